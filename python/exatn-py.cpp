@@ -202,7 +202,7 @@ py::class_<exatn::numerics::TensorExpansion,
       return exatn::initTensorSync(name, value);
     }
     return success;
-  });
+  }, py::call_guard<py::gil_scoped_release>());
   m.def("createTensor",
         [](const std::string &name, std::complex<double> &value) {
           auto success =
@@ -211,7 +211,7 @@ py::class_<exatn::numerics::TensorExpansion,
             return exatn::initTensorSync(name, value);
           }
           return success;
-        });
+        }, py::call_guard<py::gil_scoped_release>());
 
   m.def(
       "createTensor",
@@ -239,7 +239,7 @@ py::class_<exatn::numerics::TensorExpansion,
         }
         return success;
       },
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
  m.def(
       "createTensor",
       [](const std::string &name, std::vector<std::size_t> dims,
@@ -252,7 +252,7 @@ py::class_<exatn::numerics::TensorExpansion,
         }
         return success;
       },
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
   m.def(
       "createTensor",
       [](const std::string &name) {
@@ -263,7 +263,7 @@ py::class_<exatn::numerics::TensorExpansion,
         }
         return success;
       },
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
   m.def("createTensor", &createTensorWithDataNoNumServer, "");
   // Create an existing declared tensor
   m.def("createTensor", [](std::shared_ptr<Tensor> tensor) {
@@ -286,10 +286,11 @@ py::class_<exatn::numerics::TensorExpansion,
   m.def(
       "evaluate",
       [](TensorNetwork &network) { return evaluateSync(network); },
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
   m.def(
       "evaluate",
-      [](TensorExpansion& exp, std::shared_ptr<Tensor> accum){return exatn::evaluateSync(exp,accum);});
+      [](TensorExpansion& exp, std::shared_ptr<Tensor> accum){return exatn::evaluateSync(exp,accum);},
+      py::call_guard<py::gil_scoped_release>());
   m.def("getTensor", &exatn::getTensor, "");
   m.def("print", &printTensorDataNoNumServer, "");
   m.def("transformTensor", &generalTransformWithDataNoNumServer, "");
@@ -297,15 +298,41 @@ py::class_<exatn::numerics::TensorExpansion,
       "evaluateTensorNetwork",
       [](const std::string& name, const std::string& network){
          return exatn::evaluateTensorNetworkSync(name,network);},
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
   m.def(
       "evaluateTensorNetwork",
       [](const ProcessGroup& process_group, const std::string& name, const std::string& network){
          return exatn::evaluateTensorNetworkSync(process_group,name,network);},
-      "");
+      "", py::call_guard<py::gil_scoped_release>());
   m.def("getTensorData", &getTensorData, "");
+  m.def("getTensorView", [](const std::string &name) {
+    // Zero-copy read-only numpy view pinning the tensor until the array is garbage collected:
+    auto * view = withoutGIL([&]() { return new exatn::TensorView(exatn::getTensorView(name)); });
+    const auto & extents = view->getDimExtents();
+    std::vector<std::size_t> dims_vec(extents.cbegin(), extents.cend());
+    auto cap = py::capsule(view, [](void *v) { delete static_cast<exatn::TensorView*>(v); });
+    py::array arr;
+    switch (view->getElementType()) {
+    case TensorElementType::REAL32:
+      arr = py::array_t<float, py::array::f_style>(dims_vec, view->getData<float>(), cap);
+      break;
+    case TensorElementType::REAL64:
+      arr = py::array_t<double, py::array::f_style>(dims_vec, view->getData<double>(), cap);
+      break;
+    case TensorElementType::COMPLEX32:
+      arr = py::array_t<std::complex<float>, py::array::f_style>(dims_vec, view->getData<std::complex<float>>(), cap);
+      break;
+    case TensorElementType::COMPLEX64:
+      arr = py::array_t<std::complex<double>, py::array::f_style>(dims_vec, view->getData<std::complex<double>>(), cap);
+      break;
+    default:
+      return arr; // tensor not found or has no body (the capsule releases the view)
+    }
+    arr.attr("flags").attr("writeable") = false;
+    return arr;
+  }, "Returns a read-only zero-copy numpy view of a tensor (the tensor is pinned while the array is alive)");
   m.def("getLocalTensor", [](const std::string &name) {
-    auto local_tensor = exatn::getLocalTensor(name);
+    auto local_tensor = withoutGIL([&]() { return exatn::getLocalTensor(name); });
     unsigned int nd = local_tensor->getRank();
 
     std::vector<std::size_t> dims_vec(nd);
@@ -348,7 +375,121 @@ py::class_<exatn::numerics::TensorExpansion,
       assert(false && "Invalid TensorElementType");
     }
   });
-  m.def("destroyTensor", &destroyTensor, "");
+  m.def("destroyTensor", &destroyTensor, "", py::call_guard<py::gil_scoped_release>());
+  // Synchronization (waits with the GIL released)
+  m.def(
+      "sync",
+      [](const std::string &name, bool wait) { return exatn::sync(name, wait); },
+      "name"_a, "wait"_a = true, "", py::call_guard<py::gil_scoped_release>());
+  m.def(
+      "sync",
+      [](bool wait) { return exatn::sync(wait); },
+      "wait"_a = true, "", py::call_guard<py::gil_scoped_release>());
+  // Asynchronous API: Each call submits the work and immediately returns
+  // a Future which can be tested, waited on, or awaited in asyncio.
+  py::class_<PyFuture, std::shared_ptr<PyFuture>>(m, "Future", "")
+      .def("done", &PyFuture::done, "Tests for completion without blocking")
+      .def("result", &PyFuture::result, "Waits for completion (GIL released) and returns the result")
+      .def("__await__",
+          [](py::object self) {
+            // The wait is offloaded to the default executor of the running event loop:
+            auto loop = py::module::import("asyncio").attr("get_event_loop")();
+            return loop.attr("run_in_executor")(py::none(), self.attr("result")).attr("__await__")();
+          },
+          "");
+  m.def(
+      "evaluateAsync",
+      [](std::shared_ptr<TensorNetwork> network) {
+        auto submitted = withoutGIL([&]() { return exatn::evaluate(*network); });
+        if (!submitted) return std::make_shared<PyFuture>(false);
+        return std::make_shared<PyFuture>(
+            [network](bool wait) { return exatn::sync(*network, wait); },
+            []() { return py::cast(true); });
+      },
+      "");
+  m.def(
+      "evaluateAsync",
+      [](TensorExpansion &exp, std::shared_ptr<Tensor> accum) {
+        auto submitted = withoutGIL([&]() { return exatn::evaluate(exp, accum); });
+        return makeTensorFuture(submitted, accum->getName());
+      },
+      "");
+  m.def(
+      "evaluateTensorNetworkAsync",
+      [](const std::string &name, const std::string &network) {
+        auto submitted = withoutGIL([&]() { return exatn::evaluateTensorNetwork(name, network); });
+        return makeTensorFuture(submitted, getOutputTensorName(network));
+      },
+      "");
+  m.def(
+      "contractTensorsAsync",
+      [](const std::string &contraction, double alpha) {
+        auto submitted = withoutGIL([&]() { return exatn::contractTensors(contraction, alpha); });
+        return makeTensorFuture(submitted, getOutputTensorName(contraction));
+      },
+      "contraction"_a, "alpha"_a = 1.0, "");
+  m.def(
+      "contractTensorsAsync",
+      [](const std::string &contraction, std::complex<double> alpha) {
+        auto submitted = withoutGIL([&]() { return exatn::contractTensors(contraction, alpha); });
+        return makeTensorFuture(submitted, getOutputTensorName(contraction));
+      },
+      "");
+  m.def(
+      "computeNorm1Async",
+      [](const std::string &name) { return makeReductionFuture(exatn::computeNorm1Async(name)); },
+      "");
+  m.def(
+      "computeNorm2Async",
+      [](const std::string &name) { return makeReductionFuture(exatn::computeNorm2Async(name)); },
+      "");
+  m.def(
+      "computeMaxAbsAsync",
+      [](const std::string &name) { return makeReductionFuture(exatn::computeMaxAbsAsync(name)); },
+      "");
+  // Batched submission of tensor operations (see exatn.Batch)
+  py::class_<PyExpressionTemplate, std::shared_ptr<PyExpressionTemplate>>(m, "ExpressionTemplate", "")
+      .def(py::init<const std::string &>())
+      .def("getSpecification", &PyExpressionTemplate::getSpecification, "")
+      .def("getNumTensors", &PyExpressionTemplate::getNumTensors, "")
+      .def("getTensorNames", &PyExpressionTemplate::getTensorNames, "")
+      .def("instantiate", &PyExpressionTemplate::instantiate, "");
+  m.def("submitBatch", &submitBatch, "batch"_a, "wait"_a = false,
+        "Parses, validates and submits a batch of tensor operations in one call");
+  // Runtime performance counters
+  py::class_<RuntimeMetrics::OpcodeStats>(m, "OpcodeStats", "")
+      .def_readonly("count", &RuntimeMetrics::OpcodeStats::count, "")
+      .def_readonly("total_latency", &RuntimeMetrics::OpcodeStats::total_latency, "")
+      .def_readonly("latency_histogram", &RuntimeMetrics::OpcodeStats::latency_histogram, "");
+  py::class_<RuntimeMetrics::DeviceStats>(m, "DeviceStats", "")
+      .def_readonly("device", &RuntimeMetrics::DeviceStats::device, "")
+      .def_readonly("count", &RuntimeMetrics::DeviceStats::count, "")
+      .def_readonly("flops", &RuntimeMetrics::DeviceStats::flops, "")
+      .def_readonly("busy_time", &RuntimeMetrics::DeviceStats::busy_time, "")
+      .def_readonly("gflops", &RuntimeMetrics::DeviceStats::gflops, "")
+      .def_readonly("utilization", &RuntimeMetrics::DeviceStats::utilization, "")
+      .def_readonly("queued_flops", &RuntimeMetrics::DeviceStats::queued_flops, "")
+      .def_readonly("free_memory_bytes", &RuntimeMetrics::DeviceStats::free_memory_bytes, "");
+  py::class_<RuntimeMetrics>(m, "RuntimeMetrics", "")
+      .def_readonly("opcodes", &RuntimeMetrics::opcodes, "")
+      .def_readonly("devices", &RuntimeMetrics::devices, "")
+      .def_readonly("ready_queue", &RuntimeMetrics::ready_queue, "")
+      .def_readonly("ready_queue_max", &RuntimeMetrics::ready_queue_max, "")
+      .def_readonly("num_postponed", &RuntimeMetrics::num_postponed, "")
+      .def_readonly("num_prefetch_hits", &RuntimeMetrics::num_prefetch_hits, "")
+      .def_readonly("num_prefetch_misses", &RuntimeMetrics::num_prefetch_misses, "")
+      .def_readonly("host_to_device_bytes", &RuntimeMetrics::host_to_device_bytes, "")
+      .def_readonly("device_to_host_bytes", &RuntimeMetrics::device_to_host_bytes, "")
+      .def_readonly("memory_usage_bytes", &RuntimeMetrics::memory_usage_bytes, "")
+      .def_readonly("memory_free_bytes", &RuntimeMetrics::memory_free_bytes, "")
+      .def_readonly("tensor_memory_bytes", &RuntimeMetrics::tensor_memory_bytes, "")
+      .def_readonly("memory_fragmentation", &RuntimeMetrics::memory_fragmentation, "")
+      .def_readonly("exec_idle_time", &RuntimeMetrics::exec_idle_time, "")
+      .def_readonly("exec_spin_time", &RuntimeMetrics::exec_spin_time, "")
+      .def_readonly("elapsed_time", &RuntimeMetrics::elapsed_time, "");
+  m.def("getRuntimeMetrics", &exatn::getRuntimeMetrics, "");
+  m.def("getMemoryFragmentation", &exatn::getMemoryFragmentation, "");
+  m.def("resetRuntimeMetrics", &exatn::resetRuntimeMetrics, "");
   // exatn_numerics API
   // Performs tensor contraction: tensor0 += tensor1 * tensor2 * alpha
   // Input: symbolic tensor contraction specification & alpha factor (default = 1.0)
@@ -358,28 +499,28 @@ py::class_<exatn::numerics::TensorExpansion,
     [](const std::string& contraction) {
       return exatn::contractTensorsSync(contraction, 1.0);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   m.def(
     "contractTensors",
     // Floating-point alpha
     [](const std::string& contraction, double alpha) {
       return exatn::contractTensorsSync(contraction, alpha);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   m.def(
     "contractTensors",
     // Complex alpha
     [](const std::string& contraction, std::complex<double> alpha) {
       return exatn::contractTensorsSync(contraction, alpha);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   // Initializes the tensor body with random values.
   m.def(
     "initTensorRnd",
     [](const std::string& name) {
       return exatn::initTensorRndSync(name);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   // Decomposes a tensor into three tensor factors via SVD. The symbolic
   // tensor contraction specification specifies the decomposition,
   // for example:
@@ -393,28 +534,28 @@ py::class_<exatn::numerics::TensorExpansion,
     [](const std::string& contraction) {
       return exatn::decomposeTensorSVDSync(contraction);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   // SVD with singular values absorbed by the left tensor
   m.def(
     "svdL",
     [](const std::string& contraction) {
       return exatn::decomposeTensorSVDLSync(contraction);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   // SVD with singular values absorbed by the right tensor
   m.def(
     "svdR",
     [](const std::string& contraction) {
       return exatn::decomposeTensorSVDRSync(contraction);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
   // SVD with square root of singular values absorbed by the left and right tensors
   m.def(
     "svdLR",
     [](const std::string& contraction) {
       return exatn::decomposeTensorSVDLRSync(contraction);
     },
-    "");
+    "", py::call_guard<py::gil_scoped_release>());
 }
 } // namespace exatn
 
@@ -10,6 +10,39 @@ def parse_args(args):
     opts = parser.parse_args(args)
     return opts
 
+class Batch:
+    """Records tensor operations and submits them to ExaTN in a single call
+    (exatn.submitBatch) which parses, validates and submits the whole batch.
+    A target is either a symbolic specification (or tensor name), or an
+    ExpressionTemplate together with the tensor names to instantiate it with."""
+    CONTRACT, ADD, SCALE, INIT = 0, 1, 2, 3
+
+    def __init__(self):
+        self.ops = []
+
+    def _target(self, target, names):
+        return target if names is None else (target, names)
+
+    def contract(self, target, alpha=1.0, names=None):
+        self.ops.append((Batch.CONTRACT, self._target(target, names), alpha))
+
+    def add(self, target, alpha=1.0, names=None):
+        self.ops.append((Batch.ADD, self._target(target, names), alpha))
+
+    def scale(self, name, alpha):
+        self.ops.append((Batch.SCALE, name, alpha))
+
+    def init(self, name, value):
+        self.ops.append((Batch.INIT, name, value))
+
+    def __len__(self):
+        return len(self.ops)
+
+    def submit(self, wait=False):
+        success = submitBatch(self.ops, wait)
+        self.ops = []
+        return success
+
 Initialize()
 
 def _finalize():
@@ -18,7 +18,13 @@
 #include "talshxx.hpp"
 #include "tensor_basic.hpp"
 #include "tensor_method.hpp"
+#include "tensor_symbol.hpp"
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
 #include <type_traits>
 
 namespace py = pybind11;
@@ -59,6 +65,263 @@ TensorElementType TypeToTensorElementType<std::complex<double>>::type =
 
 using TensorFunctor = talsh::TensorFunctor<Identifiable>;
 
+/**
+  Runs a blocking ExaTN call with the GIL released, such that other Python
+  threads keep running meanwhile. Tensor functors calling back into Python
+  acquire the GIL themselves from the execution thread.
+*/
+template <typename Function>
+auto withoutGIL(Function &&function) -> decltype(function()) {
+  py::gil_scoped_release release;
+  return function();
+}
+
+/**
+  Handle to an asynchronously executed ExaTN call (Python class Future):
+  done() tests for completion without blocking, result() waits for completion
+  with the GIL released and returns the result. A Future is awaitable in asyncio
+  (the wait is offloaded to the default executor of the event loop).
+*/
+class PyFuture {
+public:
+  PyFuture(std::function<bool(bool)> sync,    // synchronizes the call: bool sync(bool wait)
+           std::function<py::object()> result) // returns the result once synchronized (under the GIL)
+      : sync_(sync), result_(result), completed_(false), success_(false) {}
+
+  // Completed future (failed submissions):
+  explicit PyFuture(bool success)
+      : sync_([](bool) { return true; }), result_([]() { return py::cast(true); }),
+        completed_(true), success_(success) {}
+
+  bool done() {
+    if (!completed_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!completed_ && sync_(false)) {
+        success_ = true;
+        completed_ = true;
+      }
+    }
+    return completed_;
+  }
+
+  py::object result() {
+    if (!completed_) {
+      py::gil_scoped_release release;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!completed_) {
+        success_ = sync_(true);
+        completed_ = true;
+      }
+    }
+    if (!success_) return py::cast(false);
+    return result_();
+  }
+
+private:
+  std::function<bool(bool)> sync_;
+  std::function<py::object()> result_;
+  std::atomic<bool> completed_;
+  bool success_;
+  std::mutex mutex_;
+};
+
+/**
+  Returns a future completing once all outstanding operations
+  on the given tensor have completed (asynchronous submission).
+*/
+std::shared_ptr<PyFuture> makeTensorFuture(bool submitted, const std::string &tensor_name) {
+  if (!submitted) return std::make_shared<PyFuture>(false);
+  return std::make_shared<PyFuture>(
+      [tensor_name](bool wait) { return exatn::sync(tensor_name, wait); },
+      []() { return py::cast(true); });
+}
+
+/**
+  Returns a future completing an asynchronous scalar reduction.
+  The reduction is deferred, thus done() only becomes true after result().
+*/
+std::shared_ptr<PyFuture> makeReductionFuture(std::future<double> &&future) {
+  auto reduction = std::make_shared<std::future<double>>(std::move(future));
+  auto value = std::make_shared<double>(-1.0);
+  return std::make_shared<PyFuture>(
+      [reduction, value](bool wait) {
+        if (!wait) return false;
+        *value = reduction->get();
+        return (*value >= 0.0);
+      },
+      [value]() { return py::cast(*value); });
+}
+
+/**
+  Pre-parsed tensor operation template: A symbolic tensor operation specification,
+  for example "D(a,b)+=L(a,c)*R(c,b)", is parsed and validated once, after which it
+  can be instantiated with different tensor names (in the order of appearance)
+  by plain string assembly, without parsing it again.
+*/
+class PyExpressionTemplate {
+public:
+  PyExpressionTemplate(const std::string &specification) : specification_(specification) {
+    std::vector<std::string> tensors;
+    if (!exatn::parse_tensor_network(specification, tensors)) {
+      throw std::invalid_argument("Invalid tensor operation specification: " + specification);
+    }
+    std::size_t position = 0;
+    for (const auto &tensor : tensors) {
+      std::string tensor_name;
+      std::vector<IndexLabel> indices;
+      bool conjugated;
+      if (!exatn::parse_tensor(tensor, tensor_name, indices, conjugated)) {
+        throw std::invalid_argument("Invalid tensor " + tensor + " in specification: " + specification);
+      }
+      const auto tensor_position = specification.find(tensor, position);
+      assert(tensor_position != std::string::npos);
+      pieces_.emplace_back(specification.substr(position, tensor_position - position));
+      names_.emplace_back(tensor_name);
+      position = tensor_position + tensor_name.size();
+    }
+    pieces_.emplace_back(specification.substr(position));
+  }
+
+  const std::string &getSpecification() const { return specification_; }
+
+  std::size_t getNumTensors() const { return names_.size(); }
+
+  const std::vector<std::string> &getTensorNames() const { return names_; }
+
+  // Instantiates the template with new tensor names (returns an empty string on a mismatch):
+  std::string instantiate(const std::vector<std::string> &names) const {
+    if (names.size() != names_.size()) return std::string();
+    std::string specification = pieces_[0];
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      if (names[i].empty()) return std::string();
+      specification += names[i];
+      specification += pieces_[i + 1];
+    }
+    return specification;
+  }
+
+private:
+  std::string specification_;       // original specification
+  std::vector<std::string> names_;  // original tensor names in the order of appearance
+  std::vector<std::string> pieces_; // specification text around the tensor names (names_.size() + 1)
+};
+
+/**
+  Batched submission of tensor operations recorded on the Python side: The batch is a list
+  of tuples (opcode, target, alpha), where the target is either a symbolic specification
+  (CONTRACT, ADD), a tensor name (SCALE, INIT), or a tuple (ExpressionTemplate, tensor names).
+  The whole batch is decoded, parsed and validated before any operation is submitted, such
+  that an invalid batch is rejected as a whole. Optionally waits for completion.
+*/
+enum class BatchOpCode : int { CONTRACT = 0, ADD = 1, SCALE = 2, INIT = 3 };
+
+bool submitBatch(const py::list &batch, bool wait) {
+  struct BatchOp {
+    BatchOpCode code;
+    std::string target;
+    std::complex<double> alpha;
+    bool parsed; // specification already validated (template instance)
+  };
+  // Decode the batch (under the GIL):
+  std::vector<BatchOp> ops;
+  ops.reserve(batch.size());
+  for (const auto &item : batch) {
+    auto op = item.cast<py::tuple>();
+    if (op.size() != 3) throw std::invalid_argument("Batched operation must be a tuple (opcode, target, alpha)");
+    BatchOp batch_op{static_cast<BatchOpCode>(op[0].cast<int>()), std::string(),
+                     op[2].cast<std::complex<double>>(), false};
+    if (py::isinstance<py::tuple>(op[1])) {
+      auto instance = op[1].cast<py::tuple>();
+      const auto &expression = instance[0].cast<const PyExpressionTemplate &>();
+      batch_op.target = expression.instantiate(instance[1].cast<std::vector<std::string>>());
+      batch_op.parsed = !batch_op.target.empty();
+    } else {
+      batch_op.target = op[1].cast<std::string>();
+    }
+    ops.emplace_back(std::move(batch_op));
+  }
+  py::gil_scoped_release release;
+  // Parse and validate the whole batch:
+  for (std::size_t i = 0; i < ops.size(); ++i) {
+    const auto &op = ops[i];
+    bool valid = !op.target.empty();
+    if (valid) {
+      switch (op.code) {
+      case BatchOpCode::CONTRACT:
+      case BatchOpCode::ADD: {
+        std::vector<std::string> tensors;
+        valid = exatn::parse_tensor_network(op.target, tensors) &&
+                (tensors.size() == ((op.code == BatchOpCode::CONTRACT) ? 3 : 2));
+        for (std::size_t j = 0; valid && j < tensors.size(); ++j) {
+          std::string tensor_name;
+          std::vector<IndexLabel> indices;
+          bool conjugated;
+          if (op.parsed) { // template instance: only the tensor names need to be extracted
+            tensor_name = tensors[j].substr(0, tensors[j].find_first_of("+("));
+          } else {
+            valid = exatn::parse_tensor(tensors[j], tensor_name, indices, conjugated);
+          }
+          valid = valid && exatn::tensorAllocated(tensor_name);
+        }
+        break;
+      }
+      case BatchOpCode::SCALE:
+      case BatchOpCode::INIT:
+        valid = exatn::tensorAllocated(op.target);
+        break;
+      default:
+        valid = false;
+      }
+    }
+    if (!valid) {
+      std::cout << "#ERROR(exatn::submitBatch): Invalid batched operation " << i << ": "
+                << static_cast<int>(op.code) << " " << op.target << std::endl;
+      return false;
+    }
+  }
+  // Submit the whole batch:
+  bool success = true;
+  for (const auto &op : ops) {
+    const bool real = (op.alpha.imag() == 0.0);
+    switch (op.code) {
+    case BatchOpCode::CONTRACT:
+      success = real ? exatn::contractTensors(op.target, op.alpha.real())
+                     : exatn::contractTensors(op.target, op.alpha);
+      break;
+    case BatchOpCode::ADD:
+      success = real ? exatn::addTensors(op.target, op.alpha.real())
+                     : exatn::addTensors(op.target, op.alpha);
+      break;
+    case BatchOpCode::SCALE:
+      success = real ? exatn::scaleTensor(op.target, op.alpha.real())
+                     : exatn::scaleTensor(op.target, op.alpha);
+      break;
+    case BatchOpCode::INIT:
+      success = real ? exatn::initTensor(op.target, op.alpha.real())
+                     : exatn::initTensor(op.target, op.alpha);
+      break;
+    default:
+      success = false;
+    }
+    if (!success) break;
+  }
+  if (success && wait) success = exatn::sync();
+  return success;
+}
+
+/**
+  Returns the name of the output tensor of a symbolic tensor operation.
+*/
+std::string getOutputTensorName(const std::string &specification) {
+  std::vector<std::string> tensors;
+  std::string tensor_name;
+  std::vector<IndexLabel> indices;
+  bool conjugated;
+  if (exatn::parse_tensor_network(specification, tensors))
+    if (exatn::parse_tensor(tensors[0], tensor_name, indices, conjugated)) return tensor_name;
+  return std::string();
+}
+
 class NumpyTensorFunctorCppWrapper : public TensorFunctor {
 protected:
   std::function<void(py::array& buffer)> _functor;
@@ -96,6 +359,12 @@ public:
       : _functor(functor), tensorType(type) {}
   NumpyTensorFunctorCppWrapper(py::array buffer, TensorElementType type)
       : initialData(buffer), initialDataProvided(true), tensorType(type) {}
+  // The functor may be released by the execution thread:
+  virtual ~NumpyTensorFunctorCppWrapper() {
+    py::gil_scoped_acquire acquire;
+    _functor = nullptr;
+    initialData = py::array();
+  }
   const std::string name() const override {
     return "numpy_tensor_functor_cpp_wrapper";
   }
@@ -104,6 +373,8 @@ public:
   virtual void unpack(BytePacket &packet) override {}
 
   int apply(talsh::Tensor &local_tensor) override {
+    // Executed by the execution thread while the caller has released the GIL:
+    py::gil_scoped_acquire acquire;
     auto volume = local_tensor.getVolume();
     unsigned int nd = local_tensor.getRank();
     std::vector<std::size_t> dims_vec(nd);
@@ -162,7 +433,7 @@ bool createTensorWithDataNoNumServer(const std::string name,
   auto created = n->createTensor(name, type, exatn::numerics::TensorShape(dims));
   assert(created);
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(data, type);
-  return n->transformTensorSync(name, functor);
+  return withoutGIL([&]() { return n->transformTensorSync(name, functor); });
 }
 
 bool createTensorWithData(exatn::NumServer &n, const std::string name,
@@ -189,7 +460,7 @@ bool createTensorWithData(exatn::NumServer &n, const std::string name,
   auto created = n.createTensor(name, type, exatn::numerics::TensorShape(dims));
   assert(created);
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(data, type);
-  return n.transformTensorSync(name, functor);
+  return withoutGIL([&]() { return n.transformTensorSync(name, functor); });
 }
 
 bool generalTransformWithData(exatn::NumServer &n, const std::string &name,
@@ -203,7 +474,7 @@ bool generalTransformWithData(exatn::NumServer &n, const std::string &name,
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(
       wrapper,
       type);
-  auto worked = n.transformTensorSync(name, functor);
+  auto worked = withoutGIL([&]() { return n.transformTensorSync(name, functor); });
   return worked;
 }
 
@@ -220,7 +491,7 @@ auto n = exatn::numericalServer;
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(
       wrapper,
       type);
-  auto worked = n->transformTensorSync(name, functor);
+  auto worked = withoutGIL([&]() { return n->transformTensorSync(name, functor); });
   return worked;
 }
 
@@ -234,7 +505,7 @@ void printTensorData(exatn::NumServer &n, const std::string &name) {
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(
       f,
       type);
-  auto worked = n.transformTensorSync(name, functor);
+  auto worked = withoutGIL([&]() { return n.transformTensorSync(name, functor); });
   return;
 }
 
@@ -250,7 +521,7 @@ void printTensorDataNoNumServer(const std::string &name) {
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(
       f,
       type);
-  auto worked = n->transformTensorSync(name, functor);
+  auto worked = withoutGIL([&]() { return n->transformTensorSync(name, functor); });
   return;
 }
 
@@ -266,7 +537,7 @@ const py::array getTensorData(const std::string& name) {
   auto functor = std::make_shared<NumpyTensorFunctorCppWrapper>(
       f,
       type);
-  auto worked = n->transformTensorSync(name, functor);
+  auto worked = withoutGIL([&]() { return n->transformTensorSync(name, functor); });
   return a;
 }
 } // namespace exatn
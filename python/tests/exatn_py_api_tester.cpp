@@ -256,6 +256,86 @@ print(exatn.getLocalTensor('AC0'))
 [print(exatn.getLocalTensor(c.network.getTensor(0).getName())) for c in closed_prod]
 )""");
 
+
+  py::print("\n[ Test Asynchronous API ]");
+  py::exec(
+      R"""(
+import exatn, asyncio, threading
+
+exatn.createTensor('AZ0')
+exatn.createTensor('AT0', [16,16], 0.5)
+exatn.createTensor('AT1', [16,16], 0.5)
+
+# A Python thread keeps running while the main thread waits in ExaTN:
+ticks = []
+stop = threading.Event()
+def monitor():
+    while not stop.is_set():
+        ticks.append(1)
+        stop.wait(0.001)
+thread = threading.Thread(target=monitor)
+thread.start()
+
+async def driver():
+    future = exatn.evaluateTensorNetworkAsync('Closure', 'AZ0() = AT0(a,b) * AT1(a,b)')
+    await asyncio.sleep(0)  # overlap with other work
+    assert(await future)
+    norm = await exatn.computeNorm1Async('AZ0')
+    return norm
+
+norm = asyncio.get_event_loop().run_until_complete(driver())
+assert(abs(norm - 64.0) < 1e-9)
+
+assert(exatn.contractTensorsAsync('AZ0() += AT0(a,b) * AT1(a,b)', 2.0).result())
+assert(exatn.sync('AZ0'))
+assert(abs(exatn.computeNorm1Async('AZ0').result() - 192.0) < 1e-9)
+
+stop.set()
+thread.join()
+assert(len(ticks) > 0)
+
+exatn.destroyTensor('AT1')
+exatn.destroyTensor('AT0')
+exatn.destroyTensor('AZ0')
+)""");
+
+
+  py::print("\n[ Test Batched Submission ]");
+  py::exec(
+      R"""(
+import exatn
+
+exatn.createTensor('BD', [4,4], 0.0)
+exatn.createTensor('BL', [4,4], 0.5)
+exatn.createTensor('BR', [4,4], 0.25)
+
+product = exatn.ExpressionTemplate('D(a,b)+=L(a,c)*R(c,b)')
+assert(product.getTensorNames() == ['D', 'L', 'R'])
+assert(product.instantiate(['BD', 'BL', 'BR']) == 'BD(a,b)+=BL(a,c)*BR(c,b)')
+
+batch = exatn.Batch()
+for i in range(100):
+    batch.contract(product, 1.0, ['BD', 'BL', 'BR'])
+batch.add('BD(a,b)+=BL(a,b)', 2.0)
+batch.scale('BD', 0.5)
+assert(len(batch) == 102)
+assert(batch.submit(wait=True))
+
+bd = exatn.getLocalTensor('BD')
+assert(abs(bd[0,0] - 25.5) < 1e-9)
+
+# An invalid batch is rejected as a whole:
+batch.contract(product, 1.0, ['BD', 'BL', 'Missing'])
+batch.scale('BD', 0.0)
+assert(not batch.submit())
+bd = exatn.getLocalTensor('BD')
+assert(abs(bd[0,0] - 25.5) < 1e-9)
+
+exatn.destroyTensor('BR')
+exatn.destroyTensor('BL')
+exatn.destroyTensor('BD')
+)""");
+
 }
 
 int main(int argc, char **argv) {
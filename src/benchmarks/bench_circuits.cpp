@@ -0,0 +1,116 @@
+/** ExaTN: Benchmarks: Quantum circuit tensor networks
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+std::vector<std::pair<unsigned int, unsigned int>> readCircuitGates(const std::string & filename)
+{
+ std::vector<std::pair<unsigned int, unsigned int>> gates;
+ std::ifstream circuit_file(filename);
+ if(!circuit_file.is_open()) return gates;
+ std::stringstream contents;
+ contents << circuit_file.rdbuf();
+ const std::string text = contents.str();
+ std::size_t pos = 0;
+ while((pos = text.find('{',pos)) != std::string::npos){
+  unsigned int control = 0, target = 0;
+  char comma = 0, brace = 0;
+  std::istringstream pair_stream(text.substr(pos + 1,32));
+  if((pair_stream >> control >> comma >> target >> brace) && comma == ',' && brace == '}'){
+   gates.emplace_back(std::make_pair(control,target));
+  }
+  ++pos;
+ }
+ return gates;
+}
+
+
+std::vector<std::pair<unsigned int, unsigned int>> randomCircuitGates(unsigned int num_qubits,
+                                                                      unsigned int num_layers,
+                                                                      unsigned int seed)
+{
+ std::vector<std::pair<unsigned int, unsigned int>> gates;
+ std::mt19937 generator(seed);
+ std::vector<unsigned int> qubits(num_qubits);
+ for(unsigned int i = 0; i < num_qubits; ++i) qubits[i] = i;
+ for(unsigned int layer = 0; layer < num_layers; ++layer){
+  std::shuffle(qubits.begin(),qubits.end(),generator);
+  for(unsigned int i = 0; i + 1 < num_qubits; i += 2) gates.emplace_back(std::make_pair(qubits[i],qubits[i+1]));
+ }
+ return gates;
+}
+
+
+unsigned int getCircuitNumQubits(const std::vector<std::pair<unsigned int, unsigned int>> & gates)
+{
+ unsigned int num_qubits = 0;
+ for(const auto & gate: gates) num_qubits = std::max(num_qubits,std::max(gate.first,gate.second) + 1);
+ return num_qubits;
+}
+
+
+std::shared_ptr<TensorNetwork> buildCircuitNetwork(const std::string & name,
+                                                   const std::vector<std::pair<unsigned int, unsigned int>> & gates,
+                                                   bool merge_qubits)
+{
+ const unsigned int num_qubits = getCircuitNumQubits(gates);
+ auto circuit = exatn::makeSharedTensorNetwork(name);
+ unsigned int tensor_counter = 0;
+ //Left qubit tensors:
+ const unsigned int first_q_tensor = tensor_counter + 1;
+ for(unsigned int i = 0; i < num_qubits; ++i){
+  auto success = circuit->appendTensor(++tensor_counter,
+                                       std::make_shared<Tensor>("Q"+std::to_string(i),TensorShape{2}),{});
+  assert(success);
+ }
+ const unsigned int last_q_tensor = tensor_counter;
+ //CNOT gates:
+ auto cnot = std::make_shared<Tensor>("CNOT",TensorShape{2,2,2,2});
+ for(const auto & gate: gates){
+  auto success = circuit->appendTensorGate(++tensor_counter,cnot,{gate.first,gate.second}); assert(success);
+ }
+ //Right qubit tensors:
+ const unsigned int first_p_tensor = tensor_counter + 1;
+ for(unsigned int i = 0; i < num_qubits; ++i){
+  auto success = circuit->appendTensor(++tensor_counter,
+                                       std::make_shared<Tensor>("P"+std::to_string(i),TensorShape{2}),{{0,0}});
+  assert(success);
+ }
+ const unsigned int last_p_tensor = tensor_counter;
+ //Merge qubit tensors into adjacent gates:
+ if(merge_qubits){
+  for(unsigned int i = first_p_tensor; i <= last_p_tensor; ++i){
+   const auto other_tensor_id = (*(circuit->getTensorConnections(i)))[0].getTensorId();
+   auto success = circuit->mergeTensors(other_tensor_id,i,++tensor_counter); assert(success);
+  }
+  for(unsigned int i = first_q_tensor; i <= last_q_tensor; ++i){
+   const auto other_tensor_id = (*(circuit->getTensorConnections(i)))[0].getTensorId();
+   auto success = circuit->mergeTensors(other_tensor_id,i,++tensor_counter); assert(success);
+  }
+ }
+ return circuit;
+}
+
+} //namespace bench
+
+} //namespace exatn
@@ -0,0 +1,108 @@
+/** ExaTN: Benchmarks: Performance regression check of benchmark reports
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_compare.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace exatn{
+
+namespace bench{
+
+namespace{
+
+/** Returns the key of a benchmark record: suite/name[param=value;...]. **/
+std::string record_key(const BenchReport::Record & record)
+{
+ std::string key = record.suite + "/" + record.name + "[";
+ for(std::size_t i = 0; i < record.params.size(); ++i){
+  if(i > 0) key += ';';
+  key += (record.params[i].first + "=" + record.params[i].second);
+ }
+ return key + "]";
+}
+
+/** Returns whether a larger value of a metric is better (rates). **/
+bool higher_is_better(const std::string & metric)
+{
+ const std::string suffix("_per_sec");
+ return metric.size() >= suffix.size()
+     && metric.compare(metric.size() - suffix.size(),suffix.size(),suffix) == 0;
+}
+
+/** Returns whether a metric is only checked with a metric-specific tolerance. **/
+bool checked_on_request(const std::string & metric)
+{
+ static const std::vector<std::string> metrics{"time_min","time_mean","time_max",
+                                               "samples","bytes","max_intermediate_rank"};
+ return std::find(metrics.cbegin(),metrics.cend(),metric) != metrics.cend();
+}
+
+} //namespace
+
+
+unsigned int compareReports(const BenchReport & baseline,
+                            const BenchReport & current,
+                            const CompareTolerances & tolerances,
+                            std::ostream & stream)
+{
+ unsigned int num_regressions = 0, num_improvements = 0, num_checked = 0, num_missing = 0;
+ const auto & current_records = current.getResults();
+ std::map<std::string,const BenchReport::Record*> current_by_key;
+ for(const auto & record: current_records) current_by_key.emplace(record_key(record),&record);
+ for(const auto & base_record: baseline.getResults()){
+  const auto key = record_key(base_record);
+  auto iter = current_by_key.find(key);
+  if(iter == current_by_key.end()){
+   stream << "MISSING    " << key << std::endl;
+   ++num_missing;
+   continue;
+  }
+  const auto & curr_record = *(iter->second);
+  for(const auto & base_metric: base_record.metrics){
+   const auto & metric = base_metric.first;
+   auto tolerance = tolerances.default_tolerance;
+   auto tol_iter = tolerances.metric_tolerance.find(metric);
+   if(tol_iter != tolerances.metric_tolerance.end()){
+    tolerance = tol_iter->second;
+   }else if(checked_on_request(metric)){
+    continue;
+   }
+   auto curr_metric = std::find_if(curr_record.metrics.cbegin(),curr_record.metrics.cend(),
+                      [&metric](const std::pair<std::string,double> & entry){return entry.first == metric;});
+   if(curr_metric == curr_record.metrics.cend()) continue;
+   const double base_value = base_metric.second;
+   const double curr_value = curr_metric->second;
+   if(!std::isfinite(base_value) || base_value == 0.0) continue;
+   ++num_checked;
+   double change = (curr_value - base_value) / std::abs(base_value); //relative change
+   if(!std::isfinite(curr_value)) change = higher_is_better(metric) ? -1.0 : 1.0;
+   const double loss = higher_is_better(metric) ? -change : change; //positive: worse
+   if(loss > tolerance || loss < -tolerance){
+    if(loss > tolerance){
+     stream << "REGRESSION ";
+     ++num_regressions;
+    }else{
+     stream << "IMPROVED   ";
+     ++num_improvements;
+    }
+    stream << key << " " << metric << ": " << base_value << " -> " << curr_value
+           << " (" << (change >= 0.0 ? "+" : "") << change * 100.0 << "%, tolerance "
+           << tolerance * 100.0 << "%)" << std::endl;
+   }
+  }
+ }
+ stream << "#MSG(exatn::bench): Checked " << num_checked << " metrics: "
+        << num_regressions << " regressions, " << num_improvements << " improvements, "
+        << num_missing << " missing records" << std::endl;
+ return num_regressions;
+}
+
+} //namespace bench
+
+} //namespace exatn
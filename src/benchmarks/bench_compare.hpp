@@ -0,0 +1,53 @@
+/** ExaTN: Benchmarks: Performance regression check of benchmark reports
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A current benchmark report is compared against a baseline benchmark report
+     record by record, the records being matched by {suite, case name, parameters}.
+     Each metric present in both matched records is checked against a relative tolerance
+     (metric-specific or default): The rates (metrics named *_per_sec) regress when they
+     decrease by more than the tolerance, all other metrics (time, flop count, memory usage,
+     communication volume, tensor contraction sequence quality) regress when they increase
+     by more than the tolerance.
+ (b) The secondary timing statistics and descriptive metrics (time_min, time_mean, time_max,
+     samples, bytes, max_intermediate_rank) are only checked when a metric-specific tolerance
+     is given for them. Metrics with a zero or non-finite baseline value are not checked.
+ (c) The baseline records missing in the current report are listed but do not count as
+     regressions, such that the benchmark suites can be run selectively.
+**/
+
+#ifndef EXATN_BENCH_COMPARE_HPP_
+#define EXATN_BENCH_COMPARE_HPP_
+
+#include "bench_report.hpp"
+
+#include <string>
+#include <map>
+#include <iostream>
+
+namespace exatn{
+
+namespace bench{
+
+/** Relative tolerances of the performance regression check **/
+struct CompareTolerances{
+ double default_tolerance = 0.1;               //default relative tolerance
+ std::map<std::string,double> metric_tolerance; //metric-specific relative tolerances
+};
+
+/** Compares a current benchmark report against a baseline benchmark report,
+    prints the regressions, improvements and missing records into a stream,
+    and returns the number of regressions. **/
+unsigned int compareReports(const BenchReport & baseline,         //in: baseline benchmark report
+                            const BenchReport & current,          //in: current benchmark report
+                            const CompareTolerances & tolerances, //in: relative tolerances
+                            std::ostream & stream = std::cout);   //out: comparison log
+
+} //namespace bench
+
+} //namespace exatn
+
+#endif //EXATN_BENCH_COMPARE_HPP_
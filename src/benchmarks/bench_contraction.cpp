@@ -0,0 +1,171 @@
+/** ExaTN: Benchmarks: Tensor contractions and tensor slicing
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+#include "timers.hpp"
+
+#include <string>
+#include <vector>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+namespace{
+
+/** Tensor contraction benchmark case: D+=L*R **/
+struct ContractionCase{
+ std::string name;                     //case name
+ std::string pattern;                  //index pattern with tensor names D, L, R
+ std::vector<std::vector<int>> shapes; //shapes of D, L, R
+};
+
+/** Tensor slicing benchmark case **/
+struct SliceCase{
+ std::string name;          //case name
+ std::vector<int> offsets;  //slice base offsets
+ std::vector<int> extents;  //slice extents
+};
+
+/** Returns the name of a benchmark tensor. **/
+std::string bench_tensor_name(const std::string & prefix, char tensor)
+{
+ return prefix + tensor;
+}
+
+/** Replaces the tensor names D, L, R in a contraction pattern. **/
+std::string bench_pattern(const std::string & pattern, const std::string & prefix)
+{
+ std::string result;
+ for(const char c: pattern){
+  if(c == 'D' || c == 'L' || c == 'R'){
+   result += bench_tensor_name(prefix,c);
+  }else{
+   result += c;
+  }
+ }
+ return result;
+}
+
+} //namespace
+
+
+void benchTensorContractions(const BenchConfig & config, BenchReport & report)
+{
+ const int n = config.quick ? 256 : 1024;  //matrix dimension
+ const int m = config.quick ? 16 : 32;     //tensor dimension
+ const int chi = config.quick ? 64 : 256;  //MPS bond dimension
+ const std::vector<ContractionCase> cases{
+  {"matmul","D(a,b)+=L(a,k)*R(k,b)",{{n,n},{n,n},{n,n}}},
+  {"matmul_transposed","D(a,b)+=L(k,a)*R(b,k)",{{n,n},{n,n},{n,n}}},
+  {"matvec","D(a)+=L(a,k)*R(k)",{{4*n},{4*n,4*n},{4*n}}},
+  {"tensor4_permuted","D(a,b,c,d)+=L(c,a,k,l)*R(d,l,k,b)",{{m,m,m,m},{m,m,m,m},{m,m,m,m}}},
+  {"mps_two_site","D(a,i,j,b)+=L(a,i,c)*R(c,j,b)",{{chi,2,2,chi},{chi,2,chi},{chi,2,chi}}},
+  {"mps_environment","D(a,b)+=L+(c,i,a)*R(c,i,b)",{{chi,chi},{chi,2,chi},{chi,2,chi}}},
+  {"outer_product","D(a,b,c)+=L(a,b)*R(c)",{{n/4,n/4,64},{n/4,n/4},{64}}}
+ };
+ const std::vector<std::pair<std::string,TensorElementType>> element_types{
+  {"real32",TensorElementType::REAL32},{"real64",TensorElementType::REAL64},
+  {"complex32",TensorElementType::COMPLEX32},{"complex64",TensorElementType::COMPLEX64}
+ };
+ const std::string prefix = "_BenchContr";
+
+ for(const auto & contraction: cases){
+  for(const auto & element_type: element_types){
+   const char tensors[] = {'D','L','R'};
+   for(unsigned int i = 0; i < 3; ++i){
+    auto success = exatn::createTensorSync(bench_tensor_name(prefix,tensors[i]),element_type.second,
+                                           TensorShape(contraction.shapes[i])); assert(success);
+   }
+   auto success = exatn::initTensorRndSync(bench_tensor_name(prefix,'L')); assert(success);
+   success = exatn::initTensorRndSync(bench_tensor_name(prefix,'R')); assert(success);
+   success = exatn::initTensorSync(bench_tensor_name(prefix,'D'),0.0); assert(success);
+   const auto pattern = bench_pattern(contraction.pattern,prefix);
+   RuntimeProbe probe;
+   auto timings = timeRepeated(config,[&](){
+    const double start = Timer::timeInSecHR();
+    auto success = exatn::contractTensorsSync(pattern,1.0); assert(success);
+    return Timer::timeInSecHR(start);
+   });
+   const auto stats = computeTimingStats(timings);
+   report.addTimedResult("contraction",contraction.name,
+                         {{"pattern",contraction.pattern},{"element_type",element_type.first}},
+                         timings,probe.getMetrics(config,stats.median));
+   for(unsigned int i = 0; i < 3; ++i){
+    success = exatn::destroyTensorSync(bench_tensor_name(prefix,tensors[i])); assert(success);
+   }
+  }
+ }
+ return;
+}
+
+
+void benchTensorSlicing(const BenchConfig & config, BenchReport & report)
+{
+ const int n = config.quick ? 64 : 256; //tensor dimension
+ const std::vector<SliceCase> cases{
+  {"contiguous_block",{0,0,n/2},{n,n,n/4}},    //contiguous memory block
+  {"interior_cube",{n/4,n/4,n/4},{n/2,n/2,n/2}}, //strided interior block
+  {"thin_leading",{n/2,0,0},{8,n,n}},          //short contiguous runs
+  {"half_leading",{0,n/4,0},{n,n/2,n}}         //long contiguous runs
+ };
+ const std::string tensor_name = "_BenchSliceT";
+ auto success = exatn::createTensorSync(tensor_name,TensorElementType::REAL64,TensorShape{n,n,n}); assert(success);
+ success = exatn::initTensorRndSync(tensor_name); assert(success);
+
+ for(const auto & slice_case: cases){
+  const std::string slice_name = "_BenchSliceS";
+  std::vector<std::pair<SpaceId,SubspaceId>> subspaces;
+  double slice_volume = 1.0;
+  for(std::size_t i = 0; i < slice_case.offsets.size(); ++i){
+   subspaces.emplace_back(std::make_pair(SOME_SPACE,static_cast<SubspaceId>(slice_case.offsets[i])));
+   slice_volume *= static_cast<double>(slice_case.extents[i]);
+  }
+  auto slice = std::make_shared<Tensor>(slice_name,slice_case.extents,subspaces);
+  success = exatn::createTensorSync(slice,TensorElementType::REAL64); assert(success);
+  const double slice_bytes = slice_volume * sizeof(double);
+  std::string shape;
+  for(const auto extent: slice_case.extents) shape += ((shape.empty() ? "" : "x") + std::to_string(extent));
+  //Slice extraction:
+  RuntimeProbe extract_probe;
+  auto timings = timeRepeated(config,[&](){
+   const double start = Timer::timeInSecHR();
+   auto success = exatn::extractTensorSliceSync(tensor_name,slice_name); assert(success);
+   return Timer::timeInSecHR(start);
+  });
+  auto stats = computeTimingStats(timings);
+  auto metrics = extract_probe.getMetrics(config,stats.median);
+  metrics.insert(metrics.begin(),{{"bytes",slice_bytes},{"gbytes_per_sec",2.0 * slice_bytes / stats.median * 1e-9}}); //read + write
+  report.addTimedResult("slice",slice_case.name,
+                        {{"operation","extract"},{"slice_shape",shape},{"tensor_extent",toParam(n)}},
+                        timings,metrics);
+  //Slice insertion:
+  RuntimeProbe insert_probe;
+  timings = timeRepeated(config,[&](){
+   const double start = Timer::timeInSecHR();
+   auto success = exatn::insertTensorSliceSync(tensor_name,slice_name); assert(success);
+   return Timer::timeInSecHR(start);
+  });
+  stats = computeTimingStats(timings);
+  metrics = insert_probe.getMetrics(config,stats.median);
+  metrics.insert(metrics.begin(),{{"bytes",slice_bytes},{"gbytes_per_sec",2.0 * slice_bytes / stats.median * 1e-9}}); //read + write
+  report.addTimedResult("slice",slice_case.name,
+                        {{"operation","insert"},{"slice_shape",shape},{"tensor_extent",toParam(n)}},
+                        timings,metrics);
+  success = exatn::destroyTensorSync(slice_name); assert(success);
+ }
+
+ success = exatn::destroyTensorSync(tensor_name); assert(success);
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
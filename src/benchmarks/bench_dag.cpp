@@ -0,0 +1,63 @@
+/** ExaTN: Benchmarks: DAG submission and execution throughput
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+#include "timers.hpp"
+
+#include <string>
+#include <vector>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+void benchDAGThroughput(const BenchConfig & config, BenchReport & report)
+{
+ //Empty tensor operations: Zero initializations of scalars (deferred by the node executor):
+ const std::size_t num_ops = config.quick ? 1000 : 20000;
+ const std::vector<std::size_t> num_tensors_cases{1,16,256}; //1: fully serialized DAG, >1: independent chains
+
+ for(const auto num_tensors: num_tensors_cases){
+  std::vector<std::string> names(num_tensors);
+  for(std::size_t i = 0; i < num_tensors; ++i){
+   names[i] = "_BenchDAG" + std::to_string(i);
+   auto success = exatn::createTensorSync(names[i],TensorElementType::REAL64,TensorShape{}); assert(success);
+  }
+  std::vector<double> submit_timings;
+  RuntimeProbe probe;
+  auto timings = timeRepeated(config,[&](){
+   const double start = Timer::timeInSecHR();
+   for(std::size_t i = 0; i < num_ops; ++i){
+    auto success = exatn::initTensor(names[i % num_tensors],0.0); assert(success);
+   }
+   submit_timings.emplace_back(Timer::timeInSecHR(start));
+   auto success = exatn::sync(); assert(success);
+   return Timer::timeInSecHR(start);
+  });
+  submit_timings.erase(submit_timings.begin(),submit_timings.begin() + config.warmups);
+  const auto submit_stats = computeTimingStats(submit_timings);
+  const auto total_stats = computeTimingStats(timings);
+  auto metrics = probe.getMetrics(config,total_stats.median);
+  metrics.insert(metrics.begin(),{{"submit_time_median",submit_stats.median},
+                                  {"submit_ops_per_sec",static_cast<double>(num_ops) / submit_stats.median},
+                                  {"ops_per_sec",static_cast<double>(num_ops) / total_stats.median}});
+  report.addTimedResult("dag","empty_ops",
+                        {{"num_ops",toParam(num_ops)},{"num_tensors",toParam(num_tensors)}},
+                        timings,metrics);
+  for(const auto & name: names){
+   auto success = exatn::destroyTensorSync(name); assert(success);
+  }
+ }
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
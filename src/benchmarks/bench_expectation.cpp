@@ -0,0 +1,84 @@
+/** ExaTN: Benchmarks: Expectation values of spin Hamiltonians
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+#include "quantum.hpp"
+#include "timers.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+void benchExpectationValues(const BenchConfig & config, BenchReport & report)
+{
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+ const std::vector<int> num_sites_cases = config.quick ? std::vector<int>{8} : std::vector<int>{8,16,24};
+ const std::vector<int> bond_dims = config.quick ? std::vector<int>{4} : std::vector<int>{4,16};
+
+ for(const auto num_sites: num_sites_cases){
+  const std::string hamiltonian_name = "mcvqe_" + std::to_string(num_sites) + "q";
+  const std::string filename = config.data_dir + "/" + hamiltonian_name + ".qcw.txt";
+  if(!std::ifstream(filename).good()){
+   std::cout << "#WARNING(exatn::bench): Unable to read Hamiltonian " << hamiltonian_name
+             << " from " << config.data_dir << ": Skipped!" << std::endl;
+   continue;
+  }
+  //Read the Hamiltonian in spin representation:
+  auto hamiltonian = exatn::quantum::readSpinHamiltonian("BenchHam",filename,TENS_ELEM_TYPE,"QCWare");
+  auto success = hamiltonian->deleteComponent(0); assert(success); //remove SCF part
+  for(const auto bond_dim: bond_dims){
+   const int max_bond_dim = std::min(static_cast<int>(std::pow(2,num_sites/2)),bond_dim);
+   //MPS ansatz:
+   auto tn_builder = exatn::getTensorNetworkBuilder("MPS"); assert(tn_builder);
+   success = tn_builder->setParameter("max_bond_dim",max_bond_dim); assert(success);
+   auto ket_tensor = exatn::makeSharedTensor("BenchKetTensor",std::vector<int>(num_sites,2));
+   auto ket_net = exatn::makeSharedTensorNetwork("BenchKet",ket_tensor,*tn_builder,false);
+   auto ket = exatn::makeSharedTensorExpansion("BenchKet",ket_net,std::complex<double>{1.0,0.0});
+   success = exatn::createTensorsSync(*ket_net,TENS_ELEM_TYPE); assert(success);
+   success = exatn::initTensorsRndSync(*ket_net); assert(success);
+   auto bra = exatn::makeSharedTensorExpansion(*ket);
+   bra->conjugate();
+   //Expectation value <ket|H|ket>:
+   TensorExpansion expectation(*ket,*bra,*hamiltonian);
+   auto scalar = exatn::makeSharedTensor("_BenchEnergy");
+   success = exatn::createTensorSync(scalar,TENS_ELEM_TYPE); assert(success);
+   RuntimeProbe probe;
+   auto timings = timeRepeated(config,[&](){
+    auto success = exatn::initTensorSync("_BenchEnergy",0.0); assert(success);
+    const double start = Timer::timeInSecHR();
+    success = exatn::evaluateSync(expectation,scalar); assert(success);
+    return Timer::timeInSecHR(start);
+   });
+   const auto stats = computeTimingStats(timings);
+   report.addTimedResult("expectation",hamiltonian_name,
+                         {{"ansatz","MPS"},{"max_bond_dim",toParam(max_bond_dim)},
+                          {"num_terms",toParam(hamiltonian->getNumComponents())}},
+                         timings,probe.getMetrics(config,stats.median));
+   success = exatn::destroyTensorSync("_BenchEnergy"); assert(success);
+   success = exatn::destroyTensorsSync(*ket_net); assert(success);
+  }
+  for(auto iter = hamiltonian->begin(); iter != hamiltonian->end(); ++iter){
+   success = exatn::destroyTensorsSync(*(iter->network)); assert(success);
+  }
+ }
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
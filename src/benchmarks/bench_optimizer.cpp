@@ -0,0 +1,62 @@
+/** ExaTN: Benchmarks: Tensor contraction sequence optimizers
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+#include "timers.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+void benchContractionSeqOptimizers(const BenchConfig & config, BenchReport & report)
+{
+ const std::vector<std::string> circuits = config.quick ? std::vector<std::string>{"sycamore_8_cnot"}
+                                                        : std::vector<std::string>{"sycamore_8_cnot","sycamore_12_cnot"};
+ const std::vector<std::string> optimizers{"greed","metis","auto"};
+
+ for(const auto & circuit_name: circuits){
+  const auto gates = readCircuitGates(config.data_dir + "/" + circuit_name + ".txt");
+  if(gates.empty()){
+   std::cout << "#WARNING(exatn::bench): Unable to read circuit " << circuit_name
+             << " from " << config.data_dir << ": Skipped!" << std::endl;
+   continue;
+  }
+  for(const auto & optimizer: optimizers){
+   double fma_flops = 0.0, max_volume = 0.0;
+   unsigned int max_rank = 0, num_tensors = 0;
+   auto timings = timeRepeated(config,[&](){
+    auto circuit = buildCircuitNetwork(circuit_name,gates,true); //fresh tensor network without a contraction sequence
+    num_tensors = circuit->getNumTensors();
+    const double start = Timer::timeInSecHR();
+    fma_flops = circuit->determineContractionSequence(optimizer);
+    const double duration = Timer::timeInSecHR(start);
+    circuit->getOperationList(optimizer);
+    max_volume = circuit->getMaxIntermediateVolume(&max_rank);
+    return duration;
+   });
+   report.addTimedResult("optimizer",circuit_name,
+                         {{"optimizer",optimizer},{"num_gates",toParam(gates.size())},
+                          {"num_tensors",toParam(num_tensors)}},
+                         timings,
+                         {{"fma_flops",fma_flops},{"max_intermediate_volume",max_volume},
+                          {"max_intermediate_rank",static_cast<double>(max_rank)}});
+  }
+ }
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
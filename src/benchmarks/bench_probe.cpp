@@ -0,0 +1,49 @@
+/** ExaTN: Benchmarks: Per-run runtime metrics of benchmark cases
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+
+#include <algorithm>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+RuntimeProbe::RuntimeProbe():
+ flops_start_(0.0), transfer_start_(0)
+{
+ auto success = exatn::sync(); assert(success);
+ exatn::resetRuntimeMetrics();
+ const auto metrics = exatn::getRuntimeMetrics();
+ transfer_start_ = metrics.host_to_device_bytes + metrics.device_to_host_bytes; //not reset by the runtime
+ flops_start_ = exatn::getTotalFlopCount();
+}
+
+
+BenchReport::Metrics RuntimeProbe::getMetrics(const BenchConfig & config,
+                                              double run_time) const
+{
+ const auto metrics = exatn::getRuntimeMetrics();
+ const double num_runs = static_cast<double>(std::max(config.warmups + config.repeats,1U));
+ const double flops = (exatn::getTotalFlopCount() - flops_start_) / num_runs;
+ const auto transfer_bytes = metrics.host_to_device_bytes + metrics.device_to_host_bytes;
+ const double optimizer_time = metrics.contr_seq_time / num_runs;
+ return {{"flops",flops},
+         {"gflops_per_sec",(run_time > 0.0) ? (flops / run_time * 1e-9) : 0.0},
+         {"peak_memory_bytes",static_cast<double>(metrics.memory_peak_bytes)},
+         {"comm_bytes",static_cast<double>(metrics.comm_bytes) / num_runs},
+         {"host_device_bytes",static_cast<double>(transfer_bytes - std::min(transfer_bytes,transfer_start_)) / num_runs},
+         {"optimizer_time",optimizer_time},
+         {"contraction_time",std::max(run_time - optimizer_time,0.0)}};
+}
+
+} //namespace bench
+
+} //namespace exatn
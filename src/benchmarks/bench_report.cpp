@@ -0,0 +1,416 @@
+/** ExaTN: Benchmarks: Benchmark configuration, timing and JSON/CSV report
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_report.hpp"
+
+#include "timers.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace exatn{
+
+namespace bench{
+
+namespace{
+
+/** Writes a JSON string literal. **/
+void write_json_string(std::ostream & stream, const std::string & str)
+{
+ stream << '"';
+ for(const char c: str){
+  switch(c){
+  case '"': stream << "\\\""; break;
+  case '\\': stream << "\\\\"; break;
+  case '\n': stream << "\\n"; break;
+  case '\t': stream << "\\t"; break;
+  case '\r': stream << "\\r"; break;
+  default:
+   if(static_cast<unsigned char>(c) < 0x20){
+    char code[8];
+    std::snprintf(code,sizeof(code),"\\u%04x",static_cast<unsigned int>(c));
+    stream << code;
+   }else{
+    stream << c;
+   }
+  }
+ }
+ stream << '"';
+ return;
+}
+
+/** Writes a JSON number (null if not finite). **/
+void write_json_number(std::ostream & stream, double value)
+{
+ if(std::isfinite(value)){
+  stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+ }else{
+  stream << "null";
+ }
+ return;
+}
+
+/** Writes a CSV field (quoted if needed). **/
+void write_csv_field(std::ostream & stream, const std::string & str)
+{
+ if(str.find_first_of(",\"\n\r") == std::string::npos){
+  stream << str;
+ }else{
+  stream << '"';
+  for(const char c: str){
+   if(c == '"') stream << '"';
+   stream << c;
+  }
+  stream << '"';
+ }
+ return;
+}
+
+
+/** Minimal reader of the JSON benchmark report (unknown members are skipped). **/
+class JSONReader{
+public:
+
+ explicit JSONReader(const std::string & text): text_(text), pos_(0) {}
+
+ /** Reads all benchmark records of the JSON report. **/
+ bool readReport(std::vector<BenchReport::Record> & records)
+ {
+  bool success = readObject([&](const std::string & key){
+   if(key != "results") return skipValue();
+   return readArray([&](){
+    BenchReport::Record record;
+    bool parsed = readObject([&](const std::string & field){
+     if(field == "suite") return readString(record.suite);
+     if(field == "name") return readString(record.name);
+     if(field == "params"){
+      return readObject([&](const std::string & param){
+       std::string value;
+       if(!readString(value)) return false;
+       record.params.emplace_back(std::make_pair(param,value));
+       return true;
+      });
+     }
+     if(field == "metrics"){
+      return readObject([&](const std::string & metric){
+       double value = 0.0;
+       if(!readNumber(value)) return false;
+       record.metrics.emplace_back(std::make_pair(metric,value));
+       return true;
+      });
+     }
+     return skipValue();
+    });
+    if(parsed) records.emplace_back(std::move(record));
+    return parsed;
+   });
+  });
+  skipSpace();
+  return success && pos_ == text_.size();
+ }
+
+private:
+
+ void skipSpace()
+ {
+  while(pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+  return;
+ }
+
+ bool accept(char c)
+ {
+  skipSpace();
+  if(pos_ < text_.size() && text_[pos_] == c){++pos_; return true;}
+  return false;
+ }
+
+ bool acceptLiteral(const std::string & literal)
+ {
+  skipSpace();
+  if(text_.compare(pos_,literal.size(),literal) != 0) return false;
+  pos_ += literal.size();
+  return true;
+ }
+
+ bool readString(std::string & str)
+ {
+  str.clear();
+  if(!accept('"')) return false;
+  while(pos_ < text_.size()){
+   const char c = text_[pos_++];
+   if(c == '"') return true;
+   if(c != '\\'){str += c; continue;}
+   if(pos_ >= text_.size()) return false;
+   const char e = text_[pos_++];
+   switch(e){
+   case 'n': str += '\n'; break;
+   case 't': str += '\t'; break;
+   case 'r': str += '\r'; break;
+   case 'b': str += '\b'; break;
+   case 'f': str += '\f'; break;
+   case 'u':
+    if(pos_ + 4 > text_.size()) return false;
+    {
+     const auto code = std::strtoul(text_.substr(pos_,4).c_str(),nullptr,16);
+     str += (code < 0x80) ? static_cast<char>(code) : '?'; //only ASCII is written by the report
+    }
+    pos_ += 4;
+    break;
+   default: str += e; //quote, backslash, slash
+   }
+  }
+  return false;
+ }
+
+ bool readNumber(double & value)
+ {
+  if(acceptLiteral("null")){
+   value = std::numeric_limits<double>::quiet_NaN();
+   return true;
+  }
+  const char * begin = text_.c_str() + pos_;
+  char * end = nullptr;
+  value = std::strtod(begin,&end);
+  if(end == begin) return false;
+  pos_ += (end - begin);
+  return true;
+ }
+
+ template <typename Member>
+ bool readObject(Member && member)
+ {
+  if(!accept('{')) return false;
+  if(accept('}')) return true;
+  do{
+   std::string key;
+   if(!(readString(key) && accept(':') && member(key))) return false;
+  }while(accept(','));
+  return accept('}');
+ }
+
+ template <typename Element>
+ bool readArray(Element && element)
+ {
+  if(!accept('[')) return false;
+  if(accept(']')) return true;
+  do{
+   if(!element()) return false;
+  }while(accept(','));
+  return accept(']');
+ }
+
+ bool skipValue()
+ {
+  skipSpace();
+  if(pos_ >= text_.size()) return false;
+  std::string str;
+  double value = 0.0;
+  switch(text_[pos_]){
+  case '{': return readObject([this](const std::string &){return skipValue();});
+  case '[': return readArray([this](){return skipValue();});
+  case '"': return readString(str);
+  case 't': return acceptLiteral("true");
+  case 'f': return acceptLiteral("false");
+  default: return readNumber(value); //including null
+  }
+ }
+
+ const std::string & text_; //JSON text
+ std::size_t pos_;          //current position
+};
+
+} //namespace
+
+
+TimingStats computeTimingStats(std::vector<double> timings)
+{
+ TimingStats stats;
+ stats.samples = timings.size();
+ if(timings.empty()) return stats;
+ std::sort(timings.begin(),timings.end());
+ const auto n = timings.size();
+ stats.min = timings.front();
+ stats.max = timings.back();
+ stats.median = (n % 2 != 0) ? timings[n/2] : 0.5 * (timings[n/2 - 1] + timings[n/2]);
+ double sum = 0.0;
+ for(const auto timing: timings) sum += timing;
+ stats.mean = sum / static_cast<double>(n);
+ return stats;
+}
+
+
+BenchReport::BenchReport(const BenchConfig & config):
+ config_(config), start_time_(Timer::timeInSec())
+{
+}
+
+
+void BenchReport::addResult(const std::string & suite,
+                            const std::string & name,
+                            const Params & params,
+                            const Metrics & metrics)
+{
+ records_.emplace_back(Record{suite,name,params,metrics});
+ return;
+}
+
+
+void BenchReport::addTimedResult(const std::string & suite,
+                                 const std::string & name,
+                                 const Params & params,
+                                 const std::vector<double> & timings,
+                                 const Metrics & metrics)
+{
+ const auto stats = computeTimingStats(timings);
+ Metrics all_metrics{{"time_min",stats.min},{"time_median",stats.median},
+                     {"time_mean",stats.mean},{"time_max",stats.max},
+                     {"samples",static_cast<double>(stats.samples)}};
+ all_metrics.insert(all_metrics.end(),metrics.cbegin(),metrics.cend());
+ addResult(suite,name,params,all_metrics);
+ return;
+}
+
+
+std::size_t BenchReport::getNumResults() const
+{
+ return records_.size();
+}
+
+
+const std::vector<BenchReport::Record> & BenchReport::getResults() const
+{
+ return records_;
+}
+
+
+void BenchReport::writeJSON(std::ostream & stream) const
+{
+ int num_threads = 1;
+#ifdef _OPENMP
+ num_threads = omp_get_max_threads();
+#endif
+ const auto precision = stream.precision();
+ stream << "{\n";
+ stream << " \"benchmark\": \"exatn_bench\",\n";
+ stream << " \"start_time\": "; write_json_number(stream,start_time_); stream << ",\n";
+ stream << " \"duration\": "; write_json_number(stream,Timer::timeInSec(start_time_)); stream << ",\n";
+ stream << " \"config\": {\"repeats\": " << config_.repeats
+        << ", \"warmups\": " << config_.warmups
+        << ", \"quick\": " << (config_.quick ? "true" : "false")
+        << ", \"omp_threads\": " << num_threads << "},\n";
+ stream << " \"results\": [";
+ for(std::size_t i = 0; i < records_.size(); ++i){
+  const auto & record = records_[i];
+  stream << ((i == 0) ? "\n" : ",\n");
+  stream << "  {\"suite\": "; write_json_string(stream,record.suite);
+  stream << ", \"name\": "; write_json_string(stream,record.name);
+  stream << ",\n   \"params\": {";
+  for(std::size_t j = 0; j < record.params.size(); ++j){
+   if(j > 0) stream << ", ";
+   write_json_string(stream,record.params[j].first); stream << ": ";
+   write_json_string(stream,record.params[j].second);
+  }
+  stream << "},\n   \"metrics\": {";
+  for(std::size_t j = 0; j < record.metrics.size(); ++j){
+   if(j > 0) stream << ", ";
+   write_json_string(stream,record.metrics[j].first); stream << ": ";
+   write_json_number(stream,record.metrics[j].second);
+  }
+  stream << "}}";
+ }
+ stream << "\n ]\n}\n";
+ stream.precision(precision);
+ return;
+}
+
+
+bool BenchReport::writeJSON(const std::string & filename) const
+{
+ std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+ if(!report_file.is_open()) return false;
+ writeJSON(report_file);
+ report_file.close();
+ return !report_file.fail();
+}
+
+
+bool BenchReport::readJSON(const std::string & filename)
+{
+ std::ifstream report_file(filename);
+ if(!report_file.is_open()) return false;
+ std::stringstream contents;
+ contents << report_file.rdbuf();
+ const std::string text = contents.str();
+ std::vector<Record> records;
+ JSONReader reader(text);
+ if(!reader.readReport(records)) return false;
+ records_.insert(records_.end(),records.cbegin(),records.cend());
+ return true;
+}
+
+
+void BenchReport::writeCSV(std::ostream & stream) const
+{
+ const auto precision = stream.precision();
+ stream << "suite,name,params,metric,value\n";
+ for(const auto & record: records_){
+  std::string params;
+  for(const auto & param: record.params){
+   if(!params.empty()) params += ';';
+   params += (param.first + "=" + param.second);
+  }
+  for(const auto & metric: record.metrics){
+   write_csv_field(stream,record.suite); stream << ',';
+   write_csv_field(stream,record.name); stream << ',';
+   write_csv_field(stream,params); stream << ',';
+   write_csv_field(stream,metric.first); stream << ',';
+   if(std::isfinite(metric.second)){ //empty if not finite
+    stream << std::setprecision(std::numeric_limits<double>::max_digits10) << metric.second;
+   }
+   stream << '\n';
+  }
+ }
+ stream.precision(precision);
+ return;
+}
+
+
+bool BenchReport::writeCSV(const std::string & filename) const
+{
+ std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+ if(!report_file.is_open()) return false;
+ writeCSV(report_file);
+ report_file.close();
+ return !report_file.fail();
+}
+
+
+void BenchReport::printIt() const
+{
+ for(const auto & record: records_){
+  std::cout << "[" << record.suite << "] " << record.name << ":";
+  for(const auto & param: record.params) std::cout << " " << param.first << "=" << param.second;
+  std::cout << " |";
+  for(const auto & metric: record.metrics) std::cout << " " << metric.first << "=" << metric.second;
+  std::cout << std::endl;
+ }
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
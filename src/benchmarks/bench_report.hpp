@@ -0,0 +1,147 @@
+/** ExaTN: Benchmarks: Benchmark configuration, timing and JSON/CSV report
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Each benchmark case produces a single record {suite, case name, parameters, metrics},
+     where the timing metrics (min/median/mean/max, seconds) are derived from repeated
+     timed runs preceded by untimed warm-up runs. The derived rates (Flop/s, bytes/s,
+     ops/s) are computed from the median time.
+ (b) The report is written as a single JSON document together with the run configuration
+     and environment (number of processes, OpenMP threads), such that the results of different
+     runs or commits can be compared for trend tracking. Non-finite metrics are written as null.
+     A previously written JSON report can be read back for comparison (see bench_compare.hpp).
+ (c) The CSV report has one row per metric {suite, name, params, metric, value},
+     with the case parameters joined as name=value pairs separated by semicolons,
+     such that the records with different metrics fit into a single table.
+**/
+
+#ifndef EXATN_BENCH_REPORT_HPP_
+#define EXATN_BENCH_REPORT_HPP_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+namespace exatn{
+
+namespace bench{
+
+/** Benchmark run configuration **/
+struct BenchConfig{
+ unsigned int repeats = 5;    //number of timed repetitions of each benchmark case
+ unsigned int warmups = 1;    //number of untimed warm-up repetitions of each benchmark case
+ bool quick = false;          //reduced problem sizes (smoke test)
+ std::string data_dir;        //directory with the input data files (circuits, Hamiltonians)
+ std::string output;          //JSON report file
+ std::string csv_output;      //CSV report file (none if empty)
+};
+
+/** Statistics of repeated timings (seconds) **/
+struct TimingStats{
+ double min = 0.0;
+ double median = 0.0;
+ double mean = 0.0;
+ double max = 0.0;
+ unsigned int samples = 0;
+};
+
+/** Computes the statistics of repeated timings. **/
+TimingStats computeTimingStats(std::vector<double> timings);
+
+/** Runs the warm-up and timed repetitions of a benchmark case. The benchmark case
+    returns its own measured time (seconds), such that it can exclude its setup. **/
+template <typename BenchCase>
+std::vector<double> timeRepeated(const BenchConfig & config,
+                                 BenchCase && bench_case)
+{
+ for(unsigned int i = 0; i < config.warmups; ++i) bench_case();
+ std::vector<double> timings;
+ timings.reserve(config.repeats);
+ for(unsigned int i = 0; i < config.repeats; ++i) timings.emplace_back(bench_case());
+ return timings;
+}
+
+
+class BenchReport{
+public:
+
+ using Params = std::vector<std::pair<std::string,std::string>>; //case parameters: {name, value}
+ using Metrics = std::vector<std::pair<std::string,double>>;     //case metrics: {name, value}
+
+ struct Record{
+  std::string suite;  //benchmark suite
+  std::string name;   //benchmark case name
+  Params params;      //case parameters
+  Metrics metrics;    //case metrics
+ };
+
+ explicit BenchReport(const BenchConfig & config);
+
+ BenchReport(const BenchReport &) = default;
+ BenchReport & operator=(const BenchReport &) = default;
+ BenchReport(BenchReport &&) noexcept = default;
+ BenchReport & operator=(BenchReport &&) noexcept = default;
+ ~BenchReport() = default;
+
+ /** Adds a benchmark record. **/
+ void addResult(const std::string & suite,  //in: benchmark suite
+                const std::string & name,   //in: benchmark case name
+                const Params & params,      //in: case parameters
+                const Metrics & metrics);   //in: case metrics
+
+ /** Adds a benchmark record with the timing statistics of the repeated timings
+     prepended to the other metrics. **/
+ void addTimedResult(const std::string & suite,          //in: benchmark suite
+                     const std::string & name,           //in: benchmark case name
+                     const Params & params,              //in: case parameters
+                     const std::vector<double> & timings, //in: repeated timings (seconds)
+                     const Metrics & metrics);           //in: other case metrics
+
+ /** Returns the number of benchmark records. **/
+ std::size_t getNumResults() const;
+
+ /** Returns all benchmark records. **/
+ const std::vector<Record> & getResults() const;
+
+ /** Writes the JSON report into a stream. **/
+ void writeJSON(std::ostream & stream) const;
+
+ /** Writes the JSON report into a file. Returns FALSE on failure. **/
+ bool writeJSON(const std::string & filename) const;
+
+ /** Appends the benchmark records of a JSON report file (null metrics are read as NaN).
+     Returns FALSE if the file cannot be read or parsed. **/
+ bool readJSON(const std::string & filename);
+
+ /** Writes the CSV report into a stream. **/
+ void writeCSV(std::ostream & stream) const;
+
+ /** Writes the CSV report into a file. Returns FALSE on failure. **/
+ bool writeCSV(const std::string & filename) const;
+
+ /** Prints a one-line summary of each benchmark record. **/
+ void printIt() const;
+
+private:
+
+ BenchConfig config_;          //run configuration
+ std::vector<Record> records_; //benchmark records
+ double start_time_;           //wall-clock start time of the run (seconds since epoch)
+};
+
+/** Converts a number into a string parameter. **/
+template <typename Number>
+std::string toParam(Number value)
+{
+ return std::to_string(value);
+}
+
+} //namespace bench
+
+} //namespace exatn
+
+#endif //EXATN_BENCH_REPORT_HPP_
@@ -0,0 +1,261 @@
+/** ExaTN: Benchmarks: Multi-process scaling of sliced circuit simulation
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "bench_scaling.hpp"
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+#include "timers.hpp"
+
+#ifdef MPI_ENABLED
+#include "mpi.h"
+#endif
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <complex>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace bench{
+
+namespace{
+
+/** Returns the numbers of processes of the sweep (ascending, at most all processes). **/
+std::vector<unsigned int> sweep_ranks(const std::vector<unsigned int> & requested,
+                                      unsigned int num_procs)
+{
+ std::vector<unsigned int> ranks;
+ if(requested.empty()){
+  for(unsigned int p = 1; p < num_procs; p *= 2) ranks.emplace_back(p);
+  ranks.emplace_back(num_procs);
+ }else{
+  for(const auto p: requested){
+   if(p > 0 && p <= num_procs){
+    ranks.emplace_back(p);
+   }else{
+    std::cout << "#WARNING(exatn::bench): Number of processes " << p
+              << " is not available (" << num_procs << " processes): Skipped!" << std::endl;
+   }
+  }
+  std::sort(ranks.begin(),ranks.end());
+  ranks.erase(std::unique(ranks.begin(),ranks.end()),ranks.end());
+ }
+ return ranks;
+}
+
+/** Returns floor(log2(n)) for n > 0. **/
+unsigned int log2_floor(unsigned int n)
+{
+ unsigned int log2n = 0;
+ while(n > 1){n >>= 1; ++log2n;}
+ return log2n;
+}
+
+/** Returns the total latency of the executed communication tensor operations (seconds). **/
+double comm_latency(const runtime::RuntimeMetrics & metrics)
+{
+ double latency = 0.0;
+ for(const auto opcode: {TensorOpCode::FETCH,TensorOpCode::UPLOAD,TensorOpCode::BROADCAST,TensorOpCode::ALLREDUCE}){
+  const auto i = static_cast<std::size_t>(opcode);
+  if(i < metrics.opcodes.size()) latency += metrics.opcodes[i].total_latency;
+ }
+ return latency;
+}
+
+/** Reduces values over a process group (max or sum). **/
+void reduce_group(const ProcessGroup & process_group,
+                  std::vector<double> & values,
+                  bool maximum)
+{
+#ifdef MPI_ENABLED
+ if(process_group.getSize() > 1 && !values.empty()){
+  auto errc = MPI_Allreduce(MPI_IN_PLACE,values.data(),static_cast<int>(values.size()),MPI_DOUBLE,
+                            maximum ? MPI_MAX : MPI_SUM,process_group.getMPICommProxy().getRef<MPI_Comm>());
+  assert(errc == MPI_SUCCESS);
+ }
+#endif
+ return;
+}
+
+/** Creates the circuit tensors CNOT, Q<i>, P<i> for up to a given number of qubits (collective). **/
+void create_circuit_tensors(unsigned int num_qubits,
+                            unsigned int * num_created)
+{
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+ const std::vector<std::complex<double>> qzero{{1.0,0.0},{0.0,0.0}};
+ bool success = true;
+ if(*num_created == 0 && !exatn::tensorAllocated("CNOT")){
+  success = exatn::createTensorSync("CNOT",TENS_ELEM_TYPE,TensorShape{2,2,2,2}); assert(success);
+  success = exatn::initTensorData("CNOT",std::vector<std::complex<double>>{
+   {1.0,0.0},{0.0,0.0},{0.0,0.0},{0.0,0.0},
+   {0.0,0.0},{1.0,0.0},{0.0,0.0},{0.0,0.0},
+   {0.0,0.0},{0.0,0.0},{0.0,0.0},{1.0,0.0},
+   {0.0,0.0},{0.0,0.0},{1.0,0.0},{0.0,0.0}}); assert(success);
+ }
+ for(unsigned int i = *num_created; i < num_qubits; ++i){
+  for(const auto & name: {"Q"+std::to_string(i),"P"+std::to_string(i)}){
+   success = exatn::createTensorSync(name,TENS_ELEM_TYPE,TensorShape{2}); assert(success);
+   success = exatn::initTensorData(name,qzero); assert(success);
+  }
+ }
+ *num_created = std::max(*num_created,num_qubits);
+ success = exatn::sync(); assert(success);
+ return;
+}
+
+/** Destroys the circuit tensors (collective). **/
+void destroy_circuit_tensors(unsigned int num_created)
+{
+ bool success = true;
+ for(unsigned int i = 0; i < num_created; ++i){
+  success = exatn::destroyTensorSync("Q"+std::to_string(i)); assert(success);
+  success = exatn::destroyTensorSync("P"+std::to_string(i)); assert(success);
+ }
+ if(num_created > 0){
+  success = exatn::destroyTensorSync("CNOT"); assert(success);
+ }
+ return;
+}
+
+/** Scaling baseline: Measurements at the smallest number of processes of a sweep. **/
+struct ScalingBaseline{
+ unsigned int num_procs = 0; //number of processes (0: not set)
+ double time = 0.0;          //time-to-solution (seconds)
+ double flops = 0.0;         //executed Flop count
+};
+
+} //namespace
+
+
+void benchScaling(const ScalingConfig & config, BenchReport & report)
+{
+ const auto & world = exatn::getDefaultProcessGroup();
+ const unsigned int num_procs = world.getSize();
+ const unsigned int process_rank = exatn::getProcessRank();
+ const bool master = (process_rank == 0);
+ const auto ranks = sweep_ranks(config.ranks,num_procs);
+ const double num_runs = static_cast<double>(std::max(config.bench.warmups + config.bench.repeats,1U));
+
+ //Sweeps: {circuit, weak scaling}:
+ std::vector<std::pair<std::string,bool>> sweeps;
+ for(const auto & circuit_name: config.circuits){
+  if(config.strong) sweeps.emplace_back(std::make_pair(circuit_name,false));
+  if(config.weak){
+   if(circuit_name == "random"){
+    sweeps.emplace_back(std::make_pair(circuit_name,true));
+   }else if(master){
+    std::cout << "#WARNING(exatn::bench): Weak scaling requires a random circuit: "
+              << circuit_name << " skipped!" << std::endl;
+   }
+  }
+ }
+
+ unsigned int num_created = 0; //number of qubits with created circuit tensors
+ for(const auto & sweep: sweeps){
+  const auto & circuit_name = sweep.first;
+  const bool weak = sweep.second;
+  std::vector<std::pair<unsigned int, unsigned int>> file_gates;
+  if(circuit_name != "random"){
+   file_gates = readCircuitGates(config.bench.data_dir + "/" + circuit_name + ".txt");
+   if(file_gates.empty()){
+    if(master) std::cout << "#WARNING(exatn::bench): Unable to read circuit " << circuit_name
+                         << " from " << config.bench.data_dir << ": Skipped!" << std::endl;
+    continue;
+   }
+   if(config.num_gates > 0 && file_gates.size() > config.num_gates) file_gates.resize(config.num_gates);
+  }
+  for(const auto & optimizer: config.optimizers){
+   for(const auto memory_limit: config.memory_limits){
+    ScalingBaseline baseline;
+    for(const auto group_size: ranks){
+     //Circuit of the sweep point:
+     const auto gates = (circuit_name != "random") ? file_gates :
+      randomCircuitGates(config.random_qubits + (weak ? log2_floor(group_size) : 0),config.random_layers,config.seed);
+     const unsigned int num_qubits = getCircuitNumQubits(gates);
+     create_circuit_tensors(num_qubits,&num_created);
+     //Process group of the first group_size processes (others stay idle):
+     auto process_group = world.split((process_rank < group_size) ? 0 : -1);
+     exatn::resetContrSeqOptimizer(optimizer);
+     if(process_group){
+      process_group->resetMemoryLimitPerProcess(memory_limit);
+      auto success = exatn::sync(); assert(success);
+      exatn::resetRuntimeMetrics();
+      const double flops_start = exatn::getTotalFlopCount();
+      double num_slices = 1.0;
+      auto timings = timeRepeated(config.bench,[&](){
+       auto circuit = buildCircuitNetwork(circuit_name + "_scaling",gates,false);
+       auto success = exatn::sync(*process_group); assert(success);
+       const double start = Timer::timeInSecHR();
+       success = exatn::evaluateSync(*process_group,*circuit); assert(success);
+       success = exatn::sync(*process_group); assert(success);
+       const double duration = Timer::timeInSecHR(start);
+       num_slices = 1.0;
+       for(unsigned int i = 0; i < circuit->getNumSplitIndices(); ++i)
+        num_slices *= static_cast<double>(circuit->getSplitIndexInfo(i).second.size());
+       return duration;
+      });
+      //Per-run measurements: Slowest process (times), whole process group (volumes):
+      const auto metrics = exatn::getRuntimeMetrics();
+      reduce_group(*process_group,timings,true);
+      std::vector<double> slowest{metrics.contr_seq_time / num_runs,comm_latency(metrics) / num_runs};
+      reduce_group(*process_group,slowest,true);
+      std::vector<double> total{static_cast<double>(metrics.comm_bytes) / num_runs,
+                                (exatn::getTotalFlopCount() - flops_start) / num_runs};
+      reduce_group(*process_group,total,false);
+      if(master){
+       const double time = computeTimingStats(timings).median;
+       const double flops = total[1];
+       if(baseline.num_procs == 0){
+        baseline.num_procs = group_size; baseline.time = time; baseline.flops = flops;
+       }
+       double speedup = 0.0, efficiency = 0.0;
+       if(time > 0.0 && baseline.time > 0.0){
+        if(weak){
+         const double rate = flops / time, baseline_rate = baseline.flops / baseline.time;
+         if(baseline_rate > 0.0){
+          speedup = rate / baseline_rate;
+          efficiency = speedup * static_cast<double>(baseline.num_procs) / static_cast<double>(group_size);
+         }
+        }else{
+         speedup = baseline.time / time;
+         efficiency = speedup * static_cast<double>(baseline.num_procs) / static_cast<double>(group_size);
+        }
+       }
+       report.addTimedResult("scaling",circuit_name,
+                             {{"mode",weak ? "weak" : "strong"},{"optimizer",optimizer},
+                              {"num_processes",toParam(group_size)},{"memory_limit",toParam(memory_limit)},
+                              {"num_qubits",toParam(num_qubits)},{"num_gates",toParam(gates.size())}},
+                             timings,
+                             {{"time_to_solution",time},{"speedup",speedup},{"efficiency",efficiency},
+                              {"seq_search_time",slowest[0]},{"num_slices",num_slices},
+                              {"slices_per_process",num_slices / static_cast<double>(group_size)},
+                              {"comm_time",slowest[1]},{"comm_share",(time > 0.0) ? (slowest[1] / time) : 0.0},
+                              {"comm_bytes",total[0]},{"flops",flops},
+                              {"gflops_per_sec",(time > 0.0) ? (flops / time * 1e-9) : 0.0}});
+       std::cout << "#MSG(exatn::bench): Scaling " << circuit_name << " (" << (weak ? "weak" : "strong")
+                 << ", " << optimizer << ", memory limit " << memory_limit << "): " << group_size
+                 << " processes: " << time << " s (efficiency " << efficiency << ")" << std::endl << std::flush;
+      }
+     }
+     auto success = exatn::sync(world); assert(success); //idle processes wait for the process group
+    }
+   }
+  }
+ }
+ destroy_circuit_tensors(num_created);
+ return;
+}
+
+} //namespace bench
+
+} //namespace exatn
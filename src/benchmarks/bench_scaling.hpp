@@ -0,0 +1,66 @@
+/** ExaTN: Benchmarks: Multi-process scaling of sliced circuit simulation
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) The scaling sweep evaluates the closed tensor network <0|C|0> of CNOT circuits
+     (circuit files sycamore_*_cnot.txt, optionally truncated to the first gates, or synthetic
+     random circuits) by NumServer::submit(ProcessGroup,TensorNetwork) over process groups
+     formed by the first P processes of the default process group, for each combination
+     of {circuit, contraction sequence optimizer, memory limit per process, P}. The memory limit
+     per process drives the slicing of the tensor network; the slices are distributed among
+     the P processes. The processes outside the current process group stay idle.
+ (b) Strong scaling: The same circuit for all P. Weak scaling (random circuits only): The number
+     of qubits of the random circuit grows by one per doubling of P (random_qubits at P=1),
+     such that the work per process is roughly constant. Since the Flop count of a circuit
+     does not grow exactly with P, the weak scaling efficiency is Flop-normalized.
+ (c) Each record reports the time-to-solution (slowest process, median of the timed runs,
+     including the contraction sequence search), the speedup and parallel efficiency
+     with respect to the smallest P of the sweep (strong: T0*P0/(T*P); weak: per-process
+     Flop rate relative to the one at P0), the sequence search time, the number of slices
+     (total and per process), the communication time (total latency of the executed
+     FETCH, UPLOAD, BROADCAST and ALLREDUCE tensor operations, slowest process) and its share
+     of the time-to-solution, the communication volume and the executed Flop count (whole group).
+ (d) The report has the format of the exatn_bench report (bench_report.hpp), thus two scaling
+     reports can be compared for regressions by exatn_bench_compare.
+**/
+
+#ifndef EXATN_BENCH_SCALING_HPP_
+#define EXATN_BENCH_SCALING_HPP_
+
+#include "bench_report.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace exatn{
+
+namespace bench{
+
+/** Scaling sweep configuration **/
+struct ScalingConfig{
+ BenchConfig bench;                      //repetitions, data directory, report files
+ std::vector<std::string> circuits;      //circuit file names (without .txt) or "random"
+ std::vector<std::string> optimizers;    //tensor contraction sequence optimizers
+ std::vector<unsigned int> ranks;        //numbers of processes (empty: powers of two up to all processes)
+ std::vector<std::size_t> memory_limits; //memory limits per process (bytes)
+ bool strong = true;                     //strong scaling sweep
+ bool weak = false;                      //weak scaling sweep (random circuits only)
+ unsigned int num_gates = 0;             //max number of gates taken from the circuit files (0: all)
+ unsigned int random_qubits = 24;        //number of qubits of the random circuits (weak scaling: at one process)
+ unsigned int random_layers = 8;         //number of gate layers of the random circuits
+ unsigned int seed = 1;                  //random circuit seed
+};
+
+/** Runs the scaling sweep (collective over the default process group).
+    The records are only complete on process 0. **/
+void benchScaling(const ScalingConfig & config, BenchReport & report);
+
+} //namespace bench
+
+} //namespace exatn
+
+#endif //EXATN_BENCH_SCALING_HPP_
@@ -0,0 +1,103 @@
+/** ExaTN: Benchmarks: Benchmark suites
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Each benchmark suite runs a fixed set of benchmark cases on an initialized ExaTN
+     and appends one record per case to the benchmark report. All suites destroy
+     the tensors they create, such that they can be run in any order.
+ (b) Micro benchmarks: DAG submission/execution throughput of (almost) empty tensor
+     operations ("dag"), TAL-SH tensor contraction Flop rate by shape ("contraction"),
+     tensor slice extraction/insertion bandwidth ("slice").
+     Macro benchmarks: Tensor contraction sequence optimizers on the Sycamore CNOT circuits
+     ("optimizer"), expectation values of the MC-VQE spin Hamiltonians ("expectation").
+ (c) The benchmark cases executed by the ExaTN runtime also report the per-run runtime metrics
+     (RuntimeProbe) obtained from the runtime metrics API: Executed flop count and achieved
+     Flop rate, peak Host memory buffer usage, inter-process and Host/device communication
+     volume, and the time spent in the tensor contraction sequence search (optimizer time)
+     versus the rest of the run time (contraction time).
+**/
+
+#ifndef EXATN_BENCH_SUITES_HPP_
+#define EXATN_BENCH_SUITES_HPP_
+
+#include "bench_report.hpp"
+
+#include "tensor_network.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+
+namespace exatn{
+
+namespace bench{
+
+/** Per-run runtime metrics of a benchmark case: Resets the runtime performance counters
+    on construction (after synchronizing the runtime); the counters accumulated by all
+    subsequent (warm-up and timed) runs of the benchmark case are averaged per run. **/
+class RuntimeProbe{
+public:
+
+ RuntimeProbe();
+
+ RuntimeProbe(const RuntimeProbe &) = delete;
+ RuntimeProbe & operator=(const RuntimeProbe &) = delete;
+ RuntimeProbe(RuntimeProbe &&) noexcept = default;
+ RuntimeProbe & operator=(RuntimeProbe &&) noexcept = default;
+ ~RuntimeProbe() = default;
+
+ /** Returns the per-run runtime metrics: flops, gflops_per_sec (with respect to
+     the given run time), peak_memory_bytes, comm_bytes, host_device_bytes,
+     optimizer_time, contraction_time (run time minus optimizer time). **/
+ BenchReport::Metrics getMetrics(const BenchConfig & config, //in: run configuration (number of runs)
+                                 double run_time) const;     //in: representative run time (seconds)
+
+private:
+
+ double flops_start_;               //flop counter at the start
+ std::size_t transfer_start_;       //Host/device transfer volume at the start (bytes)
+};
+
+/** DAG submission and execution throughput of empty tensor operations. **/
+void benchDAGThroughput(const BenchConfig & config, BenchReport & report);
+
+/** Tensor contraction sequence optimizers: Optimization time and quality (Sycamore circuits). **/
+void benchContractionSeqOptimizers(const BenchConfig & config, BenchReport & report);
+
+/** TAL-SH tensor contraction Flop rate for different tensor shapes. **/
+void benchTensorContractions(const BenchConfig & config, BenchReport & report);
+
+/** Tensor slice extraction and insertion bandwidth. **/
+void benchTensorSlicing(const BenchConfig & config, BenchReport & report);
+
+/** Expectation values of the MC-VQE spin Hamiltonians over a tensor network ansatz. **/
+void benchExpectationValues(const BenchConfig & config, BenchReport & report);
+
+/** Reads the two-qubit gates {control,target} of a circuit file (sycamore_*_cnot.txt). **/
+std::vector<std::pair<unsigned int, unsigned int>> readCircuitGates(const std::string & filename);
+
+/** Generates the two-qubit gates of a synthetic random circuit: Each layer
+    pairs up all qubits in a random order (reproducible for a given seed). **/
+std::vector<std::pair<unsigned int, unsigned int>> randomCircuitGates(unsigned int num_qubits,
+                                                                      unsigned int num_layers,
+                                                                      unsigned int seed);
+
+/** Returns the number of qubits of a circuit. **/
+unsigned int getCircuitNumQubits(const std::vector<std::pair<unsigned int, unsigned int>> & gates);
+
+/** Builds the closed tensor network <0|C|0> of a CNOT circuit from the qubit tensors Q<i>, P<i>
+    and the gate tensor CNOT, optionally with the qubit tensors merged into the adjacent gates
+    (such a tensor network can only be analyzed since the merged tensors do not exist). **/
+std::shared_ptr<numerics::TensorNetwork> buildCircuitNetwork(const std::string & name,
+                                                             const std::vector<std::pair<unsigned int, unsigned int>> & gates,
+                                                             bool merge_qubits);
+
+} //namespace bench
+
+} //namespace exatn
+
+#endif //EXATN_BENCH_SUITES_HPP_
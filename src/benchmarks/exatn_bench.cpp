@@ -0,0 +1,137 @@
+/** ExaTN: Benchmarks: Benchmark driver
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Usage:
+ exatn_bench [--suite <name>]... [--output <file.json>] [--csv <file.csv>] [--repeats <n>]
+             [--warmups <n>] [--data-dir <dir>] [--host-memory <bytes>] [--quick] [--list]
+ Suites: dag, optimizer, contraction, slice, expectation (all by default).
+ The JSON report is written by process 0 (exatn_bench.json by default),
+ optionally together with the CSV report. Two JSON reports are compared
+ for performance regressions by exatn_bench_compare.
+**/
+
+#include "bench_suites.hpp"
+
+#include "exatn.hpp"
+
+#ifdef MPI_ENABLED
+#include "mpi.h"
+#endif
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+#include "errors.hpp"
+
+#ifndef EXATN_BENCH_DATA_DIR
+#define EXATN_BENCH_DATA_DIR "."
+#endif
+
+using BenchSuite = void (*)(const exatn::bench::BenchConfig &, exatn::bench::BenchReport &);
+
+int main(int argc, char **argv) {
+
+  const std::vector<std::pair<std::string,BenchSuite>> suites{
+   {"dag",&exatn::bench::benchDAGThroughput},
+   {"optimizer",&exatn::bench::benchContractionSeqOptimizers},
+   {"contraction",&exatn::bench::benchTensorContractions},
+   {"slice",&exatn::bench::benchTensorSlicing},
+   {"expectation",&exatn::bench::benchExpectationValues}
+  };
+
+  //Parse the command line:
+  exatn::bench::BenchConfig config;
+  config.data_dir = EXATN_BENCH_DATA_DIR;
+  config.output = "exatn_bench.json";
+  long long host_memory = 4LL*1024LL*1024LL*1024LL;
+  std::vector<std::string> selected;
+  for(int i = 1; i < argc; ++i){
+   const std::string arg(argv[i]);
+   const bool has_value = (i + 1 < argc);
+   if(arg == "--suite" && has_value){
+    selected.emplace_back(argv[++i]);
+   }else if(arg == "--output" && has_value){
+    config.output = argv[++i];
+   }else if(arg == "--csv" && has_value){
+    config.csv_output = argv[++i];
+   }else if(arg == "--repeats" && has_value){
+    config.repeats = std::max(1,std::atoi(argv[++i]));
+   }else if(arg == "--warmups" && has_value){
+    config.warmups = std::max(0,std::atoi(argv[++i]));
+   }else if(arg == "--data-dir" && has_value){
+    config.data_dir = argv[++i];
+   }else if(arg == "--host-memory" && has_value){
+    host_memory = std::atoll(argv[++i]);
+   }else if(arg == "--quick"){
+    config.quick = true;
+   }else if(arg == "--list"){
+    for(const auto & suite: suites) std::cout << suite.first << std::endl;
+    return 0;
+   }else{
+    std::cout << "#ERROR(exatn_bench): Invalid command line argument: " << arg << std::endl;
+    return 1;
+   }
+  }
+  for(const auto & name: selected){
+   if(std::find_if(suites.cbegin(),suites.cend(),
+                   [&name](const std::pair<std::string,BenchSuite> & suite){return suite.first == name;}) == suites.cend()){
+    std::cout << "#ERROR(exatn_bench): Unknown benchmark suite: " << name << std::endl;
+    return 1;
+   }
+  }
+
+  exatn::ParamConf exatn_parameters;
+  exatn_parameters.setParameter("host_memory_buffer_size",static_cast<int64_t>(host_memory));
+#ifdef MPI_ENABLED
+  int thread_provided;
+  int mpi_error = MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &thread_provided);
+  assert(mpi_error == MPI_SUCCESS);
+  assert(thread_provided == MPI_THREAD_MULTIPLE);
+  exatn::initialize(exatn::MPICommProxy(MPI_COMM_WORLD),exatn_parameters,"lazy-dag-executor");
+#else
+  exatn::initialize(exatn_parameters,"lazy-dag-executor");
+#endif
+  const bool master = (exatn::getProcessRank() == 0);
+
+  //Run the benchmark suites:
+  exatn::bench::BenchReport report(config);
+  for(const auto & suite: suites){
+   if(!selected.empty() && std::find(selected.cbegin(),selected.cend(),suite.first) == selected.cend()) continue;
+   if(master) std::cout << "#MSG(exatn_bench): Running benchmark suite " << suite.first << " ... " << std::flush;
+   suite.second(config,report);
+   bool success = exatn::syncClean(); assert(success);
+   if(master) std::cout << "Done" << std::endl << std::flush;
+  }
+
+  int error_code = 0;
+  if(master){
+   report.printIt();
+   if(report.writeJSON(config.output)){
+    std::cout << "#MSG(exatn_bench): Benchmark report written to " << config.output << std::endl;
+   }else{
+    std::cout << "#ERROR(exatn_bench): Unable to write the benchmark report to " << config.output << std::endl;
+    error_code = 1;
+   }
+   if(!config.csv_output.empty()){
+    if(report.writeCSV(config.csv_output)){
+     std::cout << "#MSG(exatn_bench): Benchmark report written to " << config.csv_output << std::endl;
+    }else{
+     std::cout << "#ERROR(exatn_bench): Unable to write the benchmark report to " << config.csv_output << std::endl;
+     error_code = 1;
+    }
+   }
+  }
+
+  exatn::finalize();
+#ifdef MPI_ENABLED
+  mpi_error = MPI_Finalize(); assert(mpi_error == MPI_SUCCESS);
+#endif
+  return error_code;
+}
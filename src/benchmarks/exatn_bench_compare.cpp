@@ -0,0 +1,79 @@
+/** ExaTN: Benchmarks: Performance regression check driver
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Usage:
+ exatn_bench_compare <baseline.json> <current.json> [--tolerance <rel>] [--tolerance <metric>=<rel>]...
+ Compares two exatn_bench JSON reports. The default relative tolerance is 0.1 (10%).
+ Exit code: 0: No regressions; 1: Performance regressions; 2: Invalid input.
+**/
+
+#include "bench_compare.hpp"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+namespace {
+
+/** Parses a non-negative relative tolerance. **/
+bool parse_tolerance(const std::string & str, double * tolerance)
+{
+ char * end = nullptr;
+ *tolerance = std::strtod(str.c_str(),&end);
+ return (!str.empty() && *end == '\0' && *tolerance >= 0.0);
+}
+
+} //namespace
+
+int main(int argc, char **argv) {
+
+  exatn::bench::CompareTolerances tolerances;
+  std::vector<std::string> files;
+  for(int i = 1; i < argc; ++i){
+   const std::string arg(argv[i]);
+   if(arg == "--tolerance" && i + 1 < argc){
+    const std::string value(argv[++i]);
+    const auto pos = value.find('=');
+    double tolerance = 0.0;
+    bool parsed = false;
+    if(pos == std::string::npos){
+     parsed = parse_tolerance(value,&tolerance);
+     if(parsed) tolerances.default_tolerance = tolerance;
+    }else{
+     parsed = (pos > 0) && parse_tolerance(value.substr(pos + 1),&tolerance);
+     if(parsed) tolerances.metric_tolerance[value.substr(0,pos)] = tolerance;
+    }
+    if(!parsed){
+     std::cout << "#ERROR(exatn_bench_compare): Invalid tolerance: " << value << std::endl;
+     return 2;
+    }
+   }else if(arg.compare(0,2,"--") != 0){
+    files.emplace_back(arg);
+   }else{
+    std::cout << "#ERROR(exatn_bench_compare): Invalid command line argument: " << arg << std::endl;
+    return 2;
+   }
+  }
+  if(files.size() != 2){
+   std::cout << "Usage: exatn_bench_compare <baseline.json> <current.json>"
+             << " [--tolerance <rel>] [--tolerance <metric>=<rel>]..." << std::endl;
+   return 2;
+  }
+
+  exatn::bench::BenchConfig config;
+  exatn::bench::BenchReport baseline(config), current(config);
+  if(!baseline.readJSON(files[0])){
+   std::cout << "#ERROR(exatn_bench_compare): Unable to read the baseline report " << files[0] << std::endl;
+   return 2;
+  }
+  if(!current.readJSON(files[1])){
+   std::cout << "#ERROR(exatn_bench_compare): Unable to read the current report " << files[1] << std::endl;
+   return 2;
+  }
+  const auto num_regressions = exatn::bench::compareReports(baseline,current,tolerances);
+  return (num_regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,150 @@
+/** ExaTN: Benchmarks: Scaling driver
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Usage:
+ exatn_scaling [--circuit <name|random>]... [--optimizer <name>]... [--ranks <n>]...
+               [--memory <bytes>]... [--mode strong|weak|both] [--gates <n>] [--qubits <n>]
+               [--layers <n>] [--seed <n>] [--output <file.json>] [--csv <file.csv>]
+               [--repeats <n>] [--warmups <n>] [--data-dir <dir>] [--host-memory <bytes>] [--quick]
+ Runs the strong/weak scaling sweep of sliced circuit simulation (bench_scaling.hpp)
+ over process groups of the given numbers of processes (powers of two by default).
+ Circuits: circuit files <name>.txt in the data directory (sycamore_8_cnot by default),
+ optionally truncated to the first --gates gates, or synthetic random circuits ("random")
+ with --qubits qubits (at one process for weak scaling) and --layers gate layers.
+ The JSON report is written by process 0 (exatn_scaling.json by default), optionally
+ together with the CSV report. Two JSON reports are compared by exatn_bench_compare.
+**/
+
+#include "bench_scaling.hpp"
+
+#include "exatn.hpp"
+
+#ifdef MPI_ENABLED
+#include "mpi.h"
+#endif
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+#include "errors.hpp"
+
+#ifndef EXATN_BENCH_DATA_DIR
+#define EXATN_BENCH_DATA_DIR "."
+#endif
+
+int main(int argc, char **argv) {
+
+  //Parse the command line:
+  exatn::bench::ScalingConfig config;
+  config.bench.data_dir = EXATN_BENCH_DATA_DIR;
+  config.bench.output = "exatn_scaling.json";
+  config.bench.repeats = 3;
+  long long host_memory = 4LL*1024LL*1024LL*1024LL;
+  std::string mode = "strong";
+  for(int i = 1; i < argc; ++i){
+   const std::string arg(argv[i]);
+   const bool has_value = (i + 1 < argc);
+   if(arg == "--circuit" && has_value){
+    config.circuits.emplace_back(argv[++i]);
+   }else if(arg == "--optimizer" && has_value){
+    config.optimizers.emplace_back(argv[++i]);
+   }else if(arg == "--ranks" && has_value){
+    config.ranks.emplace_back(std::max(1,std::atoi(argv[++i])));
+   }else if(arg == "--memory" && has_value){
+    config.memory_limits.emplace_back(std::strtoull(argv[++i],nullptr,10));
+   }else if(arg == "--mode" && has_value){
+    mode = argv[++i];
+   }else if(arg == "--gates" && has_value){
+    config.num_gates = std::max(0,std::atoi(argv[++i]));
+   }else if(arg == "--qubits" && has_value){
+    config.random_qubits = std::max(2,std::atoi(argv[++i]));
+   }else if(arg == "--layers" && has_value){
+    config.random_layers = std::max(1,std::atoi(argv[++i]));
+   }else if(arg == "--seed" && has_value){
+    config.seed = std::atoi(argv[++i]);
+   }else if(arg == "--output" && has_value){
+    config.bench.output = argv[++i];
+   }else if(arg == "--csv" && has_value){
+    config.bench.csv_output = argv[++i];
+   }else if(arg == "--repeats" && has_value){
+    config.bench.repeats = std::max(1,std::atoi(argv[++i]));
+   }else if(arg == "--warmups" && has_value){
+    config.bench.warmups = std::max(0,std::atoi(argv[++i]));
+   }else if(arg == "--data-dir" && has_value){
+    config.bench.data_dir = argv[++i];
+   }else if(arg == "--host-memory" && has_value){
+    host_memory = std::atoll(argv[++i]);
+   }else if(arg == "--quick"){
+    config.bench.quick = true;
+   }else{
+    std::cout << "#ERROR(exatn_scaling): Invalid command line argument: " << arg << std::endl;
+    return 1;
+   }
+  }
+  if(mode == "strong" || mode == "weak" || mode == "both"){
+   config.strong = (mode != "weak");
+   config.weak = (mode != "strong");
+  }else{
+   std::cout << "#ERROR(exatn_scaling): Invalid scaling mode: " << mode << std::endl;
+   return 1;
+  }
+  if(config.bench.quick){ //smoke test: small circuits
+   if(config.circuits.empty()) config.circuits = {"sycamore_8_cnot","random"};
+   if(config.num_gates == 0) config.num_gates = 32;
+   config.random_qubits = std::min(config.random_qubits,12U);
+   config.random_layers = std::min(config.random_layers,4U);
+  }
+  if(config.circuits.empty()) config.circuits = {"sycamore_8_cnot"};
+  if(config.optimizers.empty()) config.optimizers = {"metis"};
+  if(config.memory_limits.empty()) config.memory_limits = {exatn::ProcessGroup::MAX_MEM_PER_PROCESS};
+
+  exatn::ParamConf exatn_parameters;
+  exatn_parameters.setParameter("host_memory_buffer_size",static_cast<int64_t>(host_memory));
+#ifdef MPI_ENABLED
+  int thread_provided;
+  int mpi_error = MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &thread_provided);
+  assert(mpi_error == MPI_SUCCESS);
+  assert(thread_provided == MPI_THREAD_MULTIPLE);
+  exatn::initialize(exatn::MPICommProxy(MPI_COMM_WORLD),exatn_parameters,"lazy-dag-executor");
+#else
+  exatn::initialize(exatn_parameters,"lazy-dag-executor");
+#endif
+  const bool master = (exatn::getProcessRank() == 0);
+
+  //Run the scaling sweep:
+  exatn::bench::BenchReport report(config.bench);
+  if(master) std::cout << "#MSG(exatn_scaling): Running the scaling sweep on "
+                       << exatn::getNumProcesses() << " processes" << std::endl << std::flush;
+  exatn::bench::benchScaling(config,report);
+  bool success = exatn::syncClean(); assert(success);
+
+  int error_code = 0;
+  if(master){
+   report.printIt();
+   if(report.writeJSON(config.bench.output)){
+    std::cout << "#MSG(exatn_scaling): Scaling report written to " << config.bench.output << std::endl;
+   }else{
+    std::cout << "#ERROR(exatn_scaling): Unable to write the scaling report to " << config.bench.output << std::endl;
+    error_code = 1;
+   }
+   if(!config.bench.csv_output.empty()){
+    if(report.writeCSV(config.bench.csv_output)){
+     std::cout << "#MSG(exatn_scaling): Scaling report written to " << config.bench.csv_output << std::endl;
+    }else{
+     std::cout << "#ERROR(exatn_scaling): Unable to write the scaling report to " << config.bench.csv_output << std::endl;
+     error_code = 1;
+    }
+   }
+  }
+
+  exatn::finalize();
+#ifdef MPI_ENABLED
+  mpi_error = MPI_Finalize(); assert(mpi_error == MPI_SUCCESS);
+#endif
+  return error_code;
+}
@@ -6,6 +6,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <complex>
 
 namespace exatn {
@@ -19,9 +20,15 @@ public:
   virtual const std::string interpretTAProL(const std::string& taProlStr) = 0;
 
   // Retrieve results of a TAProL job with given jobId.
-  // Currently retrieves saved complex<double> scalars.
+  // Retrieves the scalars computed by the job (e.g. norms) as complex<double>
+  // values, ordered by the scalar names. Blocks until the job has been executed.
   virtual const std::vector<std::complex<double>> getResults(const std::string& jobId) = 0;
 
+  // Retrieve the tensors copied out by a TAProL job with given jobId
+  // (data container name --> tensor elements as complex<double>).
+  virtual const std::map<std::string, std::vector<std::complex<double>>>
+  getTensorResults(const std::string& jobId) = 0;
+
   // Register an external tensor method, a subclass of TensorFunctor class
   // which overrides the .apply(talsh::Tensor &) method. This allows
   // an application to initialize and transform tensors is a custom way
@@ -30,6 +37,8 @@ public:
 
   // Register external data under some symbolic name. This data will be accessible
   // in TAProL text. It can be used to define tensor dimensions dynamically, for example.
+  // The packet holds an array of complex<double> elements which becomes a data container
+  // for tensor initialization in the TAProL jobs submitted afterwards.
   virtual void registerExternalData(const std::string& name, BytePacket& packet) = 0;
 
   // Shut down DriverClient.
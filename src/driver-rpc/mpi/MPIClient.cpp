@@ -4,11 +4,6 @@ namespace exatn {
 namespace rpc {
 namespace mpi {
 
-int MPIClient::SENDTAPROL_TAG = 0;
-int MPIClient::REGISTER_TENSORMETHOD = 1;
-int MPIClient::SYNC_TAG = 2;
-int MPIClient::SHUTDOWN_TAG = 3;
-
 void MPIClient::connect() {
   char portName[MPI_MAX_PORT_NAME];
 
@@ -31,19 +26,17 @@ void MPIClient::registerTensorMethod(const std::string& varName, talsh::TensorFu
 
   if (!connected) connect();
 
-//  char buf[1];
   auto name = method.name();
   std::cout << "[mpi-client] Sending TensorFunctor " << name << " to remote server.\n";
-  MPI_Send(name.c_str(), name.size(), MPI_CHAR, 0, REGISTER_TENSORMETHOD, serverComm);
-
-//  MPI_Send(buf, 1, MPI_CHAR, 0, REGISTER_TENSORMETHOD, serverComm);
 
-  BytePacket packet;
-  initBytePacket(&packet);
-  method.pack(packet);
+  auto packet = packetPool.acquire();
+  method.pack(*packet);
 
-  std::cout << "[mpi-client] Sending TensorFunctor data to remote server.\n";
-  MPI_Send(packet.base_addr, packet.size_bytes, MPI_BYTE, 0, 0, serverComm);
+  Message message(MessageKind::REGISTER_TENSORMETHOD);
+  message.append(name);
+  const char * bytes = static_cast<const char*>(packet->base_addr);
+  message.append(std::vector<char>(bytes, bytes + packet->size_bytes));
+  message.send(0, serverComm);
 
   return;
 }
@@ -52,11 +45,15 @@ void MPIClient::registerExternalData(const std::string& name, BytePacket& packet
 
   if (!connected) connect();
 
-  std::cout << "[mpi-client] Sending External Data ID " << name << " to remote server.\n";
-  //MPI_Send(name.c_str(), name.size(), MPI_CHAR, 0, REGISTER_EXTDATA, serverComm);
+  std::cout << "[mpi-client] Sending External Data " << name << " to remote server.\n";
 
-  std::cout << "[mpi-client] Sending External Data to remote server.\n";
-  //MPI_Send(packet.base_addr, packet.size_bytes, MPI_BYTE, 0, 0, serverComm);
+  assert(packet.size_bytes % sizeof(std::complex<double>) == 0);
+  const auto * elements = static_cast<const std::complex<double>*>(packet.base_addr);
+  Message message(MessageKind::REGISTER_EXTDATA);
+  message.append(name);
+  message.append(std::vector<std::complex<double>>(elements,
+                  elements + packet.size_bytes / sizeof(std::complex<double>)));
+  message.send(0, serverComm);
 
   return;
 }
@@ -67,72 +64,97 @@ const std::string MPIClient::interpretTAProL(const std::string& taProlStr) {
   if (!connected) connect();
 
   auto jobId = generateRandomString();
+  while (submissions.find(jobId) != submissions.end() || results.find(jobId) != results.end())
+    jobId = generateRandomString();
 
-  // Analyze the taProlStr to see how many GET commands there are
-  // and populate the jobId2NResults map
-  int nResults = 0;
-  auto position = taProlStr.find("save",0);
-  while (position != std::string::npos) {
-      nResults++;
-      position = taProlStr.find("save",position+1);
-  }
-  std::cout << "[mpi-client] This TAProL program produces " << nResults << " scalar results.\n";
-
-  jobId2NResults.insert({jobId, nResults});
-
-  // Asynchronously send the taProl string to the server
-  MPI_Request request;
+  // Asynchronously send the taProl string to the server,
+  // the server queues the job and executes it in order
   std::cout << "[mpi-client] sending request with jobid " << jobId << "\n";
-  MPI_Isend(taProlStr.c_str(), taProlStr.size(), MPI_CHAR, 0, SENDTAPROL_TAG, serverComm,
-            &request);
-
-  // Store the request object for us to use
-  // later to wait on results in retrieveResult
-  requests.insert({jobId, request});
+  auto message = std::make_shared<Message>(MessageKind::SUBMIT_TAPROL);
+  message->append(jobId);
+  message->append(taProlStr);
+  auto & submission = submissions[jobId];
+  submission.message = message;
+  message->isend(0, serverComm, submission.requests);
 
   return jobId;
 }
 
-// Retrieve results of a TAProL job with given jobId.
-// Currently retrieves saved complex<double> scalars.
-const std::vector<std::complex<double>> MPIClient::getResults(const std::string& jobId) {
+const MPIClient::JobResults & MPIClient::fetchResults(const std::string& jobId) {
 
   if (!connected) connect();
 
-  auto request = requests[jobId];
+  auto cached = results.find(jobId);
+  if (cached != results.end()) return cached->second;
 
-  MPI_Status status, status2;
-  MPI_Wait(&request, &status);
+  auto submission = submissions.find(jobId);
+  if (submission != submissions.end()) {
+    auto & requests = submission->second.requests;
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    submissions.erase(submission);
+  }
 
-  // now we know the execution has occurred,
-  // send a synchronize command to driver
-  // Tag of 1 == SYNCHRONIZE command
-  char buf[1];
-  MPI_Send(buf, 1, MPI_CHAR, 0, SYNC_TAG, serverComm);
+  // Request the results, they arrive in a single message once the job has been executed
+  Message request(MessageKind::GET_RESULTS);
+  request.append(jobId);
+  request.send(0, serverComm);
+
+  Message reply;
+  reply.receive(0, serverComm);
+  assert(reply.getKind() == MessageKind::RESULTS);
+  std::string replyJobId;
+  reply.extract(replyJobId);
+  assert(replyJobId == jobId);
+
+  auto & jobResults = results[jobId];
+  std::uint8_t success = 0;
+  reply.extract(success);
+  jobResults.success = (success != 0);
+  std::uint64_t numScalars = 0;
+  reply.extract(numScalars);
+  for (std::uint64_t k = 0; k < numScalars; k++) {
+    std::string name;
+    std::complex<double> value;
+    reply.extract(name);
+    reply.extract(value);
+    jobResults.scalars.push_back(value);
+  }
+  std::uint64_t numTensors = 0;
+  reply.extract(numTensors);
+  for (std::uint64_t k = 0; k < numTensors; k++) {
+    std::string name;
+    reply.extract(name);
+    reply.extract(jobResults.tensors[name]);
+  }
+  if (!jobResults.success)
+    std::cout << "#ERROR(exatn::rpc::mpi::MPIClient): Job " << jobId << " failed!" << std::endl;
+  return jobResults;
+}
 
-  // now get all the results
+// Retrieve results of a TAProL job with given jobId.
+const std::vector<std::complex<double>> MPIClient::getResults(const std::string& jobId) {
+  return fetchResults(jobId).scalars;
+}
 
-  std::vector<std::complex<double>> results;
-  for (int k = 0; k < jobId2NResults[jobId]; k++) {
-    double r, i;
-    MPI_Recv(&r, 1, MPI_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, serverComm, &status2);
-    MPI_Recv(&i, 1, MPI_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, serverComm, &status2);
-    results.push_back(std::complex<double>(r,i));
-  }
-  return results;
+// Retrieve the tensors copied out by a TAProL job with given jobId.
+const std::map<std::string, std::vector<std::complex<double>>>
+MPIClient::getTensorResults(const std::string& jobId) {
+  return fetchResults(jobId).tensors;
 }
 
 void MPIClient::shutdown() {
   if (!connected) connect();
 
-  char buf[1];
-  MPI_Request request;
+  // Complete all outstanding submissions first
+  for (auto & submission : submissions) {
+    auto & requests = submission.second.requests;
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+  }
+  submissions.clear();
+
   std::cout << "[mpi-client] sending shutdown.\n";
-  // Tag of 2 == SHUTDOWN command
-  MPI_Isend(buf, 1, MPI_CHAR, 0, SHUTDOWN_TAG, serverComm, &request);
-   MPI_Status status;
-   std::cout << "[mpi-client] waiting for shutdown.\n";
-  MPI_Wait(&request, &status);
+  Message message(MessageKind::SHUTDOWN);
+  message.send(0, serverComm);
   MPI_Comm_disconnect(&serverComm);
 }
 
@@ -2,11 +2,14 @@
 #define EXATN_MPICLIENT_HPP_
 
 #include "DriverClient.hpp"
+#include "MPIProtocol.hpp"
+#include "byte_packet_utils.hpp"
 #include "mpi.h"
 
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <memory>
 #include <iostream>
 
 namespace exatn {
@@ -32,19 +35,30 @@ private:
 
 protected:
 
-  MPI_Comm serverComm;
-  std::map<std::string, MPI_Request> requests;
-  std::map<std::string, int> jobId2NResults;
-  std::vector<std::complex<double>> results;
+  // Results of a TAProL job.
+  struct JobResults {
+    bool success = false;                                               // execution status
+    std::vector<std::complex<double>> scalars;                          // computed scalars ordered by name
+    std::map<std::string, std::vector<std::complex<double>>> tensors;   // retrieved tensors
+  };
 
-  static int SYNC_TAG;
-  static int SHUTDOWN_TAG;
-  static int SENDTAPROL_TAG;
-  static int REGISTER_TENSORMETHOD;
+  // Submitted TAProL job: the submission message stays alive until sent.
+  struct Submission {
+    std::shared_ptr<Message> message;
+    std::vector<MPI_Request> requests;
+  };
+
+  MPI_Comm serverComm;
+  std::map<std::string, Submission> submissions; // job id --> submission in flight
+  std::map<std::string, JobResults> results;     // job id --> retrieved results
+  exatn::BytePacketPool packetPool;              // reusable byte packets for packing tensor methods
 
   bool connected = false;
   void connect();
 
+  // Retrieves the results of a job from the server (once).
+  const JobResults & fetchResults(const std::string& jobId);
+
 public:
 
   MPIClient() = default;
@@ -53,9 +67,13 @@ public:
   const std::string interpretTAProL(const std::string& taProlStr) override;
 
   // Retrieve results of a TAProL job with given jobId.
-  // Currently retrieves saved complex<double> scalars.
+  // Retrieves the scalars computed by the job as complex<double> values ordered by name.
   const std::vector<std::complex<double>> getResults(const std::string& jobId) override;
 
+  // Retrieve the tensors copied out by a TAProL job with given jobId.
+  const std::map<std::string, std::vector<std::complex<double>>>
+  getTensorResults(const std::string& jobId) override;
+
   // Register an external tensor method, a subclass of TensorFunctor class
   // which overrides the .apply(talsh::Tensor &) method. This allows
   // an application to initialize and transform tensors is a custom way
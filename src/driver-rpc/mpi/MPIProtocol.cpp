@@ -0,0 +1,57 @@
+#include "MPIProtocol.hpp"
+
+namespace exatn {
+namespace rpc {
+namespace mpi {
+
+namespace {
+const int HEADER_TAG = 100;
+const int PAYLOAD_TAG = 101;
+const std::size_t MAX_CHUNK_BYTES = (1UL << 30); // must fit into an int count
+} // namespace
+
+void Message::send(int rank, MPI_Comm comm) {
+  std::vector<MPI_Request> requests;
+  isend(rank, comm, requests);
+  MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+void Message::isend(int rank, MPI_Comm comm, std::vector<MPI_Request> & requests) {
+  header_[0] = static_cast<std::uint64_t>(kind_);
+  header_[1] = payload_.size();
+  MPI_Request request;
+  MPI_Isend(header_, sizeof(header_), MPI_BYTE, rank, HEADER_TAG, comm, &request);
+  requests.emplace_back(request);
+  for (std::size_t offset = 0; offset < payload_.size(); offset += MAX_CHUNK_BYTES) {
+    const auto chunk = payload_.size() - offset;
+    const auto count = (chunk < MAX_CHUNK_BYTES) ? chunk : MAX_CHUNK_BYTES;
+    MPI_Isend(&payload_[offset], static_cast<int>(count), MPI_BYTE, rank, PAYLOAD_TAG, comm, &request);
+    requests.emplace_back(request);
+  }
+}
+
+int Message::receive(int rank, MPI_Comm comm) {
+  MPI_Status status;
+  MPI_Recv(header_, sizeof(header_), MPI_BYTE, rank, HEADER_TAG, comm, &status);
+  kind_ = static_cast<MessageKind>(header_[0]);
+  payload_.resize(header_[1]);
+  position_ = 0;
+  // The payload chunks follow the header from the same source:
+  for (std::size_t offset = 0; offset < payload_.size(); offset += MAX_CHUNK_BYTES) {
+    const auto chunk = payload_.size() - offset;
+    const auto count = (chunk < MAX_CHUNK_BYTES) ? chunk : MAX_CHUNK_BYTES;
+    MPI_Recv(&payload_[offset], static_cast<int>(count), MPI_BYTE, status.MPI_SOURCE, PAYLOAD_TAG,
+             comm, MPI_STATUS_IGNORE);
+  }
+  return status.MPI_SOURCE;
+}
+
+bool Message::probe(int rank, MPI_Comm comm) {
+  int flag = 0;
+  MPI_Iprobe(rank, HEADER_TAG, comm, &flag, MPI_STATUS_IGNORE);
+  return (flag != 0);
+}
+
+} // namespace mpi
+} // namespace rpc
+} // namespace exatn
@@ -0,0 +1,132 @@
+#ifndef EXATN_DRIVER_MPIPROTOCOL_HPP_
+#define EXATN_DRIVER_MPIPROTOCOL_HPP_
+
+#include "mpi.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+namespace exatn {
+namespace rpc {
+namespace mpi {
+
+// Framed binary protocol of the MPI driver: Each message consists of a fixed-size
+// header (message kind, payload size in bytes) followed by a payload of arbitrary
+// length which is sent in chunks of bounded size. Messages between the same pair
+// of processes arrive in order (MPI non-overtaking rule), thus the payload chunks
+// are always received right after their header.
+
+enum class MessageKind : std::uint64_t {
+  SUBMIT_TAPROL = 0,     // job id, TAProL source
+  REGISTER_TENSORMETHOD, // tensor method name, packed tensor method
+  REGISTER_EXTDATA,      // data container name, data container elements (complex<double>)
+  GET_RESULTS,           // job id
+  RESULTS,               // job id, status, scalar results, retrieved tensors
+  SHUTDOWN               // empty payload
+};
+
+class Message {
+
+public:
+
+  explicit Message(MessageKind kind = MessageKind::SHUTDOWN) : kind_(kind), position_(0) {}
+
+  // A message may be in flight, thus it is not copyable.
+  Message(const Message &) = delete;
+  Message & operator=(const Message &) = delete;
+
+  MessageKind getKind() const { return kind_; }
+
+  // Returns the payload size in bytes.
+  std::size_t getSize() const { return payload_.size(); }
+
+  // Appends a trivially copyable value to the payload.
+  template <typename T>
+  void append(const T & value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Non-trivially copyable message field!");
+    appendBytes(&value, sizeof(T));
+  }
+
+  // Appends a size-prefixed string to the payload.
+  void append(const std::string & str) {
+    append(static_cast<std::uint64_t>(str.size()));
+    appendBytes(str.data(), str.size());
+  }
+
+  // Appends a size-prefixed array of trivially copyable elements to the payload.
+  template <typename T>
+  void append(const std::vector<T> & vec) {
+    static_assert(std::is_trivially_copyable<T>::value, "Non-trivially copyable message field!");
+    append(static_cast<std::uint64_t>(vec.size()));
+    appendBytes(vec.data(), vec.size() * sizeof(T));
+  }
+
+  // Extracts the next trivially copyable value from the payload.
+  template <typename T>
+  void extract(T & value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Non-trivially copyable message field!");
+    extractBytes(&value, sizeof(T));
+  }
+
+  // Extracts the next size-prefixed string from the payload.
+  void extract(std::string & str) {
+    std::uint64_t size = 0;
+    extract(size);
+    str.resize(size);
+    extractBytes(&str[0], size);
+  }
+
+  // Extracts the next size-prefixed array from the payload.
+  template <typename T>
+  void extract(std::vector<T> & vec) {
+    static_assert(std::is_trivially_copyable<T>::value, "Non-trivially copyable message field!");
+    std::uint64_t size = 0;
+    extract(size);
+    vec.resize(size);
+    extractBytes(vec.data(), size * sizeof(T));
+  }
+
+  // Blocking send of the message to the given rank.
+  void send(int rank, MPI_Comm comm);
+
+  // Non-blocking send of the message to the given rank: The message must
+  // stay alive and unchanged until all appended requests have completed.
+  void isend(int rank, MPI_Comm comm, std::vector<MPI_Request> & requests);
+
+  // Blocking receive of the next message from the given rank (or MPI_ANY_SOURCE),
+  // replacing the current content of the message. Returns the source rank.
+  int receive(int rank, MPI_Comm comm);
+
+  // Returns whether or not a message from the given rank (or MPI_ANY_SOURCE) is pending.
+  static bool probe(int rank, MPI_Comm comm);
+
+private:
+
+  void appendBytes(const void * src, std::size_t size) {
+    if (size == 0) return;
+    const auto offset = payload_.size();
+    payload_.resize(offset + size);
+    std::memcpy(&payload_[offset], src, size);
+  }
+
+  void extractBytes(void * dest, std::size_t size) {
+    if (size == 0) return;
+    assert(position_ + size <= payload_.size());
+    std::memcpy(dest, &payload_[position_], size);
+    position_ += size;
+  }
+
+  MessageKind kind_;            // message kind
+  std::uint64_t header_[2];     // message header in flight: {kind, payload size}
+  std::vector<char> payload_;   // serialized payload
+  std::size_t position_;        // current extraction position in the payload
+};
+
+} // namespace mpi
+} // namespace rpc
+} // namespace exatn
+#endif
@@ -1,132 +1,298 @@
 #include "MPIServer.hpp"
 #include "exatn.hpp"
+#include "talshxx.hpp"
 
-#include <future>
+#include <chrono>
+#include <thread>
 
 namespace exatn {
 namespace rpc {
 namespace mpi {
 
-int MPIServer::SENDTAPROL_TAG = 0;
-int MPIServer::REGISTER_TENSORMETHOD = 1;
-int MPIServer::SYNC_TAG = 2;
-int MPIServer::SHUTDOWN_TAG = 3;
+namespace {
+
+// Reads the elements of a local tensor copy as double complex values.
+template <typename NumericType>
+bool readTensorData(const talsh::Tensor & local_tensor, std::vector<std::complex<double>> & elements) {
+  const NumericType * body_ptr = nullptr;
+  if (!local_tensor.getDataAccessHostConst(&body_ptr)) return false;
+  const std::size_t volume = local_tensor.getVolume();
+  elements.resize(volume);
+  for (std::size_t i = 0; i < volume; i++) elements[i] = std::complex<double>(body_ptr[i]);
+  return true;
+}
+
+// Hashes an array of bytes (FNV-1a).
+std::size_t hashBytes(const void * bytes, std::size_t size) {
+  const auto * ptr = static_cast<const unsigned char*>(bytes);
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= ptr[i];
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+// Combines two hash values.
+std::size_t combineHashes(std::size_t seed, std::size_t hash) {
+  return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+} // namespace
 
 void MPIServer::start() {
 
   parser = std::make_shared<exatn::parser::TAProLInterpreter>();
-  // FIXME Provide hook for specifying this at runtime
-//   backend = exatn::getService<exatn::numerics::Backend>("talsh");
-
-//   backend->initialize();
 
   listen = true;
 
-  MPI_Comm client;
-  MPI_Status status;
-
   int size;
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-  char buf[1000];
   char portName[MPI_MAX_PORT_NAME];
 
   MPI_Open_port(MPI_INFO_NULL, portName);
   std::cout << "[mpi-server] starting server at port name " << portName << "\n";
 
-  MPI_Send(portName, MPI_MAX_PORT_NAME, MPI_CHAR, 1, 0, MPI_COMM_WORLD);
-  MPI_Comm_accept(portName, MPI_INFO_NULL, 0, MPI_COMM_SELF, &client);
-
-  while (listen) {
-    std::cout << "[mpi-server] accepting incoming connection.\n";
+  // Every other process of MPI_COMM_WORLD is a client:
+  for (int rank = 1; rank < size; rank++)
+    MPI_Send(portName, MPI_MAX_PORT_NAME, MPI_CHAR, rank, 0, MPI_COMM_WORLD);
+  for (int rank = 1; rank < size; rank++) {
+    Client client;
+    MPI_Comm_accept(portName, MPI_INFO_NULL, 0, MPI_COMM_SELF, &(client.comm));
+    clients.emplace_back(std::move(client));
+    std::cout << "[mpi-server] accepted client " << clients.size() - 1 << ".\n";
+  }
+  MPI_Close_port(portName);
 
-    std::cout << "[mpi-server] Listening for requests.\n";
-    std::cout << "[mpi-server] Running MPI_Recv.\n";
+  std::cout << "[mpi-server] Listening for requests.\n";
 
-    int messageLength;
+  // Incoming requests are always drained first and the queued jobs are executed
+  // in between, thus the clients never wait for a job to be executed when submitting.
+  // The server stops once all clients have shut down.
+  while (listen) {
+    bool received = false;
+    for (std::size_t clientId = 0; clientId < clients.size(); clientId++) {
+      if (clients[clientId].connected && Message::probe(MPI_ANY_SOURCE, clients[clientId].comm)) {
+        Message message;
+        message.receive(MPI_ANY_SOURCE, clients[clientId].comm);
+        handleMessage(message, clientId);
+        received = true;
+      }
+    }
+    progressOutbox(false);
+    if (!received && !executeNextJob())
+      std::this_thread::sleep_for(std::chrono::microseconds(100)); // idle
+  }
 
-    MPI_Recv(buf, 1000, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
-    MPI_Get_count(&status, MPI_CHAR, &messageLength);
-    buf[messageLength] = '\0';
+  progressOutbox(true);
+  std::cout << "[mpi-server] Out of event loop.\n";
+  for (auto & client : clients)
+    MPI_Comm_disconnect(&(client.comm));
+  clients.clear();
+  return;
+}
 
-    std::cout << "[mpi-server] received: " << std::string(buf) << "\n";
+void MPIServer::handleMessage(Message & message, std::size_t clientId) {
+
+  auto & client = clients[clientId];
+
+  switch (message.getKind()) {
+
+  case MessageKind::SUBMIT_TAPROL: {
+    std::string jobId;
+    message.extract(jobId);
+    auto & job = client.jobs[jobId];
+    message.extract(job.source);
+    job.data.containers = client.dataContainers;
+    // Result cache key: {program hash, hash of the registered external data}
+    std::size_t dataHash = 0;
+    for (const auto & dataHashEntry : client.dataHashes)
+      dataHash = combineHashes(combineHashes(dataHash, std::hash<std::string>{}(dataHashEntry.first)),
+                               dataHashEntry.second);
+    job.key = std::make_pair(std::hash<std::string>{}(job.source), dataHash);
+    auto cached = resultCache.find(job.key);
+    if (cached != resultCache.end() && cached->second.source == job.source) {
+      std::cout << "[mpi-server] Serving job " << jobId << " of client " << clientId << " from the result cache.\n";
+      job.data.scalars = cached->second.data.scalars;
+      job.data.tensors = cached->second.data.tensors;
+      job.executed = true;
+      job.success = true;
+    } else {
+      std::cout << "[mpi-server] Queueing job " << jobId << " of client " << clientId << ".\n";
+      client.jobQueue.emplace_back(jobId);
+    }
+    break;
+  }
 
-    if (status.MPI_TAG == SYNC_TAG) {
+  case MessageKind::GET_RESULTS: {
+    std::string jobId;
+    message.extract(jobId);
+    auto iter = client.jobs.find(jobId);
+    if (iter != client.jobs.end() && !iter->second.executed) {
+      client.resultRequests.emplace(jobId); // the results will be sent once the job is executed
+    } else {
+      sendResults(clientId, jobId);
+    }
+    break;
+  }
 
-      // ExaTensor SYNCHRONIZE commands
-      std::cout << "[mpi-server] synchronizing!\n";
+  case MessageKind::REGISTER_TENSORMETHOD: {
+    std::string tmName;
+    message.extract(tmName);
+    std::vector<char> bytes;
+    message.extract(bytes);
 
-      // FIXME SYNCHRONIZE TALSH/EXATENSOR
-    //   parser->numerics_server->synchronize();
+    std::cout << "[mpi-server] Registering tensor method " << tmName << ".\n";
 
-      // Now take the results and execute an
-      // asynchronous Isend back to the client rank 0
-      for (int i = 0; i < nResults; i++) {
-        MPI_Request request;
-        std::cout << "[mpi-server] processed taprol, returning result.\n";
+    auto packet = packetPool.acquire(bytes.size());
+    if (!bytes.empty()) std::memcpy(packet->base_addr, bytes.data(), bytes.size());
+    packet->size_bytes = bytes.size();
 
-        // We have a set of results for each GET in the
-        // TAPROL program, so now lets send them
-        // to the client as (real,imag) complex numbers
-        // FIXME assuming 1 value right now
-        double real = (i+1)*3.3;
-        double imag = (i+1)*3.3;
+    auto tensor_method = exatn::getService<talsh::TensorFunctor<Identifiable>>(tmName);
+    tensor_method->unpack(*packet);
+    exatn::numericalServer->registerTensorMethod(tensor_method->name(),tensor_method);
+    registeredTensorMethods[tmName] = tensor_method;
 
-        MPI_Isend(&real, 1, MPI_DOUBLE, 0, 0, client, &request);
-        MPI_Isend(&imag, 1, MPI_DOUBLE, 0, 0, client, &request);
-      }
+    // The cached results may depend on the previous state of the tensor method:
+    resultCache.clear();
+    resultCacheOrder.clear();
 
-      nResults = 0;
+    std::cout << "[mpi-server] Successfully created tensor method, added to backend.\n";
+    break;
+  }
 
-    } else if (status.MPI_TAG == SHUTDOWN_TAG) {
+  case MessageKind::REGISTER_EXTDATA: {
+    std::string name;
+    message.extract(name);
+    auto & container = client.dataContainers[name];
+    message.extract(container);
+    client.dataHashes[name] = hashBytes(container.data(), container.size() * sizeof(std::complex<double>));
+    std::cout << "[mpi-server] Registered data container " << name << " of size "
+              << container.size() << " for client " << clientId << ".\n";
+    break;
+  }
 
+  case MessageKind::SHUTDOWN: {
+    std::cout << "[mpi-server] client " << clientId << " shut down.\n";
+    client.connected = false;
+    client.jobQueue.clear();
+    client.jobs.clear();
+    client.resultRequests.clear();
+    bool connected = false;
+    for (const auto & other : clients) connected = connected || other.connected;
+    if (!connected) {
       std::cout << "[mpi-server] received stop command\n";
       stop();
+    }
+    break;
+  }
 
-    } else if (status.MPI_TAG == SENDTAPROL_TAG) {
-
-      std::cout << "[mpi-server] Executing taprol commands.\n";
+  default:
+    std::cout << "#ERROR(exatn::rpc::mpi::MPIServer): Unexpected message kind: "
+              << static_cast<std::uint64_t>(message.getKind()) << std::endl;
+  }
+  return;
+}
 
-      std::string taProlProg(buf);
-      auto position = taProlProg.find("save", 0);
-      while (position != std::string::npos) {
-        nResults++;
-        position = taProlProg.find("save", position + 1);
+bool MPIServer::executeNextJob() {
+  // Fair share: the clients with queued jobs take turns
+  for (std::size_t n = 0; n < clients.size(); n++) {
+    const auto clientId = (nextClient + n) % clients.size();
+    auto & client = clients[clientId];
+    if (client.jobQueue.empty()) continue;
+    nextClient = (clientId + 1) % clients.size();
+
+    auto jobId = client.jobQueue.front();
+    client.jobQueue.pop_front();
+    auto & job = client.jobs[jobId];
+
+    std::cout << "[mpi-server] Executing job " << jobId << " of client " << clientId << ".\n";
+    job.success = parser->execute(job.source, job.data);
+    job.executed = true;
+
+    if (job.success && resultCacheCapacity > 0) {
+      if (resultCache.find(job.key) == resultCache.end()) {
+        if (resultCache.size() >= resultCacheCapacity) {
+          resultCache.erase(resultCacheOrder.front());
+          resultCacheOrder.pop_front();
+        }
+        resultCacheOrder.emplace_back(job.key);
       }
+      auto & cached = resultCache[job.key];
+      cached.source = job.source;
+      cached.data.scalars = job.data.scalars;
+      cached.data.tensors = job.data.tensors;
+    }
 
-      std::cout << "[mpi-server] Found " << nResults << " save calls.\n";
-
-      // FIXME with DMITRY:
-      // Execute the TAPROL with our Numerics backend
-    //   backend->execute(taProlProg);
-      parser->interpret(taProlProg);
-
-    } else if (status.MPI_TAG == REGISTER_TENSORMETHOD) {
-
-        std::string tmName(buf);
-
-        std::cout << "[mpi-server] Registering tensor method " << tmName << ".\n";
-
-        MPI_Status status;
-        BytePacket packet;
-        int count;
-        initBytePacket(&packet);
-        MPI_Recv(packet.base_addr, packet.capacity, MPI_BYTE, 0, 0, client, &status);
-        MPI_Get_count(&status, MPI_BYTE, &count);
-        packet.size_bytes = count;
-
-        auto tensor_method = exatn::getService<talsh::TensorFunctor<Identifiable>>(tmName);
-        tensor_method->unpack(packet);
-        exatn::numericalServer->registerTensorMethod(tensor_method->name(),tensor_method);
-
-        std::cout << "[mpi-server] Successfully created tensor method, added to backend.\n";
+    auto request = client.resultRequests.find(jobId);
+    if (request != client.resultRequests.end()) {
+      client.resultRequests.erase(request);
+      sendResults(clientId, jobId);
+    }
+    return true;
+  }
+  return false;
+}
 
+void MPIServer::sendResults(std::size_t clientId, const std::string & jobId) {
+  auto & client = clients[clientId];
+  auto message = std::make_shared<Message>(MessageKind::RESULTS);
+  message->append(jobId);
+  auto iter = client.jobs.find(jobId);
+  if (iter == client.jobs.end()) {
+    std::cout << "#ERROR(exatn::rpc::mpi::MPIServer): Unknown job: " << jobId << std::endl;
+    message->append(static_cast<std::uint8_t>(0));
+    message->append(static_cast<std::uint64_t>(0));
+    message->append(static_cast<std::uint64_t>(0));
+  } else {
+    const auto & job = iter->second;
+    message->append(static_cast<std::uint8_t>(job.success ? 1 : 0));
+    // Scalar results (ordered by name):
+    message->append(static_cast<std::uint64_t>(job.data.scalars.size()));
+    for (const auto & scalar : job.data.scalars) {
+      message->append(scalar.first);
+      message->append(std::complex<double>(scalar.second, 0.0));
+    }
+    // Retrieved tensors:
+    message->append(static_cast<std::uint64_t>(job.data.tensors.size()));
+    for (const auto & tensor : job.data.tensors) {
+      std::vector<std::complex<double>> elements;
+      if (tensor.second) {
+        bool read = readTensorData<double>(*(tensor.second), elements) ||
+                    readTensorData<std::complex<double>>(*(tensor.second), elements) ||
+                    readTensorData<float>(*(tensor.second), elements) ||
+                    readTensorData<std::complex<float>>(*(tensor.second), elements);
+        assert(read);
+      }
+      message->append(tensor.first);
+      message->append(elements);
     }
+    client.jobs.erase(iter); // the results are delivered only once
   }
+  std::cout << "[mpi-server] Returning results of job " << jobId << " to client " << clientId << " ("
+            << message->getSize() << " bytes).\n";
+  outbox.emplace_back(OutgoingMessage{message, {}});
+  message->isend(0, client.comm, outbox.back().requests);
+  return;
+}
 
-  std::cout << "[mpi-server] Out of event loop.\n";
-  MPI_Comm_disconnect(&client);
-//   backend->shutdown();
+void MPIServer::progressOutbox(bool wait) {
+  for (auto iter = outbox.begin(); iter != outbox.end();) {
+    auto & requests = iter->requests;
+    int completed = 0;
+    if (wait) {
+      MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+      completed = 1;
+    } else {
+      MPI_Testall(static_cast<int>(requests.size()), requests.data(), &completed, MPI_STATUSES_IGNORE);
+    }
+    if (completed != 0) {
+      iter = outbox.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
   return;
 }
 
@@ -134,4 +300,4 @@ void MPIServer::stop() { listen = false; }
 
 } // namespace mpi
 } // namespace rpc
-} // namespace exatn
\ No newline at end of file
+} // namespace exatn
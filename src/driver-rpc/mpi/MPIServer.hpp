@@ -2,10 +2,19 @@
 #define EXATN_DRIVER_MPISERVER_HPP_
 
 #include "DriverServer.hpp"
+#include "MPIProtocol.hpp"
+#include "byte_packet_utils.hpp"
 #include "mpi.h"
 
+#include <complex>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace exatn {
 namespace rpc {
@@ -13,17 +22,70 @@ namespace mpi {
 class MPIServer : public DriverServer {
 
 protected:
+
+  // TAProL job submitted by a client.
+  struct Job {
+    std::string source;                    // TAProL source
+    exatn::parser::TAProLProgramData data; // external data and results
+    std::pair<std::size_t, std::size_t> key; // result cache key: {program hash, external data hash}
+    bool executed = false;                 // whether or not the job has been executed
+    bool success = false;                  // execution status
+  };
+
+  // Connected client with its own job queue and data containers.
+  struct Client {
+    MPI_Comm comm;
+    bool connected = true;
+    std::map<std::string, std::vector<std::complex<double>>> dataContainers; // registered external data
+    std::map<std::string, std::size_t> dataHashes;                           // data container name --> data hash
+    std::map<std::string, Job> jobs;       // submitted jobs whose results have not been delivered yet
+    std::deque<std::string> jobQueue;      // ids of the jobs awaiting execution (FIFO)
+    std::set<std::string> resultRequests;  // ids of the queued jobs whose results have been requested
+  };
+
+  // Cached results of a successfully executed job.
+  struct CachedResults {
+    std::string source;                    // TAProL source (guards against hash collisions)
+    exatn::parser::TAProLProgramData data; // computed scalars and retrieved tensors
+  };
+
+  // Outgoing message with its pending send requests.
+  struct OutgoingMessage {
+    std::shared_ptr<Message> message;
+    std::vector<MPI_Request> requests;
+  };
+
   bool listen = false;
-  int nResults = 0;
-  static int SYNC_TAG;
-  static int SHUTDOWN_TAG;
-  static int SENDTAPROL_TAG;
-  static int REGISTER_TENSORMETHOD;
 
   std::string portName = "exatn-mpi-driver";
 
   std::map<std::string, std::shared_ptr<talsh::TensorFunctor<Identifiable>>> registeredTensorMethods;
 
+  std::vector<Client> clients;       // connected clients
+  std::size_t nextClient = 0;        // next client to execute a job for (round-robin fair share)
+
+  std::map<std::pair<std::size_t, std::size_t>, CachedResults> resultCache; // result cache
+  std::deque<std::pair<std::size_t, std::size_t>> resultCacheOrder;       // result cache keys in insertion order
+  std::size_t resultCacheCapacity = 64;                                    // max number of cached results
+
+  std::list<OutgoingMessage> outbox; // outgoing messages in flight
+
+  exatn::BytePacketPool packetPool;  // reusable byte packets for unpacking tensor methods
+
+  // Processes a message received from a client.
+  void handleMessage(Message & message, std::size_t clientId);
+
+  // Executes the next queued job in round-robin order over the clients
+  // and delivers its results if they have been requested. Returns FALSE
+  // if there are no queued jobs.
+  bool executeNextJob();
+
+  // Sends the results of an executed job back to the client in a single message.
+  void sendResults(std::size_t clientId, const std::string & jobId);
+
+  // Releases the completed outgoing messages (waits for all of them if requested).
+  void progressOutbox(bool wait);
+
 public:
   MPIServer() : DriverServer() {}
 
@@ -8,19 +8,19 @@ using namespace exatn::rpc;
 const std::string src = R"src(
 entry: main
 scope main group()
- subspace(): s0=[0:127]
- index(s0): a,b,c,d,i,j,k,l
+ space(real): vs=[0:7]
+ index(vs): a,b,c,d
+ T2(a,b,c,d) = t2_data
+ H2(a,b,c,d) = 1.0
  H2(a,b,c,d) = method("HamiltonianTest")
- T2(a,b,c,d) = {1.0,0.0}
- Z2(a,b,c,d) = {0.0,0.0}
- Z2(a,b,c,d) += H2(i,j,k,l) * T2(c,d,i,j) * T2(a,b,k,l)
- X2() = {0.0,0.0}
- X2() += Z2+(a,b,c,d) * Z2(a,b,c,d)
- save X2: tag("Z2_norm")
- ~X2
- ~Z2
- ~T2
- ~H2
+ X2() = 0.0
+ X2() += T2(a,b,c,d) * T2(a,b,c,d)
+ Y2() = 0.0
+ Y2() += H2(a,b,c,d) * T2(a,b,c,d)
+ norm_x2 = norm1(X2)
+ norm_y2 = norm1(Y2)
+ t2 = T2
+ destroy X2,Y2,H2,T2
 end scope main
 )src";
 
@@ -30,36 +30,35 @@ TEST(client_test, checkSimple) {
 
   auto tm = exatn::getService<talsh::TensorFunctor<exatn::Identifiable>>("HamiltonianTest");
 
-// How to set the state of the TensorFunctor ...
-//   BytePacket p;
-//   initBytePacket(&p);
-//   appendToBytePacket(&p, .002);
-//   tm->unpack(p);
-
   // Create the client
   auto client = exatn::getService<DriverClient>("mpi");
   client->registerTensorMethod("test", *tm.get());
 
-  // Send some taprol asynchronously, here its just
-  // a test so just send any string
-  auto jobId = client->interpretTAProL(src);
-
-  std::cout << "[client.cpp] job-id = " << jobId << ".\n";
-
-  // Retrieve the result
-  auto values = client->getResults(jobId);
-  EXPECT_EQ(3.3, std::real(values[0]));
-  EXPECT_EQ(3.3, std::imag(values[0]));
-
-  std::cout << "[client.cpp] value is " << std::real(values[0]) << ", " << std::imag(values[0]) << "\n";
-
-  // Try it again!
-  jobId = client->interpretTAProL(src);
-  values = client->getResults(jobId);
-
-  EXPECT_EQ(3.3, std::real(values[0]));
-  EXPECT_EQ(3.3, std::imag(values[0]));
-  std::cout << "[client.cpp] value second time is " << std::real(values[0]) << ", " << std::imag(values[0]) << "\n";
+  // Register the data container for T2 (8^4 elements)
+  BytePacket packet;
+  initBytePacket(&packet);
+  for (int i = 0; i < 4096; i++) appendToBytePacket(&packet, std::complex<double>(0.5, 0.0));
+  client->registerExternalData("t2_data", packet);
+
+  // Send the same TAProL twice asynchronously,
+  // the server pipelines both jobs
+  auto jobId1 = client->interpretTAProL(src);
+  auto jobId2 = client->interpretTAProL(src);
+
+  std::cout << "[client.cpp] job-ids = " << jobId1 << ", " << jobId2 << ".\n";
+
+  // Retrieve the results (scalars are ordered by name)
+  for (const auto & jobId : {jobId2, jobId1}) {
+    auto values = client->getResults(jobId);
+    EXPECT_EQ(values.size(), 2UL);
+    EXPECT_NEAR(1024.0, std::real(values[0]), 1e-9);
+    EXPECT_NEAR(0.0, std::real(values[1]), 1e-9);
+    std::cout << "[client.cpp] norm_x2 is " << std::real(values[0]) << "\n";
+
+    auto tensors = client->getTensorResults(jobId);
+    EXPECT_EQ(tensors["t2"].size(), 4096UL);
+    EXPECT_NEAR(0.5, std::real(tensors["t2"][4095]), 1e-12);
+  }
 
   // Shutdown the client, this
   // also tells the server to shutdown.
@@ -1,10 +1,11 @@
 #include "ServiceRegistry.hpp"
 #include <dirent.h>
 #include "exatn_config.hpp"
+#include "timers.hpp"
 
 namespace exatn {
 
-void ServiceRegistry::initialize(const std::string pluginPath) {
+void ServiceRegistry::initialize(const std::string pluginPath, bool lazy) {
 
   if (!initialized) {
     framework = FrameworkFactory().NewFramework();
@@ -39,7 +40,8 @@ void ServiceRegistry::initialize(const std::string pluginPath) {
         auto fileName = std::string(ent->d_name);
         if (fileName.find("lib") != std::string::npos && (has_suffix(fileName, ".so") || has_suffix(fileName, ".dylib"))) {
         //   printf("[service-registry] Installing Plugin: %s\n", ent->d_name);
-          context.InstallBundles(exatnPluginPath + "/" + fileName);
+          auto bundles = context.InstallBundles(exatnPluginPath + "/" + fileName);
+          pending.insert(pending.end(), bundles.begin(), bundles.end());
         }
       }
       closedir(dir);
@@ -50,13 +52,23 @@ void ServiceRegistry::initialize(const std::string pluginPath) {
 
     // Start the framework itself.
     framework.Start();
-    auto bundles = context.GetBundles();
-    for (auto b : bundles) {
-      b.Start();
+    if (!lazy) {
+      while (startNextBundle());
     }
 
     initialized = true;
   }
 }
 
+bool ServiceRegistry::startNextBundle() {
+  if (pending.empty()) return false;
+  auto bundle = pending.front();
+  pending.erase(pending.begin());
+  const auto timeStart = exatn::Timer::timeInSecHR();
+  bundle.Start();
+  bundleStartTime += exatn::Timer::timeInSecHR(timeStart);
+  ++numStarted;
+  return true;
+}
+
 } // namespace exatn
@@ -9,53 +9,81 @@
 #include <cppmicroservices/Framework.h>
 #include <cppmicroservices/FrameworkFactory.h>
 
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+
 using namespace cppmicroservices;
 
 namespace exatn {
 
+// Plugin bundles are installed upon initialization but, unless eager loading is requested,
+// they are only started (loaded) on demand: A service lookup starts the pending bundles
+// one by one until the requested service shows up, such that only the bundles providing
+// the actually used services (executors, optimizers, etc.) are loaded.
 class ServiceRegistry {
 
 protected:
   Framework framework;
   BundleContext context;
   std::map<std::string, std::string> installed;
+  std::vector<Bundle> pending;  // installed bundles not started yet
+  std::size_t numStarted = 0;   // number of started bundles
+  double bundleStartTime = 0.0; // total time spent starting bundles (sec)
   bool initialized = false;
 
+  // Starts the next pending bundle, returns false if there is none.
+  bool startNextBundle();
+
+  // Returns the registered service with the given name, starting
+  // the pending bundles on demand (nullptr if not found).
+  template <typename ServiceInterface>
+  std::shared_ptr<ServiceInterface> findService(const std::string & name) {
+    do {
+      auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
+      for (auto s : allServiceRefs) {
+        auto service = context.GetService(s);
+        auto identifiable =
+            std::dynamic_pointer_cast<exatn::Identifiable>(service);
+        if (identifiable && identifiable->name() == name) {
+          return service;
+        }
+      }
+    } while (startNextBundle());
+    return std::shared_ptr<ServiceInterface>(nullptr);
+  }
+
 public:
   ServiceRegistry() : framework(FrameworkFactory().NewFramework()) {}
 
-  void initialize(const std::string pluginPath = "");
+  void initialize(const std::string pluginPath = "", bool lazy = true);
+
+  // Returns the number of started bundles and the number of installed bundles.
+  std::pair<std::size_t, std::size_t> getNumBundles() const {
+    return std::make_pair(numStarted, numStarted + pending.size());
+  }
+
+  // Returns the total time spent starting bundles (sec).
+  double getBundleStartTime() const { return bundleStartTime; }
 
   template <typename ServiceInterface> bool hasService(const std::string name) {
-    auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
-    for (auto s : allServiceRefs) {
-      auto service = context.GetService(s);
-      auto identifiable =
-          std::dynamic_pointer_cast<exatn::Identifiable>(service);
-      if (identifiable && identifiable->name() == name) {
-        return true;
-      }
-    }
-    return false;
+    return static_cast<bool>(findService<ServiceInterface>(name));
   }
 
   template <typename ServiceInterface>
   std::shared_ptr<ServiceInterface> getService(const std::string name) {
     std::shared_ptr<ServiceInterface> ret;
-    auto allServiceRefs = context.GetServiceReferences<ServiceInterface>();
-    for (auto s : allServiceRefs) {
-      auto service = context.GetService(s);
-      auto identifiable =
-          std::dynamic_pointer_cast<exatn::Identifiable>(service);
-      if (identifiable && identifiable->name() == name) {
-       auto checkCloneable =
-            std::dynamic_pointer_cast<exatn::Cloneable<ServiceInterface>>(
-                service);
-        if (checkCloneable) {
-          ret = checkCloneable->clone();
-        } else {
-          ret = service;
-        }
+    auto service = findService<ServiceInterface>(name);
+    if (service) {
+      auto checkCloneable =
+          std::dynamic_pointer_cast<exatn::Cloneable<ServiceInterface>>(
+              service);
+      if (checkCloneable) {
+        ret = checkCloneable->clone();
+      } else {
+        ret = service;
       }
     }
 
@@ -0,0 +1,349 @@
+/** ExaTN:: Reverse-mode differentiation of a closed tensor network expansion
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "differentiator.hpp"
+#include "tensor_symbol.hpp"
+
+#include <talshxx.hpp>
+
+#include <map>
+#include <algorithm>
+#include <string>
+#include <iostream>
+#include <cstdint>
+
+namespace exatn{
+
+unsigned int TensorNetworkDifferentiator::debug{0};
+
+
+//Assembles a symbolic tensor from its name and index labels:
+static std::string symbolic_tensor(const std::string & name,
+                                   const std::vector<std::string> & indices,
+                                   bool conjugated = false)
+{
+ std::string tensor(name);
+ tensor += (conjugated ? "+(" : "(");
+ for(std::size_t i = 0; i < indices.size(); ++i){
+  if(i > 0) tensor += ",";
+  tensor += indices[i];
+ }
+ tensor += ")";
+ return tensor;
+}
+
+
+TensorNetworkDifferentiator::TensorNetworkDifferentiator(std::shared_ptr<TensorExpansion> expansion):
+ expansion_(expansion), memory_limit_(DEFAULT_MEMORY_LIMIT),
+ kept_memory_(0), num_recomputed_(0), num_tensors_(0)
+{
+ if(expansion_->getRank() != 0){
+  std::cout << "#ERROR(exatn:TensorNetworkDifferentiator): The tensor network expansion must be closed (scalar)!"
+            << std::endl << std::flush;
+  assert(false);
+ }
+}
+
+
+void TensorNetworkDifferentiator::resetMemoryLimit(std::size_t memory_limit)
+{
+ memory_limit_ = memory_limit;
+ return;
+}
+
+
+std::size_t TensorNetworkDifferentiator::getKeptMemory() const
+{
+ return kept_memory_;
+}
+
+
+std::size_t TensorNetworkDifferentiator::getNumRecomputed() const
+{
+ return num_recomputed_;
+}
+
+
+void TensorNetworkDifferentiator::resetDebugLevel(unsigned int level)
+{
+ TensorNetworkDifferentiator::debug = level;
+ return;
+}
+
+
+bool TensorNetworkDifferentiator::differentiate(const std::vector<std::pair<std::string,std::shared_ptr<Tensor>>> & gradients,
+                                                bool conjugated,
+                                                std::complex<double> * value)
+{
+ return differentiate(exatn::getDefaultProcessGroup(),gradients,conjugated,value);
+}
+
+
+bool TensorNetworkDifferentiator::differentiate(const ProcessGroup & process_group,
+                                                const std::vector<std::pair<std::string,std::shared_ptr<Tensor>>> & gradients,
+                                                bool conjugated,
+                                                std::complex<double> * value)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(exatn::getProcessRank(),&local_rank)) return true; //process is not in the group: Do nothing
+ std::unordered_map<std::string,std::shared_ptr<Tensor>> gradient_tensors;
+ for(const auto & gradient: gradients){
+  assert(gradient.second);
+  auto res = gradient_tensors.emplace(gradient);
+  if(!res.second){
+   std::cout << "#ERROR(exatn:TensorNetworkDifferentiator): Repeated gradient requested for tensor "
+             << gradient.first << std::endl << std::flush;
+   return false;
+  }
+ }
+ kept_memory_ = 0;
+ num_recomputed_ = 0;
+ bool success = true;
+ std::complex<double> expansion_value{0.0,0.0};
+ for(auto component = expansion_->cbegin(); component != expansion_->cend(); ++component){
+  std::complex<double> network_value{0.0,0.0};
+  success = differentiateNetwork(process_group,*(component->network),component->coefficient,
+                                 gradient_tensors,conjugated,(value != nullptr) ? &network_value : nullptr);
+  if(!success) break;
+  expansion_value += component->coefficient * network_value;
+ }
+ if(success){
+  success = exatn::sync(process_group);
+  if(success && value != nullptr) *value = expansion_value;
+ }
+ return success;
+}
+
+
+bool TensorNetworkDifferentiator::differentiateNetwork(const ProcessGroup & process_group,
+                                                       const TensorNetwork & network,
+                                                       std::complex<double> coefficient,
+                                                       const std::unordered_map<std::string,std::shared_ptr<Tensor>> & gradients,
+                                                       bool conjugated,
+                                                       std::complex<double> * value)
+{
+ TensorNetwork net(network);
+ if(net.getRank() != 0){
+  std::cout << "#ERROR(exatn:TensorNetworkDifferentiator): Tensor network " << net.getName()
+            << " is not closed!" << std::endl << std::flush;
+  return false;
+ }
+ const auto elem_type = net.getTensorElementType();
+ const auto elem_size = TensorElementTypeSize(tensorComputeElementType(elem_type));
+ bool success = true;
+
+ //Label the tensor network edges and register the input tensors as tree leaves:
+ ContractionTree tree;
+ std::map<std::pair<unsigned int, unsigned int>, std::string> edges; //lowest edge end {tensor id, mode} --> index label
+ for(auto iter = net.cbegin(); iter != net.cend(); ++iter){
+  const auto tensor_id = iter->first;
+  if(tensor_id == 0) continue;
+  bool conj = false;
+  auto tensor = net.getTensor(tensor_id,&conj);
+  TreeNode node{tensor,nullptr,{},conj,0,0,false,false,false,false,true,true};
+  const auto * legs = net.getTensorConnections(tensor_id);
+  assert(legs != nullptr);
+  for(unsigned int i = 0; i < legs->size(); ++i){
+   const auto & leg = (*legs)[i];
+   if(leg.getTensorId() == tensor_id){
+    std::cout << "#ERROR(exatn:TensorNetworkDifferentiator): Self-contracted tensor " << tensor->getName()
+              << " in tensor network " << net.getName() << " is not supported!" << std::endl << std::flush;
+    return false;
+   }
+   const auto edge = std::min(std::make_pair(tensor_id,i),std::make_pair(leg.getTensorId(),leg.getDimensionId()));
+   auto res = edges.emplace(std::make_pair(edge,"i" + std::to_string(edges.size())));
+   node.indices.emplace_back(res.first->second);
+  }
+  auto grad = gradients.find(tensor->getName());
+  node.differentiated = (grad != gradients.cend() && conj == conjugated);
+  if(node.differentiated){
+   if(grad->second->getRank() != tensor->getRank()){
+    std::cout << "#ERROR(exatn:TensorNetworkDifferentiator): Gradient tensor " << grad->second->getName()
+              << " is not congruent to tensor " << tensor->getName() << std::endl << std::flush;
+    return false;
+   }
+  }
+  tree.emplace(std::make_pair(tensor_id,node));
+ }
+
+ //Build the tensor contraction tree from the tensor contraction sequence:
+ unsigned int root_id = 0;
+ if(net.getNumTensors() > 1){
+  if(net.exportContractionSequence().empty()) net.determineContractionSequence();
+ }else{
+  root_id = tree.cbegin()->first;
+ }
+ const auto & contr_seq = net.exportContractionSequence();
+ for(const auto & contr: contr_seq){
+  auto & left = tree.at(contr.left_id);
+  auto & right = tree.at(contr.right_id);
+  TreeNode node{nullptr,nullptr,{},false,contr.left_id,contr.right_id,true,
+                (left.differentiated || right.differentiated),false,false,false,false};
+  std::vector<DimExtent> extents;
+  for(unsigned int i = 0; i < left.indices.size(); ++i){
+   if(std::find(right.indices.cbegin(),right.indices.cend(),left.indices[i]) == right.indices.cend()){
+    node.indices.emplace_back(left.indices[i]);
+    extents.emplace_back(left.tensor->getDimExtent(i));
+   }
+  }
+  for(unsigned int i = 0; i < right.indices.size(); ++i){
+   if(std::find(left.indices.cbegin(),left.indices.cend(),right.indices[i]) == left.indices.cend()){
+    node.indices.emplace_back(right.indices[i]);
+    extents.emplace_back(right.tensor->getDimExtent(i));
+   }
+  }
+  node.tensor = std::make_shared<Tensor>(generateTensorName("dv"),TensorShape(extents));
+  //The value of a child is needed in the backward pass only if its sibling is differentiated:
+  left.needed = right.differentiated;
+  right.needed = left.differentiated;
+  tree.emplace(std::make_pair(contr.result_id,node));
+  root_id = contr.result_id;
+ }
+ auto & root = tree.at(root_id);
+
+ //Forward pass (keeping the needed intermediates within the memory limit):
+ std::size_t kept_memory = 0;
+ for(const auto & contr: contr_seq){
+  success = computeIntermediate(process_group,tree,contr.result_id,elem_type); if(!success) return false;
+  auto & node = tree.at(contr.result_id);
+  if(contr.result_id != root_id && node.needed){
+   const std::size_t node_memory = node.tensor->getVolume() * elem_size;
+   if(memory_limit_ == 0 || kept_memory + node_memory <= memory_limit_){
+    node.kept = true;
+    kept_memory += node_memory;
+   }
+  }
+ }
+ kept_memory_ = std::max(kept_memory_,kept_memory);
+ if(TensorNetworkDifferentiator::debug > 0){
+  std::cout << "#DEBUG(exatn::TensorNetworkDifferentiator): Tensor network " << net.getName()
+            << ": Forward pass kept " << kept_memory << " bytes of intermediates" << std::endl;
+ }
+
+ //Backward pass:
+ if(root.differentiated){
+  root.adjoint = std::make_shared<Tensor>(generateTensorName("da"),TensorShape(std::vector<DimExtent>{}));
+  success = exatn::createTensor(process_group,root.adjoint,elem_type); if(!success) return false;
+  success = exatn::initTensor(root.adjoint->getName(),1.0); if(!success) return false;
+  if(!(root.intermediate)){ //single input tensor
+   auto gradient = gradients.at(root.tensor->getName());
+   success = exatn::addTensors(symbolic_tensor(gradient->getName(),root.indices) + "+="
+                               + symbolic_tensor(root.adjoint->getName(),root.indices),coefficient);
+   if(!success) return false;
+  }
+ }
+ for(auto contr = contr_seq.crbegin(); contr != contr_seq.crend(); ++contr){
+  auto & node = tree.at(contr->result_id);
+  if(node.differentiated){
+   for(const auto child_id: {node.left_id,node.right_id}){
+    auto & child = tree.at(child_id);
+    if(child.differentiated){
+     const auto other_id = (child_id == node.left_id) ? node.right_id : node.left_id;
+     success = computeIntermediate(process_group,tree,other_id,elem_type); if(!success) return false;
+     const auto & other = tree.at(other_id);
+     const auto other_tensor = symbolic_tensor(other.tensor->getName(),other.indices,other.conjugated);
+     const auto node_adjoint = symbolic_tensor(node.adjoint->getName(),node.indices);
+     if(child.intermediate){
+      child.adjoint = std::make_shared<Tensor>(generateTensorName("da"),child.tensor->getShape());
+      success = exatn::createTensor(process_group,child.adjoint,elem_type); if(!success) return false;
+      success = exatn::initTensor(child.adjoint->getName(),0.0); if(!success) return false;
+      success = exatn::contractTensors(symbolic_tensor(child.adjoint->getName(),child.indices) + "+="
+                                       + node_adjoint + "*" + other_tensor,1.0);
+     }else{ //differentiated input tensor: Accumulate directly into its gradient
+      auto gradient = gradients.at(child.tensor->getName());
+      success = exatn::contractTensors(symbolic_tensor(gradient->getName(),child.indices) + "+="
+                                       + node_adjoint + "*" + other_tensor,coefficient);
+     }
+     if(!success) return false;
+    }
+   }
+   success = exatn::destroyTensor(node.adjoint->getName()); if(!success) return false;
+   node.adjoint.reset();
+  }
+  //The values of the children are no longer needed:
+  success = releaseIntermediate(tree,node.left_id); if(!success) return false;
+  success = releaseIntermediate(tree,node.right_id); if(!success) return false;
+ }
+ if(!(root.intermediate) && root.adjoint){
+  success = exatn::destroyTensor(root.adjoint->getName()); if(!success) return false;
+  root.adjoint.reset();
+ }
+
+ //Retrieve the value of the tensor network:
+ if(value != nullptr){
+  success = exatn::sync(process_group,*(root.tensor)); if(!success) return false;
+  auto local_tensor = exatn::getLocalTensor(root.tensor->getName());
+  switch(elem_type){
+   case TensorElementType::REAL32:
+    *value = {local_tensor->getSliceView<float>()[std::initializer_list<int>{}],0.0f};
+    break;
+   case TensorElementType::REAL64:
+    *value = {local_tensor->getSliceView<double>()[std::initializer_list<int>{}],0.0};
+    break;
+   case TensorElementType::COMPLEX32:
+    *value = local_tensor->getSliceView<std::complex<float>>()[std::initializer_list<int>{}];
+    break;
+   case TensorElementType::COMPLEX64:
+    *value = local_tensor->getSliceView<std::complex<double>>()[std::initializer_list<int>{}];
+    break;
+   default:
+    assert(false);
+  }
+ }
+ if(root.intermediate) success = releaseIntermediate(tree,root_id);
+ return success;
+}
+
+
+bool TensorNetworkDifferentiator::computeIntermediate(const ProcessGroup & process_group,
+                                                      ContractionTree & tree,
+                                                      unsigned int node_id,
+                                                      TensorElementType elem_type)
+{
+ auto & node = tree.at(node_id);
+ if(!(node.intermediate) || node.present) return true;
+ //Make sure both children are present:
+ bool success = computeIntermediate(process_group,tree,node.left_id,elem_type); if(!success) return false;
+ success = computeIntermediate(process_group,tree,node.right_id,elem_type); if(!success) return false;
+ const auto & left = tree.at(node.left_id);
+ const auto & right = tree.at(node.right_id);
+ //Compute the intermediate:
+ success = exatn::createTensor(process_group,node.tensor,elem_type); if(!success) return false;
+ success = exatn::initTensor(node.tensor->getName(),0.0); if(!success) return false;
+ success = exatn::contractTensors(symbolic_tensor(node.tensor->getName(),node.indices) + "+="
+                                  + symbolic_tensor(left.tensor->getName(),left.indices,left.conjugated) + "*"
+                                  + symbolic_tensor(right.tensor->getName(),right.indices,right.conjugated),1.0);
+ if(!success) return false;
+ if(node.computed) ++num_recomputed_;
+ node.computed = true;
+ node.present = true;
+ //Release the children which are not kept:
+ if(!(left.kept)){
+  success = releaseIntermediate(tree,node.left_id); if(!success) return false;
+ }
+ if(!(right.kept)){
+  success = releaseIntermediate(tree,node.right_id); if(!success) return false;
+ }
+ return success;
+}
+
+
+bool TensorNetworkDifferentiator::releaseIntermediate(ContractionTree & tree,
+                                                      unsigned int node_id)
+{
+ auto & node = tree.at(node_id);
+ if(!(node.intermediate) || !(node.present)) return true;
+ node.present = false;
+ return exatn::destroyTensor(node.tensor->getName());
+}
+
+
+std::string TensorNetworkDifferentiator::generateTensorName(const std::string & prefix)
+{
+ return tensor_hex_name(prefix + std::to_string(num_tensors_++) + "_",reinterpret_cast<std::uintptr_t>(this));
+}
+
+} //namespace exatn
@@ -0,0 +1,134 @@
+/** ExaTN:: Reverse-mode differentiation of a closed tensor network expansion
+REVISION: 2022/03/25
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) Given a closed tensor network expansion (evaluating to a scalar), the tensor network
+     differentiator computes the gradients of its value with respect to any number of its
+     input tensors via a single forward pass over the tensor contraction sequence of each
+     tensor network component, followed by a single backward pass over the same tensor
+     contraction tree (reverse-mode automatic differentiation):
+      Forward:  T_result = T_left * T_right;
+      Backward: A_left += A_result * T_right, A_right += A_result * T_left;
+     where A_x is the adjoint of T_x, starting from A_output = 1. The gradient with respect
+     to a given tensor is the sum of the adjoints of its occurrences in the tensor networks
+     (with the requested conjugation status) scaled by the expansion coefficients. Thus,
+     the result is the same as from evaluating the corresponding derivative tensor network
+     expansions, TensorExpansion(expansion,tensor_name,conjugated), one by one, but it is
+     obtained at the cost of about 2-3 evaluations of the tensor network expansion.
+ (B) The adjoints are only computed for the subtrees of the tensor contraction tree
+     which contain the differentiated tensors.
+ (C) The forward intermediates needed in the backward pass are kept while their total
+     size stays within the memory limit (no limit by default). The intermediates which
+     do not fit are dropped during the forward pass and recomputed from their nearest
+     kept descendants during the backward pass (checkpointing).
+**/
+
+#ifndef EXATN_DIFFERENTIATOR_HPP_
+#define EXATN_DIFFERENTIATOR_HPP_
+
+#include "exatn_numerics.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <complex>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+class TensorNetworkDifferentiator{
+
+public:
+
+ static unsigned int debug;
+
+ static constexpr const std::size_t DEFAULT_MEMORY_LIMIT = 0; //no limit on the kept forward intermediates
+
+ TensorNetworkDifferentiator(std::shared_ptr<TensorExpansion> expansion); //in: closed tensor network expansion
+
+ TensorNetworkDifferentiator(const TensorNetworkDifferentiator &) = default;
+ TensorNetworkDifferentiator & operator=(const TensorNetworkDifferentiator &) = default;
+ TensorNetworkDifferentiator(TensorNetworkDifferentiator &&) noexcept = default;
+ TensorNetworkDifferentiator & operator=(TensorNetworkDifferentiator &&) noexcept = default;
+ ~TensorNetworkDifferentiator() = default;
+
+ /** Resets the memory limit (bytes) for the forward intermediates kept for the backward pass (0: no limit). **/
+ void resetMemoryLimit(std::size_t memory_limit = DEFAULT_MEMORY_LIMIT);
+
+ /** Evaluates the closed tensor network expansion and accumulates its gradients with respect
+     to the given input tensors into the given gradient tensors (must be created in advance):
+      gradient += d(value) / d(tensor),
+     where the tensor is differentiated against either in its complex conjugated occurrences
+     (conjugated = TRUE) or in its normal occurrences (conjugated = FALSE). **/
+ bool differentiate(const std::vector<std::pair<std::string,std::shared_ptr<Tensor>>> & gradients, //in: {tensor name, gradient tensor}
+                    bool conjugated = true,                   //in: whether to differentiate against the conjugated tensor occurrences
+                    std::complex<double> * value = nullptr);  //out: value of the tensor network expansion
+
+ bool differentiate(const ProcessGroup & process_group,       //in: executing process group
+                    const std::vector<std::pair<std::string,std::shared_ptr<Tensor>>> & gradients, //in: {tensor name, gradient tensor}
+                    bool conjugated = true,                   //in: whether to differentiate against the conjugated tensor occurrences
+                    std::complex<double> * value = nullptr);  //out: value of the tensor network expansion
+
+ /** Returns the max total size (bytes) of the kept forward intermediates during the last differentiation. **/
+ std::size_t getKeptMemory() const;
+
+ /** Returns the number of forward intermediates recomputed during the last differentiation. **/
+ std::size_t getNumRecomputed() const;
+
+ static void resetDebugLevel(unsigned int level = 0); //in: debug level
+
+private:
+
+ //Node of the tensor contraction tree:
+ struct TreeNode{
+  std::shared_ptr<Tensor> tensor;   //tensor value (input tensor or forward intermediate)
+  std::shared_ptr<Tensor> adjoint;  //tensor adjoint (if computed)
+  std::vector<std::string> indices; //index labels of the tensor modes
+  bool conjugated;                  //conjugation status of an input tensor occurrence
+  unsigned int left_id;             //left child id (intermediates only)
+  unsigned int right_id;            //right child id (intermediates only)
+  bool intermediate;                //whether or not the node is a forward intermediate
+  bool differentiated;              //whether or not the subtree contains differentiated tensors
+  bool needed;                      //whether or not the intermediate is needed in the backward pass
+  bool kept;                        //whether or not the intermediate is kept after the forward pass
+  bool present;                     //whether or not the intermediate currently exists
+  bool computed;                    //whether or not the intermediate has been computed before
+ };
+
+ using ContractionTree = std::unordered_map<unsigned int,TreeNode>;
+
+ //Differentiates a single closed tensor network component:
+ bool differentiateNetwork(const ProcessGroup & process_group,
+                           const TensorNetwork & network,
+                           std::complex<double> coefficient,
+                           const std::unordered_map<std::string,std::shared_ptr<Tensor>> & gradients,
+                           bool conjugated,
+                           std::complex<double> * value);
+
+ //Computes a forward intermediate (recursively recomputes its dropped descendants):
+ bool computeIntermediate(const ProcessGroup & process_group,
+                          ContractionTree & tree,
+                          unsigned int node_id,
+                          TensorElementType elem_type);
+
+ //Destroys a present forward intermediate:
+ bool releaseIntermediate(ContractionTree & tree,
+                          unsigned int node_id);
+
+ //Generates a new unique tensor name:
+ std::string generateTensorName(const std::string & prefix);
+
+ std::shared_ptr<TensorExpansion> expansion_; //closed tensor network expansion
+ std::size_t memory_limit_;                   //memory limit (bytes) for the kept forward intermediates (0: no limit)
+ std::size_t kept_memory_;                    //max total size (bytes) of the kept forward intermediates
+ std::size_t num_recomputed_;                 //number of recomputed forward intermediates
+ std::size_t num_tensors_;                    //number of generated tensor names
+};
+
+} //namespace exatn
+
+#endif //EXATN_DIFFERENTIATOR_HPP_
@@ -1,12 +1,31 @@
 /** ExaTN:: Extreme eigenvalue/eigenvector Krylov solver over tensor networks
-REVISION: 2021/10/22
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "eigensolver.hpp"
 
+#include <algorithm>
+#include <string>
 #include <iostream>
+#include <cmath>
+
+//LAPACK zggev:
+extern "C" {
+void zggev_(
+ char const * jobvl, char const * jobvr,
+ int const * n,
+ void * A, int const * lda,
+ void * B, int const * ldb,
+ void * alpha,
+ void * beta,
+ void * VL, int const * ldvl,
+ void * VR, int const * ldvr,
+ void * work, int const * lwork,
+ void * rwork,
+ int * info);
+}
 
 namespace exatn{
 
@@ -72,16 +91,320 @@ bool TensorNetworkEigenSolver::solve(const ProcessGroup & process_group,
 
  assert(accuracy != nullptr);
  if(num_roots == 0) return false;
+ assert(tensor_operator_ && tensor_expansion_);
+ unsigned int num_procs = process_group.getSize();
+
  num_roots_ = num_roots;
- for(unsigned int i = 0; i < num_roots; ++i) accuracy_.emplace_back(-1.0);
+ accuracy_.assign(num_roots,-1.0);
+ eigenvalue_.assign(num_roots,std::complex<double>{0.0,0.0});
+ eigenvector_.assign(num_roots,std::shared_ptr<TensorExpansion>(nullptr));
+ destroyBasis(basis_);
 
  bool success = true;
- //`Finish
+ //Generate the initial block of random Krylov basis vectors:
+ for(unsigned int i = 0; i < num_roots; ++i) basis_.emplace_back(createBasisVector(process_group));
+ const unsigned int max_subspace_dim = num_roots * DEFAULT_MAX_SUBSPACE_BLOCKS;
+ //Block Davidson iterations:
+ std::vector<std::complex<double>> oper_matrix, metr_matrix;
+ std::vector<std::complex<double>> ritz_values(num_roots,std::complex<double>{0.0,0.0});
+ unsigned int evaluated_dim = 0; //number of basis vectors with all their projected matrix elements already evaluated
+ bool converged = false;
+ for(unsigned int iteration = 0; iteration < max_iterations_; ++iteration){
+  numericalServer->reportSolverIteration("TensorNetworkEigenSolver",iteration);
+  const unsigned int subspace_dim = basis_.size();
+  //Extend the projected matrices with the matrix elements of the new basis vectors:
+  std::vector<std::complex<double>> oper_elems(subspace_dim*subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<std::complex<double>> metr_elems(subspace_dim*subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<bool> mask(subspace_dim*subspace_dim,true);
+  for(unsigned int j = 0; j < evaluated_dim; ++j){
+   for(unsigned int i = 0; i < evaluated_dim; ++i){
+    oper_elems[j*subspace_dim + i] = oper_matrix[j*evaluated_dim + i];
+    metr_elems[j*subspace_dim + i] = metr_matrix[j*evaluated_dim + i];
+    mask[j*subspace_dim + i] = false;
+   }
+  }
+  success = computeProjectedMatrices(process_group,*tensor_operator_,basis_,basis_, //bras are conjugated lazily
+                                     oper_elems,metr_elems,mask,num_procs); assert(success);
+  oper_matrix = oper_elems;
+  metr_matrix = metr_elems;
+  evaluated_dim = subspace_dim;
+  //Solve the projected generalized eigen-problem:
+  int info = 0;
+  const char job_type = 'V';
+  const int matrix_dim = subspace_dim;
+  const int lwork = std::max(2*subspace_dim,subspace_dim*subspace_dim);
+  std::vector<std::complex<double>> work_space(lwork);
+  std::vector<std::complex<double>> left_vecs(subspace_dim*subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<std::complex<double>> right_vecs(subspace_dim*subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<std::complex<double>> alpha(subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<std::complex<double>> beta(subspace_dim,std::complex<double>{0.0,0.0});
+  std::vector<double> rwork_space(subspace_dim*8);
+  zggev_(&job_type,&job_type,&matrix_dim,
+         (void*)oper_elems.data(),&matrix_dim,
+         (void*)metr_elems.data(),&matrix_dim,
+         (void*)alpha.data(),(void*)beta.data(),
+         (void*)left_vecs.data(),&matrix_dim,
+         (void*)right_vecs.data(),&matrix_dim,
+         (void*)work_space.data(),&lwork,
+         (void*)rwork_space.data(),&info);
+  if(info != 0){
+   std::cout << "#ERROR(exatn::TensorNetworkEigenSolver::solve): Projected eigen-problem failed with error "
+             << info << std::endl << std::flush;
+   success = false;
+   break;
+  }
+  //Select the lowest Ritz values (ignoring the infinite ones):
+  std::vector<int> roots;
+  for(int i = 0; i < matrix_dim; ++i) if(std::abs(beta[i]) != 0.0) roots.emplace_back(i);
+  if(roots.size() < num_roots){
+   std::cout << "#ERROR(exatn::TensorNetworkEigenSolver::solve): Krylov subspace has become linearly dependent!"
+             << std::endl << std::flush;
+   success = false;
+   break;
+  }
+  std::sort(roots.begin(),roots.end(),[&alpha,&beta](const int i, const int j){
+   return ((alpha[i]/beta[i]).real() < (alpha[j]/beta[j]).real());
+  });
+  //Form the Ritz vectors and check convergence:
+  converged = (iteration > 0);
+  for(unsigned int k = 0; k < num_roots; ++k){
+   const auto ritz_value = alpha[roots[k]] / beta[roots[k]];
+   accuracy_[k] = std::abs(ritz_value - ritz_values[k]);
+   if(iteration == 0 || accuracy_[k] > tolerance_) converged = false;
+   ritz_values[k] = ritz_value;
+   auto ritz_vector = makeSharedTensorExpansion("_RitzVector"+std::to_string(k));
+   for(unsigned int i = 0; i < subspace_dim; ++i){
+    const auto coef = right_vecs[roots[k]*subspace_dim + i];
+    for(auto net = basis_[i]->cbegin(); net != basis_[i]->cend(); ++net){
+     success = ritz_vector->appendComponent(net->network,coef*(net->coefficient)); assert(success);
+    }
+   }
+   success = normalizeNorm2Sync(process_group,*ritz_vector,1.0); assert(success);
+   eigenvalue_[k] = ritz_value;
+   eigenvector_[k] = ritz_vector;
+  }
+  if(TensorNetworkEigenSolver::debug > 0){
+   std::cout << "#DEBUG(exatn::TensorNetworkEigenSolver): Iteration " << iteration
+             << ": Subspace dimension = " << subspace_dim << ": Ritz values (accuracy):" << std::scientific;
+   for(unsigned int k = 0; k < num_roots; ++k) std::cout << " " << ritz_values[k] << " (" << accuracy_[k] << ")";
+   std::cout << std::endl;
+  }
+  if(converged || iteration == (max_iterations_ - 1)) break;
+  //Collapse the Krylov subspace onto the Ritz vectors if it is about to exceed its max dimension:
+  if(subspace_dim + num_roots > max_subspace_dim){
+   std::vector<std::shared_ptr<TensorExpansion>> collapsed_basis;
+   for(unsigned int k = 0; k < num_roots; ++k){
+    collapsed_basis.emplace_back(reconstructBasisVector(process_group,eigenvector_[k]));
+   }
+   destroyBasis(basis_);
+   basis_ = collapsed_basis;
+   evaluated_dim = 0;
+  }
+  //Extend the Krylov subspace by the residuals of the unconverged Ritz vectors:
+  for(unsigned int k = 0; k < num_roots; ++k){
+   if(accuracy_[k] > tolerance_ || iteration == 0){
+    auto residual = makeSharedTensorExpansion(*(eigenvector_[k]),*tensor_operator_);
+    success = residual->appendExpansion(*(eigenvector_[k]),-ritz_values[k]); assert(success);
+    basis_.emplace_back(reconstructBasisVector(process_group,residual));
+   }
+  }
+ }
+ success = exatn::sync(process_group) && success;
  *accuracy = &accuracy_;
  return success;
 }
 
 
+std::shared_ptr<TensorExpansion> TensorNetworkEigenSolver::createBasisVector(const ProcessGroup & process_group)
+{
+ auto basis_vector = duplicateSync(process_group,*tensor_expansion_); assert(basis_vector);
+ bool success = initTensorsRndSync(*basis_vector); assert(success);
+ success = normalizeNorm2Sync(process_group,*basis_vector,1.0); assert(success);
+ return basis_vector;
+}
+
+
+std::shared_ptr<TensorExpansion> TensorNetworkEigenSolver::reconstructBasisVector(const ProcessGroup & process_group,
+                                                                                  std::shared_ptr<TensorExpansion> expansion)
+{
+ auto basis_vector = createBasisVector(process_group);
+ basis_vector->conjugate();
+ TensorNetworkReconstructor reconstructor(expansion,basis_vector,tolerance_);
+ reconstructor.resetMaxIterations(DEFAULT_RECONSTRUCTION_ITERATIONS);
+ bool success = exatn::sync(process_group); assert(success);
+ double residual_norm, fidelity;
+ bool reconstructed = reconstructor.reconstruct(process_group,&residual_norm,&fidelity);
+ success = exatn::sync(process_group); assert(success);
+ basis_vector->conjugate();
+ if(TensorNetworkEigenSolver::debug > 1){
+  std::cout << "#DEBUG(exatn::TensorNetworkEigenSolver): New basis vector reconstructed ("
+            << reconstructed << ") with fidelity " << fidelity << std::endl;
+ }
+ success = normalizeNorm2Sync(process_group,*basis_vector,1.0); assert(success);
+ return basis_vector;
+}
+
+
+void TensorNetworkEigenSolver::destroyBasis(std::vector<std::shared_ptr<TensorExpansion>> & basis)
+{
+ for(auto & basis_vector: basis){
+  for(auto net = basis_vector->begin(); net != basis_vector->end(); ++net){
+   bool success = exatn::destroyTensors(*(net->network)); assert(success);
+  }
+ }
+ basis.clear();
+ return;
+}
+
+
+bool TensorNetworkEigenSolver::computeProjectedMatrices(const ProcessGroup & process_group,
+                                                        const TensorOperator & tensor_operator,
+                                                        const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,
+                                                        const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,
+                                                        std::vector<std::complex<double>> & oper_matrix,
+                                                        std::vector<std::complex<double>> & metr_matrix,
+                                                        const std::vector<bool> & mask,
+                                                        unsigned int parallel_width)
+{
+ return computeMatrixElements(process_group,&tensor_operator,ket_block,bra_block,
+                              &oper_matrix,metr_matrix,mask,parallel_width);
+}
+
+
+bool TensorNetworkEigenSolver::computeProjectedMetrics(const ProcessGroup & process_group,
+                                                       const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,
+                                                       const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,
+                                                       std::vector<std::complex<double>> & metr_matrix,
+                                                       const std::vector<bool> & mask,
+                                                       unsigned int parallel_width)
+{
+ return computeMatrixElements(process_group,nullptr,ket_block,bra_block,
+                              nullptr,metr_matrix,mask,parallel_width);
+}
+
+
+bool TensorNetworkEigenSolver::computeMatrixElements(const ProcessGroup & process_group,
+                                                     const TensorOperator * tensor_operator,
+                                                     const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,
+                                                     const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,
+                                                     std::vector<std::complex<double>> * oper_matrix,
+                                                     std::vector<std::complex<double>> & metr_matrix,
+                                                     const std::vector<bool> & mask,
+                                                     unsigned int parallel_width)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(exatn::getProcessRank(),&local_rank)) return true; //process is not in the group: Do nothing
+
+ assert((tensor_operator == nullptr) == (oper_matrix == nullptr));
+ const unsigned int num_kets = ket_block.size();
+ const unsigned int num_bras = bra_block.size();
+ const std::size_t matrix_volume = num_kets * num_bras;
+ if(matrix_volume == 0) return true;
+ assert(mask.empty() || mask.size() == matrix_volume);
+ if(oper_matrix != nullptr) oper_matrix->resize(matrix_volume,std::complex<double>{0.0,0.0});
+ metr_matrix.resize(matrix_volume,std::complex<double>{0.0,0.0});
+ //Collect the requested matrix elements (operator elements first, if any):
+ std::vector<std::size_t> elements; //element id = (operator ? 0 : matrix_volume) + j*num_bras + i
+ for(std::size_t elem = 0; elem < matrix_volume; ++elem) if(mask.empty() || mask[elem]) elements.emplace_back(elem);
+ const std::size_t num_oper_elems = elements.size();
+ for(std::size_t n = 0; n < num_oper_elems; ++n) elements.emplace_back(matrix_volume + elements[n]);
+ if(tensor_operator == nullptr) elements.erase(elements.begin(),elements.begin() + num_oper_elems);
+ const std::size_t num_elems = elements.size();
+ if(num_elems == 0) return true;
+ const auto elem_type = ket_block[0]->cbegin()->network->getTensorElementType();
+ assert(elem_type != TensorElementType::VOID);
+ //Create the unit selector vectors, one per matrix element:
+ bool success = true;
+ std::vector<std::shared_ptr<Tensor>> selectors(num_elems);
+ for(std::size_t n = 0; n < num_elems; ++n){
+  selectors[n] = makeSharedTensor("_ElemSelector"+std::to_string(n),std::vector<DimExtent>{num_elems});
+  success = exatn::createTensor(process_group,selectors[n],elem_type); assert(success);
+  switch(elem_type){
+   case TensorElementType::REAL32:{
+    std::vector<float> unit(num_elems,0.0f); unit[n] = 1.0f;
+    success = exatn::initTensorData(selectors[n]->getName(),unit); assert(success);
+    break;
+   }
+   case TensorElementType::REAL64:{
+    std::vector<double> unit(num_elems,0.0); unit[n] = 1.0;
+    success = exatn::initTensorData(selectors[n]->getName(),unit); assert(success);
+    break;
+   }
+   case TensorElementType::COMPLEX32:{
+    std::vector<std::complex<float>> unit(num_elems,std::complex<float>{0.0f,0.0f}); unit[n] = {1.0f,0.0f};
+    success = exatn::initTensorData(selectors[n]->getName(),unit); assert(success);
+    break;
+   }
+   case TensorElementType::COMPLEX64:{
+    std::vector<std::complex<double>> unit(num_elems,std::complex<double>{0.0,0.0}); unit[n] = {1.0,0.0};
+    success = exatn::initTensorData(selectors[n]->getName(),unit); assert(success);
+    break;
+   }
+   default:
+    assert(false);
+  }
+ }
+ //Build the fused tensor network expansion of all requested matrix elements:
+ TensorExpansion fused_expansion("_FusedMatrixElements");
+ for(std::size_t n = 0; n < num_elems; ++n){
+  const bool oper_elem = (elements[n] < matrix_volume);
+  const auto elem = (oper_elem ? elements[n] : (elements[n] - matrix_volume));
+  const unsigned int j = elem / num_bras;
+  const unsigned int i = elem % num_bras;
+  const bool bra_conjugated = bra_block[i]->isKet(); //ket in place of bra: Conjugated lazily
+  auto matrix_element = (oper_elem ? TensorExpansion(*(ket_block[j]),*(bra_block[i]),*tensor_operator,false,bra_conjugated)
+                                   : TensorExpansion(*(ket_block[j]),*(bra_block[i]),false,bra_conjugated));
+  for(auto component = matrix_element.begin(); component != matrix_element.end(); ++component){
+   auto network = component->getMutableNetwork(); //not shared: No copy
+   success = network->appendTensor(network->getMaxTensorId() + 1,selectors[n],
+                                   std::vector<std::pair<unsigned int, unsigned int>>{}); assert(success);
+   success = fused_expansion.appendComponent(network,component->coefficient); assert(success);
+  }
+ }
+ //Evaluate all matrix elements at once (with shared intermediates):
+ auto elements_tensor = makeSharedTensor("_FusedMatrixElements",std::vector<DimExtent>{num_elems});
+ success = exatn::createTensor(process_group,elements_tensor,elem_type); assert(success);
+ success = exatn::initTensor(elements_tensor->getName(),0.0); assert(success);
+ const bool intermediate_sharing = queryIntermediateSharing();
+ if(!intermediate_sharing) activateIntermediateSharing();
+ success = exatn::evaluateSync(process_group,fused_expansion,elements_tensor,parallel_width); assert(success);
+ if(!intermediate_sharing) deactivateIntermediateSharing();
+ auto local_elements = exatn::getLocalTensor(elements_tensor->getName()); assert(local_elements);
+ for(std::size_t n = 0; n < num_elems; ++n){
+  std::complex<double> value{0.0,0.0};
+  const int offset = n;
+  switch(elem_type){
+   case TensorElementType::REAL32:
+    value = std::complex<double>(local_elements->getSliceView<float>()[std::initializer_list<int>{offset}], 0.0);
+    break;
+   case TensorElementType::REAL64:
+    value = std::complex<double>(local_elements->getSliceView<double>()[std::initializer_list<int>{offset}], 0.0);
+    break;
+   case TensorElementType::COMPLEX32:
+    value = std::complex<double>(local_elements->getSliceView<std::complex<float>>()[std::initializer_list<int>{offset}]);
+    break;
+   case TensorElementType::COMPLEX64:
+    value = local_elements->getSliceView<std::complex<double>>()[std::initializer_list<int>{offset}];
+    break;
+   default:
+    assert(false);
+  }
+  if(elements[n] < matrix_volume){
+   (*oper_matrix)[elements[n]] = value;
+  }else{
+   metr_matrix[elements[n] - matrix_volume] = value;
+  }
+ }
+ //Destroy temporaries:
+ success = exatn::destroyTensor(elements_tensor->getName()); assert(success);
+ for(auto & selector: selectors){
+  success = exatn::destroyTensor(selector->getName()); assert(success);
+ }
+ success = exatn::sync(process_group); assert(success);
+ return success;
+}
+
+
 void TensorNetworkEigenSolver::resetDebugLevel(unsigned int level)
 {
  TensorNetworkEigenSolver::debug = level;
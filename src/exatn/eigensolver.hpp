@@ -1,5 +1,5 @@
 /** ExaTN: Extreme eigenvalue/eigenvector Krylov solver over tensor networks
-REVISION: 2021/01/16
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -10,6 +10,18 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
      subspace spanned by tensor network expansions. The procedure is derived
      from the Davidson-Nakatsuji-Hirao algorithm for non-Hermitian matrices,
      which in turn is based on the Arnoldi algorithm.
+ (b) Block mode: All requested eigenroots are solved for simultaneously. The Krylov
+     subspace is extended by a block of new tensor network expansions per iteration,
+     one per unconverged root, each reconstructed in the given tensor network form
+     from the residual (H - E_k)|r_k> of the corresponding Ritz vector |r_k>.
+     Once the subspace exceeds its max dimension, it is collapsed onto the
+     (reconstructed) Ritz vectors.
+ (c) All projected matrix elements, <b_i|H|b_j> and <b_i|b_j>, which have not been
+     evaluated yet are evaluated together as a single fused tensor network expansion:
+     Each closed tensor network component is extended with a unit selector vector
+     assigning it to its matrix element, such that all matrix elements are accumulated
+     into a single vector. Thus, the tensor network expansion evaluation planner can
+     share contraction work across the whole block (common sub-networks).
 **/
 
 #ifndef EXATN_EIGENSOLVER_HPP_
@@ -20,6 +32,7 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "optimizer.hpp"
 
 #include <vector>
+#include <memory>
 #include <complex>
 
 #include "errors.hpp"
@@ -35,6 +48,8 @@ public:
  static constexpr const double DEFAULT_TOLERANCE = 1e-5;
  static constexpr const double DEFAULT_LEARN_RATE = 0.5;
  static constexpr const unsigned int DEFAULT_MAX_ITERATIONS = 1000;
+ static constexpr const unsigned int DEFAULT_MAX_SUBSPACE_BLOCKS = 4;      //max Krylov subspace dimension in units of num_roots
+ static constexpr const unsigned int DEFAULT_RECONSTRUCTION_ITERATIONS = 10; //max number of iterations of the reconstruction of a new basis vector
 
  TensorNetworkEigenSolver(std::shared_ptr<TensorOperator> tensor_operator,   //in: tensor operator the extreme eigenroots of which are to be found
                           std::shared_ptr<TensorExpansion> tensor_expansion, //in: tensor network expansion form that will be used for each eigenvector
@@ -56,23 +71,69 @@ public:
  void resetMaxIterations(unsigned int max_iterations = DEFAULT_MAX_ITERATIONS);
 
  /** Runs the tensor network eigensolver for one or more extreme eigenroots
-     of the underlying tensor operator. Upon success, returns the achieved
-     accuracy for each eigenroot. **/
+     of the underlying tensor operator (all roots are solved for simultaneously
+     in block mode). Upon success, returns the achieved accuracy for each eigenroot. **/
  bool solve(unsigned int num_roots,                 //in: number of extreme eigenroots to find
             const std::vector<double> ** accuracy); //out: achieved accuracy for each root: accuracy[num_roots]
  bool solve(const ProcessGroup & process_group,     //in: executing process group
             unsigned int num_roots,                 //in: number of extreme eigenroots to find
             const std::vector<double> ** accuracy); //out: achieved accuracy for each root: accuracy[num_roots]
 
- /** Returns the requested eigenvalue and eigenvector. **/
+ /** Returns the requested eigenvalue and eigenvector. The eigenvector is a linear combination
+     of the Krylov basis vectors whose tensors are owned by the eigensolver. **/
  std::shared_ptr<TensorExpansion> getEigenRoot(unsigned int root_id,               //in: root id: [0..max]
                                                std::complex<double> * eigenvalue,  //out: eigenvalue
                                                double * accuracy = nullptr) const; //out: achieved accuracy
 
+ /** Evaluates the projected operator and metrics matrices, H_ij = <bra_i|H|ket_j> and S_ij = <bra_i|ket_j>,
+     stored column-wise, [j*num_bras + i], for a block of ket and bra tensor network expansions
+     as a single fused tensor network expansion. If the mask is provided, only the matrix
+     elements with a TRUE mask entry are evaluated, other matrix elements are left intact.
+     A ket tensor network expansion supplied in the bra block is complex conjugated lazily. **/
+ static bool computeProjectedMatrices(const ProcessGroup & process_group,                               //in: executing process group
+                                      const TensorOperator & tensor_operator,                           //in: tensor operator
+                                      const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,  //in: block of ket tensor network expansions
+                                      const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,  //in: block of bra tensor network expansions
+                                      std::vector<std::complex<double>> & oper_matrix,                  //inout: projected operator matrix
+                                      std::vector<std::complex<double>> & metr_matrix,                  //inout: projected metrics matrix
+                                      const std::vector<bool> & mask = std::vector<bool>{},             //in: mask of the matrix elements to evaluate
+                                      unsigned int parallel_width = 1);                                 //in: requested number of execution subgroups running in parallel
+
+ /** Evaluates the projected metrics matrix, S_ij = <bra_i|ket_j>, stored column-wise, [j*num_bras + i],
+     for a block of ket and bra tensor network expansions as a single fused tensor network expansion.
+     If the mask is provided, only the matrix elements with a TRUE mask entry are evaluated.
+     A ket tensor network expansion supplied in the bra block is complex conjugated lazily. **/
+ static bool computeProjectedMetrics(const ProcessGroup & process_group,                               //in: executing process group
+                                     const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,  //in: block of ket tensor network expansions
+                                     const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,  //in: block of bra tensor network expansions
+                                     std::vector<std::complex<double>> & metr_matrix,                  //inout: projected metrics matrix
+                                     const std::vector<bool> & mask = std::vector<bool>{},             //in: mask of the matrix elements to evaluate
+                                     unsigned int parallel_width = 1);                                 //in: requested number of execution subgroups running in parallel
+
  static void resetDebugLevel(unsigned int level = 0);
 
 private:
 
+ //Evaluates the projected operator (if any) and metrics matrix elements as a single fused tensor network expansion:
+ static bool computeMatrixElements(const ProcessGroup & process_group,
+                                   const TensorOperator * tensor_operator,
+                                   const std::vector<std::shared_ptr<TensorExpansion>> & ket_block,
+                                   const std::vector<std::shared_ptr<TensorExpansion>> & bra_block,
+                                   std::vector<std::complex<double>> * oper_matrix,
+                                   std::vector<std::complex<double>> & metr_matrix,
+                                   const std::vector<bool> & mask,
+                                   unsigned int parallel_width);
+
+ //Creates a new Krylov basis vector in the given tensor network form (randomly initialized):
+ std::shared_ptr<TensorExpansion> createBasisVector(const ProcessGroup & process_group);
+
+ //Reconstructs a given tensor network expansion in the given tensor network form as a new Krylov basis vector:
+ std::shared_ptr<TensorExpansion> reconstructBasisVector(const ProcessGroup & process_group,
+                                                         std::shared_ptr<TensorExpansion> expansion);
+
+ //Destroys the tensors of the Krylov basis vectors:
+ void destroyBasis(std::vector<std::shared_ptr<TensorExpansion>> & basis);
+
  std::shared_ptr<TensorOperator> tensor_operator_;           //tensor operator the extreme eigenroots of which are to be found
  std::shared_ptr<TensorExpansion> tensor_expansion_;         //desired form of the eigenvector as a tensor network expansion
  unsigned int max_iterations_;                               //max number of macro-iterations
@@ -83,6 +144,7 @@ private:
  std::vector<std::shared_ptr<TensorExpansion>> eigenvector_; //tensor network expansion approximating each requested eigenvector
  std::vector<std::complex<double>> eigenvalue_;              //computed eigenvalues
  std::vector<double> accuracy_;                              //actually achieved accuracy for each eigenroot
+ std::vector<std::shared_ptr<TensorExpansion>> basis_;       //Krylov basis vectors the eigenvectors are expanded in
 };
 
 } //namespace exatn
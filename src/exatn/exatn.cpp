@@ -4,10 +4,31 @@
 #include "mpi.h"
 #endif
 
+#include "timers.hpp"
+
 #include <iostream>
 
 namespace exatn {
 
+/** Returns whether or not the plugin bundles are to be loaded on demand **/
+static bool lazyPluginLoading(const ParamConf & parameters)
+{
+  int64_t eager = 0;
+  if(parameters.getParameter("eager_plugin_loading",&eager)) return (eager == 0);
+  return true;
+}
+
+/** Records the startup time breakdown in the numerical server **/
+static void recordStartupTimes(double services_time, double server_time)
+{
+  const auto bundles = serviceRegistry->getNumBundles();
+  numericalServer->recordStartupTime("plugin bundle installation",services_time);
+  numericalServer->recordStartupTime("plugin bundle loading ("+std::to_string(bundles.first)+" of "
+                                     +std::to_string(bundles.second)+" bundles)",serviceRegistry->getBundleStartTime());
+  numericalServer->recordStartupTime("numerical server (total)",server_time);
+  return;
+}
+
 #ifdef MPI_ENABLED
 void initialize(const MPICommProxy & communicator,
                 const ParamConf & parameters,
@@ -15,12 +36,16 @@ void initialize(const MPICommProxy & communicator,
                 const std::string & node_executor_name)
 {
   if(!exatnFrameworkInitialized){
-    serviceRegistry->initialize();
+    auto time_start = exatn::Timer::timeInSecHR();
+    serviceRegistry->initialize("",lazyPluginLoading(parameters));
+    const auto services_time = exatn::Timer::timeInSecHR(time_start);
     //std::cout << "#DEBUG(exatn): ExaTN services initialized" << std::endl << std::flush;
     exatnFrameworkInitialized = true;
     exatnInitializedMPI = false;
+    time_start = exatn::Timer::timeInSecHR();
     numericalServer = std::make_shared<NumServer>(communicator,parameters,graph_executor_name,node_executor_name);
     bool synced = numericalServer->sync(); assert(synced);
+    recordStartupTimes(services_time,exatn::Timer::timeInSecHR(time_start));
     //std::cout << "#DEBUG(exatn): ExaTN numerical server initialized with MPI" << std::endl << std::flush;
   }
   return;
@@ -33,7 +58,9 @@ void initialize(const ParamConf & parameters,
                 const std::string & node_executor_name)
 {
   if(!exatnFrameworkInitialized){
-    serviceRegistry->initialize();
+    auto time_start = exatn::Timer::timeInSecHR();
+    serviceRegistry->initialize("",lazyPluginLoading(parameters));
+    const auto services_time = exatn::Timer::timeInSecHR(time_start);
     //std::cout << "#DEBUG(exatn): ExaTN services initialized" << std::endl << std::flush;
     exatnFrameworkInitialized = true;
 #ifdef MPI_ENABLED
@@ -42,14 +69,18 @@ void initialize(const ParamConf & parameters,
     assert(mpi_error == MPI_SUCCESS);
     assert(thread_provided == MPI_THREAD_MULTIPLE);
     exatnInitializedMPI = true;
+    time_start = exatn::Timer::timeInSecHR();
     numericalServer = std::make_shared<NumServer>(MPICommProxy(MPI_COMM_WORLD),parameters,
                                                   graph_executor_name,node_executor_name);
     bool synced = numericalServer->sync(); assert(synced);
+    recordStartupTimes(services_time,exatn::Timer::timeInSecHR(time_start));
     //std::cout << "#DEBUG(exatn): ExaTN numerical server initialized with MPI" << std::endl << std::flush;
 #else
     exatnInitializedMPI = false;
+    time_start = exatn::Timer::timeInSecHR();
     numericalServer = std::make_shared<NumServer>(parameters,graph_executor_name,node_executor_name);
     bool synced = numericalServer->sync(); assert(synced);
+    recordStartupTimes(services_time,exatn::Timer::timeInSecHR(time_start));
     //std::cout << "#DEBUG(exatn): ExaTN numerical server initialized" << std::endl << std::flush;
 #endif
   }
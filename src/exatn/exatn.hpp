@@ -7,6 +7,7 @@
 #include "remapper.hpp"
 #include "linear_solver.hpp"
 #include "optimizer.hpp"
+#include "differentiator.hpp"
 #include "eigensolver.hpp"
 #include "param_conf.hpp"
 
@@ -14,7 +15,9 @@
 
 namespace exatn {
 
-/** Initializes ExaTN **/
+/** Initializes ExaTN: The plugin bundles (executors, optimizers, etc.) are loaded on demand,
+    unless the "eager_plugin_loading" runtime parameter is set (non-zero). The startup time
+    breakdown is written to the client log once it is opened (resetClientLoggingLevel). **/
 #ifdef MPI_ENABLED
 void initialize(const MPICommProxy & communicator,                               //MPI communicator proxy
                 const ParamConf & parameters = ParamConf(),                      //runtime configuration parameters
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: General client header (free function API)
-REVISION: 2022/03/15
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -19,7 +19,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
  2. Index labels:
     (a) Any registered subspace can be assigned a symbolic index label serving as a placeholder for it;
         an index label can only refer to a single registered (named) subspace it is associated with.
- 3. Tensor [tensor.hpp, tensor_composite.hpp]:
+ 3. Tensor [tensor.hpp, tensor_composite.hpp, tensor_block_sparse.hpp]:
     (a) A tensor is defined by its name, shape and signature.
     (b) Tensor shape is an ordered tuple of tensor dimension extents.
     (c) Tensor signature is an ordered tuple of {space_id,subspace_id} pairs
@@ -29,6 +29,12 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
         Contraction over such a subset of isometric dimensions of a tensor with its
         conjugate produces a Kronecker Delta tensor. Any tensor may have no more than
         two disjoint isometric dimension subsets.
+    (e) A block-sparse tensor [tensor_block_sparse.hpp] has its dimensions decomposed into
+        symmetry sectors labeled by quantum numbers, storing only the blocks allowed by
+        the U(1) or Z(N) symmetry. It is operated on by the block-sparse API only.
+    (f) A structured tensor [tensor_structured.hpp] is an order-2 Kronecker delta, diagonal
+        or permutation tensor stored compactly. Tensor contractions with it are executed
+        without materializing its dense body whenever possible.
  4. Tensor operation [tensor_operation.hpp]:
     (a) Tensor operation is a mathematical operation on one or more tensor arguments.
     (b) Evaluating a tensor operation means computing the value of all its output tensors,
@@ -425,6 +431,51 @@ inline bool destroyTensorsSync()
  {return numericalServer->destroyTensorsSync();}
 
 
+/** Creates a block-sparse tensor: Only its blocks allowed by symmetry are allocated. **/
+inline bool createTensorBlockSparse(std::shared_ptr<TensorBlockSparse> tensor, //in: declared block-sparse tensor
+                                    TensorElementType element_type)         //in: tensor element type
+ {return numericalServer->createTensorBlockSparse(tensor,element_type);}
+
+inline bool createTensorBlockSparse(const ProcessGroup & process_group,        //in: chosen group of MPI processes
+                                    std::shared_ptr<TensorBlockSparse> tensor, //in: declared block-sparse tensor
+                                    TensorElementType element_type)           //in: tensor element type
+ {return numericalServer->createTensorBlockSparse(process_group,tensor,element_type);}
+
+template <typename... Args>
+inline bool createTensorBlockSparse(const std::string & name,                                              //in: tensor name
+                                    TensorElementType element_type,                                        //in: tensor element type
+                                    const std::vector<std::vector<numerics::SymmetryRange>> & dim_sectors, //in: symmetry sectors of each tensor dimension (or empty)
+                                    const std::vector<int> & dim_directions,                               //in: direction of each tensor dimension (+1 or -1)
+                                    SymmetryId total_charge,                                               //in: total quantum number of the tensor
+                                    unsigned int modulus,                                                  //in: symmetry modulus: 0 for U(1), N for Z(N)
+                                    Args&&... args)                                                        //in: other arguments for Tensor ctor
+ {return numericalServer->createTensorBlockSparse(name,element_type,dim_sectors,dim_directions,total_charge,modulus,
+                                                  std::forward<Args>(args)...);}
+
+/** Returns a previously created block-sparse tensor, or nullptr if not found. **/
+inline std::shared_ptr<TensorBlockSparse> getTensorBlockSparse(const std::string & name) //in: tensor name
+ {return numericalServer->getTensorBlockSparse(name);}
+
+/** Destroys a block-sparse tensor (all its stored blocks). **/
+inline bool destroyTensorBlockSparse(const std::string & name) //in: tensor name
+ {return numericalServer->destroyTensorBlockSparse(name);}
+
+
+/** Registers a structured order-2 tensor (Kronecker delta, diagonal or permutation).
+    It is not allocated: Tensor contractions with it are executed as index relabeling,
+    elementwise scaling or reordering of the other input tensor. **/
+inline bool createTensorStructured(std::shared_ptr<TensorStructured> tensor) //in: declared structured tensor
+ {return numericalServer->createTensorStructured(tensor);}
+
+/** Returns a previously registered structured tensor, or nullptr if not found. **/
+inline std::shared_ptr<TensorStructured> getTensorStructured(const std::string & name) //in: tensor name
+ {return numericalServer->getTensorStructured(name);}
+
+/** Unregisters a structured tensor. **/
+inline bool destroyTensorStructured(const std::string & name) //in: tensor name
+ {return numericalServer->destroyTensorStructured(name);}
+
+
 /** Initializes a tensor to some scalar value. **/
 template<typename NumericType>
 inline bool initTensor(const std::string & name, //in: tensor name
@@ -450,6 +501,22 @@ inline bool initTensorDataSync(const std::string & name,                  //in:
  {return numericalServer->initTensorDataSync(name,ext_data);}
 
 
+/** Initializes a tensor with externally provided data residing in an externally owned
+    host buffer (generalized column-wise order) without copying it into ExaTN. The buffer
+    must stay valid until the optional release callback is invoked by ExaTN. **/
+template<typename NumericType>
+inline bool initTensorBuffer(const std::string & name,                 //in: tensor name
+                             const NumericType * ext_buffer,           //in: externally owned host buffer
+                             std::function<void ()> release = nullptr) //in: release callback for the external buffer
+ {return numericalServer->initTensorBuffer(name,ext_buffer,release);}
+
+template<typename NumericType>
+inline bool initTensorBufferSync(const std::string & name,                 //in: tensor name
+                                 const NumericType * ext_buffer,           //in: externally owned host buffer
+                                 std::function<void ()> release = nullptr) //in: release callback for the external buffer
+ {return numericalServer->initTensorBufferSync(name,ext_buffer,release);}
+
+
 /** Initializes a tensor with externally provided data read from a file with format:
      Storage format (string: {dense|list})
      Tensor name
@@ -457,7 +524,9 @@ inline bool initTensorDataSync(const std::string & name,                  //in:
      Tensor signature (space-separated dimension base offsets)
      Tensor elements:
       Dense format: Numeric values (column-wise order), any number of values per line;
-      List format: Numeric value and Multi-index in each line. **/
+      List format: Numeric value and Multi-index in each line.
+    Alternatively, the file may have the binary format (memory-mapped, each process
+    copies only its own tensor slice). **/
 inline bool initTensorFile(const std::string & name,     //in: tensor name
                            const std::string & filename) //in: file name with tensor data
  {return numericalServer->initTensorFile(name,filename);}
@@ -467,6 +536,17 @@ inline bool initTensorFileSync(const std::string & name,     //in: tensor name
  {return numericalServer->initTensorFileSync(name,filename);}
 
 
+/** Resets the seed of the random tensor initialization (same on all processes).
+    The random tensor elements only depend on the seed, the tensor name and
+    the element position, regardless of the tensor distribution. **/
+inline void resetRandomSeed(std::uint64_t seed = NumServer::DEFAULT_RANDOM_SEED) //in: random seed
+ {return numericalServer->resetRandomSeed(seed);}
+
+/** Returns the current seed of the random tensor initialization. **/
+inline std::uint64_t getRandomSeed()
+ {return numericalServer->getRandomSeed();}
+
+
 /** Initializes the tensor body with random values. **/
 inline bool initTensorRnd(const std::string & name) //in: tensor name
  {return numericalServer->initTensorRnd(name);}
@@ -475,6 +555,17 @@ inline bool initTensorRndSync(const std::string & name) //in: tensor name
  {return numericalServer->initTensorRndSync(name);}
 
 
+/** Initializes all stored blocks of a block-sparse tensor to some scalar value. **/
+template<typename NumericType>
+inline bool initTensorBlockSparse(const std::string & name, //in: tensor name
+                                  NumericType value)        //in: scalar value
+ {return numericalServer->initTensorBlockSparse(name,value);}
+
+/** Initializes all stored blocks of a block-sparse tensor to some random value. **/
+inline bool initTensorBlockSparseRnd(const std::string & name) //in: tensor name
+ {return numericalServer->initTensorBlockSparseRnd(name);}
+
+
 /** Initializes all input tensors of a given tensor network to a random value. **/
 inline bool initTensorsRnd(TensorNetwork & tensor_network)     //inout: tensor network
  {return numericalServer->initTensorsRnd(tensor_network);}
@@ -516,6 +607,11 @@ inline bool computeNorm2Sync(const std::string & name, //in: tensor name
                              double & norm)            //out: tensor norm
  {return numericalServer->computeNorm2Sync(name,norm);}
 
+/** Computes 2-norm of a block-sparse tensor. **/
+inline bool computeNorm2BlockSparseSync(const std::string & name, //in: tensor name
+                                        double & norm)            //out: tensor norm
+ {return numericalServer->computeNorm2BlockSparseSync(name,norm);}
+
 
 /** Computes partial 2-norms over a chosen tensor dimension. **/
 inline bool computePartialNormsSync(const std::string & name,            //in: tensor name
@@ -524,11 +620,38 @@ inline bool computePartialNormsSync(const std::string & name,            //in: t
  {return numericalServer->computePartialNormsSync(name,tensor_dimension,partial_norms);}
 
 
+/** Asynchronous (scalar) reductions: Return a deferred future completing the reduction
+    upon get() (a negative norm or empty partial norms indicate a failure). **/
+inline std::future<double> computeMaxAbsAsync(const std::string & name) //in: tensor name
+ {return numericalServer->computeMaxAbsAsync(name);}
+
+inline std::future<double> computeNorm1Async(const std::string & name)  //in: tensor name
+ {return numericalServer->computeNorm1Async(name);}
+
+inline std::future<double> computeNorm2Async(const std::string & name)  //in: tensor name
+ {return numericalServer->computeNorm2Async(name);}
+
+inline std::future<std::vector<double>> computePartialNormsAsync(const std::string & name,       //in: tensor name
+                                                                 unsigned int tensor_dimension) //in: chosen tensor dimension
+ {return numericalServer->computePartialNormsAsync(name,tensor_dimension);}
+
+
 /** Computes 2-norms of all tensors in a tensor network. **/
 inline bool computeNorms2Sync(const TensorNetwork & network,        //in: tensor network
                               std::map<std::string,double> & norms) //out: tensor norms: tensor_name --> norm
  {return numericalServer->computeNorms2Sync(network,norms);}
 
+/** Computes the 1-norm, 2-norm and max-abs norm of multiple tensors with a single fused pass
+    per tensor and a single collective per process group. **/
+inline bool computeNormsSync(const std::vector<std::string> & names, //in: tensor names
+                             std::vector<TensorNorms> & norms)      //out: tensor norms (in the order of names)
+ {return numericalServer->computeNormsSync(names,norms);}
+
+inline bool computeNormsSync(const ProcessGroup & process_group,     //in: chosen group of MPI processes
+                             const std::vector<std::string> & names, //in: tensor names
+                             std::vector<TensorNorms> & norms)      //out: tensor norms (in the order of names)
+ {return numericalServer->computeNormsSync(process_group,names,norms);}
+
 
 /** Replicates a tensor within the given process group, which defaults to all MPI processes.
     Only the root_process_rank within the given process group is required to have the tensor,
@@ -551,6 +674,18 @@ inline bool replicateTensorSync(const ProcessGroup & process_group, //in: chosen
                                 int root_process_rank)              //in: local rank of the root process within the given process group
  {return numericalServer->replicateTensorSync(process_group,name,root_process_rank);}
 
+/** Replicates a tensor within the given process group, keeping a single read-only copy
+    of the tensor body per compute node in MPI-3 shared memory (one writer per update,
+    propagated by broadcastTensor). Composite tensors cannot be replicated. **/
+inline bool replicateTensorSharedSync(const std::string & name,       //in: tensor name
+                                      int root_process_rank)          //in: local rank of the root process within the given process group
+ {return numericalServer->replicateTensorSharedSync(name,root_process_rank);}
+
+inline bool replicateTensorSharedSync(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                                      const std::string & name,           //in: tensor name
+                                      int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->replicateTensorSharedSync(process_group,name,root_process_rank);}
+
 
 /** Shrinks the domain of existence of a given tensor to a single process. **/
 inline bool dereplicateTensor(const std::string & name,           //in: tensor name
@@ -572,6 +707,24 @@ inline bool dereplicateTensorSync(const ProcessGroup & process_group, //in: chos
  {return numericalServer->dereplicateTensorSync(process_group,name,root_process_rank);}
 
 
+/** Redistributes a tensor from its current domain of existence (process group and decomposition)
+    to the target process group with a new decomposition (split dimensions of a composite tensor,
+    or none for a simple tensor replicated within the target process group), moving only the
+    minimal block transfers. Collective within the parent process group (defaults to all MPI processes). **/
+inline bool redistributeTensorSync(const std::string & name,          //in: tensor name
+                                   const ProcessGroup & target_group, //in: target process group
+                                   const std::vector<std::pair<unsigned int,
+                                                               unsigned int>> & split_dims = {}) //in: target split tensor dimensions: pair{Dimension,MaxDepth}
+ {return numericalServer->redistributeTensorSync(name,target_group,split_dims);}
+
+inline bool redistributeTensorSync(const ProcessGroup & process_group, //in: parent group of MPI processes
+                                   const std::string & name,           //in: tensor name
+                                   const ProcessGroup & target_group,  //in: target process group
+                                   const std::vector<std::pair<unsigned int,
+                                                               unsigned int>> & split_dims = {}) //in: target split tensor dimensions: pair{Dimension,MaxDepth}
+ {return numericalServer->redistributeTensorSync(process_group,name,target_group,split_dims);}
+
+
 /** Broadcast a tensor among all MPI processes within a given process group,
     which defaults to all MPI processes. This function is needed when
     a tensor is updated in an operation submitted to a subset of MPI processes
@@ -596,6 +749,36 @@ inline bool broadcastTensorSync(const ProcessGroup & process_group, //in: chosen
  {return numericalServer->broadcastTensorSync(process_group,name,root_process_rank);}
 
 
+/** Broadcasts a tensor network (or a tensor network expansion) built by the root process
+    to all other MPI processes within a given process group, which defaults to all MPI processes.
+    The received tensor network (expansion) replaces the one given on the other MPI processes,
+    with its tensors substituted by the tensors registered under the same names, if any. **/
+inline bool broadcastTensorNetwork(TensorNetwork & network,            //inout: tensor network (received on non-root processes)
+                                   int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->broadcastTensorNetwork(network,root_process_rank);}
+
+inline bool broadcastTensorNetwork(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                                   TensorNetwork & network,            //inout: tensor network (received on non-root processes)
+                                   int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->broadcastTensorNetwork(process_group,network,root_process_rank);}
+
+inline bool broadcastTensorExpansion(TensorExpansion & expansion,        //inout: tensor network expansion (received on non-root processes)
+                                     int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->broadcastTensorExpansion(expansion,root_process_rank);}
+
+inline bool broadcastTensorExpansion(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                                     TensorExpansion & expansion,        //inout: tensor network expansion (received on non-root processes)
+                                     int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->broadcastTensorExpansion(process_group,expansion,root_process_rank);}
+
+/** Broadcasts a raw byte buffer from the root process to all other MPI processes
+    within a given process group (resized on the receiving processes). **/
+inline bool broadcastBytes(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                           std::vector<char> & bytes,          //inout: byte buffer (received on non-root processes)
+                           int root_process_rank)              //in: local rank of the root process within the given process group
+ {return numericalServer->broadcastBytes(process_group,bytes,root_process_rank);}
+
+
 /** Performs a global sum reduction on a tensor among all MPI processes within a given
     process group, which defaults to all MPI processes. This function is needed when
     multiple MPI processes compute their local updates to the tensor, thus requiring
@@ -669,6 +852,52 @@ inline bool insertTensorSliceSync(const std::string & tensor_name, //in: tensor
  {return numericalServer->insertTensorSliceSync(tensor_name,slice_name);}
 
 
+/** Resizes a tensor dimension in place, preserving the tensor identity and
+    the retained block of its body (zero padding when growing). **/
+inline bool resizeTensorSync(const std::string & name, //in: tensor name
+                             unsigned int dimension,   //in: tensor dimension
+                             DimExtent new_extent)     //in: new dimension extent
+ {return numericalServer->resizeTensorSync(name,dimension,new_extent);}
+
+
+/** Performs a single bond adaptivity step on a tensor network, resizing
+    the adapted tensors in place (allocated tensors keep their data). **/
+inline bool adaptBondsSync(TensorNetwork & network,  //inout: adaptive tensor network
+                           bool invalidate = false)  //in: whether to invalidate the cached tensor contraction sequence
+ {return numericalServer->adaptBondsSync(network,invalidate);}
+
+
+/** Approximately evaluates a tensor network, truncating all bonds of its intermediates
+    to max_bond on the fly (boundary-MPS for 2D grids with an imported contraction sequence).
+    The result is accumulated into the existing output tensor. Returns the estimated truncation error. **/
+inline bool evaluateApproximateSync(TensorNetwork & network,   //in: tensor network
+                                    DimExtent max_bond,        //in: bond dimension limit (>0)
+                                    double & truncation_error) //out: estimated truncation error
+ {return numericalServer->evaluateApproximateSync(network,max_bond,truncation_error);}
+
+inline bool evaluateApproximateSync(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                                    TensorNetwork & network,            //in: tensor network
+                                    DimExtent max_bond,                 //in: bond dimension limit (>0)
+                                    double & truncation_error)          //out: estimated truncation error
+ {return numericalServer->evaluateApproximateSync(process_group,network,max_bond,truncation_error);}
+
+
+/** Compresses a tensor network expansion of matrix product states (MPS) into a single MPS
+    directly: Exact direct sum, left-canonicalization and a truncated SVD sweep. **/
+inline bool compressExpansionSync(const TensorExpansion & expansion,           //in: tensor network expansion of MPS
+                                  DimExtent max_bond,                          //in: bond dimension limit (>0)
+                                  std::shared_ptr<TensorNetwork> & compressed, //out: compressed MPS
+                                  double & truncation_error)                   //out: estimated truncation error
+ {return numericalServer->compressExpansionSync(expansion,max_bond,compressed,truncation_error);}
+
+inline bool compressExpansionSync(const ProcessGroup & process_group,          //in: chosen group of MPI processes
+                                  const TensorExpansion & expansion,           //in: tensor network expansion of MPS
+                                  DimExtent max_bond,                          //in: bond dimension limit (>0)
+                                  std::shared_ptr<TensorNetwork> & compressed, //out: compressed MPS
+                                  double & truncation_error)                   //out: estimated truncation error
+ {return numericalServer->compressExpansionSync(process_group,expansion,max_bond,compressed,truncation_error);}
+
+
 /** Assigns one tensor to another congruent one (makes a copy of a tensor).
     If the output tensor with the given name does not exist, it will be created.
     Note that the output tensor must either exist or not exist across all
@@ -708,6 +937,43 @@ inline bool contractTensorsSync(const std::string & contraction, //in: symbolic
  {return numericalServer->contractTensorsSync(contraction,alpha);}
 
 
+/** Performs block-sparse tensor contraction: tensor0 += tensor1 * tensor2 * alpha,
+    executing only the pairs of stored blocks allowed by symmetry. **/
+template<typename NumericType>
+inline bool contractTensorsBlockSparse(const std::string & contraction, //in: symbolic tensor contraction specification
+                                       NumericType alpha)               //in: alpha prefactor
+ {return numericalServer->contractTensorsBlockSparse(contraction,alpha);}
+
+template<typename NumericType>
+inline bool contractTensorsBlockSparseSync(const std::string & contraction, //in: symbolic tensor contraction specification
+                                           NumericType alpha)               //in: alpha prefactor
+ {return numericalServer->contractTensorsBlockSparseSync(contraction,alpha);}
+
+
+/** Prepares a symbolic tensor addition or contraction for repeated execution:
+    Returns a handle binding the parsed specification to the tensor operands,
+    or nullptr if the specification is invalid or some tensor is not found.
+    The handle stays valid as long as its tensor operands are not destroyed. **/
+inline TensorOperationHandle prepareAddition(const std::string & addition) //in: symbolic tensor addition specification
+ {return numericalServer->prepareAddition(addition);}
+
+inline TensorOperationHandle prepareContraction(const std::string & contraction) //in: symbolic tensor contraction specification
+ {return numericalServer->prepareContraction(contraction);}
+
+
+/** Executes a prepared tensor addition or contraction without
+    re-parsing its specification or looking up its tensors by name. **/
+template<typename NumericType>
+inline bool execute(const TensorOperationHandle & handle, //in: prepared tensor operation
+                    NumericType alpha)                    //in: alpha prefactor
+ {return numericalServer->execute(handle,alpha);}
+
+template<typename NumericType>
+inline bool executeSync(const TensorOperationHandle & handle, //in: prepared tensor operation
+                        NumericType alpha)                    //in: alpha prefactor
+ {return numericalServer->executeSync(handle,alpha);}
+
+
 /** Decomposes a tensor into three tensor factors via SVD. The symbolic
     tensor contraction specification specifies the decomposition,
     for example:
@@ -784,6 +1050,25 @@ inline bool orthogonalizeTensorMGSSync(const std::string & name) //in: tensor na
  {return numericalServer->orthogonalizeTensorMGSSync(name);}
 
 
+/** Enforces the registered isometries of a tensor with the chosen orthonormalization
+    algorithm: CholeskyQR2 (default, BLAS-3-like) or modified Gram-Schmidt. **/
+inline bool isometrizeTensor(const std::string & name,                                       //in: tensor name
+                             IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2)      //in: orthonormalization algorithm
+ {return numericalServer->isometrizeTensor(name,method);}
+
+inline bool isometrizeTensorSync(const std::string & name,                                   //in: tensor name
+                                 IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2)  //in: orthonormalization algorithm
+ {return numericalServer->isometrizeTensorSync(name,method);}
+
+/** Resets the orthonormalization algorithm used for the automatic enforcement of tensor isometries. **/
+inline void resetIsometrizeMethod(IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2) //in: orthonormalization algorithm
+ {return numericalServer->resetIsometrizeMethod(method);}
+
+/** Returns the orthonormalization algorithm used for the automatic enforcement of tensor isometries. **/
+inline IsometrizeMethod getIsometrizeMethod()
+ {return numericalServer->getIsometrizeMethod();}
+
+
 /** Prints a tensor to the standard output. **/
 inline bool printTensor(const std::string & name) //in: tensor name
  {return numericalServer->printTensor(name);}
@@ -792,14 +1077,34 @@ inline bool printTensorSync(const std::string & name) //in: tensor name
  {return numericalServer->printTensorSync(name);}
 
 
-/** Prints a tensor to a file. **/
+/** Prints a tensor to a file, either in the text format or in the binary format. **/
 inline bool printTensorFile(const std::string & name,     //in: tensor name
-                            const std::string & filename) //in: file name
- {return numericalServer->printTensorFile(name,filename);}
+                            const std::string & filename, //in: file name
+                            bool binary = false)          //in: binary (true) or text (false) file format
+ {return numericalServer->printTensorFile(name,filename,binary);}
 
 inline bool printTensorFileSync(const std::string & name,     //in: tensor name
-                                const std::string & filename) //in: file name
- {return numericalServer->printTensorFileSync(name,filename);}
+                                const std::string & filename, //in: file name
+                                bool binary = false)          //in: binary (true) or text (false) file format
+ {return numericalServer->printTensorFileSync(name,filename,binary);}
+
+
+/** Saves tensors to a checkpoint file collectively (all registered tensors by default). **/
+inline bool saveTensors(const ProcessGroup & process_group,                  //in: chosen group of MPI processes
+                        const std::string & filename,                        //in: checkpoint file name
+                        const std::vector<std::string> & tensor_names = {}) //in: names of the tensors to save
+ {return numericalServer->saveTensors(process_group,filename,tensor_names);}
+
+inline bool saveTensors(const std::string & filename,                        //in: checkpoint file name
+                        const std::vector<std::string> & tensor_names = {}) //in: names of the tensors to save
+ {return numericalServer->saveTensors(filename,tensor_names);}
+
+
+/** Initializes already created tensors from a checkpoint file (all stored tensors by default),
+    possibly with a different distributed storage (e.g., a different process count). **/
+inline bool loadTensors(const std::string & filename,                        //in: checkpoint file name
+                        const std::vector<std::string> & tensor_names = {}) //in: names of the tensors to load
+ {return numericalServer->loadTensors(filename,tensor_names);}
 
 
 /** Performs a full evaluation of a tensor network specified symbolically, based on
@@ -843,6 +1148,31 @@ inline bool evaluateSync(const ProcessGroup & process_group, //in: chosen group
   return success;}
 
 
+/** Evaluates a bundle of tensor networks with their own output tensors
+    (computes all output tensors, evaluating shared intermediates only once). **/
+inline bool evaluate(const std::vector<std::shared_ptr<TensorNetwork>> & networks) //in: finalized tensor networks
+ {return numericalServer->submit(networks);}
+
+inline bool evaluateSync(const std::vector<std::shared_ptr<TensorNetwork>> & networks) //in: finalized tensor networks
+ {bool success = numericalServer->submit(networks);
+  for(auto & network: networks){
+   if(success) success = numericalServer->sync(*network);
+  }
+  return success;}
+
+inline bool evaluate(const ProcessGroup & process_group,                           //in: chosen group of MPI processes
+                     const std::vector<std::shared_ptr<TensorNetwork>> & networks) //in: finalized tensor networks
+ {return numericalServer->submit(process_group,networks);}
+
+inline bool evaluateSync(const ProcessGroup & process_group,                           //in: chosen group of MPI processes
+                         const std::vector<std::shared_ptr<TensorNetwork>> & networks) //in: finalized tensor networks
+ {bool success = numericalServer->submit(process_group,networks);
+  for(auto & network: networks){
+   if(success) success = numericalServer->sync(process_group,*network);
+  }
+  return success;}
+
+
 /** Evaluates a tensor network expansion into the explicitly provided tensor accumulator. **/
 inline bool evaluate(TensorExpansion & expansion,         //in: tensor network expansion
                      std::shared_ptr<Tensor> accumulator, //inout: tensor accumulator
@@ -873,6 +1203,80 @@ inline bool evaluateSync(const ProcessGroup & process_group,  //in: chosen group
   return success;}
 
 
+/** Evaluates a lazily generated tensor network expansion (tensor network expansion stream)
+    into the explicitly provided tensor accumulator, in batches of bounded size. **/
+inline bool evaluate(TensorExpansionStream & expansion,   //in: tensor network expansion stream
+                     std::shared_ptr<Tensor> accumulator, //inout: tensor accumulator
+                     std::size_t batch_size = 256,        //in: max number of tensor network components per batch
+                     unsigned int parallel_width = 1)     //in: requested number of execution subgroups running in parallel
+ {return numericalServer->submit(expansion,accumulator,batch_size,parallel_width);}
+
+inline bool evaluateSync(TensorExpansionStream & expansion,   //in: tensor network expansion stream
+                         std::shared_ptr<Tensor> accumulator, //inout: tensor accumulator
+                         std::size_t batch_size = 256,        //in: max number of tensor network components per batch
+                         unsigned int parallel_width = 1)     //in: requested number of execution subgroups running in parallel
+ {if(!accumulator) return false;
+  bool success = numericalServer->submit(expansion,accumulator,batch_size,parallel_width);
+  if(success) success = numericalServer->sync(*accumulator);
+  return success;}
+
+inline bool evaluate(const ProcessGroup & process_group,  //in: chosen group of MPI processes
+                     TensorExpansionStream & expansion,   //in: tensor network expansion stream
+                     std::shared_ptr<Tensor> accumulator, //inout: tensor accumulator
+                     std::size_t batch_size = 256,        //in: max number of tensor network components per batch
+                     unsigned int parallel_width = 1)     //in: requested number of execution subgroups running in parallel
+ {return numericalServer->submit(process_group,expansion,accumulator,batch_size,parallel_width);}
+
+inline bool evaluateSync(const ProcessGroup & process_group,  //in: chosen group of MPI processes
+                         TensorExpansionStream & expansion,   //in: tensor network expansion stream
+                         std::shared_ptr<Tensor> accumulator, //inout: tensor accumulator
+                         std::size_t batch_size = 256,        //in: max number of tensor network components per batch
+                         unsigned int parallel_width = 1)     //in: requested number of execution subgroups running in parallel
+ {if(!accumulator) return false;
+  bool success = numericalServer->submit(process_group,expansion,accumulator,batch_size,parallel_width);
+  if(success) success = numericalServer->sync(process_group,*accumulator);
+  return success;}
+
+
+/** Starts capturing all subsequently submitted tensor operations under the given name
+    (for later replay). Captures cannot be nested. **/
+inline bool beginCapture(const std::string & capture_name) //in: capture name
+ {return numericalServer->beginCapture(capture_name);}
+
+/** Stops the active capture. **/
+inline bool endCapture()
+ {return numericalServer->endCapture();}
+
+/** Starts a speculation: Subsequently submitted tensor operations are speculative
+    (returns FALSE if speculative execution is not active). **/
+inline bool beginSpeculation()
+ {return numericalServer->beginSpeculation();}
+
+/** Commits the active speculation (speculative tensor operations are executed as usual). **/
+inline bool commitSpeculation()
+ {return numericalServer->commitSpeculation();}
+
+/** Discards the active speculation: Its tensor operations are cancelled unless
+    already executing. The output tensors should only be destroyed afterwards. **/
+inline bool discardSpeculation()
+ {return numericalServer->discardSpeculation();}
+
+/** Replays a previously captured sequence of tensor operations, skipping all front-end work.
+    Tensor operands are rebound by their captured names: To the tensors from <bindings>, if present,
+    otherwise to the currently registered tensors with the same names, if any. **/
+inline bool replay(const std::string & capture_name, //in: capture name
+                   const std::map<std::string,std::shared_ptr<Tensor>> & bindings = {}) //in: captured tensor name --> replacement tensor
+ {return numericalServer->replay(capture_name,bindings);}
+
+/** Returns TRUE if the capture with the given name exists. **/
+inline bool captureExists(const std::string & capture_name) //in: capture name
+ {return numericalServer->captureExists(capture_name);}
+
+/** Destroys a previously recorded capture. **/
+inline bool destroyCapture(const std::string & capture_name) //in: capture name
+ {return numericalServer->destroyCapture(capture_name);}
+
+
 /** Synchronizes all outstanding update operations on a given tensor specified by
     its symbolic name. If ProcessGroup is not provided, defaults to the local process.**/
 inline bool sync(const std::string & name, //in: tensor name
@@ -1043,6 +1447,23 @@ inline std::shared_ptr<TensorExpansion> projectSliceSync(const ProcessGroup & pr
  {return numericalServer->projectSliceSync(process_group,expansion,slice);}
 
 
+/** Evaluates a batch of elements (amplitudes) of the output tensor of a given tensor network,
+    specified by their multi-indices (e.g., bitstrings), by sharing a few open output legs
+    among the requested elements and projecting out the rest of the output legs. **/
+inline bool evaluateAmplitudesSync(const TensorNetwork & network,                           //in: tensor network
+                                   const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested output tensor elements
+                                   std::vector<std::complex<double>> & amplitudes,           //out: requested output tensor elements
+                                   unsigned int max_open_legs = NumServer::DEFAULT_AMPLITUDE_OPEN_LEGS) //in: max number of open output legs per projected tensor network
+ {return numericalServer->evaluateAmplitudesSync(network,multi_indices,amplitudes,max_open_legs);}
+
+inline bool evaluateAmplitudesSync(const ProcessGroup & process_group,                      //in: chosen group of MPI processes
+                                   const TensorNetwork & network,                           //in: tensor network
+                                   const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested output tensor elements
+                                   std::vector<std::complex<double>> & amplitudes,           //out: requested output tensor elements
+                                   unsigned int max_open_legs = NumServer::DEFAULT_AMPLITUDE_OPEN_LEGS) //in: max number of open output legs per projected tensor network
+ {return numericalServer->evaluateAmplitudesSync(process_group,network,multi_indices,amplitudes,max_open_legs);}
+
+
 ///////////////////////
 // TENSOR ACCESS API //
 ///////////////////////
@@ -1062,6 +1483,23 @@ inline std::shared_ptr<talsh::Tensor> getLocalTensor(const std::string & name) /
  {return numericalServer->getLocalTensor(name);}
 
 
+/** Returns a read-only zero-copy view of the locally stored tensor body,
+    which pins the tensor until all copies of the view have been released. **/
+inline TensorView getTensorView(std::shared_ptr<Tensor> tensor) //in: exatn::numerics::Tensor to view
+ {return numericalServer->getTensorView(tensor);}
+
+inline TensorView getTensorView(const std::string & name) //in: name of the registered exatn::numerics::Tensor
+ {return numericalServer->getTensorView(name);}
+
+
+/** Reads a batch of tensor elements, specified by their multi-indices, into a contiguous array
+    directly from the tensor body (collective within the domain of existence of composite tensors). **/
+inline bool getTensorElementsSync(const std::string & name,                                  //in: name of the registered exatn::numerics::Tensor
+                                  const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested tensor elements
+                                  std::vector<std::complex<double>> & values)                //out: requested tensor elements
+ {return numericalServer->getTensorElementsSync(name,multi_indices,values);}
+
+
 //////////////////////////////
 // MISCELLENEOUS HELPER API //
 //////////////////////////////
@@ -1113,18 +1551,43 @@ inline std::vector<std::string> queryComputationalBackends()
  {return numericalServer->queryComputationalBackends();}
 
 
-/** Switches the computational backend: {"default","cuquantum"}.
-    Only applies to tensor network execution. **/
+/** Reconfigures the tensor runtime in place with new runtime parameters and a new DAG executor,
+    keeping all existing tensors (the node executor and its Host buffer are retained). **/
+inline bool reconfigureRuntime(const ParamConf & parameters,
+                               const std::string & dag_executor_name = "lazy-dag-executor")
+ {return numericalServer->reconfigureRuntime(parameters,dag_executor_name);}
+
+
+/** Switches the computational backend: {"default","cuquantum","auto","exatensor"}.
+    The "auto" backend selects the default or cuQuantum backend per tensor network
+    (both "cuquantum" and "auto" require the lazy DAG executor).
+    The "exatensor" backend reconfigures the tensor runtime (no tensors may exist). **/
 inline void switchComputationalBackend(const std::string & backend_name)
  {return numericalServer->switchComputationalBackend(backend_name);}
 
 
 /** Resets the tensor contraction sequence optimizer that is invoked
-    when evaluating tensor networks: {dummy,heuro,greed,metis}. **/
+    when evaluating tensor networks: {dummy,heuro,greed,metis,dp,auto}. **/
 inline void resetContrSeqOptimizer(const std::string & optimizer_name)
  {return numericalServer->resetContrSeqOptimizer(optimizer_name);}
 
 
+/** Resets the tensor contraction sequence optimizer in the anytime mode: The optimizer
+    keeps improving the tensor contraction sequence until the wall-clock time budget expires.
+    The budget is either fixed (sec) or a fraction of the estimated contraction time. **/
+inline void resetContrSeqOptimizer(const std::string & optimizer_name,
+                                   double time_budget,
+                                   double contraction_time_fraction = 0.0)
+ {return numericalServer->resetContrSeqOptimizer(optimizer_name,numericalServer->queryContrSeqCaching(),
+                                                 time_budget,contraction_time_fraction);}
+
+
+/** Resets the portfolio of tensor contraction sequence optimizers run by processes
+    other than process 0 in the distributed tensor contraction sequence search. **/
+inline void resetContrSeqPortfolio(const std::vector<std::string> & optimizer_names)
+ {return numericalServer->resetContrSeqPortfolio(optimizer_names);}
+
+
 /** Activates optimized tensor contraction sequence caching for later reuse. **/
 inline void activateContrSeqCaching(bool persist = false)
  {return numericalServer->activateContrSeqCaching(persist);}
@@ -1140,6 +1603,166 @@ inline bool queryContrSeqCaching()
  {return numericalServer->queryContrSeqCaching();}
 
 
+/** Activates the slicing-aware tensor contraction sequence search which minimizes
+    the total Flop count of the tensor network sliced under the memory limit. **/
+inline void activateContrSeqSlicing()
+ {return numericalServer->activateContrSeqSlicing();}
+
+
+/** Deactivates the slicing-aware tensor contraction sequence search. **/
+inline void deactivateContrSeqSlicing()
+ {return numericalServer->deactivateContrSeqSlicing();}
+
+
+/** Queries the status of the slicing-aware tensor contraction sequence search. **/
+inline bool queryContrSeqSlicing()
+ {return numericalServer->queryContrSeqSlicing();}
+
+
+/** Activates the reuse of shared intermediates across the components of tensor network
+    expansions: Identical tensor sub-networks are evaluated only once. **/
+inline void activateIntermediateSharing()
+ {return numericalServer->activateIntermediateSharing();}
+
+
+/** Deactivates the reuse of shared intermediates across the components of tensor network expansions. **/
+inline void deactivateIntermediateSharing()
+ {return numericalServer->deactivateIntermediateSharing();}
+
+
+/** Queries the status of the reuse of shared intermediates across the components of tensor network expansions. **/
+inline bool queryIntermediateSharing()
+ {return numericalServer->queryIntermediateSharing();}
+
+
+/** Activates the dynamic scheduling of the sliced tensor sub-networks across the processes
+    (processes request chunks of tensor sub-networks from a shared counter). **/
+inline void activateDynamicSliceScheduling()
+ {return numericalServer->activateDynamicSliceScheduling();}
+
+
+/** Deactivates the dynamic scheduling of the sliced tensor sub-networks (static partition). **/
+inline void deactivateDynamicSliceScheduling()
+ {return numericalServer->deactivateDynamicSliceScheduling();}
+
+
+/** Queries the status of the dynamic scheduling of the sliced tensor sub-networks. **/
+inline bool queryDynamicSliceScheduling()
+ {return numericalServer->queryDynamicSliceScheduling();}
+
+
+/** Activates the double buffering of the input tensor slices in the sliced evaluation of tensor networks
+    (the input slices of the next tensor sub-network are extracted ahead of time). **/
+inline void activateSliceDoubleBuffering()
+ {return numericalServer->activateSliceDoubleBuffering();}
+
+
+/** Deactivates the double buffering of the input tensor slices in the sliced evaluation of tensor networks. **/
+inline void deactivateSliceDoubleBuffering()
+ {return numericalServer->deactivateSliceDoubleBuffering();}
+
+
+/** Queries the status of the double buffering of the input tensor slices in the sliced evaluation of tensor networks. **/
+inline bool querySliceDoubleBuffering()
+ {return numericalServer->querySliceDoubleBuffering();}
+
+
+/** Activates the memoization of tensor network evaluations (a tensor network re-evaluated
+    with all its input tensors unchanged is not recomputed). **/
+inline void activateNetworkMemoization()
+ {return numericalServer->activateNetworkMemoization();}
+
+
+/** Deactivates the memoization of tensor network evaluations. **/
+inline void deactivateNetworkMemoization()
+ {return numericalServer->deactivateNetworkMemoization();}
+
+
+/** Queries the status of the memoization of tensor network evaluations. **/
+inline bool queryNetworkMemoization()
+ {return numericalServer->queryNetworkMemoization();}
+
+
+/** Returns the number of tensor network evaluations skipped due to the memoization. **/
+inline std::size_t getNetworkMemoizationHits()
+ {return numericalServer->getNetworkMemoizationHits();}
+
+
+/** Activates the hybrid Host+accelerator execution of the sliced tensor sub-networks
+    (the Host share is calibrated by the measured Host/accelerator throughput). **/
+inline void activateHybridSliceExecution()
+ {return numericalServer->activateHybridSliceExecution();}
+
+
+/** Deactivates the hybrid Host+accelerator execution of the sliced tensor sub-networks. **/
+inline void deactivateHybridSliceExecution()
+ {return numericalServer->deactivateHybridSliceExecution();}
+
+
+/** Queries the status of the hybrid Host+accelerator execution of the sliced tensor sub-networks. **/
+inline bool queryHybridSliceExecution()
+ {return numericalServer->queryHybridSliceExecution();}
+
+
+/** Returns the current (calibrated) Host share of the sliced tensor sub-networks in the hybrid execution. **/
+inline double getHybridHostShare()
+ {return numericalServer->getHybridHostShare();}
+
+
+/** Resets the reduction strategy of the partial output tensors of tensor networks
+    evaluated by multiple processes (flat allreduce, hierarchical, reduction to root). **/
+inline void resetOutputReduction(OutputReduction reduction = OutputReduction::ALLREDUCE)
+ {return numericalServer->resetOutputReduction(reduction);}
+
+
+/** Returns the current reduction strategy of the partial output tensors. **/
+inline OutputReduction getOutputReduction()
+ {return numericalServer->getOutputReduction();}
+
+
+/** Resets the mapping of the subtensors of composite tensors to processes (fixed or
+    size-balanced and node-aware). Must be chosen before creating the composite tensors. **/
+inline void resetTensorMapping(TensorMapping mapping = TensorMapping::FIXED)
+ {return numericalServer->resetTensorMapping(mapping);}
+
+
+/** Returns the current mapping of the subtensors of composite tensors to processes. **/
+inline TensorMapping getTensorMapping()
+ {return numericalServer->getTensorMapping();}
+
+
+/** Activates the fused evaluation of tensor network expansions: All components accumulate
+    directly into the accumulator (their output tensors are not created). **/
+inline void activateFusedExpansionEvaluation()
+ {return numericalServer->activateFusedExpansionEvaluation();}
+
+
+/** Deactivates the fused evaluation of tensor network expansions. **/
+inline void deactivateFusedExpansionEvaluation()
+ {return numericalServer->deactivateFusedExpansionEvaluation();}
+
+
+/** Queries the status of the fused evaluation of tensor network expansions. **/
+inline bool queryFusedExpansionEvaluation()
+ {return numericalServer->queryFusedExpansionEvaluation();}
+
+
+/** Activates speculative execution in iterative solvers: The work of the next iteration
+    which does not depend on the convergence check is submitted before it resolves. **/
+inline void activateSpeculativeExecution()
+ {return numericalServer->activateSpeculativeExecution();}
+
+
+/** Deactivates speculative execution in iterative solvers. **/
+inline void deactivateSpeculativeExecution()
+ {return numericalServer->deactivateSpeculativeExecution();}
+
+
+/** Queries the status of speculative execution in iterative solvers. **/
+inline bool querySpeculativeExecution()
+ {return numericalServer->querySpeculativeExecution();}
+
+
 /** Resets client logging level (0:none). **/
 inline void resetClientLoggingLevel(int level = 0)
  {return numericalServer->resetClientLoggingLevel(level);}
@@ -1165,16 +1788,84 @@ inline void resetExecutionSerialization(bool serialize,
  {return numericalServer->resetExecutionSerialization(serialize,validation_trace);}
 
 
-/** Activates/deactivates dry run (no actual computations). **/
+/** Starts (interval > 0) or stops (interval <= 0) the live runtime monitor which periodically
+    overwrites the monitor file exatn_monitor.<global MPI rank>.txt with the current runtime state. **/
+inline void activateRuntimeMonitor(double interval)
+ {return numericalServer->activateRuntimeMonitor(interval);}
+
+
+/** Reports the current iteration of an iterative solver to the runtime monitor. **/
+inline void reportSolverIteration(const std::string & solver,
+                                  std::size_t iteration)
+ {return numericalServer->reportSolverIteration(solver,iteration);}
+
+
+/** Activates/deactivates the sampling validation: The given fraction of subsequently
+    submitted tensor operations is checksummed without serializing the execution
+    (checksums are written into the file exatn_validation.<global MPI rank>.txt). **/
+inline void resetValidationSampling(double fraction)
+ {return numericalServer->resetValidationSampling(fraction);}
+
+
+/** Activates/deactivates dry run (no actual computations). Activation starts
+    a new execution plan (predicted execution profile) calibrated by the runtime
+    performance counters of the prior actual computations. **/
 inline void activateDryRun(bool dry_run)
  {return numericalServer->activateDryRun(dry_run);}
 
 
+/** Sets the performance model of an execution device (-1: Host) used by the execution plan:
+    Sustained GFlop/s, sustained memory bandwidth (GB/s), per-operation latency (sec). **/
+inline void setExecutionPlanModel(int device,
+                                  double gflops,
+                                  double gbps,
+                                  double latency)
+ {return numericalServer->setExecutionPlanModel(device,gflops,gbps,latency);}
+
+
+/** Returns the execution plan predicted by the (last) dry run. **/
+inline const ExecutionPlan & getExecutionPlan()
+ {return numericalServer->getExecutionPlan();}
+
+
+/** Writes the execution plan report predicted by the (last) dry run into a text file
+    (default file name: exatn_plan.<global MPI rank>.txt). Returns FALSE on failure. **/
+inline bool writeExecutionPlan(const std::string & filename = std::string())
+ {return numericalServer->writeExecutionPlan(filename);}
+
+
 /** Activates mixed-precision fast math operations on all devices (if available). **/
 inline void activateFastMath()
  {return numericalServer->activateFastMath();}
 
 
+/** Sets the precision policy applied to all subsequently submitted tensor operations
+    which do not carry their own precision policy. The tolerance is the absolute
+    error bound used by the AUTO precision policy. **/
+inline void setPrecisionPolicy(TensorOpPrecision precision,
+                               double tolerance = 0.0)
+ {return numericalServer->setPrecisionPolicy(precision,tolerance);}
+
+
+/** Returns the current precision policy. **/
+inline TensorOpPrecision getPrecisionPolicy()
+ {return numericalServer->getPrecisionPolicy();}
+
+
+/** Sets the truncation mode of all subsequent SVD-based tensor decompositions
+    (randomized truncated SVD, singular value tolerance). **/
+inline void setSVDTruncation(bool randomized,
+                             double tolerance = 0.0)
+ {return numericalServer->setSVDTruncation(randomized,tolerance);}
+
+
+/** Marks a tensor as tolerant to reduced-precision (single-precision)
+    inter-process transfers in subsequent broadcasts/allreduces. **/
+inline void markTensorTransferTolerant(const std::string & name, //in: tensor name
+                                       bool tolerant = true)     //in: whether or not the tensor is tolerant
+ {return numericalServer->markTensorTransferTolerant(name,tolerant);}
+
+
 /** Returns the Host memory buffer size in bytes provided by the runtime. **/
 inline std::size_t getMemoryBufferSize()
  {return numericalServer->getMemoryBufferSize();}
@@ -1186,11 +1877,39 @@ inline std::size_t getMemoryUsage(std::size_t * free_mem)
  {return numericalServer->getMemoryUsage(free_mem);}
 
 
+/** Returns the current memory fragmentation factor: The ratio of the memory usage
+    to the total size of all allocated tensors (1.0: no overhead; 0.0: unknown). **/
+inline double getMemoryFragmentation()
+ {return numericalServer->getMemoryFragmentation();}
+
+
 /** Returns the current value of the Flop counter. **/
 inline double getTotalFlopCount()
  {return numericalServer->getTotalFlopCount();}
 
 
+/** Returns a snapshot of the runtime performance counters: Per-opcode counts and
+    latency histograms, achieved GFlop/s per device, ready queue length over time,
+    TRY_LATER postponements, prefetch hits/misses, Host/device transfer volume,
+    inter-process communication volume, current and peak Host memory buffer usage
+    and fragmentation, the idle/spinning time of the execution thread, and the time
+    spent in the tensor contraction sequence search. **/
+inline RuntimeMetrics getRuntimeMetrics()
+ {return numericalServer->getRuntimeMetrics();}
+
+
+/** Resets the runtime performance counters. **/
+inline void resetRuntimeMetrics()
+ {return numericalServer->resetRuntimeMetrics();}
+
+
+/** Returns the telemetry of the last tensor contraction sequence search: Search phases,
+    number of walkers and rounds, convergence of the best-so-far flop count over time,
+    chosen max intermediate volume and number of slices. **/
+inline ContractionSeqOptimizer::SearchTelemetry getContrSeqTelemetry()
+ {return numericalServer->getContrSeqTelemetry();}
+
+
 /** Returns the default process group comprising all MPI processes and their communicator. **/
 inline const ProcessGroup & getDefaultProcessGroup()
  {return numericalServer->getDefaultProcessGroup();}
@@ -1201,6 +1920,12 @@ inline const ProcessGroup & getCurrentProcessGroup()
  {return numericalServer->getCurrentProcessGroup();}
 
 
+/** Returns the node process group comprising all MPI processes running on the same compute node
+    as the current MPI process. **/
+inline const ProcessGroup & getNodeProcessGroup()
+ {return numericalServer->getNodeProcessGroup();}
+
+
 /** Returns the local rank of the MPI process in a given process group, or -1 if it does not belong to it. **/
 inline int getProcessRank(const ProcessGroup & process_group)
  {return numericalServer->getProcessRank(process_group);}
@@ -0,0 +1,249 @@
+/** ExaTN:: Predicted execution plan (dry run cost model)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "execution_plan.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace exatn{
+
+//Default performance models (used unless calibrated or set explicitly):
+static const ExecutionPlan::DeviceModel DEFAULT_HOST_MODEL{100.0,50.0,1e-5};  //Host: {GFlop/s, GB/s, latency}
+static const ExecutionPlan::DeviceModel DEFAULT_NETWORK_MODEL{0.0,10.0,5e-6}; //network: {-, GB/s, latency}
+static const ExecutionPlan::DeviceModel DEFAULT_DEVICE_MODEL{5000.0,800.0,2e-5}; //accelerator: {GFlop/s, GB/s, latency}
+
+
+static bool is_communication(TensorOpCode opcode)
+{
+ return (opcode == TensorOpCode::FETCH || opcode == TensorOpCode::UPLOAD ||
+         opcode == TensorOpCode::BROADCAST || opcode == TensorOpCode::ALLREDUCE);
+}
+
+
+ExecutionPlan::ExecutionPlan():
+ network_(DEFAULT_NETWORK_MODEL), live_memory_(0.0), peak_memory_(0.0), comm_volume_(0.0), comm_time_(0.0)
+{
+ models_.emplace(-1,DEFAULT_HOST_MODEL);
+ calibrated_.emplace(-1,false);
+}
+
+
+void ExecutionPlan::reset()
+{
+ op_stats_.clear();
+ dev_stats_.clear();
+ networks_.clear();
+ live_memory_ = 0.0;
+ peak_memory_ = 0.0;
+ comm_volume_ = 0.0;
+ comm_time_ = 0.0;
+ return;
+}
+
+
+void ExecutionPlan::calibrate(const runtime::RuntimeMetrics & metrics)
+{
+ for(const auto & device: metrics.devices){
+  if(device.flops >= MIN_CALIBRATION_FLOPS && device.gflops > 0.0){
+   auto iter = models_.find(device.device);
+   if(iter == models_.end()){
+    iter = models_.emplace(device.device,(device.device < 0) ? DEFAULT_HOST_MODEL : DEFAULT_DEVICE_MODEL).first;
+   }
+   iter->second.gflops = device.gflops;
+   calibrated_[device.device] = true;
+  }
+ }
+ return;
+}
+
+
+void ExecutionPlan::setDeviceModel(int device,
+                                   const DeviceModel & model)
+{
+ if(device < 0) device = -1;
+ models_[device] = model;
+ calibrated_[device] = true;
+ return;
+}
+
+
+void ExecutionPlan::setNetworkModel(const DeviceModel & model)
+{
+ network_ = model;
+ return;
+}
+
+
+double ExecutionPlan::predictTime(const DeviceModel & model,
+                                  double flops,
+                                  double bytes)
+{
+ double time = 0.0;
+ if(model.gflops > 0.0) time = std::max(time,flops / (model.gflops * 1e9));
+ if(model.gbps > 0.0) time = std::max(time,bytes / (model.gbps * 1e9));
+ return (time + model.latency);
+}
+
+
+void ExecutionPlan::recordOperation(const numerics::TensorOperation & op)
+{
+ const auto opcode = op.getOpcode();
+ auto element_type = TensorElementType::VOID;
+ double bytes = 0.0;
+ const auto num_operands = op.getNumOperandsSet();
+ for(unsigned int i = 0; i < num_operands; ++i){
+  const auto tensor = op.getTensorOperand(i);
+  if(tensor){
+   const auto compute_type = tensorComputeElementType(tensor->getElementType());
+   if(element_type == TensorElementType::VOID) element_type = compute_type;
+   bytes += static_cast<double>(tensor->getVolume()) *
+            static_cast<double>(numerics::tensor_element_type_size(compute_type));
+  }
+ }
+ //Symbolic live tensor memory:
+ if(opcode == TensorOpCode::CREATE || opcode == TensorOpCode::DESTROY){
+  if(opcode == TensorOpCode::CREATE){
+   live_memory_ += bytes;
+   peak_memory_ = std::max(peak_memory_,live_memory_);
+  }else{
+   live_memory_ = std::max(0.0,live_memory_ - bytes);
+  }
+  auto & stats = op_stats_[static_cast<int>(opcode)];
+  ++(stats.count);
+  stats.bytes += bytes;
+  return;
+ }
+ double flops = op.getFlopEstimate();
+ if(flops > 0.0) flops *= tensorElementTypeOpFactor(element_type);
+ if(flops < 0.0) flops = 0.0;
+ double time = 0.0;
+ if(is_communication(opcode)){ //communication follows the network model
+  const auto tensor = op.getTensorOperand(0);
+  const double payload = tensor ? (static_cast<double>(tensor->getVolume()) *
+   static_cast<double>(numerics::tensor_element_type_size(tensorComputeElementType(tensor->getElementType())))) : 0.0;
+  time = predictTime(network_,0.0,payload);
+  comm_volume_ += payload;
+  comm_time_ += time;
+ }else{ //computation follows the fastest device model
+  int device = -1;
+  time = predictTime(models_.at(-1),flops,bytes);
+  if(flops > 0.0){
+   for(const auto & model: models_){
+    if(model.first >= 0){
+     const double device_time = predictTime(model.second,flops,bytes);
+     if(device_time < time){
+      time = device_time;
+      device = model.first;
+     }
+    }
+   }
+  }
+  auto & dev_stats = dev_stats_[device];
+  ++(dev_stats.count);
+  dev_stats.flops += flops;
+  dev_stats.time += time;
+ }
+ auto & stats = op_stats_[static_cast<int>(opcode)];
+ ++(stats.count);
+ stats.flops += flops;
+ stats.bytes += bytes;
+ stats.time += time;
+ return;
+}
+
+
+void ExecutionPlan::recordNetwork(const std::string & name,
+                                  std::size_t num_slices,
+                                  std::size_t local_slices,
+                                  double flops,
+                                  double peak_bytes)
+{
+ networks_.emplace_back(NetworkStats{name,num_slices,local_slices,flops,peak_bytes});
+ return;
+}
+
+
+double ExecutionPlan::getPredictedTime() const
+{
+ double time = comm_time_;
+ for(const auto & stats: dev_stats_) time += stats.second.time;
+ return time;
+}
+
+
+double ExecutionPlan::getPredictedPeakMemory() const
+{
+ return peak_memory_;
+}
+
+
+double ExecutionPlan::getPredictedCommVolume() const
+{
+ return comm_volume_;
+}
+
+
+void ExecutionPlan::printReport(std::ostream & output_stream,
+                                int process_id) const
+{
+ double max_presence = 0.0;
+ for(const auto & network: networks_) max_presence = std::max(max_presence,network.peak_bytes);
+ output_stream << "#ExecutionPlan: Process " << process_id << std::scientific << std::setprecision(3)
+               << ": Predicted time = " << getPredictedTime() << " sec; Peak tensor memory = "
+               << peak_memory_ << " bytes; Max intermediate presence = " << max_presence
+               << " bytes; Communication = " << comm_volume_ << " bytes (" << comm_time_ << " sec)" << std::endl;
+ //Performance models:
+ output_stream << std::left << std::setw(10) << "Device" << std::right << std::setw(11) << "GFlop/s"
+               << std::setw(11) << "GB/s" << std::setw(11) << "Latency" << std::setw(12) << "Calibrated" << std::endl;
+ for(const auto & model: models_){
+  const auto iter = calibrated_.find(model.first);
+  output_stream << std::left << std::setw(10) << ((model.first < 0) ? std::string("Host") : std::to_string(model.first))
+                << std::right << std::setw(11) << model.second.gflops << std::setw(11) << model.second.gbps
+                << std::setw(11) << model.second.latency
+                << std::setw(12) << ((iter != calibrated_.cend() && iter->second) ? "yes" : "no") << std::endl;
+ }
+ output_stream << std::left << std::setw(10) << "Network" << std::right << std::setw(11) << "-"
+               << std::setw(11) << network_.gbps << std::setw(11) << network_.latency << std::setw(12) << "-" << std::endl;
+ //Predictions per tensor operation kind:
+ output_stream << std::left << std::setw(18) << "Opcode" << std::right << std::setw(10) << "Count"
+               << std::setw(11) << "GFlop" << std::setw(11) << "GByte" << std::setw(11) << "Time" << std::endl;
+ for(const auto & entry: op_stats_){
+  const auto & stats = entry.second;
+  output_stream << std::left << std::setw(18) << runtime::ExecTrace::opcodeName(entry.first) << std::right << std::setw(10) << stats.count
+                << std::setw(11) << (stats.flops * 1e-9) << std::setw(11) << (stats.bytes * 1e-9)
+                << std::setw(11) << stats.time << std::endl;
+ }
+ //Predictions per execution device:
+ output_stream << std::left << std::setw(10) << "Device" << std::right << std::setw(10) << "Count"
+               << std::setw(11) << "GFlop" << std::setw(11) << "Time" << std::endl;
+ for(const auto & entry: dev_stats_){
+  output_stream << std::left << std::setw(10) << ((entry.first < 0) ? std::string("Host") : std::to_string(entry.first))
+                << std::right << std::setw(10) << entry.second.count << std::setw(11) << (entry.second.flops * 1e-9)
+                << std::setw(11) << entry.second.time << std::endl;
+ }
+ //Tensor networks:
+ for(const auto & network: networks_){
+  output_stream << "Network " << network.name << ": Slices = " << network.num_slices
+                << " (local " << network.local_slices << "); GFlop = " << (network.flops * 1e-9)
+                << "; Max intermediate presence = " << network.peak_bytes << " bytes" << std::endl;
+ }
+ return;
+}
+
+
+bool ExecutionPlan::writeReport(const std::string & filename,
+                                int process_id) const
+{
+ std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+ if(!report_file.is_open()) return false;
+ printReport(report_file,process_id);
+ report_file.close();
+ return true;
+}
+
+} //namespace exatn
@@ -0,0 +1,149 @@
+/** ExaTN:: Predicted execution plan (dry run cost model)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) The execution plan accumulates the predicted execution profile of all tensor operations
+     submitted by the current process while the dry run is active (no actual computations):
+     Predicted execution time per tensor operation kind and per execution device, predicted
+     peak memory, predicted communication volume, and the slicing of each tensor network.
+ (B) The predicted execution time of a tensor operation follows a per-device performance model
+     {GFlop/s, GB/s, latency}: time = latency + max(flops / GFlop/s, bytes / GB/s), where flops
+     is the flop estimate scaled by the element type operation factor and bytes is the combined
+     size of all tensor operands in the compute precision. A tensor operation with a flop count
+     is assigned to the device predicting the shortest time, otherwise to the Host. Communication
+     tensor operations (FETCH, UPLOAD, BROADCAST, ALLREDUCE) follow the network model instead.
+     The predicted total time is serial (sum over all tensor operations), thus an upper bound
+     when tensor operations overlap across devices.
+ (C) The performance model is calibrated from the achieved per-device GFlop/s of the runtime
+     performance counters (a prior real run), the rest of it comes from the default models
+     unless set explicitly. Calibration ignores devices with too little executed work.
+ (D) Predicted memory: The live tensor memory is tracked symbolically (CREATE adds, DESTROY
+     subtracts the tensor size), giving the predicted peak tensor memory of the current process.
+     Additionally, each tensor network records its predicted max intermediate presence
+     (after slicing), the number of slices chosen and the number of slices assigned to the current
+     process, thus a memory limit and the process count can be sized before the actual run.
+**/
+
+#ifndef EXATN_EXECUTION_PLAN_HPP_
+#define EXATN_EXECUTION_PLAN_HPP_
+
+#include "tensor_basic.hpp"
+#include "tensor_operation.hpp"
+#include "tensor_runtime.hpp"
+#include "exec_trace.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace exatn{
+
+class ExecutionPlan{
+
+public:
+
+ static constexpr const double MIN_CALIBRATION_FLOPS = 1e9; //min executed flop count for a device to be calibrated
+
+ /** Performance model of an execution device (or the network). **/
+ struct DeviceModel{
+  double gflops;  //sustained GFlop/s
+  double gbps;    //sustained memory (network) bandwidth (GB/s)
+  double latency; //per-operation latency (sec)
+ };
+
+ ExecutionPlan();
+
+ ExecutionPlan(const ExecutionPlan &) = default;
+ ExecutionPlan & operator=(const ExecutionPlan &) = default;
+ ExecutionPlan(ExecutionPlan &&) noexcept = default;
+ ExecutionPlan & operator=(ExecutionPlan &&) noexcept = default;
+ ~ExecutionPlan() = default;
+
+ /** Discards all recorded predictions (the performance model is retained). **/
+ void reset();
+
+ /** Calibrates the GFlop/s of the device models from the runtime performance counters
+     (only the devices which have executed enough work are calibrated). **/
+ void calibrate(const runtime::RuntimeMetrics & metrics);
+
+ /** Sets the performance model of an execution device (-1: Host). **/
+ void setDeviceModel(int device,
+                     const DeviceModel & model);
+
+ /** Sets the performance model of the network (inter-process communication). **/
+ void setNetworkModel(const DeviceModel & model);
+
+ /** Records the prediction for a submitted tensor operation. **/
+ void recordOperation(const numerics::TensorOperation & op);
+
+ /** Records the slicing and predicted max intermediate presence of a submitted tensor network. **/
+ void recordNetwork(const std::string & name, //in: tensor network name (with its output tensor)
+                    std::size_t num_slices,   //in: total number of slices (tensor sub-networks)
+                    std::size_t local_slices, //in: number of slices assigned to the current process
+                    double flops,             //in: total flop count of the tensor network
+                    double peak_bytes);       //in: predicted max intermediate presence (bytes)
+
+ /** Returns the predicted (serial) execution time (sec). **/
+ double getPredictedTime() const;
+
+ /** Returns the predicted peak tensor memory of the current process (bytes). **/
+ double getPredictedPeakMemory() const;
+
+ /** Returns the predicted communication volume of the current process (bytes). **/
+ double getPredictedCommVolume() const;
+
+ /** Prints the execution plan report. **/
+ void printReport(std::ostream & output_stream,
+                  int process_id) const;
+
+ /** Writes the execution plan report into a text file. Returns FALSE on failure. **/
+ bool writeReport(const std::string & filename,
+                  int process_id) const;
+
+protected:
+
+ struct OpStats{
+  std::size_t count = 0; //number of tensor operations
+  double flops = 0.0;    //total flop count
+  double bytes = 0.0;    //total size of the tensor operands (bytes)
+  double time = 0.0;     //total predicted time (sec)
+ };
+
+ struct DeviceStats{
+  std::size_t count = 0; //number of tensor operations assigned to the device
+  double flops = 0.0;    //total flop count
+  double time = 0.0;     //total predicted time (sec)
+ };
+
+ struct NetworkStats{
+  std::string name;         //tensor network name
+  std::size_t num_slices;   //total number of slices
+  std::size_t local_slices; //number of slices assigned to the current process
+  double flops;             //total flop count
+  double peak_bytes;        //predicted max intermediate presence (bytes)
+ };
+
+ /** Returns the predicted time of a tensor operation on a device. **/
+ static double predictTime(const DeviceModel & model,
+                           double flops,
+                           double bytes);
+
+ std::map<int,DeviceModel> models_;  //performance models of execution devices (-1: Host)
+ std::map<int,bool> calibrated_;     //whether or not a device model has been calibrated
+ DeviceModel network_;               //performance model of the network
+ std::map<int,OpStats> op_stats_;    //predictions per tensor operation code
+ std::map<int,DeviceStats> dev_stats_; //predictions per execution device
+ std::vector<NetworkStats> networks_; //submitted tensor networks
+ double live_memory_;                //current live tensor memory (bytes)
+ double peak_memory_;                //peak live tensor memory (bytes)
+ double comm_volume_;                //communication volume (bytes)
+ double comm_time_;                  //predicted communication time (sec)
+};
+
+} //namespace exatn
+
+#endif //EXATN_EXECUTION_PLAN_HPP_
@@ -1,13 +1,26 @@
 /** ExaTN:: Linear solver over tensor network manifolds
-REVISION: 2021/10/22
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "linear_solver.hpp"
 #include "reconstructor.hpp"
+#include "eigensolver.hpp"
 
 #include <iostream>
+#include <cmath>
+
+//LAPACK zgesv:
+extern "C" {
+void zgesv_(
+ int const * n,
+ int const * nrhs,
+ void * A, int const * lda,
+ int * ipiv,
+ void * B, int const * ldb,
+ int * info);
+}
 
 namespace exatn{
 
@@ -26,6 +39,7 @@ TensorNetworkLinearSolver::TensorNetworkLinearSolver(std::shared_ptr<TensorOpera
 #else
  parallel_(false),
 #endif
+ krylov_(false), max_krylov_dim_(DEFAULT_MAX_KRYLOV_DIM), num_applications_(0),
  residual_norm_(0.0), fidelity_(0.0)
 {
  if(!rhs_expansion_->isKet()){
@@ -84,6 +98,13 @@ bool TensorNetworkLinearSolver::solve(const ProcessGroup & process_group, double
   if(getProcessRank() != TensorNetworkLinearSolver::focus) TensorNetworkLinearSolver::debug = 0;
  }
 
+ if(krylov_){
+  bool solved = solve_krylov(process_group,num_procs);
+  if(residual_norm != nullptr) *residual_norm = residual_norm_;
+  if(fidelity != nullptr) *fidelity = fidelity_;
+  return solved;
+ }
+
  //Construct the |A*|b> tensor network expansion:
  rhs_expansion_->conjugate();
  opvec_expansion_ = std::make_shared<TensorExpansion>(*rhs_expansion_,*tensor_operator_);
@@ -123,6 +144,178 @@ bool TensorNetworkLinearSolver::solve(const ProcessGroup & process_group, double
 }
 
 
+bool TensorNetworkLinearSolver::solve_krylov(const ProcessGroup & process_group, unsigned int num_procs)
+{
+ assert(max_krylov_dim_ > 1);
+ num_applications_ = 0;
+ residual_norm_ = 0.0;
+ fidelity_ = 0.0;
+
+ //Normalize |b> to unity (in a shallow copy):
+ auto rhs = std::make_shared<TensorExpansion>(*rhs_expansion_);
+ double rhs_norm = 0.0;
+ bool success = normalizeNorm2Sync(process_group,*rhs,1.0,&rhs_norm); assert(success);
+ if(TensorNetworkLinearSolver::debug > 0)
+  std::cout << "#DEBUG(exatn::TensorNetworkLinearSolver): Original |b> norm = " << rhs_norm << std::endl;
+
+ //Flexible GMRES iterations:
+ std::vector<std::shared_ptr<TensorExpansion>> basis;        //Krylov basis vectors: |v_i>
+ std::vector<std::shared_ptr<TensorExpansion>> op_basis;     //A|v_i>
+ std::vector<std::complex<double>> gram;                     //<v_i|A'A|v_j>: [j*evaluated_dim + i]
+ std::vector<std::complex<double>> proj;                     //<v_i|A'|b>: [i]
+ std::vector<std::complex<double>> coefs;                    //expansion coefficients of the solution in the Krylov basis
+ unsigned int evaluated_dim = 0;                             //number of Krylov basis vectors with evaluated matrix elements
+ double relative_residual = 1.0;
+ auto direction = rhs;
+ bool converged = false;
+ for(unsigned int iteration = 0; iteration < max_iterations_; ++iteration){
+  numericalServer->reportSolverIteration("TensorNetworkLinearSolver",iteration);
+  //Restart the Krylov subspace from the compressed current solution:
+  if(basis.size() >= max_krylov_dim_){
+   auto solution = makeSharedTensorExpansion("_KrylovSolution");
+   for(unsigned int i = 0; i < basis.size(); ++i){
+    success = solution->appendExpansion(*(basis[i]),coefs[i]); assert(success);
+   }
+   auto restart_vector = compressVector(process_group,solution);
+   destroyVectors(basis);
+   op_basis.clear();
+   evaluated_dim = 0;
+   basis.emplace_back(restart_vector);
+  }
+  //Precondition the search direction and compress it into a new Krylov basis vector:
+  if(preconditioner_) direction = std::make_shared<TensorExpansion>(*direction,*preconditioner_);
+  basis.emplace_back(compressVector(process_group,direction));
+  //Apply the tensor network operator to the new Krylov basis vectors:
+  for(unsigned int i = op_basis.size(); i < basis.size(); ++i){
+   op_basis.emplace_back(std::make_shared<TensorExpansion>(*(basis[i]),*tensor_operator_));
+   ++num_applications_;
+  }
+  //Evaluate the new matrix elements of the projected normal equations together:
+  const unsigned int dim = basis.size();
+  auto kets = op_basis;
+  kets.emplace_back(rhs);
+  std::vector<std::complex<double>> elements((dim+1)*dim,std::complex<double>{0.0,0.0});
+  std::vector<bool> mask((dim+1)*dim,true);
+  for(unsigned int i = 0; i < evaluated_dim; ++i){
+   for(unsigned int j = 0; j < evaluated_dim; ++j){
+    elements[j*dim + i] = gram[j*evaluated_dim + i];
+    mask[j*dim + i] = false;
+   }
+   elements[dim*dim + i] = proj[i];
+   mask[dim*dim + i] = false;
+  }
+  success = TensorNetworkEigenSolver::computeProjectedMetrics(process_group,kets,op_basis, //<v_i|A' is conjugated lazily
+                                                              elements,mask,num_procs); assert(success);
+  gram.assign(elements.cbegin(),elements.cbegin() + dim*dim);
+  proj.assign(elements.cbegin() + dim*dim,elements.cend());
+  evaluated_dim = dim;
+  //Solve the projected normal equations:
+  int info = 0;
+  const int matrix_dim = dim;
+  const int num_rhs = 1;
+  std::vector<std::complex<double>> matrix(gram);
+  std::vector<int> pivots(dim);
+  coefs = proj;
+  zgesv_(&matrix_dim,&num_rhs,(void*)matrix.data(),&matrix_dim,pivots.data(),
+         (void*)coefs.data(),&matrix_dim,&info);
+  if(info != 0){
+   std::cout << "#ERROR(exatn::TensorNetworkLinearSolver): Projected normal equations are singular: Error "
+             << info << std::endl << std::flush;
+   success = false;
+   break;
+  }
+  //Compute the residual norm: <r|r> = 1 - 2*Re(y'*c) + y'*G*y:
+  std::complex<double> residual2{1.0,0.0};
+  for(unsigned int i = 0; i < dim; ++i){
+   residual2 -= 2.0 * std::real(std::conj(coefs[i]) * proj[i]);
+   for(unsigned int j = 0; j < dim; ++j) residual2 += std::conj(coefs[i]) * gram[j*dim + i] * coefs[j];
+  }
+  relative_residual = std::sqrt(std::max(0.0,residual2.real()));
+  if(TensorNetworkLinearSolver::debug > 0)
+   std::cout << "#DEBUG(exatn::TensorNetworkLinearSolver): Krylov iteration " << iteration
+             << ": Subspace dimension = " << dim << ": Relative residual norm = "
+             << std::scientific << relative_residual << std::endl;
+  converged = (relative_residual <= tolerance_);
+  if(converged) break;
+  //Form the new residual as the next search direction:
+  direction = std::make_shared<TensorExpansion>(*rhs);
+  for(unsigned int i = 0; i < dim; ++i){
+   success = direction->appendExpansion(*(op_basis[i]),-coefs[i]); assert(success);
+  }
+ }
+
+ //Reconstruct the solution in the given tensor network form:
+ if(success){
+  auto solution = makeSharedTensorExpansion("_KrylovSolution");
+  for(unsigned int i = 0; i < basis.size(); ++i){
+   success = solution->appendExpansion(*(basis[i]),coefs[i]); assert(success);
+  }
+  double solution_norm = 0.0;
+  success = normalizeNorm2Sync(process_group,*solution,1.0,&solution_norm); assert(success);
+  vector_expansion_->conjugate();
+  vector_expansion_->markOptimizableAllTensors();
+  exatn::TensorNetworkReconstructor::resetDebugLevel(TensorNetworkLinearSolver::debug,
+                                                     TensorNetworkLinearSolver::focus);
+  exatn::TensorNetworkReconstructor reconstructor(solution,vector_expansion_,tolerance_);
+  success = exatn::sync(process_group); assert(success);
+  double reconstruction_residual = 0.0;
+  success = reconstructor.reconstruct(process_group,&reconstruction_residual,&fidelity_,true,true);
+  bool synced = exatn::sync(process_group); assert(synced);
+  vector_expansion_->conjugate();
+  vector_expansion_->rescale(std::complex<double>{solution_norm*rhs_norm,0.0});
+  residual_norm_ = relative_residual * rhs_norm;
+  if(TensorNetworkLinearSolver::debug > 0)
+   std::cout << "#DEBUG(exatn::TensorNetworkLinearSolver): Krylov solve " << (converged ? "converged" : "did not converge")
+             << ": Residual norm = " << residual_norm_ << "; Reconstruction fidelity = " << fidelity_
+             << "; Operator applications = " << num_applications_ << std::endl;
+  if(!success) std::cout << "#ERROR(exatn::TensorNetworkLinearSolver): Solution reconstruction failed!" << std::endl;
+ }
+ destroyVectors(basis);
+ bool synced = exatn::sync(process_group); assert(synced);
+ return (success && converged);
+}
+
+
+std::shared_ptr<TensorExpansion> TensorNetworkLinearSolver::compressVector(const ProcessGroup & process_group,
+                                                                           std::shared_ptr<TensorExpansion> expansion,
+                                                                           double * fidelity)
+{
+ //Normalize the compressed tensor network expansion (in a shallow copy):
+ auto target = std::make_shared<TensorExpansion>(*expansion);
+ bool success = normalizeNorm2Sync(process_group,*target,1.0); assert(success);
+ //Reconstruct it in the tensor network form of the unknown vector:
+ auto compressed = duplicateSync(process_group,*vector_expansion_); assert(compressed);
+ compressed->markOptimizableAllTensors();
+ compressed->conjugate();
+ exatn::TensorNetworkReconstructor reconstructor(target,compressed,tolerance_);
+ reconstructor.resetMaxIterations(DEFAULT_COMPRESSION_ITERATIONS);
+ success = exatn::sync(process_group); assert(success);
+ double residual_norm = 0.0, vector_fidelity = 0.0;
+ bool reconstructed = reconstructor.reconstruct(process_group,&residual_norm,&vector_fidelity,true,true);
+ success = exatn::sync(process_group); assert(success);
+ compressed->conjugate();
+ if(TensorNetworkLinearSolver::debug > 1)
+  std::cout << "#DEBUG(exatn::TensorNetworkLinearSolver): Krylov vector compressed (" << reconstructed
+            << ") with fidelity " << vector_fidelity << std::endl;
+ //Balance the norms of the tensor factors:
+ success = balanceNormalizeNorm2Sync(process_group,*compressed,1.0,1.0,true); assert(success);
+ if(fidelity != nullptr) *fidelity = vector_fidelity;
+ return compressed;
+}
+
+
+void TensorNetworkLinearSolver::destroyVectors(std::vector<std::shared_ptr<TensorExpansion>> & vectors)
+{
+ for(auto & vector: vectors){
+  for(auto net = vector->begin(); net != vector->end(); ++net){
+   bool success = exatn::destroyTensors(*(net->network)); assert(success);
+  }
+ }
+ vectors.clear();
+ return;
+}
+
+
 void TensorNetworkLinearSolver::enableParallelization(bool parallel)
 {
  parallel_ = parallel;
@@ -130,6 +323,27 @@ void TensorNetworkLinearSolver::enableParallelization(bool parallel)
 }
 
 
+void TensorNetworkLinearSolver::enableKrylov(bool krylov, unsigned int max_krylov_dim)
+{
+ krylov_ = krylov;
+ max_krylov_dim_ = max_krylov_dim;
+ return;
+}
+
+
+void TensorNetworkLinearSolver::resetPreconditioner(std::shared_ptr<TensorOperator> preconditioner)
+{
+ preconditioner_ = preconditioner;
+ return;
+}
+
+
+unsigned int TensorNetworkLinearSolver::getNumOperatorApplications() const
+{
+ return num_applications_;
+}
+
+
 void TensorNetworkLinearSolver::resetDebugLevel(unsigned int level, int focus_process)
 {
  TensorNetworkLinearSolver::debug = level;
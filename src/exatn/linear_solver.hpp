@@ -1,5 +1,5 @@
 /** ExaTN:: Linear solver over tensor network manifolds
-REVISION: 2021/10/22
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -8,6 +8,21 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
  (A) Solves a linear system A * x = b, where A is a tensor network operator,
      b is a given tensor network expansion, and x is the unknown tensor
      network expansion sought for.
+ (B) By default, the linear system is solved by reconstructing the unknown tensor
+     network expansion from the normalized |A*|b> tensor network expansion.
+ (C) Krylov mode: A preconditioned minimal-residual Krylov method (flexible GMRES)
+     over tensor network expansions. Each new Krylov basis vector is the (optionally
+     preconditioned) current residual compressed into the tensor network form of
+     the unknown vector (fixed-rank truncation by reconstruction followed by
+     balanced normalization). The projected least-squares problem,
+      min_y || A*V*y - b ||,
+     is solved via its normal equations, (V'*A'*A*V) * y = V'*A'*b, the matrix elements
+     of which are evaluated as a single fused tensor network expansion per iteration
+     (only the new ones). Since the projection onto the Krylov subspace is exact,
+     the compression only affects the quality of the subspace, not the minimization.
+     Once the Krylov subspace exceeds its max dimension, it is restarted from the
+     compressed current solution. The final solution is reconstructed in the given
+     tensor network form.
 **/
 
 #ifndef EXATN_LINEAR_SOLVER_HPP_
@@ -16,6 +31,7 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "exatn_numerics.hpp"
 
 #include <memory>
+#include <vector>
 #include <complex>
 
 #include "errors.hpp"
@@ -31,6 +47,8 @@ public:
 
  static constexpr const double DEFAULT_TOLERANCE = 1e-4;
  static constexpr const unsigned int DEFAULT_MAX_ITERATIONS = 1000;
+ static constexpr const unsigned int DEFAULT_MAX_KRYLOV_DIM = 8;             //max Krylov subspace dimension before restart
+ static constexpr const unsigned int DEFAULT_COMPRESSION_ITERATIONS = 10;    //max number of reconstruction iterations per Krylov vector compression
 
  TensorNetworkLinearSolver(std::shared_ptr<TensorOperator> tensor_operator,   //in: tensor network operator
                            std::shared_ptr<TensorExpansion> rhs_expansion,    //in: right-hand-side tensor network expansion
@@ -63,17 +81,44 @@ public:
  /** Enables/disables coarse-grain parallelization over tensor networks. **/
  void enableParallelization(bool parallel = true);
 
+ /** Enables/disables the preconditioned Krylov (flexible GMRES) mode. **/
+ void enableKrylov(bool krylov = true,                                 //in: Krylov mode on/off
+                   unsigned int max_krylov_dim = DEFAULT_MAX_KRYLOV_DIM); //in: max Krylov subspace dimension before restart
+
+ /** Resets the preconditioner (an approximate inverse of the tensor network operator)
+     used in the Krylov mode (none by default). **/
+ void resetPreconditioner(std::shared_ptr<TensorOperator> preconditioner = nullptr);
+
+ /** Returns the number of tensor network operator applications during the last solve in the Krylov mode. **/
+ unsigned int getNumOperatorApplications() const;
+
  static void resetDebugLevel(unsigned int level = 0,  //in: debug level
                              int focus_process = -1); //in: process to focus on (-1: all)
 
 private:
 
+ //Solves the linear system in the Krylov mode:
+ bool solve_krylov(const ProcessGroup & process_group,
+                   unsigned int num_procs);
+
+ //Compresses a tensor network expansion into a new tensor network expansion of the form of the unknown vector:
+ std::shared_ptr<TensorExpansion> compressVector(const ProcessGroup & process_group,
+                                                 std::shared_ptr<TensorExpansion> expansion,
+                                                 double * fidelity = nullptr);
+
+ //Destroys the tensors of the Krylov basis vectors:
+ void destroyVectors(std::vector<std::shared_ptr<TensorExpansion>> & vectors);
+
  std::shared_ptr<TensorOperator> tensor_operator_;   //tensor network operator
  std::shared_ptr<TensorExpansion> rhs_expansion_;    //right-hand-side tensor network expansion
  std::shared_ptr<TensorExpansion> vector_expansion_; //unknown tensor network expansion sought for
  unsigned int max_iterations_;                       //max number of macro-iterations
  double tolerance_;                                  //numerical convergence tolerance (for the gradient)
  bool parallel_;                                     //enables/disables coarse-grain parallelization over tensor networks
+ bool krylov_;                                       //enables/disables the Krylov mode
+ unsigned int max_krylov_dim_;                       //max Krylov subspace dimension before restart
+ std::shared_ptr<TensorOperator> preconditioner_;    //preconditioner (approximate inverse of the tensor network operator)
+ unsigned int num_applications_;                     //number of tensor network operator applications in the Krylov mode
 
  double residual_norm_;                              //2-norm of the residual tensor after optimization (error)
  double fidelity_;                                   //achieved reconstruction fidelity (normalized squared overlap)
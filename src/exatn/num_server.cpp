@@ -1,12 +1,16 @@
 /** ExaTN::Numerics: Numerical server
-REVISION: 2022/03/15
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "num_server.hpp"
 #include "tensor_range.hpp"
+#include "half_float.hpp"
 #include "timers.hpp"
+#include "comm_profile.hpp"
+#include "device_memory.hpp"
+#include "thread_topology.hpp"
 
 #include <unordered_set>
 #include <complex>
@@ -16,9 +20,14 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <map>
 #include <future>
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <cstring>
 
 #ifdef MPI_ENABLED
 #include "mpi.h"
+#include <mutex>
+#include <thread>
 #endif
 
 #include <cstddef>
@@ -28,6 +37,23 @@ namespace exatn{
 /** Numerical server (singleton) **/
 std::shared_ptr<NumServer> numericalServer {nullptr}; //initialized by exatn::initialize()
 
+namespace{
+
+/** Byte packet for exchanging tensor meta-data (one per client thread). **/
+struct ThreadBytePacket{
+ BytePacket packet;
+ ThreadBytePacket(){initBytePacket(&packet);}
+ ~ThreadBytePacket(){destroyBytePacket(&packet);}
+};
+
+BytePacket & getThreadBytePacket()
+{
+ static thread_local ThreadBytePacket byte_packet;
+ return byte_packet.packet;
+}
+
+} //namespace
+
 
 unsigned int subtensor_owner_id(unsigned int process_rank,
                                 unsigned int num_processes,
@@ -69,6 +95,53 @@ std::pair<unsigned long long, unsigned long long> owned_subtensors(unsigned int
 }
 
 
+DimOffset dim_base_offset(const Tensor & tensor,
+                          unsigned int dimensn)
+{
+ const auto space_attr = tensor.getDimSpaceAttr(dimensn);
+ if(space_attr.first == SOME_SPACE) return static_cast<DimOffset>(space_attr.second);
+ return static_cast<DimOffset>(getSpaceRegister()->getSubspace(space_attr.first,space_attr.second)->getLowerBound());
+}
+
+
+unsigned int BalancedTensorMapper::balancedOwnerId(const numerics::TensorComposite & composite,
+                                                   unsigned long long subtensor_id) const
+{
+ auto & owners = owners_[composite.getTensorHash()];
+ if(owners.empty()){
+  const auto num_procs = getNumProcesses();
+  double total_volume = 0.0;
+  for(auto subtens = composite.begin(); subtens != composite.end(); ++subtens)
+   total_volume += static_cast<double>(subtens->second->getVolume());
+  //Partition the subtensors (in the order of their ids) into contiguous chunks of balanced volume:
+  std::vector<double> chunk_volume(num_procs,0.0);
+  double volume = 0.0;
+  unsigned int chunk = 0;
+  for(auto subtens = composite.begin(); subtens != composite.end(); ++subtens){
+   const double subtens_volume = static_cast<double>(subtens->second->getVolume());
+   //Move on to the next chunk once the middle of the subtensor crosses the chunk boundary:
+   while(chunk + 1 < num_procs &&
+         (volume + 0.5 * subtens_volume) > total_volume * static_cast<double>(chunk + 1) / static_cast<double>(num_procs)) ++chunk;
+   owners.emplace(std::make_pair(subtens->first,(process_order_.empty()) ? chunk : process_order_[chunk]));
+   chunk_volume[chunk] += subtens_volume;
+   volume += subtens_volume;
+  }
+  const auto element_type = composite.getElementType();
+  if(element_type != TensorElementType::VOID){
+   const double max_bytes = (*std::max_element(chunk_volume.cbegin(),chunk_volume.cend()))
+                          * static_cast<double>(TensorElementTypeSize(tensorComputeElementType(element_type)));
+   if(max_bytes > static_cast<double>(getMemoryPerProcess())){
+    std::cout << "#WARNING(exatn::BalancedTensorMapper): Balanced subtensors of composite tensor " << composite.getName()
+              << " exceed the memory limit per process: " << max_bytes << " > " << getMemoryPerProcess() << std::endl;
+   }
+  }
+ }
+ auto iter = owners.find(subtensor_id);
+ assert(iter != owners.end());
+ return iter->second;
+}
+
+
 unsigned int replication_level(const ProcessGroup & process_group,
                                std::shared_ptr<Tensor> & tensor)
 {
@@ -84,13 +157,64 @@ unsigned int replication_level(const ProcessGroup & process_group,
 }
 
 
+#ifdef MPI_ENABLED
+/** Reduces partial norms {sum |x|, sum |x|^2, max |x|}. **/
+static void mpi_reduce_partial_norms(void * in, void * inout, int * len, MPI_Datatype * data_kind)
+{
+ const auto * src = static_cast<const double*>(in);
+ auto * dst = static_cast<double*>(inout);
+ for(int i = 0; i < *len; ++i){
+  dst[0] += src[0]; dst[1] += src[1]; dst[2] = std::max(dst[2],src[2]);
+  src += 3; dst += 3;
+ }
+ return;
+}
+
+struct MPIPartialNorms{
+ MPI_Datatype kind;
+ MPI_Op reduce;
+};
+
+static const MPIPartialNorms & get_mpi_partial_norms()
+{
+ static MPIPartialNorms partial_norms;
+ static std::once_flag created;
+ std::call_once(created,[](){
+  int errc = MPI_Type_contiguous(3,MPI_DOUBLE,&partial_norms.kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Type_commit(&partial_norms.kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Op_create(&mpi_reduce_partial_norms,1,&partial_norms.reduce); assert(errc == MPI_SUCCESS);
+ });
+ return partial_norms;
+}
+#endif
+
+
+template <typename ValueType>
+std::future<ValueType> makeReadyFuture(ValueType value)
+{
+ std::promise<ValueType> promise;
+ promise.set_value(std::move(value));
+ return promise.get_future();
+}
+
+
 #ifdef MPI_ENABLED
 NumServer::NumServer(const MPICommProxy & communicator,
                      const ParamConf & parameters,
                      const std::string & graph_executor_name,
                      const std::string & node_executor_name):
- contr_seq_optimizer_("metis"), contr_seq_caching_(false), logging_(0), comp_backend_("default"),
- intra_comm_(communicator), validation_tracing_(false)
+ active_capture_(nullptr),
+ precision_policy_(TensorOpPrecision::DEFAULT), precision_tolerance_(0.0),
+ svd_randomized_(false), svd_tolerance_(0.0),
+ contr_seq_optimizer_("metis"), contr_seq_caching_(false), contr_seq_slicing_(false),
+ contr_seq_time_budget_(0.0), contr_seq_time_fraction_(0.0), contr_seq_time_(0.0), contr_seq_count_(0), intermediate_sharing_(false), expansion_fusion_(false), speculation_(false), dynamic_slice_scheduling_(false), slice_double_buffering_(false),
+ network_memoization_(false), network_memo_hits_(0),
+ hybrid_slice_execution_(false), host_slice_share_(HYBRID_HOST_SHARE_INITIAL), host_slice_rate_(0.0), accel_slice_rate_(0.0), output_reduction_(OutputReduction::ALLREDUCE), tensor_mapping_(TensorMapping::FIXED),
+ rnd_seed_(DEFAULT_RANDOM_SEED), isometrize_method_(IsometrizeMethod::CHOLESKY_QR2), dry_run_(false),
+ logging_(0), comp_backend_("default"), graph_executor_name_(graph_executor_name),
+ default_node_executor_name_(node_executor_name), node_executor_name_(node_executor_name),
+ intra_comm_(communicator), validation_tracing_(false),
+ validation_fraction_(0.0), validation_credit_(0.0), validation_count_(0)
 {
  int mpi_error = MPI_Comm_size(*(communicator.get<MPI_Comm>()),&num_processes_); assert(mpi_error == MPI_SUCCESS);
  mpi_error = MPI_Comm_rank(*(communicator.get<MPI_Comm>()),&process_rank_); assert(mpi_error == MPI_SUCCESS);
@@ -105,21 +229,41 @@ NumServer::NumServer(const MPICommProxy & communicator,
  }
  default_tensor_mapper_ = std::shared_ptr<TensorMapper>(
   new CompositeTensorMapper(intra_comm_,process_rank_,num_processes_,process_world_->getMemoryLimitPerProcess(),tensors_));
- initBytePacket(&byte_packet_);
+ //Discover the compute node process groups (collective) for the node-local GPU binding:
+ process_node_ = getNodeProcessGroups(*process_world_).node;
+ unsigned int node_process_rank = 0;
+ auto in_node = process_node_->rankIsIn(process_rank_,&node_process_rank); assert(in_node);
+ ParamConf runtime_parameters(parameters);
+ runtime_parameters.setParameter("node_process_rank",static_cast<int64_t>(node_process_rank));
+ runtime_parameters.setParameter("node_num_processes",static_cast<int64_t>(process_node_->getSize()));
+ runtime_parameters_ = runtime_parameters;
+ //Configure the thread topology before the execution thread is launched:
+ if(getThreadTopology().configure(parameters,node_process_rank,process_node_->getSize())) getThreadTopology().pinClientThread();
  space_register_ = getSpaceRegister(); assert(space_register_);
  tensor_op_factory_ = TensorOpFactory::get();
  mpi_error = MPI_Barrier(*(communicator.get<MPI_Comm>())); assert(mpi_error == MPI_SUCCESS);
  time_start_ = exatn::Timer::timeInSecHR();
- tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(communicator,parameters,graph_executor_name,node_executor_name));
- scopes_.push(std::pair<std::string,ScopeId>{"GLOBAL",0}); //GLOBAL scope 0 is automatically open (top scope)
- tensor_rt_->openScope("GLOBAL");
+ tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(communicator,runtime_parameters,graph_executor_name,node_executor_name));
+ startup_times_.emplace_back(std::make_pair(std::string("tensor runtime construction"),exatn::Timer::timeInSecHR(time_start_)));
+ tensor_rt_->openScope("GLOBAL"); //GLOBAL scope 0 is automatically open (top scope of each client thread)
+ double monitor_interval = 0.0;
+ if(parameters.getParameter("runtime_monitor_interval",&monitor_interval)) activateRuntimeMonitor(monitor_interval);
 }
 #else
 NumServer::NumServer(const ParamConf & parameters,
                      const std::string & graph_executor_name,
                      const std::string & node_executor_name):
- contr_seq_optimizer_("metis"), contr_seq_caching_(false), logging_(0), comp_backend_("default"),
- validation_tracing_(false)
+ active_capture_(nullptr),
+ precision_policy_(TensorOpPrecision::DEFAULT), precision_tolerance_(0.0),
+ svd_randomized_(false), svd_tolerance_(0.0),
+ contr_seq_optimizer_("metis"), contr_seq_caching_(false), contr_seq_slicing_(false),
+ contr_seq_time_budget_(0.0), contr_seq_time_fraction_(0.0), contr_seq_time_(0.0), contr_seq_count_(0), intermediate_sharing_(false), expansion_fusion_(false), speculation_(false), dynamic_slice_scheduling_(false), slice_double_buffering_(false),
+ network_memoization_(false), network_memo_hits_(0),
+ hybrid_slice_execution_(false), host_slice_share_(HYBRID_HOST_SHARE_INITIAL), host_slice_rate_(0.0), accel_slice_rate_(0.0), output_reduction_(OutputReduction::ALLREDUCE), tensor_mapping_(TensorMapping::FIXED),
+ rnd_seed_(DEFAULT_RANDOM_SEED), isometrize_method_(IsometrizeMethod::CHOLESKY_QR2), dry_run_(false),
+ logging_(0), comp_backend_("default"), graph_executor_name_(graph_executor_name),
+ default_node_executor_name_(node_executor_name), node_executor_name_(node_executor_name),
+ validation_tracing_(false), validation_fraction_(0.0), validation_credit_(0.0), validation_count_(0)
 {
  num_processes_ = 1; process_rank_ = 0; global_process_rank_ = 0;
  process_world_ = std::make_shared<ProcessGroup>(intra_comm_,num_processes_); //intra-communicator is empty here
@@ -132,43 +276,45 @@ NumServer::NumServer(const ParamConf & parameters,
  }
  default_tensor_mapper_ = std::shared_ptr<TensorMapper>(
   new CompositeTensorMapper(process_rank_,num_processes_,process_world_->getMemoryLimitPerProcess(),tensors_));
- initBytePacket(&byte_packet_);
+ process_node_ = process_world_;
+ runtime_parameters_ = parameters;
+ //Configure the thread topology before the execution thread is launched:
+ if(getThreadTopology().configure(parameters,0,1)) getThreadTopology().pinClientThread();
  space_register_ = getSpaceRegister(); assert(space_register_);
  tensor_op_factory_ = TensorOpFactory::get();
  time_start_ = exatn::Timer::timeInSecHR();
  tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(parameters,graph_executor_name,node_executor_name));
- scopes_.push(std::pair<std::string,ScopeId>{"GLOBAL",0}); //GLOBAL scope 0 is automatically open (top scope)
- tensor_rt_->openScope("GLOBAL");
+ startup_times_.emplace_back(std::make_pair(std::string("tensor runtime construction"),exatn::Timer::timeInSecHR(time_start_)));
+ tensor_rt_->openScope("GLOBAL"); //GLOBAL scope 0 is automatically open (top scope of each client thread)
+ double monitor_interval = 0.0;
+ if(parameters.getParameter("runtime_monitor_interval",&monitor_interval)) activateRuntimeMonitor(monitor_interval);
 }
 #endif
 
 
 NumServer::~NumServer()
 {
+ //Stop the runtime monitor:
+ monitor_.stop();
+ //Collect the outstanding validation checksums:
+ collectValidationSamples(true);
  //Garbage collection:
  destroyOrphanedTensors();
- //Destroy composite tensors:
- auto iter = tensors_.begin();
- while(iter != tensors_.end()){
-  if(iter->second->isComposite()){
-   const auto tensor_name = iter->first;
+ //Destroy composite tensors (in the same order on all processes):
+ for(const auto & tensor_name: getSortedTensorNames(true)){
+  if(tensors_.find(lookupNameId(tensor_name)) != tensors_.end()){
    auto success = destroyTensorSync(tensor_name); assert(success);
-   iter = tensors_.begin();
-  }else{
-   ++iter;
   }
  }
  //Destroy remaining simple tensors:
- iter = tensors_.begin();
- while(iter != tensors_.end()){
-  const auto tensor_name = iter->first;
-  auto success = destroyTensorSync(tensor_name); assert(success);
-  iter = tensors_.begin();
+ for(const auto & tensor_name: getSortedTensorNames(false)){
+  if(tensors_.find(lookupNameId(tensor_name)) != tensors_.end()){
+   auto success = destroyTensorSync(tensor_name); assert(success);
+  }
  }
  //Close scope and clean:
  tensor_rt_->closeScope(); //contains sync() inside
- scopes_.pop();
- destroyBytePacket(&byte_packet_);
+ clients_.clear();
  resetClientLoggingLevel();
 }
 
@@ -180,8 +326,14 @@ void NumServer::reconfigureTensorRuntime(const MPICommProxy & communicator,
                                          const std::string & node_executor_name)
 {
  while(!tensor_rt_);
+ collectValidationSamples(true);
+ const bool monitoring = monitor_.isActive();
+ monitor_.stop(); //the monitor thread reads the tensor runtime
  bool synced = tensor_rt_->sync(); assert(synced);
- tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(communicator,parameters,dag_executor_name,node_executor_name));
+ if(!(tensor_rt_->reconfigure(parameters,dag_executor_name,node_executor_name))){ //hot reconfiguration keeps tensors
+  tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(communicator,parameters,dag_executor_name,node_executor_name));
+ }
+ if(monitoring) activateRuntimeMonitor(monitor_.getInterval());
  return;
 }
 #else
@@ -190,19 +342,65 @@ void NumServer::reconfigureTensorRuntime(const ParamConf & parameters,
                                          const std::string & node_executor_name)
 {
  while(!tensor_rt_);
+ collectValidationSamples(true);
+ const bool monitoring = monitor_.isActive();
+ monitor_.stop(); //the monitor thread reads the tensor runtime
  bool synced = tensor_rt_->sync(); assert(synced);
- tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(parameters,dag_executor_name,node_executor_name));
+ if(!(tensor_rt_->reconfigure(parameters,dag_executor_name,node_executor_name))){ //hot reconfiguration keeps tensors
+  tensor_rt_ = std::move(std::make_shared<runtime::TensorRuntime>(parameters,dag_executor_name,node_executor_name));
+ }
+ if(monitoring) activateRuntimeMonitor(monitor_.getInterval());
  return;
 }
 #endif
 
 
+bool NumServer::reconfigureRuntime(const ParamConf & parameters,
+                                   const std::string & dag_executor_name)
+{
+ while(!tensor_rt_);
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_);
+#ifdef CUQUANTUM
+ if((comp_backend_ == "cuquantum" || comp_backend_ == "auto") && dag_executor_name != "lazy-dag-executor"){
+  std::cout << "#ERROR(exatn::NumServer::reconfigureRuntime): Tensor network execution via cuQuantum requires the lazy-dag-executor: "
+            << dag_executor_name << std::endl << std::flush;
+  return false;
+ }
+#endif
+ ParamConf runtime_parameters(parameters);
+#ifdef MPI_ENABLED
+ int64_t node_process_rank = 0, node_num_processes = 1; //node-local GPU binding is fixed
+ runtime_parameters_.getParameter("node_process_rank",&node_process_rank);
+ runtime_parameters_.getParameter("node_num_processes",&node_num_processes);
+ runtime_parameters.setParameter("node_process_rank",node_process_rank);
+ runtime_parameters.setParameter("node_num_processes",node_num_processes);
+#endif
+ collectValidationSamples(true);
+ const bool monitoring = monitor_.isActive();
+ monitor_.stop(); //the monitor thread reads the tensor runtime
+ bool synced = tensor_rt_->sync(); assert(synced);
+ const bool reconfigured = tensor_rt_->reconfigure(runtime_parameters,dag_executor_name,node_executor_name_);
+ if(reconfigured){
+  runtime_parameters_ = runtime_parameters;
+  graph_executor_name_ = dag_executor_name;
+  if(logging_ > 0){
+   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+            << "]: Tensor runtime reconfigured in place with " << dag_executor_name << std::endl << std::flush;
+  }
+ }
+ if(monitoring) activateRuntimeMonitor(monitor_.getInterval());
+ return reconfigured;
+}
+
+
 std::vector<std::string> NumServer::queryComputationalBackends() const
 {
  std::vector<std::string> backends = {"default"};
 #ifdef CUQUANTUM
  backends.emplace_back("cuquantum");
+ backends.emplace_back("auto");
 #endif
+ backends.emplace_back("exatensor");
  return backends;
 }
 
@@ -214,30 +412,87 @@ void NumServer::switchComputationalBackend(const std::string & backend_name)
   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
            << "]: Switched computational backend to " << backend_name << std::endl << std::flush;
  }
+#ifdef CUQUANTUM
+ if(backend_name == "cuquantum" || backend_name == "auto"){
+  make_sure(graph_executor_name_ == "lazy-dag-executor",
+   "#ERROR(exatn::NumServer): switchComputationalBackend: Tensor network execution via cuQuantum requires the lazy-dag-executor!");
+ }
+#endif
  if(backend_name == "default"){
   comp_backend_ = backend_name;
 #ifdef CUQUANTUM
  }else if(backend_name == "cuquantum"){
   comp_backend_ = backend_name;
+ }else if(backend_name == "auto"){
+  comp_backend_ = backend_name;
 #endif
+ }else if(backend_name == "exatensor"){
+  comp_backend_ = backend_name;
  }else{
   std::cout << "#ERROR(exatn::NumServer): switchComputationalBackend: Unknown backend: "
             << backend_name << std::endl << std::flush;
   std::abort();
  }
+ //Reconfigure the tensor runtime if the backend requires a different node executor:
+ const std::string node_executor_name = (comp_backend_ == "exatensor") ? std::string("exatensor-node-executor")
+                                                                       : default_node_executor_name_;
+ if(node_executor_name != node_executor_name_){
+  make_sure(tensors_.empty(),
+   "#ERROR(exatn::NumServer): switchComputationalBackend: All tensors must be destroyed before switching the node executor!");
+  const auto scope_name = getClientContext().scopes.top().first;
+#ifdef MPI_ENABLED
+  reconfigureTensorRuntime(intra_comm_,runtime_parameters_,graph_executor_name_,node_executor_name);
+#else
+  reconfigureTensorRuntime(runtime_parameters_,graph_executor_name_,node_executor_name);
+#endif
+  tensor_rt_->openScope(scope_name);
+  node_executor_name_ = node_executor_name;
+ }
  return;
 }
 
-void NumServer::resetContrSeqOptimizer(const std::string & optimizer_name, bool caching)
+void NumServer::resetContrSeqOptimizer(const std::string & optimizer_name, bool caching,
+                                       double time_budget, double contraction_time_fraction)
 {
+ assert(time_budget >= 0.0 && contraction_time_fraction >= 0.0);
  contr_seq_optimizer_ = optimizer_name;
  contr_seq_caching_ = caching;
+ contr_seq_time_budget_ = time_budget;
+ contr_seq_time_fraction_ = contraction_time_fraction;
+ return;
+}
+
+void NumServer::resetContrSeqPortfolio(const std::vector<std::string> & optimizer_names)
+{
+ contr_seq_portfolio_ = optimizer_names;
  return;
 }
 
 void NumServer::activateContrSeqCaching(bool persist)
 {
  numerics::ContractionSeqOptimizer::activatePersistentCaching(persist);
+ if(persist){ //load the persistent database once and distribute it to all processes
+  std::vector<char> db_content;
+  if(process_rank_ == 0) numerics::ContractionSeqOptimizer::readPersistentCache(db_content);
+#ifdef MPI_ENABLED
+  if(num_processes_ > 1){
+   unsigned long long db_size = db_content.size();
+   auto errc = MPI_Bcast(&db_size,1,MPI_UNSIGNED_LONG_LONG,0,process_world_->getMPICommProxy().getRef<MPI_Comm>());
+   assert(errc == MPI_SUCCESS);
+   db_content.resize(db_size);
+   std::size_t offset = 0;
+   while(offset < db_size){ //chunked broadcast (int count)
+    const int chunk = static_cast<int>(std::min(db_size - offset,static_cast<unsigned long long>(1ULL << 30)));
+    errc = MPI_Bcast(db_content.data() + offset,chunk,MPI_CHAR,0,process_world_->getMPICommProxy().getRef<MPI_Comm>());
+    assert(errc == MPI_SUCCESS);
+    offset += chunk;
+   }
+  }
+#endif
+  const auto num_imported = numerics::ContractionSeqOptimizer::importPersistentCache(db_content);
+  if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                            << "]: Imported " << num_imported << " cached tensor contraction sequences" << std::endl << std::flush;
+ }
  contr_seq_caching_ = true;
  return;
 }
@@ -254,266 +509,715 @@ bool NumServer::queryContrSeqCaching() const
  return contr_seq_caching_;
 }
 
-void NumServer::resetClientLoggingLevel(int level){
- if(logging_ == 0){
-  if(level != 0) logfile_.open("exatn_main_thread."+std::to_string(global_process_rank_)+".log", std::ios::out | std::ios::trunc);
- }else{
-  if(level == 0) logfile_.close();
- }
- logging_ = level;
+void NumServer::activateContrSeqSlicing()
+{
+ contr_seq_slicing_ = true;
  return;
 }
 
-void NumServer::resetRuntimeLoggingLevel(int level)
+void NumServer::deactivateContrSeqSlicing()
 {
- while(!tensor_rt_);
- bool synced = tensor_rt_->sync(); assert(synced);
- tensor_rt_->resetLoggingLevel(level);
+ contr_seq_slicing_ = false;
  return;
 }
 
-void NumServer::resetExecutionSerialization(bool serialize, bool validation_trace)
+bool NumServer::queryContrSeqSlicing() const
 {
- while(!tensor_rt_);
- bool synced = tensor_rt_->sync(); assert(synced);
- validation_tracing_ = serialize && validation_trace;
- tensor_rt_->resetSerialization(serialize,validation_tracing_);
- if(logging_ > 0){
-  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-           << "]: DAG execution serialization = " << serialize
-           << ": Validation tracing = " << validation_tracing_
-           << "; Tensor runtime synced" << std::endl << std::flush;
- }
- synced = tensor_rt_->sync(); assert(synced);
- return;
+ return contr_seq_slicing_;
 }
 
-void NumServer::activateDryRun(bool dry_run)
+void NumServer::activateIntermediateSharing()
 {
- while(!tensor_rt_);
- bool synced = tensor_rt_->sync(); assert(synced);
- tensor_rt_->activateDryRun(dry_run);
- if(logging_ > 0){
-  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-           << "]: Dry run activation status = " << dry_run << std::endl << std::flush;
- }
- synced = tensor_rt_->sync(); assert(synced);
+ intermediate_sharing_ = true;
  return;
 }
 
-void NumServer::activateFastMath()
+void NumServer::deactivateIntermediateSharing()
 {
- while(!tensor_rt_);
- bool synced = tensor_rt_->sync(); assert(synced);
- tensor_rt_->activateFastMath();
- if(logging_ > 0){
-  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-           << "]: Fast math activated (if available); Tensor runtime synced" << std::endl << std::flush;
- }
- synced = tensor_rt_->sync(); assert(synced);
+ intermediate_sharing_ = false;
  return;
 }
 
-std::size_t NumServer::getMemoryBufferSize() const
+bool NumServer::queryIntermediateSharing() const
 {
- while(!tensor_rt_);
- return tensor_rt_->getMemoryBufferSize();
+ return intermediate_sharing_;
 }
 
-std::size_t NumServer::getMemoryUsage(std::size_t * free_mem) const
+void NumServer::activateDynamicSliceScheduling()
 {
- while(!tensor_rt_);
- return tensor_rt_->getMemoryUsage(free_mem);
+ dynamic_slice_scheduling_ = true;
+ return;
 }
 
-double NumServer::getTotalFlopCount() const
+void NumServer::deactivateDynamicSliceScheduling()
 {
- while(!tensor_rt_);
- return tensor_rt_->getTotalFlopCount();
+ dynamic_slice_scheduling_ = false;
+ return;
 }
 
-const ProcessGroup & NumServer::getDefaultProcessGroup() const
+bool NumServer::queryDynamicSliceScheduling() const
 {
- return *process_world_;
+ return dynamic_slice_scheduling_;
 }
 
-const ProcessGroup & NumServer::getCurrentProcessGroup() const
+void NumServer::activateSliceDoubleBuffering()
 {
- return *process_self_;
+ slice_double_buffering_ = true;
+ return;
 }
 
-int NumServer::getProcessRank(const ProcessGroup & process_group) const
+void NumServer::deactivateSliceDoubleBuffering()
 {
- unsigned int local_rank;
- auto rank_is_in = process_group.rankIsIn(getProcessRank(),&local_rank);
- if(!rank_is_in) return -1;
- assert(local_rank >= 0);
- return static_cast<int>(local_rank);
+ slice_double_buffering_ = false;
+ return;
 }
 
-int NumServer::getProcessRank() const
+bool NumServer::querySliceDoubleBuffering() const
 {
- return process_rank_;
+ return slice_double_buffering_;
 }
 
-int NumServer::getNumProcesses(const ProcessGroup & process_group) const
+void NumServer::activateNetworkMemoization()
 {
- return static_cast<int>(process_group.getSize());
+ network_memoization_ = true;
+ return;
 }
 
-int NumServer::getNumProcesses() const
+void NumServer::deactivateNetworkMemoization()
 {
- return num_processes_;
+ network_memoization_ = false;
+ network_memos_.clear();
+ return;
 }
 
-std::shared_ptr<TensorMapper> NumServer::getTensorMapper(const ProcessGroup & process_group) const
+bool NumServer::queryNetworkMemoization() const
 {
- unsigned int local_rank;
- bool rank_is_in_group = process_group.rankIsIn(process_rank_,&local_rank);
- assert(rank_is_in_group);
-#ifdef MPI_ENABLED
- return std::shared_ptr<TensorMapper>(new CompositeTensorMapper(process_group.getMPICommProxy(),
-         local_rank,process_group.getSize(),process_group.getMemoryLimitPerProcess(),tensors_));
-#else
- return std::shared_ptr<TensorMapper>(new CompositeTensorMapper(local_rank,process_group.getSize(),
-                                      process_group.getMemoryLimitPerProcess(),tensors_));
-#endif
+ return network_memoization_;
 }
 
-std::shared_ptr<TensorMapper> NumServer::getTensorMapper() const
+std::size_t NumServer::getNetworkMemoizationHits() const
 {
- return default_tensor_mapper_;
+ return network_memo_hits_;
 }
 
-void NumServer::registerTensorMethod(const std::string & tag, std::shared_ptr<TensorMethod> method)
+void NumServer::activateHybridSliceExecution()
 {
- auto res = ext_methods_.insert({tag,method});
- if(!(std::get<1>(res))) std::cout << "#ERROR(NumServer::registerTensorMethod): Method already exists: " << tag << std::endl;
- assert(std::get<1>(res));
+ hybrid_slice_execution_ = true;
  return;
 }
 
-std::shared_ptr<TensorMethod> NumServer::getTensorMethod(const std::string & tag)
+void NumServer::deactivateHybridSliceExecution()
 {
- return ext_methods_[tag];
+ hybrid_slice_execution_ = false;
+ return;
 }
 
-void NumServer::registerExternalData(const std::string & tag, std::shared_ptr<BytePacket> packet)
+bool NumServer::queryHybridSliceExecution() const
 {
- auto res = ext_data_.insert({tag,packet});
- if(!(std::get<1>(res))) std::cout << "#ERROR(NumServer::registerExternalData): Data already exists: " << tag << std::endl;
- assert(std::get<1>(res));
- return;
+ return hybrid_slice_execution_;
 }
 
-std::shared_ptr<BytePacket> NumServer::getExternalData(const std::string & tag)
+double NumServer::getHybridHostShare() const
 {
- return ext_data_[tag];
+ return host_slice_share_;
 }
 
-
-ScopeId NumServer::openScope(const std::string & scope_name)
+void NumServer::resetOutputReduction(OutputReduction reduction)
 {
- assert(scope_name.length() > 0);
- ScopeId new_scope_id = scopes_.size();
- scopes_.push(std::pair<std::string,ScopeId>{scope_name,new_scope_id});
- return new_scope_id;
+ output_reduction_ = reduction;
+ return;
 }
 
-ScopeId NumServer::closeScope()
+OutputReduction NumServer::getOutputReduction() const
 {
- assert(!scopes_.empty());
- const auto & prev_scope = scopes_.top();
- ScopeId prev_scope_id = std::get<1>(prev_scope);
- scopes_.pop();
- return prev_scope_id;
+ return output_reduction_;
 }
 
+void NumServer::resetTensorMapping(TensorMapping mapping)
+{
+ tensor_mapping_ = mapping;
+#ifdef MPI_ENABLED
+ if(tensor_mapping_ == TensorMapping::BALANCED) getNodeProcessGroups(getDefaultProcessGroup()); //collective
+#endif
+ default_tensor_mapper_ = getTensorMapper(getDefaultProcessGroup());
+ return;
+}
 
-SpaceId NumServer::createVectorSpace(const std::string & space_name, DimExtent space_dim,
-                                     const VectorSpace ** space_ptr)
+TensorMapping NumServer::getTensorMapping() const
 {
- assert(space_name.length() > 0);
- SpaceId space_id = space_register_->registerSpace(std::make_shared<VectorSpace>(space_dim,space_name));
- if(space_ptr != nullptr) *space_ptr = space_register_->getSpace(space_id);
- return space_id;
+ return tensor_mapping_;
 }
 
-void NumServer::destroyVectorSpace(const std::string & space_name)
+void NumServer::activateFusedExpansionEvaluation()
 {
- assert(false);
- //`Finish
+ expansion_fusion_ = true;
  return;
 }
 
-void NumServer::destroyVectorSpace(SpaceId space_id)
+void NumServer::deactivateFusedExpansionEvaluation()
 {
- assert(false);
- //`Finish
+ expansion_fusion_ = false;
  return;
 }
 
-const VectorSpace * NumServer::getVectorSpace(const std::string & space_name) const
+bool NumServer::queryFusedExpansionEvaluation() const
 {
- return space_register_->getSpace(space_name);
+ return expansion_fusion_;
 }
 
+void NumServer::activateSpeculativeExecution()
+{
+ speculation_ = true;
+ return;
+}
 
-SubspaceId NumServer::createSubspace(const std::string & subspace_name,
-                                     const std::string & space_name,
-                                     std::pair<DimOffset,DimOffset> bounds,
-                                     const Subspace ** subspace_ptr)
+void NumServer::deactivateSpeculativeExecution()
 {
- assert(subspace_name.length() > 0 && space_name.length() > 0);
- const VectorSpace * space = space_register_->getSpace(space_name);
- assert(space != nullptr);
- SubspaceId subspace_id = space_register_->registerSubspace(std::make_shared<Subspace>(space,bounds,subspace_name));
- if(subspace_ptr != nullptr) *subspace_ptr = space_register_->getSubspace(space_name,subspace_name);
- auto res = subname2id_.insert({subspace_name,space->getRegisteredId()});
- if(!(res.second)) std::cout << "#ERROR(NumServer::createSubspace): Subspace already exists: " << subspace_name << std::endl;
- assert(res.second);
- return subspace_id;
+ speculation_ = false;
+ return;
 }
 
-void NumServer::destroySubspace(const std::string & subspace_name)
+bool NumServer::querySpeculativeExecution() const
 {
- assert(false);
- //`Finish
+ return speculation_;
+}
+
+void NumServer::resetClientLoggingLevel(int level){
+ if(logging_ == 0){
+  if(level != 0){
+   logfile_.open("exatn_main_thread."+std::to_string(global_process_rank_)+".log", std::ios::out | std::ios::trunc);
+   logfile_ << "Startup time breakdown (sec):" << std::endl;
+   for(const auto & stage: startup_times_){
+    logfile_ << " " << stage.first << ": " << std::fixed << std::setprecision(6) << stage.second << std::endl;
+   }
+   if(getThreadTopology().isActive()) getThreadTopology().printLayout(logfile_);
+   logfile_.flush();
+  }
+ }else{
+  if(level == 0) logfile_.close();
+ }
+ logging_ = level;
  return;
 }
 
-void NumServer::destroySubspace(SubspaceId subspace_id)
+void NumServer::recordStartupTime(const std::string & stage, double duration)
 {
- assert(false);
- //`Finish
+ startup_times_.emplace_back(std::make_pair(stage,duration));
  return;
 }
 
-const Subspace * NumServer::getSubspace(const std::string & subspace_name) const
+const std::vector<std::pair<std::string,double>> & NumServer::getStartupTimes() const
 {
- assert(subspace_name.length() > 0);
- auto it = subname2id_.find(subspace_name);
- if(it == subname2id_.end()) std::cout << "#ERROR(NumServer::getSubspace): Subspace not found: " << subspace_name << std::endl;
- assert(it != subname2id_.end());
- SpaceId space_id = (*it).second;
- const VectorSpace * space = space_register_->getSpace(space_id);
- assert(space != nullptr);
- const std::string & space_name = space->getName();
- assert(space_name.length() > 0);
- return space_register_->getSubspace(space_name,subspace_name);
+ return startup_times_;
 }
 
-bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
+void NumServer::resetRuntimeLoggingLevel(int level)
 {
- bool submitted = false;
- if(operation){
-  if(logging_ > 1 || (validation_tracing_ && logging_ > 0)){
-   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-            << "]: Submitting tensor operation:" << std::endl;
-   operation->printItFile(logfile_);
-   logfile_.flush(); //`Debug only
-  }
+ while(!tensor_rt_);
+ bool synced = tensor_rt_->sync(); assert(synced);
+ tensor_rt_->resetLoggingLevel(level);
+ return;
+}
+
+void NumServer::resetExecutionSerialization(bool serialize, bool validation_trace)
+{
+ while(!tensor_rt_);
+ bool synced = tensor_rt_->sync(); assert(synced);
+ validation_tracing_ = serialize && validation_trace;
+ tensor_rt_->resetSerialization(serialize,validation_tracing_);
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: DAG execution serialization = " << serialize
+           << ": Validation tracing = " << validation_tracing_
+           << "; Tensor runtime synced" << std::endl << std::flush;
+ }
+ synced = tensor_rt_->sync(); assert(synced);
+ return;
+}
+
+void NumServer::resetValidationSampling(double fraction)
+{
+ while(!tensor_rt_);
+ collectValidationSamples(true);
+ validation_fraction_ = std::min(std::max(fraction,0.0),1.0);
+ validation_credit_ = 0.0;
+ validation_count_ = 0;
+ if(validation_fraction_ > 0.0){
+  if(!validation_file_.is_open()){
+   validation_file_.open("exatn_validation."+std::to_string(global_process_rank_)+".txt",std::ios::out|std::ios::trunc);
+   if(!validation_file_.is_open()){
+    std::cout << "#ERROR(exatn::NumServer::resetValidationSampling): Unable to open the validation stamp file!"
+              << std::endl << std::flush;
+    validation_fraction_ = 0.0;
+   }
+  }
+ }else{
+  if(validation_file_.is_open()) validation_file_.close();
+ }
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Sampling validation fraction = " << validation_fraction_ << std::endl << std::flush;
+ }
+ return;
+}
+
+void NumServer::sampleValidation(const TensorOperation & operation)
+{
+ const auto opcode = operation.getOpcode();
+ if(opcode == TensorOpCode::NOOP || opcode == TensorOpCode::CREATE || opcode == TensorOpCode::DESTROY) return;
+ const auto num_out_operands = operation.getNumOperandsOut();
+ if(num_out_operands == 0) return;
+ auto & client = getClientContext();
+ const auto op_index = validation_count_++;
+ validation_credit_ += validation_fraction_;
+ if(validation_credit_ < 1.0) return;
+ validation_credit_ -= 1.0;
+ for(unsigned int oper = 0; oper < num_out_operands; ++oper){
+  auto tensor = operation.getTensorOperand(oper);
+  auto functor_norm1 = std::shared_ptr<TensorMethod>(new numerics::FunctorNorm1());
+  std::shared_ptr<TensorOperation> op_sum = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+  op_sum->setTensorOperand(tensor);
+  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op_sum)->resetFunctor(functor_norm1);
+  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op_sum)->resetReadOnly(true);
+  bool submitted = true;
+  if(client.batching){
+   client.op_batch.emplace_back(op_sum);
+  }else{
+   submitted = tensor_rt_->submit(op_sum);
+  }
+  if(submitted){
+   validation_samples_.emplace_back(ValidationSample{op_index,static_cast<int>(opcode),oper,tensor->getName(),
+                                                     functor_norm1,op_sum});
+  }
+ }
+ //Bound the number of validation checksums in flight:
+ if(!client.batching && validation_samples_.size() > MAX_VALIDATION_SAMPLES){
+  collectValidationSamples(false);
+  if(validation_samples_.size() > MAX_VALIDATION_SAMPLES){
+   auto synced = tensor_rt_->sync(*(validation_samples_.front().op_sum)); assert(synced);
+   collectValidationSamples(false);
+  }
+ }
+ return;
+}
+
+void NumServer::collectValidationSamples(bool wait)
+{
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_);
+ while(!validation_samples_.empty()){
+  auto & sample = validation_samples_.front();
+  if(!tensor_rt_->sync(*(sample.op_sum),wait)) break;
+  if(validation_file_.is_open()){
+   double norm = std::dynamic_pointer_cast<numerics::FunctorNorm1>(sample.functor)->getNorm();
+   validation_file_ << sample.op_index << " " << sample.opcode << " " << sample.operand << " "
+                    << sample.tensor_name << " " << std::scientific << std::setprecision(15) << norm << std::endl;
+  }
+  validation_samples_.pop_front();
+ }
+ return;
+}
+
+void NumServer::activateRuntimeMonitor(double interval)
+{
+ while(!tensor_rt_);
+ if(interval > 0.0){
+  monitor_.start(interval,global_process_rank_,[this](){return tensor_rt_->getMetrics();});
+ }else{
+  monitor_.stop();
+ }
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Runtime monitor period = " << ((interval > 0.0) ? monitor_.getInterval() : 0.0)
+           << " sec" << std::endl << std::flush;
+ }
+ return;
+}
+
+void NumServer::reportSolverIteration(const std::string & solver, std::size_t iteration)
+{
+ monitor_.reportIteration(solver,iteration);
+ return;
+}
+
+void NumServer::activateDryRun(bool dry_run)
+{
+ while(!tensor_rt_);
+ bool synced = tensor_rt_->sync(); assert(synced);
+ if(dry_run && !dry_run_){ //start a new execution plan calibrated by the prior actual computations
+  exec_plan_.reset();
+  exec_plan_.calibrate(getRuntimeMetrics());
+ }
+ dry_run_ = dry_run;
+ tensor_rt_->activateDryRun(dry_run);
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Dry run activation status = " << dry_run << std::endl << std::flush;
+ }
+ synced = tensor_rt_->sync(); assert(synced);
+ return;
+}
+
+void NumServer::setExecutionPlanModel(int device,
+                                      double gflops,
+                                      double gbps,
+                                      double latency)
+{
+ make_sure(gflops >= 0.0 && gbps >= 0.0 && latency >= 0.0,
+           "exatn::NumServer::setExecutionPlanModel: Negative performance model parameter!");
+ exec_plan_.setDeviceModel(device,ExecutionPlan::DeviceModel{gflops,gbps,latency});
+ return;
+}
+
+const ExecutionPlan & NumServer::getExecutionPlan() const
+{
+ return exec_plan_;
+}
+
+bool NumServer::writeExecutionPlan(const std::string & filename)
+{
+ const int process_rank = getProcessRank();
+ const auto plan_filename = filename.empty() ? ("exatn_plan." + std::to_string(process_rank) + ".txt") : filename;
+ bool written = exec_plan_.writeReport(plan_filename,process_rank);
+ if(!written) std::cout << "#ERROR(exatn::NumServer::writeExecutionPlan): Unable to write file "
+                        << plan_filename << std::endl << std::flush;
+ return written;
+}
+
+void NumServer::setPrecisionPolicy(TensorOpPrecision precision,
+                                   double tolerance)
+{
+ make_sure(tolerance >= 0.0,"exatn::NumServer::setPrecisionPolicy: Negative error tolerance!");
+ precision_policy_ = precision;
+ precision_tolerance_ = tolerance;
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Precision policy set to " << static_cast<int>(precision)
+           << " with tolerance " << std::scientific << tolerance << std::endl << std::flush;
+ }
+ return;
+}
+
+TensorOpPrecision NumServer::getPrecisionPolicy() const
+{
+ return precision_policy_;
+}
+
+void NumServer::setSVDTruncation(bool randomized,
+                                 double tolerance)
+{
+ make_sure(tolerance >= 0.0,"exatn::NumServer::setSVDTruncation: Negative singular value tolerance!");
+ svd_randomized_ = randomized;
+ svd_tolerance_ = tolerance;
+ return;
+}
+
+void NumServer::markTensorTransferTolerant(const std::string & name, bool tolerant)
+{
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+ if(tolerant){
+  transfer_tolerant_.emplace(name);
+ }else{
+  transfer_tolerant_.erase(name);
+ }
+ return;
+}
+
+bool NumServer::tensorTransferTolerant(const std::string & name) const
+{
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+ return (transfer_tolerant_.find(name) != transfer_tolerant_.end());
+}
+
+void NumServer::activateFastMath()
+{
+ while(!tensor_rt_);
+ bool synced = tensor_rt_->sync(); assert(synced);
+ tensor_rt_->activateFastMath();
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Fast math activated (if available); Tensor runtime synced" << std::endl << std::flush;
+ }
+ synced = tensor_rt_->sync(); assert(synced);
+ return;
+}
+
+std::size_t NumServer::getMemoryBufferSize() const
+{
+ while(!tensor_rt_);
+ return tensor_rt_->getMemoryBufferSize();
+}
+
+std::size_t NumServer::getMemoryUsage(std::size_t * free_mem) const
+{
+ while(!tensor_rt_);
+ return tensor_rt_->getMemoryUsage(free_mem);
+}
+
+double NumServer::getMemoryFragmentation(std::size_t * tensor_mem) const
+{
+ while(!tensor_rt_);
+ return tensor_rt_->getMemoryFragmentation(tensor_mem);
+}
+
+double NumServer::getTotalFlopCount() const
+{
+ while(!tensor_rt_);
+ return tensor_rt_->getTotalFlopCount();
+}
+
+RuntimeMetrics NumServer::getRuntimeMetrics() const
+{
+ while(!tensor_rt_);
+ auto metrics = tensor_rt_->getMetrics();
+ metrics.contr_seq_time = contr_seq_time_;
+ metrics.contr_seq_count = contr_seq_count_;
+ metrics.contr_seq_graph_time = contr_seq_totals_.graph_time;
+ metrics.contr_seq_partition_time = contr_seq_totals_.partition_time;
+ metrics.contr_seq_partition_calls = contr_seq_totals_.partition_calls;
+ metrics.contr_seq_evaluation_time = contr_seq_totals_.evaluation_time;
+ metrics.contr_seq_merge_time = contr_seq_totals_.merge_time;
+#ifdef CUQUANTUM
+ metrics.auto_default_networks = backend_selector_.getNumSelected(runtime::BackendSelector::DEFAULT_BACKEND);
+ metrics.auto_cuquantum_networks = backend_selector_.getNumSelected(runtime::BackendSelector::CUQUANTUM_BACKEND);
+ metrics.auto_trials = backend_selector_.getNumTrials();
+#endif
+ return metrics;
+}
+
+void NumServer::resetRuntimeMetrics()
+{
+ while(!tensor_rt_);
+ contr_seq_time_ = 0.0;
+ contr_seq_count_ = 0;
+ contr_seq_totals_ = ContractionSeqOptimizer::SearchTelemetry();
+ return tensor_rt_->resetMetrics();
+}
+
+ContractionSeqOptimizer::SearchTelemetry NumServer::getContrSeqTelemetry() const
+{
+ return contr_seq_telemetry_;
+}
+
+const ProcessGroup & NumServer::getDefaultProcessGroup() const
+{
+ return *process_world_;
+}
+
+const ProcessGroup & NumServer::getCurrentProcessGroup() const
+{
+ return *process_self_;
+}
+
+const ProcessGroup & NumServer::getNodeProcessGroup() const
+{
+ return *process_node_;
+}
+
+int NumServer::getProcessRank(const ProcessGroup & process_group) const
+{
+ unsigned int local_rank;
+ auto rank_is_in = process_group.rankIsIn(getProcessRank(),&local_rank);
+ if(!rank_is_in) return -1;
+ assert(local_rank >= 0);
+ return static_cast<int>(local_rank);
+}
+
+int NumServer::getProcessRank() const
+{
+ return process_rank_;
+}
+
+int NumServer::getNumProcesses(const ProcessGroup & process_group) const
+{
+ return static_cast<int>(process_group.getSize());
+}
+
+int NumServer::getNumProcesses() const
+{
+ return num_processes_;
+}
+
+std::shared_ptr<TensorMapper> NumServer::getTensorMapper(const ProcessGroup & process_group) const
+{
+ unsigned int local_rank;
+ bool rank_is_in_group = process_group.rankIsIn(process_rank_,&local_rank);
+ assert(rank_is_in_group);
+#ifdef MPI_ENABLED
+ if(tensor_mapping_ == TensorMapping::BALANCED){
+  std::vector<unsigned int> process_order; //node-major process order (if the compute nodes are known)
+  for(const auto & groups: node_groups_){
+   if(groups.parent == process_group){
+    process_order = groups.process_order;
+    break;
+   }
+  }
+  return std::shared_ptr<TensorMapper>(new BalancedTensorMapper(process_group.getMPICommProxy(),
+          local_rank,process_group.getSize(),process_group.getMemoryLimitPerProcess(),tensors_,process_order));
+ }
+ return std::shared_ptr<TensorMapper>(new CompositeTensorMapper(process_group.getMPICommProxy(),
+         local_rank,process_group.getSize(),process_group.getMemoryLimitPerProcess(),tensors_));
+#else
+ if(tensor_mapping_ == TensorMapping::BALANCED){
+  return std::shared_ptr<TensorMapper>(new BalancedTensorMapper(local_rank,process_group.getSize(),
+                                       process_group.getMemoryLimitPerProcess(),tensors_,std::vector<unsigned int>{}));
+ }
+ return std::shared_ptr<TensorMapper>(new CompositeTensorMapper(local_rank,process_group.getSize(),
+                                      process_group.getMemoryLimitPerProcess(),tensors_));
+#endif
+}
+
+std::shared_ptr<TensorMapper> NumServer::getTensorMapper() const
+{
+ return default_tensor_mapper_;
+}
+
+void NumServer::registerTensorMethod(const std::string & tag, std::shared_ptr<TensorMethod> method)
+{
+ auto res = ext_methods_.insert({tag,method});
+ if(!(std::get<1>(res))) std::cout << "#ERROR(NumServer::registerTensorMethod): Method already exists: " << tag << std::endl;
+ assert(std::get<1>(res));
+ return;
+}
+
+std::shared_ptr<TensorMethod> NumServer::getTensorMethod(const std::string & tag)
+{
+ return ext_methods_[tag];
+}
+
+void NumServer::registerExternalData(const std::string & tag, std::shared_ptr<BytePacket> packet)
+{
+ auto res = ext_data_.insert({tag,packet});
+ if(!(std::get<1>(res))) std::cout << "#ERROR(NumServer::registerExternalData): Data already exists: " << tag << std::endl;
+ assert(std::get<1>(res));
+ return;
+}
+
+std::shared_ptr<BytePacket> NumServer::getExternalData(const std::string & tag)
+{
+ return ext_data_[tag];
+}
+
+
+ScopeId NumServer::openScope(const std::string & scope_name)
+{
+ assert(scope_name.length() > 0);
+ auto & scopes = getClientContext().scopes;
+ ScopeId new_scope_id = scopes.size();
+ scopes.push(std::pair<std::string,ScopeId>{scope_name,new_scope_id});
+ return new_scope_id;
+}
+
+ScopeId NumServer::closeScope()
+{
+ auto & scopes = getClientContext().scopes;
+ const auto & prev_scope = scopes.top();
+ ScopeId prev_scope_id = std::get<1>(prev_scope);
+ scopes.pop();
+ return prev_scope_id;
+}
+
+NumServer::ClientContext & NumServer::getClientContext()
+{
+ std::lock_guard<std::mutex> lock(clients_mtx_);
+ auto & context = clients_[std::this_thread::get_id()];
+ if(context.scopes.empty()) context.scopes.push(std::pair<std::string,ScopeId>{"GLOBAL",0}); //GLOBAL scope 0 is automatically open (top scope)
+ return context;
+}
+
+
+SpaceId NumServer::createVectorSpace(const std::string & space_name, DimExtent space_dim,
+                                     const VectorSpace ** space_ptr)
+{
+ assert(space_name.length() > 0);
+ SpaceId space_id = space_register_->registerSpace(std::make_shared<VectorSpace>(space_dim,space_name));
+ if(space_ptr != nullptr) *space_ptr = space_register_->getSpace(space_id);
+ return space_id;
+}
+
+void NumServer::destroyVectorSpace(const std::string & space_name)
+{
+ assert(false);
+ //`Finish
+ return;
+}
+
+void NumServer::destroyVectorSpace(SpaceId space_id)
+{
+ assert(false);
+ //`Finish
+ return;
+}
+
+const VectorSpace * NumServer::getVectorSpace(const std::string & space_name) const
+{
+ return space_register_->getSpace(space_name);
+}
+
+
+SubspaceId NumServer::createSubspace(const std::string & subspace_name,
+                                     const std::string & space_name,
+                                     std::pair<DimOffset,DimOffset> bounds,
+                                     const Subspace ** subspace_ptr)
+{
+ assert(subspace_name.length() > 0 && space_name.length() > 0);
+ const VectorSpace * space = space_register_->getSpace(space_name);
+ assert(space != nullptr);
+ SubspaceId subspace_id = space_register_->registerSubspace(std::make_shared<Subspace>(space,bounds,subspace_name));
+ if(subspace_ptr != nullptr) *subspace_ptr = space_register_->getSubspace(space_name,subspace_name);
+ auto res = subname2id_.insert({subspace_name,space->getRegisteredId()});
+ if(!(res.second)) std::cout << "#ERROR(NumServer::createSubspace): Subspace already exists: " << subspace_name << std::endl;
+ assert(res.second);
+ return subspace_id;
+}
+
+void NumServer::destroySubspace(const std::string & subspace_name)
+{
+ assert(false);
+ //`Finish
+ return;
+}
+
+void NumServer::destroySubspace(SubspaceId subspace_id)
+{
+ assert(false);
+ //`Finish
+ return;
+}
+
+const Subspace * NumServer::getSubspace(const std::string & subspace_name) const
+{
+ assert(subspace_name.length() > 0);
+ auto it = subname2id_.find(subspace_name);
+ if(it == subname2id_.end()) std::cout << "#ERROR(NumServer::getSubspace): Subspace not found: " << subspace_name << std::endl;
+ assert(it != subname2id_.end());
+ SpaceId space_id = (*it).second;
+ const VectorSpace * space = space_register_->getSpace(space_id);
+ assert(space != nullptr);
+ const std::string & space_name = space->getName();
+ assert(space_name.length() > 0);
+ return space_register_->getSubspace(space_name,subspace_name);
+}
+
+bool NumServer::subspaceRegistered(const std::string & subspace_name) const
+{
+ return (subname2id_.find(subspace_name) != subname2id_.end());
+}
+
+bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
+{
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_); //short bookkeeping, the tensor runtime staging is lock-free
+ bool submitted = false;
+ if(operation){
+  if(logging_ > 1 || (validation_tracing_ && logging_ > 0)){
+   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+            << "]: Submitting tensor operation:" << std::endl;
+   operation->printItFile(logfile_);
+   logfile_.flush(); //`Debug only
+  }
   submitted = true;
+  //Apply the current precision policy:
+  if(operation->getPrecision() == TensorOpPrecision::DEFAULT && precision_policy_ != TensorOpPrecision::DEFAULT)
+   operation->setPrecision(precision_policy_,precision_tolerance_);
   //Register/unregister tensor existence:
   if(operation->getOpcode() == TensorOpCode::CREATE){ //TENSOR_CREATE sets tensor element type for future references
    auto tensor = operation->getTensorOperand(0);
@@ -524,7 +1228,7 @@ bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
    }else{
     tensor->setElementType(elem_type);
    }
-   auto res = tensors_.emplace(std::make_pair(tensor->getName(),tensor)); //registers the tensor
+   auto res = tensors_.emplace(std::make_pair(tensor->getNameId(),tensor)); //registers the tensor
    if(!(res.second)){
     std::cout << "#ERROR(exatn::NumServer::submitOp): Attempt to CREATE an already existing tensor "
               << tensor->getName() << std::endl << std::flush;
@@ -535,7 +1239,8 @@ bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
    }
   }else if(operation->getOpcode() == TensorOpCode::DESTROY){
    auto tensor = operation->getTensorOperand(0);
-   auto num_deleted = tensors_.erase(tensor->getName()); //unregisters the tensor
+   auto num_deleted = tensors_.erase(tensor->getNameId()); //unregisters the tensor
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); transfer_tolerant_.erase(tensor->getName());}
    if(num_deleted != 1){
     std::cout << "#ERROR(exatn::NumServer::submitOp): Attempt to DESTROY a non-existing tensor "
               << tensor->getName() << std::endl << std::flush;
@@ -545,8 +1250,32 @@ bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
     //std::cout << "#DEBUG(exatn::NumServer::submitOp): Destroyed tensor " << tens_name << std::endl << std::flush;
    }
   }
+  //Record tensor operation in the active capture, if any:
+  if(submitted && active_capture_ != nullptr){
+   CapturedOperation captured{std::shared_ptr<TensorOperation>(operation->clone()),false,nullptr};
+   if(operation->getOpcode() == TensorOpCode::CREATE){
+    const auto & tensor_name = operation->getTensorOperand(0)->getName();
+    {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); captured.implicit = (implicit_tensors_.find(tensor_name) != implicit_tensors_.cend());}
+    auto iter = tensor_comms_.find(lookupNameId(tensor_name));
+    if(iter != tensor_comms_.cend()) captured.process_group = std::make_shared<ProcessGroup>(iter->second);
+   }
+   active_capture_->emplace_back(std::move(captured));
+  }
   //Submit tensor operation to tensor runtime:
-  if(submitted) tensor_rt_->submit(operation);
+  if(submitted){
+   last_submitted_op_ = operation;
+   if(dry_run_) exec_plan_.recordOperation(*operation);
+   auto & client = getClientContext();
+   if(client.batching){
+    client.op_batch.emplace_back(operation);
+   }else{
+    tensor_rt_->submit(operation);
+   }
+   if(client.speculating && runtime::TensorRuntime::isCancellable(*operation))
+    client.speculative_ops.emplace_back(operation); //speculative tensor operation (can be discarded)
+   //Checksum the sampled tensor operations without synchronization:
+   if(validation_fraction_ > 0.0 && !validation_tracing_ && !dry_run_) sampleValidation(*operation);
+  }
   //Compute validation stamps for all output tensor operands, if needed (debug):
   if(validation_tracing_ && submitted){
    const auto opcode = operation->getOpcode();
@@ -558,6 +1287,7 @@ bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
      std::shared_ptr<TensorOperation> op_trace = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
      op_trace->setTensorOperand(operation->getTensorOperand(oper));
      std::dynamic_pointer_cast<numerics::TensorOpTransform>(op_trace)->resetFunctor(functor_norm1);
+     std::dynamic_pointer_cast<numerics::TensorOpTransform>(op_trace)->resetReadOnly(true);
      submitted = tensor_rt_->submit(op_trace);
      if(submitted){
       submitted = tensor_rt_->sync(*op_trace);
@@ -574,12 +1304,127 @@ bool NumServer::submitOp(std::shared_ptr<TensorOperation> operation)
  return submitted;
 }
 
+bool NumServer::submitStructuredContraction(std::shared_ptr<TensorOperation> operation,
+                                            bool & handled)
+{
+ handled = false;
+ if(operation->getOpcode() != TensorOpCode::CONTRACT) return true;
+ //Find the single structured input tensor operand (implicit order-2 Kronecker Delta tensors included):
+ unsigned int s_pos = 0;
+ std::shared_ptr<TensorStructured> structured;
+ for(unsigned int i = 1; i <= 2; ++i){
+  auto operand = operation->getTensorOperand(i);
+  auto tensor = castTensorStructured(operand);
+  if(!tensor){
+   const auto & tensor_name = operand->getName();
+   if(operand->getRank() == 2 && tensor_name.length() >= 2 && tensor_name[0] == '_' && tensor_name[1] == 'd'){
+    if(operand->getDimSpaceAttr(0) == operand->getDimSpaceAttr(1) && !tensorAllocated(tensor_name))
+     tensor = std::make_shared<TensorStructured>(tensor_name,operand->getDimExtent(0));
+   }
+  }
+  if(tensor){
+   if(structured) return true; //both input tensors are structured: Not handled
+   structured = tensor;
+   s_pos = i;
+  }
+ }
+ if(!structured) return true;
+ const unsigned int x_pos = 3 - s_pos;
+ auto output = operation->getTensorOperand(0);
+ auto other = operation->getTensorOperand(x_pos);
+ if(output->isComposite() || other->isComposite() || castTensorStructured(output)) return true;
+ //The structured tensor must have one index contracted with the other input tensor and one open index:
+ std::vector<std::string> tensors;
+ std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
+ if(!parse_tensor_contraction(operation->getIndexPattern(),tensors,left_inds,right_inds,contr_inds,hyper_inds)) return true;
+ if(!hyper_inds.empty() || contr_inds.size() != 1) return true;
+ const int s_contr = contr_inds[0].arg_pos[s_pos]; //contracted dimension of the structured tensor
+ const int x_contr = contr_inds[0].arg_pos[x_pos]; //contracted dimension of the other input tensor
+ const auto & open_inds = (s_pos == 1) ? left_inds : right_inds;
+ int d_open = -1; //dimension of the output tensor associated with the open index of the structured tensor
+ for(const auto & index: open_inds) if(index.arg_pos[s_pos] == (1 - s_contr)) d_open = index.arg_pos[0];
+ if(s_contr < 0 || x_contr < 0 || d_open < 0) return true;
+ if(other->getDimExtent(x_contr) != output->getDimExtent(d_open)) return true;
+ std::string d_name, x_name;
+ std::vector<IndexLabel> d_inds, x_inds;
+ bool d_conj = false, x_conj = false;
+ if(!(parse_tensor(tensors[0],d_name,d_inds,d_conj) && parse_tensor(tensors[x_pos],x_name,x_inds,x_conj))) return true;
+ auto x_relabeled = x_inds;
+ x_relabeled[x_contr] = d_inds[d_open];
+ //Execute the tensor contraction without materializing the structured tensor:
+ handled = true;
+ bool success = true;
+ const auto priority = operation->getPriority();
+ const auto structure = structured->getStructure();
+ if(structure == numerics::TensorStructure::DELTA){ //index relabeling: D(..b..) += X(..c->b..) * alpha
+  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
+  op->setTensorOperand(output);
+  op->setTensorOperand(other,x_conj);
+  op->setIndexPattern(assemble_symbolic_tensor(d_name,d_inds) + "+=" + assemble_symbolic_tensor(x_name,x_relabeled,x_conj));
+  op->setScalar(0,operation->getScalar(0));
+  op->setPriority(priority);
+  success = submitOp(op);
+ }else{ //scaling or reordering along the contracted dimension of a temporary copy of the other input tensor
+  auto temp = std::make_shared<Tensor>(*other);
+  temp->rename(numerics::generateTensorName(*temp,"s"));
+  std::shared_ptr<TensorMethod> functor;
+  if(structure == numerics::TensorStructure::DIAGONAL){
+   auto diagonal = structured->getDiagonal();
+   if(operation->operandIsConjugated(s_pos)) for(auto & elem: diagonal) elem = std::conj(elem);
+   functor = std::shared_ptr<TensorMethod>(new numerics::FunctorApplyStructured(x_contr,diagonal,
+                                                                                dim_base_offset(*temp,x_contr)));
+  }else{ //PERMUTATION: S(i,j) = delta(i,p(j))
+   functor = std::shared_ptr<TensorMethod>(new numerics::FunctorApplyStructured(x_contr,
+    (s_contr == 0) ? structured->getPermutation() : structured->getInversePermutation(),
+    dim_base_offset(*temp,x_contr)));
+  }
+  std::vector<std::shared_ptr<TensorOperation>> ops(6);
+  ops[0] = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+  ops[0]->setTensorOperand(temp);
+  std::dynamic_pointer_cast<numerics::TensorOpCreate>(ops[0])->resetTensorElementType(other->getElementType());
+  ops[1] = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+  ops[1]->setTensorOperand(temp);
+  std::dynamic_pointer_cast<numerics::TensorOpTransform>(ops[1])->
+   resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
+  ops[2] = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
+  ops[2]->setTensorOperand(temp);
+  ops[2]->setTensorOperand(other,x_conj);
+  ops[2]->setIndexPattern(assemble_symbolic_tensor(temp->getName(),x_inds) + "+=" +
+                          assemble_symbolic_tensor(x_name,x_inds,x_conj));
+  ops[3] = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+  ops[3]->setTensorOperand(temp);
+  std::dynamic_pointer_cast<numerics::TensorOpTransform>(ops[3])->resetFunctor(functor);
+  ops[4] = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
+  ops[4]->setTensorOperand(output);
+  ops[4]->setTensorOperand(temp);
+  ops[4]->setIndexPattern(assemble_symbolic_tensor(d_name,d_inds) + "+=" +
+                          assemble_symbolic_tensor(temp->getName(),x_relabeled));
+  ops[4]->setScalar(0,operation->getScalar(0));
+  ops[5] = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+  ops[5]->setTensorOperand(temp);
+  for(auto & op: ops){
+   op->setPriority(priority);
+   success = submitOp(op); if(!success) break;
+  }
+ }
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+  << "]: Structured tensor contraction " << operation->getIndexPattern() << " executed without materializing tensor "
+  << structured->getName() << std::endl << std::flush;
+ return success;
+}
+
 bool NumServer::submit(std::shared_ptr<TensorOperation> operation, std::shared_ptr<TensorMapper> tensor_mapper)
 {
  bool success = true;
  std::stack<unsigned int> deltas;
  const auto opcode = operation->getOpcode();
  const auto num_operands = operation->getNumOperands();
+ //Execute tensor contractions with structured tensors without materializing them:
+ if(opcode == TensorOpCode::CONTRACT){
+  bool handled = false;
+  success = submitStructuredContraction(operation,handled);
+  if(handled || !success) return success;
+ }
  //Create and initialize implicit Kronecker Delta tensors:
  if(opcode != TensorOpCode::CREATE && opcode != TensorOpCode::DESTROY){
   auto elem_type = TensorElementType::VOID;
@@ -591,8 +1436,9 @@ bool NumServer::submit(std::shared_ptr<TensorOperation> operation, std::shared_p
   for(unsigned int i = 0; i < num_operands; ++i){
    auto operand = operation->getTensorOperand(i);
    const auto & tensor_name = operand->getName();
-   if(tensor_name.length() >= 2){
-    if(tensor_name[0] == '_' && tensor_name[1] == 'd'){ //_d: explicit Kronecker Delta tensor
+   auto structured = castTensorStructured(operand);
+   if(tensor_name.length() >= 2 || structured){
+    if(structured || (tensor_name[0] == '_' && tensor_name[1] == 'd')){ //_d: explicit Kronecker Delta tensor
      if(!tensorAllocated(tensor_name)){
       //std::cout << "#DEBUG(exatn::NumServer::submitOp): Kronecker Delta tensor creation: "
       //          << tensor_name << ": Element type = " << static_cast<int>(elem_type) << std::endl; //debug
@@ -608,6 +1454,20 @@ bool NumServer::submit(std::shared_ptr<TensorOperation> operation, std::shared_p
        std::dynamic_pointer_cast<numerics::TensorOpTransform>(op1)->
         resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitDelta()));
        success = submitOp(op1);
+       if(success && structured){ //dense structured tensor: S(i,j) = delta(i,j) * d(j) or delta(i,p(j))
+        std::shared_ptr<TensorMethod> functor;
+        if(structured->getStructure() == numerics::TensorStructure::DIAGONAL){
+         functor = std::shared_ptr<TensorMethod>(new numerics::FunctorApplyStructured(1,structured->getDiagonal()));
+        }else if(structured->getStructure() == numerics::TensorStructure::PERMUTATION){
+         functor = std::shared_ptr<TensorMethod>(new numerics::FunctorApplyStructured(1,structured->getPermutation()));
+        }
+        if(functor){
+         std::shared_ptr<TensorOperation> op3 = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+         op3->setTensorOperand(operand);
+         std::dynamic_pointer_cast<numerics::TensorOpTransform>(op3)->resetFunctor(functor);
+         success = submitOp(op3);
+        }
+       }
       }
      }
     }
@@ -615,30 +1475,211 @@ bool NumServer::submit(std::shared_ptr<TensorOperation> operation, std::shared_p
    if(!success) break;
   }
  }
- if(success){
-  //Submit the main tensor operation:
-  if(operation->isComposite()){
-   const auto num_ops = operation->decompose(*tensor_mapper); assert(num_ops > 0);
-   for(std::size_t op_id = 0; op_id < num_ops; ++op_id){
-    success = submitOp((*operation)[op_id]); if(!success) break;
+ if(success){
+  //Submit the main tensor operation:
+  if(operation->isComposite()){
+   runtime::TensorExecState::registerTensorWrites(*operation); //the composite output tensor operands are versioned as a whole
+   const auto num_ops = operation->decompose(*tensor_mapper); assert(num_ops > 0);
+   for(std::size_t op_id = 0; op_id < num_ops; ++op_id){
+    (*operation)[op_id]->setPriority(operation->getPriority()); //simple tensor operations inherit the latency class
+    if(operation->isCommutativeAccumulation() && (*operation)[op_id]->getOpcode() == operation->getOpcode())
+     (*operation)[op_id]->setCommutativeAccumulation(true); //so do the simple accumulations
+    (*operation)[op_id]->setPrecision(operation->getPrecision(),operation->getPrecisionTolerance()); //and the precision policy
+    (*operation)[op_id]->setExecutionDevice(operation->getExecutionDevice()); //and the execution device class
+    success = submitOp((*operation)[op_id]); if(!success) break;
+   }
+  }else{
+   success = submitOp(operation);
+  }
+  if(success){
+   //Destroy temporarily created Kronecker Delta tensors:
+   while(!deltas.empty()){
+    auto operand = operation->getTensorOperand(deltas.top());
+    std::shared_ptr<TensorOperation> op2 = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+    op2->setTensorOperand(operand);
+    success = submitOp(op2); if(!success) break;
+    deltas.pop();
+   }
+  }
+ }
+ return success;
+}
+
+bool NumServer::submit(const std::vector<std::shared_ptr<TensorOperation>> & operations,
+                       std::shared_ptr<TensorMapper> tensor_mapper)
+{
+ bool success = true;
+ beginBatch();
+ for(auto & operation: operations){
+  success = submit(operation,tensor_mapper); if(!success) break;
+ }
+ endBatch();
+ return success;
+}
+
+void NumServer::beginBatch()
+{
+ auto & client = getClientContext();
+ assert(!client.batching);
+ client.batching = !validation_tracing_; //validation tracing synchronizes each tensor operation
+ return;
+}
+
+void NumServer::endBatch()
+{
+ auto & client = getClientContext();
+ if(client.batching){
+  client.batching = false;
+  if(!client.op_batch.empty()) tensor_rt_->submit(client.op_batch);
+  client.op_batch.clear();
+ }
+ return;
+}
+
+bool NumServer::beginCapture(const std::string & capture_name)
+{
+ if(active_capture_ != nullptr){
+  std::cout << "#ERROR(exatn::NumServer::beginCapture): Another capture is still active!" << std::endl << std::flush;
+  return false;
+ }
+ auto & capture = captures_[capture_name];
+ capture.clear();
+ active_capture_ = &capture;
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Started capture <" << capture_name << ">" << std::endl << std::flush;
+ return true;
+}
+
+bool NumServer::endCapture()
+{
+ if(active_capture_ == nullptr){
+  std::cout << "#ERROR(exatn::NumServer::endCapture): No active capture!" << std::endl << std::flush;
+  return false;
+ }
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Finished capture of " << active_capture_->size() << " tensor operations" << std::endl << std::flush;
+ active_capture_ = nullptr;
+ return true;
+}
+
+bool NumServer::beginSpeculation()
+{
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_);
+ if(!speculation_) return false;
+ auto & client = getClientContext();
+ if(client.speculating) return false;
+ client.speculating = true;
+ client.speculative_ops.clear();
+ return true;
+}
+
+bool NumServer::commitSpeculation()
+{
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_);
+ auto & client = getClientContext();
+ if(!client.speculating){
+  std::cout << "#ERROR(exatn::NumServer::commitSpeculation): No active speculation!" << std::endl << std::flush;
+  return false;
+ }
+ client.speculating = false;
+ client.speculative_ops.clear();
+ return true;
+}
+
+bool NumServer::discardSpeculation()
+{
+ std::lock_guard<std::recursive_mutex> lock(submit_mtx_);
+ auto & client = getClientContext();
+ if(!client.speculating){
+  std::cout << "#ERROR(exatn::NumServer::discardSpeculation): No active speculation!" << std::endl << std::flush;
+  return false;
+ }
+ if(client.batching){ //batched tensor operations have not been submitted yet
+  std::cout << "#ERROR(exatn::NumServer::discardSpeculation): Discarding a speculation inside a batch!" << std::endl << std::flush;
+  return false;
+ }
+ client.speculating = false;
+ const auto num_cancelled = tensor_rt_->cancel(client.speculative_ops);
+ if(num_cancelled > 0) network_memos_.clear(); //memoized evaluations may refer to cancelled results (l)
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Discarded speculation: Requested cancellation of " << num_cancelled
+                           << " tensor operations" << std::endl << std::flush;
+ client.speculative_ops.clear();
+ return true;
+}
+
+bool NumServer::replay(const std::string & capture_name,
+                       const std::map<std::string,std::shared_ptr<Tensor>> & bindings)
+{
+ auto capture = captures_.find(capture_name);
+ if(capture == captures_.end()){
+  std::cout << "#ERROR(exatn::NumServer::replay): Capture not found: " << capture_name << std::endl << std::flush;
+  return false;
+ }
+ if(&(capture->second) == active_capture_){
+  std::cout << "#ERROR(exatn::NumServer::replay): Attempt to replay an active capture: " << capture_name << std::endl << std::flush;
+  return false;
+ }
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Replaying capture <" << capture_name << "> of " << capture->second.size()
+                           << " tensor operations" << std::endl << std::flush;
+ bool success = true;
+ for(const auto & captured: capture->second){
+  std::shared_ptr<TensorOperation> op(captured.operation->clone());
+  //Rebind tensor operands by their names:
+  const auto num_operands = op->getNumOperands();
+  for(unsigned int i = 0; i < num_operands; ++i){
+   auto tensor = op->getTensorOperand(i);
+   auto bound = bindings.find(tensor->getName());
+   if(bound != bindings.cend()){
+    make_sure(bound->second->getRank() == tensor->getRank(),
+              "exatn::NumServer::replay: Rank mismatch for the bound tensor " + tensor->getName());
+    tensor = bound->second;
    }
-  }else{
-   success = submitOp(operation);
+   auto registered = tensors_.find(tensor->getNameId());
+   if(registered != tensors_.end()) tensor = registered->second;
+   success = op->resetTensorOperand(i,tensor); assert(success);
   }
-  if(success){
-   //Destroy temporarily created Kronecker Delta tensors:
-   while(!deltas.empty()){
-    auto operand = operation->getTensorOperand(deltas.top());
-    std::shared_ptr<TensorOperation> op2 = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
-    op2->setTensorOperand(operand);
-    success = submitOp(op2); if(!success) break;
-    deltas.pop();
+  //Submit the rebound tensor operation:
+  const auto opcode = op->getOpcode();
+  if(opcode == TensorOpCode::CREATE){
+   auto tensor = op->getTensorOperand(0);
+   const auto & tensor_name = tensor->getName();
+   if(tensors_.find(lookupNameId(tensor_name)) == tensors_.end()){ //existing tensors are reused
+    if(captured.implicit){std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); implicit_tensors_.emplace(std::make_pair(tensor_name,tensor));}
+    if(captured.process_group) tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(tensor_name),*(captured.process_group)));
+    success = submitOp(op);
    }
+  }else if(opcode == TensorOpCode::DESTROY){
+   const auto tensor_name = op->getTensorOperand(0)->getName();
+   success = submitOp(op);
+   if(success){
+    tensor_comms_.erase(lookupNameId(tensor_name));
+    std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+    implicit_tensors_.erase(tensor_name);
+   }
+  }else{
+   success = submitOp(op);
   }
+  if(!success) break;
  }
  return success;
 }
 
+bool NumServer::captureExists(const std::string & capture_name) const
+{
+ return (captures_.find(capture_name) != captures_.cend());
+}
+
+bool NumServer::destroyCapture(const std::string & capture_name)
+{
+ auto capture = captures_.find(capture_name);
+ if(capture == captures_.end()) return false;
+ if(&(capture->second) == active_capture_) active_capture_ = nullptr;
+ captures_.erase(capture);
+ return true;
+}
+
 bool NumServer::submit(TensorNetwork & network)
 {
  return submit(getDefaultProcessGroup(),network);
@@ -649,59 +1690,237 @@ bool NumServer::submit(std::shared_ptr<TensorNetwork> network)
  return submit(getDefaultProcessGroup(),network);
 }
 
-bool NumServer::submit(const ProcessGroup & process_group,
-                       TensorNetwork & network)
+double NumServer::getMemoryFragmentationFactor() const
 {
- const bool debugging = false;
- const bool serialize = false;
+ double frag_coef = DEFAULT_MEM_FRAGMENTATION;
+ std::size_t tensor_mem = 0;
+ const double frag_measured = getMemoryFragmentation(&tensor_mem);
+ if(frag_measured > 0.0 && tensor_mem >= getMemoryBufferSize() / MEM_FRAGMENTATION_SAMPLE_RATIO)
+  frag_coef = (frag_measured < MAX_MEM_FRAGMENTATION) ? frag_measured : MAX_MEM_FRAGMENTATION;
+ return frag_coef;
+}
 
-#ifdef CUQUANTUM
- if(comp_backend_ == "cuquantum"){
-  auto sh_network = std::shared_ptr<TensorNetwork>(&network,[](TensorNetwork * net_ptr){});
-  return submit(process_group,sh_network);
+bool NumServer::submitOutputReduction(const ProcessGroup & process_group,
+                                      std::shared_ptr<Tensor> tensor,
+                                      std::shared_ptr<TensorMapper> tensor_mapper)
+{
+ const bool reduced_precision = tensorTransferTolerant(tensor->getName());
+ auto reduce = [&](const ProcessGroup & group, int root_rank){
+  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ALLREDUCE);
+  op->setTensorOperand(tensor);
+  std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetMPICommunicator(group.getMPICommProxy());
+  std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetReducedPrecisionTransfer(reduced_precision);
+  std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetRootRank(root_rank);
+  return submit(op,tensor_mapper);
+ };
+ bool success = true;
+ switch(output_reduction_){
+ case OutputReduction::ALLREDUCE:
+  success = reduce(process_group,-1);
+  break;
+ case OutputReduction::ROOT:
+  success = reduce(process_group,0);
+  break;
+ case OutputReduction::HIERARCHICAL:
+  {
+   const auto & groups = getNodeProcessGroups(process_group);
+   //Reduce within the node, allreduce among the node leaders, broadcast within the node:
+   const auto & node = *(groups.node);
+   if(node.getSize() > 1) success = reduce(node,0);
+   if(success && groups.leaders){
+    if(groups.leaders->getSize() > 1) success = reduce(*(groups.leaders),-1);
+   }
+   if(success && node.getSize() > 1){
+    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::BROADCAST);
+    op->setTensorOperand(tensor);
+    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetMPICommunicator(node.getMPICommProxy());
+    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetReducedPrecisionTransfer(reduced_precision);
+    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetRootRank(0);
+    success = submit(op,tensor_mapper);
+   }
+  }
+  break;
  }
+ return success;
+}
+
+const NumServer::NodeProcessGroups & NumServer::getNodeProcessGroups(const ProcessGroup & process_group)
+{
+ auto groups = node_groups_.begin();
+ while(groups != node_groups_.end() && !(groups->parent == process_group)) ++groups;
+ if(groups == node_groups_.end()){
+  auto node = process_group.splitByNode(); assert(node);
+  unsigned int node_rank = 0;
+  auto in_node = node->rankIsIn(process_rank_,&node_rank); assert(in_node);
+  auto leaders = process_group.split((node_rank == 0) ? 0 : -1); //collective
+  //Node-major order of the local process ranks (ordered by the node leaders):
+  const auto num_procs = process_group.getSize();
+  std::vector<unsigned int> process_order(num_procs);
+  for(unsigned int i = 0; i < num_procs; ++i) process_order[i] = i;
+#ifdef MPI_ENABLED
+  unsigned int leader_rank = 0;
+  auto in_group = process_group.rankIsIn(node->getProcessRanks()[0],&leader_rank); assert(in_group);
+  std::vector<unsigned int> node_leaders(num_procs);
+  auto errc = MPI_Allgather(&leader_rank,1,MPI_UNSIGNED,node_leaders.data(),1,MPI_UNSIGNED,
+                            process_group.getMPICommProxy().getRef<MPI_Comm>());
+  assert(errc == MPI_SUCCESS);
+  std::stable_sort(process_order.begin(),process_order.end(),
+                   [&node_leaders](unsigned int a, unsigned int b){return node_leaders[a] < node_leaders[b];});
 #endif
+  groups = node_groups_.emplace(node_groups_.end(),NodeProcessGroups{process_group,node,leaders,process_order});
+ }
+ return *groups;
+}
 
- //Determine parallel execution configuration:
+double NumServer::getContrSeqSlicingVolume(const ProcessGroup & process_group) const
+{
+ double slicing_volume = 0.0; //memory limit (max intermediate volume) for the slicing-aware search
+ if(contr_seq_slicing_){
+  const std::size_t proc_mem_volume = process_group.getMemoryLimitPerProcess() / sizeof(std::complex<double>);
+  const double contr_mem_coef = tensor_rt_->getContractionMemoryFactor(); //{2.0:tensor transpose, 1.0:direct kernels}
+  slicing_volume = static_cast<double>(proc_mem_volume) / (getMemoryFragmentationFactor() * contr_mem_coef * CONTR_SEQ_SLICING_PRESENCE);
+ }
+ return slicing_volume;
+}
+
+void NumServer::determineContractionSequence(const ProcessGroup & process_group,
+                                             TensorNetwork & network,
+                                             bool synchronize)
+{
  unsigned int local_rank; //local process rank within the process group
- if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
- //assert(network.isValid()); //debug
- unsigned int num_procs = process_group.getSize(); //number of executing processes
- assert(local_rank < num_procs);
- if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-                           << "]: Submitting tensor network <" << network.getName() << "> (" << network.getTensor(0)->getName()
-                           << ") for execution by " << num_procs << " processes with memory limit "
-                           << process_group.getMemoryLimitPerProcess() << " bytes" << std::endl << std::flush;
- if(logging_ > 0) network.printItFile(logfile_);
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return; //process is not in the group: Do nothing
+ const unsigned int num_procs = process_group.getSize(); //number of executing processes
 
- //Determine the pseudo-optimal tensor contraction sequence:
  const auto num_input_tensors = network.getNumTensors();
+ const double slicing_volume = getContrSeqSlicingVolume(process_group);
+ //Distributed search: Each process explores its own search variant (process 0 performs the default search),
+ //possibly with its own optimizer from the portfolio, the best sequence is then agreed upon:
+ std::string contr_seq_optimizer = contr_seq_optimizer_;
+ if(local_rank > 0 && !contr_seq_portfolio_.empty())
+  contr_seq_optimizer = contr_seq_portfolio_[(local_rank - 1) % contr_seq_portfolio_.size()];
+ std::function<double (double)> bound_exchange = nullptr;
+#ifdef MPI_ENABLED
+ //The best-so-far cost is shared via a one-sided MIN accumulate into a window hosted by process 0:
+ const bool bound_sharing = (synchronize && num_procs > 1 && num_input_tensors > 2);
+ MPI_Win bound_win;
+ double * bound_base = nullptr;
+ if(bound_sharing){
+  const auto & comm = process_group.getMPICommProxy().getRef<MPI_Comm>();
+  int comm_rank = 0;
+  auto errc = MPI_Comm_rank(comm,&comm_rank); assert(errc == MPI_SUCCESS);
+  const MPI_Aint win_size = (comm_rank == 0) ? sizeof(double) : 0;
+  errc = MPI_Win_allocate(win_size,sizeof(double),MPI_INFO_NULL,comm,&bound_base,&bound_win);
+  assert(errc == MPI_SUCCESS);
+  if(comm_rank == 0) *bound_base = std::numeric_limits<double>::max();
+  errc = MPI_Barrier(comm); assert(errc == MPI_SUCCESS);
+  errc = MPI_Win_lock_all(MPI_MODE_NOCHECK,bound_win); assert(errc == MPI_SUCCESS);
+  bound_exchange = [&process_group,&bound_win](double fma_flops){
+   auto & comm_profile = getCommProfile();
+   const double comm_start = exatn::Timer::timeInSecHR();
+   double shared_flops = fma_flops;
+   auto errc = MPI_Fetch_and_op(&fma_flops,&shared_flops,MPI_DOUBLE,0,0,MPI_MIN,bound_win); assert(errc == MPI_SUCCESS);
+   errc = MPI_Win_flush(0,bound_win); assert(errc == MPI_SUCCESS);
+   comm_profile.record(CommProfile::CommKind::SEQ_BOUND,process_group.getMPICommProxy(),0,
+                       sizeof(double),exatn::Timer::timeInSecHR(comm_start));
+   return std::min(fma_flops,shared_flops);
+  };
+ }
+#endif
  bool new_contr_seq = network.exportContractionSequence().empty();
+ double contr_seq_search_time = 0.0; //time spent in the tensor contraction sequence search (sec)
  if(contr_seq_caching_ && new_contr_seq){ //check whether the optimal tensor contraction sequence is already available from the past
-  auto cached_seq = ContractionSeqOptimizer::findContractionSequence(network);
-  if(cached_seq.first != nullptr){
-   network.importContractionSequence(*(cached_seq.first),cached_seq.second);
+  std::list<numerics::ContrTriple> cached_seq;
+  double cached_flops = 0.0;
+  if(ContractionSeqOptimizer::findContractionSequence(network,cached_seq,&cached_flops)){
+   network.importContractionSequence(cached_seq,cached_flops);
    new_contr_seq = false;
   }
  }
  if(new_contr_seq){
-  double flops = network.determineContractionSequence(contr_seq_optimizer_);
+  const auto search_start = exatn::Timer::timeInSecHR();
+  ContractionSeqOptimizer::beginSearchTelemetry(num_input_tensors); //no telemetry unless a full search is performed
+  if(num_procs > 1) ContractionSeqOptimizer::beginDistributedSearch(local_rank,bound_exchange);
+  double flops = network.determineContractionSequence(contr_seq_optimizer,slicing_volume,
+                  contr_seq_time_budget_,contr_seq_time_fraction_,CONTR_SEQ_FMA_FLOP_RATE*num_procs);
+  if(num_procs > 1) ContractionSeqOptimizer::endDistributedSearch();
+  if(bound_exchange){ //publish the final cost (prunes the searches still in progress)
+   bound_exchange((slicing_volume > 0.0) ?
+    ContractionSeqOptimizer::determineSlicedFlops(network,network.exportContractionSequence(),slicing_volume) : flops);
+  }
+  contr_seq_search_time = exatn::Timer::timeInSecHR(search_start);
+  contr_seq_time_ += contr_seq_search_time;
+  ++contr_seq_count_;
+  contr_seq_telemetry_ = ContractionSeqOptimizer::getSearchTelemetry();
+  if(!contr_seq_telemetry_.optimizer.empty()){
+   contr_seq_totals_.graph_time += contr_seq_telemetry_.graph_time;
+   contr_seq_totals_.partition_time += contr_seq_telemetry_.partition_time;
+   contr_seq_totals_.partition_calls += contr_seq_telemetry_.partition_calls;
+   contr_seq_totals_.evaluation_time += contr_seq_telemetry_.evaluation_time;
+   contr_seq_totals_.merge_time += contr_seq_telemetry_.merge_time;
+   if(logging_ > 0){
+    const auto & telemetry = contr_seq_telemetry_;
+    logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+             << "]: Contraction sequence search (" << telemetry.optimizer << ", " << telemetry.num_tensors
+             << " input tensors): Total time = " << telemetry.total_time << "; Graph = " << telemetry.graph_time
+             << "; Partitioning = " << telemetry.partition_time << " (" << telemetry.partition_calls << " calls)"
+             << "; Evaluation = " << telemetry.evaluation_time << "; Merging = " << telemetry.merge_time
+             << "; Walkers = " << telemetry.num_walkers << " x " << telemetry.num_rounds << " rounds ("
+             << telemetry.num_aborted << " aborted)" << std::scientific << "; FMA flops = " << telemetry.fma_flops
+             << " (sliced " << telemetry.sliced_fma_flops << " under memory limit " << telemetry.memory_limit
+             << "); Max intermediate volume = " << telemetry.max_intermediate_volume
+             << "; Slices = " << telemetry.num_slices << std::endl;
+    if(logging_ > 1){
+     logfile_ << " Best flops over time:";
+     for(const auto & point: telemetry.convergence) logfile_ << " " << std::fixed << point.first << ":" << std::scientific << point.second;
+     logfile_ << std::endl;
+    }
+   }
+  }
+  if(logging_ > 0 && contr_seq_optimizer == "auto"){
+   numerics::ContractionSeqOptimizerAuto::NetworkFeatures features;
+   const auto selected = numerics::ContractionSeqOptimizerAuto::selectOptimizer(network,&features);
+   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+            << "]: Automatic tensor contraction sequence optimizer selection: " << selected
+            << " (input tensors = " << features.num_tensors << ", treewidth <= " << features.treewidth
+            << ", max rank = " << features.max_rank << ", max extent = " << features.max_extent << ")" << std::endl;
+  }
+ }
+ if(logging_ > 0){
+  logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+           << "]: Found a contraction sequence candidate locally (" << contr_seq_optimizer
+           << ", caching = " << contr_seq_caching_ << ")";
+  if(contr_seq_caching_){
+   const auto stats = ContractionSeqOptimizer::getCacheStatistics();
+   logfile_ << ": Cache hits/misses = " << stats.hits << "/" << stats.misses << "; Entries = " << stats.entries
+            << "; Saved time (sec) = " << stats.saved_time;
+  }
+  logfile_ << std::endl;
  }
- if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
-                           << "]: Found a contraction sequence candidate locally (caching = " << contr_seq_caching_
-                           << ")" << std::endl;
 #ifdef MPI_ENABLED
+ if(bound_sharing){ //all processes have finished their search
+  auto errc = MPI_Win_unlock_all(bound_win); assert(errc == MPI_SUCCESS);
+  errc = MPI_Win_free(&bound_win); assert(errc == MPI_SUCCESS);
+ }
  //Synchronize on the best tensor contraction sequence across processes:
- if(num_procs > 1 && num_input_tensors > 2){
+ if(synchronize && num_procs > 1 && num_input_tensors > 2){
   double flops = 0.0;
   std::vector<double> proc_flops(num_procs,0.0);
   std::vector<unsigned int> contr_seq_content;
   packContractionSequenceIntoVector(network.exportContractionSequence(&flops),contr_seq_content);
-  auto errc = MPI_Gather(&flops,1,MPI_DOUBLE,proc_flops.data(),1,MPI_DOUBLE,
+  double cost = flops; //processes compete by the sliced flop count in the slicing-aware search
+  if(slicing_volume > 0.0){
+   cost = ContractionSeqOptimizer::determineSlicedFlops(network,network.exportContractionSequence(),slicing_volume);
+  }
+  auto & comm_profile = getCommProfile();
+  double comm_start = exatn::Timer::timeInSecHR();
+  auto errc = MPI_Gather(&cost,1,MPI_DOUBLE,proc_flops.data(),1,MPI_DOUBLE,
                          0,process_group.getMPICommProxy().getRef<MPI_Comm>());
   assert(errc == MPI_SUCCESS);
+  comm_profile.record(CommProfile::CommKind::SEQ_GATHER,process_group.getMPICommProxy(),0,
+                      sizeof(double),exatn::Timer::timeInSecHR(comm_start));
   auto min_flops = std::min_element(proc_flops.cbegin(),proc_flops.cend());
   int root_id = static_cast<int>(std::distance(proc_flops.cbegin(),min_flops));
+  comm_start = exatn::Timer::timeInSecHR();
   errc = MPI_Bcast(&root_id,1,MPI_INT,0,process_group.getMPICommProxy().getRef<MPI_Comm>());
   assert(errc == MPI_SUCCESS);
   errc = MPI_Bcast(&flops,1,MPI_DOUBLE,root_id,process_group.getMPICommProxy().getRef<MPI_Comm>());
@@ -709,46 +1928,261 @@ bool NumServer::submit(const ProcessGroup & process_group,
   errc = MPI_Bcast(contr_seq_content.data(),contr_seq_content.size(),MPI_UNSIGNED,
                    root_id,process_group.getMPICommProxy().getRef<MPI_Comm>());
   assert(errc == MPI_SUCCESS);
+  comm_profile.record(CommProfile::CommKind::SEQ_BCAST,process_group.getMPICommProxy(),root_id,
+                      sizeof(int) + sizeof(double) + contr_seq_content.size() * sizeof(unsigned int),
+                      exatn::Timer::timeInSecHR(comm_start));
   network.importContractionSequence(contr_seq_content,flops);
  }
  if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                            << "]: Found the optimal contraction sequence across all processes" << std::endl;
 #endif
  if(logging_ > 0) network.printContractionSequence(logfile_);
+ if(contr_seq_caching_ && new_contr_seq) ContractionSeqOptimizer::cacheContractionSequence(network,(local_rank == 0),contr_seq_search_time); //one writer per process group
+ return;
+}
+
+void NumServer::synchronizeContractionSequences(const ProcessGroup & process_group,
+                                               const std::vector<TensorNetwork*> & networks)
+{
+#ifdef MPI_ENABLED
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return; //process is not in the group: Do nothing
+ const unsigned int num_procs = process_group.getSize(); //number of executing processes
+ if(num_procs <= 1) return;
+ std::vector<TensorNetwork*> synced;
+ for(auto * network: networks){
+  if(network->getNumTensors() > 2) synced.emplace_back(network);
+ }
+ if(synced.empty()) return;
+ const int num_networks = static_cast<int>(synced.size());
+ const double slicing_volume = getContrSeqSlicingVolume(process_group);
+ //Find the process with the best tensor contraction sequence for each tensor network (single collective):
+ struct ProcCost{double cost; int rank;};
+ std::vector<ProcCost> proc_costs(num_networks);
+ std::vector<std::vector<unsigned int>> contr_seq_contents(num_networks);
+ std::vector<std::size_t> offsets(num_networks+1,0);
+ for(int i = 0; i < num_networks; ++i){
+  double flops = 0.0;
+  packContractionSequenceIntoVector(synced[i]->exportContractionSequence(&flops),contr_seq_contents[i]);
+  double cost = flops; //processes compete by the sliced flop count in the slicing-aware search
+  if(slicing_volume > 0.0){
+   cost = ContractionSeqOptimizer::determineSlicedFlops(*(synced[i]),synced[i]->exportContractionSequence(),slicing_volume);
+  }
+  proc_costs[i] = ProcCost{cost,static_cast<int>(local_rank)};
+  offsets[i+1] = offsets[i] + contr_seq_contents[i].size();
+ }
+ const double comm_start = exatn::Timer::timeInSecHR();
+ auto errc = MPI_Allreduce(MPI_IN_PLACE,proc_costs.data(),num_networks,MPI_DOUBLE_INT,MPI_MINLOC,
+                           process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ //Distribute the best tensor contraction sequences from their owners (single collective per data type):
+ std::vector<unsigned int> contr_seq_content(offsets[num_networks],0);
+ std::vector<double> contr_seq_flops(num_networks,0.0);
+ for(int i = 0; i < num_networks; ++i){
+  if(proc_costs[i].rank == static_cast<int>(local_rank)){
+   std::copy(contr_seq_contents[i].cbegin(),contr_seq_contents[i].cend(),contr_seq_content.begin()+offsets[i]);
+   synced[i]->exportContractionSequence(&(contr_seq_flops[i]));
+  }
+ }
+ errc = MPI_Allreduce(MPI_IN_PLACE,contr_seq_content.data(),static_cast<int>(contr_seq_content.size()),MPI_UNSIGNED,MPI_SUM,
+                      process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ errc = MPI_Allreduce(MPI_IN_PLACE,contr_seq_flops.data(),num_networks,MPI_DOUBLE,MPI_SUM,
+                      process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ getCommProfile().record(CommProfile::CommKind::SEQ_ALLREDUCE,process_group.getMPICommProxy(),-1,
+                         proc_costs.size() * sizeof(ProcCost) + contr_seq_content.size() * sizeof(unsigned int) +
+                         contr_seq_flops.size() * sizeof(double),exatn::Timer::timeInSecHR(comm_start));
+ for(int i = 0; i < num_networks; ++i){
+  if(proc_costs[i].rank != static_cast<int>(local_rank)){
+   synced[i]->importContractionSequence(std::vector<unsigned int>(contr_seq_content.cbegin()+offsets[i],
+                                                                  contr_seq_content.cbegin()+offsets[i+1]),
+                                        contr_seq_flops[i]);
+  }
+ }
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Found the optimal contraction sequences of " << num_networks
+                           << " tensor networks across all processes" << std::endl;
+#endif
+ return;
+}
+
+bool NumServer::submit(const ProcessGroup & process_group,
+                       TensorNetwork & network)
+{
+#ifdef CUQUANTUM
+ if(comp_backend_ == "cuquantum" || comp_backend_ == "auto"){
+  auto sh_network = std::shared_ptr<TensorNetwork>(&network,[](TensorNetwork * net_ptr){});
+  return submit(process_group,sh_network);
+ }
+#endif
+ std::size_t memo_hash = 0;
+ NetworkMemo memo;
+ if(lookupNetworkMemo(process_group,network,&memo_hash,memo)) return true; //output tensor already holds the result
+ bool submitted = submitNetwork(process_group,network,false);
+ if(submitted) recordNetworkMemo(network,memo_hash,std::move(memo));
+ return submitted;
+}
+
+bool NumServer::lookupNetworkMemo(const ProcessGroup & process_group,
+                                  const TensorNetwork & network,
+                                  std::size_t * hash,
+                                  NetworkMemo & memo)
+{
+ *hash = 0;
+ memo.structure.clear();
+ memo.versions.clear();
+ if(!network_memoization_ || dry_run_ || !process_group.rankIsIn(process_rank_)) return false;
+ //Compose the exact structure of the tensor network (in the order of tensor ids):
+ std::vector<std::pair<unsigned int,const numerics::TensorConn*>> tensors;
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter) tensors.emplace_back(std::make_pair(iter->first,&(iter->second)));
+ std::sort(tensors.begin(),tensors.end());
+ bool memoizable = true;
+ for(const auto & entry: tensors){
+  const auto tensor_id = entry.first;
+  const auto * tensor_conn = entry.second;
+  const auto & tensor = *(tensor_conn->getTensor());
+  memo.structure.emplace_back(tensor_id);
+  memo.structure.emplace_back(static_cast<std::uint64_t>(tensor.getTensorHash()));
+  memo.structure.emplace_back(tensor_conn->isComplexConjugated() ? 1 : 0);
+  const auto & legs = tensor_conn->getTensorLegs();
+  memo.structure.emplace_back(legs.size());
+  for(const auto & leg: legs){
+   memo.structure.emplace_back(leg.getTensorId());
+   memo.structure.emplace_back(leg.getDimensionId());
+   memo.structure.emplace_back(static_cast<std::uint64_t>(leg.getDirection()));
+  }
+  if(tensor_id != 0){ //input tensor
+   const auto version = runtime::TensorExecState::getTensorVersion(tensor);
+   if(version == 0) memoizable = false; //input tensor has never been written
+   memo.versions.emplace_back(version);
+  }
+ }
+ if(!memoizable){
+  memo.structure.clear();
+  memo.versions.clear();
+ }
+ std::size_t structural_hash = memo.structure.size();
+ for(const auto & item: memo.structure) structural_hash ^= std::hash<std::uint64_t>{}(item) + 0x9e3779b9 + (structural_hash << 6) + (structural_hash >> 2);
+ *hash = structural_hash;
+ //Check whether the output tensor still holds the result of the memoized evaluation:
+ int hit = 0;
+ if(memoizable){
+  auto memo_iter = network_memos_.find(structural_hash);
+  if(memo_iter != network_memos_.cend()){
+   const auto & memoized = memo_iter->second;
+   auto output_tensor = network.getTensor(0);
+   auto output_iter = tensors_.find(output_tensor->getNameId());
+   if(output_iter != tensors_.cend() && output_iter->second == output_tensor &&
+      memoized.structure == memo.structure && memoized.versions == memo.versions &&
+      memoized.output_version == runtime::TensorExecState::getTensorVersion(*output_tensor)) hit = 1;
+  }
+ }
+#ifdef MPI_ENABLED
+ if(process_group.getSize() > 1){ //all processes must agree (the evaluation is collective)
+  auto errc = MPI_Allreduce(MPI_IN_PLACE,&hit,1,MPI_INT,MPI_MIN,process_group.getMPICommProxy().getRef<MPI_Comm>());
+  assert(errc == MPI_SUCCESS);
+ }
+#endif
+ if(hit != 0){
+  ++network_memo_hits_;
+  if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                            << "]: Skipped the evaluation of tensor network <" << network.getName() << "> ("
+                            << network.getTensor(0)->getName() << "): Input tensors have not changed" << std::endl << std::flush;
+ }
+ return (hit != 0);
+}
+
+void NumServer::recordNetworkMemo(const TensorNetwork & network,
+                                  std::size_t hash,
+                                  NetworkMemo && memo)
+{
+ if(memo.structure.empty()) return; //not memoizable
+ memo.output_version = runtime::TensorExecState::getTensorVersion(*(network.getTensor(0)));
+ if(network_memos_.size() >= MAX_NETWORK_MEMOS && network_memos_.find(hash) == network_memos_.cend()) network_memos_.clear();
+ network_memos_[hash] = std::move(memo);
+ return;
+}
+
+bool NumServer::submitNetwork(const ProcessGroup & process_group,
+                              TensorNetwork & network,
+                              bool contr_seq_synced,
+                              std::shared_ptr<Tensor> accumulator,
+                              std::complex<double> coefficient,
+                              int executing_rank)
+{
+ const bool debugging = false;
+ const bool serialize = false;
+
+ //Determine parallel execution configuration:
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ //assert(network.isValid()); //debug
+ unsigned int num_procs = process_group.getSize(); //number of executing processes
+ assert(local_rank < num_procs);
+ //Destroy the implicit tensors which are no longer referenced (early garbage collection):
+ if(active_capture_ == nullptr) destroyOrphanedTensors();
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Submitting tensor network <" << network.getName() << "> (" << network.getTensor(0)->getName()
+                           << ") for execution by " << num_procs << " processes with memory limit "
+                           << process_group.getMemoryLimitPerProcess() << " bytes" << std::endl << std::flush;
+ if(logging_ > 0) network.printItFile(logfile_);
+
+ const std::size_t proc_mem_volume = process_group.getMemoryLimitPerProcess() / sizeof(std::complex<double>);
+
+ //Determine the pseudo-optimal tensor contraction sequence:
+ determineContractionSequence(process_group,network,!contr_seq_synced);
 
  //Generate the primitive tensor operation list:
  auto tensor_mapper = getTensorMapper(process_group);
  auto & op_list = network.getOperationList(contr_seq_optimizer_,(num_procs > 1));
- if(contr_seq_caching_ && new_contr_seq) ContractionSeqOptimizer::cacheContractionSequence(network);
  const double max_intermediate_presence_volume = network.getMaxIntermediatePresenceVolume();
+ const double intermediate_workspace_volume = network.getIntermediateWorkspaceVolume(); //statically planned
  unsigned int max_intermediate_rank = 0;
  double max_intermediate_volume = network.getMaxIntermediateVolume(&max_intermediate_rank);
  if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                            << "]: Contraction info: FMA flop count = " << std::scientific << network.getFMAFlops()
                            << "; Max intermediate presence volume = " << max_intermediate_presence_volume
+                           << "; Planned intermediate workspace volume = " << intermediate_workspace_volume
                            << "; Max intermediate rank = " << max_intermediate_rank
                            << " with volume " << max_intermediate_volume << " -> ";
 
  //Split some of the tensor network indices based on the requested memory limit:
- const std::size_t proc_mem_volume = process_group.getMemoryLimitPerProcess() / sizeof(std::complex<double>);
+ double presence_shrink_coef = 1.0; //expected reduction of the max intermediate presence volume due to slicing
  if(max_intermediate_presence_volume > 0.0 && max_intermediate_volume > 0.0){
+  //The statically planned workspace already accounts for the placement of intermediates,
+  //thus no fragmentation allowance is needed when the plan is available:
+  const bool planned = (intermediate_workspace_volume >= max_intermediate_presence_volume);
+  const double frag_coef = planned ? 1.0 : getMemoryFragmentationFactor();
+  const double footprint = planned ? intermediate_workspace_volume : max_intermediate_presence_volume;
+  if(logging_ > 0) logfile_ << "(memory fragmentation factor " << frag_coef << ") ";
+  const double buffer_coef = slice_double_buffering_ ? (1.0 - SLICE_DOUBLE_BUFFER_FRACTION) : 1.0; //memory reserved for staging the next input slices
+  const double contr_mem_coef = tensor_rt_->getContractionMemoryFactor(); //{2.0:tensor transpose, 1.0:direct kernels}
   const double shrink_coef = std::min(1.0,
-   static_cast<double>(proc_mem_volume) / (max_intermediate_presence_volume * 1.5 * 2.0)); //{1.5:memory fragmentation}; {2.0:tensor transpose}
+   static_cast<double>(proc_mem_volume) * buffer_coef / (footprint * frag_coef * contr_mem_coef));
   max_intermediate_volume *= shrink_coef;
+  presence_shrink_coef = shrink_coef;
  }
  if(logging_ > 0) logfile_ << max_intermediate_volume << " (after slicing)" << std::endl << std::flush;
  //if(max_intermediate_presence_volume > 0.0 && max_intermediate_volume > 0.0)
  network.splitIndices(static_cast<std::size_t>(max_intermediate_volume));
  if(logging_ > 0) network.printSplitIndexInfo(logfile_,logging_ > 1);
 
- //Create the output tensor of the tensor network if needed:
+ //Track the predicted memory usage of the tensor network in the memory timeline (if active):
+ auto * memory_timeline = tensor_rt_->getMemoryTimeline();
+ const bool track_memory = (memory_timeline != nullptr && memory_timeline->isActive());
+ const auto prior_op = last_submitted_op_;
+ const double submission_start = exatn::Timer::timeInSecHR();
+
+ //Create the output tensor of the tensor network if needed (unless accumulated directly):
  bool submitted = false;
  auto output_tensor = network.getTensor(0);
- auto iter = tensors_.find(output_tensor->getName());
- if(iter == tensors_.end()){ //output tensor does not exist and needs to be created
-  implicit_tensors_.emplace(std::make_pair(output_tensor->getName(),output_tensor)); //list of implicitly created tensors (for garbage collection)
+ auto target_tensor = accumulator ? accumulator : output_tensor; //tensor which the tensor network result goes into
+ auto iter = tensors_.find(output_tensor->getNameId());
+ if(!accumulator && iter == tensors_.end()){ //output tensor does not exist and needs to be created
+  {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); implicit_tensors_.emplace(std::make_pair(output_tensor->getName(),output_tensor));} //list of implicitly created tensors (for garbage collection)
   if(!(process_group == getDefaultProcessGroup())){
-   auto saved = tensor_comms_.emplace(std::make_pair(output_tensor->getName(),process_group));
+   auto saved = tensor_comms_.emplace(std::make_pair(output_tensor->getNameId(),process_group));
    assert(saved.second);
   }
   //Create output tensor:
@@ -759,12 +2193,21 @@ bool NumServer::submit(const ProcessGroup & process_group,
   submitted = submit(op0,tensor_mapper); if(!submitted) return false; //this CREATE operation will also register the output tensor
  }
 
- //Initialize the output tensor to zero:
- std::shared_ptr<TensorOperation> op1 = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
- op1->setTensorOperand(output_tensor);
- std::dynamic_pointer_cast<numerics::TensorOpTransform>(op1)->
-  resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
- submitted = submit(op1,tensor_mapper); if(!submitted) return false;
+ //Initialize the output tensor to zero (unless accumulated directly):
+ if(!accumulator){
+  std::shared_ptr<TensorOperation> op1 = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+  op1->setTensorOperand(output_tensor);
+  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op1)->
+   resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
+  submitted = submit(op1,tensor_mapper); if(!submitted) return false;
+ }
+
+ //Redirects the tensor operation writing into the output tensor to the accumulator (scaled accumulation):
+ auto redirect_output = [&](TensorOperation & op){
+  op.setScalar(0,op.getScalar(0)*coefficient);
+  op.setCommutativeAccumulation(true);
+  return;
+ };
 
  //Submit all tensor operations for tensor network evaluation:
  std::size_t num_tens_ops_in_fly = 0;
@@ -777,9 +2220,209 @@ bool NumServer::submit(const ProcessGroup & process_group,
   for(int i = 0; i < num_split_indices; ++i) work_extents[i] = network.getSplitIndexInfo(i).second.size(); //number of segments per split index
   numerics::TensorRange work_range(work_extents); //each range dimension refers to the number of segments per the corresponding split index
   bool not_done = true;
+  const bool dynamic_scheduling = (dynamic_slice_scheduling_ && num_procs > 1);
+  DimOffset chunk_left = 0; //number of tensor sub-networks left in the current chunk (dynamic scheduling)
+#ifdef MPI_ENABLED
+  //Dynamic scheduling: Chunks of tensor sub-networks are self-scheduled via a shared counter (hosted by the first process):
+  MPI_Win slice_win;
+  long long int * slice_counter = nullptr;
+  const long long int total_slices = work_range.localVolume();
+  const long long int slice_chunk = std::max(1LL,total_slices/static_cast<long long int>(num_procs*DYNAMIC_SLICE_CHUNKS));
+  auto fetch_chunk = [&](){
+   long long int first_slice = 0;
+   auto errc = MPI_Fetch_and_op(&slice_chunk,&first_slice,MPI_LONG_LONG,0,0,MPI_SUM,slice_win); assert(errc == MPI_SUCCESS);
+   errc = MPI_Win_flush(0,slice_win); assert(errc == MPI_SUCCESS);
+   if(first_slice >= total_slices) return false;
+   work_range.reset(static_cast<DimOffset>(first_slice));
+   chunk_left = std::min(slice_chunk,total_slices-first_slice);
+   return true;
+  };
+  if(dynamic_scheduling){
+   auto & mpi_comm = process_group.getMPICommProxy().getRef<MPI_Comm>();
+   const MPI_Aint win_size = (local_rank == 0) ? sizeof(long long int) : 0;
+   auto errc = MPI_Win_allocate(win_size,sizeof(long long int),MPI_INFO_NULL,mpi_comm,&slice_counter,&slice_win);
+   assert(errc == MPI_SUCCESS);
+   if(local_rank == 0) *slice_counter = 0;
+   errc = MPI_Barrier(mpi_comm); assert(errc == MPI_SUCCESS);
+   errc = MPI_Win_lock_all(MPI_MODE_NOCHECK,slice_win); assert(errc == MPI_SUCCESS);
+   not_done = fetch_chunk();
+  }else
+#endif
   if(num_procs > 1) not_done = work_range.reset(num_procs,local_rank); //work subrange for the current local process rank (may be empty)
   if(logging_ > 0) logfile_ << "Total number of sub-networks = " << work_range.localVolume()
                             << "; Current process has a share (0/1) = " << not_done << std::endl << std::flush;
+  //Find the split tensor info of a tensor operand (nullptr if the tensor operand has no split indices):
+  auto getOperandSplitInfo = [&](const TensorOperation & op, unsigned int op_num){
+   auto tensor = op.getTensorOperand(op_num);
+   bool tensor_is_output;
+   bool tensor_is_intermediate = tensorNameIsIntermediate(*tensor,&tensor_is_output);
+   tensor_is_output = (tensor == output_tensor);
+   std::pair<numerics::TensorHashType,numerics::TensorHashType> key;
+   if(tensor_is_intermediate || tensor_is_output){ //intermediate tensor (including output tensor)
+    numerics::TensorHashType zero = 0;
+    key = std::make_pair(zero,tensor->getTensorHash());
+   }else{ //input tensor
+    numerics::TensorHashType pos = op_num;
+    key = std::make_pair(op.getTensorOpHash(),pos);
+   }
+   return network.getSplitTensorInfo(key);
+  };
+  //Classify the tensor operations by their dependence on the split indices:
+  // Slice-invariant intermediates (computed without any split index) are only computed
+  // on the first tensor sub-network and are kept alive until all tensor sub-networks are done:
+  std::unordered_set<numerics::TensorHashType> invariant_intermediates; //slice-invariant intermediate tensors
+  std::unordered_set<numerics::TensorHashType> retained_intermediates;  //slice-invariant intermediate tensors consumed by slice-dependent operations
+  std::vector<std::shared_ptr<Tensor>> retained_tensors;
+  std::vector<bool> invariant_ops; //slice-invariant tensor operations (executed on the first tensor sub-network only)
+  for(auto op = op_list.cbegin(); op != op_list.cend(); ++op){
+   bool invariant = false;
+   if((*op)->getOpcode() == TensorOpCode::CONTRACT && (*op)->getTensorOperand(0) != output_tensor){
+    invariant = true;
+    for(unsigned int op_num = 0; op_num < (*op)->getNumOperands(); ++op_num){
+     if(getOperandSplitInfo(**op,op_num) != nullptr){invariant = false; break;}
+     if(op_num > 0){
+      auto tensor = (*op)->getTensorOperand(op_num);
+      if(tensorNameIsIntermediate(*tensor) &&
+         invariant_intermediates.find(tensor->getTensorHash()) == invariant_intermediates.end()){invariant = false; break;}
+     }
+    }
+    if(invariant) invariant_intermediates.emplace((*op)->getTensorOperand(0)->getTensorHash());
+   }
+   if(!invariant && (*op)->getOpcode() == TensorOpCode::CONTRACT){
+    for(unsigned int op_num = 1; op_num < (*op)->getNumOperands(); ++op_num){
+     auto tensor = (*op)->getTensorOperand(op_num);
+     if(invariant_intermediates.find(tensor->getTensorHash()) != invariant_intermediates.end()){
+      if(retained_intermediates.emplace(tensor->getTensorHash()).second) retained_tensors.emplace_back(tensor);
+     }
+    }
+   }
+  }
+  double retained_volume = 0.0;
+  for(const auto & tensor: retained_tensors) retained_volume += static_cast<double>(tensor->getVolume());
+  if(work_range.localVolume() < 2 || retained_volume > static_cast<double>(proc_mem_volume) * SLICE_INVARIANT_MEMORY_FRACTION){
+   invariant_intermediates.clear(); //not enough memory to keep the slice-invariant intermediates: Recompute them
+   retained_intermediates.clear();
+   retained_tensors.clear();
+  }
+  for(auto op = op_list.cbegin(); op != op_list.cend(); ++op){
+   const auto tensor = (*op)->getTensorOperand(0);
+   const bool invariant = (tensor != output_tensor) &&
+                          (invariant_intermediates.find(tensor->getTensorHash()) != invariant_intermediates.end());
+   invariant_ops.emplace_back(invariant);
+  }
+  if(logging_ > 0) logfile_ << "Number of slice-invariant intermediates = " << invariant_intermediates.size()
+                            << " (retained " << retained_tensors.size() << " with volume " << retained_volume << ")"
+                            << std::endl << std::flush;
+  bool first_subnetwork = true; //the slice-invariant intermediates are computed on the first tensor sub-network
+  //Tensor slices and per-slice tensor operations are allocated in an object arena (freed in bulk once retired):
+  auto slice_arena = numerics::ObjectArena::create();
+  const numerics::ArenaAllocator<numerics::Tensor> slice_allocator(slice_arena);
+  const numerics::ArenaAllocator<TensorOperation> op_allocator(slice_arena);
+  const std::shared_ptr<TensorOperation> create_proto = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+  const std::shared_ptr<TensorOperation> slice_proto = tensor_op_factory_->createTensorOp(TensorOpCode::SLICE);
+  const std::shared_ptr<TensorOperation> insert_proto = tensor_op_factory_->createTensorOp(TensorOpCode::INSERT);
+  const std::shared_ptr<TensorOperation> destroy_proto = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+  //Create a slice of a tensor operand for a given tensor sub-network:
+  auto createOperandSlice = [&](const Tensor & tensor,
+                                const std::vector<std::pair<unsigned int,unsigned int>> & tensor_info,
+                                const numerics::TensorRange & range){
+   const auto tensor_rank = tensor.getRank();
+   //Import original subspaces and dimension extents from the parental tensor:
+   std::vector<SubspaceId> subspaces(tensor_rank);
+   for(unsigned int i = 0; i < tensor_rank; ++i) subspaces[i] = tensor.getDimSubspaceId(i);
+   std::vector<DimExtent> dim_extents(tensor_rank);
+   for(unsigned int i = 0; i < tensor_rank; ++i) dim_extents[i] = tensor.getDimExtent(i);
+   //Replace the sliced dimensions with their updated subspaces and dimension extents:
+   for(const auto & index_desc: tensor_info){
+    const auto gl_index_id = index_desc.first;
+    const auto index_pos = index_desc.second;
+    const auto & index_info = network.getSplitIndexInfo(gl_index_id);
+    const auto segment_selector = range.getIndex(gl_index_id);
+    subspaces[index_pos] = index_info.second[segment_selector].first;
+    dim_extents[index_pos] = index_info.second[segment_selector].second;
+    if(logging_ > 1) logfile_ << "Index replacement in tensor " << tensor.getName()
+     << ": " << index_info.first << " in position " << index_pos << std::endl;
+   }
+   //Construct the tensor slice from the parental tensor:
+   auto tensor_slice = tensor.createSubtensor(subspaces,dim_extents,slice_allocator);
+   tensor_slice->rename(); //unique automatic name will be generated
+   return tensor_slice;
+  };
+  //Double buffering: The input tensor slices of the next tensor sub-network are created and extracted
+  //ahead of the tensor operations of the current one, thus overlapping with them in the tensor runtime:
+  using StagedSlices = std::map<std::pair<std::size_t,unsigned int>,std::shared_ptr<numerics::Tensor>>; //{op id, operand} --> input slice
+  auto stageInputSlices = [&](const numerics::TensorRange & range, StagedSlices & staged){
+   double staged_volume = 0.0;
+   std::size_t op_id = 0;
+   for(auto op = op_list.cbegin(); op != op_list.cend(); ++op, ++op_id){
+    if(invariant_ops[op_id]) continue;
+    for(unsigned int op_num = 1; op_num < (*op)->getNumOperands(); ++op_num){
+     auto tensor = (*op)->getTensorOperand(op_num);
+     if(tensor == output_tensor || tensorNameIsIntermediate(*tensor)) continue;
+     const auto * tensor_info = getOperandSplitInfo(**op,op_num);
+     if(tensor_info == nullptr) continue;
+     auto tensor_slice = createOperandSlice(*tensor,*tensor_info,range);
+     std::shared_ptr<TensorOperation> create_slice = create_proto->clone(op_allocator);
+     create_slice->setTensorOperand(tensor_slice);
+     std::dynamic_pointer_cast<numerics::TensorOpCreate>(create_slice)->resetTensorElementType(tensor->getElementType());
+     submitted = submit(create_slice,tensor_mapper); if(!submitted) return -1.0;
+     std::shared_ptr<TensorOperation> extract_slice = slice_proto->clone(op_allocator);
+     extract_slice->setTensorOperand(tensor_slice);
+     extract_slice->setTensorOperand(tensor);
+     std::dynamic_pointer_cast<numerics::TensorOpSlice>(extract_slice)->resetReadOnly(true); //input slice
+     submitted = submit(extract_slice,tensor_mapper); if(!submitted) return -1.0;
+     num_tens_ops_in_fly += 2;
+     staged_volume += static_cast<double>(tensor_slice->getVolume());
+     staged.emplace(std::make_pair(std::make_pair(op_id,op_num),tensor_slice));
+    }
+   }
+   return staged_volume;
+  };
+  bool double_buffering = slice_double_buffering_;
+  StagedSlices current_staged, next_staged;
+  if(double_buffering && not_done){
+   const auto staged_volume = stageInputSlices(work_range,current_staged); if(staged_volume < 0.0) return false;
+   if(staged_volume > static_cast<double>(proc_mem_volume) * SLICE_DOUBLE_BUFFER_FRACTION){
+    double_buffering = false; //not enough memory reserved for the second buffer: No look-ahead
+    if(logging_ > 0) logfile_ << "Double buffering of input slices disabled: Staged volume " << staged_volume
+                              << " exceeds the reserved memory" << std::endl << std::flush;
+   }
+  }
+  //Hybrid execution: Tensor sub-networks are assigned to Host in proportion to the calibrated Host share,
+  //the throughput of each device class being measured on its completed tensor sub-networks:
+  const bool hybrid_execution = hybrid_slice_execution_;
+  double host_credit = 0.0; //accumulated Host share (the next tensor sub-network goes to Host once it reaches one)
+  struct PendingSubnetwork{
+   TensorOpDevice device;                     //execution device class of the tensor sub-network
+   double flops;                              //Flop count of the tensor sub-network
+   std::shared_ptr<TensorOperation> first_op; //first tensor contraction of the tensor sub-network
+   std::shared_ptr<TensorOperation> last_op;  //last tensor contraction of the tensor sub-network
+  };
+  std::list<PendingSubnetwork> pending_subnetworks; //submitted tensor sub-networks awaiting their throughput measurement
+  double host_last_finish = 0.0, accel_last_finish = 0.0; //completion time of the last measured tensor sub-network per device class
+  auto calibrateHybridShare = [&](bool completed){ //completed: all submitted tensor operations are known to be completed
+   auto subnet = pending_subnetworks.begin();
+   while(subnet != pending_subnetworks.end()){
+    if(!completed && !sync(*(subnet->last_op),false)){++subnet; continue;}
+    const bool on_host = (subnet->device == TensorOpDevice::HOST);
+    double & last_finish = on_host ? host_last_finish : accel_last_finish;
+    double & rate = on_host ? host_slice_rate_ : accel_slice_rate_;
+    const double finish = subnet->last_op->getFinishTime();
+    const double interval = finish - std::max(subnet->first_op->getStartTime(),last_finish); //sub-networks of the same class overlap
+    last_finish = std::max(last_finish,finish);
+    if(interval > 0.0){
+     const double measured = subnet->flops / interval;
+     rate = (rate > 0.0) ? ((1.0 - HYBRID_RATE_SMOOTHING) * rate + HYBRID_RATE_SMOOTHING * measured) : measured;
+    }
+    subnet = pending_subnetworks.erase(subnet);
+   }
+   if(host_slice_rate_ > 0.0 && accel_slice_rate_ > 0.0){ //both device classes finish their shares at the same time
+    const double share = host_slice_rate_ / (host_slice_rate_ + accel_slice_rate_);
+    host_slice_share_ = (share < HYBRID_HOST_SHARE_MIN) ? HYBRID_HOST_SHARE_MIN :
+                        ((share > HYBRID_HOST_SHARE_MAX) ? HYBRID_HOST_SHARE_MAX : share);
+   }
+   return;
+  };
   //Each process executes its share of tensor sub-networks:
   while(not_done){
    if(logging_ > 1){
@@ -789,19 +2432,49 @@ bool NumServer::submit(const ProcessGroup & process_group,
    }
    std::unordered_map<numerics::TensorHashType,std::shared_ptr<numerics::Tensor>> intermediate_slices; //temporary slices of intermediates
    std::list<std::shared_ptr<numerics::Tensor>> input_slices; //temporary slices of input tensors
+   PendingSubnetwork subnetwork{TensorOpDevice::ANY,0.0,nullptr,nullptr};
+   bool subnetwork_measurable = true; //composite tensor contractions are not measured
+   if(hybrid_execution){
+    host_credit += host_slice_share_;
+    if(host_credit >= 1.0){
+     host_credit -= 1.0;
+     subnetwork.device = TensorOpDevice::HOST;
+    }else{
+     subnetwork.device = TensorOpDevice::ACCELERATOR;
+    }
+   }
+   beginBatch(); //tensor operations of the tensor sub-network are submitted to the tensor runtime in batches
+   //Stage the input tensor slices of the next tensor sub-network (double buffering):
+   if(double_buffering){
+    numerics::TensorRange next_range(work_range);
+    bool next_exists = false;
+    if(dynamic_scheduling){
+     next_exists = (chunk_left > 1) && next_range.next();
+    }else{
+     next_exists = next_range.next();
+    }
+    if(next_exists){
+     const auto staged_volume = stageInputSlices(next_range,next_staged); if(staged_volume < 0.0){endBatch(); return false;}
+    }
+   }
    //Execute all tensor operations for the current tensor sub-network:
-   for(auto op = op_list.begin(); op != op_list.end(); ++op){
+   std::size_t op_id = 0;
+   for(auto op = op_list.begin(); op != op_list.end(); ++op, ++op_id){
+    if(invariant_ops[op_id]){ //slice-invariant tensor operation
+     if(!first_subnetwork) continue;
+     if((*op)->getOpcode() == TensorOpCode::DESTROY &&
+        retained_intermediates.find((*op)->getTensorOperand(0)->getTensorHash()) != retained_intermediates.end()) continue;
+    }
     if(debugging && logging_ > 1){ //debug
      logfile_ << "Next tensor operation from the tensor network operation list:" << std::endl;
      (*op)->printItFile(logfile_);
     }
     const auto num_operands = (*op)->getNumOperands();
-    std::shared_ptr<TensorOperation> tens_op = (*op)->clone();
+    std::shared_ptr<TensorOperation> tens_op = (*op)->clone(op_allocator);
     //Substitute sliced tensor operands with their respective slices from the current tensor sub-network:
     std::shared_ptr<numerics::Tensor> output_tensor_slice;
     for(unsigned int op_num = 0; op_num < num_operands; ++op_num){
      auto tensor = (*op)->getTensorOperand(op_num);
-     const auto tensor_rank = tensor->getRank();
      if(debugging && logging_ > 1){ //debug
       logfile_ << "Next tensor operand " << op_num << " named " << tensor->getName();
      }
@@ -809,45 +2482,27 @@ bool NumServer::submit(const ProcessGroup & process_group,
      bool tensor_is_intermediate = tensorNameIsIntermediate(*tensor,&tensor_is_output);
      tensor_is_output = (tensor == output_tensor);
      //Look up the tensor operand in the table of sliced tensor operands:
-     std::pair<numerics::TensorHashType,numerics::TensorHashType> key;
-     if(tensor_is_intermediate || tensor_is_output){ //intermediate tensor (including output tensor)
-      numerics::TensorHashType zero = 0;
-      key = std::make_pair(zero,tensor->getTensorHash());
-     }else{ //input tensor
-      numerics::TensorHashType pos = op_num;
-      key = std::make_pair((*op)->getTensorOpHash(),pos);
-     }
-     const auto * tensor_info = network.getSplitTensorInfo(key);
+     const auto * tensor_info = getOperandSplitInfo(**op,op_num);
      //Replace the full tensor operand with its respective slice (if found):
      if(tensor_info != nullptr){ //tensor has splitted indices
       if(debugging && logging_ > 1) logfile_ << " with split indices" << std::endl; //debug
       std::shared_ptr<numerics::Tensor> tensor_slice;
+      bool slice_staged = false; //input tensor slice has already been staged (double buffering)
       //Look up the tensor slice in case it has already been created:
       if(tensor_is_intermediate && (!tensor_is_output)){ //pure intermediate tensor
        auto slice_iter = intermediate_slices.find(tensor->getTensorHash()); //look up by the hash of the parental tensor
        if(slice_iter != intermediate_slices.end()) tensor_slice = slice_iter->second;
+      }else if(!tensor_is_output){ //input tensor
+       auto slice_iter = current_staged.find(std::make_pair(op_id,op_num));
+       if(slice_iter != current_staged.end()){
+        tensor_slice = slice_iter->second;
+        input_slices.emplace_back(tensor_slice);
+        slice_staged = true;
+       }
       }
       //Create the tensor slice upon first encounter:
       if(!tensor_slice){
-       //Import original subspaces and dimension extents from the parental tensor:
-       std::vector<SubspaceId> subspaces(tensor_rank);
-       for(unsigned int i = 0; i < tensor_rank; ++i) subspaces[i] = tensor->getDimSubspaceId(i);
-       std::vector<DimExtent> dim_extents(tensor_rank);
-       for(unsigned int i = 0; i < tensor_rank; ++i) dim_extents[i] = tensor->getDimExtent(i);
-       //Replace the sliced dimensions with their updated subspaces and dimension extents:
-       for(const auto & index_desc: *tensor_info){
-        const auto gl_index_id = index_desc.first;
-        const auto index_pos = index_desc.second;
-        const auto & index_info = network.getSplitIndexInfo(gl_index_id);
-        const auto segment_selector = work_range.getIndex(gl_index_id);
-        subspaces[index_pos] = index_info.second[segment_selector].first;
-        dim_extents[index_pos] = index_info.second[segment_selector].second;
-        if(logging_ > 1) logfile_ << "Index replacement in tensor " << tensor->getName()
-         << ": " << index_info.first << " in position " << index_pos << std::endl;
-       }
-       //Construct the tensor slice from the parental tensor:
-       tensor_slice = tensor->createSubtensor(subspaces,dim_extents);
-       tensor_slice->rename(); //unique automatic name will be generated
+       tensor_slice = createOperandSlice(*tensor,*tensor_info,work_range);
        //Store the tensor in the table for subsequent referencing:
        if(tensor_is_intermediate && (!tensor_is_output)){ //pure intermediate tensor
         auto res = intermediate_slices.emplace(std::make_pair(tensor->getTensorHash(),tensor_slice));
@@ -859,13 +2514,13 @@ bool NumServer::submit(const ProcessGroup & process_group,
       //Replace the sliced tensor operand with its current slice in the primary tensor operation:
       bool replaced = tens_op->resetTensorOperand(op_num,tensor_slice); assert(replaced);
       //Allocate the input/output tensor slice and extract its contents (not for intermediates):
-      if(!tensor_is_intermediate || tensor_is_output){ //input/output tensor: create slice and extract its contents
+      if((!tensor_is_intermediate || tensor_is_output) && !slice_staged){ //input/output tensor: create slice and extract its contents
        //Create an empty slice of the input/output tensor:
-       std::shared_ptr<TensorOperation> create_slice = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+       std::shared_ptr<TensorOperation> create_slice = create_proto->clone(op_allocator);
        create_slice->setTensorOperand(tensor_slice);
        std::dynamic_pointer_cast<numerics::TensorOpCreate>(create_slice)->
         resetTensorElementType(tensor->getElementType());
-       submitted = submit(create_slice,tensor_mapper); if(!submitted) return false;
+       submitted = submit(create_slice,tensor_mapper); if(!submitted){endBatch(); return false;}
        ++num_tens_ops_in_fly;
        //Extract the slice contents from the input/output tensor:
        if(tensor_is_output){ //make sure the output tensor slice only shows up once
@@ -873,63 +2528,158 @@ bool NumServer::submit(const ProcessGroup & process_group,
         assert(!output_tensor_slice);
         output_tensor_slice = tensor_slice;
        }
-       std::shared_ptr<TensorOperation> extract_slice = tensor_op_factory_->createTensorOp(TensorOpCode::SLICE);
+       std::shared_ptr<TensorOperation> extract_slice = slice_proto->clone(op_allocator);
        extract_slice->setTensorOperand(tensor_slice);
-       extract_slice->setTensorOperand(tensor);
-       submitted = submit(extract_slice,tensor_mapper); if(!submitted) return false;
+       extract_slice->setTensorOperand(tensor_is_output ? target_tensor : tensor);
+       if(!tensor_is_output) std::dynamic_pointer_cast<numerics::TensorOpSlice>(extract_slice)->resetReadOnly(true);
+       submitted = submit(extract_slice,tensor_mapper); if(!submitted){endBatch(); return false;}
        ++num_tens_ops_in_fly;
       }
      }else{
       if(debugging && logging_ > 1) logfile_ << " without split indices" << std::endl; //debug
+      if(tensor_is_output && accumulator){
+       bool replaced = tens_op->resetTensorOperand(op_num,accumulator); assert(replaced);
+      }
      }
+     if(tensor_is_output && accumulator) redirect_output(*tens_op);
     } //loop over tensor operands
+    //Place the slice-dependent tensor contractions on the device class of the tensor sub-network:
+    if(hybrid_execution && !invariant_ops[op_id] && tens_op->getOpcode() == TensorOpCode::CONTRACT){
+     tens_op->setExecutionDevice(subnetwork.device);
+     if(tens_op->isComposite()){
+      subnetwork_measurable = false;
+     }else{
+      subnetwork.flops += tens_op->getFlopEstimate();
+      if(!subnetwork.first_op) subnetwork.first_op = tens_op;
+      subnetwork.last_op = tens_op;
+     }
+    }
     //Submit the primary tensor operation with the current slices:
-    submitted = submit(tens_op,tensor_mapper); if(!submitted) return false;
+    submitted = submit(tens_op,tensor_mapper); if(!submitted){endBatch(); return false;}
     ++num_tens_ops_in_fly;
     //Insert the output tensor slice back into the output tensor:
     if(output_tensor_slice){
-     std::shared_ptr<TensorOperation> insert_slice = tensor_op_factory_->createTensorOp(TensorOpCode::INSERT);
-     insert_slice->setTensorOperand(output_tensor);
+     std::shared_ptr<TensorOperation> insert_slice = insert_proto->clone(op_allocator);
+     insert_slice->setTensorOperand(target_tensor);
      insert_slice->setTensorOperand(output_tensor_slice);
-     submitted = submit(insert_slice,tensor_mapper); if(!submitted) return false;
+     submitted = submit(insert_slice,tensor_mapper); if(!submitted){endBatch(); return false;}
      ++num_tens_ops_in_fly;
      output_tensor_slice.reset();
     }
     //Destroy temporary input tensor slices:
     for(auto & input_slice: input_slices){
-     std::shared_ptr<TensorOperation> destroy_slice = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+     std::shared_ptr<TensorOperation> destroy_slice = destroy_proto->clone(op_allocator);
      destroy_slice->setTensorOperand(input_slice);
-     submitted = submit(destroy_slice,tensor_mapper); if(!submitted) return false;
+     submitted = submit(destroy_slice,tensor_mapper); if(!submitted){endBatch(); return false;}
      ++num_tens_ops_in_fly;
     }
-    if(serialize || num_tens_ops_in_fly > exatn::runtime::TensorRuntime::MAX_RUNTIME_DAG_SIZE){
+    if(serialize){
+     endBatch();
      sync(process_group);
+     if(hybrid_execution) calibrateHybridShare(true);
+     beginBatch();
+     num_tens_ops_in_fly = 0;
+    }else if(num_tens_ops_in_fly > exatn::runtime::TensorRuntime::MAX_RUNTIME_DAG_SIZE){
+     endBatch();
+     if(tensor_rt_->reclaimsExecutedNodes()){ //DAG size is bounded by node reclamation: Only limit the number of operations in flight
+      tensor_rt_->throttle();
+     }else if(dynamic_scheduling){ //processes execute different numbers of tensor sub-networks: Local synchronization only
+      tensor_rt_->sync();
+      if(hybrid_execution) calibrateHybridShare(true); //the executed DAG may have been cleared
+     }else{
+      sync(process_group);
+      if(hybrid_execution) calibrateHybridShare(true); //the executed DAG may have been cleared
+     }
+     beginBatch();
      num_tens_ops_in_fly = 0;
     }
     input_slices.clear();
    } //loop over tensor operations
+   endBatch();
+   //Measure the throughput of the completed tensor sub-networks and recalibrate the Host share:
+   if(hybrid_execution){
+    if(subnetwork_measurable && subnetwork.last_op) pending_subnetworks.emplace_back(std::move(subnetwork));
+    calibrateHybridShare(false);
+   }
    //Erase intermediate tensor slices once all tensor operations have been executed:
    intermediate_slices.clear();
+   current_staged.clear();
+   current_staged.swap(next_staged);
    ++num_items_executed;
+   first_subnetwork = false;
    //Proceed to the next tensor sub-network:
-   not_done = work_range.next();
+   if(dynamic_scheduling){
+#ifdef MPI_ENABLED
+    if(--chunk_left > 0){
+     not_done = work_range.next();
+    }else{ //complete the current chunk locally before requesting the next one
+     tensor_rt_->sync();
+     if(hybrid_execution) calibrateHybridShare(true);
+     num_tens_ops_in_fly = 0;
+     not_done = fetch_chunk();
+    }
+#endif
+   }else{
+    not_done = work_range.next();
+   }
   } //loop over tensor sub-networks
-  //Allreduce the tensor network output tensor within the executing process group:
-  if(num_procs > 1){
-   std::shared_ptr<TensorOperation> allreduce = tensor_op_factory_->createTensorOp(TensorOpCode::ALLREDUCE);
-   allreduce->setTensorOperand(output_tensor);
-   std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(allreduce)->resetMPICommunicator(process_group.getMPICommProxy());
-   submitted = submit(allreduce,tensor_mapper); if(!submitted) return false;
-   ++num_tens_ops_in_fly;
+  if(hybrid_execution && logging_ > 0) logfile_ << "Hybrid execution: Host share of tensor sub-networks = " << host_slice_share_
+                                                << " (Host/accelerator throughput = " << host_slice_rate_ << " / " << accel_slice_rate_
+                                                << " Flop/sec)" << std::endl << std::flush;
+#ifdef MPI_ENABLED
+  if(dynamic_scheduling){
+   auto errc = MPI_Win_unlock_all(slice_win); assert(errc == MPI_SUCCESS);
+   errc = MPI_Win_free(&slice_win); assert(errc == MPI_SUCCESS);
+  }
+#endif
+  //Destroy the retained slice-invariant intermediates:
+  if(!first_subnetwork){
+   for(auto & tensor: retained_tensors){
+    std::shared_ptr<TensorOperation> destroy_op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+    destroy_op->setTensorOperand(tensor);
+    submitted = submit(destroy_op,tensor_mapper); if(!submitted) return false;
+    ++num_tens_ops_in_fly;
+   }
   }
- }else{ //only a single tensor (sub-)network executed redundantly by all processes
-  for(auto op = op_list.begin(); op != op_list.end(); ++op){
-   submitted = submit(*op,tensor_mapper); if(!submitted) return false;
+  //Reduce the tensor network output tensor within the executing process group (the accumulator is reduced by the caller):
+  if(num_procs > 1 && !accumulator){
+   submitted = submitOutputReduction(process_group,output_tensor,tensor_mapper); if(!submitted) return false;
    ++num_tens_ops_in_fly;
   }
-  ++num_items_executed;
+ }else{ //only a single tensor (sub-)network executed redundantly by all processes (or by the chosen one)
+  if(executing_rank < 0 || static_cast<unsigned int>(executing_rank) == local_rank){
+   for(auto op = op_list.begin(); op != op_list.end(); ++op){
+    if(accumulator && (*op)->getTensorOperand(0) == output_tensor){
+     std::shared_ptr<TensorOperation> tens_op = (*op)->clone();
+     bool replaced = tens_op->resetTensorOperand(0,accumulator); assert(replaced);
+     redirect_output(*tens_op);
+     submitted = submit(tens_op,tensor_mapper); if(!submitted) return false;
+    }else{
+     submitted = submit(*op,tensor_mapper); if(!submitted) return false;
+    }
+    ++num_tens_ops_in_fly;
+   }
+   ++num_items_executed;
+  }
  }
  if(logging_ > 0) logfile_ << "Number of submitted sub-networks = " << num_items_executed << std::endl << std::flush;
+ if(dry_run_){
+  std::size_t num_slices = 1;
+  for(unsigned int i = 0; i < num_split_indices; ++i) num_slices *= network.getSplitIndexInfo(i).second.size();
+  auto elem_size = TensorElementTypeSize(output_tensor->getElementType());
+  double op_factor = tensorElementTypeOpFactor(output_tensor->getElementType());
+  if(elem_size == 0){elem_size = sizeof(std::complex<double>); op_factor = 8.0;}
+  exec_plan_.recordNetwork(network.getName() + "(" + output_tensor->getName() + ")",num_slices,num_items_executed,
+                           network.getFMAFlops() * op_factor,
+                           max_intermediate_presence_volume * presence_shrink_coef * static_cast<double>(elem_size));
+ }
+ if(track_memory && last_submitted_op_ != prior_op){
+  auto elem_size = TensorElementTypeSize(output_tensor->getElementType());
+  if(elem_size == 0) elem_size = sizeof(std::complex<double>);
+  memory_timeline->addPrediction(network.getName() + "(" + output_tensor->getName() + ")",
+                                 max_intermediate_presence_volume * presence_shrink_coef * static_cast<double>(elem_size),
+                                 submission_start,prior_op,last_submitted_op_);
+ }
  return true;
 }
 
@@ -938,7 +2688,22 @@ bool NumServer::submit(const ProcessGroup & process_group,
 {
 #ifdef CUQUANTUM
  //Try execution via an alternative computational backend:
- if(comp_backend_ == "cuquantum"){
+ bool via_cuquantum = (comp_backend_ == "cuquantum");
+ std::size_t memo_hash = 0;
+ NetworkMemo memo;
+ if((via_cuquantum || comp_backend_ == "auto") && network){
+  if(lookupNetworkMemo(process_group,*network,&memo_hash,memo)) return true; //output tensor already holds the result
+ }
+ if(comp_backend_ == "auto" && network){
+  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+  via_cuquantum = (selectNetworkBackend(process_group,*network) == runtime::BackendSelector::CUQUANTUM_BACKEND);
+  if(!via_cuquantum){
+   bool submitted = submitNetwork(process_group,*network,true); //tensor contraction sequence has been synchronized
+   if(submitted) recordNetworkMemo(*network,memo_hash,std::move(memo));
+   return submitted;
+  }
+ }
+ if(via_cuquantum){
   //Determine parallel execution configuration:
   unsigned int local_rank; //local process rank within the process group
   if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
@@ -955,12 +2720,12 @@ bool NumServer::submit(const ProcessGroup & process_group,
 
   //Create the output tensor of the tensor network if needed:
   auto output_tensor = network->getTensor(0);
-  auto iter = tensors_.find(output_tensor->getName());
+  auto iter = tensors_.find(output_tensor->getNameId());
   if(iter == tensors_.end()){ //output tensor does not exist and needs to be created
    output_tensor->setElementType(network->getTensorElementType());
-   implicit_tensors_.emplace(std::make_pair(output_tensor->getName(),output_tensor)); //list of implicitly created tensors (for garbage collection)
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); implicit_tensors_.emplace(std::make_pair(output_tensor->getName(),output_tensor));} //list of implicitly created tensors (for garbage collection)
    if(!(process_group == getDefaultProcessGroup())){
-    auto saved = tensor_comms_.emplace(std::make_pair(output_tensor->getName(),process_group));
+    auto saved = tensor_comms_.emplace(std::make_pair(output_tensor->getNameId(),process_group));
     assert(saved.second);
    }
    //Create output tensor:
@@ -987,12 +2752,99 @@ bool NumServer::submit(const ProcessGroup & process_group,
    if(success && logging_ > 0) logfile_ << "Execution handle of the submitted network via cuQuantum is "
                                         << exec_handle << std::endl << std::flush;
   }
+  if(success) recordNetworkMemo(*network,memo_hash,std::move(memo));
   return success;
  }
 #endif
- if(network) return submit(process_group,*network);
- return false;
+ if(network) return submit(process_group,*network);
+ return false;
+}
+
+#ifdef CUQUANTUM
+runtime::BackendSelector::Backend NumServer::selectNetworkBackend(const ProcessGroup & process_group,
+                                                                  TensorNetwork & network)
+{
+ using runtime::BackendSelector;
+ //Determine the tensor contraction sequence (synchronized across the processes):
+ determineContractionSequence(process_group,network,true);
+ //Estimate the cost of the tensor network:
+ const auto element_type = network.getTensorElementType();
+ const double elem_size = static_cast<double>(TensorElementTypeSize(element_type));
+ unsigned int max_rank = 0;
+ const double max_volume = network.getMaxIntermediateVolume(&max_rank);
+ BackendSelector::NetworkCost cost;
+ cost.fma_flops = network.getFMAFlops();
+ cost.max_intermediate_bytes = max_volume * elem_size;
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  cost.io_bytes += static_cast<double>(iter->second.getTensor()->getVolume()) * elem_size;
+ }
+ //Determine the available resources:
+ BackendSelector::Resources resources;
+ resources.host_memory = static_cast<double>(process_group.getMemoryLimitPerProcess());
+ auto & device_memory = getDeviceMemoryManager();
+ for(const auto device: device_memory.getDevices()){
+  void * base_ptr = nullptr;
+  std::size_t buffer_size = 0;
+  if(device_memory.getBuffer(device,&base_ptr,&buffer_size)){
+   const double size = static_cast<double>(buffer_size);
+   resources.device_memory = (resources.num_gpus == 0) ? size : std::min(resources.device_memory,size);
+   ++(resources.num_gpus);
+  }
+ }
+ //Seed the FMA flop rate of the default backend from the runtime metrics:
+ const auto metrics = getRuntimeMetrics();
+ double flops = 0.0, busy_time = 0.0;
+ for(const auto & stats: metrics.devices){flops += stats.flops; busy_time += stats.busy_time;}
+ if(busy_time > 0.0) backend_selector_.seedRate(BackendSelector::DEFAULT_BACKEND,
+                                                flops / busy_time / tensorElementTypeOpFactor(element_type));
+ //Select the backend:
+ const std::string key = std::to_string(static_cast<int>(element_type)) + ":" + std::to_string(network.getNumTensors())
+                       + ":" + std::to_string(cost.fma_flops) + ":" + std::to_string(max_volume);
+ bool trial = false;
+ auto backend = backend_selector_.select(key,cost,resources,&trial);
+#ifdef MPI_ENABLED
+ if(process_group.getSize() > 1){ //the decision of process 0 of the executing process group is binding
+  int selected = static_cast<int>(backend);
+  const double comm_start = exatn::Timer::timeInSecHR();
+  auto errc = MPI_Bcast(&selected,1,MPI_INT,0,process_group.getMPICommProxy().getRef<MPI_Comm>());
+  assert(errc == MPI_SUCCESS);
+  getCommProfile().record(CommProfile::CommKind::BACKEND_BCAST,process_group.getMPICommProxy(),0,
+                          sizeof(int),exatn::Timer::timeInSecHR(comm_start));
+  backend = static_cast<BackendSelector::Backend>(selected);
+ }
+#endif
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Selected computational backend <" << BackendSelector::backendName(backend)
+                           << "> for tensor network <" << network.getName() << ">: Estimated time (default, cuquantum) = "
+                           << backend_selector_.estimate(BackendSelector::DEFAULT_BACKEND,cost,resources) << ", "
+                           << backend_selector_.estimate(BackendSelector::CUQUANTUM_BACKEND,cost,resources)
+                           << " sec" << (trial ? " (trial)" : "") << std::endl << std::flush;
+ //Start measuring the execution time of the tensor network:
+ auto res = backend_measurements_.emplace(std::make_pair(network.getTensor(0)->getTensorHash(),
+  BackendMeasurement{key,backend,cost,resources,exatn::Timer::timeInSecHR()}));
+ if(!res.second) res.first->second.start_time = -1.0; //multiple tensor networks with the same output tensor: Not measured
+ return backend;
+}
+
+void NumServer::recordNetworkBackend(numerics::TensorHashType output_hash,
+                                     bool measured)
+{
+ auto iter = backend_measurements_.find(output_hash);
+ if(iter != backend_measurements_.end()){
+  const auto & measurement = iter->second;
+  if(measured && measurement.start_time >= 0.0){
+   const double time = exatn::Timer::timeInSecHR(measurement.start_time);
+   backend_selector_.record(measurement.key,measurement.backend,measurement.cost,measurement.resources,time);
+   if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                             << "]: Measured execution time of a tensor network via backend <"
+                             << runtime::BackendSelector::backendName(measurement.backend) << ">: "
+                             << time << " sec" << std::endl << std::flush;
+  }
+  backend_measurements_.erase(iter);
+ }
+ return;
 }
+#endif
 
 bool NumServer::submit(TensorExpansion & expansion,
                        std::shared_ptr<Tensor> accumulator,
@@ -1019,11 +2871,64 @@ bool NumServer::submit(const ProcessGroup & process_group,
  bool success = true;
  auto tensor_mapper = getTensorMapper(process_group);
  if(parallel_width <= 1){ //all processes execute all tensor networks one-by-one
+  const unsigned int num_procs = process_group.getSize();
+  const bool fused = (expansion_fusion_ && comp_backend_ == "default");
+  const bool sharing = (intermediate_sharing_ && comp_backend_ == "default" && expansion.getNumComponents() > 1);
+  //Determine the tensor contraction sequences of all tensor network components at once (single synchronization):
+  const bool contr_seq_synced = (fused || sharing);
+  if(contr_seq_synced){
+   std::vector<TensorNetwork*> networks;
+   for(auto component = expansion.begin(); component != expansion.end(); ++component){
+    determineContractionSequence(process_group,*(component->network),false);
+    networks.emplace_back(component->network.get());
+   }
+   synchronizeContractionSequences(process_group,networks);
+  }
+  //Evaluate the intermediates shared by different tensor network components only once:
+  std::shared_ptr<numerics::TensorExpansionPlanner> planner;
+  if(sharing){
+   planner = std::make_shared<numerics::TensorExpansionPlanner>(expansion);
+   if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                             << "]: Tensor expansion <" << expansion.getName() << ">: Shared intermediates = "
+                             << planner->getNumSharedIntermediates() << "; FMA flop count = " << std::scientific
+                             << planner->getOriginalFlops() << " -> " << planner->getPlannedFlops() << std::endl << std::flush;
+   for(std::size_t i = 0; i < planner->getNumSharedIntermediates(); ++i){
+    success = submitNetwork(process_group,*(planner->getSharedIntermediate(i).network),true); assert(success);
+   }
+  }
+  if(fused){ //all tensor network components accumulate directly into the accumulator
+   if(num_procs > 1 && local_rank != 0){ //the accumulator is allreduced at the end
+    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+    op->setTensorOperand(accumulator);
+    std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->
+     resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
+    success = submit(op,tensor_mapper); assert(success);
+   }
+   for(auto component = expansion.begin(); component != expansion.end(); ++component){
+    const auto comp = std::distance(expansion.begin(),component);
+    std::shared_ptr<TensorNetwork> reduced;
+    if(planner) reduced = planner->getReducedNetwork(comp);
+    auto & network = reduced ? *reduced : *(component->network);
+    bool conjugated;
+    auto output_tensor = network.getTensor(0,&conjugated); assert(!conjugated); //output tensor cannot be conjugated
+    const int executing_rank = (num_procs > 1) ? static_cast<int>(comp % num_procs) : -1; //unsliced networks are distributed round-robin
+    success = submitNetwork(process_group,network,true,accumulator,component->coefficient,executing_rank); assert(success);
+   }
+   if(num_procs > 1){
+    success = submitOutputReduction(process_group,accumulator,tensor_mapper); assert(success);
+   }
+  }
   std::list<std::shared_ptr<TensorOperation>> accumulations;
-  for(auto component = expansion.begin(); component != expansion.end(); ++component){
+  for(auto component = expansion.begin(); component != expansion.end() && !fused; ++component){
    //Evaluate the tensor network component (compute its output tensor):
-   auto & network = *(component->network);
-   success = submit(process_group,network); assert(success);
+   std::shared_ptr<TensorNetwork> reduced;
+   if(planner) reduced = planner->getReducedNetwork(std::distance(expansion.begin(),component));
+   auto & network = reduced ? *reduced : *(component->network);
+   if(contr_seq_synced){
+    success = submitNetwork(process_group,network,true); assert(success);
+   }else{
+    success = submit(process_group,network); assert(success);
+   }
    //Create accumulation operation for the scaled computed output tensor:
    bool conjugated;
    auto output_tensor = network.getTensor(0,&conjugated); assert(!conjugated); //output tensor cannot be conjugated
@@ -1036,12 +2941,19 @@ bool NumServer::submit(const ProcessGroup & process_group,
                                               accumulator->getName(),output_tensor->getName());
    assert(generated);
    op->setIndexPattern(add_pattern);
+   op->setCommutativeAccumulation(true); //accumulations into the accumulator commute
    accumulations.emplace_back(op);
   }
   //Submit all previously created accumulation operations:
   for(auto & accumulation: accumulations){
    success = submit(accumulation,tensor_mapper); assert(success);
   }
+  //Destroy the shared intermediates:
+  if(planner){
+   for(std::size_t i = 0; i < planner->getNumSharedIntermediates(); ++i){
+    success = destroyTensor(planner->getSharedIntermediate(i).network->getTensor(0)->getName()); assert(success);
+   }
+  }
  }else{ //tensor networks will be distributed among subgroups of processes
   //Destroy output tensors of all tensor networks within the original process group:
   for(auto component = expansion.begin(); component != expansion.end(); ++component){
@@ -1069,16 +2981,45 @@ bool NumServer::submit(const ProcessGroup & process_group,
    my_subgroup_size = procs_per_subgroup;
   }
   assert(my_subgroup_id >= 0 && my_subgroup_id < parallel_width);
-  auto process_subgroup = process_group.split(my_subgroup_id);
+  //Assign tensor networks to subgroups by their cost (longest-processing-time-first bin packing):
+  for(auto component = expansion.begin(); component != expansion.end(); ++component){
+   determineContractionSequence(process_group,*(component->network)); //identical across all processes
+  }
+  std::vector<std::pair<double,std::size_t>> costs; //{FMA flop count, component}
+  for(auto component = expansion.begin(); component != expansion.end(); ++component){
+   costs.emplace_back(std::make_pair(component->network->getFMAFlops(),
+                                     static_cast<std::size_t>(std::distance(expansion.begin(),component))));
+  }
+  std::stable_sort(costs.begin(),costs.end(),[](const std::pair<double,std::size_t> & a,
+                                                const std::pair<double,std::size_t> & b){return a.first > b.first;});
+  std::vector<double> subgroup_loads(parallel_width,0.0); //FMA flop count per process in each subgroup
+  std::vector<int> assigned_subgroups(num_networks,-1);
+  for(const auto & cost: costs){
+   int best_subgroup = 0;
+   double best_load = 0.0;
+   for(int subgroup = 0; subgroup < static_cast<int>(parallel_width); ++subgroup){
+    const int subgroup_size = procs_per_subgroup + ((subgroup < remainder_procs) ? 1 : 0);
+    const double load = subgroup_loads[subgroup] + cost.first / static_cast<double>(subgroup_size);
+    if(subgroup == 0 || load < best_load){best_subgroup = subgroup; best_load = load;}
+   }
+   subgroup_loads[best_subgroup] = best_load;
+   assigned_subgroups[cost.second] = best_subgroup;
+  }
+  if(logging_ > 0){
+   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+            << "]: Tensor expansion <" << expansion.getName() << ">: FMA flop count per process in subgroups:" << std::scientific;
+   for(const auto load: subgroup_loads) logfile_ << " " << load;
+   logfile_ << std::endl << std::flush;
+  }
+  auto process_subgroup = getProcessSubgroup(process_group,parallel_width,my_subgroup_id);
   auto local_tensor_mapper = getTensorMapper(*process_subgroup);
-  //Create/initialize accumulator tensors within subgroups:
-  auto local_accumulator = makeSharedTensor(*accumulator);
-  local_accumulator->rename("_lacc"+std::to_string(my_subgroup_id));
-  success = createTensorSync(*process_subgroup,local_accumulator,accumulator->getElementType()); assert(success);
+  //Create (or reuse) and initialize accumulator tensors within subgroups:
+  auto local_accumulator = getSubgroupAccumulator(process_group,parallel_width,*accumulator,
+                                                  getTensorElementType(accumulator->getName()));
   success = initTensor(local_accumulator->getName(),0.0); assert(success);
   //Distribute and evaluate tensor networks within subgroups:
   for(auto component = expansion.begin(); component != expansion.end(); ++component){
-   if(std::distance(expansion.begin(),component) % parallel_width == my_subgroup_id){
+   if(assigned_subgroups[std::distance(expansion.begin(),component)] == my_subgroup_id){
     auto & network = *(component->network);
     success = submit(*process_subgroup,network); assert(success);
     //Create accumulation operation for the scaled computed output tensor:
@@ -1094,6 +3035,7 @@ bool NumServer::submit(const ProcessGroup & process_group,
                                                local_accumulator->getName(),output_tensor_name);
     assert(generated);
     local_accumulation->setIndexPattern(add_pattern);
+    local_accumulation->setCommutativeAccumulation(true); //accumulations into the local accumulator commute
     success = submit(local_accumulation,local_tensor_mapper); assert(success);
     success = destroyTensor(output_tensor_name); assert(success);
    }
@@ -1112,7 +3054,6 @@ bool NumServer::submit(const ProcessGroup & process_group,
   success = sync(*process_subgroup); assert(success);
   success = sync(process_group); assert(success);
   success = scaleTensor(accumulator->getName(),1.0/static_cast<double>(my_subgroup_size)); assert(success);
-  success = destroyTensorSync(local_accumulator->getName()); assert(success);
   success = sync(process_group); assert(success);
   success = allreduceTensorSync(process_group,accumulator->getName()); assert(success);
  }
@@ -1128,6 +3069,85 @@ bool NumServer::submit(const ProcessGroup & process_group,
  return false;
 }
 
+bool NumServer::submit(TensorExpansionStream & expansion,
+                       std::shared_ptr<Tensor> accumulator,
+                       std::size_t batch_size,
+                       unsigned int parallel_width)
+{
+ return submit(getDefaultProcessGroup(),expansion,accumulator,batch_size,parallel_width);
+}
+
+bool NumServer::submit(const ProcessGroup & process_group,
+                       TensorExpansionStream & expansion,
+                       std::shared_ptr<Tensor> accumulator,
+                       std::size_t batch_size,
+                       unsigned int parallel_width)
+{
+ if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ assert(accumulator && batch_size > 0);
+ bool success = true;
+ std::size_t num_batches = 0;
+ expansion.reset();
+ TensorExpansion batch;
+ while(success && expansion.nextBatch(batch,batch_size) > 0){
+  success = submit(process_group,batch,accumulator,parallel_width);
+  //Bound the number of outstanding product tensor networks:
+  if(success) success = sync(process_group,*accumulator);
+  ++num_batches;
+ }
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Tensor expansion stream <" << expansion.getName() << ">: Evaluated "
+                           << (expansion.getMaxNumComponents() - expansion.getNumPruned()) << " components in "
+                           << num_batches << " batches (pruned " << expansion.getNumPruned() << ")" << std::endl << std::flush;
+ return success;
+}
+
+bool NumServer::submit(const std::vector<std::shared_ptr<TensorNetwork>> & networks)
+{
+ return submit(getDefaultProcessGroup(),networks);
+}
+
+bool NumServer::submit(const ProcessGroup & process_group,
+                       const std::vector<std::shared_ptr<TensorNetwork>> & networks)
+{
+ if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ for(const auto & network: networks) if(!network) return false;
+ bool success = true;
+ if(comp_backend_ != "default" || networks.size() < 2){ //nothing to share
+  for(const auto & network: networks){
+   success = submit(process_group,*network); if(!success) return success;
+  }
+  return success;
+ }
+ //Determine the tensor contraction sequences of all tensor networks at once (single synchronization):
+ std::vector<TensorNetwork*> network_ptrs;
+ for(const auto & network: networks){
+  determineContractionSequence(process_group,*network,false);
+  network_ptrs.emplace_back(network.get());
+ }
+ synchronizeContractionSequences(process_group,network_ptrs);
+ //Evaluate the intermediates shared by different tensor networks only once:
+ numerics::TensorExpansionPlanner planner(networks);
+ if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                           << "]: Tensor network bundle of size " << networks.size() << ": Shared intermediates = "
+                           << planner.getNumSharedIntermediates() << "; FMA flop count = " << std::scientific
+                           << planner.getOriginalFlops() << " -> " << planner.getPlannedFlops() << std::endl << std::flush;
+ for(std::size_t i = 0; i < planner.getNumSharedIntermediates(); ++i){
+  success = submitNetwork(process_group,*(planner.getSharedIntermediate(i).network),true); assert(success);
+ }
+ //Evaluate all output tensors:
+ for(std::size_t i = 0; i < networks.size(); ++i){
+  auto reduced = planner.getReducedNetwork(i);
+  auto & network = reduced ? *reduced : *(networks[i]);
+  success = submitNetwork(process_group,network,true); assert(success);
+ }
+ //Destroy the shared intermediates:
+ for(std::size_t i = 0; i < planner.getNumSharedIntermediates(); ++i){
+  success = destroyTensor(planner.getSharedIntermediate(i).network->getTensor(0)->getName()); assert(success);
+ }
+ return success;
+}
+
 bool NumServer::sync(const Tensor & tensor, bool wait)
 {
  return sync(getCurrentProcessGroup(),tensor,wait);
@@ -1138,22 +3158,23 @@ bool NumServer::sync(const ProcessGroup & process_group, const Tensor & tensor,
  bool success = true;
  if(!process_group.rankIsIn(process_rank_)) return success; //process is not in the group: Do nothing
 
- auto iter = tensors_.find(tensor.getName());
+ auto iter = tensors_.find(tensor.getNameId());
  if(iter != tensors_.end()){
 #ifdef CUQUANTUM
-  if(comp_backend_ == "cuquantum"){
+  if(comp_backend_ == "cuquantum" || comp_backend_ == "auto"){
    auto cuter = tn_exec_handles_.find(iter->second->getTensorHash());
-   success = (cuter == tn_exec_handles_.end());
-   if(!success){
+   if(cuter != tn_exec_handles_.end()){
     success = tensor_rt_->syncNetwork(cuter->second,wait);
     if(success){
      if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
       << "]: Locally synchronized cuQuantum execution handle " << cuter->second << " via tensor <" << tensor.getName() << ">"
       << std::endl << std::flush;
      tn_exec_handles_.erase(cuter);
+     if(comp_backend_ == "auto") recordNetworkBackend(iter->second->getTensorHash(),wait);
     }
+    return success;
    }
-   return success;
+   if(comp_backend_ == "cuquantum") return success;
   }
 #endif
   if(iter->second->isComposite()){
@@ -1167,8 +3188,11 @@ bool NumServer::sync(const ProcessGroup & process_group, const Tensor & tensor,
   if(success){
    if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
     << "]: Locally synchronized all operations on tensor <" << tensor.getName() << ">" << std::endl << std::flush;
+#ifdef CUQUANTUM
+   if(comp_backend_ == "auto") recordNetworkBackend(iter->second->getTensorHash(),wait);
+#endif
 #ifdef MPI_ENABLED
-   if(wait){
+   if(wait && process_group.getSize() > 1){ //a single process needs no barrier (concurrent client threads)
     auto errc = MPI_Barrier(process_group.getMPICommProxy().getRef<MPI_Comm>());
     success = success && (errc == MPI_SUCCESS);
     if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
@@ -1207,7 +3231,7 @@ bool NumServer::sync(bool wait, bool clean_garbage)
 {
  bool success = sync(getCurrentProcessGroup(),wait,clean_garbage);
 #ifdef CUQUANTUM
- if(comp_backend_ == "cuquantum" && success) tn_exec_handles_.clear();
+ if((comp_backend_ == "cuquantum" || comp_backend_ == "auto") && success) tn_exec_handles_.clear();
 #endif
  return success;
 }
@@ -1215,16 +3239,23 @@ bool NumServer::sync(bool wait, bool clean_garbage)
 bool NumServer::sync(const ProcessGroup & process_group, bool wait, bool clean_garbage)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ if(clean_garbage) destroySubgroupAccumulators(process_group);
  destroyOrphanedTensors(clean_garbage); //garbage collection
  auto success = tensor_rt_->sync(wait);
  if(success){
+  collectValidationSamples(false);
   if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
    << "]: Locally synchronized all operations" << std::endl << std::flush;
 #ifdef CUQUANTUM
   if(comp_backend_ == "cuquantum") tn_exec_handles_.clear();
+  if(comp_backend_ == "auto"){
+   tn_exec_handles_.clear();
+   const bool measured = (wait && backend_measurements_.size() == 1); //only a single outstanding tensor network is measured
+   while(!backend_measurements_.empty()) recordNetworkBackend(backend_measurements_.cbegin()->first,measured);
+  }
 #endif
 #ifdef MPI_ENABLED
-  if(wait){
+  if(wait && process_group.getSize() > 1){ //a single process needs no barrier (concurrent client threads)
    auto errc = MPI_Barrier(process_group.getMPICommProxy().getRef<MPI_Comm>());
    success = success && (errc == MPI_SUCCESS);
    if(success){
@@ -1248,19 +3279,70 @@ bool NumServer::sync(const std::string & name, bool wait)
 bool NumServer::sync(const ProcessGroup & process_group, const std::string & name, bool wait)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()) return true; //tensor does not exist: Do nothing
  return sync(process_group,*(iter->second),wait);
 }
 
 bool NumServer::tensorAllocated(const std::string & name) const
 {
- return (tensors_.find(name) != tensors_.cend());
+ return (tensors_.find(lookupNameId(name)) != tensors_.cend());
+}
+
+std::shared_ptr<ProcessGroup> NumServer::getProcessSubgroup(const ProcessGroup & process_group,
+                                                           unsigned int num_subgroups,
+                                                           int my_subgroup)
+{
+ for(const auto & cached: subgroups_){
+  if(cached.parent == process_group && cached.num_subgroups == num_subgroups){
+   assert(cached.my_subgroup == my_subgroup);
+   return cached.subgroup;
+  }
+ }
+ auto subgroup = process_group.split(my_subgroup); //collective
+ subgroups_.emplace_back(ProcessSubgroup{process_group,num_subgroups,my_subgroup,subgroup,nullptr});
+ return subgroup;
+}
+
+std::shared_ptr<Tensor> NumServer::getSubgroupAccumulator(const ProcessGroup & process_group,
+                                                         unsigned int num_subgroups,
+                                                         const Tensor & accumulator,
+                                                         TensorElementType element_type)
+{
+ for(auto & cached: subgroups_){
+  if(cached.parent == process_group && cached.num_subgroups == num_subgroups){
+   auto & local_accumulator = cached.local_accumulator;
+   if(local_accumulator){
+    if(local_accumulator->isCongruentTo(accumulator) &&
+       getTensorElementType(local_accumulator->getName()) == element_type) return local_accumulator;
+    auto success = destroyTensorSync(local_accumulator->getName()); assert(success);
+    local_accumulator.reset();
+   }
+   local_accumulator = makeSharedTensor(accumulator);
+   local_accumulator->rename("_lacc"+std::to_string(cached.my_subgroup)+"_"+std::to_string(num_subgroups));
+   auto success = createTensorSync(*(cached.subgroup),local_accumulator,element_type); assert(success);
+   return local_accumulator;
+  }
+ }
+ std::cout << "#ERROR(exatn::NumServer::getSubgroupAccumulator): Process subgroup not found!" << std::endl;
+ assert(false);
+ return std::shared_ptr<Tensor>(nullptr);
+}
+
+void NumServer::destroySubgroupAccumulators(const ProcessGroup & process_group)
+{
+ for(auto & cached: subgroups_){
+  if(cached.local_accumulator && cached.parent.isContainedIn(process_group)){
+   auto success = destroyTensorSync(cached.local_accumulator->getName()); assert(success);
+   cached.local_accumulator.reset();
+  }
+ }
+ return;
 }
 
 std::shared_ptr<Tensor> NumServer::getTensor(const std::string & name)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#ERROR(exatn::NumServer::getTensor): Tensor " << name << " not found!" << std::endl;
   return std::shared_ptr<Tensor>(nullptr);
@@ -1270,7 +3352,7 @@ std::shared_ptr<Tensor> NumServer::getTensor(const std::string & name)
 
 Tensor & NumServer::getTensorRef(const std::string & name)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   std::cout << "#ERROR(exatn::NumServer::getTensorRef): Tensor " << name << " not found!" << std::endl;
   assert(false);
@@ -1280,7 +3362,7 @@ Tensor & NumServer::getTensorRef(const std::string & name)
 
 TensorElementType NumServer::getTensorElementType(const std::string & name) const
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   std::cout << "#ERROR(exatn::NumServer::getTensorElementType): Tensor " << name << " not found!" << std::endl;
   assert(false);
@@ -1291,7 +3373,7 @@ TensorElementType NumServer::getTensorElementType(const std::string & name) cons
 bool NumServer::registerTensorIsometry(const std::string & name,
                                        const std::vector<unsigned int> & iso_dims)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   std::cout << "#ERROR(exatn::NumServer::registerTensorIsometry): Tensor " << name << " not found!" << std::endl;
   return false;
@@ -1311,8 +3393,11 @@ bool NumServer::registerTensorIsometry(const std::string & name,
 
 bool NumServer::withinTensorExistenceDomain(const std::string & tensor_name) const
 {
- bool exists = (tensors_.find(tensor_name) != tensors_.cend());
- if(!exists) exists = (implicit_tensors_.find(tensor_name) != implicit_tensors_.cend());
+ bool exists = (tensors_.find(lookupNameId(tensor_name)) != tensors_.cend());
+ if(!exists){
+  std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+  exists = (implicit_tensors_.find(tensor_name) != implicit_tensors_.cend());
+ }
  return exists;
 }
 
@@ -1324,8 +3409,8 @@ const ProcessGroup & NumServer::getTensorProcessGroup(const std::string & tensor
             << " is not within the existence domain of tensor " << tensor_name << std::endl;
   assert(false);
  }
- auto iter = tensor_comms_.find(tensor_name);
- if(iter != tensor_comms_.cend()) return iter->second;
+ const auto * tensor_domain = tensor_comms_.lookup(lookupNameId(tensor_name));
+ if(tensor_domain != nullptr) return *tensor_domain;
  return getDefaultProcessGroup();
 }
 
@@ -1378,9 +3463,9 @@ bool NumServer::createTensor(const ProcessGroup & process_group,
     submitted = submit(op,tensor_mapper);
     if(submitted){
      tensor->setElementType(element_type);
-     auto res = tensors_.emplace(std::make_pair(tensor->getName(),tensor));
+     auto res = tensors_.emplace(std::make_pair(tensor->getNameId(),tensor));
      if(res.second){
-      auto saved = tensor_comms_.emplace(std::make_pair(tensor->getName(),process_group));
+      auto saved = tensor_comms_.emplace(std::make_pair(tensor->getNameId(),process_group));
       assert(saved.second);
      }else{
       std::cout << "#ERROR(exatn::createTensor): Attempt to CREATE an already existing tensor "
@@ -1399,7 +3484,7 @@ bool NumServer::createTensor(const ProcessGroup & process_group,
    submitted = submit(op,tensor_mapper);
    if(submitted){
     if(!(process_group == getDefaultProcessGroup())){
-     auto saved = tensor_comms_.emplace(std::make_pair(tensor->getName(),process_group));
+     auto saved = tensor_comms_.emplace(std::make_pair(tensor->getNameId(),process_group));
      assert(saved.second);
     }
    }
@@ -1429,9 +3514,9 @@ bool NumServer::createTensorSync(const ProcessGroup & process_group,
     submitted = submit(op,tensor_mapper);
     if(submitted){
      tensor->setElementType(element_type);
-     auto res = tensors_.emplace(std::make_pair(tensor->getName(),tensor));
+     auto res = tensors_.emplace(std::make_pair(tensor->getNameId(),tensor));
      if(res.second){
-      auto saved = tensor_comms_.emplace(std::make_pair(tensor->getName(),process_group));
+      auto saved = tensor_comms_.emplace(std::make_pair(tensor->getNameId(),process_group));
       assert(saved.second);
       submitted = sync(*op);
      }else{
@@ -1451,7 +3536,7 @@ bool NumServer::createTensorSync(const ProcessGroup & process_group,
    submitted = submit(op,tensor_mapper);
    if(submitted){
     if(!(process_group == getDefaultProcessGroup())){
-     auto saved = tensor_comms_.emplace(std::make_pair(tensor->getName(),process_group));
+     auto saved = tensor_comms_.emplace(std::make_pair(tensor->getNameId(),process_group));
      assert(saved.second);
     }
     submitted = sync(*op);
@@ -1483,16 +3568,10 @@ bool NumServer::createTensors(const ProcessGroup & process_group,
                               TensorElementType element_type)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
- bool success = true;
- for(auto tens = tensor_network.begin(); tens != tensor_network.end(); ++tens){
-  if(tens->first != 0){ //only input tensors
-   auto tensor = tens->second.getTensor();
-   const auto & tens_name = tensor->getName();
-   if(!tensorAllocated(tens_name)) success = createTensor(process_group,tensor,element_type);
-   if(!success) break;
-  }
- }
- return success;
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_set<std::string> names;
+ collectUnallocatedTensors(tensor_network,tensors,names);
+ return createTensorBatch(process_group,tensors,element_type,false);
 }
 
 bool NumServer::createTensorsSync(const ProcessGroup & process_group,
@@ -1500,16 +3579,10 @@ bool NumServer::createTensorsSync(const ProcessGroup & process_group,
                                   TensorElementType element_type)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
- bool success = true;
- for(auto tens = tensor_network.begin(); tens != tensor_network.end(); ++tens){
-  if(tens->first != 0){ //only input tensors
-   auto tensor = tens->second.getTensor();
-   const auto & tens_name = tensor->getName();
-   if(!tensorAllocated(tens_name)) success = createTensorSync(process_group,tensor,element_type);
-   if(!success) break;
-  }
- }
- return success;
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_set<std::string> names;
+ collectUnallocatedTensors(tensor_network,tensors,names);
+ return createTensorBatch(process_group,tensors,element_type,true);
 }
 
 bool NumServer::createTensors(TensorExpansion & tensor_expansion,
@@ -1529,12 +3602,12 @@ bool NumServer::createTensors(const ProcessGroup & process_group,
                               TensorElementType element_type)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
- bool success = true;
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_set<std::string> names;
  for(auto net = tensor_expansion.begin(); net != tensor_expansion.end(); ++net){
-  success = createTensors(process_group,*(net->network),element_type);
-  if(!success) break;
+  collectUnallocatedTensors(*(net->network),tensors,names);
  }
- return success;
+ return createTensorBatch(process_group,tensors,element_type,false);
 }
 
 bool NumServer::createTensorsSync(const ProcessGroup & process_group,
@@ -1542,19 +3615,85 @@ bool NumServer::createTensorsSync(const ProcessGroup & process_group,
                                   TensorElementType element_type)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
- bool success = true;
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_set<std::string> names;
  for(auto net = tensor_expansion.begin(); net != tensor_expansion.end(); ++net){
-  success = createTensorsSync(process_group,*(net->network),element_type);
-  if(!success) break;
+  collectUnallocatedTensors(*(net->network),tensors,names);
  }
- return success;
+ return createTensorBatch(process_group,tensors,element_type,true);
+}
+
+void NumServer::collectUnallocatedTensors(TensorNetwork & tensor_network,
+                                          std::vector<std::shared_ptr<Tensor>> & tensors,
+                                          std::unordered_set<std::string> & names)
+{
+ for(auto tens = tensor_network.begin(); tens != tensor_network.end(); ++tens){
+  if(tens->first != 0){ //only input tensors
+   auto tensor = tens->second.getTensor();
+   const auto & tens_name = tensor->getName();
+   if(!tensorAllocated(tens_name)){
+    if(names.emplace(tens_name).second) tensors.emplace_back(tensor);
+   }
+  }
+ }
+ return;
+}
+
+bool NumServer::createTensorBatch(const ProcessGroup & process_group,
+                                  const std::vector<std::shared_ptr<Tensor>> & tensors,
+                                  TensorElementType element_type,
+                                  bool synchronous)
+{
+ if(tensors.empty()) return true;
+ if(element_type == TensorElementType::VOID){
+  std::cout << "#ERROR(exatn::createTensors): Missing data type!" << std::endl;
+  return false;
+ }
+ const auto num_processes = process_group.getSize(); assert(num_processes > 0);
+ const bool default_group = (process_group == getDefaultProcessGroup());
+ for(const auto & tensor: tensors){
+  if(tensor->isComposite() && (num_processes & (num_processes - 1U)) != 0){ //power of 2 check
+   std::cout << "#ERROR(exatn::createTensors): For composite tensors, the size of the process group must be power of 2, but it is "
+             << num_processes << std::endl;
+   return false;
+  }
+ }
+ //Submit all CREATE operations to the tensor runtime at once:
+ auto tensor_mapper = getTensorMapper(process_group);
+ bool submitted = true;
+ beginBatch();
+ for(const auto & tensor: tensors){
+  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+  op->setTensorOperand(tensor);
+  std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetTensorElementType(element_type);
+  submitted = submit(op,tensor_mapper);
+  if(!submitted) break;
+  if(tensor->isComposite()){ //distributed storage
+   tensor->setElementType(element_type);
+   auto res = tensors_.emplace(std::make_pair(tensor->getNameId(),tensor));
+   if(!res.second){
+    std::cout << "#ERROR(exatn::createTensors): Attempt to CREATE an already existing tensor "
+              << tensor->getName() << std::endl;
+    submitted = false;
+    break;
+   }
+  }
+  if(tensor->isComposite() || !default_group){
+   auto saved = tensor_comms_.emplace(std::make_pair(tensor->getNameId(),process_group));
+   assert(saved.second);
+  }
+ }
+ endBatch();
+ //Single synchronization of the whole batch:
+ if(submitted && synchronous) submitted = sync(process_group);
+ return submitted;
 }
 
 bool NumServer::destroyTensor(const std::string & name) //always synchronous
 {
  bool submitted = false;
  //destroyOrphanedTensors(); //garbage collection
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#WARNING(exatn::NumServer::destroyTensor): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -1565,17 +3704,21 @@ bool NumServer::destroyTensor(const std::string & name) //always synchronous
   op->setTensorOperand(iter->second);
   submitted = submit(op,tensor_mapper);
   if(submitted){
-   auto num_deleted = tensors_.erase(name); assert(num_deleted == 1);
-   num_deleted = tensor_comms_.erase(name); assert(num_deleted == 1);
-   num_deleted = implicit_tensors_.erase(name);
+   auto num_deleted = tensors_.erase(lookupNameId(name)); assert(num_deleted == 1);
+   num_deleted = tensor_comms_.erase(lookupNameId(name)); assert(num_deleted == 1);
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); num_deleted = implicit_tensors_.erase(name);}
   }
  }else{
   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
   op->setTensorOperand(iter->second);
   submitted = submit(op,tensor_mapper);
   if(submitted){
-   auto num_deleted = tensor_comms_.erase(name);
-   num_deleted = implicit_tensors_.erase(name);
+   if(tensorIsSharedReplica(name)){ //the node-shared body is released collectively
+    submitted = sync(*op);
+    if(submitted) submitted = freeSharedReplica(name);
+   }
+   auto num_deleted = tensor_comms_.erase(lookupNameId(name));
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); num_deleted = implicit_tensors_.erase(name);}
   }
  }
  return submitted;
@@ -1585,7 +3728,7 @@ bool NumServer::destroyTensorSync(const std::string & name)
 {
  bool submitted = false;
  //destroyOrphanedTensors(); //garbage collection
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#WARNING(exatn::NumServer::destroyTensorSync): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -1597,13 +3740,13 @@ bool NumServer::destroyTensorSync(const std::string & name)
   op->setTensorOperand(iter->second);
   submitted = submit(op,tensor_mapper);
   if(submitted){
-   auto num_deleted = tensors_.erase(name); assert(num_deleted == 1);
+   auto num_deleted = tensors_.erase(lookupNameId(name)); assert(num_deleted == 1);
    submitted = sync(*op);
 #ifdef MPI_ENABLED
    if(submitted) submitted = sync(process_group);
 #endif
-   num_deleted = tensor_comms_.erase(name); assert(num_deleted == 1);
-   num_deleted = implicit_tensors_.erase(name);
+   num_deleted = tensor_comms_.erase(lookupNameId(name)); assert(num_deleted == 1);
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); num_deleted = implicit_tensors_.erase(name);}
   }
  }else{
   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
@@ -1614,8 +3757,9 @@ bool NumServer::destroyTensorSync(const std::string & name)
 #ifdef MPI_ENABLED
    if(submitted) submitted = sync(process_group);
 #endif
-   auto num_deleted = tensor_comms_.erase(name);
-   num_deleted = implicit_tensors_.erase(name);
+   if(submitted && tensorIsSharedReplica(name)) submitted = freeSharedReplica(name); //collective within the compute node
+   auto num_deleted = tensor_comms_.erase(lookupNameId(name));
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); num_deleted = implicit_tensors_.erase(name);}
   }
  }
  return submitted;
@@ -1645,13 +3789,31 @@ bool NumServer::destroyTensorsSync(TensorNetwork & tensor_network)
  return success;
 }
 
+std::vector<std::string> NumServer::getSortedTensorNames(bool composite_only) const
+{
+ std::vector<std::string> names;
+ const auto tensors = tensors_.entries();
+ names.reserve(tensors.size());
+ for(const auto & tens: tensors){
+  if(!composite_only || tens.second->isComposite()) names.emplace_back(tens.second->getName());
+ }
+ std::sort(names.begin(),names.end());
+ return names;
+}
+
 bool NumServer::destroyTensors()
 {
  bool success = true;
- while(!tensors_.empty()){
-  const auto tens_name = tensors_.begin()->first;
-  success = destroyTensor(tens_name);
-  if(!success) break;
+ for(const auto & tens_name: getSortedTensorNames(false)){ //same order on all processes
+  if(tensors_.find(lookupNameId(tens_name)) != tensors_.end()){
+   success = destroyTensor(tens_name);
+   if(!success) break;
+  }
+ }
+ if(success){
+  std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+  block_sparse_tensors_.clear(); //all stored blocks have been destroyed
+  structured_tensors_.clear();
  }
  return success;
 }
@@ -1659,10 +3821,258 @@ bool NumServer::destroyTensors()
 bool NumServer::destroyTensorsSync()
 {
  bool success = true;
- while(!tensors_.empty()){
-  const auto tens_name = tensors_.begin()->first;
-  success = destroyTensorSync(tens_name);
-  if(!success) break;
+ for(const auto & tens_name: getSortedTensorNames(false)){ //same order on all processes
+  if(tensors_.find(lookupNameId(tens_name)) != tensors_.end()){
+   success = destroyTensorSync(tens_name);
+   if(!success) break;
+  }
+ }
+ if(success){
+  std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+  block_sparse_tensors_.clear(); //all stored blocks have been destroyed
+  structured_tensors_.clear();
+ }
+ return success;
+}
+
+bool NumServer::createTensorBlockSparse(std::shared_ptr<TensorBlockSparse> tensor,
+                                        TensorElementType element_type)
+{
+ return createTensorBlockSparse(getDefaultProcessGroup(),tensor,element_type);
+}
+
+bool NumServer::createTensorBlockSparse(const ProcessGroup & process_group,
+                                        std::shared_ptr<TensorBlockSparse> tensor,
+                                        TensorElementType element_type)
+{
+ if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ assert(tensor);
+ std::unique_lock<std::recursive_mutex> lock(tensor_mtx_);
+ auto res = block_sparse_tensors_.emplace(std::make_pair(tensor->getName(),tensor));
+ lock.unlock();
+ if(!res.second){
+  std::cout << "#ERROR(exatn::NumServer::createTensorBlockSparse): Block-sparse tensor " << tensor->getName()
+            << " already exists!" << std::endl << std::flush;
+  return false;
+ }
+ bool success = true;
+ for(auto & block: *tensor){
+  success = createTensor(process_group,block.second,element_type); if(!success) break;
+ }
+ if(success){
+  if(logging_ > 0) logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+   << "]: Created block-sparse tensor <" << tensor->getName() << ">: Stored blocks = " << tensor->getNumBlocks()
+   << " out of " << tensor->getNumBlocksComplete() << "; Stored volume = " << tensor->getStoredVolume()
+   << " out of " << tensor->getVolume() << std::endl << std::flush;
+ }
+ return success;
+}
+
+std::shared_ptr<TensorBlockSparse> NumServer::getTensorBlockSparse(const std::string & name)
+{
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+ auto iter = block_sparse_tensors_.find(name);
+ if(iter == block_sparse_tensors_.end()) return std::shared_ptr<TensorBlockSparse>(nullptr);
+ return iter->second;
+}
+
+bool NumServer::destroyTensorBlockSparse(const std::string & name)
+{
+ auto tensor = getTensorBlockSparse(name);
+ if(!tensor) return true;
+ bool success = true;
+ for(auto & block: *tensor){
+  success = destroyTensor(block.second->getName()); if(!success) break;
+ }
+ if(success){
+  std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+  block_sparse_tensors_.erase(name);
+ }
+ return success;
+}
+
+bool NumServer::createTensorStructured(std::shared_ptr<TensorStructured> tensor)
+{
+ assert(tensor);
+ if(tensorAllocated(tensor->getName())){
+  std::cout << "#ERROR(exatn::NumServer::createTensorStructured): Tensor " << tensor->getName()
+            << " already exists!" << std::endl << std::flush;
+  return false;
+ }
+ std::unique_lock<std::recursive_mutex> lock(tensor_mtx_);
+ auto res = structured_tensors_.emplace(std::make_pair(tensor->getName(),tensor));
+ lock.unlock();
+ if(!res.second){
+  std::cout << "#ERROR(exatn::NumServer::createTensorStructured): Structured tensor " << tensor->getName()
+            << " already exists!" << std::endl << std::flush;
+  return false;
+ }
+ return true;
+}
+
+std::shared_ptr<TensorStructured> NumServer::getTensorStructured(const std::string & name)
+{
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+ auto iter = structured_tensors_.find(name);
+ if(iter == structured_tensors_.end()) return std::shared_ptr<TensorStructured>(nullptr);
+ return iter->second;
+}
+
+bool NumServer::destroyTensorStructured(const std::string & name)
+{
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+ structured_tensors_.erase(name);
+ return true;
+}
+
+bool NumServer::initTensorBlockSparseRnd(const std::string & name)
+{
+ auto tensor = getTensorBlockSparse(name);
+ if(!tensor) return false;
+ bool success = true;
+ for(auto & block: *tensor){
+  success = initTensorRnd(block.second->getName()); if(!success) break;
+ }
+ return success;
+}
+
+bool NumServer::computeNorm2BlockSparseSync(const std::string & name,
+                                            double & norm)
+{
+ norm = -1.0;
+ auto tensor = getTensorBlockSparse(name);
+ if(!tensor) return true;
+ std::vector<std::future<double>> block_norms;
+ for(auto & block: *tensor) block_norms.emplace_back(computeNorm2Async(block.second->getName()));
+ bool success = true;
+ double norm2 = 0.0;
+ for(auto & block_norm: block_norms){
+  const double value = block_norm.get();
+  if(value >= 0.0){
+   norm2 += value * value;
+  }else{
+   success = false;
+  }
+ }
+ if(success) norm = std::sqrt(norm2);
+ return success;
+}
+
+static bool same_symmetry_sectors(const TensorBlockSparse & tensor1, unsigned int dimensn1,
+                                  const TensorBlockSparse & tensor2, unsigned int dimensn2)
+{
+ const auto & sectors1 = tensor1.getSectors(dimensn1);
+ const auto & sectors2 = tensor2.getSectors(dimensn2);
+ if(sectors1.size() != sectors2.size()) return false;
+ for(unsigned int i = 0; i < sectors1.size(); ++i){
+  if(sectors1[i].lower != sectors2[i].lower || sectors1[i].upper != sectors2[i].upper ||
+     sectors1[i].symm_id != sectors2[i].symm_id) return false;
+ }
+ return true;
+}
+
+bool NumServer::submitBlockSparseContraction(const std::string & contraction,
+                                             std::complex<double> alpha,
+                                             bool synchronous)
+{
+ auto parsed_op = parseTensorOperation(contraction,TensorOpCode::CONTRACT);
+ if(!parsed_op) return false;
+ std::vector<std::shared_ptr<TensorBlockSparse>> tensors;
+ for(const auto & tensor_name: parsed_op->tensor_names){
+  auto tensor = getTensorBlockSparse(tensor_name);
+  if(!tensor) return true; //current process does not participate
+  tensors.emplace_back(tensor);
+ }
+ //Check the symmetry consistency (complex conjugation reverses the quantum numbers):
+ const auto & out = *(tensors[0]);
+ const auto & left = *(tensors[1]);
+ const auto & right = *(tensors[2]);
+ const int left_sign = parsed_op->conjugated[1] ? -1 : 1;
+ const int right_sign = parsed_op->conjugated[2] ? -1 : 1;
+ const auto modulus = out.getModulus();
+ long long charge_mismatch = static_cast<long long>(out.getTotalCharge())
+  - left_sign * static_cast<long long>(left.getTotalCharge()) - right_sign * static_cast<long long>(right.getTotalCharge());
+ if(modulus > 0) charge_mismatch %= static_cast<long long>(modulus);
+ bool consistent = (left.getModulus() == modulus && right.getModulus() == modulus && charge_mismatch == 0 &&
+                    parsed_op->hyper_inds.empty());
+ for(const auto & index: parsed_op->left_inds){
+  if(!consistent) break;
+  consistent = same_symmetry_sectors(out,index.arg_pos[0],left,index.arg_pos[1]) &&
+               (out.getDimDirection(index.arg_pos[0]) == left_sign * left.getDimDirection(index.arg_pos[1]));
+ }
+ for(const auto & index: parsed_op->right_inds){
+  if(!consistent) break;
+  consistent = same_symmetry_sectors(out,index.arg_pos[0],right,index.arg_pos[2]) &&
+               (out.getDimDirection(index.arg_pos[0]) == right_sign * right.getDimDirection(index.arg_pos[2]));
+ }
+ for(const auto & index: parsed_op->contr_inds){
+  if(!consistent) break;
+  consistent = same_symmetry_sectors(left,index.arg_pos[1],right,index.arg_pos[2]) &&
+               (left_sign * left.getDimDirection(index.arg_pos[1]) == -(right_sign * right.getDimDirection(index.arg_pos[2])));
+ }
+ if(!consistent){
+  std::cout << "#ERROR(exatn::NumServer::contractTensorsBlockSparse): Inconsistent symmetry of the block-sparse tensors in "
+            << contraction << std::endl << std::flush;
+  return false;
+ }
+ //Group the stored right blocks by the symmetry sectors of their contracted dimensions:
+ const auto num_contr = parsed_op->contr_inds.size();
+ std::map<std::vector<unsigned int>,std::vector<unsigned long long>> right_blocks;
+ std::vector<unsigned int> contr_sectors(num_contr);
+ for(const auto & block: right){
+  const auto sectors = right.getBlockSectors(block.first);
+  for(unsigned int i = 0; i < num_contr; ++i) contr_sectors[i] = sectors[parsed_op->contr_inds[i].arg_pos[2]];
+  right_blocks[contr_sectors].emplace_back(block.first);
+ }
+ //Generate dense tensor contractions for all matching pairs of stored blocks:
+ std::vector<std::shared_ptr<TensorOperation>> operations;
+ std::vector<unsigned int> out_sectors(out.getRank());
+ double block_flops = 0.0;
+ for(const auto & left_block: left){
+  const auto left_sectors = left.getBlockSectors(left_block.first);
+  for(unsigned int i = 0; i < num_contr; ++i) contr_sectors[i] = left_sectors[parsed_op->contr_inds[i].arg_pos[1]];
+  auto matches = right_blocks.find(contr_sectors);
+  if(matches == right_blocks.end()) continue;
+  for(const auto right_block_id: matches->second){
+   const auto right_sectors = right.getBlockSectors(right_block_id);
+   for(const auto & index: parsed_op->left_inds) out_sectors[index.arg_pos[0]] = left_sectors[index.arg_pos[1]];
+   for(const auto & index: parsed_op->right_inds) out_sectors[index.arg_pos[0]] = right_sectors[index.arg_pos[2]];
+   auto out_block = out[out.getBlockId(out_sectors)]; assert(out_block); //allowed by symmetry consistency
+   auto right_block = right[right_block_id];
+   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CONTRACT);
+   op->setTensorOperand(out_block);
+   op->setTensorOperand(left_block.second,parsed_op->conjugated[1]);
+   op->setTensorOperand(right_block,parsed_op->conjugated[2]);
+   op->setIndexPattern(parsed_op->pattern);
+   op->setScalar(0,alpha);
+   operations.emplace_back(op);
+   block_flops += std::sqrt(static_cast<double>(out_block->getVolume()) * static_cast<double>(left_block.second->getVolume())
+                            * static_cast<double>(right_block->getVolume()));
+  }
+ }
+ if(operations.empty()) return true; //all block pairs are forbidden by symmetry
+ //Submit all dense block contractions as a single batch:
+ const auto & process_group = getTensorProcessGroup(operations[0]->getTensorOperand(0)->getName(),
+                                                    operations[0]->getTensorOperand(1)->getName(),
+                                                    operations[0]->getTensorOperand(2)->getName());
+ bool success = submit(operations,getTensorMapper(process_group));
+ if(success){
+  if(logging_ > 0){
+   const double dense_flops = std::sqrt(static_cast<double>(out.getVolume()) * static_cast<double>(left.getVolume())
+                                        * static_cast<double>(right.getVolume()));
+   logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+    << "]: Submitted block-sparse tensor contraction " << contraction << " as " << operations.size()
+    << " dense block contractions: Flop fraction = " << std::scientific << (block_flops / dense_flops)
+    << std::endl << std::flush;
+  }
+  if(synchronous){
+   for(auto & op: operations){
+    success = sync(*op); if(!success) break;
+   }
+#ifdef MPI_ENABLED
+   if(success) success = sync(process_group);
+#endif
+  }
  }
  return success;
 }
@@ -1673,15 +4083,26 @@ bool NumServer::initTensorFile(const std::string & name,
  return transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitFile(filename)));
 }
 
-bool NumServer::initTensorFileSync(const std::string & name,
-                                   const std::string & filename)
+bool NumServer::initTensorFileSync(const std::string & name,
+                                   const std::string & filename)
+{
+ return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitFile(filename)));
+}
+
+void NumServer::resetRandomSeed(std::uint64_t seed)
+{
+ rnd_seed_ = seed;
+ return;
+}
+
+std::uint64_t NumServer::getRandomSeed() const
 {
- return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitFile(filename)));
+ return rnd_seed_;
 }
 
 bool NumServer::initTensorRnd(const std::string & name)
 {
- bool success = transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitRnd()));
+ bool success = transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitRnd(rnd_seed_,name)));
  if(success){
   auto tensor = getTensor(name);
   if(tensor != nullptr){
@@ -1691,11 +4112,11 @@ bool NumServer::initTensorRnd(const std::string & name)
    }else{
     if(tensor->hasIsometries()){
      const auto & isometries = tensor->retrieveIsometries();
-     success = transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-    }
-    if(success){
-     const auto & process_group = getTensorProcessGroup(name);
-     success = broadcastTensor(process_group,name,0);
+     success = transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()),isometrize_method_)));
+     if(success){ //the isometrized replicas may numerically differ
+      const auto & process_group = getTensorProcessGroup(name);
+      success = broadcastTensor(process_group,name,0);
+     }
     }
    }
   }
@@ -1705,7 +4126,7 @@ bool NumServer::initTensorRnd(const std::string & name)
 
 bool NumServer::initTensorRndSync(const std::string & name)
 {
- bool success = transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitRnd()));
+ bool success = transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitRnd(rnd_seed_,name)));
  if(success){
   auto tensor = getTensor(name);
   if(tensor != nullptr){
@@ -1715,11 +4136,11 @@ bool NumServer::initTensorRndSync(const std::string & name)
    }else{
     if(tensor->hasIsometries()){
      const auto & isometries = tensor->retrieveIsometries();
-     success = transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-    }
-    if(success){
-     const auto & process_group = getTensorProcessGroup(name);
-     success = broadcastTensorSync(process_group,name,0);
+     success = transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()),isometrize_method_)));
+     if(success){ //the isometrized replicas may numerically differ
+      const auto & process_group = getTensorProcessGroup(name);
+      success = broadcastTensorSync(process_group,name,0);
+     }
     }
    }
   }
@@ -1729,83 +4150,110 @@ bool NumServer::initTensorRndSync(const std::string & name)
 
 bool NumServer::initTensorsRnd(TensorNetwork & tensor_network)
 {
- bool success = true;
- for(auto tens = tensor_network.cbegin(); tens != tensor_network.cend(); ++tens){
-  auto tensor = tens->second.getTensor();
-  const auto & tens_name = tensor->getName();
-  if(tens->first != 0){ //input tensor
-   if(tensorAllocated(tens_name)){
-    if(tens->second.isOptimizable()) success = initTensorRnd(tens_name);
-   }else{
-    success = false;
-   }
-  }else{ //output tensor
-   if(tensorAllocated(tens_name)) success = initTensor(tens_name,0.0);
-  }
-  if(!success) break;
- }
+ std::vector<std::pair<std::string,bool>> tensors;
+ std::unordered_set<std::string> names;
+ bool success = collectRandomInitTensors(tensor_network,tensors,names);
+ if(success) success = initTensorBatchRnd(tensors,false);
  return success;
 }
 
 bool NumServer::initTensorsRndSync(TensorNetwork & tensor_network)
 {
+ std::vector<std::pair<std::string,bool>> tensors;
+ std::unordered_set<std::string> names;
+ bool success = collectRandomInitTensors(tensor_network,tensors,names);
+ if(success) success = initTensorBatchRnd(tensors,true);
+ return success;
+}
+
+bool NumServer::initTensorsRnd(TensorExpansion & tensor_expansion)
+{
+ std::vector<std::pair<std::string,bool>> tensors;
+ std::unordered_set<std::string> names;
  bool success = true;
- for(auto tens = tensor_network.cbegin(); tens != tensor_network.cend(); ++tens){
-  auto tensor = tens->second.getTensor();
-  const auto & tens_name = tensor->getName();
-  if(tens->first != 0){ //input tensor
-   if(tensorAllocated(tens_name)){
-    if(tens->second.isOptimizable()) success = initTensorRndSync(tens_name);
-   }else{
-    success = false;
-   }
-  }else{ //output tensor
-   if(tensorAllocated(tens_name)) success = initTensorSync(tens_name,0.0);
-  }
-  if(!success) break;
+ for(auto tensor_network = tensor_expansion.begin(); tensor_network != tensor_expansion.end(); ++tensor_network){
+  success = collectRandomInitTensors(*(tensor_network->network),tensors,names); if(!success) break;
  }
+ if(success) success = initTensorBatchRnd(tensors,false);
  return success;
 }
 
-bool NumServer::initTensorsRnd(TensorExpansion & tensor_expansion)
+bool NumServer::initTensorsRndSync(TensorExpansion & tensor_expansion)
 {
+ std::vector<std::pair<std::string,bool>> tensors;
+ std::unordered_set<std::string> names;
  bool success = true;
- for(auto tensor_network = tensor_expansion.cbegin(); tensor_network != tensor_expansion.cend(); ++tensor_network){
-  for(auto tens = tensor_network->network->cbegin(); tens != tensor_network->network->cend(); ++tens){
-   auto tensor = tens->second.getTensor();
-   const auto & tens_name = tensor->getName();
-   if(tens->first != 0){ //input tensor
-    if(tensorAllocated(tens_name)){
-     if(tens->second.isOptimizable()) success = initTensorRnd(tens_name);
-    }else{
-     success = false;
-    }
-   }else{ //output tensor
-    if(tensorAllocated(tens_name)) success = initTensor(tens_name,0.0);
+ for(auto tensor_network = tensor_expansion.begin(); tensor_network != tensor_expansion.end(); ++tensor_network){
+  success = collectRandomInitTensors(*(tensor_network->network),tensors,names); if(!success) break;
+ }
+ if(success) success = initTensorBatchRnd(tensors,true);
+ return success;
+}
+
+bool NumServer::collectRandomInitTensors(const TensorNetwork & tensor_network,
+                                         std::vector<std::pair<std::string,bool>> & tensors,
+                                         std::unordered_set<std::string> & names)
+{
+ for(auto tens = tensor_network.cbegin(); tens != tensor_network.cend(); ++tens){
+  const auto & tens_name = tens->second.getName();
+  if(tens->first != 0){ //input tensor
+   if(!tensorAllocated(tens_name)) return false;
+   if(tens->second.isOptimizable()){
+    if(names.emplace(tens_name).second) tensors.emplace_back(std::make_pair(tens_name,true));
+   }
+  }else{ //output tensor
+   if(tensorAllocated(tens_name)){
+    if(names.emplace(tens_name).second) tensors.emplace_back(std::make_pair(tens_name,false));
    }
-   if(!success) break;
   }
  }
- return success;
+ return true;
 }
 
-bool NumServer::initTensorsRndSync(TensorExpansion & tensor_expansion)
+bool NumServer::initTensorBatchRnd(const std::vector<std::pair<std::string,bool>> & tensors,
+                                   bool synchronous)
 {
+ if(tensors.empty()) return true;
+ //Submit all initializations to the tensor runtime at once:
+ std::vector<std::string> isometric; //isometrized tensors
  bool success = true;
- for(auto tensor_network = tensor_expansion.cbegin(); tensor_network != tensor_expansion.cend(); ++tensor_network){
-  for(auto tens = tensor_network->network->cbegin(); tens != tensor_network->network->cend(); ++tens){
-   auto tensor = tens->second.getTensor();
-   const auto & tens_name = tensor->getName();
-   if(tens->first != 0){ //input tensor
-    if(tensorAllocated(tens_name)){
-     if(tens->second.isOptimizable()) success = initTensorRndSync(tens_name);
-    }else{
-     success = false;
-    }
-   }else{ //output tensor
-    if(tensorAllocated(tens_name)) success = initTensorSync(tens_name,0.0);
+ beginBatch();
+ for(const auto & tens: tensors){
+  const auto & tens_name = tens.first;
+  if(tens.second){ //random initialization
+   auto tensor = getTensor(tens_name);
+   if(tensor != nullptr && tensor->isComposite()){
+    std::cout << "#ERROR(exatn::initTensorsRnd): Random initialization of composite tensors is not implemented yet!\n";
+    assert(false);
    }
-   if(!success) break;
+   success = transformTensor(tens_name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitRnd(rnd_seed_,tens_name)));
+   if(success && tensor != nullptr && tensor->hasIsometries()){
+    const auto & isometries = tensor->retrieveIsometries();
+    success = transformTensor(tens_name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()),isometrize_method_)));
+    isometric.emplace_back(tens_name);
+   }
+  }else{ //zero initialization
+   success = initTensor(tens_name,0.0);
+  }
+  if(!success) break;
+ }
+ endBatch();
+ //The isometrized replicas may numerically differ:
+ for(const auto & tens_name: isometric){
+  if(!success) break;
+  const auto & process_group = getTensorProcessGroup(tens_name);
+  success = synchronous ? broadcastTensorSync(process_group,tens_name,0) : broadcastTensor(process_group,tens_name,0);
+ }
+ //Single synchronization per process group:
+ if(success && synchronous){
+  std::vector<ProcessGroup> process_groups;
+  for(const auto & tens: tensors){
+   const auto & process_group = getTensorProcessGroup(tens.first);
+   if(std::find(process_groups.cbegin(),process_groups.cend(),process_group) == process_groups.cend())
+    process_groups.emplace_back(process_group);
+  }
+  for(const auto & process_group: process_groups){
+   success = sync(process_group); if(!success) break;
   }
  }
  return success;
@@ -1855,124 +4303,116 @@ bool NumServer::initTensorsSpecialSync(TensorNetwork & tensor_network)
  return success;
 }
 
-bool NumServer::computeMaxAbsSync(const std::string & name,
-                                  double & norm)
+std::future<double> NumServer::computeMaxAbsAsync(const std::string & name)
 {
- norm = -1.0;
- auto iter = tensors_.find(name);
- if(iter == tensors_.end()){
-  //std::cout << "#ERROR(exatn::NumServer::computeMaxAbsSync): Tensor " << name << " not found!" << std::endl;
-  return true;
- }
- const auto & process_group = getTensorProcessGroup(name);
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return makeReadyFuture(-1.0);
+ const auto process_group = getTensorProcessGroup(name);
  auto tensor_mapper = getTensorMapper(process_group);
  auto functor = std::shared_ptr<TensorMethod>(new numerics::FunctorMaxAbs());
  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
  op->setTensorOperand(iter->second);
  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetFunctor(functor);
- auto submitted = submit(op,tensor_mapper);
- if(submitted){
-  submitted = sync(*op);
-  if(submitted){
+ std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetReadOnly(true);
+ op->setPriority(TensorOpPriority::INTERACTIVE); //latency-sensitive query
+ if(!submit(op,tensor_mapper)) return makeReadyFuture(-1.0);
+ return std::async(std::launch::deferred,[this,op,functor,process_group](){
+  double norm = -1.0;
+  auto synced = sync(*op);
+  if(synced){
    norm = std::dynamic_pointer_cast<numerics::FunctorMaxAbs>(functor)->getNorm();
 #ifdef MPI_ENABLED
    if(op->isComposite()){
     int errc = MPI_Allreduce(MPI_IN_PLACE,&norm,1,MPI_DOUBLE,MPI_MAX,process_group.getMPICommProxy().getRef<MPI_Comm>());
     assert(errc == MPI_SUCCESS);
    }else{
-    if(submitted) submitted = sync(process_group);
+    if(!sync(process_group)) norm = -1.0;
    }
 #endif
   }
- }
- return submitted;
+  return norm;
+ });
 }
 
-bool NumServer::computeNorm1Sync(const std::string & name,
-                                 double & norm)
+std::future<double> NumServer::computeNorm1Async(const std::string & name)
 {
- norm = -1.0;
- auto iter = tensors_.find(name);
- if(iter == tensors_.end()){
-  //std::cout << "#ERROR(exatn::NumServer::computeNorm1Sync): Tensor " << name << " not found!" << std::endl;
-  return true;
- }
- const auto & process_group = getTensorProcessGroup(name);
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return makeReadyFuture(-1.0);
+ const auto process_group = getTensorProcessGroup(name);
  auto tensor_mapper = getTensorMapper(process_group);
  auto functor = std::shared_ptr<TensorMethod>(new numerics::FunctorNorm1());
  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
  op->setTensorOperand(iter->second);
  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetFunctor(functor);
- auto submitted = submit(op,tensor_mapper);
- if(submitted){
-  submitted = sync(*op);
-  if(submitted){
+ std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetReadOnly(true);
+ op->setPriority(TensorOpPriority::INTERACTIVE); //latency-sensitive query
+ if(!submit(op,tensor_mapper)) return makeReadyFuture(-1.0);
+ auto tensor = iter->second;
+ return std::async(std::launch::deferred,[this,op,functor,process_group,tensor]() mutable {
+  double norm = -1.0;
+  auto synced = sync(*op);
+  if(synced){
    norm = std::dynamic_pointer_cast<numerics::FunctorNorm1>(functor)->getNorm();
 #ifdef MPI_ENABLED
    if(op->isComposite()){
     int errc = MPI_Allreduce(MPI_IN_PLACE,&norm,1,MPI_DOUBLE,MPI_SUM,process_group.getMPICommProxy().getRef<MPI_Comm>());
     assert(errc == MPI_SUCCESS);
-    norm /= static_cast<double>(replication_level(process_group,iter->second));
+    norm /= static_cast<double>(replication_level(process_group,tensor));
    }else{
-    if(submitted) submitted = sync(process_group);
+    if(!sync(process_group)) norm = -1.0;
    }
 #endif
   }
- }
- return submitted;
+  return norm;
+ });
 }
 
-bool NumServer::computeNorm2Sync(const std::string & name,
-                                 double & norm)
+std::future<double> NumServer::computeNorm2Async(const std::string & name)
 {
- norm = -1.0;
- auto iter = tensors_.find(name);
- if(iter == tensors_.end()){
-  //std::cout << "#ERROR(exatn::NumServer::computeNorm2Sync): Tensor " << name << " not found!" << std::endl;
-  return true;
- }
- const auto & process_group = getTensorProcessGroup(name);
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return makeReadyFuture(-1.0);
+ const auto process_group = getTensorProcessGroup(name);
  auto tensor_mapper = getTensorMapper(process_group);
  auto functor = std::shared_ptr<TensorMethod>(new numerics::FunctorNorm2());
  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
  op->setTensorOperand(iter->second);
  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetFunctor(functor);
- auto submitted = submit(op,tensor_mapper);
- if(submitted){
-  submitted = sync(*op);
-  if(submitted){
+ std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetReadOnly(true);
+ op->setPriority(TensorOpPriority::INTERACTIVE); //latency-sensitive query
+ if(!submit(op,tensor_mapper)) return makeReadyFuture(-1.0);
+ auto tensor = iter->second;
+ return std::async(std::launch::deferred,[this,op,functor,process_group,tensor]() mutable {
+  double norm = -1.0;
+  auto synced = sync(*op);
+  if(synced){
    norm = std::dynamic_pointer_cast<numerics::FunctorNorm2>(functor)->getNorm();
 #ifdef MPI_ENABLED
    if(op->isComposite()){
     auto norm2 = norm * norm;
     int errc = MPI_Allreduce(MPI_IN_PLACE,&norm2,1,MPI_DOUBLE,MPI_SUM,process_group.getMPICommProxy().getRef<MPI_Comm>());
     assert(errc == MPI_SUCCESS);
-    norm2 /= static_cast<double>(replication_level(process_group,iter->second));
+    norm2 /= static_cast<double>(replication_level(process_group,tensor));
     norm = std::sqrt(norm2);
    }else{
-    if(submitted) submitted = sync(process_group);
+    if(!sync(process_group)) norm = -1.0;
    }
 #endif
   }
- }
- return submitted;
+  return norm;
+ });
 }
 
-bool NumServer::computePartialNormsSync(const std::string & name,            //in: tensor name
-                                        unsigned int tensor_dimension,       //in: chosen tensor dimension
-                                        std::vector<double> & partial_norms) //out: partial 2-norms over the chosen tensor dimension
+std::future<std::vector<double>> NumServer::computePartialNormsAsync(const std::string & name,
+                                                                     unsigned int tensor_dimension)
 {
- auto iter = tensors_.find(name);
- if(iter == tensors_.end()){
-  //std::cout << "#ERROR(exatn::NumServer::computePartialNormsSync): Tensor " << name << " not found!" << std::endl;
-  return true;
- }
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return makeReadyFuture(std::vector<double>());
  if(tensor_dimension >= iter->second->getRank()){
-  std::cout << "#ERROR(exatn::NumServer::computePartialNormsSync): Chosen tensor dimension " << tensor_dimension
+  std::cout << "#ERROR(exatn::NumServer::computePartialNormsAsync): Chosen tensor dimension " << tensor_dimension
             << " does not exist for tensor " << name << std::endl << std::flush;
-  return false;
+  return makeReadyFuture(std::vector<double>());
  }
- const auto & process_group = getTensorProcessGroup(name);
+ const auto process_group = getTensorProcessGroup(name);
  auto tensor_mapper = getTensorMapper(process_group);
  const auto dim_extent = iter->second->getDimExtent(tensor_dimension);
  const auto dim_space = iter->second->getDimSpaceAttr(tensor_dimension);
@@ -1988,13 +4428,16 @@ bool NumServer::computePartialNormsSync(const std::string & name,            //i
  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
  op->setTensorOperand(iter->second);
  std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetFunctor(functor);
- auto submitted = submit(op,tensor_mapper);
- if(submitted){
-  submitted = sync(*op);
-  if(submitted){
+ std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetReadOnly(true);
+ op->setPriority(TensorOpPriority::INTERACTIVE); //latency-sensitive query
+ if(!submit(op,tensor_mapper)) return makeReadyFuture(std::vector<double>());
+ auto tensor = iter->second;
+ return std::async(std::launch::deferred,[this,op,functor,process_group,tensor,dim_extent]() mutable {
+  std::vector<double> partial_norms;
+  auto synced = sync(*op);
+  if(synced){
    const auto & norms = std::dynamic_pointer_cast<numerics::FunctorDiagRank>(functor)->getPartialNorms();
-   submitted = !norms.empty();
-   if(submitted){
+   if(!norms.empty()){
     if(op->isComposite()){
 #ifdef MPI_ENABLED
      partial_norms.resize(dim_extent);
@@ -2002,32 +4445,155 @@ bool NumServer::computePartialNormsSync(const std::string & name,            //i
      int errc = MPI_Allreduce(norms.data(),partial_norms.data(),static_cast<int>(dim_extent),
                               MPI_DOUBLE,MPI_SUM,process_group.getMPICommProxy().getRef<MPI_Comm>());
      assert(errc == MPI_SUCCESS);
-     for(auto & pnrm: partial_norms) pnrm /= static_cast<double>(replication_level(process_group,iter->second));
+     for(auto & pnrm: partial_norms) pnrm /= static_cast<double>(replication_level(process_group,tensor));
 #else
      partial_norms.assign(norms.cbegin(),norms.cend());
 #endif
     }else{
      partial_norms.assign(norms.cbegin(),norms.cend());
 #ifdef MPI_ENABLED
-     if(submitted) submitted = sync(process_group);
+     if(!sync(process_group)) partial_norms.clear();
 #endif
     }
    }
   }
+  return partial_norms;
+ });
+}
+
+bool NumServer::computeMaxAbsSync(const std::string & name,
+                                  double & norm)
+{
+ norm = -1.0;
+ if(tensors_.find(lookupNameId(name)) == tensors_.end()) return true;
+ norm = computeMaxAbsAsync(name).get();
+ return (norm >= 0.0);
+}
+
+bool NumServer::computeNorm1Sync(const std::string & name,
+                                 double & norm)
+{
+ norm = -1.0;
+ if(tensors_.find(lookupNameId(name)) == tensors_.end()) return true;
+ norm = computeNorm1Async(name).get();
+ return (norm >= 0.0);
+}
+
+bool NumServer::computeNorm2Sync(const std::string & name,
+                                 double & norm)
+{
+ norm = -1.0;
+ if(tensors_.find(lookupNameId(name)) == tensors_.end()) return true;
+ norm = computeNorm2Async(name).get();
+ return (norm >= 0.0);
+}
+
+bool NumServer::computePartialNormsSync(const std::string & name,            //in: tensor name
+                                        unsigned int tensor_dimension,       //in: chosen tensor dimension
+                                        std::vector<double> & partial_norms) //out: partial 2-norms over the chosen tensor dimension
+{
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return true;
+ if(tensor_dimension >= iter->second->getRank()){
+  std::cout << "#ERROR(exatn::NumServer::computePartialNormsSync): Chosen tensor dimension " << tensor_dimension
+            << " does not exist for tensor " << name << std::endl << std::flush;
+  return false;
  }
- return submitted;
+ partial_norms = computePartialNormsAsync(name,tensor_dimension).get();
+ return !(partial_norms.empty());
 }
 
 bool NumServer::computeNorms2Sync(const TensorNetwork & network,
                                   std::map<std::string,double> & norms)
 {
- bool success = true;
  norms.clear();
+ std::vector<std::string> names;
  for(auto tens = network.cbegin(); tens != network.cend(); ++tens){
   auto res = norms.emplace(std::make_pair(tens->second.getName(),0.0));
-  if(res.second){
-   success = computeNorm2Sync(tens->second.getName(),res.first->second);
-   if(!success) break;
+  if(res.second) names.emplace_back(tens->second.getName());
+ }
+ std::vector<TensorNorms> tensor_norms;
+ bool success = computeNormsSync(names,tensor_norms);
+ if(success){
+  for(std::size_t i = 0; i < names.size(); ++i) norms[names[i]] = tensor_norms[i].norm2;
+ }
+ return success;
+}
+
+bool NumServer::computeNormsSync(const std::vector<std::string> & names,
+                                 std::vector<TensorNorms> & norms)
+{
+ return computeNormsSync(getDefaultProcessGroup(),names,norms);
+}
+
+bool NumServer::computeNormsSync(const ProcessGroup & process_group,
+                                 const std::vector<std::string> & names,
+                                 std::vector<TensorNorms> & norms)
+{
+ norms.assign(names.size(),TensorNorms{});
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ //Submit a fused norm computation for each existing tensor:
+ std::vector<std::shared_ptr<TensorOperation>> ops(names.size());
+ std::vector<std::shared_ptr<numerics::FunctorNorms>> functors(names.size());
+ std::vector<std::pair<ProcessGroup,std::vector<std::size_t>>> groups; //process group --> tensor positions
+ bool success = true;
+ for(std::size_t i = 0; i < names.size(); ++i){
+  auto iter = tensors_.find(lookupNameId(names[i]));
+  if(iter != tensors_.end()){
+   const auto tensor_group = getTensorProcessGroup(names[i]);
+   if(tensor_group.rankIsIn(process_rank_)){
+    functors[i] = std::make_shared<numerics::FunctorNorms>();
+    ops[i] = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+    ops[i]->setTensorOperand(iter->second);
+    std::dynamic_pointer_cast<numerics::TensorOpTransform>(ops[i])->resetFunctor(functors[i]);
+    std::dynamic_pointer_cast<numerics::TensorOpTransform>(ops[i])->resetReadOnly(true);
+    ops[i]->setPriority(TensorOpPriority::INTERACTIVE); //latency-sensitive query
+    success = submit(ops[i],getTensorMapper(tensor_group));
+    if(!success) break;
+    auto group = std::find_if(groups.begin(),groups.end(),
+                              [&tensor_group](const auto & entry){return entry.first == tensor_group;});
+    if(group == groups.end()){
+     groups.emplace_back(std::make_pair(tensor_group,std::vector<std::size_t>{}));
+     group = groups.end() - 1;
+    }
+    group->second.emplace_back(i);
+   }
+  }
+ }
+ for(auto & op: ops) if(op) success = sync(*op) && success;
+ if(!success) return false;
+ //Reduce the partial norms with a single collective per process group:
+ for(const auto & group: groups){
+  const auto & positions = group.second;
+  std::vector<double> partial_norms(positions.size()*3);
+  for(std::size_t j = 0; j < positions.size(); ++j){
+   const auto partial = functors[positions[j]]->getPartialNorms();
+   std::copy(partial.cbegin(),partial.cend(),&(partial_norms[j*3]));
+  }
+#ifdef MPI_ENABLED
+  unsigned int group_rank = 0;
+  group.first.rankIsIn(process_rank_,&group_rank);
+  if(group.first.getSize() > 1){
+   for(std::size_t j = 0; j < positions.size(); ++j){ //replicated tensors are only summed once
+    if(!(ops[positions[j]]->isComposite()) && group_rank != 0){partial_norms[j*3] = 0.0; partial_norms[j*3+1] = 0.0;}
+   }
+   const auto & mpi_partial_norms = get_mpi_partial_norms();
+   int errc = MPI_Allreduce(MPI_IN_PLACE,partial_norms.data(),static_cast<int>(positions.size()),
+                            mpi_partial_norms.kind,mpi_partial_norms.reduce,
+                            group.first.getMPICommProxy().getRef<MPI_Comm>());
+   if(errc != MPI_SUCCESS) return false;
+   for(std::size_t j = 0; j < positions.size(); ++j){
+    if(ops[positions[j]]->isComposite()){
+     auto tensor = ops[positions[j]]->getTensorOperand(0);
+     const auto repl_level = static_cast<double>(replication_level(group.first,tensor));
+     partial_norms[j*3] /= repl_level; partial_norms[j*3+1] /= repl_level;
+    }
+   }
+  }
+#endif
+  for(std::size_t j = 0; j < positions.size(); ++j){
+   norms[positions[j]] = TensorNorms{partial_norms[j*3],std::sqrt(partial_norms[j*3+1]),partial_norms[j*3+2]};
   }
  }
  return success;
@@ -2048,8 +4614,9 @@ bool NumServer::replicateTensor(const ProcessGroup & process_group, const std::s
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  //Broadcast the tensor meta-data:
+ auto & byte_packet = getThreadBytePacket(); //thread-local byte packet
  int byte_packet_len = 0;
  if(local_rank == root_process_rank){
   if(iter != tensors_.end()){
@@ -2058,8 +4625,8 @@ bool NumServer::replicateTensor(const ProcessGroup & process_group, const std::s
               << " is composite, replication not allowed!" << std::endl << std::flush;
     assert(false);
    }
-   iter->second->pack(byte_packet_);
-   byte_packet_len = static_cast<int>(byte_packet_.size_bytes); assert(byte_packet_len > 0);
+   iter->second->pack(byte_packet);
+   byte_packet_len = static_cast<int>(byte_packet.size_bytes); assert(byte_packet_len > 0);
   }else{
    std::cout << "#ERROR(exatn::NumServer::replicateTensor): Tensor " << name << " not found at root!" << std::endl;
    assert(false);
@@ -2069,15 +4636,18 @@ bool NumServer::replicateTensor(const ProcessGroup & process_group, const std::s
  auto errc = MPI_Bcast(&byte_packet_len,1,MPI_INT,root_process_rank,
                        process_group.getMPICommProxy().getRef<MPI_Comm>());
  assert(errc == MPI_SUCCESS);
- if(local_rank != root_process_rank) byte_packet_.size_bytes = byte_packet_len;
- errc = MPI_Bcast(byte_packet_.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
+ if(local_rank != root_process_rank){
+  auto reserved = reserveBytePacket(&byte_packet,byte_packet_len); assert(reserved);
+  byte_packet.size_bytes = byte_packet_len;
+ }
+ errc = MPI_Bcast(byte_packet.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
                   process_group.getMPICommProxy().getRef<MPI_Comm>());
  assert(errc == MPI_SUCCESS);
 #endif
  //Create the tensor locally if it did not exist:
- resetBytePacket(&byte_packet_);
+ resetBytePacket(&byte_packet);
  if(iter == tensors_.end()){ //only other MPI processes than root_process_rank
-  auto tensor = std::make_shared<Tensor>(byte_packet_);
+  auto tensor = std::make_shared<Tensor>(byte_packet);
   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
   op->setTensorOperand(tensor);
   std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetTensorElementType(tensor->getElementType());
@@ -2085,13 +4655,13 @@ bool NumServer::replicateTensor(const ProcessGroup & process_group, const std::s
   if(submitted) submitted = sync(*op);
   assert(submitted);
  }else{
-  auto num_deleted = tensor_comms_.erase(name);
+  auto num_deleted = tensor_comms_.erase(lookupNameId(name));
  }
  if(!(process_group == getDefaultProcessGroup())){
-  auto saved = tensor_comms_.emplace(std::make_pair(name,process_group));
+  auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),process_group));
   assert(saved.second);
  }
- clearBytePacket(&byte_packet_);
+ clearBytePacket(&byte_packet);
  //Broadcast the tensor body:
 #ifdef MPI_ENABLED
 // errc = MPI_Barrier(process_group.getMPICommProxy().getRef<MPI_Comm>()); assert(errc == MPI_SUCCESS);
@@ -2104,8 +4674,9 @@ bool NumServer::replicateTensorSync(const ProcessGroup & process_group, const st
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  //Broadcast the tensor meta-data:
+ auto & byte_packet = getThreadBytePacket(); //thread-local byte packet
  int byte_packet_len = 0;
  if(local_rank == root_process_rank){
   if(iter != tensors_.end()){
@@ -2114,8 +4685,8 @@ bool NumServer::replicateTensorSync(const ProcessGroup & process_group, const st
               << " is composite, replication not allowed!" << std::endl << std::flush;
     assert(false);
    }
-   iter->second->pack(byte_packet_);
-   byte_packet_len = static_cast<int>(byte_packet_.size_bytes); assert(byte_packet_len > 0);
+   iter->second->pack(byte_packet);
+   byte_packet_len = static_cast<int>(byte_packet.size_bytes); assert(byte_packet_len > 0);
   }else{
    std::cout << "#ERROR(exatn::NumServer::replicateTensorSync): Tensor " << name << " not found at root!" << std::endl;
    assert(false);
@@ -2125,15 +4696,18 @@ bool NumServer::replicateTensorSync(const ProcessGroup & process_group, const st
  auto errc = MPI_Bcast(&byte_packet_len,1,MPI_INT,root_process_rank,
                        process_group.getMPICommProxy().getRef<MPI_Comm>());
  assert(errc == MPI_SUCCESS);
- if(local_rank != root_process_rank) byte_packet_.size_bytes = byte_packet_len;
- errc = MPI_Bcast(byte_packet_.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
+ if(local_rank != root_process_rank){
+  auto reserved = reserveBytePacket(&byte_packet,byte_packet_len); assert(reserved);
+  byte_packet.size_bytes = byte_packet_len;
+ }
+ errc = MPI_Bcast(byte_packet.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
                   process_group.getMPICommProxy().getRef<MPI_Comm>());
  assert(errc == MPI_SUCCESS);
 #endif
  //Create the tensor locally if it did not exist:
- resetBytePacket(&byte_packet_);
+ resetBytePacket(&byte_packet);
  if(iter == tensors_.end()){ //only other MPI processes than root_process_rank
-  auto tensor = std::make_shared<Tensor>(byte_packet_);
+  auto tensor = std::make_shared<Tensor>(byte_packet);
   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
   op->setTensorOperand(tensor);
   std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetTensorElementType(tensor->getElementType());
@@ -2141,18 +4715,195 @@ bool NumServer::replicateTensorSync(const ProcessGroup & process_group, const st
   if(submitted) submitted = sync(*op);
   assert(submitted);
  }else{
-  auto num_deleted = tensor_comms_.erase(name);
+  auto num_deleted = tensor_comms_.erase(lookupNameId(name));
  }
  if(!(process_group == getDefaultProcessGroup())){
-  auto saved = tensor_comms_.emplace(std::make_pair(name,process_group));
+  auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),process_group));
   assert(saved.second);
  }
- clearBytePacket(&byte_packet_);
+ clearBytePacket(&byte_packet);
  //Broadcast the tensor body:
 #ifdef MPI_ENABLED
-// errc = MPI_Barrier(process_group.getMPICommProxy().getRef<MPI_Comm>()); assert(errc == MPI_SUCCESS);
+// errc = MPI_Barrier(process_group.getMPICommProxy().getRef<MPI_Comm>()); assert(errc == MPI_SUCCESS);
+#endif
+ return broadcastTensorSync(process_group,name,root_process_rank);
+}
+
+bool NumServer::replicateTensorSharedSync(const std::string & name, int root_process_rank)
+{
+ return replicateTensorSharedSync(getDefaultProcessGroup(),name,root_process_rank);
+}
+
+bool NumServer::replicateTensorSharedSync(const ProcessGroup & process_group, const std::string & name, int root_process_rank)
+{
+#ifdef MPI_ENABLED
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ if(shared_replicas_.find(name) != shared_replicas_.end()){
+  std::cout << "#ERROR(exatn::NumServer::replicateTensorSharedSync): Tensor " << name
+            << " is already a node-shared replica!" << std::endl << std::flush;
+  assert(false);
+ }
+ auto tensor_mapper = getTensorMapper(process_group);
+ auto iter = tensors_.find(lookupNameId(name));
+ //Broadcast the tensor meta-data:
+ auto & byte_packet = getThreadBytePacket(); //thread-local byte packet
+ int byte_packet_len = 0;
+ if(local_rank == root_process_rank){
+  if(iter != tensors_.end()){
+   if(iter->second->isComposite()){
+    std::cout << "#ERROR(exatn::NumServer::replicateTensorSharedSync): Tensor " << name
+              << " is composite, replication not allowed!" << std::endl << std::flush;
+    assert(false);
+   }
+   iter->second->pack(byte_packet);
+   byte_packet_len = static_cast<int>(byte_packet.size_bytes); assert(byte_packet_len > 0);
+  }else{
+   std::cout << "#ERROR(exatn::NumServer::replicateTensorSharedSync): Tensor " << name << " not found at root!" << std::endl;
+   assert(false);
+  }
+ }
+ auto errc = MPI_Bcast(&byte_packet_len,1,MPI_INT,root_process_rank,
+                       process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ if(local_rank != root_process_rank){
+  auto reserved = reserveBytePacket(&byte_packet,byte_packet_len); assert(reserved);
+  byte_packet.size_bytes = byte_packet_len;
+ }
+ errc = MPI_Bcast(byte_packet.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
+                  process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ resetBytePacket(&byte_packet);
+ auto tensor = (iter != tensors_.end()) ? iter->second : std::make_shared<Tensor>(byte_packet);
+ clearBytePacket(&byte_packet);
+ const auto element_type = tensor->getElementType();
+ const std::size_t body_size = tensor->getVolume() * TensorElementTypeSize(tensorComputeElementType(element_type));
+ //Allocate a single tensor body per compute node in an MPI-3 shared-memory window:
+ const auto & groups = getNodeProcessGroups(process_group);
+ unsigned int node_rank = 0;
+ auto in_node = groups.node->rankIsIn(process_rank_,&node_rank); assert(in_node);
+ const auto & node_comm = groups.node->getMPICommProxy().getRef<MPI_Comm>();
+ auto * window = new MPI_Win{MPI_WIN_NULL};
+ void * body = nullptr;
+ errc = MPI_Win_allocate_shared(static_cast<MPI_Aint>((node_rank == 0) ? body_size : 0),1,
+                                MPI_INFO_NULL,node_comm,&body,window);
+ assert(errc == MPI_SUCCESS);
+ MPI_Aint segment_size = 0;
+ int disp_unit = 1;
+ errc = MPI_Win_shared_query(*window,0,&segment_size,&disp_unit,&body); assert(errc == MPI_SUCCESS);
+ assert(static_cast<std::size_t>(segment_size) == body_size);
+ errc = MPI_Win_lock_all(MPI_MODE_NOCHECK,*window); assert(errc == MPI_SUCCESS);
+ //Move the root tensor body into the node-shared body and release the private tensor bodies:
+ if(iter != tensors_.end()){
+  if(local_rank == root_process_rank){
+   auto view = getTensorView(tensor);
+   if(view.isEmpty() || view.getSize() != body_size){
+    std::cout << "#ERROR(exatn::NumServer::replicateTensorSharedSync): Unable to access tensor " << name << std::endl;
+    assert(false);
+   }
+   std::memcpy(body,view.getDataRaw(),body_size);
+   view.release();
+  }
+  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+  op->setTensorOperand(tensor);
+  auto submitted = submit(op,tensor_mapper);
+  if(submitted) submitted = sync(*op);
+  assert(submitted);
+  auto num_deleted = tensor_comms_.erase(lookupNameId(name));
+ }
+ //Recreate the tensor over the node-shared body in every process:
+ std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+ op->setTensorOperand(tensor);
+ std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetTensorElementType(element_type);
+ std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetExternalBody(body);
+ auto submitted = submit(op,tensor_mapper);
+ if(submitted) submitted = sync(*op);
+ assert(submitted);
+ if(!(process_group == getDefaultProcessGroup())){
+  auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),process_group));
+  assert(saved.second);
+ }
+ auto saved = shared_replicas_.emplace(std::make_pair(name,
+               SharedReplica{process_group,groups.node,groups.leaders,window,body,body_size}));
+ assert(saved.second);
+ //Propagate the tensor body from the compute node of the root process to all other compute nodes:
+ return updateSharedReplica(process_group,name,root_process_rank);
+#else
+ return replicateTensorSync(process_group,name,root_process_rank);
+#endif
+}
+
+bool NumServer::tensorIsSharedReplica(const std::string & name) const
+{
+ return (shared_replicas_.find(name) != shared_replicas_.cend());
+}
+
+bool NumServer::updateSharedReplica(const ProcessGroup & process_group, const std::string & name, int root_process_rank)
+{
+ bool success = true;
+#ifdef MPI_ENABLED
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ auto replica = shared_replicas_.find(name);
+ assert(replica != shared_replicas_.end());
+ if(!(replica->second.process_group.isCongruentTo(process_group))){
+  std::cout << "#ERROR(exatn::NumServer::updateSharedReplica): Process group does not match "
+            << "the domain of existence of the node-shared replica " << name << std::endl << std::flush;
+  assert(false);
+ }
+ auto & shared = replica->second;
+ const auto & node_comm = shared.node->getMPICommProxy().getRef<MPI_Comm>();
+ //Complete the update in the writer process and make it visible within its compute node
+ //(the tensor view syncs the tensor body to Host and drops stale permuted copies of it):
+ success = sync(name);
+ auto view = getTensorView(name);
+ success = success && !(view.isEmpty());
+ view.release();
+ auto errc = MPI_Win_sync(*static_cast<MPI_Win*>(shared.window)); success = success && (errc == MPI_SUCCESS);
+ errc = MPI_Barrier(node_comm); success = success && (errc == MPI_SUCCESS);
+ //Broadcast the updated tensor body among the node leaders:
+ int root_leader = static_cast<int>(shared.node->getProcessRanks()[0]); //node leader of the writer process
+ errc = MPI_Bcast(&root_leader,1,MPI_INT,root_process_rank,process_group.getMPICommProxy().getRef<MPI_Comm>());
+ success = success && (errc == MPI_SUCCESS);
+ if(shared.leaders){ //node leaders only
+  unsigned int root_leader_rank = 0;
+  auto in_leaders = shared.leaders->rankIsIn(static_cast<unsigned int>(root_leader),&root_leader_rank);
+  assert(in_leaders);
+  const auto & leader_comm = shared.leaders->getMPICommProxy().getRef<MPI_Comm>();
+  char * body = static_cast<char*>(shared.body);
+  std::size_t offset = 0;
+  while(offset < shared.size){ //chunked broadcast (int count)
+   const int chunk = static_cast<int>(std::min(shared.size - offset,static_cast<std::size_t>(1ULL << 30)));
+   errc = MPI_Bcast(body + offset,chunk,MPI_CHAR,static_cast<int>(root_leader_rank),leader_comm);
+   success = success && (errc == MPI_SUCCESS);
+   offset += chunk;
+  }
+ }
+ //Make the received tensor body visible within each compute node:
+ errc = MPI_Win_sync(*static_cast<MPI_Win*>(shared.window)); success = success && (errc == MPI_SUCCESS);
+ errc = MPI_Barrier(node_comm); success = success && (errc == MPI_SUCCESS);
+ //Drop stale permuted copies of the tensor body in all processes:
+ view = getTensorView(name);
+ view.release();
+ errc = MPI_Win_sync(*static_cast<MPI_Win*>(shared.window)); success = success && (errc == MPI_SUCCESS);
+#endif
+ return success;
+}
+
+bool NumServer::freeSharedReplica(const std::string & name)
+{
+ bool success = true;
+#ifdef MPI_ENABLED
+ auto replica = shared_replicas_.find(name);
+ if(replica != shared_replicas_.end()){
+  auto * window = static_cast<MPI_Win*>(replica->second.window);
+  auto errc = MPI_Win_unlock_all(*window); success = success && (errc == MPI_SUCCESS);
+  errc = MPI_Win_free(window); success = success && (errc == MPI_SUCCESS); //collective within the compute node
+  delete window;
+  shared_replicas_.erase(replica);
+ }
 #endif
- return broadcastTensorSync(process_group,name,root_process_rank);
+ return success;
 }
 
 bool NumServer::dereplicateTensor(const std::string & name, int root_process_rank)
@@ -2169,14 +4920,19 @@ bool NumServer::dereplicateTensor(const ProcessGroup & process_group, const std:
 {
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
- auto iter = tensors_.find(name);
+ if(tensorIsSharedReplica(name)){
+  std::cout << "#ERROR(exatn::NumServer::dereplicateTensor): Unable to dereplicate node-shared replicas like tensor "
+            << name << std::endl;
+  assert(false);
+ }
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(getTensorProcessGroup(name).isCongruentTo(process_group)){
    if(!iter->second->isComposite()){
     auto tensor_mapper = getTensorMapper(process_group);
-    auto num_deleted = tensor_comms_.erase(name);
+    auto num_deleted = tensor_comms_.erase(lookupNameId(name));
     if(local_rank == root_process_rank){
-     auto saved = tensor_comms_.emplace(std::make_pair(name,getCurrentProcessGroup()));
+     auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),getCurrentProcessGroup()));
      assert(saved.second);
     }else{
      std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
@@ -2205,14 +4961,19 @@ bool NumServer::dereplicateTensorSync(const ProcessGroup & process_group, const
 {
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
- auto iter = tensors_.find(name);
+ if(tensorIsSharedReplica(name)){
+  std::cout << "#ERROR(exatn::NumServer::dereplicateTensorSync): Unable to dereplicate node-shared replicas like tensor "
+            << name << std::endl;
+  assert(false);
+ }
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(getTensorProcessGroup(name).isCongruentTo(process_group)){
    if(!iter->second->isComposite()){
     auto tensor_mapper = getTensorMapper(process_group);
-    auto num_deleted = tensor_comms_.erase(name);
+    auto num_deleted = tensor_comms_.erase(lookupNameId(name));
     if(local_rank == root_process_rank){
-     auto saved = tensor_comms_.emplace(std::make_pair(name,getCurrentProcessGroup()));
+     auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),getCurrentProcessGroup()));
      assert(saved.second);
     }else{
      std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
@@ -2241,6 +5002,335 @@ bool NumServer::dereplicateTensorSync(const ProcessGroup & process_group, const
  return true;
 }
 
+bool NumServer::redistributeTensorSync(const std::string & name,
+                                       const ProcessGroup & target_group,
+                                       const std::vector<std::pair<unsigned int, unsigned int>> & split_dims)
+{
+ return redistributeTensorSync(getDefaultProcessGroup(),name,target_group,split_dims);
+}
+
+bool NumServer::redistributeTensorSync(const ProcessGroup & process_group,
+                                       const std::string & name,
+                                       const ProcessGroup & target_group,
+                                       const std::vector<std::pair<unsigned int, unsigned int>> & split_dims)
+{
+ using Planner = numerics::TensorRedistributionPlanner;
+ unsigned int local_rank; //local process rank within the parent process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ const unsigned int num_procs = process_group.getSize();
+ //Converts a global process rank into the local process rank within the parent process group:
+ auto parent_rank = [&process_group](unsigned int global_rank){
+  unsigned int rank = process_group.getSize();
+  if(!process_group.rankIsIn(global_rank,&rank)) rank = process_group.getSize();
+  return rank;
+ };
+ auto group_is_contained = [&](const ProcessGroup & group){
+  for(const auto & rank: group.getProcessRanks()) if(parent_rank(rank) >= num_procs) return false;
+  return true;
+ };
+ if(!group_is_contained(target_group)){
+  std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Target process group is not contained in the parent process group!"
+            << std::endl;
+  assert(false);
+ }
+ if(tensorIsSharedReplica(name)){
+  std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Unable to redistribute node-shared replicas like tensor "
+            << name << std::endl;
+  assert(false);
+ }
+ //Layout of a tensor within a process group (process ranks within the parent process group):
+ auto tensor_layout = [&](const Tensor & tensor, const TensorMapper & tensor_mapper, const ProcessGroup & group){
+  auto make_block = [](const Tensor & block_tensor){
+   Planner::Block block;
+   for(unsigned int i = 0; i < block_tensor.getRank(); ++i){
+    block.offsets.emplace_back(dim_base_offset(block_tensor,i));
+    block.extents.emplace_back(block_tensor.getDimExtent(i));
+   }
+   return block;
+  };
+  std::vector<Planner::Block> layout;
+  const auto & group_ranks = group.getProcessRanks();
+  if(tensor.isComposite()){
+   const auto & composite = dynamic_cast<const numerics::TensorComposite &>(tensor);
+   const auto num_subtensors = composite.getNumSubtensors();
+   for(auto subtens = composite.begin(); subtens != composite.end(); ++subtens){
+    layout.emplace_back(make_block(*(subtens->second)));
+    const auto first_owner = tensor_mapper.subtensorFirstOwnerId(composite,subtens->first);
+    const auto num_replicas = tensor_mapper.subtensorNumReplicas(subtens->first,num_subtensors);
+    for(unsigned int i = 0; i < num_replicas; ++i){
+     layout.back().owners.emplace_back(parent_rank(group_ranks[first_owner + i * num_subtensors]));
+    }
+   }
+  }else{
+   layout.emplace_back(make_block(tensor));
+   for(const auto & rank: group_ranks) layout.back().owners.emplace_back(parent_rank(rank));
+  }
+  return layout;
+ };
+ //Tensor blocks in the order of the tensor layout:
+ auto layout_blocks = [](std::shared_ptr<Tensor> tensor){
+  std::vector<std::shared_ptr<Tensor>> blocks;
+  if(tensor->isComposite()){
+   auto composite = castTensorComposite(tensor);
+   for(auto subtens = composite->begin(); subtens != composite->end(); ++subtens) blocks.emplace_back(subtens->second);
+  }else{
+   blocks.emplace_back(tensor);
+  }
+  return blocks;
+ };
+ auto pack_layout = [](const std::vector<Planner::Block> & layout){
+  std::vector<unsigned long long> packet{layout.size()};
+  for(const auto & block: layout){
+   packet.emplace_back(block.extents.size());
+   packet.insert(packet.end(),block.offsets.cbegin(),block.offsets.cend());
+   packet.insert(packet.end(),block.extents.cbegin(),block.extents.cend());
+   packet.emplace_back(block.owners.size());
+   packet.insert(packet.end(),block.owners.cbegin(),block.owners.cend());
+  }
+  return packet;
+ };
+ auto unpack_layout = [](const std::vector<unsigned long long> & packet){
+  std::vector<Planner::Block> layout(packet[0]);
+  std::size_t pos = 1;
+  for(auto & block: layout){
+   const auto rank = packet[pos++];
+   block.offsets.assign(packet.cbegin() + pos,packet.cbegin() + pos + rank); pos += rank;
+   block.extents.assign(packet.cbegin() + pos,packet.cbegin() + pos + rank); pos += rank;
+   const auto num_owners = packet[pos++];
+   block.owners.assign(packet.cbegin() + pos,packet.cbegin() + pos + num_owners); pos += num_owners;
+  }
+  return layout;
+ };
+#ifdef MPI_ENABLED
+ auto & comm = process_group.getMPICommProxy().getRef<MPI_Comm>();
+ auto broadcast_layout = [&comm](std::vector<unsigned long long> & packet, unsigned int root){
+  unsigned long long packet_len = packet.size();
+  auto errc = MPI_Bcast(&packet_len,1,MPI_UNSIGNED_LONG_LONG,root,comm); assert(errc == MPI_SUCCESS);
+  packet.resize(packet_len);
+  errc = MPI_Bcast(packet.data(),packet_len,MPI_UNSIGNED_LONG_LONG,root,comm); assert(errc == MPI_SUCCESS);
+  return;
+ };
+#endif
+
+ //Broadcast the tensor meta-data and its source layout from the first process of the source process group:
+ auto iter = tensors_.find(lookupNameId(name));
+ const bool in_source = (iter != tensors_.end());
+ std::shared_ptr<Tensor> source_tensor;
+ std::shared_ptr<TensorMapper> source_mapper;
+ unsigned int source_leader = num_procs;
+ if(in_source){
+  source_tensor = iter->second;
+  const auto & source_group = getTensorProcessGroup(name);
+  source_mapper = getTensorMapper(source_group); //collective within the source process group
+  unsigned int source_rank;
+  if(source_group.rankIsIn(process_rank_,&source_rank)){
+   if(source_rank == 0) source_leader = local_rank;
+  }
+ }
+#ifdef MPI_ENABLED
+ auto errc = MPI_Allreduce(MPI_IN_PLACE,&source_leader,1,MPI_UNSIGNED,MPI_MIN,comm); assert(errc == MPI_SUCCESS);
+#endif
+ if(source_leader >= num_procs){
+  std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Tensor " << name << " not found!" << std::endl;
+  return false;
+ }
+ std::vector<unsigned long long> source_packet, target_packet;
+ auto & byte_packet = getThreadBytePacket(); //thread-local byte packet
+ int byte_packet_len = 0;
+ if(local_rank == source_leader){
+  const auto & source_group = getTensorProcessGroup(name);
+  if(!group_is_contained(source_group)){
+   std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Domain of existence of tensor " << name
+             << " is not contained in the parent process group!" << std::endl;
+   assert(false);
+  }
+  source_tensor->Tensor::pack(byte_packet); //base tensor only
+  byte_packet_len = static_cast<int>(byte_packet.size_bytes); assert(byte_packet_len > 0);
+  source_packet = pack_layout(tensor_layout(*source_tensor,*source_mapper,source_group));
+ }
+#ifdef MPI_ENABLED
+ errc = MPI_Bcast(&byte_packet_len,1,MPI_INT,source_leader,comm); assert(errc == MPI_SUCCESS);
+ if(local_rank != source_leader){
+  auto reserved = reserveBytePacket(&byte_packet,byte_packet_len); assert(reserved);
+  byte_packet.size_bytes = byte_packet_len;
+ }
+ errc = MPI_Bcast(byte_packet.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,source_leader,comm); assert(errc == MPI_SUCCESS);
+ broadcast_layout(source_packet,source_leader);
+#endif
+ resetBytePacket(&byte_packet);
+ auto base_tensor = std::make_shared<Tensor>(byte_packet);
+ clearBytePacket(&byte_packet);
+ const auto element_type = base_tensor->getElementType();
+ const auto elem_size = TensorElementTypeSize(tensorComputeElementType(element_type)); //in-memory element size
+
+ //Broadcast the target layout from the first process of the target process group:
+ unsigned int target_rank;
+ const bool in_target = target_group.rankIsIn(process_rank_,&target_rank);
+ std::shared_ptr<Tensor> target_tensor;
+ if(in_target){
+  if(split_dims.empty()){
+   target_tensor = base_tensor;
+  }else{
+   target_tensor = makeSharedTensorComposite(split_dims,*base_tensor);
+  }
+  auto target_mapper = getTensorMapper(target_group); //collective within the target process group
+  if(target_rank == 0) target_packet = pack_layout(tensor_layout(*target_tensor,*target_mapper,target_group));
+ }
+#ifdef MPI_ENABLED
+ broadcast_layout(target_packet,parent_rank(target_group.getProcessRanks()[0]));
+#endif
+ if(!(in_source || in_target)) return true;
+
+ //Plan the block transfers:
+ const auto source_layout = unpack_layout(source_packet);
+ const auto target_layout = unpack_layout(target_packet);
+ const Planner planner(source_layout,target_layout);
+ const auto & transfers = planner.getTransfers();
+
+ //Pack the outgoing tensor slices from the local source blocks:
+ bool success = true;
+ std::vector<std::vector<char>> buffers(transfers.size()); //packed tensor slices
+ if(in_source){
+  auto source_blocks = layout_blocks(source_tensor);
+  std::vector<std::size_t> outgoing;
+  for(std::size_t i = 0; i < transfers.size(); ++i){
+   if(transfers[i].source_process == local_rank) outgoing.emplace_back(i);
+  }
+  std::stable_sort(outgoing.begin(),outgoing.end(),[&transfers](std::size_t i, std::size_t j){
+   return transfers[i].source_block < transfers[j].source_block;
+  });
+  TensorView view;
+  std::size_t block_id = source_layout.size();
+  for(const auto & i: outgoing){
+   const auto & transfer = transfers[i];
+   const auto & block = source_layout[transfer.source_block];
+   if(transfer.source_block != block_id){
+    block_id = transfer.source_block;
+    view = getTensorView(source_blocks[block_id]);
+    if(view.isEmpty()){
+     std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Unable to access tensor "
+               << source_blocks[block_id]->getName() << std::endl;
+     success = false;
+     break;
+    }
+   }
+   buffers[i].resize(transfer.volume * elem_size);
+   Planner::copySlice(transfer.offsets,transfer.extents,block.offsets,block.extents,view.getDataRaw(),
+                      transfer.offsets,transfer.extents,buffers[i].data(),elem_size);
+  }
+  view.release();
+ }
+
+#ifdef MPI_ENABLED
+ //Post the pairwise exchange of the remote tensor slices:
+ std::vector<MPI_Request> requests;
+ auto post_transfer = [&](std::vector<char> & buffer, unsigned int peer, bool send){
+  std::size_t offset = 0;
+  while(offset < buffer.size()){ //chunked transfer (int count)
+   const int chunk = static_cast<int>(std::min(buffer.size() - offset,static_cast<std::size_t>(1ULL << 30)));
+   requests.emplace_back(MPI_REQUEST_NULL);
+   auto errc = (send ? MPI_Isend(buffer.data() + offset,chunk,MPI_CHAR,peer,0,comm,&(requests.back()))
+                     : MPI_Irecv(buffer.data() + offset,chunk,MPI_CHAR,peer,0,comm,&(requests.back())));
+   success = success && (errc == MPI_SUCCESS);
+   offset += chunk;
+  }
+  return;
+ };
+ std::vector<std::size_t> outgoing;
+ for(std::size_t i = 0; i < transfers.size(); ++i){
+  const auto & transfer = transfers[i];
+  if(transfer.source_process != transfer.target_process){
+   if(transfer.target_process == local_rank){
+    buffers[i].resize(transfer.volume * elem_size);
+    post_transfer(buffers[i],transfer.source_process,false);
+   }else if(transfer.source_process == local_rank){
+    outgoing.emplace_back(i);
+   }
+  }
+ }
+ std::stable_sort(outgoing.begin(),outgoing.end(),[&](std::size_t i, std::size_t j){ //rotated pairwise schedule
+  return ((transfers[i].target_process + num_procs - local_rank) % num_procs)
+       < ((transfers[j].target_process + num_procs - local_rank) % num_procs);
+ });
+ for(const auto & i: outgoing) post_transfer(buffers[i],transfers[i].target_process,true);
+#endif
+
+ //Replace the source tensor by the target tensor (overlapped with the exchange):
+ if(in_source) success = destroyTensorSync(name) && success; //collective within the source process group
+ if(in_target) success = createTensorSync(target_group,target_tensor,element_type) && success; //collective within the target process group
+
+#ifdef MPI_ENABLED
+ if(!requests.empty()){
+  errc = MPI_Waitall(requests.size(),requests.data(),MPI_STATUSES_IGNORE);
+  success = success && (errc == MPI_SUCCESS);
+ }
+#endif
+
+ //Assemble and initialize the local target blocks:
+ if(in_target){
+  auto target_blocks = layout_blocks(target_tensor);
+  std::vector<std::shared_ptr<std::vector<char>>> bodies(target_layout.size());
+  for(std::size_t i = 0; i < transfers.size(); ++i){
+   const auto & transfer = transfers[i];
+   if(transfer.target_process == local_rank){
+    const auto & block = target_layout[transfer.target_block];
+    auto & body = bodies[transfer.target_block];
+    if(!body){
+     std::size_t volume = 1;
+     for(const auto & extent: block.extents) volume *= extent;
+     body = std::make_shared<std::vector<char>>(volume * elem_size);
+    }
+    Planner::copySlice(transfer.offsets,transfer.extents,transfer.offsets,transfer.extents,buffers[i].data(),
+                       block.offsets,block.extents,body->data(),elem_size);
+    std::vector<char>().swap(buffers[i]);
+   }
+  }
+  std::vector<std::shared_ptr<TensorOperation>> ops;
+  for(std::size_t block_id = 0; block_id < bodies.size(); ++block_id){
+   const auto & body = bodies[block_id];
+   if(body){
+    const auto & block = target_layout[block_id];
+    const TensorShape block_shape(block.extents);
+    std::shared_ptr<void> guard(body); //the block body is released once the initialization has been executed
+    std::shared_ptr<TensorMethod> functor;
+    switch(tensorComputeElementType(element_type)){
+     case TensorElementType::REAL32:
+      functor.reset(new numerics::FunctorInitBuf(block_shape,block.offsets,
+                                                 reinterpret_cast<const float*>(body->data()),guard));
+      break;
+     case TensorElementType::REAL64:
+      functor.reset(new numerics::FunctorInitBuf(block_shape,block.offsets,
+                                                 reinterpret_cast<const double*>(body->data()),guard));
+      break;
+     case TensorElementType::COMPLEX32:
+      functor.reset(new numerics::FunctorInitBuf(block_shape,block.offsets,
+                                                 reinterpret_cast<const std::complex<float>*>(body->data()),guard));
+      break;
+     case TensorElementType::COMPLEX64:
+      functor.reset(new numerics::FunctorInitBuf(block_shape,block.offsets,
+                                                 reinterpret_cast<const std::complex<double>*>(body->data()),guard));
+      break;
+     default:
+      std::cout << "#ERROR(exatn::NumServer::redistributeTensorSync): Tensor " << name
+                << " has an unsupported element type!" << std::endl;
+      assert(false);
+    }
+    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+    op->setTensorOperand(target_blocks[block_id]);
+    std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->resetFunctor(functor);
+    success = submitOp(op) && success;
+    ops.emplace_back(op);
+   }
+  }
+  bodies.clear();
+  for(auto & op: ops) success = sync(*op) && success;
+#ifdef MPI_ENABLED
+  success = sync(target_group) && success;
+#endif
+ }
+ return success;
+}
+
 bool NumServer::broadcastTensor(const std::string & name, int root_process_rank)
 {
  return broadcastTensor(getDefaultProcessGroup(),name,root_process_rank);
@@ -2254,9 +5344,10 @@ bool NumServer::broadcastTensorSync(const std::string & name, int root_process_r
 bool NumServer::broadcastTensor(const ProcessGroup & process_group, const std::string & name, int root_process_rank)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ if(tensorIsSharedReplica(name)) return updateSharedReplica(process_group,name,root_process_rank); //always synchronous
  bool success = true;
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(iter->second->isComposite()){
    std::cout << "#ERROR(exatn::NumServer::broadcastTensor): Tensor " << name
@@ -2266,6 +5357,7 @@ bool NumServer::broadcastTensor(const ProcessGroup & process_group, const std::s
    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::BROADCAST);
    op->setTensorOperand(iter->second);
    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetMPICommunicator(process_group.getMPICommProxy());
+   std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetReducedPrecisionTransfer(tensorTransferTolerant(name));
    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetRootRank(root_process_rank);
    success = submit(op,tensor_mapper);
   }
@@ -2279,9 +5371,10 @@ bool NumServer::broadcastTensor(const ProcessGroup & process_group, const std::s
 bool NumServer::broadcastTensorSync(const ProcessGroup & process_group, const std::string & name, int root_process_rank)
 {
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ if(tensorIsSharedReplica(name)) return updateSharedReplica(process_group,name,root_process_rank); //always synchronous
  bool success = true;
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(iter->second->isComposite()){
    std::cout << "#ERROR(exatn::NumServer::broadcastTensorSync): Tensor " << name
@@ -2291,6 +5384,7 @@ bool NumServer::broadcastTensorSync(const ProcessGroup & process_group, const st
    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::BROADCAST);
    op->setTensorOperand(iter->second);
    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetMPICommunicator(process_group.getMPICommProxy());
+   std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetReducedPrecisionTransfer(tensorTransferTolerant(name));
    std::dynamic_pointer_cast<numerics::TensorOpBroadcast>(op)->resetRootRank(root_process_rank);
    success = submit(op,tensor_mapper);
    if(success){
@@ -2307,6 +5401,105 @@ bool NumServer::broadcastTensorSync(const ProcessGroup & process_group, const st
  return success;
 }
 
+bool NumServer::broadcastTensorNetwork(TensorNetwork & network, int root_process_rank)
+{
+ return broadcastTensorNetwork(getDefaultProcessGroup(),network,root_process_rank);
+}
+
+bool NumServer::broadcastTensorNetwork(const ProcessGroup & process_group, TensorNetwork & network, int root_process_rank)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ bool success = broadcastPackable(process_group,network,root_process_rank);
+ if(success && local_rank != root_process_rank) substituteRegisteredTensors(network);
+ return success;
+}
+
+bool NumServer::broadcastTensorExpansion(TensorExpansion & expansion, int root_process_rank)
+{
+ return broadcastTensorExpansion(getDefaultProcessGroup(),expansion,root_process_rank);
+}
+
+bool NumServer::broadcastTensorExpansion(const ProcessGroup & process_group, TensorExpansion & expansion, int root_process_rank)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ bool success = broadcastPackable(process_group,expansion,root_process_rank);
+ if(success && local_rank != root_process_rank){
+  for(auto component = expansion.begin(); component != expansion.end(); ++component){
+   substituteRegisteredTensors(*(component->network)); //unpacked tensor networks are not shared
+  }
+ }
+ return success;
+}
+
+bool NumServer::broadcastBytes(const ProcessGroup & process_group, std::vector<char> & bytes, int root_process_rank)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ assert(bytes.size() <= static_cast<std::size_t>(std::numeric_limits<int>::max()));
+#ifdef MPI_ENABLED
+ int num_bytes = static_cast<int>(bytes.size());
+ auto errc = MPI_Bcast(&num_bytes,1,MPI_INT,root_process_rank,
+                       process_group.getMPICommProxy().getRef<MPI_Comm>());
+ if(errc != MPI_SUCCESS) return false;
+ if(local_rank != root_process_rank) bytes.resize(num_bytes);
+ if(num_bytes > 0){
+  errc = MPI_Bcast(bytes.data(),num_bytes,MPI_CHAR,root_process_rank,
+                   process_group.getMPICommProxy().getRef<MPI_Comm>());
+  if(errc != MPI_SUCCESS) return false;
+ }
+#endif
+ return true;
+}
+
+bool NumServer::broadcastPackable(const ProcessGroup & process_group, Packable & object, int root_process_rank)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return false;
+ auto & byte_packet = getThreadBytePacket(); //thread-local byte packet
+ int byte_packet_len = 0;
+ if(local_rank == root_process_rank){
+  object.pack(byte_packet);
+  byte_packet_len = static_cast<int>(byte_packet.size_bytes); assert(byte_packet_len > 0);
+ }
+#ifdef MPI_ENABLED
+ auto errc = MPI_Bcast(&byte_packet_len,1,MPI_INT,root_process_rank,
+                       process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+ if(local_rank != root_process_rank){
+  auto reserved = reserveBytePacket(&byte_packet,byte_packet_len); assert(reserved);
+  byte_packet.size_bytes = byte_packet_len;
+ }
+ errc = MPI_Bcast(byte_packet.base_addr,byte_packet_len,MPI_UNSIGNED_CHAR,root_process_rank,
+                  process_group.getMPICommProxy().getRef<MPI_Comm>());
+ assert(errc == MPI_SUCCESS);
+#endif
+ if(local_rank != root_process_rank){
+  resetBytePacket(&byte_packet);
+  object.unpack(byte_packet);
+ }
+ clearBytePacket(&byte_packet);
+ return true;
+}
+
+void NumServer::substituteRegisteredTensors(TensorNetwork & network)
+{
+ for(auto iter = network.begin(); iter != network.end(); ++iter){
+  auto tensor = iter->second.getTensor();
+  auto registered = tensors_.find(lookupNameId(tensor->getName()));
+  if(registered != tensors_.end() && registered->second != tensor){
+   auto substituted = network.substituteTensor(tensor,registered->second);
+   if(!substituted){
+    std::cout << "#ERROR(exatn::NumServer::substituteRegisteredTensors): Received tensor " << tensor->getName()
+              << " is not congruent to the registered tensor with the same name!" << std::endl << std::flush;
+    assert(false);
+   }
+  }
+ }
+ return;
+}
+
 bool NumServer::allreduceTensor(const std::string & name)
 {
  return allreduceTensor(getDefaultProcessGroup(),name);
@@ -2322,7 +5515,7 @@ bool NumServer::allreduceTensor(const ProcessGroup & process_group, const std::s
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
  bool success = true;
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(iter->second->isComposite()){
    std::cout << "#ERROR(exatn::NumServer::allreduceTensor): Tensor " << name
@@ -2332,6 +5525,7 @@ bool NumServer::allreduceTensor(const ProcessGroup & process_group, const std::s
    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ALLREDUCE);
    op->setTensorOperand(iter->second);
    std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetMPICommunicator(process_group.getMPICommProxy());
+   std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetReducedPrecisionTransfer(tensorTransferTolerant(name));
    success = submit(op,tensor_mapper);
   }
  }else{
@@ -2346,7 +5540,7 @@ bool NumServer::allreduceTensorSync(const ProcessGroup & process_group, const st
  if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
  bool success = true;
  auto tensor_mapper = getTensorMapper(process_group);
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter != tensors_.end()){
   if(iter->second->isComposite()){
    std::cout << "#ERROR(exatn::NumServer::allreduceTensorSync): Tensor " << name
@@ -2356,6 +5550,7 @@ bool NumServer::allreduceTensorSync(const ProcessGroup & process_group, const st
    std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ALLREDUCE);
    op->setTensorOperand(iter->second);
    std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetMPICommunicator(process_group.getMPICommProxy());
+   std::dynamic_pointer_cast<numerics::TensorOpAllreduce>(op)->resetReducedPrecisionTransfer(tensorTransferTolerant(name));
    success = submit(op,tensor_mapper);
    if(success){
     success = sync(*op);
@@ -2373,7 +5568,7 @@ bool NumServer::allreduceTensorSync(const ProcessGroup & process_group, const st
 
 bool NumServer::transformTensor(const std::string & name, std::shared_ptr<TensorMethod> functor)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#ERROR(exatn::NumServer::transformTensor): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -2388,7 +5583,7 @@ bool NumServer::transformTensor(const std::string & name, std::shared_ptr<Tensor
 
 bool NumServer::transformTensorSync(const std::string & name, std::shared_ptr<TensorMethod> functor)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#ERROR(exatn::NumServer::transformTensorSync): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -2422,10 +5617,10 @@ bool NumServer::extractTensorSlice(const std::string & tensor_name,
                                    const std::string & slice_name)
 {
  bool success = false;
- auto iter = tensors_.find(tensor_name);
+ auto iter = tensors_.find(lookupNameId(tensor_name));
  if(iter != tensors_.end()){
   auto tensor0 = iter->second;
-  iter = tensors_.find(slice_name);
+  iter = tensors_.find(lookupNameId(slice_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
    auto tensor_mapper = getTensorMapper(getTensorProcessGroup(slice_name,tensor_name));
@@ -2448,10 +5643,10 @@ bool NumServer::extractTensorSliceSync(const std::string & tensor_name,
                                        const std::string & slice_name)
 {
  bool success = false;
- auto iter = tensors_.find(tensor_name);
+ auto iter = tensors_.find(lookupNameId(tensor_name));
  if(iter != tensors_.end()){
   auto tensor0 = iter->second;
-  iter = tensors_.find(slice_name);
+  iter = tensors_.find(lookupNameId(slice_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
    const auto & process_group = getTensorProcessGroup(slice_name,tensor_name);
@@ -2481,10 +5676,10 @@ bool NumServer::insertTensorSlice(const std::string & tensor_name,
                                   const std::string & slice_name)
 {
  bool success = false;
- auto iter = tensors_.find(tensor_name);
+ auto iter = tensors_.find(lookupNameId(tensor_name));
  if(iter != tensors_.end()){
   auto tensor0 = iter->second;
-  iter = tensors_.find(slice_name);
+  iter = tensors_.find(lookupNameId(slice_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
    auto tensor_mapper = getTensorMapper(getTensorProcessGroup(tensor_name,slice_name));
@@ -2507,10 +5702,10 @@ bool NumServer::insertTensorSliceSync(const std::string & tensor_name,
                                       const std::string & slice_name)
 {
  bool success = false;
- auto iter = tensors_.find(tensor_name);
+ auto iter = tensors_.find(lookupNameId(tensor_name));
  if(iter != tensors_.end()){
   auto tensor0 = iter->second;
-  iter = tensors_.find(slice_name);
+  iter = tensors_.find(lookupNameId(slice_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
    const auto & process_group = getTensorProcessGroup(tensor_name,slice_name);
@@ -2529,10 +5724,560 @@ bool NumServer::insertTensorSliceSync(const std::string & tensor_name,
    success = true;
    //std::cout << "#ERROR(exatn::NumServer::insertTensorSliceSync): Tensor " << slice_name << " not found!\n";
   }
- }else{
-  success = true;
-  //std::cout << "#ERROR(exatn::NumServer::insertTensorSliceSync): Tensor " << tensor_name << " not found!\n";
+ }else{
+  success = true;
+  //std::cout << "#ERROR(exatn::NumServer::insertTensorSliceSync): Tensor " << tensor_name << " not found!\n";
+ }
+ return success;
+}
+
+bool NumServer::resizeTensorSync(const std::string & name,
+                                 unsigned int dimension,
+                                 DimExtent new_extent)
+{
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()){
+  std::cout << "#ERROR(exatn::NumServer::resizeTensorSync): Tensor " << name << " not found!" << std::endl;
+  return false;
+ }
+ auto tensor = iter->second;
+ if(tensor->isComposite() || dimension >= tensor->getRank() || new_extent == 0){
+  std::cout << "#ERROR(exatn::NumServer::resizeTensorSync): Invalid request for tensor " << name << std::endl;
+  return false;
+ }
+ const auto old_extent = tensor->getDimExtent(dimension);
+ if(new_extent == old_extent) return true;
+ const auto & process_group = getTensorProcessGroup(name);
+ auto tensor_mapper = getTensorMapper(process_group);
+ const auto element_type = getTensorElementType(name);
+ const bool transfer_tolerant = tensorTransferTolerant(name);
+ //Stage the retained block in a temporary tensor of the new shape:
+ auto staged = makeSharedTensor(*tensor);
+ staged->replaceDimension(dimension,new_extent);
+ staged->rename();
+ bool success = createTensor(process_group,staged,element_type);
+ if(success){
+  std::shared_ptr<TensorOperation> op;
+  if(new_extent > old_extent){ //zero padding + insertion
+   op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM);
+   op->setTensorOperand(staged);
+   std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->
+    resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
+   success = submit(op,tensor_mapper);
+   if(success){
+    op = tensor_op_factory_->createTensorOp(TensorOpCode::INSERT);
+    op->setTensorOperand(staged);
+    op->setTensorOperand(tensor);
+    success = submit(op,tensor_mapper);
+   }
+  }else{ //extraction of the leading block
+   op = tensor_op_factory_->createTensorOp(TensorOpCode::SLICE);
+   op->setTensorOperand(staged);
+   op->setTensorOperand(tensor);
+   success = submit(op,tensor_mapper);
+  }
+  //Release the old storage once all preceding tensor operations on the tensor are done:
+  if(success){
+   op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+   op->setTensorOperand(tensor);
+   success = submit(op,tensor_mapper);
+   if(success) success = sync(*op);
+  }
+  //Resize the same tensor object and move the staged body into its new storage:
+  if(success){
+   tensor->replaceDimension(dimension,new_extent);
+   op = tensor_op_factory_->createTensorOp(TensorOpCode::CREATE);
+   op->setTensorOperand(tensor);
+   std::dynamic_pointer_cast<numerics::TensorOpCreate>(op)->resetTensorElementType(element_type);
+   success = submit(op,tensor_mapper); //registers the tensor again
+   if(success){
+    if(transfer_tolerant) markTensorTransferTolerant(name,true);
+    op = tensor_op_factory_->createTensorOp(TensorOpCode::TRANSFORM); //known-zero destination allows aliasing
+    op->setTensorOperand(tensor);
+    std::dynamic_pointer_cast<numerics::TensorOpTransform>(op)->
+     resetFunctor(std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(0.0)));
+    success = submit(op,tensor_mapper);
+   }
+   if(success){
+    op = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
+    op->setTensorOperand(tensor);
+    op->setTensorOperand(staged);
+    std::string add_pattern;
+    auto generated = generate_addition_pattern(tensor->getRank(),add_pattern,false,
+                                               tensor->getName(),staged->getName());
+    assert(generated);
+    op->setIndexPattern(add_pattern);
+    op->donateTensorOperand(1); //the staged tensor is destroyed right after
+    success = submit(op,tensor_mapper);
+    if(success) success = sync(*op);
+   }
+  }
+  auto destroyed = destroyTensorSync(staged->getName());
+  success = success && destroyed;
+#ifdef MPI_ENABLED
+  if(success) success = sync(process_group);
+#endif
+ }
+ return success;
+}
+
+bool NumServer::adaptBondsSync(TensorNetwork & network, bool invalidate)
+{
+ auto resizer = [this](std::shared_ptr<Tensor> tensor, unsigned int dimension, DimExtent new_extent){
+  bool success = true;
+  if(tensors_.find(tensor->getNameId()) != tensors_.end()){ //allocated tensor: Resize its storage as well
+   success = resizeTensorSync(tensor->getName(),dimension,new_extent);
+  }
+  if(success && tensor->getDimExtent(dimension) != new_extent){ //unallocated tensor or a copy of the allocated one
+   tensor->replaceDimension(dimension,new_extent);
+  }
+  return success;
+ };
+ return network.applyBondAdaptivityStep(invalidate,resizer);
+}
+
+bool NumServer::evaluateApproximateSync(TensorNetwork & network,
+                                        DimExtent max_bond,
+                                        double & truncation_error)
+{
+ return evaluateApproximateSync(getDefaultProcessGroup(),network,max_bond,truncation_error);
+}
+
+bool NumServer::evaluateApproximateSync(const ProcessGroup & process_group,
+                                        TensorNetwork & network,
+                                        DimExtent max_bond,
+                                        double & truncation_error)
+{
+ truncation_error = 0.0;
+ if(max_bond == 0){
+  std::cout << "#ERROR(exatn::NumServer::evaluateApproximateSync): Invalid bond dimension limit!" << std::endl;
+  return false;
+ }
+ if(network.getNumTensors() < 3){ //nothing to compress
+  bool success = submit(process_group,network);
+  if(success) success = sync(process_group,network);
+  return success;
+ }
+ auto output_tensor = network.getTensor(0);
+ if(tensors_.find(output_tensor->getNameId()) == tensors_.end()){
+  std::cout << "#ERROR(exatn::NumServer::evaluateApproximateSync): Output tensor " << output_tensor->getName()
+            << " has not been created!" << std::endl;
+  return false;
+ }
+ auto tensor_mapper = getTensorMapper(process_group);
+ const auto element_type = getTensorElementType(output_tensor->getName());
+ //Determine the tensor contraction sequence (an imported one is retained):
+ network.determineContractionSequence(contr_seq_optimizer_);
+ const auto contr_seq = network.exportContractionSequence();
+ TensorNetwork net(network); //working copy sharing the input tensors
+ std::unordered_set<unsigned int> owned; //ids of the tensors created here (intermediates, compressed tensors)
+ bool success = true;
+ //Creates a new (renamed) tensor from the working copy:
+ auto create_tensor = [&](unsigned int tensor_id){
+  auto tensor = net.getTensor(tensor_id);
+  tensor->rename();
+  auto created = createTensor(process_group,tensor,element_type);
+  if(created) owned.emplace(tensor_id);
+  return created;
+ };
+ //Destroys a tensor from the working copy if created here:
+ auto destroy_tensor = [&](std::shared_ptr<Tensor> tensor, unsigned int tensor_id){
+  if(owned.erase(tensor_id) == 0) return true;
+  return destroyTensor(tensor->getName());
+ };
+ //Submits a tensor contraction (overwriting the destination tensor unless accumulative):
+ auto contract = [&](std::shared_ptr<Tensor> dest, std::shared_ptr<Tensor> left, bool left_conj,
+                     std::shared_ptr<Tensor> right, bool right_conj, const std::string & pattern, bool accumulative){
+  std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CONTRACT);
+  op->setTensorOperand(dest);
+  op->setTensorOperand(left,left_conj);
+  op->setTensorOperand(right,right_conj);
+  op->setIndexPattern(pattern);
+  std::dynamic_pointer_cast<numerics::TensorOpContract>(op)->resetAccumulative(accumulative);
+  return submit(op,tensor_mapper);
+ };
+ //Compresses all bonds of a given tensor exceeding the bond dimension limit:
+ auto compress = [&](unsigned int tensor_id){
+  //Group the tensor legs by the neighbor tensor:
+  std::map<unsigned int,std::pair<unsigned int,DimExtent>> bonds; //neighbor tensor id --> {number of legs, total bond dimension}
+  const auto * legs = net.getTensorConnections(tensor_id);
+  const auto tensor = net.getTensor(tensor_id);
+  for(unsigned int i = 0; i < legs->size(); ++i){
+   const auto neighbor_id = (*legs)[i].getTensorId();
+   if(neighbor_id == 0) continue; //open legs are never compressed
+   auto res = bonds.emplace(std::make_pair(neighbor_id,std::make_pair(1U,tensor->getDimExtent(i))));
+   if(!res.second){
+    res.first->second.first += 1;
+    res.first->second.second *= tensor->getDimExtent(i);
+   }
+  }
+  for(const auto & bond: bonds){
+   if(bond.second.second <= max_bond) continue;
+   const auto neighbor_id = bond.first;
+   bool self_conj = false, neighbor_conj = false;
+   auto self = net.getTensor(tensor_id,&self_conj);
+   auto neighbor = net.getTensor(neighbor_id,&neighbor_conj);
+   const unsigned int left_open = self->getRank() - bond.second.first;
+   const unsigned int right_open = neighbor->getRank() - bond.second.first;
+   if(left_open == 0 || right_open == 0) continue; //a single factor would remain: Nothing to compress
+   //Merge both tensors (D = X * N):
+   const auto merged_id = net.getMaxTensorId() + 1;
+   std::string pattern;
+   success = net.mergeTensors(tensor_id,neighbor_id,merged_id,&pattern); if(!success) break;
+   auto merged = net.getTensor(merged_id);
+   DimExtent left_volume = 1, right_volume = 1;
+   for(unsigned int i = 0; i < left_open; ++i) left_volume *= merged->getDimExtent(i);
+   for(unsigned int i = left_open; i < merged->getRank(); ++i) right_volume *= merged->getDimExtent(i);
+   const auto new_bond = std::min(max_bond,std::min(left_volume,right_volume));
+   merged->rename();
+   success = createTensor(process_group,merged,element_type); if(!success) break;
+   success = contract(merged,self,self_conj,neighbor,neighbor_conj,pattern,false); if(!success) break;
+   success = destroy_tensor(self,tensor_id) && destroy_tensor(neighbor,neighbor_id); if(!success) break;
+   //Split the merged tensor via the truncated SVD (D = L * R):
+   std::vector<int> right_dims(merged->getRank(),0);
+   for(unsigned int i = left_open; i < merged->getRank(); ++i) right_dims[i] = 1;
+   success = net.splitTensor(merged_id,tensor_id,"_l",neighbor_id,"_r",TensorShape{new_bond},right_dims); if(!success) break;
+   success = create_tensor(tensor_id) && create_tensor(neighbor_id); if(!success) break;
+   auto left = net.getTensor(tensor_id);
+   auto right = net.getTensor(neighbor_id);
+   std::vector<TensorLeg> factors(left_open + right_open + 2,TensorLeg(0,0));
+   for(unsigned int i = 0; i < left_open; ++i) factors[i] = TensorLeg(0,i);
+   factors[left_open] = TensorLeg(2,right_open);
+   for(unsigned int i = 0; i < right_open; ++i) factors[left_open + 1 + i] = TensorLeg(0,left_open + i);
+   factors[left_open + 1 + right_open] = TensorLeg(1,left_open);
+   std::string svd_pattern;
+   auto generated = generate_contraction_pattern(factors,left_open+1,right_open+1,svd_pattern); assert(generated);
+   svd_pattern.replace(svd_pattern.find("+="),2,"=");
+   std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DECOMPOSE_SVD2);
+   std::dynamic_pointer_cast<numerics::TensorOpDecomposeSVD2>(op)->resetTruncation(svd_randomized_,svd_tolerance_);
+   op->setTensorOperand(left); //out: left tensor factor
+   op->setTensorOperand(right); //out: right tensor factor
+   op->setTensorOperand(merged); //in: original tensor
+   op->setIndexPattern(svd_pattern);
+   success = submit(op,tensor_mapper); if(!success) break;
+   //Local truncation error: ||D - L * R||^2 = ||D||^2 - ||L+ * L||^2 (L+ * L is the diagonal of the retained singular values):
+   auto gram = std::make_shared<Tensor>("_g",TensorShape{new_bond,new_bond});
+   gram->rename();
+   success = createTensor(process_group,gram,element_type); if(!success) break;
+   std::vector<TensorLeg> gram_legs(2 * (left_open + 1),TensorLeg(0,0));
+   for(unsigned int i = 0; i < left_open; ++i){
+    gram_legs[i] = TensorLeg(2,i);
+    gram_legs[left_open + 1 + i] = TensorLeg(1,i);
+   }
+   gram_legs[left_open] = TensorLeg(0,0);
+   gram_legs[2 * left_open + 1] = TensorLeg(0,1);
+   std::string gram_pattern;
+   generated = generate_contraction_pattern(gram_legs,left_open+1,left_open+1,gram_pattern,true,false); assert(generated);
+   success = contract(gram,left,true,left,false,gram_pattern,false); if(!success) break;
+   double merged_norm = 0.0, retained_norm = 0.0;
+   success = computeNorm2Sync(merged->getName(),merged_norm) &&
+             computeNorm2Sync(gram->getName(),retained_norm); if(!success) break;
+   truncation_error += std::sqrt(std::max(0.0,merged_norm * merged_norm - retained_norm * retained_norm));
+   success = destroyTensor(gram->getName()) && destroyTensor(merged->getName()); if(!success) break;
+  }
+  return success;
+ };
+ //Contract the tensor network along the tensor contraction sequence, compressing the intermediates:
+ for(const auto & contr: contr_seq){
+  bool left_conj = false, right_conj = false;
+  auto left = net.getTensor(contr.left_id,&left_conj);
+  auto right = net.getTensor(contr.right_id,&right_conj);
+  if(!left || !right){
+   std::cout << "#ERROR(exatn::NumServer::evaluateApproximateSync): Invalid tensor contraction sequence!" << std::endl;
+   success = false; break;
+  }
+  std::string pattern;
+  if(contr.result_id != 0){ //intermediate tensor contraction
+   success = net.mergeTensors(contr.left_id,contr.right_id,contr.result_id,&pattern); if(!success) break;
+   success = create_tensor(contr.result_id); if(!success) break;
+   success = contract(net.getTensor(contr.result_id),left,left_conj,right,right_conj,pattern,false); if(!success) break;
+  }else{ //last tensor contraction accumulates into the output tensor
+   const auto * left_legs = net.getTensorConnections(contr.left_id);
+   const auto * right_legs = net.getTensorConnections(contr.right_id);
+   std::vector<TensorLeg> legs(*left_legs);
+   legs.insert(legs.end(),right_legs->begin(),right_legs->end());
+   auto generated = generate_contraction_pattern(legs,left_legs->size(),right_legs->size(),
+                                                 pattern,left_conj,right_conj); assert(generated);
+   success = contract(output_tensor,left,left_conj,right,right_conj,pattern,true); if(!success) break;
+  }
+  success = destroy_tensor(left,contr.left_id) && destroy_tensor(right,contr.right_id); if(!success) break;
+  if(contr.result_id != 0){
+   success = compress(contr.result_id); if(!success) break;
+  }
+ }
+ //Destroy the remaining tensors created here (only on failure):
+ for(const auto tensor_id: std::vector<unsigned int>(owned.cbegin(),owned.cend())){
+  auto tensor = net.getTensor(tensor_id);
+  if(tensor) destroy_tensor(tensor,tensor_id);
+ }
+ if(success) success = sync(*output_tensor);
+ return success;
+}
+
+bool NumServer::compressExpansionSync(const TensorExpansion & expansion,
+                                      DimExtent max_bond,
+                                      std::shared_ptr<TensorNetwork> & compressed,
+                                      double & truncation_error)
+{
+ return compressExpansionSync(getDefaultProcessGroup(),expansion,max_bond,compressed,truncation_error);
+}
+
+bool NumServer::compressExpansionSync(const ProcessGroup & process_group,
+                                      const TensorExpansion & expansion,
+                                      DimExtent max_bond,
+                                      std::shared_ptr<TensorNetwork> & compressed,
+                                      double & truncation_error)
+{
+ compressed.reset();
+ truncation_error = 0.0;
+ if(max_bond == 0 || expansion.getNumComponents() == 0 || expansion.getRank() <= 0){
+  std::cout << "#ERROR(exatn::NumServer::compressExpansionSync): Invalid arguments!" << std::endl;
+  return false;
+ }
+ const unsigned int num_sites = expansion.getRank();
+ //Validate the MPS structure of the components and collect their site tensors:
+ struct MPSSite{
+  std::shared_ptr<Tensor> tensor; //site tensor
+  int left;                       //position of the left bond leg (-1: none)
+  int phys;                       //position of the open leg
+  int right;                      //position of the right bond leg (-1: none)
+ };
+ std::vector<std::vector<MPSSite>> components;
+ std::vector<std::complex<double>> coefficients;
+ std::shared_ptr<Tensor> output_tensor;
+ TensorElementType element_type = TensorElementType::VOID;
+ bool success = true;
+ for(auto component = expansion.cbegin(); component != expansion.cend(); ++component){
+  const auto & network = *(component->network);
+  success = (network.getRank() == num_sites && network.getNumTensors() == num_sites);
+  if(!success) break;
+  auto output = network.getTensor(0);
+  if(!output_tensor) output_tensor = output;
+  const auto * output_legs = network.getTensorConnections(0);
+  std::vector<MPSSite> sites(num_sites);
+  std::vector<unsigned int> site_ids(num_sites);
+  for(unsigned int k = 0; k < num_sites; ++k){
+   site_ids[k] = (*output_legs)[k].getTensorId();
+   success = (output->getDimExtent(k) == output_tensor->getDimExtent(k)); if(!success) break;
+  }
+  for(unsigned int k = 0; success && k < num_sites; ++k){
+   bool conjugated = false;
+   auto & site = sites[k];
+   site.tensor = network.getTensor(site_ids[k],&conjugated);
+   site.left = -1; site.phys = -1; site.right = -1;
+   success = (site.tensor && !conjugated && tensors_.find(site.tensor->getNameId()) != tensors_.end());
+   if(!success) break;
+   const auto * legs = network.getTensorConnections(site_ids[k]);
+   for(int i = 0; success && i < static_cast<int>(legs->size()); ++i){
+    const auto neighbor_id = (*legs)[i].getTensorId();
+    if(neighbor_id == 0 && (*legs)[i].getDimensionId() == k && site.phys < 0){
+     site.phys = i;
+    }else if(k > 0 && neighbor_id == site_ids[k-1] && site.left < 0){
+     site.left = i;
+    }else if(k + 1 < num_sites && neighbor_id == site_ids[k+1] && site.right < 0){
+     site.right = i;
+    }else{
+     success = false;
+    }
+   }
+   success = success && (site.phys >= 0) && ((k > 0) == (site.left >= 0)) && ((k + 1 < num_sites) == (site.right >= 0));
+   if(!success) break;
+   const auto site_type = getTensorElementType(site.tensor->getName());
+   if(element_type == TensorElementType::VOID) element_type = site_type;
+   success = (site_type == element_type); if(!success) break;
+  }
+  if(!success) break;
+  components.emplace_back(sites);
+  coefficients.emplace_back(component->coefficient);
+ }
+ if(!success){
+  std::cout << "#ERROR(exatn::NumServer::compressExpansionSync): Tensor network expansion " << expansion.getName()
+            << " does not consist of MPS tensor networks of the same element type!" << std::endl;
+  return false;
+ }
+ if(element_type == TensorElementType::REAL32 || element_type == TensorElementType::REAL64){
+  for(const auto & coefficient: coefficients){
+   if(coefficient.imag() != 0.0){
+    std::cout << "#ERROR(exatn::NumServer::compressExpansionSync): Complex expansion coefficient for real tensors in "
+              << expansion.getName() << std::endl;
+    return false;
+   }
+  }
+ }
+ std::unordered_set<std::string> owned; //names of the tensors created here
+ //Symbolic tensor:
+ auto symbol = [](std::shared_ptr<Tensor> tensor, const std::vector<std::string> & labels, bool conjugated){
+  std::string symb = tensor->getName();
+  if(conjugated) symb += "+";
+  symb += "(";
+  for(std::size_t i = 0; i < labels.size(); ++i){
+   if(i > 0) symb += ",";
+   symb += labels[i];
+  }
+  return symb + ")";
+ };
+ //Creates a new zero tensor:
+ auto create_tensor = [&](const std::vector<DimExtent> & extents, std::shared_ptr<Tensor> & tensor){
+  tensor = std::make_shared<Tensor>("_c",TensorShape(extents));
+  tensor->rename();
+  auto created = createTensor(process_group,tensor,element_type);
+  if(created){
+   owned.emplace(tensor->getName());
+   created = initTensor(tensor->getName(),0.0);
+  }
+  return created;
+ };
+ //Destroys a tensor created here:
+ auto destroy_tensor = [&](std::shared_ptr<Tensor> tensor){
+  owned.erase(tensor->getName());
+  return destroyTensor(tensor->getName());
+ };
+ //Canonical layout of an MPS site tensor: [left bond], open leg, [right bond]:
+ auto site_labels = [&](unsigned int k, const std::string & left, const std::string & phys, const std::string & right){
+  std::vector<std::string> labels;
+  if(k > 0) labels.emplace_back(left);
+  labels.emplace_back(phys);
+  if(k + 1 < num_sites) labels.emplace_back(right);
+  return labels;
+ };
+ //Exact direct sum of the MPS components (block-diagonal site tensors):
+ std::vector<DimExtent> bonds(num_sites,0); //bond k connects sites k and k+1
+ for(const auto & sites: components){
+  for(unsigned int k = 0; k + 1 < num_sites; ++k) bonds[k] += sites[k].tensor->getDimExtent(sites[k].right);
+ }
+ std::vector<std::shared_ptr<Tensor>> mps(num_sites);
+ for(unsigned int k = 0; success && k < num_sites; ++k){
+  std::vector<DimExtent> extents;
+  if(k > 0) extents.emplace_back(bonds[k-1]);
+  extents.emplace_back(output_tensor->getDimExtent(k));
+  if(k + 1 < num_sites) extents.emplace_back(bonds[k]);
+  success = create_tensor(extents,mps[k]);
+ }
+ std::vector<DimExtent> offsets(num_sites,0); //current offset of each bond
+ for(std::size_t c = 0; success && c < components.size(); ++c){
+  const auto & sites = components[c];
+  for(unsigned int k = 0; k < num_sites; ++k){
+   const auto & site = sites[k];
+   std::vector<std::string> labels(site.tensor->getRank());
+   labels[site.phys] = "p";
+   if(site.left >= 0) labels[site.left] = "l";
+   if(site.right >= 0) labels[site.right] = "r";
+   const auto coefficient = (k == 0) ? coefficients[c] : std::complex<double>{1.0,0.0};
+   if(num_sites == 1){ //single site: plain weighted sum
+    success = addTensors(symbol(mps[k],{"p"},false) + "+=" + symbol(site.tensor,labels,false),coefficient);
+    if(!success) break;
+    continue;
+   }
+   //Stage the permuted block of the component with its offsets in the site tensor:
+   std::vector<DimExtent> extents;
+   std::vector<std::pair<SpaceId,SubspaceId>> subspaces;
+   if(k > 0){
+    extents.emplace_back(site.tensor->getDimExtent(site.left));
+    subspaces.emplace_back(std::make_pair(SOME_SPACE,offsets[k-1]));
+   }
+   extents.emplace_back(site.tensor->getDimExtent(site.phys));
+   subspaces.emplace_back(std::make_pair(SOME_SPACE,0));
+   if(k + 1 < num_sites){
+    extents.emplace_back(site.tensor->getDimExtent(site.right));
+    subspaces.emplace_back(std::make_pair(SOME_SPACE,offsets[k]));
+   }
+   auto block = std::make_shared<Tensor>("_b",TensorShape(extents),TensorSignature(subspaces));
+   block->rename();
+   success = createTensor(process_group,block,element_type); if(!success) break;
+   owned.emplace(block->getName());
+   success = initTensor(block->getName(),0.0) &&
+             addTensors(symbol(block,site_labels(k,"l","p","r"),false) + "+=" + symbol(site.tensor,labels,false),coefficient) &&
+             insertTensorSlice(mps[k]->getName(),block->getName()) &&
+             destroy_tensor(block);
+   if(!success) break;
+  }
+  for(unsigned int k = 0; k + 1 < num_sites; ++k) offsets[k] += sites[k].tensor->getDimExtent(sites[k].right);
+ }
+ //Left-to-right sweep: Left-canonical form (A = U * S * V, U is kept, S * V = U+ * A is absorbed into the next site):
+ for(unsigned int k = 0; success && k + 1 < num_sites; ++k){
+  auto site = mps[k];
+  auto next = mps[k+1];
+  const auto rank = site->getRank();
+  const auto right_extent = site->getDimExtent(rank - 1);
+  DimExtent left_volume = 1;
+  for(unsigned int i = 0; i < rank - 1; ++i) left_volume *= site->getDimExtent(i);
+  const auto bond = std::min(left_volume,right_extent);
+  std::vector<DimExtent> extents(site->getDimExtents().cbegin(),site->getDimExtents().cend());
+  extents.back() = bond;
+  std::shared_ptr<Tensor> u, s, v, w, new_next;
+  success = create_tensor(extents,u) && create_tensor({bond},s) &&
+            create_tensor({bond,right_extent},v) && create_tensor({bond,right_extent},w); if(!success) break;
+  extents.assign(next->getDimExtents().cbegin(),next->getDimExtents().cend());
+  extents.front() = bond;
+  success = create_tensor(extents,new_next); if(!success) break;
+  const auto labels = site_labels(k,"l","p","r");
+  const auto u_labels = site_labels(k,"l","p","i");
+  success = decomposeTensorSVDSync(symbol(site,labels,false) + "=" + symbol(u,u_labels,false) + "*" +
+                                   symbol(s,{"i"},false) + "*" + symbol(v,{"i","r"},false)) &&
+            contractTensors(symbol(w,{"i","r"},false) + "+=" + symbol(u,u_labels,true) + "*" + symbol(site,labels,false),1.0) &&
+            contractTensors(symbol(new_next,site_labels(k+1,"i","q","s"),false) + "+=" +
+                            symbol(w,{"i","r"},false) + "*" + symbol(next,site_labels(k+1,"r","q","s"),false),1.0);
+  if(!success) break;
+  success = destroy_tensor(site) && destroy_tensor(s) && destroy_tensor(v) &&
+            destroy_tensor(w) && destroy_tensor(next); if(!success) break;
+  mps[k] = u;
+  mps[k+1] = new_next;
+ }
+ //Right-to-left sweep: Truncation (A = U * S * V, V is kept, U * S = A * V+ is absorbed into the previous site):
+ double discarded = 0.0; //squared norm of the discarded singular values
+ for(unsigned int k = num_sites - 1; success && k > 0; --k){
+  auto site = mps[k];
+  auto prev = mps[k-1];
+  const auto left_extent = site->getDimExtent(0);
+  DimExtent right_volume = 1;
+  for(unsigned int i = 1; i < site->getRank(); ++i) right_volume *= site->getDimExtent(i);
+  const auto bond = std::min(max_bond,std::min(left_extent,right_volume));
+  std::vector<DimExtent> extents(site->getDimExtents().cbegin(),site->getDimExtents().cend());
+  extents.front() = bond;
+  std::shared_ptr<Tensor> u, s, v, w, new_prev;
+  success = create_tensor({left_extent,bond},u) && create_tensor({bond},s) &&
+            create_tensor(extents,v) && create_tensor({left_extent,bond},w); if(!success) break;
+  extents.assign(prev->getDimExtents().cbegin(),prev->getDimExtents().cend());
+  extents.back() = bond;
+  success = create_tensor(extents,new_prev); if(!success) break;
+  const auto labels = site_labels(k,"l","p","r");
+  const auto v_labels = site_labels(k,"i","p","r");
+  success = decomposeTensorSVDSync(symbol(site,labels,false) + "=" + symbol(u,{"l","i"},false) + "*" +
+                                   symbol(s,{"i"},false) + "*" + symbol(v,v_labels,false)) &&
+            contractTensors(symbol(w,{"l","i"},false) + "+=" + symbol(site,labels,false) + "*" + symbol(v,v_labels,true),1.0) &&
+            contractTensors(symbol(new_prev,site_labels(k-1,"m","q","i"),false) + "+=" +
+                            symbol(prev,site_labels(k-1,"m","q","l"),false) + "*" + symbol(w,{"l","i"},false),1.0);
+  if(!success) break;
+  //Local truncation error: ||A - U * S * V||^2 = ||A||^2 - ||A * V+||^2 (V is isometric):
+  double site_norm = 0.0, retained_norm = 0.0;
+  success = computeNorm2Sync(site->getName(),site_norm) &&
+            computeNorm2Sync(w->getName(),retained_norm); if(!success) break;
+  discarded += std::max(0.0,site_norm * site_norm - retained_norm * retained_norm);
+  success = destroy_tensor(site) && destroy_tensor(u) && destroy_tensor(s) &&
+            destroy_tensor(w) && destroy_tensor(prev); if(!success) break;
+  mps[k] = v;
+  mps[k-1] = new_prev;
+ }
+ truncation_error = std::sqrt(discarded);
+ //Assemble the compressed MPS:
+ if(success){
+  auto output = makeSharedTensor(*output_tensor);
+  output->rename();
+  std::map<std::string,std::shared_ptr<Tensor>> tensors{{output->getName(),output}};
+  std::vector<std::string> open_labels(num_sites);
+  for(unsigned int k = 0; k < num_sites; ++k) open_labels[k] = "u" + std::to_string(k);
+  std::string spec = symbol(output,open_labels,false) + "+=";
+  for(unsigned int k = 0; k < num_sites; ++k){
+   if(k > 0) spec += "*";
+   spec += symbol(mps[k],site_labels(k,"c"+std::to_string(k-1),open_labels[k],"c"+std::to_string(k)),false);
+   tensors.emplace(mps[k]->getName(),mps[k]);
+   owned.erase(mps[k]->getName());
+  }
+  compressed = std::make_shared<TensorNetwork>(expansion.getName(),spec,tensors);
+  success = sync(process_group);
  }
+ //Destroy the remaining tensors created here (only on failure):
+ for(const auto & name: std::vector<std::string>(owned.cbegin(),owned.cend())) destroyTensor(name);
  return success;
 }
 
@@ -2541,15 +6286,15 @@ bool NumServer::copyTensor(const std::string & output_name,
 {
  bool success = true;
  if(output_name != input_name){
-  auto iter = tensors_.find(input_name);
+  auto iter = tensors_.find(lookupNameId(input_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
-   iter = tensors_.find(output_name);
+   iter = tensors_.find(lookupNameId(output_name));
    if(iter == tensors_.end()){
     auto output_tensor = getTensor(input_name)->clone();
     output_tensor->rename(output_name);
     success = createTensor(output_tensor,output_tensor->getElementType());
-    if(success) iter = tensors_.find(output_name);
+    if(success) iter = tensors_.find(lookupNameId(output_name));
    }
    if(success){
     auto tensor0 = iter->second;
@@ -2584,15 +6329,15 @@ bool NumServer::copyTensorSync(const std::string & output_name,
 {
  bool success = true;
  if(output_name != input_name){
-  auto iter = tensors_.find(input_name);
+  auto iter = tensors_.find(lookupNameId(input_name));
   if(iter != tensors_.end()){
    auto tensor1 = iter->second;
-   iter = tensors_.find(output_name);
+   iter = tensors_.find(lookupNameId(output_name));
    if(iter == tensors_.end()){
     auto output_tensor = getTensor(input_name)->clone();
     output_tensor->rename(output_name);
     success = createTensorSync(output_tensor,output_tensor->getElementType());
-    if(success) iter = tensors_.find(output_name);
+    if(success) iter = tensors_.find(lookupNameId(output_name));
    }
    if(success){
     auto tensor0 = iter->second;
@@ -2622,6 +6367,195 @@ bool NumServer::copyTensorSync(const std::string & output_name,
  return success;
 }
 
+TensorOperationHandle NumServer::prepareAddition(const std::string & addition)
+{
+ TensorOperationHandle handle;
+ prepareTensorOperation(addition,TensorOpCode::ADD,handle);
+ return handle;
+}
+
+TensorOperationHandle NumServer::prepareContraction(const std::string & contraction)
+{
+ TensorOperationHandle handle;
+ prepareTensorOperation(contraction,TensorOpCode::CONTRACT,handle);
+ return handle;
+}
+
+std::shared_ptr<const ParsedTensorOperation> NumServer::parseTensorOperation(const std::string & specification,
+                                                                             TensorOpCode opcode)
+{
+ static constexpr std::size_t MAX_PARSED_OPERATIONS = 4096; //bound on the number of cached parsed specifications
+ assert(opcode == TensorOpCode::ADD || opcode == TensorOpCode::CONTRACT);
+ const ParsedOperationKey key(opcode,specification);
+ auto iter = parsed_operations_.find(key);
+ if(iter != parsed_operations_.end()) return iter->second;
+ const bool contraction = (opcode == TensorOpCode::CONTRACT);
+ const std::string caller = contraction ? "contractTensors" : "addTensors";
+ const std::string kind = contraction ? "tensor contraction" : "tensor addition";
+ auto parsed_op = std::make_shared<ParsedTensorOperation>();
+ parsed_op->opcode = opcode;
+ parsed_op->pattern = specification;
+ std::vector<std::string> tensors;
+ bool parsed = false;
+ if(contraction){
+  parsed = parse_tensor_contraction(specification,tensors,parsed_op->left_inds,parsed_op->right_inds,
+                                    parsed_op->contr_inds,parsed_op->hyper_inds);
+ }else{
+  parsed = parse_tensor_network(specification,tensors);
+ }
+ if(!parsed){
+  std::cout << "#ERROR(exatn::NumServer::" << caller << "): Invalid " << kind << ": " << specification << std::endl;
+  return std::shared_ptr<const ParsedTensorOperation>(nullptr);
+ }
+ if(tensors.size() != (contraction ? 3 : 2)){
+  std::cout << "#ERROR(exatn::NumServer::" << caller << "): Invalid number of arguments in " << kind << ": "
+            << specification << std::endl;
+  return std::shared_ptr<const ParsedTensorOperation>(nullptr);
+ }
+ std::string tensor_name;
+ std::vector<IndexLabel> indices;
+ for(unsigned int i = 0; i < tensors.size(); ++i){
+  bool complex_conj = false;
+  if(!parse_tensor(tensors[i],tensor_name,indices,complex_conj)){
+   std::cout << "#ERROR(exatn::NumServer::" << caller << "): Invalid argument#" << i << " in " << kind << ": "
+             << specification << std::endl;
+   return std::shared_ptr<const ParsedTensorOperation>(nullptr);
+  }
+  if(i == 0) assert(!complex_conj);
+  parsed_op->tensor_names.emplace_back(tensor_name);
+  parsed_op->conjugated.emplace_back(complex_conj);
+ }
+ if(parsed_operations_.size() >= MAX_PARSED_OPERATIONS) parsed_operations_.clear();
+ auto res = parsed_operations_.emplace(std::make_pair(key,
+             std::shared_ptr<const ParsedTensorOperation>(parsed_op)));
+ return res.first->second; //another client thread may have cached the same specification meanwhile
+}
+
+bool NumServer::prepareTensorOperation(const std::string & specification,
+                                       TensorOpCode opcode,
+                                       TensorOperationHandle & handle)
+{
+ handle.reset();
+ auto parsed_op = parseTensorOperation(specification,opcode);
+ if(!parsed_op) return false;
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::vector<std::string> domain_names; //structured tensors do not have their own existence domain
+ for(unsigned int i = 0; i < parsed_op->tensor_names.size(); ++i){
+  const auto & tensor_name = parsed_op->tensor_names[i];
+  auto iter = tensors_.find(lookupNameId(tensor_name));
+  if(iter == tensors_.end()){
+   std::shared_ptr<TensorStructured> structured;
+   if(opcode == TensorOpCode::CONTRACT && i > 0) structured = getTensorStructured(tensor_name);
+   if(!structured) return true; //current process does not participate
+   tensors.emplace_back(structured);
+   domain_names.emplace_back(parsed_op->tensor_names[0]);
+  }else{
+   tensors.emplace_back(iter->second);
+   domain_names.emplace_back(tensor_name);
+  }
+ }
+ const auto & process_group = (opcode == TensorOpCode::CONTRACT) ?
+  getTensorProcessGroup(domain_names[0],domain_names[1],domain_names[2]) :
+  getTensorProcessGroup(domain_names[0],domain_names[1]);
+ auto prepared = std::make_shared<PreparedTensorOperation>(PreparedTensorOperation{parsed_op,std::move(tensors),process_group});
+ handle = prepared;
+ return true;
+}
+
+bool NumServer::executeTensorOperation(const PreparedTensorOperation & prepared,
+                                       std::complex<double> alpha,
+                                       bool synchronous)
+{
+ const auto & parsed_op = *(prepared.parsed);
+ const auto & tensors = prepared.tensors;
+ const auto & process_group = prepared.process_group;
+ std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(parsed_op.opcode);
+ for(unsigned int i = 0; i < tensors.size(); ++i) op->setTensorOperand(tensors[i],parsed_op.conjugated[i]);
+ op->setIndexPattern(parsed_op.pattern);
+ op->setScalar(0,alpha);
+ bool success = true;
+ const bool structured = (parsed_op.opcode == TensorOpCode::CONTRACT &&
+                          (castTensorStructured(tensors[1]) || castTensorStructured(tensors[2])));
+ if(parsed_op.opcode == TensorOpCode::CONTRACT && !structured){
+  //Create temporary tensors with optimized distributed layout and copy tensor data:
+  bool redistribution = false;
+  std::dynamic_pointer_cast<numerics::TensorOpContract>(op)->
+   introduceOptTemporaries(process_group.getSize(),process_group.getMemoryLimitPerProcess(),
+                           parsed_op.left_inds,parsed_op.right_inds,parsed_op.contr_inds,parsed_op.hyper_inds);
+  std::vector<std::shared_ptr<Tensor>> temps;
+  for(unsigned int i = 0; i < tensors.size(); ++i) temps.emplace_back(op->getTensorOperand(i));
+  for(unsigned int i = 0; i < tensors.size(); ++i){
+   if(success && temps[i] != tensors[i]){
+    redistribution = true;
+    success = createTensorSync(temps[i],tensors[i]->getElementType());
+    if(success){
+     if(synchronous){
+      success = copyTensorSync(temps[i]->getName(),tensors[i]->getName());
+     }else{
+      success = copyTensor(temps[i]->getName(),tensors[i]->getName());
+     }
+    }
+   }
+  }
+#ifdef MPI_ENABLED
+  if(!synchronous && success && redistribution) success = sync(process_group);
+#else
+  (void)redistribution; //process group synchronization is only needed with MPI
+#endif
+  //Submit tensor contraction for execution:
+  if(success){
+   success = submit(op,getTensorMapper(process_group));
+   if(synchronous && success){
+    success = sync(*op);
+#ifdef MPI_ENABLED
+    if(success) success = sync(process_group);
+#endif
+   }
+  }
+  //Copy the result back:
+  if(success && temps[0] != tensors[0]){
+   if(synchronous){
+    success = copyTensorSync(tensors[0]->getName(),temps[0]->getName());
+   }else{
+#ifdef MPI_ENABLED
+    if(redistribution) success = sync(process_group);
+#endif
+    if(success) success = copyTensor(tensors[0]->getName(),temps[0]->getName());
+   }
+  }
+  //Destroy temporary tensors:
+  for(unsigned int i = tensors.size() - 1; i > 0; --i){
+   if(success && temps[i] != tensors[i]){
+    success = synchronous ? destroyTensorSync(temps[i]->getName()) : destroyTensor(temps[i]->getName());
+   }
+  }
+#ifdef MPI_ENABLED
+  if(!synchronous && success && redistribution) success = sync(process_group);
+#endif
+  if(success && temps[0] != tensors[0]){
+   success = synchronous ? destroyTensorSync(temps[0]->getName()) : destroyTensor(temps[0]->getName());
+  }
+ }else{
+  success = submit(op,getTensorMapper(process_group));
+  if(synchronous && success){
+   success = structured ? sync(*(tensors[0])) : sync(*op); //structured contraction is executed by other operations
+#ifdef MPI_ENABLED
+   if(success) success = sync(process_group);
+#endif
+  }
+ }
+ //Enforce the isometries of the output tensor:
+ if(success){
+  const auto & tensor0 = tensors[0];
+  if(tensor0->hasIsometries()){
+   const auto & isometries = tensor0->retrieveIsometries();
+   std::shared_ptr<TensorMethod> isometrize(new numerics::FunctorIsometrize(*(isometries.cbegin()),isometrize_method_));
+   success = synchronous ? transformTensorSync(tensor0->getName(),isometrize) : transformTensor(tensor0->getName(),isometrize);
+  }
+ }
+ return success;
+}
+
 bool NumServer::decomposeTensorSVD(const std::string & contraction)
 {
  std::vector<std::string> tensors;
@@ -2634,30 +6568,31 @@ bool NumServer::decomposeTensorSVD(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          parsed = parse_tensor(tensors[3],tensor_name,indices,complex_conj3);
          if(parsed){
           assert(!complex_conj3);
-          iter = tensors_.find(tensor_name);
+          iter = tensors_.find(lookupNameId(tensor_name));
           if(iter != tensors_.end()){
            auto tensor3 = iter->second;
            const auto & process_group = getTensorProcessGroup(tensor1->getName(),tensor3->getName(),tensor2->getName(),tensor0->getName());
            auto tensor_mapper = getTensorMapper(process_group);
            std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DECOMPOSE_SVD3);
+           std::dynamic_pointer_cast<numerics::TensorOpDecomposeSVD3>(op)->resetTruncation(svd_randomized_,svd_tolerance_);
            op->setTensorOperand(tensor1,complex_conj1); //out: left tensor factor
            op->setTensorOperand(tensor3,complex_conj3); //out: right tensor factor
            op->setTensorOperand(tensor2,complex_conj2); //out: middle tensor factor
@@ -2724,30 +6659,31 @@ bool NumServer::decomposeTensorSVDSync(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          parsed = parse_tensor(tensors[3],tensor_name,indices,complex_conj3);
          if(parsed){
           assert(!complex_conj3);
-          iter = tensors_.find(tensor_name);
+          iter = tensors_.find(lookupNameId(tensor_name));
           if(iter != tensors_.end()){
            auto tensor3 = iter->second;
            const auto & process_group = getTensorProcessGroup(tensor1->getName(),tensor3->getName(),tensor2->getName(),tensor0->getName());
            auto tensor_mapper = getTensorMapper(process_group);
            std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DECOMPOSE_SVD3);
+           std::dynamic_pointer_cast<numerics::TensorOpDecomposeSVD3>(op)->resetTruncation(svd_randomized_,svd_tolerance_);
            op->setTensorOperand(tensor1,complex_conj1); //out: left tensor factor
            op->setTensorOperand(tensor3,complex_conj3); //out: right tensor factor
            op->setTensorOperand(tensor2,complex_conj2); //out: middle tensor factor
@@ -2846,24 +6782,25 @@ bool NumServer::decomposeTensorSVDLR(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          const auto & process_group = getTensorProcessGroup(tensor1->getName(),tensor2->getName(),tensor0->getName());
          auto tensor_mapper = getTensorMapper(process_group);
          std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DECOMPOSE_SVD2);
+         std::dynamic_pointer_cast<numerics::TensorOpDecomposeSVD2>(op)->resetTruncation(svd_randomized_,svd_tolerance_);
          op->setTensorOperand(tensor1,complex_conj1); //out: left tensor factor
          op->setTensorOperand(tensor2,complex_conj2); //out: right tensor factor
          op->setTensorOperand(tensor0,complex_conj0); //in: original tensor
@@ -2920,24 +6857,25 @@ bool NumServer::decomposeTensorSVDLRSync(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          const auto & process_group = getTensorProcessGroup(tensor1->getName(),tensor2->getName(),tensor0->getName());
          auto tensor_mapper = getTensorMapper(process_group);
          std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::DECOMPOSE_SVD2);
+         std::dynamic_pointer_cast<numerics::TensorOpDecomposeSVD2>(op)->resetTruncation(svd_randomized_,svd_tolerance_);
          op->setTensorOperand(tensor1,complex_conj1); //out: left tensor factor
          op->setTensorOperand(tensor2,complex_conj2); //out: right tensor factor
          op->setTensorOperand(tensor0,complex_conj0); //in: original tensor
@@ -3002,19 +6940,19 @@ bool NumServer::orthogonalizeTensorSVD(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName(),tensor2->getName());
@@ -3074,19 +7012,19 @@ bool NumServer::orthogonalizeTensorSVDSync(const std::string & contraction)
    parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
    if(parsed){
     assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
+    auto iter = tensors_.find(lookupNameId(tensor_name));
     if(iter != tensors_.end()){
      auto tensor0 = iter->second;
      parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
      if(parsed){
       assert(!complex_conj1);
-      iter = tensors_.find(tensor_name);
+      iter = tensors_.find(lookupNameId(tensor_name));
       if(iter != tensors_.end()){
        auto tensor1 = iter->second;
        parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
        if(parsed){
         assert(!complex_conj2);
-        iter = tensors_.find(tensor_name);
+        iter = tensors_.find(lookupNameId(tensor_name));
         if(iter != tensors_.end()){
          auto tensor2 = iter->second;
          const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName(),tensor2->getName());
@@ -3144,7 +7082,7 @@ bool NumServer::orthogonalizeTensorSVDSync(const std::string & contraction)
 
 bool NumServer::orthogonalizeTensorMGS(const std::string & name)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#ERROR(exatn::NumServer::orthogonalizeTensorMGS): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -3160,7 +7098,7 @@ bool NumServer::orthogonalizeTensorMGS(const std::string & name)
 
 bool NumServer::orthogonalizeTensorMGSSync(const std::string & name)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()){
   //std::cout << "#ERROR(exatn::NumServer::orthogonalizeTensorMGSSync): Tensor " << name << " not found!" << std::endl;
   return true;
@@ -3181,6 +7119,37 @@ bool NumServer::orthogonalizeTensorMGSSync(const std::string & name)
  return parsed;
 }
 
+bool NumServer::isometrizeTensor(const std::string & name,
+                                 IsometrizeMethod method)
+{
+ auto tensor = getTensor(name);
+ if(!tensor) return true;
+ if(!(tensor->hasIsometries())) return true;
+ const auto & isometries = tensor->retrieveIsometries();
+ return transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()),method)));
+}
+
+bool NumServer::isometrizeTensorSync(const std::string & name,
+                                     IsometrizeMethod method)
+{
+ auto tensor = getTensor(name);
+ if(!tensor) return true;
+ if(!(tensor->hasIsometries())) return true;
+ const auto & isometries = tensor->retrieveIsometries();
+ return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()),method)));
+}
+
+void NumServer::resetIsometrizeMethod(IsometrizeMethod method)
+{
+ isometrize_method_ = method;
+ return;
+}
+
+IsometrizeMethod NumServer::getIsometrizeMethod() const
+{
+ return isometrize_method_;
+}
+
 bool NumServer::printTensor(const std::string & name){
  return transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint()));
 }
@@ -3189,12 +7158,307 @@ bool NumServer::printTensorSync(const std::string & name){
  return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint()));
 }
 
-bool NumServer::printTensorFile(const std::string & name, const std::string & filename){
- return transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint(filename)));
+bool NumServer::printTensorFile(const std::string & name, const std::string & filename, bool binary){
+ return transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint(filename,binary)));
+}
+
+bool NumServer::printTensorFileSync(const std::string & name, const std::string & filename, bool binary){
+ return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint(filename,binary)));
+}
+
+bool NumServer::saveTensors(const ProcessGroup & process_group,
+                            const std::string & filename,
+                            const std::vector<std::string> & tensor_names)
+{
+ unsigned int local_rank; //local process rank within the process group
+ if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
+ if(!numerics::hostIsLittleEndian()){
+  std::cout << "#ERROR(exatn::NumServer::saveTensors): Checkpoint files require a little-endian host!" << std::endl;
+  return false;
+ }
+ auto tensor_mapper = getTensorMapper(process_group);
+ //Collect the saved tensors:
+ std::vector<std::string> names(tensor_names);
+ if(names.empty()){
+  for(const auto & tens: tensors_.entries()){
+   const auto & tens_name = tens.second->getName();
+   bool implicit = false;
+   {std::lock_guard<std::recursive_mutex> lock(tensor_mtx_); implicit = (implicit_tensors_.find(tens_name) != implicit_tensors_.end());}
+   if(!implicit && getTensorProcessGroup(tens_name) == process_group) names.emplace_back(tens_name);
+  }
+  std::sort(names.begin(),names.end()); //same order on all processes
+ }
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ for(const auto & name: names){
+  auto iter = tensors_.find(lookupNameId(name));
+  if(iter == tensors_.end()){
+   std::cout << "#ERROR(exatn::NumServer::saveTensors): Tensor " << name << " not found!" << std::endl;
+   return false;
+  }
+  if(!(getTensorProcessGroup(name) == process_group)){
+   std::cout << "#ERROR(exatn::NumServer::saveTensors): Tensor " << name
+             << " does not exist in the given process group!" << std::endl;
+   return false;
+  }
+  tensors.emplace_back(iter->second);
+ }
+
+ //Lay out the checkpoint file (identically on all processes):
+ struct BlockBody{
+  std::shared_ptr<Tensor> tensor; //(sub)tensor
+  unsigned int writer;            //writing process (local rank)
+  std::uint64_t position;         //absolute position in the file
+  std::uint64_t size;             //size in bytes
+ };
+ auto align_up = [](std::uint64_t pos, std::uint64_t alignment){
+  return ((pos + alignment - 1) / alignment) * alignment;
+ };
+ std::vector<char> header; //file header and tensor records (written by the first process)
+ auto append = [&header](auto value){
+  const char * ptr = reinterpret_cast<const char*>(&value);
+  header.insert(header.end(),ptr,ptr+sizeof(value));
+ };
+ std::vector<std::vector<BlockBody>> bodies(tensors.size());
+ std::vector<std::uint64_t> record_pos(tensors.size());
+ std::uint64_t pos = (sizeof(numerics::BINARY_CHECKPOINT_FILE_MAGIC) - 1) + sizeof(std::uint64_t);
+ for(const auto & name: names) pos += sizeof(std::uint32_t) + name.length() + sizeof(std::uint64_t);
+ for(std::size_t i = 0; i < tensors.size(); ++i){
+  const auto & tensor = tensors[i];
+  const std::uint64_t tens_rank = tensor->getRank();
+  const auto elem_size = TensorElementTypeSize(tensor->getElementType());
+  if(tensor->isComposite()){
+   auto composite = castTensorComposite(tensor);
+   for(auto subtens = composite->begin(); subtens != composite->end(); ++subtens){
+    bodies[i].emplace_back(BlockBody{subtens->second,
+                                     tensor_mapper->subtensorFirstOwnerId(*composite,subtens->first),
+                                     0,subtens->second->getVolume()*elem_size});
+   }
+  }else{
+   bodies[i].emplace_back(BlockBody{tensor,0,0,tensor->getVolume()*elem_size});
+  }
+  record_pos[i] = pos;
+  pos += (sizeof(numerics::BINARY_TENSOR_FILE_MAGIC) - 1) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t)
+       + (2 * tens_rank) * sizeof(std::uint64_t) + bodies[i].size() * (2 * tens_rank + 1) * sizeof(std::uint64_t);
+ }
+ for(auto & tensor_bodies: bodies){
+  for(auto & body: tensor_bodies){
+   pos = align_up(pos,(body.size >= CHECKPOINT_STRIPE_SIZE) ? CHECKPOINT_STRIPE_SIZE : numerics::BINARY_TENSOR_FILE_ALIGNMENT);
+   body.position = pos;
+   pos += body.size;
+  }
+ }
+ const std::uint64_t file_size = pos;
+ if(local_rank == 0){
+  header.insert(header.end(),numerics::BINARY_CHECKPOINT_FILE_MAGIC,
+                numerics::BINARY_CHECKPOINT_FILE_MAGIC + sizeof(numerics::BINARY_CHECKPOINT_FILE_MAGIC) - 1);
+  append(static_cast<std::uint64_t>(names.size()));
+  for(std::size_t i = 0; i < names.size(); ++i){
+   append(static_cast<std::uint32_t>(names[i].length()));
+   header.insert(header.end(),names[i].cbegin(),names[i].cend());
+   append(record_pos[i]);
+  }
+  for(std::size_t i = 0; i < tensors.size(); ++i){
+   const auto & tensor = tensors[i];
+   assert(header.size() == record_pos[i]);
+   numerics::BinaryTensorElem elem_type;
+   switch(tensor->getElementType()){
+    case TensorElementType::REAL32: elem_type = numerics::BinaryTensorElem::REAL32; break;
+    case TensorElementType::REAL64: elem_type = numerics::BinaryTensorElem::REAL64; break;
+    case TensorElementType::COMPLEX32: elem_type = numerics::BinaryTensorElem::COMPLEX32; break;
+    case TensorElementType::COMPLEX64: elem_type = numerics::BinaryTensorElem::COMPLEX64; break;
+    case TensorElementType::REAL16: elem_type = numerics::BinaryTensorElem::REAL16; break;
+    case TensorElementType::COMPLEX16: elem_type = numerics::BinaryTensorElem::COMPLEX16; break;
+    default:
+     std::cout << "#ERROR(exatn::NumServer::saveTensors): Tensor " << names[i]
+               << " has an unsupported element type!" << std::endl;
+     assert(false);
+   }
+   const unsigned int tens_rank = tensor->getRank();
+   header.insert(header.end(),numerics::BINARY_TENSOR_FILE_MAGIC,
+                 numerics::BINARY_TENSOR_FILE_MAGIC + sizeof(numerics::BINARY_TENSOR_FILE_MAGIC) - 1);
+   append(static_cast<std::uint32_t>(elem_type));
+   append(static_cast<std::uint32_t>(tens_rank));
+   append(static_cast<std::uint64_t>(bodies[i].size()));
+   for(unsigned int j = 0; j < tens_rank; ++j) append(static_cast<std::uint64_t>(tensor->getDimExtent(j)));
+   for(unsigned int j = 0; j < tens_rank; ++j) append(dim_base_offset(*tensor,j));
+   for(const auto & body: bodies[i]){
+    for(unsigned int j = 0; j < tens_rank; ++j) append(dim_base_offset(*(body.tensor),j));
+    for(unsigned int j = 0; j < tens_rank; ++j) append(static_cast<std::uint64_t>(body.tensor->getDimExtent(j)));
+    append(body.position - record_pos[i]); //relative to the tensor record
+   }
+  }
+ }
+
+ //Returns a pointer to the host body of a local tensor copy:
+ auto body_ptr = [](const talsh::Tensor & local_tensor){
+  const void * ptr = nullptr;
+  const float * body_r4 = nullptr;
+  const double * body_r8 = nullptr;
+  const std::complex<float> * body_c4 = nullptr;
+  const std::complex<double> * body_c8 = nullptr;
+  if(local_tensor.getDataAccessHostConst(&body_r4)) ptr = body_r4;
+  else if(local_tensor.getDataAccessHostConst(&body_r8)) ptr = body_r8;
+  else if(local_tensor.getDataAccessHostConst(&body_c4)) ptr = body_c4;
+  else if(local_tensor.getDataAccessHostConst(&body_c8)) ptr = body_c8;
+  return ptr;
+ };
+
+ //Converts the single-precision host body of a half-precision tensor into binary16 numbers:
+ auto convert_to_half = [](const char * data, std::uint64_t size, std::vector<char> & buffer){
+  const std::size_t num_comps = size / sizeof(numerics::Float16);
+  buffer.resize(size);
+  const float * src = reinterpret_cast<const float*>(data);
+  auto * dst = reinterpret_cast<numerics::Float16*>(buffer.data());
+  for(std::size_t k = 0; k < num_comps; ++k) dst[k] = src[k];
+  return static_cast<const char*>(buffer.data());
+ };
+
+ bool success = true;
+#ifdef MPI_ENABLED
+ auto & comm = process_group.getMPICommProxy().getRef<MPI_Comm>();
+ MPI_File file;
+ auto errc = MPI_File_open(comm,filename.c_str(),MPI_MODE_CREATE|MPI_MODE_WRONLY,MPI_INFO_NULL,&file);
+ if(errc != MPI_SUCCESS){
+  std::cout << "#ERROR(exatn::NumServer::saveTensors): Unable to open file " << filename << std::endl;
+  return false;
+ }
+ errc = MPI_File_set_size(file,static_cast<MPI_Offset>(file_size)); success = success && (errc == MPI_SUCCESS);
+ //Issues the asynchronous chunked write of a contiguous buffer:
+ auto write_async = [&file](const char * data, std::uint64_t size, std::uint64_t position,
+                            std::vector<MPI_Request> & requests){
+  bool written = true;
+  std::uint64_t offset = 0;
+  while(offset < size){ //chunked write (int count)
+   const int chunk = static_cast<int>(std::min(size - offset,static_cast<std::uint64_t>(1ULL << 30)));
+   requests.emplace_back(MPI_REQUEST_NULL);
+   auto errc = MPI_File_iwrite_at(file,static_cast<MPI_Offset>(position + offset),data + offset,
+                                  chunk,MPI_CHAR,&(requests.back()));
+   written = written && (errc == MPI_SUCCESS);
+   offset += chunk;
+  }
+  return written;
+ };
+ std::vector<MPI_Request> requests, prev_requests;
+ std::shared_ptr<talsh::Tensor> prev_local_tensor;
+ std::vector<char> half_buffer, prev_half_buffer;
+ if(local_rank == 0) success = success && write_async(header.data(),header.size(),0,prev_requests);
+ for(const auto & tensor_bodies: bodies){
+  for(const auto & body: tensor_bodies){
+   if(body.writer == local_rank){
+    auto local_tensor = getLocalTensor(body.tensor); //overlaps with the write of the previous block
+    const char * data = static_cast<const char*>(local_tensor ? body_ptr(*local_tensor) : nullptr);
+    if(data == nullptr){
+     std::cout << "#ERROR(exatn::NumServer::saveTensors): Unable to access tensor " << body.tensor->getName() << std::endl;
+     success = false;
+     continue;
+    }
+    if(tensorElementTypeIsHalf(body.tensor->getElementType())) data = convert_to_half(data,body.size,half_buffer);
+    requests.clear();
+    success = success && write_async(data,body.size,body.position,requests);
+    if(!prev_requests.empty()){
+     errc = MPI_Waitall(prev_requests.size(),prev_requests.data(),MPI_STATUSES_IGNORE);
+     success = success && (errc == MPI_SUCCESS);
+    }
+    prev_requests.swap(requests);
+    prev_local_tensor = local_tensor; //keep the body alive until its write completes
+    prev_half_buffer.swap(half_buffer);
+   }
+  }
+ }
+ if(!prev_requests.empty()){
+  errc = MPI_Waitall(prev_requests.size(),prev_requests.data(),MPI_STATUSES_IGNORE);
+  success = success && (errc == MPI_SUCCESS);
+ }
+ errc = MPI_File_close(&file); success = success && (errc == MPI_SUCCESS);
+#else
+ std::ofstream file(filename,std::fstream::out|std::fstream::binary|std::fstream::trunc);
+ if(!file.is_open()){
+  std::cout << "#ERROR(exatn::NumServer::saveTensors): Unable to open file " << filename << std::endl;
+  return false;
+ }
+ file.write(header.data(),header.size());
+ std::vector<char> half_buffer;
+ for(const auto & tensor_bodies: bodies){
+  for(const auto & body: tensor_bodies){
+   auto local_tensor = getLocalTensor(body.tensor);
+   const char * data = static_cast<const char*>(local_tensor ? body_ptr(*local_tensor) : nullptr);
+   if(data == nullptr){
+    std::cout << "#ERROR(exatn::NumServer::saveTensors): Unable to access tensor " << body.tensor->getName() << std::endl;
+    success = false;
+    continue;
+   }
+   if(tensorElementTypeIsHalf(body.tensor->getElementType())) data = convert_to_half(data,body.size,half_buffer);
+   file.seekp(body.position);
+   file.write(data,body.size);
+  }
+ }
+ if(file.good() && static_cast<std::uint64_t>(file.tellp()) < file_size){ //pad a missing trailing body to the full file size
+  file.seekp(file_size - 1);
+  file.put('\0');
+ }
+ success = success && file.good() && (static_cast<std::uint64_t>(file.tellp()) == file_size);
+ file.close();
+#endif
+ if(!success) std::cout << "#ERROR(exatn::NumServer::saveTensors): Failed to write file " << filename << std::endl;
+ return success;
+}
+
+bool NumServer::saveTensors(const std::string & filename,
+                            const std::vector<std::string> & tensor_names)
+{
+ return saveTensors(getDefaultProcessGroup(),filename,tensor_names);
 }
 
-bool NumServer::printTensorFileSync(const std::string & name, const std::string & filename){
- return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorPrint(filename)));
+bool NumServer::loadTensors(const std::string & filename,
+                            const std::vector<std::string> & tensor_names)
+{
+ //Read the table of contents of the checkpoint file:
+ std::map<std::string,std::uint64_t> records; //tensor name --> tensor record position
+ std::ifstream file(filename,std::fstream::in|std::fstream::binary);
+ if(!file.is_open()){
+  std::cout << "#ERROR(exatn::NumServer::loadTensors): File not found: " << filename << std::endl;
+  return false;
+ }
+ char magic[sizeof(numerics::BINARY_CHECKPOINT_FILE_MAGIC)] = {'\0'};
+ file.read(magic,sizeof(numerics::BINARY_CHECKPOINT_FILE_MAGIC)-1);
+ std::uint64_t num_tensors = 0;
+ bool success = (std::string(magic) == numerics::BINARY_CHECKPOINT_FILE_MAGIC);
+ if(success) success = static_cast<bool>(file.read(reinterpret_cast<char*>(&num_tensors),sizeof(num_tensors)));
+ for(std::uint64_t i = 0; success && i < num_tensors; ++i){
+  std::uint32_t name_len = 0;
+  std::uint64_t record_pos = 0;
+  success = static_cast<bool>(file.read(reinterpret_cast<char*>(&name_len),sizeof(name_len)));
+  std::string name(name_len,'\0');
+  if(success && name_len > 0) success = static_cast<bool>(file.read(&(name[0]),name_len));
+  if(success) success = static_cast<bool>(file.read(reinterpret_cast<char*>(&record_pos),sizeof(record_pos)));
+  if(success) records.emplace(std::make_pair(name,record_pos));
+ }
+ file.close();
+ if(!success){
+  std::cout << "#ERROR(exatn::NumServer::loadTensors): Invalid format of checkpoint file " << filename << std::endl;
+  return false;
+ }
+ //Initialize the tensors from their records:
+ std::vector<std::string> names(tensor_names);
+ if(names.empty()){
+  for(const auto & record: records){
+   if(tensors_.find(lookupNameId(record.first)) != tensors_.end()) names.emplace_back(record.first);
+  }
+ }
+ for(const auto & name: names){
+  auto record = records.find(name);
+  if(record == records.end()){
+   std::cout << "#ERROR(exatn::NumServer::loadTensors): Tensor " << name << " not found in checkpoint file " << filename << std::endl;
+   return false;
+  }
+  if(tensors_.find(lookupNameId(name)) == tensors_.end()){
+   std::cout << "#ERROR(exatn::NumServer::loadTensors): Tensor " << name << " has not been created!" << std::endl;
+   return false;
+  }
+  success = transformTensor(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitFile(filename,record->second)));
+  if(!success) break;
+ }
+ return success;
 }
 
 bool NumServer::evaluateTensorNetwork(const std::string & name,
@@ -3222,7 +7486,7 @@ bool NumServer::evaluateTensorNetwork(const ProcessGroup & process_group,
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetwork): Invalid tensor network: " << network << std::endl;
     break;
    }
-   auto iter = tensors_.find(tensor_name);
+   auto iter = tensors_.find(lookupNameId(tensor_name));
    if(iter == tensors_.end()){
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetwork): Tensor " << tensor_name << " not found!" << std::endl;
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetwork): Undefined tensor in tensor network: " << network << std::endl;
@@ -3266,7 +7530,7 @@ bool NumServer::evaluateTensorNetworkSync(const ProcessGroup & process_group,
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetworkSync): Invalid tensor network: " << network << std::endl;
     break;
    }
-   auto iter = tensors_.find(tensor_name);
+   auto iter = tensors_.find(lookupNameId(tensor_name));
    if(iter == tensors_.end()){
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetworkSync): Tensor " << tensor_name << " not found!" << std::endl;
     std::cout << "#ERROR(exatn::NumServer::evaluateTensorNetworkSync): Undefined tensor in tensor network: " << network << std::endl;
@@ -3327,11 +7591,9 @@ bool NumServer::normalizeNorm2Sync(const ProcessGroup & process_group,
   if(success){
    success = initTensor("_InnerProd",0.0);
    if(success){
-    TensorExpansion conjugate(expansion);
-    conjugate.conjugate();
-    conjugate.rename(expansion.getName()+"Conj");
-    TensorExpansion inner_product(conjugate,expansion);
+    TensorExpansion inner_product(expansion,expansion,true,false); //bra is conjugated lazily
     inner_product.rename("InnerProduct");
+    inner_product.collapseIsometries(); //canonical forms collapse to local contractions around the orthogonality center
     //inner_product.printIt(); //debug
     success = sync(process_group,"_InnerProd"); assert(success);
     success = submit(process_group,inner_product,inner_prod_tensor);
@@ -3380,35 +7642,18 @@ bool NumServer::balanceNorm2Sync(const ProcessGroup & process_group,
 {
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
- bool success = true;
+ std::vector<std::string> names;
+ std::unordered_set<std::string> unique_names;
  for(auto tens = network.begin(); tens != network.end(); ++tens){
   if(tens->first != 0){ //output tensor is ignored
    if(!only_optimizable || tens->second.isOptimizable()){
     if(!(tens->second.hasIsometries())){
-     double tens_norm;
-     success = computeNorm2Sync(tens->second.getName(),tens_norm);
-     if(success){
-      if(tens_norm > 0.0){
-       success = scaleTensorSync(tens->second.getName(),norm/tens_norm);
-       if(!success){
-        std::cout << "#ERROR(exatn::balanceNorm2): Unable to rescale input tensor "
-                  << tens->second.getName() << std::endl;
-        break;
-       }
-      }else{
-       std::cout << "#WARNING(exatn::balanceNorm2): Tensor " << tens->second.getName()
-                 << " has zero norm, thus cannot be renormalized!" << std::endl;
-      }
-     }else{
-      std::cout << "#ERROR(exatn::balanceNorm2): Unable to compute the norm of input tensor "
-                << tens->second.getName() << std::endl;
-      break;
-     }
+     if(unique_names.emplace(tens->second.getName()).second) names.emplace_back(tens->second.getName());
     }
    }
   }
  }
- return success;
+ return balanceTensorNorms2Sync(process_group,names,norm);
 }
 
 bool NumServer::balanceNorm2Sync(TensorExpansion & expansion,
@@ -3425,10 +7670,45 @@ bool NumServer::balanceNorm2Sync(const ProcessGroup & process_group,
 {
  unsigned int local_rank; //local process rank within the process group
  if(!process_group.rankIsIn(process_rank_,&local_rank)) return true; //process is not in the group: Do nothing
- bool success = true;
+ std::vector<std::string> names;
+ std::unordered_set<std::string> unique_names;
  for(auto net = expansion.begin(); net != expansion.end(); ++net){
-  success = balanceNorm2Sync(process_group,*(net->network),norm,only_optimizable);
-  if(!success) break;
+  for(auto tens = net->network->begin(); tens != net->network->end(); ++tens){
+   if(tens->first != 0){ //output tensor is ignored
+    if(!only_optimizable || tens->second.isOptimizable()){
+     if(!(tens->second.hasIsometries())){
+      if(unique_names.emplace(tens->second.getName()).second) names.emplace_back(tens->second.getName());
+     }
+    }
+   }
+  }
+ }
+ return balanceTensorNorms2Sync(process_group,names,norm);
+}
+
+bool NumServer::balanceTensorNorms2Sync(const ProcessGroup & process_group,
+                                        const std::vector<std::string> & names,
+                                        double norm)
+{
+ std::vector<TensorNorms> norms;
+ bool success = computeNormsSync(process_group,names,norms);
+ if(success){
+  for(std::size_t i = 0; i < names.size(); ++i){
+   const auto tens_norm = norms[i].norm2;
+   if(tens_norm > 0.0){
+    success = scaleTensorSync(names[i],norm/tens_norm);
+    if(!success){
+     std::cout << "#ERROR(exatn::balanceNorm2): Unable to rescale input tensor "
+               << names[i] << std::endl;
+     break;
+    }
+   }else{
+    std::cout << "#WARNING(exatn::balanceNorm2): Tensor " << names[i]
+              << " has zero norm, thus cannot be renormalized!" << std::endl;
+   }
+  }
+ }else{
+  std::cout << "#ERROR(exatn::balanceNorm2): Unable to compute the norms of input tensors" << std::endl;
  }
  return success;
 }
@@ -3535,6 +7815,232 @@ std::shared_ptr<TensorExpansion> NumServer::projectSliceSync(const ProcessGroup
  return std::shared_ptr<TensorExpansion>(nullptr);
 }
 
+/** Reads a tensor element from a tensor view as a double complex value. **/
+static std::complex<double> read_view_element(const TensorView & view,
+                                              std::size_t offset)
+{
+ switch(tensorComputeElementType(view.getElementType())){
+  case TensorElementType::REAL32: return std::complex<double>(view.getData<float>()[offset]);
+  case TensorElementType::REAL64: return std::complex<double>(view.getData<double>()[offset]);
+  case TensorElementType::COMPLEX32: return std::complex<double>(view.getData<std::complex<float>>()[offset]);
+  case TensorElementType::COMPLEX64: return view.getData<std::complex<double>>()[offset];
+  default: assert(false);
+ }
+ return std::complex<double>(0.0,0.0);
+}
+
+bool NumServer::evaluateAmplitudesSync(const TensorNetwork & network,
+                                       const std::vector<std::vector<DimOffset>> & multi_indices,
+                                       std::vector<std::complex<double>> & amplitudes,
+                                       unsigned int max_open_legs)
+{
+ return evaluateAmplitudesSync(getDefaultProcessGroup(),network,multi_indices,amplitudes,max_open_legs);
+}
+
+bool NumServer::evaluateAmplitudesSync(const ProcessGroup & process_group,
+                                       const TensorNetwork & network,
+                                       const std::vector<std::vector<DimOffset>> & multi_indices,
+                                       std::vector<std::complex<double>> & amplitudes,
+                                       unsigned int max_open_legs)
+{
+ amplitudes.assign(multi_indices.size(),std::complex<double>(0.0,0.0));
+ if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ if(multi_indices.empty()) return true;
+ const auto elem_type = network.getTensorElementType();
+ const auto output_extents = network.getTensor(0)->getDimExtents();
+ const unsigned int output_rank = output_extents.size();
+ for(const auto & mlndx: multi_indices){
+  bool valid = (mlndx.size() == output_rank);
+  for(unsigned int i = 0; valid && i < output_rank; ++i) valid = (mlndx[i] < output_extents[i]);
+  if(!valid){
+   std::cout << "#ERROR(exatn::NumServer::evaluateAmplitudesSync): Invalid multi-index for the output tensor of tensor network "
+             << network.getName() << std::endl << std::flush;
+   return false;
+  }
+ }
+ //Classify the output tensor modes: Fixed (same value in all multi-indices), open, grouped:
+ std::vector<bool> open_mode(output_rank,false);
+ std::vector<unsigned int> open_modes, grouped_modes;
+ for(unsigned int i = 0; i < output_rank; ++i){
+  bool fixed = true;
+  for(const auto & mlndx: multi_indices){
+   if(mlndx[i] != multi_indices[0][i]){fixed = false; break;}
+  }
+  if(!fixed){
+   if(open_modes.size() < max_open_legs){
+    open_modes.emplace_back(i);
+    open_mode[i] = true;
+   }else{
+    grouped_modes.emplace_back(i);
+   }
+  }
+ }
+ //Group the multi-indices by the values of their grouped modes:
+ std::map<std::vector<DimOffset>,std::vector<std::size_t>> groups;
+ for(std::size_t n = 0; n < multi_indices.size(); ++n){
+  std::vector<DimOffset> key;
+  for(const auto mode: grouped_modes) key.emplace_back(multi_indices[n][mode]);
+  groups[key].emplace_back(n);
+ }
+ //Create the projected tensor networks (rank-1 projection tensors are shared by all of them):
+ bool success = true;
+ std::map<std::pair<DimExtent,DimOffset>,std::shared_ptr<Tensor>> projectors;
+ std::vector<std::pair<std::shared_ptr<TensorNetwork>,const std::vector<std::size_t>*>> projected_networks;
+ for(const auto & group: groups){
+  auto projected = std::make_shared<TensorNetwork>(network,true);
+  const auto & mlndx = multi_indices[group.second[0]];
+  for(int i = static_cast<int>(output_rank) - 1; i >= 0; --i){ //descending order preserves the lower output modes
+   if(!open_mode[i]){
+    auto res = projectors.emplace(std::make_pair(std::make_pair(output_extents[i],mlndx[i]),std::shared_ptr<Tensor>(nullptr)));
+    if(res.second){
+     res.first->second = std::make_shared<Tensor>("_proj",TensorShape{output_extents[i]});
+     res.first->second->rename();
+     success = createTensorSync(process_group,res.first->second,elem_type); if(!success) break;
+     std::vector<double> proj_data(output_extents[i],0.0);
+     proj_data[mlndx[i]] = 1.0;
+     success = initTensorDataSync(res.first->second->getName(),proj_data); if(!success) break;
+    }
+    success = projected->appendTensor(res.first->second,{{static_cast<unsigned int>(i),0}}); if(!success) break;
+   }
+  }
+  if(!success) break;
+  //Reuse the contraction sequence of the first projected tensor network (same structure):
+  if(!projected_networks.empty()){
+   double flops = 0.0;
+   const auto & contr_seq = projected_networks[0].first->exportContractionSequence(&flops);
+   if(!contr_seq.empty()) projected->importContractionSequence(contr_seq,flops);
+  }
+  success = submit(process_group,*projected); if(!success) break;
+  projected_networks.emplace_back(std::make_pair(projected,&(group.second)));
+ }
+ //Scatter the computed amplitudes:
+ for(auto & projected: projected_networks){
+  auto output_tensor = projected.first->getTensor(0);
+  if(success){
+   success = sync(process_group,*(projected.first));
+   if(success){
+    std::vector<std::vector<DimOffset>> open_indices;
+    for(const auto n: *(projected.second)){
+     open_indices.emplace_back(std::vector<DimOffset>{});
+     for(const auto mode: open_modes) open_indices.back().emplace_back(multi_indices[n][mode]);
+    }
+    std::vector<std::complex<double>> values;
+    success = getTensorElementsSync(output_tensor->getName(),open_indices,values);
+    if(success){
+     std::size_t i = 0;
+     for(const auto n: *(projected.second)) amplitudes[n] = values[i++];
+    }
+   }
+  }
+  auto destroyed = destroyTensorSync(output_tensor->getName());
+  success = success && destroyed;
+ }
+ for(auto & projector: projectors){
+  if(projector.second){
+   auto destroyed = destroyTensorSync(projector.second->getName());
+   success = success && destroyed;
+  }
+ }
+ return success;
+}
+
+bool NumServer::getTensorElementsSync(const std::string & name,
+                                      const std::vector<std::vector<DimOffset>> & multi_indices,
+                                      std::vector<std::complex<double>> & values)
+{
+ values.assign(multi_indices.size(),std::complex<double>(0.0,0.0));
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()){
+  std::cout << "#ERROR(exatn::NumServer::getTensorElementsSync): Tensor " << name << " not found!" << std::endl << std::flush;
+  return false;
+ }
+ auto tensor = iter->second;
+ const auto & process_group = getTensorProcessGroup(name);
+ if(!process_group.rankIsIn(process_rank_)) return true; //process is not in the group: Do nothing
+ const auto tensor_rank = tensor->getRank();
+ for(const auto & mlndx: multi_indices){
+  bool valid = (mlndx.size() == tensor_rank);
+  for(unsigned int i = 0; valid && i < tensor_rank; ++i) valid = (mlndx[i] < tensor->getDimExtent(i));
+  if(!valid){
+   std::cout << "#ERROR(exatn::NumServer::getTensorElementsSync): Invalid multi-index for tensor " << name << std::endl << std::flush;
+   return false;
+  }
+ }
+ bool success = true;
+ if(tensor->isComposite()){ //distributed storage: Read the elements of the local subtensors and gather them
+  auto composite = castTensorComposite(tensor);
+  auto tensor_mapper = getTensorMapper(process_group);
+  std::vector<double> gathered(multi_indices.size() * 3,0.0); //{real, imaginary, number of replicas}
+  for(auto subtens = composite->begin(); success && subtens != composite->end(); ++subtens){
+   const auto & subtensor = *(subtens->second);
+   if(!(tensor_mapper->isLocalSubtensor(subtensor))) continue;
+   std::vector<DimOffset> base(tensor_rank);
+   for(unsigned int i = 0; i < tensor_rank; ++i)
+    base[i] = dim_base_offset(subtensor,i) - dim_base_offset(*tensor,i);
+   TensorView view;
+   for(std::size_t n = 0; n < multi_indices.size(); ++n){
+    std::size_t offset = 0, stride = 1;
+    bool inside = true;
+    for(unsigned int i = 0; inside && i < tensor_rank; ++i){
+     inside = (multi_indices[n][i] >= base[i] && multi_indices[n][i] < base[i] + subtensor.getDimExtent(i));
+     if(inside){
+      offset += (multi_indices[n][i] - base[i]) * stride;
+      stride *= subtensor.getDimExtent(i);
+     }
+    }
+    if(!inside) continue;
+    if(view.isEmpty()){
+     view = getTensorView(subtens->second);
+     if(view.isEmpty()){
+      std::cout << "#ERROR(exatn::NumServer::getTensorElementsSync): Unable to access subtensor "
+                << subtensor.getName() << " of tensor " << name << std::endl << std::flush;
+      success = false;
+      break;
+     }
+    }
+    const auto value = read_view_element(view,offset);
+    gathered[n * 3] += value.real();
+    gathered[n * 3 + 1] += value.imag();
+    gathered[n * 3 + 2] += 1.0;
+   }
+   view.release();
+  }
+#ifdef MPI_ENABLED
+  if(process_group.getSize() > 1){
+   auto errc = MPI_Allreduce(MPI_IN_PLACE,gathered.data(),static_cast<int>(gathered.size()),MPI_DOUBLE,MPI_SUM,
+                             process_group.getMPICommProxy().getRef<MPI_Comm>());
+   success = success && (errc == MPI_SUCCESS);
+  }
+#endif
+  for(std::size_t n = 0; success && n < multi_indices.size(); ++n){
+   const double replicas = gathered[n * 3 + 2];
+   if(replicas > 0.0){ //replicated subtensors contribute multiple copies of the same element
+    values[n] = std::complex<double>(gathered[n * 3] / replicas,gathered[n * 3 + 1] / replicas);
+   }else{
+    std::cout << "#ERROR(exatn::NumServer::getTensorElementsSync): Element not found in any subtensor of tensor "
+              << name << std::endl << std::flush;
+    success = false;
+   }
+  }
+ }else{ //replicated storage: Read the elements of the local tensor body
+  auto view = getTensorView(tensor);
+  if(view.isEmpty()){
+   std::cout << "#ERROR(exatn::NumServer::getTensorElementsSync): Unable to access tensor " << name << std::endl << std::flush;
+   return false;
+  }
+  for(std::size_t n = 0; n < multi_indices.size(); ++n){
+   std::size_t offset = 0, stride = 1;
+   for(unsigned int i = 0; i < tensor_rank; ++i){
+    offset += multi_indices[n][i] * stride;
+    stride *= tensor->getDimExtent(i);
+   }
+   values[n] = read_view_element(view,offset);
+  }
+  view.release();
+ }
+ return success;
+}
+
 std::shared_ptr<talsh::Tensor> NumServer::getLocalTensor(std::shared_ptr<Tensor> tensor, //in: exatn::numerics::Tensor to get slice of (by copy)
                          const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec) //in: tensor slice specification
 {
@@ -3552,43 +8058,64 @@ std::shared_ptr<talsh::Tensor> NumServer::getLocalTensor(std::shared_ptr<Tensor>
 std::shared_ptr<talsh::Tensor> NumServer::getLocalTensor(const std::string & name,
                    const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()) return std::shared_ptr<talsh::Tensor>(nullptr);
  return getLocalTensor(iter->second,slice_spec);
 }
 
 std::shared_ptr<talsh::Tensor> NumServer::getLocalTensor(const std::string & name)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()) return std::shared_ptr<talsh::Tensor>(nullptr);
  return getLocalTensor(iter->second);
 }
 
+TensorView NumServer::getTensorView(std::shared_ptr<Tensor> tensor)
+{
+ return (tensor_rt_->getTensorView(tensor)).get();
+}
+
+TensorView NumServer::getTensorView(const std::string & name)
+{
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return TensorView();
+ return getTensorView(iter->second);
+}
+
 void NumServer::destroyOrphanedTensors(bool force)
 {
  //std::cout << "#DEBUG(exatn::NumServer): Destroying orphaned tensors:\n" << std::flush; //debug
- auto iter = implicit_tensors_.begin();
- while(iter != implicit_tensors_.end()){
-  int ref_count = 1;
-  auto tens = tensors_.find(iter->first);
-  if(tens != tensors_.end()) ++ref_count;
-  auto sh_use_count = iter->second.use_count();
-  //std::cout << "#DEBUG(exatn::NumServer::destroyOrphanedTensors): Orphan candidate found: ExaTN ref count "
-  //          << ref_count << " VS shared_ptr use count " << sh_use_count << ": "
-  //          << iter->first << std::endl << std::flush; //debug
-  if(force || sh_use_count <= ref_count){
-   //std::cout << "#DEBUG(exatn::NumServer::destroyOrphanedTensors): Orphan found with ref count "
-   //          << ref_count << ": " << iter->first << std::endl << std::flush; //debug
-   auto tensor_mapper = getTensorMapper(getTensorProcessGroup(iter->first));
-   std::shared_ptr<TensorOperation> destroy_op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
-   destroy_op->setTensorOperand(iter->second);
-   auto submitted = submit(destroy_op,tensor_mapper);
-   auto num_deleted = tensor_comms_.erase(iter->first);
-   iter = implicit_tensors_.erase(iter);
-  }else{
-   ++iter;
+ //Unregister the orphaned implicit tensors (the tensor lock is not held during submission):
+ std::vector<std::pair<std::shared_ptr<Tensor>,ProcessGroup>> orphans;
+ {
+  std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
+  auto iter = implicit_tensors_.begin();
+  while(iter != implicit_tensors_.end()){
+   int ref_count = 1;
+   auto tens = tensors_.find(iter->second->getNameId());
+   if(tens != tensors_.end()) ++ref_count;
+   auto sh_use_count = iter->second.use_count();
+   //std::cout << "#DEBUG(exatn::NumServer::destroyOrphanedTensors): Orphan candidate found: ExaTN ref count "
+   //          << ref_count << " VS shared_ptr use count " << sh_use_count << ": "
+   //          << iter->first << std::endl << std::flush; //debug
+   if(force || sh_use_count <= ref_count){
+    //std::cout << "#DEBUG(exatn::NumServer::destroyOrphanedTensors): Orphan found with ref count "
+    //          << ref_count << ": " << iter->first << std::endl << std::flush; //debug
+    orphans.emplace_back(std::make_pair(iter->second,getTensorProcessGroup(iter->first)));
+    iter = implicit_tensors_.erase(iter);
+   }else{
+    ++iter;
+   }
   }
  }
+ //Destroy the orphaned implicit tensors (in the order of their names):
+ for(auto & orphan: orphans){
+  auto tensor_mapper = getTensorMapper(orphan.second);
+  std::shared_ptr<TensorOperation> destroy_op = tensor_op_factory_->createTensorOp(TensorOpCode::DESTROY);
+  destroy_op->setTensorOperand(orphan.first);
+  auto submitted = submit(destroy_op,tensor_mapper);
+  auto num_deleted = tensor_comms_.erase(orphan.first->getNameId());
+ }
  //std::cout << "Done\n" << std::flush; //debug
  return;
 }
@@ -3596,8 +8123,8 @@ void NumServer::destroyOrphanedTensors(bool force)
 void NumServer::printAllocatedTensors() const
 {
  std::cout << "#DEBUG(exatn::NumServer::printAllocatedTensors):" << std::endl;
- for(const auto & tens: tensors_){
-  std::cout << tens.first << ": Reference count = " << tens.second.use_count() << std::endl;
+ for(const auto & tens: tensors_.entries()){
+  std::cout << tens.second->getName() << ": Reference count = " << (tens.second.use_count() - 1) << std::endl;
  }
  std::cout << "#END" << std::endl << std::flush;
  return;
@@ -3606,8 +8133,9 @@ void NumServer::printAllocatedTensors() const
 void NumServer::printImplicitTensors() const
 {
  std::cout << "#DEBUG(exatn::NumServer::printImplicitTensors):" << std::endl;
+ std::lock_guard<std::recursive_mutex> lock(tensor_mtx_);
  for(const auto & tens: implicit_tensors_){
-  std::cout << tens.first << ": Reference count = " << tens.second.use_count() << std::endl;
+  std::cout << tens.second->getName() << ": Reference count = " << tens.second.use_count() << std::endl;
  }
  std::cout << "#END" << std::endl << std::flush;
  return;
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Numerical server
-REVISION: 2022/03/15
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -30,6 +30,86 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
      defines the interface which needs to be implemented by the application in order
      to perform a custom unary transformation/initialization operation on exatn::Tensor.
      This is the only portable way to modify the tensor content in a desired way.
+ (d) Iterative algorithms repeatedly submitting structurally identical tensor networks
+     can capture the generated sequence of tensor operations once (beginCapture/endCapture)
+     and then replay it (replay), thus skipping all front-end work, that is, the determination
+     of the tensor contraction sequence, generation of the tensor operation list, index splitting,
+     and decomposition of composite tensor operations. Tensor operands of the replayed tensor
+     operations are rebound by their names, thus picking up the currently registered tensors.
+ (e) Symbolic tensor additions and contractions are parsed once and cached by their specification
+     string. Inner loops can additionally prepare a tensor operation handle (prepareAddition/
+     prepareContraction) which binds the parsed specification to the tensor operands and their
+     process group, and then execute it repeatedly, thus skipping both parsing and tensor name lookups.
+     A prepared handle is valid as long as all its tensor operands are not destroyed.
+ (f) Registered tensors and their process groups are keyed by interned tensor names (TensorNameId),
+     where class Tensor caches the identifier of its name, thus registering, unregistering and
+     looking up a tensor given by its object neither hashes nor copies its name string. Names are
+     only hashed for the lookups of tensors given by name (user API).
+ (g) Sampling validation: Unlike the validation tracing (serialized execution), a given fraction
+     of the submitted tensor operations (deterministically, every 1/fraction-th one in the order
+     of submission) is checksummed by the 1-norms of their output tensor operands while the DAG
+     execution stays asynchronous. The checksums are collected once completed (at synchronization
+     points, or when too many of them are in flight) and appended to the validation stamp file
+     "exatn_validation.<global_rank>.txt" as "<operation index> <opcode> <operand> <tensor name> <1-norm>",
+     thus the files of two runs (different backends or versions) can be compared line by line.
+ (h) Output tensors created implicitly during tensor network evaluation are garbage collected
+     as soon as they are orphaned, that is, neither the client nor any outstanding tensor
+     operation references them anymore: Each tensor network submission first destroys
+     the orphaned implicit tensors, not only synchronization points. Since the DESTROY
+     operation is appended to the DAG, it is ordered after the last reading tensor operation.
+ (i) Approximate tensor network evaluation contracts the tensor network pairwise along its
+     tensor contraction sequence (an imported one, for example, a boundary-MPS sequence for
+     2D grids, see TensorNetwork::importBoundaryMPSSequence), compressing each new intermediate:
+     Every bond of the intermediate exceeding the bond dimension limit is truncated by the SVD
+     of the merged pair of neighbors. The sum of the local truncation errors (Frobenius norms)
+     is returned as an estimate of the total truncation error (it is not an upper bound).
+ (j) The tensor contraction sequence search for a tensor network executed by multiple processes
+     is distributed: Instead of repeating the same search, each process explores its own
+     search variant (process 0 performs the default search), possibly with its own optimizer
+     from the optimizer portfolio. The best-so-far (sliced) Flop count is shared asynchronously
+     via one-sided MIN accumulates into an MPI window hosted by process 0, thus a search dominated
+     by another process is pruned and the anytime time budget is shared by all processes.
+     The best tensor contraction sequence found by all processes is then broadcast.
+ (k) The "auto" computational backend selects between the default backend and cuQuantum
+     per tensor network (see BackendSelector): The cost of the tensor network is estimated
+     from its tensor contraction sequence (FMA flops, largest intermediate, input/output volume)
+     and the available memory (per-process memory limit, GPU device buffers), with the FMA flop
+     rate of the default backend seeded from the runtime metrics. The execution time of the tensor
+     network on the selected backend is measured from its submission until its output tensor has
+     been synchronized with waiting, and it is fed back to the backend selector. The decision
+     of process 0 of the executing process group is broadcast to the other processes.
+ (l) Network memoization: Solvers often re-evaluate tensor networks whose input tensors have not
+     changed since the last evaluation. Every submitted write into a tensor bumps its version
+     (see TensorExecState), thus, once activated, the numerical server remembers the evaluation
+     of each tensor network by its exact structure (tensor ids, tensor objects, conjugation, legs)
+     together with the versions of its input tensors and the version of its output tensor right
+     after the evaluation. A re-evaluation of the same tensor network with all input tensors
+     and the output tensor unchanged is skipped, since the output tensor still holds the result.
+     Tensor networks with input tensors never written (for example, structured or implicitly
+     created tensors) are not memoized. The decision is agreed upon by all processes
+     of the executing process group.
+ (m) Concurrent clients: The registries of tensors and their process groups are sharded concurrent
+     registries (ConcurrentRegistry), thus multiple client threads can look up, create and destroy
+     tensors concurrently, with lookups returning shared snapshots which keep a concurrently destroyed
+     tensor alive for the reader. The cache of parsed symbolic tensor operations is a concurrent
+     registry as well. The registries of implicit, block-sparse and structured tensors
+     are guarded by their own mutex. Each client thread has its own TAProL scope stack (GLOBAL scope
+     on first use), and the byte packets used for exchanging tensor meta-data are thread-local.
+     Submission into the tensor runtime stages into its lock-free multi-producer ring, and only
+     the short bookkeeping of each submitted tensor operation (capture, batching, validation sampling)
+     is serialized. The configuration (backend, optimizers, policies) is expected to be set up
+     before the client threads start, and the collective (MPI) operations issued by different
+     client threads must not interleave.
+ (n) Speculative execution: Once activated, an iterative solver may submit the likely-next work
+     of its next iteration (which does not depend on the convergence check of the current one)
+     inside a speculation (beginSpeculation()) before it blocks on the convergence check, such that
+     the tensor runtime keeps executing it during the sync wait. The speculation is then either
+     committed (commitSpeculation(): no convergence, the next iteration reuses the submitted work)
+     or discarded (discardSpeculation(): converged), in which case the recorded tensor operations
+     of the calling client thread which have not started executing yet are cancelled by the tensor
+     runtime (see TensorRuntime rationale (m)). Tensor creation/destruction and communication are
+     never cancelled, and neither are tensor networks executed by the cuQuantum backend. The output
+     tensors of a discarded speculation are in an undefined state and should only be destroyed.
 **/
 
 #ifndef EXATN_NUM_SERVER_HPP_
@@ -40,22 +120,31 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_range.hpp"
 #include "tensor.hpp"
 #include "tensor_composite.hpp"
+#include "tensor_block_sparse.hpp"
+#include "tensor_structured.hpp"
 #include "tensor_operation.hpp"
 #include "tensor_op_factory.hpp"
 #include "tensor_symbol.hpp"
 #include "tensor_network.hpp"
 #include "tensor_operator.hpp"
 #include "tensor_expansion.hpp"
+#include "tensor_expansion_planner.hpp"
+#include "tensor_expansion_stream.hpp"
+#include "tensor_redistribution.hpp"
 #include "network_build_factory.hpp"
 #include "contraction_seq_optimizer_factory.hpp"
 
 #include "tensor_runtime.hpp"
+#include "backend_selector.hpp"
+#include "execution_plan.hpp"
+#include "runtime_monitor.hpp"
 
 #include "Identifiable.hpp"
 #include "tensor_method.hpp"
 #include "functor_init_val.hpp"
 #include "functor_init_rnd.hpp"
 #include "functor_init_dat.hpp"
+#include "functor_init_buf.hpp"
 #include "functor_init_delta.hpp"
 #include "functor_init_proj.hpp"
 #include "functor_init_file.hpp"
@@ -64,8 +153,11 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "functor_maxabs.hpp"
 #include "functor_norm1.hpp"
 #include "functor_norm2.hpp"
+#include "functor_norms.hpp"
 #include "functor_diag_rank.hpp"
+#include "functor_apply_structured.hpp"
 #include "functor_print.hpp"
+#include "tensor_method_device.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -75,7 +167,16 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <stack>
 #include <list>
 #include <map>
-
+#include <unordered_map>
+#include <unordered_set>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+#include "concurrent_registry.hpp"
 #include "errors.hpp"
 
 using exatn::Identifiable;
@@ -86,17 +187,22 @@ namespace exatn{
 using numerics::VectorSpace;
 using numerics::Subspace;
 using numerics::TensorHashType;
+using numerics::TensorNameId;
+using numerics::TensorNameTable;
 using numerics::TensorRange;
 using numerics::TensorShape;
 using numerics::TensorSignature;
 using numerics::TensorLeg;
 using numerics::Tensor;
 using numerics::TensorComposite;
+using numerics::TensorBlockSparse;
+using numerics::TensorStructured;
 using numerics::TensorOperation;
 using numerics::TensorOpFactory;
 using numerics::TensorNetwork;
 using numerics::TensorOperator;
 using numerics::TensorExpansion;
+using numerics::TensorExpansionStream;
 
 using numerics::NetworkBuilder;
 using numerics::NetworkBuildFactory;
@@ -111,6 +217,7 @@ using numerics::FunctorInitDelta;
 using numerics::FunctorInitProj;
 using numerics::FunctorInitFile;
 using numerics::FunctorIsometrize;
+using numerics::IsometrizeMethod;
 using numerics::FunctorScale;
 using numerics::FunctorMaxAbs;
 using numerics::FunctorNorm1;
@@ -120,6 +227,22 @@ using numerics::FunctorPrint;
 
 using TensorMethod = talsh::TensorFunctor<Identifiable>;
 
+using runtime::RuntimeMetrics;
+using runtime::TensorView;
+
+/** Reduction strategy of partial output tensors computed by multiple processes: **/
+enum class OutputReduction{
+ ALLREDUCE,    //flat allreduce over the whole process group (all processes get the result)
+ HIERARCHICAL, //reduction within each compute node, allreduce among the node leaders, broadcast within each node
+ ROOT          //reduction to the first process of the process group only (the result is undefined elsewhere)
+};
+
+/** Mapping of the subtensors of composite tensors to the processes of a process group: **/
+enum class TensorMapping{
+ FIXED,   //fixed arithmetic mapping of subtensor ids to process ranks (requires evenly divisible numbers)
+ BALANCED //size-aware mapping balancing the bytes per process and keeping neighbouring subtensors on the same node
+};
+
 
 /** Returns the closest owner id (process rank) for a given subtensor. **/
 unsigned int subtensor_owner_id(unsigned int process_rank,          //in: current process rank
@@ -138,6 +261,10 @@ unsigned int replication_level(const ProcessGroup & process_group, //in: process
                                std::shared_ptr<Tensor> & tensor);  //in: tensor
 
 
+/** Registry of tensors keyed by interned tensor names (see rationale m). **/
+using TensorRegistry = ConcurrentRegistry<TensorNameId,std::shared_ptr<Tensor>>;
+
+
 //Composite tensor mapper (helper):
 class CompositeTensorMapper: public TensorMapper{
 public:
@@ -147,20 +274,24 @@ public:
                        unsigned int current_rank_in_group,
                        unsigned int num_processes_in_group,
                        std::size_t memory_per_process,
-                       const std::unordered_map<std::string,std::shared_ptr<Tensor>> & local_tensors):
+                       const TensorRegistry & local_tensors):
   current_process_rank_(current_rank_in_group), group_num_processes_(num_processes_in_group),
   memory_per_process_(memory_per_process), intra_comm_(communicator), local_tensors_(local_tensors) {}
 #else
  CompositeTensorMapper(unsigned int current_rank_in_group,
                        unsigned int num_processes_in_group,
                        std::size_t memory_per_process,
-                       const std::unordered_map<std::string,std::shared_ptr<Tensor>> & local_tensors):
+                       const TensorRegistry & local_tensors):
   current_process_rank_(current_rank_in_group), group_num_processes_(num_processes_in_group),
   memory_per_process_(memory_per_process), local_tensors_(local_tensors) {}
 #endif
 
  virtual ~CompositeTensorMapper() = default;
 
+ using TensorMapper::subtensorOwnerId;
+ using TensorMapper::subtensorFirstOwnerId;
+ using TensorMapper::isLocalSubtensor;
+
  /** Returns the closest-to-the-target process rank owning the given subtensor. **/
  virtual unsigned int subtensorOwnerId(unsigned int target_process_rank,                 //in: target process rank
                                        unsigned long long subtensor_id,                  //in: subtensor id (binary mask)
@@ -213,7 +344,7 @@ public:
  /** Returns whether or not the given subtensor is owned by the current process. **/
  virtual bool isLocalSubtensor(const Tensor & subtensor) const override //in: subtensor
  {
-  return (local_tensors_.find(subtensor.getName()) != local_tensors_.cend());
+  return (local_tensors_.find(subtensor.getNameId()) != local_tensors_.cend());
  }
 
  /** Returns the amount of memory per process. **/
@@ -234,7 +365,110 @@ private:
  unsigned int group_num_processes_;  //total number of processes (in some process group)
  std::size_t memory_per_process_;    //amount of memory (bytes) per process
  MPICommProxy intra_comm_;           //MPI communicator for the process group
- const std::unordered_map<std::string,std::shared_ptr<Tensor>> & local_tensors_; //locally stored tensors
+ const TensorRegistry & local_tensors_; //locally stored tensors (keyed by interned names)
+};
+
+
+/** Cost- and size-aware composite tensor mapper: If a composite tensor has more subtensors than
+    processes, its subtensors ordered by their ids (neighbouring bisection blocks are adjacent)
+    are partitioned into contiguous chunks of balanced volume, which are assigned to the processes
+    in their node-major order. Thus, uneven bisections are balanced in bytes per process,
+    neighbouring blocks prefer the same compute node, and the matching subtensors of equally
+    decomposed tensors (contracted together) are co-located. Composite tensors with no more
+    subtensors than processes keep the replicated mapping of CompositeTensorMapper. **/
+class BalancedTensorMapper: public CompositeTensorMapper{
+public:
+
+#ifdef MPI_ENABLED
+ BalancedTensorMapper(const MPICommProxy & communicator,
+                      unsigned int current_rank_in_group,
+                      unsigned int num_processes_in_group,
+                      std::size_t memory_per_process,
+                      const TensorRegistry & local_tensors,
+                      const std::vector<unsigned int> & process_order): //node-major order of the process ranks (empty: natural order)
+  CompositeTensorMapper(communicator,current_rank_in_group,num_processes_in_group,memory_per_process,local_tensors),
+  process_order_(process_order) {}
+#else
+ BalancedTensorMapper(unsigned int current_rank_in_group,
+                      unsigned int num_processes_in_group,
+                      std::size_t memory_per_process,
+                      const TensorRegistry & local_tensors,
+                      const std::vector<unsigned int> & process_order): //node-major order of the process ranks (empty: natural order)
+  CompositeTensorMapper(current_rank_in_group,num_processes_in_group,memory_per_process,local_tensors),
+  process_order_(process_order) {}
+#endif
+
+ virtual ~BalancedTensorMapper() = default;
+
+ using CompositeTensorMapper::subtensorOwnerId;
+ using CompositeTensorMapper::subtensorFirstOwnerId;
+ using CompositeTensorMapper::isLocalSubtensor;
+
+ virtual unsigned int subtensorOwnerId(unsigned int target_process_rank,            //in: target process rank
+                                       const numerics::TensorComposite & composite, //in: composite tensor
+                                       unsigned long long subtensor_id) const override
+ {
+  if(composite.getNumSubtensors() > getNumProcesses()) return balancedOwnerId(composite,subtensor_id);
+  return subtensorOwnerId(target_process_rank,subtensor_id,composite.getNumSubtensors());
+ }
+
+ virtual unsigned int subtensorOwnerId(const numerics::TensorComposite & composite, //in: composite tensor
+                                       unsigned long long subtensor_id) const override
+ {
+  return subtensorOwnerId(getProcessRank(),composite,subtensor_id);
+ }
+
+ virtual unsigned int subtensorFirstOwnerId(const numerics::TensorComposite & composite, //in: composite tensor
+                                            unsigned long long subtensor_id) const override
+ {
+  if(composite.getNumSubtensors() > getNumProcesses()) return balancedOwnerId(composite,subtensor_id);
+  return subtensorFirstOwnerId(subtensor_id,composite.getNumSubtensors());
+ }
+
+ virtual bool isLocalSubtensor(const numerics::TensorComposite & composite, //in: composite tensor
+                               unsigned long long subtensor_id) const override
+ {
+  return (subtensorOwnerId(composite,subtensor_id) == getProcessRank());
+ }
+
+private:
+
+ /** Returns the unique owner of a subtensor of a composite tensor with more subtensors than processes. **/
+ unsigned int balancedOwnerId(const numerics::TensorComposite & composite,
+                              unsigned long long subtensor_id) const;
+
+ std::vector<unsigned int> process_order_; //node-major order of the process ranks (empty: natural order)
+ mutable std::unordered_map<numerics::TensorHashType,
+                            std::unordered_map<unsigned long long,unsigned int>> owners_; //cached owners: composite hash --> {subtensor id --> owner}
+};
+
+
+//Parsed symbolic tensor addition or contraction (cached by its kind and specification):
+struct ParsedTensorOperation{
+ TensorOpCode opcode;                     //tensor operation kind: ADD or CONTRACT
+ std::string pattern;                     //symbolic specification (index pattern)
+ std::vector<std::string> tensor_names;   //names of the tensor operands: {output, input(s)}
+ std::vector<bool> conjugated;            //complex conjugation flags of the tensor operands
+ std::vector<PosIndexLabel> left_inds;    //CONTRACT only: left indices
+ std::vector<PosIndexLabel> right_inds;   //CONTRACT only: right indices
+ std::vector<PosIndexLabel> contr_inds;   //CONTRACT only: contracted indices
+ std::vector<PosIndexLabel> hyper_inds;   //CONTRACT only: hyper indices
+};
+
+//Parsed tensor addition or contraction bound to its tensor operands:
+struct PreparedTensorOperation{
+ std::shared_ptr<const ParsedTensorOperation> parsed; //parsed symbolic specification
+ std::vector<std::shared_ptr<Tensor>> tensors;        //tensor operands
+ ProcessGroup process_group;                          //process group executing the tensor operation
+};
+
+using TensorOperationHandle = std::shared_ptr<const PreparedTensorOperation>;
+
+//Norms of a tensor (negative if not computed):
+struct TensorNorms{
+ double norm1 = -1.0;   //1-norm
+ double norm2 = -1.0;   //2-norm
+ double max_abs = -1.0; //max-abs norm
 };
 
 
@@ -243,6 +477,9 @@ class NumServer final {
 
 public:
 
+ static constexpr const unsigned int DEFAULT_AMPLITUDE_OPEN_LEGS = 10; //default max number of open output legs in batched amplitude evaluation
+ static constexpr const std::uint64_t DEFAULT_RANDOM_SEED = 0x5EED5EED; //default seed of the random tensor initialization
+
 #ifdef MPI_ENABLED
  NumServer(const MPICommProxy & communicator,                               //MPI communicator proxy
            const ParamConf & parameters,                                    //runtime configuration parameters
@@ -272,19 +509,49 @@ public:
                                const std::string & node_executor_name);
 #endif
 
+ /** Reconfigures the tensor runtime in place with new runtime parameters and a new DAG executor,
+     keeping all existing tensors, open scopes and the node executor (hot reconfiguration).
+     The outstanding tensor operations of all concurrently executed scopes are completed first,
+     whereas the tensor operations of paused scopes resume with the new DAG executor.
+     A changed Host buffer size only takes effect if no tensor has been allocated yet.
+     Only the lazy DAG executor executes entire tensor networks, thus no other DAG executor
+     can be selected while the "cuquantum" or "auto" computational backend is active.
+     Returns FALSE if the tensor runtime could not be reconfigured in place (nothing done then). **/
+ bool reconfigureRuntime(const ParamConf & parameters,
+                         const std::string & dag_executor_name);
+
  /** Queries available computational backends. **/
  std::vector<std::string> queryComputationalBackends() const;
 
- /** Switches the computational backend: {"default","cuquantum"}.
-     Only applies to tensor network execution. **/
+ /** Switches the computational backend: {"default","cuquantum","auto","exatensor"}.
+     The "cuquantum" backend only applies to tensor network execution. The "auto" backend
+     selects either the default or the "cuquantum" backend per tensor network. Both require the lazy
+     DAG executor (the only one executing entire tensor networks). The "exatensor" backend
+     reconfigures the tensor runtime with the ExaTENSOR node executor (switching the node executor
+     requires all tensors to be destroyed and must be done by all processes). **/
  void switchComputationalBackend(const std::string & backend_name);
 
  /** Resets the tensor contraction sequence optimizer that is
-     invoked when evaluating tensor networks. **/
- void resetContrSeqOptimizer(const std::string & optimizer_name, //in: tensor contraction sequence optimizer name
-                             bool caching = false);              //whether or not optimized tensor contraction sequence will be cached for later reuse
-
- /** Activates optimized tensor contraction sequence caching for later reuse. **/
+     invoked when evaluating tensor networks. A non-zero time budget activates the anytime
+     mode in which the optimizer (if it supports it) keeps improving the tensor contraction
+     sequence until the wall-clock budget expires. The budget is either fixed or set
+     automatically as a fraction of the estimated contraction time (whichever is larger). **/
+ void resetContrSeqOptimizer(const std::string & optimizer_name,       //in: tensor contraction sequence optimizer name
+                             bool caching = false,                     //whether or not optimized tensor contraction sequence will be cached for later reuse
+                             double time_budget = 0.0,                 //in: fixed wall-clock time budget of the search (sec)
+                             double contraction_time_fraction = 0.0);  //in: time budget as a fraction of the estimated tensor network contraction time
+
+ /** Resets the portfolio of tensor contraction sequence optimizers for the distributed search:
+     When a tensor network is executed by multiple processes, process 0 runs the configured
+     optimizer whereas other processes cycle through the portfolio (empty: the configured
+     optimizer as well), each process exploring its own search variant (random streams,
+     partitioning parameters). The processes share the best-so-far cost asynchronously
+     and the best tensor contraction sequence is then broadcast to all of them. **/
+ void resetContrSeqPortfolio(const std::vector<std::string> & optimizer_names); //in: tensor contraction sequence optimizer names
+
+ /** Activates optimized tensor contraction sequence caching for later reuse.
+     With persistence, the binary database of tensor contraction sequences is read
+     by process 0 and broadcast to all processes (collective call in this case). **/
  void activateContrSeqCaching(bool persist = false);
 
  /** Deactivates optimized tensor contraction sequence caching. **/
@@ -293,9 +560,131 @@ public:
  /** Queries the status of optimized tensor contraction sequence caching. **/
  bool queryContrSeqCaching() const;
 
- /** Resets the client logging level (0:none). **/
+ /** Activates the slicing-aware tensor contraction sequence search: The tensor contraction
+     sequence optimizer will minimize the total Flop count of the tensor network sliced
+     under the memory limit of the executing process group (if the optimizer supports it). **/
+ void activateContrSeqSlicing();
+
+ /** Deactivates the slicing-aware tensor contraction sequence search. **/
+ void deactivateContrSeqSlicing();
+
+ /** Queries the status of the slicing-aware tensor contraction sequence search. **/
+ bool queryContrSeqSlicing() const;
+
+ /** Activates the reuse of shared intermediates when evaluating tensor network expansions:
+     Identical tensor sub-networks shared by different components of a tensor network expansion
+     are evaluated only once and their results are reused by all components (common-subexpression
+     elimination). Only applies to the evaluation of all components by the same process group. **/
+ void activateIntermediateSharing();
+
+ /** Deactivates the reuse of shared intermediates when evaluating tensor network expansions. **/
+ void deactivateIntermediateSharing();
+
+ /** Queries the status of the reuse of shared intermediates when evaluating tensor network expansions. **/
+ bool queryIntermediateSharing() const;
+
+ /** Activates the dynamic scheduling of the sliced tensor sub-networks across the processes:
+     Instead of a static partition, each process repeatedly requests the next chunk of
+     tensor sub-networks from a shared counter (MPI one-sided communication) once it has
+     completed its previous chunk, thus faster processes execute more tensor sub-networks. **/
+ void activateDynamicSliceScheduling();
+
+ /** Deactivates the dynamic scheduling of the sliced tensor sub-networks (static partition). **/
+ void deactivateDynamicSliceScheduling();
+
+ /** Queries the status of the dynamic scheduling of the sliced tensor sub-networks. **/
+ bool queryDynamicSliceScheduling() const;
+
+ /** Activates the double buffering of the input tensor slices in the sliced evaluation of tensor networks:
+     The input tensor slices of the next tensor sub-network are extracted while the tensor operations
+     of the current tensor sub-network are executed. A fraction of the process memory limit is reserved
+     for the second buffer when determining the tensor slicing. **/
+ void activateSliceDoubleBuffering();
+
+ /** Deactivates the double buffering of the input tensor slices in the sliced evaluation of tensor networks. **/
+ void deactivateSliceDoubleBuffering();
+
+ /** Queries the status of the double buffering of the input tensor slices in the sliced evaluation of tensor networks. **/
+ bool querySliceDoubleBuffering() const;
+
+ /** Activates the memoization of tensor network evaluations: A tensor network re-evaluated
+     with all its input tensors unchanged since its last evaluation (and its output tensor
+     not written since then) is not recomputed, its output tensor already holds the result. **/
+ void activateNetworkMemoization();
+
+ /** Deactivates the memoization of tensor network evaluations (forgets all memoized evaluations). **/
+ void deactivateNetworkMemoization();
+
+ /** Queries the status of the memoization of tensor network evaluations. **/
+ bool queryNetworkMemoization() const;
+
+ /** Returns the number of tensor network evaluations skipped due to the memoization. **/
+ std::size_t getNetworkMemoizationHits() const;
+
+ /** Activates the hybrid Host+accelerator execution of the sliced tensor sub-networks: Each process
+     executes a share of its tensor sub-networks on Host (CPU) and the rest on accelerators (GPU),
+     concurrently. The Host share is proportional to the Host throughput measured on the completed
+     tensor sub-networks (Flop/sec), thus it is calibrated at run time and persists across evaluations. **/
+ void activateHybridSliceExecution();
+
+ /** Deactivates the hybrid Host+accelerator execution of the sliced tensor sub-networks. **/
+ void deactivateHybridSliceExecution();
+
+ /** Queries the status of the hybrid Host+accelerator execution of the sliced tensor sub-networks. **/
+ bool queryHybridSliceExecution() const;
+
+ /** Returns the current (calibrated) Host share of the sliced tensor sub-networks in the hybrid execution. **/
+ double getHybridHostShare() const;
+
+ /** Resets the reduction strategy of the partial output tensors of tensor networks
+     (and tensor network expansions) evaluated by multiple processes. **/
+ void resetOutputReduction(OutputReduction reduction = OutputReduction::ALLREDUCE);
+
+ /** Returns the current reduction strategy of the partial output tensors. **/
+ OutputReduction getOutputReduction() const;
+
+ /** Resets the mapping of the subtensors of composite tensors to processes. The mapping
+     must be chosen before creating composite tensors which it is supposed to apply to.
+     Collective over all processes when switching to the balanced mapping. **/
+ void resetTensorMapping(TensorMapping mapping = TensorMapping::FIXED);
+
+ /** Returns the current mapping of the subtensors of composite tensors to processes. **/
+ TensorMapping getTensorMapping() const;
+
+ /** Activates the fused evaluation of tensor network expansions: The tensor contraction sequences
+     of all components are synchronized across processes at once and the components accumulate
+     their results directly into the accumulator (scaled accumulating contractions), without
+     creating their output tensors. The accumulator is allreduced once at the end. Only applies
+     to the evaluation of all components by the same process group. The output tensors of the
+     components are not available after the evaluation. **/
+ void activateFusedExpansionEvaluation();
+
+ /** Deactivates the fused evaluation of tensor network expansions. **/
+ void deactivateFusedExpansionEvaluation();
+
+ /** Queries the status of the fused evaluation of tensor network expansions. **/
+ bool queryFusedExpansionEvaluation() const;
+
+ /** Activates speculative execution in iterative solvers (see rationale (n)). **/
+ void activateSpeculativeExecution();
+
+ /** Deactivates speculative execution in iterative solvers. **/
+ void deactivateSpeculativeExecution();
+
+ /** Queries the status of speculative execution in iterative solvers. **/
+ bool querySpeculativeExecution() const;
+
+ /** Resets the client logging level (0:none).
+     Opening the client log writes the startup time breakdown first. **/
  void resetClientLoggingLevel(int level = 0);
 
+ /** Records the duration of a startup stage (for the startup time breakdown). **/
+ void recordStartupTime(const std::string & stage, //in: startup stage
+                        double duration);          //in: duration (sec)
+
+ /** Returns the startup time breakdown: {startup stage, duration (sec)}. **/
+ const std::vector<std::pair<std::string,double>> & getStartupTimes() const;
+
  /** Resets the runtime logging level (0:none). **/
  void resetRuntimeLoggingLevel(int level = 0);
 
@@ -303,12 +692,69 @@ public:
  void resetExecutionSerialization(bool serialize,
                                   bool validation_trace = false);
 
- /** Activates/deactivates dry run (no actual computations). **/
+ /** Starts (interval > 0) or stops (interval <= 0) the live runtime monitor thread which
+     periodically overwrites the monitor file exatn_monitor.<global MPI rank>.txt with the current
+     runtime state (DAG size and front node, operation and flop rates, TRY_LATER rate, memory usage,
+     current solver iteration). It can also be started via the "runtime_monitor_interval" runtime parameter. **/
+ void activateRuntimeMonitor(double interval); //in: monitoring period (sec)
+
+ /** Reports the current iteration of an iterative solver to the runtime monitor (if active). **/
+ void reportSolverIteration(const std::string & solver, //in: solver name
+                            std::size_t iteration);     //in: iteration number
+
+ /** Activates/deactivates the sampling validation: The given fraction of subsequently submitted
+     tensor operations is checksummed (1-norms of the output tensor operands) without serializing
+     the execution, the checksums being written into the file exatn_validation.<global MPI rank>.txt
+     (fraction = 0.0 deactivates). The validation tracing (serialized execution) takes precedence. **/
+ void resetValidationSampling(double fraction);
+
+ /** Activates/deactivates dry run (no actual computations). Activation starts
+     a new execution plan (predicted execution profile of all subsequently submitted
+     tensor operations and tensor networks), with its performance model calibrated
+     by the runtime performance counters of the prior actual computations. **/
  void activateDryRun(bool dry_run);
 
+ /** Sets the performance model of an execution device (-1: Host) used by the execution plan. **/
+ void setExecutionPlanModel(int device,      //in: execution device (-1: Host)
+                            double gflops,   //in: sustained GFlop/s
+                            double gbps,     //in: sustained memory bandwidth (GB/s)
+                            double latency); //in: per-operation latency (sec)
+
+ /** Returns the execution plan predicted by the (last) dry run. **/
+ const ExecutionPlan & getExecutionPlan() const;
+
+ /** Writes the execution plan report predicted by the (last) dry run into a text file
+     (default file name: exatn_plan.<global MPI rank>.txt). Returns FALSE on failure. **/
+ bool writeExecutionPlan(const std::string & filename = std::string());
+
  /** Activates mixed-precision fast math operations on all devices (if available). **/
  void activateFastMath();
 
+ /** Sets the precision policy applied to all subsequently submitted tensor operations
+    which do not carry their own precision policy (TensorOpPrecision::DEFAULT).
+    The tolerance is the absolute error bound used by the AUTO precision policy. **/
+ void setPrecisionPolicy(TensorOpPrecision precision,
+                         double tolerance = 0.0);
+
+ /** Returns the current precision policy. **/
+ TensorOpPrecision getPrecisionPolicy() const;
+
+ /** Sets the truncation mode of all subsequent SVD-based tensor decompositions: The randomized
+     truncated SVD computes only the leading singular triplets retained by the tensor factors
+     (the target rank is the total extent of the contracted indices). Singular values not exceeding
+     the tolerance are discarded. **/
+ void setSVDTruncation(bool randomized,         //in: randomized truncated SVD (TRUE) or full SVD (FALSE)
+                       double tolerance = 0.0); //in: singular values not exceeding the tolerance are discarded
+
+ /** Marks a tensor as tolerant to reduced-precision inter-process transfers:
+     Subsequent broadcasts/allreduces of this tensor will communicate its
+     body in single precision, thus halving the communication volume. **/
+ void markTensorTransferTolerant(const std::string & name, //in: tensor name
+                                 bool tolerant = true);     //in: whether or not the tensor is tolerant
+
+ /** Returns whether or not a tensor is tolerant to reduced-precision inter-process transfers. **/
+ bool tensorTransferTolerant(const std::string & name) const;
+
  /** Returns the Host memory buffer size in bytes provided by the runtime. **/
  std::size_t getMemoryBufferSize() const;
 
@@ -316,15 +762,36 @@ public:
      Note that the returned value includes buffer fragmentation overhead. **/
  std::size_t getMemoryUsage(std::size_t * free_mem) const;
 
+ /** Returns the current memory fragmentation factor: The ratio of the memory usage
+     to the total size of all allocated tensors (1.0: no overhead; 0.0: unknown).
+     Optionally returns the total size of all allocated tensors (bytes). **/
+ double getMemoryFragmentation(std::size_t * tensor_mem = nullptr) const;
+
  /** Returns the current value of the Flop counter. **/
  double getTotalFlopCount() const;
 
+ /** Returns a snapshot of the runtime performance counters, including
+     the time spent in the tensor contraction sequence search. **/
+ RuntimeMetrics getRuntimeMetrics() const;
+
+ /** Resets the runtime performance counters. **/
+ void resetRuntimeMetrics();
+
+ /** Returns the telemetry of the last tensor contraction sequence search: Search phases,
+     number of walkers and rounds, convergence of the best-so-far flop count over time,
+     chosen max intermediate volume and number of slices. **/
+ ContractionSeqOptimizer::SearchTelemetry getContrSeqTelemetry() const;
+
  /** Returns the default process group comprising all MPI processes and their communicator. **/
  const ProcessGroup & getDefaultProcessGroup() const;
 
  /** Returns the current process group comprising solely the current MPI process and its own self-communicator. **/
  const ProcessGroup & getCurrentProcessGroup() const;
 
+ /** Returns the node process group comprising all MPI processes running on the same compute node
+     as the current MPI process (discovered at initialization within the default process group). **/
+ const ProcessGroup & getNodeProcessGroup() const;
+
  /** Returns the local rank of the MPI process in a given process group, or -1 if it does not belong to it. **/
  int getProcessRank(const ProcessGroup & process_group) const;
 
@@ -395,12 +862,21 @@ public:
      of a previously registered named vector space. **/
  const Subspace * getSubspace(const std::string & subspace_name) const;
 
+ /** Returns TRUE if a named subspace has been registered. **/
+ bool subspaceRegistered(const std::string & subspace_name) const;
+
 
  /** Submits an individual (simple or composite) tensor operation for processing.
      Composite tensor operations require an implementation of the TensorMapper interface. **/
  bool submit(std::shared_ptr<TensorOperation> operation,   //in: tensor operation for numerical evaluation
              std::shared_ptr<TensorMapper> tensor_mapper); //in: tensor mapper (for composite tensor operations only)
 
+ /** Submits a batch of (simple or composite) tensor operations for processing in order.
+     All resulting simple tensor operations are staged into the tensor runtime at once,
+     thus amortizing the staging and DAG appending costs over the whole batch. **/
+ bool submit(const std::vector<std::shared_ptr<TensorOperation>> & operations, //in: tensor operations for numerical evaluation
+             std::shared_ptr<TensorMapper> tensor_mapper);                     //in: tensor mapper (for composite tensor operations only)
+
  /** Submits a tensor network for processing (evaluating the output tensor-result).
      If the output (result) tensor has not been created yet, it will be created and
      initialized to zero automatically, and later destroyed automatically when no longer needed.
@@ -413,11 +889,22 @@ public:
  bool submit(const ProcessGroup & process_group,          //in: chosen group of MPI processes
              std::shared_ptr<TensorNetwork> network);     //in: tensor network for numerical evaluation
 
+ /** Submits a bundle of tensor networks with their own output tensors for processing
+     (evaluating all output tensors-results). The tensor contraction sequences of all
+     tensor networks are determined at once and the intermediates shared by different
+     tensor networks are evaluated only once. Synchronization is done via syncing on
+     each individual tensor network from the bundle. **/
+ bool submit(const std::vector<std::shared_ptr<TensorNetwork>> & networks); //in: tensor network bundle for numerical evaluation
+ bool submit(const ProcessGroup & process_group,                            //in: chosen group of MPI processes
+             const std::vector<std::shared_ptr<TensorNetwork>> & networks); //in: tensor network bundle for numerical evaluation
+
  /** Submits a tensor network expansion for processing (evaluating output tensors of all
      constituting tensor networks and accumualting them in the provided accumulator tensor).
      Synchronization of the tensor expansion evaluation is done via syncing on the accumulator
      tensor. By default all parallel processes will be processing the tensor network,
-     otherwise the desired process subset needs to be explicitly specified. **/
+     otherwise the desired process subset needs to be explicitly specified. With multiple
+     execution subgroups, the tensor networks are assigned to the subgroups by their
+     FMA flop count (longest first, to the least loaded subgroup per process). **/
  bool submit(TensorExpansion & expansion,                 //in: tensor expansion for numerical evaluation
              std::shared_ptr<Tensor> accumulator,         //inout: tensor accumulator (result)
              unsigned int parallel_width = 1);            //in: requested number of execution subgroups running in parallel
@@ -433,6 +920,55 @@ public:
              std::shared_ptr<Tensor> accumulator,         //inout: tensor accumulator (result)
              unsigned int parallel_width = 1);            //in: requested number of execution subgroups running in parallel
 
+ /** Submits a lazily generated tensor network expansion (tensor network expansion stream)
+     for processing, accumulating it into the provided accumulator tensor. The components
+     are generated and evaluated in batches of bounded size, such that only a single batch
+     of product tensor networks is present in memory at a time. The tensor network
+     expansion stream is rewound before the evaluation. **/
+ bool submit(TensorExpansionStream & expansion,           //in: tensor network expansion stream for numerical evaluation
+             std::shared_ptr<Tensor> accumulator,         //inout: tensor accumulator (result)
+             std::size_t batch_size = 256,                //in: max number of tensor network components per batch
+             unsigned int parallel_width = 1);            //in: requested number of execution subgroups running in parallel
+ bool submit(const ProcessGroup & process_group,          //in: chosen group of MPI processes
+             TensorExpansionStream & expansion,           //in: tensor network expansion stream for numerical evaluation
+             std::shared_ptr<Tensor> accumulator,         //inout: tensor accumulator (result)
+             std::size_t batch_size = 256,                //in: max number of tensor network components per batch
+             unsigned int parallel_width = 1);            //in: requested number of execution subgroups running in parallel
+
+ /** Starts capturing all subsequently submitted tensor operations under the given name,
+     replacing a previous capture with the same name. Captures cannot be nested. **/
+ bool beginCapture(const std::string & capture_name); //in: capture name
+
+ /** Stops the active capture. **/
+ bool endCapture();
+
+ /** Starts a speculation of the calling client thread: Subsequently submitted tensor operations
+     are recorded as speculative (see rationale (n)). Returns FALSE if speculative execution
+     is not active or the client thread is already speculating (nothing is recorded then). **/
+ bool beginSpeculation();
+
+ /** Commits the active speculation of the calling client thread: The recorded speculative
+     tensor operations are executed as usual. **/
+ bool commitSpeculation();
+
+ /** Discards the active speculation of the calling client thread: The recorded speculative
+     tensor operations are cancelled unless they are already executing or executed.
+     The output tensors of the speculation should only be destroyed afterwards. **/
+ bool discardSpeculation();
+
+ /** Resubmits a previously captured sequence of tensor operations for processing.
+     Each tensor operand is rebound by its captured name: To the tensor from <bindings>, if present,
+     otherwise to the currently registered tensor with the same name, if any, otherwise to the captured
+     tensor itself (intermediates). A captured CREATE of an already existing tensor is skipped. **/
+ bool replay(const std::string & capture_name,                                   //in: capture name
+             const std::map<std::string,std::shared_ptr<Tensor>> & bindings = {}); //in: captured tensor name --> replacement tensor
+
+ /** Returns TRUE if the capture with the given name exists. **/
+ bool captureExists(const std::string & capture_name) const; //in: capture name
+
+ /** Destroys a previously recorded capture. **/
+ bool destroyCapture(const std::string & capture_name); //in: capture name
+
  /** Synchronizes all update operations on a given tensor.
      Changing wait to FALSE, only tests for completion.
      If ProcessGroup is not provided, defaults to the local process. **/
@@ -598,7 +1134,8 @@ public:
                        Args&&... args);                                         //in: other arguments for Tensor ctor
 
  /** Creates all input tensors in a given tensor network that are still unallocated.
-     No initialization is performed on the tensor bodies. **/
+     No initialization is performed on the tensor bodies. All tensors are created
+     in a single batch, the synchronous version synchronizes the process group once. **/
  bool createTensors(TensorNetwork & tensor_network,         //inout: tensor network
                     TensorElementType element_type);        //in: tensor element type
 
@@ -645,6 +1182,67 @@ public:
 
  bool destroyTensorsSync();
 
+ /** Creates a block-sparse tensor: Only its blocks allowed by symmetry are allocated,
+     each as a regular tensor (the block-sparse tensor itself is not allocated).
+     The block-sparse tensor can only be operated on by the block-sparse API below. **/
+ bool createTensorBlockSparse(std::shared_ptr<TensorBlockSparse> tensor, //in: declared block-sparse tensor
+                              TensorElementType element_type);         //in: tensor element type
+
+ bool createTensorBlockSparse(const ProcessGroup & process_group,        //in: chosen group of MPI processes
+                              std::shared_ptr<TensorBlockSparse> tensor, //in: declared block-sparse tensor
+                              TensorElementType element_type);           //in: tensor element type
+
+ template<typename... Args>
+ bool createTensorBlockSparse(const std::string & name,                                               //in: tensor name
+                              TensorElementType element_type,                                         //in: tensor element type
+                              const std::vector<std::vector<numerics::SymmetryRange>> & dim_sectors,  //in: symmetry sectors of each tensor dimension (or empty)
+                              const std::vector<int> & dim_directions,                                //in: direction of each tensor dimension (+1 or -1)
+                              SymmetryId total_charge,                                                //in: total quantum number of the tensor
+                              unsigned int modulus,                                                   //in: symmetry modulus: 0 for U(1), N for Z(N)
+                              Args&&... args);                                                        //in: other arguments for Tensor ctor
+
+ /** Returns a previously created block-sparse tensor, or nullptr if not found. **/
+ std::shared_ptr<TensorBlockSparse> getTensorBlockSparse(const std::string & name); //in: tensor name
+
+ /** Destroys a block-sparse tensor (all its stored blocks). **/
+ bool destroyTensorBlockSparse(const std::string & name); //in: tensor name
+
+ /** Initializes all stored blocks of a block-sparse tensor to some scalar value. **/
+ template<typename NumericType>
+ bool initTensorBlockSparse(const std::string & name, //in: tensor name
+                            NumericType value);       //in: scalar value
+
+ /** Initializes all stored blocks of a block-sparse tensor to some random value. **/
+ bool initTensorBlockSparseRnd(const std::string & name); //in: tensor name
+
+ /** Performs block-sparse tensor contraction: tensor0 += tensor1 * tensor2 * alpha,
+     where all tensors are block-sparse. Only the pairs of stored input blocks with
+     matching symmetry sectors of the contracted dimensions are contracted into their
+     stored output blocks, all submitted as a single batch of dense tensor contractions. **/
+ template<typename NumericType>
+ bool contractTensorsBlockSparse(const std::string & contraction, //in: symbolic tensor contraction specification
+                                 NumericType alpha);              //in: alpha prefactor
+
+ template<typename NumericType>
+ bool contractTensorsBlockSparseSync(const std::string & contraction, //in: symbolic tensor contraction specification
+                                     NumericType alpha);              //in: alpha prefactor
+
+ /** Computes 2-norm of a block-sparse tensor. **/
+ bool computeNorm2BlockSparseSync(const std::string & name, //in: tensor name
+                                  double & norm);           //out: tensor norm
+
+ /** Registers a structured order-2 tensor (Kronecker delta, diagonal or permutation).
+     The structured tensor is not allocated: Tensor contractions with it (contractTensors)
+     are executed as index relabeling, elementwise scaling or reordering of the other
+     input tensor along the contracted dimension (see tensor_structured.hpp). **/
+ bool createTensorStructured(std::shared_ptr<TensorStructured> tensor); //in: declared structured tensor
+
+ /** Returns a previously registered structured tensor, or nullptr if not found. **/
+ std::shared_ptr<TensorStructured> getTensorStructured(const std::string & name); //in: tensor name
+
+ /** Unregisters a structured tensor. **/
+ bool destroyTensorStructured(const std::string & name); //in: tensor name
+
  /** Initializes a tensor to some scalar value. **/
  template<typename NumericType>
  bool initTensor(const std::string & name, //in: tensor name
@@ -665,6 +1263,21 @@ public:
  bool initTensorDataSync(const std::string & name,                   //in: tensor name
                          const std::vector<NumericType> & ext_data); //in: vector with externally provided data
 
+ /** Initializes a tensor with externally provided data residing in an externally
+     owned host buffer (column-wise storage of the full tensor) without copying it:
+     Each local tensor slice is filled directly from the external buffer. The external
+     buffer must stay valid until the optional release callback is invoked, which
+     happens once the tensor initialization has been executed (and its functor destroyed). **/
+ template<typename NumericType>
+ bool initTensorBuffer(const std::string & name,                 //in: tensor name
+                       const NumericType * ext_buffer,           //in: externally owned host buffer
+                       std::function<void ()> release = nullptr); //in: release callback for the external buffer
+
+ template<typename NumericType>
+ bool initTensorBufferSync(const std::string & name,                 //in: tensor name
+                           const NumericType * ext_buffer,           //in: externally owned host buffer
+                           std::function<void ()> release = nullptr); //in: release callback for the external buffer
+
 /** Initializes a tensor with externally provided data read from a file with format:
      Storage format (string: {dense|list})
      Tensor name
@@ -672,19 +1285,32 @@ public:
      Tensor signature (space-separated dimension base offsets)
      Tensor elements:
       Dense format: Numeric values (column-wise order), any number of values per line
-      List format: Numeric value and Multi-index in each line **/
+      List format: Numeric value and Multi-index in each line
+    Alternatively, the file may have the binary format (functor_init_file.hpp),
+    in which case it is memory-mapped and each process copies only its own tensor slice. **/
  bool initTensorFile(const std::string & name,      //in: tensor name
                      const std::string & filename); //in: file name with tensor data
 
  bool initTensorFileSync(const std::string & name,      //in: tensor name
                          const std::string & filename); //in: file name with tensor data
 
+ /** Resets the seed of the random tensor initialization. The random tensor elements are
+     determined by the seed, the tensor name and the element position in the full tensor,
+     thus they are reproducible and independent of the tensor distribution and slicing.
+     Re-initializing a tensor with the same name and seed reproduces its elements. **/
+ void resetRandomSeed(std::uint64_t seed = DEFAULT_RANDOM_SEED); //in: random seed (must be the same on all processes)
+
+ /** Returns the current seed of the random tensor initialization. **/
+ std::uint64_t getRandomSeed() const;
+
  /** Initializes a tensor to some random value. **/
  bool initTensorRnd(const std::string & name);     //in: tensor name
 
  bool initTensorRndSync(const std::string & name); //in: tensor name
 
- /** Initializes all input tensors of a given tensor network to a random value. **/
+ /** Initializes all input tensors of a given tensor network to a random value.
+     All tensors are initialized in a single batch, the synchronous version
+     synchronizes each involved process group once. **/
  bool initTensorsRnd(TensorNetwork & tensor_network);     //inout: tensor network
 
  bool initTensorsRndSync(TensorNetwork & tensor_network); //inout: tensor network
@@ -716,10 +1342,38 @@ public:
                               unsigned int tensor_dimension,        //in: chosen tensor dimension
                               std::vector<double> & partial_norms); //out: partial 2-norms over the chosen tensor dimension
 
+ /** Asynchronous versions of the above (scalar) reductions: The reduction is submitted
+     with the interactive latency class and a deferred future is returned immediately,
+     such that the client can submit more (independent) work while the reduction drains.
+     The reduction is completed upon future.get(), which synchronizes the reduction
+     and returns its result: A negative norm (empty partial norms) indicates a failure
+     or a nonexistent tensor. The future must be consumed by the client thread
+     (in the presence of MPI, collectively by the tensor process group). **/
+ std::future<double> computeMaxAbsAsync(const std::string & name); //in: tensor name
+
+ std::future<double> computeNorm1Async(const std::string & name);  //in: tensor name
+
+ std::future<double> computeNorm2Async(const std::string & name);  //in: tensor name
+
+ std::future<std::vector<double>> computePartialNormsAsync(const std::string & name,       //in: tensor name
+                                                           unsigned int tensor_dimension); //in: chosen tensor dimension
+
  /** Computes 2-norms of all tensors in a tensor network. **/
  bool computeNorms2Sync(const TensorNetwork & network,         //in: tensor network
                         std::map<std::string,double> & norms); //out: tensor norms: tensor_name --> norm
 
+ /** Computes the 1-norm, 2-norm and max-abs norm of multiple tensors: Each tensor is reduced
+     by a single fused pass over its body and the partial norms of all tensors associated
+     with the given process group are combined by a single collective. Tensors associated
+     with other process groups are combined by their own collectives. The norms of
+     nonexistent tensors are negative. **/
+ bool computeNormsSync(const std::vector<std::string> & names, //in: tensor names
+                       std::vector<TensorNorms> & norms);      //out: tensor norms (in the order of names)
+
+ bool computeNormsSync(const ProcessGroup & process_group,     //in: chosen group of MPI processes
+                       const std::vector<std::string> & names, //in: tensor names
+                       std::vector<TensorNorms> & norms);      //out: tensor norms (in the order of names)
+
  /** Replicates a tensor within the given process group, which defaults to all MPI processes.
      Only the root_process_rank within the given process group is required to have the tensor,
      that is, the tensor will automatically be created in those MPI processes which do not have it.  **/
@@ -737,6 +1391,25 @@ public:
                           const std::string & name,           //in: tensor name
                           int root_process_rank);             //in: local rank of the root process within the given process group
 
+ /** Replicates a tensor within the given process group, which defaults to all MPI processes,
+     such that only a single copy of the tensor body is kept per compute node: The body is
+     allocated in an MPI-3 shared-memory window of each node and mapped into the node executor
+     of every MPI process on that node. Only the root_process_rank within the given process
+     group is required to have the tensor. The node-shared replica is read-only: It can only
+     be updated by a single writer (any one process of the group) followed by broadcastTensor
+     from that writer, which propagates the update between the compute nodes. Composite tensors
+     cannot be replicated. The node-shared replica is released by destroyTensor, which always
+     synchronizes in this case (collective within the process group). **/
+ bool replicateTensorSharedSync(const std::string & name,       //in: tensor name
+                                int root_process_rank);         //in: local rank of the root process within the given process group
+
+ bool replicateTensorSharedSync(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                                const std::string & name,           //in: tensor name
+                                int root_process_rank);             //in: local rank of the root process within the given process group
+
+ /** Returns TRUE if the tensor is a node-shared replica (see replicateTensorSharedSync). **/
+ bool tensorIsSharedReplica(const std::string & name) const; //in: tensor name
+
  /** Shrinks the domain of existence of a given tensor to a single process. **/
  bool dereplicateTensor(const std::string & name,     //in: tensor name
                         int root_process_rank);       //in: local rank of the chosen process
@@ -752,6 +1425,25 @@ public:
                             const std::string & name,           //in: tensor name
                             int root_process_rank);             //in: local rank of the chosen process
 
+ /** Redistributes a tensor from its current domain of existence (process group and decomposition)
+     to the target process group with a new decomposition (split dimensions of a composite tensor,
+     or none for a simple tensor replicated within the target process group). Only the minimal
+     block transfers between the source and target layouts are performed, which are exchanged
+     pairwise (non-blocking) while the source tensor is destroyed and the target tensor is created.
+     Both the source and target process groups must be contained in the given (parent) process group,
+     which defaults to all MPI processes; the call is collective within the parent process group.
+     Node-shared replicas cannot be redistributed. **/
+ bool redistributeTensorSync(const std::string & name,          //in: tensor name
+                             const ProcessGroup & target_group, //in: target process group
+                             const std::vector<std::pair<unsigned int,
+                                                         unsigned int>> & split_dims = {}); //in: target split tensor dimensions: pair{Dimension,MaxDepth}
+
+ bool redistributeTensorSync(const ProcessGroup & process_group, //in: parent group of MPI processes
+                             const std::string & name,           //in: tensor name
+                             const ProcessGroup & target_group,  //in: target process group
+                             const std::vector<std::pair<unsigned int,
+                                                         unsigned int>> & split_dims = {}); //in: target split tensor dimensions: pair{Dimension,MaxDepth}
+
  /** Broadcast a tensor among all MPI processes within a given process group,
      which defaults to all MPI processes. This function is needed when
      a tensor is updated in an operation submitted to a subset of MPI processes
@@ -771,6 +1463,32 @@ public:
                           const std::string & name,           //in: tensor name
                           int root_process_rank);             //in: local rank of the root process within the given process group
 
+ /** Broadcasts a tensor network (or a tensor network expansion) built by the root process
+     to all other MPI processes within a given process group, which defaults to all MPI processes,
+     such that it does not have to be built by each MPI process independently. It is sent packed
+     together with its tensor contraction sequence (see tensor_network.hpp), replacing the tensor
+     network (expansion) given on the other MPI processes. The received tensors are substituted
+     by the tensors registered under the same names, if any. Tensor bodies are not transferred. **/
+ bool broadcastTensorNetwork(TensorNetwork & network,                 //inout: tensor network (received on non-root processes)
+                             int root_process_rank);                  //in: local rank of the root process within the given process group
+
+ bool broadcastTensorNetwork(const ProcessGroup & process_group,      //in: chosen group of MPI processes
+                             TensorNetwork & network,                 //inout: tensor network (received on non-root processes)
+                             int root_process_rank);                  //in: local rank of the root process within the given process group
+
+ bool broadcastTensorExpansion(TensorExpansion & expansion,           //inout: tensor network expansion (received on non-root processes)
+                               int root_process_rank);                //in: local rank of the root process within the given process group
+
+ bool broadcastTensorExpansion(const ProcessGroup & process_group,    //in: chosen group of MPI processes
+                               TensorExpansion & expansion,           //inout: tensor network expansion (received on non-root processes)
+                               int root_process_rank);                //in: local rank of the root process within the given process group
+
+ /** Broadcasts a raw byte buffer from the root process to all other MPI processes
+     within a given process group (resized on the receiving processes). **/
+ bool broadcastBytes(const ProcessGroup & process_group,              //in: chosen group of MPI processes
+                     std::vector<char> & bytes,                       //inout: byte buffer (received on non-root processes)
+                     int root_process_rank);                          //in: local rank of the root process within the given process group
+
  /** Performs a global sum reduction on a tensor among all MPI processes within a given
      process group, which defaults to all MPI processes. This function is needed when
      multiple MPI processes compute their local updates to the tensor, thus requiring
@@ -825,6 +1543,57 @@ public:
  bool insertTensorSliceSync(const std::string & tensor_name, //in: tensor name
                             const std::string & slice_name); //in: slice name
 
+ /** Resizes a tensor dimension in place, preserving the tensor identity (the same tensor
+     object keeps its name). The retained block of the tensor body is preserved: When growing,
+     the tensor is inserted into the new zero-initialized storage (zero padding); when shrinking,
+     the leading block is extracted. Composite tensors are not supported. **/
+ bool resizeTensorSync(const std::string & name, //in: tensor name
+                       unsigned int dimension,   //in: tensor dimension
+                       DimExtent new_extent);    //in: new dimension extent (>0)
+
+ /** Performs a single bond adaptivity step on a tensor network (see TensorNetwork::applyBondAdaptivityStep)
+     resizing the adapted tensors in place: Allocated tensors are resized via resizeTensorSync,
+     thus keeping their identity and stored data, whereas the tensor contraction sequence
+     of the tensor network is retained with its cost rescaled (unless invalidated). **/
+ bool adaptBondsSync(TensorNetwork & network,  //inout: adaptive tensor network
+                     bool invalidate = false); //in: whether to invalidate the cached tensor contraction sequence
+
+ /** Approximately evaluates a tensor network by compressing its intermediates on the fly:
+     All bonds of the intermediate tensors exceeding max_bond are truncated to max_bond via
+     the truncated SVD of the merged neighbors. The output tensor (#0) must already exist,
+     the result is accumulated into it. The tensor network (its input tensors) is not modified,
+     except its tensor contraction sequence is determined if absent. Returns the estimate
+     of the truncation error (sum of the local truncation errors). Synchronous. **/
+ bool evaluateApproximateSync(TensorNetwork & network,    //in: tensor network
+                              DimExtent max_bond,         //in: bond dimension limit (>0)
+                              double & truncation_error); //out: estimated truncation error
+
+ bool evaluateApproximateSync(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                              TensorNetwork & network,            //in: tensor network
+                              DimExtent max_bond,                 //in: bond dimension limit (>0)
+                              double & truncation_error);         //out: estimated truncation error
+
+ /** Compresses a tensor network expansion of matrix product states (MPS) into a single MPS
+     directly, without iterative reconstruction: The exact direct sum of all components
+     (block-diagonal site tensors, the expansion coefficients absorbed into the first site)
+     is brought into the left-canonical form by a left-to-right SVD sweep, followed by
+     a right-to-left truncated SVD sweep capping all bonds at max_bond. Each component must
+     be an MPS: Tensor k carries output mode k and is connected to tensors k-1 and k+1 only
+     (one bond each), no complex conjugation. The new MPS tensors are created here, their sites
+     1..N-1 being registered as (right) isometries; the output tensor of the compressed
+     tensor network is not created. Returns the estimate of the truncation error (2-norm
+     of the discarded singular values). Synchronous. **/
+ bool compressExpansionSync(const TensorExpansion & expansion,            //in: tensor network expansion of MPS
+                            DimExtent max_bond,                           //in: bond dimension limit (>0)
+                            std::shared_ptr<TensorNetwork> & compressed,  //out: compressed MPS
+                            double & truncation_error);                   //out: estimated truncation error
+
+ bool compressExpansionSync(const ProcessGroup & process_group,           //in: chosen group of MPI processes
+                            const TensorExpansion & expansion,            //in: tensor network expansion of MPS
+                            DimExtent max_bond,                           //in: bond dimension limit (>0)
+                            std::shared_ptr<TensorNetwork> & compressed,  //out: compressed MPS
+                            double & truncation_error);                   //out: estimated truncation error
+
  /** Assigns one tensor to another congruent one (makes a copy of a tensor).
      If the output tensor with the given name does not exist, it will be created.
      Note that the output tensor must either exist or not exist across all
@@ -855,6 +1624,26 @@ public:
  bool contractTensorsSync(const std::string & contraction, //in: symbolic tensor contraction specification
                           NumericType alpha);              //in: alpha prefactor
 
+ /** Prepares a symbolic tensor addition or contraction for repeated execution:
+     Returns a handle binding the parsed specification to the tensor operands,
+     or nullptr if the specification is invalid or some tensor is not found
+     (for example, the current process does not participate). The handle stays
+     valid as long as its tensor operands are not destroyed. **/
+ TensorOperationHandle prepareAddition(const std::string & addition); //in: symbolic tensor addition specification
+
+ TensorOperationHandle prepareContraction(const std::string & contraction); //in: symbolic tensor contraction specification
+
+ /** Executes a prepared tensor addition (tensor0 += tensor1 * alpha) or
+     contraction (tensor0 += tensor1 * tensor2 * alpha) without re-parsing
+     its specification or looking up its tensor operands by name. **/
+ template<typename NumericType>
+ bool execute(const TensorOperationHandle & handle, //in: prepared tensor operation
+              NumericType alpha);                   //in: alpha prefactor
+
+ template<typename NumericType>
+ bool executeSync(const TensorOperationHandle & handle, //in: prepared tensor operation
+                  NumericType alpha);                   //in: alpha prefactor
+
  /** Decomposes a tensor into three tensor factors via SVD. The symbolic
      tensor contraction specification specifies the decomposition,
      for example:
@@ -913,17 +1702,56 @@ public:
 
  bool orthogonalizeTensorMGSSync(const std::string & name); //in: tensor name
 
+ /** Enforces the registered isometries of a tensor with the chosen orthonormalization algorithm
+     (does nothing if the tensor has no isometries). **/
+ bool isometrizeTensor(const std::string & name,   //in: tensor name
+                       IsometrizeMethod method);   //in: orthonormalization algorithm
+
+ bool isometrizeTensorSync(const std::string & name,   //in: tensor name
+                           IsometrizeMethod method);   //in: orthonormalization algorithm
+
+ /** Resets the orthonormalization algorithm used for the automatic enforcement of tensor isometries
+     (after random initialization, tensor addition/contraction, etc.). **/
+ void resetIsometrizeMethod(IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2);
+
+ /** Returns the orthonormalization algorithm used for the automatic enforcement of tensor isometries. **/
+ IsometrizeMethod getIsometrizeMethod() const;
+
  /** Prints a tensor to the standard output. **/
  bool printTensor(const std::string & name); //in: tensor name
 
  bool printTensorSync(const std::string & name); //in: tensor name
 
- /** Prints a tensor to a file. **/
- bool printTensorFile(const std::string & name,      //in: tensor name
-                      const std::string & filename); //in: file name
-
- bool printTensorFileSync(const std::string & name,      //in: tensor name
-                          const std::string & filename); //in: file name
+ /** Prints a tensor to a file, either in the text format or in the binary
+     format (see initTensorFile). **/
+ bool printTensorFile(const std::string & name,     //in: tensor name
+                      const std::string & filename, //in: file name
+                      bool binary = false);         //in: binary (true) or text (false) file format
+
+ bool printTensorFileSync(const std::string & name,     //in: tensor name
+                          const std::string & filename, //in: file name
+                          bool binary = false);         //in: binary (true) or text (false) file format
+
+ /** Saves tensors to a checkpoint file collectively by all processes of the given
+     process group, which must be the existence domain of all saved tensors (by default,
+     all registered tensors of that process group with non-implicit names are saved).
+     The checkpoint file contains a binary tensor record (see initTensorFile) for each
+     saved tensor, with the subtensors of composite tensors stored as separate blocks
+     written by their first owners. Block bodies are aligned to stripes (MPI-IO), and
+     retrieving the next local block overlaps with the asynchronous write of the previous one. **/
+ bool saveTensors(const ProcessGroup & process_group,                  //in: chosen group of MPI processes
+                  const std::string & filename,                        //in: checkpoint file name
+                  const std::vector<std::string> & tensor_names = {}); //in: names of the tensors to save (all by default)
+
+ bool saveTensors(const std::string & filename,                        //in: checkpoint file name
+                  const std::vector<std::string> & tensor_names = {}); //in: names of the tensors to save (all by default)
+
+ /** Initializes already created tensors from a checkpoint file (by default, all registered
+     tensors stored in the checkpoint). The tensors may have a different distributed storage
+     (e.g., a different process count): Each process copies only the portions of the stored
+     blocks overlapping with its own (sub)tensors. **/
+ bool loadTensors(const std::string & filename,                        //in: checkpoint file name
+                  const std::vector<std::string> & tensor_names = {}); //in: names of the tensors to load (all by default)
 
  /** Performs a full evaluation of a tensor network based on the symbolic
      specification involving already created tensors (including the output). **/
@@ -1029,6 +1857,34 @@ public:
                                                    const TensorExpansion & expansion,  //in: tensor network expansion
                                                    const Tensor & slice);              //in: desired slice of the output tensor
 
+ /** Evaluates a batch of elements (amplitudes) of the output tensor of a given tensor network,
+     specified by their multi-indices (e.g., bitstrings). The output tensor modes on which all
+     multi-indices coincide are projected out by rank-1 projection tensors, up to max_open_legs
+     varying modes are left open, and each distinct combination of values of the remaining
+     varying modes yields a single projected tensor network whose output tensor supplies all
+     amplitudes of that group. All projected tensor networks share the same structure, hence
+     the same contraction sequence (or cuQuantum contraction plan). **/
+ bool evaluateAmplitudesSync(const TensorNetwork & network,                           //in: tensor network
+                             const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested output tensor elements
+                             std::vector<std::complex<double>> & amplitudes,           //out: requested output tensor elements
+                             unsigned int max_open_legs = DEFAULT_AMPLITUDE_OPEN_LEGS); //in: max number of open output legs per projected tensor network
+
+ bool evaluateAmplitudesSync(const ProcessGroup & process_group,                      //in: chosen group of MPI processes
+                             const TensorNetwork & network,                           //in: tensor network
+                             const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested output tensor elements
+                             std::vector<std::complex<double>> & amplitudes,           //out: requested output tensor elements
+                             unsigned int max_open_legs = DEFAULT_AMPLITUDE_OPEN_LEGS); //in: max number of open output legs per projected tensor network
+
+ /** Reads a batch of tensor elements, specified by their multi-indices (relative to the tensor
+     base offsets), into a contiguous array (in the order of the multi-indices). The elements are
+     read directly from the local tensor body (zero-copy view), one request per tensor body.
+     For composite tensors, this is a collective call within the domain of existence of the tensor:
+     Each process reads the requested elements from its local subtensors and the values are
+     then gathered by a single all-reduce, such that all processes receive all requested elements. **/
+ bool getTensorElementsSync(const std::string & name,                                  //in: tensor name
+                            const std::vector<std::vector<DimOffset>> & multi_indices, //in: multi-indices of the requested tensor elements
+                            std::vector<std::complex<double>> & values);               //out: requested tensor elements
+
  /** Returns a locally stored tensor slice (talsh::Tensor) providing access to tensor elements.
      This slice will be extracted from the exatn::numerics::Tensor implementation as a copy.
      The returned future becomes ready once the execution thread has retrieved the slice copy. **/
@@ -1042,6 +1898,14 @@ public:
  /** This overload returns a copy of the full tensor while referencing it by its registered name. **/
  std::shared_ptr<talsh::Tensor> getLocalTensor(const std::string & name); //in: exatn tensor name
 
+ /** Returns a read-only zero-copy view of the locally stored tensor body (column-major),
+     which pins the tensor (no tensor operations on it will be executed) until all copies
+     of the view have been released. Release the view before submitting further
+     tensor operations on the tensor that need to be waited on. **/
+ TensorView getTensorView(std::shared_ptr<Tensor> tensor); //in: exatn::numerics::Tensor to view
+ /** This overload references the ExaTN tensor by its registered name. **/
+ TensorView getTensorView(const std::string & name); //in: exatn tensor name
+
  inline double getTimeStampStart() const {return time_start_;}
 
  /** DEBUG: Prints all currently existing (allocated) tensors. **/
@@ -1052,9 +1916,140 @@ public:
 
 protected:
 
+ static constexpr const double DEFAULT_MEM_FRAGMENTATION = 1.5;     //assumed memory fragmentation factor (when not measurable)
+ static constexpr const double MAX_MEM_FRAGMENTATION = 3.0;         //max memory fragmentation factor used in slicing
+ static constexpr const std::size_t MEM_FRAGMENTATION_SAMPLE_RATIO = 64; //measured fragmentation is used when the allocated tensors occupy at least 1/64 of the memory buffer
+ static constexpr const double CONTR_SEQ_SLICING_PRESENCE = 3.0;     //assumed ratio of the max intermediate presence volume to the max intermediate volume (slicing-aware search)
+ static constexpr const double CONTR_SEQ_FMA_FLOP_RATE = 1e12;      //assumed FMA flop rate per process (FMA/sec) for estimating the contraction time (anytime search)
+ static constexpr const unsigned int DYNAMIC_SLICE_CHUNKS = 8;       //number of chunks of tensor sub-networks per process in the dynamic scheduling
+ static constexpr const double SLICE_INVARIANT_MEMORY_FRACTION = 0.25; //max fraction of the process memory limit occupied by the retained slice-invariant intermediates
+ static constexpr const double SLICE_DOUBLE_BUFFER_FRACTION = 0.25;    //fraction of the process memory limit reserved for the staged input slices (double buffering)
+ static constexpr const double HYBRID_HOST_SHARE_INITIAL = 0.125;      //initial Host share of the tensor sub-networks in the hybrid execution (before calibration)
+ static constexpr const double HYBRID_HOST_SHARE_MIN = 1.0/64.0;        //min Host share of the tensor sub-networks (keeps the Host throughput measured)
+ static constexpr const double HYBRID_HOST_SHARE_MAX = 0.5;             //max Host share of the tensor sub-networks (Host also drives the accelerators)
+ static constexpr const double HYBRID_RATE_SMOOTHING = 0.25;            //weight of the latest measurement in the running Host/accelerator throughput
+ static constexpr const std::size_t CHECKPOINT_STRIPE_SIZE = 1048576;  //stripe size (bytes) to which the large block bodies in a checkpoint file are aligned
+ static constexpr const std::size_t MAX_VALIDATION_SAMPLES = 256;      //max number of validation checksums in flight (the oldest one is then waited upon)
+ static constexpr const std::size_t MAX_NETWORK_MEMOS = 1024;         //max number of memoized tensor network evaluations (the memo is then reset)
+
  /** Submits an individual tensor operation for processing. **/
  bool submitOp(std::shared_ptr<TensorOperation> operation); //in: tensor operation for numerical evaluation
 
+ /** Returns the memory fragmentation factor used in tensor slicing (measured if enough tensors are allocated). **/
+ double getMemoryFragmentationFactor() const;
+
+ /** Submits the validation checksums of a submitted tensor operation if it is sampled. **/
+ void sampleValidation(const TensorOperation & operation);
+
+ /** Collects the completed validation checksums (in order) into the validation stamp file.
+     If wait = TRUE, it will block until all of them have completed. **/
+ void collectValidationSamples(bool wait);
+
+ /** Determines the pseudo-optimal tensor contraction sequence for a tensor network
+     executed by a given process group (collective). An already determined tensor
+     contraction sequence is only synchronized across the processes. **/
+ void determineContractionSequence(const ProcessGroup & process_group, //in: executing process group
+                                   TensorNetwork & network,            //inout: tensor network
+                                   bool synchronize = true);           //in: whether or not to synchronize the tensor contraction sequence across the processes
+
+ /** Synchronizes the best tensor contraction sequences of multiple tensor networks
+     across the processes of a given process group at once (collective). **/
+ void synchronizeContractionSequences(const ProcessGroup & process_group,              //in: executing process group
+                                      const std::vector<TensorNetwork*> & networks); //inout: tensor networks
+
+ /** Submits the reduction of the partial tensor computed by all processes of
+     a given process group according to the current output reduction strategy. **/
+ bool submitOutputReduction(const ProcessGroup & process_group,          //in: executing process group
+                            std::shared_ptr<Tensor> tensor,              //inout: partial tensor (reduced)
+                            std::shared_ptr<TensorMapper> tensor_mapper); //in: tensor mapper
+
+ /** Returns the max intermediate volume used by the slicing-aware tensor contraction sequence search (0 if inactive). **/
+ double getContrSeqSlicingVolume(const ProcessGroup & process_group) const;
+
+ /** Submits a tensor network for evaluation by a given process group. If an accumulator
+     is provided, the scaled result of the tensor network is accumulated directly into it
+     (its output tensor is neither created nor allreduced), with unsliced tensor networks
+     executed by the process of the given local rank only (all processes if negative). **/
+ bool submitNetwork(const ProcessGroup & process_group,                       //in: executing process group
+                    TensorNetwork & network,                                  //in: tensor network
+                    bool contr_seq_synced,                                    //in: whether or not the tensor contraction sequence has already been synchronized
+                    std::shared_ptr<Tensor> accumulator = nullptr,            //in: optional accumulator tensor
+                    std::complex<double> coefficient = std::complex<double>{1.0,0.0}, //in: accumulation coefficient
+                    int executing_rank = -1);                                 //in: local rank of the executing process for unsliced tensor networks
+
+ /** Memoized evaluation of a tensor network (l) **/
+ struct NetworkMemo {
+  std::vector<std::uint64_t> structure; //exact structure of the tensor network (empty: not memoizable)
+  std::vector<std::uint64_t> versions;  //versions of the input tensors (in the order of the structure)
+  std::uint64_t output_version = 0;     //version of the output tensor right after the evaluation
+ };
+
+ /** Looks up the memoized evaluation of a tensor network (collective). Returns TRUE if the output
+     tensor already holds the result, otherwise returns the memo to be recorded after the evaluation. **/
+ bool lookupNetworkMemo(const ProcessGroup & process_group, //in: executing process group
+                        const TensorNetwork & network,      //in: tensor network
+                        std::size_t * hash,                 //out: structural hash of the tensor network
+                        NetworkMemo & memo);                //out: memo of the tensor network (without the output version)
+
+ /** Records the memoized evaluation of a just submitted tensor network. **/
+ void recordNetworkMemo(const TensorNetwork & network, //in: tensor network
+                        std::size_t hash,              //in: structural hash of the tensor network
+                        NetworkMemo && memo);          //in: memo returned by lookupNetworkMemo
+
+ /** Broadcasts a packable object from the root process to all other MPI processes
+     of a given process group (the object is unpacked on the non-root processes).
+     Returns FALSE if the calling process does not belong to the process group. **/
+ bool broadcastPackable(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                        Packable & object,                  //inout: packable object
+                        int root_process_rank);             //in: local rank of the root process within the given process group
+
+ /** Substitutes the tensors of a received tensor network by the tensors registered under the same names. **/
+ void substituteRegisteredTensors(TensorNetwork & network); //inout: tensor network
+
+#ifdef CUQUANTUM
+ /** Selects the computational backend of a tensor network under the "auto" backend (collective),
+     determining its tensor contraction sequence, and starts measuring its execution time. **/
+ runtime::BackendSelector::Backend selectNetworkBackend(const ProcessGroup & process_group, //in: executing process group
+                                                        TensorNetwork & network);           //in: tensor network
+
+ /** Completes the measurement of the execution time of a tensor network with a given output tensor
+     under the "auto" backend, feeding it back to the backend selector if it has been measured. **/
+ void recordNetworkBackend(numerics::TensorHashType output_hash, //in: output tensor hash
+                           bool measured);                       //in: whether or not the execution has been waited upon
+#endif
+
+ /** Starts batching: Subsequently submitted simple tensor operations are collected
+     instead of being submitted to the tensor runtime right away (no-op under validation tracing).
+     No synchronization may happen until the batch has been ended. **/
+ void beginBatch();
+
+ /** Ends batching: Submits all collected simple tensor operations to the tensor runtime at once. **/
+ void endBatch();
+
+ /** Appends the still unallocated input tensors of a tensor network which have not been collected yet. **/
+ void collectUnallocatedTensors(TensorNetwork & tensor_network,                 //in: tensor network
+                                std::vector<std::shared_ptr<Tensor>> & tensors, //inout: collected tensors
+                                std::unordered_set<std::string> & names);       //inout: names of the collected tensors
+
+ /** Creates a list of tensors in a single batch of tensor operations. If synchronous,
+     the process group is synchronized once after the whole batch. **/
+ bool createTensorBatch(const ProcessGroup & process_group,                     //in: chosen group of MPI processes
+                        const std::vector<std::shared_ptr<Tensor>> & tensors,   //in: tensors to create
+                        TensorElementType element_type,                         //in: tensor element type
+                        bool synchronous);                                      //in: synchronous or not
+
+ /** Appends the tensors of a tensor network subject to random initialization, as pairs
+     {name, random}: The optimizable input tensors (random) and the allocated output tensor (zero).
+     Returns FALSE if some input tensor is not allocated. **/
+ bool collectRandomInitTensors(const TensorNetwork & tensor_network,                   //in: tensor network
+                               std::vector<std::pair<std::string,bool>> & tensors,     //inout: collected tensors
+                               std::unordered_set<std::string> & names);               //inout: names of the collected tensors
+
+ /** Initializes a list of tensors in a single batch of tensor operations (random or zero). If synchronous,
+     each involved process group is synchronized once after the whole batch. **/
+ bool initTensorBatchRnd(const std::vector<std::pair<std::string,bool>> & tensors,    //in: collected tensors
+                         bool synchronous);                                           //in: synchronous or not
+
  /** Synchronizes execution of a specific tensor operation.
      Changing wait to FALSE will only test for completion.
      This method has local synchronization semantics! **/
@@ -1062,35 +2057,225 @@ protected:
            bool wait = true);
 
  /** Destroys orphaned tensors (garbage collection). Setting <force> to TRUE
-     will force destruction regardless of the use count. **/
+     will force destruction regardless of the use count. Called at synchronization
+     points and upon each tensor network submission (outside of captures). **/
  void destroyOrphanedTensors(bool force = false);
 
+ /** Returns the process subgroup of the current process when splitting a given process group
+     into a given number of execution subgroups (collective upon first request only). **/
+ std::shared_ptr<ProcessGroup> getProcessSubgroup(const ProcessGroup & process_group, //in: parent process group
+                                                  unsigned int num_subgroups,         //in: number of execution subgroups
+                                                  int my_subgroup);                   //in: subgroup of the current process
+
+ /** Returns the subgroup accumulator tensor of the current process congruent to a given accumulator
+     (created within the process subgroup upon first request, reused afterwards). **/
+ std::shared_ptr<Tensor> getSubgroupAccumulator(const ProcessGroup & process_group, //in: parent process group
+                                                unsigned int num_subgroups,         //in: number of execution subgroups
+                                                const Tensor & accumulator,         //in: global accumulator tensor
+                                                TensorElementType element_type);    //in: tensor element type
+
+ /** Destroys the cached subgroup accumulator tensors of the subgroups of a given process group. **/
+ void destroySubgroupAccumulators(const ProcessGroup & process_group);
+
+ /** Propagates an update of a node-shared tensor replica from a given writer process
+     to all other compute nodes (collective within the process group of the replica). **/
+ bool updateSharedReplica(const ProcessGroup & process_group, //in: chosen group of MPI processes
+                          const std::string & name,           //in: tensor name
+                          int root_process_rank);             //in: local rank of the writer process within the process group
+
+ /** Releases the MPI shared-memory window of a node-shared tensor replica after the tensor
+     has been destroyed (collective within the compute node). **/
+ bool freeSharedReplica(const std::string & name); //in: tensor name
+
 private:
 
+ /** Returns the interned identifier of a tensor name for the registry lookups
+     (NO_TENSOR_NAME_ID if the name has never been interned, thus not registered). **/
+ static inline TensorNameId lookupNameId(const std::string & name){
+  return TensorNameTable::find(name);
+ }
+
+ /** Returns the sorted names of all (or only composite) registered tensors. **/
+ std::vector<std::string> getSortedTensorNames(bool composite_only) const;
+
+ /** Parses a symbolic tensor addition or contraction, reusing the cached result if any.
+     Returns nullptr if the specification is invalid. **/
+ std::shared_ptr<const ParsedTensorOperation> parseTensorOperation(const std::string & specification, //in: symbolic specification
+                                                                   TensorOpCode opcode);                //in: ADD or CONTRACT
+
+ /** Parses a symbolic tensor addition or contraction and binds it to its tensor operands.
+     Returns FALSE if the specification is invalid. The returned handle is nullptr
+     if some tensor operand is not found (the current process does not participate). **/
+ bool prepareTensorOperation(const std::string & specification, //in: symbolic specification
+                             TensorOpCode opcode,                //in: ADD or CONTRACT
+                             TensorOperationHandle & handle);    //out: prepared tensor operation (or nullptr)
+
+ /** Executes a prepared tensor addition or contraction. **/
+ bool executeTensorOperation(const PreparedTensorOperation & prepared, //in: prepared tensor operation
+                             std::complex<double> alpha,               //in: alpha prefactor
+                             bool synchronous);                        //in: whether or not to synchronize on completion
+
+ /** Submits a block-sparse tensor contraction as a batch of dense tensor contractions of stored blocks. **/
+ bool submitBlockSparseContraction(const std::string & contraction, //in: symbolic tensor contraction specification
+                                   std::complex<double> alpha,      //in: alpha prefactor
+                                   bool synchronous);               //in: synchronous execution
+
+ /** Submits a tensor contraction with a structured input tensor without materializing it,
+     if possible. Otherwise, handled is returned FALSE and nothing is submitted. **/
+ bool submitStructuredContraction(std::shared_ptr<TensorOperation> operation, //in: tensor contraction
+                                  bool & handled);                            //out: whether or not the contraction has been submitted
+
+ /** Rescales the given tensors to a given 2-norm (fused norm computation). **/
+ bool balanceTensorNorms2Sync(const ProcessGroup & process_group,     //in: chosen group of MPI processes
+                              const std::vector<std::string> & names, //in: tensor names
+                              double norm);                           //in: desired 2-norm
+
  //Spaces:
  std::shared_ptr<numerics::SpaceRegister> space_register_; //register of vector spaces and their named subspaces
  std::unordered_map<std::string,SpaceId> subname2id_; //maps a subspace name to its parental vector space id
 
  //Tensors:
- std::unordered_map<std::string,std::shared_ptr<Tensor>> tensors_; //registered tensors (by CREATE operation)
+ TensorRegistry tensors_; //registered tensors (by CREATE operation), keyed by interned names
+ /** Key of a parsed symbolic tensor operation: {ADD|CONTRACT, specification} **/
+ using ParsedOperationKey = std::pair<TensorOpCode,std::string>;
+ struct ParsedOperationKeyHash{
+  std::size_t operator()(const ParsedOperationKey & key) const {
+   std::size_t seed = std::hash<std::string>()(key.second);
+   seed ^= static_cast<std::size_t>(key.first) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+   return seed;
+  }
+ };
+ ConcurrentRegistry<ParsedOperationKey,std::shared_ptr<const ParsedTensorOperation>,
+                    ParsedOperationKeyHash> parsed_operations_; //parsed symbolic tensor additions/contractions
  std::map<std::string,std::shared_ptr<Tensor>> implicit_tensors_; //tensors created implicitly by the runtime (for garbage collection)
- std::unordered_map<std::string,ProcessGroup> tensor_comms_; //process group associated with each tensor
+ ConcurrentRegistry<TensorNameId,ProcessGroup> tensor_comms_; //process group associated with each tensor, keyed by interned names
+ std::unordered_map<std::string,std::shared_ptr<TensorBlockSparse>> block_sparse_tensors_; //registered block-sparse tensors (their blocks are in tensors_)
+ std::unordered_map<std::string,std::shared_ptr<TensorStructured>> structured_tensors_; //registered structured tensors (not allocated)
+ mutable std::recursive_mutex tensor_mtx_; //guards implicit_tensors_, block_sparse_tensors_, structured_tensors_, transfer_tolerant_
+
+ //Cached process subgroups (for repeated parallel evaluation of tensor network expansions):
+ struct ProcessSubgroup {
+  ProcessGroup parent;                        //parent process group
+  unsigned int num_subgroups;                 //number of execution subgroups (defines the split)
+  int my_subgroup;                            //subgroup of the current process
+  std::shared_ptr<ProcessGroup> subgroup;     //process subgroup of the current process
+  std::shared_ptr<Tensor> local_accumulator;  //subgroup accumulator tensor (reused if congruent)
+ };
+ std::list<ProcessSubgroup> subgroups_; //cached process subgroups
+
+ //Cached compute node process subgroups (for the hierarchical output reduction):
+ struct NodeProcessGroups {
+  ProcessGroup parent;                    //parent process group
+  std::shared_ptr<ProcessGroup> node;     //process subgroup of the compute node of the current process
+  std::shared_ptr<ProcessGroup> leaders;  //process subgroup of the node leaders (only on node leaders)
+  std::vector<unsigned int> process_order; //node-major order of the local process ranks of the parent process group
+ };
+ std::list<NodeProcessGroups> node_groups_; //cached compute node process subgroups
+
+ /** Returns the compute node process subgroups of a given process group
+     (collective upon first request only, cached afterwards). **/
+ const NodeProcessGroups & getNodeProcessGroups(const ProcessGroup & process_group);
+
+ //Captured sequences of tensor operations (for replay):
+ struct CapturedOperation {
+  std::shared_ptr<TensorOperation> operation;    //captured tensor operation (clone)
+  bool implicit;                                 //CREATE only: TRUE if the created tensor is implicit (garbage-collected)
+  std::shared_ptr<ProcessGroup> process_group;   //CREATE only: non-default process group associated with the created tensor
+ };
+ std::unordered_map<std::string,std::vector<CapturedOperation>> captures_; //captured sequences of tensor operations
+ std::vector<CapturedOperation> * active_capture_; //active capture (if any)
+
+ //Submission:
+ std::recursive_mutex submit_mtx_; //serializes the bookkeeping of submitted tensor operations among client threads
+
+ //Precision policy:
+ TensorOpPrecision precision_policy_; //precision policy of submitted tensor operations (unless their own one is set)
+ double precision_tolerance_; //absolute error tolerance of the AUTO precision policy
+ std::unordered_set<std::string> transfer_tolerant_; //tensors tolerant to reduced-precision inter-process transfers
+
+ //SVD truncation mode:
+ bool svd_randomized_; //randomized truncated SVD in tensor decompositions
+ double svd_tolerance_; //singular values not exceeding the tolerance are discarded
 
 #ifdef CUQUANTUM
  //Tensor network execution handles:
  std::unordered_map<numerics::TensorHashType,runtime::TensorOpExecHandle> tn_exec_handles_;
+ //Automatic selection of the computational backend:
+ struct BackendMeasurement {
+  std::string key;                                   //tensor network key
+  runtime::BackendSelector::Backend backend;         //selected backend
+  runtime::BackendSelector::NetworkCost cost;        //tensor network cost
+  runtime::BackendSelector::Resources resources;     //available resources
+  double start_time;                                 //submission time stamp (sec)
+ };
+ runtime::BackendSelector backend_selector_; //backend selector of the "auto" backend
+ std::unordered_map<numerics::TensorHashType,BackendMeasurement> backend_measurements_; //output tensor hash --> measurement in progress
 #endif
 
  //Contraction path optimizer:
  std::string contr_seq_optimizer_; //tensor contraction sequence optimizer invoked when evaluating tensor networks
+ std::vector<std::string> contr_seq_portfolio_; //tensor contraction sequence optimizers run by processes other than 0 in the distributed search
  bool contr_seq_caching_; //regulates whether or not to cache pseudo-optimal tensor contraction orders for later reuse
+ bool contr_seq_slicing_; //regulates whether or not the tensor contraction sequence search accounts for tensor slicing
+ double contr_seq_time_budget_; //fixed wall-clock time budget of the anytime tensor contraction sequence search (sec)
+ double contr_seq_time_fraction_; //time budget of the anytime tensor contraction sequence search as a fraction of the contraction time
+ double contr_seq_time_; //total time spent in the tensor contraction sequence search since the runtime metrics reset (sec)
+ std::size_t contr_seq_count_; //number of tensor contraction sequence searches since the runtime metrics reset
+ ContractionSeqOptimizer::SearchTelemetry contr_seq_telemetry_; //telemetry of the last tensor contraction sequence search
+ ContractionSeqOptimizer::SearchTelemetry contr_seq_totals_; //search phases accumulated since the runtime metrics reset
+ std::shared_ptr<TensorOperation> last_submitted_op_; //last tensor operation submitted to the tensor runtime (delimits memory timeline windows)
+ bool intermediate_sharing_; //regulates whether or not shared intermediates are reused across the components of tensor network expansions
+ bool expansion_fusion_; //regulates whether or not the components of tensor network expansions accumulate directly into the accumulator
+ bool speculation_; //regulates whether or not iterative solvers speculatively submit the work of their next iteration
+ bool dynamic_slice_scheduling_; //regulates whether or not the sliced tensor sub-networks are dynamically scheduled across the processes
+ bool slice_double_buffering_; //regulates whether or not the input tensor slices of the next tensor sub-network are staged in advance
+ bool network_memoization_; //regulates whether or not the tensor network evaluations are memoized (l)
+ std::unordered_map<std::size_t,NetworkMemo> network_memos_; //memoized tensor network evaluations: structural hash --> memo
+ std::size_t network_memo_hits_; //number of tensor network evaluations skipped due to the memoization
+ bool hybrid_slice_execution_; //regulates whether or not the sliced tensor sub-networks are shared between Host and accelerators
+ double host_slice_share_; //calibrated Host share of the sliced tensor sub-networks in the hybrid execution
+ double host_slice_rate_; //measured Host throughput on the sliced tensor sub-networks (Flop/sec, 0 if not measured)
+ double accel_slice_rate_; //measured accelerator throughput on the sliced tensor sub-networks (Flop/sec, 0 if not measured)
+ OutputReduction output_reduction_; //reduction strategy of the partial output tensors computed by multiple processes
+ TensorMapping tensor_mapping_; //mapping of the subtensors of composite tensors to processes
+ std::uint64_t rnd_seed_; //seed of the random tensor initialization (same on all processes)
+ IsometrizeMethod isometrize_method_; //orthonormalization algorithm enforcing tensor isometries
+
+ //Dry run:
+ bool dry_run_; //whether or not the dry run is active (no actual computations)
+ ExecutionPlan exec_plan_; //execution plan predicted by the dry run
+
+ //Live runtime monitor:
+ RuntimeMonitor monitor_; //runtime monitor thread (for long-running jobs)
 
  //Registered external methods and data:
  std::map<std::string,std::shared_ptr<TensorMethod>> ext_methods_; //external tensor methods
  std::map<std::string,std::shared_ptr<BytePacket>> ext_data_; //external data
 
- //Program scopes:
- std::stack<std::pair<std::string,ScopeId>> scopes_; //TAProL scope stack: {Scope name, Scope Id}
+ //Node-shared tensor replicas:
+ struct SharedReplica{
+  ProcessGroup process_group;             //process group of the replica
+  std::shared_ptr<ProcessGroup> node;     //process subgroup of the compute node of the current process
+  std::shared_ptr<ProcessGroup> leaders;  //process subgroup of the node leaders (only on node leaders)
+  void * window;                          //MPI shared-memory window (owning pointer to MPI_Win)
+  void * body;                            //node-shared tensor body (non-owning)
+  std::size_t size;                       //size of the tensor body in bytes
+ };
+ std::map<std::string,SharedReplica> shared_replicas_; //node-shared tensor replicas: tensor name --> replica
+
+ //Client threads:
+ struct ClientContext{
+  std::stack<std::pair<std::string,ScopeId>> scopes; //TAProL scope stack: {Scope name, Scope Id}
+  bool batching = false; //whether or not simple tensor operations are currently being batched
+  std::vector<std::shared_ptr<TensorOperation>> op_batch; //batch of simple tensor operations pending submission to the tensor runtime
+  bool speculating = false; //whether or not submitted tensor operations are currently speculative
+  std::vector<std::shared_ptr<TensorOperation>> speculative_ops; //cancellable tensor operations of the active speculation
+ };
+ std::unordered_map<std::thread::id,ClientContext> clients_; //context of each client thread
+ std::mutex clients_mtx_; //guards clients_
+
+ /** Returns the context of the calling client thread (with the GLOBAL scope open on first use). **/
+ ClientContext & getClientContext();
 
  //Tensor operation factory:
  TensorOpFactory * tensor_op_factory_; //tensor operation factory (non-owning pointer)
@@ -1099,6 +2284,10 @@ private:
  int logging_; //logging level
  std::ofstream logfile_; //log file
  std::string comp_backend_; //current computational backend
+ ParamConf runtime_parameters_; //runtime configuration parameters of the tensor runtime
+ std::string graph_executor_name_; //DAG executor kind of the tensor runtime
+ std::string default_node_executor_name_; //DAG node executor kind of the default computational backend
+ std::string node_executor_name_; //current DAG node executor kind of the tensor runtime
  int num_processes_; //total number of parallel processes in the dedicated MPI communicator
  int process_rank_; //rank of the current parallel process in the dedicated MPI communicator
  int global_process_rank_; //rank of the current parallel process in MPI_COMM_WORLD
@@ -1106,10 +2295,26 @@ private:
  std::shared_ptr<TensorMapper> default_tensor_mapper_; //default composite tensor mapper (across all parallel processes)
  std::shared_ptr<ProcessGroup> process_world_; //default process group comprising all MPI processes and their communicator
  std::shared_ptr<ProcessGroup> process_self_;  //current process group comprising solely the current MPI process and its own communicator
+ std::shared_ptr<ProcessGroup> process_node_;  //node process group comprising all MPI processes on the same compute node
  std::shared_ptr<runtime::TensorRuntime> tensor_rt_; //tensor runtime (for actual execution of tensor operations)
- BytePacket byte_packet_; //byte packet for exchanging tensor meta-data
  double time_start_; //time stamp of the Numerical Server start
+ std::vector<std::pair<std::string,double>> startup_times_; //startup time breakdown: {startup stage, duration (sec)}
  bool validation_tracing_; //validation tracing flag (for debugging)
+
+ struct ValidationSample{
+  std::size_t op_index;                    //index of the checksummed tensor operation (in the order of submission)
+  int opcode;                              //tensor operation code
+  unsigned int operand;                    //output tensor operand position
+  std::string tensor_name;                 //output tensor name
+  std::shared_ptr<TensorMethod> functor;   //1-norm functor
+  std::shared_ptr<TensorOperation> op_sum; //checksum tensor operation (TRANSFORM)
+ };
+
+ double validation_fraction_;   //fraction of the sampled tensor operations (0.0: sampling validation off)
+ double validation_credit_;     //accumulated sampling credit (a tensor operation is sampled once it reaches 1.0)
+ std::size_t validation_count_; //number of tensor operations eligible for the sampling validation
+ std::list<ValidationSample> validation_samples_; //validation checksums in flight (in order of submission)
+ std::ofstream validation_file_; //validation stamp file
 };
 
 /** Numerical service singleton (numerical server) **/
@@ -1148,7 +2353,7 @@ bool NumServer::createTensor(const ProcessGroup & process_group,
   submitted = submit(op,getTensorMapper(process_group));
   if(submitted){
    if(!(process_group == getDefaultProcessGroup())){
-    auto saved = tensor_comms_.emplace(std::make_pair(name,process_group));
+    auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),process_group));
     assert(saved.second);
    }
   }
@@ -1173,7 +2378,7 @@ bool NumServer::createTensorSync(const ProcessGroup & process_group,
   submitted = submit(op,getTensorMapper(process_group));
   if(submitted){
    if(!(process_group == getDefaultProcessGroup())){
-    auto saved = tensor_comms_.emplace(std::make_pair(name,process_group));
+    auto saved = tensor_comms_.emplace(std::make_pair(TensorNameTable::intern(name),process_group));
     assert(saved.second);
    }
    submitted = sync(*op);
@@ -1209,6 +2414,19 @@ bool NumServer::createTensorSync(const ProcessGroup & process_group,
  return createTensorSync(process_group,makeSharedTensorComposite(split_dims,name,std::forward<Args>(args)...),element_type);
 }
 
+template <typename... Args>
+bool NumServer::createTensorBlockSparse(const std::string & name,
+                                        TensorElementType element_type,
+                                        const std::vector<std::vector<numerics::SymmetryRange>> & dim_sectors,
+                                        const std::vector<int> & dim_directions,
+                                        SymmetryId total_charge,
+                                        unsigned int modulus,
+                                        Args&&... args)
+{
+ return createTensorBlockSparse(std::make_shared<TensorBlockSparse>(dim_sectors,dim_directions,total_charge,modulus,
+                                                                    name,std::forward<Args>(args)...),element_type);
+}
+
 template<typename NumericType>
 bool NumServer::initTensor(const std::string & name,
                            NumericType value)
@@ -1225,11 +2443,24 @@ bool NumServer::initTensorSync(const std::string & name,
  return transformTensorSync(name,std::shared_ptr<TensorMethod>(new numerics::FunctorInitVal(value)));
 }
 
+template<typename NumericType>
+bool NumServer::initTensorBlockSparse(const std::string & name,
+                                      NumericType value)
+{
+ auto tensor = getTensorBlockSparse(name);
+ if(!tensor) return false;
+ bool success = true;
+ for(auto & block: *tensor){
+  success = initTensor(block.second->getName(),value); if(!success) break;
+ }
+ return success;
+}
+
 template<typename NumericType>
 bool NumServer::initTensorData(const std::string & name,
                                const std::vector<NumericType> & ext_data)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()) return false;
  return transformTensor(name,std::shared_ptr<TensorMethod>(
          new numerics::FunctorInitDat(iter->second->getShape(),ext_data)));
@@ -1239,12 +2470,48 @@ template<typename NumericType>
 bool NumServer::initTensorDataSync(const std::string & name,
                                    const std::vector<NumericType> & ext_data)
 {
- auto iter = tensors_.find(name);
+ auto iter = tensors_.find(lookupNameId(name));
  if(iter == tensors_.end()) return false;
  return transformTensorSync(name,std::shared_ptr<TensorMethod>(
          new numerics::FunctorInitDat(iter->second->getShape(),ext_data)));
 }
 
+template<typename NumericType>
+bool NumServer::initTensorBuffer(const std::string & name,
+                                 const NumericType * ext_buffer,
+                                 std::function<void ()> release)
+{
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return false;
+ if(ext_buffer == nullptr ||
+    reinterpret_cast<std::uintptr_t>(ext_buffer) % alignof(NumericType) != 0){
+  std::cout << "#ERROR(exatn::NumServer::initTensorBuffer): Invalid or misaligned external buffer for tensor "
+            << name << std::endl;
+  return false;
+ }
+ std::shared_ptr<void> guard(nullptr,[release](void *){if(release) release();});
+ return transformTensor(name,std::shared_ptr<TensorMethod>(
+         new numerics::FunctorInitBuf(iter->second->getShape(),ext_buffer,guard)));
+}
+
+template<typename NumericType>
+bool NumServer::initTensorBufferSync(const std::string & name,
+                                     const NumericType * ext_buffer,
+                                     std::function<void ()> release)
+{
+ auto iter = tensors_.find(lookupNameId(name));
+ if(iter == tensors_.end()) return false;
+ if(ext_buffer == nullptr ||
+    reinterpret_cast<std::uintptr_t>(ext_buffer) % alignof(NumericType) != 0){
+  std::cout << "#ERROR(exatn::NumServer::initTensorBufferSync): Invalid or misaligned external buffer for tensor "
+            << name << std::endl;
+  return false;
+ }
+ std::shared_ptr<void> guard(nullptr,[release](void *){if(release) release();});
+ return transformTensorSync(name,std::shared_ptr<TensorMethod>(
+         new numerics::FunctorInitBuf(iter->second->getShape(),ext_buffer,guard)));
+}
+
 template<typename NumericType>
 bool NumServer::scaleTensor(const std::string & name,
                             NumericType value)
@@ -1265,64 +2532,9 @@ template<typename NumericType>
 bool NumServer::addTensors(const std::string & addition,
                            NumericType alpha)
 {
- std::vector<std::string> tensors;
- auto parsed = parse_tensor_network(addition,tensors);
- if(parsed){
-  if(tensors.size() == 2){
-   std::string tensor_name, tensor0_name;
-   std::vector<IndexLabel> indices;
-   bool complex_conj0,complex_conj1;
-   parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
-   if(parsed){
-    assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
-    if(iter != tensors_.end()){
-     auto tensor0 = iter->second;
-     tensor0_name = tensor_name;
-     parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
-     if(parsed){
-      iter = tensors_.find(tensor_name);
-      if(iter != tensors_.end()){
-       auto tensor1 = iter->second;
-       const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName());
-       std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
-       op->setTensorOperand(tensor0,complex_conj0);
-       op->setTensorOperand(tensor1,complex_conj1);
-       op->setIndexPattern(addition);
-       op->setScalar(0,std::complex<double>(alpha));
-       parsed = submit(op,getTensorMapper(process_group));
-       if(parsed){
-        if(tensor0->hasIsometries()){
-         const auto & isometries = tensor0->retrieveIsometries();
-         parsed = transformTensor(tensor0_name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-        }
-       }
-      }else{
-       parsed = true;
-       //std::cout << "#ERROR(exatn::NumServer::addTensors): Tensor " << tensor_name << " not found in tensor addition: "
-       //          << addition << std::endl;
-      }
-     }else{
-      std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid argument#1 in tensor addition: "
-                << addition << std::endl;
-     }
-    }else{
-     parsed = true;
-     //std::cout << "#ERROR(exatn::NumServer::addTensors): Tensor " << tensor_name << " not found in tensor addition: "
-     //          << addition << std::endl;
-    }
-   }else{
-    std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid argument#0 in tensor addition: "
-              << addition << std::endl;
-   }
-  }else{
-   parsed = false;
-   std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid number of arguments in tensor addition: "
-             << addition << std::endl;
-  }
- }else{
-  std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid tensor addition: " << addition << std::endl;
- }
+ TensorOperationHandle handle;
+ auto parsed = prepareTensorOperation(addition,TensorOpCode::ADD,handle);
+ if(parsed && handle) parsed = executeTensorOperation(*handle,std::complex<double>(alpha),false);
  return parsed;
 }
 
@@ -1330,70 +2542,9 @@ template<typename NumericType>
 bool NumServer::addTensorsSync(const std::string & addition,
                                NumericType alpha)
 {
- std::vector<std::string> tensors;
- auto parsed = parse_tensor_network(addition,tensors);
- if(parsed){
-  if(tensors.size() == 2){
-   std::string tensor_name, tensor0_name;
-   std::vector<IndexLabel> indices;
-   bool complex_conj0,complex_conj1;
-   parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
-   if(parsed){
-    assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
-    if(iter != tensors_.end()){
-     auto tensor0 = iter->second;
-     tensor0_name = tensor_name;
-     parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
-     if(parsed){
-      iter = tensors_.find(tensor_name);
-      if(iter != tensors_.end()){
-       auto tensor1 = iter->second;
-       const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName());
-       std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::ADD);
-       op->setTensorOperand(tensor0,complex_conj0);
-       op->setTensorOperand(tensor1,complex_conj1);
-       op->setIndexPattern(addition);
-       op->setScalar(0,std::complex<double>(alpha));
-       parsed = submit(op,getTensorMapper(process_group));
-       if(parsed){
-        parsed = sync(*op);
-#ifdef MPI_ENABLED
-        if(parsed) parsed = sync(process_group);
-#endif
-        if(parsed){
-         if(tensor0->hasIsometries()){
-          const auto & isometries = tensor0->retrieveIsometries();
-          parsed = transformTensorSync(tensor0_name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-         }
-        }
-       }
-      }else{
-       parsed = true;
-       //std::cout << "#ERROR(exatn::NumServer::addTensors): Tensor " << tensor_name << " not found in tensor addition: "
-       //          << addition << std::endl;
-      }
-     }else{
-      std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid argument#1 in tensor addition: "
-                << addition << std::endl;
-     }
-    }else{
-     parsed = true;
-     //std::cout << "#ERROR(exatn::NumServer::addTensors): Tensor " << tensor_name << " not found in tensor addition: "
-     //          << addition << std::endl;
-    }
-   }else{
-    std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid argument#0 in tensor addition: "
-              << addition << std::endl;
-   }
-  }else{
-   parsed = false;
-   std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid number of arguments in tensor addition: "
-             << addition << std::endl;
-  }
- }else{
-  std::cout << "#ERROR(exatn::NumServer::addTensors): Invalid tensor addition: " << addition << std::endl;
- }
+ TensorOperationHandle handle;
+ auto parsed = prepareTensorOperation(addition,TensorOpCode::ADD,handle);
+ if(parsed && handle) parsed = executeTensorOperation(*handle,std::complex<double>(alpha),true);
  return parsed;
 }
 
@@ -1401,123 +2552,9 @@ template<typename NumericType>
 bool NumServer::contractTensors(const std::string & contraction,
                                 NumericType alpha)
 {
- std::vector<std::string> tensors;
- std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
- auto parsed = parse_tensor_contraction(contraction,tensors,left_inds,right_inds,contr_inds,hyper_inds);
- if(parsed){
-  if(tensors.size() == 3){
-   std::string tensor_name, tensor0_name;
-   std::vector<IndexLabel> indices;
-   bool complex_conj0,complex_conj1,complex_conj2;
-   parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
-   if(parsed){
-    assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
-    if(iter != tensors_.end()){
-     auto tensor0 = iter->second;
-     tensor0_name = tensor_name;
-     parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
-     if(parsed){
-      iter = tensors_.find(tensor_name);
-      if(iter != tensors_.end()){
-       auto tensor1 = iter->second;
-       parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
-       if(parsed){
-        iter = tensors_.find(tensor_name);
-        if(iter != tensors_.end()){
-         auto tensor2 = iter->second;
-         const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName(),tensor2->getName());
-         std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CONTRACT);
-         op->setTensorOperand(tensor0,complex_conj0);
-         op->setTensorOperand(tensor1,complex_conj1);
-         op->setTensorOperand(tensor2,complex_conj2);
-         op->setIndexPattern(contraction);
-         op->setScalar(0,std::complex<double>(alpha));
-         //Create temporary tensors with optimized distributed layout and copy tensor data:
-         bool redistribution = false;
-         std::dynamic_pointer_cast<numerics::TensorOpContract>(op)->
-          introduceOptTemporaries(process_group.getSize(),process_group.getMemoryLimitPerProcess(),left_inds,right_inds,contr_inds,hyper_inds);
-         auto tensor0a = op->getTensorOperand(0);
-         auto tensor1a = op->getTensorOperand(1);
-         auto tensor2a = op->getTensorOperand(2);
-         if(parsed && tensor0a != tensor0){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensors): New temporary for tensor operand 0" << std::endl; //debug
-          redistribution = true;
-          parsed = createTensorSync(tensor0a,tensor0->getElementType());
-          if(parsed) parsed = copyTensor(tensor0a->getName(),tensor0->getName());
-         }
-         if(parsed && tensor1a != tensor1){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensors): New temporary for tensor operand 1" << std::endl; //debug
-          redistribution = true;
-          parsed = createTensorSync(tensor1a,tensor1->getElementType());
-          if(parsed) parsed = copyTensor(tensor1a->getName(),tensor1->getName());
-         }
-         if(parsed && tensor2a != tensor2){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensors): New temporary for tensor operand 2" << std::endl; //debug
-          redistribution = true;
-          parsed = createTensorSync(tensor2a,tensor2->getElementType());
-          if(parsed) parsed = copyTensor(tensor2a->getName(),tensor2->getName());
-         }
-#ifdef MPI_ENABLED
-         if(parsed && redistribution) parsed = sync(process_group);
-#endif
-         //Submit tensor contraction for execution:
-         if(parsed) parsed = submit(op,getTensorMapper(process_group));
-         //Copy the result back:
-         if(parsed && tensor0a != tensor0){
-#ifdef MPI_ENABLED
-          if(redistribution) parsed = sync(process_group);
-#endif
-          if(parsed) parsed = copyTensor(tensor0->getName(),tensor0a->getName());
-         }
-         //Destroy temporary tensors:
-         if(parsed && tensor2a != tensor2) parsed = destroyTensor(tensor2a->getName());
-         if(parsed && tensor1a != tensor1) parsed = destroyTensor(tensor1a->getName());
-#ifdef MPI_ENABLED
-         if(parsed && redistribution) parsed = sync(process_group);
-#endif
-         if(parsed && tensor0a != tensor0) parsed = destroyTensor(tensor0a->getName());
-         if(parsed){
-          if(tensor0->hasIsometries()){
-           const auto & isometries = tensor0->retrieveIsometries();
-           parsed = transformTensor(tensor0_name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-          }
-         }
-        }else{
-         parsed = true;
-         //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-         //          << contraction << std::endl;
-        }
-       }else{
-        std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#2 in tensor contraction: "
-                  << contraction << std::endl;
-       }
-      }else{
-       parsed = true;
-       //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-       //          << contraction << std::endl;
-      }
-     }else{
-      std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#1 in tensor contraction: "
-                << contraction << std::endl;
-     }
-    }else{
-     parsed = true;
-     //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-     //          << contraction << std::endl;
-    }
-   }else{
-    std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#0 in tensor contraction: "
-              << contraction << std::endl;
-   }
-  }else{
-   parsed = false;
-   std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid number of arguments in tensor contraction: "
-             << contraction << std::endl;
-  }
- }else{
-  std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid tensor contraction: " << contraction << std::endl;
- }
+ TensorOperationHandle handle;
+ auto parsed = prepareTensorOperation(contraction,TensorOpCode::CONTRACT,handle);
+ if(parsed && handle) parsed = executeTensorOperation(*handle,std::complex<double>(alpha),false);
  return parsed;
 }
 
@@ -1525,120 +2562,42 @@ template<typename NumericType>
 bool NumServer::contractTensorsSync(const std::string & contraction,
                                     NumericType alpha)
 {
- std::vector<std::string> tensors;
- std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
- auto parsed = parse_tensor_contraction(contraction,tensors,left_inds,right_inds,contr_inds,hyper_inds);
- if(parsed){
-  if(tensors.size() == 3){
-   std::string tensor_name, tensor0_name;
-   std::vector<IndexLabel> indices;
-   bool complex_conj0,complex_conj1,complex_conj2;
-   parsed = parse_tensor(tensors[0],tensor_name,indices,complex_conj0);
-   if(parsed){
-    assert(!complex_conj0);
-    auto iter = tensors_.find(tensor_name);
-    if(iter != tensors_.end()){
-     auto tensor0 = iter->second;
-     tensor0_name = tensor_name;
-     parsed = parse_tensor(tensors[1],tensor_name,indices,complex_conj1);
-     if(parsed){
-      iter = tensors_.find(tensor_name);
-      if(iter != tensors_.end()){
-       auto tensor1 = iter->second;
-       parsed = parse_tensor(tensors[2],tensor_name,indices,complex_conj2);
-       if(parsed){
-        iter = tensors_.find(tensor_name);
-        if(iter != tensors_.end()){
-         auto tensor2 = iter->second;
-         const auto & process_group = getTensorProcessGroup(tensor0->getName(),tensor1->getName(),tensor2->getName());
-         std::shared_ptr<TensorOperation> op = tensor_op_factory_->createTensorOp(TensorOpCode::CONTRACT);
-         op->setTensorOperand(tensor0,complex_conj0);
-         op->setTensorOperand(tensor1,complex_conj1);
-         op->setTensorOperand(tensor2,complex_conj2);
-         op->setIndexPattern(contraction);
-         op->setScalar(0,std::complex<double>(alpha));
-         //Create temporary tensors with optimized distributed layout and copy tensor data:
-         std::dynamic_pointer_cast<numerics::TensorOpContract>(op)->
-          introduceOptTemporaries(process_group.getSize(),process_group.getMemoryLimitPerProcess(),left_inds,right_inds,contr_inds,hyper_inds);
-         auto tensor0a = op->getTensorOperand(0);
-         auto tensor1a = op->getTensorOperand(1);
-         auto tensor2a = op->getTensorOperand(2);
-         //std::cout << "#DEBUG: " << tensor0a->getName() << " " << tensor1a->getName() << " " << tensor2a->getName() << std::endl; //debug
-         if(parsed && tensor0a != tensor0){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensorsSync): New temporary for tensor operand 0" << std::endl; //debug
-          parsed = createTensorSync(tensor0a,tensor0->getElementType());
-          if(parsed) parsed = copyTensorSync(tensor0a->getName(),tensor0->getName());
-         }
-         if(parsed && tensor1a != tensor1){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensorsSync): New temporary for tensor operand 1" << std::endl; //debug
-          parsed = createTensorSync(tensor1a,tensor1->getElementType());
-          if(parsed) parsed = copyTensorSync(tensor1a->getName(),tensor1->getName());
-         }
-         if(parsed && tensor2a != tensor2){
-          //std::cout << "#DEBUG(exatn::NumServer::contractTensorsSync): New temporary for tensor operand 2" << std::endl; //debug
-          parsed = createTensorSync(tensor2a,tensor2->getElementType());
-          if(parsed) parsed = copyTensorSync(tensor2a->getName(),tensor2->getName());
-         }
-         //Submit tensor contraction for execution:
-         if(parsed){
-          parsed = submit(op,getTensorMapper(process_group));
-          if(parsed){
-           parsed = sync(*op);
-#ifdef MPI_ENABLED
-           if(parsed) parsed = sync(process_group);
-#endif
-          }
-         }
-         //Copy the result back:
-         if(parsed && tensor0a != tensor0) parsed = copyTensorSync(tensor0->getName(),tensor0a->getName());
-         //Destroy temporary tensors:
-         if(parsed && tensor2a != tensor2) parsed = destroyTensorSync(tensor2a->getName());
-         if(parsed && tensor1a != tensor1) parsed = destroyTensorSync(tensor1a->getName());
-         if(parsed && tensor0a != tensor0) parsed = destroyTensorSync(tensor0a->getName());
-         if(parsed){
-          if(tensor0->hasIsometries()){
-           const auto & isometries = tensor0->retrieveIsometries();
-           parsed = transformTensorSync(tensor0_name,std::shared_ptr<TensorMethod>(new numerics::FunctorIsometrize(*(isometries.cbegin()))));
-          }
-         }
-        }else{
-         parsed = true;
-         //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-         //          << contraction << std::endl;
-        }
-       }else{
-        std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#2 in tensor contraction: "
-                  << contraction << std::endl;
-       }
-      }else{
-       parsed = true;
-       //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-       //          << contraction << std::endl;
-      }
-     }else{
-      std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#1 in tensor contraction: "
-                << contraction << std::endl;
-     }
-    }else{
-     parsed = true;
-     //std::cout << "#ERROR(exatn::NumServer::contractTensors): Tensor " << tensor_name << " not found in tensor contraction: "
-     //          << contraction << std::endl;
-    }
-   }else{
-    std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid argument#0 in tensor contraction: "
-              << contraction << std::endl;
-   }
-  }else{
-   parsed = false;
-   std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid number of arguments in tensor contraction: "
-             << contraction << std::endl;
-  }
- }else{
-  std::cout << "#ERROR(exatn::NumServer::contractTensors): Invalid tensor contraction: " << contraction << std::endl;
- }
+ TensorOperationHandle handle;
+ auto parsed = prepareTensorOperation(contraction,TensorOpCode::CONTRACT,handle);
+ if(parsed && handle) parsed = executeTensorOperation(*handle,std::complex<double>(alpha),true);
  return parsed;
 }
 
+template<typename NumericType>
+bool NumServer::contractTensorsBlockSparse(const std::string & contraction,
+                                           NumericType alpha)
+{
+ return submitBlockSparseContraction(contraction,std::complex<double>(alpha),false);
+}
+
+template<typename NumericType>
+bool NumServer::contractTensorsBlockSparseSync(const std::string & contraction,
+                                               NumericType alpha)
+{
+ return submitBlockSparseContraction(contraction,std::complex<double>(alpha),true);
+}
+
+template<typename NumericType>
+bool NumServer::execute(const TensorOperationHandle & handle,
+                        NumericType alpha)
+{
+ assert(handle);
+ return executeTensorOperation(*handle,std::complex<double>(alpha),false);
+}
+
+template<typename NumericType>
+bool NumServer::executeSync(const TensorOperationHandle & handle,
+                            NumericType alpha)
+{
+ assert(handle);
+ return executeTensorOperation(*handle,std::complex<double>(alpha),true);
+}
+
 } //namespace exatn
 
 #endif //EXATN_NUM_SERVER_HPP_
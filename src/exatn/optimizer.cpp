@@ -1,14 +1,16 @@
 /** ExaTN:: Variational optimizer of a closed symmetric tensor network expansion functional
-REVISION: 2022/03/12
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "optimizer.hpp"
+#include "eigensolver.hpp"
 
 #include <talshxx.hpp>
 
 #include <unordered_set>
+#include <algorithm>
 #include <string>
 #include <iostream>
 
@@ -45,6 +47,7 @@ TensorNetworkOptimizer::TensorNetworkOptimizer(std::shared_ptr<TensorOperator> t
 #else
  parallel_(false),
 #endif
+ sweep_(DEFAULT_SWEEP_ENVIRONMENTS),
  average_expect_val_({0.0,0.0})
 {
  if(!vector_expansion_->isKet()){
@@ -148,7 +151,7 @@ bool TensorNetworkOptimizer::optimize(const ProcessGroup & process_group,
   success = normalizeNorm2Sync(*solution_vector,1.0); assert(success);
   eigenvectors_.emplace_back(solution_vector);
   for(auto ket_net = solution_vector->begin(); ket_net != solution_vector->end(); ++ket_net){
-   ket_net->network->markOptimizableNoTensors();
+   ket_net->getMutableNetwork()->markOptimizableNoTensors();
   }
   const auto num_legs = solution_vector->getRank();
   std::vector<std::pair<unsigned int, unsigned int>> ket_pairing(num_legs);
@@ -212,7 +215,7 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
  TensorExpansion operator_expectation(bra_vector_expansion,*vector_expansion_,*tensor_operator_);
  operator_expectation.rename("OperatorExpectation");
  for(auto net = operator_expectation.begin(); net != operator_expectation.end(); ++net){
-  net->network->rename("OperExpect" + std::to_string(std::distance(operator_expectation.begin(),net)));
+  net->getMutableNetwork()->rename("OperExpect" + std::to_string(std::distance(operator_expectation.begin(),net)));
  }
  if(TensorNetworkOptimizer::debug > 1){
   std::cout << "#DEBUG(exatn::TensorNetworkOptimizer): Operator expectation expansion:" << std::endl;
@@ -224,7 +227,7 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
  TensorExpansion metrics_expectation(bra_vector_expansion,*vector_expansion_);
  metrics_expectation.rename("MetricsExpectation");
  for(auto net = metrics_expectation.begin(); net != metrics_expectation.end(); ++net){
-  net->network->rename("MetrExpect" + std::to_string(std::distance(metrics_expectation.begin(),net)));
+  net->getMutableNetwork()->rename("MetrExpect" + std::to_string(std::distance(metrics_expectation.begin(),net)));
  }
  if(TensorNetworkOptimizer::debug > 1){
   std::cout << "#DEBUG(exatn::TensorNetworkOptimizer): Metrics expectation expansion:" << std::endl;
@@ -259,6 +262,9 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
                                             std::make_shared<Tensor>("_h"+tensor.getName(),  //auxiliary gradient tensor
                                                                      tensor.getShape(),
                                                                      tensor.getSignature()),
+                                            std::make_shared<Tensor>("_s"+tensor.getName(),  //auxiliary metrics gradient tensor
+                                                                     tensor.getShape(),
+                                                                     tensor.getSignature()),
                                             TensorExpansion(residual_expectation,tensor.getName(),true), // |operator|tensor> - |metrics|tensor>
                                             TensorExpansion(operator_expectation,tensor.getName(),true), // |operator|tensor>
                                             TensorExpansion(metrics_expectation,tensor.getName(),true),  // |metrics|tensor>
@@ -268,6 +274,30 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
    }
   }
  }
+
+ //Assign sweep sites to the optimizable tensors (in the order of their environments):
+ sweep_sites_.clear();
+ sweep_networks_.clear();
+ const bool sweep = sweep_ && (environments_.size() > 1);
+ if(sweep){
+  for(unsigned int site = 0; site < environments_.size(); ++site){
+   sweep_sites_[environments_[site].tensor->getName()] = site;
+   sweep_sites_[environments_[site].gradient->getName()] = site;
+  }
+  for(auto net = operator_expectation.cbegin(); net != operator_expectation.cend(); ++net) sweep_networks_.emplace_back(net->network);
+  for(auto net = metrics_expectation.cbegin(); net != metrics_expectation.cend(); ++net) sweep_networks_.emplace_back(net->network);
+ }
+ //Collapse isometric tensor pairs (canonical forms) into local contractions around the orthogonality center:
+ if(!sweep){ //sweeping relies on the original tensor network structure
+  operator_expectation.collapseIsometries();
+  metrics_expectation.collapseIsometries();
+  for(auto & environment: environments_){
+   environment.gradient_expansion.collapseIsometries();
+   environment.operator_gradient.collapseIsometries();
+   environment.metrics_gradient.collapseIsometries();
+   environment.hessian_expansion.collapseIsometries();
+  }
+ }
  if(TensorNetworkOptimizer::debug > 1){
   std::cout << "#DEBUG(exatn::TensorNetworkOptimizer): Derivatives:" << std::endl;
   for(const auto & environment: environments_){
@@ -295,6 +325,7 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
   //Iterate:
   unsigned int iteration = 0;
   while((!converged) && (iteration < max_iterations_)){
+   numericalServer->reportSolverIteration("TensorNetworkOptimizer",iteration);
    if(TensorNetworkOptimizer::debug > 0)
     std::cout << "#DEBUG(exatn::TensorNetworkOptimizer)["
               << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(numericalServer->getTimeStampStart())
@@ -302,26 +333,44 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
    converged = true;
    double max_convergence = 0.0;
    average_expect_val_ = std::complex<double>{0.0,0.0};
-   for(auto & environment: environments_){
+   if(sweep) buildRightEnvironments(process_group);
+   for(unsigned int site = 0; site < environments_.size(); ++site){
+    auto & environment = environments_[site];
+    //Replace the tensors of all other sweep sites by their environment blocks:
+    if(sweep) updateLeftEnvironments(process_group,site);
+    auto site_operator_expectation = makeSweepExpansion(operator_expectation,site);
+    auto site_metrics_expectation = makeSweepExpansion(metrics_expectation,site);
+    auto site_gradient_expansion = makeSweepExpansion(environment.gradient_expansion,site);
+    auto site_operator_gradient = makeSweepExpansion(environment.operator_gradient,site);
+    auto site_metrics_gradient = makeSweepExpansion(environment.metrics_gradient,site);
+    auto site_hessian_expansion = makeSweepExpansion(environment.hessian_expansion,site);
     //Create the gradient tensors:
     done = createTensorSync(environment.gradient,environment.tensor->getElementType()); assert(done);
     done = createTensorSync(environment.gradient_aux,environment.tensor->getElementType()); assert(done);
+    done = createTensorSync(environment.metrics_aux,environment.tensor->getElementType()); assert(done);
     //Microiterations:
     double local_convergence = 0.0;
     for(unsigned int micro_iteration = 0; micro_iteration < micro_iterations_; ++micro_iteration){
-     //Normalize the optimized tensor w.r.t. metrics:
+     //Normalize the optimized tensor w.r.t. metrics (unless already done by the previous micro-iteration):
      double tens_norm = 0.0;
-     if(!(environment.tensor->hasIsometries())){
-      done = initTensorSync("_scalar_norm",0.0); assert(done);
-      done = evaluateSync(process_group,metrics_expectation,scalar_norm,num_procs); assert(done);
-      tens_norm = 0.0;
-      done = computeNorm1Sync("_scalar_norm",tens_norm); assert(done);
+     if(!(environment.tensor->hasIsometries()) && (micro_iteration == 0 || !NORMALIZE_WITH_METRICS)){
+      done = initTensor("_scalar_norm",0.0); assert(done);
+      done = evaluate(process_group,site_metrics_expectation,scalar_norm,num_procs); assert(done);
+      tens_norm = computeNorm1Async("_scalar_norm").get(); assert(tens_norm >= 0.0);
       tens_norm = std::sqrt(tens_norm); //`Generalize for repeated tensors
-      done = scaleTensorSync(environment.tensor->getName(),1.0/tens_norm); assert(done);
+      done = scaleTensor(environment.tensor->getName(),1.0/tens_norm); assert(done);
      }
-     //Compute the operator expectation value w.r.t. the optimized tensor:
-     done = initTensorSync("_scalar_norm",0.0); assert(done);
-     done = evaluateSync(process_group,operator_expectation,scalar_norm,num_procs); assert(done);
+     //Submit the operator expectation value and the partial gradients w.r.t. the optimized tensor together:
+     done = initTensor("_scalar_norm",0.0); assert(done);
+     done = evaluate(process_group,site_operator_expectation,scalar_norm,num_procs); assert(done);
+     done = initTensor(environment.gradient_aux->getName(),0.0); assert(done);
+     done = evaluate(process_group,site_operator_gradient,environment.gradient_aux,num_procs); assert(done);
+     auto oper_norm_future = computeNorm2Async(environment.gradient_aux->getName());
+     done = initTensor(environment.metrics_aux->getName(),0.0); assert(done);
+     done = evaluate(process_group,site_metrics_gradient,environment.metrics_aux,num_procs); assert(done);
+     auto metr_norm_future = computeNorm2Async(environment.metrics_aux->getName());
+     //Retrieve the operator expectation value (the partial gradients are still being computed):
+     done = sync(process_group,*scalar_norm); assert(done);
      std::complex<double> expect_val{0.0,0.0};
      switch(scalar_norm->getElementType()){
       case TensorElementType::REAL32:
@@ -342,38 +391,44 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
      if(micro_iteration == (micro_iterations_ - 1)) average_expect_val_ += expect_val;
      if(TensorNetworkOptimizer::debug > 1) std::cout << " Operator expectation value w.r.t. " << environment.tensor->getName()
                                                      << " = " << std::scientific << expect_val << std::endl;
-     //Update the expectation value in the gradient expansion:
+     //Update the expectation value in the gradient and hessian expansions:
      if(TensorNetworkOptimizer::debug > 2){
       std::cout << " Old gradient expansion coefficients:\n";
       environment.gradient_expansion.printCoefficients();
      }
      scale_metrics(environment.gradient_expansion,environment.expect_value,expect_val);
+     scale_metrics(site_gradient_expansion,environment.expect_value,expect_val);
      if(TensorNetworkOptimizer::debug > 2){
       std::cout << " New gradient expansion coefficients:\n";
       environment.gradient_expansion.printCoefficients();
      }
-     //Initialize the gradient tensor to zero:
-     done = initTensorSync(environment.gradient->getName(),0.0); assert(done);
-     //Evaluate the gradient tensor expansion:
-     done = evaluateSync(process_group,environment.gradient_expansion,environment.gradient,num_procs); assert(done);
+     if(TensorNetworkOptimizer::debug > 2){
+      std::cout << " Old hessian expansion coefficients:\n";
+      environment.hessian_expansion.printCoefficients();
+     }
+     scale_metrics(environment.hessian_expansion,environment.expect_value,expect_val);
+     scale_metrics(site_hessian_expansion,environment.expect_value,expect_val);
+     if(TensorNetworkOptimizer::debug > 2){
+      std::cout << " New hessian expansion coefficients:\n";
+      environment.hessian_expansion.printCoefficients();
+     }
+     //Submit the gradient tensor expansion, its norm, and the hessian-gradient expansion together:
+     done = initTensor(environment.gradient->getName(),0.0); assert(done);
+     done = evaluate(process_group,site_gradient_expansion,environment.gradient,num_procs); assert(done);
+     auto grad_norm_future = computeNorm2Async(environment.gradient->getName());
+     done = initTensor("_scalar_norm",0.0); assert(done);
+     done = evaluate(process_group,site_hessian_expansion,scalar_norm,num_procs); assert(done);
      //Compute the norm of the gradient tensor:
-     double grad_norm = 0.0;
-     done = computeNorm2Sync(environment.gradient->getName(),grad_norm); assert(done);
+     double grad_norm = grad_norm_future.get(); assert(grad_norm >= 0.0);
      if(TensorNetworkOptimizer::debug > 1) std::cout << " Gradient norm w.r.t. " << environment.tensor->getName()
                                                      << " = " << grad_norm << std::endl;
      //Compute the convergence criterion:
      double denom = 0.0;
-     done = initTensorSync(environment.gradient_aux->getName(),0.0); assert(done);
-     done = evaluateSync(process_group,environment.operator_gradient,environment.gradient_aux,num_procs); assert(done);
-     tens_norm = 0.0;
-     done = computeNorm2Sync(environment.gradient_aux->getName(),tens_norm); assert(done);
+     tens_norm = oper_norm_future.get(); assert(tens_norm >= 0.0);
      if(TensorNetworkOptimizer::debug > 1) std::cout << environment.tensor->getName()
                                                      << ": |H|x> 2-norm = " << tens_norm;
      denom += tens_norm;
-     done = initTensorSync(environment.gradient_aux->getName(),0.0); assert(done);
-     done = evaluateSync(process_group,environment.metrics_gradient,environment.gradient_aux,num_procs); assert(done);
-     tens_norm = 0.0;
-     done = computeNorm2Sync(environment.gradient_aux->getName(),tens_norm); assert(done);
+     tens_norm = metr_norm_future.get(); assert(tens_norm >= 0.0);
      if(TensorNetworkOptimizer::debug > 1) std::cout << "; |S|x> 2-norm = " << tens_norm
                                                      << "; Absolute eigenvalue = " << std::abs(expect_val) << std::endl;
      denom += std::abs(expect_val) * tens_norm;
@@ -385,17 +440,7 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
       if(micro_iteration == (micro_iterations_ - 1)) converged = false;
      }
      //Compute the optimal step size:
-     if(TensorNetworkOptimizer::debug > 2){
-      std::cout << " Old hessian expansion coefficients:\n";
-      environment.hessian_expansion.printCoefficients();
-     }
-     scale_metrics(environment.hessian_expansion,environment.expect_value,expect_val);
-     if(TensorNetworkOptimizer::debug > 2){
-      std::cout << " New hessian expansion coefficients:\n";
-      environment.hessian_expansion.printCoefficients();
-     }
-     done = initTensorSync("_scalar_norm",0.0); assert(done);
-     done = evaluateSync(process_group,environment.hessian_expansion,scalar_norm,num_procs); assert(done);
+     done = sync(process_group,*scalar_norm); assert(done);
      denom = 0.0;
      switch(scalar_norm->getElementType()){
       case TensorElementType::REAL32:
@@ -429,25 +474,23 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
      std::string add_pattern;
      done = generate_addition_pattern(environment.tensor->getRank(),add_pattern,false,
                                       environment.tensor->getName(),environment.gradient->getName()); assert(done);
-     done = addTensorsSync(add_pattern,-epsilon_); assert(done);
+     done = addTensors(add_pattern,-epsilon_); assert(done);
      if(!(environment.tensor->hasIsometries())){
       if(NORMALIZE_WITH_METRICS){
        //Normalize the optimized tensor w.r.t. metrics:
-       done = initTensorSync("_scalar_norm",0.0); assert(done);
-       done = evaluateSync(process_group,metrics_expectation,scalar_norm,num_procs); assert(done);
-       tens_norm = 0.0;
-       done = computeNorm1Sync("_scalar_norm",tens_norm); assert(done);
+       done = initTensor("_scalar_norm",0.0); assert(done);
+       done = evaluate(process_group,site_metrics_expectation,scalar_norm,num_procs); assert(done);
+       tens_norm = computeNorm1Async("_scalar_norm").get(); assert(tens_norm >= 0.0);
        tens_norm = std::sqrt(tens_norm); //`Generalize for repeated tensors
        if(TensorNetworkOptimizer::debug > 1) std::cout << " Metrical tensor norm before normalization = "
                                                        << tens_norm << std::endl;
-       done = scaleTensorSync(environment.tensor->getName(),1.0/tens_norm); assert(done);
+       done = scaleTensor(environment.tensor->getName(),1.0/tens_norm); assert(done);
       }else{
        //Normalize the optimized tensor with unity metrics:
-       tens_norm = 0.0;
-       done = computeNorm2Sync(environment.tensor->getName(),tens_norm); assert(done);
+       tens_norm = computeNorm2Async(environment.tensor->getName()).get(); assert(tens_norm >= 0.0);
        if(TensorNetworkOptimizer::debug > 1) std::cout << " Regular tensor norm before normalization = "
                                                        << tens_norm << std::endl;
-       done = scaleTensorSync(environment.tensor->getName(),1.0/tens_norm); assert(done);
+       done = scaleTensor(environment.tensor->getName(),1.0/tens_norm); assert(done);
       }
      }
      //Update the old expectation value:
@@ -457,9 +500,11 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
     //Update the convergence residual:
     max_convergence = std::max(max_convergence,local_convergence);
     //Destroy the gradient tensors:
+    done = destroyTensorSync(environment.metrics_aux->getName()); assert(done);
     done = destroyTensorSync(environment.gradient_aux->getName()); assert(done);
     done = destroyTensorSync(environment.gradient->getName()); assert(done);
    }
+   if(sweep) destroyEnvironments();
    average_expect_val_ /= static_cast<double>(environments_.size());
    if(TensorNetworkOptimizer::debug > 0){
     std::cout << "Average expectation value = " << average_expect_val_
@@ -478,6 +523,169 @@ bool TensorNetworkOptimizer::optimize_sd(const ProcessGroup & process_group)
 }
 
 
+int TensorNetworkOptimizer::getSweepSite(const TensorNetwork & network,
+                                         unsigned int tensor_id) const
+{
+ auto iter = sweep_sites_.find(network.getTensor(tensor_id)->getName());
+ if(iter != sweep_sites_.cend()) return iter->second;
+ //Non-optimizable tensors belong to the lowest sweep site adjacent to them:
+ int site = -1;
+ const auto * legs = network.getTensorConnections(tensor_id);
+ assert(legs != nullptr);
+ for(const auto & leg: *legs){
+  const auto other_tensor_id = leg.getTensorId();
+  if(other_tensor_id != 0){
+   iter = sweep_sites_.find(network.getTensor(other_tensor_id)->getName());
+   if(iter != sweep_sites_.cend()){
+    if(site < 0 || static_cast<int>(iter->second) < site) site = iter->second;
+   }
+  }
+ }
+ return site;
+}
+
+
+std::vector<unsigned int> TensorNetworkOptimizer::getSweepSiteTensors(const TensorNetwork & network,
+                                                                      unsigned int first_site,
+                                                                      unsigned int last_site) const
+{
+ std::vector<unsigned int> tensor_ids;
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  if(iter->first != 0){
+   const int site = getSweepSite(network,iter->first);
+   if(site >= static_cast<int>(first_site) && site < static_cast<int>(last_site)) tensor_ids.emplace_back(iter->first);
+  }
+ }
+ std::sort(tensor_ids.begin(),tensor_ids.end());
+ return tensor_ids;
+}
+
+
+TensorNetworkOptimizer::EnvironmentBlock TensorNetworkOptimizer::extendEnvironmentBlock(const ProcessGroup & process_group,
+                                                                                       TensorNetwork & network,
+                                                                                       const EnvironmentBlock & block,
+                                                                                       const std::vector<unsigned int> & tensor_ids,
+                                                                                       const std::string & block_name)
+{
+ if(tensor_ids.empty()) return EnvironmentBlock{};
+ if(tensor_ids == block.tensor_ids) return block;
+ //Extract the tensor sub-network forming the environment block:
+ auto subnetwork = std::make_shared<TensorNetwork>(network.getName() + "_Env",network,tensor_ids);
+ const auto * out_tens_conn = subnetwork->getTensorConn(0);
+ assert(out_tens_conn != nullptr);
+ EnvironmentBlock new_block{tensor_ids,{},
+                            std::make_shared<Tensor>(block_name,out_tens_conn->getTensor()->getShape(),
+                                                                out_tens_conn->getTensor()->getSignature())};
+ for(const auto & leg: out_tens_conn->getTensorLegs()){
+  new_block.leg_origins.emplace_back(std::make_pair(leg.getTensorId(),leg.getDimensionId()));
+ }
+ //Reuse the previous environment block inside the sub-network:
+ bool success = true;
+ if(block.tensor){
+  success = subnetwork->replaceTensors(block.tensor_ids,subnetwork->getMaxTensorId() + 1,
+                                       block.tensor,block.leg_origins); assert(success);
+ }
+ //Evaluate the new environment block:
+ TensorExpansion block_expansion(block_name);
+ success = block_expansion.appendComponent(subnetwork,{1.0,0.0}); assert(success);
+ success = createTensorSync(new_block.tensor,network.getTensorElementType()); assert(success);
+ success = initTensorSync(block_name,0.0); assert(success);
+ success = evaluateSync(process_group,block_expansion,new_block.tensor); assert(success);
+ return new_block;
+}
+
+
+void TensorNetworkOptimizer::buildRightEnvironments(const ProcessGroup & process_group)
+{
+ const unsigned int num_sites = environments_.size();
+ for(auto & network: sweep_networks_){
+  auto & blocks = right_blocks_[network->getName()];
+  blocks.assign(num_sites,EnvironmentBlock{});
+  for(int site = static_cast<int>(num_sites) - 2; site >= 0; --site){
+   blocks[site] = extendEnvironmentBlock(process_group,*network,blocks[site+1],
+                                         getSweepSiteTensors(*network,site+1,num_sites),
+                                         "_r" + network->getName() + "_" + std::to_string(site));
+  }
+ }
+ return;
+}
+
+
+void TensorNetworkOptimizer::updateLeftEnvironments(const ProcessGroup & process_group,
+                                                    unsigned int site)
+{
+ for(auto & network: sweep_networks_){
+  auto & block = left_blocks_[network->getName()];
+  auto new_block = extendEnvironmentBlock(process_group,*network,block,
+                                          getSweepSiteTensors(*network,0,site),
+                                          "_l" + network->getName() + "_" + std::to_string(site));
+  if(block.tensor && block.tensor != new_block.tensor){
+   bool success = destroyTensorSync(block.tensor->getName()); assert(success);
+  }
+  block = new_block;
+ }
+ return;
+}
+
+
+void TensorNetworkOptimizer::destroyEnvironments()
+{
+ std::unordered_set<std::string> block_names;
+ for(auto & block: left_blocks_){
+  if(block.second.tensor) block_names.emplace(block.second.tensor->getName());
+ }
+ for(auto & blocks: right_blocks_){
+  for(auto & block: blocks.second){
+   if(block.tensor) block_names.emplace(block.tensor->getName());
+  }
+ }
+ for(const auto & block_name: block_names){
+  bool success = destroyTensorSync(block_name); assert(success);
+ }
+ left_blocks_.clear();
+ right_blocks_.clear();
+ return;
+}
+
+
+TensorExpansion TensorNetworkOptimizer::makeSweepExpansion(const TensorExpansion & expansion,
+                                                           unsigned int site) const
+{
+ TensorExpansion sweep_expansion(expansion,false);
+ if(sweep_sites_.empty()) return sweep_expansion;
+ const unsigned int num_sites = environments_.size();
+ for(auto component = sweep_expansion.begin(); component != sweep_expansion.end(); ++component){
+  //Derived tensor networks retain the name of their base tensor network as a prefix:
+  const auto & name = component->network->getName();
+  const auto base_name = name.substr(0,name.find_first_of("/-"));
+  auto left = left_blocks_.find(base_name);
+  auto right = right_blocks_.find(base_name);
+  if(left != left_blocks_.cend() && right != right_blocks_.cend()){
+   const auto & left_block = left->second;
+   const auto & right_block = right->second[site];
+   const auto left_ids = getSweepSiteTensors(*(component->network),0,site);
+   const auto right_ids = getSweepSiteTensors(*(component->network),site+1,num_sites);
+   //Substitute an environment block only if it consists of exactly the same tensors:
+   bool left_match = (left_block.tensor && left_ids == left_block.tensor_ids);
+   bool right_match = (right_block.tensor && right_ids == right_block.tensor_ids);
+   if(left_match || right_match){
+    auto network = component->getMutableNetwork();
+    bool success = true;
+    if(left_match){
+     success = network->replaceTensors(left_block.tensor_ids,network->getMaxTensorId() + 1,
+                                       left_block.tensor,left_block.leg_origins); assert(success);
+    }
+    if(right_match){
+     success = network->replaceTensors(right_block.tensor_ids,network->getMaxTensorId() + 1,
+                                       right_block.tensor,right_block.leg_origins); assert(success);
+    }
+   }
+  }
+ }
+ return sweep_expansion;
+}
+
+
 void TensorNetworkOptimizer::computeInitialGuess(const ProcessGroup & process_group,
                                                  bool highest,
                                                  unsigned int guess_dim)
@@ -500,7 +708,6 @@ void TensorNetworkOptimizer::computeInitialGuess(const ProcessGroup & process_gr
  const auto elem_type = vector_expansion_->cbegin()->network->getTensorElementType();
  assert(elem_type != TensorElementType::VOID);
  std::vector<std::shared_ptr<TensorExpansion>> basis_ket(guess_dim);
- std::vector<std::shared_ptr<TensorExpansion>> basis_bra(guess_dim);
  success = exatn::sync(process_group); assert(success);
  for(unsigned int i = 0; i < guess_dim; ++i){
   basis_ket[i] = makeSharedTensorExpansion("_BasisVector"+std::to_string(i));
@@ -513,72 +720,14 @@ void TensorNetworkOptimizer::computeInitialGuess(const ProcessGroup & process_gr
  //Normalize the non-orthogonal tensor network basis:
  for(unsigned int i = 0; i < guess_dim; ++i){
   success = normalizeNorm2Sync(process_group,*(basis_ket[i]),1.0); assert(success);
-  basis_bra[i] = makeSharedTensorExpansion(*(basis_ket[i]));
-  basis_bra[i]->conjugate();
-  basis_bra[i]->rename("_ConjBasisVector"+std::to_string(i));
  }
  success = exatn::sync(process_group); assert(success);
- //Build the operator matrix:
+ //Build the operator and metric matrices (all matrix elements are evaluated as a single fused expansion):
  std::vector<std::complex<double>> oper_matrix(guess_dim*guess_dim);
- std::vector<std::shared_ptr<Tensor>> oper_scalar(guess_dim*guess_dim);
- std::vector<std::shared_ptr<TensorExpansion>> oper_elems(guess_dim*guess_dim);
- for(unsigned int j = 0; j < guess_dim; ++j){
-  for(unsigned int i = 0; i < guess_dim; ++i){
-   oper_elems[j*guess_dim + i] = makeSharedTensorExpansion(*(basis_ket[j]),*(basis_bra[i]),*tensor_operator_);
-   oper_scalar[j*guess_dim + i] = makeSharedTensor("_");
-   oper_scalar[j*guess_dim + i]->rename("_OperScalarElem_"+std::to_string(i)+"_"+std::to_string(j));
-   success = exatn::createTensor(process_group,oper_scalar[j*guess_dim + i],elem_type); assert(success);
-   success = exatn::initTensor(oper_scalar[j*guess_dim + i]->getName(),0.0); assert(success);
-   success = exatn::evaluate(process_group,*(oper_elems[j*guess_dim + i]),oper_scalar[j*guess_dim + i],num_procs); assert(success);
-  }
- }
- //Build the metric matrix:
  std::vector<std::complex<double>> metr_matrix(guess_dim*guess_dim);
- std::vector<std::shared_ptr<Tensor>> metr_scalar(guess_dim*guess_dim);
- std::vector<std::shared_ptr<TensorExpansion>> metr_elems(guess_dim*guess_dim);
- for(unsigned int j = 0; j < guess_dim; ++j){
-  for(unsigned int i = 0; i < guess_dim; ++i){
-   metr_elems[j*guess_dim + i] = makeSharedTensorExpansion(*(basis_ket[j]),*(basis_bra[i]));
-   metr_scalar[j*guess_dim + i] = makeSharedTensor("_");
-   metr_scalar[j*guess_dim + i]->rename("_MetrScalarElem_"+std::to_string(i)+"_"+std::to_string(j));
-   success = exatn::createTensor(process_group,metr_scalar[j*guess_dim + i],elem_type); assert(success);
-   success = exatn::initTensor(metr_scalar[j*guess_dim + i]->getName(),0.0); assert(success);
-   success = exatn::evaluate(process_group,*(metr_elems[j*guess_dim + i]),metr_scalar[j*guess_dim + i],num_procs); assert(success);
-  }
- }
- success = exatn::sync(process_group); assert(success);
- for(unsigned int j = 0; j < guess_dim; ++j){
-  for(unsigned int i = 0; i < guess_dim; ++i){
-   const auto & oper_name = oper_scalar[j*guess_dim + i]->getName();
-   const auto & metr_name = metr_scalar[j*guess_dim + i]->getName();
-   switch(elem_type){
-    case TensorElementType::REAL32:
-     oper_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(oper_name)->getSliceView<float>()[std::initializer_list<int>{}], 0.0);
-     metr_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(metr_name)->getSliceView<float>()[std::initializer_list<int>{}], 0.0);
-     break;
-    case TensorElementType::REAL64:
-     oper_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(oper_name)->getSliceView<double>()[std::initializer_list<int>{}], 0.0);
-     metr_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(metr_name)->getSliceView<double>()[std::initializer_list<int>{}], 0.0);
-     break;
-    case TensorElementType::COMPLEX32:
-     oper_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(oper_name)->getSliceView<std::complex<float>>()[std::initializer_list<int>{}]);
-     metr_matrix[j*guess_dim + i] = std::complex<double>(
-      exatn::getLocalTensor(metr_name)->getSliceView<std::complex<float>>()[std::initializer_list<int>{}]);
-     break;
-    case TensorElementType::COMPLEX64:
-     oper_matrix[j*guess_dim + i] = exatn::getLocalTensor(oper_name)->getSliceView<std::complex<double>>()[std::initializer_list<int>{}];
-     metr_matrix[j*guess_dim + i] = exatn::getLocalTensor(metr_name)->getSliceView<std::complex<double>>()[std::initializer_list<int>{}];
-     break;
-    default:
-     assert(false);
-   }
-  }
- }
+ success = TensorNetworkEigenSolver::computeProjectedMatrices(process_group,*tensor_operator_,basis_ket,basis_ket, //bras are conjugated lazily
+                                                              oper_matrix,metr_matrix,std::vector<bool>{},num_procs);
+ assert(success);
  //Print matrices (debug):
  if(TensorNetworkOptimizer::debug > 0){
   std::cout << "#DEBUG(exatn::TensorNetworkOptimizer::computeInitialGuess): Operator matrix:\n" << std::scientific;
@@ -669,10 +818,6 @@ void TensorNetworkOptimizer::computeInitialGuess(const ProcessGroup & process_gr
  //Destroy temporaries:
  for(unsigned int j = 0; j < guess_dim; ++j){
   success = exatn::destroyTensors(*(basis_ket[j]->begin()->network)); assert(success);
-  for(unsigned int i = 0; i < guess_dim; ++i){
-   success = exatn::destroyTensor(oper_scalar[j*guess_dim + i]->getName()); assert(success);
-   success = exatn::destroyTensor(metr_scalar[j*guess_dim + i]->getName()); assert(success);
-  }
  }
  success = exatn::sync(process_group); assert(success);
  return;
@@ -686,6 +831,13 @@ void TensorNetworkOptimizer::enableParallelization(bool parallel)
 }
 
 
+void TensorNetworkOptimizer::enableSweepEnvironments(bool sweep)
+{
+ sweep_ = sweep;
+ return;
+}
+
+
 void TensorNetworkOptimizer::resetDebugLevel(unsigned int level, int focus_process)
 {
  TensorNetworkOptimizer::debug = level;
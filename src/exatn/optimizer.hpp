@@ -1,5 +1,5 @@
 /** ExaTN:: Variational optimizer of a closed symmetric tensor network expansion functional
-REVISION: 2022/03/12
+REVISION: 2022/03/26
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -24,6 +24,20 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
        |x_(i+1)> = |x_i> + t*|r_i>
       end for
      end for
+ (C) Sweep environments (DMRG-style): Each optimizable tensor defines a sweep site,
+     together with the non-optimizable tensors adjacent to it (e.g., operator tensors).
+     The sweep sites are visited in order and, while a site is being optimized,
+     the tensors of all preceding (left) and all following (right) sweep sites
+     are replaced in every tensor network by their cached contracted products
+     (left/right environment blocks). The right environment blocks are built once
+     per sweep, from the last site backwards, whereas the left environment block
+     is extended by one site after each site update, thus making the cost
+     of a sweep linear in the number of sweep sites (e.g., MPS, TTN).
+ (D) Each micro-iteration is pipelined: The expectation value and both partial gradients,
+     H|x> and S|x>, are submitted together, followed by the gradient and hessian-gradient
+     expansions, whereas their scalar results (expectation values, norms) are only retrieved
+     via futures once all of them are in flight. The updates of different optimized tensors
+     remain sequential since each one depends on the previously updated tensors.
 **/
 
 #ifndef EXATN_OPTIMIZER_HPP_
@@ -32,6 +46,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "exatn_numerics.hpp"
 #include "reconstructor.hpp"
 
+#include <unordered_map>
 #include <vector>
 #include <complex>
 
@@ -54,6 +69,7 @@ public:
  static constexpr const unsigned int DEFAULT_KRYLOV_GUESS_DIM = 8;
  static constexpr const unsigned int DEFAULT_GUESS_MAX_BOND_DIM = DEFAULT_KRYLOV_GUESS_DIM;
  static constexpr const double DEFAULT_GUESS_TOLERANCE = 1e-3;
+ static constexpr const bool DEFAULT_SWEEP_ENVIRONMENTS = false;
 
  TensorNetworkOptimizer(std::shared_ptr<TensorOperator> tensor_operator,   //in: hermitian tensor network operator
                         std::shared_ptr<TensorExpansion> vector_expansion, //inout: tensor network expansion forming the bra/ket vectors
@@ -107,6 +123,9 @@ public:
  /** Enables/disables coarse-grain parallelization over tensor networks. **/
  void enableParallelization(bool parallel = true);
 
+ /** Enables/disables the cached left/right environments in the sweep order. **/
+ void enableSweepEnvironments(bool sweep = true);
+
  static void resetDebugLevel(unsigned int level = 0,  //in: debug level
                              int focus_process = -1); //in: process to focus on (-1: all)
 
@@ -122,10 +141,48 @@ protected:
 
 private:
 
+ //Cached contracted product of some input tensors of a tensor network (environment block):
+ struct EnvironmentBlock{
+  std::vector<unsigned int> tensor_ids;                           //ids of the contracted input tensors (sorted)
+  std::vector<std::pair<unsigned int, unsigned int>> leg_origins; //origin {tensor id, mode} of each mode of the block tensor
+  std::shared_ptr<Tensor> tensor;                                  //block tensor
+ };
+
+ //Returns the sweep site an input tensor of a tensor network belongs to (-1: none):
+ int getSweepSite(const TensorNetwork & network,
+                  unsigned int tensor_id) const;
+
+ //Returns the sorted ids of the input tensors of a tensor network belonging to sweep sites [first_site:last_site):
+ std::vector<unsigned int> getSweepSiteTensors(const TensorNetwork & network,
+                                               unsigned int first_site,
+                                               unsigned int last_site) const;
+
+ //Computes the environment block for the given input tensors of a tensor network by extending a previous block:
+ EnvironmentBlock extendEnvironmentBlock(const ProcessGroup & process_group,
+                                         TensorNetwork & network,
+                                         const EnvironmentBlock & block,
+                                         const std::vector<unsigned int> & tensor_ids,
+                                         const std::string & block_name);
+
+ //Builds the right environment blocks for all sweep sites:
+ void buildRightEnvironments(const ProcessGroup & process_group);
+
+ //Extends the left environment blocks up to the given sweep site:
+ void updateLeftEnvironments(const ProcessGroup & process_group,
+                             unsigned int site);
+
+ //Destroys all environment blocks:
+ void destroyEnvironments();
+
+ //Returns a copy of a tensor network expansion with the tensors of all other sweep sites replaced by environment blocks:
+ TensorExpansion makeSweepExpansion(const TensorExpansion & expansion,
+                                    unsigned int site) const;
+
  struct Environment{
   std::shared_ptr<Tensor> tensor;       //tensor being optimized: x
   std::shared_ptr<Tensor> gradient;     //gradient w.r.t. the tensor being optimized: g
-  std::shared_ptr<Tensor> gradient_aux; //partial gradient tensor (intermediate)
+  std::shared_ptr<Tensor> gradient_aux; //partial operator gradient tensor (intermediate): H|x>
+  std::shared_ptr<Tensor> metrics_aux;  //partial metrics gradient tensor (intermediate): S|x>
   TensorExpansion gradient_expansion;   //gradient tensor network expansion: H|x> - E*S|x> = g
   TensorExpansion operator_gradient;    //operator gradient tensor network expansion: H|x>
   TensorExpansion metrics_gradient;     //metrics gradient tensor network expansion: S|x>
@@ -143,10 +200,16 @@ private:
  double epsilon_;                                    //learning rate for the gradient descent based tensor update
  double tolerance_;                                  //numerical convergence tolerance (for the gradient)
  bool parallel_;                                     //enables/disables coarse-grain parallelization over tensor networks
+ bool sweep_;                                        //enables/disables cached left/right environments in the sweep order
 
  std::complex<double> average_expect_val_;           //average expectation value (across all optimized tensor factors)
 
  std::vector<Environment> environments_;             //optimization environments for each optimizable tensor
+
+ std::unordered_map<std::string,unsigned int> sweep_sites_;                            //tensor name --> sweep site
+ std::vector<std::shared_ptr<TensorNetwork>> sweep_networks_;                          //base tensor networks (expectation networks)
+ std::unordered_map<std::string,EnvironmentBlock> left_blocks_;                        //base tensor network name --> current left environment block
+ std::unordered_map<std::string,std::vector<EnvironmentBlock>> right_blocks_;          //base tensor network name --> right environment block for each sweep site
 };
 
 } //namespace exatn
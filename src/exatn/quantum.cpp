@@ -1,12 +1,25 @@
 /** ExaTN: Quantum computing related
-REVISION: 2021/11/02
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include <iostream>
 #include <fstream>
+#include <unordered_set>
+#include <tuple>
+#include <random>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+#include <sys/stat.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "quantum.hpp"
 
@@ -121,105 +134,303 @@ std::vector<std::complex<double>> getGateData(const Gate gate_name,
 }
 
 
+static std::shared_ptr<exatn::numerics::Tensor> getPauliTensor(Gate gate_name,
+                                                                TensorElementType precision)
+{
+ std::string tensor_name;
+ switch(gate_name){
+  case Gate::gate_I: tensor_name = "_Pauli_I"; break;
+  case Gate::gate_X: tensor_name = "_Pauli_X"; break;
+  case Gate::gate_Y: tensor_name = "_Pauli_Y"; break;
+  case Gate::gate_Z: tensor_name = "_Pauli_Z"; break;
+  default: return std::shared_ptr<exatn::numerics::Tensor>(nullptr);
+ }
+ if(!exatn::tensorAllocated(tensor_name)){
+  auto success = exatn::createTensorSync(tensor_name,precision,TensorShape{2,2});
+  if(success) success = exatn::initTensorDataSync(tensor_name,getGateData(gate_name));
+  if(!success) return std::shared_ptr<exatn::numerics::Tensor>(nullptr);
+ }
+ return exatn::getTensor(tensor_name);
+}
+
+
 bool appendPauliComponent(exatn::numerics::TensorOperator & tens_operator,
-                          const std::string & paulis,
-                          const std::complex<double> & coef,
+                          const PauliProduct & pauli_prod,
                           TensorElementType precision)
 {
  bool success = true;
- std::shared_ptr<exatn::numerics::Tensor> gate_tensor;
  auto pauli_product = std::make_shared<exatn::numerics::TensorNetwork>();
  std::vector<std::pair<unsigned int, unsigned int>> ket_pairing;
  std::vector<std::pair<unsigned int, unsigned int>> bra_pairing;
  unsigned int pauli_id = 0;
- std::size_t pos = 1;
- while(paulis[pos] != ']'){
-  auto gate_name = Gate::gate_I;
-  if(paulis[pos] == 'I'){
-   gate_name = Gate::gate_I;
-   if(!exatn::tensorAllocated("_Pauli_I")){
-    success = exatn::createTensorSync("_Pauli_I",precision,TensorShape{2,2});
-    if(success) success = exatn::initTensorDataSync("_Pauli_I",getGateData(gate_name));
-   }
-   gate_tensor = exatn::getTensor("_Pauli_I");
-  }else if(paulis[pos] == 'X'){
-   gate_name = Gate::gate_X;
-   if(!exatn::tensorAllocated("_Pauli_X")){
-    success = exatn::createTensorSync("_Pauli_X",precision,TensorShape{2,2});
-    if(success) success = exatn::initTensorDataSync("_Pauli_X",getGateData(gate_name));
-   }
-   gate_tensor = exatn::getTensor("_Pauli_X");
-  }else if(paulis[pos] == 'Y'){
-   gate_name = Gate::gate_Y;
-   if(!exatn::tensorAllocated("_Pauli_Y")){
-    success = exatn::createTensorSync("_Pauli_Y",precision,TensorShape{2,2});
-    if(success) success = exatn::initTensorDataSync("_Pauli_Y",getGateData(gate_name));
-   }
-   gate_tensor = exatn::getTensor("_Pauli_Y");
-  }else if(paulis[pos] == 'Z'){
-   gate_name = Gate::gate_Z;
-   if(!exatn::tensorAllocated("_Pauli_Z")){
-    success = exatn::createTensorSync("_Pauli_Z",precision,TensorShape{2,2});
-    if(success) success = exatn::initTensorDataSync("_Pauli_Z",getGateData(gate_name));
-   }
-   gate_tensor = exatn::getTensor("_Pauli_Z");
-  }else{
-   std::cout << "#ERROR(exatn::quantum::readSpinHamiltonian): Invalid Pauli gate: " << paulis << std::endl;
-   success = false;
-  }
-  success = success && (gate_tensor != nullptr);
-  if(!success) break;
-  ++pos;
-  const auto beg_pos = pos;
-  while(is_number(paulis[pos])) ++pos;
-  unsigned int qubit = static_cast<unsigned int>(std::stoi(paulis.substr(beg_pos,pos-beg_pos)));
-  while(paulis[pos] == ' ') ++pos;
+ for(const auto & pauli: pauli_prod.product){
+  auto gate_tensor = getPauliTensor(pauli.pauli_gate,precision);
+  success = (gate_tensor != nullptr); if(!success) break;
+  const auto qubit = static_cast<unsigned int>(pauli.qubit);
   success = pauli_product->appendTensor(gate_tensor,{}); if(!success) break;
   ket_pairing.push_back({qubit,pauli_id*2+1});
   bra_pairing.push_back({qubit,pauli_id*2+0});
   ++pauli_id;
  }
  pauli_product->rename("PauliProduct" + std::to_string(tens_operator.getNumComponents()));
- success = tens_operator.appendComponent(pauli_product,ket_pairing,bra_pairing,coef);
+ if(success) success = tens_operator.appendComponent(pauli_product,ket_pairing,bra_pairing,pauli_prod.coefficient);
  return success;
 }
 
 
+/** Binary image of a spin Hamiltonian (see rationale f):
+    Header, followed by the Pauli terms, each encoded as {real coefficient (double),
+    imaginary coefficient (double), number of Pauli factors (uint32), Pauli factors (uint32 each)},
+    with each Pauli factor encoded as (qubit << 2 | Pauli code), Pauli code: I = 0, X = 1, Y = 2, Z = 3. **/
+struct PauliImageHeader {
+ std::uint32_t magic;       //magic number
+ std::uint32_t format;      //source text format: 0: OpenFermion, 1: QCWare
+ std::uint64_t num_terms;   //number of Pauli terms
+ std::uint64_t source_size; //size of the source text file (bytes)
+ std::int64_t source_time;  //last modification time of the source text file
+};
+
+constexpr const std::uint32_t PAULI_IMAGE_MAGIC = 0x48505845; //"EXPH"
+constexpr const std::size_t PAULI_CHUNKS_PER_THREAD = 4;      //number of text chunks per thread in the parallel parsing
+const std::string PAULI_CACHE_SUFFIX {".exatn.bin"};          //file name suffix of the binary cache of a spin Hamiltonian
+
+
+/** Encodes a Pauli string "[X0 Y1 Z5]" with a coefficient into a binary Pauli term. **/
+static bool encodePauliTerm(const std::string & paulis,
+                            const std::complex<double> & coef,
+                            std::vector<char> & terms)
+{
+ if(paulis.length() < 2 || paulis[0] != '[' || paulis[paulis.length()-1] != ']') return false;
+ std::vector<std::uint32_t> factors;
+ std::size_t pos = 1;
+ while(paulis[pos] != ']'){
+  std::uint32_t code = 0;
+  switch(paulis[pos]){
+   case 'I': code = 0; break;
+   case 'X': code = 1; break;
+   case 'Y': code = 2; break;
+   case 'Z': code = 3; break;
+   default: return false;
+  }
+  ++pos;
+  std::uint32_t qubit = 0;
+  const auto beg_pos = pos;
+  while(is_number(paulis[pos])){
+   qubit = qubit * 10 + static_cast<std::uint32_t>(paulis[pos] - '0');
+   if(qubit >= (1U << 30)) return false;
+   ++pos;
+  }
+  if(pos == beg_pos) return false;
+  while(paulis[pos] == ' ') ++pos;
+  factors.emplace_back((qubit << 2) | code);
+ }
+ const double coefs[2] = {coef.real(), coef.imag()};
+ const std::uint32_t num_factors = factors.size();
+ const auto offset = terms.size();
+ terms.resize(offset + sizeof(coefs) + sizeof(num_factors) + sizeof(std::uint32_t) * num_factors);
+ char * ptr = terms.data() + offset;
+ std::memcpy(ptr,coefs,sizeof(coefs)); ptr += sizeof(coefs);
+ std::memcpy(ptr,&num_factors,sizeof(num_factors)); ptr += sizeof(num_factors);
+ if(num_factors > 0) std::memcpy(ptr,factors.data(),sizeof(std::uint32_t) * num_factors);
+ return true;
+}
+
+
+/** Parses the text of a spin Hamiltonian into the binary Pauli terms, in parallel
+    over the chunks of lines. Returns FALSE if some line cannot be parsed. **/
+static bool parsePauliText(const std::string & text,
+                           std::uint32_t format,
+                           std::vector<char> & terms,
+                           std::uint64_t * num_terms)
+{
+ //Split the text into chunks of whole lines:
+ std::size_t num_chunks = PAULI_CHUNKS_PER_THREAD;
+#ifdef _OPENMP
+ num_chunks *= static_cast<std::size_t>(omp_get_max_threads());
+#endif
+ num_chunks = std::max(std::size_t{1},std::min(num_chunks,text.length() / 4096 + 1));
+ std::vector<std::size_t> bounds(num_chunks + 1,text.length());
+ bounds[0] = 0;
+ for(std::size_t chunk = 1; chunk < num_chunks; ++chunk){
+  auto pos = std::max(bounds[chunk-1],(text.length() / num_chunks) * chunk);
+  pos = text.find('\n',pos);
+  bounds[chunk] = (pos == std::string::npos) ? text.length() : pos + 1;
+ }
+ //Parse the chunks:
+ std::vector<std::vector<char>> chunk_terms(num_chunks);
+ std::vector<std::uint64_t> chunk_num_terms(num_chunks,0);
+ int failed = 0;
+#pragma omp parallel for schedule(dynamic,1) reduction(+:failed)
+ for(std::size_t chunk = 0; chunk < num_chunks; ++chunk){
+  std::string line, paulis;
+  std::complex<double> coef;
+  auto beg = bounds[chunk];
+  while(beg < bounds[chunk+1] && failed == 0){
+   auto end = text.find('\n',beg);
+   if(end == std::string::npos || end > bounds[chunk+1]) end = bounds[chunk+1];
+   if(end > beg){
+    line.assign(text,beg,end-beg);
+    bool success = false;
+    try{
+     if(format == 0){
+      success = parse_pauli_string_ofermion(line,paulis,coef);
+     }else if(format == 1){
+      success = parse_pauli_string_qcware(line,paulis,coef);
+     }
+     if(success) success = encodePauliTerm(paulis,coef,chunk_terms[chunk]);
+    }catch(...){
+     success = false;
+    }
+    if(success){
+     ++(chunk_num_terms[chunk]);
+    }else{
+     ++failed;
+    }
+   }
+   beg = end + 1;
+  }
+ }
+ if(failed != 0) return false;
+ //Concatenate the binary Pauli terms in the order of lines:
+ std::size_t total_size = terms.size();
+ for(const auto & chunk: chunk_terms) total_size += chunk.size();
+ terms.reserve(total_size);
+ *num_terms = 0;
+ for(std::size_t chunk = 0; chunk < num_chunks; ++chunk){
+  terms.insert(terms.end(),chunk_terms[chunk].cbegin(),chunk_terms[chunk].cend());
+  *num_terms += chunk_num_terms[chunk];
+ }
+ return true;
+}
+
+
+/** Validates a binary image of a spin Hamiltonian against its expected header. **/
+static bool validPauliImage(const std::vector<char> & image,
+                            const PauliImageHeader & expected)
+{
+ PauliImageHeader header;
+ if(image.size() < sizeof(header)) return false;
+ std::memcpy(&header,image.data(),sizeof(header));
+ return (header.magic == expected.magic && header.format == expected.format &&
+         header.source_size == expected.source_size && header.source_time == expected.source_time);
+}
+
+
+/** Creates the binary image of a spin Hamiltonian from its binary cache, if it is up to date,
+    otherwise by parsing its text file (the binary cache is then written next to it). **/
+static bool loadPauliImage(const std::string & filename,
+                           std::uint32_t format,
+                           std::vector<char> & image)
+{
+ struct stat source_stat;
+ if(stat(filename.c_str(),&source_stat) != 0){
+  std::cout << "#ERROR(exatn::quantum::readSpinHamiltonian): File not found: " << filename << std::endl;
+  return false;
+ }
+ PauliImageHeader header{PAULI_IMAGE_MAGIC,format,0,static_cast<std::uint64_t>(source_stat.st_size),
+                         static_cast<std::int64_t>(source_stat.st_mtime)};
+ const std::string cache_name = filename + PAULI_CACHE_SUFFIX;
+ //Binary cache:
+ std::ifstream cache_file(cache_name,std::ios::binary);
+ if(cache_file){
+  cache_file.seekg(0,std::ios::end);
+  const auto cache_size = cache_file.tellg();
+  cache_file.seekg(0,std::ios::beg);
+  if(cache_size > 0){
+   image.resize(static_cast<std::size_t>(cache_size));
+   cache_file.read(image.data(),cache_size);
+   if(cache_file && validPauliImage(image,header)) return true;
+  }
+  cache_file.close();
+ }
+ //Text file:
+ std::ifstream input_file(filename,std::ios::binary);
+ if(!input_file){
+  std::cout << "#ERROR(exatn::quantum::readSpinHamiltonian): File not found: " << filename << std::endl;
+  return false;
+ }
+ std::string text(static_cast<std::size_t>(source_stat.st_size),'\0');
+ input_file.read(&text[0],text.length());
+ text.resize(static_cast<std::size_t>(input_file.gcount()));
+ input_file.close();
+ image.assign(sizeof(header),'\0');
+ if(!parsePauliText(text,format,image,&(header.num_terms))) return false;
+ std::memcpy(image.data(),&header,sizeof(header));
+ //Write the binary cache (atomically replaced, skipped if not writable):
+ const std::string tmp_name = cache_name + ".tmp";
+ std::ofstream tmp_file(tmp_name,std::ios::binary|std::ios::trunc);
+ if(tmp_file){
+  tmp_file.write(image.data(),image.size());
+  tmp_file.close();
+  if(!tmp_file || std::rename(tmp_name.c_str(),cache_name.c_str()) != 0) std::remove(tmp_name.c_str());
+ }
+ return true;
+}
+
+
 std::shared_ptr<exatn::numerics::TensorOperator> readSpinHamiltonian(const std::string & operator_name,
                                                                      const std::string & filename,
                                                                      TensorElementType precision,
                                                                      const std::string & format)
+{
+ return readSpinHamiltonian(exatn::getDefaultProcessGroup(),operator_name,filename,precision,format);
+}
+
+
+std::shared_ptr<exatn::numerics::TensorOperator> readSpinHamiltonian(const ProcessGroup & process_group,
+                                                                     const std::string & operator_name,
+                                                                     const std::string & filename,
+                                                                     TensorElementType precision,
+                                                                     const std::string & format)
 {
  assert(filename.length() > 0);
  assert(precision == TensorElementType::COMPLEX32 || precision == TensorElementType::COMPLEX64);
- std::ifstream input_file(filename);
- if(!input_file){
-  std::cout << "#ERROR(exatn::quantum::readSpinHamiltonian): File not found: " << filename << std::endl;
+ std::uint32_t format_id = 0;
+ if(format == "OpenFermion"){
+  format_id = 0;
+ }else if(format == "QCWare"){
+  format_id = 1;
+ }else{
+  std::cout << "#ERROR(exatn::quantum::readSpinHamiltonian): Unknown format: " << format << std::endl;
+  assert(false);
+ }
+ //The root process reads the spin Hamiltonian and broadcasts its binary image:
+ std::vector<char> image;
+ if(exatn::getProcessRank(process_group) == 0){
+  if(!loadPauliImage(filename,format_id,image)) image.clear();
+ }
+ auto success = exatn::broadcastBytes(process_group,image,0); assert(success);
+ PauliImageHeader header;
+ if(image.size() < sizeof(header)){
+  std::cout << "#ERROR(exatn:quantum:readSpinHamiltonian): Unable to parse file "
+            << filename << " with format " << format << std::endl;
   assert(false);
  }
+ std::memcpy(&header,image.data(),sizeof(header));
+ //Decode the binary Pauli terms:
  auto tens_oper = makeSharedTensorOperator(operator_name);
- std::string line;
- while(std::getline(input_file,line)){
-  std::string paulis;
-  std::complex<double> coef;
-  auto success = false;
-  if(format == "OpenFermion"){
-   success = parse_pauli_string_ofermion(line,paulis,coef);
-  }else if(format == "QCWare"){
-   success = parse_pauli_string_qcware(line,paulis,coef);
-  }
-  if(!success){
-   std::cout << "#ERROR(exatn:quantum:readSpinHamiltonian): Unable to parse file "
-             << filename << " with format " << format << std::endl;
-   assert(false);
+ const char * ptr = image.data() + sizeof(header);
+ const char * end = image.data() + image.size();
+ PauliProduct pauli_prod;
+ for(std::uint64_t term = 0; term < header.num_terms; ++term){
+  double coefs[2];
+  std::uint32_t num_factors = 0;
+  assert(static_cast<std::size_t>(end - ptr) >= sizeof(coefs) + sizeof(num_factors));
+  std::memcpy(coefs,ptr,sizeof(coefs)); ptr += sizeof(coefs);
+  std::memcpy(&num_factors,ptr,sizeof(num_factors)); ptr += sizeof(num_factors);
+  assert(static_cast<std::size_t>(end - ptr) >= sizeof(std::uint32_t) * num_factors);
+  pauli_prod.product.resize(num_factors);
+  for(auto & pauli: pauli_prod.product){
+   std::uint32_t factor;
+   std::memcpy(&factor,ptr,sizeof(factor)); ptr += sizeof(factor);
+   const Gate gates[4] = {Gate::gate_I, Gate::gate_X, Gate::gate_Y, Gate::gate_Z};
+   pauli.pauli_gate = gates[factor & 3U];
+   pauli.qubit = (factor >> 2);
   }
-  //std::cout << "#DEBUG: " << paulis << std::endl; //debug
-  assert(paulis.length() >= 2); //'[]' at least
-  assert(paulis[0] == '[' && paulis[paulis.length()-1] == ']');
-  success = appendPauliComponent(*tens_oper,paulis,coef,precision); assert(success);
-  line.clear();
+  pauli_prod.coefficient = std::complex<double>{coefs[0],coefs[1]};
+  success = appendPauliComponent(*tens_oper,pauli_prod,precision); assert(success);
  }
- input_file.close();
+ assert(ptr == end);
  return tens_oper;
 }
 
@@ -232,32 +443,638 @@ std::shared_ptr<exatn::numerics::TensorOperator> generateSpinHamiltonian(const s
  while(true){
   const auto pauli_prod = hamiltonian_generator();
   if(pauli_prod.product.size() == 0 && pauli_prod.coefficient == std::complex<double>{0.0,0.0}) break;
-  std::string paulis = "[";
-  bool not_first = false;
   for(const auto & pauli: pauli_prod.product){
-   if(not_first) paulis += " ";
-   if(pauli.pauli_gate == Gate::gate_I){
-    paulis += "I";
-   }else if(pauli.pauli_gate == Gate::gate_X){
-    paulis += "X";
-   }else if(pauli.pauli_gate == Gate::gate_Y){
-    paulis += "Y";
-   }else if(pauli.pauli_gate == Gate::gate_Z){
-    paulis += "Z";
-   }else{
+   if(pauli.pauli_gate != Gate::gate_I && pauli.pauli_gate != Gate::gate_X &&
+      pauli.pauli_gate != Gate::gate_Y && pauli.pauli_gate != Gate::gate_Z){
     std::cout << "#ERROR(exatn::quantum::generateSpinHamiltonian): Invalid gate returned by the generator: "
               << static_cast<int>(pauli.pauli_gate) << std::endl;
     assert(false);
    }
-   paulis += std::to_string(pauli.qubit);
-   not_first = true;
   }
-  paulis += "]";
-  auto success = appendPauliComponent(*hamiltonian,paulis,pauli_prod.coefficient,precision); assert(success);
+  auto success = appendPauliComponent(*hamiltonian,pauli_prod,precision); assert(success);
  }
  return hamiltonian;
 }
 
+bool getPauliProduct(const exatn::numerics::TensorOperator::OperatorComponent & component,
+                     std::map<unsigned int, Gate> & pauli_product)
+{
+ pauli_product.clear();
+ const auto num_paulis = component.ket_legs.size();
+ if(component.bra_legs.size() != num_paulis || component.network->getNumTensors() != num_paulis) return false;
+ for(const auto & ket_leg: component.ket_legs){ //{qubit, pauli_id*2+1}
+  if(ket_leg.second % 2 != 1) return false;
+  const auto tensor = component.network->getTensor(ket_leg.second / 2 + 1);
+  if(!tensor) return false;
+  const auto & tensor_name = tensor->getName();
+  auto gate_name = Gate::gate_I;
+  if(tensor_name == "_Pauli_I"){
+   gate_name = Gate::gate_I;
+  }else if(tensor_name == "_Pauli_X"){
+   gate_name = Gate::gate_X;
+  }else if(tensor_name == "_Pauli_Y"){
+   gate_name = Gate::gate_Y;
+  }else if(tensor_name == "_Pauli_Z"){
+   gate_name = Gate::gate_Z;
+  }else{
+   return false;
+  }
+  if(gate_name != Gate::gate_I){
+   auto res = pauli_product.emplace(ket_leg.first,gate_name);
+   if(!(res.second)) return false; //repeated qubit
+  }
+ }
+ return true;
+}
+
+
+std::vector<std::vector<std::size_t>> groupQubitWiseCommuting(const exatn::numerics::TensorOperator & hamiltonian,
+                                                              unsigned int max_support)
+{
+ std::vector<std::vector<std::size_t>> groups;
+ std::vector<std::map<unsigned int, Gate>> bases; //measurement basis of each group: qubit --> Pauli gate
+ std::size_t component_id = 0;
+ for(auto component = hamiltonian.cbegin(); component != hamiltonian.cend(); ++component, ++component_id){
+  std::map<unsigned int, Gate> pauli_product;
+  make_sure(getPauliProduct(*component,pauli_product),
+            "#ERROR(exatn::quantum::groupQubitWiseCommuting): Tensor operator component is not a Pauli product!");
+  bool assigned = false;
+  for(std::size_t group = 0; group < groups.size(); ++group){
+   auto & basis = bases[group];
+   bool commuting = true;
+   unsigned int support = basis.size();
+   for(const auto & pauli: pauli_product){
+    auto iter = basis.find(pauli.first);
+    if(iter == basis.end()){
+     ++support;
+    }else if(iter->second != pauli.second){
+     commuting = false;
+     break;
+    }
+   }
+   if(commuting && support <= max_support){
+    for(const auto & pauli: pauli_product) basis.emplace(pauli);
+    groups[group].emplace_back(component_id);
+    assigned = true;
+    break;
+   }
+  }
+  if(!assigned){
+   groups.emplace_back(std::vector<std::size_t>{component_id});
+   bases.emplace_back(pauli_product);
+  }
+ }
+ return groups;
+}
+
+
+/** Reads a tensor element from a local tensor copy as a double complex value. **/
+template <typename NumericType>
+static std::complex<double> readLocalElement(const talsh::Tensor & local_tensor,
+                                             std::size_t offset)
+{
+ const NumericType * body_ptr = nullptr;
+ auto access_granted = local_tensor.getDataAccessHostConst(&body_ptr); assert(access_granted);
+ return std::complex<double>(body_ptr[offset]);
+}
+
+
+/** Returns an auxiliary constant tensor (creates it on the first use). **/
+static std::shared_ptr<exatn::numerics::Tensor> getAuxiliaryTensor(const std::string & name,
+                                                                  const TensorShape & shape,
+                                                                  const std::vector<std::complex<double>> & data,
+                                                                  TensorElementType precision)
+{
+ if(!exatn::tensorAllocated(name)){
+  bool success = exatn::createTensorSync(name,precision,shape);
+  if(success) success = exatn::initTensorDataSync(name,data);
+  if(!success) return std::shared_ptr<exatn::numerics::Tensor>(nullptr);
+ }
+ return exatn::getTensor(name);
+}
+
+
+bool evaluatePauliExpectation(const ProcessGroup & process_group,
+                              const exatn::numerics::TensorOperator & hamiltonian,
+                              const exatn::numerics::TensorExpansion & state,
+                              std::complex<double> & expect_value,
+                              unsigned int max_support,
+                              std::size_t * num_groups)
+{
+ expect_value = std::complex<double>{0.0,0.0};
+ if(num_groups != nullptr) *num_groups = 0;
+ if(!process_group.rankIsIn(exatn::getProcessRank())) return true; //process is not in the group: Do nothing
+ if(!state.isKet() || state.getNumComponents() == 0){
+  std::cout << "#ERROR(exatn::quantum::evaluatePauliExpectation): The state must be a non-empty ket tensor network expansion!"
+            << std::endl;
+  return false;
+ }
+ const auto precision = state.cbegin()->network->getTensorElementType();
+ const unsigned int num_qubits = state.getRank();
+ //Partition the Pauli products into groups of qubit-wise commuting ones:
+ const auto groups = groupQubitWiseCommuting(hamiltonian,max_support);
+ if(num_groups != nullptr) *num_groups = groups.size();
+ //Get the basis rotation gates and the measurement tensor:
+ const double inv_sqrt2 = 1.0 / std::sqrt(2.0);
+ auto gate_h = getAuxiliaryTensor("_Pauli_H",TensorShape{2,2},
+                                  {{inv_sqrt2,0.0},{inv_sqrt2,0.0},{inv_sqrt2,0.0},{-inv_sqrt2,0.0}},precision);
+ auto gate_sdg = getAuxiliaryTensor("_Pauli_Sdg",TensorShape{2,2},
+                                    {{1.0,0.0},{0.0,0.0},{0.0,0.0},{0.0,-1.0}},precision);
+ auto measure = getAuxiliaryTensor("_Pauli_Measure",TensorShape{2,2,2}, //M(a,b,m): M(a,b,0) = I(a,b), M(a,b,1) = Z(a,b)
+                                   {{1.0,0.0},{0.0,0.0},{0.0,0.0},{1.0,0.0},
+                                    {1.0,0.0},{0.0,0.0},{0.0,0.0},{-1.0,0.0}},precision);
+ bool success = (gate_h && gate_sdg && measure);
+ //Evaluate each group of qubit-wise commuting Pauli products:
+ for(const auto & group: groups){
+  if(!success) break;
+  //Determine the measurement basis and the support of the group:
+  std::vector<std::map<unsigned int, Gate>> pauli_products(group.size());
+  std::map<unsigned int, Gate> basis;
+  for(std::size_t i = 0; i < group.size(); ++i){
+   success = getPauliProduct(*(hamiltonian.cbegin() + group[i]),pauli_products[i]); assert(success);
+   for(const auto & pauli: pauli_products[i]) basis.emplace(pauli);
+  }
+  std::vector<unsigned int> support;
+  for(const auto & pauli: basis){
+   if(pauli.first >= num_qubits){
+    std::cout << "#ERROR(exatn::quantum::evaluatePauliExpectation): Pauli product acts on qubit "
+              << pauli.first << " outside of the state space!" << std::endl;
+    success = false; break;
+   }
+   if(pauli.second == Gate::gate_Y &&
+      precision != TensorElementType::COMPLEX32 && precision != TensorElementType::COMPLEX64){
+    std::cout << "#ERROR(exatn::quantum::evaluatePauliExpectation): Pauli Y requires a complex state!" << std::endl;
+    success = false; break;
+   }
+   support.emplace_back(pauli.first);
+  }
+  if(!success) break;
+  const unsigned int group_rank = support.size();
+  //Rotate the state into the measurement basis of the group:
+  exatn::numerics::TensorExpansion rotated_ket;
+  for(auto component = state.cbegin(); component != state.cend(); ++component){
+   auto network = std::make_shared<exatn::numerics::TensorNetwork>(*(component->network));
+   for(const auto & pauli: basis){
+    if(pauli.second == Gate::gate_Y){ //Y = (S*H) * Z * (H*S^+)
+     success = network->appendTensorGate(gate_sdg,{pauli.first}); assert(success);
+     success = network->appendTensorGate(gate_h,{pauli.first}); assert(success);
+    }else if(pauli.second == Gate::gate_X){ //X = H * Z * H
+     success = network->appendTensorGate(gate_h,{pauli.first}); assert(success);
+    }
+   }
+   success = rotated_ket.appendComponent(network,component->coefficient); assert(success);
+  }
+  //Close the rotated state with its conjugate, leaving a measurement leg per support qubit:
+  // The measurement legs of the output tensor follow the support qubits in descending order
+  std::vector<std::pair<unsigned int, unsigned int>> pairing;
+  unsigned int pos = 0;
+  for(unsigned int qubit = 0; qubit < num_qubits; ++qubit){
+   if(basis.find(qubit) == basis.end()) pairing.emplace_back(std::make_pair(pos++,qubit));
+  }
+  for(unsigned int i = 0; i < group_rank; ++i){
+   pairing.emplace_back(std::make_pair(pos,support[group_rank - 1 - i]));
+   pos += 2;
+  }
+  exatn::numerics::TensorExpansion measured("_PauliGroupMeasurement");
+  for(auto ket = rotated_ket.cbegin(); ket != rotated_ket.cend(); ++ket){
+   for(auto bra = rotated_ket.cbegin(); bra != rotated_ket.cend(); ++bra){ //bra is conjugated lazily
+    auto product = std::make_shared<exatn::numerics::TensorNetwork>(*(ket->network));
+    for(int i = static_cast<int>(group_rank) - 1; i >= 0; --i){ //descending order preserves the lower qubit legs
+     success = product->appendTensor(measure,{{support[i],0}}); assert(success);
+    }
+    exatn::numerics::TensorNetwork bra_network(*(bra->network));
+    success = bra_network.conjugate(); assert(success);
+    success = product->appendTensorNetwork(std::move(bra_network),pairing); assert(success);
+    success = measured.appendComponent(product,(ket->coefficient)*std::conj(bra->coefficient)); assert(success);
+   }
+  }
+  //Evaluate the expectation values of all Z-strings on the group support at once:
+  auto z_strings = exatn::makeSharedTensor("_PauliGroupValues",std::vector<DimExtent>(group_rank,2));
+  success = exatn::createTensorSync(process_group,z_strings,precision); if(!success) break;
+  success = exatn::initTensorSync(z_strings->getName(),0.0);
+  if(success) success = exatn::evaluateSync(process_group,measured,z_strings);
+  if(success){
+   auto local_tensor = exatn::getLocalTensor(z_strings->getName());
+   success = static_cast<bool>(local_tensor);
+   for(std::size_t i = 0; success && i < group.size(); ++i){
+    std::size_t offset = 0;
+    for(unsigned int j = 0; j < group_rank; ++j){
+     if(pauli_products[i].find(support[group_rank - 1 - j]) != pauli_products[i].end()) offset += (1UL << j);
+    }
+    std::complex<double> value{0.0,0.0};
+    switch(precision){
+     case TensorElementType::REAL32: value = readLocalElement<float>(*local_tensor,offset); break;
+     case TensorElementType::REAL64: value = readLocalElement<double>(*local_tensor,offset); break;
+     case TensorElementType::COMPLEX32: value = readLocalElement<std::complex<float>>(*local_tensor,offset); break;
+     case TensorElementType::COMPLEX64: value = readLocalElement<std::complex<double>>(*local_tensor,offset); break;
+     default:
+      std::cout << "#ERROR(exatn::quantum::evaluatePauliExpectation): Unsupported tensor element type!" << std::endl;
+      success = false;
+    }
+    expect_value += (hamiltonian.cbegin() + group[i])->coefficient * value;
+   }
+  }
+  auto destroyed = exatn::destroyTensorSync(z_strings->getName());
+  success = success && destroyed;
+ }
+ return success;
+}
+
+/** Returns TRUE if the given input tensor of the circuit is a gate tensor with storage. **/
+static bool isGateTensor(const exatn::numerics::TensorNetwork & circuit,
+                         unsigned int tensor_id)
+{
+ if(tensor_id == 0) return false;
+ const auto tensor = circuit.getTensor(tensor_id);
+ if(!tensor) return false;
+ const auto rank = tensor->getRank();
+ if(rank != 2 && rank != 4) return false;
+ const auto half_rank = rank / 2;
+ for(unsigned int i = 0; i < half_rank; ++i){
+  if(tensor->getDimExtent(i) != tensor->getDimExtent(half_rank + i)) return false;
+ }
+ return exatn::tensorAllocated(tensor->getName());
+}
+
+
+/** Returns TRUE if the gate tensor is proportional to the identity. **/
+static bool isProportionalToIdentity(const std::string & name,
+                                     double tolerance)
+{
+ auto local_tensor = exatn::getLocalTensor(name);
+ if(!local_tensor) return false;
+ const auto elem_type = exatn::getTensorElementType(name);
+ const auto rank = exatn::getTensor(name)->getRank();
+ std::size_t dim = 1;
+ for(unsigned int i = 0; i < rank / 2; ++i) dim *= exatn::getTensor(name)->getDimExtent(i);
+ auto element = [&](std::size_t offset) -> std::complex<double> {
+  switch(elem_type){
+   case TensorElementType::REAL32: return readLocalElement<float>(*local_tensor,offset);
+   case TensorElementType::REAL64: return readLocalElement<double>(*local_tensor,offset);
+   case TensorElementType::COMPLEX32: return readLocalElement<std::complex<float>>(*local_tensor,offset);
+   case TensorElementType::COMPLEX64: return readLocalElement<std::complex<double>>(*local_tensor,offset);
+   default: assert(false);
+  }
+  return std::complex<double>{0.0,0.0};
+ };
+ const auto factor = element(0);
+ if(std::abs(factor) <= tolerance) return false;
+ for(std::size_t j = 0; j < dim; ++j){
+  for(std::size_t i = 0; i < dim; ++i){
+   const auto expected = (i == j) ? factor : std::complex<double>{0.0,0.0};
+   if(std::abs(element(j*dim + i) - expected) > tolerance * std::abs(factor)) return false;
+  }
+ }
+ return true;
+}
+
+
+/** Replaces two adjacent input tensors of the circuit by their numerically computed
+    contracted product whose modes are matched with the given boundary legs. **/
+static bool fuseTensors(const ProcessGroup & process_group,
+                        exatn::numerics::TensorNetwork & circuit,
+                        unsigned int left_id,
+                        unsigned int right_id,
+                        const std::vector<std::pair<unsigned int, unsigned int>> & leg_origins,
+                        std::unordered_set<std::string> & fused)
+{
+ bool left_conj = false, right_conj = false;
+ const auto left_tensor = circuit.getTensor(left_id,&left_conj);
+ const auto right_tensor = circuit.getTensor(right_id,&right_conj);
+ //Assign index labels to the modes of both tensors:
+ std::map<std::pair<unsigned int, unsigned int>, std::string> labels;
+ std::vector<DimExtent> extents;
+ for(unsigned int i = 0; i < leg_origins.size(); ++i){
+  labels[leg_origins[i]] = "u" + std::to_string(i);
+  const auto & origin = (leg_origins[i].first == left_id) ? left_tensor : right_tensor;
+  extents.emplace_back(origin->getDimExtent(leg_origins[i].second));
+ }
+ const auto & left_legs = *(circuit.getTensorConnections(left_id));
+ unsigned int num_contracted = 0;
+ for(unsigned int i = 0; i < left_legs.size(); ++i){
+  if(left_legs[i].getTensorId() == right_id){
+   const auto label = "c" + std::to_string(num_contracted++);
+   labels[std::make_pair(left_id,i)] = label;
+   labels[std::make_pair(right_id,left_legs[i].getDimensionId())] = label;
+  }
+ }
+ //Create the fused tensor:
+ const auto left_type = exatn::getTensorElementType(left_tensor->getName());
+ const auto right_type = exatn::getTensorElementType(right_tensor->getName());
+ const auto elem_type = (right_type == TensorElementType::COMPLEX32 || right_type == TensorElementType::COMPLEX64) ?
+                        right_type : left_type;
+ auto fused_tensor = exatn::makeSharedTensor("_CircuitGate",extents);
+ fused_tensor->rename();
+ bool success = exatn::createTensorSync(process_group,fused_tensor,elem_type);
+ if(!success) return false;
+ //Compute the fused tensor:
+ std::string pattern = fused_tensor->getName() + "(";
+ for(unsigned int i = 0; i < leg_origins.size(); ++i){
+  if(i > 0) pattern += ",";
+  pattern += ("u" + std::to_string(i));
+ }
+ pattern += ")+=";
+ const std::vector<std::tuple<unsigned int, std::shared_ptr<exatn::numerics::Tensor>, bool>> operands
+  {std::make_tuple(left_id,left_tensor,left_conj),std::make_tuple(right_id,right_tensor,right_conj)};
+ for(const auto & operand: operands){
+  const auto & tensor = std::get<1>(operand);
+  if(std::get<0>(operand) == right_id) pattern += "*";
+  pattern += (tensor->getName() + (std::get<2>(operand) ? "+(" : "("));
+  for(unsigned int i = 0; i < tensor->getRank(); ++i){
+   if(i > 0) pattern += ",";
+   pattern += labels.at(std::make_pair(std::get<0>(operand),i));
+  }
+  pattern += ")";
+ }
+ success = exatn::initTensorSync(fused_tensor->getName(),0.0);
+ if(success) success = exatn::contractTensorsSync(pattern,1.0);
+ //Replace both tensors by the fused tensor:
+ if(success) success = circuit.replaceTensors({left_id,right_id},circuit.getMaxTensorId() + 1,fused_tensor,leg_origins);
+ if(!success){
+  exatn::destroyTensorSync(fused_tensor->getName());
+  return false;
+ }
+ //Destroy the previously fused tensors which are no longer present:
+ for(const auto & tensor: {left_tensor,right_tensor}){
+  if(fused.erase(tensor->getName()) > 0){
+   success = exatn::destroyTensorSync(tensor->getName()); assert(success);
+  }
+ }
+ fused.emplace(fused_tensor->getName());
+ return success;
+}
+
+
+bool simplifyCircuitSync(const ProcessGroup & process_group,
+                         exatn::numerics::TensorNetwork & circuit,
+                         std::vector<std::string> * fused_tensors,
+                         std::size_t * num_removed,
+                         double identity_tolerance)
+{
+ if(num_removed != nullptr) *num_removed = 0;
+ if(fused_tensors != nullptr) fused_tensors->clear();
+ if(!process_group.rankIsIn(exatn::getProcessRank())) return true; //process is not in the group: Do nothing
+ const auto initial_num_tensors = circuit.getNumTensors();
+ std::unordered_set<std::string> fused;     //fused gate tensors created here and still present in the circuit
+ std::unordered_set<std::string> checked;   //gate tensors known not to be proportional to the identity
+ bool success = true, simplified = true;
+ while(success && simplified){
+  simplified = false;
+  std::vector<unsigned int> gate_ids; //deterministic order on all processes
+  for(auto iter = circuit.cbegin(); iter != circuit.cend(); ++iter){
+   if(isGateTensor(circuit,iter->first)) gate_ids.emplace_back(iter->first);
+  }
+  std::sort(gate_ids.begin(),gate_ids.end());
+  for(const auto gate_id: gate_ids){
+   const auto gate = circuit.getTensor(gate_id);
+   const unsigned int rank = gate->getRank();
+   const unsigned int half_rank = rank / 2;
+   const auto & gate_legs = *(circuit.getTensorConnections(gate_id));
+   //Absorb a gate proportional to the identity into its neighbor:
+   if(checked.find(gate->getName()) == checked.end()){
+    if(isProportionalToIdentity(gate->getName(),identity_tolerance)){
+     for(const auto & leg: gate_legs){
+      const auto neighbor_id = leg.getTensorId();
+      if(neighbor_id == 0 || neighbor_id == gate_id) continue;
+      const auto neighbor = circuit.getTensor(neighbor_id);
+      if(!exatn::tensorAllocated(neighbor->getName())) continue;
+      //The neighbor must connect to exactly one leg of each input/output leg pair:
+      std::vector<int> connected(rank,0);
+      std::vector<std::pair<unsigned int, unsigned int>> leg_origins;
+      const auto & neighbor_legs = *(circuit.getTensorConnections(neighbor_id));
+      for(unsigned int m = 0; m < neighbor_legs.size(); ++m){
+       if(neighbor_legs[m].getTensorId() == gate_id){
+        const auto j = neighbor_legs[m].getDimensionId();
+        const auto partner = (j < half_rank) ? (j + half_rank) : (j - half_rank);
+        ++connected[j]; ++connected[partner];
+        leg_origins.emplace_back(std::make_pair(gate_id,partner));
+       }else{
+        leg_origins.emplace_back(std::make_pair(neighbor_id,m));
+       }
+      }
+      if(std::all_of(connected.cbegin(),connected.cend(),[](int count){return count == 1;})){
+       success = fuseTensors(process_group,circuit,neighbor_id,gate_id,leg_origins,fused);
+       simplified = success;
+       break;
+      }
+     }
+     if(simplified || !success) break;
+    }else{
+     checked.emplace(gate->getName());
+    }
+   }
+   //Fuse with an adjacent gate acting on the same qubits:
+   for(const auto & leg: gate_legs){
+    const auto other_id = leg.getTensorId();
+    if(other_id == gate_id || !isGateTensor(circuit,other_id)) continue;
+    if(circuit.getTensor(other_id)->getRank() != rank) continue;
+    //Both gates must be connected via a full half of legs each, in order:
+    std::vector<unsigned int> connected_legs;
+    for(unsigned int i = 0; i < rank; ++i){
+     if(gate_legs[i].getTensorId() == other_id) connected_legs.emplace_back(i);
+    }
+    if(connected_legs.size() != half_rank) continue;
+    const unsigned int gate_half = connected_legs[0] / half_rank;
+    const unsigned int other_half = gate_legs[connected_legs[0]].getDimensionId() / half_rank;
+    bool matched = true;
+    for(unsigned int i = 0; i < half_rank; ++i){
+     matched = matched && (connected_legs[i] == gate_half * half_rank + i)
+                       && (gate_legs[connected_legs[i]].getDimensionId() == other_half * half_rank + i);
+    }
+    if(!matched) continue;
+    //Order the fused gate modes as {input, output} if possible:
+    auto first_id = gate_id, second_id = other_id;
+    auto first_half = gate_half, second_half = other_half;
+    if(gate_half == 0 && other_half == 1){
+     std::swap(first_id,second_id);
+     std::swap(first_half,second_half);
+    }
+    std::vector<std::pair<unsigned int, unsigned int>> leg_origins;
+    for(unsigned int i = 0; i < half_rank; ++i)
+     leg_origins.emplace_back(std::make_pair(first_id,(1 - first_half) * half_rank + i));
+    for(unsigned int i = 0; i < half_rank; ++i)
+     leg_origins.emplace_back(std::make_pair(second_id,(1 - second_half) * half_rank + i));
+    success = fuseTensors(process_group,circuit,first_id,second_id,leg_origins,fused);
+    simplified = success;
+    break;
+   }
+   if(simplified || !success) break;
+   //Absorb a 1-qubit gate into an adjacent 2-qubit gate:
+   if(rank == 2){
+    for(unsigned int g = 0; g < rank; ++g){
+     const auto other_id = gate_legs[g].getTensorId();
+     if(other_id == gate_id || !isGateTensor(circuit,other_id)) continue;
+     if(circuit.getTensor(other_id)->getRank() != 4) continue;
+     if(gate_legs[1 - g].getTensorId() == other_id) continue;
+     const auto t = gate_legs[g].getDimensionId();
+     std::vector<std::pair<unsigned int, unsigned int>> leg_origins;
+     for(unsigned int m = 0; m < 4; ++m){
+      leg_origins.emplace_back((m == t) ? std::make_pair(gate_id,1 - g) : std::make_pair(other_id,m));
+     }
+     success = fuseTensors(process_group,circuit,other_id,gate_id,leg_origins,fused);
+     simplified = success;
+     break;
+    }
+    if(simplified || !success) break;
+   }
+  }
+ }
+ if(fused_tensors != nullptr) fused_tensors->assign(fused.cbegin(),fused.cend());
+ if(num_removed != nullptr) *num_removed = initial_num_tensors - circuit.getNumTensors();
+ return success;
+}
+
+
+bool sampleBitstringsSync(const ProcessGroup & process_group,
+                          const exatn::numerics::TensorExpansion & state,
+                          std::size_t num_samples,
+                          std::vector<std::vector<unsigned int>> & samples,
+                          unsigned int block_size,
+                          unsigned int seed,
+                          std::size_t * num_evaluations)
+{
+ samples.clear();
+ if(num_evaluations != nullptr) *num_evaluations = 0;
+ if(!process_group.rankIsIn(exatn::getProcessRank())) return true; //process is not in the group: Do nothing
+ if(!state.isKet() || state.getNumComponents() == 0 || block_size == 0){
+  std::cout << "#ERROR(exatn::quantum::sampleBitstringsSync): The state must be a non-empty ket tensor network expansion!"
+            << std::endl;
+  return false;
+ }
+ const auto precision = state.cbegin()->network->getTensorElementType();
+ const unsigned int num_qubits = state.getRank();
+ for(auto component = state.cbegin(); component != state.cend(); ++component){
+  const auto & output_tensor = *(component->network->getTensor(0));
+  for(unsigned int i = 0; i < num_qubits; ++i){
+   if(output_tensor.getDimExtent(i) != 2){
+    std::cout << "#ERROR(exatn::quantum::sampleBitstringsSync): The state must be a multi-qubit state!" << std::endl;
+    return false;
+   }
+  }
+ }
+ samples.assign(num_samples,std::vector<unsigned int>(num_qubits,0));
+ //Get the projectors and the diagonal measurement (copy) tensor:
+ std::vector<std::shared_ptr<exatn::numerics::Tensor>> projectors {
+  getAuxiliaryTensor("_Sample_Proj0",TensorShape{2},{{1.0,0.0},{0.0,0.0}},precision),
+  getAuxiliaryTensor("_Sample_Proj1",TensorShape{2},{{0.0,0.0},{1.0,0.0}},precision)};
+ auto copy = getAuxiliaryTensor("_Sample_Copy",TensorShape{2,2,2}, //D(a,b,m) = d(a,b)*d(b,m)
+                                {{1.0,0.0},{0.0,0.0},{0.0,0.0},{0.0,0.0},
+                                 {0.0,0.0},{0.0,0.0},{0.0,0.0},{1.0,0.0}},precision);
+ bool success = (projectors[0] && projectors[1] && copy);
+ std::mt19937_64 generator(seed);
+ std::uniform_real_distribution<double> distribution(0.0,1.0);
+ //Sample the blocks of qubits in ascending order:
+ for(unsigned int first = 0; success && first < num_qubits; first += block_size){
+  const unsigned int block_rank = std::min(block_size,num_qubits - first);
+  const unsigned int num_traced = num_qubits - first - block_rank;
+  const bool amplitudes = (num_traced == 0); //no qubits left to trace out: Evaluate the amplitudes from the ket alone
+  //Group the samples by their prefix (bits of the preceding qubits):
+  std::map<std::vector<unsigned int>, std::vector<std::size_t>> prefixes;
+  for(std::size_t s = 0; s < num_samples; ++s){
+   prefixes[std::vector<unsigned int>(samples[s].cbegin(),samples[s].cbegin() + first)].emplace_back(s);
+  }
+  //Evaluate the conditional distribution of the block for each distinct prefix:
+  for(const auto & prefix: prefixes){
+   //Project the prefix qubits of the state onto their sampled values:
+   exatn::numerics::TensorExpansion projected_ket;
+   for(auto component = state.cbegin(); component != state.cend(); ++component){
+    auto network = std::make_shared<exatn::numerics::TensorNetwork>(*(component->network));
+    for(int q = static_cast<int>(first) - 1; q >= 0; --q){ //descending order preserves the lower qubit legs
+     success = network->appendTensor(projectors[prefix.first[q]],{{static_cast<unsigned int>(q),0}}); assert(success);
+    }
+    success = projected_ket.appendComponent(network,component->coefficient); assert(success);
+   }
+   //The legs of the block qubits are now the leading output legs:
+   exatn::numerics::TensorExpansion block_distribution("_SampleBlockDistribution");
+   if(amplitudes){
+    block_distribution = projected_ket;
+   }else{
+    //Trace out the remaining qubits, leaving a measurement leg per block qubit (in descending order):
+    std::vector<std::pair<unsigned int, unsigned int>> pairing;
+    unsigned int pos = 0;
+    for(unsigned int i = 0; i < num_traced; ++i) pairing.emplace_back(std::make_pair(pos++,block_rank + i));
+    for(unsigned int i = 0; i < block_rank; ++i){
+     pairing.emplace_back(std::make_pair(pos,block_rank - 1 - i));
+     pos += 2;
+    }
+    for(auto ket = projected_ket.cbegin(); ket != projected_ket.cend(); ++ket){
+     for(auto bra = projected_ket.cbegin(); bra != projected_ket.cend(); ++bra){ //bra is conjugated lazily
+      auto product = std::make_shared<exatn::numerics::TensorNetwork>(*(ket->network));
+      for(int i = static_cast<int>(block_rank) - 1; i >= 0; --i){
+       success = product->appendTensor(copy,{{static_cast<unsigned int>(i),0}}); assert(success);
+      }
+      exatn::numerics::TensorNetwork bra_network(*(bra->network));
+      success = bra_network.conjugate(); assert(success);
+      success = product->appendTensorNetwork(std::move(bra_network),pairing); assert(success);
+      success = block_distribution.appendComponent(product,(ket->coefficient)*std::conj(bra->coefficient)); assert(success);
+     }
+    }
+   }
+   auto values = exatn::makeSharedTensor("_SampleBlockValues",std::vector<DimExtent>(block_rank,2));
+   success = exatn::createTensorSync(process_group,values,precision); if(!success) break;
+   success = exatn::initTensorSync(values->getName(),0.0);
+   if(success) success = exatn::evaluateSync(process_group,block_distribution,values);
+   if(num_evaluations != nullptr) ++(*num_evaluations);
+   //Read the (unnormalized) conditional probabilities:
+   const std::size_t volume = (1UL << block_rank);
+   std::vector<double> cumulative(volume,0.0);
+   if(success){
+    auto local_tensor = exatn::getLocalTensor(values->getName());
+    success = static_cast<bool>(local_tensor);
+    double total = 0.0;
+    for(std::size_t offset = 0; success && offset < volume; ++offset){
+     std::complex<double> value{0.0,0.0};
+     switch(precision){
+      case TensorElementType::REAL32: value = readLocalElement<float>(*local_tensor,offset); break;
+      case TensorElementType::REAL64: value = readLocalElement<double>(*local_tensor,offset); break;
+      case TensorElementType::COMPLEX32: value = readLocalElement<std::complex<float>>(*local_tensor,offset); break;
+      case TensorElementType::COMPLEX64: value = readLocalElement<std::complex<double>>(*local_tensor,offset); break;
+      default:
+       std::cout << "#ERROR(exatn::quantum::sampleBitstringsSync): Unsupported tensor element type!" << std::endl;
+       success = false;
+     }
+     total += (amplitudes ? std::norm(value) : std::max(value.real(),0.0));
+     cumulative[offset] = total;
+    }
+    if(success && total <= 0.0){
+     std::cout << "#ERROR(exatn::quantum::sampleBitstringsSync): Zero probability of a sampled prefix!" << std::endl;
+     success = false;
+    }
+   }
+   auto destroyed = exatn::destroyTensorSync(values->getName());
+   success = success && destroyed;
+   if(!success) break;
+   //Sample the block for all samples sharing the prefix:
+   for(const auto s: prefix.second){
+    const double threshold = distribution(generator) * cumulative.back();
+    const std::size_t offset = std::min(static_cast<std::size_t>(
+     std::upper_bound(cumulative.cbegin(),cumulative.cend(),threshold) - cumulative.cbegin()),volume - 1);
+    for(unsigned int i = 0; i < block_rank; ++i){ //offset bit j: block qubit j (amplitudes) or block qubit (block_rank-1-j)
+     const unsigned int bit = amplitudes ? i : (block_rank - 1 - i);
+     samples[s][first + i] = static_cast<unsigned int>((offset >> bit) & 1UL);
+    }
+   }
+  }
+ }
+ if(!success) samples.clear();
+ return success;
+}
+
+
+bool sampleBitstringsSync(const ProcessGroup & process_group,
+                          const exatn::numerics::TensorNetwork & state,
+                          std::size_t num_samples,
+                          std::vector<std::vector<unsigned int>> & samples,
+                          unsigned int block_size,
+                          unsigned int seed,
+                          std::size_t * num_evaluations)
+{
+ exatn::numerics::TensorExpansion expansion;
+ bool success = expansion.appendComponent(std::make_shared<exatn::numerics::TensorNetwork>(state),{1.0,0.0});
+ if(success) success = sampleBitstringsSync(process_group,expansion,num_samples,samples,block_size,seed,num_evaluations);
+ return success;
+}
+
 } //namespace quantum
 
 } //namespace exatn
@@ -1,8 +1,8 @@
 /** ExaTN: Quantum computing related
-REVISION: 2021/11/02
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  a) Provides utilities related to quantum circuit simulations, like quantum gates,
@@ -19,6 +19,39 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
     adhere to the bra convention such that we will have:
      <v(i1,i0)| = <q(j1,j0)| * CX(j1,j0|i1,i0), where
     the CX gate is applied to a 2-qubit register q.
+ c) The expectation value of a spin Hamiltonian given as a sum of Pauli products
+    can be evaluated by groups of qubit-wise commuting Pauli products: All Pauli
+    products of a group are diagonalized by the same single-qubit basis rotations
+    (H for X, H*S^+ for Y), thus becoming Z-strings. For each group, the rotated
+    state is contracted with its conjugate only once, leaving one open measurement
+    leg m per qubit of the group support via the measurement tensor M(a,b,m),
+    with M(a,b,0) = I(a,b) and M(a,b,1) = Z(a,b). The resulting tensor contains
+    the expectation values of all Z-strings on the group support, from which
+    all Pauli products of the group are read off.
+ d) A quantum circuit tensor network can be simplified before the contraction sequence
+    search by fusing its gate tensors (even-rank input tensors of rank 2 or 4 with
+    storage, whose first half of legs is the input and second half is the output):
+    A 1-qubit gate is absorbed into an adjacent 2-qubit gate; two adjacent gates acting
+    on the same qubits (connected via a full half of legs each, in order) are fused
+    into one gate; a gate proportional to the identity is absorbed into its neighbor.
+    Since a gate meeting its own inverse fuses into the identity, this cancels inverse
+    pairs, including the pairs U * U+ outside of the light cone of the observable
+    in a closed tensor network <psi|U+ O U|psi>. The fused gate tensors are computed
+    numerically and stay allocated, thus the simplified tensor network is equivalent.
+ e) Bitstrings are sampled from a quantum state by conditional sampling over blocks
+    of qubits (in ascending order): For each distinct prefix (bits of the preceding,
+    already sampled qubits), the joint conditional distribution of the current block
+    is evaluated once, with the prefix qubits projected onto their sampled values,
+    the block qubits diagonally measured via the copy tensor D(a,b,m) = d(a,b)*d(b,m),
+    and the remaining qubits traced out. The conditional distribution is then reused by
+    all samples sharing the same prefix. For the last block, there are no qubits left
+    to trace out, thus the amplitudes are evaluated from the ket alone (single layer).
+ f) A spin Hamiltonian text file is read by the root process of the process group only:
+    Its text is parsed in parallel by chunks of lines into a compact binary image of the
+    Pauli terms (coefficient + Pauli factors encoded as qubit/Pauli code words), which is
+    broadcast to all processes of the process group. The binary image is also cached next
+    to the text file (<filename>.exatn.bin) and reused as long as the size and modification
+    time of the text file are unchanged.
 **/
 
 #ifndef EXATN_QUANTUM_HPP_
@@ -31,6 +64,7 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include <functional>
 #include <vector>
+#include <map>
 #include <complex>
 #include <string>
 
@@ -60,6 +94,15 @@ enum class Gate{
  gate_CR
 };
 
+//Max number of qubits in the support of a group of qubit-wise commuting Pauli products:
+constexpr const unsigned int DEFAULT_MAX_GROUP_SUPPORT = 12;
+
+//Default number of qubits per block in the conditional bitstring sampling:
+constexpr const unsigned int DEFAULT_SAMPLING_BLOCK = 10;
+
+//Default seed of the random number generator used in the bitstring sampling:
+constexpr const unsigned int DEFAULT_SAMPLING_SEED = 1;
+
 //Pauli gate acting on a specific qubit:
 struct PauliMap {
  Gate pauli_gate;   //Pauli gate (I,X,Y,Z)
@@ -83,12 +126,19 @@ std::vector<std::complex<double>> getGateData(const Gate gate_name,
     represented as a linear combination of Pauli strings. Supported formats:
     + "OpenFermion": Open Fermion format (default);
     + "QCWare": QCWare collab format (by Rob Parrish);
+    This is a collective call over the default (or given) process group (see rationale f).
 **/
 std::shared_ptr<exatn::numerics::TensorOperator> readSpinHamiltonian(const std::string & operator_name,
                                                                      const std::string & filename,
                                                                      TensorElementType precision = TensorElementType::COMPLEX64,
                                                                      const std::string & format = "OpenFermion");
 
+std::shared_ptr<exatn::numerics::TensorOperator> readSpinHamiltonian(const ProcessGroup & process_group, //in: process group reading the spin Hamiltonian
+                                                                     const std::string & operator_name,
+                                                                     const std::string & filename,
+                                                                     TensorElementType precision = TensorElementType::COMPLEX64,
+                                                                     const std::string & format = "OpenFermion");
+
 /** Generates a grid-based spin Hamiltonian of the form:
      H = Sum{i1,...,iK} [H(i1,...,iK) * P(i1) * ... * P(iK)],
     where P(i) is a Pauli matrix acting on spin site i. In general,
@@ -105,6 +155,58 @@ std::shared_ptr<exatn::numerics::TensorOperator> generateSpinHamiltonian(const s
                                                   std::function<PauliProduct ()> hamiltonian_generator,
                                                   TensorElementType precision = TensorElementType::COMPLEX64);
 
+/** Returns the Pauli product represented by a given component of a spin Hamiltonian
+    created by readSpinHamiltonian or generateSpinHamiltonian: {Qubit --> Pauli gate},
+    with identity factors omitted. Returns FALSE if the component is not a Pauli product. **/
+bool getPauliProduct(const exatn::numerics::TensorOperator::OperatorComponent & component, //in: spin Hamiltonian component
+                     std::map<unsigned int, Gate> & pauli_product);                         //out: qubit --> Pauli gate (X,Y,Z)
+
+/** Partitions the components (Pauli products) of a spin Hamiltonian into groups
+    of qubit-wise commuting Pauli products (greedy, in the order of the components),
+    with each group supported on at most max_support qubits. Returns the component
+    ids for each group. **/
+std::vector<std::vector<std::size_t>> groupQubitWiseCommuting(const exatn::numerics::TensorOperator & hamiltonian,
+                                                              unsigned int max_support = DEFAULT_MAX_GROUP_SUPPORT);
+
+/** Evaluates the expectation value <state|H|state> of a spin Hamiltonian for a given
+    ket tensor network expansion by groups of qubit-wise commuting Pauli products:
+    Each group requires a single tensor network expansion evaluation. **/
+bool evaluatePauliExpectation(const ProcessGroup & process_group,                   //in: executing process group
+                              const exatn::numerics::TensorOperator & hamiltonian,  //in: spin Hamiltonian (sum of Pauli products)
+                              const exatn::numerics::TensorExpansion & state,       //in: ket tensor network expansion
+                              std::complex<double> & expect_value,                  //out: expectation value (not normalized)
+                              unsigned int max_support = DEFAULT_MAX_GROUP_SUPPORT, //in: max number of qubits in the group support
+                              std::size_t * num_groups = nullptr);                  //out: number of qubit-wise commuting groups
+
+/** Simplifies a quantum circuit tensor network (see rationale d) by fusing its gate tensors.
+    The newly created fused gate tensors stay allocated and are owned by the caller.
+    Returns TRUE upon success (even if no simplification was possible). **/
+bool simplifyCircuitSync(const ProcessGroup & process_group,                 //in: executing process group
+                         exatn::numerics::TensorNetwork & circuit,           //inout: quantum circuit tensor network (finalized)
+                         std::vector<std::string> * fused_tensors = nullptr, //out: names of the created fused gate tensors present in the circuit
+                         std::size_t * num_removed = nullptr,                //out: number of removed tensors
+                         double identity_tolerance = 1e-7);                  //in: relative tolerance for the identity detection
+
+/** Samples bitstrings from the quantum state given by a ket tensor network expansion
+    (need not be normalized) by conditional sampling over blocks of qubits (see rationale e).
+    Each bitstring contains the sampled value (0 or 1) of each qubit in the qubit order.
+    The same seed produces the same bitstrings on all processes of the process group. **/
+bool sampleBitstringsSync(const ProcessGroup & process_group,                //in: executing process group
+                          const exatn::numerics::TensorExpansion & state,    //in: ket tensor network expansion
+                          std::size_t num_samples,                           //in: number of samples
+                          std::vector<std::vector<unsigned int>> & samples,  //out: sampled bitstrings
+                          unsigned int block_size = DEFAULT_SAMPLING_BLOCK,  //in: number of qubits per sampled block
+                          unsigned int seed = DEFAULT_SAMPLING_SEED,         //in: seed of the random number generator
+                          std::size_t * num_evaluations = nullptr);          //out: number of evaluated conditional distributions
+
+bool sampleBitstringsSync(const ProcessGroup & process_group,                //in: executing process group
+                          const exatn::numerics::TensorNetwork & state,      //in: ket tensor network
+                          std::size_t num_samples,                           //in: number of samples
+                          std::vector<std::vector<unsigned int>> & samples,  //out: sampled bitstrings
+                          unsigned int block_size = DEFAULT_SAMPLING_BLOCK,  //in: number of qubits per sampled block
+                          unsigned int seed = DEFAULT_SAMPLING_SEED,         //in: seed of the random number generator
+                          std::size_t * num_evaluations = nullptr);          //out: number of evaluated conditional distributions
+
 } //namespace quantum
 
 } //namespace exatn
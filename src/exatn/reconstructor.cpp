@@ -1,5 +1,5 @@
 /** ExaTN:: Reconstructs an approximate tensor network expansion for a given tensor network expansion
-REVISION: 2021/11/21
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -11,6 +11,8 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <unordered_set>
 #include <string>
 #include <iostream>
+#include <random>
+#include <algorithm>
 #include <cmath>
 
 namespace exatn{
@@ -29,6 +31,7 @@ TensorNetworkReconstructor::TensorNetworkReconstructor(std::shared_ptr<TensorExp
 #else
  parallel_(false),
 #endif
+ sketch_(false), num_probes_(DEFAULT_SKETCH_PROBES),
  input_norm_(0.0), output_norm_(0.0), residual_norm_(0.0), fidelity_(0.0)
 {
  if(!expansion_->isKet()){
@@ -200,6 +203,29 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
   residual.printIt();
  }
 
+ //Construct the fused sketched scalars (if sketching):
+ // <approximant|p_k> and <p_k|expansion>, k = [0..K)
+ const bool sketched = (sketch_ && num_probes_ > 0);
+ TensorExpansion sketch_approximant, sketch_target;
+ std::vector<std::complex<double>> target_values;
+ double target_norm2 = 0.0;
+ if(sketched){
+  createProbes(process_group);
+  sketch_approximant = makeSketchExpansion(*approximant_);
+  sketch_approximant.rename("SketchApproximant");
+  sketch_target = makeSketchExpansion(*expansion_);
+  sketch_target.rename("SketchTarget");
+  auto sketch_values = makeSharedTensor("_sketch_values",std::vector<DimExtent>{num_probes_});
+  success = createTensorSync(sketch_values,expansion_->cbegin()->network->getTensorElementType()); assert(success);
+  success = initTensorSync("_sketch_values",0.0); assert(success);
+  success = evaluateSync(process_group,sketch_target,sketch_values,num_procs); assert(success);
+  target_values = getVectorValues("_sketch_values");
+  success = destroyTensorSync("_sketch_values"); assert(success);
+  for(const auto & value: target_values) target_norm2 += std::norm(value);
+  target_norm2 /= static_cast<double>(num_probes_);
+ }
+ bool input_norm_exact = false;
+
  //Prepare derivative environments for all optimizable tensors in the approximant:
  std::unordered_set<std::string> tensor_names;
  // Loop over the tensor networks constituting the approximant tensor expansion:
@@ -237,35 +263,78 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
   }
  }
 
+ //Split the scalar functionals into the components which depend on the optimizable tensors
+ //(re-evaluated in each iteration) and the constant components (evaluated once and cached):
+ TensorExpansion residual_var, residual_const;
+ splitExpansion(residual,tensor_names,residual_var,residual_const);
+ TensorExpansion normalization_var, normalization_const;
+ splitExpansion(normalization,tensor_names,normalization_var,normalization_const);
+ TensorExpansion overlap_var, overlap_const;
+ splitExpansion(overlap,tensor_names,overlap_var,overlap_const);
+ TensorExpansion overlap_conj_var, overlap_conj_const;
+ splitExpansion(overlap_conj,tensor_names,overlap_conj_var,overlap_conj_const);
+ std::complex<double> residual_cached{0.0,0.0}, normalization_cached{0.0,0.0};
+ std::complex<double> overlap_cached{0.0,0.0}, overlap_conj_cached{0.0,0.0};
+ if(!environments_.empty()){
+  auto scalar_cached = makeSharedTensor("_scalar_cached");
+  success = createTensorSync(scalar_cached,environments_[0].tensor->getElementType()); assert(success);
+  residual_cached = evaluateScalar(process_group,residual_const,scalar_cached,num_procs);
+  normalization_cached = evaluateScalar(process_group,normalization_const,scalar_cached,num_procs);
+  overlap_cached = evaluateScalar(process_group,overlap_const,scalar_cached,num_procs);
+  overlap_conj_cached = evaluateScalar(process_group,overlap_conj_const,scalar_cached,num_procs);
+  success = destroyTensorSync("_scalar_cached"); assert(success);
+  if(TensorNetworkReconstructor::debug > 0)
+   std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Number of residual components re-evaluated per iteration = "
+             << residual_var.getNumComponents() << " out of " << residual.getNumComponents() << std::endl;
+ }
+
  //Tensor optimization procedure:
  bool converged = environments_.empty();
  while(!converged){
   double overlap_abs = 0.0;
   double overlap_prev = 0.0;
   double overlap_diff = 0.0;
+  bool sketching = sketched;
   if(TensorNetworkReconstructor::debug > 0) expansion_->printCoefficients();
   //Compute the 2-norm of the input tensor network expansion:
   auto scalar_norm = makeSharedTensor("_scalar_norm");
   bool done = createTensorSync(scalar_norm,environments_[0].tensor->getElementType()); assert(done);
-  done = initTensorSync("_scalar_norm",0.0); assert(done);
-  done = evaluateSync(process_group,input_norm,scalar_norm,num_procs); assert(done);
-  input_norm_ = 0.0;
-  done = computeNorm1Sync("_scalar_norm",input_norm_); assert(done);
-  input_norm_ = std::sqrt(input_norm_);
+  auto scalar_overlap = makeSharedTensor("_scalar_overlap");
+  done = createTensorSync(scalar_overlap,environments_[0].tensor->getElementType()); assert(done);
+  auto scalar_residual = makeSharedTensor("_scalar_residual");
+  done = createTensorSync(scalar_residual,environments_[0].tensor->getElementType()); assert(done);
+  if(sketching){
+   input_norm_ = std::sqrt(target_norm2);
+  }else if(!input_norm_exact){
+   done = initTensorSync("_scalar_norm",0.0); assert(done);
+   done = evaluateSync(process_group,input_norm,scalar_norm,num_procs); assert(done);
+   input_norm_ = 0.0;
+   done = computeNorm1Sync("_scalar_norm",input_norm_); assert(done);
+   input_norm_ = std::sqrt(input_norm_);
+   input_norm_exact = true;
+  }
   //Check the initial guess:
   overlap_abs = 0.0;
   while(overlap_abs <= DEFAULT_MIN_INITIAL_OVERLAP){
-   //Compute the approximant norm:
-   done = initTensorSync("_scalar_norm",0.0); assert(done);
-   done = evaluateSync(process_group,normalization,scalar_norm,num_procs); assert(done);
-   output_norm_ = 0.0;
-   done = computeNorm1Sync("_scalar_norm",output_norm_); assert(done);
-   output_norm_ = std::sqrt(output_norm_);
-   //Compute the direct absolute overlap with the approximant:
-   done = initTensorSync("_scalar_norm",0.0); assert(done);
-   done = evaluateSync(process_group,overlap,scalar_norm,num_procs); assert(done);
-   overlap_abs = 0.0;
-   done = computeNorm1Sync("_scalar_norm",overlap_abs); assert(done);
+   if(sketching){
+    //Estimate the approximant norm and the direct overlap with the approximant via sketching:
+    double output_norm2 = 0.0;
+    std::complex<double> overlap_value{0.0,0.0};
+    done = evaluateSketch(process_group,sketch_approximant,target_values,num_procs,output_norm2,overlap_value); assert(done);
+    output_norm_ = std::sqrt(output_norm2);
+    overlap_abs = std::abs(overlap_value);
+   }else{
+    //Compute the approximant norm and the direct absolute overlap with the approximant (together):
+    done = initTensor("_scalar_norm",normalization_cached); assert(done);
+    done = evaluate(process_group,normalization_var,scalar_norm,num_procs); assert(done);
+    auto output_norm_future = computeNorm1Async("_scalar_norm");
+    done = initTensor("_scalar_overlap",overlap_cached); assert(done);
+    done = evaluate(process_group,overlap_var,scalar_overlap,num_procs); assert(done);
+    auto overlap_future = computeNorm1Async("_scalar_overlap");
+    output_norm_ = output_norm_future.get(); assert(output_norm_ >= 0.0);
+    output_norm_ = std::sqrt(output_norm_);
+    overlap_abs = overlap_future.get(); assert(overlap_abs >= 0.0);
+   }
    overlap_abs /= (output_norm_ * input_norm_);
    if(TensorNetworkReconstructor::debug > 0){
     std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Input 2-norm = "
@@ -279,49 +348,60 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
    }
   }
   //Iterate:
+  bool speculated = false; //the gradient of the first environment has been speculatively submitted (F)
+  std::future<double> spec_grad_norm_future, spec_tens_norm_future;
   unsigned int iteration = 0;
   while((!converged) && (iteration < max_iterations_)){
+   numericalServer->reportSolverIteration("TensorNetworkReconstructor",iteration);
    if(TensorNetworkReconstructor::debug > 0)
     std::cout << "#DEBUG(exatn::TensorNetworkReconstructor)["
               << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(numericalServer->getTimeStampStart())
               << "]: Iteration " << iteration << std::endl;
    double max_grad_norm = 0.0;
    for(auto & environment: environments_){
+    const bool reuse_speculation = (speculated && &environment == &(environments_[0]));
     //Nesterov extrapolation:
     if(nesterov){
      double extra_coef = static_cast<double>(iteration) / (static_cast<double>(iteration) + 3.0);
-     done = scaleTensorSync(environment.tensor->getName(),(1.0 + extra_coef)); assert(done);
+     done = scaleTensor(environment.tensor->getName(),(1.0 + extra_coef)); assert(done);
      std::string add_pattern;
      done = generate_addition_pattern(environment.tensor->getRank(),add_pattern,false,
                                       environment.tensor->getName(),environment.tensor_aux->getName()); assert(done);
-     done = addTensorsSync(add_pattern,-extra_coef); assert(done);
-     done = scaleTensorSync(environment.tensor_aux->getName(),extra_coef/(1.0+extra_coef)); assert(done);
+     done = addTensors(add_pattern,-extra_coef); assert(done);
+     done = scaleTensor(environment.tensor_aux->getName(),extra_coef/(1.0+extra_coef)); assert(done);
      add_pattern.clear();
      done = generate_addition_pattern(environment.tensor->getRank(),add_pattern,false,
                                       environment.tensor_aux->getName(),environment.tensor->getName()); assert(done);
-     done = addTensorsSync(add_pattern,1.0/(1.0+extra_coef)); assert(done);
+     done = addTensors(add_pattern,1.0/(1.0+extra_coef)); assert(done);
+    }
+    std::future<double> grad_norm_future, tens_norm_future;
+    if(reuse_speculation){ //the gradient has been submitted during the previous convergence check
+     grad_norm_future = std::move(spec_grad_norm_future);
+     tens_norm_future = std::move(spec_tens_norm_future);
+     speculated = false;
+    }else{
+     //Create the gradient tensor:
+     done = createTensorSync(environment.gradient,environment.tensor->getElementType()); assert(done);
+     //Initialize the gradient tensor to zero:
+     done = initTensor(environment.gradient->getName(),0.0); assert(done);
+     //Evaluate the gradient tensor expansion (asynchronously):
+     done = evaluate(process_group,environment.gradient_expansion,environment.gradient,num_procs); assert(done);
+     //Compute the norm of the gradient tensor (asynchronously):
+     grad_norm_future = computeNorm2Async(environment.gradient->getName());
+     //Compute the tensor norm (asynchronously):
+     tens_norm_future = computeNorm2Async(environment.tensor->getName());
     }
-    //Create the gradient tensor:
-    done = createTensorSync(environment.gradient,environment.tensor->getElementType()); assert(done);
-    //Initialize the gradient tensor to zero:
-    done = initTensorSync(environment.gradient->getName(),0.0); assert(done);
-    //Evaluate the gradient tensor expansion:
-    done = evaluateSync(process_group,environment.gradient_expansion,environment.gradient,num_procs); assert(done);
-    //Compute the norm of the gradient tensor:
-    double grad_norm = 0.0;
-    done = computeNorm2Sync(environment.gradient->getName(),grad_norm); assert(done);
+    //Update the optimizable tensor using the computed gradient:
+    //Compute the optimal step size (while the norms are being computed):
+    done = initTensor("_scalar_norm",0.0); assert(done);
+    done = evaluate(process_group,environment.hessian_expansion,scalar_norm,num_procs); assert(done);
+    auto hess_grad_future = computeNorm1Async("_scalar_norm");
+    double grad_norm = grad_norm_future.get(); assert(grad_norm >= 0.0);
     assert(!std::isnan(grad_norm));
-    //Compute the tensor norm:
-    double tens_norm = 0.0;
-    done = computeNorm2Sync(environment.tensor->getName(),tens_norm); assert(done);
+    double tens_norm = tens_norm_future.get();
     assert(tens_norm > 1e-7);
     double relative_grad_norm = grad_norm / tens_norm;
-    //Update the optimizable tensor using the computed gradient:
-    //Compute the optimal step size:
-    done = initTensorSync("_scalar_norm",0.0); assert(done);
-    done = evaluateSync(process_group,environment.hessian_expansion,scalar_norm,num_procs); assert(done);
-    double hess_grad = 0.0;
-    done = computeNorm1Sync("_scalar_norm",hess_grad); assert(done);
+    double hess_grad = hess_grad_future.get(); assert(hess_grad >= 0.0);
     if(hess_grad > 0.0){
      epsilon_ = grad_norm * grad_norm / hess_grad; //Cauchy step size
      relative_grad_norm *= epsilon_;
@@ -338,33 +418,58 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
     std::string add_pattern;
     done = generate_addition_pattern(environment.tensor->getRank(),add_pattern,false,
                                      environment.tensor->getName(),environment.gradient->getName()); assert(done);
-    done = addTensorsSync(add_pattern,-epsilon_); assert(done);
+    done = addTensors(add_pattern,-epsilon_); assert(done);
     //Normalize the optimizable tensor to unity:
     done = normalizeNorm2Sync(environment.tensor->getName(),1.0); assert(done);
     //Destroy the gradient tensor:
     done = destroyTensorSync(environment.gradient->getName()); assert(done);
    }
-   //Compute the residual norm and check convergence:
-   done = initTensorSync("_scalar_norm",0.0); assert(done);
-   done = evaluateSync(process_group,residual,scalar_norm,num_procs); assert(done);
-   residual_norm_ = 0.0;
-   done = computeNorm1Sync("_scalar_norm",residual_norm_); assert(done);
-   residual_norm_ = std::sqrt(residual_norm_);
-   if(TensorNetworkReconstructor::debug > 0){
-    std::cout << " Residual norm = " << residual_norm_ << "; Max gradient = " << max_grad_norm << std::endl;
-    approximant_->printCoefficients();
+   if(sketching){
+    //Estimate the residual norm, the approximant norm, and the direct overlap via sketching:
+    double output_norm2 = 0.0;
+    std::complex<double> overlap_value{0.0,0.0};
+    done = evaluateSketch(process_group,sketch_approximant,target_values,num_procs,output_norm2,overlap_value); assert(done);
+    residual_norm_ = std::sqrt(std::max(0.0,target_norm2 + output_norm2 - 2.0*overlap_value.real()));
+    output_norm_ = std::sqrt(output_norm2);
+    overlap_abs = std::abs(overlap_value);
+    if(TensorNetworkReconstructor::debug > 0){
+     std::cout << " Residual norm (sketched) = " << residual_norm_ << "; Max gradient = " << max_grad_norm << std::endl;
+     approximant_->printCoefficients();
+    }
+   }else{
+    //Submit the residual norm, the approximant norm, and the direct overlap together:
+    done = initTensor("_scalar_residual",residual_cached); assert(done);
+    done = evaluate(process_group,residual_var,scalar_residual,num_procs); assert(done);
+    auto residual_norm_future = computeNorm1Async("_scalar_residual");
+    done = initTensor("_scalar_norm",normalization_cached); assert(done);
+    done = evaluate(process_group,normalization_var,scalar_norm,num_procs); assert(done);
+    auto output_norm_future = computeNorm1Async("_scalar_norm");
+    done = initTensor("_scalar_overlap",overlap_cached); assert(done);
+    done = evaluate(process_group,overlap_var,scalar_overlap,num_procs); assert(done);
+    auto overlap_future = computeNorm1Async("_scalar_overlap");
+    //Speculatively submit the gradient of the first environment for the next iteration (F):
+    if(!nesterov && (iteration + 1) < max_iterations_ && beginSpeculation()){
+     auto & environment = environments_[0];
+     done = createTensorSync(environment.gradient,environment.tensor->getElementType()); assert(done);
+     done = initTensor(environment.gradient->getName(),0.0); assert(done);
+     done = evaluate(process_group,environment.gradient_expansion,environment.gradient,num_procs); assert(done);
+     spec_grad_norm_future = computeNorm2Async(environment.gradient->getName());
+     spec_tens_norm_future = computeNorm2Async(environment.tensor->getName());
+     speculated = true;
+    }
+    //Compute the residual norm and check convergence:
+    residual_norm_ = residual_norm_future.get(); assert(residual_norm_ >= 0.0);
+    residual_norm_ = std::sqrt(residual_norm_);
+    if(TensorNetworkReconstructor::debug > 0){
+     std::cout << " Residual norm = " << residual_norm_ << "; Max gradient = " << max_grad_norm << std::endl;
+     approximant_->printCoefficients();
+    }
+    //Compute the approximant norm:
+    output_norm_ = output_norm_future.get(); assert(output_norm_ >= 0.0);
+    output_norm_ = std::sqrt(output_norm_);
+    //Compute the direct overlap:
+    overlap_abs = overlap_future.get(); assert(overlap_abs >= 0.0);
    }
-   //Compute the approximant norm:
-   done = initTensorSync("_scalar_norm",0.0); assert(done);
-   done = evaluateSync(process_group,normalization,scalar_norm,num_procs); assert(done);
-   output_norm_ = 0.0;
-   done = computeNorm1Sync("_scalar_norm",output_norm_); assert(done);
-   output_norm_ = std::sqrt(output_norm_);
-   //Compute the direct overlap:
-   done = initTensorSync("_scalar_norm",0.0); assert(done);
-   done = evaluateSync(process_group,overlap,scalar_norm,num_procs); assert(done);
-   overlap_abs = 0.0;
-   done = computeNorm1Sync("_scalar_norm",overlap_abs); assert(done);
    overlap_abs = overlap_abs / (output_norm_ * input_norm_);
    overlap_diff = std::max(overlap_diff,std::abs(overlap_abs-overlap_prev));
    overlap_prev = overlap_abs;
@@ -372,8 +477,50 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
     std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): 2-norm of the output tensor network expansion = "
               << output_norm_ << "; Absolute overlap = " << overlap_abs << std::endl;
    bool last_diff_iteration = (iteration % DEFAULT_OVERLAP_ITERATIONS == (DEFAULT_OVERLAP_ITERATIONS-1));
-   converged = (overlap_diff/overlap_abs <= tolerance_) && last_diff_iteration;
+   if(sketching){
+    //The sketched estimates only decide when to switch to the exact evaluation:
+    converged = false;
+    if((overlap_diff/overlap_abs <= DEFAULT_SKETCH_EXACT_FACTOR * tolerance_) && last_diff_iteration){
+     if(TensorNetworkReconstructor::debug > 0)
+      std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Switching to the exact evaluation\n";
+     sketching = false;
+     //Compute the exact input norm, approximant norm, and direct overlap:
+     if(!input_norm_exact){
+      done = initTensor("_scalar_residual",0.0); assert(done);
+      done = evaluate(process_group,input_norm,scalar_residual,num_procs); assert(done);
+     }
+     done = initTensor("_scalar_norm",normalization_cached); assert(done);
+     done = evaluate(process_group,normalization_var,scalar_norm,num_procs); assert(done);
+     auto output_norm_future = computeNorm1Async("_scalar_norm");
+     done = initTensor("_scalar_overlap",overlap_cached); assert(done);
+     done = evaluate(process_group,overlap_var,scalar_overlap,num_procs); assert(done);
+     auto overlap_future = computeNorm1Async("_scalar_overlap");
+     if(!input_norm_exact){
+      input_norm_ = 0.0;
+      done = computeNorm1Sync("_scalar_residual",input_norm_); assert(done);
+      input_norm_ = std::sqrt(input_norm_);
+      input_norm_exact = true;
+     }
+     output_norm_ = output_norm_future.get(); assert(output_norm_ >= 0.0);
+     output_norm_ = std::sqrt(output_norm_);
+     overlap_abs = overlap_future.get(); assert(overlap_abs >= 0.0);
+     overlap_prev = overlap_abs / (output_norm_ * input_norm_);
+    }
+   }else{
+    converged = (overlap_diff/overlap_abs <= tolerance_) && last_diff_iteration;
+   }
    //converged = (max_grad_norm <= tolerance_) || ((overlap_diff/overlap_abs <= tolerance_) && last_diff_iteration);
+   if(speculated){ //resolve the speculation
+    if(converged){
+     done = discardSpeculation(); assert(done);
+     spec_grad_norm_future = std::future<double>(); //deferred: never executed
+     spec_tens_norm_future = std::future<double>();
+     done = destroyTensorSync(environments_[0].gradient->getName()); assert(done);
+     speculated = false;
+    }else{
+     done = commitSpeculation(); assert(done);
+    }
+   }
    if(last_diff_iteration) overlap_diff = 0.0;
    ++iteration;
   }
@@ -387,26 +534,36 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
    }
    std::cout << std::endl;
   }*/
+  //Compute the exact 2-norm of the input tensor network expansion (if only sketched so far):
+  if(!input_norm_exact){
+   done = initTensorSync("_scalar_norm",0.0); assert(done);
+   done = evaluateSync(process_group,input_norm,scalar_norm,num_procs); assert(done);
+   input_norm_ = 0.0;
+   done = computeNorm1Sync("_scalar_norm",input_norm_); assert(done);
+   input_norm_ = std::sqrt(input_norm_);
+   input_norm_exact = true;
+  }
+  //Submit the approximant norm, the conjugated overlap, and the direct overlap together:
+  done = initTensor("_scalar_norm",normalization_cached); assert(done);
+  done = evaluate(process_group,normalization_var,scalar_norm,num_procs); assert(done);
+  auto output_norm_future = computeNorm1Async("_scalar_norm");
+  done = initTensor("_scalar_residual",overlap_conj_cached); assert(done);
+  done = evaluate(process_group,overlap_conj_var,scalar_residual,num_procs); assert(done);
+  auto overlap_conj_future = computeNorm1Async("_scalar_residual");
+  done = initTensor("_scalar_overlap",overlap_cached); assert(done);
+  done = evaluate(process_group,overlap_var,scalar_overlap,num_procs); assert(done);
+  auto overlap_future = computeNorm1Async("_scalar_overlap");
   //Compute the approximant norm:
-  done = initTensorSync("_scalar_norm",0.0); assert(done);
-  done = evaluateSync(process_group,normalization,scalar_norm,num_procs); assert(done);
-  output_norm_ = 0.0;
-  done = computeNorm1Sync("_scalar_norm",output_norm_); assert(done);
+  output_norm_ = output_norm_future.get(); assert(output_norm_ >= 0.0);
   output_norm_ = std::sqrt(output_norm_);
   if(TensorNetworkReconstructor::debug > 0)
    std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): 2-norm of the output tensor network expansion = "
              << output_norm_ << std::endl;
   //Compute final approximation fidelity and overlap:
-  done = initTensorSync("_scalar_norm",0.0); assert(done);
-  done = evaluateSync(process_group,overlap_conj,scalar_norm,num_procs); assert(done);
-  overlap_abs = 0.0;
-  done = computeNorm1Sync("_scalar_norm",overlap_abs); assert(done);
+  overlap_abs = overlap_conj_future.get(); assert(overlap_abs >= 0.0);
   if(TensorNetworkReconstructor::debug > 0)
    std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Conjugated overlap = " << overlap_abs << std::endl;
-  done = initTensorSync("_scalar_norm",0.0); assert(done);
-  done = evaluateSync(process_group,overlap,scalar_norm,num_procs); assert(done);
-  overlap_abs = 0.0;
-  done = computeNorm1Sync("_scalar_norm",overlap_abs); assert(done);
+  overlap_abs = overlap_future.get(); assert(overlap_abs >= 0.0);
   fidelity_ = std::pow(overlap_abs / (output_norm_ * input_norm_), 2.0);
   if(TensorNetworkReconstructor::debug > 0){
    std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Direct overlap = " << overlap_abs << std::endl;
@@ -414,6 +571,8 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
              << (overlap_abs / (output_norm_ * input_norm_)) << std::endl;
    std::cout << "#DEBUG(exatn::TensorNetworkReconstructor): Fidelity = " << fidelity_ << std::endl;
   }
+  done = destroyTensorSync("_scalar_residual"); assert(done);
+  done = destroyTensorSync("_scalar_overlap"); assert(done);
   done = destroyTensorSync("_scalar_norm"); assert(done);
   //Check the necessity to restart iterations:
   if(iteration >= max_iterations_) break;
@@ -433,6 +592,9 @@ bool TensorNetworkReconstructor::reconstruct_sd(const ProcessGroup & process_gro
   }
  }
 
+ //Destroy the random probes:
+ if(sketched) destroyProbes();
+
  //Deactivate caching of optimal tensor contraction sequences:
  if(!con_seq_caching) deactivateContrSeqCaching();
 
@@ -449,6 +611,196 @@ void TensorNetworkReconstructor::enableParallelization(bool parallel)
 }
 
 
+void TensorNetworkReconstructor::splitExpansion(const TensorExpansion & expansion,
+                                                const std::unordered_set<std::string> & tensor_names,
+                                                TensorExpansion & variable,
+                                                TensorExpansion & constant)
+{
+ for(auto component = expansion.cbegin(); component != expansion.cend(); ++component){
+  bool dependent = false;
+  for(auto tensor = component->network->cbegin(); tensor != component->network->cend(); ++tensor){
+   if(tensor_names.find(tensor->second.getName()) != tensor_names.cend()){
+    dependent = true;
+    break;
+   }
+  }
+  bool success = true;
+  if(dependent){
+   success = variable.appendComponent(component->network,component->coefficient);
+  }else{
+   success = constant.appendComponent(component->network,component->coefficient);
+  }
+  assert(success);
+ }
+ variable.rename(expansion.getName()+"Var");
+ constant.rename(expansion.getName()+"Const");
+ return;
+}
+
+
+std::complex<double> TensorNetworkReconstructor::evaluateScalar(const ProcessGroup & process_group,
+                                                                TensorExpansion & expansion,
+                                                                std::shared_ptr<Tensor> scalar,
+                                                                unsigned int num_procs)
+{
+ if(expansion.getNumComponents() == 0) return std::complex<double>{0.0,0.0};
+ bool success = initTensorSync(scalar->getName(),0.0); assert(success);
+ success = evaluateSync(process_group,expansion,scalar,num_procs); assert(success);
+ auto local_tensor = getLocalTensor(scalar->getName()); assert(local_tensor);
+ std::complex<double> value{0.0,0.0};
+ switch(getTensorElementType(scalar->getName())){
+  case TensorElementType::REAL32:
+   value = std::complex<double>(local_tensor->getSliceView<float>()[std::initializer_list<int>{}], 0.0);
+   break;
+  case TensorElementType::REAL64:
+   value = std::complex<double>(local_tensor->getSliceView<double>()[std::initializer_list<int>{}], 0.0);
+   break;
+  case TensorElementType::COMPLEX32:
+   value = std::complex<double>(local_tensor->getSliceView<std::complex<float>>()[std::initializer_list<int>{}]);
+   break;
+  case TensorElementType::COMPLEX64:
+   value = local_tensor->getSliceView<std::complex<double>>()[std::initializer_list<int>{}];
+   break;
+  default:
+   assert(false);
+ }
+ return value;
+}
+
+
+void TensorNetworkReconstructor::enableSketching(bool sketch, unsigned int num_probes)
+{
+ sketch_ = sketch;
+ num_probes_ = num_probes;
+ return;
+}
+
+
+void TensorNetworkReconstructor::createProbes(const ProcessGroup & process_group)
+{
+ destroyProbes();
+ const auto elem_type = expansion_->cbegin()->network->getTensorElementType();
+ const auto space_tensor = expansion_->getSpaceTensor();
+ const unsigned int rank = expansion_->getRank();
+ std::mt19937 generator(DEFAULT_SKETCH_SEED); //same probes on all processes
+ std::bernoulli_distribution distribution(0.5);
+ probes_.resize(num_probes_);
+ selectors_.resize(num_probes_);
+ for(unsigned int k = 0; k < num_probes_; ++k){
+  //Create the Rademacher probe vectors for all open legs:
+  for(unsigned int i = 0; i < rank; ++i){
+   const auto extent = space_tensor->getDimExtent(i);
+   auto probe = makeSharedTensor("_sketch_probe"+std::to_string(k)+"_"+std::to_string(i),
+                                 std::vector<DimExtent>{extent});
+   bool success = createTensorSync(process_group,probe,elem_type); assert(success);
+   std::vector<double> probe_data(extent);
+   for(auto & elem: probe_data) elem = (distribution(generator) ? 1.0 : -1.0);
+   success = initTensorDataSync(probe->getName(),probe_data); assert(success);
+   probes_[k].emplace_back(probe);
+  }
+  //Create the unit selector vector:
+  selectors_[k] = makeSharedTensor("_sketch_selector"+std::to_string(k),std::vector<DimExtent>{num_probes_});
+  bool success = createTensorSync(process_group,selectors_[k],elem_type); assert(success);
+  std::vector<double> unit(num_probes_,0.0); unit[k] = 1.0;
+  success = initTensorDataSync(selectors_[k]->getName(),unit); assert(success);
+ }
+ return;
+}
+
+
+void TensorNetworkReconstructor::destroyProbes()
+{
+ for(auto & probe: probes_){
+  for(auto & vec: probe){
+   bool success = destroyTensorSync(vec->getName()); assert(success);
+  }
+ }
+ probes_.clear();
+ for(auto & selector: selectors_){
+  bool success = destroyTensorSync(selector->getName()); assert(success);
+ }
+ selectors_.clear();
+ return;
+}
+
+
+TensorExpansion TensorNetworkReconstructor::makeSketchExpansion(const TensorExpansion & expansion) const
+{
+ TensorExpansion sketch_expansion;
+ const int rank = expansion.getRank();
+ for(unsigned int k = 0; k < probes_.size(); ++k){
+  for(auto component = expansion.cbegin(); component != expansion.cend(); ++component){
+   auto network = std::make_shared<TensorNetwork>(*(component->network));
+   for(int i = rank - 1; i >= 0; --i){ //descending order preserves the lower open legs
+    bool success = network->appendTensor(probes_[k][i],{{static_cast<unsigned int>(i),0}}); assert(success);
+   }
+   bool success = network->appendTensor(network->getMaxTensorId() + 1,selectors_[k],
+                                        std::vector<std::pair<unsigned int, unsigned int>>{}); assert(success);
+   success = sketch_expansion.appendComponent(network,component->coefficient); assert(success);
+  }
+ }
+ return sketch_expansion;
+}
+
+
+bool TensorNetworkReconstructor::evaluateSketch(const ProcessGroup & process_group,
+                                                TensorExpansion & sketch_approximant,
+                                                const std::vector<std::complex<double>> & target_values,
+                                                unsigned int num_procs,
+                                                double & output_norm2,
+                                                std::complex<double> & overlap)
+{
+ output_norm2 = 0.0;
+ overlap = std::complex<double>{0.0,0.0};
+ auto sketch_values = makeSharedTensor("_sketch_values",std::vector<DimExtent>{num_probes_});
+ bool success = createTensorSync(sketch_values,environments_[0].tensor->getElementType());
+ if(success){
+  success = initTensorSync("_sketch_values",0.0);
+  if(success) success = evaluateSync(process_group,sketch_approximant,sketch_values,num_procs);
+  if(success){
+   const auto approx_values = getVectorValues("_sketch_values");
+   assert(approx_values.size() == target_values.size());
+   for(std::size_t k = 0; k < approx_values.size(); ++k){
+    output_norm2 += std::norm(approx_values[k]);
+    overlap += approx_values[k] * target_values[k];
+   }
+   output_norm2 /= static_cast<double>(num_probes_);
+   overlap /= static_cast<double>(num_probes_);
+  }
+  success = destroyTensorSync("_sketch_values") && success;
+ }
+ return success;
+}
+
+
+std::vector<std::complex<double>> TensorNetworkReconstructor::getVectorValues(const std::string & name)
+{
+ auto local_tensor = getLocalTensor(name); assert(local_tensor);
+ const auto elem_type = getTensorElementType(name);
+ const int volume = static_cast<int>(local_tensor->getVolume());
+ std::vector<std::complex<double>> values(volume,std::complex<double>{0.0,0.0});
+ for(int i = 0; i < volume; ++i){
+  switch(elem_type){
+   case TensorElementType::REAL32:
+    values[i] = std::complex<double>(local_tensor->getSliceView<float>()[std::initializer_list<int>{i}], 0.0);
+    break;
+   case TensorElementType::REAL64:
+    values[i] = std::complex<double>(local_tensor->getSliceView<double>()[std::initializer_list<int>{i}], 0.0);
+    break;
+   case TensorElementType::COMPLEX32:
+    values[i] = std::complex<double>(local_tensor->getSliceView<std::complex<float>>()[std::initializer_list<int>{i}]);
+    break;
+   case TensorElementType::COMPLEX64:
+    values[i] = local_tensor->getSliceView<std::complex<double>>()[std::initializer_list<int>{i}];
+    break;
+   default:
+    assert(false);
+  }
+ }
+ return values;
+}
+
+
 void TensorNetworkReconstructor::resetDebugLevel(unsigned int level, int focus_process)
 {
  TensorNetworkReconstructor::debug = level;
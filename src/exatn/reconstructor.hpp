@@ -1,5 +1,5 @@
 /** ExaTN:: Reconstructs an approximate tensor network expansion for a given tensor network expansion
-REVISION: 2021/10/22
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -13,6 +13,33 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
      of the underlying linear algebra procedures.
  (B) The reconstructed tensor network expansion must be a Ket (primary space) and
      the reconstructing tensor network expansion must be a Bra (dual space).
+ (C) The independent tensor network expansion evaluations (gradient and hessian-gradient,
+     residual, normalization and overlap) are submitted together, with their scalar results
+     retrieved via futures afterwards, thus keeping the runtime pipeline full.
+ (D) Sketching (optional): In early iterations, the overlap <approximant|expansion> and
+     the norms <approximant|approximant> and <expansion|expansion> are estimated via
+     K random product-state probes |p_k> with independent Rademacher (+1/-1) entries,
+     for which E[|p_k><p_k|] = I:
+      <approximant|expansion> ~ (1/K) * Sum_k <approximant|p_k> * <p_k|expansion>,
+     where each probed scalar is a closed tensor network with the probe vectors
+     attached to its open legs (no bra-ket double layer). All K probed scalars are fused
+     into a single vector-valued tensor network expansion (via unit selector vectors),
+     such that they are evaluated at once. The probed target scalars <p_k|expansion>
+     are evaluated only once. The probes are generated with a fixed seed,
+     hence they are the same across the iterations and across the MPI processes.
+     Once the estimated convergence criterion falls below DEFAULT_SKETCH_EXACT_FACTOR
+     times the tolerance, the reconstruction switches to the exact evaluation, which
+     decides the convergence. The gradients are always evaluated exactly.
+ (E) The components of the scalar functionals (residual, normalization, overlap) which
+     do not depend on any optimizable tensor (for example, <expansion|expansion>) are
+     evaluated only once and cached: Their cached sum initializes the scalar accumulator,
+     into which only the dependent components are evaluated in each iteration.
+ (F) Speculative execution (optional, exatn::activateSpeculativeExecution()): Without Nesterov
+     extrapolation, the gradient of the first environment in the next iteration does not depend
+     on the convergence check of the current iteration, thus its evaluation (and the norms)
+     is submitted speculatively right before blocking on the convergence check, such that the runtime
+     keeps executing it meanwhile. Upon convergence, the speculation is discarded
+     (its unexecuted tensor operations are cancelled) and the gradient tensor is destroyed.
 **/
 
 #ifndef EXATN_RECONSTRUCTOR_HPP_
@@ -20,7 +47,9 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_numerics.hpp"
 
+#include <unordered_set>
 #include <vector>
+#include <string>
 #include <complex>
 
 #include "errors.hpp"
@@ -40,6 +69,9 @@ public:
  static constexpr const unsigned int DEFAULT_OVERLAP_ITERATIONS = 3;
  static constexpr const double DEFAULT_ACCEPTABLE_FIDELITY = 0.01;
  static constexpr const double DEFAULT_MIN_INITIAL_OVERLAP = 1e-9;
+ static constexpr const unsigned int DEFAULT_SKETCH_PROBES = 16;   //number of random product-state probes
+ static constexpr const double DEFAULT_SKETCH_EXACT_FACTOR = 10.0; //switch to the exact evaluation at this multiple of the tolerance
+ static constexpr const unsigned int DEFAULT_SKETCH_SEED = 1;      //random seed for the probes (must be the same on all processes)
 
  TensorNetworkReconstructor(std::shared_ptr<TensorExpansion> expansion,   //in: tensor network expansion to be reconstructed (constant)
                             std::shared_ptr<TensorExpansion> approximant, //inout: reconstructing tensor network expansion
@@ -83,6 +115,11 @@ public:
  /** Enables/disables coarse-grain parallelization over tensor networks. **/
  void enableParallelization(bool parallel = true);
 
+ /** Enables/disables the randomized sketching estimation of the overlaps and norms
+     in early iterations, with a given number of random product-state probes. **/
+ void enableSketching(bool sketch = true,                             //in: sketching on/off
+                      unsigned int num_probes = DEFAULT_SKETCH_PROBES); //in: number of random product-state probes
+
  static void resetDebugLevel(unsigned int level = 0,  //in: debug level
                              int focus_process = -1); //in: process to focus on (-1: all)
 
@@ -100,6 +137,41 @@ private:
 
  void reinitializeApproximant(const ProcessGroup & process_group);
 
+ //Creates random product-state probes for all open legs of the reconstructed tensor network expansion:
+ void createProbes(const ProcessGroup & process_group);
+
+ //Destroys the random product-state probes:
+ void destroyProbes();
+
+ //Builds the fused tensor network expansion of all probed scalars of a given tensor network expansion
+ //(its output is a vector: probed scalar k is selected by the unit selector vector k):
+ TensorExpansion makeSketchExpansion(const TensorExpansion & expansion) const;
+
+ //Evaluates the probed scalars of the approximant and returns the sketched estimates
+ //of <approximant|approximant> and <approximant|expansion>:
+ bool evaluateSketch(const ProcessGroup & process_group,
+                     TensorExpansion & sketch_approximant,
+                     const std::vector<std::complex<double>> & target_values,
+                     unsigned int num_procs,
+                     double & output_norm2,
+                     std::complex<double> & overlap);
+
+ //Splits a tensor network expansion into the components which depend on any of the given
+ //optimizable tensors and the constant components:
+ static void splitExpansion(const TensorExpansion & expansion,
+                            const std::unordered_set<std::string> & tensor_names,
+                            TensorExpansion & variable,
+                            TensorExpansion & constant);
+
+ //Evaluates a closed tensor network expansion and returns its value (zero for an empty expansion):
+ static std::complex<double> evaluateScalar(const ProcessGroup & process_group,
+                                            TensorExpansion & expansion,
+                                            std::shared_ptr<Tensor> scalar,
+                                            unsigned int num_procs);
+
+ //Returns the values of a locally stored vector tensor:
+ static std::vector<std::complex<double>> getVectorValues(const std::string & name);
+
  struct Environment{
   std::shared_ptr<Tensor> tensor;       //tensor being optimized
   std::shared_ptr<Tensor> tensor_aux;   //auxiliary tensor (e.g., previous iteration)
@@ -115,6 +187,8 @@ private:
  double epsilon_;                               //learning rate for the gradient descent based tensor update
  double tolerance_;                             //numerical reconstruction convergence tolerance (for the gradient)
  bool parallel_;                                //enables/disables coarse-grain parallelization over tensor networks
+ bool sketch_;                                  //enables/disables the sketching estimation in early iterations
+ unsigned int num_probes_;                      //number of random product-state probes
 
  double input_norm_;                            //2-norm of the input tensor expansion
  double output_norm_;                           //2-norm of the approximant tensor expansion
@@ -122,6 +196,8 @@ private:
  double fidelity_;                              //achieved reconstruction fidelity (normalized squared overlap)
 
  std::vector<Environment> environments_;        //optimization environments for each optimizable tensor
+ std::vector<std::vector<std::shared_ptr<Tensor>>> probes_; //random product-state probes: probe --> open leg --> vector
+ std::vector<std::shared_ptr<Tensor>> selectors_; //unit selector vectors: probe --> selector
 };
 
 } //namespace exatn
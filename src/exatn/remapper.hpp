@@ -1,5 +1,5 @@
 /** ExaTN:: Reconstructs an approximate tensor network operator for a given tensor network operator
-REVISION: 2021/10/22
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -11,6 +11,10 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
      fidelity is the normalized squared overlap between the two tensor network operators.
      The reconstruction tolerance is a numerical tolerance used for checking convergence
      of the underlying linear algebra procedures.
+ (B) The remapped tensor network operators are reconstructed by the tensor network
+     reconstructor, which tracks the dependence of the residual components on the
+     optimizable tensors: Only the dependent components are re-evaluated in each
+     iteration whereas the constant ones (target-target) are evaluated once and cached.
 **/
 
 #ifndef EXATN_REMAPPER_HPP_
@@ -0,0 +1,177 @@
+/** ExaTN:: Live runtime monitor (for long-running jobs)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "runtime_monitor.hpp"
+
+#include "timers.hpp"
+#include "thread_topology.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+namespace exatn{
+
+static std::size_t total_executed(const runtime::RuntimeMetrics & metrics)
+{
+ std::size_t count = 0;
+ for(const auto & stats: metrics.opcodes) count += stats.count;
+ return count;
+}
+
+
+static double total_flops(const runtime::RuntimeMetrics & metrics)
+{
+ double flops = 0.0;
+ for(const auto & stats: metrics.devices) flops += stats.flops;
+ return flops;
+}
+
+
+RuntimeMonitor::RuntimeMonitor():
+ interval_(0.0), process_id_(0), running_(false), stopping_(false), iteration_(0),
+ iteration_time_(0.0), time_start_(0.0), progress_time_(0.0)
+{
+}
+
+
+RuntimeMonitor::~RuntimeMonitor()
+{
+ stop();
+}
+
+
+void RuntimeMonitor::start(double interval,
+                           int process_id,
+                           MetricsProvider provider)
+{
+ stop();
+ std::lock_guard<std::mutex> lock(mtx_);
+ interval_ = (interval > MIN_INTERVAL) ? interval : MIN_INTERVAL;
+ process_id_ = process_id;
+ time_start_ = exatn::Timer::timeInSecHR();
+ progress_time_ = time_start_;
+ stopping_ = false;
+ running_ = true;
+ thread_ = std::thread(&RuntimeMonitor::monitorLoop,this,std::move(provider));
+ return;
+}
+
+
+void RuntimeMonitor::stop()
+{
+ {
+  std::lock_guard<std::mutex> lock(mtx_);
+  stopping_ = true;
+ }
+ cv_.notify_all();
+ if(thread_.joinable()) thread_.join();
+ std::lock_guard<std::mutex> lock(mtx_);
+ running_ = false;
+ return;
+}
+
+
+bool RuntimeMonitor::isActive() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ return running_;
+}
+
+
+double RuntimeMonitor::getInterval() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ return interval_;
+}
+
+
+void RuntimeMonitor::reportIteration(const std::string & solver,
+                                     std::size_t iteration)
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(!running_) return;
+ if(solver_ != solver) solver_ = solver;
+ iteration_ = iteration;
+ iteration_time_ = exatn::Timer::timeInSecHR();
+ return;
+}
+
+
+void RuntimeMonitor::monitorLoop(MetricsProvider provider)
+{
+ getThreadTopology().pinRuntimeThread(false); //if the thread topology is active
+ auto previous = provider();
+ double previous_time = exatn::Timer::timeInSecHR();
+ std::unique_lock<std::mutex> lock(mtx_);
+ while(!stopping_){
+  const auto period = std::chrono::duration<double>(interval_);
+  if(cv_.wait_for(lock,period,[this](){return stopping_;})) break;
+  lock.unlock();
+  const auto metrics = provider();
+  const double current_time = exatn::Timer::timeInSecHR();
+  lock.lock();
+  writeSnapshot(metrics,previous,current_time - previous_time);
+  previous = metrics;
+  previous_time = current_time;
+ }
+ return;
+}
+
+
+void RuntimeMonitor::writeSnapshot(const runtime::RuntimeMetrics & metrics,
+                                   const runtime::RuntimeMetrics & previous,
+                                   double period)
+{
+ const double now = exatn::Timer::timeInSecHR();
+ const auto executed = total_executed(metrics);
+ const auto prev_executed = total_executed(previous);
+ //The counters may have been reset meanwhile:
+ const std::size_t delta_ops = (executed >= prev_executed) ? (executed - prev_executed) : executed;
+ const double delta_flops = std::max(0.0,total_flops(metrics) - total_flops(previous));
+ const std::size_t delta_postponed = (metrics.num_postponed >= previous.num_postponed) ?
+                                     (metrics.num_postponed - previous.num_postponed) : metrics.num_postponed;
+ const bool progressed = (delta_ops > 0 || metrics.dag_front != previous.dag_front);
+ const bool pending = (metrics.dag_front < metrics.dag_nodes);
+ if(progressed || !pending) progress_time_ = now;
+ const std::string filename = "exatn_monitor." + std::to_string(process_id_) + ".txt";
+ const std::string tmp_filename = filename + ".tmp";
+ std::ofstream monitor_file(tmp_filename,std::ios::out|std::ios::trunc);
+ if(!monitor_file.is_open()) return;
+ monitor_file << "#RuntimeMonitor: Process " << process_id_ << std::fixed << std::setprecision(3)
+              << ": Time = " << (now - time_start_) << " sec; Period = " << period << " sec" << std::endl;
+ monitor_file << "DAG: Nodes = " << metrics.dag_nodes << "; Front node = " << metrics.dag_front
+              << "; Unexecuted = " << (pending ? (metrics.dag_nodes - metrics.dag_front) : std::size_t{0})
+              << "; Ready queue max = " << metrics.ready_queue_max << std::endl;
+ monitor_file << std::scientific << "Rates: Ops/s = " << ((period > 0.0) ? (static_cast<double>(delta_ops) / period) : 0.0)
+              << "; GFlop/s = " << ((period > 0.0) ? (delta_flops / period * 1e-9) : 0.0)
+              << "; TRY_LATER rate = " << ((delta_ops + delta_postponed > 0) ?
+                 (static_cast<double>(delta_postponed) / static_cast<double>(delta_ops + delta_postponed)) : 0.0)
+              << std::endl;
+ monitor_file << "Totals: Ops = " << executed << "; GFlop = " << (total_flops(metrics) * 1e-9)
+              << "; TRY_LATER = " << metrics.num_postponed << std::endl;
+ monitor_file << "Host memory: Usage = " << metrics.memory_usage_bytes << " bytes; Free = " << metrics.memory_free_bytes
+              << " bytes; Peak = " << metrics.memory_peak_bytes << " bytes; Tensors = " << metrics.tensor_memory_bytes
+              << " bytes" << std::endl;
+ for(const auto & device: metrics.devices){
+  monitor_file << "Device " << device.device << ": Ops = " << device.count << "; GFlop/s = " << device.gflops
+               << "; Utilization = " << device.utilization << "; Queued flops = " << device.queued_flops
+               << "; Free memory = " << device.free_memory_bytes << " bytes" << std::endl;
+ }
+ monitor_file << std::fixed;
+ if(!solver_.empty()){
+  monitor_file << "Solver: " << solver_ << ": Iteration = " << iteration_
+               << "; Since iteration start = " << (now - iteration_time_) << " sec" << std::endl;
+ }
+ monitor_file << "Stall: No progress for " << (now - progress_time_) << " sec" << std::endl;
+ monitor_file.close();
+ std::rename(tmp_filename.c_str(),filename.c_str());
+ return;
+}
+
+} //namespace exatn
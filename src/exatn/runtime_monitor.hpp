@@ -0,0 +1,96 @@
+/** ExaTN:: Live runtime monitor (for long-running jobs)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) Once started, the runtime monitor thread periodically takes a snapshot of the runtime
+     performance counters (RuntimeMetrics, which are always on and readable by any thread)
+     and overwrites the monitor file "exatn_monitor.<global_rank>.txt" with the current state:
+     The DAG size and its front node, the rates of executed tensor operations and flops
+     (over the last monitoring period), the TRY_LATER rate, the memory usage of the Host
+     memory buffer and the free memory of each device, as well as the current solver iteration
+     reported by the iterative solvers. The monitor file is replaced atomically (renamed
+     from a temporary file), thus it can be polled (e.g., by monitor.sh) at any time.
+ (B) Stall detection: The monitor file reports the time elapsed since the last progress
+     (executed tensor operation or DAG front node advance) while the DAG has unexecuted nodes.
+ (C) The overhead is a single snapshot of the atomic counters per monitoring period
+     (the monitor thread sleeps in between), the client only records its solver iterations.
+**/
+
+#ifndef EXATN_RUNTIME_MONITOR_HPP_
+#define EXATN_RUNTIME_MONITOR_HPP_
+
+#include "tensor_runtime.hpp"
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace exatn{
+
+class RuntimeMonitor{
+
+public:
+
+ static constexpr const double MIN_INTERVAL = 0.1; //min monitoring period (sec)
+
+ /** Provider of the runtime performance counters (called by the monitor thread). **/
+ using MetricsProvider = std::function<runtime::RuntimeMetrics()>;
+
+ RuntimeMonitor();
+
+ RuntimeMonitor(const RuntimeMonitor &) = delete;
+ RuntimeMonitor & operator=(const RuntimeMonitor &) = delete;
+ RuntimeMonitor(RuntimeMonitor &&) = delete;
+ RuntimeMonitor & operator=(RuntimeMonitor &&) = delete;
+ ~RuntimeMonitor();
+
+ /** Starts the monitor thread with a given monitoring period (sec). **/
+ void start(double interval,             //in: monitoring period (sec)
+            int process_id,              //in: process id (global MPI rank)
+            MetricsProvider provider);   //in: provider of the runtime performance counters
+
+ /** Stops the monitor thread. **/
+ void stop();
+
+ /** Returns TRUE if the monitor thread is running. **/
+ bool isActive() const;
+
+ /** Returns the monitoring period (sec). **/
+ double getInterval() const;
+
+ /** Records the current iteration of an iterative solver. **/
+ void reportIteration(const std::string & solver, //in: solver name
+                      std::size_t iteration);     //in: iteration number
+
+protected:
+
+ /** Monitor thread. **/
+ void monitorLoop(MetricsProvider provider);
+
+ /** Writes the monitor file given the current and previous snapshots of the runtime performance counters. **/
+ void writeSnapshot(const runtime::RuntimeMetrics & metrics,
+                    const runtime::RuntimeMetrics & previous,
+                    double period);
+
+ double interval_;                   //monitoring period (sec)
+ int process_id_;                    //process id (global MPI rank)
+ bool running_;                      //whether or not the monitor thread is running
+ bool stopping_;                     //signal to stop the monitor thread
+ std::string solver_;                //name of the current iterative solver
+ std::size_t iteration_;             //current solver iteration
+ double iteration_time_;             //time stamp of the current solver iteration (sec)
+ double time_start_;                 //time stamp of the monitor start (sec)
+ double progress_time_;              //time stamp of the last observed progress (sec)
+ std::thread thread_;                //monitor thread
+ mutable std::mutex mtx_;            //protects the monitor state
+ std::condition_variable cv_;        //wakes up the monitor thread upon stop
+};
+
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_MONITOR_HPP_
@@ -3,6 +3,8 @@
 #include "exatn.hpp"
 #include "quantum.hpp"
 #include "talshxx.hpp"
+#include "tensor_network_flat.hpp"
+#include "thread_topology.hpp"
 
 #ifdef MPI_ENABLED
 #include "mpi.h"
@@ -12,8 +14,11 @@
 #include <ios>
 #include <utility>
 #include <numeric>
+#include <fstream>
+#include <cstdio>
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 #include "errors.hpp"
 
@@ -53,6 +58,70 @@
 #define EXATN_TEST32
 //#define EXATN_TEST33 //requires input file from source
 //#define EXATN_TEST34
+#define EXATN_TEST35
+#define EXATN_TEST36
+#define EXATN_TEST37
+#define EXATN_TEST38
+#define EXATN_TEST39
+#define EXATN_TEST40
+#define EXATN_TEST41
+#define EXATN_TEST42
+#define EXATN_TEST43
+#define EXATN_TEST44
+#define EXATN_TEST45
+#define EXATN_TEST46
+#define EXATN_TEST47
+#define EXATN_TEST48
+#define EXATN_TEST49
+#define EXATN_TEST50
+#define EXATN_TEST51
+#define EXATN_TEST52
+#define EXATN_TEST53
+#define EXATN_TEST54
+#define EXATN_TEST55
+#define EXATN_TEST56
+#define EXATN_TEST57
+#define EXATN_TEST58
+#define EXATN_TEST59
+#define EXATN_TEST60
+#define EXATN_TEST61
+#define EXATN_TEST62
+#define EXATN_TEST63
+#define EXATN_TEST64
+#define EXATN_TEST65
+#define EXATN_TEST66
+#define EXATN_TEST67
+#define EXATN_TEST68
+#define EXATN_TEST69
+#define EXATN_TEST70
+#define EXATN_TEST71
+#define EXATN_TEST72
+#define EXATN_TEST73
+#define EXATN_TEST74
+#define EXATN_TEST75
+#define EXATN_TEST76
+#define EXATN_TEST77
+#define EXATN_TEST78
+#define EXATN_TEST79
+#define EXATN_TEST80
+#define EXATN_TEST81
+#define EXATN_TEST82
+#define EXATN_TEST83
+#define EXATN_TEST84
+#define EXATN_TEST85
+#define EXATN_TEST86
+#define EXATN_TEST87
+#define EXATN_TEST88
+#define EXATN_TEST89
+#define EXATN_TEST90
+#define EXATN_TEST91
+#define EXATN_TEST92
+#define EXATN_TEST93
+#define EXATN_TEST94
+#define EXATN_TEST95
+#define EXATN_TEST96
+#define EXATN_TEST97
+#define EXATN_TEST98
 
 
 #ifdef EXATN_TEST0
@@ -4398,6 +4467,3165 @@ TEST(NumServerTester, TensorComposite) {
 }
 #endif
 
+#ifdef EXATN_TEST35
+TEST(NumServerTester, CaptureReplay) {
+ using exatn::TensorShape;
+ using exatn::TensorSignature;
+ using exatn::Tensor;
+ using exatn::TensorNetwork;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const exatn::DimExtent DIM = 16;
+
+ //exatn::resetLoggingLevel(1,2); //debug
+
+ bool success = true;
+
+ //Create and initialize tensors:
+ success = exatn::createTensor("A",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::createTensor("B",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::createTensor("C",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::createTensor("D",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::initTensor("A",1.0); assert(success);
+ success = exatn::initTensor("B",1.0); assert(success);
+ success = exatn::initTensor("C",0.0); assert(success);
+ success = exatn::initTensor("D",3.0); assert(success);
+
+ //Capture the tensor network evaluation:
+ success = exatn::beginCapture("MatMul"); assert(success);
+ success = exatn::evaluateTensorNetwork("MatMul","C(i,j)+=A(i,k)*B(k,j)"); assert(success);
+ success = exatn::endCapture(); assert(success);
+ double norm = 0.0;
+ success = exatn::computeNorm1Sync("C",norm); assert(success);
+ std::cout << "Captured evaluation 1-norm = " << norm << std::endl;
+ EXPECT_NEAR(norm,static_cast<double>(DIM*DIM*DIM),1e-6);
+
+ //Replay the captured evaluation with updated tensor data:
+ success = exatn::initTensor("A",2.0); assert(success);
+ success = exatn::replay("MatMul"); assert(success);
+ success = exatn::computeNorm1Sync("C",norm); assert(success);
+ std::cout << "Replayed evaluation 1-norm = " << norm << std::endl;
+ EXPECT_NEAR(norm,static_cast<double>(2*DIM*DIM*DIM),1e-6);
+
+ //Replay the captured evaluation with a substituted tensor:
+ success = exatn::replay("MatMul",{{"A",exatn::getTensor("D")}}); assert(success);
+ success = exatn::computeNorm1Sync("C",norm); assert(success);
+ std::cout << "Replayed evaluation 1-norm (rebound) = " << norm << std::endl;
+ EXPECT_NEAR(norm,static_cast<double>(3*DIM*DIM*DIM),1e-6);
+
+ success = exatn::destroyCapture("MatMul"); assert(success);
+
+ //Destroy tensors:
+ success = exatn::destroyTensor("D"); assert(success);
+ success = exatn::destroyTensor("C"); assert(success);
+ success = exatn::destroyTensor("B"); assert(success);
+ success = exatn::destroyTensor("A"); assert(success);
+
+ //Synchronize:
+ success = exatn::syncClean(); assert(success);
+ //exatn::resetLoggingLevel(0,0);
+ //Grab a beer!
+}
+#endif
+
+#ifdef EXATN_TEST36
+TEST(NumServerTester, RuntimeMetrics) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const exatn::DimExtent DIM = 16;
+
+ bool success = true;
+
+ exatn::resetRuntimeMetrics();
+
+ //Create, initialize and contract tensors:
+ success = exatn::createTensor("A",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::createTensor("B",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::createTensor("C",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::initTensor("A",1.0); assert(success);
+ success = exatn::initTensor("B",1.0); assert(success);
+ success = exatn::initTensor("C",0.0); assert(success);
+ success = exatn::contractTensors("C(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+ success = exatn::sync("C"); assert(success);
+
+ //Inspect the runtime performance counters:
+ const auto metrics = exatn::getRuntimeMetrics();
+ const auto & contractions = metrics.opcodes[static_cast<int>(TensorOpCode::CONTRACT)];
+ std::cout << "Executed tensor contractions = " << contractions.count
+           << "; Total latency = " << contractions.total_latency
+           << "; TRY_LATER postponements = " << metrics.num_postponed << std::endl;
+ EXPECT_GE(contractions.count,1);
+ std::size_t num_binned = 0;
+ for(const auto & num_ops: contractions.latency_histogram) num_binned += num_ops;
+ EXPECT_EQ(num_binned,contractions.count);
+ double flops = 0.0;
+ for(const auto & device: metrics.devices){
+  std::cout << "Device " << device.device << ": GFlop/s = " << device.gflops << std::endl;
+  flops += device.flops;
+ }
+ EXPECT_GE(flops,static_cast<double>(DIM*DIM*DIM));
+
+ //Destroy tensors:
+ success = exatn::destroyTensor("C"); assert(success);
+ success = exatn::destroyTensor("B"); assert(success);
+ success = exatn::destroyTensor("A"); assert(success);
+
+ //Synchronize:
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST37
+TEST(NumServerTester, ZeroCopyTensorView) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const exatn::DimExtent DIM = 8;
+
+ bool success = true;
+
+ success = exatn::createTensor("A",TENS_ELEM_TYPE,TensorShape{DIM,DIM,DIM}); assert(success);
+ success = exatn::initTensor("A",2.0); assert(success);
+
+ //View the tensor body without copying:
+ {
+  auto view = exatn::getTensorView("A");
+  EXPECT_FALSE(view.isEmpty());
+  EXPECT_EQ(view.getVolume(),DIM*DIM*DIM);
+  EXPECT_EQ(view.getDimExtents().size(),3);
+  const double * body = view.getData<double>();
+  double sum = 0.0;
+  for(std::size_t i = 0; i < view.getVolume(); ++i) sum += body[i];
+  EXPECT_NEAR(sum,2.0*DIM*DIM*DIM,1e-10);
+ } //view released: tensor unpinned
+
+ //The tensor can be updated once the view has been released:
+ success = exatn::scaleTensor("A",0.5); assert(success);
+ success = exatn::sync("A"); assert(success);
+ {
+  auto view = exatn::getTensorView("A");
+  EXPECT_NEAR(view.getData<double>()[0],1.0,1e-10);
+  view.release();
+ }
+
+ //Destroy tensors:
+ success = exatn::destroyTensor("A"); assert(success);
+
+ //Synchronize:
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST38
+TEST(NumServerTester, BatchedAmplitudes) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ bool success = true;
+
+ //Create tensors:
+ success = exatn::createTensor("A",TENS_ELEM_TYPE,TensorShape{2,2,4}); assert(success);
+ success = exatn::createTensor("B",TENS_ELEM_TYPE,TensorShape{4,2}); assert(success);
+ success = exatn::createTensor("R",TENS_ELEM_TYPE,TensorShape{2,2,2}); assert(success);
+ success = exatn::initTensorRnd("A"); assert(success);
+ success = exatn::initTensorRnd("B"); assert(success);
+ success = exatn::initTensor("R",0.0); assert(success);
+
+ //Evaluate the full output tensor for reference:
+ success = exatn::evaluateTensorNetworkSync("RefNet","R(a,b,c)+=A(a,b,i)*B(i,c)"); assert(success);
+ auto ref_tensor = exatn::getLocalTensor("R"); assert(ref_tensor);
+ const double * ref_body = nullptr;
+ auto access_granted = ref_tensor->getDataAccessHostConst(&ref_body); assert(access_granted);
+
+ //Evaluate a batch of amplitudes with different numbers of open legs:
+ exatn::TensorNetwork network("AmpNet","D(a,b,c)+=A(a,b,i)*B(i,c)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"D",exatn::makeSharedTensor("D",TensorShape{2,2,2})},
+   {"A",exatn::getTensor("A")},{"B",exatn::getTensor("B")}});
+ const std::vector<std::vector<exatn::DimOffset>> bitstrings{{0,1,1},{1,1,0},{0,0,1},{1,0,0},{1,1,1}};
+ for(unsigned int open_legs: {0,1,3}){
+  std::vector<std::complex<double>> amplitudes;
+  success = exatn::evaluateAmplitudesSync(network,bitstrings,amplitudes,open_legs); assert(success);
+  EXPECT_EQ(amplitudes.size(),bitstrings.size());
+  for(std::size_t n = 0; n < bitstrings.size(); ++n){
+   const auto & bits = bitstrings[n];
+   EXPECT_NEAR(amplitudes[n].real(),ref_body[bits[0] + 2*bits[1] + 4*bits[2]],1e-10);
+   EXPECT_NEAR(amplitudes[n].imag(),0.0,1e-10);
+  }
+ }
+ ref_body = nullptr;
+ ref_tensor.reset();
+
+ //Destroy tensors:
+ success = exatn::destroyTensor("R"); assert(success);
+ success = exatn::destroyTensor("B"); assert(success);
+ success = exatn::destroyTensor("A"); assert(success);
+
+ //Synchronize:
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+
+#ifdef EXATN_TEST39
+TEST(NumServerTester, ExactContractionSequence) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+
+ //Operator-times-MPS environment-like tensor network:
+ TensorNetwork network("EnvNet","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ TensorNetwork network_greed(network);
+ TensorNetwork network_metis(network);
+ double flops_dp = network.determineContractionSequence("dp");
+ double flops_greed = network_greed.determineContractionSequence("greed");
+ double flops_metis = network_metis.determineContractionSequence("metis");
+ std::cout << "Flop count (dp, greed, metis) = " << flops_dp << " " << flops_greed << " " << flops_metis << std::endl;
+ EXPECT_EQ(network.exportContractionSequence().size(),network.getNumTensors() - 1);
+ EXPECT_GT(flops_dp,0.0);
+ EXPECT_LE(flops_dp,flops_greed*(1.0+1e-12));
+ EXPECT_LE(flops_dp,flops_metis*(1.0+1e-12));
+}
+#endif
+
+
+#ifdef EXATN_TEST40
+TEST(NumServerTester, SlicingAwareContractionSequence) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContractionSeqOptimizer;
+
+ TensorNetwork network("SliceNet","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ const double max_volume = 64.0; //forces slicing
+ double flops = network.determineContractionSequence("metis",max_volume);
+ const auto & contr_seq = network.exportContractionSequence();
+ double num_slices = 0.0;
+ double unsliced_flops = ContractionSeqOptimizer::determineSlicedFlops(network,contr_seq,0.0,&num_slices);
+ EXPECT_NEAR(unsliced_flops,flops,flops*1e-12);
+ EXPECT_EQ(num_slices,1.0);
+ double sliced_flops = ContractionSeqOptimizer::determineSlicedFlops(network,contr_seq,max_volume,&num_slices);
+ std::cout << "Flop count (unsliced, sliced) = " << flops << " " << sliced_flops
+           << " with " << num_slices << " slices" << std::endl;
+ EXPECT_GE(sliced_flops,flops*(1.0-1e-12));
+ EXPECT_GT(num_slices,1.0);
+}
+#endif
+
+
+#ifdef EXATN_TEST41
+TEST(NumServerTester, StructuralContractionSeqCache) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContractionSeqOptimizer;
+ using exatn::numerics::ContrTriple;
+
+ TensorNetwork network1("CacheNet1","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ //Isomorphic tensor network with different tensor names and ids:
+ TensorNetwork network2("CacheNet2","W(x,y)+=P(l,f)*Q(k,e,l)*R(d,k,y)*S(a,b,c,d,e,f)*T(j,c)*U(i,b,j)*V(a,i,x)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"W",exatn::makeSharedTensor("W",TensorShape{2,2})},
+   {"P",exatn::makeSharedTensor("P",TensorShape{16,4})},
+   {"Q",exatn::makeSharedTensor("Q",TensorShape{16,4,16})},
+   {"R",exatn::makeSharedTensor("R",TensorShape{4,16,2})},
+   {"S",exatn::makeSharedTensor("S",TensorShape{4,4,4,4,4,4})},
+   {"T",exatn::makeSharedTensor("T",TensorShape{16,4})},
+   {"U",exatn::makeSharedTensor("U",TensorShape{16,4,16})},
+   {"V",exatn::makeSharedTensor("V",TensorShape{4,16,2})}});
+ double flops = network1.determineContractionSequence("metis");
+ bool success = ContractionSeqOptimizer::cacheContractionSequence(network1); EXPECT_TRUE(success);
+ std::list<ContrTriple> contr_seq;
+ double cached_flops = 0.0;
+ success = ContractionSeqOptimizer::findContractionSequence(network2,contr_seq,&cached_flops); EXPECT_TRUE(success);
+ EXPECT_EQ(cached_flops,flops);
+ EXPECT_EQ(contr_seq.size(),network2.getNumTensors() - 1);
+ //Replay the remapped tensor contraction sequence on the second tensor network:
+ TensorNetwork net(network2);
+ double replay_flops = 0.0;
+ for(const auto & contr: contr_seq){
+  replay_flops += net.getContractionCost(contr.left_id,contr.right_id);
+  if(contr.result_id != 0){
+   success = net.mergeTensors(contr.left_id,contr.right_id,contr.result_id); EXPECT_TRUE(success);
+  }
+ }
+ EXPECT_NEAR(replay_flops,flops,flops*1e-12);
+ success = ContractionSeqOptimizer::eraseContractionSequence(network2); EXPECT_TRUE(success);
+ success = ContractionSeqOptimizer::findContractionSequence(network1,contr_seq); EXPECT_FALSE(success);
+}
+#endif
+
+
+#ifdef EXATN_TEST42
+TEST(NumServerTester, PersistentContractionSeqCache) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContractionSeqOptimizer;
+ using exatn::numerics::ContrTriple;
+
+ const std::string db_file("test_cseq_cache.exatn");
+ std::remove(db_file.c_str());
+ ContractionSeqOptimizer::activatePersistentCaching(true,db_file);
+
+ TensorNetwork network1("DbNet1","Z(x)+=A(a,i,x)*B(i,b,j)*C(j,a,b)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,8,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{8,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4,4})}});
+ TensorNetwork network2("DbNet2","W(x)+=P(j,a,b)*Q(a,i,x)*R(i,b,j)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"W",exatn::makeSharedTensor("W",TensorShape{2})},
+   {"P",exatn::makeSharedTensor("P",TensorShape{16,4,4})},
+   {"Q",exatn::makeSharedTensor("Q",TensorShape{4,8,2})},
+   {"R",exatn::makeSharedTensor("R",TensorShape{8,4,16})}});
+ double flops = network1.determineContractionSequence("dp");
+ bool success = ContractionSeqOptimizer::cacheContractionSequence(network1); EXPECT_TRUE(success);
+ success = ContractionSeqOptimizer::eraseContractionSequence(network1); EXPECT_TRUE(success);
+
+ //Reload the persistent database:
+ std::vector<char> db_content;
+ success = ContractionSeqOptimizer::readPersistentCache(db_content); EXPECT_TRUE(success);
+ EXPECT_EQ(ContractionSeqOptimizer::importPersistentCache(db_content),1);
+ EXPECT_EQ(ContractionSeqOptimizer::importPersistentCache(db_content),0); //duplicates are ignored
+ std::list<ContrTriple> contr_seq;
+ double cached_flops = 0.0;
+ success = ContractionSeqOptimizer::findContractionSequence(network2,contr_seq,&cached_flops); EXPECT_TRUE(success);
+ EXPECT_EQ(cached_flops,flops);
+ EXPECT_EQ(contr_seq.size(),2);
+
+ //Torn records are ignored:
+ db_content.pop_back();
+ success = ContractionSeqOptimizer::eraseContractionSequence(network2); EXPECT_TRUE(success);
+ EXPECT_EQ(ContractionSeqOptimizer::importPersistentCache(db_content),0);
+
+ ContractionSeqOptimizer::activatePersistentCaching(false);
+ std::remove(db_file.c_str());
+}
+#endif
+
+
+#ifdef EXATN_TEST43
+TEST(NumServerTester, ConcurrentContractionSeqCache) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContractionSeqOptimizer;
+ using exatn::numerics::ContrTriple;
+
+ TensorNetwork network("ShardNet","Z(x)+=A(a,i,x)*B(i,b,j)*C(j,a,b)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,8,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{8,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4,4})}});
+ double flops = network.determineContractionSequence("dp");
+ ContractionSeqOptimizer::resetCacheStatistics();
+ bool success = ContractionSeqOptimizer::cacheContractionSequence(network,true,1.0); EXPECT_TRUE(success);
+
+ //Concurrent lookups by multiple threads:
+ const int num_threads = 4, num_lookups = 16;
+ std::atomic<int> num_found{0};
+ std::vector<std::thread> threads;
+ for(int i = 0; i < num_threads; ++i){
+  threads.emplace_back([&](){
+   TensorNetwork net(network);
+   for(int j = 0; j < num_lookups; ++j){
+    std::list<ContrTriple> contr_seq;
+    double cached_flops = 0.0;
+    if(ContractionSeqOptimizer::findContractionSequence(net,contr_seq,&cached_flops) && cached_flops == flops) ++num_found;
+   }
+  });
+ }
+ for(auto & thread: threads) thread.join();
+ EXPECT_EQ(num_found.load(),num_threads*num_lookups);
+ auto stats = ContractionSeqOptimizer::getCacheStatistics();
+ EXPECT_EQ(stats.hits,num_threads*num_lookups);
+ EXPECT_EQ(stats.insertions,1);
+ EXPECT_NEAR(stats.saved_time,num_threads*num_lookups,1e-3);
+
+ //Zero capacity evicts everything:
+ ContractionSeqOptimizer::resetCacheCapacity(0);
+ std::list<ContrTriple> contr_seq;
+ success = ContractionSeqOptimizer::findContractionSequence(network,contr_seq); EXPECT_FALSE(success);
+ stats = ContractionSeqOptimizer::getCacheStatistics();
+ EXPECT_EQ(stats.entries,0);
+ EXPECT_EQ(stats.misses,1);
+ ContractionSeqOptimizer::resetCacheCapacity(ContractionSeqOptimizer::DEFAULT_CACHE_CAPACITY);
+}
+#endif
+
+
+#ifdef EXATN_TEST44
+TEST(NumServerTester, IncrementalContractionSeqRepair) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContrTriple;
+
+ TensorNetwork network("RepairNet","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ double flops = network.determineContractionSequence("dp"); EXPECT_GT(flops,0.0);
+ //Delete one tensor and repair the tensor contraction sequence:
+ bool success = network.deleteTensor(7); EXPECT_TRUE(success);
+ flops = network.determineContractionSequence("dp"); EXPECT_GT(flops,0.0);
+ const auto & contr_seq = network.exportContractionSequence();
+ EXPECT_EQ(contr_seq.size(),network.getNumTensors() - 1);
+ EXPECT_EQ(contr_seq.back().result_id,0);
+ //Replay the repaired tensor contraction sequence:
+ TensorNetwork net(network);
+ double replay_flops = 0.0;
+ for(const auto & contr: contr_seq){
+  replay_flops += net.getContractionCost(contr.left_id,contr.right_id);
+  if(contr.result_id != 0){
+   success = net.mergeTensors(contr.left_id,contr.right_id,contr.result_id); EXPECT_TRUE(success);
+  }
+ }
+ EXPECT_NEAR(replay_flops,flops,flops*1e-9);
+}
+#endif
+
+
+#ifdef EXATN_TEST45
+TEST(NumServerTester, AnytimeContractionSequence) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+
+ TensorNetwork network("AnytimeNet","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ TensorNetwork reference(network);
+ const double optimal_flops = reference.determineContractionSequence("dp");
+ //The anytime search keeps running until the time budget expires:
+ const double time_budget = 0.25;
+ const auto time_start = std::chrono::steady_clock::now();
+ double flops = network.determineContractionSequence("metis",0.0,time_budget);
+ const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - time_start;
+ EXPECT_GE(elapsed.count(),time_budget);
+ EXPECT_GE(flops,optimal_flops*(1.0-1e-9));
+ EXPECT_EQ(network.exportContractionSequence().size(),network.getNumTensors() - 1);
+}
+#endif
+
+
+#ifdef EXATN_TEST46
+TEST(NumServerTester, AutoContractionSeqOptimizer) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContractionSeqOptimizerAuto;
+
+ //Small tensor network: Exact search:
+ TensorNetwork small("AutoSmall","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ EXPECT_EQ(ContractionSeqOptimizerAuto::selectOptimizer(small),"dp");
+ TensorNetwork reference(small);
+ const double flops = small.determineContractionSequence("auto");
+ EXPECT_EQ(flops,reference.determineContractionSequence("dp"));
+
+ //Long matrix product state chain: Greedy search:
+ const unsigned int num_sites = 24;
+ TensorNetwork chain("AutoChain");
+ bool success = true;
+ for(unsigned int i = 0; i < num_sites; ++i){
+  const auto name = "T" + std::to_string(i);
+  if(i == 0){
+   success = chain.appendTensor(i+1,exatn::makeSharedTensor(name,TensorShape{2,8}),{}); EXPECT_TRUE(success);
+  }else{
+   const auto rank = chain.getTensor(0)->getRank();
+   const TensorShape shape = (i < num_sites - 1) ? TensorShape{8,2,8} : TensorShape{8,2};
+   success = chain.appendTensor(i+1,exatn::makeSharedTensor(name,shape),{{rank-1,0}}); EXPECT_TRUE(success);
+  }
+ }
+ ContractionSeqOptimizerAuto::NetworkFeatures features;
+ EXPECT_EQ(ContractionSeqOptimizerAuto::selectOptimizer(chain,&features),"greed");
+ EXPECT_EQ(features.num_tensors,num_sites);
+ EXPECT_LE(features.treewidth,2);
+ EXPECT_GT(chain.determineContractionSequence("auto"),0.0);
+}
+#endif
+
+
+#ifdef EXATN_TEST47
+TEST(NumServerTester, FlatNetworkConnectivity) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::TensorNetworkFlat;
+
+ TensorNetwork network("FlatNet","Z(x,y)+=A(a,i,x)*B(i,b,j)*C(j,c)*H(a,b,c,d,e,f)*D(d,k,y)*E(k,e,l)*F(l,f)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{2,2})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{4,16,2})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{16,4,16})},
+   {"C",exatn::makeSharedTensor("C",TensorShape{16,4})},
+   {"H",exatn::makeSharedTensor("H",TensorShape{4,4,4,4,4,4})},
+   {"D",exatn::makeSharedTensor("D",TensorShape{4,16,2})},
+   {"E",exatn::makeSharedTensor("E",TensorShape{16,4,16})},
+   {"F",exatn::makeSharedTensor("F",TensorShape{16,4})}});
+ const TensorNetworkFlat flat(network);
+ EXPECT_EQ(flat.getNumTensors(),network.getNumTensors());
+ EXPECT_EQ(flat.getNumEdges(),12);
+ EXPECT_EQ(flat.getTensorId(0),0);
+ EXPECT_EQ(flat.getRank(flat.getVertex(4)),6);
+ //Simulated flop count coincides with the replayed one:
+ double flops = network.determineContractionSequence("greed");
+ std::vector<double> contr_flops;
+ EXPECT_NEAR(flat.simulateContractionSequence(network.exportContractionSequence(),&contr_flops),flops,flops*1e-12);
+ EXPECT_EQ(contr_flops.size(),network.getNumTensors() - 1);
+ EXPECT_LT(flat.simulateContractionSequence(network.exportContractionSequence(),nullptr,
+                                            [](double flops_so_far){return true;}),0.0);
+}
+#endif
+
+#ifdef EXATN_TEST48
+TEST(NumServerTester, CopyOnWriteExpansion) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::TensorExpansion;
+
+ auto network = exatn::makeSharedTensorNetwork("CowNet","Z(i,j)+=A(i,k)*B(k,j)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"Z",exatn::makeSharedTensor("Z",TensorShape{8,8})},
+   {"A",exatn::makeSharedTensor("A",TensorShape{8,8})},
+   {"B",exatn::makeSharedTensor("B",TensorShape{8,8})}});
+ TensorExpansion expansion("CowExp",network,{1.0,0.0});
+ //Copies share the tensor network:
+ TensorExpansion copy(expansion);
+ EXPECT_EQ(copy.cbegin()->network.get(),expansion.cbegin()->network.get());
+ //Modification of a copy duplicates the shared tensor network:
+ copy.markOptimizableAllTensors();
+ EXPECT_NE(copy.cbegin()->network.get(),expansion.cbegin()->network.get());
+ EXPECT_TRUE(copy.cbegin()->network->getTensorConn(1)->isOptimizable());
+ EXPECT_FALSE(expansion.cbegin()->network->getTensorConn(1)->isOptimizable());
+ //The last owner modifies the tensor network in place:
+ expansion.markOptimizableAllTensors();
+ EXPECT_EQ(expansion.cbegin()->network.get(),network.get());
+}
+#endif
+
+
+#ifdef EXATN_TEST49
+TEST(NumServerTester, SharedIntermediatesExpansion) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+ using exatn::TensorExpansion;
+ using exatn::numerics::ContrTriple;
+ using exatn::numerics::TensorNetworkFlat;
+ using exatn::numerics::TensorExpansionPlanner;
+
+ bool success = true;
+ for(const auto & name: {"SA","SB","SC","SD","SE"}){
+  success = exatn::createTensorSync(name,TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+  success = exatn::initTensorSync(name,(std::string(name) == "SE") ? 0.2 : 0.1); assert(success);
+ }
+ success = exatn::createTensorSync("SACC",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::initTensorSync("SACC",0.0); assert(success);
+
+ //Two tensor networks sharing the sub-network SA*SB*SC:
+ const std::list<ContrTriple> contr_seq{{5,1,2},{6,5,3},{0,6,4}};
+ TensorExpansion expansion("SharedExpansion");
+ for(const auto & name: {"SD","SE"}){
+  auto network = exatn::makeSharedTensorNetwork(std::string("Shared") + name,
+   std::string("Z") + name + "()+=SA(i,j)*SB(j,k)*SC(k,l)*" + name + "(l,i)",
+   std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+    {std::string("Z") + name,exatn::makeSharedTensor(std::string("Z") + name,TensorShape{})},
+    {"SA",exatn::getTensor("SA")},{"SB",exatn::getTensor("SB")},
+    {"SC",exatn::getTensor("SC")},{name,exatn::getTensor(name)}});
+  network->importContractionSequence(contr_seq,TensorNetworkFlat(*network).simulateContractionSequence(contr_seq));
+  success = expansion.appendComponent(network,{1.0,0.0}); assert(success);
+ }
+ TensorExpansionPlanner planner(expansion);
+ EXPECT_EQ(planner.getNumSharedIntermediates(),1);
+ EXPECT_EQ(planner.getSharedIntermediate(0).num_uses,2);
+ EXPECT_LT(planner.getPlannedFlops(),planner.getOriginalFlops());
+
+ //Evaluate the tensor expansion with the reuse of shared intermediates:
+ exatn::activateIntermediateSharing();
+ success = exatn::evaluateSync(expansion,exatn::getTensor("SACC")); assert(success);
+ exatn::deactivateIntermediateSharing();
+ auto talsh_tensor = exatn::getLocalTensor("SACC");
+ const double * body_ptr;
+ auto access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); assert(access_granted);
+ EXPECT_NEAR(*body_ptr,4096.0*(1e-4 + 2e-4),1e-10);
+ body_ptr = nullptr;
+
+ success = exatn::destroyTensorSync("SACC"); assert(success);
+ for(const auto & name: {"SA","SB","SC","SD","SE"}){
+  success = exatn::destroyTensorSync(name); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+
+#ifdef EXATN_TEST50
+TEST(NumServerTester, FusedExpansionEvaluation) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+ using exatn::TensorExpansion;
+
+ bool success = true;
+ for(const auto & name: {"FA","FB","FC","FD","FE"}){
+  success = exatn::createTensorSync(name,TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+  success = exatn::initTensorSync(name,(std::string(name) == "FE") ? 0.2 : 0.1); assert(success);
+ }
+ success = exatn::createTensorSync("FACC",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::initTensorSync("FACC",1.0); assert(success);
+
+ //Two scaled tensor networks accumulating directly into the (non-zero) accumulator:
+ TensorExpansion expansion("FusedExpansion");
+ for(const auto & name: {"FD","FE"}){
+  auto network = exatn::makeSharedTensorNetwork(std::string("Fused") + name,
+   std::string("Z") + name + "()+=FA(i,j)*FB(j,k)*FC(k,l)*" + name + "(l,i)",
+   std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+    {std::string("Z") + name,exatn::makeSharedTensor(std::string("Z") + name,TensorShape{})},
+    {"FA",exatn::getTensor("FA")},{"FB",exatn::getTensor("FB")},
+    {"FC",exatn::getTensor("FC")},{name,exatn::getTensor(name)}});
+  success = expansion.appendComponent(network,{(std::string(name) == "FE") ? 2.0 : 1.0,0.0}); assert(success);
+ }
+ exatn::activateFusedExpansionEvaluation();
+ EXPECT_TRUE(exatn::queryFusedExpansionEvaluation());
+ success = exatn::evaluateSync(expansion,exatn::getTensor("FACC")); assert(success);
+ exatn::deactivateFusedExpansionEvaluation();
+ EXPECT_FALSE(exatn::getTensor("ZFD")); //output tensors of the components are not created
+ auto talsh_tensor = exatn::getLocalTensor("FACC");
+ const double * body_ptr;
+ auto access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); assert(access_granted);
+ EXPECT_NEAR(*body_ptr,1.0 + 4096.0*(1e-4 + 2.0*2e-4),1e-10);
+ body_ptr = nullptr;
+
+ success = exatn::destroyTensorSync("FACC"); assert(success);
+ for(const auto & name: {"FA","FB","FC","FD","FE"}){
+  success = exatn::destroyTensorSync(name); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST51
+TEST(NumServerTester, CheckpointRestart) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+ success = exatn::createTensorSync("CKA",TensorElementType::REAL64,TensorShape{4,3,5}); assert(success);
+ success = exatn::createTensorSync("CKB",TensorElementType::COMPLEX64,TensorShape{6,2}); assert(success);
+ success = exatn::initTensorRndSync("CKA"); assert(success);
+ success = exatn::initTensorSync("CKB",std::complex<double>{0.5,-0.25}); assert(success);
+ double norm_a = 0.0, norm_b = 0.0;
+ success = exatn::computeNorm2Sync("CKA",norm_a); assert(success);
+ success = exatn::computeNorm2Sync("CKB",norm_b); assert(success);
+
+ //Save both tensors, overwrite them, and restore them from the checkpoint:
+ success = exatn::saveTensors("tensors.ckpt",{"CKA","CKB"}); assert(success);
+ success = exatn::initTensorSync("CKA",0.0); assert(success);
+ success = exatn::initTensorSync("CKB",0.0); assert(success);
+ success = exatn::loadTensors("tensors.ckpt"); assert(success);
+ double norm = 0.0;
+ success = exatn::computeNorm2Sync("CKA",norm); assert(success);
+ EXPECT_NEAR(norm,norm_a,1e-12);
+ success = exatn::computeNorm2Sync("CKB",norm); assert(success);
+ EXPECT_NEAR(norm,norm_b,1e-12);
+
+ success = exatn::destroyTensorSync("CKB"); assert(success);
+ success = exatn::destroyTensorSync("CKA"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST52
+TEST(NumServerTester, BalancedTensorMapping) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+ const auto & all_processes = exatn::getDefaultProcessGroup();
+ exatn::resetTensorMapping(exatn::TensorMapping::BALANCED);
+
+ //Uneven bisections (odd extents) of composite tensors:
+ success = exatn::createTensorSync(all_processes,"BMA",
+                                   std::vector<std::pair<unsigned int, unsigned int>>{{0,2},{1,2}},
+                                   TensorElementType::REAL64,TensorShape{37,23}); assert(success);
+ success = exatn::createTensorSync(all_processes,"BMB",
+                                   std::vector<std::pair<unsigned int, unsigned int>>{{0,2},{1,2}},
+                                   TensorElementType::REAL64,TensorShape{37,23}); assert(success);
+ success = exatn::initTensorSync("BMA",1e-2); assert(success);
+ success = exatn::initTensorSync("BMB",0.0); assert(success);
+ success = exatn::addTensorsSync("BMB(i,j)+=BMA(i,j)",1.0); assert(success);
+ double norm_a = 0.0, norm_b = 0.0;
+ success = exatn::computeNorm2Sync("BMA",norm_a); assert(success);
+ success = exatn::computeNorm2Sync("BMB",norm_b); assert(success);
+ EXPECT_NEAR(norm_a,norm_b,1e-12);
+
+ success = exatn::destroyTensorSync("BMB"); assert(success);
+ success = exatn::destroyTensorSync("BMA"); assert(success);
+ exatn::resetTensorMapping(exatn::TensorMapping::FIXED);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST53
+TEST(NumServerTester, TensorRedistribution) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+ const auto & all_processes = exatn::getDefaultProcessGroup();
+
+ //Composite tensor redistributed to a different decomposition:
+ success = exatn::createTensorSync(all_processes,"RDA",
+                                   std::vector<std::pair<unsigned int, unsigned int>>{{0,1},{1,1}},
+                                   TensorElementType::COMPLEX64,TensorShape{21,14,9}); assert(success);
+ success = exatn::initTensorRndSync("RDA"); assert(success);
+ double norm0 = 0.0, norm1 = 0.0, norm2 = 0.0;
+ success = exatn::computeNorm2Sync("RDA",norm0); assert(success);
+ success = exatn::redistributeTensorSync("RDA",all_processes,
+                                         std::vector<std::pair<unsigned int, unsigned int>>{{2,2}}); assert(success);
+ success = exatn::computeNorm2Sync("RDA",norm1); assert(success);
+ EXPECT_NEAR(norm0,norm1,1e-10);
+
+ //Composite tensor redistributed to a simple replicated tensor:
+ success = exatn::redistributeTensorSync("RDA",all_processes); assert(success);
+ success = exatn::computeNorm2Sync("RDA",norm2); assert(success);
+ EXPECT_NEAR(norm0,norm2,1e-10);
+
+ success = exatn::destroyTensorSync("RDA"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+
+#ifdef EXATN_TEST54
+TEST(NumServerTester, ExaTensorBackend) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL32;
+
+ const int NUM_REPEATS = 5;
+
+ bool success = exatn::syncClean(); assert(success);
+
+ //The same tensor network (DAG) is executed by the default and the ExaTENSOR node executors:
+ std::vector<double> norms;
+ for(const std::string backend: {"default","exatensor"}){
+  exatn::switchComputationalBackend(backend);
+  success = exatn::createTensor("A",TENS_ELEM_TYPE,TensorShape{64,64,64,64}); assert(success);
+  success = exatn::createTensor("B",TENS_ELEM_TYPE,TensorShape{64,64,64}); assert(success);
+  success = exatn::createTensor("C",TENS_ELEM_TYPE,TensorShape{64,64,64}); assert(success);
+  success = exatn::createTensor("D",TENS_ELEM_TYPE,TensorShape{64,64,64,64}); assert(success);
+  success = exatn::initTensor("A",1e-2); assert(success);
+  success = exatn::initTensor("B",2e-2); assert(success);
+  success = exatn::initTensor("C",3e-2); assert(success);
+  success = exatn::initTensor("D",0.0); assert(success);
+  success = exatn::sync(); assert(success);
+  std::cout << "Testing tensor network execution via " << backend << " backend ...\n";
+  int num_repeats = NUM_REPEATS;
+  while(--num_repeats >= 0){
+   std::cout << "D(m,x,n,y)+=A(m,h,k,n)*B(u,k,h)*C(x,u,y): ";
+   auto flops = exatn::getTotalFlopCount();
+   auto time_start = exatn::Timer::timeInSecHR();
+   success = exatn::evaluateTensorNetwork("exNet","D(m,x,n,y)+=A(m,h,k,n)*B(u,k,h)*C(x,u,y)"); assert(success);
+   success = exatn::sync("D",true); assert(success);
+   auto duration = exatn::Timer::timeInSecHR(time_start);
+   flops = exatn::getTotalFlopCount() - flops;
+   std::cout << "Duration = " << duration << " s; GFlop count = " << flops/1e9
+             << "; Performance = " << (flops / (1e9 * duration)) << " Gflop/s\n";
+  }
+  double norm = 0.0;
+  success = exatn::computeNorm1Sync("D",norm); assert(success);
+  std::cout << "1-norm of tensor D = " << norm << std::endl;
+  norms.emplace_back(norm);
+  success = exatn::destroyTensor("D"); assert(success);
+  success = exatn::destroyTensor("C"); assert(success);
+  success = exatn::destroyTensor("B"); assert(success);
+  success = exatn::destroyTensor("A"); assert(success);
+  success = exatn::syncClean(); assert(success);
+ }
+ exatn::switchComputationalBackend("default");
+ EXPECT_NEAR(norms[0],norms[1],norms[0]*1e-5);
+}
+#endif
+
+#ifdef EXATN_TEST55
+TEST(NumServerTester, SweepEnvironments) {
+ using exatn::TensorElementType;
+ using exatn::TensorRange;
+ using exatn::quantum::Gate;
+ using exatn::quantum::PauliMap;
+ using exatn::quantum::PauliProduct;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ const std::complex<double> j_param {-1.0,0.0};
+ const std::complex<double> h_param {-0.5,0.0};
+ const int num_spin_sites = 8;
+ const int max_bond_dim = 4;
+ const double accuracy = 1e-4;
+
+ bool success = exatn::syncClean(); assert(success);
+
+ //Define the 1D transverse field Ising Hamiltonian generator:
+ TensorRange spin_sites({num_spin_sites});
+ auto ising_generator = [j_param,h_param,
+                         spin_sites,
+                         num_sites = spin_sites.localVolume(),
+                         transverse = false,
+                         finished = false] () mutable -> PauliProduct {
+  PauliProduct pauli_product;
+  if(!finished){
+   const auto spin_site = spin_sites.localOffset();
+   if(transverse){
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_X,spin_site});
+    pauli_product.coefficient = h_param;
+    if(spin_site < (num_sites - 1)) spin_sites.next(); else finished = true;
+   }else{
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_Z,spin_site});
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_Z,spin_site+1});
+    pauli_product.coefficient = j_param;
+    if(spin_site < (num_sites - 2)){spin_sites.next();}else{spin_sites.reset(); transverse = true;}
+   }
+  }
+  return pauli_product;
+ };
+ auto hamiltonian = exatn::quantum::generateSpinHamiltonian("TransverseIsing",ising_generator,TENS_ELEM_TYPE);
+
+ //The same ground state search with and without cached sweep environments:
+ auto tn_builder = exatn::getTensorNetworkBuilder("MPS"); assert(tn_builder);
+ success = tn_builder->setParameter("max_bond_dim",max_bond_dim); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("TensorSpace",std::vector<int>(num_spin_sites,2));
+ std::vector<double> energies;
+ for(const bool sweep: {false,true}){
+  auto vec_net = exatn::makeSharedTensorNetwork("VectorNet",ket_tensor,*tn_builder,false);
+  vec_net->markOptimizableAllTensors();
+  auto vec_tns = exatn::makeSharedTensorExpansion("VectorTNS",vec_net,std::complex<double>{1.0,0.0});
+  success = exatn::createTensorsSync(*vec_net,TENS_ELEM_TYPE); assert(success);
+  success = exatn::initTensorsRndSync(*vec_net); assert(success);
+  exatn::TensorNetworkOptimizer::resetDebugLevel(1,0);
+  exatn::TensorNetworkOptimizer optimizer(hamiltonian,vec_tns,accuracy);
+  optimizer.enableSweepEnvironments(sweep);
+  auto time_start = exatn::Timer::timeInSecHR();
+  bool converged = optimizer.optimize();
+  success = exatn::sync(); assert(success);
+  auto duration = exatn::Timer::timeInSecHR(time_start);
+  EXPECT_TRUE(converged);
+  energies.emplace_back(optimizer.getExpectationValue().real());
+  std::cout << "Ground state energy (sweep environments = " << sweep << ") = " << energies.back()
+            << ": Duration = " << duration << " s" << std::endl;
+  success = exatn::destroyTensorsSync(*vec_net); assert(success);
+ }
+ EXPECT_NEAR(energies[0],energies[1],1e-3);
+ success = exatn::destroyTensorsSync(); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST56
+TEST(NumServerTester, ReverseModeGradients) {
+ using exatn::TensorElementType;
+ using exatn::TensorExpansion;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ const int num_sites = 8;
+ const int max_bond_dim = 8;
+
+ bool success = exatn::syncClean(); assert(success);
+
+ //Build the closed tensor network expansion <x|x> for an MPS vector:
+ auto tn_builder = exatn::getTensorNetworkBuilder("MPS"); assert(tn_builder);
+ success = tn_builder->setParameter("max_bond_dim",max_bond_dim); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("TensorSpace",std::vector<int>(num_sites,2));
+ auto ket_net = exatn::makeSharedTensorNetwork("KetNet",ket_tensor,*tn_builder,false);
+ auto ket = exatn::makeSharedTensorExpansion("Ket",ket_net,std::complex<double>{1.0,0.0});
+ success = exatn::createTensorsSync(*ket_net,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorsRndSync(*ket_net); assert(success);
+ TensorExpansion bra(*ket);
+ bra.conjugate();
+ auto norm = std::make_shared<TensorExpansion>(bra,*ket);
+
+ //Create the gradient tensors:
+ std::vector<std::pair<std::string,std::shared_ptr<exatn::Tensor>>> gradients;
+ for(auto iter = ket_net->cbegin(); iter != ket_net->cend(); ++iter){
+  if(iter->first != 0){
+   const auto & tensor = iter->second;
+   auto gradient = exatn::makeSharedTensor("_g" + tensor.getName(),tensor.getShape());
+   success = exatn::createTensorSync(gradient,TENS_ELEM_TYPE); assert(success);
+   gradients.emplace_back(std::make_pair(tensor.getName(),gradient));
+  }
+ }
+
+ //Compare with the derivative tensor network expansions, without and with checkpointing:
+ exatn::TensorNetworkDifferentiator differentiator(norm);
+ for(const std::size_t memory_limit: {std::size_t{0},std::size_t{1024}}){
+  differentiator.resetMemoryLimit(memory_limit);
+  for(const auto & gradient: gradients){
+   success = exatn::initTensorSync(gradient.second->getName(),0.0); assert(success);
+  }
+  std::complex<double> value{0.0,0.0};
+  success = differentiator.differentiate(gradients,true,&value); assert(success);
+  std::cout << "Memory limit = " << memory_limit << ": Norm = " << value
+            << "; Kept memory = " << differentiator.getKeptMemory()
+            << "; Recomputed intermediates = " << differentiator.getNumRecomputed() << std::endl;
+  if(memory_limit > 0){
+   EXPECT_GT(differentiator.getNumRecomputed(),0);
+  }
+  for(const auto & gradient: gradients){
+   TensorExpansion derivative(*norm,gradient.first,true);
+   auto reference = exatn::makeSharedTensor("_r" + gradient.first,gradient.second->getShape());
+   success = exatn::createTensorSync(reference,TENS_ELEM_TYPE); assert(success);
+   success = exatn::initTensorSync(reference->getName(),0.0); assert(success);
+   success = exatn::evaluateSync(derivative,reference); assert(success);
+   double ref_norm = 0.0;
+   success = exatn::computeNorm2Sync(reference->getName(),ref_norm); assert(success);
+   std::string add_pattern;
+   success = exatn::generate_addition_pattern(reference->getRank(),add_pattern,false,
+                                              reference->getName(),gradient.second->getName()); assert(success);
+   success = exatn::addTensorsSync(add_pattern,-1.0); assert(success);
+   double diff_norm = 0.0;
+   success = exatn::computeNorm2Sync(reference->getName(),diff_norm); assert(success);
+   EXPECT_LE(diff_norm,ref_norm*1e-10);
+   success = exatn::destroyTensorSync(reference->getName()); assert(success);
+  }
+ }
+
+ for(const auto & gradient: gradients){
+  success = exatn::destroyTensorSync(gradient.second->getName()); assert(success);
+ }
+ success = exatn::destroyTensorsSync(*ket_net); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST57
+TEST(NumServerTester, BlockEigenSolver) {
+ using exatn::TensorElementType;
+ using exatn::TensorExpansion;
+ using exatn::TensorRange;
+ using exatn::quantum::Gate;
+ using exatn::quantum::PauliMap;
+ using exatn::quantum::PauliProduct;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ const std::complex<double> j_param {-1.0,0.0};
+ const std::complex<double> h_param {-0.5,0.0};
+ const int num_spin_sites = 4;
+ const int max_bond_dim = 4;
+ const unsigned int block_size = 3;
+ const unsigned int num_roots = 2;
+
+ bool success = exatn::syncClean(); assert(success);
+
+ //Define the 1D transverse field Ising Hamiltonian generator:
+ TensorRange spin_sites({num_spin_sites});
+ auto ising_generator = [j_param,h_param,
+                         spin_sites,
+                         num_sites = spin_sites.localVolume(),
+                         transverse = false,
+                         finished = false] () mutable -> PauliProduct {
+  PauliProduct pauli_product;
+  if(!finished){
+   const auto spin_site = spin_sites.localOffset();
+   if(transverse){
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_X,spin_site});
+    pauli_product.coefficient = h_param;
+    if(spin_site < (num_sites - 1)) spin_sites.next(); else finished = true;
+   }else{
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_Z,spin_site});
+    pauli_product.product.emplace_back(PauliMap{Gate::gate_Z,spin_site+1});
+    pauli_product.coefficient = j_param;
+    if(spin_site < (num_sites - 2)){spin_sites.next();}else{spin_sites.reset(); transverse = true;}
+   }
+  }
+  return pauli_product;
+ };
+ auto hamiltonian = exatn::quantum::generateSpinHamiltonian("TransverseIsing",ising_generator,TENS_ELEM_TYPE);
+
+ //Build a block of random MPS vectors:
+ auto tn_builder = exatn::getTensorNetworkBuilder("MPS"); assert(tn_builder);
+ success = tn_builder->setParameter("max_bond_dim",max_bond_dim); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("TensorSpace",std::vector<int>(num_spin_sites,2));
+ std::vector<std::shared_ptr<TensorExpansion>> kets, bras;
+ for(unsigned int i = 0; i < block_size; ++i){
+  auto ket_net = exatn::makeSharedTensorNetwork("KetNet"+std::to_string(i),ket_tensor,*tn_builder,false);
+  ket_net->markOptimizableAllTensors();
+  kets.emplace_back(exatn::makeSharedTensorExpansion("Ket"+std::to_string(i),ket_net,std::complex<double>{1.0,0.0}));
+  success = exatn::createTensorsSync(*ket_net,TENS_ELEM_TYPE); assert(success);
+  success = exatn::initTensorsRndSync(*ket_net); assert(success);
+  bras.emplace_back(exatn::makeSharedTensorExpansion(*(kets.back())));
+  bras.back()->conjugate();
+ }
+
+ //Compare the fused matrix elements with the individually evaluated ones:
+ std::vector<std::complex<double>> oper_matrix, metr_matrix;
+ success = exatn::TensorNetworkEigenSolver::computeProjectedMatrices(exatn::getDefaultProcessGroup(),*hamiltonian,
+                                                                     kets,bras,oper_matrix,metr_matrix); assert(success);
+ auto scalar = exatn::makeSharedTensor("_scalar");
+ success = exatn::createTensorSync(scalar,TENS_ELEM_TYPE); assert(success);
+ for(unsigned int j = 0; j < block_size; ++j){
+  for(unsigned int i = 0; i < block_size; ++i){
+   TensorExpansion oper_elem(*(kets[j]),*(bras[i]),*hamiltonian);
+   success = exatn::initTensorSync("_scalar",0.0); assert(success);
+   success = exatn::evaluateSync(oper_elem,scalar); assert(success);
+   double oper_value = exatn::getLocalTensor("_scalar")->getSliceView<double>()[std::initializer_list<int>{}];
+   EXPECT_NEAR(oper_matrix[j*block_size + i].real(),oper_value,std::abs(oper_value)*1e-10);
+   TensorExpansion metr_elem(*(kets[j]),*(bras[i]));
+   success = exatn::initTensorSync("_scalar",0.0); assert(success);
+   success = exatn::evaluateSync(metr_elem,scalar); assert(success);
+   double metr_value = exatn::getLocalTensor("_scalar")->getSliceView<double>()[std::initializer_list<int>{}];
+   EXPECT_NEAR(metr_matrix[j*block_size + i].real(),metr_value,std::abs(metr_value)*1e-10);
+  }
+ }
+ success = exatn::destroyTensorSync("_scalar"); assert(success);
+
+ //Solve for the lowest eigenroots in block mode:
+ exatn::TensorNetworkEigenSolver::resetDebugLevel(1);
+ exatn::TensorNetworkEigenSolver eigensolver(hamiltonian,kets[0],1e-4);
+ eigensolver.resetMaxIterations(20);
+ const std::vector<double> * accuracy = nullptr;
+ success = eigensolver.solve(num_roots,&accuracy);
+ EXPECT_TRUE(success);
+ ASSERT_TRUE(accuracy != nullptr);
+ std::vector<std::complex<double>> eigenvalues(num_roots);
+ for(unsigned int k = 0; k < num_roots; ++k){
+  auto eigenvector = eigensolver.getEigenRoot(k,&(eigenvalues[k]));
+  EXPECT_TRUE(eigenvector);
+  std::cout << "Eigenvalue " << k << " = " << eigenvalues[k] << ": Accuracy = " << (*accuracy)[k] << std::endl;
+ }
+ EXPECT_LE(eigenvalues[0].real(),eigenvalues[1].real());
+
+ success = exatn::destroyTensorsSync(); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST58
+TEST(NumServerTester, CircuitSimplification) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::TensorElementType;
+ using exatn::quantum::Gate;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+
+ bool success = true;
+
+ //Quantum Circuit:
+ //Q0----H---------C----C--------
+ //Q1--------------N----N----S---
+ //Q2----X----X------------------
+ const std::vector<std::complex<double>> qzero {{1.0,0.0},{0.0,0.0}};
+ success = exatn::createTensorSync("Q",TENS_ELEM_TYPE,TensorShape{2}); assert(success);
+ success = exatn::initTensorDataSync("Q",qzero); assert(success);
+ success = exatn::createTensorSync("H",TENS_ELEM_TYPE,TensorShape{2,2}); assert(success);
+ success = exatn::initTensorDataSync("H",exatn::quantum::getGateData(Gate::gate_H)); assert(success);
+ success = exatn::createTensorSync("X",TENS_ELEM_TYPE,TensorShape{2,2}); assert(success);
+ success = exatn::initTensorDataSync("X",exatn::quantum::getGateData(Gate::gate_X)); assert(success);
+ success = exatn::createTensorSync("S",TENS_ELEM_TYPE,TensorShape{2,2}); assert(success);
+ success = exatn::initTensorDataSync("S",exatn::quantum::getGateData(Gate::gate_S)); assert(success);
+ success = exatn::createTensorSync("CNOT",TENS_ELEM_TYPE,TensorShape{2,2,2,2}); assert(success);
+ success = exatn::initTensorDataSync("CNOT",exatn::quantum::getGateData(Gate::gate_CX)); assert(success);
+ {
+  TensorNetwork circuit("Circuit");
+  success = circuit.appendTensor(1,exatn::getTensor("Q"),{}); assert(success);
+  success = circuit.appendTensor(2,exatn::getTensor("Q"),{}); assert(success);
+  success = circuit.appendTensor(3,exatn::getTensor("Q"),{}); assert(success);
+  success = circuit.appendTensorGate(4,exatn::getTensor("H"),{0}); assert(success);
+  success = circuit.appendTensorGate(5,exatn::getTensor("X"),{2}); assert(success);
+  success = circuit.appendTensorGate(6,exatn::getTensor("X"),{2}); assert(success);
+  success = circuit.appendTensorGate(7,exatn::getTensor("CNOT"),{1,0}); assert(success);
+  success = circuit.appendTensorGate(8,exatn::getTensor("CNOT"),{1,0}); assert(success);
+  success = circuit.appendTensorGate(9,exatn::getTensor("S"),{1}); assert(success);
+  const auto num_tensors = circuit.getNumTensors();
+  //Evaluate the original circuit:
+  TensorNetwork reference(circuit,true);
+  success = exatn::evaluateSync(reference); assert(success);
+  //Simplify the circuit and evaluate it:
+  std::vector<std::string> fused_tensors;
+  std::size_t num_removed = 0;
+  success = exatn::quantum::simplifyCircuitSync(exatn::getDefaultProcessGroup(),circuit,
+                                                &fused_tensors,&num_removed); assert(success);
+  std::cout << "Circuit simplification removed " << num_removed
+            << " out of " << num_tensors << " tensors" << std::endl;
+  assert(num_removed >= 4); //X*X and CNOT*CNOT are cancelled
+  success = exatn::evaluateSync(circuit); assert(success);
+  //Compare the output states:
+  auto ref_tensor = exatn::getLocalTensor(reference.getTensor(0)->getName()); assert(ref_tensor);
+  auto out_tensor = exatn::getLocalTensor(circuit.getTensor(0)->getName()); assert(out_tensor);
+  const auto ref_view = ref_tensor->getSliceView<std::complex<double>>();
+  const auto out_view = out_tensor->getSliceView<std::complex<double>>();
+  for(int i = 0; i < 2; ++i){
+   for(int j = 0; j < 2; ++j){
+    for(int k = 0; k < 2; ++k){
+     const auto diff = ref_view[std::initializer_list<int>{i,j,k}] - out_view[std::initializer_list<int>{i,j,k}];
+     assert(std::abs(diff) < 1e-7);
+    }
+   }
+  }
+  success = exatn::destroyTensorSync(circuit.getTensor(0)->getName()); assert(success);
+  success = exatn::destroyTensorSync(reference.getTensor(0)->getName()); assert(success);
+  for(const auto & name: fused_tensors){
+   success = exatn::destroyTensorSync(name); assert(success);
+  }
+ }
+ success = exatn::destroyTensorSync("CNOT"); assert(success);
+ success = exatn::destroyTensorSync("S"); assert(success);
+ success = exatn::destroyTensorSync("X"); assert(success);
+ success = exatn::destroyTensorSync("H"); assert(success);
+ success = exatn::destroyTensorSync("Q"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST59
+TEST(NumServerTester, BitstringSampling) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::TensorElementType;
+ using exatn::quantum::Gate;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+
+ const unsigned int num_qubits = 5;
+ const std::size_t num_samples = 64;
+
+ bool success = true;
+
+ //GHZ state preparation circuit:
+ const std::vector<std::complex<double>> qzero {{1.0,0.0},{0.0,0.0}};
+ success = exatn::createTensorSync("Q",TENS_ELEM_TYPE,TensorShape{2}); assert(success);
+ success = exatn::initTensorDataSync("Q",qzero); assert(success);
+ success = exatn::createTensorSync("H",TENS_ELEM_TYPE,TensorShape{2,2}); assert(success);
+ success = exatn::initTensorDataSync("H",exatn::quantum::getGateData(Gate::gate_H)); assert(success);
+ success = exatn::createTensorSync("CNOT",TENS_ELEM_TYPE,TensorShape{2,2,2,2}); assert(success);
+ success = exatn::initTensorDataSync("CNOT",exatn::quantum::getGateData(Gate::gate_CX)); assert(success);
+ {
+  TensorNetwork circuit("GHZ");
+  for(unsigned int i = 0; i < num_qubits; ++i){
+   success = circuit.appendTensor(i+1,exatn::getTensor("Q"),{}); assert(success);
+  }
+  success = circuit.appendTensorGate(exatn::getTensor("H"),{0}); assert(success);
+  for(unsigned int i = 1; i < num_qubits; ++i){
+   success = circuit.appendTensorGate(exatn::getTensor("CNOT"),{i,i-1}); assert(success);
+  }
+  //Sample qubit by qubit (conditional distributions with traced out qubits):
+  std::vector<std::vector<unsigned int>> samples;
+  std::size_t num_evaluations = 0;
+  success = exatn::quantum::sampleBitstringsSync(exatn::getDefaultProcessGroup(),circuit,num_samples,samples,
+                                                 1,exatn::quantum::DEFAULT_SAMPLING_SEED,&num_evaluations); assert(success);
+  std::cout << "Number of evaluated conditional distributions = " << num_evaluations << std::endl;
+  assert(samples.size() == num_samples);
+  assert(num_evaluations <= 1 + 2 * (num_qubits - 1)); //at most two distinct prefixes per qubit
+  std::size_t num_ones = 0;
+  for(const auto & bitstring: samples){
+   assert(bitstring.size() == num_qubits);
+   for(const auto bit: bitstring) assert(bit == bitstring[0]);
+   num_ones += bitstring[0];
+  }
+  assert(num_ones > 0 && num_ones < num_samples);
+  //Sample all qubits at once (amplitudes):
+  success = exatn::quantum::sampleBitstringsSync(exatn::getDefaultProcessGroup(),circuit,num_samples,samples,
+                                                 num_qubits,exatn::quantum::DEFAULT_SAMPLING_SEED,&num_evaluations); assert(success);
+  assert(num_evaluations == 1);
+  for(const auto & bitstring: samples){
+   for(const auto bit: bitstring) assert(bit == bitstring[0]);
+  }
+ }
+ success = exatn::destroyTensorSync("CNOT"); assert(success);
+ success = exatn::destroyTensorSync("H"); assert(success);
+ success = exatn::destroyTensorSync("Q"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST60
+TEST(NumServerTester, PreparedTensorOperations) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ const unsigned int num_iterations = 10;
+
+ bool success = true;
+
+ success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("E",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::initTensorSync("A",0.5); assert(success);
+ success = exatn::initTensorSync("B",0.25); assert(success);
+ success = exatn::initTensorSync("C",0.0); assert(success);
+ success = exatn::initTensorSync("D",0.0); assert(success);
+ success = exatn::initTensorSync("E",0.0); assert(success);
+ {
+  //Invalid specifications and missing tensors:
+  assert(!exatn::prepareContraction("C(i,j)+=A(i,k)*B(k,j"));
+  assert(!exatn::prepareContraction("C(i,j)+=A(i,k)*X(k,j)"));
+  //String-based contractions (parsed once, then cached):
+  for(unsigned int iter = 0; iter < num_iterations; ++iter){
+   success = exatn::contractTensors("C(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+  }
+  //Prepared contraction and addition:
+  auto contraction = exatn::prepareContraction("D(i,j)+=A(i,k)*B(k,j)"); assert(contraction);
+  auto addition = exatn::prepareAddition("E(i,j)+=D(i,j)"); assert(addition);
+  for(unsigned int iter = 0; iter < num_iterations; ++iter){
+   success = exatn::execute(contraction,1.0); assert(success);
+  }
+  success = exatn::executeSync(addition,0.5); assert(success);
+  double norm_c = 0.0, norm_d = 0.0, norm_e = 0.0;
+  success = exatn::computeNorm1Sync("C",norm_c); assert(success);
+  success = exatn::computeNorm1Sync("D",norm_d); assert(success);
+  success = exatn::computeNorm1Sync("E",norm_e); assert(success);
+  std::cout << "1-norms of the results: " << norm_c << " " << norm_d << " " << norm_e << std::endl;
+  assert(std::abs(norm_c - 640.0) < 1e-7);
+  assert(std::abs(norm_d - norm_c) < 1e-7);
+  assert(std::abs(norm_e - 320.0) < 1e-7);
+ }
+ success = exatn::destroyTensorSync("E"); assert(success);
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST61
+TEST(NumServerTester, ReproducibleRandomInit) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+
+ bool success = true;
+
+ double norms[3] = {0.0, 0.0, 0.0};
+ const std::uint64_t seeds[3] = {exatn::NumServer::DEFAULT_RANDOM_SEED, exatn::NumServer::DEFAULT_RANDOM_SEED, 12345};
+ for(int i = 0; i < 3; ++i){
+  exatn::resetRandomSeed(seeds[i]);
+  success = exatn::createTensorSync("R",TENS_ELEM_TYPE,TensorShape{16,8,4,2}); assert(success);
+  success = exatn::initTensorRndSync("R"); assert(success);
+  success = exatn::computeNorm2Sync("R",norms[i]); assert(success);
+  success = exatn::destroyTensorSync("R"); assert(success);
+ }
+ exatn::resetRandomSeed();
+ std::cout << "2-norms of the random tensors: " << norms[0] << " " << norms[1] << " " << norms[2] << std::endl;
+ //The same seed and tensor name reproduce the tensor bitwise:
+ assert(norms[0] == norms[1]);
+ assert(norms[2] != norms[0]);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST62
+TEST(NumServerTester, FusedTensorNorms) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+
+ const std::vector<std::string> names{"A","B","C","NONE"};
+ success = exatn::createTensorSync("A",TensorElementType::REAL64,TensorShape{16,8,4}); assert(success);
+ success = exatn::createTensorSync("B",TensorElementType::COMPLEX64,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("C",TensorElementType::REAL32,TensorShape{32}); assert(success);
+ for(int i = 0; i < 3; ++i){success = exatn::initTensorRndSync(names[i]); assert(success);}
+ std::vector<exatn::TensorNorms> norms;
+ success = exatn::computeNormsSync(names,norms); assert(success);
+ assert(norms.size() == names.size());
+ for(int i = 0; i < 3; ++i){
+  double norm1, norm2, max_abs;
+  success = exatn::computeNorm1Sync(names[i],norm1); assert(success);
+  success = exatn::computeNorm2Sync(names[i],norm2); assert(success);
+  success = exatn::computeMaxAbsSync(names[i],max_abs); assert(success);
+  std::cout << "Tensor " << names[i] << " norms: " << norms[i].norm1 << " " << norms[i].norm2
+            << " " << norms[i].max_abs << std::endl;
+  assert(std::abs(norms[i].norm1 - norm1) <= 1e-5 * norm1);
+  assert(std::abs(norms[i].norm2 - norm2) <= 1e-5 * norm2);
+  assert(std::abs(norms[i].max_abs - max_abs) <= 1e-5 * max_abs);
+ }
+ assert(norms[3].norm2 < 0.0);
+ for(int i = 2; i >= 0; --i){success = exatn::destroyTensorSync(names[i]); assert(success);}
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST63
+TEST(NumServerTester, DeviceTensorFunctor) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+
+ success = exatn::createTensorSync("D",TensorElementType::REAL64,TensorShape{8,8,8}); assert(success);
+ success = exatn::initTensorSync("D",2.0); assert(success);
+ //The device kernel is only invoked if the tensor body resides on a GPU (Host fallback otherwise):
+ int device_calls = 0;
+ auto functor = std::make_shared<exatn::numerics::FunctorDeviceKernel>(
+  std::make_shared<exatn::numerics::FunctorScale>(0.5),
+  [&device_calls](talsh::Tensor & local_tensor, void * device_body, int data_kind, int device_kind, int device_id){
+   ++device_calls;
+   return exatn::numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED; //fall back to the Host functor
+  });
+ success = exatn::transformTensorSync("D",functor); assert(success);
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("D",norm1); assert(success);
+ std::cout << "1-norm of the scaled tensor = " << norm1 << " (device kernel calls: " << device_calls << ")" << std::endl;
+ assert(std::abs(norm1 - 512.0) < 1e-9);
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST64
+TEST(NumServerTester, IsometrizeMethods) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::IsometrizeMethod;
+
+ bool success = true;
+
+ //Isometry over dimensions {0,2}: 16*32 rows, 24 columns:
+ for(auto method: {IsometrizeMethod::MGS, IsometrizeMethod::CHOLESKY_QR2}){
+  success = exatn::createTensorSync("Q",TensorElementType::COMPLEX64,TensorShape{16,24,32}); assert(success);
+  exatn::getTensor("Q")->registerIsometry({0,2});
+  success = exatn::createTensorSync("G",TensorElementType::COMPLEX64,TensorShape{24,24}); assert(success);
+  success = exatn::initTensorRndSync("Q"); assert(success);
+  success = exatn::isometrizeTensorSync("Q",method); assert(success);
+  success = exatn::initTensorSync("G",0.0); assert(success);
+  success = exatn::contractTensorsSync("G(a,b)+=Q+(i,a,j)*Q(i,b,j)",1.0); assert(success);
+  success = exatn::destroyTensorSync("Q"); assert(success);
+  double norm1 = 0.0, norm2 = 0.0;
+  success = exatn::computeNorm1Sync("G",norm1); assert(success);
+  success = exatn::computeNorm2Sync("G",norm2); assert(success);
+  std::cout << "Identity norms (method " << static_cast<int>(method) << "): "
+            << norm1 << " " << norm2*norm2 << " VS correct = 24" << std::endl;
+  assert(std::abs(norm1 - 24.0) < 1e-6 && std::abs(norm2*norm2 - 24.0) < 1e-6);
+  success = exatn::destroyTensorSync("G"); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST65
+TEST(NumServerTester, ScaledAccumulatingContraction) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ bool success = true;
+
+ success = exatn::createTensorSync("D",TensorElementType::REAL64,TensorShape{4,4}); assert(success);
+ success = exatn::createTensorSync("L",TensorElementType::REAL64,TensorShape{4,4}); assert(success);
+ success = exatn::createTensorSync("R",TensorElementType::REAL64,TensorShape{4,4}); assert(success);
+ success = exatn::initTensorSync("D",1.0); assert(success);
+ success = exatn::initTensorSync("L",1.0); assert(success);
+ success = exatn::initTensorSync("R",1.0); assert(success);
+ //D = 0.5 * D + 2.0 * L * R = 0.5 + 8.0 (elementwise):
+ std::shared_ptr<exatn::TensorOperation> op = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+ op->setTensorOperand(exatn::getTensor("D"));
+ op->setTensorOperand(exatn::getTensor("L"));
+ op->setTensorOperand(exatn::getTensor("R"));
+ op->setScalar(0,std::complex<double>{2.0,0.0});
+ op->setIndexPattern("D(a,b)+=L(a,c)*R(c,b)");
+ std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(op)->resetBeta(std::complex<double>{0.5,0.0});
+ auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup("D"));
+ success = exatn::numericalServer->submit(op,tensor_mapper); assert(success);
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("D",norm1); assert(success);
+ std::cout << "1-norm of the scaled accumulation = " << norm1 << " VS correct = " << 16.0 * 8.5 << std::endl;
+ assert(std::abs(norm1 - 16.0 * 8.5) < 1e-9);
+ //A scaling followed by an accumulating contraction (may be fused into the beta prefactor):
+ success = exatn::scaleTensor("D",0.0); assert(success);
+ success = exatn::contractTensorsSync("D(a,b)+=L(a,c)*R(c,b)",1.0); assert(success);
+ success = exatn::computeNorm1Sync("D",norm1); assert(success);
+ assert(std::abs(norm1 - 16.0 * 4.0) < 1e-9);
+ success = exatn::destroyTensorSync("R"); assert(success);
+ success = exatn::destroyTensorSync("L"); assert(success);
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+#ifdef EXATN_TEST66
+TEST(NumServerTester, MultiOutputNetworkBundle) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+ using exatn::numerics::ContrTriple;
+ using exatn::numerics::TensorNetworkFlat;
+ using exatn::numerics::TensorExpansionPlanner;
+
+ bool success = true;
+ for(const auto & name: {"MA","MB","MC","MD","ME"}){
+  success = exatn::createTensorSync(name,TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+  success = exatn::initTensorSync(name,(std::string(name) == "ME") ? 0.2 : 0.1); assert(success);
+ }
+ success = exatn::createTensorSync("MN",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::createTensorSync("MM",TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+
+ //Two tensor networks with different outputs (a scalar and a matrix) sharing the sub-network MA*MB*MC:
+ const std::list<ContrTriple> contr_seq{{5,1,2},{6,5,3},{0,6,4}};
+ std::vector<std::shared_ptr<TensorNetwork>> bundle;
+ bundle.emplace_back(exatn::makeSharedTensorNetwork("BundleNorm",
+  "MN()+=MA(i,j)*MB(j,k)*MC(k,l)*MD(l,i)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"MN",exatn::getTensor("MN")},{"MA",exatn::getTensor("MA")},{"MB",exatn::getTensor("MB")},
+   {"MC",exatn::getTensor("MC")},{"MD",exatn::getTensor("MD")}}));
+ bundle.emplace_back(exatn::makeSharedTensorNetwork("BundleMatrix",
+  "MM(l,m)+=MA(i,j)*MB(j,k)*MC(k,l)*ME(i,m)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"MM",exatn::getTensor("MM")},{"MA",exatn::getTensor("MA")},{"MB",exatn::getTensor("MB")},
+   {"MC",exatn::getTensor("MC")},{"ME",exatn::getTensor("ME")}}));
+ for(auto & network: bundle){
+  network->importContractionSequence(contr_seq,TensorNetworkFlat(*network).simulateContractionSequence(contr_seq));
+ }
+ TensorExpansionPlanner planner(bundle);
+ EXPECT_EQ(planner.getNumSharedIntermediates(),1);
+ EXPECT_EQ(planner.getSharedIntermediate(0).num_uses,2);
+ EXPECT_LT(planner.getPlannedFlops(),planner.getOriginalFlops());
+
+ //Evaluate both outputs with the reuse of the shared intermediate:
+ success = exatn::initTensorSync("MN",0.0); assert(success);
+ success = exatn::initTensorSync("MM",0.0); assert(success);
+ success = exatn::evaluateSync(bundle); assert(success);
+ auto talsh_tensor = exatn::getLocalTensor("MN");
+ const double * body_ptr;
+ auto access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); assert(access_granted);
+ EXPECT_NEAR(*body_ptr,4096.0*1e-4,1e-10);
+ body_ptr = nullptr;
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("MM",norm1); assert(success);
+ EXPECT_NEAR(norm1,64.0*8.0*0.064*0.2,1e-10);
+
+ success = exatn::destroyTensorSync("MM"); assert(success);
+ success = exatn::destroyTensorSync("MN"); assert(success);
+ for(const auto & name: {"MA","MB","MC","MD","ME"}){
+  success = exatn::destroyTensorSync(name); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+#ifdef EXATN_TEST67
+TEST(NumServerTester, InPlaceBondGrowth) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorLeg;
+ using exatn::numerics::BondAdaptivity;
+
+ bool success = true;
+ success = exatn::createTensorSync("RA",TensorElementType::REAL64,TensorShape{4,4}); assert(success);
+ success = exatn::createTensorSync("RB",TensorElementType::REAL64,TensorShape{4,4}); assert(success);
+ success = exatn::createTensorSync("RZ",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::initTensorSync("RA",1.0); assert(success);
+ success = exatn::initTensorSync("RB",1.0); assert(success);
+ auto tensor_a = exatn::getTensor("RA");
+
+ //Growth (zero padding) and shrinking keep the tensor identity and the retained block:
+ double norm1 = 0.0;
+ success = exatn::resizeTensorSync("RA",1,6); assert(success);
+ EXPECT_EQ(exatn::getTensor("RA"),tensor_a);
+ EXPECT_EQ(tensor_a->getDimExtent(1),6);
+ success = exatn::computeNorm1Sync("RA",norm1); assert(success);
+ EXPECT_NEAR(norm1,16.0,1e-10);
+ success = exatn::resizeTensorSync("RA",1,2); assert(success);
+ success = exatn::computeNorm1Sync("RA",norm1); assert(success);
+ EXPECT_NEAR(norm1,8.0,1e-10);
+ success = exatn::resizeTensorSync("RA",1,4); assert(success);
+ success = exatn::initTensorSync("RA",1.0); assert(success);
+
+ //Bond adaptivity step on a tensor network with in-place tensor growth:
+ auto network = exatn::makeSharedTensorNetwork("AdaptiveNetwork","RZ()+=RA(i,j)*RB(j,i)",
+  std::map<std::string,std::shared_ptr<exatn::Tensor>>{
+   {"RZ",exatn::getTensor("RZ")},{"RA",exatn::getTensor("RA")},{"RB",exatn::getTensor("RB")}});
+ auto bond_adaptivity = std::make_shared<BondAdaptivity>();
+ bond_adaptivity->addBondPolicy({{TensorLeg{1,1},TensorLeg{2,0}},BondAdaptivity::IncrPolicy::ADD,2,8});
+ success = network->resetBondAdaptivity(bond_adaptivity); assert(success);
+ success = exatn::adaptBondsSync(*network); assert(success);
+ EXPECT_EQ(exatn::getTensor("RA"),tensor_a);
+ EXPECT_EQ(network->getTensor(1)->getDimExtent(1),6);
+ EXPECT_EQ(network->getTensor(2)->getDimExtent(0),6);
+ success = exatn::evaluateSync(*network); assert(success);
+ success = exatn::computeNorm1Sync("RZ",norm1); assert(success);
+ EXPECT_NEAR(norm1,16.0,1e-10); //padding does not contribute
+
+ network.reset();
+ success = exatn::destroyTensorSync("RZ"); assert(success);
+ success = exatn::destroyTensorSync("RB"); assert(success);
+ success = exatn::destroyTensorSync("RA"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST68
+TEST(NumServerTester, CopyOnWriteTensors) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+ success = exatn::createTensorSync("WA",TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+ success = exatn::initTensorSync("WA",1.0); assert(success);
+
+ //Writing into the source tensor after the copy does not affect the copy:
+ double norm1 = 0.0;
+ success = exatn::copyTensorSync("WB","WA"); assert(success);
+ success = exatn::copyTensorSync("WC","WB"); assert(success);
+ success = exatn::scaleTensorSync("WA",2.0); assert(success);
+ success = exatn::computeNorm1Sync("WB",norm1); assert(success);
+ EXPECT_NEAR(norm1,64.0,1e-10);
+ success = exatn::computeNorm1Sync("WA",norm1); assert(success);
+ EXPECT_NEAR(norm1,128.0,1e-10);
+
+ //Destroying the source tensor hands its body over to the copies:
+ success = exatn::copyTensorSync("WD","WA"); assert(success);
+ success = exatn::copyTensorSync("WE","WA"); assert(success);
+ success = exatn::destroyTensorSync("WA"); assert(success);
+ success = exatn::computeNorm1Sync("WD",norm1); assert(success);
+ EXPECT_NEAR(norm1,128.0,1e-10);
+ success = exatn::computeNorm1Sync("WE",norm1); assert(success);
+ EXPECT_NEAR(norm1,128.0,1e-10);
+
+ //Reinitializing the copy before its use:
+ success = exatn::initTensorSync("WC",0.5); assert(success);
+ success = exatn::computeNorm1Sync("WC",norm1); assert(success);
+ EXPECT_NEAR(norm1,32.0,1e-10);
+
+ success = exatn::destroyTensorSync("WE"); assert(success);
+ success = exatn::destroyTensorSync("WD"); assert(success);
+ success = exatn::destroyTensorSync("WC"); assert(success);
+ success = exatn::destroyTensorSync("WB"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST69
+TEST(NumServerTester, ApproximateEvaluation) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+
+ bool success = true;
+ const std::map<std::string,TensorShape> shapes{{"GA",TensorShape{4,4}},{"GB",TensorShape{4,4,4}},{"GC",TensorShape{4,4}},
+                                                {"GD",TensorShape{4,4}},{"GE",TensorShape{4,4,4}},{"GF",TensorShape{4,4}}};
+ for(const auto & shape: shapes){
+  success = exatn::createTensorSync(shape.first,TensorElementType::REAL64,shape.second); assert(success);
+  success = exatn::initTensorRndSync(shape.first); assert(success);
+ }
+ success = exatn::createTensorSync("GZ0",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::initTensorSync("GZ0",0.0); assert(success);
+ success = exatn::createTensorSync("GZ1",TensorElementType::REAL64,TensorShape{}); assert(success);
+ success = exatn::initTensorSync("GZ1",0.0); assert(success);
+
+ //Reference (exact) evaluation of a closed 2x3 grid:
+ const std::string grid_net = "GZ0()+=GA(a,b)*GB(a,c,d)*GC(c,e)*GD(b,f)*GE(d,f,g)*GF(e,g)";
+ success = exatn::evaluateTensorNetworkSync("ExactGrid",grid_net); assert(success);
+
+ //Boundary-MPS evaluation (columns of tensor ids):
+ std::map<std::string,std::shared_ptr<exatn::Tensor>> tensors;
+ for(const auto & shape: shapes) tensors.emplace(std::make_pair(shape.first,exatn::getTensor(shape.first)));
+ tensors.emplace(std::make_pair(std::string("GZ0"),exatn::getTensor("GZ1")));
+ TensorNetwork network("BoundaryGrid",grid_net,tensors);
+ success = network.importBoundaryMPSSequence({{1,4},{2,5},{3,6}}); assert(success);
+ double truncation_error = 1.0;
+ success = exatn::evaluateApproximateSync(network,64,truncation_error); assert(success);
+ EXPECT_NEAR(truncation_error,0.0,1e-10);
+ success = exatn::addTensorsSync("GZ1()+=GZ0()",-1.0); assert(success);
+ double norm1 = 1.0;
+ success = exatn::computeNorm1Sync("GZ1",norm1); assert(success);
+ EXPECT_NEAR(norm1,0.0,1e-8);
+
+ //Truncated evaluation:
+ success = exatn::evaluateApproximateSync(network,2,truncation_error); assert(success);
+ EXPECT_GE(truncation_error,0.0);
+
+ success = exatn::destroyTensorSync("GZ1"); assert(success);
+ success = exatn::destroyTensorSync("GZ0"); assert(success);
+ for(const auto & shape: shapes){
+  success = exatn::destroyTensorSync(shape.first); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST70
+TEST(NumServerTester, TensorElementQueries) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ bool success = true;
+ success = exatn::createTensorSync("EQ",TensorElementType::COMPLEX64,TensorShape{3,4,5}); assert(success);
+ std::vector<std::complex<double>> body(3*4*5);
+ for(std::size_t i = 0; i < body.size(); ++i) body[i] = std::complex<double>(static_cast<double>(i),-0.5*static_cast<double>(i));
+ success = exatn::initTensorDataSync("EQ",body); assert(success);
+
+ const std::vector<std::vector<exatn::DimOffset>> multi_indices{{0,0,0},{2,3,4},{1,2,3},{2,0,1},{1,2,3}};
+ std::vector<std::complex<double>> values;
+ success = exatn::getTensorElementsSync("EQ",multi_indices,values); assert(success);
+ ASSERT_EQ(values.size(),multi_indices.size());
+ for(std::size_t n = 0; n < multi_indices.size(); ++n){
+  const auto offset = multi_indices[n][0] + 3 * (multi_indices[n][1] + 4 * multi_indices[n][2]); //column-major
+  EXPECT_NEAR(std::abs(values[n] - body[offset]),0.0,1e-12);
+ }
+ EXPECT_FALSE(exatn::getTensorElementsSync("EQ",{{3,0,0}},values)); //out of range
+
+ success = exatn::destroyTensorSync("EQ"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST71
+TEST(NumServerTester, ExpansionCompression) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+ using exatn::TensorExpansion;
+
+ bool success = true;
+ //Two MPS components (the second one with permuted tensor legs):
+ const std::map<std::string,TensorShape> shapes{{"XA0",TensorShape{2,2}},{"XA1",TensorShape{2,2,2}},{"XA2",TensorShape{2,2,2}},
+                                                {"XA3",TensorShape{2,2}},{"XB0",TensorShape{3,2}},{"XB1",TensorShape{2,3,3}},
+                                                {"XB2",TensorShape{3,3,2}},{"XB3",TensorShape{3,2}}};
+ std::map<std::string,std::shared_ptr<exatn::Tensor>> tensors;
+ for(const auto & shape: shapes){
+  success = exatn::createTensorSync(shape.first,TensorElementType::REAL64,shape.second); assert(success);
+  success = exatn::initTensorRndSync(shape.first); assert(success);
+  tensors.emplace(std::make_pair(shape.first,exatn::getTensor(shape.first)));
+ }
+ for(const auto & name: {"XZ0","XZ1","XZ2"}){
+  success = exatn::createTensorSync(name,TensorElementType::REAL64,TensorShape{2,2,2,2}); assert(success);
+  success = exatn::initTensorSync(name,0.0); assert(success);
+  tensors.emplace(std::make_pair(std::string(name),exatn::getTensor(name)));
+ }
+ auto mps_a = std::make_shared<TensorNetwork>("XMPSA","XZ0(a,b,c,d)+=XA0(a,i)*XA1(i,b,j)*XA2(j,c,k)*XA3(k,d)",tensors);
+ auto mps_b = std::make_shared<TensorNetwork>("XMPSB","XZ1(a,b,c,d)+=XB0(i,a)*XB1(b,i,j)*XB2(k,j,c)*XB3(k,d)",tensors);
+ TensorExpansion expansion;
+ success = expansion.appendComponent(mps_a,{0.5,0.0}); assert(success);
+ success = expansion.appendComponent(mps_b,{-1.5,0.0}); assert(success);
+ expansion.rename("XSum");
+
+ //Reference: XZ2 = 0.5 * XZ0 - 1.5 * XZ1:
+ success = exatn::evaluateSync(*mps_a); assert(success);
+ success = exatn::evaluateSync(*mps_b); assert(success);
+ success = exatn::addTensorsSync("XZ2(a,b,c,d)+=XZ0(a,b,c,d)",0.5); assert(success);
+ success = exatn::addTensorsSync("XZ2(a,b,c,d)+=XZ1(a,b,c,d)",-1.5); assert(success);
+
+ //Exact compression (bond dimension 2+3 fits):
+ std::shared_ptr<TensorNetwork> compressed;
+ double truncation_error = 1.0;
+ success = exatn::compressExpansionSync(expansion,5,compressed,truncation_error); assert(success);
+ ASSERT_TRUE(compressed);
+ EXPECT_EQ(compressed->getNumTensors(),4U);
+ EXPECT_NEAR(truncation_error,0.0,1e-10);
+ auto output = compressed->getTensor(0);
+ success = exatn::createTensorSync(output,TensorElementType::REAL64); assert(success);
+ success = exatn::initTensorSync(output->getName(),0.0); assert(success);
+ success = exatn::evaluateSync(*compressed); assert(success);
+ success = exatn::addTensorsSync(output->getName() + "(a,b,c,d)+=XZ2(a,b,c,d)",-1.0); assert(success);
+ double norm = 1.0;
+ success = exatn::computeNorm2Sync(output->getName(),norm); assert(success);
+ EXPECT_NEAR(norm,0.0,1e-8);
+ success = exatn::destroyTensorsSync(*compressed); assert(success);
+
+ //Truncated compression (the error estimate bounds the actual error):
+ success = exatn::compressExpansionSync(expansion,2,compressed,truncation_error); assert(success);
+ output = compressed->getTensor(0);
+ success = exatn::createTensorSync(output,TensorElementType::REAL64); assert(success);
+ success = exatn::initTensorSync(output->getName(),0.0); assert(success);
+ success = exatn::evaluateSync(*compressed); assert(success);
+ success = exatn::addTensorsSync(output->getName() + "(a,b,c,d)+=XZ2(a,b,c,d)",-1.0); assert(success);
+ success = exatn::computeNorm2Sync(output->getName(),norm); assert(success);
+ EXPECT_LE(norm,truncation_error + 1e-8);
+ success = exatn::destroyTensorsSync(*compressed); assert(success);
+
+ for(const auto & name: {"XZ2","XZ1","XZ0"}){
+  success = exatn::destroyTensorSync(name); assert(success);
+ }
+ for(const auto & shape: shapes){
+  success = exatn::destroyTensorSync(shape.first); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST72
+TEST(NumServerTester, NetworkMemoization) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+
+ bool success = true;
+ for(const auto & name: {"MA","MB"}){
+  success = exatn::createTensorSync(name,TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+  success = exatn::initTensorRndSync(name); assert(success);
+ }
+ success = exatn::createTensorSync("MC",TensorElementType::REAL64,TensorShape{8,8}); assert(success);
+ success = exatn::initTensorSync("MC",0.0); assert(success);
+ std::map<std::string,std::shared_ptr<exatn::Tensor>> tensors{{"MA",exatn::getTensor("MA")},{"MB",exatn::getTensor("MB")},
+                                                              {"MC",exatn::getTensor("MC")}};
+ TensorNetwork network("MemoNet","MC(a,b)+=MA(a,i)*MB(i,b)",tensors);
+
+ exatn::activateNetworkMemoization();
+ const auto hits = exatn::getNetworkMemoizationHits();
+ double norm0 = 0.0, norm = 0.0;
+ success = exatn::evaluateSync(network); assert(success);
+ success = exatn::computeNorm2Sync("MC",norm0); assert(success);
+ EXPECT_EQ(exatn::getNetworkMemoizationHits(),hits);
+
+ //Unchanged input tensors: The evaluation is skipped:
+ success = exatn::evaluateSync(network); assert(success);
+ success = exatn::computeNorm2Sync("MC",norm); assert(success);
+ EXPECT_EQ(exatn::getNetworkMemoizationHits(),hits + 1);
+ EXPECT_NEAR(norm,norm0,1e-10);
+
+ //Updated input tensor: The tensor network is recomputed:
+ success = exatn::scaleTensorSync("MB",2.0); assert(success);
+ success = exatn::evaluateSync(network); assert(success);
+ success = exatn::computeNorm2Sync("MC",norm); assert(success);
+ EXPECT_EQ(exatn::getNetworkMemoizationHits(),hits + 1);
+ EXPECT_NEAR(norm,2.0*norm0,1e-8);
+
+ //Overwritten output tensor: The tensor network is recomputed:
+ success = exatn::initTensorSync("MC",0.0); assert(success);
+ success = exatn::evaluateSync(network); assert(success);
+ success = exatn::computeNorm2Sync("MC",norm); assert(success);
+ EXPECT_EQ(exatn::getNetworkMemoizationHits(),hits + 1);
+ EXPECT_NEAR(norm,2.0*norm0,1e-8);
+ exatn::deactivateNetworkMemoization();
+
+ for(const auto & name: {"MC","MB","MA"}){
+  success = exatn::destroyTensorSync(name); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST73
+TEST(NumServerTester, IncrementalGreedySearch) {
+ using exatn::TensorShape;
+ using exatn::TensorNetwork;
+ using exatn::numerics::TensorNetworkFlat;
+
+ //Large two-dimensional grid of tensors (closed):
+ const unsigned int num_rows = 20, num_cols = 25;
+ std::map<std::string,std::shared_ptr<exatn::Tensor>> tensors{{"Z",exatn::makeSharedTensor("Z")}};
+ std::string expression = "Z()+=";
+ for(unsigned int r = 0; r < num_rows; ++r){
+  for(unsigned int c = 0; c < num_cols; ++c){
+   const auto site = r * num_cols + c;
+   std::vector<std::string> indices;
+   if(c > 0) indices.emplace_back("h" + std::to_string(site - 1));
+   if(c < num_cols - 1) indices.emplace_back("h" + std::to_string(site));
+   if(r > 0) indices.emplace_back("v" + std::to_string(site - num_cols));
+   if(r < num_rows - 1) indices.emplace_back("v" + std::to_string(site));
+   const auto name = "T" + std::to_string(site);
+   tensors.emplace(name,exatn::makeSharedTensor(name,TensorShape(std::vector<exatn::DimExtent>(indices.size(),2))));
+   if(site > 0) expression += "*";
+   expression += name + "(" + indices[0];
+   for(std::size_t i = 1; i < indices.size(); ++i) expression += "," + indices[i];
+   expression += ")";
+  }
+ }
+ TensorNetwork network("GreedGrid",expression,tensors);
+ EXPECT_EQ(network.getNumTensors(),num_rows * num_cols);
+ const auto time_start = exatn::Timer::timeInSecHR();
+ const double flops = network.determineContractionSequence("greed");
+ std::cout << "Greedy search over " << network.getNumTensors() << " tensors took "
+           << exatn::Timer::timeInSecHR(time_start) << " sec: Flop count = " << flops << std::endl;
+ const auto contr_seq = network.exportContractionSequence();
+ EXPECT_EQ(contr_seq.size(),network.getNumTensors() - 1);
+ EXPECT_EQ(contr_seq.back().result_id,0);
+ EXPECT_NEAR(TensorNetworkFlat(network).simulateContractionSequence(contr_seq),flops,flops*1e-12);
+}
+#endif
+
+#ifdef EXATN_TEST74
+TEST(NumServerTester, SpinHamiltonianCache) {
+ using exatn::TensorElementType;
+ using exatn::quantum::Gate;
+
+ //Small spin Hamiltonian in the OpenFermion format:
+ const std::string filename("spin_ham_cache_test.ofn.txt");
+ const std::string cache_name = filename + ".exatn.bin";
+ if(exatn::getProcessRank() == 0){
+  std::ofstream text_file(filename);
+  text_file << "(1+0j) [] +" << std::endl
+            << "(-0.5+0j) [X0 Z1 X2] +" << std::endl
+            << "(0.25-0.125j) [Y3 Z10] +" << std::endl
+            << "(0.75+0j) [Z5]";
+  text_file.close();
+  std::remove(cache_name.c_str());
+ }
+ const std::vector<std::complex<double>> coefs{{1.0,0.0},{-0.5,0.0},{0.25,-0.125},{0.75,0.0}};
+ const std::vector<std::map<unsigned int, Gate>> products{{},
+  {{0,Gate::gate_X},{1,Gate::gate_Z},{2,Gate::gate_X}},{{3,Gate::gate_Y},{10,Gate::gate_Z}},{{5,Gate::gate_Z}}};
+
+ //The first reading parses the text file and caches its binary image, the second one reads the cache:
+ for(int reading = 0; reading < 2; ++reading){
+  auto hamiltonian = exatn::quantum::readSpinHamiltonian("CachedHam",filename,TensorElementType::COMPLEX64,"OpenFermion");
+  ASSERT_EQ(hamiltonian->getNumComponents(),coefs.size());
+  std::size_t i = 0;
+  for(auto component = hamiltonian->cbegin(); component != hamiltonian->cend(); ++component, ++i){
+   std::map<unsigned int, Gate> product;
+   EXPECT_TRUE(exatn::quantum::getPauliProduct(*component,product));
+   EXPECT_EQ(product,products[i]);
+   EXPECT_EQ(component->coefficient,coefs[i]);
+  }
+  if(exatn::getProcessRank() == 0){
+   EXPECT_TRUE(std::ifstream(cache_name).good());
+  }
+ }
+ if(exatn::getProcessRank() == 0){
+  std::remove(cache_name.c_str());
+  std::remove(filename.c_str());
+ }
+ auto success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST75
+TEST(NumServerTester, ThreadTopologyLayout) {
+ //The thread topology is inactive unless requested:
+ exatn::ThreadTopology topology;
+ EXPECT_FALSE(topology.configure(exatn::ParamConf(),0,1));
+ EXPECT_EQ(topology.getNumComputeCores(),0);
+ EXPECT_FALSE(topology.pinRuntimeThread(false));
+
+ //Requested: The process share always keeps at least one compute core:
+ exatn::ParamConf parameters;
+ parameters.setParameter("thread_topology",int64_t{1});
+ parameters.setParameter("thread_topology_runtime_cores",int64_t{1});
+ parameters.setParameter("thread_topology_mpi_cores",int64_t{1});
+ const auto num_cores = std::thread::hardware_concurrency();
+ for(int rank = 0; rank < 2; ++rank){
+  if(topology.configure(parameters,rank,2)){ //Linux only
+   EXPECT_GE(topology.getNumComputeCores(),1);
+   EXPECT_LE(topology.getNumComputeCores(),std::max(1U,num_cores));
+   topology.printLayout(std::cout);
+  }
+ }
+}
+#endif
+
+#ifdef EXATN_TEST76
+TEST(NumServerTester, BatchedNetworkTensorCreation) {
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int num_sites = 8, max_bond_dim = 4;
+
+ //Build two tensor networks sharing the same tensors:
+ auto tn_builder = exatn::getTensorNetworkBuilder("MPS"); assert(tn_builder);
+ auto success = tn_builder->setParameter("max_bond_dim",max_bond_dim); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("BatchSpace",std::vector<int>(num_sites,2));
+ auto net = exatn::makeSharedTensorNetwork("BatchNet",ket_tensor,*tn_builder,false);
+ net->markOptimizableAllTensors();
+ auto expansion = exatn::makeSharedTensorExpansion("BatchTNS",net,std::complex<double>{1.0,0.0});
+ success = expansion->appendComponent(net,std::complex<double>{0.5,0.0}); assert(success);
+
+ //Create and initialize all input tensors in a single batch each:
+ success = exatn::createTensorsSync(*expansion,TENS_ELEM_TYPE); ASSERT_TRUE(success);
+ success = exatn::initTensorsRndSync(*expansion); ASSERT_TRUE(success);
+ for(auto tens = net->cbegin(); tens != net->cend(); ++tens){
+  if(tens->first != 0){
+   const auto & tens_name = tens->second.getName();
+   EXPECT_TRUE(exatn::tensorAllocated(tens_name));
+   double norm = 0.0;
+   success = exatn::computeNorm2Sync(tens_name,norm); ASSERT_TRUE(success);
+   EXPECT_GT(norm,0.0);
+  }
+ }
+ //Already created tensors are skipped:
+ success = exatn::createTensorsSync(*net,TENS_ELEM_TYPE); EXPECT_TRUE(success);
+ success = exatn::initTensorsRndSync(*net); EXPECT_TRUE(success);
+
+ success = exatn::destroyTensorsSync(*net); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST77
+TEST(NumServerTester, ConcurrentClientThreads) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int num_threads = 4, num_iterations = 8;
+ if(exatn::getNumProcesses() > 1) return; //collectives issued by different client threads must not interleave
+
+ //Independent client threads create, contract and destroy their own tensors:
+ std::atomic<int> num_correct{0};
+ std::vector<std::thread> threads;
+ for(int t = 0; t < num_threads; ++t){
+  threads.emplace_back([&,t](){
+   const std::string suffix = "_cl" + std::to_string(t);
+   const auto scope_id = exatn::numericalServer->openScope("Client" + std::to_string(t));
+   if(scope_id == 1) ++num_correct; //own scope stack: {GLOBAL, Client}
+   for(int i = 0; i < num_iterations; ++i){
+    bool success = exatn::createTensorSync("A"+suffix,TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+    success = exatn::createTensorSync("B"+suffix,TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+    success = exatn::createTensorSync("C"+suffix,TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+    success = exatn::initTensor("A"+suffix,1.0); assert(success);
+    success = exatn::initTensor("B"+suffix,2.0); assert(success);
+    success = exatn::initTensor("C"+suffix,0.0); assert(success);
+    success = exatn::contractTensorsSync("C"+suffix+"(i,j)+=A"+suffix+"(i,k)*B"+suffix+"(k,j)",1.0); assert(success);
+    double norm = 0.0;
+    success = exatn::computeNorm2Sync("C"+suffix,norm); assert(success);
+    if(std::abs(norm - 128.0) < 1e-9) ++num_correct;
+    success = exatn::destroyTensorSync("C"+suffix); assert(success);
+    success = exatn::destroyTensorSync("B"+suffix); assert(success);
+    success = exatn::destroyTensorSync("A"+suffix); assert(success);
+   }
+   exatn::numericalServer->closeScope();
+  });
+ }
+ for(auto & thread: threads) thread.join();
+ EXPECT_EQ(num_correct.load(),num_threads*(num_iterations+1));
+ for(int t = 0; t < num_threads; ++t) EXPECT_FALSE(exatn::tensorAllocated("A_cl"+std::to_string(t)));
+
+ bool success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST78
+TEST(NumServerTester, HotRuntimeReconfiguration) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ bool success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::initTensor("A",1.0); assert(success);
+ success = exatn::initTensor("B",2.0); assert(success);
+
+ //Switch to the eager DAG executor, keeping the existing tensors:
+ exatn::ParamConf parameters;
+ parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ success = exatn::reconfigureRuntime(parameters,"eager-dag-executor");
+ EXPECT_TRUE(success);
+ double norm = 0.0;
+ success = exatn::computeNorm2Sync("A",norm); assert(success);
+ EXPECT_NEAR(norm,8.0,1e-9);
+ success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::initTensor("C",0.0); assert(success);
+ success = exatn::contractTensorsSync("C(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+ success = exatn::computeNorm2Sync("C",norm); assert(success);
+ EXPECT_NEAR(norm,128.0,1e-9);
+
+ //Switch back to the lazy DAG executor:
+ success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor");
+ EXPECT_TRUE(success);
+ success = exatn::computeNorm2Sync("C",norm); assert(success);
+ EXPECT_NEAR(norm,128.0,1e-9);
+
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST79
+TEST(NumServerTester, SpeculativeExecution) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ EXPECT_FALSE(exatn::beginSpeculation()); //speculative execution is not active
+ exatn::activateSpeculativeExecution();
+
+ bool success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::initTensor("A",1.0); assert(success);
+ success = exatn::initTensor("B",2.0); assert(success);
+ success = exatn::initTensorSync("C",0.0); assert(success);
+ success = exatn::initTensorSync("D",0.0); assert(success);
+
+ //Committed speculation is executed as usual:
+ EXPECT_TRUE(exatn::beginSpeculation());
+ EXPECT_FALSE(exatn::beginSpeculation()); //speculations cannot be nested
+ success = exatn::contractTensors("C(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+ EXPECT_TRUE(exatn::commitSpeculation());
+ double norm = 0.0;
+ success = exatn::computeNorm2Sync("C",norm); assert(success);
+ EXPECT_NEAR(norm,128.0,1e-9);
+
+ //Discarded speculation: Its output tensor is only destroyed afterwards:
+ EXPECT_TRUE(exatn::beginSpeculation());
+ for(int i = 0; i < 16; ++i){
+  success = exatn::contractTensors("D(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+ }
+ EXPECT_TRUE(exatn::discardSpeculation());
+ EXPECT_FALSE(exatn::discardSpeculation()); //no active speculation
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::sync(); assert(success);
+
+ //Subsequent work is not affected:
+ success = exatn::contractTensorsSync("C(i,j)+=A(i,k)*B(k,j)",1.0); assert(success);
+ success = exatn::computeNorm2Sync("C",norm); assert(success);
+ EXPECT_NEAR(norm,256.0,1e-9);
+
+ exatn::deactivateSpeculativeExecution();
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST80
+TEST(NumServerTester, EagerWindowCommutativeAccumulations) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int NUM_ACCUMULATIONS = 16;
+
+ //Eager DAG executor with an issue window of several DAG nodes in flight:
+ exatn::ParamConf parameters;
+ parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ parameters.setParameter("dag_executor_issue_window",static_cast<int64_t>(8));
+ bool success = exatn::reconfigureRuntime(parameters,"eager-dag-executor"); assert(success);
+
+ success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{64,64}); assert(success);
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{64,64}); assert(success);
+ success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{64,64}); assert(success);
+ success = exatn::initTensor("A",1.0); assert(success);
+ success = exatn::initTensor("B",1.0); assert(success);
+ success = exatn::initTensorSync("C",0.0); assert(success);
+
+ //Commutative accumulations into the same tensor (no mutual DAG dependencies):
+ auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup("C"));
+ double expected = 0.0;
+ for(int i = 0; i < NUM_ACCUMULATIONS; ++i){
+  std::shared_ptr<exatn::TensorOperation> op = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  op->setTensorOperand(exatn::getTensor("C"));
+  op->setTensorOperand(exatn::getTensor("A"));
+  op->setTensorOperand(exatn::getTensor("B"));
+  op->setScalar(0,std::complex<double>{static_cast<double>(i+1),0.0});
+  op->setIndexPattern("C(a,b)+=A(a,c)*B(c,b)");
+  op->setCommutativeAccumulation(true);
+  success = exatn::numericalServer->submit(op,tensor_mapper); assert(success);
+  expected += static_cast<double>(i+1) * 64.0; //each element of A*B equals 64
+ }
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("C",norm1); assert(success);
+ EXPECT_NEAR(norm1,expected*64.0*64.0,1e-6);
+
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ exatn::ParamConf default_parameters; //ParamConf::setParameter() does not overwrite
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST81
+TEST(NumServerTester, TensorOpFusionResubmission) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ //The same sequence of tensor operations (with resubmitted operation objects) without and with the fusion pass:
+ for(const std::string optimizer: {"none","tensor-op-fusion"}){
+  exatn::ParamConf parameters;
+  parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+  parameters.setParameter("runtime_dag_optimizer",optimizer);
+  bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+
+  success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+  success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+  success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+  success = exatn::initTensorSync("A",1.0); assert(success);
+  success = exatn::initTensorSync("C",0.0); assert(success);
+  auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup("D"));
+
+  std::shared_ptr<exatn::TensorOperation> contraction = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  contraction->setTensorOperand(exatn::getTensor("D"));
+  contraction->setTensorOperand(exatn::getTensor("A"));
+  contraction->setTensorOperand(exatn::getTensor("A"));
+  contraction->setIndexPattern("D(a,b)+=A(a,c)*A(c,b)");
+  //D = 0 (zero-init fusion candidate); D += A*A; D += A*A (resubmitted):
+  success = exatn::initTensor("D",0.0); assert(success);
+  success = exatn::numericalServer->submit(contraction,tensor_mapper); assert(success);
+  success = exatn::sync("D"); assert(success);
+  success = exatn::numericalServer->submit(contraction,tensor_mapper); assert(success);
+  success = exatn::sync("D"); assert(success);
+  //D *= 0.5 (scaling fusion candidate); D += A*A:
+  success = exatn::scaleTensor("D",0.5); assert(success);
+  success = exatn::numericalServer->submit(contraction,tensor_mapper); assert(success);
+  double norm1 = 0.0;
+  success = exatn::computeNorm1Sync("D",norm1); assert(success);
+  EXPECT_NEAR(norm1,16.0*8.0*8.0,1e-7); //each element of A*A equals 8
+  //The submitted contraction is not altered by the fusion pass:
+  auto submitted = std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(contraction);
+  EXPECT_TRUE(submitted->isAccumulative());
+  EXPECT_NEAR(std::abs(submitted->getBeta()-std::complex<double>{1.0,0.0}),0.0,1e-12);
+
+  //C += A twice (addition merge candidates), then C += A (resubmitted):
+  std::shared_ptr<exatn::TensorOperation> addition = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(exatn::getTensor("C"));
+  addition->setTensorOperand(exatn::getTensor("A"));
+  addition->setScalar(0,std::complex<double>{1.0,0.0});
+  addition->setIndexPattern("C(a,b)+=A(a,b)");
+  std::shared_ptr<exatn::TensorOperation> other_addition(addition->clone());
+  success = exatn::numericalServer->submit(addition,tensor_mapper); assert(success);
+  success = exatn::numericalServer->submit(other_addition,tensor_mapper); assert(success);
+  success = exatn::sync("C"); assert(success);
+  success = exatn::numericalServer->submit(addition,tensor_mapper); assert(success);
+  success = exatn::computeNorm1Sync("C",norm1); assert(success);
+  EXPECT_NEAR(norm1,3.0*8.0*8.0,1e-7);
+  EXPECT_NEAR(std::abs(addition->getScalar(0)-std::complex<double>{1.0,0.0}),0.0,1e-12);
+
+  success = exatn::destroyTensorSync("D"); assert(success);
+  success = exatn::destroyTensorSync("C"); assert(success);
+  success = exatn::destroyTensorSync("A"); assert(success);
+ }
+ exatn::ParamConf parameters;
+ parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST82
+TEST(NumServerTester, NodeProcessGroup) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto global_rank = exatn::getProcessRank();
+ const auto total_processes = exatn::getNumProcesses();
+ const auto & all_processes = exatn::getDefaultProcessGroup();
+ const auto & node_processes = exatn::getNodeProcessGroup();
+
+ //The node-local process group is a non-empty subgroup of the default process group containing this process:
+ EXPECT_GE(node_processes.getSize(),1);
+ EXPECT_LE(node_processes.getSize(),total_processes);
+ EXPECT_TRUE(node_processes.rankIsIn(global_rank));
+ EXPECT_TRUE(node_processes.isContainedIn(all_processes));
+ const auto node_rank = exatn::getProcessRank(node_processes);
+ EXPECT_GE(node_rank,0);
+ EXPECT_LT(node_rank,exatn::getNumProcesses(node_processes));
+#ifndef MPI_ENABLED
+ EXPECT_TRUE(node_processes.isCongruentTo(all_processes));
+#endif
+
+ //Tensor operations run on the node-local process group:
+ bool success = exatn::createTensorSync(node_processes,"N",TensorElementType::REAL64,TensorShape{16,16}); assert(success);
+ success = exatn::initTensorSync("N",1.0); assert(success);
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("N",norm1); assert(success);
+ EXPECT_NEAR(norm1,16.0*16.0,1e-10);
+ success = exatn::destroyTensorSync("N"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST83
+TEST(NumServerTester, NodeSharedReplica) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const std::size_t VOL = 16 * 16;
+
+ auto process_rank = exatn::getProcessRank();
+ exatn::ProcessGroup myself(exatn::getCurrentProcessGroup());
+ exatn::ProcessGroup all_processes(exatn::getDefaultProcessGroup());
+
+ //Root process: Create and fill tensor R:
+ bool success = true;
+ if(process_rank == 0){
+  success = exatn::createTensorSync(myself,"R",TENS_ELEM_TYPE,TensorShape{16,16}); assert(success);
+  std::vector<double> data(VOL);
+  for(std::size_t i = 0; i < VOL; ++i) data[i] = static_cast<double>(i);
+  success = exatn::initTensorDataSync("R",data); assert(success);
+ }
+ //All processes: Keep a single node-shared copy of tensor R per compute node:
+ success = exatn::replicateTensorSharedSync(all_processes,"R",0); assert(success);
+
+ //All processes: The replica carries the contents of the root tensor:
+ auto local_copy = exatn::getLocalTensor("R"); assert(local_copy);
+ EXPECT_EQ(local_copy->getVolume(),VOL);
+ const exatn::TensorDataType<TENS_ELEM_TYPE>::value * body_ptr = nullptr;
+ auto access_granted = local_copy->getDataAccessHostConst(&body_ptr); assert(access_granted);
+ for(std::size_t i = 0; i < VOL; ++i) EXPECT_EQ(body_ptr[i],static_cast<double>(i));
+ body_ptr = nullptr;
+ local_copy.reset();
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("R",norm1); assert(success);
+ EXPECT_NEAR(norm1,static_cast<double>(VOL*(VOL-1)/2),1e-8);
+
+ success = exatn::destroyTensorSync("R"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST84
+TEST(NumServerTester, KrylovLinearSolver) {
+ using exatn::Tensor;
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+ const int num_sites = 4;
+
+ //The operator A = X(0) is unitary and Hermitian, thus the non-Krylov (<x|A*|b> reconstruction)
+ //and the Krylov (A|x> = |b>) solutions must both coincide with |x> = A|b>:
+ auto pauli_x = exatn::makeSharedTensor("KrylovPauliX",TensorShape{2,2});
+ auto op = exatn::makeSharedTensorOperator("KrylovOperator");
+ bool success = op->appendComponent(pauli_x,{{0,0}},{{0,1}},{1.0,0.0}); assert(success);
+
+ auto tn_builder = exatn::getTensorNetworkBuilder("TTN"); assert(tn_builder);
+ success = tn_builder->setParameter("max_bond_dim",4); assert(success);
+ success = tn_builder->setParameter("arity",2); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("KrylovSpace",std::vector<int>(num_sites,2));
+ auto vec_net = exatn::makeSharedTensorNetwork("KrylovVectorNet",ket_tensor,*tn_builder,false);
+ vec_net->markOptimizableAllTensors();
+ auto vec_tns = exatn::makeSharedTensorExpansion("KrylovVectorTNS",vec_net,std::complex<double>{1.0,0.0});
+ auto rhs_net = exatn::makeSharedTensorNetwork("KrylovRightHandSideNet",ket_tensor,*tn_builder,false);
+ auto rhs_tns = exatn::makeSharedTensorExpansion("KrylovRightHandSideTNS",rhs_net,std::complex<double>{1.0,0.0});
+
+ success = exatn::createTensorSync(pauli_x,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorDataSync("KrylovPauliX",std::vector<std::complex<double>>{
+  {0.0,0.0}, {1.0,0.0},
+  {1.0,0.0}, {0.0,0.0}}); assert(success);
+ success = exatn::createTensorsSync(*vec_net,TENS_ELEM_TYPE); assert(success);
+ success = exatn::createTensorsSync(*rhs_net,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorsRndSync(*rhs_net); assert(success);
+ auto x_direct = exatn::makeSharedTensor("KrylovDirect",std::vector<int>(num_sites,2));
+ auto x_krylov = exatn::makeSharedTensor("KrylovSolution",std::vector<int>(num_sites,2));
+ success = exatn::createTensorSync(x_direct,TENS_ELEM_TYPE); assert(success);
+ success = exatn::createTensorSync(x_krylov,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorSync("KrylovDirect",0.0); assert(success);
+ success = exatn::initTensorSync("KrylovSolution",0.0); assert(success);
+
+ //Non-Krylov solve:
+ double residual_norm = 0.0, fidelity = 0.0;
+ success = exatn::initTensorsRndSync(*vec_net); assert(success);
+ exatn::TensorNetworkLinearSolver linsolver(op,rhs_tns,vec_tns,1e-6);
+ bool converged = linsolver.solve(&residual_norm,&fidelity);
+ EXPECT_TRUE(converged);
+ success = exatn::evaluateSync(*(linsolver.getSolution(nullptr,nullptr)),x_direct); assert(success);
+
+ //Krylov solve from a different initial guess:
+ success = exatn::initTensorsRndSync(*vec_net); assert(success);
+ exatn::TensorNetworkLinearSolver krylov_solver(op,rhs_tns,vec_tns,1e-6);
+ krylov_solver.enableKrylov(true);
+ converged = krylov_solver.solve(&residual_norm,&fidelity);
+ EXPECT_TRUE(converged);
+ EXPECT_GT(krylov_solver.getNumOperatorApplications(),0);
+ success = exatn::evaluateSync(*(krylov_solver.getSolution(nullptr,nullptr)),x_krylov); assert(success);
+
+ //Compare the solutions:
+ double direct_norm = 0.0, diff_norm = 0.0;
+ success = exatn::computeNorm2Sync("KrylovDirect",direct_norm); assert(success);
+ EXPECT_GT(direct_norm,0.0);
+ success = exatn::addTensorsSync("KrylovSolution(a,b,c,d)+=KrylovDirect(a,b,c,d)",-1.0); assert(success);
+ success = exatn::computeNorm2Sync("KrylovSolution",diff_norm); assert(success);
+ EXPECT_LT(diff_norm,1e-2*direct_norm);
+
+ success = exatn::destroyTensorSync("KrylovSolution"); assert(success);
+ success = exatn::destroyTensorSync("KrylovDirect"); assert(success);
+ success = exatn::destroyTensorsSync(*rhs_net); assert(success);
+ success = exatn::destroyTensorsSync(*vec_net); assert(success);
+ success = exatn::destroyTensorSync("KrylovPauliX"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST85
+TEST(NumServerTester, BinaryTensorFile) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const std::string filename("tensor_file_test.bin");
+
+ //Print tensor A to a binary file and reload it into tensors C (same precision) and D (lower precision):
+ bool success = exatn::createTensorSync("A",TensorElementType::REAL64,TensorShape{2,3,4,2}); assert(success);
+ success = exatn::createTensorSync("C",TensorElementType::REAL64,TensorShape{2,3,4,2}); assert(success);
+ success = exatn::createTensorSync("D",TensorElementType::REAL32,TensorShape{2,3,4,2}); assert(success);
+ success = exatn::initTensorRndSync("A"); assert(success);
+ success = exatn::initTensorSync("C",0.0); assert(success);
+ success = exatn::initTensorSync("D",0.0); assert(success);
+ success = exatn::printTensorFileSync("A",filename,true); assert(success);
+ success = exatn::initTensorFileSync("C",filename); assert(success);
+ success = exatn::initTensorFileSync("D",filename); assert(success);
+
+ //The reloaded tensors match the original one:
+ double norm_a = 0.0, norm_c = 0.0, norm_d = 0.0;
+ success = exatn::computeNorm2Sync("A",norm_a); assert(success);
+ EXPECT_GT(norm_a,0.0);
+ success = exatn::computeNorm2Sync("C",norm_c); assert(success);
+ EXPECT_NEAR(norm_c,norm_a,1e-12);
+ success = exatn::addTensorsSync("C(a,b,c,d)+=A(a,b,c,d)",-1.0); assert(success);
+ success = exatn::computeNorm2Sync("C",norm_c); assert(success);
+ EXPECT_NEAR(norm_c,0.0,1e-12);
+ success = exatn::computeNorm2Sync("D",norm_d); assert(success);
+ EXPECT_NEAR(norm_d,norm_a,1e-5*norm_a);
+
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ success = exatn::syncClean(); assert(success);
+ if(exatn::getProcessRank() == 0) std::remove(filename.c_str());
+}
+#endif
+
+#ifdef EXATN_TEST86
+TEST(NumServerTester, SketchedReconstructor) {
+ using exatn::TensorShape;
+ using exatn::Tensor;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int bond_dim = 4;
+
+ //Target T(i,j) = A0(k,i)*B0(k,j) is exactly representable by the approximant A(k,i)*B(k,j):
+ bool success = exatn::createTensorSync("T",TENS_ELEM_TYPE,TensorShape{40,30}); assert(success);
+ success = exatn::createTensorSync("Z",TENS_ELEM_TYPE,TensorShape{40,30}); assert(success);
+ success = exatn::createTensorSync("A0",TENS_ELEM_TYPE,TensorShape{bond_dim,40}); assert(success);
+ success = exatn::createTensorSync("B0",TENS_ELEM_TYPE,TensorShape{bond_dim,30}); assert(success);
+ success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{bond_dim,40}); assert(success);
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{bond_dim,30}); assert(success);
+ success = exatn::initTensorRndSync("A0"); assert(success);
+ success = exatn::initTensorRndSync("B0"); assert(success);
+ success = exatn::initTensorSync("T",0.0); assert(success);
+ success = exatn::contractTensorsSync("T(i,j)+=A0(k,i)*B0(k,j)",1.0); assert(success);
+ success = exatn::initTensorSync("Z",0.0); assert(success);
+
+ auto target_net = exatn::makeSharedTensorNetwork("TargetNet");
+ target_net->appendTensor(1,exatn::getTensor("T"),{});
+ auto target = exatn::makeSharedTensorExpansion();
+ target->appendComponent(target_net,{1.0,0.0});
+ target->rename("Target");
+ success = exatn::balanceNorm2Sync(*target,1.0,false); assert(success);
+
+ //Exact and sketched reconstructions:
+ double fidelities[2] = {0.0,0.0};
+ for(int sketch = 0; sketch < 2; ++sketch){
+  success = exatn::initTensorRndSync("A"); assert(success);
+  success = exatn::initTensorRndSync("B"); assert(success);
+  auto approx_net = exatn::makeTensorNetwork("ApproxNet","Z(i,j)=A(k,i)*B(k,j)");
+  approx_net->markOptimizableAllTensors();
+  auto approximant = exatn::makeSharedTensorExpansion();
+  approximant->appendComponent(approx_net,{1.0,0.0});
+  approximant->conjugate();
+  approximant->rename("Approximant");
+  exatn::TensorNetworkReconstructor reconstructor(target,approximant,1e-6);
+  if(sketch != 0) reconstructor.enableSketching(true,32);
+  double residual_norm = 1.0;
+  bool reconstructed = reconstructor.reconstruct(&residual_norm,&fidelities[sketch]);
+  success = exatn::sync(); assert(success);
+  EXPECT_TRUE(reconstructed);
+  EXPECT_LT(residual_norm,1e-2);
+  EXPECT_GT(fidelities[sketch],0.999);
+ }
+ //Sketching only affects early iterations, the final fidelity is exact:
+ EXPECT_NEAR(fidelities[1],fidelities[0],1e-3);
+
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::destroyTensorSync("A"); assert(success);
+ success = exatn::destroyTensorSync("B0"); assert(success);
+ success = exatn::destroyTensorSync("A0"); assert(success);
+ success = exatn::destroyTensorSync("Z"); assert(success);
+ success = exatn::destroyTensorSync("T"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST87
+TEST(NumServerTester, PauliExpectation) {
+ using exatn::TensorExpansion;
+ using exatn::TensorElementType;
+ using exatn::quantum::Gate;
+ using exatn::quantum::PauliMap;
+ using exatn::quantum::PauliProduct;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+ const int num_spin_sites = 4;
+
+ //Spin Hamiltonian with three groups of qubit-wise commuting Pauli products (ZZ, X, and Y-containing):
+ std::vector<PauliProduct> terms;
+ for(std::size_t site = 0; site < (num_spin_sites - 1); ++site){
+  terms.emplace_back(PauliProduct{{PauliMap{Gate::gate_Z,site},PauliMap{Gate::gate_Z,site+1}},{-1.0,0.0}});
+ }
+ for(std::size_t site = 0; site < num_spin_sites; ++site){
+  terms.emplace_back(PauliProduct{{PauliMap{Gate::gate_X,site}},{-0.1,0.0}});
+ }
+ terms.emplace_back(PauliProduct{{PauliMap{Gate::gate_Y,0},PauliMap{Gate::gate_Y,1}},{0.3,0.0}});
+ terms.emplace_back(PauliProduct{{PauliMap{Gate::gate_X,2},PauliMap{Gate::gate_Y,3}},{0.2,0.0}});
+ auto hamiltonian = exatn::quantum::generateSpinHamiltonian("PauliHamiltonian",
+                     [terms,term = std::size_t{0}] () mutable -> PauliProduct {
+                      if(term < terms.size()) return terms[term++];
+                      return PauliProduct{};
+                     },TENS_ELEM_TYPE);
+ EXPECT_EQ(hamiltonian->getNumComponents(),terms.size());
+
+ //Random tree tensor network state:
+ auto tn_builder = exatn::getTensorNetworkBuilder("TTN"); assert(tn_builder);
+ bool success = tn_builder->setParameter("max_bond_dim",4); assert(success);
+ success = tn_builder->setParameter("arity",2); assert(success);
+ auto ket_tensor = exatn::makeSharedTensor("TensorSpace",std::vector<int>(num_spin_sites,2));
+ auto vec_net = exatn::makeSharedTensorNetwork("VectorNet",ket_tensor,*tn_builder,false);
+ auto vec_tns = exatn::makeSharedTensorExpansion("VectorTNS",vec_net,std::complex<double>{1.0,0.0});
+ success = exatn::createTensorsSync(*vec_net,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorsRndSync(*vec_net); assert(success);
+
+ //Expectation value by groups of qubit-wise commuting Pauli products:
+ std::size_t num_groups = 0;
+ std::complex<double> grouped_value{0.0,0.0};
+ success = exatn::quantum::evaluatePauliExpectation(exatn::getDefaultProcessGroup(),*hamiltonian,*vec_tns,
+                                                     grouped_value,exatn::quantum::DEFAULT_MAX_GROUP_SUPPORT,
+                                                     &num_groups); assert(success);
+ EXPECT_EQ(num_groups,3);
+
+ //Expectation value through the explicit operator:
+ TensorExpansion vec_tns_bra(*vec_tns,false);
+ vec_tns_bra.conjugate();
+ TensorExpansion expectation(*vec_tns,vec_tns_bra,*hamiltonian);
+ auto scalar_value = exatn::makeSharedTensor("_ExpectationValue");
+ success = exatn::createTensorSync(scalar_value,TENS_ELEM_TYPE); assert(success);
+ success = exatn::initTensorSync("_ExpectationValue",0.0); assert(success);
+ success = exatn::evaluateSync(expectation,scalar_value); assert(success);
+ const auto direct_value = exatn::getLocalTensor("_ExpectationValue")->
+                            getSliceView<std::complex<float>>()[std::initializer_list<int>{}];
+ EXPECT_GT(std::abs(direct_value),0.0);
+ EXPECT_NEAR(std::abs(grouped_value - std::complex<double>(direct_value)),0.0,
+             1e-5 * std::max(1.0,static_cast<double>(std::abs(direct_value))));
+
+ success = exatn::destroyTensorsSync(); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST88
+TEST(NumServerTester, MemoryAdmissionUnderPressure) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int NUM_BALLAST = 13;    //13 x 256 MiB out of the 4 GiB Host buffer leave less than 25% free (memory pressure)
+ const int NUM_ITERATIONS = 12;
+ const int DIM = 512;
+
+ //Lazy DAG executor with the memory admission control and critical-path priorities:
+ exatn::ParamConf parameters;
+ parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ parameters.setParameter("dag_executor_memory_admission",static_cast<int64_t>(1));
+ parameters.setParameter("dag_executor_scheduling",std::string("critical_path"));
+ bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+
+ for(int i = 0; i < NUM_BALLAST; ++i){
+  success = exatn::createTensorSync("Ballast"+std::to_string(i),TENS_ELEM_TYPE,TensorShape{4096,8192}); assert(success);
+ }
+ success = exatn::createTensorSync("R",TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+ success = exatn::initTensorSync("R",0.0); assert(success);
+
+ //Asynchronous workload creating, using and destroying temporary tensors:
+ for(int i = 0; i < NUM_ITERATIONS; ++i){
+  const auto suffix = std::to_string(i);
+  success = exatn::createTensor("A"+suffix,TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+  success = exatn::createTensor("B"+suffix,TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+  success = exatn::createTensor("C"+suffix,TENS_ELEM_TYPE,TensorShape{DIM,DIM}); assert(success);
+  success = exatn::initTensor("A"+suffix,1.0); assert(success);
+  success = exatn::initTensor("B"+suffix,1.0); assert(success);
+  success = exatn::initTensor("C"+suffix,0.0); assert(success);
+  success = exatn::contractTensors("C"+suffix+"(a,b)+=A"+suffix+"(a,c)*B"+suffix+"(c,b)",1.0); assert(success);
+  success = exatn::addTensors("R(a,b)+=C"+suffix+"(a,b)",1.0); assert(success);
+  success = exatn::destroyTensor("C"+suffix); assert(success);
+  success = exatn::destroyTensor("B"+suffix); assert(success);
+  success = exatn::destroyTensor("A"+suffix); assert(success);
+ }
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("R",norm1); assert(success);
+ EXPECT_NEAR(norm1,static_cast<double>(NUM_ITERATIONS)*DIM*DIM*DIM,1e-6);
+
+ success = exatn::destroyTensorSync("R"); assert(success);
+ for(int i = 0; i < NUM_BALLAST; ++i){
+  success = exatn::destroyTensorSync("Ballast"+std::to_string(i)); assert(success);
+ }
+ exatn::ParamConf default_parameters;
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST89
+TEST(NumServerTester, ScaledAccumulationResubmission) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ bool success = true;
+
+ for(const auto elem_type: {TensorElementType::REAL64,TensorElementType::COMPLEX64}){
+  success = exatn::createTensorSync("D",elem_type,TensorShape{4,4}); assert(success);
+  success = exatn::createTensorSync("L",elem_type,TensorShape{4,4}); assert(success);
+  success = exatn::createTensorSync("R",elem_type,TensorShape{4,4}); assert(success);
+  success = exatn::initTensorSync("D",1.0); assert(success);
+  success = exatn::initTensorSync("L",1.0); assert(success);
+  success = exatn::initTensorSync("R",1.0); assert(success);
+  auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup("D"));
+  //D = 0.5 * D + 2.0 * L * R, submitted three times (the same operation object):
+  std::shared_ptr<exatn::TensorOperation> op = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  op->setTensorOperand(exatn::getTensor("D"));
+  op->setTensorOperand(exatn::getTensor("L"));
+  op->setTensorOperand(exatn::getTensor("R"));
+  op->setScalar(0,std::complex<double>{2.0,0.0});
+  op->setIndexPattern("D(a,b)+=L(a,c)*R(c,b)");
+  auto contraction = std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(op);
+  contraction->resetBeta(std::complex<double>{0.5,0.0});
+  double element = 1.0; //sequential result: each element of L*R equals 4
+  for(int i = 0; i < 3; ++i){
+   success = exatn::numericalServer->submit(op,tensor_mapper); assert(success);
+   success = exatn::sync("D"); assert(success);
+   element = 0.5 * element + 2.0 * 4.0;
+   double norm1 = 0.0;
+   success = exatn::computeNorm1Sync("D",norm1); assert(success);
+   EXPECT_NEAR(norm1,16.0*element,1e-5);
+   //The executed tensor contraction keeps its beta prefactor:
+   EXPECT_TRUE(contraction->isAccumulative());
+   EXPECT_NEAR(std::abs(contraction->getBeta()-std::complex<double>{0.5,0.0}),0.0,1e-12);
+  }
+  success = exatn::destroyTensorSync("R"); assert(success);
+  success = exatn::destroyTensorSync("L"); assert(success);
+  success = exatn::destroyTensorSync("D"); assert(success);
+ }
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST90
+TEST(NumServerTester, CommutativeAccumulationOrdering) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int NUM_ACCUMULATIONS = 8;
+
+ //The same accumulations executed in the submission order (sequential) and as commutative accumulations:
+ double norms[2][2] = {{0.0,0.0},{0.0,0.0}};
+ for(const bool commutative: {false,true}){
+  exatn::ParamConf parameters;
+  parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+  bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+
+  success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::createTensorSync("E",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::initTensor("A",1.0); assert(success);
+  success = exatn::initTensor("D",0.0); assert(success);
+  success = exatn::initTensor("E",0.0); assert(success);
+  auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup("D"));
+  auto accumulate = [&](int i){ //D += X_i * A (each element of X_i * A equals 32*(i+1))
+   std::shared_ptr<exatn::TensorOperation> op = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+   op->setTensorOperand(exatn::getTensor("D"));
+   op->setTensorOperand(exatn::getTensor("X"+std::to_string(i)));
+   op->setTensorOperand(exatn::getTensor("A"));
+   op->setScalar(0,std::complex<double>{1.0,0.0});
+   op->setIndexPattern("D(a,b)+=X"+std::to_string(i)+"(a,c)*A(c,b)");
+   op->setCommutativeAccumulation(commutative);
+   auto submitted = exatn::numericalServer->submit(op,tensor_mapper); assert(submitted);
+  };
+  //Accumulations whose producers complete at different times:
+  for(int i = 0; i < NUM_ACCUMULATIONS; ++i){
+   const std::string name = "X" + std::to_string(i);
+   success = exatn::createTensorSync(name,TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+   success = exatn::initTensor(name,static_cast<double>(i+1)); assert(success);
+   accumulate(i);
+  }
+  //Later accesses must observe all preceding accumulations:
+  success = exatn::addTensors("E(a,b)+=D(a,b)",1.0); assert(success);
+  success = exatn::scaleTensor("D",2.0); assert(success);
+  for(int i = 0; i < NUM_ACCUMULATIONS / 2; ++i) accumulate(i);
+  success = exatn::computeNorm1Sync("D",norms[commutative][0]); assert(success);
+  success = exatn::computeNorm1Sync("E",norms[commutative][1]); assert(success);
+
+  for(int i = 0; i < NUM_ACCUMULATIONS; ++i){
+   success = exatn::destroyTensorSync("X"+std::to_string(i)); assert(success);
+  }
+  success = exatn::destroyTensorSync("E"); assert(success);
+  success = exatn::destroyTensorSync("D"); assert(success);
+  success = exatn::destroyTensorSync("A"); assert(success);
+ }
+ //E = sum(i+1)*32 = 1152, D = 2*1152 + (1+2+3+4)*32 = 2624 (per element):
+ EXPECT_NEAR(norms[0][0],2624.0*32.0*32.0,1e-6);
+ EXPECT_NEAR(norms[0][1],1152.0*32.0*32.0,1e-6);
+ EXPECT_NEAR(norms[1][0],norms[0][0],1e-6);
+ EXPECT_NEAR(norms[1][1],norms[0][1],1e-6);
+
+ exatn::ParamConf default_parameters; //ParamConf::setParameter() does not overwrite
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ bool success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST91
+TEST(NumServerTester, ExecTraceDump) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int NUM_CONTRACTIONS = 8;
+
+ //The same tensor contractions executed without and with the execution trace:
+ double norms[2] = {0.0,0.0};
+ for(const int64_t exec_trace: {0,1}){
+  exatn::ParamConf parameters;
+  parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+  parameters.setParameter("runtime_exec_trace",exec_trace);
+  bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+
+  success = exatn::createTensorSync("A",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::initTensor("A",1.0); assert(success);
+  success = exatn::initTensor("D",0.0); assert(success);
+  for(int i = 0; i < NUM_CONTRACTIONS; ++i){
+   success = exatn::contractTensors("D(a,b)+=A(a,c)*A(c,b)",static_cast<double>(i+1)); assert(success);
+  }
+  success = exatn::computeNorm1Sync("D",norms[exec_trace]); assert(success);
+  success = exatn::destroyTensorSync("D"); assert(success);
+  success = exatn::destroyTensorSync("A"); assert(success);
+ }
+ //Each element of A*A equals 32:
+ EXPECT_NEAR(norms[0],36.0*32.0*32.0*32.0,1e-6);
+ EXPECT_NEAR(norms[1],norms[0],1e-6);
+
+ //The reconfiguration dumps the execution trace of the outgoing DAG executor:
+ exatn::ParamConf default_parameters; //ParamConf::setParameter() does not overwrite
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ bool success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ const std::string trace_file_name = "exatn_exec_trace." + std::to_string(exatn::getProcessRank()) + ".GLOBAL.json";
+ std::ifstream trace_file(trace_file_name);
+ ASSERT_TRUE(trace_file.is_open());
+ const std::string trace((std::istreambuf_iterator<char>(trace_file)),std::istreambuf_iterator<char>());
+ trace_file.close();
+ std::size_t num_contractions = 0;
+ for(auto pos = trace.find("\"name\":\"CONTRACT\",\"cat\":\"exec\""); pos != std::string::npos;
+     pos = trace.find("\"name\":\"CONTRACT\",\"cat\":\"exec\"",pos+1)) ++num_contractions;
+ EXPECT_EQ(num_contractions,static_cast<std::size_t>(NUM_CONTRACTIONS));
+ EXPECT_NE(trace.find("\"dropped_events\":0"),std::string::npos);
+ std::remove(trace_file_name.c_str());
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST92
+TEST(NumServerTester, RandomizedTruncatedSVD) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+
+ bool success = true;
+
+ //Nearly low-rank tensor: D = A0 * B0 (rank 4) + 1e-4 * N:
+ success = exatn::createTensorSync("A0",TENS_ELEM_TYPE,TensorShape{64,4}); assert(success);
+ success = exatn::createTensorSync("B0",TENS_ELEM_TYPE,TensorShape{4,48}); assert(success);
+ success = exatn::createTensorSync("N",TENS_ELEM_TYPE,TensorShape{64,48}); assert(success);
+ success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{64,48}); assert(success);
+ success = exatn::initTensorRnd("A0"); assert(success);
+ success = exatn::initTensorRnd("B0"); assert(success);
+ success = exatn::initTensorRnd("N"); assert(success);
+ success = exatn::initTensor("D",0.0); assert(success);
+ success = exatn::contractTensors("D(a,b)+=A0(a,k)*B0(k,b)",1.0); assert(success);
+ success = exatn::addTensorsSync("D(a,b)+=N(a,b)",1e-4); assert(success);
+ double d_norm = 0.0;
+ success = exatn::computeNorm2Sync("D",d_norm); assert(success);
+
+ //Rank-4 truncated SVD (full SVD, then randomized) and its residual norm:
+ double residual[2] = {0.0,0.0};
+ for(const bool randomized: {false,true}){
+  exatn::setSVDTruncation(randomized);
+  success = exatn::createTensorSync("L",TENS_ELEM_TYPE,TensorShape{64,4}); assert(success);
+  success = exatn::createTensorSync("R",TENS_ELEM_TYPE,TensorShape{4,48}); assert(success);
+  success = exatn::createTensorSync("E",TENS_ELEM_TYPE,TensorShape{64,48}); assert(success);
+  success = exatn::initTensor("L",0.0); assert(success);
+  success = exatn::initTensor("R",0.0); assert(success);
+  success = exatn::initTensor("E",0.0); assert(success);
+  success = exatn::decomposeTensorSVDLRSync("D(a,b)=L(a,i)*R(i,b)"); assert(success);
+  success = exatn::addTensors("E(a,b)+=D(a,b)",1.0); assert(success);
+  success = exatn::contractTensors("E(a,b)+=L(a,i)*R(i,b)",-1.0); assert(success);
+  success = exatn::computeNorm2Sync("E",residual[randomized]); assert(success);
+  std::cout << "Rank-4 SVD residual (randomized = " << randomized << ") = " << residual[randomized]
+            << " (tensor norm = " << d_norm << ")" << std::endl;
+  success = exatn::destroyTensorSync("E"); assert(success);
+  success = exatn::destroyTensorSync("R"); assert(success);
+  success = exatn::destroyTensorSync("L"); assert(success);
+ }
+ exatn::setSVDTruncation(false);
+ //The full truncated SVD is optimal; the randomized one is close to it:
+ EXPECT_LT(residual[0],1e-2*d_norm);
+ EXPECT_GE(residual[1],residual[0]*(1.0-1e-6));
+ EXPECT_LE(residual[1],residual[0]*1.05);
+
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::destroyTensorSync("N"); assert(success);
+ success = exatn::destroyTensorSync("B0"); assert(success);
+ success = exatn::destroyTensorSync("A0"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST93
+TEST(NumServerTester, ExternalBufferInit) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const std::size_t VOL = 8 * 6 * 4;
+
+ bool success = true;
+
+ std::vector<double> data(VOL);
+ for(std::size_t i = 0; i < VOL; ++i) data[i] = static_cast<double>(i) - 0.5 * static_cast<double>(VOL);
+ std::vector<float> data_sp(data.cbegin(),data.cend());
+ const std::vector<double> expected(data);
+
+ //Tensor B is initialized from the external buffers (asynchronously), tensor C from a copy of the same data:
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{8,6,4}); assert(success);
+ success = exatn::createTensorSync("B1",TENS_ELEM_TYPE,TensorShape{8,6,4}); assert(success);
+ success = exatn::createTensorSync("C",TENS_ELEM_TYPE,TensorShape{8,6,4}); assert(success);
+ success = exatn::initTensorBuffer("B",data.data()); assert(success);
+ success = exatn::initTensorBuffer("B1",data_sp.data()); assert(success);
+ success = exatn::initTensorDataSync("C",data); assert(success);
+ success = exatn::sync("B"); assert(success);
+ success = exatn::sync("B1"); assert(success);
+ //The external buffers are no longer referenced once the initialization has been executed:
+ std::fill(data.begin(),data.end(),0.0);
+ std::fill(data_sp.begin(),data_sp.end(),0.0f);
+
+ //The tensor body holds the external buffer contents (column-major):
+ auto local_copy = exatn::getLocalTensor("B"); assert(local_copy);
+ EXPECT_EQ(local_copy->getVolume(),VOL);
+ const exatn::TensorDataType<TENS_ELEM_TYPE>::value * body_ptr = nullptr;
+ auto access_granted = local_copy->getDataAccessHostConst(&body_ptr); assert(access_granted);
+ for(std::size_t i = 0; i < VOL; ++i) EXPECT_EQ(body_ptr[i],expected[i]);
+ body_ptr = nullptr;
+ local_copy.reset();
+
+ //The same result as the initialization from the copied data (with the type conversion of B1):
+ double norm = 0.0;
+ success = exatn::addTensorsSync("C(a,b,c)+=B(a,b,c)",-1.0); assert(success);
+ success = exatn::computeNorm1Sync("C",norm); assert(success);
+ EXPECT_NEAR(norm,0.0,1e-12);
+ success = exatn::addTensorsSync("B1(a,b,c)+=B(a,b,c)",-1.0); assert(success);
+ success = exatn::computeNorm1Sync("B1",norm); assert(success);
+ EXPECT_NEAR(norm,0.0,1e-12); //all values are exactly representable in single precision
+
+ success = exatn::destroyTensorSync("C"); assert(success);
+ success = exatn::destroyTensorSync("B1"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST94
+TEST(NumServerTester, ParallelDagExecutor) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const int NUM_PRODUCTS = 8;
+
+ //Parallel DAG executor (falls back to a single worker with a non-thread-safe node executor):
+ exatn::ParamConf parameters;
+ parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ parameters.setParameter("dag_executor_num_workers",static_cast<int64_t>(4));
+ bool success = exatn::reconfigureRuntime(parameters,"parallel-dag-executor"); assert(success);
+
+ success = exatn::createTensorSync("B",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+ success = exatn::createTensorSync("D",TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+ success = exatn::initTensor("B",1.0); assert(success);
+ success = exatn::initTensor("D",0.0); assert(success);
+ //Independent tensor contractions followed by dependent accumulations into D:
+ double expected = 0.0;
+ for(int i = 0; i < NUM_PRODUCTS; ++i){
+  const auto a_name = "A" + std::to_string(i);
+  const auto c_name = "C" + std::to_string(i);
+  success = exatn::createTensor(a_name,TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::createTensor(c_name,TENS_ELEM_TYPE,TensorShape{32,32}); assert(success);
+  success = exatn::initTensor(a_name,static_cast<double>(i+1)); assert(success);
+  success = exatn::initTensor(c_name,0.0); assert(success);
+  success = exatn::contractTensors(c_name + "(a,b)+=" + a_name + "(a,c)*B(c,b)",1.0); assert(success);
+  success = exatn::addTensors("D(a,b)+=" + c_name + "(a,b)",1.0); assert(success);
+  expected += static_cast<double>(i+1) * 32.0; //each element of Ai*B equals (i+1)*32
+ }
+ double norm1 = 0.0;
+ success = exatn::computeNorm1Sync("D",norm1); assert(success);
+ EXPECT_NEAR(norm1,expected*32.0*32.0,1e-6);
+
+ for(int i = 0; i < NUM_PRODUCTS; ++i){
+  success = exatn::destroyTensor("C" + std::to_string(i)); assert(success);
+  success = exatn::destroyTensor("A" + std::to_string(i)); assert(success);
+ }
+ success = exatn::destroyTensorSync("D"); assert(success);
+ success = exatn::destroyTensorSync("B"); assert(success);
+ exatn::ParamConf default_parameters; //ParamConf::setParameter() does not overwrite
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST95
+TEST(NumServerTester, GaussComplexContraction) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorOpCode;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::COMPLEX64;
+ const std::complex<double> alpha{0.5,-1.25};
+ const std::complex<double> beta{0.5,0.25};
+ const std::size_t DIM_A = 16, DIM_B = 20, DIM_C = 24;
+
+ auto make_data = [](std::size_t volume, double phase){
+  std::vector<std::complex<double>> data(volume);
+  for(std::size_t i = 0; i < volume; ++i) data[i] = std::complex<double>{std::sin(phase + 0.37 * i),std::cos(phase - 0.11 * i)};
+  return data;
+ };
+ const auto data_l = make_data(DIM_A*DIM_C,0.1);
+ const auto data_r = make_data(DIM_C*DIM_B,0.7);
+ const auto data_d = make_data(DIM_A*DIM_B,1.3);
+
+ //Executes the non-accumulative, accumulative and scaled accumulative (beta) tensor contractions:
+ auto run = [&](bool gauss){
+  exatn::ParamConf parameters; //ParamConf::setParameter() does not overwrite
+  parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+  if(gauss){ //3M path for all complex tensor contractions (small kernels off)
+   parameters.setParameter("talsh_gauss_contraction_flops",static_cast<int64_t>(1));
+   parameters.setParameter("talsh_small_kernel_flops",static_cast<int64_t>(0));
+  }
+  bool success = exatn::reconfigureRuntime(parameters,"lazy-dag-executor"); assert(success);
+  success = exatn::createTensorSync("L",TENS_ELEM_TYPE,TensorShape{DIM_A,DIM_C}); assert(success);
+  success = exatn::createTensorSync("R",TENS_ELEM_TYPE,TensorShape{DIM_C,DIM_B}); assert(success);
+  success = exatn::initTensorDataSync("L",data_l); assert(success);
+  success = exatn::initTensorDataSync("R",data_r); assert(success);
+  const std::vector<std::pair<std::string,std::string>> contractions{
+   {"D1","D1(a,b)+=L(a,c)*R(c,b)"},{"D2","D2(a,b)+=L(a,c)*R(c,b)"},{"D3","D3(a,b)+=L(a,c)*R+(c,b)"}};
+  const std::vector<std::complex<double>> betas{{0.0,0.0},{1.0,0.0},beta};
+  std::vector<std::vector<std::complex<double>>> results;
+  for(std::size_t i = 0; i < contractions.size(); ++i){
+   const auto & name = contractions[i].first;
+   success = exatn::createTensorSync(name,TENS_ELEM_TYPE,TensorShape{DIM_A,DIM_B}); assert(success);
+   success = exatn::initTensorDataSync(name,data_d); assert(success);
+   std::shared_ptr<exatn::TensorOperation> op = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+   op->setTensorOperand(exatn::getTensor(name));
+   op->setTensorOperand(exatn::getTensor("L"));
+   op->setTensorOperand(exatn::getTensor("R"),(i == 2));
+   op->setScalar(0,alpha);
+   op->setIndexPattern(contractions[i].second);
+   std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(op)->resetBeta(betas[i]);
+   auto tensor_mapper = exatn::numericalServer->getTensorMapper(exatn::getTensorProcessGroup(name));
+   success = exatn::numericalServer->submit(op,tensor_mapper); assert(success);
+   success = exatn::sync(name,true); assert(success);
+   auto local_tensor = exatn::getLocalTensor(name); assert(local_tensor);
+   const std::complex<double> * body = nullptr;
+   success = local_tensor->getDataAccessHostConst(&body); assert(success);
+   results.emplace_back(body,body+local_tensor->getVolume());
+   success = exatn::destroyTensorSync(name); assert(success);
+  }
+  success = exatn::destroyTensorSync("R"); assert(success);
+  success = exatn::destroyTensorSync("L"); assert(success);
+  success = exatn::syncClean(); assert(success);
+  return results;
+ };
+
+ const auto regular = run(false);
+ const auto gauss = run(true);
+ ASSERT_EQ(regular.size(),gauss.size());
+ for(std::size_t i = 0; i < regular.size(); ++i){
+  ASSERT_EQ(regular[i].size(),gauss[i].size());
+  double max_diff = 0.0, max_abs = 0.0;
+  for(std::size_t j = 0; j < regular[i].size(); ++j){
+   max_diff = std::max(max_diff,std::abs(gauss[i][j] - regular[i][j]));
+   max_abs = std::max(max_abs,std::abs(regular[i][j]));
+  }
+  std::cout << "3M vs regular tensor contraction " << i << ": Max deviation = " << max_diff << std::endl;
+  EXPECT_GT(max_abs,1.0);
+  EXPECT_LT(max_diff,1e-10 * max_abs);
+ }
+ //The accumulation and the beta prefactor are applied (column-wise element (0,0)):
+ std::complex<double> product{0.0,0.0}, conj_product{0.0,0.0};
+ for(std::size_t c = 0; c < DIM_C; ++c){
+  product += data_l[c*DIM_A] * data_r[c];
+  conj_product += data_l[c*DIM_A] * std::conj(data_r[c]);
+ }
+ EXPECT_LT(std::abs(gauss[0][0] - alpha * product),1e-10);
+ EXPECT_LT(std::abs(gauss[1][0] - (data_d[0] + alpha * product)),1e-10);
+ EXPECT_LT(std::abs(gauss[2][0] - (beta * data_d[0] + alpha * conj_product)),1e-10);
+
+ exatn::ParamConf default_parameters;
+ default_parameters.setParameter("host_memory_buffer_size",4L*1024L*1024L*1024L);
+ bool success = exatn::reconfigureRuntime(default_parameters,"lazy-dag-executor"); assert(success);
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST96
+TEST(NumServerTester, ThreadedSliceInsert) {
+ using exatn::TensorShape;
+ using exatn::TensorSignature;
+ using exatn::TensorElementType;
+ using exatn::SOME_SPACE;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const std::vector<std::size_t> extents{16,32,24,20}; //tensor volume 245760
+ //Slices larger than the parallel volume threshold (65536) of the Host slicing kernel:
+ // (a) Leading dimension covered in full (contiguous run spans two dimensions);
+ // (b) No dimension covered in full (contiguous run is a partial leading dimension).
+ const std::vector<std::pair<std::vector<std::size_t>,std::vector<std::size_t>>> slices{
+  {{16,24,16,16},{0,4,6,2}},{{12,30,20,18},{3,1,2,1}}};
+
+ auto volume_of = [](const std::vector<std::size_t> & dims){
+  std::size_t volume = 1;
+  for(const auto & dim: dims) volume *= dim;
+  return volume;
+ };
+ //Linear offset in the tensor of the element of a slice with a given linear offset (column-major):
+ auto tensor_offset = [&](const std::vector<std::size_t> & slice_extents,
+                          const std::vector<std::size_t> & offsets,
+                          std::size_t slice_offset){
+  std::size_t offset = 0, stride = 1;
+  for(std::size_t i = 0; i < extents.size(); ++i){
+   offset += (offsets[i] + slice_offset % slice_extents[i]) * stride;
+   slice_offset /= slice_extents[i];
+   stride *= extents[i];
+  }
+  return offset;
+ };
+ auto host_data = [](const std::string & name){
+  auto local_tensor = exatn::getLocalTensor(name); assert(local_tensor);
+  const double * body = nullptr;
+  bool success = local_tensor->getDataAccessHostConst(&body); assert(success);
+  return std::vector<double>(body,body+local_tensor->getVolume());
+ };
+
+ std::vector<double> tensor_data(volume_of(extents));
+ for(std::size_t i = 0; i < tensor_data.size(); ++i) tensor_data[i] = static_cast<double>(i);
+ bool success = exatn::createTensorSync("T",TENS_ELEM_TYPE,TensorShape(extents)); assert(success);
+ success = exatn::initTensorDataSync("T",tensor_data); assert(success);
+ for(std::size_t n = 0; n < slices.size(); ++n){
+  const auto & slice_extents = slices[n].first;
+  const auto & offsets = slices[n].second;
+  const auto slice_volume = volume_of(slice_extents);
+  ASSERT_GT(slice_volume,65536);
+  std::vector<std::pair<exatn::SpaceId,exatn::SubspaceId>> subspaces;
+  for(const auto & offset: offsets) subspaces.emplace_back(std::make_pair(SOME_SPACE,offset));
+  const std::string slice_name = "S" + std::to_string(n);
+  success = exatn::createTensorSync(slice_name,TENS_ELEM_TYPE,TensorShape(slice_extents),TensorSignature(subspaces)); assert(success);
+  //Extraction:
+  success = exatn::initTensorSync(slice_name,-1.0); assert(success);
+  success = exatn::extractTensorSliceSync("T",slice_name); assert(success);
+  auto slice_data = host_data(slice_name);
+  ASSERT_EQ(slice_data.size(),slice_volume);
+  std::size_t mismatches = 0;
+  for(std::size_t i = 0; i < slice_volume; ++i){
+   if(slice_data[i] != tensor_data[tensor_offset(slice_extents,offsets,i)]) ++mismatches;
+  }
+  EXPECT_EQ(mismatches,0);
+  //Insertion:
+  std::vector<double> insert_data(slice_volume);
+  for(std::size_t i = 0; i < slice_volume; ++i) insert_data[i] = -1.0 - static_cast<double>(i);
+  success = exatn::initTensorDataSync(slice_name,insert_data); assert(success);
+  success = exatn::insertTensorSliceSync("T",slice_name); assert(success);
+  for(std::size_t i = 0; i < slice_volume; ++i) tensor_data[tensor_offset(slice_extents,offsets,i)] = insert_data[i];
+  EXPECT_EQ(host_data("T"),tensor_data); //inserted region replaced, the rest of the tensor intact
+  success = exatn::destroyTensorSync(slice_name); assert(success);
+ }
+ success = exatn::destroyTensorSync("T"); assert(success);
+
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST97
+TEST(NumServerTester, ImplicitTensorEarlyDestruction) {
+ using exatn::Tensor;
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+ using exatn::TensorNetwork;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ bool success = exatn::createTensorSync("GA",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::createTensorSync("GB",TENS_ELEM_TYPE,TensorShape{8,8}); assert(success);
+ success = exatn::initTensorRndSync("GA"); assert(success);
+ success = exatn::initTensorRndSync("GB"); assert(success);
+ //Tensor networks with implicitly created output tensors (the client only holds the tensor networks):
+ auto make_network = [](const std::string & output_name){
+  std::map<std::string,std::shared_ptr<Tensor>> tensors{{"GA",exatn::getTensor("GA")},{"GB",exatn::getTensor("GB")},
+                                                        {output_name,std::make_shared<Tensor>(output_name,TensorShape{8,8})}};
+  return std::make_shared<TensorNetwork>(output_name,output_name + "(a,b)+=GA(a,c)*GB(c,b)",tensors);
+ };
+ auto network0 = make_network("GZ0");
+ auto network1 = make_network("GZ1");
+ auto network2 = make_network("GZ2");
+ success = exatn::evaluateSync(*network0); assert(success);
+ success = exatn::sync(); assert(success); //executed tensor operations dissociate their tensor operands
+ EXPECT_TRUE(exatn::withinTensorExistenceDomain("GZ0"));
+ //An implicit tensor still referenced by the client survives a tensor network submission:
+ success = exatn::evaluate(*network1); assert(success);
+ EXPECT_TRUE(exatn::withinTensorExistenceDomain("GZ0"));
+ success = exatn::sync(); assert(success);
+ //An orphaned implicit tensor is destroyed upon the next tensor network submission (no synchronization point):
+ network0.reset();
+ EXPECT_TRUE(exatn::withinTensorExistenceDomain("GZ0"));
+ success = exatn::evaluate(*network2); assert(success);
+ EXPECT_FALSE(exatn::withinTensorExistenceDomain("GZ0"));
+ EXPECT_TRUE(exatn::withinTensorExistenceDomain("GZ1","GZ2"));
+ //The remaining implicit tensors are destroyed at a synchronization point once orphaned:
+ network1.reset();
+ network2.reset();
+ success = exatn::sync(); assert(success); //GZ2 may still be referenced by its outstanding tensor operations here
+ success = exatn::sync(); assert(success);
+ EXPECT_FALSE(exatn::withinTensorExistenceDomain("GZ1"));
+ EXPECT_FALSE(exatn::withinTensorExistenceDomain("GZ2"));
+ success = exatn::destroyTensorSync("GB"); assert(success);
+ success = exatn::destroyTensorSync("GA"); assert(success);
+
+ success = exatn::syncClean(); assert(success);
+}
+#endif
+
+#ifdef EXATN_TEST98
+TEST(NumServerTester, CompositeContraction) {
+ using exatn::TensorShape;
+ using exatn::TensorElementType;
+
+ const auto TENS_ELEM_TYPE = TensorElementType::REAL64;
+ const std::size_t DIM_K = 64, DIM_I = 48, DIM_J = 40;
+ const double alpha = 0.5;
+
+ auto make_data = [](std::size_t volume, double phase){
+  std::vector<double> data(volume);
+  for(std::size_t i = 0; i < volume; ++i) data[i] = std::sin(phase + 0.37 * i);
+  return data;
+ };
+ const auto data_a = make_data(DIM_K*DIM_I,0.1);
+ const auto data_b = make_data(DIM_K*DIM_J,0.7);
+ const auto data_c = make_data(DIM_I*DIM_J,1.3);
+
+ const auto & all_processes = exatn::getDefaultProcessGroup();
+ //Composite tensors with mismatching bisections of the contracted dimension (overlapping left/right blocks):
+ bool success = exatn::createTensorSync(all_processes,"CA",
+                                        std::vector<std::pair<unsigned int, unsigned int>>{{0,1},{1,1}},
+                                        TENS_ELEM_TYPE,TensorShape{DIM_K,DIM_I}); assert(success);
+ success = exatn::createTensorSync(all_processes,"CB",
+                                   std::vector<std::pair<unsigned int, unsigned int>>{{0,2},{1,1}},
+                                   TENS_ELEM_TYPE,TensorShape{DIM_K,DIM_J}); assert(success);
+ success = exatn::createTensorSync(all_processes,"CC",
+                                   std::vector<std::pair<unsigned int, unsigned int>>{{0,1},{1,2}},
+                                   TENS_ELEM_TYPE,TensorShape{DIM_I,DIM_J}); assert(success);
+ ASSERT_TRUE(exatn::castTensorComposite(exatn::getTensor("CC")));
+ //Regular tensors with the same data (reference):
+ success = exatn::createTensorSync("RA",TENS_ELEM_TYPE,TensorShape{DIM_K,DIM_I}); assert(success);
+ success = exatn::createTensorSync("RB",TENS_ELEM_TYPE,TensorShape{DIM_K,DIM_J}); assert(success);
+ success = exatn::createTensorSync("RC",TENS_ELEM_TYPE,TensorShape{DIM_I,DIM_J}); assert(success);
+ for(const auto & name: {"CA","RA"}){success = exatn::initTensorDataSync(name,data_a); assert(success);}
+ for(const auto & name: {"CB","RB"}){success = exatn::initTensorDataSync(name,data_b); assert(success);}
+ for(const auto & name: {"CC","RC"}){success = exatn::initTensorDataSync(name,data_c); assert(success);}
+
+ //Distributed (SUMMA-style) composite tensor contraction VS regular tensor contraction:
+ success = exatn::contractTensorsSync("CC(i,j)+=CA(k,i)*CB(k,j)",alpha); assert(success);
+ success = exatn::contractTensorsSync("RC(i,j)+=RA(k,i)*RB(k,j)",alpha); assert(success);
+ success = exatn::sync(); assert(success);
+
+ //The reference is correct (element (0,0)):
+ double product = 0.0;
+ for(std::size_t k = 0; k < DIM_K; ++k) product += data_a[k] * data_b[k];
+ auto local_tensor = exatn::getLocalTensor("RC"); assert(local_tensor);
+ const double * body = nullptr;
+ success = local_tensor->getDataAccessHostConst(&body); assert(success);
+ EXPECT_NEAR(body[0],data_c[0] + alpha * product,1e-10);
+ //Full and partial (per index value) norms of the results agree:
+ double composite_norm = 0.0, regular_norm = 0.0;
+ success = exatn::computeNorm2Sync("CC",composite_norm); assert(success);
+ success = exatn::computeNorm2Sync("RC",regular_norm); assert(success);
+ std::cout << "2-norm of the composite tensor contraction = " << composite_norm
+           << " VS regular = " << regular_norm << std::endl;
+ EXPECT_GT(regular_norm,1.0);
+ EXPECT_NEAR(composite_norm,regular_norm,1e-10 * regular_norm);
+ for(unsigned int dim = 0; dim < 2; ++dim){
+  std::vector<double> composite_pnorms, regular_pnorms;
+  success = exatn::computePartialNormsSync("CC",dim,composite_pnorms); assert(success);
+  success = exatn::computePartialNormsSync("RC",dim,regular_pnorms); assert(success);
+  ASSERT_EQ(composite_pnorms.size(),regular_pnorms.size());
+  for(std::size_t i = 0; i < regular_pnorms.size(); ++i){
+   EXPECT_NEAR(composite_pnorms[i],regular_pnorms[i],1e-10 * regular_norm * regular_norm);
+  }
+ }
+
+ for(const auto & name: {"RC","RB","RA","CC","CB","CA"}){success = exatn::destroyTensorSync(name); assert(success);}
+
+ success = exatn::syncClean(); assert(success);
+}
+#endif
 
 int main(int argc, char **argv) {
 
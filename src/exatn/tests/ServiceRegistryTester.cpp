@@ -13,9 +13,13 @@ TEST(ServiceRegistryTester, checkInitialize) {
 
  ServiceRegistry registry;
  registry.initialize(fakepluginpath);
+ EXPECT_EQ(0,registry.getNumBundles().first); //bundles are loaded on demand
  auto test = registry.getService<TestInterface>("test");
  auto s = test->test("HOWDY");
  EXPECT_EQ("HOWDY",s);
+ EXPECT_GE(registry.getNumBundles().first,1);
+ EXPECT_FALSE(registry.hasService<TestInterface>("missing"));
+ EXPECT_EQ(registry.getNumBundles().first,registry.getNumBundles().second);
 }
 
 int main(int argc, char **argv) {
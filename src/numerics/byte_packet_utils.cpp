@@ -0,0 +1,84 @@
+/** ExaTN::Numerics: Byte packet utilities: Bulk packing, capacity reservation, packet pool
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "byte_packet_utils.hpp"
+
+#include <cstdlib>
+
+namespace exatn{
+
+bool reserveBytePacket(BytePacket * packet,
+                       std::size_t capacity)
+{
+ if(capacity <= packet->capacity) return true;
+ void * new_addr = std::realloc(packet->base_addr,capacity);
+ if(new_addr == nullptr) return false;
+ packet->base_addr = new_addr;
+ packet->capacity = capacity;
+ return true;
+}
+
+
+struct BytePacketPool::Idle{
+ std::mutex lock;
+ std::size_t max_packets;
+ std::vector<BytePacket*> packets;
+
+ ~Idle(){
+  for(auto * packet: packets){
+   destroyBytePacket(packet);
+   delete packet;
+  }
+ }
+};
+
+
+BytePacketPool::BytePacketPool(std::size_t max_packets):
+ idle_(std::make_shared<Idle>())
+{
+ idle_->max_packets = max_packets;
+}
+
+
+std::shared_ptr<BytePacket> BytePacketPool::acquire(std::size_t min_capacity)
+{
+ BytePacket * packet = nullptr;
+ {
+  std::lock_guard<std::mutex> lock(idle_->lock);
+  if(!(idle_->packets.empty())){
+   packet = idle_->packets.back();
+   idle_->packets.pop_back();
+  }
+ }
+ if(packet == nullptr){
+  packet = new BytePacket;
+  initBytePacket(packet);
+ }
+ auto reserved = reserveBytePacket(packet,min_capacity); assert(reserved);
+ std::weak_ptr<Idle> pool = idle_;
+ return std::shared_ptr<BytePacket>(packet,[pool](BytePacket * packet){
+  clearBytePacket(packet);
+  auto idle = pool.lock();
+  if(idle){
+   std::lock_guard<std::mutex> lock(idle->lock);
+   if(idle->packets.size() < idle->max_packets){
+    idle->packets.emplace_back(packet);
+    return;
+   }
+  }
+  destroyBytePacket(packet);
+  delete packet;
+ });
+}
+
+
+std::size_t BytePacketPool::getNumIdle() const
+{
+ std::lock_guard<std::mutex> lock(idle_->lock);
+ return idle_->packets.size();
+}
+
+} //namespace exatn
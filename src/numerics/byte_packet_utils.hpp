@@ -0,0 +1,108 @@
+/** ExaTN::Numerics: Byte packet utilities: Bulk packing, capacity reservation, packet pool
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) BytePacket (TAL-SH) packs items one by one (appendToBytePacket/extractFromBytePacket)
+     into a buffer of fixed capacity. Contiguous arrays (tensor names, dimension extents,
+     graph adjacency arrays, etc.) are instead appended/extracted here as a single memory
+     copy, growing the packet buffer (geometrically) when it is full. The array elements
+     must be byte-copyable, as required by appendToBytePacket.
+ (b) reserveBytePacket() grows the packet buffer to the given capacity in advance, for example
+     before receiving a packet of known size via MPI. The TAL-SH packet buffer is allocated
+     by malloc and released by destroyBytePacket, thus it can be grown via realloc.
+ (c) BytePacketPool keeps initialized byte packets for reuse by repeated metadata exchanges,
+     such that their (grown) buffers are neither reallocated nor leaked. A packet acquired
+     from the pool is returned to it (cleared) once its last reference is gone; packets
+     exceeding the pool size, or returned after the pool is gone, are destroyed.
+**/
+
+#ifndef EXATN_NUMERICS_BYTE_PACKET_UTILS_HPP_
+#define EXATN_NUMERICS_BYTE_PACKET_UTILS_HPP_
+
+#include "byte_packet.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+
+namespace exatn{
+
+/** Grows the byte packet buffer to at least the given capacity (bytes).
+    Returns FALSE if the memory could not be allocated. **/
+bool reserveBytePacket(BytePacket * packet,
+                       std::size_t capacity);
+
+/** Appends a contiguous array of items to the byte packet (single copy). **/
+template <typename T>
+void appendArrayToBytePacket(BytePacket * packet, const T * items, std::size_t count)
+{
+ static_assert(std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value,
+               "#FATAL(exatn::appendArrayToBytePacket): Array items must be byte-copyable!");
+ const std::size_t num_bytes = count * sizeof(T);
+ if(num_bytes == 0) return;
+ const std::size_t end_pos = packet->position + num_bytes;
+ if(end_pos > packet->capacity){
+  const std::size_t doubled = 2 * static_cast<std::size_t>(packet->capacity);
+  auto reserved = reserveBytePacket(packet,(doubled > end_pos) ? doubled : end_pos);
+  assert(reserved);
+ }
+ std::memcpy(static_cast<char*>(packet->base_addr) + packet->position,static_cast<const void*>(items),num_bytes);
+ packet->position = end_pos;
+ if(packet->position > packet->size_bytes) packet->size_bytes = packet->position;
+ return;
+}
+
+/** Extracts a contiguous array of items from the byte packet (single copy).
+    Returns a non-zero error code if the byte packet does not contain enough data. **/
+template <typename T>
+int extractArrayFromBytePacket(BytePacket * packet, T * items, std::size_t count)
+{
+ static_assert(std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value,
+               "#FATAL(exatn::extractArrayFromBytePacket): Array items must be byte-copyable!");
+ const std::size_t num_bytes = count * sizeof(T);
+ if(num_bytes == 0) return 0;
+ if(packet->position + num_bytes > packet->size_bytes) return -1;
+ std::memcpy(static_cast<void*>(items),static_cast<const char*>(packet->base_addr) + packet->position,num_bytes);
+ packet->position += num_bytes;
+ return 0;
+}
+
+
+class BytePacketPool{
+public:
+
+ static constexpr std::size_t DEFAULT_MAX_PACKETS = 4; //max number of idle packets kept by the pool
+
+ explicit BytePacketPool(std::size_t max_packets = DEFAULT_MAX_PACKETS);
+
+ BytePacketPool(const BytePacketPool &) = delete;
+ BytePacketPool & operator=(const BytePacketPool &) = delete;
+ BytePacketPool(BytePacketPool &&) noexcept = delete;
+ BytePacketPool & operator=(BytePacketPool &&) noexcept = delete;
+ ~BytePacketPool() = default;
+
+ /** Acquires an empty byte packet of at least the given capacity (bytes),
+     which returns to the pool once released. **/
+ std::shared_ptr<BytePacket> acquire(std::size_t min_capacity = 0);
+
+ /** Returns the number of idle packets kept by the pool. **/
+ std::size_t getNumIdle() const;
+
+private:
+
+ struct Idle; //idle packets (shared with the acquired packets)
+
+ std::shared_ptr<Idle> idle_;
+};
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_BYTE_PACKET_UTILS_HPP_
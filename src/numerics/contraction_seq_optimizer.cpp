@@ -1,23 +1,77 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Base
-REVISION: 2021/04/01
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "contraction_seq_optimizer.hpp"
 #include "tensor_network.hpp"
-#include "metis_graph.hpp"
+#include "tensor_network_flat.hpp"
 
 #include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <chrono>
+
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace exatn{
 
 namespace numerics{
 
 //Cache of already determined tensor network contraction sequences:
-std::unordered_map<std::string,ContractionSeqOptimizer::CachedContrSeq> ContractionSeqOptimizer::cached_contr_seqs_;
-bool ContractionSeqOptimizer::cache_to_disk_{false};
+ContractionSeqOptimizer::CacheShard ContractionSeqOptimizer::cache_shards_[ContractionSeqOptimizer::CACHE_SHARDS];
+std::atomic<std::size_t> ContractionSeqOptimizer::cache_capacity_{ContractionSeqOptimizer::DEFAULT_CACHE_CAPACITY};
+std::atomic<std::uint64_t> ContractionSeqOptimizer::cache_clock_{0};
+std::atomic<std::size_t> ContractionSeqOptimizer::cache_hits_{0};
+std::atomic<std::size_t> ContractionSeqOptimizer::cache_misses_{0};
+std::atomic<std::size_t> ContractionSeqOptimizer::cache_insertions_{0};
+std::atomic<std::size_t> ContractionSeqOptimizer::cache_evictions_{0};
+std::atomic<std::uint64_t> ContractionSeqOptimizer::cache_saved_time_{0};
+std::atomic<bool> ContractionSeqOptimizer::cache_to_disk_{false};
+std::string ContractionSeqOptimizer::cache_db_file_{ContractionSeqOptimizer::DEFAULT_CACHE_DB_FILE};
+std::mutex ContractionSeqOptimizer::cache_db_lock_;
+
+//Persistent database record layout:
+// {uint32 magic, uint64 payload size, uint64 payload checksum, payload}, payload:
+// {uint64 structural hash, uint32 num tensors, {uint32 num legs, {uint32 position, uint64 extent}}, uint32 num contractions, {uint32 result, left, right}, double flops}
+constexpr const std::uint32_t CSEQ_RECORD_MAGIC = 0x51534345; //"ECSQ"
+
+template<typename T>
+inline void appendToBytes(std::vector<char> & bytes, const T & value)
+{
+ const auto offset = bytes.size();
+ bytes.resize(offset + sizeof(T));
+ std::memcpy(bytes.data() + offset, &value, sizeof(T));
+ return;
+}
+
+template<typename T>
+inline bool extractFromBytes(const std::vector<char> & bytes, std::size_t & position, std::size_t end, T & value)
+{
+ if(position + sizeof(T) > end) return false;
+ std::memcpy(&value, bytes.data() + position, sizeof(T));
+ position += sizeof(T);
+ return true;
+}
+
+inline std::uint64_t checksumBytes(const char * bytes, std::size_t size) //FNV-1a
+{
+ std::uint64_t hash = 0xcbf29ce484222325ULL;
+ for(std::size_t i = 0; i < size; ++i){
+  hash ^= static_cast<unsigned char>(bytes[i]);
+  hash *= 0x100000001b3ULL;
+ }
+ return hash;
+}
 
 
 void packContractionSequenceIntoVector(const std::list<ContrTriple> & contr_sequence,
@@ -51,21 +105,215 @@ void unpackContractionSequenceFromVector(std::list<ContrTriple> & contr_sequence
 }
 
 
-bool ContractionSeqOptimizer::cacheContractionSequence(const TensorNetwork & network)
+ContractionSeqOptimizer::CanonicalStructure ContractionSeqOptimizer::canonicalizeTensorNetwork(const TensorNetwork & network)
+{
+ auto combine = [](std::size_t seed, std::size_t value){
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+ };
+
+ //Enumerate tensors (the output tensor is always present and distinguished):
+ std::vector<unsigned int> tensor_ids;
+ std::unordered_map<unsigned int, unsigned int> tensor_pos; //tensor id --> position
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  tensor_pos.emplace(std::make_pair(iter->first,static_cast<unsigned int>(tensor_ids.size())));
+  tensor_ids.emplace_back(iter->first);
+ }
+ const std::size_t num_tensors = tensor_ids.size();
+ std::vector<std::vector<std::pair<unsigned int,DimExtent>>> adjacency(num_tensors); //position --> {connected position, extent}
+ std::vector<std::size_t> labels(num_tensors,0);
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  const auto pos = tensor_pos[iter->first];
+  const auto & tensor = iter->second;
+  const auto & legs = tensor.getTensorLegs();
+  std::vector<DimExtent> extents;
+  for(unsigned int i = 0; i < legs.size(); ++i){
+   adjacency[pos].emplace_back(std::make_pair(tensor_pos[legs[i].getTensorId()],tensor.getDimExtent(i)));
+   extents.emplace_back(tensor.getDimExtent(i));
+  }
+  std::sort(extents.begin(),extents.end());
+  std::size_t label = (iter->first == 0) ? 1 : 2;
+  for(const auto extent: extents) label = combine(label,extent);
+  labels[pos] = label;
+ }
+
+ //Refine tensor labels by their neighborhood until no more tensors get distinguished:
+ auto count_distinct = [](std::vector<std::size_t> values){
+  std::sort(values.begin(),values.end());
+  return static_cast<std::size_t>(std::distance(values.begin(),std::unique(values.begin(),values.end())));
+ };
+ auto refine = [&](){
+  auto num_distinct = count_distinct(labels);
+  std::vector<std::pair<DimExtent,std::size_t>> neighborhood;
+  while(true){
+   std::vector<std::size_t> new_labels(num_tensors,0);
+   for(std::size_t pos = 0; pos < num_tensors; ++pos){
+    neighborhood.clear();
+    for(const auto & leg: adjacency[pos]) neighborhood.emplace_back(std::make_pair(leg.second,labels[leg.first]));
+    std::sort(neighborhood.begin(),neighborhood.end());
+    std::size_t label = labels[pos];
+    for(const auto & nb: neighborhood) label = combine(combine(label,nb.first),nb.second);
+    new_labels[pos] = label;
+   }
+   labels.swap(new_labels);
+   const auto new_num_distinct = count_distinct(labels);
+   if(new_num_distinct <= num_distinct) break;
+   num_distinct = new_num_distinct;
+  }
+  return num_distinct;
+ };
+ //Individualize the first tensor of the smallest indistinguishable class until all tensors are distinguished:
+ while(refine() < num_tensors){
+  std::map<std::size_t,std::vector<unsigned int>> classes; //label --> positions
+  for(std::size_t pos = 0; pos < num_tensors; ++pos) classes[labels[pos]].emplace_back(pos);
+  for(const auto & cls: classes){
+   if(cls.second.size() > 1){
+    labels[cls.second.front()] = combine(labels[cls.second.front()],cls.second.size());
+    break;
+   }
+  }
+ }
+
+ //Build the canonical structure:
+ std::vector<unsigned int> order(num_tensors); //canonical position --> position
+ for(unsigned int pos = 0; pos < num_tensors; ++pos) order[pos] = pos;
+ std::sort(order.begin(),order.end(),[&labels](unsigned int p1, unsigned int p2){return labels[p1] < labels[p2];});
+ std::vector<unsigned int> canonical(num_tensors); //position --> canonical position
+ for(unsigned int cpos = 0; cpos < num_tensors; ++cpos) canonical[order[cpos]] = cpos;
+ CanonicalStructure structure;
+ structure.hash = num_tensors;
+ structure.legs.resize(num_tensors);
+ structure.tensor_ids.resize(num_tensors);
+ for(unsigned int cpos = 0; cpos < num_tensors; ++cpos){
+  const auto pos = order[cpos];
+  structure.tensor_ids[cpos] = tensor_ids[pos];
+  auto & legs = structure.legs[cpos];
+  for(const auto & leg: adjacency[pos]) legs.emplace_back(std::make_pair(canonical[leg.first],leg.second));
+  std::sort(legs.begin(),legs.end());
+  structure.hash = combine(structure.hash,legs.size());
+  for(const auto & leg: legs) structure.hash = combine(combine(structure.hash,leg.first),leg.second);
+ }
+ return structure;
+}
+
+
+std::size_t ContractionSeqOptimizer::CachedContrSeq::getSize() const
+{
+ std::size_t size = sizeof(CachedContrSeq) + sizeof(std::size_t) + 2 * sizeof(void*); //entry + hash node
+ for(const auto & tensor_legs: legs) size += sizeof(tensor_legs) + tensor_legs.size() * sizeof(tensor_legs[0]);
+ size += contr_seq.size() * (sizeof(ContrTriple) + 2 * sizeof(void*)); //list nodes
+ return size;
+}
+
+
+std::list<ContrTriple> ContractionSeqOptimizer::canonicalizeContractionSequence(const CanonicalStructure & structure,
+                                                                               const std::list<ContrTriple> & contr_seq)
 {
- if(!(network.exportContractionSequence().empty())){
-  auto res = cached_contr_seqs_.emplace(network.getName(),
-   std::move(CachedContrSeq{std::make_shared<MetisGraph>(network),network.exportContractionSequence(),network.getFMAFlops()}));
-  if(res.second && cache_to_disk_){
-   const auto & kv = *(res.first);
-   std::ofstream cseq_file(kv.first + ".cseq.exatn",std::ios::out|std::ios::trunc);
-   cseq_file << kv.second.fma_flops << " " << kv.second.contr_seq.size() << std::endl;
-   for(const auto & triple: kv.second.contr_seq){
-    cseq_file << triple.result_id << " " << triple.left_id << " " << triple.right_id << std::endl;
+ //Convert tensor ids into canonical positions (intermediate tensors follow the input tensors):
+ std::unordered_map<unsigned int, unsigned int> canonical_ids;
+ for(unsigned int cpos = 0; cpos < structure.tensor_ids.size(); ++cpos) canonical_ids[structure.tensor_ids[cpos]] = cpos;
+ unsigned int intermediate_id = structure.tensor_ids.size();
+ std::list<ContrTriple> canonical_seq;
+ for(const auto & contr: contr_seq){
+  auto left = canonical_ids.find(contr.left_id); assert(left != canonical_ids.end());
+  auto right = canonical_ids.find(contr.right_id); assert(right != canonical_ids.end());
+  unsigned int result_id = 0;
+  if(contr.result_id != 0){
+   result_id = intermediate_id++;
+   canonical_ids[contr.result_id] = result_id;
+  }else{
+   result_id = canonical_ids[0];
+  }
+  canonical_seq.emplace_back(ContrTriple{result_id,left->second,right->second});
+ }
+ return canonical_seq;
+}
+
+
+bool ContractionSeqOptimizer::insertCachedContrSeq(std::size_t hash,
+                                                   std::vector<std::vector<std::pair<unsigned int,DimExtent>>> && legs,
+                                                   std::list<ContrTriple> && canonical_seq,
+                                                   double fma_flops,
+                                                   double search_time)
+{
+ auto & shard = cache_shards_[hash % CACHE_SHARDS];
+ std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+ auto range = shard.entries.equal_range(hash);
+ for(auto iter = range.first; iter != range.second; ++iter){
+  if(iter->second.legs == legs) return false; //isomorphic tensor network already cached
+ }
+ auto inserted = shard.entries.emplace(std::piecewise_construct,std::forward_as_tuple(hash),
+                  std::forward_as_tuple(std::move(legs),std::move(canonical_seq),fma_flops,search_time));
+ inserted->second.last_use.store(++cache_clock_,std::memory_order_relaxed);
+ shard.bytes += inserted->second.getSize();
+ ++cache_insertions_;
+ //Evict the least recently used entries exceeding the shard capacity (keeping the new one):
+ const std::size_t shard_capacity = cache_capacity_.load() / CACHE_SHARDS;
+ while(shard.bytes > shard_capacity && shard.entries.size() > 1){
+  auto victim = shard.entries.end();
+  for(auto iter = shard.entries.begin(); iter != shard.entries.end(); ++iter){
+   if(iter != inserted){
+    if(victim == shard.entries.end() ||
+       iter->second.last_use.load(std::memory_order_relaxed) < victim->second.last_use.load(std::memory_order_relaxed)) victim = iter;
    }
-   cseq_file.close();
   }
-  return res.second;
+  shard.bytes -= victim->second.getSize();
+  shard.entries.erase(victim);
+  ++cache_evictions_;
+ }
+ return true;
+}
+
+
+bool ContractionSeqOptimizer::cacheContractionSequence(const TensorNetwork & network, bool writer, double search_time)
+{
+ const auto & contr_seq = network.exportContractionSequence();
+ if(!(contr_seq.empty())){
+  auto structure = canonicalizeTensorNetwork(network);
+  auto canonical_seq = canonicalizeContractionSequence(structure,contr_seq);
+  const double fma_flops = network.getFMAFlops();
+  //Prepare the persistent database record before the entry becomes visible (and evictable):
+  std::vector<char> record;
+  if(cache_to_disk_.load() && writer){
+   std::vector<char> payload;
+   appendToBytes(payload,static_cast<std::uint64_t>(structure.hash));
+   appendToBytes(payload,static_cast<std::uint32_t>(structure.legs.size()));
+   for(const auto & legs: structure.legs){
+    appendToBytes(payload,static_cast<std::uint32_t>(legs.size()));
+    for(const auto & leg: legs){
+     appendToBytes(payload,static_cast<std::uint32_t>(leg.first));
+     appendToBytes(payload,static_cast<std::uint64_t>(leg.second));
+    }
+   }
+   appendToBytes(payload,static_cast<std::uint32_t>(canonical_seq.size()));
+   for(const auto & contr: canonical_seq){
+    appendToBytes(payload,static_cast<std::uint32_t>(contr.result_id));
+    appendToBytes(payload,static_cast<std::uint32_t>(contr.left_id));
+    appendToBytes(payload,static_cast<std::uint32_t>(contr.right_id));
+   }
+   appendToBytes(payload,fma_flops);
+   appendToBytes(record,CSEQ_RECORD_MAGIC);
+   appendToBytes(record,static_cast<std::uint64_t>(payload.size()));
+   appendToBytes(record,checksumBytes(payload.data(),payload.size()));
+   record.insert(record.end(),payload.cbegin(),payload.cend());
+  }
+  auto cached = insertCachedContrSeq(structure.hash,std::move(structure.legs),std::move(canonical_seq),fma_flops,search_time);
+  if(cached && !(record.empty())){ //append a new record to the persistent database
+   std::lock_guard<std::mutex> lock(cache_db_lock_);
+   //Single atomic append (concurrent writers never interleave records):
+   int fd = ::open(cache_db_file_.c_str(),O_WRONLY|O_APPEND|O_CREAT,0644);
+   if(fd >= 0){
+    const auto written = ::write(fd,record.data(),record.size());
+    if(written < 0 || static_cast<std::size_t>(written) != record.size()){
+     std::cout << "#WARNING(ContractionSeqOptimizer::cacheContractionSequence): Unable to append to "
+               << cache_db_file_ << std::endl << std::flush;
+    }
+    ::close(fd);
+   }else{
+    std::cout << "#WARNING(ContractionSeqOptimizer::cacheContractionSequence): Unable to open "
+              << cache_db_file_ << std::endl << std::flush;
+   }
+  }
+  return cached;
  }
  return false;
 }
@@ -73,50 +321,407 @@ bool ContractionSeqOptimizer::cacheContractionSequence(const TensorNetwork & net
 
 bool ContractionSeqOptimizer::eraseContractionSequence(const TensorNetwork & network)
 {
- auto num_deleted = cached_contr_seqs_.erase(network.getName());
- return (num_deleted == 1);
+ const auto structure = canonicalizeTensorNetwork(network);
+ auto & shard = cache_shards_[structure.hash % CACHE_SHARDS];
+ std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+ auto range = shard.entries.equal_range(structure.hash);
+ for(auto iter = range.first; iter != range.second; ++iter){
+  if(iter->second.legs == structure.legs){
+   shard.bytes -= iter->second.getSize();
+   shard.entries.erase(iter);
+   return true;
+  }
+ }
+ return false;
+}
+
+
+bool ContractionSeqOptimizer::findContractionSequence(const TensorNetwork & network,
+                                                      std::list<ContrTriple> & contr_seq,
+                                                      double * fma_flops)
+{
+ contr_seq.clear();
+ const auto structure = canonicalizeTensorNetwork(network);
+ const auto & shard = cache_shards_[structure.hash % CACHE_SHARDS];
+ std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+ auto range = shard.entries.equal_range(structure.hash);
+ for(auto iter = range.first; iter != range.second; ++iter){
+  if(iter->second.legs == structure.legs){ //isomorphic tensor network: Remap canonical positions to tensor ids
+   const unsigned int num_tensors = structure.tensor_ids.size();
+   const unsigned int output_pos = std::distance(structure.tensor_ids.cbegin(),
+    std::find(structure.tensor_ids.cbegin(),structure.tensor_ids.cend(),0U));
+   const unsigned int max_tensor_id = *std::max_element(structure.tensor_ids.cbegin(),structure.tensor_ids.cend());
+   auto tensor_id = [&](unsigned int cpos){
+    return (cpos < num_tensors) ? structure.tensor_ids[cpos] : (max_tensor_id + 1 + (cpos - num_tensors));
+   };
+   for(const auto & contr: iter->second.contr_seq){
+    const unsigned int result_id = (contr.result_id == output_pos) ? 0 : tensor_id(contr.result_id);
+    contr_seq.emplace_back(ContrTriple{result_id,tensor_id(contr.left_id),tensor_id(contr.right_id)});
+   }
+   if(fma_flops != nullptr) *fma_flops = iter->second.fma_flops;
+   iter->second.last_use.store(++cache_clock_,std::memory_order_relaxed);
+   ++cache_hits_;
+   cache_saved_time_ += static_cast<std::uint64_t>(iter->second.search_time * 1e6);
+   return true;
+  }
+ }
+ ++cache_misses_;
+ return false;
 }
 
 
-std::pair<const std::list<ContrTriple> *, double> ContractionSeqOptimizer::findContractionSequence(const TensorNetwork & network)
+void ContractionSeqOptimizer::resetCacheCapacity(std::size_t max_bytes)
 {
- auto iter = cached_contr_seqs_.find(network.getName());
- if(iter != cached_contr_seqs_.end()){
-  MetisGraph network_graph(network);
-  if(network_graph == *(iter->second.graph)) return std::make_pair(&(iter->second.contr_seq),iter->second.fma_flops);
- }else{
-  if(cache_to_disk_){
-   std::ifstream cseq_file(network.getName() + ".cseq.exatn",std::ios::in);
-   if(cseq_file.is_open()){
-    double flops = 0.0;
-    std::size_t num_contractions = 0;
-    cseq_file >> flops >> num_contractions;
-    //std::cout << "#DEBUG: Reading cseq.exatn file: " << flops << " " << num_contractions << std::endl; //debug
-    auto res = cached_contr_seqs_.emplace(network.getName(),
-     std::move(CachedContrSeq{std::make_shared<MetisGraph>(network),std::list<ContrTriple>(num_contractions),flops}));
-    if(res.second){
-     auto & cseq = res.first->second.contr_seq;
-     for(auto contr = cseq.begin(); contr != cseq.end(); ++contr){
-      cseq_file >> contr->result_id >> contr->left_id >> contr->right_id;
-     }
-     cseq_file.close();
-     return std::make_pair(&(res.first->second.contr_seq),res.first->second.fma_flops);
+ cache_capacity_.store(max_bytes);
+ const std::size_t shard_capacity = max_bytes / CACHE_SHARDS;
+ for(auto & shard: cache_shards_){
+  std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+  while(shard.bytes > shard_capacity && !(shard.entries.empty())){
+   auto victim = shard.entries.begin();
+   for(auto iter = shard.entries.begin(); iter != shard.entries.end(); ++iter){
+    if(iter->second.last_use.load(std::memory_order_relaxed) < victim->second.last_use.load(std::memory_order_relaxed)) victim = iter;
+   }
+   shard.bytes -= victim->second.getSize();
+   shard.entries.erase(victim);
+   ++cache_evictions_;
+  }
+ }
+ return;
+}
+
+
+ContractionSeqOptimizer::CacheStatistics ContractionSeqOptimizer::getCacheStatistics()
+{
+ CacheStatistics stats;
+ stats.hits = cache_hits_.load();
+ stats.misses = cache_misses_.load();
+ stats.insertions = cache_insertions_.load();
+ stats.evictions = cache_evictions_.load();
+ stats.saved_time = static_cast<double>(cache_saved_time_.load()) * 1e-6;
+ for(const auto & shard: cache_shards_){
+  std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+  stats.entries += shard.entries.size();
+  stats.bytes += shard.bytes;
+ }
+ return stats;
+}
+
+
+void ContractionSeqOptimizer::resetCacheStatistics()
+{
+ cache_hits_.store(0);
+ cache_misses_.store(0);
+ cache_insertions_.store(0);
+ cache_evictions_.store(0);
+ cache_saved_time_.store(0);
+ return;
+}
+
+
+void ContractionSeqOptimizer::activatePersistentCaching(bool persist,
+                                                        const std::string & db_file_name)
+{
+ std::lock_guard<std::mutex> lock(cache_db_lock_);
+ cache_db_file_ = db_file_name;
+ cache_to_disk_.store(persist);
+ return;
+}
+
+
+bool ContractionSeqOptimizer::readPersistentCache(std::vector<char> & db_content)
+{
+ db_content.clear();
+ if(!cache_to_disk_.load()) return false;
+ std::lock_guard<std::mutex> lock(cache_db_lock_);
+ int fd = ::open(cache_db_file_.c_str(),O_RDONLY);
+ if(fd < 0) return false;
+ struct stat file_stat;
+ bool success = (::fstat(fd,&file_stat) == 0);
+ if(success && file_stat.st_size > 0){
+  const std::size_t db_size = static_cast<std::size_t>(file_stat.st_size);
+  void * db_ptr = ::mmap(nullptr,db_size,PROT_READ,MAP_PRIVATE,fd,0);
+  if(db_ptr != MAP_FAILED){
+   db_content.assign(static_cast<const char*>(db_ptr),static_cast<const char*>(db_ptr) + db_size);
+   ::munmap(db_ptr,db_size);
+  }else{
+   success = false;
+  }
+ }
+ ::close(fd);
+ return success;
+}
+
+
+std::size_t ContractionSeqOptimizer::importPersistentCache(const std::vector<char> & db_content)
+{
+ std::size_t num_imported = 0;
+ std::size_t position = 0;
+ const std::size_t db_size = db_content.size();
+ while(position < db_size){
+  //Record header:
+  std::uint32_t magic = 0;
+  std::uint64_t payload_size = 0, checksum = 0;
+  if(!(extractFromBytes(db_content,position,db_size,magic) && magic == CSEQ_RECORD_MAGIC)) break;
+  if(!(extractFromBytes(db_content,position,db_size,payload_size) && extractFromBytes(db_content,position,db_size,checksum))) break;
+  if(payload_size > db_size - position) break; //torn record
+  const std::size_t end = position + payload_size;
+  if(checksumBytes(db_content.data() + position,payload_size) != checksum) break; //corrupted record
+  //Record payload:
+  std::uint64_t hash = 0;
+  std::uint32_t num_tensors = 0, num_legs = 0, num_contractions = 0;
+  bool valid = extractFromBytes(db_content,position,end,hash) && extractFromBytes(db_content,position,end,num_tensors);
+  std::vector<std::vector<std::pair<unsigned int,DimExtent>>> legs;
+  std::list<ContrTriple> canonical_seq;
+  double fma_flops = 0.0;
+  if(valid) legs.resize(num_tensors);
+  for(std::uint32_t i = 0; valid && i < num_tensors; ++i){
+   valid = extractFromBytes(db_content,position,end,num_legs);
+   for(std::uint32_t j = 0; valid && j < num_legs; ++j){
+    std::uint32_t pos = 0;
+    std::uint64_t extent = 0;
+    valid = extractFromBytes(db_content,position,end,pos) && extractFromBytes(db_content,position,end,extent) && (pos < num_tensors);
+    if(valid) legs[i].emplace_back(std::make_pair(static_cast<unsigned int>(pos),static_cast<DimExtent>(extent)));
+   }
+  }
+  if(valid) valid = extractFromBytes(db_content,position,end,num_contractions);
+  for(std::uint32_t i = 0; valid && i < num_contractions; ++i){
+   std::uint32_t result_id = 0, left_id = 0, right_id = 0;
+   valid = extractFromBytes(db_content,position,end,result_id) && extractFromBytes(db_content,position,end,left_id)
+        && extractFromBytes(db_content,position,end,right_id)
+        && result_id < num_tensors + num_contractions && left_id < num_tensors + num_contractions
+        && right_id < num_tensors + num_contractions;
+   if(valid) canonical_seq.emplace_back(ContrTriple{result_id,left_id,right_id});
+  }
+  if(valid) valid = extractFromBytes(db_content,position,end,fma_flops) && (position == end);
+  position = end;
+  if(!valid) continue; //malformed record
+  //Insert into the in-memory cache (duplicates are ignored):
+  if(insertCachedContrSeq(static_cast<std::size_t>(hash),std::move(legs),std::move(canonical_seq),fma_flops,0.0)) ++num_imported;
+ }
+ return num_imported;
+}
+
+
+void ContractionSeqOptimizer::resetMemoryLimit(double max_intermediate_volume)
+{
+ assert(max_intermediate_volume >= 0.0);
+ max_intermediate_volume_ = max_intermediate_volume;
+ return;
+}
+
+
+void ContractionSeqOptimizer::resetTimeBudget(double time_budget,
+                                              double contraction_time_fraction,
+                                              double fma_flop_rate)
+{
+ assert(time_budget >= 0.0 && contraction_time_fraction >= 0.0 && fma_flop_rate >= 0.0);
+ time_budget_ = time_budget;
+ contraction_time_fraction_ = contraction_time_fraction;
+ fma_flop_rate_ = fma_flop_rate;
+ return;
+}
+
+
+double ContractionSeqOptimizer::getTimeBudget(double fma_flops) const
+{
+ double time_budget = time_budget_;
+ if(contraction_time_fraction_ > 0.0 && fma_flop_rate_ > 0.0){
+  time_budget = std::max(time_budget,contraction_time_fraction_ * fma_flops / fma_flop_rate_);
+ }
+ return time_budget;
+}
+
+
+double ContractionSeqOptimizer::determineSlicedFlops(const TensorNetwork & network,
+                                                     const std::list<ContrTriple> & contr_seq,
+                                                     double max_intermediate_volume,
+                                                     double * num_slices,
+                                                     double * max_volume)
+{
+ using EdgeSet = std::vector<unsigned int>; //sorted ids of tensor network edges
+
+ //Enumerate tensor network edges (each edge connects two tensor legs):
+ const TensorNetworkFlat network_flat(network);
+ std::vector<double> extents(network_flat.getNumEdges(),1.0); //edge id --> dimension extent
+ std::unordered_map<unsigned int, EdgeSet> tensors; //tensor id --> edges of the tensor
+ tensors.reserve((network_flat.getNumTensors() + 1) * 2);
+ for(std::size_t vertex = 0; vertex <= network_flat.getNumTensors(); ++vertex){
+  const auto rank = network_flat.getRank(vertex);
+  const auto * leg_edges = network_flat.getLegEdges(vertex);
+  const auto * leg_extents = network_flat.getLegExtents(vertex);
+  auto & edges = tensors[network_flat.getTensorId(vertex)];
+  edges.assign(leg_edges,leg_edges + rank);
+  for(unsigned int i = 0; i < rank; ++i) extents[leg_edges[i]] = static_cast<double>(leg_extents[i]);
+  std::sort(edges.begin(),edges.end());
+ }
+
+ //Simulate the tensor contraction sequence:
+ std::vector<EdgeSet> contr_edges;  //all edges of each tensor contraction
+ std::vector<EdgeSet> result_edges; //edges of the tensor-result of each tensor contraction
+ for(const auto & contr: contr_seq){
+  const auto & left = tensors[contr.left_id];
+  const auto & right = tensors[contr.right_id];
+  contr_edges.emplace_back(EdgeSet());
+  std::set_union(left.cbegin(),left.cend(),right.cbegin(),right.cend(),std::back_inserter(contr_edges.back()));
+  result_edges.emplace_back(EdgeSet());
+  std::set_symmetric_difference(left.cbegin(),left.cend(),right.cbegin(),right.cend(),std::back_inserter(result_edges.back()));
+  if(contr.result_id != 0) tensors[contr.result_id] = result_edges.back();
+  tensors.erase(contr.left_id);
+  tensors.erase(contr.right_id);
+ }
+
+ //Choose sliced edges (the same way as TensorNetwork::splitIndices):
+ std::vector<double> segments(extents.size(),1.0); //number of segments each edge is split into
+ if(max_intermediate_volume > 0.0){
+  std::vector<double> edge_volume(extents.size(),0.0); //cumulative volume of intermediates carrying each edge
+  for(const auto & edges: result_edges){
+   double volume = 1.0;
+   for(const auto edge: edges) volume *= extents[edge];
+   for(const auto edge: edges) edge_volume[edge] += volume;
+  }
+  for(auto result = result_edges.crbegin(); result != result_edges.crend(); ++result){
+   double volume = 1.0;
+   std::vector<unsigned int> full_edges;
+   for(const auto edge: *result){
+    if(segments[edge] > 1.0){
+     volume *= extents[edge] / segments[edge];
     }else{
-     cseq_file.close();
+     volume *= extents[edge];
+     full_edges.emplace_back(edge);
+    }
+   }
+   if(volume > max_intermediate_volume && !full_edges.empty()){
+    std::stable_sort(full_edges.begin(),full_edges.end(),[&edge_volume](unsigned int e1, unsigned int e2){
+                                                          return edge_volume[e1] < edge_volume[e2];
+                                                         });
+    int i = full_edges.size() - 1;
+    int stalled = 0;
+    while(volume > max_intermediate_volume && stalled < static_cast<int>(full_edges.size())){
+     const auto edge = full_edges[i];
+     if(segments[edge] * 2.0 <= extents[edge]){
+      segments[edge] *= 2.0; volume /= 2.0; stalled = 0;
+     }else{
+      ++stalled;
+     }
+     if(--i < 0) i = full_edges.size() - 1;
     }
    }
   }
  }
- return std::pair<const std::list<ContrTriple> *, double> {nullptr,0.0};
+
+ //Compute the total sliced FMA flop count:
+ double total_slices = 1.0;
+ for(const auto & segs: segments) total_slices *= segs;
+ double flops = 0.0;
+ for(const auto & edges: contr_edges){
+  double contr_flops = 1.0, contr_slices = 1.0;
+  for(const auto edge: edges){
+   contr_flops *= extents[edge];
+   contr_slices *= segments[edge];
+  }
+  flops += contr_flops * (total_slices / contr_slices); //recomputation due to slicing of other edges
+ }
+ if(num_slices != nullptr) *num_slices = total_slices;
+ if(max_volume != nullptr){
+  *max_volume = 0.0;
+  for(const auto & edges: result_edges){
+   double volume = 1.0;
+   for(const auto edge: edges) volume *= extents[edge] / segments[edge];
+   *max_volume = std::max(*max_volume,volume);
+  }
+ }
+ return flops;
+}
+
+
+//Telemetry of the current tensor contraction sequence search (per thread):
+static thread_local ContractionSeqOptimizer::SearchTelemetry search_telemetry;
+static thread_local std::chrono::steady_clock::time_point search_start = std::chrono::steady_clock::now();
+
+
+ContractionSeqOptimizer::SearchTelemetry & ContractionSeqOptimizer::searchTelemetry()
+{
+ return search_telemetry;
+}
+
+
+double ContractionSeqOptimizer::searchElapsedTime()
+{
+ const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - search_start;
+ return elapsed.count();
 }
 
 
-void ContractionSeqOptimizer::activatePersistentCaching(bool persist)
+void ContractionSeqOptimizer::beginSearchTelemetry(std::size_t num_tensors)
 {
- cache_to_disk_ = persist;
+ search_telemetry = SearchTelemetry();
+ search_telemetry.num_tensors = num_tensors;
+ search_start = std::chrono::steady_clock::now();
  return;
 }
 
+
+void ContractionSeqOptimizer::endSearchTelemetry(const TensorNetwork & network,
+                                                 const std::list<ContrTriple> & contr_seq,
+                                                 double fma_flops) const
+{
+ auto & telemetry = search_telemetry;
+ telemetry.total_time = searchElapsedTime();
+ if(telemetry.optimizer.empty()) telemetry.optimizer = "other"; //optimizer without its own telemetry
+ telemetry.fma_flops = fma_flops;
+ telemetry.memory_limit = max_intermediate_volume_;
+ if(!contr_seq.empty()){
+  telemetry.sliced_fma_flops = determineSlicedFlops(network,contr_seq,max_intermediate_volume_,
+                                                    &(telemetry.num_slices),&(telemetry.max_intermediate_volume));
+ }else{
+  telemetry.sliced_fma_flops = fma_flops;
+ }
+ if(telemetry.convergence.empty() || telemetry.convergence.back().second != telemetry.sliced_fma_flops)
+  telemetry.convergence.emplace_back(std::make_pair(telemetry.total_time,telemetry.sliced_fma_flops));
+ return;
+}
+
+
+ContractionSeqOptimizer::SearchTelemetry ContractionSeqOptimizer::getSearchTelemetry()
+{
+ return search_telemetry;
+}
+
+
+//Distributed search context (per thread):
+static thread_local unsigned int search_variant = 0;
+static thread_local std::function<double (double)> search_bound_exchange;
+
+
+void ContractionSeqOptimizer::beginDistributedSearch(unsigned int variant,
+                                                     std::function<double (double)> bound_exchange)
+{
+ search_variant = variant;
+ search_bound_exchange = std::move(bound_exchange);
+ return;
+}
+
+
+void ContractionSeqOptimizer::endDistributedSearch()
+{
+ search_variant = 0;
+ search_bound_exchange = nullptr;
+ return;
+}
+
+
+unsigned int ContractionSeqOptimizer::searchVariant()
+{
+ return search_variant;
+}
+
+
+double ContractionSeqOptimizer::exchangeSearchBound(double fma_flops)
+{
+ if(search_bound_exchange) return std::min(fma_flops,search_bound_exchange(fma_flops));
+ return fma_flops;
+}
+
 } //namespace numerics
 
 } //namespace exatn
@@ -1,10 +1,51 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer
-REVISION: 2021/04/01
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
+ (a) Tensor contraction sequences are cached by the canonical structure of the tensor
+     network (tensor shapes and their connectivity), which is invariant to tensor ids
+     and names. A cached tensor contraction sequence thus serves all isomorphic tensor
+     networks, with its tensor ids remapped to those of the requesting tensor network.
+     The canonical tensor ordering is obtained by the iterative refinement of tensor
+     labels by their neighborhood (with individualization of indistinguishable tensors),
+     and a cache hit is always verified by the exact comparison of canonical structures.
+ (b) Persistent caching stores tensor contraction sequences in a single binary
+     database file which is an append-only log of self-delimited, check-summed
+     records in canonical tensor positions, keyed by the structural hash. The database
+     is memory-mapped and parsed into the in-memory hash index at once (this can be done
+     by a single process which then distributes the raw database to others). Torn or
+     corrupted records terminate parsing, and every cache hit is validated against
+     the stored canonical structure. Only designated writers append new records.
+ (c) The in-memory cache is shared by all threads of the process: It is split into
+     shards (by the structural hash), each protected by a reader-writer lock such that
+     lookups only take a shared lock. The memory occupied by the cache is bounded,
+     with the least recently used entries being evicted (approximate LRU via logical
+     time stamps updated atomically on lookup). Cache statistics are collected.
+ (d) A tensor contraction sequence optimizer can be given a memory limit, that is,
+     the max volume of intermediate tensors. Intermediate tensors exceeding it
+     will be sliced by splitting some of the tensor network indices, which causes
+     recomputation of the tensor contractions not carrying the split indices.
+     An optimizer supporting the memory limit minimizes the total sliced Flop count.
+ (e) A tensor contraction sequence optimizer can be given a wall-clock time budget
+     (anytime mode), trading the search time against the contraction time explicitly.
+     An optimizer supporting the anytime mode keeps improving the best tensor contraction
+     sequence until the budget expires; the result then depends on the machine speed.
+ (f) Each full tensor contraction sequence search records its telemetry in the calling thread:
+     Total search time, the chosen (sliced) FMA flop count, the max intermediate volume and
+     the number of slices of the chosen tensor contraction sequence, as well as the optimizer-specific
+     search phases (graph construction, partitioning, walker evaluation, merging of walker results),
+     the number of walkers and rounds, and the convergence of the best-so-far flop count over time.
+     Phase times accumulated over concurrent walkers may exceed the total search time.
+ (g) A tensor contraction sequence search can be a part of a distributed search in which multiple
+     processes search for the same tensor network concurrently: Each process is given its own
+     search variant (different random streams and search parameters, variant 0 being the default
+     search) and, optionally, a bound exchange which shares the best-so-far (sliced) FMA flop count
+     among the processes. An optimizer supporting it prunes its search by the shared best-so-far
+     Flop count and evaluates the anytime time budget at it, such that all processes stop together.
+     The distributed search context is set per thread, similarly to the search telemetry.
 **/
 
 #ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_HPP_
@@ -13,10 +54,16 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_basic.hpp"
 
 #include <list>
+#include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+#include <cstdint>
 
 #include "errors.hpp"
 
@@ -59,35 +106,211 @@ public:
                                              std::list<ContrTriple> & contr_seq,
                                              std::function<unsigned int ()> intermediate_num_generator) = 0;
 
+ /** Resets the memory limit, that is, the max volume of intermediate tensors
+     to be enforced by tensor slicing (0.0 means no limit). **/
+ virtual void resetMemoryLimit(double max_intermediate_volume);
+
+ /** Resets the time budget of the anytime mode in which an optimizer supporting it keeps
+     improving the best tensor contraction sequence until the wall-clock budget expires.
+     The budget is either fixed (sec) or set automatically as a fraction of the estimated
+     contraction time at the current best FMA flop count for the given FMA flop rate,
+     whichever is larger (all zeros mean no anytime mode). **/
+ virtual void resetTimeBudget(double time_budget,                 //in: fixed wall-clock time budget (sec)
+                              double contraction_time_fraction = 0.0, //in: time budget as a fraction of the estimated contraction time
+                              double fma_flop_rate = 0.0);        //in: FMA flop rate for estimating the contraction time (FMA/sec)
+
+ /** Estimates the total FMA flop count of a given tensor contraction sequence executed
+     with some tensor network indices sliced such that no intermediate tensor exceeds
+     the given volume. The choice of the sliced indices mimics TensorNetwork::splitIndices,
+     otherwise returns the unsliced FMA flop count if the volume limit is zero. **/
+ static double determineSlicedFlops(const TensorNetwork & network,               //in: tensor network
+                                    const std::list<ContrTriple> & contr_seq,    //in: tensor contraction sequence
+                                    double max_intermediate_volume,              //in: max volume of intermediate tensors
+                                    double * num_slices = nullptr,               //out: total number of slices
+                                    double * max_volume = nullptr);              //out: max volume of (sliced) intermediate tensors
+
  /** Caches the determined pseudo-optimal tensor contraction sequence for a given
-     tensor network for a later retrieval for the same tensor networks. Returns TRUE
-     on success, FALSE in case this tensor network has already been cached before. **/
- static bool cacheContractionSequence(const TensorNetwork & network); //in: tensor network with a determined tensor contraction sequence
+     tensor network for a later retrieval for the same (isomorphic) tensor networks. Returns TRUE
+     on success, FALSE in case an isomorphic tensor network has already been cached before.
+     With persistent caching activated, a writer also appends the new record to the database file. **/
+ static bool cacheContractionSequence(const TensorNetwork & network, //in: tensor network with a determined tensor contraction sequence
+                                      bool writer = true,            //in: whether or not the caller appends to the persistent database
+                                      double search_time = 0.0);     //in: time spent in determining the tensor contraction sequence (sec)
 
- /** Erases the previously cached tensor contraction sequence for a given tensor
+ /** Erases the previously cached tensor contraction sequence for a given (isomorphic) tensor
      network and returns TRUE, or returns FALSE in case it has not been cached before. **/
  static bool eraseContractionSequence(const TensorNetwork & network); //in: tensor network
 
- /** Retrieves a previously cached tensor contraction sequence for a given tensor
-     network and its corresponding FMA flop count. Returns {nullptr,0.0} in case
+ /** Retrieves a previously cached tensor contraction sequence for a given tensor network
+     (or any isomorphic one) and its corresponding FMA flop count. The tensor ids in the
+     retrieved tensor contraction sequence refer to the given tensor network, with
+     intermediate tensor ids following its max tensor id. Returns FALSE in case
      no previously cached tensor contraction sequence has been found. **/
- static std::pair<const std::list<ContrTriple> *, double> findContractionSequence(const TensorNetwork & network); //in: tensor network
+ static bool findContractionSequence(const TensorNetwork & network,  //in: tensor network
+                                     std::list<ContrTriple> & contr_seq, //out: tensor contraction sequence
+                                     double * fma_flops = nullptr);      //out: FMA flop count
+
+ /** Activates/deactivates persistent caching of tensor contraction sequences in a binary database file. **/
+ static void activatePersistentCaching(bool persist,
+                                       const std::string & db_file_name = DEFAULT_CACHE_DB_FILE);
+
+ /** Reads the raw content of the persistent database file (memory-mapped). Returns FALSE
+     if persistent caching is not active or the database file does not exist yet. **/
+ static bool readPersistentCache(std::vector<char> & db_content); //out: raw database content
+
+ /** Imports tensor contraction sequences from the raw content of the persistent database
+     into the in-memory cache. Returns the number of imported (valid and new) records. **/
+ static std::size_t importPersistentCache(const std::vector<char> & db_content); //in: raw database content
+
+ /** Resets the max memory occupied by the in-memory cache of tensor contraction sequences (bytes). **/
+ static void resetCacheCapacity(std::size_t max_bytes);
+
+ //Cache statistics:
+ struct CacheStatistics{
+  std::size_t hits = 0;       //number of successful lookups
+  std::size_t misses = 0;     //number of failed lookups
+  std::size_t insertions = 0; //number of cached tensor contraction sequences
+  std::size_t evictions = 0;  //number of evicted tensor contraction sequences
+  std::size_t entries = 0;    //current number of cached tensor contraction sequences
+  std::size_t bytes = 0;      //current memory occupied by the cache (approximate)
+  double saved_time = 0.0;    //total search time saved by cache hits (sec)
+ };
+
+ /** Returns the cache statistics. **/
+ static CacheStatistics getCacheStatistics();
+
+ /** Resets the cache statistics counters. **/
+ static void resetCacheStatistics();
+
+ //Telemetry of a tensor contraction sequence search:
+ struct SearchTelemetry{
+  std::string optimizer;             //tensor contraction sequence optimizer
+  std::size_t num_tensors = 0;       //number of input tensors in the tensor network
+  double total_time = 0.0;           //total search time (sec)
+  double graph_time = 0.0;           //graph construction time (sec)
+  double partition_time = 0.0;       //graph partitioning time (sec, accumulated over walkers)
+  std::size_t partition_calls = 0;   //number of graph partitioning calls
+  double evaluation_time = 0.0;      //walker evaluation time: flop count and slicing simulation (sec, accumulated over walkers)
+  double merge_time = 0.0;           //merging of walker results (sec)
+  unsigned int num_walkers = 0;      //number of walkers per round (or beam width)
+  unsigned int num_rounds = 0;       //number of rounds of walkers (or passes)
+  std::size_t num_aborted = 0;       //number of walkers aborted early (dominated by the best-so-far)
+  std::vector<std::pair<double,double>> convergence; //best-so-far (sliced) FMA flop count over time: {time since the search start (sec), flops}
+  double fma_flops = 0.0;            //FMA flop count of the chosen tensor contraction sequence
+  double sliced_fma_flops = 0.0;     //sliced FMA flop count of the chosen tensor contraction sequence under the memory limit
+  double memory_limit = 0.0;         //memory limit: max volume of intermediate tensors (0.0 means no limit)
+  double max_intermediate_volume = 0.0; //max volume of (sliced) intermediate tensors of the chosen tensor contraction sequence
+  double num_slices = 1.0;           //number of slices of the chosen tensor contraction sequence
+ };
+
+ /** Starts the telemetry of a new full tensor contraction sequence search in the calling thread. **/
+ static void beginSearchTelemetry(std::size_t num_tensors); //in: number of input tensors
+
+ /** Finishes the telemetry of the full tensor contraction sequence search in the calling thread
+     given the chosen tensor contraction sequence and its FMA flop count. **/
+ void endSearchTelemetry(const TensorNetwork & network,
+                         const std::list<ContrTriple> & contr_seq,
+                         double fma_flops) const;
+
+ /** Returns the telemetry of the last full tensor contraction sequence search performed by the calling thread. **/
+ static SearchTelemetry getSearchTelemetry();
+
+ /** Makes the subsequent tensor contraction sequence searches performed by the calling thread
+     a part of a distributed search with a given search variant and an optional bound exchange
+     which shares the local best-so-far (sliced) FMA flop count and returns the best one
+     found by all searching processes so far (the bound exchange must not block). **/
+ static void beginDistributedSearch(unsigned int search_variant,                             //in: search variant (0: default search)
+                                    std::function<double (double)> bound_exchange = nullptr); //in: bound exchange (local best --> shared best)
 
- /** Activates/deactivates disk caching of tensor contraction sequences. **/
- static void activatePersistentCaching(bool persist);
+ /** Ends the distributed search in the calling thread (subsequent searches are independent). **/
+ static void endDistributedSearch();
+
+ static constexpr const char * DEFAULT_CACHE_DB_FILE = "cseq_cache.exatn"; //default persistent database file
+ static constexpr const std::size_t DEFAULT_CACHE_CAPACITY = 256 * 1024 * 1024; //default max memory occupied by the cache (bytes)
+ static constexpr const unsigned int CACHE_SHARDS = 16; //number of cache shards
+
+protected:
+
+ /** Returns the current time budget of the anytime mode (sec) for the given best-so-far FMA flop count. **/
+ double getTimeBudget(double fma_flops) const;
+
+ /** Returns the telemetry of the current tensor contraction sequence search in the calling thread. **/
+ static SearchTelemetry & searchTelemetry();
+
+ /** Returns the time elapsed since the start of the current tensor contraction sequence search (sec). **/
+ static double searchElapsedTime();
+
+ /** Returns the search variant of the current distributed search in the calling thread (0: default search). **/
+ static unsigned int searchVariant();
+
+ /** Exchanges the local best-so-far (sliced) FMA flop count within the current distributed search
+     in the calling thread and returns the shared best-so-far FMA flop count (the local one if none). **/
+ static double exchangeSearchBound(double fma_flops);
+
+ /** Returns whether or not the anytime mode is active. **/
+ bool isAnytime() const {return (time_budget_ > 0.0 || (contraction_time_fraction_ > 0.0 && fma_flop_rate_ > 0.0));}
+
+ double max_intermediate_volume_ = 0.0; //memory limit: max volume of intermediate tensors (0.0 means no limit)
+ double time_budget_ = 0.0;               //anytime mode: fixed wall-clock time budget (sec)
+ double contraction_time_fraction_ = 0.0; //anytime mode: time budget as a fraction of the estimated contraction time
+ double fma_flop_rate_ = 0.0;             //anytime mode: FMA flop rate for estimating the contraction time (FMA/sec)
 
 private:
 
+ //Canonical structure of a tensor network (invariant to tensor ids and names):
+ struct CanonicalStructure{
+  std::size_t hash;                                               //structural hash
+  std::vector<std::vector<std::pair<unsigned int,DimExtent>>> legs; //canonical tensor position --> sorted {canonical position of the connected tensor, dimension extent}
+  std::vector<unsigned int> tensor_ids;                           //canonical tensor position --> tensor id (not a part of the structure)
+ };
+
  //Cached optimized tensor contraction sequence:
  struct CachedContrSeq{
-  std::shared_ptr<MetisGraph> graph; //METIS graph of the tensor network
-  std::list<ContrTriple> contr_seq;  //optimized tensor contraction sequence for the tensor network
-  double fma_flops;                  //FMA flop count for the stored tensor contraction sequence
+  std::vector<std::vector<std::pair<unsigned int,DimExtent>>> legs; //canonical structure of the tensor network
+  std::list<ContrTriple> contr_seq; //optimized tensor contraction sequence in canonical tensor positions
+  double fma_flops;                 //FMA flop count for the stored tensor contraction sequence
+  double search_time;               //time spent in determining the tensor contraction sequence (sec)
+  mutable std::atomic<std::uint64_t> last_use; //logical time stamp of the last use (LRU)
+
+  CachedContrSeq(std::vector<std::vector<std::pair<unsigned int,DimExtent>>> && structure_legs,
+                 std::list<ContrTriple> && canonical_seq, double flops, double time):
+   legs(std::move(structure_legs)), contr_seq(std::move(canonical_seq)),
+   fma_flops(flops), search_time(time), last_use(0) {}
+
+  std::size_t getSize() const; //approximate memory footprint (bytes)
  };
 
+ //Cache shard:
+ struct CacheShard{
+  mutable std::shared_timed_mutex lock; //reader-writer lock
+  std::unordered_multimap<std::size_t,CachedContrSeq> entries; //structural hash --> optimized tensor contraction sequence
+  std::size_t bytes = 0; //memory occupied by the shard (approximate)
+ };
+
+ /** Determines the canonical structure of a tensor network. **/
+ static CanonicalStructure canonicalizeTensorNetwork(const TensorNetwork & network);
+
+ /** Converts a tensor contraction sequence into canonical tensor positions. **/
+ static std::list<ContrTriple> canonicalizeContractionSequence(const CanonicalStructure & structure,
+                                                               const std::list<ContrTriple> & contr_seq);
+
+ /** Inserts a new entry into the cache (evicting the least recently used entries
+     if needed). Returns FALSE if an isomorphic tensor network is already cached. **/
+ static bool insertCachedContrSeq(std::size_t hash,
+                                  std::vector<std::vector<std::pair<unsigned int,DimExtent>>> && legs,
+                                  std::list<ContrTriple> && canonical_seq,
+                                  double fma_flops,
+                                  double search_time);
+
  /** Cached tensor contraction sequences. **/
- static std::unordered_map<std::string,CachedContrSeq> cached_contr_seqs_; //tensor network name --> optimized tensor contraction sequence
- static bool cache_to_disk_; //will additionally cache tensor contraction sequences to disk files
+ static CacheShard cache_shards_[CACHE_SHARDS]; //cache shards (by structural hash)
+ static std::atomic<std::size_t> cache_capacity_; //max memory occupied by the cache (bytes)
+ static std::atomic<std::uint64_t> cache_clock_; //logical clock for the LRU time stamps
+ static std::atomic<std::size_t> cache_hits_, cache_misses_, cache_insertions_, cache_evictions_;
+ static std::atomic<std::uint64_t> cache_saved_time_; //saved search time (microseconds)
+ static std::atomic<bool> cache_to_disk_; //will additionally cache tensor contraction sequences to the persistent database
+ static std::string cache_db_file_; //persistent database file name (protected by the persistence lock)
+ static std::mutex cache_db_lock_;  //persistence lock
 };
 
 using createContractionSeqOptimizerFn = std::unique_ptr<ContractionSeqOptimizer> (*)(void);
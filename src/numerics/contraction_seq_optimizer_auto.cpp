@@ -0,0 +1,105 @@
+/** ExaTN::Numerics: Tensor contraction sequence optimizer: Automatic selection
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "contraction_seq_optimizer_auto.hpp"
+#include "contraction_seq_optimizer_greed.hpp"
+#include "contraction_seq_optimizer_metis.hpp"
+#include "contraction_seq_optimizer_dp.hpp"
+#include "tensor_network.hpp"
+#include "tensor_network_flat.hpp"
+
+#include <unordered_set>
+#include <vector>
+#include <iostream>
+
+namespace exatn{
+
+namespace numerics{
+
+std::string ContractionSeqOptimizerAuto::selectOptimizer(const TensorNetwork & network,
+                                                         NetworkFeatures * features)
+{
+ //Build the input tensor graph (the output tensor is excluded):
+ NetworkFeatures feats;
+ const TensorNetworkFlat network_flat(network);
+ feats.num_tensors = network_flat.getNumTensors();
+ std::vector<std::unordered_set<unsigned int>> graph(feats.num_tensors + 1); //vertex --> adjacent vertices
+ for(std::size_t vertex = 1; vertex <= feats.num_tensors; ++vertex){
+  const auto rank = network_flat.getRank(vertex);
+  const auto * leg_vertices = network_flat.getLegVertices(vertex);
+  const auto * leg_extents = network_flat.getLegExtents(vertex);
+  for(unsigned int i = 0; i < rank; ++i){
+   if(leg_vertices[i] != 0 && leg_vertices[i] != vertex) graph[vertex].emplace(leg_vertices[i]);
+   feats.max_extent = std::max(feats.max_extent,leg_extents[i]);
+  }
+  feats.max_rank = std::max(feats.max_rank,rank);
+ }
+ //Estimate the treewidth by the min-degree elimination:
+ std::vector<bool> eliminated(feats.num_tensors + 1,false);
+ for(std::size_t step = 0; step < feats.num_tensors; ++step){
+  std::size_t vertex = 0;
+  for(std::size_t v = 1; v <= feats.num_tensors; ++v){
+   if(!eliminated[v] && (vertex == 0 || graph[v].size() < graph[vertex].size())) vertex = v;
+  }
+  feats.treewidth = std::max(feats.treewidth,static_cast<unsigned int>(graph[vertex].size()));
+  for(const auto neighbor: graph[vertex]){ //eliminated vertex turns its neighborhood into a clique
+   auto & adjacent = graph[neighbor];
+   adjacent.erase(vertex);
+   for(const auto other: graph[vertex]){
+    if(other != neighbor) adjacent.emplace(other);
+   }
+  }
+  graph[vertex].clear();
+  eliminated[vertex] = true;
+ }
+ if(features != nullptr) *features = feats;
+ //Select the optimizer:
+ if(feats.num_tensors <= EXACT_MAX_TENSORS) return "dp";
+ if(feats.treewidth <= CHAIN_MAX_TREEWIDTH && feats.max_rank <= CHAIN_MAX_RANK) return "greed";
+ return "metis";
+}
+
+
+double ContractionSeqOptimizerAuto::determineContractionSequence(const TensorNetwork & network,
+                                                                 std::list<ContrTriple> & contr_seq,
+                                                                 std::function<unsigned int ()> intermediate_num_generator)
+{
+ const bool debugging = false;
+
+ NetworkFeatures features;
+ last_selection_ = selectOptimizer(network,&features);
+ auto iter = optimizers_.find(last_selection_);
+ if(iter == optimizers_.end()){
+  std::unique_ptr<ContractionSeqOptimizer> optimizer;
+  if(last_selection_ == "dp"){
+   optimizer = ContractionSeqOptimizerDP::createNew();
+  }else if(last_selection_ == "greed"){
+   optimizer = ContractionSeqOptimizerGreed::createNew();
+  }else{
+   optimizer = ContractionSeqOptimizerMetis::createNew();
+  }
+  iter = optimizers_.emplace(std::make_pair(last_selection_,std::move(optimizer))).first;
+ }
+ if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerAuto): Selected " << last_selection_
+                         << " for a tensor network with " << features.num_tensors << " input tensors, treewidth <= "
+                         << features.treewidth << ", max rank " << features.max_rank << std::endl; //debug
+ iter->second->resetMemoryLimit(max_intermediate_volume_);
+ iter->second->resetTimeBudget(time_budget_,contraction_time_fraction_,fma_flop_rate_);
+ const double flops = iter->second->determineContractionSequence(network,contr_seq,intermediate_num_generator);
+ auto & telemetry = searchTelemetry();
+ telemetry.optimizer = "auto(" + telemetry.optimizer + ")";
+ return flops;
+}
+
+
+std::unique_ptr<ContractionSeqOptimizer> ContractionSeqOptimizerAuto::createNew()
+{
+ return std::unique_ptr<ContractionSeqOptimizer>(new ContractionSeqOptimizerAuto());
+}
+
+} //namespace numerics
+
+} //namespace exatn
@@ -0,0 +1,73 @@
+/** ExaTN::Numerics: Tensor contraction sequence optimizer: Automatic selection
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Selects a tensor contraction sequence optimizer for each tensor network individually
+     based on its features: The number of input tensors, the treewidth estimate of the
+     tensor graph (upper bound by the min-degree elimination), and the max tensor rank.
+ (b) Small tensor networks are optimized exactly by the dynamic programming, chain-like
+     (low treewidth, low rank) tensor networks by the greedy optimizer, and all others
+     by the Metis graph partitioning optimizer. The memory limit and the time budget
+     are forwarded to the selected optimizer.
+**/
+
+#ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_AUTO_HPP_
+#define EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_AUTO_HPP_
+
+#include "contraction_seq_optimizer.hpp"
+
+#include <string>
+#include <map>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class ContractionSeqOptimizerAuto: public ContractionSeqOptimizer{
+
+public:
+
+ //Tensor network features used for the optimizer selection:
+ struct NetworkFeatures{
+  unsigned int num_tensors = 0;  //number of input tensors
+  unsigned int treewidth = 0;    //treewidth estimate (upper bound) of the input tensor graph
+  unsigned int max_rank = 0;     //max input tensor rank
+  DimExtent max_extent = 0;      //max dimension extent
+ };
+
+ ContractionSeqOptimizerAuto() = default;
+ virtual ~ContractionSeqOptimizerAuto() = default;
+
+ virtual double determineContractionSequence(const TensorNetwork & network,
+                                             std::list<ContrTriple> & contr_seq,
+                                             std::function<unsigned int ()> intermediate_num_generator) override;
+
+ /** Returns the name of the tensor contraction sequence optimizer selected for a given tensor network. **/
+ static std::string selectOptimizer(const TensorNetwork & network,    //in: tensor network
+                                    NetworkFeatures * features = nullptr); //out: tensor network features
+
+ /** Returns the name of the optimizer selected during the last invocation. **/
+ const std::string & getLastSelection() const {return last_selection_;}
+
+ static std::unique_ptr<ContractionSeqOptimizer> createNew();
+
+protected:
+
+ static constexpr const unsigned int EXACT_MAX_TENSORS = 12;   //max number of input tensors for the exact search
+ static constexpr const unsigned int CHAIN_MAX_TREEWIDTH = 2;  //max treewidth of chain-like tensor networks
+ static constexpr const unsigned int CHAIN_MAX_RANK = 4;       //max tensor rank of chain-like tensor networks
+
+ std::map<std::string,std::unique_ptr<ContractionSeqOptimizer>> optimizers_; //instantiated optimizers
+ std::string last_selection_; //optimizer selected during the last invocation
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_AUTO_HPP_
@@ -0,0 +1,192 @@
+/** ExaTN::Numerics: Tensor contraction sequence optimizer: Exact dynamic programming
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "contraction_seq_optimizer_dp.hpp"
+#include "contraction_seq_optimizer_metis.hpp"
+#include "tensor_network.hpp"
+
+#include <unordered_map>
+#include <limits>
+#include <chrono>
+
+#include <cstdint>
+#include <cmath>
+
+namespace exatn{
+
+namespace numerics{
+
+ContractionSeqOptimizerDP::ContractionSeqOptimizerDP():
+ max_tensors_(MAX_TENSORS)
+{
+}
+
+
+void ContractionSeqOptimizerDP::resetMaxTensors(unsigned int max_tensors)
+{
+ assert(max_tensors <= MAX_TENSORS_LIMIT);
+ max_tensors_ = max_tensors;
+ return;
+}
+
+
+double ContractionSeqOptimizerDP::determineContractionSequence(const TensorNetwork & network,
+                                                               std::list<ContrTriple> & contr_seq,
+                                                               std::function<unsigned int ()> intermediate_num_generator)
+{
+ using SubsetMask = std::uint32_t; //subset of input tensors (bit mask)
+
+ struct TensorEdge{
+  SubsetMask left;  //left input tensor
+  SubsetMask right; //right input tensor (0 for the output tensor)
+  double extent;    //dimension extent
+ };
+
+ const bool debugging = false;
+
+ double flops = 0.0;
+ contr_seq.clear();
+ const std::size_t num_tensors = network.getNumTensors(); //number of input tensors
+ if(num_tensors < 2) return flops;
+
+ //Delegate large tensor networks to the Metis optimizer:
+ auto delegate = [&](){
+  if(!fallback_) fallback_ = ContractionSeqOptimizerMetis::createNew();
+  fallback_->resetMemoryLimit(max_intermediate_volume_);
+  fallback_->resetTimeBudget(time_budget_,contraction_time_fraction_,fma_flop_rate_);
+  return fallback_->determineContractionSequence(network,contr_seq,intermediate_num_generator);
+ };
+ if(num_tensors > std::min(max_tensors_,MAX_TENSORS_LIMIT)) return delegate();
+ searchTelemetry().optimizer = "dp";
+
+ if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerDP): Determining the optimal tensor contraction sequence ... \n"; //debug
+ auto time_beg = std::chrono::high_resolution_clock::now();
+
+ //Enumerate input tensors and tensor edges:
+ std::vector<unsigned int> tensor_ids; //position --> input tensor id
+ std::unordered_map<unsigned int, unsigned int> tensor_pos; //input tensor id --> position
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  if(iter->first != 0){
+   tensor_pos.emplace(std::make_pair(iter->first,static_cast<unsigned int>(tensor_ids.size())));
+   tensor_ids.emplace_back(iter->first);
+  }
+ }
+ assert(tensor_ids.size() == num_tensors);
+ std::vector<TensorEdge> edges;
+ std::vector<SubsetMask> adjacent(num_tensors,0); //adjacent input tensors of each input tensor
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  if(iter->first == 0) continue;
+  const auto & tensor = iter->second;
+  const SubsetMask left = (1U << tensor_pos[iter->first]);
+  const auto & legs = tensor.getTensorLegs();
+  for(unsigned int i = 0; i < legs.size(); ++i){
+   const auto other_id = legs[i].getTensorId();
+   const double extent = static_cast<double>(tensor.getDimExtent(i));
+   if(other_id == 0){ //open edge
+    edges.emplace_back(TensorEdge{left,0,extent});
+   }else if(other_id > iter->first){ //each contracted edge is registered once
+    const SubsetMask right = (1U << tensor_pos[other_id]);
+    edges.emplace_back(TensorEdge{left,right,extent});
+    adjacent[tensor_pos[iter->first]] |= right;
+    adjacent[tensor_pos[other_id]] |= left;
+   }
+  }
+ }
+
+ //Compute volumes and neighbors of all subsets of input tensors:
+ const SubsetMask full = static_cast<SubsetMask>((1ULL << num_tensors) - 1);
+ std::vector<double> volume(full + 1,1.0);     //volume of the intermediate tensor of each subset
+ std::vector<SubsetMask> neighbors(full + 1,0); //input tensors adjacent to each subset
+ for(SubsetMask subset = 1; subset <= full; ++subset){
+  const SubsetMask lowest = subset & (~subset + 1);
+  unsigned int pos = 0; while((1U << pos) != lowest) ++pos;
+  neighbors[subset] = neighbors[subset ^ lowest] | adjacent[pos];
+  for(const auto & edge: edges){
+   if(((edge.left & subset) != 0) != ((edge.right & subset) != 0)) volume[subset] *= edge.extent; //open edge of the subset
+  }
+ }
+ //Outer products are only considered if the tensor network is disconnected:
+ SubsetMask connected = 1;
+ SubsetMask frontier = 1;
+ while(frontier != 0){
+  SubsetMask reached = 0;
+  for(unsigned int pos = 0; pos < num_tensors; ++pos) if((frontier >> pos) & 1U) reached |= adjacent[pos];
+  frontier = reached & (~connected);
+  connected |= reached;
+ }
+ const bool outer_products = (connected != full);
+
+ //Dynamic programming over subsets in increasing order (all proper subsets precede their superset):
+ const double infinity = std::numeric_limits<double>::infinity();
+ std::vector<double> cost(full + 1,infinity); //optimal Flop count of each subset
+ std::vector<SubsetMask> split(full + 1,0);    //optimal left part of each subset
+ for(SubsetMask subset = 1; subset <= full; ++subset){
+  if((subset & (subset - 1)) == 0){cost[subset] = 0.0; continue;} //single input tensor
+  if(subset != full && max_intermediate_volume_ > 0.0 && volume[subset] > max_intermediate_volume_) continue;
+  const SubsetMask lowest = subset & (~subset + 1);
+  const SubsetMask rest = subset ^ lowest;
+  double best = infinity;
+  SubsetMask best_left = 0;
+  for(SubsetMask sub = rest; ; sub = (sub - 1) & rest){ //left part always contains the lowest input tensor
+   const SubsetMask left = lowest | sub;
+   const SubsetMask right = subset ^ left;
+   if(right != 0){
+    const double base = cost[left] + cost[right];
+    if(base < best && (outer_products || (neighbors[left] & right) != 0)){
+     const double contr_flops = std::sqrt(volume[left] * volume[right] * volume[subset]);
+     if(base + contr_flops < best){
+      best = base + contr_flops;
+      best_left = left;
+     }
+    }
+   }
+   if(sub == 0) break;
+  }
+  cost[subset] = best;
+  split[subset] = best_left;
+ }
+ if(cost[full] == infinity){
+  if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerDP): Memory limit is unattainable, delegating to Metis\n"; //debug
+  return delegate();
+ }
+ flops = cost[full];
+
+ //Unroll the optimal contraction tree in the post-order:
+ std::function<unsigned int (SubsetMask)> emit = [&](SubsetMask subset){
+  if((subset & (subset - 1)) == 0){ //input tensor
+   unsigned int pos = 0; while((1U << pos) != subset) ++pos;
+   return tensor_ids[pos];
+  }
+  const auto left_id = emit(split[subset]);
+  const auto right_id = emit(subset ^ split[subset]);
+  const unsigned int result_id = (subset == full) ? 0 : intermediate_num_generator();
+  contr_seq.emplace_back(ContrTriple{result_id,left_id,right_id});
+  return result_id;
+ };
+ emit(full);
+ assert(contr_seq.size() == num_tensors - 1);
+
+ auto time_end = std::chrono::high_resolution_clock::now();
+ auto time_total = std::chrono::duration_cast<std::chrono::duration<double>>(time_end - time_beg);
+ if(debugging){
+  std::cout << "#DEBUG(ContractionSeqOptimizerDP): Done (" << time_total.count() << " sec): Flop count = " << flops << ":";
+  for(const auto & contr_triple: contr_seq) std::cout << " {" << contr_triple.left_id << ","
+                                                              << contr_triple.right_id << "->"
+                                                              << contr_triple.result_id << "}";
+  std::cout << std::endl;
+ }
+ return flops;
+}
+
+
+std::unique_ptr<ContractionSeqOptimizer> ContractionSeqOptimizerDP::createNew()
+{
+ return std::unique_ptr<ContractionSeqOptimizer>(new ContractionSeqOptimizerDP());
+}
+
+} //namespace numerics
+
+} //namespace exatn
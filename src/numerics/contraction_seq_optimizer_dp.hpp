@@ -0,0 +1,66 @@
+/** ExaTN::Numerics: Tensor contraction sequence optimizer: Exact dynamic programming
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Determines the Flop-optimal tensor contraction sequence exactly by
+     the dynamic programming over the subsets of the input tensors:
+     The optimal cost of a subset is the minimum over all its bipartitions
+     of the optimal costs of both parts plus the cost of their contraction.
+ (b) Pruning: If the tensor network is connected, only connected subsets
+     and bipartitions into mutually connected parts are considered (no outer
+     products). A bipartition is skipped as soon as the optimal costs of its
+     parts alone exceed the best cost found for the subset so far. With the memory
+     limit set, intermediate tensors exceeding it are excluded from the search,
+     thus the found tensor contraction sequence does not require slicing.
+ (c) The cost of the dynamic programming grows as 3^N with the number of input
+     tensors N, thus tensor networks with more than a given number of input tensors
+     (or with an unattainable memory limit) are delegated to the Metis optimizer.
+**/
+
+#ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_DP_HPP_
+#define EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_DP_HPP_
+
+#include "contraction_seq_optimizer.hpp"
+
+#include <vector>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class ContractionSeqOptimizerDP: public ContractionSeqOptimizer{
+
+public:
+
+ ContractionSeqOptimizerDP();
+ virtual ~ContractionSeqOptimizerDP() = default;
+
+ /** Resets the max number of input tensors handled by the dynamic programming
+     (larger tensor networks are delegated to the Metis optimizer). **/
+ void resetMaxTensors(unsigned int max_tensors);
+
+ virtual double determineContractionSequence(const TensorNetwork & network,
+                                             std::list<ContrTriple> & contr_seq,
+                                             std::function<unsigned int ()> intermediate_num_generator) override;
+
+ static std::unique_ptr<ContractionSeqOptimizer> createNew();
+
+protected:
+
+ static constexpr const unsigned int MAX_TENSORS = 14;       //default max number of input tensors
+ static constexpr const unsigned int MAX_TENSORS_LIMIT = 24; //hard limit on the max number of input tensors
+
+ unsigned int max_tensors_;                         //max number of input tensors handled by the dynamic programming
+ std::unique_ptr<ContractionSeqOptimizer> fallback_; //fallback optimizer for large tensor networks
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_DP_HPP_
@@ -1,17 +1,21 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Greedy heuristics
-REVISION: 2020/10/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "contraction_seq_optimizer_greed.hpp"
 #include "tensor_network.hpp"
+#include "tensor_network_flat.hpp"
 
 #include <vector>
 #include <queue>
 #include <tuple>
 #include <iterator>
 #include <chrono>
+#include <atomic>
+#include <limits>
+#include <algorithm>
 
 namespace exatn{
 
@@ -50,11 +54,25 @@ double ContractionSeqOptimizerGreed::determineContractionSequence(const TensorNe
                               double,              //2: current total flop count
                               double>;             //3: local differential volume (temporary)
 
+ struct Candidate{
+  double diff_vol;       //local differential volume of the tensor contraction
+  double cost;           //total flop count of the extended contraction path
+  std::size_t path;      //parental contraction path
+  unsigned int left_id;  //left contracted tensor
+  unsigned int right_id; //right contracted tensor
+ };
+
  contr_seq.clear();
  double flops = 0.0;
 
  auto numContractions = network.getNumTensors() - 1; //number of contractions is one less than the number of r.h.s. tensors
  if(numContractions == 0) return flops;
+ const std::size_t numWalkers = std::max(num_walkers_,1U);
+ if(numWalkers == 1) return determineContractionSequenceIncremental(network,contr_seq,intermediate_num_generator);
+ auto & telemetry = searchTelemetry();
+ telemetry.optimizer = "greed";
+ telemetry.num_walkers = static_cast<unsigned int>(numWalkers);
+ telemetry.num_rounds = static_cast<unsigned int>(numContractions); //passes
 
  if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerGreed): Determining a pseudo-optimal tensor contraction sequence ... \n"; //debug
  auto timeBeg = std::chrono::high_resolution_clock::now();
@@ -63,12 +81,14 @@ double ContractionSeqOptimizerGreed::determineContractionSequence(const TensorNe
  std::vector<ContrPath> inputPaths; //considered contraction paths
  inputPaths.emplace_back(std::make_tuple(network,contrSeqEmpty,0.0,0.0)); //initial configuration
 
- //auto cmpPaths = [](const ContrPath & left, const ContrPath & right){return (std::get<3>(left) < std::get<3>(right));};
- auto cmpPaths = [](const ContrPath & left, const ContrPath & right){
-                    if(std::get<3>(left) == std::get<3>(right)) return (std::get<2>(left) < std::get<2>(right));
-                    return (std::get<3>(left) < std::get<3>(right));
-                   };
- std::priority_queue<ContrPath, std::vector<ContrPath>, decltype(cmpPaths)> priq(cmpPaths); //prioritized contraction paths
+ //Strict total order of candidates (the result does not depend on the number of threads):
+ auto cmpCands = [](const Candidate & left, const Candidate & right){
+                  if(left.diff_vol != right.diff_vol) return (left.diff_vol < right.diff_vol);
+                  if(left.cost != right.cost) return (left.cost < right.cost);
+                  if(left.path != right.path) return (left.path < right.path);
+                  if(left.left_id != right.left_id) return (left.left_id < right.left_id);
+                  return (left.right_id < right.right_id);
+                 };
 
  //Loop over the tensor contractions (passes):
  for(decltype(numContractions) pass = 0; pass < numContractions; ++pass){
@@ -77,87 +97,88 @@ double ContractionSeqOptimizerGreed::determineContractionSequence(const TensorNe
              << inputPaths.size() << " candidates" << std::endl; //debug
   }
   unsigned int intermediate_id = intermediate_num_generator(); //id of the next intermediate tensor
-  unsigned int numPassCands = 0, candid = 0;
-  //Update the list of promising contraction path candidates due to a new tensor contraction:
-  for(auto & contrPath: inputPaths){
-   //std::cout << " #DEBUG(ContractionSeqOptimizerGreed): Processing candidate path " << candid++ << std::endl; //debug
-   auto & parentTensNet = std::get<0>(contrPath); //parental tensor network
-   const auto numTensors = parentTensNet.getNumTensors(); //number of r.h.s. tensors in the parental tensor network
-   const auto & parentContrSeq = std::get<1>(contrPath); //contraction sequence for the parental tensor network
-   //Inspect contractions of all unique pairs of tensors:
-   for(auto iter_i = parentTensNet.begin(); iter_i != parentTensNet.end(); ++iter_i){ //r.h.s. tensors
-    auto i = iter_i->first;
-    if(i != 0){ //exclude output tensor
-     const auto & tensor_i = iter_i->second; //connected tensor i
-     //std::cout << "  First tensor id " << i << std::endl; //debug
-     const auto adjacent_tensors = parentTensNet.getAdjacentTensors(i);
-     if(only_connected && !adjacent_tensors.empty()){
-      for(auto & j: adjacent_tensors){
-       if(j > i){ //unique pairs
-        const auto & tensor_j = *(parentTensNet.getTensorConn(j));
-        double tot_vol, diff_vol;
-        double contrCost = getTensorContractionCost(tensor_i,tensor_j,&tot_vol,&diff_vol); //tensor contraction cost (flops)
-        //double contrCost = parentTensNet.getContractionCost(i,j,&tot_vol,&diff_vol); //tensor contraction cost (flops)
-        //std::cout << "  New candidate contracted pair of tensors is {" << i << "," << j << "} with cost " << contrCost << std::endl; //debug
-        TensorNetwork tensNet(parentTensNet);
-        auto contracted = tensNet.mergeTensors(i,j,intermediate_id); assert(contracted);
-        auto cSeq = parentContrSeq;
-        if(pass == numContractions - 1){ //the very last tensor contraction writes into the output tensor #0
-         cSeq.emplace_back(ContrTriple{0,i,j}); //append the last pair of contracted tensors
-        }else{
-         cSeq.emplace_back(ContrTriple{intermediate_id,i,j}); //append a new pair of contracted tensors
-        }
-        priq.emplace(std::make_tuple(tensNet, cSeq, contrCost + std::get<2>(contrPath), diff_vol)); //cloning tensor network and contraction sequence
-        if(priq.size() > num_walkers_) priq.pop(); //remove the top-costly contraction path when limit achieved
-        numPassCands++;
+  unsigned int numPassCands = 0;
+  std::vector<Candidate> passCands; //cheapest candidates of the pass
+  std::atomic<double> bound(std::numeric_limits<double>::max()); //best-so-far differential volume of the last surviving candidate
+  //Inspect contraction path candidates concurrently (each thread keeps its own top candidates):
+#pragma omp parallel shared(inputPaths,passCands,bound) reduction(+:numPassCands)
+  {
+   std::priority_queue<Candidate, std::vector<Candidate>, decltype(cmpCands)> priq(cmpCands); //prioritized candidates
+#pragma omp for schedule(dynamic,1) nowait
+   for(int path = 0; path < static_cast<int>(inputPaths.size()); ++path){
+    auto & parentTensNet = std::get<0>(inputPaths[path]); //parental tensor network
+    const double parentCost = std::get<2>(inputPaths[path]); //flop count of the parental contraction path
+    //Inspect contractions of all unique pairs of tensors:
+    for(auto iter_i = parentTensNet.cbegin(); iter_i != parentTensNet.cend(); ++iter_i){ //r.h.s. tensors
+     auto i = iter_i->first;
+     if(i != 0){ //exclude output tensor
+      const auto & tensor_i = iter_i->second; //connected tensor i
+      std::vector<unsigned int> pair_ids; //candidate tensors j to contract with tensor i
+      const auto adjacent_tensors = parentTensNet.getAdjacentTensors(i);
+      if(only_connected && !adjacent_tensors.empty()){
+       for(auto & j: adjacent_tensors){
+        if(j > i) pair_ids.emplace_back(j); //unique pairs
+       }
+      }else{
+       for(auto iter_j = std::next(iter_i); iter_j != parentTensNet.cend(); ++iter_j){ //r.h.s. tensors
+        if(iter_j->first != 0) pair_ids.emplace_back(iter_j->first); //exclude output tensor
        }
       }
-     }else{
-      for(auto iter_j = std::next(iter_i); iter_j != parentTensNet.end(); ++iter_j){ //r.h.s. tensors
-       auto j = iter_j->first;
-       if(j != 0){ //exclude output tensor
-        const auto & tensor_j = iter_j->second; //connected tensor j
-        double tot_vol, diff_vol;
-        double contrCost = getTensorContractionCost(tensor_i,tensor_j,&tot_vol,&diff_vol); //tensor contraction cost (flops)
-        //double contrCost = parentTensNet.getContractionCost(i,j,&tot_vol,&diff_vol); //tensor contraction cost (flops)
-        //std::cout << "  New candidate contracted pair of tensors is {" << i << "," << j << "} with cost " << contrCost << std::endl; //debug
-        TensorNetwork tensNet(parentTensNet);
-        auto contracted = tensNet.mergeTensors(i,j,intermediate_id); assert(contracted);
-        auto cSeq = parentContrSeq;
-        if(pass == numContractions - 1){ //the very last tensor contraction writes into the output tensor #0
-         cSeq.emplace_back(ContrTriple{0,i,j}); //append the last pair of contracted tensors
-        }else{
-         cSeq.emplace_back(ContrTriple{intermediate_id,i,j}); //append a new pair of contracted tensors
+      for(const auto j: pair_ids){
+       const auto & tensor_j = *(parentTensNet.getTensorConn(j)); //connected tensor j
+       double tot_vol, diff_vol;
+       double contrCost = getTensorContractionCost(tensor_i,tensor_j,&tot_vol,&diff_vol); //tensor contraction cost (flops)
+       numPassCands++;
+       Candidate cand{diff_vol,contrCost + parentCost,static_cast<std::size_t>(path),i,j};
+       if(cand.diff_vol > bound.load()) continue; //dominated candidate
+       if(priq.size() < numWalkers || cmpCands(cand,priq.top())){
+        priq.emplace(cand);
+        if(priq.size() > numWalkers) priq.pop(); //remove the top-costly candidate when limit achieved
+        if(priq.size() == numWalkers){ //tighten the shared bound
+         double current = bound.load();
+         const double top = priq.top().diff_vol;
+         while(top < current && !bound.compare_exchange_weak(current,top));
         }
-        priq.emplace(std::make_tuple(tensNet, cSeq, contrCost + std::get<2>(contrPath), diff_vol)); //cloning tensor network and contraction sequence
-        if(priq.size() > num_walkers_) priq.pop(); //remove the top-costly contraction path when limit achieved
-        numPassCands++;
        }
       }
      }
     }
    }
+#pragma omp critical
+   {
+    while(!priq.empty()){
+     passCands.emplace_back(priq.top());
+     priq.pop();
+    }
+   }
   }
+  std::sort(passCands.begin(),passCands.end(),cmpCands);
+  if(passCands.size() > numWalkers) passCands.resize(numWalkers);
+  assert(!passCands.empty());
   if(debugging){
    std::cout << "#DEBUG(ContractionSeqOptimizerGreed): Pass " << pass << ": Total number of candidates considered = "
              << numPassCands << std::endl; //debug
   }
   //Collect the cheapest contraction paths left:
-  inputPaths.clear();
-  if(pass == numContractions - 1){ //last pass
-   while(priq.size() > 1) priq.pop(); //get to the cheapest contraction path
-   contr_seq = std::get<1>(priq.top());
-   flops = std::get<2>(priq.top());
-   priq.pop();
+  if(pass == numContractions - 1){ //last pass: the very last tensor contraction writes into the output tensor #0
+   const auto & best = passCands.front();
+   contr_seq = std::get<1>(inputPaths[best.path]);
+   contr_seq.emplace_back(ContrTriple{0,best.left_id,best.right_id}); //append the last pair of contracted tensors
+   flops = best.cost;
    if(debugging){
     std::cout << "#DEBUG(ContractionSeqOptimizerGreed): Best tensor contraction sequence found has cost (flops) = "
               << flops << std::endl; //debug
    }
-  }else{ //intermediate pass
-   while(priq.size() > 0){
-    inputPaths.emplace_back(priq.top());
-    priq.pop();
+  }else{ //intermediate pass: only the surviving candidates are materialized
+   std::vector<ContrPath> outputPaths;
+   for(const auto & cand: passCands){
+    TensorNetwork tensNet(std::get<0>(inputPaths[cand.path]));
+    auto contracted = tensNet.mergeTensors(cand.left_id,cand.right_id,intermediate_id); assert(contracted);
+    auto cSeq = std::get<1>(inputPaths[cand.path]);
+    cSeq.emplace_back(ContrTriple{intermediate_id,cand.left_id,cand.right_id}); //append a new pair of contracted tensors
+    outputPaths.emplace_back(std::make_tuple(tensNet,cSeq,cand.cost,cand.diff_vol));
    }
+   inputPaths = std::move(outputPaths);
   }
  }
 
@@ -173,6 +194,172 @@ double ContractionSeqOptimizerGreed::determineContractionSequence(const TensorNe
 }
 
 
+double ContractionSeqOptimizerGreed::determineContractionSequenceIncremental(const TensorNetwork & network,
+                                                                             std::list<ContrTriple> & contr_seq,
+                                                                             std::function<unsigned int ()> intermediate_num_generator)
+{
+ const bool debugging = false;
+
+ using Bond = std::pair<unsigned int, double>; //{adjacent vertex, bond volume}
+
+ struct Candidate{
+  double diff_vol;       //local differential volume of the tensor contraction
+  double cost;           //flop count of the tensor contraction
+  unsigned int left_id;  //left contracted tensor
+  unsigned int right_id; //right contracted tensor
+  unsigned int left;     //left contracted vertex
+  unsigned int right;    //right contracted vertex
+ };
+
+ contr_seq.clear();
+ double flops = 0.0;
+
+ const auto numContractions = network.getNumTensors() - 1; //number of contractions is one less than the number of r.h.s. tensors
+ if(numContractions == 0) return flops;
+ auto & telemetry = searchTelemetry();
+ telemetry.optimizer = "greed";
+ telemetry.num_walkers = 1;
+ telemetry.num_rounds = static_cast<unsigned int>(numContractions); //passes
+
+ if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerGreed): Determining a greedy tensor contraction sequence ... \n"; //debug
+ auto timeBeg = std::chrono::high_resolution_clock::now();
+
+ //Build the compact graph: Vertices 1..N are the input tensors, merged tensors are appended:
+ const TensorNetworkFlat flat(network);
+ const std::size_t numTensors = flat.getNumTensors();
+ const std::size_t maxVertices = 2 * numTensors;
+ std::vector<unsigned int> ids(maxVertices,0);        //vertex --> tensor id
+ std::vector<double> volumes(maxVertices,1.0);        //vertex --> tensor volume
+ std::vector<char> alive(maxVertices,0);              //vertex --> whether or not the tensor still exists
+ std::vector<std::vector<Bond>> bonds(maxVertices);   //vertex --> adjacent vertices (input tensors only)
+ std::vector<std::size_t> marks(maxVertices,0);       //vertex --> position in the bond list under construction + 1
+ for(std::size_t vertex = 1; vertex <= numTensors; ++vertex){
+  ids[vertex] = flat.getTensorId(vertex);
+  alive[vertex] = 1;
+  const auto rank = flat.getRank(vertex);
+  const auto * leg_vertices = flat.getLegVertices(vertex);
+  const auto * leg_extents = flat.getLegExtents(vertex);
+  auto & vertex_bonds = bonds[vertex];
+  for(unsigned int i = 0; i < rank; ++i){
+   const double dim_ext = static_cast<double>(leg_extents[i]);
+   volumes[vertex] *= dim_ext;
+   const auto other = leg_vertices[i];
+   if(other != 0 && other != vertex){ //ignore the output tensor
+    if(marks[other] == 0){
+     vertex_bonds.emplace_back(Bond{other,dim_ext});
+     marks[other] = vertex_bonds.size();
+    }else{
+     vertex_bonds[marks[other] - 1].second *= dim_ext;
+    }
+   }
+  }
+  for(const auto & bond: vertex_bonds) marks[bond.first] = 0;
+ }
+ telemetry.graph_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+                         std::chrono::high_resolution_clock::now() - timeBeg).count();
+
+ //Heap of tensor contraction candidates (strict total order, the cheapest on top):
+ auto cmpCands = [](const Candidate & left, const Candidate & right){
+                  if(left.diff_vol != right.diff_vol) return (left.diff_vol > right.diff_vol);
+                  if(left.cost != right.cost) return (left.cost > right.cost);
+                  if(left.left_id != right.left_id) return (left.left_id > right.left_id);
+                  return (left.right_id > right.right_id);
+                 };
+ std::priority_queue<Candidate, std::vector<Candidate>, decltype(cmpCands)> priq(cmpCands);
+ auto pushCandidate = [&](unsigned int u, unsigned int v, double bond_vol){
+  if(ids[u] > ids[v]) std::swap(u,v);
+  const double cost = volumes[u] * volumes[v] / bond_vol; //FMA flops (same as getTensorContractionCost)
+  priq.emplace(Candidate{(cost / bond_vol) - (volumes[u] + volumes[v]),cost,ids[u],ids[v],u,v});
+ };
+ std::vector<unsigned int> isolated; //vertices without adjacent input tensors (contracted with any other tensor)
+ auto pushIsolated = [&](unsigned int vertex, std::size_t num_vertices){
+  for(unsigned int other = 1; other < num_vertices; ++other){
+   if(other != vertex && alive[other] != 0) pushCandidate(vertex,other,1.0);
+  }
+  isolated.emplace_back(vertex);
+ };
+ for(unsigned int vertex = 1; vertex <= numTensors; ++vertex){
+  for(const auto & bond: bonds[vertex]){
+   if(bond.first > vertex) pushCandidate(vertex,bond.first,bond.second);
+  }
+  if(bonds[vertex].empty()) pushIsolated(vertex,numTensors + 1);
+ }
+
+ //Loop over the tensor contractions (passes):
+ std::size_t numVertices = numTensors + 1;
+ std::size_t numStale = 0;
+ for(std::size_t pass = 0; pass < numContractions; ++pass){
+  unsigned int intermediate_id = intermediate_num_generator(); //id of the next intermediate tensor
+  while(!priq.empty() && (alive[priq.top().left] == 0 || alive[priq.top().right] == 0)){
+   priq.pop(); ++numStale; //discard the candidates of the merged tensors
+  }
+  if(priq.empty()){ //the remaining tensors are only connected via the output tensor
+   for(unsigned int u = 1; u < numVertices; ++u){
+    if(alive[u] != 0){
+     for(unsigned int v = u + 1; v < numVertices; ++v) if(alive[v] != 0) pushCandidate(u,v,1.0);
+    }
+   }
+  }
+  assert(!priq.empty());
+  const auto best = priq.top();
+  priq.pop();
+  flops += best.cost;
+  if(pass == numContractions - 1){ //last pass: the very last tensor contraction writes into the output tensor #0
+   contr_seq.emplace_back(ContrTriple{0,best.left_id,best.right_id});
+   break;
+  }
+  contr_seq.emplace_back(ContrTriple{intermediate_id,best.left_id,best.right_id});
+  //Merge the contracted tensors into a new vertex:
+  const unsigned int merged = static_cast<unsigned int>(numVertices++);
+  ids[merged] = intermediate_id;
+  alive[merged] = 1;
+  alive[best.left] = 0;
+  alive[best.right] = 0;
+  auto & merged_bonds = bonds[merged];
+  double bond_vol = 1.0;
+  for(const auto vertex: {best.left,best.right}){
+   for(const auto & bond: bonds[vertex]){
+    if(bond.first == best.left || bond.first == best.right){
+     if(vertex == best.left) bond_vol *= bond.second; //contracted bond
+    }else if(marks[bond.first] == 0){
+     merged_bonds.emplace_back(bond);
+     marks[bond.first] = merged_bonds.size();
+    }else{
+     merged_bonds[marks[bond.first] - 1].second *= bond.second; //neighbor adjacent to both tensors
+    }
+   }
+   std::vector<Bond>().swap(bonds[vertex]);
+  }
+  volumes[merged] = best.cost / bond_vol;
+  //Update the neighbors and add the new candidates:
+  for(const auto & bond: merged_bonds){
+   marks[bond.first] = 0;
+   auto & neighbor_bonds = bonds[bond.first];
+   neighbor_bonds.erase(std::remove_if(neighbor_bonds.begin(),neighbor_bonds.end(),
+                                       [&best](const Bond & nb){return (nb.first == best.left || nb.first == best.right);}),
+                        neighbor_bonds.end());
+   neighbor_bonds.emplace_back(Bond{merged,bond.second});
+   pushCandidate(merged,bond.first,bond.second);
+  }
+  isolated.erase(std::remove_if(isolated.begin(),isolated.end(),
+                                [&alive](unsigned int vertex){return (alive[vertex] == 0);}),isolated.end());
+  if(merged_bonds.empty()){
+   pushIsolated(merged,numVertices);
+  }else{
+   for(const auto vertex: isolated) pushCandidate(vertex,merged,1.0);
+  }
+ }
+
+ auto timeEnd = std::chrono::high_resolution_clock::now();
+ auto timeTot = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd - timeBeg);
+ if(debugging){
+  std::cout << "#DEBUG(ContractionSeqOptimizerGreed): Done (" << timeTot.count() << " sec, "
+            << numStale << " stale candidates): Cost (flops) = " << flops << std::endl; //debug
+ }
+ return flops;
+}
+
+
 std::unique_ptr<ContractionSeqOptimizer> ContractionSeqOptimizerGreed::createNew()
 {
  return std::unique_ptr<ContractionSeqOptimizer>(new ContractionSeqOptimizerGreed());
@@ -1,12 +1,25 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Greedy heuristics
-REVISION: 2020/04/28
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Greedy heuristics based on the differential tensor volume
      in individual tensor contractions.
+ (b) Candidate tensor contractions of the retained contraction paths (walkers)
+     are inspected concurrently by OpenMP threads, each thread keeping its own
+     best candidates and tightening a shared best-so-far bound which discards
+     dominated candidates early. Only the surviving candidates are materialized.
+     Candidates are strictly ordered (ties broken by the path and tensor ids),
+     thus the result does not depend on the number of threads.
+ (c) A single walker (default) does not need tensor network copies: The search runs
+     over a compact graph of the tensor network (tensor volumes and bond volumes
+     between adjacent tensors) with a heap of the pairwise tensor contraction candidates.
+     Merging two tensors only adds the candidates of the new tensor with its neighbors,
+     whereas the candidates of the merged tensors are discarded lazily once popped.
+     It selects the same tensor contractions as the walker-based search (up to the
+     candidates with disconnected tensors), at a small fraction of its cost.
 **/
 
 #ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_GREED_HPP_
@@ -39,6 +52,12 @@ public:
 
 protected:
 
+ /** Determines the greedy tensor contraction sequence with a single walker
+     over the compact graph of the tensor network, see (c). **/
+ double determineContractionSequenceIncremental(const TensorNetwork & network,
+                                                std::list<ContrTriple> & contr_seq,
+                                                std::function<unsigned int ()> intermediate_num_generator);
+
  static constexpr const unsigned int NUM_WALKERS = 1;
  static constexpr const double ACCEPTANCE_TOLERANCE = 0.0;
 
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Greedy heuristics
-REVISION: 2020/04/29
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "contraction_seq_optimizer_heuro.hpp"
 #include "tensor_network.hpp"
@@ -12,6 +12,9 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <tuple>
 #include <iterator>
 #include <chrono>
+#include <atomic>
+#include <limits>
+#include <algorithm>
 
 namespace exatn{
 
@@ -39,11 +42,23 @@ double ContractionSeqOptimizerHeuro::determineContractionSequence(const TensorNe
                               ContractionSequence, //1: tensor contraction sequence resulted in this state
                               double>;             //2: current total flop count
 
+ struct Candidate{
+  double cost;           //total flop count of the extended contraction path
+  std::size_t path;      //parental contraction path
+  unsigned int left_id;  //left contracted tensor
+  unsigned int right_id; //right contracted tensor
+ };
+
  contr_seq.clear();
  double flops = 0.0;
 
  auto numContractions = network.getNumTensors() - 1; //number of contractions is one less than the number of r.h.s. tensors
  if(numContractions == 0) return flops;
+ const std::size_t numWalkers = std::max(num_walkers_,1U);
+ auto & telemetry = searchTelemetry();
+ telemetry.optimizer = "heuro";
+ telemetry.num_walkers = static_cast<unsigned int>(numWalkers);
+ telemetry.num_rounds = static_cast<unsigned int>(numContractions); //passes
 
  //std::cout << "#DEBUG(ContractionSeqOptimizerHeuro): Determining a pseudo-optimal tensor contraction sequence ... \n"; //debug
  auto timeBeg = std::chrono::high_resolution_clock::now();
@@ -52,65 +67,88 @@ double ContractionSeqOptimizerHeuro::determineContractionSequence(const TensorNe
  std::vector<ContrPath> inputPaths; //considered contraction paths
  inputPaths.emplace_back(std::make_tuple(network,contrSeqEmpty,0.0)); //initial configuration
 
- auto cmpPaths = [](const ContrPath & left, const ContrPath & right){return (std::get<2>(left) < std::get<2>(right));};
- std::priority_queue<ContrPath, std::vector<ContrPath>, decltype(cmpPaths)> priq(cmpPaths); //prioritized contraction paths
+ //Strict total order of candidates (the result does not depend on the number of threads):
+ auto cmpCands = [](const Candidate & left, const Candidate & right){
+                  if(left.cost != right.cost) return (left.cost < right.cost);
+                  if(left.path != right.path) return (left.path < right.path);
+                  if(left.left_id != right.left_id) return (left.left_id < right.left_id);
+                  return (left.right_id < right.right_id);
+                 };
 
  //Loop over the tensor contractions (passes):
  for(decltype(numContractions) pass = 0; pass < numContractions; ++pass){
   //std::cout << "#DEBUG(ContractionSeqOptimizerHeuro): Pass " << pass << " started with "
   //          << inputPaths.size() << " candidates" << std::endl; //debug
   unsigned int intermediate_id = intermediate_num_generator(); //id of the next intermediate tensor
-  unsigned int numPassCands = 0, candid = 0;
-  //Update the list of promising contraction path candidates due to a new tensor contraction:
-  for(auto & contrPath: inputPaths){
-   //std::cout << " #DEBUG(ContractionSeqOptimizerHeuro): Processing candidate path " << candid++ << std::endl; //debug
-   auto & parentTensNet = std::get<0>(contrPath); //parental tensor network
-   const auto numTensors = parentTensNet.getNumTensors(); //number of r.h.s. tensors in the parental tensor network
-   const auto & parentContrSeq = std::get<1>(contrPath); //contraction sequence for the parental tensor network
-   //Inspect contractions of all unique pairs of tensors:
-   for(auto iter_i = parentTensNet.begin(); iter_i != parentTensNet.end(); ++iter_i){ //r.h.s. tensors
-    auto i = iter_i->first;
-    if(i != 0){ //exclude output tensor
-     const auto & tensor_i = iter_i->second; //connected tensor i
-     for(auto iter_j = std::next(iter_i); iter_j != parentTensNet.end(); ++iter_j){ //r.h.s. tensors
-      auto j = iter_j->first;
-      if(j != 0){ //exclude output tensor
-       const auto & tensor_j = iter_j->second; //connected tensor j
-       double contrCost = getTensorContractionCost(tensor_i,tensor_j); //tensor contraction cost (flops)
-       //double contrCost = parentTensNet.getContractionCost(i,j); //tensor contraction cost (flops)
-       //std::cout << "  New candidate contracted pair of tensors is {" << i << "," << j << "} with cost " << contrCost << std::endl; //debug
-       TensorNetwork tensNet(parentTensNet);
-       auto contracted = tensNet.mergeTensors(i,j,intermediate_id); assert(contracted);
-       auto cSeq = parentContrSeq;
-       if(pass == numContractions - 1){ //the very last tensor contraction writes into the output tensor #0
-        cSeq.emplace_back(ContrTriple{0,i,j}); //append the last pair of contracted tensors
-       }else{
-        cSeq.emplace_back(ContrTriple{intermediate_id,i,j}); //append a new pair of contracted tensors
+  unsigned int numPassCands = 0;
+  std::vector<Candidate> passCands; //cheapest candidates of the pass
+  std::atomic<double> bound(std::numeric_limits<double>::max()); //best-so-far cost of the last surviving candidate
+  //Inspect contraction path candidates concurrently (each thread keeps its own top candidates):
+#pragma omp parallel shared(inputPaths,passCands,bound) reduction(+:numPassCands)
+  {
+   std::priority_queue<Candidate, std::vector<Candidate>, decltype(cmpCands)> priq(cmpCands); //prioritized candidates
+#pragma omp for schedule(dynamic,1) nowait
+   for(int path = 0; path < static_cast<int>(inputPaths.size()); ++path){
+    auto & parentTensNet = std::get<0>(inputPaths[path]); //parental tensor network
+    const double parentCost = std::get<2>(inputPaths[path]); //flop count of the parental contraction path
+    //Inspect contractions of all unique pairs of tensors:
+    for(auto iter_i = parentTensNet.cbegin(); iter_i != parentTensNet.cend(); ++iter_i){ //r.h.s. tensors
+     auto i = iter_i->first;
+     if(i != 0){ //exclude output tensor
+      const auto & tensor_i = iter_i->second; //connected tensor i
+      for(auto iter_j = std::next(iter_i); iter_j != parentTensNet.cend(); ++iter_j){ //r.h.s. tensors
+       auto j = iter_j->first;
+       if(j != 0){ //exclude output tensor
+        const auto & tensor_j = iter_j->second; //connected tensor j
+        numPassCands++;
+        Candidate cand{getTensorContractionCost(tensor_i,tensor_j) + parentCost,
+                       static_cast<std::size_t>(path),i,j};
+        if(cand.cost > bound.load()) continue; //dominated candidate
+        if(priq.size() < numWalkers || cmpCands(cand,priq.top())){
+         priq.emplace(cand);
+         if(priq.size() > numWalkers) priq.pop(); //remove the top-costly candidate when limit achieved
+         if(priq.size() == numWalkers){ //tighten the shared bound
+          double current = bound.load();
+          const double top = priq.top().cost;
+          while(top < current && !bound.compare_exchange_weak(current,top));
+         }
+        }
        }
-       priq.emplace(std::make_tuple(tensNet, cSeq, contrCost + std::get<2>(contrPath))); //cloning tensor network and contraction sequence
-       if(priq.size() > num_walkers_) priq.pop(); //remove the top-costly contraction path when limit achieved
-       numPassCands++;
       }
      }
     }
    }
+#pragma omp critical
+   {
+    while(!priq.empty()){
+     passCands.emplace_back(priq.top());
+     priq.pop();
+    }
+   }
   }
+  std::sort(passCands.begin(),passCands.end(),cmpCands);
+  if(passCands.size() > numWalkers) passCands.resize(numWalkers);
+  assert(!passCands.empty());
   //std::cout << "#DEBUG(ContractionSeqOptimizerHeuro): Pass " << pass << ": Total number of candidates considered = "
   //          << numPassCands << std::endl; //debug
   //Collect the cheapest contraction paths left:
-  inputPaths.clear();
-  if(pass == numContractions - 1){ //last pass
-   while(priq.size() > 1) priq.pop(); //get to the cheapest contraction path
-   contr_seq = std::get<1>(priq.top());
-   flops = std::get<2>(priq.top());
-   priq.pop();
+  if(pass == numContractions - 1){ //last pass: the very last tensor contraction writes into the output tensor #0
+   const auto & best = passCands.front();
+   contr_seq = std::get<1>(inputPaths[best.path]);
+   contr_seq.emplace_back(ContrTriple{0,best.left_id,best.right_id}); //append the last pair of contracted tensors
+   flops = best.cost;
    //std::cout << "#DEBUG(ContractionSeqOptimizerHeuro): Best tensor contraction sequence found has cost (flops) = "
    //          << flops << std::endl; //debug
-  }else{ //intermediate pass
-   while(priq.size() > 0){
-    inputPaths.emplace_back(priq.top());
-    priq.pop();
+  }else{ //intermediate pass: only the surviving candidates are materialized
+   std::vector<ContrPath> outputPaths;
+   for(const auto & cand: passCands){
+    TensorNetwork tensNet(std::get<0>(inputPaths[cand.path]));
+    auto contracted = tensNet.mergeTensors(cand.left_id,cand.right_id,intermediate_id); assert(contracted);
+    auto cSeq = std::get<1>(inputPaths[cand.path]);
+    cSeq.emplace_back(ContrTriple{intermediate_id,cand.left_id,cand.right_id}); //append a new pair of contracted tensors
+    outputPaths.emplace_back(std::make_tuple(tensNet,cSeq,cand.cost));
    }
+   inputPaths = std::move(outputPaths);
   }
  }
 
@@ -1,11 +1,17 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Greedy heuristics
-REVISION: 2020/04/28
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Greedy heuristics based on the individual tensor contraction cost.
+ (b) Candidate tensor contractions of the retained contraction paths (walkers)
+     are inspected concurrently by OpenMP threads, each thread keeping its own
+     best candidates and tightening a shared best-so-far bound which discards
+     dominated candidates early. Only the surviving candidates are materialized.
+     Candidates are strictly ordered (ties broken by the path and tensor ids),
+     thus the result does not depend on the number of threads.
 **/
 
 #ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_HEURO_HPP_
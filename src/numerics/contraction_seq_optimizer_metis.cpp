@@ -1,19 +1,23 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Metis heuristics
-REVISION: 2020/10/25
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "contraction_seq_optimizer_metis.hpp"
 #include "tensor_network.hpp"
 
 #include "metis_graph.hpp"
+#include "tensor_network_flat.hpp"
 
 #include <algorithm>
 #include <random>
 #include <deque>
 #include <tuple>
 #include <chrono>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
 
 #include <cmath>
 
@@ -30,6 +34,8 @@ ContractionSeqOptimizerMetis::ContractionSeqOptimizerMetis():
  partition_max_size_(PARTITION_MAX_SIZE),
  partition_imbalance_(PARTITION_IMBALANCE_DEPTH,PARTITION_IMBALANCE)
 {
+ std::random_device seeder;
+ random_seed_ = seeder();
 }
 
 
@@ -47,6 +53,13 @@ void ContractionSeqOptimizerMetis::resetAcceptanceTolerance(double acceptance_to
 }
 
 
+void ContractionSeqOptimizerMetis::resetRandomSeed(unsigned int random_seed)
+{
+ random_seed_ = random_seed;
+ return;
+}
+
+
 double ContractionSeqOptimizerMetis::determineContractionSequence(const TensorNetwork & network,
                                                                   std::list<ContrTriple> & contr_seq,
                                                                   std::function<unsigned int ()> intermediate_num_generator)
@@ -54,112 +67,189 @@ double ContractionSeqOptimizerMetis::determineContractionSequence(const TensorNe
  const bool debugging = false;
  const bool deterministic = false;
 
+ struct Walker{
+  std::vector<double> imbalance;   //partition imbalances used by the walker
+  ContractionSequence cseq;        //tensor contraction sequence found by the walker (walker-local intermediate ids)
+  std::vector<double> contr_flops; //individual tensor contraction costs
+  double flops;                    //total Flop count (negative if the walker aborted)
+  double cost;                     //total sliced Flop count under the memory limit (same as flops without it)
+  double partition_time;           //time spent in graph partitioning (sec)
+  std::size_t partition_calls;     //number of graph partitioning calls
+  double evaluation_time;          //time spent in the flop count and slicing simulation (sec)
+ };
+
  double flops = 0.0;
  contr_seq.clear();
  std::size_t num_tensors = network.getNumTensors();
  auto num_contractions = (num_tensors - 1); //number of contractions is one less than the number of r.h.s. tensors
  if(num_contractions == 0) return flops;
+ const unsigned int num_walkers = std::max(num_walkers_,1U);
+ auto & telemetry = searchTelemetry();
+ telemetry.optimizer = "metis";
+ telemetry.num_walkers = num_walkers;
+ auto phase_start = std::chrono::steady_clock::now();
+ auto phaseTime = [&phase_start](){ //time since the phase start (sec), starts a new phase
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed = now - phase_start;
+  phase_start = now;
+  return elapsed.count();
+ };
+
+ //Walker-local intermediate tensor ids are issued above the largest tensor id of the network:
+ unsigned int max_tensor_id = 0;
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter) max_tensor_id = std::max(max_tensor_id,iter->first);
+
+ //Flat connectivity and the graph of the tensor network are shared by all walkers:
+ const TensorNetworkFlat network_flat(network);
+ const MetisGraph network_graph(network_flat);
+ telemetry.graph_time += phaseTime();
 
  //Search for the optimal tensor contraction sequence:
  if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerMetis): Searching for a pseudo-optimal tensor contraction sequence:\n"; //debug
- std::random_device seeder;
- std::default_random_engine generator(seeder());
  std::uniform_real_distribution<double> distribution(1.001,1.999);
- auto rnd = std::bind(distribution,generator);
-
+ std::atomic<double> best_cost(std::numeric_limits<double>::max()); //best-so-far (sliced) Flop count shared by all walkers
+ double cost = 0.0;
+ std::vector<double> next_imbalance(partition_imbalance_); //partition imbalances of the very first walker
+ ContractionSequence best_cseq;
+ std::vector<double> best_contr_flops;
  double max_flop = 0.0;
- partition_granularity_ = std::max(partition_factor_,std::min(partition_granularity_,num_tensors/(2*partition_max_size_)));
- while(partition_granularity_ >= partition_factor_){
-  auto num_walkers = num_walkers_;
-  while(num_walkers-- > 0){
-   //Determine a tensor contraction sequence:
-   std::list<ContrTriple> cseq;
-   determineContrSequence(network,cseq,intermediate_num_generator);
-   //Compute the total FMA flop count:
-   TensorNetwork net(network);
-   std::vector<double> contr_flops(cseq.size(),0.0);
-   double flps = 0.0; std::size_t i = 0;
-   for(const auto & contr_triple: cseq){
-    contr_flops[i] = net.getContractionCost(contr_triple.left_id,contr_triple.right_id);
-    flps += contr_flops[i++];
-    if(contr_triple.result_id != 0){ //intermediate tensor contraction
-     bool success = net.mergeTensors(contr_triple.left_id,contr_triple.right_id,contr_triple.result_id);
-     assert(success);
-    }else{ //last tensor contraction (into the output tensor)
-     assert(net.getNumTensors() == 2);
+ const unsigned int variant = searchVariant(); //distributed search variant (0: default search)
+ const unsigned int random_seed = random_seed_ + variant * 0x9E3779B9U;
+ const std::size_t top_granularity = std::max(partition_factor_,std::min(partition_granularity_ >> (variant % 3),
+                                                                         num_tensors/(2*partition_max_size_)));
+ double shared_cost = std::numeric_limits<double>::max(); //best-so-far (sliced) Flop count shared by all searching processes
+ std::size_t granularity = top_granularity;
+ unsigned int round = 0;
+ const bool anytime = isAnytime();
+ const auto time_start = std::chrono::steady_clock::now();
+ bool expired = false; //anytime mode: time budget expired
+ while(granularity >= partition_factor_ && !expired){
+  bool improved = true;
+  while(improved && !expired){ //a new round of walkers is launched as long as the previous round found a better sequence
+   std::vector<Walker> walkers(num_walkers);
+   for(unsigned int w = 0; w < num_walkers; ++w){
+    if(round == 0 && w == 0 && variant == 0){
+     walkers[w].imbalance = next_imbalance;
+    }else{ //walker-specific random number stream
+     std::seed_seq seeds{random_seed,static_cast<unsigned int>(granularity),round,w};
+     std::default_random_engine generator(seeds);
+     walkers[w].imbalance.resize(partition_imbalance_.size());
+     for(auto & imbalance: walkers[w].imbalance) imbalance = distribution(generator);
     }
+    if(deterministic && round > 0 && w == 0) walkers[w].imbalance = next_imbalance;
    }
-   //Compare with previous best:
-   if(flops > 0.0){
-    if(flops > flps){
-     max_flop = *(std::max_element(contr_flops.cbegin(),contr_flops.cend()));
-     contr_seq = cseq;
-     flops = flps;
+#pragma omp parallel for schedule(dynamic,1) shared(walkers,best_cost)
+   for(int w = 0; w < static_cast<int>(num_walkers); ++w){
+    auto & walker = walkers[w];
+    //Determine a tensor contraction sequence:
+    unsigned int intermediate_id = max_tensor_id;
+    walker.partition_time = 0.0;
+    walker.partition_calls = 0;
+    determineContrSequence(network,network_graph,walker.cseq,[&intermediate_id](){return ++intermediate_id;},
+                           granularity,walker.imbalance,&(walker.partition_time),&(walker.partition_calls));
+    const auto evaluation_start = std::chrono::steady_clock::now();
+    //Compute the total FMA flop count (abort once it exceeds the best-so-far, a lower bound for the sliced one):
+    assert(walker.cseq.size() == num_contractions && walker.cseq.back().result_id == 0);
+    const double flps = network_flat.simulateContractionSequence(walker.cseq,&(walker.contr_flops),
+                         [&best_cost](double flops_so_far){return (flops_so_far > best_cost.load());}); //negative for a dominated walker
+    walker.flops = flps;
+    walker.cost = flps;
+    if(flps >= 0.0){ //update the shared best-so-far Flop count
+     if(max_intermediate_volume_ > 0.0){ //account for the slicing overhead
+      walker.cost = determineSlicedFlops(network,walker.cseq,max_intermediate_volume_);
+     }
+     double current = best_cost.load();
+     while(walker.cost < current && !best_cost.compare_exchange_weak(current,walker.cost));
+    }
+    const std::chrono::duration<double> evaluation_time = std::chrono::steady_clock::now() - evaluation_start;
+    walker.evaluation_time = evaluation_time.count();
+   }
+   phaseTime(); //walker phases are accumulated per walker
+   for(const auto & walker: walkers){
+    telemetry.partition_time += walker.partition_time;
+    telemetry.partition_calls += walker.partition_calls;
+    telemetry.evaluation_time += walker.evaluation_time;
+    if(walker.flops < 0.0) ++(telemetry.num_aborted);
+   }
+   //Compare with previous best (the lowest walker id wins ties):
+   improved = false;
+   for(unsigned int w = 0; w < num_walkers; ++w){
+    const auto & walker = walkers[w];
+    if(walker.flops >= 0.0 && (best_cseq.empty() || walker.cost < cost)){
+     max_flop = *(std::max_element(walker.contr_flops.cbegin(),walker.contr_flops.cend()));
+     best_cseq = walker.cseq;
+     best_contr_flops = walker.contr_flops;
+     flops = walker.flops;
+     cost = walker.cost;
+     next_imbalance = walker.imbalance;
+     improved = true;
      if(debugging){
-      std::cout << " Iteration " << (num_walkers + 1)
+      std::cout << " Round " << round << ", walker " << w
                 << ": A faster tensor contraction sequence found with Flop count = " << flops
-                << " with top granularity " << partition_granularity_ << " under imbalances:";
-      for(const auto & imbalance: partition_imbalance_) std::cout << " " << imbalance;
+                << " (sliced " << cost << ")"
+                << " with top granularity " << granularity << " under imbalances:";
+      for(const auto & imbalance: walker.imbalance) std::cout << " " << imbalance;
       std::cout << ":\n";
-      for(const auto & contr_cost: contr_flops) std::cout << " " << contr_cost;
+      for(const auto & contr_cost: walker.contr_flops) std::cout << " " << contr_cost;
       std::cout << std::endl;
      }
-     num_walkers = num_walkers_;
-    }
-   }else{
-    max_flop = *(std::max_element(contr_flops.cbegin(),contr_flops.cend()));
-    contr_seq = cseq;
-    flops = flps;
-    if(debugging){
-     std::cout << " Iteration " << (num_walkers + 1)
-               << ": A faster tensor contraction sequence found with Flop count = " << flops
-               << " with top granularity " << partition_granularity_ << " under imbalances:";
-     for(const auto & imbalance: partition_imbalance_) std::cout << " " << imbalance;
-     std::cout << ":\n";
-     for(const auto & contr_cost: contr_flops) std::cout << " " << contr_cost;
-     std::cout << std::endl;
     }
    }
-   //Update partition imbalances:
-   if(deterministic){ //deterministic update
+   if(improved) telemetry.convergence.emplace_back(std::make_pair(searchElapsedTime(),cost));
+   //Exchange the best-so-far Flop count with other processes (tightens the early abort bound):
+   shared_cost = exchangeSearchBound(cost);
+   double current = best_cost.load();
+   while(shared_cost < current && !best_cost.compare_exchange_weak(current,shared_cost));
+   telemetry.merge_time += phaseTime();
+   //Update partition imbalances for the next round:
+   if(deterministic && improved){ //deterministic update of the best walker imbalances
     auto adjust_func = [](double z, double x){return z/(z + (1.0 - z) * std::exp(-0.33 * x));};
-    auto contr = cseq.size(); //last tensor contraction
-    for(auto & imbalance: partition_imbalance_){
-     const double diff = std::log10(contr_flops[--contr]) - std::log10(max_flop);
+    auto contr = best_contr_flops.size(); //last tensor contraction
+    for(auto & imbalance: next_imbalance){
+     const double diff = std::log10(best_contr_flops[--contr]) - std::log10(max_flop);
      imbalance = std::pow(2.0,adjust_func(std::log2(imbalance),diff));
      if(contr == 0) break;
     }
-   }else{ //random update
-    for(auto & imbalance: partition_imbalance_) imbalance = rnd();
    }
-   /*
-   if(debugging){
-    std::cout << " Updated imbalances: ";
-    for(const auto & imbalance: partition_imbalance_) std::cout << " " << imbalance;
-    std::cout << std::endl;
-    std::cout << " Reverse contraction costs: ";
-    contr = cseq.size();
-    for(const auto & imbalance: partition_imbalance_){
-     std::cout << " " << contr_flops[--contr];
-     if(contr == 0) break;
-    }
-    std::cout << std::endl;
+   ++round;
+   telemetry.num_rounds = round;
+   if(anytime){
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - time_start;
+    expired = (elapsed.count() >= getTimeBudget(std::min(cost,shared_cost))); //contraction time is estimated at the best (sliced) flop count
    }
-   */
   }
-  --partition_granularity_;
+  --granularity;
+  if(anytime && !expired && granularity < partition_factor_) granularity = top_granularity; //restart the sweep with new walkers
  }
- //Restore default partition parameters:
- partition_granularity_ = PARTITION_GRANULARITY;
- for(auto & imbalance: partition_imbalance_) imbalance = PARTITION_IMBALANCE;
+ if(debugging && anytime) std::cout << "#DEBUG(ContractionSeqOptimizerMetis): Anytime mode: " << round << " rounds of walkers\n"; //debug
+ //Map walker-local intermediate tensor ids to the externally generated ones:
+ std::unordered_map<unsigned int, unsigned int> id_map;
+ for(auto & contr_triple: best_cseq){ //intermediate tensors are always produced before they are consumed
+  auto iter = id_map.find(contr_triple.left_id);
+  if(iter != id_map.end()) contr_triple.left_id = iter->second;
+  iter = id_map.find(contr_triple.right_id);
+  if(iter != id_map.end()) contr_triple.right_id = iter->second;
+  if(contr_triple.result_id != 0){
+   const unsigned int result_id = intermediate_num_generator();
+   id_map[contr_triple.result_id] = result_id;
+   contr_triple.result_id = result_id;
+  }
+ }
+ contr_seq = best_cseq;
+ telemetry.merge_time += phaseTime();
  if(debugging) std::cout << "#DEBUG(ContractionSeqOptimizerMetis): The pseudo-optimal Flop count found = " << flops << std::endl;
  return flops;
 }
 
 
 void ContractionSeqOptimizerMetis::determineContrSequence(const TensorNetwork & network,
+                                                          const MetisGraph & network_graph,
                                                           std::list<ContrTriple> & contr_seq,
-                                                          std::function<unsigned int ()> intermediate_num_generator)
+                                                          std::function<unsigned int ()> intermediate_num_generator,
+                                                          std::size_t partition_granularity,
+                                                          const std::vector<double> & partition_imbalance,
+                                                          double * partition_time,
+                                                          std::size_t * partition_calls) const
 {
  const bool debugging = false;
 
@@ -174,8 +264,8 @@ void ContractionSeqOptimizerMetis::determineContrSequence(const TensorNetwork &
  std::deque<std::pair<MetisGraph,   //graph of a tensor sub-network
                       unsigned int> //tensor id for the intermediate output tensor of the sub-network
            > graphs; //graphs of tensor sub-networks
- graphs.emplace_back(std::make_pair(MetisGraph(network),0)); //original full tensor network graph
- std::size_t num_miniparts = partition_granularity_;
+ graphs.emplace_back(std::make_pair(network_graph,0)); //original full tensor network graph
+ std::size_t num_miniparts = partition_granularity;
  std::size_t contr = 0;
  bool not_done = true;
  while(not_done){
@@ -187,12 +277,18 @@ void ContractionSeqOptimizerMetis::determineContrSequence(const TensorNetwork &
    if(num_vertices > partition_max_size_){
     not_done = true;
     auto imbalance = PARTITION_IMBALANCE;
-    if(contr < partition_imbalance_.size()) imbalance = partition_imbalance_[contr];
+    if(contr < partition_imbalance.size()) imbalance = partition_imbalance[contr];
     std::size_t num_miniparts_safe = std::max(partition_factor_,std::min(num_miniparts,num_vertices/(2*partition_max_size_)));
     bool success = false;
     while(!success){
+     const auto partition_start = std::chrono::steady_clock::now();
      success = graph.partitionGraph(partition_factor_,num_miniparts_safe,imbalance);
      assert(success);
+     if(partition_time != nullptr){
+      const std::chrono::duration<double> partition_duration = std::chrono::steady_clock::now() - partition_start;
+      *partition_time += partition_duration.count();
+     }
+     if(partition_calls != nullptr) ++(*partition_calls);
      const auto num_partitions = graph.getNumPartitions(); assert(num_partitions == 2);
      for(std::size_t j = 0; j < num_partitions; ++j){
       graphs.emplace_back(std::make_pair(MetisGraph(graph,j),
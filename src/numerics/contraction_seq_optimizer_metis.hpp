@@ -1,10 +1,33 @@
 /** ExaTN::Numerics: Tensor contraction sequence optimizer: Metis heuristics
-REVISION: 2020/10/23
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
+ (a) Randomized partitioning walkers (different graph partition imbalances)
+     are executed concurrently by OpenMP threads. Each walker draws its
+     partition imbalances from its own random number stream derived from
+     the random seed and its walker id, thus making the result independent
+     of the number of threads for a fixed random seed.
+ (b) All walkers share the best-so-far Flop count such that a walker whose
+     partial Flop count exceeds it aborts early. The best walker is the one
+     with the smallest Flop count, the lowest walker id breaking ties.
+ (c) With the memory limit set, walkers are compared by their total sliced Flop count
+     (the unsliced Flop count still serves as a lower bound for the early abort).
+ (d) In the anytime mode, the search stops after the round of walkers during which
+     the time budget expired; otherwise, once all partition granularities have been
+     swept, the sweep is restarted with new random walkers until the budget expires.
+ (e) Search telemetry: The graph construction and the merging of walker results are timed
+     as phases of the search, whereas the graph partitioning (with its number of calls) and
+     the walker evaluation are timed per walker and accumulated; the best-so-far (sliced)
+     Flop count is recorded after each round of walkers which improved it.
+ (f) Distributed search: A non-default search variant offsets the random seed, draws
+     the partition imbalances of the very first walker randomly as well, and starts
+     the sweep of partition granularities at a coarser top granularity. After each round
+     of walkers, the best-so-far (sliced) Flop count is exchanged with the other processes,
+     and the shared one tightens the early abort bound of the walkers and determines
+     the anytime time budget (all processes then estimate the same contraction time).
 **/
 
 #ifndef EXATN_NUMERICS_CONTRACTION_SEQ_OPTIMIZER_METIS_HPP_
@@ -20,6 +43,9 @@ namespace exatn{
 
 namespace numerics{
 
+class MetisGraph;
+
+
 class ContractionSeqOptimizerMetis: public ContractionSeqOptimizer{
 
 public:
@@ -31,6 +57,9 @@ public:
 
  void resetAcceptanceTolerance(double acceptance_tolerance);
 
+ /** Resets the random seed defining the random number streams of the walkers. **/
+ void resetRandomSeed(unsigned int random_seed);
+
  virtual double determineContractionSequence(const TensorNetwork & network,
                                              std::list<ContrTriple> & contr_seq,
                                              std::function<unsigned int ()> intermediate_num_generator) override;
@@ -42,8 +71,13 @@ protected:
  using ContractionSequence = std::list<ContrTriple>;
 
  void determineContrSequence(const TensorNetwork & network,
+                             const MetisGraph & network_graph,
                              std::list<ContrTriple> & contr_seq,
-                             std::function<unsigned int ()> intermediate_num_generator);
+                             std::function<unsigned int ()> intermediate_num_generator,
+                             std::size_t partition_granularity,
+                             const std::vector<double> & partition_imbalance,
+                             double * partition_time = nullptr,           //inout: accumulated graph partitioning time (sec)
+                             std::size_t * partition_calls = nullptr) const; //inout: accumulated number of graph partitioning calls
 
  static constexpr const unsigned int NUM_WALKERS = 16;
  static constexpr const double ACCEPTANCE_TOLERANCE = 0.0;
@@ -56,6 +90,7 @@ protected:
 
  unsigned int num_walkers_;
  double acceptance_tolerance_;
+ unsigned int random_seed_;
 
  std::size_t partition_factor_;
  std::size_t partition_granularity_;
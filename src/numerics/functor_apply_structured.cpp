@@ -0,0 +1,162 @@
+/** ExaTN::Numerics: Tensor Functor: Application of a structured tensor to a tensor dimension
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "functor_apply_structured.hpp"
+
+#include "talshxx.hpp"
+
+#include <type_traits>
+#include <algorithm>
+
+namespace exatn{
+
+namespace numerics{
+
+FunctorApplyStructured::FunctorApplyStructured(unsigned int tensor_dimension,
+                                               const std::vector<std::complex<double>> & diagonal,
+                                               DimOffset dimension_base):
+ tensor_dimension_(tensor_dimension), dimension_base_(dimension_base), diagonal_(diagonal)
+{
+}
+
+
+FunctorApplyStructured::FunctorApplyStructured(unsigned int tensor_dimension,
+                                               const std::vector<DimOffset> & permutation,
+                                               DimOffset dimension_base):
+ tensor_dimension_(tensor_dimension), dimension_base_(dimension_base), permutation_(permutation)
+{
+}
+
+
+void FunctorApplyStructured::pack(BytePacket & packet)
+{
+ std::size_t diag_size = diagonal_.size();
+ std::size_t perm_size = permutation_.size();
+ appendToBytePacket(&packet,tensor_dimension_);
+ appendToBytePacket(&packet,dimension_base_);
+ appendToBytePacket(&packet,diag_size);
+ for(const auto & value: diagonal_){
+  appendToBytePacket(&packet,value.real());
+  appendToBytePacket(&packet,value.imag());
+ }
+ appendToBytePacket(&packet,perm_size);
+ for(const auto & pos: permutation_) appendToBytePacket(&packet,pos);
+ return;
+}
+
+
+void FunctorApplyStructured::unpack(BytePacket & packet)
+{
+ std::size_t diag_size, perm_size;
+ extractFromBytePacket(&packet,tensor_dimension_);
+ extractFromBytePacket(&packet,dimension_base_);
+ extractFromBytePacket(&packet,diag_size);
+ diagonal_.resize(diag_size);
+ for(auto & value: diagonal_){
+  double real,imag;
+  extractFromBytePacket(&packet,real);
+  extractFromBytePacket(&packet,imag);
+  value = std::complex<double>{real,imag};
+ }
+ extractFromBytePacket(&packet,perm_size);
+ permutation_.resize(perm_size);
+ for(auto & pos: permutation_) extractFromBytePacket(&packet,pos);
+ return;
+}
+
+
+int FunctorApplyStructured::apply(talsh::Tensor & local_tensor) //tensor slice (in general)
+{
+ unsigned int rank;
+ const auto * extents = local_tensor.getDimExtents(rank); //rank is returned by reference
+ const auto tensor_volume = local_tensor.getVolume(); //volume of the given tensor slice
+ const auto & offsets = local_tensor.getDimOffsets(); //base offsets of the given tensor slice
+ if(tensor_dimension_ >= rank){
+  std::cout << "#ERROR(exatn::numerics::FunctorApplyStructured): Invalid tensor dimension: "
+            << tensor_dimension_ << std::endl;
+  return 1;
+ }
+ //Tensor slice = {outer, dimension, inner} (column-wise storage):
+ const DimExtent extent = extents[tensor_dimension_];
+ const DimOffset base = offsets[tensor_dimension_] - dimension_base_;
+ DimExtent inner = 1;
+ for(unsigned int i = 0; i < tensor_dimension_; ++i) inner *= extents[i];
+ const DimExtent outer = (extent > 0 && inner > 0) ? (tensor_volume / (extent * inner)) : 0;
+ if(!permutation_.empty()){
+  if(base != 0 || extent != permutation_.size()){
+   std::cout << "#ERROR(exatn::numerics::FunctorApplyStructured): Permutation requires the full tensor dimension "
+             << tensor_dimension_ << " in the local tensor slice!" << std::endl;
+   return 1;
+  }
+ }else{
+  if(base + extent > diagonal_.size()){
+   std::cout << "#ERROR(exatn::numerics::FunctorApplyStructured): Diagonal does not match the tensor dimension "
+             << tensor_dimension_ << std::endl;
+   return 1;
+  }
+ }
+
+ auto apply_structured = [&](auto * tensor_body, auto convert){
+  using tensor_body_type = typename std::remove_pointer<decltype(tensor_body)>::type;
+  if(!permutation_.empty()){ //reordering along the dimension
+#pragma omp parallel for schedule(guided)
+   for(DimExtent o = 0; o < outer; ++o){
+    auto * block = &(tensor_body[o * extent * inner]);
+    std::vector<tensor_body_type> buffer(block,block + extent * inner);
+    for(DimExtent j = 0; j < extent; ++j){
+     std::copy(&(buffer[permutation_[j] * inner]),&(buffer[permutation_[j] * inner]) + inner,&(block[j * inner]));
+    }
+   }
+  }else{ //elementwise scaling along the dimension
+#pragma omp parallel for schedule(guided)
+   for(DimExtent o = 0; o < outer; ++o){
+    for(DimExtent j = 0; j < extent; ++j){
+     const tensor_body_type factor = convert(diagonal_[base + j]);
+     auto * run = &(tensor_body[(o * extent + j) * inner]);
+#pragma omp simd
+     for(DimExtent i = 0; i < inner; ++i) run[i] *= factor;
+    }
+   }
+  }
+  return 0;
+ };
+
+ auto access_granted = false;
+ {//Try REAL32:
+  float * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return apply_structured(body,[](const std::complex<double> & val){
+                                                   return static_cast<float>(val.real());});
+ }
+
+ {//Try REAL64:
+  double * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return apply_structured(body,[](const std::complex<double> & val){
+                                                   return val.real();});
+ }
+
+ {//Try COMPLEX32:
+  std::complex<float> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return apply_structured(body,[](const std::complex<double> & val){
+                                                   return std::complex<float>(val);});
+ }
+
+ {//Try COMPLEX64:
+  std::complex<double> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return apply_structured(body,[](const std::complex<double> & val){
+                                                   return val;});
+ }
+
+ std::cout << "#ERROR(exatn::numerics::FunctorApplyStructured): Unknown data kind in talsh::Tensor!" << std::endl;
+ return 1;
+}
+
+} //namespace numerics
+
+} //namespace exatn
@@ -0,0 +1,83 @@
+/** ExaTN::Numerics: Tensor Functor: Application of a structured tensor to a tensor dimension
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) This tensor functor (method) applies a structured order-2 tensor (tensor_structured.hpp)
+     to a given dimension k of a tensor T in place, without materializing the structured tensor:
+      Diagonal d: T(..,j,..) <- T(..,j,..) * d(j) (elementwise scaling along dimension k);
+      Permutation p: T(..,j,..) <- T(..,p(j),..) (reordering along dimension k).
+     The permutation requires the local tensor slice to cover dimension k completely.
+**/
+
+#ifndef EXATN_NUMERICS_FUNCTOR_APPLY_STRUCTURED_HPP_
+#define EXATN_NUMERICS_FUNCTOR_APPLY_STRUCTURED_HPP_
+
+#include "Identifiable.hpp"
+
+#include "tensor_basic.hpp"
+
+#include "tensor_method.hpp" //from TAL-SH
+
+#include <string>
+#include <vector>
+#include <complex>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class FunctorApplyStructured: public talsh::TensorFunctor<Identifiable>{
+public:
+
+ /** Elementwise scaling along a tensor dimension by a diagonal. **/
+ FunctorApplyStructured(unsigned int tensor_dimension,                        //in: chosen tensor dimension
+                        const std::vector<std::complex<double>> & diagonal,   //in: diagonal
+                        DimOffset dimension_base = 0);                        //in: tensor dimension base (for sliced dimensions)
+
+ /** Reordering along a tensor dimension by a permutation. **/
+ FunctorApplyStructured(unsigned int tensor_dimension,                        //in: chosen tensor dimension
+                        const std::vector<DimOffset> & permutation,           //in: permutation
+                        DimOffset dimension_base = 0);                        //in: tensor dimension base (for sliced dimensions)
+
+ virtual ~FunctorApplyStructured() = default;
+
+ virtual const std::string name() const override
+ {
+  return "TensorFunctorApplyStructured";
+ }
+
+ virtual const std::string description() const override
+ {
+  return "Applies a structured (diagonal or permutation) tensor to a tensor dimension";
+ }
+
+ /** Packs data members into a byte packet. **/
+ virtual void pack(BytePacket & packet) override;
+
+ /** Unpacks data members from a byte packet. **/
+ virtual void unpack(BytePacket & packet) override;
+
+ /** Applies the structured tensor to the chosen dimension of the local tensor slice.
+     Returns zero on success, or an error code otherwise.
+     The talsh::Tensor slice is identified by its signature and
+     shape that both can be accessed by talsh::Tensor methods. **/
+ virtual int apply(talsh::Tensor & local_tensor) override;
+
+private:
+
+ unsigned int tensor_dimension_;              //specific tensor dimension: [0..order-1]
+ DimOffset dimension_base_;                   //dimension base offset (if the dimension is sliced)
+ std::vector<std::complex<double>> diagonal_; //diagonal (scaling)
+ std::vector<DimOffset> permutation_;         //permutation (reordering)
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_FUNCTOR_APPLY_STRUCTURED_HPP_
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor Functor: Computes partial 2-norms over a given tensor dimension
-REVISION: 2021/07/22
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "functor_diag_rank.hpp"
 
@@ -65,14 +65,25 @@ int FunctorDiagRank::apply(talsh::Tensor & local_tensor) //tensor slice (in gene
 
  auto procedure = [&](const auto * tens_body){ //`Needs multi-threading
   TensorRange body_range(bases,extents);
-  bool active = (body_range.localVolume() > 0);
-  while(active){
-   const auto index_value = bases[tensor_dimension_] + body_range.getIndex(tensor_dimension_);
-   const auto offset = body_range.localOffset();
-   double val = std::abs(tens_body[offset]);
-   partial_norms_[index_value] += val * val;
-   active = body_range.next();
-  }
+  if(body_range.localVolume() == 0) return 0;
+  body_range.forEachRun([&](const DimOffset * mlndx, DimOffset offset, DimOffset, DimExtent length){
+   const auto * run = &(tens_body[offset]);
+   if(tensor_dimension_ == 0){ //the chosen dimension varies within the run
+    auto * norms = &(partial_norms_[bases[0] + mlndx[0]]);
+    for(DimExtent k = 0; k < length; ++k){
+     const double val = std::abs(run[k]);
+     norms[k] += val * val;
+    }
+   }else{ //the chosen dimension is fixed within the run
+    double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+    for(DimExtent k = 0; k < length; ++k){
+     const double val = std::abs(run[k]);
+     sum += val * val;
+    }
+    partial_norms_[bases[tensor_dimension_] + mlndx[tensor_dimension_]] += sum;
+   }
+  });
   return 0;
  };
 
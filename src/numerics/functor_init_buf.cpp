@@ -0,0 +1,168 @@
+/** ExaTN::Numerics: Tensor Functor: Initialization from an external host buffer
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "functor_init_buf.hpp"
+
+#include "talshxx.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace exatn{
+
+namespace numerics{
+
+namespace{
+
+template <typename DstType, typename SrcType>
+inline DstType convertElement(const SrcType & value){return static_cast<DstType>(value);}
+
+template <>
+inline float convertElement<float,std::complex<float>>(const std::complex<float> & value){return value.real();}
+template <>
+inline float convertElement<float,std::complex<double>>(const std::complex<double> & value){return static_cast<float>(value.real());}
+template <>
+inline double convertElement<double,std::complex<float>>(const std::complex<float> & value){return static_cast<double>(value.real());}
+template <>
+inline double convertElement<double,std::complex<double>>(const std::complex<double> & value){return value.real();}
+template <>
+inline std::complex<float> convertElement<std::complex<float>,std::complex<double>>(const std::complex<double> & value){
+ return std::complex<float>(value);
+}
+template <>
+inline std::complex<double> convertElement<std::complex<double>,std::complex<float>>(const std::complex<float> & value){
+ return std::complex<double>(value);
+}
+
+} //namespace
+
+
+void FunctorInitBuf::pack(BytePacket & packet)
+{
+ unsigned int rank = shape_.getRank();
+ appendToBytePacket(&packet,rank);
+ appendArrayToBytePacket(&packet,shape_.getDimExtents().data(),rank);
+ const std::size_t num_offsets = offsets_.size();
+ appendToBytePacket(&packet,num_offsets);
+ appendArrayToBytePacket(&packet,offsets_.data(),num_offsets);
+ appendToBytePacket(&packet,reinterpret_cast<std::uintptr_t>(buffer_));
+ appendToBytePacket(&packet,static_cast<int>(elem_type_));
+ return;
+}
+
+
+void FunctorInitBuf::unpack(BytePacket & packet)
+{
+ unsigned int rank;
+ extractFromBytePacket(&packet,rank);
+ std::vector<DimExtent> extents(rank);
+ extractArrayFromBytePacket(&packet,extents.data(),rank);
+ shape_ = TensorShape(extents);
+ std::size_t num_offsets;
+ extractFromBytePacket(&packet,num_offsets);
+ offsets_.resize(num_offsets);
+ extractArrayFromBytePacket(&packet,offsets_.data(),num_offsets);
+ std::uintptr_t address;
+ extractFromBytePacket(&packet,address);
+ buffer_ = reinterpret_cast<const void*>(address);
+ int elem_type;
+ extractFromBytePacket(&packet,elem_type);
+ elem_type_ = static_cast<TensorElementType>(elem_type);
+ return;
+}
+
+
+int FunctorInitBuf::apply(talsh::Tensor & local_tensor) //tensor slice (in general)
+{
+ unsigned int rank;
+ const auto * extents = local_tensor.getDimExtents(rank); //rank is returned by reference
+ const auto tensor_volume = local_tensor.getVolume(); //volume of the given tensor slice
+ const auto & offsets = local_tensor.getDimOffsets(); //base offsets of the given tensor slice
+ if(rank != shape_.getRank()){
+  std::cout << "#ERROR(exatn::numerics::FunctorInitBuf): Tensor rank mismatch: "
+            << rank << " " << shape_.getRank() << std::endl;
+  return 3;
+ }
+ std::vector<DimOffset> base(offsets_); //base offsets of the external buffer
+ if(base.empty()) base.assign(rank,0);
+ for(unsigned int i = 0; i < rank; ++i){
+  if(offsets[i] < base[i] || offsets[i] + extents[i] > base[i] + shape_.getDimExtent(i)){
+   std::cout << "#ERROR(exatn::numerics::FunctorInitBuf): Tensor dimension mismatch for dimension "
+             << i << ": " << offsets[i] << " " << extents[i] << " " << base[i] << " "
+             << shape_.getDimExtent(i) << std::endl;
+   return 2;
+  }
+ }
+ if(tensor_volume == 0) return 0;
+
+ //Copies contiguous runs along the first dimension from the external buffer:
+ auto copy_func = [&](auto * tensor_body, const auto * ext_body){
+  using BodyType = std::remove_pointer_t<decltype(tensor_body)>;
+  using ExtType = std::remove_cv_t<std::remove_pointer_t<decltype(ext_body)>>;
+  std::vector<std::size_t> full_strides(rank);
+  std::size_t stride = 1;
+  for(unsigned int i = 0; i < rank; ++i){full_strides[i] = stride; stride *= shape_.getDimExtent(i);}
+  const std::size_t run = (rank > 0) ? extents[0] : 1;
+  std::vector<std::size_t> mlndx(rank,0); //local multi-index (dimensions above the first one)
+  std::size_t dst = 0;
+  while(dst < tensor_volume){
+   std::size_t src = 0;
+   for(unsigned int i = 0; i < rank; ++i) src += (offsets[i] - base[i] + mlndx[i]) * full_strides[i];
+   for(std::size_t j = 0; j < run; ++j) tensor_body[dst+j] = convertElement<BodyType,ExtType>(ext_body[src+j]);
+   dst += run;
+   unsigned int i = 1;
+   while(i < rank){
+    if(++(mlndx[i]) < static_cast<std::size_t>(extents[i])) break;
+    mlndx[i++] = 0;
+   }
+  }
+  return 0;
+ };
+
+ auto ext_func = [&](auto * tensor_body){
+  switch(elem_type_){
+   case TensorElementType::REAL32: return copy_func(tensor_body,static_cast<const float*>(buffer_));
+   case TensorElementType::REAL64: return copy_func(tensor_body,static_cast<const double*>(buffer_));
+   case TensorElementType::COMPLEX32: return copy_func(tensor_body,static_cast<const std::complex<float>*>(buffer_));
+   case TensorElementType::COMPLEX64: return copy_func(tensor_body,static_cast<const std::complex<double>*>(buffer_));
+   default:
+    std::cout << "#ERROR(exatn::numerics::FunctorInitBuf): Invalid numeric type of the external buffer!" << std::endl;
+  }
+  return 4;
+ };
+
+ auto access_granted = false;
+ {//Try REAL32:
+  float * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return ext_func(body);
+ }
+
+ {//Try REAL64:
+  double * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return ext_func(body);
+ }
+
+ {//Try COMPLEX32:
+  std::complex<float> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return ext_func(body);
+ }
+
+ {//Try COMPLEX64:
+  std::complex<double> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) return ext_func(body);
+ }
+
+ std::cout << "#ERROR(exatn::numerics::FunctorInitBuf): Unknown data kind in talsh::Tensor!" << std::endl;
+ return 1;
+}
+
+} //namespace numerics
+
+} //namespace exatn
@@ -0,0 +1,143 @@
+/** ExaTN::Numerics: Tensor Functor: Initialization from an external host buffer
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) This tensor functor (method) is used to initialize a Tensor with
+     externally provided data residing in an externally owned host buffer.
+     Unlike FunctorInitDat, the external data is not copied into the functor:
+     Each local tensor slice is filled directly from the external buffer
+     (contiguous runs along the first dimension), such that large datasets
+     enter ExaTN without an intermediate copy.
+ (B) The external buffer must contain the entire tensor body stored column-major,
+     with the explicit shape of the full tensor supplied as well. Alternatively,
+     the external buffer may only contain a dense block of the full tensor,
+     specified by its shape and base offsets, which must cover all local tensor
+     slices initialized by the functor (e.g., a single subtensor). The external
+     buffer must stay valid until the functor is destroyed (once the tensor
+     initialization has been executed), at which point the lifetime guard
+     (e.g., a release callback) supplied by the owner is released.
+ (C) The external numeric type is converted to the tensor element type
+     (a complex value converted to a real one retains its real part).
+ (D) The functor references a host buffer of the current process, thus
+     its packed form is only meaningful within the same process.
+**/
+
+#ifndef EXATN_NUMERICS_FUNCTOR_INIT_BUF_HPP_
+#define EXATN_NUMERICS_FUNCTOR_INIT_BUF_HPP_
+
+#include "Identifiable.hpp"
+
+#include "tensor_basic.hpp"
+#include "tensor_shape.hpp"
+
+#include "tensor_method.hpp" //from TAL-SH
+
+#include <type_traits>
+#include <string>
+#include <vector>
+#include <memory>
+#include <complex>
+#include <cstdint>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class FunctorInitBuf: public talsh::TensorFunctor<Identifiable>{
+public:
+
+ /** TensorShape object must specify the shape of the full tensor and
+     the external buffer must contain the full tensor body stored
+     column-major as specified by the provided tensor shape. **/
+ template <typename NumericType>
+ FunctorInitBuf(const TensorShape & full_shape,  //in: shape of the full tensor
+                const NumericType * ext_buffer,  //in: externally owned host buffer (full tensor body)
+                std::shared_ptr<void> guard);    //in: lifetime guard of the external buffer (released with the functor)
+
+ /** TensorShape object and base offsets must specify a dense block of the full tensor
+     and the external buffer must contain the body of that block stored column-major. **/
+ template <typename NumericType>
+ FunctorInitBuf(const TensorShape & block_shape,                //in: shape of the tensor block stored in the external buffer
+                const std::vector<DimOffset> & block_offsets,   //in: base offsets of the tensor block
+                const NumericType * ext_buffer,                 //in: externally owned host buffer (tensor block body)
+                std::shared_ptr<void> guard);                   //in: lifetime guard of the external buffer (released with the functor)
+
+ virtual ~FunctorInitBuf() = default;
+
+ virtual const std::string name() const override
+ {
+  return "TensorFunctorInitBuf";
+ }
+
+ virtual const std::string description() const override
+ {
+  return "Initializes a tensor with a given external data from a host buffer";
+ }
+
+ /** Packs data members into a byte packet. **/
+ virtual void pack(BytePacket & packet) override;
+
+ /** Unpacks data members from a byte packet. **/
+ virtual void unpack(BytePacket & packet) override;
+
+ /** Initializes the local tensor slice with external data.
+     Returns zero on success, or an error code otherwise.
+     The talsh::Tensor slice is identified by its signature and
+     shape that both can be accessed by talsh::Tensor methods. **/
+ virtual int apply(talsh::Tensor & local_tensor) override;
+
+private:
+
+ TensorShape shape_;            //shape of the full tensor (or its block)
+ std::vector<DimOffset> offsets_; //base offsets of the tensor block (empty: full tensor)
+ const void * buffer_;          //externally owned host buffer (full tensor body)
+ TensorElementType elem_type_;  //numeric type of the external buffer
+ std::shared_ptr<void> guard_;  //lifetime guard of the external buffer
+};
+
+
+//DEFINITIONS:
+template <typename NumericType>
+FunctorInitBuf::FunctorInitBuf(const TensorShape & full_shape,
+                               const NumericType * ext_buffer,
+                               std::shared_ptr<void> guard):
+ FunctorInitBuf(full_shape,std::vector<DimOffset>{},ext_buffer,guard)
+{
+}
+
+template <typename NumericType>
+FunctorInitBuf::FunctorInitBuf(const TensorShape & block_shape,
+                               const std::vector<DimOffset> & block_offsets,
+                               const NumericType * ext_buffer,
+                               std::shared_ptr<void> guard):
+ shape_(block_shape), offsets_(block_offsets), buffer_(ext_buffer), elem_type_(TensorElementType::VOID), guard_(guard)
+{
+ static_assert(std::is_same<NumericType,float>::value ||
+               std::is_same<NumericType,double>::value ||
+               std::is_same<NumericType,std::complex<float>>::value ||
+               std::is_same<NumericType,std::complex<double>>::value,
+               "#ERROR(exatn::numerics::FunctorInitBuf): Invalid numeric data type!");
+ assert(ext_buffer != nullptr);
+ assert(reinterpret_cast<std::uintptr_t>(ext_buffer) % alignof(NumericType) == 0);
+ assert(offsets_.empty() || offsets_.size() == shape_.getRank());
+ if(std::is_same<NumericType,float>::value){
+  elem_type_ = TensorElementType::REAL32;
+ }else if(std::is_same<NumericType,double>::value){
+  elem_type_ = TensorElementType::REAL64;
+ }else if(std::is_same<NumericType,std::complex<float>>::value){
+  elem_type_ = TensorElementType::COMPLEX32;
+ }else{
+  elem_type_ = TensorElementType::COMPLEX64;
+ }
+}
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_FUNCTOR_INIT_BUF_HPP_
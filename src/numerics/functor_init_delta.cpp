@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization of Kronecker Delta tensors
-REVISION: 2020/12/29
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "functor_init_delta.hpp"
 
@@ -10,6 +10,8 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "talshxx.hpp"
 
+#include <type_traits>
+
 namespace exatn{
 
 namespace numerics{
@@ -38,16 +40,22 @@ int FunctorInitDelta::apply(talsh::Tensor & local_tensor) //tensor slice (in gen
   for(unsigned int i = 0; i < rank; ++i) bas[i] = offsets[i]; //tensor slice dimension base offsets
   std::vector<DimExtent> ext(rank);
   for(unsigned int i = 0; i < rank; ++i) ext[i] = extents[i]; //tensor slice dimension extents
+  using tensor_body_type = typename std::remove_pointer<decltype(tensor_body)>::type;
   TensorRange rng(bas,ext);
-  bool not_over = true;
-  while(not_over){
-   if(rng.onDiagonal()){
-    tensor_body[rng.localOffset()] = 1.0;
+  rng.forEachRun([&](const DimOffset * mlndx, DimOffset offset, DimOffset, DimExtent length){
+   auto * run = &(tensor_body[offset]);
+#pragma omp simd
+   for(DimExtent k = 0; k < length; ++k) run[k] = tensor_body_type(0.0);
+   //Only the first index varies within the run, thus at most one diagonal element:
+   if(rank > 1){
+    const DimOffset diag = bas[1] + mlndx[1];
+    for(unsigned int i = 2; i < rank; ++i) if(bas[i] + mlndx[i] != diag) return;
+    const DimOffset first = bas[0] + mlndx[0];
+    if(diag >= first && diag < first + length) run[diag - first] = tensor_body_type(1.0);
    }else{
-    tensor_body[rng.localOffset()] = 0.0;
+    for(DimExtent k = 0; k < length; ++k) run[k] = tensor_body_type(1.0);
    }
-   not_over = rng.next();
-  }
+  });
   return 0;
  };
 
@@ -1,24 +1,35 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization from a file
-REVISION: 2020/12/04
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "functor_init_file.hpp"
 
 #include "tensor_range.hpp"
+#include "half_float.hpp"
 
 #include "talshxx.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace exatn{
 
 namespace numerics{
 
-FunctorInitFile::FunctorInitFile(const std::string & filename):
- filename_(filename)
+FunctorInitFile::FunctorInitFile(const std::string & filename, std::uint64_t record_pos):
+ filename_(filename), record_pos_(record_pos)
 {
 }
 
@@ -27,7 +38,8 @@ void FunctorInitFile::pack(BytePacket & packet)
 {
  unsigned int filename_len = filename_.length();
  appendToBytePacket(&packet,filename_len);
- while(filename_len > 0) appendToBytePacket(&packet,filename_[--filename_len]);
+ appendArrayToBytePacket(&packet,filename_.data(),filename_len);
+ appendToBytePacket(&packet,record_pos_);
  return;
 }
 
@@ -38,16 +50,28 @@ void FunctorInitFile::unpack(BytePacket & packet)
  extractFromBytePacket(&packet,filename_len);
  if(filename_len > 0){
   filename_.resize(filename_len);
-  for(unsigned int i = 0; i < filename_len; ++i) extractFromBytePacket(&packet,filename_[i]);
+  extractArrayFromBytePacket(&packet,&(filename_[0]),filename_len);
  }else{
   filename_.clear();
  }
+ extractFromBytePacket(&packet,record_pos_);
  return;
 }
 
 
 int FunctorInitFile::apply(talsh::Tensor & local_tensor) //tensor slice (in general)
 {
+ {//Detect the binary format:
+  std::ifstream tensor_file(filename_,std::fstream::in|std::fstream::binary);
+  if(tensor_file.is_open()){
+   tensor_file.seekg(record_pos_);
+   char magic[sizeof(BINARY_TENSOR_FILE_MAGIC)] = {'\0'};
+   tensor_file.read(magic,sizeof(BINARY_TENSOR_FILE_MAGIC)-1);
+   if(tensor_file.gcount() == sizeof(BINARY_TENSOR_FILE_MAGIC)-1 &&
+      std::strcmp(magic,BINARY_TENSOR_FILE_MAGIC) == 0) return applyBinary(local_tensor);
+  }
+ }
+
  unsigned int rank;
  const auto * extents = local_tensor.getDimExtents(rank); //rank is returned by reference
  const auto tensor_volume = local_tensor.getVolume(); //volume of the given tensor slice
@@ -169,6 +193,178 @@ int FunctorInitFile::apply(talsh::Tensor & local_tensor) //tensor slice (in gene
  return 1;
 }
 
+
+int FunctorInitFile::applyBinary(talsh::Tensor & local_tensor) //tensor slice (in general)
+{
+ unsigned int rank;
+ const auto * extents = local_tensor.getDimExtents(rank); //rank is returned by reference
+ const auto & offsets = local_tensor.getDimOffsets(); //base offsets of the given tensor slice
+
+ if(!hostIsLittleEndian()){
+  std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Binary tensor files require a little-endian host!" << std::endl << std::flush;
+  return 14;
+ }
+
+ //Memory-map the binary tensor file:
+ int fd = ::open(filename_.c_str(),O_RDONLY);
+ if(fd < 0){
+  std::cout << "#ERROR(exatn::numerics::FunctorInitFile): File not found: " << filename_ << std::endl << std::flush;
+  return 2;
+ }
+ struct stat file_stat;
+ if(::fstat(fd,&file_stat) != 0 || file_stat.st_size <= 0){
+  ::close(fd);
+  std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Invalid format of file " << filename_ << std::endl << std::flush;
+  return 12;
+ }
+ const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+ void * file_ptr = ::mmap(nullptr,file_size,PROT_READ,MAP_PRIVATE,fd,0);
+ ::close(fd);
+ if(file_ptr == MAP_FAILED){
+  std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Unable to map file " << filename_ << std::endl << std::flush;
+  return 13;
+ }
+ const char * file_data = static_cast<const char*>(file_ptr);
+
+ auto read_func = [&](auto * tensor_body, bool complex_body){
+  using BodyType = std::remove_pointer_t<decltype(tensor_body)>;
+  std::size_t pos = record_pos_ + sizeof(BINARY_TENSOR_FILE_MAGIC) - 1;
+  auto read_value = [&](auto & value){
+   if(pos + sizeof(value) > file_size) return false;
+   std::memcpy(&value,file_data+pos,sizeof(value));
+   pos += sizeof(value);
+   return true;
+  };
+
+  //Read the header:
+  std::uint32_t elem_type, tens_rank;
+  std::uint64_t num_blocks;
+  if(!(read_value(elem_type) && read_value(tens_rank) && read_value(num_blocks))){
+   std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Invalid format of file " << filename_ << std::endl << std::flush;
+   return 11;
+  }
+  const bool complex_file = (elem_type == static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX32) ||
+                             elem_type == static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX64) ||
+                             elem_type == static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX16));
+  const bool double_file = (elem_type == static_cast<std::uint32_t>(BinaryTensorElem::REAL64) ||
+                            elem_type == static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX64));
+  const bool half_file = (elem_type == static_cast<std::uint32_t>(BinaryTensorElem::REAL16) ||
+                          elem_type == static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX16));
+  if(elem_type < static_cast<std::uint32_t>(BinaryTensorElem::REAL32) ||
+     elem_type > static_cast<std::uint32_t>(BinaryTensorElem::COMPLEX16) || complex_file != complex_body){
+   std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Tensor element type mismatch in file " << filename_ << std::endl << std::flush;
+   return 4;
+  }
+  if(tens_rank != rank){
+   std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Tensor rank mismatch in file " << filename_ << std::endl << std::flush;
+   return 7;
+  }
+  std::vector<std::uint64_t> tens_shape(tens_rank), tens_signa(tens_rank);
+  bool success = true;
+  for(auto & extent: tens_shape) success = success && read_value(extent);
+  for(auto & base_offset: tens_signa) success = success && read_value(base_offset);
+  if(!success){
+   std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Invalid format of file " << filename_ << std::endl << std::flush;
+   return 10;
+  }
+  for(unsigned int i = 0; i < tens_rank; ++i){
+   if(offsets[i] < tens_signa[i] || offsets[i] + extents[i] > tens_signa[i] + tens_shape[i]){
+    std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Tensor slice is outside of the tensor stored in file "
+              << filename_ << std::endl << std::flush;
+    return 5;
+   }
+  }
+
+  //Copy the portions of the stored blocks overlapping with the local tensor slice:
+  const std::size_t num_comps = (complex_file ? 2 : 1);
+  const std::size_t comp_size = (double_file ? sizeof(double) : (half_file ? sizeof(Float16) : sizeof(float)));
+  std::vector<std::uint64_t> block_signa(tens_rank), block_shape(tens_rank);
+  std::vector<std::uint64_t> lb(tens_rank), ub(tens_rank), mlndx(tens_rank);
+  for(std::uint64_t block = 0; block < num_blocks; ++block){
+   std::uint64_t body_pos; //relative to the tensor record
+   for(auto & base_offset: block_signa) success = success && read_value(base_offset);
+   for(auto & extent: block_shape) success = success && read_value(extent);
+   success = success && read_value(body_pos);
+   body_pos += record_pos_;
+   if(!success){
+    std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Invalid block index in file " << filename_ << std::endl << std::flush;
+    return 9;
+   }
+   std::uint64_t block_volume = 1;
+   for(const auto extent: block_shape) block_volume *= extent;
+   if(body_pos % comp_size != 0 || body_pos + block_volume * num_comps * comp_size > file_size){
+    std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Invalid block body in file " << filename_ << std::endl << std::flush;
+    return 8;
+   }
+   bool overlap = true;
+   for(unsigned int i = 0; i < tens_rank; ++i){
+    lb[i] = std::max(static_cast<std::uint64_t>(offsets[i]),block_signa[i]);
+    ub[i] = std::min(static_cast<std::uint64_t>(offsets[i] + extents[i]),block_signa[i] + block_shape[i]);
+    if(lb[i] >= ub[i]){overlap = false; break;}
+   }
+   if(!overlap) continue;
+   auto copy_block = [&](const auto * block_body){
+    const std::size_t run = (tens_rank > 0 ? (ub[0] - lb[0]) : 1) * num_comps; //contiguous run along the first dimension
+    mlndx = lb;
+    while(true){
+     std::size_t src = 0, dst = 0, src_stride = 1, dst_stride = 1;
+     for(unsigned int i = 0; i < tens_rank; ++i){
+      src += (mlndx[i] - block_signa[i]) * src_stride; src_stride *= block_shape[i];
+      dst += (mlndx[i] - offsets[i]) * dst_stride; dst_stride *= extents[i];
+     }
+     const auto * src_ptr = &(block_body[src * num_comps]);
+     auto * dst_ptr = &(tensor_body[dst * num_comps]);
+     for(std::size_t j = 0; j < run; ++j) dst_ptr[j] = static_cast<BodyType>(src_ptr[j]);
+     unsigned int i = 1;
+     while(i < tens_rank){
+      if(++(mlndx[i]) < ub[i]) break;
+      mlndx[i] = lb[i]; ++i;
+     }
+     if(i >= tens_rank) break;
+    }
+   };
+   if(double_file){
+    copy_block(reinterpret_cast<const double*>(file_data + body_pos));
+   }else if(half_file){
+    copy_block(reinterpret_cast<const Float16*>(file_data + body_pos));
+   }else{
+    copy_block(reinterpret_cast<const float*>(file_data + body_pos));
+   }
+  }
+  return 0;
+ };
+
+ int error_code = 1;
+ auto access_granted = false;
+ {//Try REAL32:
+  float * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) error_code = read_func(body,false);
+ }
+
+ if(!access_granted){//Try REAL64:
+  double * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) error_code = read_func(body,false);
+ }
+
+ if(!access_granted){//Try COMPLEX32:
+  std::complex<float> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) error_code = read_func(reinterpret_cast<float*>(body),true);
+ }
+
+ if(!access_granted){//Try COMPLEX64:
+  std::complex<double> * body;
+  access_granted = local_tensor.getDataAccessHost(&body);
+  if(access_granted) error_code = read_func(reinterpret_cast<double*>(body),true);
+ }
+
+ ::munmap(file_ptr,file_size);
+ if(!access_granted) std::cout << "#ERROR(exatn::numerics::FunctorInitFile): Unknown data kind in talsh::Tensor!" << std::endl << std::flush;
+ return error_code;
+}
+
 } //namespace numerics
 
 } //namespace exatn
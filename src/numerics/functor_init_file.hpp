@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization from a file
-REVISION: 2020/12/03
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (A) This tensor functor (method) is used to initialize a Tensor
@@ -14,6 +14,30 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
       Tensor elements:
        Dense format: Numeric values (column-wise order), any number of values per line
        List format: Numeric value and Multi-index in each line
+ (B) Alternatively, the file may have the binary format (little-endian),
+     which is detected by its leading magic string:
+      Magic string (8 bytes: BINARY_TENSOR_FILE_MAGIC)
+      Tensor element type (uint32: BinaryTensorElem)
+      Tensor rank (uint32)
+      Number of stored blocks (uint64)
+      Tensor shape (uint64[rank]: dimension extents)
+      Tensor signature (uint64[rank]: dimension base offsets)
+      Block index (for each block):
+       Block signature (uint64[rank]: absolute dimension base offsets)
+       Block shape (uint64[rank]: dimension extents)
+       Block body position (uint64: byte offset from the beginning of the tensor record,
+                            aligned to BINARY_TENSOR_FILE_ALIGNMENT)
+      Block bodies: Raw tensor elements (column-wise order)
+     The binary file is memory-mapped and only the portions of the stored
+     blocks overlapping with the local tensor slice are copied, such that
+     each process reads only the tensor slice it owns. The stored element
+     type is converted to the element type of the tensor (real <-> real and
+     complex <-> complex only).
+ (C) A binary tensor record may also be embedded into a larger file at some
+     position (e.g., a checkpoint file containing multiple tensors), in which
+     case the block body positions are relative to the tensor record position.
+ (D) Half-precision (REAL16, COMPLEX16) tensor files store binary16 numbers,
+     which are converted to the (single-precision) in-memory tensor elements.
 **/
 
 #ifndef EXATN_NUMERICS_FUNCTOR_INIT_FILE_HPP_
@@ -28,6 +52,7 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include <string>
 #include <complex>
+#include <cstdint>
 
 #include "errors.hpp"
 
@@ -35,10 +60,32 @@ namespace exatn{
 
 namespace numerics{
 
+//Binary tensor file format:
+constexpr char BINARY_TENSOR_FILE_MAGIC[] = "EXATNBT1";   //8 leading bytes of a binary tensor file
+constexpr std::uint64_t BINARY_TENSOR_FILE_ALIGNMENT = 64; //alignment of block bodies in a binary tensor file
+constexpr char BINARY_CHECKPOINT_FILE_MAGIC[] = "EXATNCK1"; //8 leading bytes of a checkpoint file with multiple binary tensor records
+
+enum class BinaryTensorElem: std::uint32_t{
+ REAL32 = 1,
+ REAL64 = 2,
+ COMPLEX32 = 3,
+ COMPLEX64 = 4,
+ REAL16 = 5,    //IEEE binary16
+ COMPLEX16 = 6  //pair of IEEE binary16
+};
+
+/** Returns TRUE if the host byte order is little-endian (binary tensor files are stored little-endian). **/
+inline bool hostIsLittleEndian()
+{
+ const std::uint32_t probe = 1;
+ return (*reinterpret_cast<const unsigned char*>(&probe) == 1);
+}
+
 class FunctorInitFile: public talsh::TensorFunctor<Identifiable>{
 public:
 
- FunctorInitFile(const std::string & filename); //in: file name which contains tensor data
+ FunctorInitFile(const std::string & filename,  //in: file name which contains tensor data
+                 std::uint64_t record_pos = 0); //in: position of the binary tensor record in the file (binary format only)
 
  virtual ~FunctorInitFile() = default;
 
@@ -66,7 +113,11 @@ public:
 
 private:
 
- std::string filename_; //file name which contains tensor data
+ /** Initializes the local tensor slice from a memory-mapped binary tensor file. **/
+ int applyBinary(talsh::Tensor & local_tensor);
+
+ std::string filename_;     //file name which contains tensor data
+ std::uint64_t record_pos_; //position of the binary tensor record in the file
 };
 
 } //namespace numerics
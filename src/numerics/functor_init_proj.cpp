@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization of Ordering Projection tensors
-REVISION: 2022/01/28
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -10,6 +10,8 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "talshxx.hpp"
 
+#include <type_traits>
+
 namespace exatn{
 
 namespace numerics{
@@ -37,21 +39,43 @@ int FunctorInitProj::apply(talsh::Tensor & local_tensor) //tensor slice (in gene
 
  assert(rank%2 == 0); //only even-order tensors
 
+ //Fills a run along the first dimension: Only the first index varies within the run,
+ //thus at most one element satisfies the (strong or weak) ordering of both equal halves:
+ auto fill_run = [rank](auto * run,
+                        const std::vector<DimOffset> & bas,
+                        const DimOffset * mlndx,
+                        DimExtent length,
+                        bool weak){
+  using tensor_body_type = typename std::remove_pointer<decltype(run)>::type;
+#pragma omp simd
+  for(DimExtent k = 0; k < length; ++k) run[k] = tensor_body_type(0.0);
+  if(rank == 0){run[0] = tensor_body_type(1.0); return;}
+  const unsigned int half = rank / 2;
+  for(unsigned int i = 1; i < half; ++i){ //ordering of the fixed indices of the first half
+   const auto prev = bas[i-1] + mlndx[i-1], curr = bas[i] + mlndx[i];
+   if(i > 1 && (weak ? (curr < prev) : (curr <= prev))) return;
+   if(curr != bas[half+i] + mlndx[half+i]) return; //both halves must be equal
+  }
+  const DimOffset first = bas[0] + mlndx[0];
+  const DimOffset target = bas[half] + mlndx[half]; //the first index must be equal to its pair
+  if(target < first || target >= first + length) return;
+  if(half > 1){
+   const auto next = bas[1] + mlndx[1];
+   if(weak ? (next < target) : (next <= target)) return;
+  }
+  run[target - first] = tensor_body_type(1.0);
+  return;
+ };
+
  auto init_proj_strong = [&](auto * tensor_body){
   std::vector<DimOffset> bas(rank);
   for(unsigned int i = 0; i < rank; ++i) bas[i] = offsets[i]; //tensor slice dimension base offsets
   std::vector<DimExtent> ext(rank);
   for(unsigned int i = 0; i < rank; ++i) ext[i] = extents[i]; //tensor slice dimension extents
   TensorRange rng(bas,ext);
-  bool not_over = true;
-  while(not_over){
-   if(rng.increasingOrderDiag()){
-    tensor_body[rng.localOffset()] = 1.0;
-   }else{
-    tensor_body[rng.localOffset()] = 0.0;
-   }
-   not_over = rng.next();
-  }
+  rng.forEachRun([&](const DimOffset * mlndx, DimOffset offset, DimOffset, DimExtent length){
+   fill_run(&(tensor_body[offset]),bas,mlndx,length,false);
+  });
   return 0;
  };
 
@@ -61,15 +85,9 @@ int FunctorInitProj::apply(talsh::Tensor & local_tensor) //tensor slice (in gene
   std::vector<DimExtent> ext(rank);
   for(unsigned int i = 0; i < rank; ++i) ext[i] = extents[i]; //tensor slice dimension extents
   TensorRange rng(bas,ext);
-  bool not_over = true;
-  while(not_over){
-   if(rng.nondecreasingOrderDiag()){
-    tensor_body[rng.localOffset()] = 1.0;
-   }else{
-    tensor_body[rng.localOffset()] = 0.0;
-   }
-   not_over = rng.next();
-  }
+  rng.forEachRun([&](const DimOffset * mlndx, DimOffset offset, DimOffset, DimExtent length){
+   fill_run(&(tensor_body[offset]),bas,mlndx,length,true);
+  });
   return 0;
  };
 
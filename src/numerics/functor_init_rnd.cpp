@@ -1,14 +1,14 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization to a random value
-REVISION: 2019/11/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2019 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2019 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "functor_init_rnd.hpp"
+#include "philox_rng.hpp"
 
 #include "talshxx.hpp"
 
-#include <functional>
 #include <random>
 #include <complex>
 
@@ -16,23 +16,60 @@ namespace exatn{
 
 namespace numerics{
 
-int FunctorInitRnd::apply(talsh::Tensor & local_tensor)
+FunctorInitRnd::FunctorInitRnd()
 {
  std::random_device seeder;
+ key_ = (static_cast<std::uint64_t>(seeder()) << 32) | static_cast<std::uint64_t>(seeder());
+}
+
+
+FunctorInitRnd::FunctorInitRnd(std::uint64_t seed,
+                               const std::string & tensor_name):
+ key_(Philox4x32::makeKey(seed,tensor_name))
+{
+}
+
+
+int FunctorInitRnd::apply(talsh::Tensor & local_tensor) //tensor slice (in general)
+{
+ unsigned int rank;
+ const auto * extents = local_tensor.getDimExtents(rank); //rank is returned by reference
+ const auto tensor_volume = local_tensor.getVolume(); //volume of the given tensor slice
+ const auto & offsets = local_tensor.getDimOffsets(); //base offsets of the given tensor slice
+ if(tensor_volume == 0) return 0;
+
+ const Philox4x32 generator(key_);
+ const std::size_t run = (rank > 0) ? extents[0] : 1; //contiguous run along the first dimension
+ const std::size_t num_runs = tensor_volume / run;
+ const std::uint64_t base = (rank > 0) ? offsets[0] : 0; //global offset of the first dimension
+
+ //Fills contiguous runs along the first dimension in parallel, the counter being
+ //{global index of the first dimension, hash of the global indices of the other dimensions}:
+ auto fill_func = [&](auto * tensor_body, auto make_element){
+#pragma omp parallel for schedule(static)
+  for(std::size_t r = 0; r < num_runs; ++r){
+   std::uint64_t hash = 0;
+   std::size_t rest = r;
+   for(unsigned int i = 1; i < rank; ++i){
+    const std::size_t extent = extents[i];
+    hash = Philox4x32::mix(hash,static_cast<std::uint64_t>(offsets[i]) + (rest % extent));
+    rest /= extent;
+   }
+   auto * run_body = &(tensor_body[r * run]);
+   for(std::size_t j = 0; j < run; ++j) run_body[j] = make_element(generator(base + j,hash));
+  }
+  return 0;
+ };
 
- auto tensor_volume = local_tensor.getVolume();
  auto access_granted = false;
 
  {//Try REAL32:
   float * body;
   access_granted = local_tensor.getDataAccessHost(&body);
   if(access_granted){
-   std::default_random_engine generator(seeder());
-   std::uniform_real_distribution<float> distribution(-1.0,1.0);
-   auto rnd = std::bind(distribution,generator);
-#pragma omp parallel for schedule(guided) shared(tensor_volume,body)
-   for(std::size_t i = 0; i < tensor_volume; ++i) body[i] = rnd();
-   return 0;
+   return fill_func(body,[](const Philox4x32::Counter & bits){
+    return Philox4x32::uniformFloat(bits[0]);
+   });
   }
  }
 
@@ -40,12 +77,9 @@ int FunctorInitRnd::apply(talsh::Tensor & local_tensor)
   double * body;
   access_granted = local_tensor.getDataAccessHost(&body);
   if(access_granted){
-   std::default_random_engine generator(seeder());
-   std::uniform_real_distribution<double> distribution(-1.0,1.0);
-   auto rnd = std::bind(distribution,generator);
-#pragma omp parallel for schedule(guided) shared(tensor_volume,body)
-   for(std::size_t i = 0; i < tensor_volume; ++i) body[i] = rnd();
-   return 0;
+   return fill_func(body,[](const Philox4x32::Counter & bits){
+    return Philox4x32::uniformDouble(bits[0],bits[1]);
+   });
   }
  }
 
@@ -53,12 +87,9 @@ int FunctorInitRnd::apply(talsh::Tensor & local_tensor)
   std::complex<float> * body;
   access_granted = local_tensor.getDataAccessHost(&body);
   if(access_granted){
-   std::default_random_engine generator(seeder());
-   std::uniform_real_distribution<float> distribution(-1.0,1.0);
-   auto rnd = std::bind(distribution,generator);
-#pragma omp parallel for schedule(guided) shared(tensor_volume,body)
-   for(std::size_t i = 0; i < tensor_volume; ++i) body[i] = std::complex<float>{rnd(),rnd()};
-   return 0;
+   return fill_func(body,[](const Philox4x32::Counter & bits){
+    return std::complex<float>{Philox4x32::uniformFloat(bits[0]),Philox4x32::uniformFloat(bits[2])};
+   });
   }
  }
 
@@ -66,12 +97,9 @@ int FunctorInitRnd::apply(talsh::Tensor & local_tensor)
   std::complex<double> * body;
   access_granted = local_tensor.getDataAccessHost(&body);
   if(access_granted){
-   std::default_random_engine generator(seeder());
-   std::uniform_real_distribution<double> distribution(-1.0,1.0);
-   auto rnd = std::bind(distribution,generator);
-#pragma omp parallel for schedule(guided) shared(tensor_volume,body)
-   for(std::size_t i = 0; i < tensor_volume; ++i) body[i] = std::complex<double>{rnd(),rnd()};
-   return 0;
+   return fill_func(body,[](const Philox4x32::Counter & bits){
+    return std::complex<double>{Philox4x32::uniformDouble(bits[0],bits[1]),Philox4x32::uniformDouble(bits[2],bits[3])};
+   });
   }
  }
 
@@ -1,11 +1,19 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization to a random value
-REVISION: 2019/11/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2019 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2019 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (A) This tensor functor (method) is used to initialize a Tensor to a random value.
+ (B) Random tensor elements are uniformly distributed in [-1,1) (both real and imaginary
+     parts) and generated by the counter-based Philox4x32-10 generator keyed by the functor
+     key, with the counter given by the global multi-index of the tensor element. Thus, each
+     tensor element only depends on the key and its position in the full tensor, such that
+     the result is bitwise identical regardless of how the tensor is sliced across processes,
+     and the local tensor slice is filled by multiple threads in parallel.
+ (C) The key is normally derived from a random seed and the tensor name, thus identical
+     across processes; the default constructor generates a random (non-reproducible) key.
 **/
 
 #ifndef EXATN_NUMERICS_FUNCTOR_INIT_RND_HPP_
@@ -18,6 +26,7 @@ Copyright (C) 2018-2019 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_method.hpp" //from TAL-SH
 
 #include <string>
+#include <cstdint>
 
 #include "errors.hpp"
 
@@ -28,7 +37,12 @@ namespace numerics{
 class FunctorInitRnd: public talsh::TensorFunctor<Identifiable>{
 public:
 
- FunctorInitRnd() = default;
+ /** Random (non-reproducible) key. **/
+ FunctorInitRnd();
+
+ /** Reproducible key derived from a random seed and a tensor name. **/
+ FunctorInitRnd(std::uint64_t seed,
+                const std::string & tensor_name);
 
  virtual ~FunctorInitRnd() = default;
 
@@ -45,12 +59,14 @@ public:
  /** Packs data members into a byte packet. **/
  virtual void pack(BytePacket & packet) override
  {
+  appendToBytePacket(&packet,key_);
   return;
  }
 
  /** Unpacks data members from a byte packet. **/
  virtual void unpack(BytePacket & packet) override
  {
+  extractFromBytePacket(&packet,key_);
   return;
  }
 
@@ -60,6 +76,9 @@ public:
      shape that both can be accessed by talsh::Tensor methods. **/
  virtual int apply(talsh::Tensor & local_tensor) override;
 
+private:
+
+ std::uint64_t key_; //random generator key
 };
 
 } //namespace numerics
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor Functor: Initialization to a scalar value
-REVISION: 2019/11/21
+REVISION: 2022/03/21
 
 Copyright (C) 2018-2019 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2019 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -47,6 +47,12 @@ public:
   return "Initializes a tensor to a scalar value";
  }
 
+ /** Returns the scalar initialization value. **/
+ std::complex<double> getValue() const
+ {
+  return init_val_;
+ }
+
  /** Packs data members into a byte packet. **/
  virtual void pack(BytePacket & packet) override
  {
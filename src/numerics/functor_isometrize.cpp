@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor Functor: Tensor Isometrization
-REVISION: 2022/01/29
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -7,23 +7,44 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "functor_isometrize.hpp"
 
 #include "tensor_range.hpp"
+#include "byte_packet_utils.hpp"
 
 #include "talshxx.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
 namespace exatn{
 
 namespace numerics{
 
 void FunctorIsometrize::pack(BytePacket & packet)
 {
- //`Finish
+ const std::size_t size1 = isometry1_.size();
+ appendToBytePacket(&packet,size1);
+ appendArrayToBytePacket(&packet,isometry1_.data(),size1);
+ const std::size_t size2 = isometry2_.size();
+ appendToBytePacket(&packet,size2);
+ appendArrayToBytePacket(&packet,isometry2_.data(),size2);
+ appendToBytePacket(&packet,static_cast<int>(method_));
  return;
 }
 
 
 void FunctorIsometrize::unpack(BytePacket & packet)
 {
- //`Finish
+ std::size_t size1 = 0;
+ extractFromBytePacket(&packet,size1);
+ isometry1_.resize(size1);
+ extractArrayFromBytePacket(&packet,isometry1_.data(),size1);
+ std::size_t size2 = 0;
+ extractFromBytePacket(&packet,size2);
+ isometry2_.resize(size2);
+ extractArrayFromBytePacket(&packet,isometry2_.data(),size2);
+ int method = 0;
+ extractFromBytePacket(&packet,method);
+ method_ = static_cast<IsometrizeMethod>(method);
  return;
 }
 
@@ -41,6 +62,110 @@ inline std::complex<NumericType> conjugated(std::complex<NumericType> value)
 }
 
 
+//Accumulation type of the Gram matrix (double precision):
+template <typename NumericType>
+struct GramType{using type = double;};
+
+template <typename NumericType>
+struct GramType<std::complex<NumericType>>{using type = std::complex<double>;};
+
+
+/** Orthonormalizes the columns of a column-major matrix buf[volx,voly] in place
+    by the modified Gram-Schmidt procedure. **/
+template <typename NumericType>
+void gram_schmidt(NumericType * buf, DimExtent volx, DimExtent voly)
+{
+ for(DimOffset j = 0; j < voly; ++j){
+  double nrm2 = 0.0;
+  for(DimOffset i = 0; i < volx; ++i){
+   const auto elem = std::abs(buf[volx*j + i]);
+   nrm2 += elem * elem;
+  }
+  nrm2 = std::sqrt(nrm2);
+  for(DimOffset i = 0; i < volx; ++i){
+   buf[volx*j + i] /= NumericType(nrm2);
+  }
+  for(DimOffset k = j+1; k < voly; ++k){
+   NumericType dpr(0.0);
+   for(DimOffset i = 0; i < volx; ++i){
+    dpr += conjugated(buf[volx*j + i]) * buf[volx*k + i];
+   }
+   for(DimOffset i = 0; i < volx; ++i){
+    buf[volx*k + i] -= dpr * buf[volx*j + i];
+   }
+  }
+ }
+ return;
+}
+
+
+/** Orthonormalizes the columns of a column-major matrix buf[volx,voly] in place
+    by a single CholeskyQR step. Returns FALSE if the Gram matrix is not (numerically)
+    positive definite, in which case the matrix is left intact. **/
+template <typename NumericType>
+bool cholesky_qr(NumericType * buf, DimExtent volx, DimExtent voly)
+{
+ using AccType = typename GramType<NumericType>::type;
+ const DimExtent tile = FunctorIsometrize::TILE_SIZE;
+ const DimExtent row_block = FunctorIsometrize::ROW_BLOCK_SIZE;
+ //Gram matrix G = X^H * X (upper triangle, column-major), tile by tile:
+ std::vector<AccType> gram(voly*voly,AccType(0.0));
+ const DimExtent num_tiles = (voly + tile - 1) / tile;
+ std::vector<std::pair<DimExtent,DimExtent>> tiles; //{column tile k, column tile j}: k <= j
+ for(DimExtent jb = 0; jb < num_tiles; ++jb){
+  for(DimExtent kb = 0; kb <= jb; ++kb) tiles.emplace_back(std::make_pair(kb,jb));
+ }
+#pragma omp parallel for schedule(dynamic)
+ for(std::size_t t = 0; t < tiles.size(); ++t){
+  const DimOffset k0 = tiles[t].first * tile, k1 = std::min(k0 + tile,voly);
+  const DimOffset j0 = tiles[t].second * tile, j1 = std::min(j0 + tile,voly);
+  for(DimOffset i0 = 0; i0 < volx; i0 += row_block){
+   const DimOffset i1 = std::min(i0 + row_block,volx);
+   for(DimOffset j = j0; j < j1; ++j){
+    const NumericType * xj = &(buf[volx*j]);
+    const DimOffset kend = std::min(k1,j+1);
+    for(DimOffset k = k0; k < kend; ++k){
+     const NumericType * xk = &(buf[volx*k]);
+     AccType dpr(0.0);
+     for(DimOffset i = i0; i < i1; ++i) dpr += conjugated(AccType(xk[i])) * AccType(xj[i]);
+     gram[voly*j + k] += dpr;
+    }
+   }
+  }
+ }
+ //Cholesky factorization G = R^H * R (R is upper triangular, stored in place of G):
+ for(DimOffset j = 0; j < voly; ++j){
+  for(DimOffset k = 0; k < j; ++k){
+   AccType sum = gram[voly*j + k];
+   for(DimOffset l = 0; l < k; ++l) sum -= conjugated(gram[voly*k + l]) * gram[voly*j + l];
+   gram[voly*j + k] = sum / gram[voly*k + k];
+  }
+  double diag = std::real(gram[voly*j + j]);
+  const double diag_scale = diag;
+  for(DimOffset l = 0; l < j; ++l) diag -= std::norm(gram[voly*j + l]);
+  if(!(diag > diag_scale * std::numeric_limits<double>::epsilon())) return false;
+  gram[voly*j + j] = AccType(std::sqrt(diag));
+ }
+ //Triangular solve X = X * R^(-1), row block by row block:
+ const DimExtent num_row_blocks = (volx + row_block - 1) / row_block;
+#pragma omp parallel for schedule(static)
+ for(DimOffset b = 0; b < num_row_blocks; ++b){
+  const DimOffset i0 = b * row_block, i1 = std::min(i0 + row_block,volx);
+  for(DimOffset j = 0; j < voly; ++j){
+   NumericType * xj = &(buf[volx*j]);
+   for(DimOffset k = 0; k < j; ++k){
+    const NumericType * xk = &(buf[volx*k]);
+    const auto rkj = static_cast<NumericType>(gram[voly*j + k]);
+    for(DimOffset i = i0; i < i1; ++i) xj[i] -= xk[i] * rkj;
+   }
+   const auto rjj_inv = static_cast<NumericType>(1.0 / std::real(gram[voly*j + j]));
+   for(DimOffset i = i0; i < i1; ++i) xj[i] *= rjj_inv;
+  }
+ }
+ return true;
+}
+
+
 int FunctorIsometrize::apply(talsh::Tensor & local_tensor) //tensor slice (in general)
 {
  unsigned int tens_rank;
@@ -100,27 +225,13 @@ int FunctorIsometrize::apply(talsh::Tensor & local_tensor) //tensor slice (in ge
     rngy.next();
    }
 
-   //Modified Gram-Schmidt procedure:
-   for(DimOffset j = 0; j < voly; ++j){
-    double nrm2 = 0.0;
-    for(DimOffset i = 0; i < volx; ++i){
-     const auto elem = std::abs(buf[volx*j + i]);
-     nrm2 += elem * elem;
-    }
-    nrm2 = std::sqrt(nrm2);
-    for(DimOffset i = 0; i < volx; ++i){
-     buf[volx*j + i] /= tensor_body_type(nrm2);
-    }
-    for(DimOffset k = j+1; k < voly; ++k){
-     tensor_body_type dpr(0.0);
-     for(DimOffset i = 0; i < volx; ++i){
-      dpr += conjugated(buf[volx*j + i]) * buf[volx*k + i];
-     }
-     for(DimOffset i = 0; i < volx; ++i){
-      buf[volx*k + i] -= dpr * buf[volx*j + i];
-     }
-    }
+   //Orthonormalization (CholeskyQR2 or modified Gram-Schmidt):
+   bool orthonormalized = false;
+   if(method_ == IsometrizeMethod::CHOLESKY_QR2 && voly <= volx){
+    orthonormalized = cholesky_qr(buf,volx,voly);
+    if(orthonormalized) orthonormalized = cholesky_qr(buf,volx,voly);
    }
+   if(!orthonormalized) gram_schmidt(buf,volx,voly);
 
    //Copy the result back into the tensor:
    rngy.reset();
@@ -1,12 +1,21 @@
 /** ExaTN::Numerics: Tensor Functor: Tensor Isometrization
-REVISION: 2022/01/28
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
- (A) This tensor functor (method) performs the modified Gram-Schmidt
-     procedure on a tensor in order to enforce its isometries.
+ (A) This tensor functor (method) orthonormalizes a tensor matricized over its
+     isometric dimensions (rows) in order to enforce its isometries.
+ (B) The default orthonormalization is CholeskyQR2: The Gram matrix X^H*X is
+     accumulated (in double precision) tile by tile in cache-sized row blocks,
+     Cholesky-factorized (X^H*X = R^H*R) and the columns are orthonormalized by
+     the row-parallel triangular solve X = X*R^(-1), the whole step being repeated
+     twice to reach the orthogonality of Householder QR. Unlike the modified
+     Gram-Schmidt (MGS) procedure, which is a sequence of memory-bound vector
+     operations, CholeskyQR2 is dominated by (multithreaded) matrix-matrix products.
+     If the Gram matrix is numerically singular (ill-conditioned tensor), the MGS
+     procedure is used instead.
 **/
 
 #ifndef EXATN_NUMERICS_FUNCTOR_ISOMETRIZE_HPP_
@@ -21,6 +30,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <string>
 #include <vector>
 #include <complex>
+#include <cstddef>
 
 #include "errors.hpp"
 
@@ -28,18 +38,30 @@ namespace exatn{
 
 namespace numerics{
 
+/** Orthonormalization algorithm used to enforce tensor isometries. **/
+enum class IsometrizeMethod{
+ MGS,         //modified Gram-Schmidt
+ CHOLESKY_QR2 //CholeskyQR2 (falls back to MGS if ill-conditioned)
+};
+
+
 class FunctorIsometrize: public talsh::TensorFunctor<Identifiable>{
 public:
 
- FunctorIsometrize(const std::vector<unsigned int> & isometry1):
-  isometry1_(isometry1)
+ static constexpr std::size_t TILE_SIZE = 32;       //column tile size of the Gram matrix (CholeskyQR2)
+ static constexpr std::size_t ROW_BLOCK_SIZE = 256; //row block size of the Gram matrix and triangular solve (CholeskyQR2)
+
+ FunctorIsometrize(const std::vector<unsigned int> & isometry1,
+                   IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2):
+  isometry1_(isometry1), method_(method)
  {
   for(int i = 1; i < isometry1_.size(); ++i) assert(isometry1_[i] > isometry1_[i-1]);
  }
 
  FunctorIsometrize(const std::vector<unsigned int> & isometry1,
-                   const std::vector<unsigned int> & isometry2):
-  isometry1_(isometry1), isometry2_(isometry2)
+                   const std::vector<unsigned int> & isometry2,
+                   IsometrizeMethod method = IsometrizeMethod::CHOLESKY_QR2):
+  isometry1_(isometry1), isometry2_(isometry2), method_(method)
  {
   for(int i = 1; i < isometry1_.size(); ++i) assert(isometry1_[i] > isometry1_[i-1]);
   for(int i = 1; i < isometry2_.size(); ++i) assert(isometry2_[i] > isometry2_[i-1]);
@@ -63,16 +85,23 @@ public:
  /** Unpacks data members from a byte packet. **/
  virtual void unpack(BytePacket & packet) override;
 
- /** Initializes the local tensor slice with external data.
+ /** Enforces the isometry of the local tensor slice.
      Returns zero on success, or an error code otherwise.
      The talsh::Tensor slice is identified by its signature and
      shape that both can be accessed by talsh::Tensor methods. **/
  virtual int apply(talsh::Tensor & local_tensor) override;
 
+ /** Returns the orthonormalization algorithm. **/
+ IsometrizeMethod getMethod() const
+ {
+  return method_;
+ }
+
 private:
 
  std::vector<unsigned int> isometry1_;
  std::vector<unsigned int> isometry2_;
+ IsometrizeMethod method_; //orthonormalization algorithm
 };
 
 } //namespace numerics
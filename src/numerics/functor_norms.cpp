@@ -0,0 +1,86 @@
+/** ExaTN::Numerics: Tensor Functor: Computes 1-norm, 2-norm and max-abs norm of a tensor in one pass
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "functor_norms.hpp"
+
+#include "talshxx.hpp"
+
+#include <complex>
+#include <algorithm>
+
+namespace exatn{
+
+namespace numerics{
+
+namespace{
+
+template <typename T>
+inline double squared_modulus(const T & value){
+ return static_cast<double>(value) * static_cast<double>(value);
+}
+
+template <typename T>
+inline double squared_modulus(const std::complex<T> & value){
+ return static_cast<double>(value.real()) * static_cast<double>(value.real())
+      + static_cast<double>(value.imag()) * static_cast<double>(value.imag());
+}
+
+} //namespace
+
+
+int FunctorNorms::apply(talsh::Tensor & local_tensor)
+{
+ const auto tensor_volume = local_tensor.getVolume();
+ auto access_granted = false;
+
+ auto norms_func = [&](const auto * tensor_body){
+  double norm1 = 0.0, norm2 = 0.0, max_abs = 0.0;
+#pragma omp parallel for simd schedule(static) reduction(+:norm1,norm2) reduction(max:max_abs)
+  for(std::size_t i = 0; i < tensor_volume; ++i){
+   const double sqmod = squared_modulus(tensor_body[i]);
+   const double absval = std::sqrt(sqmod);
+   norm1 += absval;
+   norm2 += sqmod;
+   max_abs = std::max(max_abs,absval);
+  }
+  const std::lock_guard<std::mutex> lock(mutex_);
+  partial_norms_[0] += norm1;
+  partial_norms_[1] += norm2;
+  partial_norms_[2] = std::max(partial_norms_[2],max_abs);
+  return 0;
+ };
+
+ {//Try REAL32:
+  const float * body;
+  access_granted = local_tensor.getDataAccessHostConst(&body);
+  if(access_granted) return norms_func(body);
+ }
+
+ {//Try REAL64:
+  const double * body;
+  access_granted = local_tensor.getDataAccessHostConst(&body);
+  if(access_granted) return norms_func(body);
+ }
+
+ {//Try COMPLEX32:
+  const std::complex<float> * body;
+  access_granted = local_tensor.getDataAccessHostConst(&body);
+  if(access_granted) return norms_func(body);
+ }
+
+ {//Try COMPLEX64:
+  const std::complex<double> * body;
+  access_granted = local_tensor.getDataAccessHostConst(&body);
+  if(access_granted) return norms_func(body);
+ }
+
+ std::cout << "#ERROR(exatn::numerics::FunctorNorms): Unknown data kind in talsh::Tensor!" << std::endl;
+ return 1;
+}
+
+} //namespace numerics
+
+} //namespace exatn
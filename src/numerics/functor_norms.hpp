@@ -0,0 +1,106 @@
+/** ExaTN::Numerics: Tensor Functor: Computes 1-norm, 2-norm and max-abs norm of a tensor in one pass
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) This tensor functor (method) computes the 1-norm, the 2-norm and the max-abs norm
+     of a tensor in a single multithreaded, vectorized pass over the tensor body
+     (the absolute value of a complex element is computed from its squared modulus,
+     avoiding the overflow-safe but slow std::abs). The partial norms of multiple
+     local tensor slices are accumulated; unlike FunctorNorm1/FunctorNorm2/FunctorMaxAbs,
+     the accumulation is serialized per functor, not across all functors.
+ (B) The accumulated partial norms are exposed as {sum |x|, sum |x|^2, max |x|},
+     such that the partial norms of many tensors can be reduced across processes
+     by a single collective.
+**/
+
+#ifndef EXATN_NUMERICS_FUNCTOR_NORMS_HPP_
+#define EXATN_NUMERICS_FUNCTOR_NORMS_HPP_
+
+#include "Identifiable.hpp"
+
+#include "tensor_basic.hpp"
+#include "byte_packet_utils.hpp"
+
+#include "tensor_method.hpp" //from TAL-SH
+
+#include <string>
+#include <array>
+#include <cmath>
+#include <mutex>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class FunctorNorms: public talsh::TensorFunctor<Identifiable>{
+public:
+
+ /** Partial norms: {sum |x|, sum |x|^2, max |x|}. **/
+ using PartialNorms = std::array<double,3>;
+
+ FunctorNorms(): partial_norms_{0.0,0.0,0.0} {}
+
+ virtual ~FunctorNorms() = default;
+
+ virtual const std::string name() const override
+ {
+  return "TensorFunctorNorms";
+ }
+
+ virtual const std::string description() const override
+ {
+  return "Computes 1-norm, 2-norm and max-abs norm of a tensor";
+ }
+
+ /** Packs data members into a byte packet. **/
+ virtual void pack(BytePacket & packet) override
+ {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  appendArrayToBytePacket(&packet,partial_norms_.data(),partial_norms_.size());
+  return;
+ }
+
+ /** Unpacks data members from a byte packet. **/
+ virtual void unpack(BytePacket & packet) override
+ {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  extractArrayFromBytePacket(&packet,partial_norms_.data(),partial_norms_.size());
+  return;
+ }
+
+ /** Accumulates the partial norms of a tensor slice. Returns zero on success,
+     or an error code otherwise. The talsh::Tensor slice is identified by its
+     signature and shape that both can be accessed by talsh::Tensor methods. **/
+ virtual int apply(talsh::Tensor & local_tensor) override;
+
+ /** Returns the accumulated partial norms. **/
+ PartialNorms getPartialNorms() const {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return partial_norms_;
+ }
+
+ /** Returns the tensor 1-norm. **/
+ double getNorm1() const {return getPartialNorms()[0];}
+
+ /** Returns the tensor 2-norm. **/
+ double getNorm2() const {return std::sqrt(getPartialNorms()[1]);}
+
+ /** Returns the tensor max-abs norm. **/
+ double getMaxAbs() const {return getPartialNorms()[2];}
+
+private:
+
+ PartialNorms partial_norms_; //accumulated partial norms
+ mutable std::mutex mutex_;
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_FUNCTOR_NORMS_HPP_
@@ -1,10 +1,11 @@
 /** ExaTN::Numerics: Tensor Functor: Prints a tensor to a file or standard output
-REVISION: 2020/12/04
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "functor_print.hpp"
+#include "functor_init_file.hpp"
 
 #include "tensor_range.hpp"
 
@@ -12,13 +13,15 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <cstdint>
 
 namespace exatn{
 
 namespace numerics{
 
-FunctorPrint::FunctorPrint(const std::string & filename):
- filename_(filename)
+FunctorPrint::FunctorPrint(const std::string & filename, bool binary):
+ filename_(filename), binary_(binary)
 {
 }
 
@@ -28,6 +31,7 @@ void FunctorPrint::pack(BytePacket & packet)
  unsigned int filename_len = filename_.length();
  appendToBytePacket(&packet,filename_len);
  while(filename_len > 0) appendToBytePacket(&packet,filename_[--filename_len]);
+ appendToBytePacket(&packet,binary_);
  return;
 }
 
@@ -42,6 +46,7 @@ void FunctorPrint::unpack(BytePacket & packet)
  }else{
   filename_.clear();
  }
+ extractFromBytePacket(&packet,binary_);
  return;
 }
 
@@ -54,7 +59,61 @@ int FunctorPrint::apply(talsh::Tensor & local_tensor) //tensor slice (in general
  const auto & offsets = local_tensor.getDimOffsets(); //base offsets of the given tensor slice
  const auto element_type = local_tensor.getElementType(); //tensor element type
 
+ auto write_func = [&](auto * tensor_body){
+  std::ofstream tensor_file(filename_,std::fstream::out|std::fstream::binary|std::fstream::trunc);
+  if(!tensor_file.is_open()){
+   std::cout << "#ERROR(exatn::numerics::FunctorPrint): Output failed!" << std::endl << std::flush;
+   return 2;
+  }
+  auto write_value = [&tensor_file](auto value){
+   tensor_file.write(reinterpret_cast<const char*>(&value),sizeof(value));
+  };
+  BinaryTensorElem elem_type = BinaryTensorElem::REAL32;
+  std::size_t elem_size = sizeof(float);
+  if(element_type == talsh::REAL64){
+   elem_type = BinaryTensorElem::REAL64; elem_size = sizeof(double);
+  }else if(element_type == talsh::COMPLEX32){
+   elem_type = BinaryTensorElem::COMPLEX32; elem_size = sizeof(std::complex<float>);
+  }else if(element_type == talsh::COMPLEX64){
+   elem_type = BinaryTensorElem::COMPLEX64; elem_size = sizeof(std::complex<double>);
+  }
+  //Header:
+  tensor_file.write(BINARY_TENSOR_FILE_MAGIC,sizeof(BINARY_TENSOR_FILE_MAGIC)-1);
+  write_value(static_cast<std::uint32_t>(elem_type));
+  write_value(static_cast<std::uint32_t>(rank));
+  write_value(static_cast<std::uint64_t>(1)); //single block
+  for(unsigned int i = 0; i < rank; ++i) write_value(static_cast<std::uint64_t>(extents[i]));
+  for(unsigned int i = 0; i < rank; ++i) write_value(static_cast<std::uint64_t>(offsets[i]));
+  //Block index:
+  for(unsigned int i = 0; i < rank; ++i) write_value(static_cast<std::uint64_t>(offsets[i]));
+  for(unsigned int i = 0; i < rank; ++i) write_value(static_cast<std::uint64_t>(extents[i]));
+  std::uint64_t body_pos = (sizeof(BINARY_TENSOR_FILE_MAGIC) - 1) + 2 * sizeof(std::uint32_t)
+                         + (3 * rank + 2) * sizeof(std::uint64_t);
+  const std::uint64_t padding = (BINARY_TENSOR_FILE_ALIGNMENT - body_pos % BINARY_TENSOR_FILE_ALIGNMENT)
+                              % BINARY_TENSOR_FILE_ALIGNMENT;
+  body_pos += padding;
+  write_value(body_pos);
+  //Block body:
+  const std::vector<char> zeros(padding,'\0');
+  tensor_file.write(zeros.data(),padding);
+  tensor_file.write(reinterpret_cast<const char*>(tensor_body),tensor_volume*elem_size);
+  const bool success = tensor_file.good();
+  tensor_file.close();
+  if(!success){
+   std::cout << "#ERROR(exatn::numerics::FunctorPrint): Output failed!" << std::endl << std::flush;
+   return 2;
+  }
+  return 0;
+ };
+
  auto print_func = [&](auto * tensor_body){
+  if(binary_ && filename_.length() > 0){
+   if(!hostIsLittleEndian()){
+    std::cout << "#ERROR(exatn::numerics::FunctorPrint): Binary tensor files require a little-endian host!" << std::endl << std::flush;
+    return 3;
+   }
+   return write_func(tensor_body);
+  }
   std::ofstream tensor_file;
   std::ostream * output = nullptr;
   if(filename_.length() > 0){
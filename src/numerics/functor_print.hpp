@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor Functor: Prints a tensor to a file or standard output
-REVISION: 2020/12/04
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (A) This tensor functor (method) is used to print a Tensor
@@ -14,6 +14,8 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
       Tensor elements:
        Dense format: Numeric values (column-wise order), any number of values per line
        List format: Numeric value and Multi-index in each line
+ (B) Alternatively, the tensor can be printed to a file in the binary format
+     (see functor_init_file.hpp) as a single block covering the local tensor slice.
 **/
 
 #ifndef EXATN_NUMERICS_FUNCTOR_PRINT_HPP_
@@ -39,7 +41,8 @@ class FunctorPrint: public talsh::TensorFunctor<Identifiable>{
 public:
 
  FunctorPrint() = default;
- FunctorPrint(const std::string & filename); //in: output file name
+ FunctorPrint(const std::string & filename, //in: output file name
+              bool binary = false);         //in: binary (true) or text (false) file format
 
  virtual ~FunctorPrint() = default;
 
@@ -68,6 +71,7 @@ public:
 private:
 
  std::string filename_; //file name (empty means standard output
+ bool binary_ = false;  //binary file format
 };
 
 } //namespace numerics
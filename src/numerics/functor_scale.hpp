@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor Functor: Scaling a tensor by a scalar
-REVISION: 2019/11/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2019 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2019 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (A) This tensor functor (method) is used to scale a tensor by a scalar.
@@ -68,6 +68,12 @@ public:
      shape that both can be accessed by talsh::Tensor methods. **/
  virtual int apply(talsh::Tensor & local_tensor) override;
 
+ /** Returns the scaling value. **/
+ std::complex<double> getValue() const
+ {
+  return scale_val_;
+ }
+
 private:
 
  std::complex<double> scale_val_; //scalar scaling value
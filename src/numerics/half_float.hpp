@@ -0,0 +1,112 @@
+/** ExaTN::Numerics: Half-precision (IEEE binary16) storage type
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Float16 is a storage-only IEEE binary16 number: It is converted from single
+     precision with rounding to the nearest even and converted back to single
+     precision exactly. No arithmetic is performed in half precision: Tensors
+     with the REAL16/COMPLEX16 element type are computed in single precision
+     (with single-precision accumulation), whereas their elements are stored
+     in half precision whenever they leave the processing backend (collective
+     communication, checkpoint files), halving the transferred volume.
+ (b) ComplexFloat16 is a pair of Float16 numbers (real, imaginary) with the memory
+     layout of std::complex, which cannot be instantiated with a non-floating type.
+**/
+
+#ifndef EXATN_NUMERICS_HALF_FLOAT_HPP_
+#define EXATN_NUMERICS_HALF_FLOAT_HPP_
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+
+namespace exatn{
+
+namespace numerics{
+
+class Float16{
+public:
+
+ Float16() = default;
+
+ Float16(float value): bits_(fromFloat(value)) {}
+
+ operator float() const {return toFloat(bits_);}
+
+ /** Returns the binary16 bit pattern. **/
+ std::uint16_t getBits() const {return bits_;}
+
+ /** Converts a single-precision number into a binary16 bit pattern (round to nearest even). **/
+ static std::uint16_t fromFloat(float value)
+ {
+  std::uint32_t x;
+  std::memcpy(&x,&value,sizeof(x));
+  const std::uint16_t sign = static_cast<std::uint16_t>((x >> 16) & 0x8000U);
+  const std::uint32_t abs = x & 0x7FFFFFFFU;
+  if(abs >= 0x7F800000U) return sign | ((abs > 0x7F800000U) ? 0x7E00U : 0x7C00U); //NaN or infinity
+  if(abs >= 0x477FF000U) return sign | 0x7C00U; //overflow: rounds to infinity
+  if(abs < 0x38800000U){ //subnormal binary16 or zero
+   if(abs < 0x33000000U) return sign; //rounds to zero
+   const std::uint32_t shift = 126U - (abs >> 23);
+   const std::uint32_t mant = (abs & 0x7FFFFFU) | 0x800000U;
+   std::uint32_t h = mant >> shift;
+   const std::uint32_t rem = mant & ((1U << shift) - 1U);
+   const std::uint32_t halfway = 1U << (shift - 1U);
+   if(rem > halfway || (rem == halfway && (h & 1U))) ++h;
+   return sign | static_cast<std::uint16_t>(h);
+  }
+  std::uint32_t h = (abs - 0x38000000U) >> 13; //rebias the exponent
+  const std::uint32_t rem = abs & 0x1FFFU;
+  if(rem > 0x1000U || (rem == 0x1000U && (h & 1U))) ++h; //carry may round up to infinity
+  return sign | static_cast<std::uint16_t>(h);
+ }
+
+ /** Converts a binary16 bit pattern into a single-precision number (exact). **/
+ static float toFloat(std::uint16_t h)
+ {
+  const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000U) << 16;
+  std::uint32_t expo = (h >> 10) & 0x1FU;
+  std::uint32_t mant = h & 0x3FFU;
+  std::uint32_t x = sign;
+  if(expo == 0){
+   if(mant != 0){ //subnormal binary16: normalize
+    expo = 113;
+    while((mant & 0x400U) == 0){mant <<= 1; --expo;}
+    x |= (expo << 23) | ((mant & 0x3FFU) << 13);
+   }
+  }else if(expo == 0x1FU){
+   x |= 0x7F800000U | (mant << 13); //infinity or NaN
+  }else{
+   x |= ((expo + 112U) << 23) | (mant << 13);
+  }
+  float value;
+  std::memcpy(&value,&x,sizeof(value));
+  return value;
+ }
+
+private:
+
+ std::uint16_t bits_; //binary16 bit pattern
+};
+
+
+struct ComplexFloat16{
+
+ ComplexFloat16() = default;
+
+ ComplexFloat16(const std::complex<float> & value): real(value.real()), imag(value.imag()) {}
+
+ operator std::complex<float>() const {return std::complex<float>(real,imag);}
+
+ Float16 real; //real part
+ Float16 imag; //imaginary part
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_HALF_FLOAT_HPP_
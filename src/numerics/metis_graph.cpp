@@ -1,12 +1,13 @@
 /** ExaTN::Numerics: Graph k-way partitioning via METIS
-REVISION: 2021/04/01
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "metis_graph.hpp"
 
 #include "tensor_network.hpp"
+#include "tensor_network_flat.hpp"
 
 #include <iostream>
 #include <unordered_map>
@@ -46,69 +47,67 @@ MetisGraph::MetisGraph():
 
 
 MetisGraph::MetisGraph(const TensorNetwork & network):
+ MetisGraph(TensorNetworkFlat(network))
+{
+}
+
+
+MetisGraph::MetisGraph(const TensorNetworkFlat & network):
  MetisGraph()
 {
- //Map tensor Ids to a consecutive integer range [0..N-1], N is the number of input tensors:
- std::unordered_map<unsigned int, unsigned int> tensor_id_map; //tensor_id --> vertex_id [0..N-1]
- unsigned int vertex_id = 0;
- for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
-  if(iter->first != 0){ //ignore the output tensor
-   renumber_.emplace_back(iter->first); //new vertex id --> old tensor id
-   auto res = tensor_id_map.emplace(std::make_pair(iter->first,vertex_id++)); //old tensor id --> new vertex id
-   assert(res.second);
-  }
- }
+ //Input tensors are already densely numerated by vertices [1..N] of the flat connectivity:
+ const std::size_t num_tensors = network.getNumTensors();
+ renumber_.reserve(num_tensors);
+ for(std::size_t vertex = 1; vertex <= num_tensors; ++vertex) renumber_.emplace_back(network.getTensorId(vertex)); //vertex id --> tensor id
  //Generate the adjacency list:
  auto cmp = [](std::pair<unsigned int, DimExtent> & a,
                std::pair<unsigned int, DimExtent> & b){return (a.first < b.first);};
- for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
-  if(iter->first != 0){ //ignore the output tensor (it is not a real vertex of the graph)
-   const auto tensor_rank = iter->second.getRank();
-   const auto & tensor_dims = iter->second.getDimExtents();
-   const auto & tensor_legs = iter->second.getTensorLegs();
-   std::vector<std::pair<unsigned int, DimExtent>> edges(tensor_rank); //vertex edges
-   for(unsigned int i = 0; i < tensor_rank; ++i){
-    edges[i] = std::pair<unsigned int, DimExtent>{tensor_legs[i].getTensorId(), //connected tensor id
-                                                  tensor_dims[i]}; //edge dimension
-   }
-   //Remap tensor id to the vertex id:
-   std::sort(edges.begin(),edges.end(),cmp); //order adjacent tensors by their Ids
-   std::size_t adj_vertices[tensor_rank], edge_weights[tensor_rank];
-   std::size_t vertex_weight = 1; //default vertex weight (if no open edges)
-   unsigned int first_vertex_pos = tensor_rank;
-   for(unsigned int i = 0; i < tensor_rank; ++i){
-    if(edges[i].first == 0){ //connections to the output tensor are not counted as edges
-     vertex_weight *= edges[i].second; //they are absorbed into the vertex weight
-    }else{
-     if(first_vertex_pos == tensor_rank) first_vertex_pos = i; //position of the first real edge
-     edges[i].first = tensor_id_map[edges[i].first]; //adjacent tensor id --> adjacent vertex id
-    }
+ std::vector<std::pair<unsigned int, DimExtent>> edges; //vertex edges
+ std::vector<std::size_t> adj_vertices, edge_weights;
+ for(std::size_t vertex = 1; vertex <= num_tensors; ++vertex){
+  const auto tensor_rank = network.getRank(vertex);
+  const auto * tensor_dims = network.getLegExtents(vertex);
+  const auto * tensor_legs = network.getLegVertices(vertex);
+  edges.resize(tensor_rank);
+  for(unsigned int i = 0; i < tensor_rank; ++i){
+   edges[i] = std::pair<unsigned int, DimExtent>{network.getTensorId(tensor_legs[i]), //connected tensor id
+                                                 tensor_dims[i]}; //edge dimension
+  }
+  //Remap tensor id to the vertex id:
+  std::sort(edges.begin(),edges.end(),cmp); //order adjacent tensors by their Ids
+  adj_vertices.resize(tensor_rank); edge_weights.resize(tensor_rank);
+  std::size_t vertex_weight = 1; //default vertex weight (if no open edges)
+  unsigned int first_vertex_pos = tensor_rank;
+  for(unsigned int i = 0; i < tensor_rank; ++i){
+   if(edges[i].first == 0){ //connections to the output tensor are not counted as edges
+    vertex_weight *= edges[i].second; //they are absorbed into the vertex weight
+   }else{
+    if(first_vertex_pos == tensor_rank) first_vertex_pos = i; //position of the first real edge
+    edges[i].first = network.getVertex(edges[i].first) - 1; //adjacent tensor id --> adjacent vertex id
    }
-   //Compute edge weights and adjacency list:
-   std::size_t num_edges = 0;
-   std::size_t edge_weight = 1;
-   int current_vertex = -1;
-   for(int i = first_vertex_pos; i < tensor_rank; ++i){ //consider only real edges
-    if(edges[i].first != current_vertex){
-     if(current_vertex >= 0){ //record previous edge
-      adj_vertices[num_edges] = current_vertex;
-      //edge_weights[num_edges++] = edge_weight;
-      edge_weights[num_edges++] = static_cast<std::size_t>(std::log2(static_cast<double>(edge_weight))) + 1; //weight is always shifted by one
-     }
-     current_vertex = edges[i].first;
-     edge_weight = edges[i].second;
-    }else{
-     edge_weight *= edges[i].second;
+  }
+  //Compute edge weights and adjacency list:
+  std::size_t num_edges = 0;
+  std::size_t edge_weight = 1;
+  int current_vertex = -1;
+  for(int i = first_vertex_pos; i < tensor_rank; ++i){ //consider only real edges
+   if(edges[i].first != current_vertex){
+    if(current_vertex >= 0){ //record previous edge
+     adj_vertices[num_edges] = current_vertex;
+     edge_weights[num_edges++] = static_cast<std::size_t>(std::log2(static_cast<double>(edge_weight))) + 1; //weight is always shifted by one
     }
+    current_vertex = edges[i].first;
+    edge_weight = edges[i].second;
+   }else{
+    edge_weight *= edges[i].second;
    }
-   if(current_vertex >= 0){ //record last edge
-    adj_vertices[num_edges] = current_vertex;
-    //edge_weights[num_edges++] = edge_weight;
-    edge_weights[num_edges++] = static_cast<std::size_t>(std::log2(static_cast<double>(edge_weight))) + 1; //weight is always shifted by one
-   }
-   vertex_weight = static_cast<std::size_t>(std::log2(static_cast<double>(vertex_weight))) + 1; //weight is always shifted by one
-   appendVertex(num_edges,adj_vertices,edge_weights,vertex_weight);
   }
+  if(current_vertex >= 0){ //record last edge
+   adj_vertices[num_edges] = current_vertex;
+   edge_weights[num_edges++] = static_cast<std::size_t>(std::log2(static_cast<double>(edge_weight))) + 1; //weight is always shifted by one
+  }
+  vertex_weight = static_cast<std::size_t>(std::log2(static_cast<double>(vertex_weight))) + 1; //weight is always shifted by one
+  appendVertex(num_edges,adj_vertices.data(),edge_weights.data(),vertex_weight);
  }
 }
 
@@ -205,23 +204,23 @@ void MetisGraph::pack(BytePacket & byte_packet) const
  //renumber_:
  std::size_t length = renumber_.size();
  appendToBytePacket(&byte_packet,length);
- for(std::size_t i = 0; i < length; ++i) appendToBytePacket(&byte_packet,renumber_[i]);
+ appendArrayToBytePacket(&byte_packet,renumber_.data(),length);
  //xadj_:
  length = xadj_.size();
  appendToBytePacket(&byte_packet,length);
- for(std::size_t i = 0; i < length; ++i) appendToBytePacket(&byte_packet,xadj_[i]);
+ appendArrayToBytePacket(&byte_packet,xadj_.data(),length);
  //adjncy_:
  length = adjncy_.size();
  appendToBytePacket(&byte_packet,length);
- for(std::size_t i = 0; i < length; ++i) appendToBytePacket(&byte_packet,adjncy_[i]);
+ appendArrayToBytePacket(&byte_packet,adjncy_.data(),length);
  //vwgt_:
  length = vwgt_.size();
  appendToBytePacket(&byte_packet,length);
- for(std::size_t i = 0; i < length; ++i) appendToBytePacket(&byte_packet,vwgt_[i]);
+ appendArrayToBytePacket(&byte_packet,vwgt_.data(),length);
  //adjwgt_:
  length = adjwgt_.size();
  appendToBytePacket(&byte_packet,length);
- for(std::size_t i = 0; i < length; ++i) appendToBytePacket(&byte_packet,adjwgt_[i]);
+ appendArrayToBytePacket(&byte_packet,adjwgt_.data(),length);
  return;
 }
 
@@ -234,23 +233,23 @@ void MetisGraph::unpack(BytePacket & byte_packet)
  std::size_t length = 0;
  extractFromBytePacket(&byte_packet,length);
  renumber_.resize(length);
- for(std::size_t i = 0; i < length; ++i) extractFromBytePacket(&byte_packet,renumber_[i]);
+ extractArrayFromBytePacket(&byte_packet,renumber_.data(),length);
  //xadj_:
  extractFromBytePacket(&byte_packet,length);
  xadj_.resize(length);
- for(std::size_t i = 0; i < length; ++i) extractFromBytePacket(&byte_packet,xadj_[i]);
+ extractArrayFromBytePacket(&byte_packet,xadj_.data(),length);
  //adjncy_:
  extractFromBytePacket(&byte_packet,length);
  adjncy_.resize(length);
- for(std::size_t i = 0; i < length; ++i) extractFromBytePacket(&byte_packet,adjncy_[i]);
+ extractArrayFromBytePacket(&byte_packet,adjncy_.data(),length);
  //vwgt_:
  extractFromBytePacket(&byte_packet,length);
  vwgt_.resize(length);
- for(std::size_t i = 0; i < length; ++i) extractFromBytePacket(&byte_packet,vwgt_[i]);
+ extractArrayFromBytePacket(&byte_packet,vwgt_.data(),length);
  //adjwgt_:
  extractFromBytePacket(&byte_packet,length);
  adjwgt_.resize(length);
- for(std::size_t i = 0; i < length; ++i) extractFromBytePacket(&byte_packet,adjwgt_[i]);
+ extractArrayFromBytePacket(&byte_packet,adjwgt_.data(),length);
  return;
 }
 
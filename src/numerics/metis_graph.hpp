@@ -26,6 +26,7 @@ namespace exatn{
 namespace numerics{
 
 class TensorNetwork;
+class TensorNetworkFlat;
 
 
 class MetisGraph: public Packable {
@@ -50,6 +51,10 @@ public:
      aggregated into the vertex/edge weight logarithmically. **/
  MetisGraph(const TensorNetwork & network); //in: tensor network
 
+ /** Constructs a graph from the flat connectivity of an existing tensor network
+     (same as above, the flat connectivity just avoids traversing the tensor network). **/
+ MetisGraph(const TensorNetworkFlat & network); //in: flat connectivity of a tensor network
+
  /** Constructs a graph from a given partition of a larger graph.
      The open edges are aggregated into the weights of incident vertices. **/
  MetisGraph(const MetisGraph & parent, //in: partitioned parental graph
@@ -1,20 +1,21 @@
 /** ExaTN::Numerics: Tensor network builder: MPS: Matrix Product State
-REVISION: 2021/10/07
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "network_builder_mps.hpp"
 #include "tensor_network.hpp"
 
 #include <initializer_list>
+#include <vector>
 
 namespace exatn{
 
 namespace numerics{
 
 NetworkBuilderMPS::NetworkBuilderMPS():
- max_bond_dim_(1)
+ max_bond_dim_(1), canonical_center_(-1)
 {
 }
 
@@ -24,6 +25,8 @@ bool NetworkBuilderMPS::getParameter(const std::string & name, long long * value
  bool found = true;
  if(name == "max_bond_dim"){
   *value = max_bond_dim_;
+ }else if(name == "canonical_center"){
+  *value = canonical_center_;
  }else{
   found = false;
  }
@@ -36,6 +39,8 @@ bool NetworkBuilderMPS::setParameter(const std::string & name, long long value)
  bool found = true;
  if(name == "max_bond_dim"){
   max_bond_dim_ = value;
+ }else if(name == "canonical_center"){
+  canonical_center_ = value;
  }else{
   found = false;
  }
@@ -157,6 +162,26 @@ void NetworkBuilderMPS::build(TensorNetwork & network, bool tensor_operator)
    tensor.rename(generateTensorName(tensor,"t"));
   }
  }
+ //Register isometries of the canonical form (if specified):
+ if(!tensor_operator && canonical_center_ >= 0 && output_tensor_rank > 1){
+  for(unsigned int i = 0; i < output_tensor_rank; ++i){
+   if(i == canonical_center_) continue; //orthogonality center is not isometric
+   const unsigned int bond_tensor_id = (i < canonical_center_) ? (i + 2) : i; //neighbor towards the center
+   auto tens = network.getTensor(1+i);
+   const auto & legs = network.getTensorConn(1+i)->getTensorLegs();
+   std::vector<unsigned int> iso_dims;
+   DimExtent iso_vol = 1, bond_vol = 1;
+   for(unsigned int j = 0; j < legs.size(); ++j){
+    if(legs[j].getTensorId() == bond_tensor_id){
+     bond_vol *= tens->getDimExtent(j);
+    }else{
+     iso_dims.emplace_back(j);
+     iso_vol *= tens->getDimExtent(j);
+    }
+   }
+   if(iso_vol >= bond_vol) tens->registerIsometry(iso_dims);
+  }
+ }
  if(tensor_operator){
   for(unsigned int i = 0; i < output_tensor_rank; ++i){
    auto * tens_conn = network.getTensorConn(1+i);
@@ -1,13 +1,15 @@
 /** ExaTN::Numerics: Tensor network builder: MPS: Matrix Product State
-REVISION: 2021/10/14
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Builds a matrix product state tensor network:
      Parameters:
      * max_bond_dim: Maximal internal bond dimension;
+     * canonical_center: >=0: Site of the orthogonality center of the mixed canonical form,
+                         <0: No canonical form (default);
  (b) Leg numeration (tensor network vector):
 
      [0]    [1]    [2]         [n-2]  [n-1]
@@ -25,6 +27,13 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
       2      3      3            3      2
      [n]   [n+1]  [n+2]       [n*2-2][n*2-1]
 
+ (d) Mixed canonical form (tensor network vector only): All tensors to the left
+     of the orthogonality center are registered as left-isometric (all legs except
+     the right bond), all tensors to the right of it as right-isometric (all legs
+     except the left bond). The registered isometries are enforced by ExaTN on every
+     tensor update, thus the canonical form is maintained automatically, and the norm,
+     overlaps and environments of the MPS collapse to local contractions around
+     the orthogonality center (see TensorNetwork::collapseIsometries).
 **/
 
 #ifndef EXATN_NUMERICS_NETWORK_BUILDER_MPS_HPP_
@@ -71,7 +80,8 @@ public:
 
 private:
 
- long long max_bond_dim_; //maximal internal bond dimension
+ long long max_bond_dim_;     //maximal internal bond dimension
+ long long canonical_center_; //orthogonality center of the mixed canonical form (<0: none)
 };
 
 } //namespace numerics
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor network builder: Tree: Tree Tensor Network
-REVISION: 2022/02/04
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -16,7 +16,7 @@ namespace exatn{
 namespace numerics{
 
 NetworkBuilderTTN::NetworkBuilderTTN():
- max_bond_dim_(1), arity_(2), num_states_(1), isometric_(0)
+ max_bond_dim_(1), arity_(2), num_states_(1), isometric_(0), canonical_(0)
 {
 }
 
@@ -32,6 +32,8 @@ bool NetworkBuilderTTN::getParameter(const std::string & name, long long * value
   *value = num_states_;
  }else if(name == "isometric"){
   *value = isometric_;
+ }else if(name == "canonical"){
+  *value = canonical_;
  }else{
   found = false;
  }
@@ -50,6 +52,8 @@ bool NetworkBuilderTTN::setParameter(const std::string & name, long long value)
   num_states_ = value;
  }else if(name == "isometric"){
   isometric_ = value;
+ }else if(name == "canonical"){
+  canonical_ = value;
  }else{
   found = false;
  }
@@ -152,7 +156,8 @@ void NetworkBuilderTTN::build(TensorNetwork & network, bool tensor_operator)
    tree_root_id = new_tensor_id; //assumes the last appended tensor is the root
    tree_root_dim = tens_rank - end_decr;
    //Register isometries (if specified):
-   if(isometric_ != 0){
+   const bool tree_root = (num_dims <= arity_);
+   if(isometric_ != 0 || (canonical_ != 0 && !tree_root)){
     std::vector<unsigned int> iso_dims(tens->getRank() - end_decr);
     unsigned int k = 0;
     for(unsigned int i = 0; i < (tens_rank - end_decr); ++i) iso_dims[k++] = i;
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor network builder: Tree: Tree Tensor Network
-REVISION: 2022/02/04
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -10,6 +10,8 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
      * arity: >1: Tree arity;
      * num_states: >0: Number of quantum states to represent;
      * isometric: {0/1}: Whether or not all tensor factors should be isometric;
+     * canonical: {0/1}: Whether or not all tensor factors except the tree root should be
+                         isometric (canonical form with the orthogonality center at the root);
  (b) Leg numeration with arity 2 (tensor network vector):
 
     [0] [1]      [2] [3] ...
@@ -36,6 +38,11 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
  (d) If the desired number of represented quantum states is greater than 1,
      an open leg will be added to the root tensor as well, with dimension equal
      to the number of states. It will be appended to the end of the output tensor.
+ (e) In the canonical form, each non-root tensor is isometric over its child legs,
+     whereas the tree root is an unconstrained orthogonality center. The registered
+     isometries are enforced by ExaTN on every tensor update, thus the canonical form
+     is maintained automatically, and the norm and overlaps of the tree tensor network
+     collapse to the contraction of the tree root with its conjugate.
 **/
 
 #ifndef EXATN_NUMERICS_NETWORK_BUILDER_TTN_HPP_
@@ -86,6 +93,7 @@ private:
  long long arity_;         //tree arity
  unsigned int num_states_; //number of quantum states to represent
  int isometric_;           //isometry
+ int canonical_;           //canonical form (orthogonality center at the root)
 };
 
 } //namespace numerics
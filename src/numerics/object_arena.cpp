@@ -0,0 +1,112 @@
+/** ExaTN::Numerics: Arena for short-lived numerical objects
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "object_arena.hpp"
+
+#include <new>
+#include <cstdint>
+#include <cassert>
+
+namespace exatn{
+
+namespace numerics{
+
+//Each allocated object is preceded by a pointer to its chunk:
+struct ObjectArena::Chunk{
+ char * data;             //chunk buffer
+ std::size_t capacity;    //chunk buffer size in bytes
+ std::size_t offset;      //first free byte in the chunk buffer
+ std::size_t num_objects; //number of live objects allocated from the chunk
+};
+
+
+std::shared_ptr<ObjectArena> ObjectArena::create(std::size_t chunk_size)
+{
+ return std::shared_ptr<ObjectArena>(new ObjectArena(chunk_size));
+}
+
+ObjectArena::ObjectArena(std::size_t chunk_size):
+ chunk_size_(chunk_size), current_(nullptr), num_chunks_(0), num_objects_(0)
+{
+ assert(chunk_size_ > 0);
+}
+
+ObjectArena::~ObjectArena()
+{
+ assert(num_objects_ == 0); //all objects keep the arena alive via their allocators
+ if(current_ != nullptr) freeChunk(current_);
+}
+
+void ObjectArena::startChunk(std::size_t min_size)
+{
+ const std::size_t capacity = (min_size > chunk_size_) ? min_size : chunk_size_;
+ auto * chunk = new Chunk{nullptr,capacity,0,0};
+ chunk->data = static_cast<char*>(::operator new(capacity));
+ if(current_ != nullptr){
+  if(current_->num_objects == 0) freeChunk(current_); //otherwise freed by its last object
+ }
+ current_ = chunk;
+ ++num_chunks_;
+ return;
+}
+
+void ObjectArena::freeChunk(Chunk * chunk)
+{
+ ::operator delete(chunk->data);
+ delete chunk;
+ --num_chunks_;
+ return;
+}
+
+void * ObjectArena::allocate(std::size_t size,
+                             std::size_t alignment)
+{
+ if(alignment < alignof(Chunk*)) alignment = alignof(Chunk*);
+ const std::size_t max_size = sizeof(Chunk*) + alignment + size; //worst case footprint
+ std::lock_guard<std::mutex> lock(lock_);
+ if(current_ == nullptr || current_->offset + max_size > current_->capacity) startChunk(max_size);
+ auto base = reinterpret_cast<std::uintptr_t>(current_->data + current_->offset + sizeof(Chunk*));
+ base = (base + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+ auto * ptr = reinterpret_cast<char*>(base);
+ *(reinterpret_cast<Chunk**>(ptr - sizeof(Chunk*))) = current_;
+ current_->offset = (ptr + size) - current_->data;
+ ++(current_->num_objects);
+ ++num_objects_;
+ return ptr;
+}
+
+void ObjectArena::deallocate(void * ptr)
+{
+ if(ptr == nullptr) return;
+ auto * chunk = *(reinterpret_cast<Chunk**>(static_cast<char*>(ptr) - sizeof(Chunk*)));
+ std::lock_guard<std::mutex> lock(lock_);
+ assert(chunk->num_objects > 0);
+ --num_objects_;
+ if(--(chunk->num_objects) == 0){
+  if(chunk == current_){
+   chunk->offset = 0; //reuse the current chunk from the beginning
+  }else{
+   freeChunk(chunk);
+  }
+ }
+ return;
+}
+
+std::size_t ObjectArena::getNumChunks() const
+{
+ std::lock_guard<std::mutex> lock(lock_);
+ return num_chunks_;
+}
+
+std::size_t ObjectArena::getNumObjects() const
+{
+ std::lock_guard<std::mutex> lock(lock_);
+ return num_objects_;
+}
+
+} //namespace numerics
+
+} //namespace exatn
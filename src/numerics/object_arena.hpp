@@ -0,0 +1,123 @@
+/** ExaTN::Numerics: Arena for short-lived numerical objects
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) An object arena hands out memory for many small short-lived objects
+     (tensor slices, per-slice tensor operations) from large chunks via bump
+     allocation. Individual deallocations do not return memory; instead,
+     a chunk is freed as a whole once all objects allocated from it have
+     been released (and the chunk is no longer the current one). Objects
+     created together, for example for the same tensor sub-network, are
+     thus freed in bulk when the tensor runtime retires them.
+ (b) An object arena is always owned by std::shared_ptr: ArenaAllocator keeps
+     its arena alive, thus objects created via std::allocate_shared with
+     an ArenaAllocator may safely outlive all other references to the arena.
+ (c) Allocation and deallocation are thread-safe: Objects are normally created
+     by the submitting thread and released by the tensor runtime threads.
+**/
+
+#ifndef EXATN_NUMERICS_OBJECT_ARENA_HPP_
+#define EXATN_NUMERICS_OBJECT_ARENA_HPP_
+
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+namespace exatn{
+
+namespace numerics{
+
+class ObjectArena{
+public:
+
+ static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024; //bytes
+
+ /** Creates a new object arena. **/
+ static std::shared_ptr<ObjectArena> create(std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+ ObjectArena(const ObjectArena &) = delete;
+ ObjectArena & operator=(const ObjectArena &) = delete;
+ ObjectArena(ObjectArena &&) noexcept = delete;
+ ObjectArena & operator=(ObjectArena &&) noexcept = delete;
+ ~ObjectArena();
+
+ /** Allocates memory for an object of the given size and alignment. **/
+ void * allocate(std::size_t size,
+                 std::size_t alignment);
+
+ /** Releases memory previously allocated from this arena. **/
+ void deallocate(void * ptr);
+
+ /** Returns the number of currently allocated (live) chunks. **/
+ std::size_t getNumChunks() const;
+
+ /** Returns the number of currently live objects. **/
+ std::size_t getNumObjects() const;
+
+private:
+
+ struct Chunk;
+
+ explicit ObjectArena(std::size_t chunk_size);
+
+ /** Starts a new current chunk able to hold at least the given number of bytes. **/
+ void startChunk(std::size_t min_size);
+
+ /** Frees a chunk. **/
+ void freeChunk(Chunk * chunk);
+
+ mutable std::mutex lock_; //serializes access to the arena
+ std::size_t chunk_size_;  //default chunk size in bytes
+ Chunk * current_;         //current chunk (bump allocation)
+ std::size_t num_chunks_;  //number of live chunks
+ std::size_t num_objects_; //number of live objects
+};
+
+
+/** Standard allocator drawing memory from an object arena (for std::allocate_shared). **/
+template<typename T>
+class ArenaAllocator{
+public:
+
+ using value_type = T;
+
+ explicit ArenaAllocator(std::shared_ptr<ObjectArena> arena) noexcept: arena_(std::move(arena)) {}
+
+ template<typename U>
+ ArenaAllocator(const ArenaAllocator<U> & another) noexcept: arena_(another.getArena()) {}
+
+ T * allocate(std::size_t n){
+  return static_cast<T*>(arena_->allocate(n * sizeof(T),alignof(T)));
+ }
+
+ void deallocate(T * ptr, std::size_t n) noexcept{
+  arena_->deallocate(ptr);
+ }
+
+ const std::shared_ptr<ObjectArena> & getArena() const noexcept{
+  return arena_;
+ }
+
+private:
+
+ std::shared_ptr<ObjectArena> arena_; //object arena (shared ownership)
+};
+
+template<typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> & lhs, const ArenaAllocator<U> & rhs) noexcept{
+ return (lhs.getArena() == rhs.getArena());
+}
+
+template<typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> & lhs, const ArenaAllocator<U> & rhs) noexcept{
+ return !(lhs == rhs);
+}
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_OBJECT_ARENA_HPP_
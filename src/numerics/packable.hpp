@@ -1,13 +1,14 @@
 /** ExaTN: Packable interface
-REVISION: 2020/06/25
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #ifndef EXATN_PACKABLE_HPP_
 #define EXATN_PACKABLE_HPP_
 
 #include "byte_packet.h"
+#include "byte_packet_utils.hpp"
 
 namespace exatn {
 
@@ -0,0 +1,99 @@
+/** ExaTN::Numerics: Counter-based random number generator (Philox4x32-10)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Philox4x32-10 (Salmon et al., SC'11, Random123) maps a 128-bit counter and
+     a 64-bit key to 128 random bits. Unlike sequential generators, any random
+     number is computed directly from its counter, thus random tensor elements
+     can be generated in any order, by any number of threads or processes,
+     with bitwise identical results.
+ (b) The conversion to a uniform distribution on [-1,1) uses the upper 24 (float)
+     or 53 (double) random bits, thus being exact.
+**/
+
+#ifndef EXATN_NUMERICS_PHILOX_RNG_HPP_
+#define EXATN_NUMERICS_PHILOX_RNG_HPP_
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+namespace exatn{
+
+namespace numerics{
+
+class Philox4x32{
+public:
+
+ using Counter = std::array<std::uint32_t,4>;
+ using Key = std::array<std::uint32_t,2>;
+
+ explicit Philox4x32(std::uint64_t key):
+  key_{static_cast<std::uint32_t>(key),static_cast<std::uint32_t>(key >> 32)}
+ {
+ }
+
+ /** Returns 128 random bits for the given counter. **/
+ Counter operator()(Counter ctr) const
+ {
+  Key key = key_;
+  for(int round = 0; round < 10; ++round){
+   if(round > 0){key[0] += 0x9E3779B9U; key[1] += 0xBB67AE85U;}
+   const std::uint64_t prod0 = static_cast<std::uint64_t>(0xD2511F53U) * ctr[0];
+   const std::uint64_t prod1 = static_cast<std::uint64_t>(0xCD9E8D57U) * ctr[2];
+   ctr = {static_cast<std::uint32_t>(prod1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(prod1),
+          static_cast<std::uint32_t>(prod0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(prod0)};
+  }
+  return ctr;
+ }
+
+ /** Returns 128 random bits for the counter composed of two 64-bit words. **/
+ Counter operator()(std::uint64_t ctr_lo, std::uint64_t ctr_hi) const
+ {
+  return (*this)(Counter{static_cast<std::uint32_t>(ctr_lo),static_cast<std::uint32_t>(ctr_lo >> 32),
+                         static_cast<std::uint32_t>(ctr_hi),static_cast<std::uint32_t>(ctr_hi >> 32)});
+ }
+
+ /** Converts 32 random bits into a uniformly distributed float in [-1,1). **/
+ static float uniformFloat(std::uint32_t bits)
+ {
+  return static_cast<float>(bits >> 8) * (1.0f / 8388608.0f) - 1.0f; //2^-23
+ }
+
+ /** Converts 64 random bits into a uniformly distributed double in [-1,1). **/
+ static double uniformDouble(std::uint32_t bits_lo, std::uint32_t bits_hi)
+ {
+  const std::uint64_t bits = (static_cast<std::uint64_t>(bits_hi) << 32) | bits_lo;
+  return static_cast<double>(bits >> 11) * (1.0 / 4503599627370496.0) - 1.0; //2^-52
+ }
+
+ /** Mixes a 64-bit word into a 64-bit hash (SplitMix64 finalizer). **/
+ static std::uint64_t mix(std::uint64_t hash, std::uint64_t word)
+ {
+  std::uint64_t z = hash + word + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+ }
+
+ /** Returns a generator key derived from a seed and a name. **/
+ static std::uint64_t makeKey(std::uint64_t seed, const std::string & name)
+ {
+  std::uint64_t hash = 0xCBF29CE484222325ULL; //FNV-1a (stable across processes)
+  for(const char c: name){hash ^= static_cast<unsigned char>(c); hash *= 0x100000001B3ULL;}
+  return mix(seed,hash);
+ }
+
+private:
+
+ Key key_; //generator key
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_PHILOX_RNG_HPP_
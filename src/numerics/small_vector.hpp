@@ -0,0 +1,272 @@
+/** ExaTN::Numerics: Small vector with inline storage
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) SmallVector<T,N> is a sequence container with the std::vector interface subset
+     used by the numerics classes. It stores up to N elements inline (inside the object),
+     such that the common case (low-rank tensors, few tensor operands) does not touch
+     the heap at all; it switches to heap storage only when it grows beyond N elements.
+ (b) Iterators are plain pointers, thus they are invalidated by any operation which
+     changes the size of the container (or by moving the container), like the iterators
+     of std::vector upon reallocation. Moving a SmallVector with inline storage moves
+     its elements one by one.
+**/
+
+#ifndef EXATN_NUMERICS_SMALL_VECTOR_HPP_
+#define EXATN_NUMERICS_SMALL_VECTOR_HPP_
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <vector>
+
+#include <cstddef>
+#include <cassert>
+
+namespace exatn{
+
+namespace numerics{
+
+template<typename T, std::size_t N>
+class SmallVector{
+public:
+
+ static_assert(N > 0,"#FATAL(exatn::numerics::SmallVector): Inline capacity must be positive!");
+
+ using value_type = T;
+ using size_type = std::size_t;
+ using difference_type = std::ptrdiff_t;
+ using reference = T &;
+ using const_reference = const T &;
+ using pointer = T *;
+ using const_pointer = const T *;
+ using iterator = T *;
+ using const_iterator = const T *;
+
+ SmallVector() noexcept: data_(inlineData()), size_(0), capacity_(N) {}
+
+ explicit SmallVector(size_type count): SmallVector() {resize(count);}
+
+ SmallVector(size_type count, const T & value): SmallVector() {resize(count,value);}
+
+ template<typename InputIt,
+          typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+ SmallVector(InputIt first, InputIt last): SmallVector() {assign(first,last);}
+
+ SmallVector(std::initializer_list<T> init): SmallVector(init.begin(),init.end()) {}
+
+ SmallVector(const std::vector<T> & vec): SmallVector(vec.cbegin(),vec.cend()) {}
+
+ SmallVector(const SmallVector & another): SmallVector() {assign(another.cbegin(),another.cend());}
+
+ SmallVector(SmallVector && another) noexcept(std::is_nothrow_move_constructible<T>::value):
+  SmallVector()
+ {
+  stealFrom(another);
+ }
+
+ SmallVector & operator=(const SmallVector & another)
+ {
+  if(this != &another) assign(another.cbegin(),another.cend());
+  return *this;
+ }
+
+ SmallVector & operator=(SmallVector && another) noexcept(std::is_nothrow_move_constructible<T>::value)
+ {
+  if(this != &another){
+   clear();
+   releaseHeap();
+   stealFrom(another);
+  }
+  return *this;
+ }
+
+ SmallVector & operator=(std::initializer_list<T> init)
+ {
+  assign(init.begin(),init.end());
+  return *this;
+ }
+
+ ~SmallVector()
+ {
+  clear();
+  releaseHeap();
+ }
+
+ /** Element access. **/
+ reference operator[](size_type pos) {assert(pos < size_); return data_[pos];}
+ const_reference operator[](size_type pos) const {assert(pos < size_); return data_[pos];}
+ reference front() {assert(size_ > 0); return data_[0];}
+ const_reference front() const {assert(size_ > 0); return data_[0];}
+ reference back() {assert(size_ > 0); return data_[size_-1];}
+ const_reference back() const {assert(size_ > 0); return data_[size_-1];}
+ pointer data() noexcept {return data_;}
+ const_pointer data() const noexcept {return data_;}
+
+ /** Iterators. **/
+ iterator begin() noexcept {return data_;}
+ const_iterator begin() const noexcept {return data_;}
+ const_iterator cbegin() const noexcept {return data_;}
+ iterator end() noexcept {return data_ + size_;}
+ const_iterator end() const noexcept {return data_ + size_;}
+ const_iterator cend() const noexcept {return data_ + size_;}
+
+ /** Capacity. **/
+ bool empty() const noexcept {return (size_ == 0);}
+ size_type size() const noexcept {return size_;}
+ size_type capacity() const noexcept {return capacity_;}
+
+ /** Returns TRUE if the elements are stored inline (no heap storage). **/
+ bool isInline() const noexcept {return (data_ == inlineData());}
+
+ /** Reserves storage for at least the given number of elements. **/
+ void reserve(size_type new_capacity)
+ {
+  if(new_capacity <= capacity_) return;
+  T * new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+  for(size_type i = 0; i < size_; ++i){
+   new(new_data + i) T(std::move(data_[i]));
+   data_[i].~T();
+  }
+  releaseHeap();
+  data_ = new_data;
+  capacity_ = new_capacity;
+  return;
+ }
+
+ /** Modifiers. **/
+ void clear() noexcept
+ {
+  for(size_type i = 0; i < size_; ++i) data_[i].~T();
+  size_ = 0;
+  return;
+ }
+
+ template<typename InputIt>
+ void assign(InputIt first, InputIt last)
+ {
+  clear();
+  const auto count = std::distance(first,last);
+  assert(count >= 0);
+  reserve(static_cast<size_type>(count));
+  for(; first != last; ++first) new(data_ + size_++) T(*first);
+  return;
+ }
+
+ void push_back(const T & value) {emplace_back(value);}
+
+ void push_back(T && value) {emplace_back(std::move(value));}
+
+ template<typename... Args>
+ reference emplace_back(Args&&... args)
+ {
+  if(size_ < capacity_){
+   new(data_ + size_) T(std::forward<Args>(args)...);
+  }else{ //the arguments may refer to the elements of this container
+   T value(std::forward<Args>(args)...);
+   reserve(2 * capacity_);
+   new(data_ + size_) T(std::move(value));
+  }
+  return data_[size_++];
+ }
+
+ void pop_back()
+ {
+  assert(size_ > 0);
+  data_[--size_].~T();
+  return;
+ }
+
+ iterator erase(const_iterator pos)
+ {
+  assert(pos >= cbegin() && pos < cend());
+  iterator iter = data_ + (pos - data_);
+  std::move(iter + 1,end(),iter);
+  pop_back();
+  return iter;
+ }
+
+ void resize(size_type count)
+ {
+  if(count < size_){
+   while(size_ > count) pop_back();
+  }else{
+   reserve(count);
+   while(size_ < count) new(data_ + size_++) T();
+  }
+  return;
+ }
+
+ void resize(size_type count, const T & value)
+ {
+  if(count < size_){
+   while(size_ > count) pop_back();
+  }else{
+   reserve(count);
+   while(size_ < count) new(data_ + size_++) T(value);
+  }
+  return;
+ }
+
+ /** Conversion to std::vector. **/
+ std::vector<T> toVector() const {return std::vector<T>(cbegin(),cend());}
+
+ friend bool operator==(const SmallVector & lhs, const SmallVector & rhs)
+ {
+  if(lhs.size_ != rhs.size_) return false;
+  for(size_type i = 0; i < lhs.size_; ++i) if(!(lhs.data_[i] == rhs.data_[i])) return false;
+  return true;
+ }
+
+ friend bool operator!=(const SmallVector & lhs, const SmallVector & rhs)
+ {
+  return !(lhs == rhs);
+ }
+
+private:
+
+ T * inlineData() noexcept {return reinterpret_cast<T*>(&inline_[0]);}
+ const T * inlineData() const noexcept {return reinterpret_cast<const T*>(&inline_[0]);}
+
+ /** Frees the heap storage (the elements must have been destroyed). **/
+ void releaseHeap() noexcept
+ {
+  if(data_ != inlineData()){
+   ::operator delete(data_);
+   data_ = inlineData();
+   capacity_ = N;
+  }
+  return;
+ }
+
+ /** Takes over the elements of another (empty) small vector, leaving it empty. **/
+ void stealFrom(SmallVector & another) noexcept(std::is_nothrow_move_constructible<T>::value)
+ {
+  assert(size_ == 0 && data_ == inlineData());
+  if(another.isInline()){
+   for(size_type i = 0; i < another.size_; ++i) new(data_ + i) T(std::move(another.data_[i]));
+   size_ = another.size_;
+   another.clear();
+  }else{
+   data_ = another.data_; size_ = another.size_; capacity_ = another.capacity_;
+   another.data_ = another.inlineData(); another.size_ = 0; another.capacity_ = N;
+  }
+  return;
+ }
+
+ typename std::aligned_storage<sizeof(T),alignof(T)>::type inline_[N]; //inline storage
+ T * data_;           //current storage (inline or heap)
+ size_type size_;     //number of elements
+ size_type capacity_; //capacity of the current storage
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_SMALL_VECTOR_HPP_
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor
-REVISION: 2022/03/12
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -141,7 +141,7 @@ void Tensor::pack(BytePacket & byte_packet) const
 {
  const std::size_t name_len = name_.length();
  appendToBytePacket(&byte_packet,name_len);
- for(std::size_t i = 0; i < name_len; ++i) appendToBytePacket(&byte_packet,name_[i]);
+ appendArrayToBytePacket(&byte_packet,name_.data(),name_len);
  shape_.pack(byte_packet);
  signature_.pack(byte_packet);
  appendToBytePacket(&byte_packet,element_type_);
@@ -150,7 +150,7 @@ void Tensor::pack(BytePacket & byte_packet) const
  for(const auto & isometry: isometries_){
   const std::size_t num_vertices = isometry.size();
   appendToBytePacket(&byte_packet,num_vertices);
-  for(const auto & vertex_id: isometry) appendToBytePacket(&byte_packet,vertex_id);
+  appendArrayToBytePacket(&byte_packet,isometry.data(),num_vertices);
  }
  return;
 }
@@ -160,7 +160,8 @@ void Tensor::unpack(BytePacket & byte_packet)
  std::size_t name_len = 0;
  extractFromBytePacket(&byte_packet,name_len);
  name_.resize(name_len);
- for(std::size_t i = 0; i < name_len; ++i) extractFromBytePacket(&byte_packet,name_[i]);
+ if(name_len > 0) extractArrayFromBytePacket(&byte_packet,&(name_[0]),name_len);
+ name_id_ = NO_TENSOR_NAME_ID;
  shape_.unpack(byte_packet);
  signature_.unpack(byte_packet);
  extractFromBytePacket(&byte_packet,element_type_);
@@ -172,7 +173,7 @@ void Tensor::unpack(BytePacket & byte_packet)
   std::size_t num_vertices = 0;
   extractFromBytePacket(&byte_packet,num_vertices);
   isometry.resize(num_vertices);
-  for(auto & vertex_id: isometry) extractFromBytePacket(&byte_packet,vertex_id);
+  extractArrayFromBytePacket(&byte_packet,isometry.data(),num_vertices);
  }
  return;
 }
@@ -205,7 +206,7 @@ void Tensor::printIt(bool with_hash) const
  return;
 }
 
-void Tensor::printItFile(std::ofstream & output_file, bool with_hash) const
+void Tensor::printItFile(std::ostream & output_file, bool with_hash) const
 {
  if(!with_hash){
   output_file << name_;
@@ -220,12 +221,14 @@ void Tensor::printItFile(std::ofstream & output_file, bool with_hash) const
 void Tensor::rename(const std::string & name)
 {
  name_ = name;
+ name_id_ = NO_TENSOR_NAME_ID;
  return;
 }
 
 void Tensor::rename()
 {
  name_ = tensor_hex_name("",this->getTensorHash());
+ name_id_ = NO_TENSOR_NAME_ID;
  return;
 }
 
@@ -234,6 +237,12 @@ const std::string & Tensor::getName() const
  return name_;
 }
 
+TensorNameId Tensor::getNameId() const
+{
+ if(name_id_ == NO_TENSOR_NAME_ID) name_id_ = TensorNameTable::intern(name_);
+ return name_id_;
+}
+
 unsigned int Tensor::getRank() const
 {
  return shape_.getRank();
@@ -246,7 +255,7 @@ std::size_t Tensor::getVolume() const
 
 std::size_t Tensor::getSize() const
 {
- return static_cast<std::size_t>(shape_.getVolume()) * tensor_element_type_size(element_type_);
+ return static_cast<std::size_t>(shape_.getVolume()) * tensor_element_type_size(tensorComputeElementType(element_type_));
 }
 
 const TensorShape & Tensor::getShape() const
@@ -264,7 +273,7 @@ DimExtent Tensor::getDimExtent(unsigned int dim_id) const
  return shape_.getDimExtent(dim_id);
 }
 
-const std::vector<DimExtent> & Tensor::getDimExtents() const
+const DimExtentVector & Tensor::getDimExtents() const
 {
  return shape_.getDimExtents();
 }
@@ -365,6 +374,20 @@ std::shared_ptr<Tensor> Tensor::createSubtensor(const std::vector<SubspaceId> &
  return subtensor;
 }
 
+std::shared_ptr<Tensor> Tensor::createSubtensor(const std::vector<SubspaceId> & subspaces,
+                                                const std::vector<DimExtent> & dim_extents,
+                                                const ArenaAllocator<Tensor> & allocator) const
+{
+ assert(subspaces.size() == this->getRank());
+ assert(dim_extents.size() == this->getRank());
+ auto subtensor = std::allocate_shared<Tensor>(allocator,*this);
+ const auto tens_rank = subtensor->getRank();
+ for(unsigned int i = 0; i < tens_rank; ++i){
+  subtensor->replaceDimension(i,std::make_pair(this->getDimSpaceId(i),subspaces[i]),dim_extents[i]);
+ }
+ return subtensor;
+}
+
 std::vector<std::shared_ptr<Tensor>> Tensor::createSubtensors(unsigned int dim_id,
                                                               DimExtent num_segments) const
 {
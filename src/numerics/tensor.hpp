@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Abstract Tensor
-REVISION: 2022/03/12
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -40,6 +40,8 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #define EXATN_NUMERICS_TENSOR_HPP_
 
 #include "tensor_basic.hpp"
+#include "tensor_name_table.hpp"
+#include "object_arena.hpp"
 #include "packable.hpp"
 #include "tensor_shape.hpp"
 #include "tensor_signature.hpp"
@@ -140,7 +142,7 @@ public:
 
  /** Print. **/
  virtual void printIt(bool with_hash = false) const;
- virtual void printItFile(std::ofstream & output_file,
+ virtual void printItFile(std::ostream & output_file,
                           bool with_hash = false) const;
 
  /** Rename (use this method with care as it can mess up higher-level maps). **/
@@ -150,6 +152,9 @@ public:
  /** Get tensor name. **/
  const std::string & getName() const;
 
+ /** Get the interned identifier of the tensor name (cached until the tensor is renamed). **/
+ TensorNameId getNameId() const;
+
  /** Get the tensor rank (order). **/
  unsigned int getRank() const;
 
@@ -169,7 +174,7 @@ public:
  DimExtent getDimExtent(unsigned int dim_id) const;
 
  /** Get the extents of all tensor dimensions. **/
- const std::vector<DimExtent> & getDimExtents() const;
+ const DimExtentVector & getDimExtents() const;
 
  /** Get the strides for all tensor dimensions.
      Column-major tensor storage layout is assumed. **/
@@ -212,6 +217,12 @@ public:
  std::shared_ptr<Tensor> createSubtensor(const std::vector<SubspaceId> & subspaces,         //in: new defining subspaces
                                          const std::vector<DimExtent> & dim_extents) const; //in: new dimension extents
 
+ /** Creates a related tensor from a given tensor by updating its subspaces and dimension extents,
+     drawing the memory for the new tensor from an object arena. **/
+ std::shared_ptr<Tensor> createSubtensor(const std::vector<SubspaceId> & subspaces,   //in: new defining subspaces
+                                         const std::vector<DimExtent> & dim_extents,  //in: new dimension extents
+                                         const ArenaAllocator<Tensor> & allocator) const; //in: object arena allocator
+
  /** Generates subtensors from a given tensor by splitting one of its dimensions. **/
  std::vector<std::shared_ptr<Tensor>> createSubtensors(unsigned int dim_id,
                                                        DimExtent num_segments = 2) const;
@@ -248,6 +259,7 @@ protected:
  TensorSignature signature_;      //tensor signature
  TensorElementType element_type_; //tensor element type (optional)
  std::list<std::vector<unsigned int>> isometries_; //available isometries (optional)
+ mutable TensorNameId name_id_ = NO_TENSOR_NAME_ID; //cached interned identifier of the tensor name
 };
 
 
@@ -1,5 +1,5 @@
 /** ExaTN: Tensor basic types and parameters
-REVISION: 2022/01/07
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -10,6 +10,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <complex>
 
 #include <cstdint>
+#include <cstddef>
 
 namespace exatn{
 
@@ -31,6 +32,9 @@ constexpr SpaceId SOME_SPACE = 0; //any unregistered (anonymous) space (all regi
 constexpr SubspaceId FULL_SUBSPACE = 0; //every space has its trivial (full) subspace automatically registered as subspace 0
 constexpr SubspaceId UNREG_SUBSPACE = 0xFFFFFFFFFFFFFFFF; //id of any unregistered subspace
 
+constexpr std::size_t TENSOR_RANK_INLINE = 12; //tensor shapes/signatures up to this rank are stored inline (no heap)
+constexpr std::size_t TENSOR_OP_OPERANDS_INLINE = 4; //tensor operations with up to this number of operands are stored inline (no heap)
+
 //Possible types of tensor elements:
 enum class TensorElementType{
  VOID,
@@ -81,6 +85,29 @@ enum class TensorOpCode{
  ALLREDUCE          //15: tensor allreduce (parallel execution only)
 };
 
+//Latency classes (priorities) of tensor operations:
+enum class TensorOpPriority{
+ BACKGROUND = -1, //-1: background work (issued after all other ready tensor operations)
+ NORMAL = 0,      //0: default
+ INTERACTIVE = 1, //1: latency-sensitive work (small synchronous queries)
+ URGENT = 2       //2: urgent work (a client thread is blocked on it)
+};
+
+//Precision policies of tensor operations:
+enum class TensorOpPrecision{
+ DEFAULT = 0, //0: default (reduced precision only if fast math has been activated)
+ FULL = 1,    //1: full precision of the tensor element type
+ REDUCED = 2, //2: reduced precision (mixed-precision fast math, if available)
+ AUTO = 3     //3: reduced precision if the estimated error bound does not exceed the tolerance
+};
+
+//Execution device class of a tensor operation:
+enum class TensorOpDevice{
+ ANY = 0,        //0: device chosen by the node executor
+ HOST = 1,       //1: host (CPU)
+ ACCELERATOR = 2 //2: accelerator (GPU), if available
+};
+
 
 //TensorElementTypeSize<enum TensorElementType>() --> Size in bytes:
 template <TensorElementType> constexpr std::size_t TensorElementTypeSize();
@@ -105,6 +132,23 @@ inline std::size_t TensorElementTypeSize(TensorElementType element_type)
  return 0;
 }
 
+//Half-precision tensors (REAL16, COMPLEX16) are stored in half precision outside of the processing backend
+//(communication, files) but are held in memory and computed in single precision (REAL32, COMPLEX32):
+inline bool tensorElementTypeIsHalf(TensorElementType element_type)
+{
+ return (element_type == TensorElementType::REAL16 || element_type == TensorElementType::COMPLEX16);
+}
+
+inline TensorElementType tensorComputeElementType(TensorElementType element_type)
+{
+ switch(element_type){
+  case TensorElementType::REAL16: return TensorElementType::REAL32;
+  case TensorElementType::COMPLEX16: return TensorElementType::COMPLEX32;
+  default: break;
+ }
+ return element_type;
+}
+
 //TensorElementTypeOpFactor<enum TensorElementType>() --> Multiplication factor:
 template <TensorElementType> constexpr double TensorElementTypeOpFactor();
 template <> constexpr double TensorElementTypeOpFactor<TensorElementType::VOID>(){return 0.0;}
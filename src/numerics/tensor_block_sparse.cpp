@@ -0,0 +1,237 @@
+/** ExaTN::Numerics: Block-sparse symmetric tensor
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_block_sparse.hpp"
+#include "space_register.hpp"
+
+#include <algorithm>
+
+namespace exatn{
+
+namespace numerics{
+
+std::shared_ptr<Tensor> TensorBlockSparse::clone() const
+{
+ return makeSharedTensorBlockSparse(*this);
+}
+
+
+bool TensorBlockSparse::isConformantTo(const Tensor & another) const
+{
+ bool ans = isCongruentTo(another);
+ if(ans){
+  const auto * block_sparse = dynamic_cast<const TensorBlockSparse *>(&another);
+  ans = (block_sparse != nullptr);
+  if(ans){
+   ans = (dim_directions_ == block_sparse->dim_directions_ && total_charge_ == block_sparse->total_charge_ &&
+          modulus_ == block_sparse->modulus_);
+   for(unsigned int i = 0; ans && i < dim_sectors_.size(); ++i){
+    const auto & sectors0 = dim_sectors_[i];
+    const auto & sectors1 = block_sparse->dim_sectors_[i];
+    ans = (sectors0.size() == sectors1.size());
+    for(unsigned int j = 0; ans && j < sectors0.size(); ++j){
+     ans = (sectors0[j].lower == sectors1[j].lower && sectors0[j].upper == sectors1[j].upper &&
+            sectors0[j].symm_id == sectors1[j].symm_id);
+    }
+   }
+  }
+ }
+ return ans;
+}
+
+
+void TensorBlockSparse::rename(const std::string & name)
+{
+ Tensor::rename(name);
+ for(auto & kv: blocks_){
+  kv.second->rename(); //generate a unique hash-name
+  kv.second->rename(kv.second->getName() + "_" + this->getName() + "_" + std::to_string(kv.first));
+ }
+ return;
+}
+
+
+void TensorBlockSparse::rename()
+{
+ Tensor::rename();
+ for(auto & kv: blocks_){
+  kv.second->rename(); //generate a unique hash-name
+  kv.second->rename(kv.second->getName() + "_" + this->getName() + "_" + std::to_string(kv.first));
+ }
+ return;
+}
+
+
+std::shared_ptr<Tensor> TensorBlockSparse::operator[](unsigned long long block_id) const
+{
+ auto iter = blocks_.find(block_id);
+ if(iter != blocks_.end()) return iter->second;
+ return std::shared_ptr<Tensor>(nullptr);
+}
+
+
+unsigned long long TensorBlockSparse::getNumBlocksComplete() const
+{
+ unsigned long long num_blocks = 1;
+ for(const auto & sectors: dim_sectors_) num_blocks *= sectors.size();
+ return num_blocks;
+}
+
+
+unsigned long long TensorBlockSparse::getBlockId(const std::vector<unsigned int> & sectors) const
+{
+ const auto tensor_rank = getRank();
+ assert(sectors.size() == tensor_rank);
+ unsigned long long block_id = 0;
+ for(int i = tensor_rank - 1; i >= 0; --i){
+  assert(sectors[i] < dim_sectors_[i].size());
+  block_id = block_id * dim_sectors_[i].size() + sectors[i];
+ }
+ return block_id;
+}
+
+
+std::vector<unsigned int> TensorBlockSparse::getBlockSectors(unsigned long long block_id) const
+{
+ const auto tensor_rank = getRank();
+ std::vector<unsigned int> sectors(tensor_rank);
+ for(unsigned int i = 0; i < tensor_rank; ++i){
+  sectors[i] = block_id % dim_sectors_[i].size();
+  block_id /= dim_sectors_[i].size();
+ }
+ assert(block_id == 0);
+ return sectors;
+}
+
+
+bool TensorBlockSparse::isAllowedBlock(const std::vector<unsigned int> & sectors) const
+{
+ const auto tensor_rank = getRank();
+ assert(sectors.size() == tensor_rank);
+ long long charge = 0;
+ for(unsigned int i = 0; i < tensor_rank; ++i){
+  charge += static_cast<long long>(dim_directions_[i]) * dim_sectors_[i][sectors[i]].symm_id;
+ }
+ charge -= total_charge_;
+ if(modulus_ > 0) charge %= static_cast<long long>(modulus_);
+ return (charge == 0);
+}
+
+
+void TensorBlockSparse::setSectorsFromSpaces()
+{
+ auto space_reg = getSpaceRegister();
+ const auto tensor_rank = getRank();
+ dim_sectors_.resize(tensor_rank);
+ for(unsigned int i = 0; i < tensor_rank; ++i){
+  auto & sectors = dim_sectors_[i];
+  sectors.clear();
+  auto append_sector = [&sectors](DimOffset lower, DimOffset upper, SymmetryId symm_id){
+   if(!sectors.empty() && sectors.back().symm_id == symm_id){ //merge adjacent sectors with the same quantum number
+    sectors.back().upper = upper;
+   }else{
+    sectors.emplace_back(SymmetryRange{lower,upper,symm_id});
+   }
+  };
+  const DimExtent extent = getDimExtent(i);
+  const auto subspace_attr = getDimSpaceAttr(i);
+  if(subspace_attr.first != SOME_SPACE){
+   const auto * subspace = space_reg->getSubspace(subspace_attr.first,subspace_attr.second);
+   assert(subspace != nullptr);
+   const auto lower = subspace->getLowerBound();
+   const auto upper = subspace->getUpperBound();
+   auto ranges = subspace->getVectorSpace()->getSymmetrySubranges();
+   std::sort(ranges.begin(),ranges.end(),
+             [](const SymmetryRange & a, const SymmetryRange & b){return (a.lower < b.lower);});
+   DimOffset next = 0; //next uncovered basis vector relative to the subspace
+   for(const auto & range: ranges){ //intersect symmetry subranges with the subspace
+    const auto range_lower = std::max(range.lower,lower);
+    const auto range_upper = std::min(range.upper,upper);
+    if(range_lower <= range_upper && (range_lower - lower) >= next){
+     if((range_lower - lower) > next) append_sector(next,range_lower-lower-1,0); //uncovered gap
+     append_sector(range_lower-lower,range_upper-lower,range.symm_id);
+     next = range_upper - lower + 1;
+    }
+   }
+   if(next < extent) append_sector(next,extent-1,0); //uncovered remainder
+  }else{ //anonymous space has no symmetry subranges: Single sector with quantum number 0
+   sectors.emplace_back(SymmetryRange{0,extent-1,0});
+  }
+ }
+ return;
+}
+
+
+void TensorBlockSparse::generateBlocks()
+{
+ blocks_.clear();
+ stored_volume_ = 0;
+ auto space_reg = getSpaceRegister();
+ const auto tensor_rank = getRank();
+ if(tensor_rank > 0){
+  //Determine the defining subspace of each symmetry sector:
+  std::vector<std::vector<SubspaceId>> sector_subspaces(tensor_rank);
+  for(unsigned int i = 0; i < tensor_rank; ++i){
+   const auto subspace_attr = getDimSpaceAttr(i);
+   const auto num_sectors = dim_sectors_[i].size();
+   if(subspace_attr.first == SOME_SPACE){
+    for(const auto & sector: dim_sectors_[i]) sector_subspaces[i].emplace_back(subspace_attr.second + sector.lower);
+   }else if(num_sectors == 1){
+    sector_subspaces[i].emplace_back(subspace_attr.second);
+   }else{ //register named sector subspaces
+    const auto * space = space_reg->getSpace(subspace_attr.first);
+    const auto * parent = space_reg->getSubspace(subspace_attr.first,subspace_attr.second);
+    assert(space != nullptr && parent != nullptr);
+    const auto parent_lower = parent->getLowerBound();
+    for(const auto & sector: dim_sectors_[i]){
+     const std::string sector_name = "_" + parent->getName() + "_" + std::to_string(parent_lower + sector.lower)
+                                   + "_" + std::to_string(parent_lower + sector.upper);
+     const auto * child = space_reg->getSubspace(space->getName(),sector_name);
+     if(child != nullptr){
+      sector_subspaces[i].emplace_back(child->getRegisteredId());
+     }else{
+      auto id = space_reg->registerSubspace(std::make_shared<Subspace>(space,parent_lower+sector.lower,
+                                                                       parent_lower+sector.upper,sector_name));
+      assert(id != UNREG_SUBSPACE);
+      sector_subspaces[i].emplace_back(id);
+     }
+    }
+   }
+  }
+  //Iterate over all blocks and generate the allowed ones:
+  std::vector<SubspaceId> subspace_signature(tensor_rank);
+  std::vector<DimExtent> dim_extents(tensor_rank);
+  const auto num_blocks = getNumBlocksComplete();
+  for(unsigned long long block_id = 0; block_id < num_blocks; ++block_id){
+   const auto sectors = getBlockSectors(block_id);
+   if(isAllowedBlock(sectors)){
+    for(unsigned int i = 0; i < tensor_rank; ++i){
+     const auto & sector = dim_sectors_[i][sectors[i]];
+     subspace_signature[i] = sector_subspaces[i][sectors[i]];
+     dim_extents[i] = sector.upper - sector.lower + 1;
+    }
+    auto block = createSubtensor(subspace_signature,dim_extents);
+    block->rename(); //generate a unique hash-name
+    block->rename(block->getName() + "_" + this->getName() + "_" + std::to_string(block_id));
+    stored_volume_ += block->getVolume();
+    auto res = blocks_.emplace(std::make_pair(block_id,block)); assert(res.second);
+   }
+  }
+ }else{ //scalar tensor: Allowed only if the total quantum number vanishes
+  if(isAllowedBlock({})){
+   auto block = createSubtensor({},{});
+   block->rename(); //generate a unique hash-name
+   block->rename(block->getName() + "_" + this->getName() + "_0");
+   stored_volume_ = 1;
+   auto res = blocks_.emplace(std::make_pair(0ULL,block)); assert(res.second);
+  }
+ }
+ return;
+}
+
+} //namespace numerics
+
+} //namespace exatn
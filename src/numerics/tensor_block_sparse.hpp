@@ -0,0 +1,247 @@
+/** ExaTN::Numerics: Block-sparse symmetric tensor
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A block-sparse tensor is a tensor whose dimensions are decomposed
+     into symmetry sectors, that is, contiguous subranges of basis vectors
+     labeled by a quantum number (symmetry id). By default, the symmetry
+     sectors of each tensor dimension are the symmetry subranges registered
+     in its vector space (VectorSpace::getSymmetrySubranges) intersected
+     with the subspace spanned by the tensor dimension (basis vectors outside
+     of any symmetry subrange are assigned quantum number 0 and adjacent
+     sectors with the same quantum number are merged). Alternatively, they
+     can be specified explicitly relative to the beginning of each dimension,
+     in which case they must cover each tensor dimension contiguously.
+ (b) Each tensor dimension has a direction (+1 or -1). A tensor block,
+     defined by a choice of a symmetry sector in each tensor dimension,
+     is allowed if the sum of the sector quantum numbers multiplied by
+     the dimension directions is equal to the total quantum number of the tensor:
+     Exactly for the U(1) symmetry (modulus 0) or modulo N for the Z(N) symmetry
+     (modulus N, for example, Z2 for modulus 2). Only allowed blocks are stored
+     as subtensors, all other blocks are zero by symmetry.
+ (c) The blocks are identified by their integer id which linearizes the tuple of
+     the sector numbers in all tensor dimensions, with the first dimension
+     running fastest. The blocks are ordered with respect to their ids.
+ (d) A block-sparse tensor contraction executes only the pairs of stored blocks of
+     the input tensors with matching symmetry sectors of their contracted dimensions,
+     each as a dense tensor contraction into the corresponding stored output block.
+     The contracted dimensions must have the same symmetry sectors and opposite
+     directions in the left and right input tensors.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_BLOCK_SPARSE_HPP_
+#define EXATN_NUMERICS_TENSOR_BLOCK_SPARSE_HPP_
+
+#include "tensor_basic.hpp"
+#include "tensor.hpp"
+#include "space_basis.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class TensorBlockSparse : public Tensor{
+public:
+
+ /** For iterating over the stored (allowed) blocks. **/
+ using Iterator = std::map<unsigned long long, std::shared_ptr<Tensor>>::iterator;
+ using ConstIterator = std::map<unsigned long long, std::shared_ptr<Tensor>>::const_iterator;
+
+ /** Constructs a block-sparse tensor from the symmetry sectors of its dimensions.
+     If the symmetry sectors are not provided (empty), they are taken from the
+     symmetry subranges registered in the vector spaces of the tensor dimensions.
+     The bounds of the provided symmetry sectors are relative to the beginning
+     of each tensor dimension. **/
+ template<typename... Args>
+ TensorBlockSparse(const std::vector<std::vector<SymmetryRange>> & dim_sectors, //in: symmetry sectors of each tensor dimension (or empty)
+                   const std::vector<int> & dim_directions,                     //in: direction of each tensor dimension (+1 or -1)
+                   SymmetryId total_charge,                                     //in: total quantum number of the tensor
+                   unsigned int modulus,                                        //in: symmetry modulus: 0 for U(1), N for Z(N)
+                   Args&&... args);                                             //in: arguments for base Tensor ctor
+
+ TensorBlockSparse(const TensorBlockSparse & tensor) = default;
+ TensorBlockSparse & operator=(const TensorBlockSparse & tensor) = default;
+ TensorBlockSparse(TensorBlockSparse && tensor) noexcept = default;
+ TensorBlockSparse & operator=(TensorBlockSparse && tensor) noexcept = default;
+ virtual ~TensorBlockSparse() = default;
+
+ virtual std::shared_ptr<Tensor> clone() const override;
+
+ /** Returns TRUE if the tensor is congruent to another tensor and it is
+     also a block-sparse tensor with the same symmetry sectors, dimension
+     directions, total quantum number and symmetry modulus. **/
+ virtual bool isConformantTo(const Tensor & another) const override;
+
+ /** Renames the block-sparse tensor and all its stored blocks. **/
+ virtual void rename(const std::string & name) override;
+ virtual void rename() override; //a unique tensor name will be generated automatically via tensor hash
+
+ inline Iterator begin() {return blocks_.begin();}
+ inline Iterator end() {return blocks_.end();}
+ inline ConstIterator cbegin() {return blocks_.cbegin();}
+ inline ConstIterator cend() {return blocks_.cend();}
+ inline ConstIterator begin() const {return blocks_.cbegin();}
+ inline ConstIterator end() const {return blocks_.cend();}
+
+ /** Returns a stored block associated with a given block id,
+     or nullptr if the block is forbidden by symmetry. **/
+ std::shared_ptr<Tensor> operator[](unsigned long long block_id) const;
+
+ /** Returns the number of symmetry sectors in a given tensor dimension. **/
+ inline unsigned int getNumSectors(unsigned int dimensn) const;
+
+ /** Returns the symmetry sectors of a given tensor dimension
+     (bounds are relative to the beginning of the tensor dimension). **/
+ inline const std::vector<SymmetryRange> & getSectors(unsigned int dimensn) const;
+
+ /** Returns the direction of a given tensor dimension (+1 or -1). **/
+ inline int getDimDirection(unsigned int dimensn) const;
+
+ /** Returns the total quantum number of the tensor. **/
+ inline SymmetryId getTotalCharge() const;
+
+ /** Returns the symmetry modulus (0 for U(1), N for Z(N)). **/
+ inline unsigned int getModulus() const;
+
+ /** Returns the total number of blocks (allowed and forbidden). **/
+ unsigned long long getNumBlocksComplete() const;
+
+ /** Returns the number of stored (allowed) blocks. **/
+ inline unsigned long long getNumBlocks() const;
+
+ /** Returns the total volume of the stored blocks (number of stored tensor elements). **/
+ inline DimExtent getStoredVolume() const;
+
+ /** Returns the block id for given symmetry sector numbers in all tensor dimensions. **/
+ unsigned long long getBlockId(const std::vector<unsigned int> & sectors) const;
+
+ /** Returns the symmetry sector numbers in all tensor dimensions for a given block id. **/
+ std::vector<unsigned int> getBlockSectors(unsigned long long block_id) const;
+
+ /** Returns TRUE if the block with given symmetry sector numbers is allowed by symmetry. **/
+ bool isAllowedBlock(const std::vector<unsigned int> & sectors) const;
+
+protected:
+
+ std::vector<std::vector<SymmetryRange>> dim_sectors_; //symmetry sectors of each tensor dimension
+ std::vector<int> dim_directions_;                     //direction of each tensor dimension (+1 or -1)
+ SymmetryId total_charge_;                             //total quantum number of the tensor
+ unsigned int modulus_;                                //symmetry modulus: 0 for U(1), N for Z(N)
+ std::map<unsigned long long, std::shared_ptr<Tensor>> blocks_; //stored (allowed) blocks identified by their block ids
+
+private:
+
+ /** Sets the symmetry sectors of tensor dimensions from their vector spaces. **/
+ void setSectorsFromSpaces();
+
+ /** Generates all allowed blocks. **/
+ void generateBlocks();
+
+ DimExtent stored_volume_; //total volume of the stored blocks
+};
+
+
+//TEMPLATE DEFINITIONS:
+
+template<typename... Args>
+TensorBlockSparse::TensorBlockSparse(const std::vector<std::vector<SymmetryRange>> & dim_sectors,
+                                     const std::vector<int> & dim_directions,
+                                     SymmetryId total_charge,
+                                     unsigned int modulus,
+                                     Args&&... args):
+ Tensor(std::forward<Args>(args)...),
+ dim_sectors_(dim_sectors), dim_directions_(dim_directions),
+ total_charge_(total_charge), modulus_(modulus), stored_volume_(0)
+{
+ const auto tensor_rank = Tensor::getRank();
+ if(dim_sectors_.empty()) setSectorsFromSpaces();
+ assert(dim_sectors_.size() == tensor_rank);
+ assert(dim_directions_.size() == tensor_rank);
+ for(unsigned int i = 0; i < tensor_rank; ++i){
+  assert(dim_directions_[i] == 1 || dim_directions_[i] == -1);
+  assert(!(dim_sectors_[i].empty()));
+  DimOffset next = 0;
+  for(const auto & sector: dim_sectors_[i]){ //sectors must tile the tensor dimension
+   assert(sector.lower == next && sector.upper >= sector.lower);
+   next = sector.upper + 1;
+  }
+  assert(next == getDimExtent(i));
+ }
+ generateBlocks();
+}
+
+
+inline unsigned int TensorBlockSparse::getNumSectors(unsigned int dimensn) const
+{
+ assert(dimensn < getRank());
+ return dim_sectors_[dimensn].size();
+}
+
+
+inline const std::vector<SymmetryRange> & TensorBlockSparse::getSectors(unsigned int dimensn) const
+{
+ assert(dimensn < getRank());
+ return dim_sectors_[dimensn];
+}
+
+
+inline int TensorBlockSparse::getDimDirection(unsigned int dimensn) const
+{
+ assert(dimensn < getRank());
+ return dim_directions_[dimensn];
+}
+
+
+inline SymmetryId TensorBlockSparse::getTotalCharge() const
+{
+ return total_charge_;
+}
+
+
+inline unsigned int TensorBlockSparse::getModulus() const
+{
+ return modulus_;
+}
+
+
+inline unsigned long long TensorBlockSparse::getNumBlocks() const
+{
+ return blocks_.size();
+}
+
+
+inline DimExtent TensorBlockSparse::getStoredVolume() const
+{
+ return stored_volume_;
+}
+
+} //namespace numerics
+
+
+/** Creates a new TensorBlockSparse as a shared pointer to the base Tensor. **/
+template<typename... Args>
+inline std::shared_ptr<numerics::Tensor> makeSharedTensorBlockSparse(Args&&... args)
+{
+ return std::shared_ptr<numerics::Tensor>{new numerics::TensorBlockSparse(std::forward<Args>(args)...)};
+}
+
+
+/** Downcasts a Tensor as TensorBlockSparse if it is TensorBlockSparse, otherwise returns nullptr. **/
+inline std::shared_ptr<numerics::TensorBlockSparse> castTensorBlockSparse(std::shared_ptr<numerics::Tensor> tensor)
+{
+ return std::dynamic_pointer_cast<numerics::TensorBlockSparse>(tensor);
+}
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_BLOCK_SPARSE_HPP_
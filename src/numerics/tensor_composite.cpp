@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Composite tensor
-REVISION: 2021/08/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_composite.hpp"
 #include "tensor_symbol.hpp"
@@ -68,22 +68,14 @@ void TensorComposite::packTensorComposite(BytePacket & byte_packet) const
  //Member split_dims_:
  unsigned int n = split_dims_.size();
  appendToBytePacket(&byte_packet,n);
- for(unsigned int i = 0; i < n; ++i){
-  appendToBytePacket(&byte_packet,split_dims_[i].first);
-  appendToBytePacket(&byte_packet,split_dims_[i].second);
- }
+ appendArrayToBytePacket(&byte_packet,split_dims_.data(),n);
  //Member dim_depth_:
  n = dim_depth_.size();
  appendToBytePacket(&byte_packet,n);
- for(unsigned int i = 0; i < n; ++i){
-  appendToBytePacket(&byte_packet,dim_depth_[i]);
- }
+ appendArrayToBytePacket(&byte_packet,dim_depth_.data(),n);
  //Member num_bisections_ & bisect_bits_:
  appendToBytePacket(&byte_packet,num_bisections_);
- for(unsigned int i = 0; i < num_bisections_; ++i){
-  appendToBytePacket(&byte_packet,bisect_bits_[i].first);
-  appendToBytePacket(&byte_packet,bisect_bits_[i].second);
- }
+ appendArrayToBytePacket(&byte_packet,bisect_bits_.data(),num_bisections_);
  //Member subtensors_:
  unsigned long long num_subtensors = subtensors_.size();
  appendToBytePacket(&byte_packet,num_subtensors);
@@ -101,23 +93,15 @@ void TensorComposite::unpackTensorComposite(BytePacket & byte_packet)
  unsigned int n;
  extractFromBytePacket(&byte_packet,n);
  split_dims_.resize(n);
- for(unsigned int i = 0; i < n; ++i){
-  extractFromBytePacket(&byte_packet,split_dims_[i].first);
-  extractFromBytePacket(&byte_packet,split_dims_[i].second);
- }
+ extractArrayFromBytePacket(&byte_packet,split_dims_.data(),n);
  //Member dim_depth_:
  extractFromBytePacket(&byte_packet,n);
  dim_depth_.resize(n);
- for(unsigned int i = 0; i < n; ++i){
-  extractFromBytePacket(&byte_packet,dim_depth_[i]);
- }
+ extractArrayFromBytePacket(&byte_packet,dim_depth_.data(),n);
  //Member num_bisections_ & bisect_bits_:
  extractFromBytePacket(&byte_packet,num_bisections_);
  bisect_bits_.resize(num_bisections_);
- for(unsigned int i = 0; i < num_bisections_; ++i){
-  extractFromBytePacket(&byte_packet,bisect_bits_[i].first);
-  extractFromBytePacket(&byte_packet,bisect_bits_[i].second);
- }
+ extractArrayFromBytePacket(&byte_packet,bisect_bits_.data(),num_bisections_);
  //Member subtensors_:
  subtensors_.clear();
  unsigned long long num_subtensors;
@@ -176,7 +160,7 @@ bool TensorComposite::isConformantTo(const Tensor & another) const
 
 void TensorComposite::rename(const std::string & name)
 {
- name_ = name;
+ Tensor::rename(name);
  for(auto & kv: subtensors_){
   kv.second->rename(); //generate a unique hash-name
   kv.second->rename(kv.second->getName() + "_" + this->getName() + "_" + std::to_string(kv.first));
@@ -187,7 +171,7 @@ void TensorComposite::rename(const std::string & name)
 
 void TensorComposite::rename()
 {
- name_ = tensor_hex_name("",this->getTensorHash());
+ Tensor::rename();
  for(auto & kv: subtensors_){
   kv.second->rename(); //generate a unique hash-name
   kv.second->rename(kv.second->getName() + "_" + this->getName() + "_" + std::to_string(kv.first));
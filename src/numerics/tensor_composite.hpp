@@ -101,6 +101,8 @@ public:
  inline Iterator end() {return subtensors_.end();}
  inline ConstIterator cbegin() {return subtensors_.cbegin();}
  inline ConstIterator cend() {return subtensors_.cend();}
+ inline ConstIterator begin() const {return subtensors_.cbegin();}
+ inline ConstIterator end() const {return subtensors_.cend();}
 
  /** Returns a subtensor associated with a given bit-string (integer id),
      or nullptr if no such subtensor exists. **/
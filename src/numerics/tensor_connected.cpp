@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor connected to other tensors inside a tensor network
-REVISION: 2022/01/28
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -32,7 +32,7 @@ void TensorConn::printIt(bool with_hash) const
  return;
 }
 
-void TensorConn::printItFile(std::ofstream & output_file,
+void TensorConn::printItFile(std::ostream & output_file,
                              bool with_hash) const
 {
  output_file << id_ << ": ";
@@ -103,7 +103,7 @@ const std::vector<TensorLeg> & TensorConn::getTensorLegs() const
  return legs_;
 }
 
-const std::vector<DimExtent> & TensorConn::getDimExtents() const
+const DimExtentVector & TensorConn::getDimExtents() const
 {
  return tensor_->getDimExtents();
 }
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor connected to other tensors in a tensor network
-REVISION: 2022/01/28
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -53,7 +53,7 @@ public:
 
  /** Prints. **/
  void printIt(bool with_hash = false) const;
- void printItFile(std::ofstream & output_file,
+ void printItFile(std::ostream & output_file,
                   bool with_hash = false) const;
 
  /** Returns the tensor name. **/
@@ -88,7 +88,7 @@ public:
  const std::vector<TensorLeg> & getTensorLegs() const;
 
  /** Returns the tensor dimension extents. **/
- const std::vector<DimExtent> & getDimExtents() const;
+ const DimExtentVector & getDimExtents() const;
 
  /** Returns the dimension extent of a specific tensor leg. **/
  DimExtent getDimExtent(unsigned int dim_id) const;
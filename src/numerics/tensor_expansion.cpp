@@ -1,11 +1,12 @@
 /** ExaTN::Numerics: Tensor network expansion
-REVISION: 2022/03/12
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_expansion.hpp"
 
+#include <unordered_map>
 #include <algorithm>
 
 namespace exatn{
@@ -23,26 +24,16 @@ TensorExpansion::TensorExpansion(const std::string & name,
 
 
 TensorExpansion::TensorExpansion(const TensorExpansion & expansion,       //in: tensor network expansion in some tensor space
-                                 const TensorOperator & tensor_operator): //in: tensor network operator
- ket_(expansion.isKet())
+                                 const TensorOperator & tensor_operator,  //in: tensor network operator
+                                 bool conjugated):                        //in: whether or not the tensor network expansion enters complex conjugated
+ ket_(expansion.isKet() != conjugated)
 {
  bool appended;
  for(auto term = expansion.cbegin(); term != expansion.cend(); ++term){
+  const auto term_coefficient = conjugated ? std::conj(term->coefficient) : term->coefficient;
   for(auto oper = tensor_operator.cbegin(); oper != tensor_operator.cend(); ++oper){
-   auto product = std::make_shared<TensorNetwork>(*(term->network));
-   if(ket_){
-    appended = product->appendTensorNetwork(TensorNetwork(*(oper->network)),oper->ket_legs);
-    assert(appended);
-    appended = reorderProductLegs(*product,oper->bra_legs);
-    assert(appended);
-   }else{
-    appended = product->appendTensorNetwork(TensorNetwork(*(oper->network)),oper->bra_legs);
-    assert(appended);
-    appended = reorderProductLegs(*product,oper->ket_legs);
-    assert(appended);
-   }
-   product->rename(oper->network->getName() + "*" + term->network->getName());
-   appended = this->appendComponent(product,(oper->coefficient)*(term->coefficient));
+   auto product = makeOperatorProduct(*(term->network),*oper,conjugated,ket_);
+   appended = this->appendComponent(product,(oper->coefficient)*term_coefficient);
    assert(appended);
   }
  }
@@ -62,6 +53,23 @@ TensorExpansion::TensorExpansion(const TensorExpansion & left_expansion,  //in:
 }
 
 
+TensorExpansion::TensorExpansion(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
+                                 const TensorExpansion & right_expansion, //in: tensor network expansion from the same or dual space
+                                 bool left_conjugated,                    //in: whether or not the left tensor network expansion enters complex conjugated
+                                 bool right_conjugated)                   //in: whether or not the right tensor network expansion enters complex conjugated
+{
+ const bool left_ket = (left_expansion.isKet() != left_conjugated);
+ const bool right_ket = (right_expansion.isKet() != right_conjugated);
+ if(left_ket == right_ket){
+  constructDirectProductTensorExpansion(left_expansion,right_expansion,left_conjugated,right_conjugated);
+  ket_ = left_ket;
+ }else{
+  constructInnerProductTensorExpansion(left_expansion,right_expansion,left_conjugated,right_conjugated);
+  ket_ = true; //inner product tensor expansion is formally marked as ket but it is irrelevant
+ }
+}
+
+
 TensorExpansion::TensorExpansion(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
                                  const TensorExpansion & right_expansion, //in: tensor network expansion from the dual tensor space
                                  const TensorOperator & tensor_operator)  //in: tensor network operator
@@ -71,6 +79,18 @@ TensorExpansion::TensorExpansion(const TensorExpansion & left_expansion,  //in:
 }
 
 
+TensorExpansion::TensorExpansion(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
+                                 const TensorExpansion & right_expansion, //in: tensor network expansion from the dual tensor space
+                                 const TensorOperator & tensor_operator,  //in: tensor network operator
+                                 bool left_conjugated,                    //in: whether or not the left tensor network expansion enters complex conjugated
+                                 bool right_conjugated)                   //in: whether or not the right tensor network expansion enters complex conjugated
+{
+ constructInnerProductTensorExpansion(left_expansion,TensorExpansion(right_expansion,tensor_operator,right_conjugated),
+                                      left_conjugated,false);
+ ket_ = true; //inner product tensor expansion is formally marked as ket but it is irrelevant
+}
+
+
 TensorExpansion::TensorExpansion(const TensorExpansion & expansion,
                                  const std::string & tensor_name,
                                  bool conjugated):
@@ -111,8 +131,12 @@ TensorExpansion::TensorExpansion(const TensorExpansion & another,
  ket_(another.isKet())
 {
  for(auto iter = another.cbegin(); iter != another.cend(); ++iter){
-  this->appendComponent(std::make_shared<TensorNetwork>(*(iter->network),reset_output_tensors),
-                        iter->coefficient);
+  if(reset_output_tensors){
+   this->appendComponent(std::make_shared<TensorNetwork>(*(iter->network),reset_output_tensors),
+                         iter->coefficient);
+  }else{
+   components_.emplace_back(*iter); //shares the tensor network (copy-on-write)
+  }
  }
  if(new_name.length() > 0){
   this->rename(new_name);
@@ -203,8 +227,12 @@ TensorExpansion TensorExpansion::clone(bool reset_output_tensors,
 {
  TensorExpansion clon(this->isKet());
  for(auto iter = this->cbegin(); iter != this->cend(); ++iter){
-  clon.appendComponent(std::make_shared<TensorNetwork>(*(iter->network),reset_output_tensors),
-                       iter->coefficient);
+  if(reset_output_tensors){
+   clon.appendComponent(std::make_shared<TensorNetwork>(*(iter->network),reset_output_tensors),
+                        iter->coefficient);
+  }else{
+   clon.components_.emplace_back(*iter); //shares the tensor network (copy-on-write)
+  }
  }
  if(new_name.length() > 0){
   clon.rename(new_name);
@@ -284,7 +312,7 @@ bool TensorExpansion::deleteComponent(std::size_t component_num)
 void TensorExpansion::conjugate()
 {
  for(auto & component: components_){
-  component.network->conjugate();
+  component.getMutableNetwork()->conjugate();
   component.coefficient = std::conj(component.coefficient);
  }
  ket_ = !ket_;
@@ -312,7 +340,7 @@ bool TensorExpansion::appendTensorGateGeneral(std::shared_ptr<Tensor> tensor,
 {
  bool success = true;
  for(auto net = this->begin(); net != this->end(); ++net){
-  success = net->network->appendTensorGateGeneral(tensor,pairing,conjugated);
+  success = net->getMutableNetwork()->appendTensorGateGeneral(tensor,pairing,conjugated);
   if(!success) break;
  }
  return success;
@@ -325,7 +353,7 @@ bool TensorExpansion::appendTensorGate(std::shared_ptr<Tensor> tensor,
 {
  bool success = true;
  for(auto net = this->begin(); net != this->end(); ++net){
-  success = net->network->appendTensorGate(tensor,pairing,conjugated);
+  success = net->getMutableNetwork()->appendTensorGate(tensor,pairing,conjugated);
   if(!success) break;
  }
  return success;
@@ -334,14 +362,14 @@ bool TensorExpansion::appendTensorGate(std::shared_ptr<Tensor> tensor,
 
 void TensorExpansion::markOptimizableTensors(std::function<bool (const Tensor &)> predicate)
 {
- for(auto net = begin(); net != end(); ++net) net->network->markOptimizableTensors(predicate);
+ for(auto net = begin(); net != end(); ++net) net->getMutableNetwork()->markOptimizableTensors(predicate);
  return;
 }
 
 
 void TensorExpansion::markOptimizableAllTensors()
 {
- for(auto net = begin(); net != end(); ++net) net->network->markOptimizableAllTensors();
+ for(auto net = begin(); net != end(); ++net) net->getMutableNetwork()->markOptimizableAllTensors();
  return;
 }
 
@@ -369,7 +397,7 @@ bool TensorExpansion::collapseIsometries(bool * deltas_appended)
  bool collapsed = false, deltas_inserted = false;
  for(auto net = begin(); net != end(); ++net){
   bool deltas = false, clps = false;
-  if(net->network->hasIsometries()) clps = net->network->collapseIsometries(&deltas);
+  if(net->network->hasIsometries()) clps = net->getMutableNetwork()->collapseIsometries(&deltas);
   collapsed = collapsed || clps;
   deltas_inserted = deltas_inserted || deltas;
  }
@@ -378,6 +406,63 @@ bool TensorExpansion::collapseIsometries(bool * deltas_appended)
 }
 
 
+TensorExpansion::TensorExpansion(BytePacket & byte_packet):
+ ket_(true)
+{
+ unpack(byte_packet);
+}
+
+
+void TensorExpansion::pack(BytePacket & byte_packet) const
+{
+ appendToBytePacket(&byte_packet,ket_);
+ const std::size_t name_len = name_.length();
+ appendToBytePacket(&byte_packet,name_len);
+ appendArrayToBytePacket(&byte_packet,name_.data(),name_len);
+ //Tensors shared by all tensor networks:
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_map<const Tensor*,unsigned int> positions;
+ for(const auto & component: components_) component.network->collectTensors(tensors,positions);
+ TensorNetwork::packTensors(byte_packet,tensors);
+ //Components:
+ const std::size_t num_components = components_.size();
+ appendToBytePacket(&byte_packet,num_components);
+ for(const auto & component: components_){
+  const double coef_real = component.coefficient.real();
+  const double coef_imag = component.coefficient.imag();
+  appendToBytePacket(&byte_packet,coef_real);
+  appendToBytePacket(&byte_packet,coef_imag);
+  component.network->packTensorNetwork(byte_packet,positions);
+ }
+ return;
+}
+
+
+void TensorExpansion::unpack(BytePacket & byte_packet)
+{
+ components_.clear();
+ extractFromBytePacket(&byte_packet,ket_);
+ std::size_t name_len = 0;
+ extractFromBytePacket(&byte_packet,name_len);
+ name_.resize(name_len);
+ if(name_len > 0) extractArrayFromBytePacket(&byte_packet,&(name_[0]),name_len);
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ TensorNetwork::unpackTensors(byte_packet,tensors);
+ std::size_t num_components = 0;
+ extractFromBytePacket(&byte_packet,num_components);
+ components_.reserve(num_components);
+ for(std::size_t i = 0; i < num_components; ++i){
+  double coef_real = 0.0, coef_imag = 0.0;
+  extractFromBytePacket(&byte_packet,coef_real);
+  extractFromBytePacket(&byte_packet,coef_imag);
+  auto network = makeSharedTensorNetwork();
+  network->unpackTensorNetwork(byte_packet,tensors);
+  components_.emplace_back(ExpansionComponent(network,std::complex<double>{coef_real,coef_imag}));
+ }
+ return;
+}
+
+
 void TensorExpansion::printIt() const
 {
  if(ket_){
@@ -424,7 +509,9 @@ void TensorExpansion::printOperationList() const
 
 
 void TensorExpansion::constructDirectProductTensorExpansion(const TensorExpansion & left_expansion,
-                                                            const TensorExpansion & right_expansion)
+                                                            const TensorExpansion & right_expansion,
+                                                            bool left_conjugated,
+                                                            bool right_conjugated)
 {
  if(left_expansion.getNumComponents() == 0 || right_expansion.getNumComponents() == 0){
   std::cout << "#ERROR(exatn::numerics::TensorExpansion::constructDirectProductTensorExpansion): Empty input expansion!"
@@ -432,14 +519,11 @@ void TensorExpansion::constructDirectProductTensorExpansion(const TensorExpansio
   assert(false);
  }
  bool appended;
- std::vector<std::pair<unsigned int, unsigned int>> pairing;
  for(auto left = left_expansion.cbegin(); left != left_expansion.cend(); ++left){
   for(auto right = right_expansion.cbegin(); right != right_expansion.cend(); ++right){
-   auto product = std::make_shared<TensorNetwork>(*(left->network));
-   appended = product->appendTensorNetwork(TensorNetwork(*(right->network)),pairing);
-   assert(appended);
-   product->rename(left->network->getName() + "*" + right->network->getName());
-   appended = this->appendComponent(product,(left->coefficient)*(right->coefficient));
+   auto product = makeProduct(*(left->network),*(right->network),left_conjugated,right_conjugated,false);
+   appended = this->appendComponent(product,(left_conjugated ? std::conj(left->coefficient) : left->coefficient)
+                                           *(right_conjugated ? std::conj(right->coefficient) : right->coefficient));
    assert(appended);
   }
  }
@@ -448,26 +532,21 @@ void TensorExpansion::constructDirectProductTensorExpansion(const TensorExpansio
 
 
 void TensorExpansion::constructInnerProductTensorExpansion(const TensorExpansion & left_expansion,
-                                                           const TensorExpansion & right_expansion)
+                                                           const TensorExpansion & right_expansion,
+                                                           bool left_conjugated,
+                                                           bool right_conjugated)
 {
  if(left_expansion.getNumComponents() == 0 || right_expansion.getNumComponents() == 0){
   std::cout << "#ERROR(exatn::numerics::TensorExpansion::constructInnerProductTensorExpansion): Empty input expansion!"
             << std::endl;
   assert(false);
  }
- auto rank = left_expansion.cbegin()->network->getRank();
- assert(rank > 0);
  bool appended;
- std::vector<std::pair<unsigned int, unsigned int>> pairing(rank);
- for(unsigned int i = 0; i < rank; ++i) pairing[i] = {i,i};
  for(auto left = left_expansion.cbegin(); left != left_expansion.cend(); ++left){
   for(auto right = right_expansion.cbegin(); right != right_expansion.cend(); ++right){
-   assert(right->network->getRank() == rank);
-   auto product = std::make_shared<TensorNetwork>(*(right->network));
-   appended = product->appendTensorNetwork(TensorNetwork(*(left->network)),pairing);
-   assert(appended);
-   product->rename(left->network->getName() + "*" + right->network->getName());
-   appended = this->appendComponent(product,(left->coefficient)*(right->coefficient));
+   auto product = makeProduct(*(left->network),*(right->network),left_conjugated,right_conjugated,true);
+   appended = this->appendComponent(product,(left_conjugated ? std::conj(left->coefficient) : left->coefficient)
+                                           *(right_conjugated ? std::conj(right->coefficient) : right->coefficient));
    assert(appended);
   }
  }
@@ -475,6 +554,63 @@ void TensorExpansion::constructInnerProductTensorExpansion(const TensorExpansion
 }
 
 
+std::shared_ptr<TensorNetwork> TensorExpansion::makeOperatorProduct(const TensorNetwork & network,
+                                                                    const TensorOperator::OperatorComponent & oper,
+                                                                    bool conjugated,
+                                                                    bool ket)
+{
+ bool appended;
+ auto product = std::make_shared<TensorNetwork>(network);
+ if(conjugated){appended = product->conjugate(); assert(appended);}
+ if(ket){
+  appended = product->appendTensorNetwork(TensorNetwork(*(oper.network)),oper.ket_legs);
+  assert(appended);
+  appended = reorderProductLegs(*product,oper.bra_legs);
+  assert(appended);
+ }else{
+  appended = product->appendTensorNetwork(TensorNetwork(*(oper.network)),oper.bra_legs);
+  assert(appended);
+  appended = reorderProductLegs(*product,oper.ket_legs);
+  assert(appended);
+ }
+ product->rename(oper.network->getName() + "*" + network.getName());
+ return product;
+}
+
+
+std::shared_ptr<TensorNetwork> TensorExpansion::makeProduct(const TensorNetwork & left_network,
+                                                            const TensorNetwork & right_network,
+                                                            bool left_conjugated,
+                                                            bool right_conjugated,
+                                                            bool inner)
+{
+ bool appended;
+ std::shared_ptr<TensorNetwork> product;
+ if(inner){ //inner product: All output legs are contracted pairwise
+  const auto rank = left_network.getRank();
+  assert(rank > 0 && right_network.getRank() == rank);
+  std::vector<std::pair<unsigned int, unsigned int>> pairing(rank);
+  for(unsigned int i = 0; i < rank; ++i) pairing[i] = {i,i};
+  product = std::make_shared<TensorNetwork>(right_network);
+  if(right_conjugated){appended = product->conjugate(); assert(appended);}
+  TensorNetwork left(left_network);
+  if(left_conjugated){appended = left.conjugate(); assert(appended);}
+  appended = product->appendTensorNetwork(std::move(left),pairing);
+  assert(appended);
+ }else{ //direct product
+  std::vector<std::pair<unsigned int, unsigned int>> pairing;
+  product = std::make_shared<TensorNetwork>(left_network);
+  if(left_conjugated){appended = product->conjugate(); assert(appended);}
+  TensorNetwork right(right_network);
+  if(right_conjugated){appended = right.conjugate(); assert(appended);}
+  appended = product->appendTensorNetwork(std::move(right),pairing);
+  assert(appended);
+ }
+ product->rename(left_network.getName() + "*" + right_network.getName());
+ return product;
+}
+
+
 bool TensorExpansion::reorderProductLegs(TensorNetwork & network,
      const std::vector<std::pair<unsigned int, unsigned int>> & new_legs)
 {
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor network expansion
-REVISION: 2022/02/15
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -21,6 +21,22 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
      two tensor network expansions from the same space (bra*bra, ket*ket).
  (e) A tensor network operator can be applied to a tensor network expansion,
      producing another tensor network expansion.
+ (f) Copies of a tensor network expansion share the constituting tensor networks
+     (copy-on-write): A shared tensor network is duplicated only when it is about
+     to be modified via a copy of the tensor network expansion. Tensor networks
+     appended by the user are not duplicated, thus modifying them in place
+     becomes visible via the tensor network expansion and vice versa.
+ (g) Complex conjugation is a lazy attribute of the tensors in a tensor network:
+     A tensor network expansion can enter a product/inner product or an operator
+     application complex conjugated, in which case the conjugation is applied to
+     the newly built product tensor networks only. Thus, there is no need to create
+     a conjugated (bra) copy of a ket tensor network expansion beforehand.
+ (h) The inner product tensor network expansion built with a tensor network operator
+     can also be generated lazily, component by component (tensor_expansion_stream.hpp),
+     instead of materializing the full product of all components at once.
+ (i) A tensor network expansion can be packed into a byte packet, together with its tensor
+     networks (see tensor_network.hpp), where the tensors shared by multiple tensor networks
+     are packed once. The unpacked tensor networks are not shared with other expansions.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_EXPANSION_HPP_
@@ -41,7 +57,7 @@ namespace exatn{
 
 namespace numerics{
 
-class TensorExpansion{
+class TensorExpansion: public Packable{
 public:
 
  //Tensor network expansion component:
@@ -53,23 +69,29 @@ public:
 
   ExpansionComponent(std::shared_ptr<TensorNetwork> network,
                      std::complex<double> coefficient):
-   network(network), coefficient(coefficient)
+   network(network), coefficient(coefficient), copies_(std::make_shared<const bool>(true))
   {}
 
-  ExpansionComponent(const ExpansionComponent & another){
-   network = makeSharedTensorNetwork(*(another.network));
-   coefficient = another.coefficient;
-  }
-
-  ExpansionComponent & operator=(const ExpansionComponent & another){
-   network = makeSharedTensorNetwork(*(another.network));
-   coefficient = another.coefficient;
-   return *this;
-  }
-
+  //Copies share the tensor network until one of them modifies it:
+  ExpansionComponent(const ExpansionComponent &) = default;
+  ExpansionComponent & operator=(const ExpansionComponent &) = default;
   ExpansionComponent(ExpansionComponent &&) noexcept = default;
   ExpansionComponent & operator=(ExpansionComponent &&) noexcept = default;
   ~ExpansionComponent() = default;
+
+  /** Returns the tensor network for in-place modification. If the tensor network
+      is still shared with other copies of this expansion component, it is
+      duplicated first (copy-on-write). **/
+  std::shared_ptr<TensorNetwork> getMutableNetwork(){
+   if(copies_.use_count() > 1){
+    network = makeSharedTensorNetwork(*network);
+    copies_ = std::make_shared<const bool>(true);
+   }
+   return network;
+  }
+
+ private:
+  std::shared_ptr<const bool> copies_; //shared by all copies of the expansion component sharing the same tensor network
  };
 
  using Iterator = typename std::vector<ExpansionComponent>::iterator;
@@ -91,7 +113,8 @@ public:
  /** Constructs a tensor expansion by applying a tensor network operator
      to another tensor network expansion. **/
  TensorExpansion(const TensorExpansion & expansion,       //in: tensor network expansion in some tensor space
-                 const TensorOperator & tensor_operator); //in: tensor network operator
+                 const TensorOperator & tensor_operator,  //in: tensor network operator
+                 bool conjugated = false);                //in: whether or not the tensor network expansion enters complex conjugated
 
  /** Either constructs the inner product tensor network expansion by closing
      one tensor network expansion with another tensor network expansion
@@ -100,6 +123,13 @@ public:
  TensorExpansion(const TensorExpansion & left_expansion,   //in: tensor network expansion in some tensor space
                  const TensorExpansion & right_expansion); //in: tensor network expansion from the same or dual space
 
+ /** Same as above, but either tensor network expansion may enter complex conjugated
+     (lazily, without creating its conjugated copy), which also flips its ket/bra status. **/
+ TensorExpansion(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
+                 const TensorExpansion & right_expansion, //in: tensor network expansion from the same or dual space
+                 bool left_conjugated,                    //in: whether or not the left tensor network expansion enters complex conjugated
+                 bool right_conjugated);                  //in: whether or not the right tensor network expansion enters complex conjugated
+
  /** Constructs the inner product tensor network expansion by applying
      a tensor network operator to a tensor network expansion (right_expansion)
      and then closing the resulting tensor network expansion with another
@@ -108,6 +138,15 @@ public:
                  const TensorExpansion & right_expansion, //in: tensor network expansion from the dual tensor space
                  const TensorOperator & tensor_operator); //in: tensor network operator
 
+ /** Same as above, but either tensor network expansion may enter complex conjugated
+     (lazily, without creating its conjugated copy). The tensor network operator is
+     applied to the (possibly conjugated) right tensor network expansion. **/
+ TensorExpansion(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
+                 const TensorExpansion & right_expansion, //in: tensor network expansion from the dual tensor space
+                 const TensorOperator & tensor_operator,  //in: tensor network operator
+                 bool left_conjugated,                    //in: whether or not the left tensor network expansion enters complex conjugated
+                 bool right_conjugated);                  //in: whether or not the right tensor network expansion enters complex conjugated
+
  /** Produces a derivative tensor expansion by differentiating
      the tensor expansion with respect to a given tensor (by its name). **/
  TensorExpansion(const TensorExpansion & expansion, //in: original tensor expansion
@@ -142,12 +181,20 @@ public:
  TensorExpansion(const TensorOperator & tensor_operator, //in: tensor network operator
                  const Tensor & ket_subspace);           //in: tensor defining the ket and bra subspace from the tensor operator map
 
+ /** Creates a tensor network expansion from a byte packet (previously packed tensor network expansion). **/
+ TensorExpansion(BytePacket & byte_packet);
+
  TensorExpansion(const TensorExpansion &) = default;
  TensorExpansion & operator=(const TensorExpansion &) = default;
  TensorExpansion(TensorExpansion &&) noexcept = default;
  TensorExpansion & operator=(TensorExpansion &&) noexcept = default;
  virtual ~TensorExpansion() = default;
 
+ /** Packs the tensor network expansion into a byte packet, see (i). **/
+ virtual void pack(BytePacket & byte_packet) const override;
+ /** Unpacks the tensor network expansion from a byte packet (replaces the current content). **/
+ virtual void unpack(BytePacket & byte_packet) override;
+
  /** Clones the current tensor network expansion. By default, the output
      tensor in each tensor network component of the newly cloned tensor
      network expansion will be reset to a new one. The name of the cloned
@@ -280,11 +327,29 @@ private:
 
  /** Internal methods: **/
  void constructDirectProductTensorExpansion(const TensorExpansion & left_expansion,
-                                            const TensorExpansion & right_expansion);
+                                            const TensorExpansion & right_expansion,
+                                            bool left_conjugated = false,
+                                            bool right_conjugated = false);
  void constructInnerProductTensorExpansion(const TensorExpansion & left_expansion,
-                                           const TensorExpansion & right_expansion);
- bool reorderProductLegs(TensorNetwork & network,
-                         const std::vector<std::pair<unsigned int, unsigned int>> & new_legs);
+                                           const TensorExpansion & right_expansion,
+                                           bool left_conjugated = false,
+                                           bool right_conjugated = false);
+ static bool reorderProductLegs(TensorNetwork & network,
+                                const std::vector<std::pair<unsigned int, unsigned int>> & new_legs);
+
+ /** Builds a single product tensor network: Tensor network operator component applied to a tensor network. **/
+ static std::shared_ptr<TensorNetwork> makeOperatorProduct(const TensorNetwork & network,
+                                                           const TensorOperator::OperatorComponent & oper,
+                                                           bool conjugated,  //whether or not the tensor network enters complex conjugated
+                                                           bool ket);        //ket/bra status of the product
+ /** Builds a single product tensor network: Inner or direct product of two tensor networks. **/
+ static std::shared_ptr<TensorNetwork> makeProduct(const TensorNetwork & left_network,
+                                                   const TensorNetwork & right_network,
+                                                   bool left_conjugated,
+                                                   bool right_conjugated,
+                                                   bool inner);             //inner versus direct product
+
+ friend class TensorExpansionStream;
 
 protected:
 
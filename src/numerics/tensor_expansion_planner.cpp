@@ -0,0 +1,315 @@
+/** ExaTN::Numerics: Tensor network expansion: Evaluation planner
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_expansion_planner.hpp"
+#include "tensor_network_flat.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <string>
+#include <list>
+
+namespace exatn{
+
+namespace numerics{
+
+namespace{
+
+//Structural fingerprint of an intermediate tensor (two independent hashes):
+using Fingerprint = std::pair<std::size_t,std::size_t>;
+
+struct FingerprintHash{
+ std::size_t operator()(const Fingerprint & key) const {return key.first ^ (key.second << 1);}
+};
+
+inline void combineHash(Fingerprint & key, std::size_t value)
+{
+ key.first ^= value + 0x9e3779b97f4a7c15ULL + (key.first << 6) + (key.first >> 2);
+ key.second = (key.second ^ value) * 0x100000001b3ULL + 0x517cc1b727220a95ULL;
+ return;
+}
+
+//Node of a tensor contraction tree (intermediate tensor):
+struct ContrNode{
+ unsigned int left_id;                                   //left child id
+ unsigned int right_id;                                  //right child id
+ std::vector<std::pair<unsigned int,unsigned int>> legs; //dimensions of the intermediate: {input tensor id, its dimension}
+ double flops;                                           //FMA flop count of the sub-tree
+ std::size_t key;                                        //fingerprint id
+};
+
+//Contraction tree of a tensor network component:
+struct ContrTree{
+ std::unordered_map<unsigned int,ContrNode> nodes; //intermediate tensor id --> node
+ std::vector<unsigned int> selected;               //roots of the reused sub-trees
+};
+
+//Appends the input tensor ids of a sub-tree in the order of the contraction tree:
+void collectLeaves(const ContrTree & tree, unsigned int id, std::vector<unsigned int> & leaves)
+{
+ auto node = tree.nodes.find(id);
+ if(node == tree.nodes.cend()){
+  leaves.emplace_back(id);
+ }else{
+  collectLeaves(tree,node->second.left_id,leaves);
+  collectLeaves(tree,node->second.right_id,leaves);
+ }
+ return;
+}
+
+//Collects the intermediate tensor ids of a sub-tree:
+void collectIntermediates(const ContrTree & tree, unsigned int id, std::unordered_set<unsigned int> & ids)
+{
+ auto node = tree.nodes.find(id);
+ if(node != tree.nodes.cend()){
+  ids.emplace(id);
+  collectIntermediates(tree,node->second.left_id,ids);
+  collectIntermediates(tree,node->second.right_id,ids);
+ }
+ return;
+}
+
+} //namespace
+
+
+TensorExpansionPlanner::TensorExpansionPlanner(const TensorExpansion & expansion):
+ original_flops_(0.0), planned_flops_(0.0)
+{
+ std::vector<const TensorNetwork *> networks;
+ for(auto component = expansion.cbegin(); component != expansion.cend(); ++component){
+  networks.emplace_back(component->network.get());
+ }
+ plan(networks);
+}
+
+
+TensorExpansionPlanner::TensorExpansionPlanner(const std::vector<std::shared_ptr<TensorNetwork>> & networks):
+ original_flops_(0.0), planned_flops_(0.0)
+{
+ std::vector<const TensorNetwork *> network_ptrs;
+ for(const auto & network: networks) network_ptrs.emplace_back(network.get());
+ plan(network_ptrs);
+}
+
+
+void TensorExpansionPlanner::plan(const std::vector<const TensorNetwork *> & networks)
+{
+ const auto num_components = networks.size();
+ reduced_.assign(num_components,std::shared_ptr<TensorNetwork>(nullptr));
+ std::vector<ContrTree> trees(num_components);
+ std::vector<std::vector<double>> contr_flops(num_components);
+ std::unordered_map<Fingerprint,std::size_t,FingerprintHash> keys; //fingerprint --> fingerprint id
+ std::vector<std::size_t> occurrences; //fingerprint id --> number of occurrences across all components
+
+ //Build the tensor contraction trees and fingerprint all their intermediates:
+ for(std::size_t comp = 0; comp < num_components; ++comp){
+  const auto & network = *(networks[comp]);
+  double fma_flops = 0.0;
+  const auto & contr_seq = network.exportContractionSequence(&fma_flops);
+  original_flops_ += fma_flops;
+  if(contr_seq.size() < 2) continue; //no intermediates to share
+  const TensorNetworkFlat flat(network);
+  flat.simulateContractionSequence(contr_seq,&(contr_flops[comp]));
+  auto & tree = trees[comp];
+  auto childLegs = [&](unsigned int id, Fingerprint & key){
+   std::vector<std::pair<unsigned int,unsigned int>> legs;
+   auto node = tree.nodes.find(id);
+   if(node != tree.nodes.end()){ //intermediate tensor
+    key = {node->second.key,~(node->second.key)};
+    legs = node->second.legs;
+   }else{ //input tensor
+    bool conjugated = false;
+    const auto tensor = network.getTensor(id,&conjugated);
+    key = {0,0};
+    combineHash(key,std::hash<std::string>{}(tensor->getName()));
+    combineHash(key,conjugated ? 1 : 0);
+    const auto vertex = flat.getVertex(id);
+    const auto rank = flat.getRank(vertex);
+    const auto * extents = flat.getLegExtents(vertex);
+    for(unsigned int i = 0; i < rank; ++i){
+     combineHash(key,static_cast<std::size_t>(extents[i]));
+     legs.emplace_back(std::make_pair(id,i));
+    }
+   }
+   return legs;
+  };
+  std::size_t contr_num = 0;
+  for(const auto & contr: contr_seq){
+   Fingerprint left_key, right_key;
+   auto left_legs = childLegs(contr.left_id,left_key);
+   auto right_legs = childLegs(contr.right_id,right_key);
+   //Find the contracted dimensions:
+   std::unordered_map<std::size_t,unsigned int> right_pos; //vertex leg --> position in the right intermediate
+   for(unsigned int j = 0; j < right_legs.size(); ++j){
+    right_pos.emplace(std::make_pair(
+     static_cast<std::size_t>(flat.getVertex(right_legs[j].first)) * 65536 + right_legs[j].second,j));
+   }
+   ContrNode node{contr.left_id,contr.right_id,{},contr_flops[comp][contr_num++],0};
+   Fingerprint key = {left_key.first,left_key.second};
+   combineHash(key,right_key.first);
+   combineHash(key,right_key.second);
+   std::vector<bool> contracted(right_legs.size(),false);
+   for(unsigned int i = 0; i < left_legs.size(); ++i){
+    const auto vertex = flat.getVertex(left_legs[i].first);
+    const auto other_vertex = flat.getLegVertices(vertex)[left_legs[i].second];
+    const auto other_dim = flat.getLegDimensions(vertex)[left_legs[i].second];
+    auto pos = right_pos.find(static_cast<std::size_t>(other_vertex) * 65536 + other_dim);
+    if(pos != right_pos.end()){ //contracted dimension
+     combineHash(key,i);
+     combineHash(key,pos->second);
+     contracted[pos->second] = true;
+    }else{
+     node.legs.emplace_back(left_legs[i]);
+    }
+   }
+   for(unsigned int j = 0; j < right_legs.size(); ++j){
+    if(!contracted[j]) node.legs.emplace_back(right_legs[j]);
+   }
+   for(const auto id: {contr.left_id,contr.right_id}){
+    auto child = tree.nodes.find(id);
+    if(child != tree.nodes.end()) node.flops += child->second.flops;
+   }
+   if(contr.result_id != 0){
+    auto res = keys.emplace(std::make_pair(key,keys.size()));
+    node.key = res.first->second;
+    if(res.second) occurrences.emplace_back(0);
+    ++(occurrences[node.key]);
+   }
+   tree.nodes.emplace(std::make_pair(contr.result_id,std::move(node)));
+  }
+ }
+
+ //Select the maximal shared sub-trees in each tensor contraction tree:
+ std::vector<std::size_t> uses(occurrences.size(),0); //fingerprint id --> number of selected occurrences
+ std::function<void (ContrTree &, unsigned int)> descend = [&](ContrTree & tree, unsigned int id){
+  auto node = tree.nodes.find(id);
+  if(node == tree.nodes.end()) return; //input tensor
+  if(occurrences[node->second.key] > 1){
+   tree.selected.emplace_back(id);
+   ++(uses[node->second.key]);
+  }else{
+   descend(tree,node->second.left_id);
+   descend(tree,node->second.right_id);
+  }
+  return;
+ };
+ for(auto & tree: trees){
+  auto root = tree.nodes.find(0);
+  if(root != tree.nodes.end()){
+   descend(tree,root->second.left_id);
+   descend(tree,root->second.right_id);
+  }
+ }
+ bool refined = true;
+ while(refined){ //a shared intermediate used only once is replaced by the shared sub-trees it contains
+  refined = false;
+  for(auto & tree: trees){
+   std::vector<unsigned int> selected;
+   selected.swap(tree.selected);
+   for(const auto id: selected){
+    const auto & node = tree.nodes[id];
+    if(uses[node.key] > 1){
+     tree.selected.emplace_back(id);
+    }else{
+     uses[node.key] = 0;
+     descend(tree,node.left_id);
+     descend(tree,node.right_id);
+     refined = true;
+    }
+   }
+  }
+ }
+
+ //Create the tensor sub-networks computing the shared intermediates:
+ std::unordered_map<std::size_t,std::size_t> shared_ids; //fingerprint id --> shared intermediate
+ for(std::size_t comp = 0; comp < num_components; ++comp){
+  auto & tree = trees[comp];
+  for(const auto id: tree.selected){
+   const auto & node = tree.nodes[id];
+   auto res = shared_ids.emplace(std::make_pair(node.key,shared_.size()));
+   if(res.second){
+    const auto & network = *(networks[comp]);
+    std::vector<unsigned int> leaves;
+    collectLeaves(tree,id,leaves);
+    auto subnetwork = std::make_shared<TensorNetwork>(network.getName() + "_shared" + std::to_string(shared_.size()),
+                                                      network,leaves);
+    //Reorder the output tensor dimensions to match those of the intermediate:
+    const auto & legs = node.legs;
+    const auto * output_legs = subnetwork->getTensorConnections(0);
+    assert(output_legs != nullptr && output_legs->size() == legs.size());
+    std::vector<unsigned int> order(legs.size());
+    for(unsigned int i = 0; i < legs.size(); ++i){
+     unsigned int pos = 0;
+     while(pos < output_legs->size() && ((*output_legs)[pos].getTensorId() != legs[i].first ||
+                                         (*output_legs)[pos].getDimensionId() != legs[i].second)) ++pos;
+     assert(pos < output_legs->size());
+     order[i] = pos;
+    }
+    auto reordered = subnetwork->reorderOutputModes(order); assert(reordered);
+    //Inherit the tensor contraction sequence of the sub-tree:
+    std::unordered_set<unsigned int> ids;
+    collectIntermediates(tree,id,ids);
+    std::list<ContrTriple> contr_seq;
+    for(const auto & contr: network.exportContractionSequence()){
+     if(ids.find(contr.result_id) != ids.end()){
+      contr_seq.emplace_back(contr);
+      if(contr.result_id == id) contr_seq.back().result_id = 0;
+     }
+    }
+    subnetwork->importContractionSequence(contr_seq,node.flops);
+    shared_.emplace_back(SharedIntermediate{subnetwork,0,node.flops});
+    planned_flops_ += node.flops;
+   }
+  }
+ }
+
+ //Create the reduced tensor networks:
+ for(std::size_t comp = 0; comp < num_components; ++comp){
+  const auto & tree = trees[comp];
+  const auto & network = *(networks[comp]);
+  if(tree.selected.empty()){
+   planned_flops_ += network.getFMAFlops();
+   continue;
+  }
+  std::unordered_set<unsigned int> ids;
+  for(const auto id: tree.selected) collectIntermediates(tree,id,ids);
+  auto reduced = std::make_shared<TensorNetwork>(network);
+  std::list<ContrTriple> contr_seq;
+  double fma_flops = 0.0;
+  std::size_t contr_num = 0;
+  bool success = true;
+  for(const auto & contr: network.exportContractionSequence()){
+   if(ids.find(contr.result_id) != ids.end()){
+    success = reduced->mergeTensors(contr.left_id,contr.right_id,contr.result_id);
+   }else{
+    contr_seq.emplace_back(contr);
+    fma_flops += contr_flops[comp][contr_num];
+   }
+   ++contr_num;
+   if(!success) break;
+  }
+  for(const auto id: tree.selected){
+   if(!success) break;
+   const auto & shared = shared_[shared_ids[tree.nodes.at(id).key]];
+   success = reduced->substituteTensor(id,shared.network->getTensor(0));
+  }
+  if(success){
+   reduced->importContractionSequence(contr_seq,fma_flops);
+   for(const auto id: tree.selected) ++(shared_[shared_ids[tree.nodes.at(id).key]].num_uses);
+   reduced_[comp] = reduced;
+   planned_flops_ += fma_flops;
+  }else{ //the component will be evaluated as is
+   std::cout << "#WARNING(exatn::numerics::TensorExpansionPlanner): Unable to reuse shared intermediates in tensor network "
+             << network.getName() << std::endl;
+   planned_flops_ += network.getFMAFlops();
+  }
+ }
+}
+
+} //namespace numerics
+
+} //namespace exatn
@@ -0,0 +1,111 @@
+/** ExaTN::Numerics: Tensor network expansion: Evaluation planner
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Components of a tensor network expansion often share identical tensor
+     sub-networks (e.g., the untouched left and right environments of an MPS
+     closed with different terms of a Hamiltonian). The evaluation planner
+     detects such shared sub-networks across all components of a tensor network
+     expansion (common-subexpression elimination), such that each shared
+     intermediate tensor is computed only once and then reused by all components.
+ (b) Candidate sub-networks are the sub-trees of the tensor contraction sequences
+     already determined for the tensor network components. Each candidate is
+     identified by its structural fingerprint: Participating input tensors (names,
+     conjugation, extents) in the order of the contraction tree, their mutual
+     connections, and the relative order of the output tensor legs they carry.
+     Identical fingerprints define identical intermediate tensors (including
+     the order of their dimensions).
+ (c) Only maximal shared sub-trees are reused: A shared intermediate which would
+     be used by a single component only is replaced by the shared sub-trees it
+     contains (if any). Each shared intermediate is computed by a dedicated tensor
+     sub-network whose output tensor substitutes the sub-tree in the reduced tensor
+     networks of the reusing components. Both inherit their tensor contraction
+     sequences from the original tensor networks (no additional search).
+ (d) All shared intermediates are present at the same time while the reduced
+     tensor networks are being evaluated.
+ (e) The same planning applies to an arbitrary collection of tensor networks
+     with distinct output tensors (tensor network bundle), in which case the
+     tensor network components are the member tensor networks of the bundle.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_EXPANSION_PLANNER_HPP_
+#define EXATN_NUMERICS_TENSOR_EXPANSION_PLANNER_HPP_
+
+#include "tensor_basic.hpp"
+#include "tensor_network.hpp"
+#include "tensor_expansion.hpp"
+
+#include <vector>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class TensorExpansionPlanner{
+
+public:
+
+ //Shared intermediate tensor:
+ struct SharedIntermediate{
+  std::shared_ptr<TensorNetwork> network; //tensor sub-network computing the shared intermediate (its output tensor)
+  std::size_t num_uses;                   //number of uses across the tensor network components
+  double flops;                           //FMA flop count of computing the shared intermediate once
+ };
+
+ /** Plans the evaluation of a tensor network expansion whose components
+     have their tensor contraction sequences already determined
+     (components without a tensor contraction sequence do not participate). **/
+ explicit TensorExpansionPlanner(const TensorExpansion & expansion);
+
+ /** Plans the joint evaluation of a collection of tensor networks with
+     their own output tensors and already determined tensor contraction sequences
+     (each tensor network is treated as a tensor network component). **/
+ explicit TensorExpansionPlanner(const std::vector<std::shared_ptr<TensorNetwork>> & networks);
+
+ TensorExpansionPlanner(const TensorExpansionPlanner &) = delete;
+ TensorExpansionPlanner & operator=(const TensorExpansionPlanner &) = delete;
+ TensorExpansionPlanner(TensorExpansionPlanner &&) noexcept = default;
+ TensorExpansionPlanner & operator=(TensorExpansionPlanner &&) noexcept = default;
+ ~TensorExpansionPlanner() = default;
+
+ /** Returns the number of shared intermediate tensors. **/
+ inline std::size_t getNumSharedIntermediates() const {return shared_.size();}
+
+ /** Returns a shared intermediate tensor. Shared intermediates must be
+     computed before evaluating the reduced tensor networks. **/
+ inline const SharedIntermediate & getSharedIntermediate(std::size_t i) const {return shared_[i];}
+
+ /** Returns the reduced tensor network of a tensor network component in which
+     the shared sub-networks are replaced by the shared intermediate tensors
+     (nullptr if the tensor network component does not reuse any of them).
+     The reduced tensor network has the same output tensor as the original one. **/
+ inline std::shared_ptr<TensorNetwork> getReducedNetwork(std::size_t component) const {return reduced_[component];}
+
+ /** Returns the total FMA flop count of evaluating all tensor network components independently. **/
+ inline double getOriginalFlops() const {return original_flops_;}
+
+ /** Returns the total FMA flop count of the planned evaluation (shared intermediates included). **/
+ inline double getPlannedFlops() const {return planned_flops_;}
+
+private:
+
+ /** Detects shared sub-networks and builds the reduced tensor networks. **/
+ void plan(const std::vector<const TensorNetwork *> & networks);
+
+ std::vector<SharedIntermediate> shared_;              //shared intermediate tensors
+ std::vector<std::shared_ptr<TensorNetwork>> reduced_; //reduced tensor networks (by component)
+ double original_flops_;                               //FMA flop count of the independent evaluation
+ double planned_flops_;                                //FMA flop count of the planned evaluation
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_EXPANSION_PLANNER_HPP_
@@ -0,0 +1,82 @@
+/** ExaTN::Numerics: Tensor network expansion: Lazy generation of operator products
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_expansion_stream.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+TensorExpansionStream::TensorExpansionStream(const TensorExpansion & left_expansion,
+                                             const TensorExpansion & right_expansion,
+                                             const TensorOperator & tensor_operator,
+                                             bool left_conjugated,
+                                             bool right_conjugated,
+                                             double prune_threshold):
+ left_(left_expansion), right_(right_expansion), operator_(tensor_operator),
+ left_conjugated_(left_conjugated), right_conjugated_(right_conjugated), prune_threshold_(prune_threshold),
+ name_(left_expansion.getName() + "*" + tensor_operator.getName() + "*" + right_expansion.getName()),
+ num_components_(left_expansion.getNumComponents() * right_expansion.getNumComponents() *
+                 tensor_operator.getNumComponents()),
+ position_(0), num_pruned_(0)
+{
+ if(left_expansion.getNumComponents() == 0 || right_expansion.getNumComponents() == 0){
+  std::cout << "#ERROR(exatn::numerics::TensorExpansionStream): Empty input expansion!" << std::endl;
+  assert(false);
+ }
+}
+
+
+void TensorExpansionStream::reset()
+{
+ position_ = 0;
+ num_pruned_ = 0;
+ return;
+}
+
+
+bool TensorExpansionStream::next(std::shared_ptr<TensorNetwork> & network,
+                                 std::complex<double> & coefficient)
+{
+ const auto num_opers = operator_.getNumComponents();
+ const auto num_rights = right_.getNumComponents();
+ while(position_ < num_components_){
+  const auto oper = operator_.cbegin() + (position_ % num_opers);
+  const auto right = right_.cbegin() + ((position_ / num_opers) % num_rights);
+  const auto left = left_.cbegin() + (position_ / (num_opers * num_rights));
+  ++position_;
+  coefficient = (left_conjugated_ ? std::conj(left->coefficient) : left->coefficient) *
+                ((oper->coefficient) * (right_conjugated_ ? std::conj(right->coefficient) : right->coefficient));
+  if(std::abs(coefficient) > prune_threshold_){
+   const bool ket = (right_.isKet() != right_conjugated_);
+   auto product = TensorExpansion::makeOperatorProduct(*(right->network),*oper,right_conjugated_,ket);
+   network = TensorExpansion::makeProduct(*(left->network),*product,left_conjugated_,false,true);
+   return true;
+  }
+  ++num_pruned_;
+ }
+ return false;
+}
+
+
+std::size_t TensorExpansionStream::nextBatch(TensorExpansion & batch,
+                                             std::size_t max_components)
+{
+ assert(max_components > 0);
+ batch = TensorExpansion(name_,true); //inner product tensor expansion is formally marked as ket
+ std::size_t num_generated = 0;
+ std::shared_ptr<TensorNetwork> network;
+ std::complex<double> coefficient;
+ while(num_generated < max_components && next(network,coefficient)){
+  auto appended = batch.appendComponent(network,coefficient); assert(appended);
+  ++num_generated;
+ }
+ return num_generated;
+}
+
+} //namespace numerics
+
+} //namespace exatn
@@ -0,0 +1,103 @@
+/** ExaTN::Numerics: Tensor network expansion: Lazy generation of operator products
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) The inner product tensor network expansion <L|H|R> built from a tensor network
+     operator H and two tensor network expansions L and R contains the full product
+     of all their components: |L| x |R| x |H|. Materializing it at once may require
+     a lot of memory (for example, with operators consisting of thousands of terms).
+ (b) A tensor network expansion stream is a lazy view of such an inner product tensor
+     network expansion: It only keeps (shared) copies of its three factors and generates
+     the product tensor networks on demand, either one by one or in batches of bounded size
+     (regular tensor network expansions), in the same order as the eager construction.
+ (c) Components with the absolute value of the product coefficient not exceeding
+     the given pruning threshold are skipped without building their tensor networks.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_EXPANSION_STREAM_HPP_
+#define EXATN_NUMERICS_TENSOR_EXPANSION_STREAM_HPP_
+
+#include "tensor_basic.hpp"
+#include "tensor_network.hpp"
+#include "tensor_operator.hpp"
+#include "tensor_expansion.hpp"
+
+#include <string>
+#include <complex>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class TensorExpansionStream{
+public:
+
+ /** Lazily constructs the inner product tensor network expansion by applying
+     a tensor network operator to a tensor network expansion (right_expansion)
+     and then closing the result with another tensor network expansion from
+     the dual tensor space (same semantics as the corresponding TensorExpansion constructor).
+     Components with |coefficient| <= prune_threshold will not be generated. **/
+ TensorExpansionStream(const TensorExpansion & left_expansion,  //in: tensor network expansion in some tensor space
+                       const TensorExpansion & right_expansion, //in: tensor network expansion from the dual tensor space
+                       const TensorOperator & tensor_operator,  //in: tensor network operator
+                       bool left_conjugated = false,            //in: whether or not the left tensor network expansion enters complex conjugated
+                       bool right_conjugated = false,           //in: whether or not the right tensor network expansion enters complex conjugated
+                       double prune_threshold = 0.0);           //in: pruning threshold for the absolute value of the component coefficient
+
+ TensorExpansionStream(const TensorExpansionStream &) = default;
+ TensorExpansionStream & operator=(const TensorExpansionStream &) = default;
+ TensorExpansionStream(TensorExpansionStream &&) noexcept = default;
+ TensorExpansionStream & operator=(TensorExpansionStream &&) noexcept = default;
+ ~TensorExpansionStream() = default;
+
+ /** Returns the tensor network expansion stream name. **/
+ inline const std::string & getName() const {return name_;}
+
+ /** Returns the total number of components in the full product (before pruning). **/
+ inline std::size_t getMaxNumComponents() const {return num_components_;}
+
+ /** Returns the number of components skipped so far due to pruning. **/
+ inline std::size_t getNumPruned() const {return num_pruned_;}
+
+ /** Returns TRUE if all components have already been generated. **/
+ inline bool isExhausted() const {return (position_ >= num_components_);}
+
+ /** Rewinds the tensor network expansion stream to its first component. **/
+ void reset();
+
+ /** Generates the next (non-pruned) product tensor network with its coefficient.
+     Returns FALSE if the tensor network expansion stream is exhausted. **/
+ bool next(std::shared_ptr<TensorNetwork> & network, //out: product tensor network
+           std::complex<double> & coefficient);      //out: its expansion coefficient
+
+ /** Generates up to max_components next (non-pruned) components as
+     a regular tensor network expansion. Returns the number of generated
+     components (zero when the tensor network expansion stream is exhausted). **/
+ std::size_t nextBatch(TensorExpansion & batch,      //out: tensor network expansion containing the next components
+                       std::size_t max_components);  //in: max number of components in the batch (>0)
+
+private:
+
+ TensorExpansion left_;           //left tensor network expansion (shares tensor networks with the original)
+ TensorExpansion right_;          //right tensor network expansion (shares tensor networks with the original)
+ TensorOperator operator_;        //tensor network operator (shares tensor networks with the original)
+ bool left_conjugated_;           //whether or not the left tensor network expansion enters complex conjugated
+ bool right_conjugated_;          //whether or not the right tensor network expansion enters complex conjugated
+ double prune_threshold_;         //pruning threshold for the absolute value of the component coefficient
+ std::string name_;               //name of the tensor network expansion stream
+ std::size_t num_components_;     //total number of components in the full product
+ std::size_t position_;           //current position: ((left * |R|) + right) * |H| + operator
+ std::size_t num_pruned_;         //number of pruned components
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_EXPANSION_STREAM_HPP_
@@ -34,7 +34,7 @@ void TensorLeg::printIt() const
  return;
 }
 
-void TensorLeg::printItFile(std::ofstream & output_file) const
+void TensorLeg::printItFile(std::ostream & output_file) const
 {
  if(direction_ == LegDirection::INWARD){
   output_file << "{" << tensor_id_ << ":" << dimensn_id_ << ";+}";
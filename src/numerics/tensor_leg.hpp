@@ -51,7 +51,7 @@ public:
 
  /** Print. **/
  void printIt() const;
- void printItFile(std::ofstream & output_file) const;
+ void printItFile(std::ostream & output_file) const;
 
  /** Return the connected tensor id: [0..*]. **/
  unsigned int getTensorId() const;
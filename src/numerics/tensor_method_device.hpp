@@ -0,0 +1,131 @@
+/** ExaTN::Numerics: Tensor methods with device kernels
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (A) A tensor functor (talsh::TensorFunctor::apply) operates on the Host image of a tensor,
+     thus a TRANSFORM of a tensor resident on an accelerator moves its body to Host and back.
+     A tensor functor which additionally derives from DeviceTensorMethod is instead applied
+     in place on the accelerator, provided that the only image of the tensor body resides
+     there: applyOnDevice() receives the device pointer to the tensor body (of the given
+     TAL-SH data kind) and must complete the device work (or synchronize its stream)
+     before returning. Returning DEVICE_UNSUPPORTED falls back to the Host apply().
+ (B) FunctorDeviceKernel combines a Host tensor functor with a user-supplied device kernel
+     (e.g., a CUDA/HIP kernel launcher), such that any existing tensor functor can be
+     extended with a device implementation without modifying it.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_METHOD_DEVICE_HPP_
+#define EXATN_NUMERICS_TENSOR_METHOD_DEVICE_HPP_
+
+#include "Identifiable.hpp"
+
+#include "tensor_basic.hpp"
+
+#include "tensor_method.hpp" //from TAL-SH
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class DeviceTensorMethod{
+public:
+
+ static constexpr const int DEVICE_UNSUPPORTED = -1; //the device kernel is not applicable: Use the Host apply()
+
+ virtual ~DeviceTensorMethod() = default;
+
+ /** Applies the tensor method to the tensor body resident on an accelerator.
+     Returns zero on success, DEVICE_UNSUPPORTED if the device kernel is not applicable,
+     or an error code otherwise. The talsh::Tensor slice is identified by its signature
+     and shape that both can be accessed by talsh::Tensor methods. **/
+ virtual int applyOnDevice(talsh::Tensor & local_tensor, //in: tensor slice (metadata)
+                           void * device_body,           //inout: device pointer to the tensor body
+                           int data_kind,                //in: TAL-SH data kind of the tensor body
+                           int device_kind,              //in: TAL-SH device kind (DEV_NVIDIA_GPU, etc.)
+                           int device_id) = 0;           //in: device id within its kind
+};
+
+
+class FunctorDeviceKernel: public talsh::TensorFunctor<Identifiable>, public DeviceTensorMethod{
+public:
+
+ /** Device kernel: Same arguments and return codes as DeviceTensorMethod::applyOnDevice(). **/
+ using DeviceKernel = std::function<int (talsh::Tensor & local_tensor, void * device_body,
+                                         int data_kind, int device_kind, int device_id)>;
+
+ FunctorDeviceKernel(std::shared_ptr<talsh::TensorFunctor<Identifiable>> host_functor,
+                     DeviceKernel device_kernel):
+  host_functor_(host_functor), device_kernel_(device_kernel)
+ {
+  make_sure(static_cast<bool>(host_functor_),"#ERROR(exatn::numerics::FunctorDeviceKernel): Host tensor functor is missing!");
+ }
+
+ virtual ~FunctorDeviceKernel() = default;
+
+ virtual const std::string name() const override
+ {
+  return host_functor_->name();
+ }
+
+ virtual const std::string description() const override
+ {
+  return host_functor_->description();
+ }
+
+ /** Packs data members into a byte packet. **/
+ virtual void pack(BytePacket & packet) override
+ {
+  host_functor_->pack(packet);
+  return;
+ }
+
+ /** Unpacks data members from a byte packet. **/
+ virtual void unpack(BytePacket & packet) override
+ {
+  host_functor_->unpack(packet);
+  return;
+ }
+
+ /** Applies the Host tensor functor. **/
+ virtual int apply(talsh::Tensor & local_tensor) override
+ {
+  return host_functor_->apply(local_tensor);
+ }
+
+ /** Applies the device kernel (if any). **/
+ virtual int applyOnDevice(talsh::Tensor & local_tensor,
+                           void * device_body,
+                           int data_kind,
+                           int device_kind,
+                           int device_id) override
+ {
+  if(!device_kernel_) return DEVICE_UNSUPPORTED;
+  return device_kernel_(local_tensor,device_body,data_kind,device_kind,device_id);
+ }
+
+ /** Returns the Host tensor functor. **/
+ std::shared_ptr<talsh::TensorFunctor<Identifiable>> getHostFunctor() const
+ {
+  return host_functor_;
+ }
+
+private:
+
+ std::shared_ptr<talsh::TensorFunctor<Identifiable>> host_functor_; //Host tensor functor
+ DeviceKernel device_kernel_;                                       //device kernel
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_METHOD_DEVICE_HPP_
@@ -0,0 +1,59 @@
+/** ExaTN::Numerics: Interned tensor names
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_name_table.hpp"
+
+#include <cassert>
+
+namespace exatn{
+
+namespace numerics{
+
+TensorNameTable & TensorNameTable::get()
+{
+ static TensorNameTable name_table;
+ return name_table;
+}
+
+TensorNameId TensorNameTable::intern(const std::string & name)
+{
+ auto & table = get();
+ std::lock_guard<std::mutex> lock(table.lock_);
+ auto res = table.ids_.emplace(name,static_cast<TensorNameId>(table.names_.size()));
+ if(res.second){
+  assert(res.first->second != NO_TENSOR_NAME_ID);
+  table.names_.emplace_back(name);
+ }
+ return res.first->second;
+}
+
+TensorNameId TensorNameTable::find(const std::string & name)
+{
+ auto & table = get();
+ std::lock_guard<std::mutex> lock(table.lock_);
+ auto iter = table.ids_.find(name);
+ if(iter == table.ids_.end()) return NO_TENSOR_NAME_ID;
+ return iter->second;
+}
+
+const std::string & TensorNameTable::getName(TensorNameId name_id)
+{
+ auto & table = get();
+ std::lock_guard<std::mutex> lock(table.lock_);
+ assert(name_id < table.names_.size());
+ return table.names_[name_id];
+}
+
+std::size_t TensorNameTable::getSize()
+{
+ auto & table = get();
+ std::lock_guard<std::mutex> lock(table.lock_);
+ return table.names_.size();
+}
+
+} //namespace numerics
+
+} //namespace exatn
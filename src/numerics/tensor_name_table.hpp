@@ -0,0 +1,74 @@
+/** ExaTN::Numerics: Interned tensor names
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Tensor names are interned into compact integer identifiers (TensorNameId),
+     such that tensor registries can be keyed by integers: A tensor name is hashed
+     (and stored) only once, when it is interned for the first time, whereas
+     class Tensor caches the identifier of its current name.
+ (b) Interned tensor names are never released, thus a tensor name identifier stays
+     valid for the whole run. The table grows with the number of distinct tensor names
+     (the automatically generated tensor names derive from the tensor hashes, thus they
+     are recycled together with the memory of the tensor objects).
+ (c) The name table is shared by all threads (its methods are thread-safe).
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_NAME_TABLE_HPP_
+#define EXATN_NUMERICS_TENSOR_NAME_TABLE_HPP_
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace exatn{
+
+namespace numerics{
+
+using TensorNameId = std::uint32_t; //interned tensor name identifier
+
+constexpr TensorNameId NO_TENSOR_NAME_ID = 0xFFFFFFFFU; //invalid tensor name identifier
+
+class TensorNameTable{
+public:
+
+ TensorNameTable(const TensorNameTable &) = delete;
+ TensorNameTable & operator=(const TensorNameTable &) = delete;
+ TensorNameTable(TensorNameTable &&) noexcept = delete;
+ TensorNameTable & operator=(TensorNameTable &&) noexcept = delete;
+ ~TensorNameTable() = default;
+
+ /** Returns the identifier of a tensor name, interning the name if needed. **/
+ static TensorNameId intern(const std::string & name);
+
+ /** Returns the identifier of an already interned tensor name,
+     or NO_TENSOR_NAME_ID if the name has never been interned. **/
+ static TensorNameId find(const std::string & name);
+
+ /** Returns the tensor name of an interned identifier. **/
+ static const std::string & getName(TensorNameId name_id);
+
+ /** Returns the number of interned tensor names. **/
+ static std::size_t getSize();
+
+private:
+
+ TensorNameTable() = default;
+
+ /** Returns the name table singleton. **/
+ static TensorNameTable & get();
+
+ std::mutex lock_;                                  //serializes access to the name table
+ std::unordered_map<std::string,TensorNameId> ids_; //tensor name --> tensor name identifier
+ std::deque<std::string> names_;                    //tensor name identifier --> tensor name (stable references)
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_NAME_TABLE_HPP_
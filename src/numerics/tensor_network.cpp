@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor network
-REVISION: 2022/02/21
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -8,8 +8,10 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_symbol.hpp"
 #include "contraction_seq_optimizer_factory.hpp"
 #include "functor_init_val.hpp"
+#include "tensor_composite.hpp"
 
 #include "metis_graph.hpp"
+#include "tensor_network_flat.hpp"
 
 #include <iostream>
 #include <unordered_set>
@@ -124,7 +126,8 @@ void printContractionSequence(std::ofstream & output_file, const std::list<numer
 TensorNetwork::TensorNetwork():
  explicit_output_(0), finalized_(1), has_isometries_(0), max_tensor_id_(0),
  contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
- max_intermediate_volume_(0.0), max_intermediate_rank_(0), universal_indexing_(false)
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
 {
  auto res = emplaceTensorConnDirect(false,
                                     0U, //output tensor (id = 0)
@@ -139,7 +142,8 @@ TensorNetwork::TensorNetwork():
 TensorNetwork::TensorNetwork(const std::string & name):
  explicit_output_(0), finalized_(1), name_(name), has_isometries_(0), max_tensor_id_(0),
  contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
- max_intermediate_volume_(0.0), max_intermediate_rank_(0), universal_indexing_(false)
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
 {
  auto res = emplaceTensorConnDirect(false,
                                     0U, //output tensor (id = 0)
@@ -156,7 +160,8 @@ TensorNetwork::TensorNetwork(const std::string & name,
                              const std::vector<TensorLeg> & output_legs):
  explicit_output_(1), finalized_(0), name_(name), has_isometries_(0), max_tensor_id_(0),
  contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
- max_intermediate_volume_(0.0), max_intermediate_rank_(0), universal_indexing_(false)
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
 {
  auto res = emplaceTensorConnDirect(false,
                                     0U, //output tensor (id = 0)
@@ -173,7 +178,8 @@ TensorNetwork::TensorNetwork(const std::string & name,
                              const std::map<std::string,std::shared_ptr<Tensor>> & tensors):
  explicit_output_(1), finalized_(0), name_(name), has_isometries_(0), max_tensor_id_(0),
  contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
- max_intermediate_volume_(0.0), max_intermediate_rank_(0), universal_indexing_(false)
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
 {
  //Convert tensor hypernetwork into regular tensor network, if needed:
  //`Finish
@@ -256,7 +262,8 @@ TensorNetwork::TensorNetwork(const std::string & name,
                              bool tensor_operator):
  explicit_output_(1), finalized_(0), name_(name), has_isometries_(0), max_tensor_id_(0),
  contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
- max_intermediate_volume_(0.0), max_intermediate_rank_(0), universal_indexing_(false)
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
 {
  auto res = emplaceTensorConnDirect(false,
                                     0U, //output tensor (id = 0)
@@ -281,6 +288,16 @@ TensorNetwork::TensorNetwork(const TensorNetwork & another,
 }
 
 
+TensorNetwork::TensorNetwork(BytePacket & byte_packet):
+ explicit_output_(0), finalized_(1), has_isometries_(0), max_tensor_id_(0),
+ contraction_seq_flops_(0.0), max_intermediate_presence_volume_(0.0),
+ max_intermediate_volume_(0.0), max_intermediate_rank_(0),
+ intermediate_workspace_volume_(0.0), universal_indexing_(false)
+{
+ unpack(byte_packet);
+}
+
+
 TensorNetwork::TensorNetwork(const std::string & name,
                              const TensorNetwork & another,
                              const std::vector<unsigned int> & tensor_ids):
@@ -358,7 +375,7 @@ void TensorNetwork::printIt(bool with_tensor_hash) const
 }
 
 
-void TensorNetwork::printItFile(std::ofstream & output_file,
+void TensorNetwork::printItFile(std::ostream & output_file,
                                 bool with_tensor_hash) const
 {
  output_file << "TensorNetwork(" << name_
@@ -629,6 +646,8 @@ void TensorNetwork::invalidateMaxTensorId()
 
 void TensorNetwork::invalidateContractionSequence()
 {
+ stale_contraction_seq_.clear();
+ stale_tensors_.clear();
  split_tensors_.clear();
  split_indices_.clear();
  operations_.clear();
@@ -637,11 +656,29 @@ void TensorNetwork::invalidateContractionSequence()
  max_intermediate_presence_volume_ = 0.0;
  max_intermediate_volume_ = 0.0;
  max_intermediate_rank_ = 0;
+ intermediate_workspace_volume_ = 0.0;
+ intermediate_offsets_.clear();
  universal_indexing_ = false;
  return;
 }
 
 
+void TensorNetwork::invalidateContractionSequence(const std::vector<unsigned int> & modified_tensors)
+{
+ if(!(contraction_seq_.empty())){ //retain the previous tensor contraction sequence
+  stale_contraction_seq_ = contraction_seq_;
+  stale_tensors_.clear();
+ }
+ if(!(stale_contraction_seq_.empty())){
+  for(const auto tensor_id: modified_tensors) stale_tensors_.emplace(tensor_id);
+ }
+ invalidateTensorOperationList();
+ contraction_seq_.clear();
+ contraction_seq_flops_ = 0.0;
+ return;
+}
+
+
 void TensorNetwork::invalidateTensorOperationList()
 {
  split_tensors_.clear();
@@ -650,6 +687,8 @@ void TensorNetwork::invalidateTensorOperationList()
  max_intermediate_presence_volume_ = 0.0;
  max_intermediate_volume_ = 0.0;
  max_intermediate_rank_ = 0;
+ intermediate_workspace_volume_ = 0.0;
+ intermediate_offsets_.clear();
  universal_indexing_ = false;
  return;
 }
@@ -659,18 +698,30 @@ double TensorNetwork::determineContractionSequence(ContractionSeqOptimizer & con
 {
  assert(finalized_ != 0); //tensor network must be in finalized state
  if(contraction_seq_.empty()){
-  auto intermediate_num_begin = this->getMaxTensorId() + 1;
-  auto intermediate_num_generator = [intermediate_num_begin]() mutable {return intermediate_num_begin++;};
-  contraction_seq_flops_ = contr_seq_optimizer.determineContractionSequence(*this,contraction_seq_,intermediate_num_generator);
+  if(!repairContractionSequence(contr_seq_optimizer)){ //full tensor contraction sequence search
+   auto intermediate_num_begin = this->getMaxTensorId() + 1;
+   auto intermediate_num_generator = [intermediate_num_begin]() mutable {return intermediate_num_begin++;};
+   ContractionSeqOptimizer::beginSearchTelemetry(this->getNumTensors());
+   contraction_seq_flops_ = contr_seq_optimizer.determineContractionSequence(*this,contraction_seq_,intermediate_num_generator);
+   contr_seq_optimizer.endSearchTelemetry(*this,contraction_seq_,contraction_seq_flops_);
+  }
+  stale_contraction_seq_.clear();
+  stale_tensors_.clear();
   max_intermediate_presence_volume_ = 0.0;
   max_intermediate_volume_ = 0.0;
   max_intermediate_rank_ = 0;
+  intermediate_workspace_volume_ = 0.0;
+  intermediate_offsets_.clear();
  }
  return contraction_seq_flops_;
 }
 
 
-double TensorNetwork::determineContractionSequence(const std::string & contr_seq_opt_name)
+double TensorNetwork::determineContractionSequence(const std::string & contr_seq_opt_name,
+                                                   double max_intermediate_volume,
+                                                   double time_budget,
+                                                   double contraction_time_fraction,
+                                                   double fma_flop_rate)
 {
  auto iter = optimizers.find(contr_seq_opt_name);
  if(iter == optimizers.end()){ //not cached
@@ -687,20 +738,83 @@ double TensorNetwork::determineContractionSequence(const std::string & contr_seq
    assert(false);
   }
  }
+ iter->second->resetMemoryLimit(max_intermediate_volume);
+ iter->second->resetTimeBudget(time_budget,contraction_time_fraction,fma_flop_rate);
  return determineContractionSequence(*(iter->second));
 }
 
 
+bool TensorNetwork::repairContractionSequence(ContractionSeqOptimizer & contr_seq_optimizer)
+{
+ if(stale_contraction_seq_.empty() || this->getNumTensors() < 2) return false;
+ //Find the intact subtrees of the previous contraction tree (all their input tensors are present and unmodified):
+ std::unordered_map<unsigned int, bool> intact; //previous intermediate tensor id --> whether its subtree is intact
+ auto is_intact = [this,&intact](unsigned int tensor_id){
+  auto iter = intact.find(tensor_id);
+  if(iter != intact.end()) return iter->second;
+  return (tensor_id != 0 && stale_tensors_.find(tensor_id) == stale_tensors_.end()
+                         && tensors_.find(tensor_id) != tensors_.end());
+ };
+ std::list<ContrTriple> reused;
+ for(const auto & contr: stale_contraction_seq_){
+  const bool result_intact = is_intact(contr.left_id) && is_intact(contr.right_id);
+  intact[contr.result_id] = result_intact;
+  if(result_intact) reused.emplace_back(contr);
+ }
+ if(reused.empty()) return false;
+ //Collapse the intact subtrees into single tensors (with new intermediate tensor ids):
+ TensorNetwork reduced(*this);
+ unsigned int intermediate_id = this->getMaxTensorId();
+ std::unordered_map<unsigned int, unsigned int> id_map; //previous intermediate tensor id --> new intermediate tensor id
+ std::list<ContrTriple> contr_seq;
+ double flops = 0.0;
+ for(const auto & contr: reused){
+  auto left = id_map.find(contr.left_id);
+  const unsigned int left_id = (left != id_map.end()) ? left->second : contr.left_id;
+  auto right = id_map.find(contr.right_id);
+  const unsigned int right_id = (right != id_map.end()) ? right->second : contr.right_id;
+  const unsigned int result_id = ++intermediate_id;
+  id_map[contr.result_id] = result_id;
+  flops += reduced.getContractionCost(left_id,right_id);
+  auto merged = reduced.mergeTensors(left_id,right_id,result_id); assert(merged);
+  contr_seq.emplace_back(ContrTriple{result_id,left_id,right_id});
+ }
+ //Re-optimize the reduced tensor network:
+ if(reduced.getNumTensors() > 1){
+  flops += reduced.determineContractionSequence(contr_seq_optimizer);
+  contr_seq.splice(contr_seq.end(),reduced.contraction_seq_);
+ }else{
+  contr_seq.back().result_id = 0; //the intact subtree spans the entire tensor network
+ }
+ contraction_seq_ = std::move(contr_seq);
+ contraction_seq_flops_ = flops;
+ return true;
+}
+
+
+double TensorNetwork::updateContractionSequenceFlops()
+{
+ if(!(contraction_seq_.empty())){
+  contraction_seq_flops_ = TensorNetworkFlat(*this).simulateContractionSequence(contraction_seq_);
+ }
+ return contraction_seq_flops_;
+}
+
+
 void TensorNetwork::importContractionSequence(const std::list<ContrTriple> & contr_sequence,
                                               double fma_flops)
 {
  assert(finalized_ != 0); //tensor network must be in finalized state
+ stale_contraction_seq_.clear();
+ stale_tensors_.clear();
  contraction_seq_.clear();
  contraction_seq_ = contr_sequence;
  contraction_seq_flops_ = fma_flops; //flop count may be unknown yet (defaults to zero)
  max_intermediate_presence_volume_ = 0.0; //max cumulative volume of intermediates present at a time
  max_intermediate_volume_ = 0.0; //max intermediate tensor volume is unknown yet
  max_intermediate_rank_ = 0; //max intermediate tensor rank
+ intermediate_workspace_volume_ = 0.0; //intermediate workspace is unplanned yet
+ intermediate_offsets_.clear();
  return;
 }
 
@@ -709,16 +823,70 @@ void TensorNetwork::importContractionSequence(const std::vector<unsigned int> &
                                               double fma_flops)
 {
  assert(finalized_ != 0); //tensor network must be in finalized state
+ stale_contraction_seq_.clear();
+ stale_tensors_.clear();
  contraction_seq_.clear();
  unpackContractionSequenceFromVector(contraction_seq_,contr_sequence_content);
  contraction_seq_flops_ = fma_flops; //flop count may be unknown yet (defaults to zero)
  max_intermediate_presence_volume_ = 0.0; //max cumulative volume of intermediates present at a time
  max_intermediate_volume_ = 0.0; //max intermediate tensor volume is unknown yet
  max_intermediate_rank_ = 0; //max intermediate tensor rank
+ intermediate_workspace_volume_ = 0.0; //intermediate workspace is unplanned yet
+ intermediate_offsets_.clear();
  return;
 }
 
 
+bool TensorNetwork::importBoundaryMPSSequence(const std::vector<std::vector<unsigned int>> & grid)
+{
+ assert(finalized_ != 0); //tensor network must be in finalized state
+ //Validate the grid:
+ if(grid.empty() || grid[0].empty()){
+  std::cout << "#ERROR(TensorNetwork::importBoundaryMPSSequence): Empty grid!" << std::endl;
+  return false;
+ }
+ const auto num_rows = grid[0].size();
+ std::unordered_set<unsigned int> ids;
+ for(const auto & column: grid){
+  if(column.size() != num_rows){
+   std::cout << "#ERROR(TensorNetwork::importBoundaryMPSSequence): Grid columns differ in size!" << std::endl;
+   return false;
+  }
+  for(const auto tensor_id: column){
+   if(tensor_id == 0 || this->getTensorConn(tensor_id) == nullptr || !(ids.emplace(tensor_id).second)){
+    std::cout << "#ERROR(TensorNetwork::importBoundaryMPSSequence): Invalid or repeated tensor id in the grid: "
+              << tensor_id << std::endl;
+    return false;
+   }
+  }
+ }
+ if(ids.size() != this->getNumTensors()){
+  std::cout << "#ERROR(TensorNetwork::importBoundaryMPSSequence): The grid does not cover all input tensors!" << std::endl;
+  return false;
+ }
+ if(ids.size() < 2) return false;
+ //Absorb the grid columns into the boundary one by one:
+ std::list<ContrTriple> contr_seq;
+ auto next_id = this->getMaxTensorId() + 1;
+ std::vector<unsigned int> boundary(grid[0]);
+ for(std::size_t col = 1; col < grid.size(); ++col){
+  for(std::size_t row = 0; row < num_rows; ++row){
+   contr_seq.emplace_back(ContrTriple{next_id,boundary[row],grid[col][row]});
+   boundary[row] = next_id++;
+  }
+ }
+ //Contract the final boundary row by row:
+ auto accumulated = boundary[0];
+ for(std::size_t row = 1; row < num_rows; ++row){
+  contr_seq.emplace_back(ContrTriple{next_id,accumulated,boundary[row]});
+  accumulated = next_id++;
+ }
+ contr_seq.back().result_id = 0; //the last tensor contraction produces the output tensor
+ importContractionSequence(contr_seq);
+ return true;
+}
+
+
 const std::list<ContrTriple> & TensorNetwork::exportContractionSequence(double * fma_flops) const
 {
  if(fma_flops != nullptr) *fma_flops = contraction_seq_flops_;
@@ -1054,7 +1222,7 @@ bool TensorNetwork::appendTensor(unsigned int tensor_id,
    return false;
   }
  }
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({}); //invalidate previously cached tensor contraction sequence (incremental repair)
  finalized_ = 1; //implicit leg pairing always keeps the tensor network in a finalized state
  return true;
 }
@@ -1163,7 +1331,7 @@ bool TensorNetwork::appendTensorGate(unsigned int tensor_id,
    return false;
   }
  }
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({}); //invalidate previously cached tensor contraction sequence (incremental repair)
  finalized_ = 1; //implicit leg pairing always keeps the tensor network in a finalized state
  return true;
 }
@@ -1294,7 +1462,7 @@ bool TensorNetwork::appendTensorGateGeneral(unsigned int tensor_id,
    return false;
   }
  }
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({}); //invalidate previously cached tensor contraction sequence (incremental repair)
  finalized_ = 1; //implicit leg pairing always keeps the tensor network in a finalized state
  return true;
 }
@@ -1422,7 +1590,7 @@ bool TensorNetwork::appendTensorNetwork(TensorNetwork && network,
   }
  }
  this->updateConnections(0); //update connections in just appended input tensors
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({}); //invalidate previously cached tensor contraction sequence (incremental repair)
  finalized_ = 1; //implicit leg pairing always keeps the primary tensor network in a finalized state
  return true;
 }
@@ -1535,7 +1703,7 @@ bool TensorNetwork::appendTensorNetworkGate(TensorNetwork && network,
   }
  }
  this->updateConnections(0); //update connections in just appended input tensors
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({}); //invalidate previously cached tensor contraction sequence (incremental repair)
  finalized_ = 1; //implicit leg pairing always keeps the primary tensor network in a finalized state
  return true;
 }
@@ -1624,7 +1792,7 @@ bool TensorNetwork::deleteTensor(unsigned int tensor_id)
  //Delete the tensor from the network:
  tensor = nullptr;
  auto erased = eraseTensorConn(tensor_id); assert(erased);
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({tensor_id}); //invalidate previously cached tensor contraction sequence (incremental repair)
  return true;
 }
 
@@ -1861,6 +2029,70 @@ bool TensorNetwork::mergeTensors(const std::vector<unsigned int> & tensor_ids,
 }
 
 
+bool TensorNetwork::replaceTensors(const std::vector<unsigned int> & tensor_ids,
+                                   unsigned int result_id,
+                                   std::shared_ptr<Tensor> tensor,
+                                   const std::vector<std::pair<unsigned int, unsigned int>> & leg_origins)
+{
+ bool success = true;
+ if(finalized_ == 0){
+  std::cout << "#ERROR(TensorNetwork::replaceTensors): Invalid request: " <<
+   "Replacing tensors in an unfinalized tensor network is forbidden!" << std::endl;
+  return false;
+ }
+ //Check tensor ids:
+ std::unordered_set<unsigned int> ids;
+ for(const auto tens_id: tensor_ids){
+  assert(tens_id != 0);
+  auto res = ids.emplace(tens_id);
+  assert(res.second);
+ }
+ //Count the boundary legs of the replaced tensors:
+ unsigned int num_boundary_legs = 0;
+ for(const auto tens_id: tensor_ids){
+  const auto * tens_conn = getTensorConn(tens_id);
+  if(tens_conn == nullptr){
+   std::cout << "#ERROR(TensorNetwork::replaceTensors): Invalid request: " <<
+    "Tensor with id " << tens_id << " is not found in the tensor network!" << std::endl;
+   return false;
+  }
+  for(const auto & leg: tens_conn->getTensorLegs()){
+   if(ids.find(leg.getTensorId()) == ids.cend()) ++num_boundary_legs;
+  }
+ }
+ if(leg_origins.size() != num_boundary_legs || tensor->getRank() != num_boundary_legs){
+  std::cout << "#ERROR(TensorNetwork::replaceTensors): Invalid request: " <<
+   "The replacing tensor does not match the boundary of the replaced tensors!" << std::endl;
+  return false;
+ }
+ //Connect the replacing tensor to the neighbors of the replaced tensors:
+ std::vector<TensorLeg> legs;
+ legs.reserve(num_boundary_legs);
+ for(const auto & origin: leg_origins){
+  assert(ids.find(origin.first) != ids.cend());
+  auto * orig_tens_conn = getTensorConn(origin.first);
+  const auto & orig_tens_leg = orig_tens_conn->getTensorLeg(origin.second);
+  assert(ids.find(orig_tens_leg.getTensorId()) == ids.cend());
+  assert(tensor->getDimExtent(legs.size()) == orig_tens_conn->getDimExtent(origin.second));
+  legs.emplace_back(orig_tens_leg);
+ }
+ success = emplaceTensorConn(result_id,TensorConn(tensor,result_id,legs));
+ //Erase replaced tensors:
+ if(success){
+  for(const auto tens_id: tensor_ids){
+   success = eraseTensorConn(tens_id);
+   if(!success) break;
+  }
+  //Update connections:
+  if(success){
+   updateConnections(result_id);
+   invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+  }
+ }
+ return success;
+}
+
+
 bool TensorNetwork::splitTensor(unsigned int tensor_id,
                                 unsigned int left_tensor_id,
                                 const std::string & left_tensor_name,
@@ -1940,7 +2172,7 @@ bool TensorNetwork::splitTensor(unsigned int tensor_id,
   right->appendLeg(dim_extent,TensorLeg(left_tensor_id,left_rank++));
  }
  assert(left_rank == left_full_rank && right_rank == right_full_rank);
- invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+ invalidateContractionSequence({tensor_id,left_tensor_id,right_tensor_id}); //invalidate previously cached tensor contraction sequence (incremental repair)
  return true;
 }
 
@@ -2022,7 +2254,7 @@ bool TensorNetwork::substituteTensor(unsigned int tensor_id,
      updateConnections(id_map[tens_entry->first]);
     }
    }
-   invalidateContractionSequence(); //invalidate previously cached tensor contraction sequence
+   invalidateContractionSequence({tensor_id}); //invalidate previously cached tensor contraction sequence (incremental repair)
   }else{
    success = false;
   }
@@ -2299,10 +2531,14 @@ bool TensorNetwork::resetBondAdaptivity(std::shared_ptr<BondAdaptivity> bond_ada
 }
 
 
-bool TensorNetwork::applyBondAdaptivityStep(bool invalidate)
+bool TensorNetwork::applyBondAdaptivityStep(bool invalidate,
+                                            std::function<bool (std::shared_ptr<Tensor>,unsigned int,DimExtent)> resizer)
 {
- bool success = true, adapted = false;
+ bool success = true;
+ std::vector<unsigned int> adapted_tensors;
  if(bond_adaptivity_){
+  //Determine the new bond dimensions from the current ones:
+  std::vector<std::tuple<unsigned int,unsigned int,DimExtent>> resizes; //{tensor id, dimension, new extent}
   for(const auto & policy: bond_adaptivity_->bond_policy_){
    const auto tid1 = policy.bond.first.getTensorId();
    const auto lid1 = policy.bond.first.getDimensionId();
@@ -2325,22 +2561,39 @@ bool TensorNetwork::applyBondAdaptivityStep(bool invalidate)
    const auto dim_ext = tensor1->getDimExtent(lid1);
    const auto new_dim_ext = policy.adapt(dim_ext);
    if(new_dim_ext != dim_ext){
-    auto new_tensor1 = makeSharedTensor(*(tensor1->getTensor()));
-    new_tensor1->replaceDimension(lid1,new_dim_ext);
-    new_tensor1->rename();
-    auto new_tensor2 = makeSharedTensor(*(tensor2->getTensor()));
-    new_tensor2->replaceDimension(lid2,new_dim_ext);
-    new_tensor2->rename();
-    success = substituteTensor(tid1,new_tensor1);
-    success = substituteTensor(tid2,new_tensor2);
-    adapted = true;
+    resizes.emplace_back(std::make_tuple(tid1,lid1,new_dim_ext));
+    resizes.emplace_back(std::make_tuple(tid2,lid2,new_dim_ext));
    }
   }
-  if(adapted){
+  //Resize the adapted tensors:
+  for(const auto & resize: resizes){
+   const auto tid = std::get<0>(resize);
+   const auto lid = std::get<1>(resize);
+   const auto new_dim_ext = std::get<2>(resize);
+   auto * tensor_conn = getTensorConn(tid);
+   auto tensor = tensor_conn->getTensor();
+   if(tensor->getDimExtent(lid) == new_dim_ext) continue; //tensor shared by multiple bonds has already been resized
+   if(resizer){ //in-place resize (tensor identity is preserved)
+    success = resizer(tensor,lid,new_dim_ext);
+    if(success) success = (tensor->getDimExtent(lid) == new_dim_ext);
+   }else{ //replacement with a renamed copy of the new shape
+    auto new_tensor = makeSharedTensor(*tensor);
+    new_tensor->replaceDimension(lid,new_dim_ext);
+    new_tensor->rename();
+    tensor_conn->replaceStoredTensor(new_tensor);
+   }
+   if(!success){
+    std::cout << "#ERROR(TensorNetwork::applyBondAdaptivityStep): Unable to resize tensor " << tensor->getName() << std::endl;
+    break;
+   }
+   adapted_tensors.emplace_back(tid);
+  }
+  if(!adapted_tensors.empty()){
    if(invalidate){
-    invalidateContractionSequence();
+    invalidateContractionSequence(adapted_tensors); //re-optimize around the adapted tensors
    }else{
     invalidateTensorOperationList();
+    updateContractionSequenceFlops(); //same tensor contraction sequence with rescaled cost
    }
   }
  }else{
@@ -2436,6 +2689,8 @@ std::list<std::shared_ptr<TensorOperation>> & TensorNetwork::getOperationList(co
   max_intermediate_presence_volume_ = 0.0;
   max_intermediate_volume_ = 0.0;
   max_intermediate_rank_ = 0;
+  intermediate_workspace_volume_ = 0.0;
+  intermediate_offsets_.clear();
   double flops = determineContractionSequence();
   //Generate the list of operations (tensor contractions):
   std::size_t intermediates_vol = 0;
@@ -2502,6 +2757,7 @@ std::list<std::shared_ptr<TensorOperation>> & TensorNetwork::getOperationList(co
     operations_.emplace_back(op);
     auto left_intermediate = std::find(intermediates.begin(),intermediates.end(),contr->left_id);
     if(left_intermediate != intermediates.end()){
+     op->donateTensorOperand(1); //last use of the intermediate
      intermediates_vol -= tensor1->getVolume();
      auto op_destroy = tensor_op_factory.createTensorOp(TensorOpCode::DESTROY); //destroy intermediate
      op_destroy->setTensorOperand(tensor1);
@@ -2510,6 +2766,7 @@ std::list<std::shared_ptr<TensorOperation>> & TensorNetwork::getOperationList(co
     }
     auto right_intermediate = std::find(intermediates.begin(),intermediates.end(),contr->right_id);
     if(right_intermediate != intermediates.end()){
+     op->donateTensorOperand(2); //last use of the intermediate
      intermediates_vol -= tensor2->getVolume();
      auto op_destroy = tensor_op_factory.createTensorOp(TensorOpCode::DESTROY); //destroy intermediate
      op_destroy->setTensorOperand(tensor2);
@@ -2546,6 +2803,7 @@ std::list<std::shared_ptr<TensorOperation>> & TensorNetwork::getOperationList(co
    assert(op->isSet());
    operations_.emplace_back(std::shared_ptr<TensorOperation>(std::move(op)));
   }
+  planIntermediateMemory(); //static offsets of intermediates within a single workspace
   //std::cout << "#DEBUG(exatn::numerics::TensorNetwork::getOperationList): Flop count = " << flops
   //          << "; Max intermediate presence volume = " << max_intermediate_presence_volume_
   //          << "; Max intermediate volume = " << max_intermediate_volume_
@@ -2556,6 +2814,78 @@ std::list<std::shared_ptr<TensorOperation>> & TensorNetwork::getOperationList(co
 }
 
 
+void TensorNetwork::planIntermediateMemory()
+{
+ struct IntermediateLifetime{
+  TensorHashType tensor_hash; //intermediate tensor hash
+  std::size_t volume;         //intermediate tensor volume
+  std::size_t first;          //position of the CREATE operation in the operation list
+  std::size_t last;           //position of the DESTROY operation in the operation list
+  std::size_t offset;         //assigned offset in the workspace
+ };
+
+ intermediate_workspace_volume_ = 0.0;
+ intermediate_offsets_.clear();
+ //Determine the lifetimes of all intermediate tensors from the operation list:
+ std::vector<IntermediateLifetime> lifetimes;
+ std::unordered_map<TensorHashType,std::size_t> live; //tensor hash --> position in lifetimes
+ std::size_t op_pos = 0;
+ for(const auto & op: operations_){
+  const auto opcode = op->getOpcode();
+  if(opcode == TensorOpCode::CREATE){
+   const auto tensor = op->getTensorOperand(0);
+   const auto tensor_hash = tensor->getTensorHash();
+   auto res = live.emplace(std::make_pair(tensor_hash,lifetimes.size())); assert(res.second);
+   lifetimes.emplace_back(IntermediateLifetime{tensor_hash,tensor->getVolume(),op_pos,operations_.size(),0});
+  }else if(opcode == TensorOpCode::DESTROY){
+   auto iter = live.find(op->getTensorOperand(0)->getTensorHash());
+   if(iter != live.end()){
+    lifetimes[iter->second].last = op_pos;
+    live.erase(iter);
+   }
+  }
+  ++op_pos;
+ }
+ //Assign workspace offsets to intermediates in the order of decreasing volume,
+ //placing each intermediate into the smallest gap left by the already placed
+ //intermediates with overlapping lifetimes (best fit):
+ std::vector<std::size_t> order(lifetimes.size());
+ for(std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+ std::stable_sort(order.begin(),order.end(),[&lifetimes](const std::size_t & i1, const std::size_t & i2){
+                                             return lifetimes[i1].volume > lifetimes[i2].volume;
+                                            });
+ std::size_t workspace_volume = 0;
+ std::vector<std::pair<std::size_t,std::size_t>> occupied; //occupied workspace segments: [offset,end)
+ for(std::size_t i = 0; i < order.size(); ++i){
+  auto & intermediate = lifetimes[order[i]];
+  occupied.clear();
+  for(std::size_t j = 0; j < i; ++j){
+   const auto & placed = lifetimes[order[j]];
+   if(placed.first <= intermediate.last && intermediate.first <= placed.last){ //overlapping lifetimes
+    occupied.emplace_back(std::make_pair(placed.offset,placed.offset + placed.volume));
+   }
+  }
+  std::sort(occupied.begin(),occupied.end());
+  std::size_t best_offset = 0, best_gap = 0, prev_end = 0;
+  bool found = false;
+  for(const auto & segment: occupied){
+   if(segment.first > prev_end){
+    const auto gap = segment.first - prev_end;
+    if(gap >= intermediate.volume && (!found || gap < best_gap)){
+     best_offset = prev_end; best_gap = gap; found = true;
+    }
+   }
+   prev_end = std::max(prev_end,segment.second);
+  }
+  intermediate.offset = (found ? best_offset : prev_end);
+  workspace_volume = std::max(workspace_volume,intermediate.offset + intermediate.volume);
+  intermediate_offsets_[intermediate.tensor_hash] = intermediate.offset;
+ }
+ intermediate_workspace_volume_ = static_cast<double>(workspace_volume);
+ return;
+}
+
+
 void TensorNetwork::splitIndices(std::size_t max_intermediate_volume)
 {
  assert(!operations_.empty());
@@ -2939,6 +3269,216 @@ double TensorNetwork::getMaxIntermediateVolume(unsigned int * intermediate_rank)
 }
 
 
+double TensorNetwork::getIntermediateWorkspaceVolume() const
+{
+ return intermediate_workspace_volume_;
+}
+
+
+long long TensorNetwork::getIntermediateWorkspaceOffset(const Tensor & intermediate) const
+{
+ auto iter = intermediate_offsets_.find(intermediate.getTensorHash());
+ if(iter == intermediate_offsets_.end()) return -1;
+ return static_cast<long long>(iter->second);
+}
+
+
+void TensorNetwork::collectTensors(std::vector<std::shared_ptr<Tensor>> & tensors,
+                                   std::unordered_map<const Tensor*,unsigned int> & positions) const
+{
+ std::vector<unsigned int> tensor_ids;
+ tensor_ids.reserve(tensors_.size());
+ for(const auto & tens: tensors_) tensor_ids.emplace_back(tens.first);
+ std::sort(tensor_ids.begin(),tensor_ids.end()); //deterministic packing
+ for(const auto tensor_id: tensor_ids){
+  const auto & tensor = tensors_.at(tensor_id).getTensor();
+  auto res = positions.emplace(std::make_pair(tensor.get(),static_cast<unsigned int>(tensors.size())));
+  if(res.second) tensors.emplace_back(tensor);
+ }
+ return;
+}
+
+
+void TensorNetwork::packTensors(BytePacket & byte_packet,
+                                const std::vector<std::shared_ptr<Tensor>> & tensors)
+{
+ const std::size_t num_tensors = tensors.size();
+ appendToBytePacket(&byte_packet,num_tensors);
+ for(const auto & tensor: tensors){
+  const bool composite = tensor->isComposite();
+  appendToBytePacket(&byte_packet,composite);
+  tensor->pack(byte_packet); //composite tensors also pack their subtensors
+ }
+ return;
+}
+
+
+void TensorNetwork::unpackTensors(BytePacket & byte_packet,
+                                  std::vector<std::shared_ptr<Tensor>> & tensors)
+{
+ std::size_t num_tensors = 0;
+ extractFromBytePacket(&byte_packet,num_tensors);
+ tensors.clear();
+ tensors.reserve(num_tensors);
+ for(std::size_t i = 0; i < num_tensors; ++i){
+  bool composite = false;
+  extractFromBytePacket(&byte_packet,composite);
+  if(composite){
+   tensors.emplace_back(std::make_shared<TensorComposite>(byte_packet));
+  }else{
+   tensors.emplace_back(std::make_shared<Tensor>(byte_packet));
+  }
+ }
+ return;
+}
+
+
+void TensorNetwork::packTensorNetwork(BytePacket & byte_packet,
+                                      const std::unordered_map<const Tensor*,unsigned int> & positions) const
+{
+ const std::size_t name_len = name_.length();
+ appendToBytePacket(&byte_packet,name_len);
+ appendArrayToBytePacket(&byte_packet,name_.data(),name_len);
+ appendToBytePacket(&byte_packet,explicit_output_);
+ appendToBytePacket(&byte_packet,finalized_);
+ //Connected tensors (in the order of their ids):
+ std::vector<unsigned int> tensor_ids;
+ tensor_ids.reserve(tensors_.size());
+ for(const auto & tens: tensors_) tensor_ids.emplace_back(tens.first);
+ std::sort(tensor_ids.begin(),tensor_ids.end());
+ const std::size_t num_tensors = tensor_ids.size();
+ appendToBytePacket(&byte_packet,num_tensors);
+ std::vector<unsigned int> legs; //{connected tensor id, connected dimension, direction} for each leg
+ for(const auto tensor_id: tensor_ids){
+  const auto & tensor_conn = tensors_.at(tensor_id);
+  const auto position = positions.find(tensor_conn.getTensor().get());
+  assert(position != positions.cend());
+  appendToBytePacket(&byte_packet,tensor_id);
+  appendToBytePacket(&byte_packet,position->second);
+  const bool conjugated = tensor_conn.isComplexConjugated();
+  appendToBytePacket(&byte_packet,conjugated);
+  const bool optimizable = tensor_conn.isOptimizable();
+  appendToBytePacket(&byte_packet,optimizable);
+  legs.clear();
+  for(const auto & leg: tensor_conn.getTensorLegs()){
+   legs.emplace_back(leg.getTensorId());
+   legs.emplace_back(leg.getDimensionId());
+   legs.emplace_back(static_cast<unsigned int>(leg.getDirection()));
+  }
+  const std::size_t num_legs = legs.size() / 3;
+  appendToBytePacket(&byte_packet,num_legs);
+  appendArrayToBytePacket(&byte_packet,legs.data(),legs.size());
+ }
+ //Tensor contraction sequence:
+ std::vector<unsigned int> contr_seq;
+ packContractionSequenceIntoVector(contraction_seq_,contr_seq);
+ const std::size_t contr_seq_len = contr_seq.size();
+ appendToBytePacket(&byte_packet,contraction_seq_flops_);
+ appendToBytePacket(&byte_packet,contr_seq_len);
+ appendArrayToBytePacket(&byte_packet,contr_seq.data(),contr_seq_len);
+ //Split index info:
+ const std::size_t num_split_indices = split_indices_.size();
+ appendToBytePacket(&byte_packet,num_split_indices);
+ for(const auto & split_index: split_indices_){
+  const std::size_t label_len = split_index.first.length();
+  appendToBytePacket(&byte_packet,label_len);
+  appendArrayToBytePacket(&byte_packet,split_index.first.data(),label_len);
+  const std::size_t num_segments = split_index.second.size();
+  appendToBytePacket(&byte_packet,num_segments);
+  appendArrayToBytePacket(&byte_packet,split_index.second.data(),num_segments);
+ }
+ return;
+}
+
+
+void TensorNetwork::unpackTensorNetwork(BytePacket & byte_packet,
+                                        const std::vector<std::shared_ptr<Tensor>> & tensors)
+{
+ tensors_.clear();
+ has_isometries_ = 0;
+ max_tensor_id_ = 0;
+ invalidateContractionSequence();
+ bond_adaptivity_.reset();
+ std::size_t name_len = 0;
+ extractFromBytePacket(&byte_packet,name_len);
+ name_.resize(name_len);
+ if(name_len > 0) extractArrayFromBytePacket(&byte_packet,&(name_[0]),name_len);
+ extractFromBytePacket(&byte_packet,explicit_output_);
+ extractFromBytePacket(&byte_packet,finalized_);
+ //Connected tensors:
+ std::size_t num_tensors = 0;
+ extractFromBytePacket(&byte_packet,num_tensors);
+ std::vector<unsigned int> legs_content;
+ std::vector<TensorLeg> legs;
+ for(std::size_t i = 0; i < num_tensors; ++i){
+  unsigned int tensor_id = 0, position = 0;
+  bool conjugated = false, optimizable = false;
+  extractFromBytePacket(&byte_packet,tensor_id);
+  extractFromBytePacket(&byte_packet,position);
+  extractFromBytePacket(&byte_packet,conjugated);
+  extractFromBytePacket(&byte_packet,optimizable);
+  std::size_t num_legs = 0;
+  extractFromBytePacket(&byte_packet,num_legs);
+  legs_content.resize(num_legs * 3);
+  extractArrayFromBytePacket(&byte_packet,legs_content.data(),legs_content.size());
+  legs.clear();
+  for(std::size_t j = 0; j < num_legs; ++j){
+   legs.emplace_back(TensorLeg(legs_content[j*3],legs_content[j*3+1],static_cast<LegDirection>(legs_content[j*3+2])));
+  }
+  if(position >= tensors.size()){
+   std::cout << "#ERROR(exatn::numerics::TensorNetwork::unpack): Invalid tensor position in the byte packet: "
+             << position << std::endl;
+   assert(false);
+  }
+  auto emplaced = emplaceTensorConnDirect(false,tensor_id,tensors[position],tensor_id,legs,conjugated);
+  assert(emplaced);
+  tensors_.at(tensor_id).resetOptimizability(optimizable);
+ }
+ //Tensor contraction sequence:
+ std::size_t contr_seq_len = 0;
+ extractFromBytePacket(&byte_packet,contraction_seq_flops_);
+ extractFromBytePacket(&byte_packet,contr_seq_len);
+ std::vector<unsigned int> contr_seq(contr_seq_len);
+ extractArrayFromBytePacket(&byte_packet,contr_seq.data(),contr_seq_len);
+ unpackContractionSequenceFromVector(contraction_seq_,contr_seq);
+ //Split index info:
+ std::size_t num_split_indices = 0;
+ extractFromBytePacket(&byte_packet,num_split_indices);
+ for(std::size_t i = 0; i < num_split_indices; ++i){
+  std::size_t label_len = 0;
+  extractFromBytePacket(&byte_packet,label_len);
+  std::string label(label_len,' ');
+  if(label_len > 0) extractArrayFromBytePacket(&byte_packet,&(label[0]),label_len);
+  std::size_t num_segments = 0;
+  extractFromBytePacket(&byte_packet,num_segments);
+  IndexSplit split_info(num_segments);
+  extractArrayFromBytePacket(&byte_packet,split_info.data(),num_segments);
+  split_indices_.emplace_back(std::make_pair(label,split_info));
+ }
+ return;
+}
+
+
+void TensorNetwork::pack(BytePacket & byte_packet) const
+{
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ std::unordered_map<const Tensor*,unsigned int> positions;
+ collectTensors(tensors,positions);
+ packTensors(byte_packet,tensors);
+ packTensorNetwork(byte_packet,positions);
+ return;
+}
+
+
+void TensorNetwork::unpack(BytePacket & byte_packet)
+{
+ std::vector<std::shared_ptr<Tensor>> tensors;
+ unpackTensors(byte_packet,tensors);
+ unpackTensorNetwork(byte_packet,tensors);
+ return;
+}
+
+
 bool TensorNetwork::printTensorNetwork(std::string & network)
 {
  network.clear();
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor network
-REVISION: 2022/02/21
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -47,6 +47,32 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
  (e) The modes of the output tensor of a tensor network can be examined and reordered.
  (f) Any tensor except the output tensor can be deleted from the tensor network.
  (g) Any two tensors, excluding the output tensor, can be merged by tensor contraction.
+ (h) Local edits of a tensor network (appending, deleting, splitting or replacing a few tensors)
+     retain the previous tensor contraction sequence: The subtrees of the previous contraction
+     tree which do not involve modified tensors are reused as is, and only the remaining
+     (reduced) tensor network is re-optimized. Bond dimension changes preserve the tensor
+     contraction sequence, only its flop count is recomputed.
+ (i) The tensor operation list comes with a static memory plan for the intermediate tensors:
+     Each intermediate is assigned a fixed offset within a single workspace based on its
+     lifetime (from its CREATE to its DESTROY operation), such that intermediates with
+     disjoint lifetimes reuse the same space. The planned workspace volume is thus
+     free of fragmentation and can be used directly for deciding on slicing.
+ (j) Bond adaptivity steps can resize the adapted tensors in place via a user-provided
+     tensor resizer (e.g., the one of the numerical server which also resizes the stored
+     tensor bodies), thus keeping the identity of the tensors instead of replacing them
+     with renamed copies. A tensor shared by multiple bonds is resized only once.
+ (k) For 2D grid tensor networks, a boundary-MPS tensor contraction sequence can be imported:
+     The grid columns are absorbed one by one into the boundary (initially the first column),
+     each boundary tensor absorbing the grid tensor of its row, and the final boundary
+     is contracted row by row. Combined with the bond compression of the intermediates
+     (approximate evaluation by the numerical server), this is the boundary-MPS method.
+ (l) A tensor network can be packed into a byte packet (broadcast, persistent storage):
+     The tensors (each tensor shared by multiple connected tensors is packed once),
+     their connectivity, the tensor contraction sequence and the split index info.
+     The tensor operation list and the split info of its tensor operands, which are
+     keyed by the tensor hashes of the packing process, are regenerated after unpacking,
+     as is the bond adaptivity policy which is not packed. The unpacked tensors are new
+     tensor objects (with the same names), unless substituted by the existing ones.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_NETWORK_HPP_
@@ -62,6 +88,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include <fstream>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 #include <map>
 #include <vector>
 #include <list>
@@ -147,7 +174,7 @@ protected:
 };
 
 
-class TensorNetwork{
+class TensorNetwork: public Packable{
 
  friend class TensorExpansion;
 
@@ -183,6 +210,8 @@ public:
  TensorNetwork(const std::string & name,                      //in: new tensor network name (sub-network name)
                const TensorNetwork & another,                 //in: another tensor network
                const std::vector<unsigned int> & tensor_ids); //in: ids of the tensors forming a chosen tensor sub-network
+ /** Creates a tensor network from a byte packet (previously packed tensor network). **/
+ TensorNetwork(BytePacket & byte_packet);
 
  TensorNetwork(const TensorNetwork &) = default;
  TensorNetwork & operator=(const TensorNetwork &) = default;
@@ -190,6 +219,11 @@ public:
  TensorNetwork & operator=(TensorNetwork &&) noexcept = default;
  virtual ~TensorNetwork() = default;
 
+ /** Packs the tensor network into a byte packet, see (l). **/
+ virtual void pack(BytePacket & byte_packet) const override;
+ /** Unpacks the tensor network from a byte packet (replaces the current content). **/
+ virtual void unpack(BytePacket & byte_packet) override;
+
  /** Begin iterator **/
  inline Iterator begin() {return tensors_.begin();}
  /** End iterator **/
@@ -206,7 +240,7 @@ public:
 
  /** Prints **/
  void printIt(bool with_tensor_hash = false) const;
- void printItFile(std::ofstream & output_file,
+ void printItFile(std::ostream & output_file,
                   bool with_tensor_hash = false) const;
 
  /** Returns TRUE if the tensor network is empty, FALSE otherwise. **/
@@ -379,6 +413,15 @@ public:
  bool mergeTensors(const std::vector<unsigned int> & tensor_ids, //in: ids of the tensors to be merged
                    unsigned int result_id); //in: result tensor id (absent in the tensor network, to be appended)
 
+ /** Replaces two or more tensors in a finalized tensor network by a single given tensor
+     which stores their (precomputed) contracted product. Each mode of the given tensor
+     is matched with a boundary leg of the replaced tensors via its origin {tensor id, mode},
+     as recorded in the output tensor of the corresponding tensor sub-network. **/
+ bool replaceTensors(const std::vector<unsigned int> & tensor_ids, //in: ids of the tensors to be replaced
+                     unsigned int result_id,                       //in: result tensor id (absent in the tensor network, to be appended)
+                     std::shared_ptr<Tensor> tensor,               //in: replacing tensor (contracted product of the replaced tensors)
+                     const std::vector<std::pair<unsigned int, unsigned int>> & leg_origins); //in: origin {tensor id, mode} of each mode of the replacing tensor
+
  /** Splits a given tensor in a finalized tensor network into two tensors by introducing new dimensions
      across the cutting boundary. The original tensor dimensions are then assigned to either left or
      right tensor. The new dimensions are then appended to both tensors at the end. The two tensors
@@ -443,8 +486,14 @@ public:
  bool resetBondAdaptivity(std::shared_ptr<BondAdaptivity> bond_adaptivity);
 
  /** Performs a single adaptivity step based on the currently set bond adaptivity policy.
-     If no policy has been set, does nothing and returns FALSE. **/
- bool applyBondAdaptivityStep(bool invalidate = false); //whether to invalidate the cached tensor contraction sequence
+     If no policy has been set, does nothing and returns FALSE. By default, the adapted
+     tensors are replaced with their renamed copies of the new shape. If a tensor resizer
+     is provided, the adapted tensors are resized in place by it instead (tensor identity
+     is preserved). The tensor resizer must update the dimension extent of the given tensor. **/
+ bool applyBondAdaptivityStep(bool invalidate = false,                   //in: whether to invalidate the cached tensor contraction sequence
+                              std::function<bool (std::shared_ptr<Tensor>, //in: tensor resizer: tensor,
+                                                  unsigned int,             //                   tensor dimension,
+                                                  DimExtent)> resizer = nullptr); //             new dimension extent
 
  /** Partitions the tensor network into multiple parts by minimizing the weighted edge cut.
      The returned vector <parts> is:
@@ -482,8 +531,16 @@ public:
      The tensor network must contain at least two input tensors in order to generate a single contraction.
      No contraction sequence is generated for tensor networks consisting of a single input tensor.
      If the tensor network already has its contraction sequence determined, does nothing. Note that
-     the FMA flop count neither includes the FMA factor of 2.0 nor the factor of 4.0 for complex numbers.**/
- double determineContractionSequence(const std::string & contr_seq_opt_name = "metis");
+     the FMA flop count neither includes the FMA factor of 2.0 nor the factor of 4.0 for complex numbers.
+     If the memory limit is given, an optimizer supporting it will minimize the total FMA flop count
+     of the tensor network sliced under this memory limit (the returned flop count is still unsliced).
+     If the time budget is given, an optimizer supporting the anytime mode will keep improving
+     the tensor contraction sequence until the time budget expires (see ContractionSeqOptimizer). **/
+ double determineContractionSequence(const std::string & contr_seq_opt_name = "metis",
+                                     double max_intermediate_volume = 0.0,   //in: memory limit (max intermediate volume) for slicing-aware optimizers
+                                     double time_budget = 0.0,               //in: fixed wall-clock time budget (sec) for anytime optimizers
+                                     double contraction_time_fraction = 0.0, //in: time budget as a fraction of the estimated contraction time
+                                     double fma_flop_rate = 0.0);            //in: FMA flop rate for estimating the contraction time (FMA/sec)
 
  /** Imports and caches an externally provided tensor contraction sequence. **/
  void importContractionSequence(const std::list<ContrTriple> & contr_sequence, //in: imported tensor contraction sequence
@@ -493,6 +550,12 @@ public:
  void importContractionSequence(const std::vector<unsigned int> & contr_sequence_content, //in: imported tensor contraction sequence
                                 double fma_flops = 0.0); //in: FMA flop count for the imported tensor contraction sequence
 
+ /** Imports the boundary-MPS tensor contraction sequence for a 2D grid tensor network:
+     grid[c][r] is the id of the input tensor in row r of column c. All input tensors
+     of the tensor network must be present in the grid exactly once, all columns must
+     have the same number of rows. Returns FALSE if the grid is invalid (nothing is done). **/
+ bool importBoundaryMPSSequence(const std::vector<std::vector<unsigned int>> & grid); //in: grid of input tensor ids (columns of rows)
+
  /** Returns the currently stored tensor contraction sequence, if any. **/
  const std::list<ContrTriple> & exportContractionSequence(double * fma_flops = nullptr) const; //out: FMA flop count for the exported tensor contraction sequence
 
@@ -528,6 +591,14 @@ public:
      the tensor network (if getOperationList has already been invoked). **/
  double getMaxIntermediateVolume(unsigned int * intermediate_rank = nullptr) const;
 
+ /** Returns the volume of the single workspace holding all intermediate tensors
+     at their planned offsets (if getOperationList has already been invoked). **/
+ double getIntermediateWorkspaceVolume() const;
+
+ /** Returns the planned offset (in elements) of an intermediate tensor from the operation list
+     within the intermediate workspace, or -1 if the tensor is not a planned intermediate. **/
+ long long getIntermediateWorkspaceOffset(const Tensor & intermediate) const;
+
  /** Returns the FMA flop count estimate required for evaluating the tensor network,
      if available (if getOperationList has already been invoked). The FMA flop count estimate
      neither includes the FMA factor of 2.0 nor the factor of 4.0 for complex numbers. **/
@@ -602,9 +673,28 @@ protected:
  /** Invalidate the cached max tensor id. **/
  void invalidateMaxTensorId();
 
+ /** Packing of tensor networks sharing a table of tensors (each tensor is packed once):
+     Appends the tensors of the tensor network to the tensor table (tensor --> position). **/
+ void collectTensors(std::vector<std::shared_ptr<Tensor>> & tensors,
+                     std::unordered_map<const Tensor*,unsigned int> & positions) const;
+ /** Packs/unpacks the tensor table. **/
+ static void packTensors(BytePacket & byte_packet,
+                         const std::vector<std::shared_ptr<Tensor>> & tensors);
+ static void unpackTensors(BytePacket & byte_packet,
+                           std::vector<std::shared_ptr<Tensor>> & tensors);
+ /** Packs/unpacks the tensor network referring to the tensors by their position in the tensor table. **/
+ void packTensorNetwork(BytePacket & byte_packet,
+                        const std::unordered_map<const Tensor*,unsigned int> & positions) const;
+ void unpackTensorNetwork(BytePacket & byte_packet,
+                          const std::vector<std::shared_ptr<Tensor>> & tensors);
+
  /** Invalidates cached tensor contraction sequence. **/
  void invalidateContractionSequence();
 
+ /** Invalidates cached tensor contraction sequence after a local edit, retaining it
+     for the incremental repair around the modified (deleted or replaced) tensors. **/
+ void invalidateContractionSequence(const std::vector<unsigned int> & modified_tensors);
+
  /** Invalidates cached tensor operation list. **/
  void invalidateTensorOperationList();
 
@@ -621,6 +711,10 @@ protected:
      If the tensor operation list is empty, does nothing. **/
  void establishUniversalIndexNumeration();
 
+ /** Assigns static offsets within a single workspace to all intermediate tensors
+     from the generated tensor operation list based on their lifetimes. **/
+ void planIntermediateMemory();
+
 
 private:
 
@@ -633,6 +727,15 @@ private:
  void resetOutputTensor(const std::vector<unsigned int> & order, //in: new order of dimensions (N2O)
                         const std::string & name = ""); //in: new name of the output tensor (if empty, will be generated automatically)
 
+ /** Repairs the previous (invalidated) tensor contraction sequence by reusing its subtrees
+     not involving modified tensors and re-optimizing the rest of the tensor network.
+     Returns FALSE if there is nothing to reuse. **/
+ bool repairContractionSequence(ContractionSeqOptimizer & contr_seq_optimizer);
+
+ /** Recomputes the flop count of the cached tensor contraction sequence
+     (e.g., after changing bond dimensions). **/
+ double updateContractionSequenceFlops();
+
  /** Updates the max tensor id used in the tensor network when a tensor
      is either appended to or removed from the tensor network.  **/
  void updateMaxTensorIdOnAppend(unsigned int tensor_id);
@@ -653,7 +756,11 @@ private:
  double max_intermediate_presence_volume_; //max cumulative volume of intermediates present at a time
  double max_intermediate_volume_; //volume of the largest intermediate tensor
  unsigned int max_intermediate_rank_; //rank of the largest intermediate tensor
+ double intermediate_workspace_volume_; //volume of the workspace holding all intermediates at their planned offsets
+ std::unordered_map<TensorHashType,std::size_t> intermediate_offsets_; //intermediate tensor hash --> offset in the workspace
  std::list<ContrTriple> contraction_seq_; //cached tensor contraction sequence
+ std::list<ContrTriple> stale_contraction_seq_; //previous tensor contraction sequence (reused by the incremental repair)
+ std::unordered_set<unsigned int> stale_tensors_; //tensors modified since the previous tensor contraction sequence was determined
  std::list<std::shared_ptr<TensorOperation>> operations_; //cached tensor operations required for evaluating the tensor network
  std::vector<std::pair<std::string, //universal (unique) label of the index that was split
                        IndexSplit>  //information on the segments the index is split into
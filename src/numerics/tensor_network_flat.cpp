@@ -0,0 +1,130 @@
+/** ExaTN::Numerics: Tensor network: Flat connectivity
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_network_flat.hpp"
+#include "tensor_network.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+
+namespace exatn{
+
+namespace numerics{
+
+TensorNetworkFlat::TensorNetworkFlat(const TensorNetwork & network):
+ num_edges_(0)
+{
+ //Enumerate vertices (the output tensor is always vertex 0):
+ const std::size_t num_vertices = network.getNumTensors() + 1;
+ std::vector<const TensorConn *> tensors(num_vertices,nullptr);
+ tensor_ids_.reserve(num_vertices);
+ tensor_ids_.emplace_back(0);
+ unsigned int max_tensor_id = 0;
+ for(auto iter = network.cbegin(); iter != network.cend(); ++iter){
+  max_tensor_id = std::max(max_tensor_id,iter->first);
+  if(iter->first != 0){
+   tensors[tensor_ids_.size()] = &(iter->second);
+   tensor_ids_.emplace_back(iter->first);
+  }else{
+   tensors[0] = &(iter->second);
+  }
+ }
+ assert(tensor_ids_.size() == num_vertices && tensors[0] != nullptr);
+ vertices_.assign(max_tensor_id + 1,-1);
+ for(std::size_t vertex = 0; vertex < num_vertices; ++vertex) vertices_[tensor_ids_[vertex]] = static_cast<int>(vertex);
+ //Compute leg offsets:
+ leg_offsets_.resize(num_vertices + 1);
+ leg_offsets_[0] = 0;
+ for(std::size_t vertex = 0; vertex < num_vertices; ++vertex){
+  leg_offsets_[vertex + 1] = leg_offsets_[vertex] + tensors[vertex]->getNumLegs();
+ }
+ //Fill in the legs and assign edge ids:
+ const auto num_legs = leg_offsets_[num_vertices];
+ leg_vertices_.resize(num_legs);
+ leg_dims_.resize(num_legs);
+ leg_extents_.resize(num_legs);
+ leg_edges_.assign(num_legs,std::numeric_limits<unsigned int>::max());
+ for(std::size_t vertex = 0; vertex < num_vertices; ++vertex){
+  const auto & legs = tensors[vertex]->getTensorLegs();
+  const auto & extents = tensors[vertex]->getDimExtents();
+  const auto offset = leg_offsets_[vertex];
+  for(std::size_t i = 0; i < legs.size(); ++i){
+   const int other_vertex = getVertex(legs[i].getTensorId());
+   assert(other_vertex >= 0);
+   leg_vertices_[offset + i] = static_cast<unsigned int>(other_vertex);
+   leg_dims_[offset + i] = legs[i].getDimensionId();
+   leg_extents_[offset + i] = extents[i];
+   if(leg_edges_[offset + i] == std::numeric_limits<unsigned int>::max()){ //new edge
+    const auto other_leg = leg_offsets_[other_vertex] + legs[i].getDimensionId();
+    assert(other_leg < leg_offsets_[other_vertex + 1]);
+    leg_edges_[offset + i] = num_edges_;
+    leg_edges_[other_leg] = num_edges_;
+    ++num_edges_;
+   }
+  }
+ }
+}
+
+
+double TensorNetworkFlat::simulateContractionSequence(const std::list<ContrTriple> & contr_seq,
+                                                      std::vector<double> * contr_flops,
+                                                      std::function<bool (double)> abort) const
+{
+ //Pooled legs of all tensors {edge id, extent}: Input tensors first:
+ std::vector<std::pair<unsigned int, DimExtent>> pool;
+ pool.reserve(leg_edges_.size() * 2);
+ for(std::size_t i = 0; i < leg_edges_.size(); ++i) pool.emplace_back(std::make_pair(leg_edges_[i],leg_extents_[i]));
+ std::unordered_map<unsigned int, std::pair<std::size_t, std::size_t>> intermediates; //intermediate tensor id --> {offset, rank} in the pool
+ intermediates.reserve(contr_seq.size());
+ auto tensor_legs = [&](unsigned int tensor_id){
+  auto iter = intermediates.find(tensor_id);
+  if(iter != intermediates.end()) return iter->second;
+  const int vertex = getVertex(tensor_id); assert(vertex > 0);
+  return std::make_pair(leg_offsets_[vertex],leg_offsets_[vertex + 1] - leg_offsets_[vertex]);
+ };
+ std::vector<unsigned int> left_mark(num_edges_,0), contr_mark(num_edges_,0); //edge stamps
+ if(contr_flops != nullptr){contr_flops->clear(); contr_flops->reserve(contr_seq.size());}
+ double total_flops = 0.0;
+ unsigned int stamp = 0;
+ for(const auto & contr: contr_seq){
+  ++stamp;
+  const auto left = tensor_legs(contr.left_id);
+  const auto right = tensor_legs(contr.right_id);
+  double left_vol = 1.0, right_vol = 1.0, contr_vol = 1.0;
+  for(std::size_t i = left.first; i < left.first + left.second; ++i){
+   left_vol *= static_cast<double>(pool[i].second);
+   left_mark[pool[i].first] = stamp;
+  }
+  for(std::size_t i = right.first; i < right.first + right.second; ++i){
+   const double dim_ext = static_cast<double>(pool[i].second);
+   if(left_mark[pool[i].first] == stamp){ //contracted dimension
+    contr_vol *= dim_ext;
+    contr_mark[pool[i].first] = stamp;
+   }
+   right_vol *= dim_ext;
+  }
+  const double flops = left_vol * right_vol / contr_vol; //FMA flops (same as getTensorContractionCost)
+  total_flops += flops;
+  if(contr_flops != nullptr) contr_flops->emplace_back(flops);
+  if(abort && abort(total_flops)) return -1.0;
+  if(contr.result_id != 0){ //intermediate tensor: Uncontracted legs of the left tensor followed by those of the right tensor
+   const auto offset = pool.size();
+   for(std::size_t i = left.first; i < left.first + left.second; ++i){
+    if(contr_mark[pool[i].first] != stamp){const auto leg = pool[i]; pool.emplace_back(leg);}
+   }
+   for(std::size_t i = right.first; i < right.first + right.second; ++i){
+    if(contr_mark[pool[i].first] != stamp){const auto leg = pool[i]; pool.emplace_back(leg);}
+   }
+   intermediates[contr.result_id] = std::make_pair(offset,pool.size() - offset);
+  }
+ }
+ return total_flops;
+}
+
+} //namespace numerics
+
+} //namespace exatn
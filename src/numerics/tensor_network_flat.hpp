@@ -0,0 +1,101 @@
+/** ExaTN::Numerics: Tensor network: Flat connectivity
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A flat (read-only) snapshot of the connectivity of a tensor network for fast
+     traversals: Tensors are densely indexed by vertex ids (vertex 0 is always the
+     output tensor, input tensors follow in the iteration order of the tensor network),
+     and the legs of all tensors are stored in contiguous arrays (compressed sparse
+     row format) together with their dimension extents. Each tensor network edge
+     (a pair of connected legs) is assigned a unique edge id.
+ (b) The flat connectivity can simulate a tensor contraction sequence (the flop count
+     of each tensor contraction) without copying and modifying the tensor network.
+     The simulated flop count coincides with TensorNetwork::getContractionCost.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_NETWORK_FLAT_HPP_
+#define EXATN_NUMERICS_TENSOR_NETWORK_FLAT_HPP_
+
+#include "tensor_basic.hpp"
+#include "contraction_seq_optimizer.hpp"
+
+#include <list>
+#include <vector>
+#include <functional>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class TensorNetwork;
+
+
+class TensorNetworkFlat{
+
+public:
+
+ /** Constructs the flat connectivity of a given tensor network. **/
+ explicit TensorNetworkFlat(const TensorNetwork & network);
+
+ TensorNetworkFlat(const TensorNetworkFlat &) = default;
+ TensorNetworkFlat & operator=(const TensorNetworkFlat &) = default;
+ TensorNetworkFlat(TensorNetworkFlat &&) noexcept = default;
+ TensorNetworkFlat & operator=(TensorNetworkFlat &&) noexcept = default;
+ ~TensorNetworkFlat() = default;
+
+ /** Returns the number of input tensors (vertices 1..N). **/
+ inline std::size_t getNumTensors() const {return tensor_ids_.size() - 1;}
+
+ /** Returns the number of tensor network edges. **/
+ inline std::size_t getNumEdges() const {return num_edges_;}
+
+ /** Returns the tensor id of a given vertex. **/
+ inline unsigned int getTensorId(std::size_t vertex) const {return tensor_ids_[vertex];}
+
+ /** Returns the vertex of a given tensor id (negative if the tensor is not found). **/
+ inline int getVertex(unsigned int tensor_id) const {
+  return (tensor_id < vertices_.size()) ? vertices_[tensor_id] : -1;
+ }
+
+ /** Returns the rank of a given vertex. **/
+ inline unsigned int getRank(std::size_t vertex) const {
+  return static_cast<unsigned int>(leg_offsets_[vertex+1] - leg_offsets_[vertex]);
+ }
+
+ /** Returns the legs of a given vertex: Connected vertices, their dimensions,
+     dimension extents and edge ids (arrays of the vertex rank). **/
+ inline const unsigned int * getLegVertices(std::size_t vertex) const {return &(leg_vertices_[leg_offsets_[vertex]]);}
+ inline const unsigned int * getLegDimensions(std::size_t vertex) const {return &(leg_dims_[leg_offsets_[vertex]]);}
+ inline const DimExtent * getLegExtents(std::size_t vertex) const {return &(leg_extents_[leg_offsets_[vertex]]);}
+ inline const unsigned int * getLegEdges(std::size_t vertex) const {return &(leg_edges_[leg_offsets_[vertex]]);}
+
+ /** Simulates a tensor contraction sequence and returns its total FMA flop count.
+     The simulation is aborted (returning a negative value) as soon as the abort predicate
+     returns TRUE for the accumulated flop count. The individual tensor contraction costs
+     can optionally be returned. **/
+ double simulateContractionSequence(const std::list<ContrTriple> & contr_seq,                //in: tensor contraction sequence
+                                    std::vector<double> * contr_flops = nullptr,             //out: individual tensor contraction costs
+                                    std::function<bool (double)> abort = nullptr) const;    //in: abort predicate
+
+private:
+
+ std::vector<unsigned int> tensor_ids_;    //vertex --> tensor id
+ std::vector<int> vertices_;               //tensor id --> vertex (-1: absent)
+ std::vector<std::size_t> leg_offsets_;    //vertex --> offset of its first leg (CSR)
+ std::vector<unsigned int> leg_vertices_;  //leg --> connected vertex
+ std::vector<unsigned int> leg_dims_;      //leg --> connected dimension
+ std::vector<DimExtent> leg_extents_;      //leg --> dimension extent
+ std::vector<unsigned int> leg_edges_;     //leg --> edge id
+ std::size_t num_edges_;                   //number of edges
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_NETWORK_FLAT_HPP_
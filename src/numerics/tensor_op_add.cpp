@@ -95,6 +95,15 @@ std::size_t TensorOpAdd::decompose(const TensorMapper & tensor_mapper)
     end1 = comp_tens1->end();
     num_subtensors1 = comp_tens1->getNumSubtensors();
    }
+   //Subtensor owners (composite-aware):
+   auto first_owner0 = [&](unsigned long long subtensor_id){
+    return comp_tens0 ? tensor_mapper.subtensorFirstOwnerId(*comp_tens0,subtensor_id)
+                      : tensor_mapper.subtensorFirstOwnerId(subtensor_id,num_subtensors0);
+   };
+   auto owner1 = [&](unsigned int target_process_rank, unsigned long long subtensor_id){
+    return comp_tens1 ? tensor_mapper.subtensorOwnerId(target_process_rank,*comp_tens1,subtensor_id)
+                      : tensor_mapper.subtensorOwnerId(target_process_rank,subtensor_id,num_subtensors1);
+   };
    //Send local tensor slices to remote processes:
    std::stack<std::shared_ptr<Tensor>> slices; //temporary tensor slices
    for(auto subtens1 = beg1; subtens1 != end1; ++subtens1){
@@ -126,10 +135,10 @@ std::size_t TensorOpAdd::decompose(const TensorMapper & tensor_mapper)
          op->setTensorOperand(subtens1->second);
         }
        }
-       const auto tensor_owner_first = tensor_mapper.subtensorFirstOwnerId(subtens0->first,num_subtensors0);
+       const auto tensor_owner_first = first_owner0(subtens0->first);
        for(auto tensor_owner = tensor_owner_first; tensor_owner < num_procs; tensor_owner += num_subtensors0){
         if(tensor_owner != proc_rank){ //consider only remote processes
-         if(tensor_mapper.subtensorOwnerId(tensor_owner,subtens1->first,num_subtensors1) == proc_rank){//Upload the intersection slice to a remote process:
+         if(owner1(tensor_owner,subtens1->first) == proc_rank){//Upload the intersection slice to a remote process:
           comm_distance.emplace_back(std::make_pair(process_distance(proc_rank,tensor_owner),simple_operations.size()));
           simple_operations.emplace_back(std::move(TensorOpUpload::createNew()));
           auto & op = simple_operations.back();
@@ -159,7 +168,7 @@ std::size_t TensorOpAdd::decompose(const TensorMapper & tensor_mapper)
        if(slice) slice->rename();
       }
       if(slice){
-       const auto tensor_owner = tensor_mapper.subtensorOwnerId(subtens1->first,num_subtensors1);
+       const auto tensor_owner = owner1(proc_rank,subtens1->first);
        if(!congruent){//Create the tensor intersection slice:
         comm_distance.emplace_back(std::make_pair(-1,simple_operations.size()));
         simple_operations.emplace_back(std::move(TensorOpCreate::createNew()));
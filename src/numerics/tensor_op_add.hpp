@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Adds a tensor to another tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Adds a tensor to another tensor inside the processing backend:
@@ -33,6 +33,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpAdd(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpAdd>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: All-reduces a tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -15,7 +15,8 @@ namespace exatn{
 namespace numerics{
 
 TensorOpAllreduce::TensorOpAllreduce():
- TensorOperation(TensorOpCode::ALLREDUCE,1,0,1,{0})
+ TensorOperation(TensorOpCode::ALLREDUCE,1,0,1,{0}),
+ reduced_precision_(false), root_rank_(-1)
 {
 }
 
@@ -46,6 +47,28 @@ const MPICommProxy & TensorOpAllreduce::getMPICommunicator() const
  return intra_comm_;
 }
 
+bool TensorOpAllreduce::resetReducedPrecisionTransfer(bool reduced)
+{
+ reduced_precision_ = reduced;
+ return true;
+}
+
+bool TensorOpAllreduce::reducedPrecisionTransfer() const
+{
+ return reduced_precision_;
+}
+
+bool TensorOpAllreduce::resetRootRank(int rank)
+{
+ root_rank_ = rank;
+ return true;
+}
+
+int TensorOpAllreduce::getRootRank() const
+{
+ return root_rank_;
+}
+
 std::size_t TensorOpAllreduce::decompose(const TensorMapper & tensor_mapper)
 {
  assert(false);
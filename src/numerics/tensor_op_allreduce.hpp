@@ -1,11 +1,16 @@
 /** ExaTN::Numerics: Tensor operation: All-reduces a tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) All-reduces a tensor inside the execution backend.
+ (b) A tensor of double precision may be transferred in single precision (lossy),
+     halving the communicated volume, if the reduced-precision transfer is set.
+     All participating MPI processes must agree on the reduced-precision transfer.
+ (c) If the root rank is set, the tensor is only reduced to the root process
+     (in full precision), leaving the tensor on other processes unchanged.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_ALLREDUCE_HPP_
@@ -34,6 +39,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpAllreduce(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpAllreduce>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -55,9 +63,23 @@ public:
  /** Returns the MPI communicator. **/
  const MPICommProxy & getMPICommunicator() const;
 
+ /** Resets the reduced-precision (lossy) transfer of a double precision tensor. **/
+ bool resetReducedPrecisionTransfer(bool reduced);
+
+ /** Returns TRUE if the double precision tensor is to be transferred in single precision. **/
+ bool reducedPrecisionTransfer() const;
+
+ /** Resets the root rank within the MPI communicator (negative: allreduce, non-negative: reduce to root). **/
+ bool resetRootRank(int rank);
+
+ /** Returns the root rank within the MPI communicator (negative for allreduce). **/
+ int getRootRank() const;
+
 private:
 
  MPICommProxy intra_comm_; //MPI intra-communicator
+ bool reduced_precision_; //reduced-precision (lossy) transfer of a double precision tensor
+ int root_rank_; //root rank of the reduction (negative: allreduce)
 };
 
 } //namespace numerics
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Broadcasts a tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -16,7 +16,7 @@ namespace numerics{
 
 TensorOpBroadcast::TensorOpBroadcast():
  TensorOperation(TensorOpCode::BROADCAST,1,0,1,{0}),
- root_rank_(0)
+ reduced_precision_(false), root_rank_(0)
 {
 }
 
@@ -47,6 +47,17 @@ const MPICommProxy & TensorOpBroadcast::getMPICommunicator() const
  return intra_comm_;
 }
 
+bool TensorOpBroadcast::resetReducedPrecisionTransfer(bool reduced)
+{
+ reduced_precision_ = reduced;
+ return true;
+}
+
+bool TensorOpBroadcast::reducedPrecisionTransfer() const
+{
+ return reduced_precision_;
+}
+
 bool TensorOpBroadcast::resetRootRank(unsigned int rank)
 {
  root_rank_ = static_cast<int>(rank);
@@ -1,11 +1,14 @@
 /** ExaTN::Numerics: Tensor operation: Broadcasts a tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Broadcasts a tensor inside the execution backend.
+ (b) A tensor of double precision may be transferred in single precision (lossy),
+     halving the communicated volume, if the reduced-precision transfer is set.
+     All participating MPI processes must agree on the reduced-precision transfer.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_BROADCAST_HPP_
@@ -34,6 +37,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpBroadcast(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpBroadcast>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -55,6 +61,12 @@ public:
  /** Returns the MPI communicator. **/
  const MPICommProxy & getMPICommunicator() const;
 
+ /** Resets the reduced-precision (lossy) transfer of a double precision tensor. **/
+ bool resetReducedPrecisionTransfer(bool reduced);
+
+ /** Returns TRUE if the double precision tensor is to be transferred in single precision. **/
+ bool reducedPrecisionTransfer() const;
+
  /** Resets the broadcast root rank. **/
  bool resetRootRank(unsigned int rank);
 
@@ -64,6 +76,7 @@ public:
 private:
 
  MPICommProxy intra_comm_; //MPI intra-communicator
+ bool reduced_precision_; //reduced-precision (lossy) transfer of a double precision tensor
  int root_rank_; //MPI broadcast root process rank
 };
 
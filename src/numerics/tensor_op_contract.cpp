@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Contracts two tensors and accumulates the result into another tensor
-REVISION: 2021/11/03
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -10,7 +10,14 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_node_executor.hpp"
 
+#include "functor_init_val.hpp"
+#include "functor_scale.hpp"
+
 #include <cmath>
+#include <tuple>
+#include <map>
+#include <stack>
+#include <algorithm>
 
 namespace exatn{
 
@@ -54,6 +61,14 @@ std::unique_ptr<TensorOperation> TensorOpContract::createNew()
 void TensorOpContract::resetAccumulative(bool accum)
 {
  accumulative_ = accum;
+ this->setScalar(1,accum ? std::complex<double>{1.0,0.0} : std::complex<double>{0.0,0.0});
+ return;
+}
+
+void TensorOpContract::resetBeta(const std::complex<double> beta)
+{
+ accumulative_ = (beta != std::complex<double>{0.0,0.0});
+ this->setScalar(1,beta);
  return;
 }
 
@@ -94,7 +109,7 @@ void TensorOpContract::determineNumBisections(unsigned int num_processes,
  *bisect_contr = 0;
  *bisect_hyper = 0;
 
- const auto tens_elem_size = TensorElementTypeSize(getTensorOperand(2)->getElementType());
+ const auto tens_elem_size = TensorElementTypeSize(tensorComputeElementType(getTensorOperand(2)->getElementType()));
  auto dim_left = getCombinedDimExtent(IndexKind::LEFT);
  auto dim_right = getCombinedDimExtent(IndexKind::RIGHT);
  auto dim_contr = getCombinedDimExtent(IndexKind::CONTR);
@@ -323,16 +338,279 @@ void TensorOpContract::introduceOptTemporaries(unsigned int num_processes, std::
 
 std::size_t TensorOpContract::decompose(const TensorMapper & tensor_mapper)
 {
+ const bool optimized_communication = true; //activates tensor operation sorting for optimized communication
+
  if(this->isComposite()){
   if(simple_operations_.empty()){
    //Identify parallel configuration:
    const auto num_procs = tensor_mapper.getNumProcesses();
    const auto proc_rank = tensor_mapper.getProcessRank();
    const auto & intra_comm = tensor_mapper.getMPICommProxy();
+   std::vector<std::shared_ptr<TensorOperation>> simple_operations;
+   std::vector<std::pair<int, std::size_t>> comm_distance; //{communication distance, operation position}
+
+   auto process_distance = [&num_procs](unsigned int proc0, unsigned int proc1){
+    int dist = proc0 <= proc1 ? static_cast<int>(proc1-proc0) :
+                                static_cast<int>(num_procs-(proc0-proc1));
+    return dist;
+   };
+
+   auto comp_lt = [](const std::pair<int, std::size_t> & item0,
+                     const std::pair<int, std::size_t> & item1){
+    return (item0.first < item1.first);
+   };
+
    //Proceed with decomposition:
-   assert(index_info_);
-   //`Finish
-   std::abort(); //`debug
+   if(!index_info_){
+    std::vector<std::string> tensors;
+    std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
+    auto parsed = parse_tensor_contraction(getIndexPattern(),tensors,left_inds,right_inds,contr_inds,hyper_inds);
+    if(!parsed){
+     std::cout << "#ERROR(TensorOpContract:decompose): Invalid tensor contraction specification: "
+               << getIndexPattern() << std::endl << std::flush;
+     assert(false);
+    }
+    index_info_ = std::make_shared<IndexInfo>(left_inds,right_inds,contr_inds,hyper_inds);
+   }
+   const std::vector<const std::vector<PosIndexLabel>*> indices {&(index_info_->left_indices_),
+                                                                 &(index_info_->right_indices_),
+                                                                 &(index_info_->contr_indices_),
+                                                                 &(index_info_->hyper_indices_)};
+
+   //Restricts a (sub)tensor of a tensor operand to the index ranges of a (sub)tensor of another tensor operand:
+   auto restrict_to = [&indices](std::shared_ptr<Tensor> tensor, unsigned int opnd,
+                                 const Tensor & other, unsigned int other_opnd){
+    const auto tensor_rank = tensor->getRank();
+    std::vector<SubspaceId> subspaces(tensor_rank);
+    std::vector<DimExtent> extents(tensor_rank);
+    for(unsigned int i = 0; i < tensor_rank; ++i){
+     subspaces[i] = tensor->getDimSubspaceId(i);
+     extents[i] = tensor->getDimExtent(i);
+    }
+    bool restricted = false;
+    for(const auto * inds: indices){
+     for(const auto & ind: *inds){
+      if(ind.arg_pos[opnd] >= 0 && ind.arg_pos[other_opnd] >= 0){
+       subspaces[ind.arg_pos[opnd]] = other.getDimSubspaceId(ind.arg_pos[other_opnd]);
+       extents[ind.arg_pos[opnd]] = other.getDimExtent(ind.arg_pos[other_opnd]);
+       restricted = true;
+      }
+     }
+    }
+    if(!restricted) return tensor;
+    auto window = tensor->createSubtensor(subspaces,extents);
+    auto slice = makeSharedTensorIntersection("_",*tensor,*window);
+    if(slice){
+     if(slice->isCongruentTo(*tensor)) return tensor;
+     slice->rename();
+    }
+    return slice;
+   };
+
+   //Prepare (composite) tensor operands:
+   using Block = std::pair<unsigned long long, std::shared_ptr<Tensor>>; //{subtensor id, subtensor}
+   std::vector<Block> blocks[3];
+   unsigned long long num_blocks[3];
+   std::shared_ptr<TensorComposite> composites[3];
+   bool conjugated[3];
+   for(unsigned int opnd = 0; opnd < 3; ++opnd){
+    auto tensor = getTensorOperand(opnd,&(conjugated[opnd]));
+    auto comp_tens = castTensorComposite(tensor);
+    composites[opnd] = comp_tens;
+    if(comp_tens){
+     for(auto subtens = comp_tens->begin(); subtens != comp_tens->end(); ++subtens) blocks[opnd].emplace_back(*subtens);
+     num_blocks[opnd] = comp_tens->getNumSubtensors();
+    }else{
+     blocks[opnd].emplace_back(Block{0,tensor});
+     num_blocks[opnd] = 1;
+    }
+   }
+
+   //Subtensor owners (composite-aware):
+   auto first_owner = [&](unsigned int opnd, unsigned long long subtensor_id){
+    return composites[opnd] ? tensor_mapper.subtensorFirstOwnerId(*(composites[opnd]),subtensor_id)
+                            : tensor_mapper.subtensorFirstOwnerId(subtensor_id,num_blocks[opnd]);
+   };
+   auto owner = [&](unsigned int target_process_rank, unsigned int opnd, unsigned long long subtensor_id){
+    return composites[opnd] ? tensor_mapper.subtensorOwnerId(target_process_rank,*(composites[opnd]),subtensor_id)
+                            : tensor_mapper.subtensorOwnerId(target_process_rank,subtensor_id,num_blocks[opnd]);
+   };
+
+   //Slices of the input subtensors required by the owners of the destination subtensors:
+   using SliceKey = std::tuple<unsigned int, unsigned int, unsigned long long, std::vector<std::size_t>>;
+   std::map<SliceKey, std::shared_ptr<Tensor>> staged; //{destination process, operand, subtensor id, slice} --> local slice
+   std::stack<std::shared_ptr<Tensor>> slices; //temporary tensor slices
+   int message_tag = 0; //message tags enumerate all transfers consistently across all processes
+
+   //Makes the slice of an input subtensor available on the process computing a destination subtensor:
+   auto stage_slice = [&](unsigned int owner, unsigned int opnd, const Block & block,
+                          std::shared_ptr<Tensor> slice, unsigned int source){
+    std::vector<std::size_t> dims;
+    for(unsigned int i = 0; i < slice->getRank(); ++i){
+     dims.emplace_back(slice->getDimSubspaceId(i));
+     dims.emplace_back(slice->getDimExtent(i));
+    }
+    auto res = staged.emplace(std::make_pair(SliceKey{owner,opnd,block.first,dims},std::shared_ptr<Tensor>{nullptr}));
+    if(!res.second) return res.first->second; //already staged
+    const bool remote = (source != owner);
+    const int tag = (remote ? message_tag++ : -1);
+    const bool whole = (slice.get() == block.second.get());
+    const auto tens_elem_type = block.second->getElementType();
+    auto create_slice = [&](std::shared_ptr<Tensor> tens, int distance){
+     comm_distance.emplace_back(std::make_pair(distance,simple_operations.size()));
+     simple_operations.emplace_back(std::move(TensorOpCreate::createNew()));
+     auto & op = simple_operations.back();
+     op->setTensorOperand(tens);
+     std::dynamic_pointer_cast<TensorOpCreate>(op)->resetTensorElementType(tens_elem_type);
+     slices.emplace(tens); //stack of slices to be destroyed later
+    };
+    auto extract_slice = [&](std::shared_ptr<Tensor> tens){
+     comm_distance.emplace_back(std::make_pair(-1,simple_operations.size()));
+     simple_operations.emplace_back(std::move(TensorOpSlice::createNew()));
+     auto & op = simple_operations.back();
+     op->setTensorOperand(tens);
+     op->setTensorOperand(block.second);
+    };
+    if(owner == proc_rank){
+     if(!remote){ //slice is local
+      if(!whole){
+       create_slice(slice,-1);
+       extract_slice(slice);
+      }
+     }else{ //slice is remote
+      if(whole){
+       slice = std::make_shared<Tensor>(*slice);
+       slice->rename();
+      }
+      const auto distance = 2 * process_distance(source,proc_rank);
+      create_slice(slice,distance);
+      //Fetch the (remote) slice:
+      comm_distance.emplace_back(std::make_pair(distance,simple_operations.size()));
+      simple_operations.emplace_back(std::move(TensorOpFetch::createNew()));
+      auto & op = simple_operations.back();
+      op->setTensorOperand(slice);
+      std::dynamic_pointer_cast<TensorOpFetch>(op)->resetMPICommunicator(intra_comm);
+      auto success = std::dynamic_pointer_cast<TensorOpFetch>(op)->resetRemoteProcessRank(source); assert(success);
+      success = std::dynamic_pointer_cast<TensorOpFetch>(op)->resetMessageTag(tag); assert(success);
+     }
+     res.first->second = slice;
+    }else if(remote && source == proc_rank){ //send the local slice to the remote process:
+     if(!whole){
+      create_slice(slice,-1);
+      extract_slice(slice);
+     }
+     comm_distance.emplace_back(std::make_pair(-1,simple_operations.size()));
+     simple_operations.emplace_back(std::move(TensorOpUpload::createNew()));
+     auto & op = simple_operations.back();
+     op->setTensorOperand(slice);
+     std::dynamic_pointer_cast<TensorOpUpload>(op)->resetMPICommunicator(intra_comm);
+     auto success = std::dynamic_pointer_cast<TensorOpUpload>(op)->resetRemoteProcessRank(owner); assert(success);
+     success = std::dynamic_pointer_cast<TensorOpUpload>(op)->resetMessageTag(tag); assert(success);
+    }
+    return res.first->second;
+   };
+
+   //Initialize the local destination subtensors (non-accumulative tensor contraction):
+   if(!accumulative_){
+    for(const auto & dblock: blocks[0]){
+     if(tensor_mapper.isLocalSubtensor(*(dblock.second))){
+      comm_distance.emplace_back(std::make_pair(-2,simple_operations.size()));
+      simple_operations.emplace_back(std::move(TensorOpTransform::createNew()));
+      auto & op = simple_operations.back();
+      op->setTensorOperand(dblock.second);
+      std::dynamic_pointer_cast<TensorOpTransform>(op)->
+       resetFunctor(std::shared_ptr<talsh::TensorFunctor<Identifiable>>(new FunctorInitVal(0.0)));
+     }
+    }
+   }else if(getBeta() != std::complex<double>{1.0,0.0}){ //scaled accumulation: Scale the local destination subtensors
+    for(const auto & dblock: blocks[0]){
+     if(tensor_mapper.isLocalSubtensor(*(dblock.second))){
+      comm_distance.emplace_back(std::make_pair(-2,simple_operations.size()));
+      simple_operations.emplace_back(std::move(TensorOpTransform::createNew()));
+      auto & op = simple_operations.back();
+      op->setTensorOperand(dblock.second);
+      std::dynamic_pointer_cast<TensorOpTransform>(op)->
+       resetFunctor(std::shared_ptr<talsh::TensorFunctor<Identifiable>>(new FunctorScale(getBeta())));
+     }
+    }
+   }
+   //Owner-computes: Each owner of a destination subtensor accumulates all block contractions contributing to it.
+   //All processes enumerate the same global schedule, thus matching their fetches and uploads:
+   for(const auto & dblock: blocks[0]){
+    const auto dest_owner_first = first_owner(0,dblock.first);
+    for(auto dest_owner = dest_owner_first; dest_owner < num_procs; dest_owner += num_blocks[0]){
+     for(const auto & lblock: blocks[1]){
+      auto left = restrict_to(lblock.second,1,*(dblock.second),0);
+      if(!left) continue;
+      const auto left_owner = owner(dest_owner,1,lblock.first);
+      for(const auto & rblock: blocks[2]){
+       auto right = restrict_to(rblock.second,2,*(dblock.second),0);
+       if(!right) continue;
+       auto left_slice = restrict_to(left,1,*right,2);
+       if(!left_slice) continue;
+       auto right_slice = restrict_to(right,2,*left_slice,1); assert(right_slice);
+       const auto right_owner = owner(dest_owner,2,rblock.first);
+       auto left_local = stage_slice(dest_owner,1,lblock,left_slice,left_owner);
+       auto right_local = stage_slice(dest_owner,2,rblock,right_slice,right_owner);
+       if(dest_owner == proc_rank){
+        assert(left_local && right_local);
+        auto dest_slice = restrict_to(dblock.second,0,*left_slice,1); assert(dest_slice);
+        dest_slice = restrict_to(dest_slice,0,*right_slice,2); assert(dest_slice);
+        const bool whole = (dest_slice.get() == dblock.second.get());
+        //Block contractions are issued after the fetches of their operand slices:
+        const auto distance = 2 * std::max(process_distance(left_owner,proc_rank),
+                                           process_distance(right_owner,proc_rank)) + 1;
+        if(!whole){//Create the destination slice:
+         comm_distance.emplace_back(std::make_pair(distance,simple_operations.size()));
+         simple_operations.emplace_back(std::move(TensorOpCreate::createNew()));
+         auto & op = simple_operations.back();
+         op->setTensorOperand(dest_slice);
+         std::dynamic_pointer_cast<TensorOpCreate>(op)->resetTensorElementType(dblock.second->getElementType());
+         slices.emplace(dest_slice); //stack of slices to be destroyed later
+        }
+        {//Contract the operand slices:
+         comm_distance.emplace_back(std::make_pair(distance,simple_operations.size()));
+         simple_operations.emplace_back(std::move(TensorOpContract::createNew()));
+         auto & op = simple_operations.back();
+         op->setTensorOperand(dest_slice,conjugated[0]);
+         op->setTensorOperand(left_local,conjugated[1]);
+         op->setTensorOperand(right_local,conjugated[2]);
+         op->setIndexPattern(getIndexPattern());
+         op->setScalar(0,getScalar(0));
+         std::dynamic_pointer_cast<TensorOpContract>(op)->resetAccumulative(whole);
+        }
+        if(!whole){//Accumulate the destination slice into the destination subtensor:
+         comm_distance.emplace_back(std::make_pair(distance,simple_operations.size()));
+         simple_operations.emplace_back(std::move(TensorOpInsert::createNew()));
+         auto & op = simple_operations.back();
+         op->setTensorOperand(dblock.second);
+         op->setTensorOperand(dest_slice);
+         std::dynamic_pointer_cast<TensorOpInsert>(op)->resetAccumulative(true);
+        }
+       }
+      }
+     }
+    }
+   }
+   assert(message_tag >= 0); //message tag overflow
+   //Destroy temporary slices:
+   while(!slices.empty()){
+    comm_distance.emplace_back(std::make_pair(static_cast<int>(2*num_procs+2),simple_operations.size()));
+    simple_operations.emplace_back(std::move(TensorOpDestroy::createNew()));
+    auto & op = simple_operations.back();
+    op->setTensorOperand(slices.top());
+    slices.pop();
+   }
+   //Sort generated simple tensor operations for optimal execution:
+   if(optimized_communication){
+    const auto num_ops = simple_operations.size();
+    assert(comm_distance.size() == num_ops);
+    std::stable_sort(comm_distance.begin(),comm_distance.end(),comp_lt);
+    simple_operations_.resize(num_ops);
+    for(std::size_t i = 0; i < num_ops; ++i) simple_operations_[i] = std::move(simple_operations[comm_distance[i].second]);
+   }else{
+    simple_operations_ = std::move(simple_operations);
+   }
   }
  }
  return simple_operations_.size();
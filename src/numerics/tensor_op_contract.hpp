@@ -1,13 +1,27 @@
 /** ExaTN::Numerics: Tensor operation: Contracts two tensors and accumulates the result into another tensor
-REVISION: 2021/09/24
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Contracts two tensors and accumulates the result into another tensor
      inside the processing backend:
-     Operand 0 += Operand 1 * Operand 2 * prefactor
+     Operand 0 = Operand 0 * beta + Operand 1 * Operand 2 * alpha
+     The alpha prefactor is scalar 0, the beta prefactor is scalar 1: An accumulative
+     tensor contraction has beta = 1 by default, a non-accumulative one has beta = 0
+     (overwrites the destination tensor). Any other beta scales the destination tensor
+     before the accumulation, such that a scaled accumulation into an existing tensor
+     does not require a separate scaling pass.
+ (b) A composite tensor contraction is decomposed by the owner-computes rule:
+     Each owner of a destination subtensor accumulates the contractions of
+     all pairs of overlapping slices of the left and right subtensors into it,
+     fetching the remote slices from their closest owners (each slice is fetched
+     once per process). In a block-aligned decomposition this reproduces the
+     SUMMA schedule over the contracted dimensions, with subtensor replicas acting
+     as the third dimension of a 2.5D process grid. The block contractions are
+     ordered by the communication distance of their operand slices, such that
+     the fetches of the more distant slices overlap with the computation.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_CONTRACT_HPP_
@@ -39,6 +53,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpContract(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpContract>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -65,6 +82,15 @@ public:
   return accumulative_;
  }
 
+ /** Resets the beta prefactor (scaling of the destination tensor before accumulation).
+     A zero beta makes the tensor contraction non-accumulative. **/
+ void resetBeta(const std::complex<double> beta);
+
+ /** Returns the beta prefactor (zero for non-accumulative tensor contractions). **/
+ inline std::complex<double> getBeta() const {
+  return accumulative_ ? this->getScalar(1) : std::complex<double>{0.0,0.0};
+ }
+
  /** Replaces none, some, or all tensor operands with new temporary
      tensors with optimized distributed storage configuration
      (only for composite tensor contractions). **/
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Creates a tensor
-REVISION: 2021/07/26
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -16,7 +16,7 @@ namespace numerics{
 
 TensorOpCreate::TensorOpCreate():
  TensorOperation(TensorOpCode::CREATE,1,0,1,{0}),
- element_type_(TensorElementType::REAL64)
+ element_type_(TensorElementType::REAL64), ext_body_(nullptr)
 {
 }
 
@@ -42,10 +42,16 @@ void TensorOpCreate::resetTensorElementType(TensorElementType element_type)
  return;
 }
 
+void TensorOpCreate::resetExternalBody(void * body)
+{
+ ext_body_ = body;
+ return;
+}
+
 void TensorOpCreate::printIt() const
 {
  std::cout << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) std::cout << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) std::cout << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -67,10 +73,10 @@ void TensorOpCreate::printIt() const
  return;
 }
 
-void TensorOpCreate::printItFile(std::ofstream & output_file) const
+void TensorOpCreate::printItFile(std::ostream & output_file) const
 {
  output_file << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) output_file << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) output_file << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -99,9 +105,8 @@ std::size_t TensorOpCreate::decompose(const TensorMapper & tensor_mapper)
   if(simple_operations_.empty()){
    auto tensor0 = getTensorOperand(0);
    auto composite_tensor0 = castTensorComposite(tensor0); assert(composite_tensor0);
-   const auto num_subtensors = composite_tensor0->getNumSubtensors();
    for(auto subtensor_iter = composite_tensor0->begin(); subtensor_iter != composite_tensor0->end(); ++subtensor_iter){
-    if(tensor_mapper.isLocalSubtensor(subtensor_iter->first,num_subtensors)){
+    if(tensor_mapper.isLocalSubtensor(*composite_tensor0,subtensor_iter->first)){
      simple_operations_.emplace_back(std::move(TensorOpCreate::createNew()));
      auto & op = simple_operations_.back();
      op->setTensorOperand(subtensor_iter->second);
@@ -1,11 +1,14 @@
 /** ExaTN::Numerics: Tensor operation: Creates a tensor
-REVISION: 2021/07/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Creates a tensor inside the processing backend.
+ (b) The tensor body can optionally be provided externally, in which case
+     the processing backend will not allocate (and will not free) it.
+     The external body must stay alive until the tensor is destroyed.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_CREATE_HPP_
@@ -34,6 +37,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpCreate(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpCreate>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -48,7 +54,7 @@ public:
 
  /** Prints. **/
  virtual void printIt() const override;
- virtual void printItFile(std::ofstream & output_file) const override;
+ virtual void printItFile(std::ostream & output_file) const override;
 
  /** Create a new polymorphic instance of this subclass. **/
  static std::unique_ptr<TensorOperation> createNew();
@@ -61,9 +67,18 @@ public:
   return element_type_;
  }
 
+ /** Resets the externally provided tensor body (nullptr: allocated by the backend). **/
+ void resetExternalBody(void * body);
+
+ /** Returns the externally provided tensor body (nullptr if none). **/
+ inline void * getExternalBody() const {
+  return ext_body_;
+ }
+
 private:
 
  TensorElementType element_type_; //tensor element type
+ void * ext_body_;                //externally provided tensor body (non-owning)
 };
 
 } //namespace numerics
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Decomposes a tensor into two tensor factors via SVD
-REVISION: 2021/07/15
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -15,7 +15,8 @@ namespace exatn{
 namespace numerics{
 
 TensorOpDecomposeSVD2::TensorOpDecomposeSVD2():
- TensorOperation(TensorOpCode::DECOMPOSE_SVD2,3,0,1+1*2+0*4,{1,2,0})
+ TensorOperation(TensorOpCode::DECOMPOSE_SVD2,3,0,1+1*2+0*4,{1,2,0}),
+ randomized_(false), truncation_tolerance_(0.0)
 {
 }
 
@@ -35,6 +36,24 @@ std::unique_ptr<TensorOperation> TensorOpDecomposeSVD2::createNew()
  return std::unique_ptr<TensorOperation>(new TensorOpDecomposeSVD2());
 }
 
+bool TensorOpDecomposeSVD2::resetTruncation(bool randomized, double tolerance)
+{
+ if(tolerance < 0.0) return false;
+ randomized_ = randomized;
+ truncation_tolerance_ = tolerance;
+ return true;
+}
+
+bool TensorOpDecomposeSVD2::randomizedTruncation() const
+{
+ return randomized_;
+}
+
+double TensorOpDecomposeSVD2::getTruncationTolerance() const
+{
+ return truncation_tolerance_;
+}
+
 std::size_t TensorOpDecomposeSVD2::decompose(const TensorMapper & tensor_mapper)
 {
  assert(false);
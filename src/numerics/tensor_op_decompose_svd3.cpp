@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Decomposes a tensor into three tensor factors via SVD
-REVISION: 2021/07/15
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -16,7 +16,7 @@ namespace numerics{
 
 TensorOpDecomposeSVD3::TensorOpDecomposeSVD3():
  TensorOperation(TensorOpCode::DECOMPOSE_SVD3,4,0,1+1*2+1*4+0*8,{1,2,-1,0}),
- absorb_singular_values_('N')
+ absorb_singular_values_('N'), randomized_(false), truncation_tolerance_(0.0)
 {
 }
 
@@ -47,6 +47,24 @@ bool TensorOpDecomposeSVD3::resetAbsorptionMode(const char absorb_mode)
  return true;
 }
 
+bool TensorOpDecomposeSVD3::resetTruncation(bool randomized, double tolerance)
+{
+ if(tolerance < 0.0) return false;
+ randomized_ = randomized;
+ truncation_tolerance_ = tolerance;
+ return true;
+}
+
+bool TensorOpDecomposeSVD3::randomizedTruncation() const
+{
+ return randomized_;
+}
+
+double TensorOpDecomposeSVD3::getTruncationTolerance() const
+{
+ return truncation_tolerance_;
+}
+
 std::size_t TensorOpDecomposeSVD3::decompose(const TensorMapper & tensor_mapper)
 {
  assert(false);
@@ -1,14 +1,18 @@
 /** ExaTN::Numerics: Tensor operation: Decomposes a tensor into three tensor factors via SVD
-REVISION: 2021/07/15
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Decomposes a tensor into three tensor factors via SVD, for example:
      D(a,b,c,d,e) = L(c,i,e,j) * S(i,j)    * R(d,j,a,b,i)
      Operand 3    = Operand 0  * Operand 2 * Operand 1
      Note that the ordering of the contracted indices is not guaranteed.
+ (b) The target rank of the truncated SVD is the total extent of the contracted (bond) indices
+     of the tensor factors. In the truncated mode, the bond factors may be computed by the randomized
+     range finder (only the leading singular triplets) instead of the full SVD, and singular values
+     not exceeding the truncation tolerance are discarded (zeroed).
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_DECOMPOSE_SVD3_HPP_
@@ -35,6 +39,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpDecomposeSVD3(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpDecomposeSVD3>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -53,9 +60,22 @@ public:
  /** Resets the absorption mode for the singular values factor: {'N','L','R','S'} **/
  bool resetAbsorptionMode(const char absorb_mode = 'N');
 
+ /** Resets the truncated mode: The randomized truncated SVD computes only the leading singular
+     triplets retained by the tensor factors, singular values not exceeding the tolerance are discarded. **/
+ bool resetTruncation(bool randomized,         //in: randomized truncated SVD (TRUE) or full SVD (FALSE)
+                      double tolerance = 0.0); //in: singular values not exceeding the tolerance are discarded
+
+ /** Returns TRUE if the randomized truncated SVD is requested. **/
+ bool randomizedTruncation() const;
+
+ /** Returns the singular value truncation tolerance. **/
+ double getTruncationTolerance() const;
+
 private:
 
  char absorb_singular_values_; //regulates the absorption of the singular values factor
+ bool randomized_;              //randomized truncated SVD
+ double truncation_tolerance_;  //singular values not exceeding the tolerance are discarded
 };
 
 } //namespace numerics
@@ -41,9 +41,8 @@ std::size_t TensorOpDestroy::decompose(const TensorMapper & tensor_mapper)
   if(simple_operations_.empty()){
    auto tensor0 = getTensorOperand(0);
    auto composite_tensor0 = castTensorComposite(tensor0); assert(composite_tensor0);
-   const auto num_subtensors = composite_tensor0->getNumSubtensors();
    for(auto subtensor_iter = composite_tensor0->begin(); subtensor_iter != composite_tensor0->end(); ++subtensor_iter){
-    if(tensor_mapper.isLocalSubtensor(subtensor_iter->first,num_subtensors)){
+    if(tensor_mapper.isLocalSubtensor(*composite_tensor0,subtensor_iter->first)){
      simple_operations_.emplace_back(std::move(TensorOpDestroy::createNew()));
      auto & op = simple_operations_.back();
      op->setTensorOperand(subtensor_iter->second);
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Extracts a slice from a tensor
-REVISION: 2021/07/27
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -16,7 +16,7 @@ namespace numerics{
 
 TensorOpSlice::TensorOpSlice():
  TensorOperation(TensorOpCode::SLICE,2,0,1+0*2,{0,1}),
- accumulative_(false)
+ accumulative_(false), read_only_(false)
 {
 }
 
@@ -42,6 +42,12 @@ void TensorOpSlice::resetAccumulative(bool accum)
  return;
 }
 
+void TensorOpSlice::resetReadOnly(bool read_only)
+{
+ read_only_ = read_only;
+ return;
+}
+
 std::size_t TensorOpSlice::decompose(const TensorMapper & tensor_mapper)
 {
  assert(false);
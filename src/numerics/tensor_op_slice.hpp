@@ -1,12 +1,15 @@
 /** ExaTN::Numerics: Tensor operation: Extracts a slice from a tensor
-REVISION: 2021/07/27
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Extracts a slice from a tensor inside the processing backend:
      Operand 0 (slice) <= Operand 1
+ (b) A read-only slice is only read after its extraction, until its destruction,
+     thus the processing backend may alias its body to the body of the parental
+     tensor instead of copying the data (the slice is then a zero-copy view).
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_SLICE_HPP_
@@ -33,6 +36,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpSlice(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpSlice>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -56,9 +62,18 @@ public:
   return accumulative_;
  }
 
+ /** Resets the read-only attribute of the tensor slice. **/
+ void resetReadOnly(bool read_only);
+
+ /** Queries the read-only attribute of the tensor slice. **/
+ inline bool isReadOnly() const {
+  return read_only_;
+ }
+
 private:
 
  bool accumulative_; //accumulative or not (default)
+ bool read_only_;    //whether or not the tensor slice is read-only (may alias the parental tensor body)
 };
 
 } //namespace numerics
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Transforms/initializes a tensor
-REVISION: 2021/07/22
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -15,7 +15,7 @@ namespace exatn{
 namespace numerics{
 
 TensorOpTransform::TensorOpTransform():
- TensorOperation(TensorOpCode::TRANSFORM,1,1,1,{0})
+ TensorOperation(TensorOpCode::TRANSFORM,1,1,1,{0}), read_only_(false)
 {
  this->setScalar(0,std::complex<double>{0.0,0.0}); //default numerical initialization value
 }
@@ -42,13 +42,13 @@ std::size_t TensorOpTransform::decompose(const TensorMapper & tensor_mapper)
   if(simple_operations_.empty()){
    auto tensor0 = getTensorOperand(0);
    auto composite_tensor0 = castTensorComposite(tensor0); assert(composite_tensor0);
-   const auto num_subtensors = composite_tensor0->getNumSubtensors();
    for(auto subtensor_iter = composite_tensor0->begin(); subtensor_iter != composite_tensor0->end(); ++subtensor_iter){
-    if(tensor_mapper.isLocalSubtensor(subtensor_iter->first,num_subtensors)){
+    if(tensor_mapper.isLocalSubtensor(*composite_tensor0,subtensor_iter->first)){
      simple_operations_.emplace_back(std::move(TensorOpTransform::createNew()));
      auto & op = simple_operations_.back();
      op->setTensorOperand(subtensor_iter->second);
      std::dynamic_pointer_cast<TensorOpTransform>(op)->resetFunctor(getFunctor());
+     std::dynamic_pointer_cast<TensorOpTransform>(op)->resetReadOnly(isReadOnly());
     }
    }
   }
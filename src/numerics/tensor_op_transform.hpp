@@ -1,13 +1,16 @@
 /** ExaTN::Numerics: Tensor operation: Transforms/initializes a tensor
-REVISION: 2021/07/19
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Transforms/initializes a tensor inside the processing backend.
      Requires a user-provided talsh::TensorFunctor object to concretize
      the transformation/initilization operation.
+ (b) A read-only tensor transformation only inspects the tensor (for example,
+     computes its norm), thus it does not count as a write into the tensor
+     (it does not bump the tensor version tracked by the tensor runtime).
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OP_TRANSFORM_HPP_
@@ -38,6 +41,9 @@ public:
  virtual std::unique_ptr<TensorOperation> clone() const override{
   return std::unique_ptr<TensorOperation>(new TensorOpTransform(*this));
  }
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const override{
+  return std::allocate_shared<TensorOpTransform>(allocator,*this);
+ }
 
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const override;
@@ -67,9 +73,21 @@ public:
   return 0;
  }
 
+ /** Resets the read-only attribute of the tensor transformation. **/
+ void resetReadOnly(bool read_only){
+  read_only_ = read_only;
+  return;
+ }
+
+ /** Queries the read-only attribute of the tensor transformation. **/
+ bool isReadOnly() const{
+  return read_only_;
+ }
+
 private:
 
  std::shared_ptr<talsh::TensorFunctor<Identifiable>> functor_; //tensor functor (method)
+ bool read_only_; //whether or not the tensor functor only inspects the tensor
 };
 
 } //namespace numerics
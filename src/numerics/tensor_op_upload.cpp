@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation: Uploads remote tensor data
-REVISION: 2021/07/28
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "exatn_service.hpp"
 
@@ -72,7 +72,7 @@ int TensorOpUpload::getMessageTag() const
 void TensorOpUpload::printIt() const
 {
  std::cout << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) std::cout << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) std::cout << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -94,10 +94,10 @@ void TensorOpUpload::printIt() const
  return;
 }
 
-void TensorOpUpload::printItFile(std::ofstream & output_file) const
+void TensorOpUpload::printItFile(std::ostream & output_file) const
 {
  output_file << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) output_file << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) output_file << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -1,12 +1,16 @@
 /** ExaTN::Numerics: Tensor operation
-REVISION: 2021/07/13
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_operation.hpp"
 #include "tensor_symbol.hpp"
 
+#include <unordered_set>
+#include <unordered_map>
+#include <mutex>
+
 #include <iostream>
 #include <ios>
 
@@ -19,13 +23,29 @@ TensorOperation::TensorOperation(TensorOpCode opcode,
                                  unsigned int num_scalars,
                                  std::size_t mutability,
                                  std::initializer_list<int> symbolic_positions):
- symb_pos_(symbolic_positions), num_operands_(num_operands), num_scalars_(num_scalars),
- mutation_(mutability), opcode_(opcode), id_(0), repeatable_(true),
- scalars_(num_scalars,std::complex<double>{0.0,0.0})
+ pattern_(internIndexPattern(std::string())),
+ symb_pos_(symbolic_positions), scalars_(num_scalars,std::complex<double>{0.0,0.0}),
+ num_operands_(num_operands), num_scalars_(num_scalars),
+ mutation_(mutability), donation_(0), opcode_(opcode), id_(0), repeatable_(true), priority_(TensorOpPriority::NORMAL),
+ commutative_(false), precision_(TensorOpPrecision::DEFAULT), precision_tolerance_(0.0),
+ device_(TensorOpDevice::ANY)
 {
  operands_.reserve(num_operands);
 }
 
+const std::string * TensorOperation::internIndexPattern(const std::string & pattern)
+{
+ static std::mutex patterns_lock;
+ static std::unordered_set<std::string> patterns; //element references are stable
+ std::lock_guard<std::mutex> lock(patterns_lock);
+ return &(*(patterns.emplace(pattern).first));
+}
+
+std::shared_ptr<TensorOperation> TensorOperation::clone(const ArenaAllocator<TensorOperation> & allocator) const
+{
+ return std::shared_ptr<TensorOperation>(this->clone());
+}
+
 bool TensorOperation::isComposite() const
 {
  bool is_composite = this->isSet();
@@ -60,7 +80,7 @@ double TensorOperation::getWordEstimate() const
 void TensorOperation::printIt() const
 {
  std::cout << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) std::cout << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) std::cout << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -82,10 +102,10 @@ void TensorOperation::printIt() const
  return;
 }
 
-void TensorOperation::printItFile(std::ofstream & output_file) const
+void TensorOperation::printItFile(std::ostream & output_file) const
 {
  output_file << "TensorOperation(opcode=" << static_cast<int>(opcode_) << ")[id=" << id_ << "]{" << std::endl;
- if(pattern_.length() > 0) output_file << " " << pattern_ << std::endl;
+ if(pattern_->length() > 0) output_file << " " << *pattern_ << std::endl;
  for(const auto & operand: operands_){
   const auto & tensor = std::get<0>(operand);
   if(tensor != nullptr){
@@ -150,6 +170,20 @@ bool TensorOperation::operandIsMutable(unsigned int op_num) const
  return std::get<2>(operands_[op_num]);
 }
 
+bool TensorOperation::operandIsDonated(unsigned int op_num) const
+{
+ assert(op_num < operands_.size());
+ return ((donation_ >> op_num) & (0x1U)) != 0;
+}
+
+void TensorOperation::donateTensorOperand(unsigned int op_num)
+{
+ assert(op_num < operands_.size());
+ assert(!std::get<2>(operands_[op_num])); //only immutable (input) tensor operands can be donated
+ donation_ |= (std::size_t{1} << op_num);
+ return;
+}
+
 std::shared_ptr<Tensor> TensorOperation::getTensorOperand(unsigned int op_num,
                                                           bool * conjugated,
                                                           bool * mutated) const
@@ -224,16 +258,43 @@ void TensorOperation::setScalar(unsigned int scalar_num, const std::complex<doub
 
 const std::string & TensorOperation::getIndexPattern() const
 {
- return pattern_;
+ return *pattern_;
 }
 
 std::string TensorOperation::getIndexPatternReduced() const
+{
+ if(pattern_->length() == 0) return std::string();
+ //Reduction key: {interned index pattern, opcode, symbolic operand positions, extent-1 dimensions of the operands}:
+ std::string key(reinterpret_cast<const char*>(&pattern_),sizeof(pattern_));
+ key += static_cast<char>(opcode_);
+ const auto num_operands = this->getNumOperands();
+ for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
+  const auto & tensor = *(this->getTensorOperand(oprnd));
+  key += static_cast<char>(symb_pos_[oprnd]);
+  const auto rank = tensor.getRank();
+  for(unsigned int i = 0; i < rank; ++i) key += ((tensor.getDimExtent(i) > 1) ? '1' : '0');
+  key += '|';
+ }
+ static std::mutex reduced_lock;
+ static std::unordered_map<std::string,const std::string*> reduced_patterns; //reduction key --> interned reduced pattern
+ {
+  std::lock_guard<std::mutex> lock(reduced_lock);
+  auto iter = reduced_patterns.find(key);
+  if(iter != reduced_patterns.end()) return *(iter->second);
+ }
+ const auto * reduced = internIndexPattern(reduceIndexPattern());
+ std::lock_guard<std::mutex> lock(reduced_lock);
+ reduced_patterns.emplace(std::make_pair(std::move(key),reduced));
+ return *reduced;
+}
+
+std::string TensorOperation::reduceIndexPattern() const
 {
  std::string reduced;
- if(pattern_.length() > 0){
+ if(pattern_->length() > 0){
   const auto num_operands = this->getNumOperands();
   std::vector<std::string> tensors;
-  auto parsed = parse_tensor_network(pattern_,tensors);
+  auto parsed = parse_tensor_network(*pattern_,tensors);
   if(parsed){
    const auto num_tensors = tensors.size();
    assert(num_tensors == num_operands);
@@ -258,7 +319,7 @@ std::string TensorOperation::getIndexPatternReduced() const
      }else{
       std::cout << "#ERROR(exatn::numerics::TensorOperation::getIndexPatternReduced): "
                 << "Unable to parse tensor operand " << symb_pos_[oprnd]
-                << " in symbolic tensor operation specification: " << pattern_ << std::endl;
+                << " in symbolic tensor operation specification: " << *pattern_ << std::endl;
       assert(false);
      }
     }
@@ -270,7 +331,7 @@ std::string TensorOperation::getIndexPatternReduced() const
   }else{
    std::cout << "#ERROR(exatn::numerics::TensorOperation::getIndexPatternReduced): "
              << "Unable to parse the symbolic tensor operation specification: "
-             << pattern_ << std::endl;
+             << *pattern_ << std::endl;
    assert(false);
   }
  }
@@ -280,7 +341,7 @@ std::string TensorOperation::getIndexPatternReduced() const
 void TensorOperation::setIndexPattern(const std::string & pattern)
 {
  if(operands_.size() == num_operands_ && scalars_.size() == num_scalars_){
-  pattern_ = pattern;
+  pattern_ = internIndexPattern(pattern);
  }else{
   std::cout << "#ERROR(exatn::numerics::TensorOperation::setIndexPattern): "
             << "Index pattern cannot be set until all operands and scalars have been set!\n";
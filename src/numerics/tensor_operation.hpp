@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operation
-REVISION: 2021/08/19
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) A tensor operation is a formal numerical operation on one or more tensors.
@@ -11,6 +11,35 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
  (c) A tensor operation may be either simple or composite. A tensor operation is
      composite when at least one tensor operand is composite. A composite tensor
      operation is decomposed into two or more simple tensor operations.
+ (d) A tensor operation carries a latency class (TensorOpPriority) which is honored
+     by the tensor runtime when choosing among the tensor operations ready for execution.
+     The simple tensor operations of a composite tensor operation inherit its latency class.
+ (e) A tensor operation accumulating into its (single) output tensor operand may be flagged
+     as a commutative accumulation, in which case the tensor runtime is free to execute
+     it in any order with respect to other commutative accumulations into the same tensor
+     (but never concurrently with them). Such a tensor operation must not read its output
+     tensor operand other than for the accumulation itself.
+ (f) A tensor operation carries a precision policy (TensorOpPrecision) which is honored
+     by the node executors supporting mixed-precision (fast) math: The AUTO policy selects
+     the reduced precision only if the estimated absolute error bound stays within the
+     tolerance carried by the tensor operation. The simple tensor operations of a composite
+     tensor operation inherit its precision policy.
+ (g) A tensor operation may carry an execution device class (TensorOpDevice) which is
+     honored by the node executors as a placement constraint (ANY leaves the choice
+     to the node executor). The simple tensor operations of a composite tensor operation
+     inherit its execution device class.
+ (h) The tensor operands, scalar arguments and symbolic operand positions are stored
+     inline (without heap allocation) for up to TENSOR_OP_OPERANDS_INLINE tensor operands,
+     which covers all basic tensor operations. The symbolic index patterns are interned
+     (stored once per distinct pattern), thus creating and copying a basic tensor operation
+     does not allocate heap memory for these components in the common case.
+ (i) A tensor operation can be cloned into an object arena, such that the per-slice
+     clones of the tensor operations of a sliced tensor network are allocated in bulk
+     and freed in bulk once the tensor runtime retires them.
+ (j) An immutable (input) tensor operand may be marked as donated when the tensor operation
+     is its last use (the tensor is destroyed right after), in which case the node executor
+     is free to reuse or discard its buffer (or any cached copy of it) once the tensor
+     operation has consumed it.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OPERATION_HPP_
@@ -20,6 +49,8 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_symbol.hpp"
 #include "tensor.hpp"
 #include "tensor_composite.hpp"
+#include "small_vector.hpp"
+#include "object_arena.hpp"
 #include "timers.hpp"
 
 #include <initializer_list>
@@ -73,6 +104,33 @@ public:
  /** Returns whether or not the given subtensor is owned by the current process. **/
  virtual bool isLocalSubtensor(const numerics::Tensor & subtensor) const = 0; //in: subtensor
 
+ /** Composite-aware versions of the above, which may account for the actual subtensor sizes.
+     By default, they fall back to the subtensor-id based mapping. **/
+ virtual unsigned int subtensorOwnerId(unsigned int target_process_rank,            //in: target process rank
+                                       const numerics::TensorComposite & composite, //in: composite tensor
+                                       unsigned long long subtensor_id) const       //in: subtensor id (binary mask)
+ {
+  return subtensorOwnerId(target_process_rank,subtensor_id,composite.getNumSubtensors());
+ }
+
+ virtual unsigned int subtensorOwnerId(const numerics::TensorComposite & composite, //in: composite tensor
+                                       unsigned long long subtensor_id) const       //in: subtensor id (binary mask)
+ {
+  return subtensorOwnerId(subtensor_id,composite.getNumSubtensors());
+ }
+
+ virtual unsigned int subtensorFirstOwnerId(const numerics::TensorComposite & composite, //in: composite tensor
+                                            unsigned long long subtensor_id) const       //in: subtensor id (binary mask)
+ {
+  return subtensorFirstOwnerId(subtensor_id,composite.getNumSubtensors());
+ }
+
+ virtual bool isLocalSubtensor(const numerics::TensorComposite & composite, //in: composite tensor
+                               unsigned long long subtensor_id) const       //in: subtensor id (binary mask)
+ {
+  return isLocalSubtensor(subtensor_id,composite.getNumSubtensors());
+ }
+
  /** Returns the amount of memory per process. **/
  virtual std::size_t getMemoryPerProcess() const = 0;
 
@@ -119,6 +177,10 @@ public:
 
  virtual std::unique_ptr<TensorOperation> clone() const = 0;
 
+ /** Clones the tensor operation into an object arena (per-slice tensor operations).
+     The default implementation allocates the clone on the heap. **/
+ virtual std::shared_ptr<TensorOperation> clone(const ArenaAllocator<TensorOperation> & allocator) const;
+
  /** Returns TRUE iff the tensor operation is fully set. **/
  virtual bool isSet() const = 0;
 
@@ -161,7 +223,7 @@ public:
 
  /** Prints. **/
  virtual void printIt() const;
- virtual void printItFile(std::ofstream & output_file) const;
+ virtual void printItFile(std::ostream & output_file) const;
 
  /** Returns the tensor operation code (opcode). **/
  TensorOpCode getOpcode() const;
@@ -186,6 +248,13 @@ public:
      (whether or not the operand is mutated during the tensor operation). **/
  bool operandIsMutable(unsigned int op_num) const;
 
+ /** Returns whether or not a tensor operand is donated, that is, the tensor operation
+     is its last use such that its buffer can be reused by the node executor. **/
+ bool operandIsDonated(unsigned int op_num) const;
+
+ /** Marks an immutable tensor operand as donated (last use). **/
+ void donateTensorOperand(unsigned int op_num);
+
  /** Returns a co-owned pointer to a specific tensor operand, or nullptr if not yet set. **/
  std::shared_ptr<Tensor> getTensorOperand(unsigned int op_num,             //in: operand position
                                           bool * conjugated = nullptr,     //out: complex conjugation status
@@ -221,7 +290,8 @@ public:
  /** Returns a reduced symbolic tensor operation specification (index pattern)
      in which indices associated with tensor dimensions of extent 1 are removed.
      Also, specifically for tensor operation DECOMPOSE_SVD3, the middle SVD
-     tensor will be removed completely per requirements of the TAL-SH backend. **/
+     tensor will be removed completely per requirements of the TAL-SH backend.
+     The reduced index patterns are memoized per {index pattern, tensor operand shapes}. **/
  std::string getIndexPatternReduced() const;
 
  /** Sets the symbolic tensor operation specification (index pattern).
@@ -238,6 +308,57 @@ public:
  /** Returns a unique integer hash for the tensor operation. **/
  TensorHashType getTensorOpHash() const;
 
+ /** Sets the latency class (priority) of the tensor operation. **/
+ inline void setPriority(TensorOpPriority priority){
+  priority_ = priority;
+  return;
+ }
+
+ /** Returns the latency class (priority) of the tensor operation. **/
+ inline TensorOpPriority getPriority() const{
+  return priority_;
+ }
+
+ /** Sets the precision policy of the tensor operation (with the absolute error tolerance for AUTO). **/
+ inline void setPrecision(TensorOpPrecision precision,
+                          double tolerance = 0.0){
+  precision_ = precision;
+  precision_tolerance_ = tolerance;
+  return;
+ }
+
+ /** Returns the precision policy of the tensor operation. **/
+ inline TensorOpPrecision getPrecision() const{
+  return precision_;
+ }
+
+ /** Returns the absolute error tolerance of the AUTO precision policy. **/
+ inline double getPrecisionTolerance() const{
+  return precision_tolerance_;
+ }
+
+ /** Flags/unflags the tensor operation as a commutative accumulation into its output tensor operand. **/
+ inline void setCommutativeAccumulation(bool commutative){
+  commutative_ = commutative;
+  return;
+ }
+
+ /** Returns TRUE if the tensor operation is a commutative accumulation into its output tensor operand. **/
+ inline bool isCommutativeAccumulation() const{
+  return commutative_;
+ }
+
+ /** Sets the execution device class of the tensor operation. **/
+ inline void setExecutionDevice(TensorOpDevice device){
+  device_ = device;
+  return;
+ }
+
+ /** Returns the execution device class of the tensor operation. **/
+ inline TensorOpDevice getExecutionDevice() const{
+  return device_;
+ }
+
  /** Records the start time stamp for tensor operation execution. **/
  inline bool recordStartTime(){
   return timer_.start();
@@ -270,19 +391,31 @@ private:
                        bool conjugated,                //in: complex conjugation status
                        bool mutated);                  //in: mutability status
 
+ /** Returns the interned copy of a symbolic index pattern. **/
+ static const std::string * internIndexPattern(const std::string & pattern);
+
 protected:
 
+ /** Computes the reduced symbolic tensor operation specification (see getIndexPatternReduced). **/
+ std::string reduceIndexPattern() const;
+
  std::vector<std::shared_ptr<TensorOperation>> simple_operations_; //container of simple tensor operations for composite operation decomposition
- std::string pattern_; //symbolic index pattern
- const std::vector<int> symb_pos_; //symb_pos_[operand_position] --> operand position in the symbolic index pattern;
- std::vector<std::tuple<std::shared_ptr<Tensor>,bool,bool>> operands_; //tensor operands <operand,conjugation,mutation>
- std::vector<std::complex<double>> scalars_; //additional scalars (prefactors)
+ const std::string * pattern_; //symbolic index pattern (interned)
+ const SmallVector<int,TENSOR_OP_OPERANDS_INLINE> symb_pos_; //symb_pos_[operand_position] --> operand position in the symbolic index pattern;
+ SmallVector<std::tuple<std::shared_ptr<Tensor>,bool,bool>,TENSOR_OP_OPERANDS_INLINE> operands_; //tensor operands <operand,conjugation,mutation>
+ SmallVector<std::complex<double>,TENSOR_OP_OPERANDS_INLINE> scalars_; //additional scalars (prefactors)
  unsigned int num_operands_; //number of required tensor operands
  unsigned int num_scalars_; //number of required scalar arguments
  std::size_t mutation_; //default operand mutability bits: Bit X --> Operand #X
+ std::size_t donation_; //operand donation bits: Bit X --> Operand #X
  TensorOpCode opcode_; //tensor operation code
  std::size_t id_; //tensor operation id (unique integer identifier)
  bool repeatable_; //whether or not the tensor operation may be executed more than once
+ TensorOpPriority priority_; //latency class (priority) of the tensor operation
+ bool commutative_; //whether or not the tensor operation is a commutative accumulation into its output tensor operand
+ TensorOpPrecision precision_; //precision policy of the tensor operation
+ double precision_tolerance_; //absolute error tolerance of the AUTO precision policy
+ TensorOpDevice device_; //execution device class of the tensor operation
  Timer timer_; //internal timer
 };
 
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operator
-REVISION: 2021/10/29
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_operator.hpp"
 #include "tensor_range.hpp"
@@ -213,7 +213,7 @@ bool TensorOperator::deleteComponent(std::size_t component_num)
 void TensorOperator::conjugate()
 {
  for(auto & component: components_){
-  component.network->conjugate();
+  component.getMutableNetwork()->conjugate();
   component.ket_legs.swap(component.bra_legs);
   component.coefficient = std::conj(component.coefficient);
  }
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor operator
-REVISION: 2021/10/29
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) A tensor network vector is a vector in a given tensor space with
@@ -23,6 +23,9 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
      when acting on a ket vector; the last component of the tensor network
      operator is applied first when acting on a bra vector.
  (e) The order of components of a tensor network operator is reversed upon conjugation.
+ (f) Copies of a tensor network operator share the constituting tensor networks
+     (copy-on-write): A shared tensor network is duplicated only when it is about
+     to be modified via a copy of the tensor network operator.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_OPERATOR_HPP_
@@ -55,6 +58,19 @@ public:
   std::vector<std::pair<unsigned int, unsigned int>> bra_legs;
   //Expansion coefficient of the operator component:
   std::complex<double> coefficient;
+  //Shared by all copies of the operator component sharing the same tensor network:
+  std::shared_ptr<const bool> copies = std::make_shared<const bool>(true);
+
+  /** Returns the tensor network for in-place modification. If the tensor network
+      is still shared with other copies of this operator component, it is
+      duplicated first (copy-on-write). **/
+  std::shared_ptr<TensorNetwork> getMutableNetwork(){
+   if(copies.use_count() > 1){
+    network = makeSharedTensorNetwork(*network);
+    copies = std::make_shared<const bool>(true);
+   }
+   return network;
+  }
  };
 
  using Iterator = typename std::vector<OperatorComponent>::iterator;
@@ -1,5 +1,5 @@
 /** ExaTN::Numerics: Tensor range
-REVISION: 2022/01/28
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
@@ -25,6 +25,14 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
      Note that only generalized column-wise strides are allowed.
  (e) A tensor range can also be split into disjoint chunks such
      that each chunk can be iterated over by a concurrent agent.
+ (f) Instead of iterating element by element (next()), a tensor range
+     (or its subrange set for a concurrent agent) can be traversed run by run
+     (forEachRun()), where a run is a maximal sequence of elements along
+     the first (innermost) dimension, which is contiguous in the local
+     1d super-range, such that the per-element work can be vectorized and
+     the per-multi-index work (index checks, offset computation) is done
+     once per run. The run traversal is specialized at compile time
+     for ranks 1 through MAX_STATIC_RANK.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_RANGE_HPP_
@@ -33,6 +41,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_basic.hpp"
 
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -45,6 +54,8 @@ namespace numerics{
 class TensorRange{
 public:
 
+ static constexpr unsigned int MAX_STATIC_RANK = 8; //max rank with a compile-time specialized run traversal
+
  inline TensorRange(const std::vector<DimOffset> & bases,    //in: base offset of each dimension (0 is min)
                     const std::vector<DimExtent> & extents,  //in: extent of each dimension (on top of the base offset)
                     const std::vector<DimExtent> & strides); //in: stride of each dimension (global increment caused by local increment)
@@ -138,6 +149,17 @@ public:
      If the tensor range (or subrange) is over, return false. **/
  inline bool shift(long long offset);
 
+ /** Traverses the tensor range (or the subrange set by reset(num_agents,agent_rank))
+     run by run, where a run is a contiguous sequence of elements along the first dimension,
+     calling func(mlndx, local_offset, global_offset, run_length) for each run, where
+     mlndx is the local multi-index (const DimOffset *) of the first element of the run,
+     local_offset and global_offset are its flattened local and global offsets, and
+     run_length is the number of elements in the run. The elements of a run are
+     contiguous in the local 1d super-range (their global offsets are strided by
+     the stride of the first dimension). The current multi-index value is not changed. **/
+ template <typename RunFunc>
+ inline void forEachRun(RunFunc && func) const;
+
  /** Prints the current multi-index value. **/
  void printCurrent() const{
   std::cout << "{";
@@ -164,6 +186,10 @@ private:
  DimExtent volume_;               //total local volume
  DimOffset subrange_begin_;       //subrange begin (if multiple agents iterate through the range)
  DimOffset subrange_end_;         //subrange end (if multiple agents iterate through the range)
+
+ /** Traverses the runs within [begin,end) of the local 1d super-range (Rank = 0: any rank). **/
+ template <unsigned int Rank, typename RunFunc>
+ inline void traverseRuns(RunFunc && func, DimOffset * mlndx, DimOffset begin, DimOffset end) const;
 };
 
 
@@ -510,6 +536,81 @@ inline bool TensorRange::shift(long long offset)
  return true;
 }
 
+
+template <typename RunFunc>
+inline void TensorRange::forEachRun(RunFunc && func) const
+{
+ const unsigned int rank = extents_.size();
+ if(rank == 0){ //scalar: single run of a single element
+  const DimOffset scalar = 0;
+  func(static_cast<const DimOffset*>(&scalar),DimOffset{0},DimOffset{0},DimExtent{1});
+  return;
+ }
+ DimOffset begin = 0, end = volume_;
+ if(subrange_end_ > 0){ //subranging is set
+  begin = subrange_begin_;
+  end = subrange_end_;
+ }
+ if(begin >= end) return;
+ if(rank > MAX_STATIC_RANK){
+  std::vector<DimOffset> mlndx(rank);
+  traverseRuns<0>(func,mlndx.data(),begin,end);
+ }else{
+  DimOffset mlndx[MAX_STATIC_RANK];
+  switch(rank){
+   case 1: traverseRuns<1>(func,mlndx,begin,end); break;
+   case 2: traverseRuns<2>(func,mlndx,begin,end); break;
+   case 3: traverseRuns<3>(func,mlndx,begin,end); break;
+   case 4: traverseRuns<4>(func,mlndx,begin,end); break;
+   case 5: traverseRuns<5>(func,mlndx,begin,end); break;
+   case 6: traverseRuns<6>(func,mlndx,begin,end); break;
+   case 7: traverseRuns<7>(func,mlndx,begin,end); break;
+   case 8: traverseRuns<8>(func,mlndx,begin,end); break;
+  }
+ }
+ return;
+}
+
+
+template <unsigned int Rank, typename RunFunc>
+inline void TensorRange::traverseRuns(RunFunc && func, DimOffset * mlndx, DimOffset begin, DimOffset end) const
+{
+ const unsigned int rank = (Rank > 0) ? Rank : extents_.size();
+ const DimExtent * extents = extents_.data();
+ const DimExtent * strides = strides_.data();
+ const DimOffset * bases = bases_.data();
+ //Multi-index of the first element:
+ auto offs = begin;
+ for(unsigned int i = 0; i < rank; ++i){
+  mlndx[i] = offs % extents[i];
+  offs /= extents[i];
+ }
+ //Global offset of the current multi-index (updated incrementally):
+ DimOffset global_offset = 0;
+ for(unsigned int i = 0; i < rank; ++i) global_offset += (bases[i] + mlndx[i]) * strides[i];
+ DimOffset local_offset = begin;
+ while(local_offset < end){
+  const DimExtent run_length = std::min(extents[0] - mlndx[0], end - local_offset);
+  func(static_cast<const DimOffset*>(mlndx),local_offset,global_offset,run_length);
+  local_offset += run_length;
+  mlndx[0] += run_length;
+  global_offset += run_length * strides[0];
+  if(mlndx[0] == extents[0]){ //carry over to the next dimensions
+   global_offset -= extents[0] * strides[0];
+   mlndx[0] = 0;
+   for(unsigned int i = 1; i < rank; ++i){
+    if(++mlndx[i] < extents[i]){
+     global_offset += strides[i];
+     break;
+    }
+    global_offset -= (extents[i] - 1) * strides[i];
+    mlndx[i] = 0;
+   }
+  }
+ }
+ return;
+}
+
 } //namespace numerics
 
 } //namespace exatn
@@ -0,0 +1,108 @@
+/** ExaTN::Numerics: Tensor redistribution planner
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_redistribution.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+namespace exatn{
+
+namespace numerics{
+
+TensorRedistributionPlanner::TensorRedistributionPlanner(const std::vector<Block> & source_layout,
+                                                         const std::vector<Block> & target_layout)
+{
+ std::unordered_map<unsigned int,std::size_t> sent; //process rank --> volume sent so far
+ for(std::size_t tb = 0; tb < target_layout.size(); ++tb){
+  const auto & target = target_layout[tb];
+  const auto rank = target.extents.size();
+  std::size_t target_volume = 1;
+  for(const auto & extent: target.extents) target_volume *= extent;
+  for(const auto & receiver: target.owners){
+   std::size_t covered = 0;
+   for(std::size_t sb = 0; sb < source_layout.size(); ++sb){
+    const auto & source = source_layout[sb];
+    assert(source.extents.size() == rank && !(source.owners.empty()));
+    //Intersect the source block with the target block:
+    Transfer transfer{sb,tb,receiver,receiver,std::vector<DimOffset>(rank),std::vector<DimExtent>(rank),1};
+    for(unsigned int i = 0; i < rank; ++i){
+     const auto begin = std::max(source.offsets[i],target.offsets[i]);
+     const auto end = std::min(source.offsets[i] + source.extents[i],target.offsets[i] + target.extents[i]);
+     transfer.offsets[i] = begin;
+     transfer.extents[i] = (end > begin) ? (end - begin) : 0;
+     transfer.volume *= transfer.extents[i];
+    }
+    if(transfer.volume == 0) continue;
+    //Choose the sending process:
+    if(std::find(source.owners.cbegin(),source.owners.cend(),receiver) == source.owners.cend()){
+     const auto num_owners = source.owners.size();
+     transfer.source_process = source.owners[receiver % num_owners];
+     for(std::size_t i = 1; i < num_owners; ++i){
+      const auto owner = source.owners[(receiver + i) % num_owners];
+      if(sent[owner] < sent[transfer.source_process]) transfer.source_process = owner;
+     }
+     sent[transfer.source_process] += transfer.volume;
+    }
+    covered += transfer.volume;
+    transfers_.emplace_back(std::move(transfer));
+   }
+   make_sure(covered == target_volume,
+             "#ERROR(exatn::numerics::TensorRedistributionPlanner): Source layout does not cover the target block!");
+  }
+ }
+}
+
+
+std::size_t TensorRedistributionPlanner::getRemoteVolume() const
+{
+ std::size_t volume = 0;
+ for(const auto & transfer: transfers_){
+  if(transfer.source_process != transfer.target_process) volume += transfer.volume;
+ }
+ return volume;
+}
+
+
+void TensorRedistributionPlanner::copySlice(const std::vector<DimOffset> & slice_offsets,
+                                            const std::vector<DimExtent> & slice_extents,
+                                            const std::vector<DimOffset> & src_offsets,
+                                            const std::vector<DimExtent> & src_extents,
+                                            const void * src_body,
+                                            const std::vector<DimOffset> & dst_offsets,
+                                            const std::vector<DimExtent> & dst_extents,
+                                            void * dst_body,
+                                            std::size_t elem_size)
+{
+ const unsigned int rank = slice_extents.size();
+ std::size_t volume = 1;
+ for(const auto & extent: slice_extents) volume *= extent;
+ if(volume == 0) return;
+ //Copies contiguous runs along the first dimension:
+ const auto * src = static_cast<const char*>(src_body);
+ auto * dst = static_cast<char*>(dst_body);
+ const std::size_t run = ((rank > 0) ? slice_extents[0] : 1) * elem_size;
+ std::vector<DimExtent> mlndx(rank,0); //multi-index within the slice (dimensions above the first one)
+ for(std::size_t done = 0; done < volume; done += run / elem_size){
+  std::size_t src_pos = 0, dst_pos = 0, src_stride = elem_size, dst_stride = elem_size;
+  for(unsigned int i = 0; i < rank; ++i){
+   src_pos += (slice_offsets[i] - src_offsets[i] + mlndx[i]) * src_stride; src_stride *= src_extents[i];
+   dst_pos += (slice_offsets[i] - dst_offsets[i] + mlndx[i]) * dst_stride; dst_stride *= dst_extents[i];
+  }
+  std::memcpy(dst + dst_pos,src + src_pos,run);
+  unsigned int i = 1;
+  while(i < rank){
+   if(++(mlndx[i]) < slice_extents[i]) break;
+   mlndx[i++] = 0;
+  }
+ }
+ return;
+}
+
+} //namespace numerics
+
+} //namespace exatn
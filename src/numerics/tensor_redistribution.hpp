@@ -0,0 +1,95 @@
+/** ExaTN::Numerics: Tensor redistribution planner
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A distributed tensor is laid out as a set of dense non-overlapping blocks
+     (subtensors of a composite tensor or the whole simple tensor), each stored
+     by one or more processes (replicas). The redistribution planner computes
+     the minimal set of block transfers needed to move a tensor from one layout
+     (source process group and decomposition) to another (target process group
+     and decomposition): Each replica of each target block receives each of its
+     intersections with the source blocks exactly once, and an intersection
+     is never transferred if the receiving process stores the source block.
+ (b) Among the replicas of a source block, the sending process is chosen
+     to balance the number of elements sent by each process.
+ (c) Process ranks in both layouts must refer to the same (parent) process group.
+     The transfers are ordered by the target block, then the receiving process,
+     then the source block, such that all processes derive the same ordering.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_REDISTRIBUTION_HPP_
+#define EXATN_NUMERICS_TENSOR_REDISTRIBUTION_HPP_
+
+#include "tensor_basic.hpp"
+
+#include <vector>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+class TensorRedistributionPlanner{
+
+public:
+
+ //Dense tensor block stored by one or more processes:
+ struct Block{
+  std::vector<DimOffset> offsets;   //base offsets of the tensor block
+  std::vector<DimExtent> extents;   //dimension extents of the tensor block
+  std::vector<unsigned int> owners; //process ranks storing the tensor block (replicas)
+ };
+
+ //Transfer of a dense tensor slice from a source block to a target block:
+ struct Transfer{
+  std::size_t source_block;        //position of the source block in the source layout
+  std::size_t target_block;        //position of the target block in the target layout
+  unsigned int source_process;     //sending process rank
+  unsigned int target_process;     //receiving process rank
+  std::vector<DimOffset> offsets;  //base offsets of the transferred tensor slice
+  std::vector<DimExtent> extents;  //dimension extents of the transferred tensor slice
+  std::size_t volume;              //volume of the transferred tensor slice
+ };
+
+ /** Plans the redistribution of a tensor from the source layout to the target layout.
+     The source blocks must cover all target blocks. **/
+ TensorRedistributionPlanner(const std::vector<Block> & source_layout,  //in: source layout of the tensor
+                             const std::vector<Block> & target_layout); //in: target layout of the tensor
+
+ TensorRedistributionPlanner(const TensorRedistributionPlanner &) = default;
+ TensorRedistributionPlanner & operator=(const TensorRedistributionPlanner &) = default;
+ TensorRedistributionPlanner(TensorRedistributionPlanner &&) noexcept = default;
+ TensorRedistributionPlanner & operator=(TensorRedistributionPlanner &&) noexcept = default;
+ ~TensorRedistributionPlanner() = default;
+
+ /** Returns the planned transfers (including local copies). **/
+ inline const std::vector<Transfer> & getTransfers() const {return transfers_;}
+
+ /** Returns the total volume moved between different processes. **/
+ std::size_t getRemoteVolume() const;
+
+ /** Copies a tensor slice between two column-major tensor block bodies. **/
+ static void copySlice(const std::vector<DimOffset> & slice_offsets, //in: base offsets of the tensor slice
+                       const std::vector<DimExtent> & slice_extents, //in: dimension extents of the tensor slice
+                       const std::vector<DimOffset> & src_offsets,   //in: base offsets of the source tensor block
+                       const std::vector<DimExtent> & src_extents,   //in: dimension extents of the source tensor block
+                       const void * src_body,                        //in: source tensor block body
+                       const std::vector<DimOffset> & dst_offsets,   //in: base offsets of the destination tensor block
+                       const std::vector<DimExtent> & dst_extents,   //in: dimension extents of the destination tensor block
+                       void * dst_body,                              //out: destination tensor block body
+                       std::size_t elem_size);                       //in: tensor element size in bytes
+
+private:
+
+ std::vector<Transfer> transfers_; //planned transfers
+};
+
+} //namespace numerics
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_REDISTRIBUTION_HPP_
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor shape
-REVISION: 2020/06/25
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_shape.hpp"
 
@@ -30,7 +30,7 @@ void TensorShape::pack(BytePacket & byte_packet) const
 {
  const std::size_t tensor_rank = extents_.size();
  appendToBytePacket(&byte_packet,tensor_rank);
- for(const auto & extent: extents_) appendToBytePacket(&byte_packet,extent);
+ appendArrayToBytePacket(&byte_packet,extents_.data(),tensor_rank);
  return;
 }
 
@@ -39,7 +39,7 @@ void TensorShape::unpack(BytePacket & byte_packet)
  std::size_t tensor_rank = 0;
  extractFromBytePacket(&byte_packet,tensor_rank);
  extents_.resize(tensor_rank);
- for(auto & extent: extents_) extractFromBytePacket(&byte_packet,extent);
+ extractArrayFromBytePacket(&byte_packet,extents_.data(),tensor_rank);
  return;
 }
 
@@ -57,7 +57,7 @@ void TensorShape::printIt() const
  return;
 }
 
-void TensorShape::printItFile(std::ofstream & output_file) const
+void TensorShape::printItFile(std::ostream & output_file) const
 {
  output_file << "{";
  for(auto ext_it = extents_.cbegin(); ext_it != extents_.cend(); ++ext_it){
@@ -89,7 +89,7 @@ DimExtent TensorShape::getDimExtent(unsigned int dim_id) const
  return extents_[dim_id];
 }
 
-const std::vector<DimExtent> & TensorShape::getDimExtents() const
+const DimExtentVector & TensorShape::getDimExtents() const
 {
  return extents_;
 }
@@ -1,12 +1,14 @@
 /** ExaTN::Numerics: Tensor shape
-REVISION: 2020/06/25
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Tensor shape is an ordered set of tensor dimension extents.
      A scalar tensor (rank-0 tensor) has an empty shape.
+ (b) The dimension extents are stored inline (without heap allocation)
+     for tensor ranks up to TENSOR_RANK_INLINE.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_SHAPE_HPP_
@@ -14,6 +16,7 @@ Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_basic.hpp"
 #include "packable.hpp"
+#include "small_vector.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -27,6 +30,8 @@ namespace exatn{
 
 namespace numerics{
 
+using DimExtentVector = SmallVector<DimExtent,TENSOR_RANK_INLINE>; //tensor dimension extents
+
 class TensorShape: public Packable {
 public:
 
@@ -54,7 +59,7 @@ public:
 
  /** Print. **/
  void printIt() const;
- void printItFile(std::ofstream & output_file) const;
+ void printItFile(std::ostream & output_file) const;
 
  /** Get tensor rank (number of tensor dimensions). **/
  unsigned int getRank() const;
@@ -66,7 +71,7 @@ public:
  DimExtent getDimExtent(unsigned int dim_id) const;
 
  /** Get the extents of all tensor dimensions. **/
- const std::vector<DimExtent> & getDimExtents() const;
+ const DimExtentVector & getDimExtents() const;
 
  /** Get the strides for all tensor dimensions.
      Column-major storage layout is assumed. **/
@@ -86,7 +91,7 @@ public:
 
 private:
 
- std::vector<DimExtent> extents_; //tensor dimension extents
+ DimExtentVector extents_; //tensor dimension extents
 };
 
 
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor signature
-REVISION: 2020/06/25
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2020 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2020 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "tensor_signature.hpp"
 
@@ -45,7 +45,7 @@ void TensorSignature::pack(BytePacket & byte_packet) const
 {
  const std::size_t tensor_rank = subspaces_.size();
  appendToBytePacket(&byte_packet,tensor_rank);
- for(const auto & subspace: subspaces_) appendToBytePacket(&byte_packet,subspace);
+ appendArrayToBytePacket(&byte_packet,subspaces_.data(),tensor_rank);
  return;
 }
 
@@ -54,7 +54,7 @@ void TensorSignature::unpack(BytePacket & byte_packet)
  std::size_t tensor_rank = 0;
  extractFromBytePacket(&byte_packet,tensor_rank);
  subspaces_.resize(tensor_rank);
- for(auto & subspace: subspaces_) extractFromBytePacket(&byte_packet,subspace);
+ extractArrayFromBytePacket(&byte_packet,subspaces_.data(),tensor_rank);
  return;
 }
 
@@ -72,7 +72,7 @@ void TensorSignature::printIt() const
  return;
 }
 
-void TensorSignature::printItFile(std::ofstream & output_file) const
+void TensorSignature::printItFile(std::ostream & output_file) const
 {
  output_file << "{";
  for(auto subsp_it = subspaces_.cbegin(); subsp_it != subspaces_.cend(); ++subsp_it){
@@ -109,7 +109,7 @@ std::pair<SpaceId,SubspaceId> TensorSignature::getDimSpaceAttr(unsigned int dim_
  return subspaces_[dim_id];
 }
 
-const std::vector<std::pair<SpaceId,SubspaceId>> & TensorSignature::getDimSpaceAttrs() const
+const DimSpaceAttrVector & TensorSignature::getDimSpaceAttrs() const
 {
  return subspaces_;
 }
@@ -1,8 +1,8 @@
 /** ExaTN::Numerics: Tensor signature
-REVISION: 2021/03/17
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 /** Rationale:
  (a) Tensor signature is an ordered set of tensor dimension specifiers,
@@ -13,6 +13,8 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
  (c) Anonymous signature: Tensor dimension specifier consists of
      the Space Id = SOME_SPACE, while the Subspace Id specifies
      the offset (first basis vector) in SOME_SPACE.
+ (d) The tensor dimension specifiers are stored inline (without heap allocation)
+     for tensor ranks up to TENSOR_RANK_INLINE.
 **/
 
 #ifndef EXATN_NUMERICS_TENSOR_SIGNATURE_HPP_
@@ -21,6 +23,7 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
 #include "tensor_basic.hpp"
 #include "packable.hpp"
 #include "spaces.hpp"
+#include "small_vector.hpp"
 
 #include <utility>
 #include <initializer_list>
@@ -35,6 +38,8 @@ namespace exatn{
 
 namespace numerics{
 
+using DimSpaceAttrVector = SmallVector<std::pair<SpaceId,SubspaceId>,TENSOR_RANK_INLINE>; //tensor dimension specifiers
+
 struct DimRange {
  DimOffset lower_bound;
  DimOffset upper_bound;
@@ -89,7 +94,7 @@ public:
 
  /** Print. **/
  void printIt() const;
- void printItFile(std::ofstream & output_file) const;
+ void printItFile(std::ostream & output_file) const;
 
  /** Get tensor rank (number of dimensions). **/
  unsigned int getRank() const;
@@ -100,7 +105,7 @@ public:
  std::pair<SpaceId,SubspaceId> getDimSpaceAttr(unsigned int dim_id) const;
 
  /** Get the attributes of all tensor dimensions. **/
- const std::vector<std::pair<SpaceId,SubspaceId>> & getDimSpaceAttrs() const;
+ const DimSpaceAttrVector & getDimSpaceAttrs() const;
 
  /** Returns TRUE if the tensor signature coincides with another tensor signature. **/
  bool isCongruentTo(const TensorSignature & another) const;
@@ -116,7 +121,7 @@ public:
 
 private:
 
- std::vector<std::pair<SpaceId,SubspaceId>> subspaces_; //tensor signature
+ DimSpaceAttrVector subspaces_; //tensor signature
 };
 
 } //namespace numerics
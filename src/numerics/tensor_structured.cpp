@@ -0,0 +1,73 @@
+/** ExaTN::Numerics: Structured (diagonal, Kronecker delta, permutation) tensor
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "tensor_structured.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+TensorStructured::TensorStructured(const std::string & name,
+                                   DimExtent extent):
+ Tensor(name,TensorShape{extent,extent}), structure_(TensorStructure::DELTA)
+{
+ assert(extent > 0);
+}
+
+
+TensorStructured::TensorStructured(const std::string & name,
+                                   const std::vector<std::complex<double>> & diagonal):
+ Tensor(name,TensorShape{diagonal.size(),diagonal.size()}), structure_(TensorStructure::DIAGONAL),
+ diagonal_(diagonal)
+{
+ assert(!diagonal_.empty());
+}
+
+
+TensorStructured::TensorStructured(const std::string & name,
+                                   const std::vector<DimOffset> & permutation):
+ Tensor(name,TensorShape{permutation.size(),permutation.size()}), structure_(TensorStructure::PERMUTATION),
+ permutation_(permutation)
+{
+ const auto extent = permutation_.size();
+ assert(extent > 0);
+ std::vector<bool> present(extent,false);
+ for(const auto & pos: permutation_){ //must be a permutation of {0..N-1}
+  assert(pos < extent && !present[pos]);
+  present[pos] = true;
+ }
+}
+
+
+std::shared_ptr<Tensor> TensorStructured::clone() const
+{
+ return makeSharedTensorStructured(*this);
+}
+
+
+bool TensorStructured::isConformantTo(const Tensor & another) const
+{
+ bool ans = isCongruentTo(another);
+ if(ans){
+  const auto * structured = dynamic_cast<const TensorStructured *>(&another);
+  ans = (structured != nullptr);
+  if(ans) ans = (structure_ == structured->structure_ && diagonal_ == structured->diagonal_ &&
+                 permutation_ == structured->permutation_);
+ }
+ return ans;
+}
+
+
+std::vector<DimOffset> TensorStructured::getInversePermutation() const
+{
+ std::vector<DimOffset> inverse(permutation_.size());
+ for(DimOffset i = 0; i < permutation_.size(); ++i) inverse[permutation_[i]] = i;
+ return inverse;
+}
+
+} //namespace numerics
+
+} //namespace exatn
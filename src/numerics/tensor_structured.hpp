@@ -0,0 +1,113 @@
+/** ExaTN::Numerics: Structured (diagonal, Kronecker delta, permutation) tensor
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A structured tensor is a square order-2 tensor S(i,j) with a known sparse structure:
+      Kronecker delta (identity): S(i,j) = delta(i,j);
+      Diagonal: S(i,j) = delta(i,j) * d(j), where d is the diagonal;
+      Permutation: S(i,j) = delta(i,p(j)), where p is the permutation.
+     Its structure is stored compactly (at most one vector of the dimension extent),
+     thus a structured tensor has no dense tensor body by default.
+ (b) A tensor contraction of a structured tensor with a regular tensor over one of its
+     dimensions, with the other dimension being an open dimension of the result, is executed
+     as an index relabeling (Kronecker delta), an elementwise scaling along the relabeled
+     dimension (diagonal) or a reordering along the relabeled dimension (permutation),
+     never materializing the dense body of the structured tensor. In all other cases,
+     the dense body of the structured tensor is created temporarily.
+ (c) Order-2 Kronecker delta tensors introduced implicitly (named "_d...") are treated
+     the same way as structured Kronecker delta tensors.
+**/
+
+#ifndef EXATN_NUMERICS_TENSOR_STRUCTURED_HPP_
+#define EXATN_NUMERICS_TENSOR_STRUCTURED_HPP_
+
+#include "tensor_basic.hpp"
+#include "tensor.hpp"
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <memory>
+
+#include "errors.hpp"
+
+namespace exatn{
+
+namespace numerics{
+
+enum class TensorStructure{
+ DELTA,      //Kronecker delta (identity): S(i,j) = delta(i,j)
+ DIAGONAL,   //diagonal: S(i,j) = delta(i,j) * d(j)
+ PERMUTATION //permutation: S(i,j) = delta(i,p(j))
+};
+
+
+class TensorStructured : public Tensor{
+public:
+
+ /** Kronecker delta (identity) tensor of a given dimension extent. **/
+ TensorStructured(const std::string & name, //in: tensor name
+                  DimExtent extent);        //in: dimension extent
+
+ /** Diagonal tensor with a given diagonal. **/
+ TensorStructured(const std::string & name,                         //in: tensor name
+                  const std::vector<std::complex<double>> & diagonal); //in: diagonal
+
+ /** Permutation tensor with a given permutation of {0..N-1}. **/
+ TensorStructured(const std::string & name,              //in: tensor name
+                  const std::vector<DimOffset> & permutation); //in: permutation
+
+ TensorStructured(const TensorStructured & tensor) = default;
+ TensorStructured & operator=(const TensorStructured & tensor) = default;
+ TensorStructured(TensorStructured && tensor) noexcept = default;
+ TensorStructured & operator=(TensorStructured && tensor) noexcept = default;
+ virtual ~TensorStructured() = default;
+
+ virtual std::shared_ptr<Tensor> clone() const override;
+
+ /** Returns TRUE if the tensor is congruent to another tensor and
+     it is also a structured tensor with the same structure. **/
+ virtual bool isConformantTo(const Tensor & another) const override;
+
+ /** Returns the tensor structure. **/
+ inline TensorStructure getStructure() const {return structure_;}
+
+ /** Returns the diagonal (diagonal tensor only). **/
+ inline const std::vector<std::complex<double>> & getDiagonal() const {return diagonal_;}
+
+ /** Returns the permutation (permutation tensor only). **/
+ inline const std::vector<DimOffset> & getPermutation() const {return permutation_;}
+
+ /** Returns the inverse permutation (permutation tensor only). **/
+ std::vector<DimOffset> getInversePermutation() const;
+
+private:
+
+ TensorStructure structure_;                 //tensor structure
+ std::vector<std::complex<double>> diagonal_; //diagonal (diagonal tensor only)
+ std::vector<DimOffset> permutation_;         //permutation (permutation tensor only)
+};
+
+} //namespace numerics
+
+
+/** Creates a new TensorStructured as a shared pointer to the base Tensor. **/
+template<typename... Args>
+inline std::shared_ptr<numerics::Tensor> makeSharedTensorStructured(Args&&... args)
+{
+ return std::shared_ptr<numerics::Tensor>{new numerics::TensorStructured(std::forward<Args>(args)...)};
+}
+
+
+/** Downcasts a Tensor as TensorStructured if it is TensorStructured, otherwise returns nullptr. **/
+inline std::shared_ptr<numerics::TensorStructured> castTensorStructured(std::shared_ptr<numerics::Tensor> tensor)
+{
+ return std::dynamic_pointer_cast<numerics::TensorStructured>(tensor);
+}
+
+} //namespace exatn
+
+#endif //EXATN_NUMERICS_TENSOR_STRUCTURED_HPP_
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "exatn.hpp"
+#include "half_float.hpp"
+#include "tensor_range.hpp"
 
 #include <iostream>
 #include <utility>
@@ -130,6 +132,63 @@ TEST(NumericsTester, checkSharedTensorNetworkSymbolic)
 }
 
 
+TEST(NumericsTester, checkIntermediateMemoryPlan)
+{
+ TensorNetwork network("{0,1} 3-site MPS closure",
+                       "Z0() = T0(a,b) * T1(b,c,d) * T2(d,e) * H0(a,c,f,g) * S0(f,h) * S1(h,g,i) * S2(i,e)",
+                       std::map<std::string,std::shared_ptr<Tensor>>{
+                        {"Z0",std::make_shared<Tensor>("Z0")},
+                        {"T0",std::make_shared<Tensor>("T0",TensorShape{2,4})},
+                        {"T1",std::make_shared<Tensor>("T1",TensorShape{4,2,4})},
+                        {"T2",std::make_shared<Tensor>("T2",TensorShape{4,2})},
+                        {"H0",std::make_shared<Tensor>("H0",TensorShape{2,2,2,2})},
+                        {"S0",std::make_shared<Tensor>("S0",TensorShape{2,4})},
+                        {"S1",std::make_shared<Tensor>("S1",TensorShape{4,2,4})},
+                        {"S2",std::make_shared<Tensor>("S2",TensorShape{4,2})}
+                       }
+                      );
+ network.importContractionSequence(std::list<ContrTriple>{{8,1,2},{9,8,4},{10,9,5},{11,10,6},{12,11,7},{0,12,3}});
+ const auto & op_list = network.getOperationList();
+ const double workspace = network.getIntermediateWorkspaceVolume();
+ EXPECT_GE(workspace,network.getMaxIntermediatePresenceVolume());
+ //Intermediates present at the same time must occupy disjoint workspace segments:
+ std::list<std::pair<long long,long long>> present;
+ for(const auto & op: op_list){
+  if(op->getOpcode() == TensorOpCode::CREATE){
+   const auto & tensor = *(op->getTensorOperand(0));
+   const auto offset = network.getIntermediateWorkspaceOffset(tensor);
+   ASSERT_GE(offset,0);
+   const long long end = offset + static_cast<long long>(tensor.getVolume());
+   EXPECT_LE(static_cast<double>(end),workspace);
+   for(const auto & segment: present) EXPECT_TRUE(end <= segment.first || offset >= segment.second);
+   present.emplace_back(std::make_pair(offset,end));
+  }else if(op->getOpcode() == TensorOpCode::DESTROY){
+   const auto & tensor = *(op->getTensorOperand(0));
+   const auto offset = network.getIntermediateWorkspaceOffset(tensor);
+   present.remove(std::make_pair(offset,offset + static_cast<long long>(tensor.getVolume())));
+  }
+ }
+ EXPECT_TRUE(present.empty());
+ EXPECT_EQ(network.getIntermediateWorkspaceOffset(*(network.getTensor(1))),-1);
+ //Intermediates are donated by their last use (contraction) right before being destroyed:
+ std::shared_ptr<TensorOperation> last_contraction;
+ unsigned int num_destroyed = 0, num_donated = 0;
+ for(const auto & op: op_list){
+  if(op->getOpcode() == TensorOpCode::CONTRACT){
+   last_contraction = op;
+   for(unsigned int i = 1; i < op->getNumOperands(); ++i) num_donated += op->operandIsDonated(i) ? 1 : 0;
+  }else if(op->getOpcode() == TensorOpCode::DESTROY){
+   ++num_destroyed;
+   ASSERT_TRUE(last_contraction);
+   const auto hash = op->getTensorOperandHash(0);
+   EXPECT_TRUE((last_contraction->getTensorOperandHash(1) == hash && last_contraction->operandIsDonated(1)) ||
+               (last_contraction->getTensorOperandHash(2) == hash && last_contraction->operandIsDonated(2)));
+  }
+ }
+ EXPECT_EQ(num_donated,num_destroyed);
+}
+
+
 TEST(NumericsTester, checkNetworkBuilders)
 {
  //Get tensor network builders:
@@ -158,6 +217,31 @@ TEST(NumericsTester, checkNetworkBuilders)
  auto output_tensor_ttn = makeSharedTensor("Z_TTN",std::vector<DimExtent>{2,2,2,2,2,2,2,2,2,2,2});
  auto network_ttn = makeSharedTensorNetwork("TensorTree",output_tensor_ttn,*builder_ttn);
  network_ttn->printIt();
+
+ //The norm of an MPS in the mixed canonical form collapses to its orthogonality center:
+ success = builder_mps->setParameter("canonical_center",3); assert(success);
+ auto output_tensor_cmps = makeSharedTensor("Z_CMPS",std::vector<DimExtent>{2,2,2,2,2,2,2,2});
+ auto network_cmps = makeSharedTensorNetwork("CanonicalTrain",output_tensor_cmps,*builder_mps);
+ for(auto tens = network_cmps->cbegin(); tens != network_cmps->cend(); ++tens){
+  if(tens->first != 0){
+   EXPECT_EQ(tens->second.hasIsometries(),(tens->first != 4));
+  }
+ }
+ TensorExpansion ket_cmps;
+ ket_cmps.appendComponent(network_cmps,std::complex<double>{1.0});
+ TensorExpansion norm_cmps(ket_cmps,ket_cmps,true,false);
+ EXPECT_TRUE(norm_cmps.collapseIsometries());
+ EXPECT_EQ(norm_cmps.cbegin()->network->getNumTensors(),2);
+
+ //Same for a tree tensor network with the orthogonality center at the root:
+ success = builder_ttn->setParameter("canonical",1); assert(success);
+ auto output_tensor_cttn = makeSharedTensor("Z_CTTN",std::vector<DimExtent>{2,2,2,2,2,2,2,2,2,2,2});
+ auto network_cttn = makeSharedTensorNetwork("CanonicalTree",output_tensor_cttn,*builder_ttn);
+ TensorExpansion ket_cttn;
+ ket_cttn.appendComponent(network_cttn,std::complex<double>{1.0});
+ TensorExpansion norm_cttn(ket_cttn,ket_cttn,true,false);
+ EXPECT_TRUE(norm_cttn.collapseIsometries());
+ EXPECT_EQ(norm_cttn.cbegin()->network->getNumTensors(),2);
 }
 
 
@@ -223,6 +307,45 @@ TEST(NumericsTester, checkTensorExpansion)
  bra_vector.printIt();
  TensorExpansion bra_times_oper_times_ket(bra_vector,oper_times_ket);
  bra_times_oper_times_ket.printIt();
+
+ //Same inner product with the ket tensor network conjugated lazily:
+ TensorExpansion lazy_inner_product(ket_vector,oper_times_ket,true,false);
+ ASSERT_EQ(lazy_inner_product.getNumComponents(),bra_times_oper_times_ket.getNumComponents());
+ auto eager = bra_times_oper_times_ket.cbegin();
+ for(auto lazy = lazy_inner_product.cbegin(); lazy != lazy_inner_product.cend(); ++lazy, ++eager){
+  EXPECT_EQ(lazy->coefficient,eager->coefficient);
+  ASSERT_EQ(lazy->network->getNumTensors(),eager->network->getNumTensors());
+  unsigned int lazy_conj = 0, eager_conj = 0;
+  for(auto tens = lazy->network->cbegin(); tens != lazy->network->cend(); ++tens) if(tens->second.isComplexConjugated()) ++lazy_conj;
+  for(auto tens = eager->network->cbegin(); tens != eager->network->cend(); ++tens) if(tens->second.isComplexConjugated()) ++eager_conj;
+  EXPECT_EQ(lazy_conj,eager_conj);
+ }
+ for(auto tens = network->cbegin(); tens != network->cend(); ++tens){
+  EXPECT_FALSE(tens->second.isComplexConjugated()); //original ket tensor network is intact
+ }
+
+ //Same inner product generated lazily in batches, with a negligible operator component pruned:
+ TensorOperator pruned_ham(ham);
+ pruned_ham.appendComponent(std::make_shared<Tensor>("H4",TensorShape{2,2,2,2}),
+                            {{0,2},{1,3}},{{0,0},{1,1}},std::complex<double>{1e-14});
+ TensorExpansion eager_product(ket_vector,ket_vector,ham,true,false);
+ TensorExpansionStream stream(ket_vector,ket_vector,pruned_ham,true,false,1e-12);
+ EXPECT_EQ(stream.getMaxNumComponents(),eager_product.getNumComponents() + 1);
+ TensorExpansion batch;
+ std::size_t num_streamed = 0;
+ eager = eager_product.cbegin();
+ while(stream.nextBatch(batch,3) > 0){
+  EXPECT_LE(batch.getNumComponents(),3);
+  for(auto lazy = batch.cbegin(); lazy != batch.cend(); ++lazy, ++eager, ++num_streamed){
+   ASSERT_NE(eager,eager_product.cend());
+   EXPECT_EQ(lazy->coefficient,eager->coefficient);
+   EXPECT_EQ(lazy->network->getNumTensors(),eager->network->getNumTensors());
+   EXPECT_EQ(lazy->network->getName(),eager->network->getName());
+  }
+ }
+ EXPECT_TRUE(stream.isExhausted());
+ EXPECT_EQ(num_streamed,eager_product.getNumComponents());
+ EXPECT_EQ(stream.getNumPruned(),1);
 }
 
 
@@ -270,6 +393,301 @@ TEST(NumericsTester, checkTensorComposite)
 }
 
 
+TEST(NumericsTester, checkTensorBlockSparse)
+{
+ //U(1) symmetry: Sectors with quantum numbers {0,1,2}, T(a,b,c): q(a) + q(b) - q(c) = 0
+ const std::vector<SymmetryRange> sectors{{0,1,0},{2,4,1},{5,5,2}};
+ auto tensor = exatn::makeSharedTensorBlockSparse(std::vector<std::vector<SymmetryRange>>{sectors,sectors,sectors},
+                                                  std::vector<int>{1,1,-1},0,0U,"T3",exatn::TensorShape{6,6,6});
+ auto block_sparse = exatn::castTensorBlockSparse(tensor);
+ ASSERT_TRUE(block_sparse);
+ EXPECT_EQ(block_sparse->getNumBlocksComplete(),27);
+ EXPECT_EQ(block_sparse->getNumBlocks(),6);
+ EXPECT_EQ(block_sparse->getStoredVolume(),57);
+ for(auto block = block_sparse->cbegin(); block != block_sparse->cend(); ++block){
+  const auto block_sectors = block_sparse->getBlockSectors(block->first);
+  EXPECT_TRUE(block_sparse->isAllowedBlock(block_sectors));
+  EXPECT_EQ(block_sparse->getBlockId(block_sectors),block->first);
+  for(unsigned int i = 0; i < 3; ++i){
+   EXPECT_EQ(block->second->getDimExtent(i),sectors[block_sectors[i]].upper - sectors[block_sectors[i]].lower + 1);
+   EXPECT_EQ(block->second->getDimSpaceAttr(i).second,sectors[block_sectors[i]].lower);
+  }
+ }
+ EXPECT_FALSE(block_sparse->isAllowedBlock({1,1,1}));
+ //Z2 symmetry with the odd total quantum number:
+ auto tensor_z2 = exatn::makeSharedTensorBlockSparse(std::vector<std::vector<SymmetryRange>>{sectors,sectors},
+                                                     std::vector<int>{1,1},1,2U,"Z2",exatn::TensorShape{6,6});
+ EXPECT_EQ(exatn::castTensorBlockSparse(tensor_z2)->getNumBlocks(),4);
+}
+
+
+TEST(NumericsTester, checkTensorStructured)
+{
+ auto delta = exatn::makeSharedTensorStructured("D",DimExtent{4});
+ auto structured = exatn::castTensorStructured(delta);
+ ASSERT_TRUE(structured);
+ EXPECT_TRUE(structured->getStructure() == exatn::numerics::TensorStructure::DELTA);
+ EXPECT_EQ(delta->getRank(),2);
+ EXPECT_EQ(delta->getDimExtent(0),4);
+ EXPECT_EQ(delta->getDimExtent(1),4);
+ //Diagonal tensor:
+ auto diag = exatn::makeSharedTensorStructured("G",std::vector<std::complex<double>>{1.0,2.0,3.0});
+ EXPECT_TRUE(exatn::castTensorStructured(diag)->getStructure() == exatn::numerics::TensorStructure::DIAGONAL);
+ EXPECT_EQ(diag->getDimExtent(1),3);
+ //Permutation tensor:
+ auto perm = exatn::makeSharedTensorStructured("P",std::vector<DimOffset>{2,0,3,1});
+ const auto inverse = exatn::castTensorStructured(perm)->getInversePermutation();
+ EXPECT_EQ(inverse,(std::vector<DimOffset>{1,3,0,2}));
+ EXPECT_TRUE(perm->isConformantTo(*(perm->clone())));
+ EXPECT_FALSE(perm->isConformantTo(*delta));
+ EXPECT_FALSE(delta->isConformantTo(Tensor("R",TensorShape{4,4})));
+}
+
+
+TEST(NumericsTester, checkInlineStorage)
+{
+ //Low-rank tensors and basic tensor operations do not use heap storage:
+ TensorShape shape{2,3,4,5};
+ EXPECT_TRUE(shape.getDimExtents().isInline());
+ shape.deleteDimension(1);
+ shape.appendDimension(6);
+ EXPECT_EQ(shape.getRank(),4);
+ EXPECT_EQ(shape.getDimExtent(1),4);
+ EXPECT_EQ(shape.getDimExtent(3),6);
+ TensorShape permuted(shape,{3,2,1,0});
+ EXPECT_EQ(permuted.getDimExtent(0),6);
+ EXPECT_EQ(permuted.getDimExtent(3),2);
+
+ //High-rank tensors switch to heap storage transparently:
+ TensorSignature signa(TENSOR_RANK_INLINE);
+ EXPECT_TRUE(signa.getDimSpaceAttrs().isInline());
+ signa.appendDimension({SOME_SPACE,7});
+ EXPECT_FALSE(signa.getDimSpaceAttrs().isInline());
+ EXPECT_EQ(signa.getRank(),TENSOR_RANK_INLINE+1);
+ EXPECT_EQ(signa.getDimSubspaceId(TENSOR_RANK_INLINE),7);
+ TensorSignature signa_copy(signa);
+ EXPECT_TRUE(signa_copy.isCongruentTo(signa));
+
+ //Tensor operations share interned index patterns:
+ auto tensor0 = makeSharedTensor("D",TensorShape{2,2});
+ auto tensor1 = makeSharedTensor("L",TensorShape{2,2});
+ auto tensor2 = makeSharedTensor("R",TensorShape{2,2});
+ std::shared_ptr<TensorOperation> op[2];
+ for(int i = 0; i < 2; ++i){
+  op[i] = TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  op[i]->setTensorOperand(tensor0);
+  op[i]->setTensorOperand(tensor1);
+  op[i]->setTensorOperand(tensor2);
+  op[i]->setScalar(0,std::complex<double>{1.0,0.0});
+  op[i]->setIndexPattern("D(a,b)+=L(a,c)*R(c,b)");
+ }
+ EXPECT_EQ(&(op[0]->getIndexPattern()),&(op[1]->getIndexPattern()));
+}
+
+
+TEST(NumericsTester, checkReducedIndexPattern)
+{
+ //Reduced index patterns are memoized per tensor operand shapes:
+ const std::string pattern("D(a,b)+=L(a,c)*R(c,b)");
+ auto make_contraction = [&pattern](const TensorShape & left_shape, const TensorShape & right_shape,
+                                    const TensorShape & dest_shape){
+  auto op = TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  op->setTensorOperand(makeSharedTensor("D",dest_shape));
+  op->setTensorOperand(makeSharedTensor("L",left_shape));
+  op->setTensorOperand(makeSharedTensor("R",right_shape));
+  op->setScalar(0,std::complex<double>{1.0,0.0});
+  op->setIndexPattern(pattern);
+  return op;
+ };
+ auto full = make_contraction(TensorShape{2,3},TensorShape{3,4},TensorShape{2,4});
+ auto degenerate = make_contraction(TensorShape{1,3},TensorShape{3,4},TensorShape{1,4});
+ for(int repeat = 0; repeat < 2; ++repeat){
+  EXPECT_EQ(full->getIndexPatternReduced(),"D(a,b)+=L(a,c)*R(c,b)");
+  EXPECT_EQ(degenerate->getIndexPatternReduced(),"D(b)+=L(c)*R(c,b)");
+ }
+}
+
+
+TEST(NumericsTester, checkObjectArena)
+{
+ auto arena = ObjectArena::create();
+ auto tensor = makeSharedTensor("T",TensorShape{8,8});
+ auto op = std::shared_ptr<TensorOperation>(TensorOpFactory::get()->createTensorOp(TensorOpCode::DESTROY));
+ op->setTensorOperand(tensor);
+ {
+  //Slices and per-slice tensor operations live in the arena:
+  auto slice = tensor->createSubtensor({0,4},{8,4},ArenaAllocator<Tensor>(arena));
+  EXPECT_EQ(slice->getDimExtent(1),4);
+  EXPECT_EQ(slice->getDimSubspaceId(1),4);
+  auto slice_op = op->clone(ArenaAllocator<TensorOperation>(arena));
+  EXPECT_EQ(slice_op->getOpcode(),TensorOpCode::DESTROY);
+  EXPECT_TRUE(slice_op->resetTensorOperand(0,slice));
+  EXPECT_EQ(arena->getNumObjects(),2);
+ }
+ //The arena memory is recycled once all its objects are gone:
+ EXPECT_EQ(arena->getNumObjects(),0);
+ EXPECT_EQ(arena->getNumChunks(),1);
+}
+
+
+TEST(NumericsTester, checkHalfPrecision)
+{
+ //Storage element types are half precision, compute element types are single precision:
+ EXPECT_EQ(TensorElementTypeSize(TensorElementType::REAL16),2);
+ EXPECT_EQ(tensorComputeElementType(TensorElementType::REAL16),TensorElementType::REAL32);
+ EXPECT_EQ(tensorComputeElementType(TensorElementType::COMPLEX16),TensorElementType::COMPLEX32);
+ EXPECT_EQ(tensorComputeElementType(TensorElementType::REAL64),TensorElementType::REAL64);
+ auto tensor = std::make_shared<Tensor>("H",TensorShape{4,8});
+ tensor->setElementType(TensorElementType::REAL16);
+ EXPECT_EQ(tensor->getSize(),4*8*sizeof(float));
+
+ //Binary16 conversion (round to nearest even, exact in the opposite direction):
+ EXPECT_EQ(Float16(1.0f).getBits(),0x3C00);
+ EXPECT_EQ(Float16(-2.0f).getBits(),0xC000);
+ EXPECT_EQ(Float16(65504.0f).getBits(),0x7BFF);
+ EXPECT_EQ(Float16(1e6f).getBits(),0x7C00);
+ EXPECT_EQ(Float16(1.0f + 1.0f/2048.0f).getBits(),0x3C00); //tie rounds to even
+ EXPECT_EQ(static_cast<float>(Float16(0.333251953125f)),0.333251953125f);
+ EXPECT_EQ(static_cast<float>(Float16(5.9604645e-08f)),5.9604645e-08f); //smallest subnormal
+ for(unsigned int bits = 0; bits < 0x7C00; ++bits){
+  const float value = Float16::toFloat(static_cast<std::uint16_t>(bits));
+  EXPECT_EQ(Float16::fromFloat(value),bits);
+ }
+ const ComplexFloat16 z(std::complex<float>{0.5f,-0.25f});
+ EXPECT_EQ(static_cast<std::complex<float>>(z),std::complex<float>(0.5f,-0.25f));
+}
+
+
+TEST(NumericsTester, checkBytePacket)
+{
+ //Tensor metadata is packed in bulk into a reusable byte packet:
+ BytePacketPool pool(1);
+ const std::string name(4096,'T'); //exceeds the initial packet capacity
+ Tensor tensor(name,TensorShape{2,3,4});
+ {
+  auto packet = pool.acquire();
+  tensor.pack(*packet);
+  resetBytePacket(packet.get());
+  Tensor copy(*packet);
+  EXPECT_EQ(copy.getName(),name);
+  EXPECT_TRUE(copy.getShape().isCongruentTo(tensor.getShape()));
+  int value = 0;
+  EXPECT_NE(extractArrayFromBytePacket(packet.get(),&value,1),0); //nothing left
+ }
+ EXPECT_EQ(pool.getNumIdle(),1);
+ auto packet = pool.acquire(1 << 20);
+ EXPECT_GE(packet->capacity,1 << 20);
+ EXPECT_EQ(packet->size_bytes,0);
+}
+
+
+TEST(NumericsTester, checkTensorNetworkPacking)
+{
+ //Tensor networks and expansions are packed with their contraction sequences:
+ auto t0 = std::make_shared<Tensor>("T0",TensorShape{2,2});
+ auto network = std::make_shared<TensorNetwork>("closure",
+                 "Z0() = T0(a,b) * T1(b,c,d) * T2(d,e) * H0(a,c,f,g) * S0(f,h) * S1(h,g,i) * S2(i,e)",
+                 std::map<std::string,std::shared_ptr<Tensor>>{
+                  {"Z0",std::make_shared<Tensor>("Z0")},
+                  {"T0",t0},
+                  {"T1",std::make_shared<Tensor>("T1",TensorShape{2,2,2})},
+                  {"T2",std::make_shared<Tensor>("T2",TensorShape{2,2})},
+                  {"H0",std::make_shared<Tensor>("H0",TensorShape{2,2,2,2})},
+                  {"S0",std::make_shared<Tensor>("S0",TensorShape{2,2})},
+                  {"S1",std::make_shared<Tensor>("S1",TensorShape{2,2,2})},
+                  {"S2",std::make_shared<Tensor>("S2",TensorShape{2,2})}
+                 }
+                );
+ const double flops = network->determineContractionSequence("greed");
+ BytePacketPool pool(1);
+ {
+  auto packet = pool.acquire();
+  network->pack(*packet);
+  resetBytePacket(packet.get());
+  TensorNetwork copy(*packet);
+  EXPECT_EQ(copy.getName(),network->getName());
+  EXPECT_EQ(copy.getNumTensors(),network->getNumTensors());
+  EXPECT_EQ(copy.getFMAFlops(),flops);
+  const auto & seq = network->exportContractionSequence();
+  const auto & copy_seq = copy.exportContractionSequence();
+  ASSERT_EQ(copy_seq.size(),seq.size());
+  for(auto iter = seq.cbegin(), copy_iter = copy_seq.cbegin(); iter != seq.cend(); ++iter, ++copy_iter){
+   EXPECT_EQ(copy_iter->result_id,iter->result_id);
+   EXPECT_EQ(copy_iter->left_id,iter->left_id);
+   EXPECT_EQ(copy_iter->right_id,iter->right_id);
+  }
+  for(auto iter = network->cbegin(); iter != network->cend(); ++iter){
+   const auto tensor_id = iter->first;
+   ASSERT_NE(copy.getTensor(tensor_id),nullptr);
+   EXPECT_EQ(copy.getTensor(tensor_id)->getName(),iter->second.getName());
+   const auto & legs = *(network->getTensorConnections(tensor_id));
+   const auto & copy_legs = *(copy.getTensorConnections(tensor_id));
+   ASSERT_EQ(copy_legs.size(),legs.size());
+   for(unsigned int i = 0; i < legs.size(); ++i){
+    EXPECT_EQ(copy_legs[i].getTensorId(),legs[i].getTensorId());
+    EXPECT_EQ(copy_legs[i].getDimensionId(),legs[i].getDimensionId());
+   }
+  }
+ }
+ //Tensors shared by the components of an expansion stay shared:
+ auto other = std::make_shared<TensorNetwork>(*network);
+ other->rename("other");
+ TensorExpansion expansion("expansion");
+ EXPECT_TRUE(expansion.appendComponent(network,std::complex<double>{1.0,0.0}));
+ EXPECT_TRUE(expansion.appendComponent(other,std::complex<double>{0.5,-0.5}));
+ {
+  auto packet = pool.acquire();
+  expansion.pack(*packet);
+  resetBytePacket(packet.get());
+  TensorExpansion copy(*packet);
+  EXPECT_EQ(copy.getName(),expansion.getName());
+  ASSERT_EQ(copy.getNumComponents(),2);
+  EXPECT_EQ(copy.getCoefficients(),expansion.getCoefficients());
+  auto first = copy.cbegin();
+  auto second = first; ++second;
+  EXPECT_EQ(first->network->getTensor(1),second->network->getTensor(1));
+  EXPECT_EQ(first->network->getTensor(1)->getName(),t0->getName());
+ }
+}
+
+
+TEST(NumericsTester, checkTensorRangeRuns)
+{
+ //Run-by-run traversal visits the same elements as the element-by-element iteration:
+ const std::vector<DimOffset> bases{1,0,2,0,1,0,0,1,0,2};
+ const std::vector<DimExtent> extents{3,2,2,1,3,2,1,2,2,2};
+ for(unsigned int rank: {1,3,8,10}){
+  const std::vector<DimOffset> bas(bases.cbegin(),bases.cbegin()+rank);
+  const std::vector<DimExtent> ext(extents.cbegin(),extents.cbegin()+rank);
+  for(unsigned int num_agents: {1,3}){
+   for(unsigned int agent = 0; agent < num_agents; ++agent){
+    TensorRange range(bas,ext), runs(bas,ext);
+    if(num_agents > 1){
+     if(!range.reset(num_agents,agent)) continue;
+     runs.reset(num_agents,agent);
+    }
+    std::vector<std::pair<DimOffset,DimOffset>> elements;
+    bool not_over = true;
+    while(not_over){
+     elements.emplace_back(std::make_pair(range.localOffset(),range.globalOffset()));
+     not_over = range.next();
+    }
+    std::size_t pos = 0;
+    runs.forEachRun([&](const DimOffset * mlndx, DimOffset local_offset, DimOffset global_offset, DimExtent length){
+     for(DimExtent k = 0; k < length; ++k){
+      ASSERT_LT(pos,elements.size());
+      EXPECT_EQ(elements[pos].first,local_offset + k);
+      EXPECT_EQ(elements[pos].second,global_offset + k);
+      ++pos;
+     }
+    });
+    EXPECT_EQ(pos,elements.size());
+   }
+  }
+ }
+}
+
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -2,6 +2,11 @@
 
 #include "TAProLLexer.h"
 #include "TAProLListenerCPPImpl.hpp"
+#include "TAProLListenerProgramImpl.hpp"
+
+#include <unordered_map>
+#include <functional>
+#include <mutex>
 
 using namespace antlr4;
 using namespace taprol;
@@ -41,6 +46,78 @@ void TAProLInterpreter::interpret(const std::string &src, std::ostream &output,
   tree::ParseTreeWalker::DEFAULT.walk(&listener, tree);
 }
 
+namespace {
+
+// Compiled TAProL programs: source hash --> programs (distinct sources with the same hash):
+std::unordered_map<std::size_t, std::vector<std::shared_ptr<const TAProLProgram>>> program_cache;
+std::mutex program_cache_mutex;
+
+} // namespace
+
+std::shared_ptr<const TAProLProgram>
+TAProLInterpreter::compile(const std::string &src) {
+  const auto src_hash = std::hash<std::string>{}(src);
+  {
+    std::lock_guard<std::mutex> lock(program_cache_mutex);
+    auto iter = program_cache.find(src_hash);
+    if (iter != program_cache.end()) {
+      for (const auto &program : iter->second) {
+        if (program->getSource() == src)
+          return program;
+      }
+    }
+  }
+
+  // Setup the Antlr Parser
+  ANTLRInputStream input(src);
+  TAProLLexer lexer(&input);
+  lexer.removeErrorListeners();
+  lexer.addErrorListener(new TAProLErrorListener());
+
+  CommonTokenStream tokens(&lexer);
+  TAProLParser parser(&tokens);
+  parser.removeErrorListeners();
+  parser.addErrorListener(new TAProLErrorListener());
+
+  // Walk the Parse Tree
+  tree::ParseTree *tree = parser.taprolsrc();
+
+  auto program = std::make_shared<TAProLProgram>(src);
+  if (parser.getNumberOfSyntaxErrors() > 0)
+    program->invalidate();
+  if (program->isValid()) {
+    TAProLListenerProgramImpl listener(*program);
+    tree::ParseTreeWalker::DEFAULT.walk(&listener, tree);
+  }
+  if (program->isValid())
+    program->finalize();
+  // Only successfully compiled programs are cached:
+  if (program->isValid()) {
+    std::lock_guard<std::mutex> lock(program_cache_mutex);
+    program_cache[src_hash].emplace_back(program);
+  }
+  return program;
+}
+
+bool TAProLInterpreter::execute(const std::string &src, TAProLProgramData &data) {
+  auto program = compile(src);
+  return program->execute(data);
+}
+
+std::size_t TAProLInterpreter::getNumCachedPrograms() {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  std::size_t num_programs = 0;
+  for (const auto &entry : program_cache)
+    num_programs += entry.second.size();
+  return num_programs;
+}
+
+void TAProLInterpreter::clearProgramCache() {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  program_cache.clear();
+  return;
+}
+
 } // namespace parser
 
 } // namespace exatn
@@ -3,6 +3,7 @@
 
 #include "antlr4-runtime.h"
 #include "num_server.hpp"
+#include "TAProLProgram.hpp"
 
 namespace exatn {
 
@@ -29,6 +30,20 @@ public:
   void interpret(const std::string &src);
   void interpret(const std::string &src, std::ostream &output,
                  std::map<std::string, std::string> &args);
+
+  /** Compiles a TAProL source into an executable program. The compiled programs
+      are cached by the source hash, thus the repeated compilation of the same
+      source returns the cached program without parsing it again. **/
+  std::shared_ptr<const TAProLProgram> compile(const std::string &src);
+
+  /** Compiles (or retrieves from the cache) and executes a TAProL source. **/
+  bool execute(const std::string &src, TAProLProgramData &data);
+
+  /** Returns the number of cached compiled programs **/
+  static std::size_t getNumCachedPrograms();
+
+  /** Clears the cache of compiled programs **/
+  static void clearProgramCache();
 };
 
 } // namespace parser
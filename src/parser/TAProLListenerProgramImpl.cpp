@@ -0,0 +1,362 @@
+/** ExaTN: TAProL parser
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh), Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "TAProLListenerProgramImpl.hpp"
+
+#include "exatn_numerics.hpp"
+#include "tensor_symbol.hpp"
+
+#include <algorithm>
+
+namespace exatn {
+
+namespace parser {
+
+namespace {
+
+TAProLValue makeValue(TAProLParser::RealContext *real) {
+  return TAProLValue{std::complex<double>(std::stod(real->getText()), 0.0), ""};
+}
+
+TAProLValue makeValue(TAProLParser::ComplexContext *cmplx) {
+  return TAProLValue{std::complex<double>(std::stod(cmplx->real(0)->getText()),
+                                           std::stod(cmplx->real(1)->getText())), ""};
+}
+
+TAProLValue makeValue(TAProLParser::PrefactorContext *prefactor) {
+  if (prefactor == nullptr)
+    return TAProLValue{std::complex<double>(1.0, 0.0), ""};
+  if (prefactor->real() != nullptr)
+    return makeValue(prefactor->real());
+  if (prefactor->complex() != nullptr)
+    return makeValue(prefactor->complex());
+  return TAProLValue{std::complex<double>(0.0, 0.0), prefactor->id()->getText()};
+}
+
+template <typename BoundContext>
+TAProLValue makeBound(BoundContext *bound) {
+  if (bound->INT() != nullptr)
+    return TAProLValue{std::complex<double>(std::stod(bound->INT()->getText()), 0.0), ""};
+  return TAProLValue{std::complex<double>(0.0, 0.0), bound->id()->getText()};
+}
+
+/** Removes the trailing prefactor from the text of a tensor operation **/
+std::string stripPrefactor(const std::string &text,
+                           TAProLParser::PrefactorContext *prefactor) {
+  if (prefactor == nullptr)
+    return text;
+  const auto suffix = "*" + prefactor->getText();
+  assert(text.size() > suffix.size());
+  return text.substr(0, text.size() - suffix.size());
+}
+
+/** Calls a tensor operation with a real prefactor if possible, complex otherwise **/
+template <typename Operation>
+bool callWithPrefactor(const TAProLValue &prefactor, const TAProLProgramData &data,
+                       Operation operation) {
+  std::complex<double> alpha;
+  if (!prefactor.resolve(data, alpha))
+    return false;
+  if (alpha.imag() == 0.0)
+    return operation(alpha.real());
+  return operation(alpha);
+}
+
+/** Collects the names of the tensors from a TAProL tensor list **/
+std::vector<std::string> collectTensorNames(TAProLParser::TensorContext *tensor,
+                                            TAProLParser::TensornameContext *tensorname) {
+  std::vector<std::string> names;
+  if (tensor != nullptr)
+    names.emplace_back(tensor->tensorname()->getText());
+  if (tensorname != nullptr)
+    names.emplace_back(tensorname->getText());
+  return names;
+}
+
+} // namespace
+
+void TAProLListenerProgramImpl::error(const std::string &message) {
+  std::cerr << "Invalid TAProL source: " << message << "\n";
+  program.invalidate();
+  return;
+}
+
+void TAProLListenerProgramImpl::enterScope(TAProLParser::ScopeContext *ctx) {
+  const auto scope_name = ctx->scopename(0)->getText();
+  program.appendInstruction([scope_name](TAProLProgramData &data) {
+    exatn::openScope(scope_name);
+    return true;
+  }, {}, {}, TAProLProgram::Statement::Kind::Barrier);
+  return;
+}
+
+void TAProLListenerProgramImpl::exitScope(TAProLParser::ScopeContext *ctx) {
+  program.appendInstruction([](TAProLProgramData &data) {
+    exatn::closeScope();
+    return true;
+  }, {}, {}, TAProLProgram::Statement::Kind::Barrier);
+  return;
+}
+
+void TAProLListenerProgramImpl::enterSpace(TAProLParser::SpaceContext *ctx) {
+  const bool complex_field = (ctx->numfield()->getText() == "complex");
+  for (auto space : ctx->spacedeflist()->spacedef()) {
+    const auto space_name = space->spacename()->getText();
+    spaces[space_name] = complex_field;
+    const auto lower = makeBound(space->range()->lowerbound());
+    const auto upper = makeBound(space->range()->upperbound());
+    program.appendInstruction([space_name, lower, upper](TAProLProgramData &data) {
+      if (exatn::numericalServer->getVectorSpace(space_name) != nullptr)
+        return true; // already registered (previous execution)
+      std::complex<double> lb, ub;
+      if (!(lower.resolve(data, lb) && upper.resolve(data, ub)))
+        return false;
+      exatn::createVectorSpace(space_name, static_cast<DimExtent>(ub.real() - lb.real() + 1.0));
+      return true;
+    });
+  }
+  return;
+}
+
+void TAProLListenerProgramImpl::enterSubspace(TAProLParser::SubspaceContext *ctx) {
+  if (ctx->spacename() == nullptr) {
+    error("Subspace definition without the containing space!");
+    return;
+  }
+  const auto space_name = ctx->spacename()->getText();
+  if (spaces.find(space_name) == spaces.end()) {
+    error("Undefined space: " + space_name);
+    return;
+  }
+  for (auto subspace : ctx->spacedeflist()->spacedef()) {
+    const auto subspace_name = subspace->spacename()->getText();
+    subspaces[subspace_name] = space_name;
+    const auto lower = makeBound(subspace->range()->lowerbound());
+    const auto upper = makeBound(subspace->range()->upperbound());
+    program.appendInstruction([subspace_name, space_name, lower, upper](TAProLProgramData &data) {
+      if (exatn::numericalServer->subspaceRegistered(subspace_name))
+        return true; // already registered (previous execution)
+      std::complex<double> lb, ub;
+      if (!(lower.resolve(data, lb) && upper.resolve(data, ub)))
+        return false;
+      exatn::createSubspace(subspace_name, space_name,
+                            std::pair<DimOffset, DimOffset>{static_cast<DimOffset>(lb.real()),
+                                                            static_cast<DimOffset>(ub.real())});
+      return true;
+    });
+  }
+  return;
+}
+
+void TAProLListenerProgramImpl::enterIndex(TAProLParser::IndexContext *ctx) {
+  const auto space_name = ctx->spacename()->getText();
+  std::pair<std::string, std::string> space_binding;
+  if (spaces.find(space_name) != spaces.end()) {
+    space_binding = std::make_pair(space_name, std::string());
+  } else {
+    auto iter = subspaces.find(space_name);
+    if (iter == subspaces.end()) {
+      error("Undefined space: " + space_name);
+      return;
+    }
+    space_binding = std::make_pair(iter->second, space_name);
+  }
+  for (auto indx : ctx->indexlist()->indexname()) {
+    indices[indx->getText()] = space_binding;
+  }
+  return;
+}
+
+void TAProLListenerProgramImpl::enterAssign(TAProLParser::AssignContext *ctx) {
+  const auto tensor_name = ctx->tensor()->tensorname()->getText();
+  if (ctx->methodname() != nullptr) {
+    auto method_name = ctx->methodname()->getText();
+    method_name.erase(std::remove(method_name.begin(), method_name.end(), '"'), method_name.end());
+    program.appendInstruction([tensor_name, method_name](TAProLProgramData &data) {
+      return exatn::transformTensor(tensor_name, method_name);
+    }, {tensor_name}, {tensor_name});
+    return;
+  }
+  // Resolve the tensor signature:
+  std::vector<std::pair<std::string, std::string>> signature;
+  bool complex_field = (ctx->complex() != nullptr);
+  if (ctx->tensor()->indexlist() != nullptr) {
+    for (auto indx : ctx->tensor()->indexlist()->indexname()) {
+      auto iter = indices.find(indx->getText());
+      if (iter == indices.end()) {
+        error("Undefined index: " + indx->getText());
+        return;
+      }
+      signature.emplace_back(iter->second);
+      complex_field = complex_field || spaces[iter->second.first];
+    }
+  }
+  const auto tensor_data_type =
+      complex_field ? TensorElementType::COMPLEX64 : TensorElementType::REAL64;
+  const bool has_value = (ctx->complex() != nullptr || ctx->real() != nullptr);
+  const auto value = (ctx->complex() != nullptr)
+                         ? makeValue(ctx->complex())
+                         : ((ctx->real() != nullptr) ? makeValue(ctx->real()) : TAProLValue{});
+  const auto container = (ctx->datacontainer() != nullptr) ? ctx->datacontainer()->getText() : std::string();
+  const bool zero_init = container.empty() && has_value && value.isLiteral() &&
+                         (value.value == std::complex<double>(0.0, 0.0));
+  program.appendInstruction([tensor_name, signature, tensor_data_type, has_value, value,
+                             container](TAProLProgramData &data) {
+    std::vector<std::pair<SpaceId, SubspaceId>> subspace_ids;
+    for (const auto &binding : signature) {
+      const auto *space = exatn::numericalServer->getVectorSpace(binding.first);
+      if (space == nullptr)
+        return false;
+      SubspaceId subspace_id = FULL_SUBSPACE;
+      if (!binding.second.empty())
+        subspace_id = exatn::getSubspace(binding.second)->getRegisteredId();
+      subspace_ids.emplace_back(std::make_pair(space->getRegisteredId(), subspace_id));
+    }
+    bool success = exatn::createTensor(tensor_name, TensorSignature(subspace_ids), tensor_data_type);
+    if (success && !container.empty()) {
+      auto iter = data.containers.find(container);
+      if (iter == data.containers.end()) {
+        std::cout << "#ERROR(exatn::parser::TAProLProgram): Undefined data container: "
+                  << container << std::endl;
+        return false;
+      }
+      if (tensor_data_type == TensorElementType::COMPLEX64) {
+        success = exatn::initTensorData(tensor_name, iter->second);
+      } else {
+        std::vector<double> real_data(iter->second.size());
+        for (std::size_t i = 0; i < real_data.size(); ++i)
+          real_data[i] = iter->second[i].real();
+        success = exatn::initTensorData(tensor_name, real_data);
+      }
+    } else if (success && has_value) {
+      std::complex<double> init_value;
+      success = value.resolve(data, init_value);
+      if (success)
+        success = exatn::initTensor(tensor_name, init_value);
+    }
+    return success;
+  }, {}, {tensor_name}, TAProLProgram::Statement::Kind::Create, zero_init);
+  return;
+}
+
+void TAProLListenerProgramImpl::enterRetrieve(TAProLParser::RetrieveContext *ctx) {
+  const auto container = ctx->datacontainer()->getText();
+  const auto names = collectTensorNames(ctx->tensor(), ctx->tensorname());
+  assert(names.size() == 1);
+  const auto tensor_name = names[0];
+  program.appendInstruction([container, tensor_name](TAProLProgramData &data) {
+    auto local_tensor = exatn::getLocalTensor(tensor_name);
+    data.tensors[container] = local_tensor;
+    return static_cast<bool>(local_tensor);
+  }, {tensor_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::enterDestroy(TAProLParser::DestroyContext *ctx) {
+  std::vector<std::string> names;
+  if (ctx->tensorlist() != nullptr) {
+    for (auto tens : ctx->tensorlist()->tensor())
+      names.emplace_back(tens->tensorname()->getText());
+    for (auto tens : ctx->tensorlist()->tensorname())
+      names.emplace_back(tens->getText());
+  } else {
+    names = collectTensorNames(ctx->tensor(), ctx->tensorname());
+  }
+  for (const auto &name : names) {
+    program.appendInstruction([name](TAProLProgramData &data) {
+      return exatn::destroyTensor(name);
+    }, {}, {name}, TAProLProgram::Statement::Kind::Destroy);
+  }
+  return;
+}
+
+void TAProLListenerProgramImpl::enterNorm1(TAProLParser::Norm1Context *ctx) {
+  const auto scalar_name = ctx->scalar()->getText();
+  const auto tensor_name = collectTensorNames(ctx->tensor(), ctx->tensorname())[0];
+  program.appendInstruction([scalar_name, tensor_name](TAProLProgramData &data) {
+    return exatn::computeNorm1Sync(tensor_name, data.scalars[scalar_name]);
+  }, {tensor_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::enterNorm2(TAProLParser::Norm2Context *ctx) {
+  const auto scalar_name = ctx->scalar()->getText();
+  const auto tensor_name = collectTensorNames(ctx->tensor(), ctx->tensorname())[0];
+  program.appendInstruction([scalar_name, tensor_name](TAProLProgramData &data) {
+    return exatn::computeNorm2Sync(tensor_name, data.scalars[scalar_name]);
+  }, {tensor_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::enterMaxabs(TAProLParser::MaxabsContext *ctx) {
+  const auto scalar_name = ctx->scalar()->getText();
+  const auto tensor_name = collectTensorNames(ctx->tensor(), ctx->tensorname())[0];
+  program.appendInstruction([scalar_name, tensor_name](TAProLProgramData &data) {
+    return exatn::computeMaxAbsSync(tensor_name, data.scalars[scalar_name]);
+  }, {tensor_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::enterScale(TAProLParser::ScaleContext *ctx) {
+  const auto tensor_name = ctx->tensor()->tensorname()->getText();
+  const auto prefactor = makeValue(ctx->prefactor());
+  program.appendInstruction([tensor_name, prefactor](TAProLProgramData &data) {
+    return callWithPrefactor(prefactor, data, [&tensor_name](auto alpha) {
+      return exatn::scaleTensor(tensor_name, alpha);
+    });
+  }, {tensor_name}, {tensor_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::enterAddition(TAProLParser::AdditionContext *ctx) {
+  const auto addition = stripPrefactor(ctx->getText(), ctx->prefactor());
+  const auto prefactor = makeValue(ctx->prefactor());
+  const auto output_name = ctx->tensor(0)->tensorname()->getText();
+  const auto input_name = (ctx->conjtensor() != nullptr) ? ctx->conjtensor()->tensorname()->getText()
+                                                         : ctx->tensor(1)->tensorname()->getText();
+  program.appendInstruction([addition, prefactor](TAProLProgramData &data) {
+    return callWithPrefactor(prefactor, data, [&addition](auto alpha) {
+      return exatn::addTensors(addition, alpha);
+    });
+  }, {input_name}, {output_name});
+  return;
+}
+
+void TAProLListenerProgramImpl::appendProduct(const std::string &text,
+                                              TAProLParser::PrefactorContext *prefactor) {
+  auto product = std::make_shared<TAProLProduct>();
+  if (!exatn::parse_tensor_network(stripPrefactor(text, prefactor), product->tensors)) {
+    error("Invalid tensor product: " + text);
+    return;
+  }
+  for (const auto &tensor : product->tensors) {
+    std::string tensor_name;
+    std::vector<IndexLabel> indices;
+    bool complex_conj;
+    if (!exatn::parse_tensor(tensor, tensor_name, indices, complex_conj)) {
+      error("Invalid tensor: " + tensor);
+      return;
+    }
+  }
+  if (prefactor != nullptr)
+    product->prefactors.emplace_back(makeValue(prefactor));
+  program.appendProduct(product);
+  return;
+}
+
+void TAProLListenerProgramImpl::enterContraction(TAProLParser::ContractionContext *ctx) {
+  appendProduct(ctx->getText(), ctx->prefactor());
+  return;
+}
+
+void TAProLListenerProgramImpl::enterCompositeproduct(TAProLParser::CompositeproductContext *ctx) {
+  appendProduct(ctx->getText(), ctx->prefactor());
+  return;
+}
+
+} // namespace parser
+
+} // namespace exatn
@@ -0,0 +1,80 @@
+/** ExaTN: TAProL parser
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh), Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#ifndef EXATN_TAPROLLISTENERPROGRAMIMPL_HPP_
+#define EXATN_TAPROLLISTENERPROGRAMIMPL_HPP_
+
+#include "TAProLBaseListener.h"
+#include "TAProLParser.h"
+
+#include "TAProLProgram.hpp"
+
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace taprol;
+
+namespace exatn {
+
+namespace parser {
+
+/** Lowers the TAProL parse tree into a compiled TAProL program **/
+class TAProLListenerProgramImpl : public TAProLBaseListener {
+
+public:
+  TAProLListenerProgramImpl(TAProLProgram &_program) : program(_program) {}
+
+  virtual void enterScope(TAProLParser::ScopeContext *ctx) override;
+  virtual void exitScope(TAProLParser::ScopeContext *ctx) override;
+
+  virtual void enterSpace(TAProLParser::SpaceContext *ctx) override;
+
+  virtual void enterSubspace(TAProLParser::SubspaceContext *ctx) override;
+
+  virtual void enterIndex(TAProLParser::IndexContext *ctx) override;
+
+  virtual void enterAssign(TAProLParser::AssignContext *ctx) override;
+
+  virtual void enterRetrieve(TAProLParser::RetrieveContext *ctx) override;
+
+  virtual void enterDestroy(TAProLParser::DestroyContext *ctx) override;
+
+  virtual void enterNorm1(TAProLParser::Norm1Context *ctx) override;
+
+  virtual void enterNorm2(TAProLParser::Norm2Context *ctx) override;
+
+  virtual void enterMaxabs(TAProLParser::MaxabsContext *ctx) override;
+
+  virtual void enterScale(TAProLParser::ScaleContext *ctx) override;
+
+  virtual void enterAddition(TAProLParser::AdditionContext *ctx) override;
+
+  virtual void enterContraction(TAProLParser::ContractionContext *ctx) override;
+
+  virtual void
+  enterCompositeproduct(TAProLParser::CompositeproductContext *ctx) override;
+
+  virtual ~TAProLListenerProgramImpl() {}
+
+protected:
+  /** Reports a compilation error and invalidates the program **/
+  void error(const std::string &message);
+
+  /** Appends a tensor product (contraction or composite product) to the program **/
+  void appendProduct(const std::string &text, TAProLParser::PrefactorContext *prefactor);
+
+  TAProLProgram &program;
+  std::map<std::string, bool> spaces;                  // space name --> complex field
+  std::map<std::string, std::string> subspaces;        // subspace name --> space name
+  std::map<std::string, std::pair<std::string, std::string>> indices; // index name --> {space name, subspace name (empty for the full space)}
+};
+
+} // namespace parser
+
+} // namespace exatn
+
+#endif // EXATN_TAPROLLISTENERPROGRAMIMPL_HPP_
@@ -0,0 +1,370 @@
+/** ExaTN: TAProL compiled program
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh), Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "TAProLProgram.hpp"
+
+#include "exatn_numerics.hpp"
+#include "tensor_symbol.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <set>
+
+namespace exatn {
+
+namespace parser {
+
+bool TAProLValue::resolve(const TAProLProgramData &data,
+                          std::complex<double> &result) const {
+  if (isLiteral()) {
+    result = value;
+    return true;
+  }
+  auto iter = data.scalars.find(scalar_name);
+  if (iter == data.scalars.end()) {
+    std::cout << "#ERROR(exatn::parser::TAProLProgram): Undefined scalar: "
+              << scalar_name << std::endl;
+    return false;
+  }
+  result = std::complex<double>(iter->second, 0.0);
+  return true;
+}
+
+namespace {
+
+/** Returns the name of a symbolic tensor **/
+std::string getTensorName(const std::string &tensor) {
+  std::string tensor_name;
+  std::vector<IndexLabel> indices;
+  bool conjugated;
+  bool parsed = parse_tensor(tensor, tensor_name, indices, conjugated);
+  assert(parsed);
+  return tensor_name;
+}
+
+/** Substitutes the tensor product computing an intermediate tensor into
+    the tensor product consuming it (returns nullptr if not possible) **/
+std::shared_ptr<TAProLProduct> substituteProduct(const TAProLProduct &consumer,
+                                                 const TAProLProduct &producer) {
+  std::string intermediate;
+  std::vector<IndexLabel> output_indices;
+  bool conjugated;
+  if (!parse_tensor(producer.tensors[0], intermediate, output_indices, conjugated))
+    return nullptr;
+  // Find the intermediate tensor among the factors of the consuming tensor product:
+  std::set<std::string> used_labels;
+  std::vector<IndexLabel> intermediate_indices;
+  std::size_t position = 0;
+  for (std::size_t i = 0; i < consumer.tensors.size(); ++i) {
+    std::string tensor_name;
+    std::vector<IndexLabel> indices;
+    if (!parse_tensor(consumer.tensors[i], tensor_name, indices, conjugated))
+      return nullptr;
+    for (const auto &index : indices)
+      used_labels.emplace(index.label);
+    if (i > 0 && tensor_name == intermediate) {
+      if (conjugated)
+        return nullptr;
+      position = i;
+      intermediate_indices = indices;
+    }
+  }
+  if (position == 0 || intermediate_indices.size() != output_indices.size())
+    return nullptr;
+  // Map the output indices of the producer onto the indices of the intermediate:
+  std::map<std::string, std::string> relabel;
+  std::set<std::string> target_labels;
+  for (std::size_t i = 0; i < output_indices.size(); ++i) {
+    if (!relabel.emplace(output_indices[i].label, intermediate_indices[i].label).second)
+      return nullptr; // repeated output index
+    if (!target_labels.emplace(intermediate_indices[i].label).second)
+      return nullptr; // repeated intermediate index
+  }
+  // Substitute the relabeled factors of the producer:
+  auto product = std::make_shared<TAProLProduct>();
+  product->tensors.assign(consumer.tensors.cbegin(), consumer.tensors.cbegin() + position);
+  for (std::size_t i = 1; i < producer.tensors.size(); ++i) {
+    std::string tensor_name;
+    std::vector<IndexLabel> indices;
+    if (!parse_tensor(producer.tensors[i], tensor_name, indices, conjugated))
+      return nullptr;
+    for (auto &index : indices) {
+      auto iter = relabel.find(index.label);
+      if (iter == relabel.end()) { // internal index of the producer
+        std::string label = index.label;
+        for (unsigned int n = 0; used_labels.find(label) != used_labels.end(); ++n)
+          label = index.label + "_" + std::to_string(n);
+        used_labels.emplace(label);
+        iter = relabel.emplace(index.label, label).first;
+      }
+      index.label = iter->second;
+    }
+    product->tensors.emplace_back(assemble_symbolic_tensor(tensor_name, indices, conjugated));
+  }
+  product->tensors.insert(product->tensors.end(), consumer.tensors.cbegin() + position + 1,
+                          consumer.tensors.cend());
+  product->prefactors = consumer.prefactors;
+  product->prefactors.insert(product->prefactors.end(), producer.prefactors.cbegin(),
+                             producer.prefactors.cend());
+  return product;
+}
+
+/** Resolves the total prefactor of a tensor product **/
+bool resolvePrefactor(const TAProLProduct &product, const TAProLProgramData &data,
+                      std::complex<double> &prefactor) {
+  prefactor = std::complex<double>(1.0, 0.0);
+  for (const auto &factor : product.prefactors) {
+    std::complex<double> value;
+    if (!factor.resolve(data, value))
+      return false;
+    prefactor *= value;
+  }
+  return true;
+}
+
+} // namespace
+
+void TAProLProgram::appendInstruction(Instruction instruction,
+                                      const std::vector<std::string> &reads,
+                                      const std::vector<std::string> &writes,
+                                      Statement::Kind kind, bool zero_init) {
+  assert(!finalized_);
+  statements_.emplace_back(Statement{kind, instruction, reads, writes, zero_init, {}});
+  return;
+}
+
+void TAProLProgram::appendProduct(std::shared_ptr<TAProLProduct> product) {
+  assert(!finalized_ && product->tensors.size() > 2);
+  std::vector<std::string> reads;
+  for (auto tensor = product->tensors.cbegin() + 1; tensor != product->tensors.cend(); ++tensor)
+    reads.emplace_back(getTensorName(*tensor));
+  statements_.emplace_back(Statement{Statement::Kind::Product, nullptr, reads,
+                                     {getTensorName(product->tensors[0])}, false, {product}});
+  return;
+}
+
+void TAProLProgram::finalize(bool batching) {
+  if (finalized_)
+    return;
+  if (valid_ && batching) {
+    fuseIntermediates();
+    groupProducts();
+  }
+  for (auto &statement : statements_) {
+    if (statement.kind == Statement::Kind::Product)
+      statement.instruction = lowerProducts(statement.products);
+  }
+  finalized_ = true;
+  return;
+}
+
+void TAProLProgram::fuseIntermediates() {
+  auto mentions = [](const Statement &statement, const std::string &name) {
+    return std::find(statement.reads.cbegin(), statement.reads.cend(), name) != statement.reads.cend() ||
+           std::find(statement.writes.cbegin(), statement.writes.cend(), name) != statement.writes.cend();
+  };
+  const auto num_statements = statements_.size();
+  std::vector<bool> removed(num_statements, false);
+  for (std::size_t i = 0; i < num_statements; ++i) {
+    if (removed[i] || statements_[i].kind != Statement::Kind::Create || !statements_[i].zero_init)
+      continue;
+    const auto name = statements_[i].writes[0];
+    // Find the next three statements referring to the intermediate tensor within the same scope:
+    std::vector<std::size_t> refs;
+    for (std::size_t s = i + 1; s < num_statements && refs.size() < 3; ++s) {
+      if (removed[s])
+        continue;
+      if (statements_[s].kind == Statement::Kind::Barrier)
+        break;
+      if (mentions(statements_[s], name))
+        refs.emplace_back(s);
+    }
+    if (refs.size() < 3)
+      continue;
+    auto &producer = statements_[refs[0]];
+    auto &consumer = statements_[refs[1]];
+    const auto &destruction = statements_[refs[2]];
+    // Producer: single tensor product computing the intermediate with literal prefactors:
+    if (producer.kind != Statement::Kind::Product || producer.products.size() != 1 ||
+        producer.writes[0] != name ||
+        std::find(producer.reads.cbegin(), producer.reads.cend(), name) != producer.reads.cend())
+      continue;
+    if (!std::all_of(producer.products[0]->prefactors.cbegin(), producer.products[0]->prefactors.cend(),
+                     [](const TAProLValue &value) { return value.isLiteral(); }))
+      continue;
+    // Consumer: single tensor product reading the intermediate once:
+    if (consumer.kind != Statement::Kind::Product || consumer.products.size() != 1 ||
+        consumer.writes[0] == name || std::count(consumer.reads.cbegin(), consumer.reads.cend(), name) != 1)
+      continue;
+    if (destruction.kind != Statement::Kind::Destroy)
+      continue;
+    // The factors of the producer must not change before the consumer:
+    bool unchanged = true;
+    for (std::size_t s = refs[0] + 1; unchanged && s < refs[1]; ++s) {
+      if (removed[s])
+        continue;
+      for (const auto &tensor : statements_[s].writes)
+        unchanged = unchanged && (std::find(producer.reads.cbegin(), producer.reads.cend(), tensor) == producer.reads.cend());
+    }
+    if (!unchanged)
+      continue;
+    auto product = substituteProduct(*(consumer.products[0]), *(producer.products[0]));
+    if (!product)
+      continue;
+    consumer.products[0] = product;
+    consumer.reads.erase(std::find(consumer.reads.begin(), consumer.reads.end(), name));
+    consumer.reads.insert(consumer.reads.end(), producer.reads.cbegin(), producer.reads.cend());
+    removed[i] = true;
+    removed[refs[0]] = true;
+    removed[refs[2]] = true;
+    ++num_fused_intermediates_;
+  }
+  std::vector<Statement> statements;
+  for (std::size_t i = 0; i < num_statements; ++i) {
+    if (!removed[i])
+      statements.emplace_back(std::move(statements_[i]));
+  }
+  statements_ = std::move(statements);
+  return;
+}
+
+void TAProLProgram::groupProducts() {
+  std::vector<Statement> statements;
+  for (auto &statement : statements_) {
+    if (statement.kind == Statement::Kind::Product && !statements.empty()) {
+      auto &group = statements.back();
+      const auto &output = statement.writes[0];
+      if (group.kind == Statement::Kind::Product &&
+          group.products[0]->tensors[0] == statement.products[0]->tensors[0] &&
+          std::find(group.reads.cbegin(), group.reads.cend(), output) == group.reads.cend() &&
+          std::find(statement.reads.cbegin(), statement.reads.cend(), output) == statement.reads.cend()) {
+        group.products.insert(group.products.end(), statement.products.cbegin(), statement.products.cend());
+        group.reads.insert(group.reads.end(), statement.reads.cbegin(), statement.reads.cend());
+        num_grouped_products_ += statement.products.size();
+        continue;
+      }
+    }
+    statements.emplace_back(std::move(statement));
+  }
+  statements_ = std::move(statements);
+  return;
+}
+
+TAProLProgram::Instruction
+TAProLProgram::lowerProducts(const std::vector<std::shared_ptr<TAProLProduct>> &products) {
+  assert(!products.empty());
+  const auto output_name = getTensorName(products[0]->tensors[0]);
+  std::vector<std::string> networks;
+  std::vector<std::vector<std::string>> tensor_names;
+  bool reads_output = false;
+  for (const auto &product : products) {
+    networks.emplace_back(assemble_symbolic_tensor_network(product->tensors));
+    tensor_names.emplace_back(std::vector<std::string>{});
+    for (auto tensor = product->tensors.cbegin() + 1; tensor != product->tensors.cend(); ++tensor) {
+      tensor_names.back().emplace_back(getTensorName(*tensor));
+      reads_output = reads_output || (tensor_names.back().back() == output_name);
+    }
+  }
+  // Binary tensor contraction:
+  if (products.size() == 1 && products[0]->tensors.size() == 3) {
+    const auto product = products[0];
+    const auto contraction = networks[0];
+    return [product, contraction](TAProLProgramData &data) {
+      std::complex<double> alpha;
+      if (!resolvePrefactor(*product, data, alpha))
+        return false;
+      if (alpha.imag() == 0.0)
+        return exatn::contractTensors(contraction, alpha.real());
+      return exatn::contractTensors(contraction, alpha);
+    };
+  }
+  // Tensor network expansion accumulated into the output tensor:
+  auto contr_sequences = std::make_shared<std::vector<std::pair<std::list<numerics::ContrTriple>, double>>>(products.size());
+  return [products, output_name, networks, tensor_names, reads_output,
+          contr_sequences](TAProLProgramData &data) {
+    auto accumulator = exatn::getTensor(output_name);
+    if (!accumulator) {
+      std::cout << "#ERROR(exatn::parser::TAProLProgram): Output tensor " << output_name
+                << " not found in tensor network: " << networks[0] << std::endl;
+      return false;
+    }
+    TensorExpansion expansion("_TAProLExpansion");
+    std::vector<std::shared_ptr<TensorNetwork>> components;
+    for (std::size_t i = 0; i < products.size(); ++i) {
+      std::map<std::string, std::shared_ptr<Tensor>> tensor_map;
+      for (const auto &tensor_name : tensor_names[i]) {
+        auto tensor = exatn::getTensor(tensor_name);
+        if (!tensor) {
+          std::cout << "#ERROR(exatn::parser::TAProLProgram): Tensor " << tensor_name
+                    << " not found in tensor network: " << networks[i] << std::endl;
+          return false;
+        }
+        tensor_map.emplace(std::make_pair(tensor_name, tensor));
+      }
+      if (!reads_output) { // each tensor network computes its own output tensor
+        auto output_tensor = std::make_shared<Tensor>(*accumulator);
+        output_tensor->rename();
+        tensor_map[output_name] = output_tensor;
+      }
+      auto network = std::make_shared<TensorNetwork>("_TAProLNetwork", networks[i], tensor_map);
+      const auto &contr_sequence = (*contr_sequences)[i];
+      if (!contr_sequence.first.empty())
+        network->importContractionSequence(contr_sequence.first, contr_sequence.second);
+      components.emplace_back(network);
+      if (reads_output)
+        continue;
+      std::complex<double> coefficient;
+      if (!resolvePrefactor(*(products[i]), data, coefficient))
+        return false;
+      if (!expansion.appendComponent(network, coefficient))
+        return false;
+    }
+    bool success = true;
+    if (reads_output) { // the output tensor is updated in place by each tensor network
+      for (std::size_t i = 0; success && i < components.size(); ++i) {
+        std::complex<double> coefficient;
+        success = resolvePrefactor(*(products[i]), data, coefficient);
+        if (success && coefficient != std::complex<double>(1.0, 0.0)) {
+          std::cout << "#ERROR(exatn::parser::TAProLProgram): Prefactors are not supported in a tensor network"
+                    << " updating its own input tensor: " << networks[i] << std::endl;
+          success = false;
+        }
+        if (success)
+          success = exatn::numericalServer->submit(components[i]);
+      }
+    } else {
+      success = exatn::evaluate(expansion, accumulator);
+    }
+    // Remember the tensor contraction sequences for subsequent executions:
+    for (std::size_t i = 0; success && i < components.size(); ++i) {
+      auto &contr_sequence = (*contr_sequences)[i];
+      if (contr_sequence.first.empty())
+        contr_sequence.first = components[i]->exportContractionSequence(&(contr_sequence.second));
+    }
+    return success;
+  };
+}
+
+bool TAProLProgram::execute(TAProLProgramData &data) const {
+  if (!valid_ || !finalized_) {
+    std::cout << "#ERROR(exatn::parser::TAProLProgram::execute): "
+              << "Attempt to execute an invalid or unfinalized TAProL program!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < statements_.size(); ++i) {
+    if (!statements_[i].instruction(data)) {
+      std::cout << "#ERROR(exatn::parser::TAProLProgram::execute): "
+                << "Instruction " << i << " failed!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace parser
+
+} // namespace exatn
@@ -0,0 +1,162 @@
+/** ExaTN: TAProL compiled program
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh), Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A TAProL source is lowered once into an in-memory program, that is, a sequence of
+     statements, each compiled into an instruction calling the numerical server directly,
+     instead of C++ source text. The symbols of the TAProL source (spaces, subspaces, indices)
+     are resolved during the compilation, such that each instruction only refers to the
+     registered vector spaces and subspaces by name. The compiled program can be executed
+     many times with different external data (data containers and scalars supplied in
+     TAProLProgramData).
+ (b) Each statement records the names of the tensors it reads and writes. Before the
+     instructions are generated, a dependency analysis pass over the statements of each
+     TAProL scope (scope boundaries are barriers) does the following:
+     (1) An intermediate tensor X which is created zero-initialized, computed by a single
+         tensor product, consumed by a single subsequent tensor product and then destroyed,
+         with the factors of its tensor product unchanged in between, is eliminated by
+         substituting its tensor product into the consuming tensor product (the internal
+         indices are relabeled), thus forming a larger tensor network;
+     (2) Consecutive tensor products accumulating into the same output tensor (which none
+         of them reads) are grouped into a single tensor network expansion.
+     Tensor products with more than two factors and grouped tensor products are evaluated
+     as a tensor network expansion accumulated into the output tensor, such that the
+     numerical server sees all tensor networks of the group at once (joint contraction
+     sequence determination and scheduling).
+ (c) Each tensor network remembers its tensor contraction sequence after the first execution
+     and imports it in all subsequent executions, thus skipping the contraction sequence search.
+**/
+
+#ifndef EXATN_TAPROLPROGRAM_HPP_
+#define EXATN_TAPROLPROGRAM_HPP_
+
+#include "num_server.hpp"
+
+#include <functional>
+#include <complex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+
+namespace exatn {
+
+namespace parser {
+
+/** External data for a TAProL program execution **/
+struct TAProLProgramData {
+  std::map<std::string, std::vector<std::complex<double>>> containers; // in: data containers for tensor initialization
+  std::map<std::string, double> scalars;                               // inout: scalars (prefactors, range bounds, computed norms)
+  std::map<std::string, std::shared_ptr<talsh::Tensor>> tensors;       // out: retrieved local tensor copies
+};
+
+/** Numeric value given either by a literal or by a named scalar (resolved at execution) **/
+struct TAProLValue {
+  std::complex<double> value{1.0, 0.0}; // literal value
+  std::string scalar_name;              // name of the scalar (empty for literals)
+
+  bool isLiteral() const { return scalar_name.empty(); }
+
+  /** Resolves the value (returns FALSE if the scalar is undefined) **/
+  bool resolve(const TAProLProgramData &data, std::complex<double> &result) const;
+};
+
+/** Tensor product: tensors[0] += prefactors * tensors[1] * tensors[2] * ... **/
+struct TAProLProduct {
+  std::vector<std::string> tensors;     // symbolic tensors: output tensor followed by the factors
+  std::vector<TAProLValue> prefactors;  // prefactors (multiplied together)
+};
+
+/** TAProL program compiled into a sequence of numerical server calls **/
+class TAProLProgram {
+public:
+  using Instruction = std::function<bool (TAProLProgramData &)>;
+
+  /** Program statement **/
+  struct Statement {
+    enum class Kind {
+      Other,   // generic instruction
+      Barrier, // scope boundary
+      Create,  // tensor creation (writes[0])
+      Destroy, // tensor destruction (writes[0])
+      Product  // tensor product(s) accumulating into the same output tensor
+    };
+    Kind kind;
+    Instruction instruction;                              // compiled instruction (tensor products are lowered later)
+    std::vector<std::string> reads;                       // names of the tensors read
+    std::vector<std::string> writes;                      // names of the tensors written (created, updated, destroyed)
+    bool zero_init;                                       // whether or not the created tensor is initialized to zero
+    std::vector<std::shared_ptr<TAProLProduct>> products; // tensor products (Product statement)
+  };
+
+  TAProLProgram(const std::string &src) : source_(src), valid_(true), finalized_(false),
+                                          num_fused_intermediates_(0), num_grouped_products_(0) {}
+
+  TAProLProgram(const TAProLProgram &) = delete;
+  TAProLProgram &operator=(const TAProLProgram &) = delete;
+  TAProLProgram(TAProLProgram &&) noexcept = default;
+  TAProLProgram &operator=(TAProLProgram &&) noexcept = default;
+  virtual ~TAProLProgram() = default;
+
+  /** Appends a new statement with a compiled instruction to the program **/
+  void appendInstruction(Instruction instruction,
+                         const std::vector<std::string> &reads = {},
+                         const std::vector<std::string> &writes = {},
+                         Statement::Kind kind = Statement::Kind::Other,
+                         bool zero_init = false);
+
+  /** Appends a new tensor product statement to the program **/
+  void appendProduct(std::shared_ptr<TAProLProduct> product);
+
+  /** Finalizes the program: Optionally runs the dependency analysis pass
+      (see rationale b) and then compiles the tensor products into instructions. **/
+  void finalize(bool batching = true);
+
+  /** Marks the program as invalid (compilation error) **/
+  void invalidate() { valid_ = false; }
+
+  /** Returns whether or not the program has been compiled successfully **/
+  bool isValid() const { return valid_; }
+
+  /** Returns the TAProL source of the program **/
+  const std::string &getSource() const { return source_; }
+
+  /** Returns the number of statements (instructions) in the program **/
+  std::size_t getNumInstructions() const { return statements_.size(); }
+
+  /** Returns the number of intermediate tensors eliminated by the dependency analysis **/
+  std::size_t getNumFusedIntermediates() const { return num_fused_intermediates_; }
+
+  /** Returns the number of tensor products grouped into tensor network expansions **/
+  std::size_t getNumGroupedProducts() const { return num_grouped_products_; }
+
+  /** Executes the finalized program with the given external data:
+      The execution stops at the first failed instruction. **/
+  bool execute(TAProLProgramData &data) const;
+
+private:
+  /** Eliminates intermediate tensors between consecutive tensor products **/
+  void fuseIntermediates();
+
+  /** Groups consecutive tensor products with the same output tensor **/
+  void groupProducts();
+
+  /** Compiles a tensor product statement into an instruction **/
+  static Instruction lowerProducts(const std::vector<std::shared_ptr<TAProLProduct>> &products);
+
+  std::string source_;                 // TAProL source
+  std::vector<Statement> statements_;  // program statements
+  bool valid_;                         // compilation status
+  bool finalized_;                     // finalization status
+  std::size_t num_fused_intermediates_; // number of eliminated intermediate tensors
+  std::size_t num_grouped_products_;   // number of grouped tensor products
+};
+
+} // namespace parser
+
+} // namespace exatn
+
+#endif // EXATN_TAPROLPROGRAM_HPP_
@@ -39,6 +39,83 @@ TEST(TAProLInterpreterTester, checkSimple) {
   interpreter.interpret(src);
 }
 
+TEST(TAProLInterpreterTester, checkCompiled) {
+
+  TAProLInterpreter interpreter;
+
+  const std::string src = R"src(
+  entry: main
+  scope main group()
+   space(real): vs=[0:7]
+   index(vs): i,j,k
+   A(i,k) = a_data
+   B(k,j) = 0.5
+   C(i,j) = 0.0
+   C(i,j) += A(i,k) * B(k,j) * alpha
+   D() = 0.0
+   D() += A(i,k) * B(k,j) * C(i,j)
+   norm_c = norm2(C)
+   norm_d = norm1(D)
+   destroy A,B,C,D
+  end scope main
+  )src";
+
+  TAProLInterpreter::clearProgramCache();
+  auto program = interpreter.compile(src);
+  EXPECT_TRUE(program->isValid());
+  EXPECT_EQ(TAProLInterpreter::getNumCachedPrograms(), 1UL);
+  // Execute the same TAProL source repeatedly with different external data:
+  for (int iter = 1; iter <= 3; ++iter) {
+    TAProLProgramData data;
+    data.containers["a_data"] = std::vector<std::complex<double>>(64, std::complex<double>(iter, 0.0));
+    data.scalars["alpha"] = 2.0;
+    EXPECT_TRUE(interpreter.execute(src, data));
+    EXPECT_EQ(interpreter.compile(src), program);
+    EXPECT_NEAR(data.scalars["norm_c"], 64.0 * iter, 1e-9);
+    EXPECT_NEAR(data.scalars["norm_d"], 2048.0 * iter * iter, 1e-6);
+  }
+  EXPECT_EQ(TAProLInterpreter::getNumCachedPrograms(), 1UL);
+  TAProLInterpreter::clearProgramCache();
+}
+
+TEST(TAProLInterpreterTester, checkBatched) {
+
+  TAProLInterpreter interpreter;
+
+  const std::string src = R"src(
+  entry: main
+  scope main group()
+   space(real): vs=[0:7]
+   index(vs): i,j,k,l
+   A(i,k) = a_data
+   B(k,j) = 0.5
+   C(j,l) = 1.0
+   X(i,j) = 0.0
+   X(i,j) += A(i,k) * B(k,j)
+   Y(i,l) = 0.0
+   Y(i,l) += X(i,j) * C(j,l) * 2.0
+   Y(i,l) += A(i,k) * C(k,l)
+   norm_y = norm1(Y)
+   destroy X
+   destroy A,B,C,Y
+  end scope main
+  )src";
+
+  TAProLInterpreter::clearProgramCache();
+  auto program = interpreter.compile(src);
+  EXPECT_TRUE(program->isValid());
+  // The intermediate X is substituted into the Y network which is then grouped with the second Y product:
+  EXPECT_EQ(program->getNumFusedIntermediates(), 1UL);
+  EXPECT_EQ(program->getNumGroupedProducts(), 1UL);
+  for (int iter = 1; iter <= 2; ++iter) {
+    TAProLProgramData data;
+    data.containers["a_data"] = std::vector<std::complex<double>>(64, std::complex<double>(iter, 0.0));
+    EXPECT_TRUE(interpreter.execute(src, data));
+    EXPECT_NEAR(data.scalars["norm_y"], 4608.0 * iter, 1e-6);
+  }
+  TAProLInterpreter::clearProgramCache();
+}
+
 int main(int argc, char **argv) {
   exatn::initialize();
 
@@ -0,0 +1,211 @@
+/** ExaTN:: Tensor Runtime: Automatic selection of the computational backend of tensor networks
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) A whole tensor network can be executed either by the default backend (TAL-SH node executor,
+     one tensor operation at a time, sliced by the numerical server under the memory limit per process)
+     or by the cuQuantum backend (cuTensorNet, slices distributed across all GPUs). Which one
+     is faster depends on the tensor network, thus the backend selector estimates the execution time
+     of the tensor network on each backend from its cost: The FMA flop count of its contraction
+     sequence, the size of its largest intermediate tensor (which determines the number of slices
+     needed under the available memory) and the total size of its input/output tensors (which must
+     fit into the GPU memory for cuQuantum, and which is transferred there).
+ (b) Time estimate = latency + number of slices * slice latency + FMA flops / (FMA flop rate * parallelism)
+     (+ input/output transfer time for cuQuantum, whose parallelism is the number of GPUs used by the slices).
+     The FMA flop rate of each backend starts from a prior (the default backend may be seeded from
+     the achieved flop rate reported by the runtime metrics), and it is learned from the observed
+     execution times of the tensor networks (exponential moving average).
+ (c) The execution times are also recorded per tensor network structure (key composed by the client):
+     Once a key has been seen a given number of times with only one backend measured, the other
+     (feasible) backend is tried once, unless its estimated time is much longer than the measured one.
+     Once both backends have been measured for a key, the faster one is selected for it.
+ (d) The backend selector is used by the thread submitting the tensor networks only (not thread-safe).
+**/
+
+#ifndef EXATN_RUNTIME_BACKEND_SELECTOR_HPP_
+#define EXATN_RUNTIME_BACKEND_SELECTOR_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+class BackendSelector {
+
+public:
+
+  /** Computational backends of tensor networks **/
+  enum Backend: int {
+    DEFAULT_BACKEND = 0,   //TAL-SH node executor
+    CUQUANTUM_BACKEND = 1, //cuQuantum tensor network executor
+    NUM_BACKENDS
+  };
+
+  /** Cost of a tensor network **/
+  struct NetworkCost {
+    double fma_flops = 0.0;              //FMA flop count of the contraction sequence
+    double max_intermediate_bytes = 0.0; //size of the largest intermediate tensor (bytes)
+    double io_bytes = 0.0;               //total size of the input and output tensors (bytes)
+  };
+
+  /** Resources available to the current process **/
+  struct Resources {
+    double host_memory = 0.0;   //memory limit per process of the default backend (bytes)
+    double device_memory = 0.0; //size of the smallest GPU device buffer (bytes)
+    unsigned int num_gpus = 0;  //number of GPUs
+  };
+
+  static constexpr const double DEFAULT_FMA_RATE = 1e10;     //prior FMA flop rate of the default backend (FMA/s)
+  static constexpr const double CUQUANTUM_FMA_RATE = 1e12;   //prior FMA flop rate of the cuQuantum backend per GPU (FMA/s)
+  static constexpr const double DEFAULT_LATENCY = 1e-4;      //latency of a tensor network execution by the default backend (sec)
+  static constexpr const double CUQUANTUM_LATENCY = 2e-2;    //latency of a tensor network execution by cuQuantum (planning, sec)
+  static constexpr const double DEFAULT_SLICE_LATENCY = 1e-3;   //latency of a slice of the default backend (sec)
+  static constexpr const double CUQUANTUM_SLICE_LATENCY = 1e-5; //latency of a slice of cuQuantum (sec)
+  static constexpr const double TRANSFER_BANDWIDTH = 1e10;   //Host-to-GPU transfer bandwidth (bytes/s)
+  static constexpr const double WORKSPACE_FRACTION = 0.3;    //fraction of the GPU memory usable by the intermediates of a slice
+  static constexpr const double LEARNING_RATE = 0.5;         //weight of a new observation of the FMA flop rate
+  static constexpr const double TRIAL_MARGIN = 4.0;          //max estimated/measured time ratio of a trial
+  static constexpr const unsigned int DEFAULT_THRESHOLD = 2; //number of occurrences of a key before a trial
+
+  BackendSelector(): threshold_(DEFAULT_THRESHOLD), rates_{DEFAULT_FMA_RATE,CUQUANTUM_FMA_RATE},
+                     learned_{false,false}, num_selected_{0,0}, num_trials_(0) {}
+
+  BackendSelector(const BackendSelector &) = delete;
+  BackendSelector & operator=(const BackendSelector &) = delete;
+  BackendSelector(BackendSelector &&) noexcept = delete;
+  BackendSelector & operator=(BackendSelector &&) noexcept = delete;
+  ~BackendSelector() = default;
+
+  /** Returns the estimated execution time of a tensor network on a given backend
+      (infinity if the backend cannot execute it). **/
+  double estimate(Backend backend,
+                  const NetworkCost & cost,
+                  const Resources & resources) const
+  {
+    if(backend == CUQUANTUM_BACKEND){
+      if(resources.num_gpus == 0 || cost.io_bytes > resources.device_memory)
+        return std::numeric_limits<double>::infinity(); //input/output tensors do not fit into the GPU memory
+      const double num_slices = numSlices(cost.max_intermediate_bytes,
+                                          (resources.device_memory - cost.io_bytes) * WORKSPACE_FRACTION);
+      const double parallelism = std::min(static_cast<double>(resources.num_gpus),num_slices);
+      return CUQUANTUM_LATENCY + num_slices * CUQUANTUM_SLICE_LATENCY + cost.io_bytes / TRANSFER_BANDWIDTH
+           + cost.fma_flops / (rates_[CUQUANTUM_BACKEND] * parallelism);
+    }
+    const double num_slices = numSlices(cost.max_intermediate_bytes,resources.host_memory);
+    return DEFAULT_LATENCY + num_slices * DEFAULT_SLICE_LATENCY + cost.fma_flops / rates_[DEFAULT_BACKEND];
+  }
+
+  /** Selects the backend for the next execution of a tensor network with a given key.
+      Sets <trial> to TRUE if the other backend is tried for the key (the measured
+      execution time should be recorded). **/
+  Backend select(const std::string & key,
+                 const NetworkCost & cost,
+                 const Resources & resources,
+                 bool * trial)
+  {
+    *trial = false;
+    auto & entry = keys_[key];
+    ++(entry.seen);
+    const double estimated[NUM_BACKENDS] = {estimate(DEFAULT_BACKEND,cost,resources),estimate(CUQUANTUM_BACKEND,cost,resources)};
+    Backend selected = (estimated[CUQUANTUM_BACKEND] < estimated[DEFAULT_BACKEND]) ? CUQUANTUM_BACKEND : DEFAULT_BACKEND;
+    if(estimated[CUQUANTUM_BACKEND] != std::numeric_limits<double>::infinity()){
+      const bool measured[NUM_BACKENDS] = {(entry.times[DEFAULT_BACKEND] >= 0.0),(entry.times[CUQUANTUM_BACKEND] >= 0.0)};
+      if(measured[DEFAULT_BACKEND] && measured[CUQUANTUM_BACKEND]){
+        selected = (entry.times[CUQUANTUM_BACKEND] < entry.times[DEFAULT_BACKEND]) ? CUQUANTUM_BACKEND : DEFAULT_BACKEND;
+      }else if(measured[DEFAULT_BACKEND] || measured[CUQUANTUM_BACKEND]){
+        const Backend known = measured[DEFAULT_BACKEND] ? DEFAULT_BACKEND : CUQUANTUM_BACKEND;
+        const Backend other = measured[DEFAULT_BACKEND] ? CUQUANTUM_BACKEND : DEFAULT_BACKEND;
+        selected = known;
+        if(entry.seen >= threshold_ && !entry.tried && estimated[other] <= entry.times[known] * TRIAL_MARGIN){
+          selected = other;
+          entry.tried = true;
+          *trial = true;
+          ++num_trials_;
+        }
+      }
+    }else{
+      selected = DEFAULT_BACKEND;
+    }
+    ++(num_selected_[selected]);
+    return selected;
+  }
+
+  /** Records the observed execution time of a tensor network with a given key on a given backend. **/
+  void record(const std::string & key,
+              Backend backend,
+              const NetworkCost & cost,
+              const Resources & resources,
+              double time)
+  {
+    auto & entry = keys_[key];
+    entry.times[backend] = (entry.times[backend] < 0.0) ? time : std::min(entry.times[backend],time);
+    //Learn the FMA flop rate from the compute part of the observed time:
+    const double latency = estimate(backend,NetworkCost{0.0,cost.max_intermediate_bytes,cost.io_bytes},resources);
+    const double compute_time = time - latency;
+    if(cost.fma_flops > 0.0 && compute_time > 0.0 && latency != std::numeric_limits<double>::infinity()){
+      double parallelism = 1.0;
+      if(backend == CUQUANTUM_BACKEND){
+        parallelism = std::min(static_cast<double>(std::max(resources.num_gpus,1U)),
+         numSlices(cost.max_intermediate_bytes,(resources.device_memory - cost.io_bytes) * WORKSPACE_FRACTION));
+      }
+      const double rate = cost.fma_flops / (compute_time * parallelism);
+      rates_[backend] = learned_[backend] ? ((1.0 - LEARNING_RATE) * rates_[backend] + LEARNING_RATE * rate) : rate;
+      learned_[backend] = true;
+    }
+    return;
+  }
+
+  /** Seeds the FMA flop rate of a backend (ignored once it has been learned from observations). **/
+  void seedRate(Backend backend, double fma_rate)
+  {
+    if(!learned_[backend] && fma_rate > 0.0) rates_[backend] = fma_rate;
+    return;
+  }
+
+  /** Returns the current FMA flop rate of a backend. **/
+  inline double getRate(Backend backend) const {return rates_[backend];}
+
+  /** Returns the number of tensor networks assigned to a backend. **/
+  inline std::size_t getNumSelected(Backend backend) const {return num_selected_[backend];}
+
+  /** Returns the number of trials. **/
+  inline std::size_t getNumTrials() const {return num_trials_;}
+
+  /** Returns the printable name of a backend. **/
+  static const char * backendName(Backend backend) {return (backend == CUQUANTUM_BACKEND) ? "cuquantum" : "default";}
+
+private:
+
+  struct Entry {
+    unsigned int seen = 0;                    //number of occurrences
+    bool tried = false;                       //whether or not the other backend has been tried
+    double times[NUM_BACKENDS] = {-1.0,-1.0}; //best measured execution time on each backend (<0: not yet)
+  };
+
+  /** Number of slices needed for an intermediate tensor under a memory limit (at least 1). **/
+  static double numSlices(double intermediate_bytes, double memory)
+  {
+    if(memory <= 0.0 || intermediate_bytes <= memory) return 1.0;
+    return std::pow(2.0,std::ceil(std::log2(intermediate_bytes / memory))); //slicing halves the volume per split index
+  }
+
+  unsigned int threshold_;                         //number of occurrences of a key before a trial
+  double rates_[NUM_BACKENDS];                     //FMA flop rate of each backend (FMA/s)
+  bool learned_[NUM_BACKENDS];                     //whether or not the FMA flop rate has been learned
+  std::size_t num_selected_[NUM_BACKENDS];         //number of tensor networks assigned to each backend
+  std::size_t num_trials_;                         //number of trials
+  std::unordered_map<std::string,Entry> keys_;     //tensor network key --> measured execution times
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_BACKEND_SELECTOR_HPP_
@@ -0,0 +1,208 @@
+/** ExaTN:: Tensor Runtime: Tensor node executor: Autotuner of tensor contraction execution strategies
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The same tensor contraction (index pattern, operand shapes, element type) can be executed
+     by a node executor via different execution strategies (for example, specialized kernels,
+     transpose-transpose-GEMM-transpose with or without cached operand layouts, different devices)
+     whose performance may differ severalfold for the same Flop count. The autotuner selects
+     the execution strategy for each tensor contraction key, where the key is composed
+     by the node executor and the strategies are identified by their (persistent) names.
+ (b) A key is tuned once it has been seen a given number of times (frequently seen keys):
+     Each subsequent execution of the tensor contraction tries the next candidate strategy
+     not measured yet (each trial is an actual execution, no extra executions are performed),
+     and once all candidate strategies have been measured, the fastest one is selected.
+     Until then, and while a trial is still in flight, the default strategy is used.
+     Candidate strategies found inapplicable to the key are excluded.
+ (c) The selected strategies are persisted in an on-disk database (text file), one line
+     "<key> <strategy name> <time in sec>" per tuned key, appended once the key is tuned,
+     and loaded upon activation (later lines override earlier ones), thus subsequent runs
+     start with the tuned strategies. Keys must not contain whitespaces.
+ (d) The autotuner is used by the thread executing the tensor operations only (not thread-safe).
+**/
+
+#ifndef EXATN_RUNTIME_CONTRACT_AUTOTUNER_HPP_
+#define EXATN_RUNTIME_CONTRACT_AUTOTUNER_HPP_
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <fstream>
+#include <iostream>
+
+namespace exatn {
+namespace runtime {
+
+class ContractAutotuner {
+
+public:
+
+  static constexpr const int DEFAULT_STRATEGY = -1;           //default execution strategy of the node executor
+  static constexpr const unsigned int DEFAULT_THRESHOLD = 4;  //number of occurrences of a key before it is tuned
+
+  ContractAutotuner(): threshold_(DEFAULT_THRESHOLD) {}
+
+  ContractAutotuner(const ContractAutotuner &) = delete;
+  ContractAutotuner & operator=(const ContractAutotuner &) = delete;
+  ContractAutotuner(ContractAutotuner &&) noexcept = delete;
+  ContractAutotuner & operator=(ContractAutotuner &&) noexcept = delete;
+  ~ContractAutotuner() = default;
+
+  /** Activates the autotuner with a given database file and the names of the execution strategies
+      (strategy id = position in the list), loading the previously tuned keys from the database. **/
+  void activate(const std::string & database,               //in: database file path
+                const std::vector<std::string> & strategies, //in: names of the execution strategies
+                unsigned int threshold = DEFAULT_THRESHOLD)  //in: number of occurrences of a key before it is tuned
+  {
+    database_ = database;
+    strategies_ = strategies;
+    threshold_ = threshold;
+    keys_.clear();
+    if(database_.empty()) return;
+    std::ifstream file(database_,std::ios::in);
+    if(!file.is_open()) return; //no database yet
+    std::string key, name;
+    double time = 0.0;
+    while(file >> key >> name >> time){
+      const auto strategy = getStrategyId(name);
+      if(strategy != DEFAULT_STRATEGY){
+        auto & entry = keys_[key];
+        entry.selected = strategy;
+        entry.time = time;
+      }
+    }
+    return;
+  }
+
+  /** Returns TRUE if the autotuner is active. **/
+  inline bool isActive() const {return !(database_.empty());}
+
+  /** Returns the execution strategy for the next execution of the tensor contraction
+      with a given key among the given candidate strategies (the candidate strategies
+      for the same key must not change), or DEFAULT_STRATEGY. Sets <trial> to TRUE if
+      the returned strategy is to be measured and recorded (record/reject/cancel). **/
+  int select(const std::string & key,               //in: tensor contraction key
+             const std::vector<int> & candidates,   //in: candidate execution strategies
+             bool * trial)                          //out: whether the execution is a trial
+  {
+    *trial = false;
+    auto & entry = keys_[key];
+    if(entry.selected != DEFAULT_STRATEGY){
+      if(std::find(candidates.cbegin(),candidates.cend(),entry.selected) != candidates.cend()) return entry.selected;
+      return DEFAULT_STRATEGY; //tuned strategy is not available in this run
+    }
+    if(++(entry.seen) < threshold_ || entry.in_flight != DEFAULT_STRATEGY) return DEFAULT_STRATEGY;
+    if(entry.timings.empty()){
+      entry.candidates = candidates;
+      entry.timings.assign(candidates.size(),-1.0);
+    }
+    for(std::size_t i = 0; i < entry.candidates.size(); ++i){
+      if(entry.timings[i] < 0.0){
+        entry.in_flight = entry.candidates[i];
+        *trial = true;
+        return entry.in_flight;
+      }
+    }
+    return DEFAULT_STRATEGY;
+  }
+
+  /** Records the measured execution time of a trial. **/
+  void record(const std::string & key, int strategy, double time)
+  {
+    setTiming(key,strategy,std::max(time,0.0));
+    return;
+  }
+
+  /** Excludes a candidate strategy found inapplicable to the key during its trial. **/
+  void reject(const std::string & key, int strategy)
+  {
+    setTiming(key,strategy,std::numeric_limits<double>::infinity());
+    return;
+  }
+
+  /** Cancels a trial which has not been executed (it will be retried). **/
+  void cancel(const std::string & key, int strategy)
+  {
+    auto iter = keys_.find(key);
+    if(iter != keys_.end()){
+      if(iter->second.in_flight == strategy) iter->second.in_flight = DEFAULT_STRATEGY;
+    }
+    return;
+  }
+
+  /** Returns the selected execution strategy for a key (DEFAULT_STRATEGY if not tuned yet). **/
+  int getSelected(const std::string & key) const
+  {
+    auto iter = keys_.find(key);
+    if(iter != keys_.cend()) return iter->second.selected;
+    return DEFAULT_STRATEGY;
+  }
+
+  /** Returns the number of tuned keys. **/
+  std::size_t getNumTuned() const
+  {
+    std::size_t num_tuned = 0;
+    for(const auto & kv: keys_) if(kv.second.selected != DEFAULT_STRATEGY) ++num_tuned;
+    return num_tuned;
+  }
+
+private:
+
+  struct Entry {
+    unsigned int seen = 0;                 //number of occurrences before tuning
+    int in_flight = DEFAULT_STRATEGY;      //strategy of the trial in flight
+    int selected = DEFAULT_STRATEGY;       //selected strategy
+    double time = 0.0;                     //execution time of the selected strategy (sec)
+    std::vector<int> candidates;           //candidate strategies
+    std::vector<double> timings;           //measured execution times of the candidate strategies (<0: not yet)
+  };
+
+  int getStrategyId(const std::string & name) const
+  {
+    for(std::size_t i = 0; i < strategies_.size(); ++i) if(strategies_[i] == name) return static_cast<int>(i);
+    return DEFAULT_STRATEGY;
+  }
+
+  void setTiming(const std::string & key, int strategy, double time)
+  {
+    auto iter = keys_.find(key);
+    if(iter == keys_.end()) return;
+    auto & entry = iter->second;
+    if(entry.in_flight == strategy) entry.in_flight = DEFAULT_STRATEGY;
+    if(entry.selected != DEFAULT_STRATEGY) return;
+    bool complete = true;
+    for(std::size_t i = 0; i < entry.candidates.size(); ++i){
+      if(entry.candidates[i] == strategy) entry.timings[i] = time;
+      if(entry.timings[i] < 0.0) complete = false;
+    }
+    if(complete && !(entry.candidates.empty())){
+      const auto best = std::min_element(entry.timings.cbegin(),entry.timings.cend()) - entry.timings.cbegin();
+      if(entry.timings[best] == std::numeric_limits<double>::infinity()) return; //no applicable strategy: Keep default
+      entry.selected = entry.candidates[best];
+      entry.time = entry.timings[best];
+      std::ofstream file(database_,std::ios::out|std::ios::app);
+      if(file.is_open()){
+        file << key << " " << strategies_[entry.selected] << " " << entry.time << std::endl;
+      }else{
+        std::cout << "#WARNING(exatn::runtime::ContractAutotuner): Unable to append to the autotuning database "
+                  << database_ << std::endl;
+      }
+    }
+    return;
+  }
+
+  std::string database_;                          //database file path (empty: inactive)
+  std::vector<std::string> strategies_;           //names of the execution strategies
+  unsigned int threshold_;                        //number of occurrences of a key before it is tuned
+  std::unordered_map<std::string,Entry> keys_;    //tensor contraction key --> autotuning entry
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_CONTRACT_AUTOTUNER_HPP_
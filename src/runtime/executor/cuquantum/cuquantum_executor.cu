@@ -1,10 +1,53 @@
 /** ExaTN: Tensor Runtime: Tensor network executor: NVIDIA cuQuantum
-REVISION: 2022/01/11
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
+ (a) Multi-GPU execution: The tensor network slices are distributed across all
+     GPUs of all processes (slice_id = proc_id * num_gpus + gpu, with the stride
+     of num_procs * num_gpus). Each GPU has its own copy of the tensors, stream,
+     workspace and contraction plan (the contraction path and slicing are
+     determined once on the first GPU and shared by all GPUs). The partial output
+     tensors are then reduced on the first GPU via peer copies, followed by
+     the transfer of the output tensor to Host.
+ (b) Contraction plan cache: The cuTensorNet network descriptor, optimizer info
+     (contraction path and slicing) and per-GPU contraction plans are cached,
+     keyed by the structure of the tensor network (tensor modes and extents)
+     and its data/compute type, and reused by all subsequent submissions of
+     tensor networks with the same structure (with different tensor data).
+     If a plan cache directory is provided, the optimizer info is also stored
+     in (and loaded from) files in that directory (cuTensorNet 1.0+).
+ (c) GPU memory: The GPU buffer of TAL-SH is leased from the process-wide device memory
+     manager (device_memory.hpp) while tensor networks are executed (from the first
+     submission until sync() completes all of them), thus the whole GPU buffer is available
+     to cuQuantum, except for the ranges retained by TAL-SH (tensor images left on the GPU).
+     The tensors and the workspace of each tensor network are allocated in the GPU buffer
+     by the best-fit free-list memory pool, thus tensor networks may complete (and
+     release their memory) in any order. There are at most pipeline-depth workspace slots
+     of the same size (up to WORKSPACE_FRACTION of the GPU buffer in total), each slot being
+     acquired by a single tensor network before its tensors and held until its completion.
+     The input tensors whose TAL-SH images reside on a GPU are used in place on that GPU
+     (zero copy) and copied from there to the other GPUs, otherwise they are loaded from
+     their Host images.
+ (d) Three-stage pipeline: The input tensors are loaded via a dedicated (copy engine)
+     stream on each GPU, the contraction path is determined on Host by a pool of
+     planner threads (each with its own cuTensorNet handle), and the contraction
+     proceeds on the compute stream of each tensor network once its input tensors
+     have arrived. Thus, loading and planning of subsequent tensor networks overlap
+     with the contraction of the current one(s).
+ (e) Multi-process execution (MPI): If a tensor network is executed by multiple
+     processes, its slices are assigned dynamically in batches via a shared atomic
+     slice counter (MPI RMA window hosted by the first process of the communicator),
+     such that faster GPUs/nodes process more slices. The partial output tensors of
+     all processes are then summed via a non-blocking MPI_Iallreduce which is
+     progressed by sync(). All processes are assumed to obtain the same slicing.
+     The shared counters are organized in (pipeline depth + 1) slots reused by
+     successive tensor networks in their submission order: A tensor network starts
+     fetching slices only after the previous user of its slot has completed its
+     reduction locally, thus after all processes have stopped using the slot.
+     The reductions are started in the submission order on all processes.
 
 **/
 
@@ -16,12 +59,20 @@ Rationale:
 
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <atomic>
+#include <cstdio>
 #include <type_traits>
 
 #include <iostream>
 
 #include "talshxx.hpp"
 #include "timers.hpp"
+#include "device_memory.hpp"
 
 #include "cuquantum_executor.hpp"
 
@@ -49,14 +100,68 @@ struct TensorDescriptor {
  std::size_t volume = 0;       //tensor body volume
  std::size_t size = 0;         //tensor body size (bytes)
  void * src_ptr = nullptr;     //non-owning pointer to the tensor body source image
+ int src_gpu = -1;             //GPU (position in gpu_attr_) of the tensor body source image (-1: Host)
  std::vector<void*> dst_ptr;   //non-owning pointer to the tensor body destination image (on each GPU)
 };
 
+struct ContractionPlan {
+ bool planned = false; //whether or not the optimizer info and contraction plans have been created
+ bool optimizing = false; //whether or not the optimizer info has been requested from a planner thread
+ std::atomic<bool> optimized{false}; //whether or not the optimizer info has been created (by a planner thread)
+ double flops = 0.0; //flop count of the contraction path
+ int64_t num_slices = 0; //number of slices
+ std::vector<int> gpu_ids; //GPU id for each contraction plan
+ cutensornetNetworkDescriptor_t net_descriptor;
+ cutensornetContractionOptimizerConfig_t opt_config;
+ cutensornetContractionOptimizerInfo_t opt_info;
+ bool opt_config_created = false;
+ bool opt_info_created = false;
+ std::vector<cutensornetContractionPlan_t> comp_plans; //contraction plan on each GPU
+
+ ~ContractionPlan() {
+  for(int gpu = 0; gpu < comp_plans.size(); ++gpu){
+   cudaSetDevice(gpu_ids[gpu]);
+   cutensornetDestroyContractionPlan(comp_plans[gpu]);
+  }
+  if(opt_config_created) cutensornetDestroyContractionOptimizerConfig(opt_config);
+  if(opt_info_created) cutensornetDestroyContractionOptimizerInfo(opt_info);
+  cutensornetDestroyNetworkDescriptor(net_descriptor);
+ }
+};
+
+struct TensorNetworkGPUReq {
+ int gpu_id = -1; //GPU id
+ bool slices_exhausted = false; //no more slices to contract on this GPU (dynamic slicing)
+ void ** data_in = nullptr; //non-owning pointers to the input tensor bodies on the GPU
+ void * data_out = nullptr; //non-owning pointer to the (partial) output tensor body on the GPU
+ void * workspace = nullptr; //non-owning
+ uint64_t worksize = 0;
+ int workspace_slot = -1; //occupied workspace slot (-1: none)
+ cudaStream_t stream; //compute stream
+ cudaEvent_t data_in_start;
+ cudaEvent_t data_in_finish;
+ cudaEvent_t compute_start;
+ cudaEvent_t compute_finish;
+};
+
 struct TensorNetworkReq {
  TensorNetworkQueue::ExecStat exec_status = TensorNetworkQueue::ExecStat::None; //tensor network execution status
+ TensorOpExecHandle exec_handle = 0; //tensor network execution handle
  int num_procs = 0; //total number of executing processes
  int proc_id = -1; //id of the current executing process
  int64_t num_slices = 0;
+ bool dynamic_slicing = false; //whether or not the slices are assigned dynamically across the processes
+ int64_t slice_batch = 0; //number of slices fetched at once from the shared slice counter
+ bool contraction_done = false; //whether or not all slices have been issued (followed by the output reduction on the first GPU)
+ bool memory_released = false; //whether or not the GPU memory and workspace have been released
+#ifdef MPI_ENABLED
+ MPI_Comm comm; //MPI communicator of the executing processes
+ unsigned int counter_seq = 0; //sequence number of the tensor network among those using the shared slice counters
+ unsigned int counter_slot = 0; //slot of the shared slice counter
+ int64_t counter_base = 0; //value of the shared slice counter corresponding to the first slice
+ bool reduction_started = false; //whether or not the reduction of the output tensor across the processes has started
+ MPI_Request reduction_request = MPI_REQUEST_NULL; //reduction of the output tensor across the processes
+#endif
  std::shared_ptr<numerics::TensorNetwork> network; //tensor network specification
  std::unordered_map<numerics::TensorHashType, TensorDescriptor> tensor_descriptors; //tensor descriptors (shape, volume, data type, body)
  std::unordered_map<unsigned int, std::vector<int32_t>> tensor_modes; //indices associated with tensor dimensions (key = original tensor id)
@@ -66,47 +171,40 @@ struct TensorNetworkReq {
  int64_t ** strides_in = nullptr;
  int32_t ** modes_in = nullptr; //non-owning
  uint32_t * alignments_in = nullptr;
- void ** data_in = nullptr;
  int32_t num_modes_out;
  int64_t * extents_out = nullptr; //non-owning
  int64_t * strides_out = nullptr;
  int32_t * modes_out = nullptr; //non-owning
  uint32_t alignment_out;
- void * data_out = nullptr; //non-owning
- void * workspace = nullptr; //non-owning
- uint64_t worksize = 0;
- std::vector<void*> memory_window_ptr; //end of the GPU memory segment allocated for the tensors (on each GPU)
- cutensornetNetworkDescriptor_t net_descriptor;
- cutensornetContractionOptimizerConfig_t opt_config;
- cutensornetContractionOptimizerInfo_t opt_info;
- cutensornetContractionPlan_t comp_plan;
+ std::string plan_key; //structural key of the tensor network in the contraction plan cache
+ void * reduction_buffer = nullptr; //non-owning: buffer for partial output tensors on the first GPU
+ std::vector<std::vector<void*>> gpu_memory; //GPU memory blocks acquired for the tensors (on each GPU)
+ std::vector<TensorNetworkGPUReq> gpus; //per-GPU execution state
+ std::shared_ptr<ContractionPlan> plan; //contraction plan (shared via the plan cache)
  cudaDataType_t data_type;
  cutensornetComputeType_t compute_type;
- cudaStream_t stream;
- cudaEvent_t data_in_start;
- cudaEvent_t data_in_finish;
- cudaEvent_t compute_start;
- cudaEvent_t compute_finish;
- cudaEvent_t data_out_finish;
+ cudaEvent_t data_out_finish; //on the first GPU
  double prepare_start;
  double prepare_finish;
 
  ~TensorNetworkReq() {
-  cudaStreamSynchronize(stream);
-  cudaEventDestroy(data_out_finish);
-  cudaEventDestroy(compute_finish);
-  cudaEventDestroy(compute_start);
-  cudaEventDestroy(data_in_finish);
-  cudaEventDestroy(data_in_start);
-  cudaStreamDestroy(stream);
-  cutensornetDestroyContractionPlan(comp_plan);
-  cutensornetDestroyContractionOptimizerConfig(opt_config);
-  cutensornetDestroyContractionOptimizerInfo(opt_info);
-  cutensornetDestroyNetworkDescriptor(net_descriptor);
+  for(auto & gpu: gpus){
+   cudaSetDevice(gpu.gpu_id);
+   cudaStreamSynchronize(gpu.stream);
+   cudaEventDestroy(gpu.compute_finish);
+   cudaEventDestroy(gpu.compute_start);
+   cudaEventDestroy(gpu.data_in_finish);
+   cudaEventDestroy(gpu.data_in_start);
+   cudaStreamDestroy(gpu.stream);
+   if(gpu.data_in != nullptr) delete [] gpu.data_in;
+  }
+  if(!gpus.empty()){
+   cudaSetDevice(gpus[0].gpu_id);
+   cudaEventDestroy(data_out_finish);
+  }
   //if(modes_out != nullptr) delete [] modes_out;
   if(strides_out != nullptr) delete [] strides_out;
   //if(extents_out != nullptr) delete [] extents_out;
-  if(data_in != nullptr) delete [] data_in;
   if(alignments_in != nullptr) delete [] alignments_in;
   //if(modes_in != nullptr) delete [] modes_in;
   if(strides_in != nullptr) delete [] strides_in;
@@ -116,11 +214,21 @@ struct TensorNetworkReq {
 };
 
 
+/** Accumulates a partial output tensor body into the output tensor body (real components). **/
+template <typename RealType>
+__global__ void accumulate_partial_output(RealType * dst, const RealType * src, std::size_t count)
+{
+ for(std::size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += gridDim.x * blockDim.x) dst[i] += src[i];
+}
+
+
 CuQuantumExecutor::CuQuantumExecutor(TensorImplFunc tensor_data_access_func,
                                      unsigned int pipeline_depth,
-                                     unsigned int num_processes, unsigned int process_rank):
+                                     unsigned int num_processes, unsigned int process_rank,
+                                     const std::string & plan_cache_dir):
  tensor_data_access_func_(std::move(tensor_data_access_func)),
- pipe_depth_(pipeline_depth), num_processes_(num_processes), process_rank_(process_rank), flops_(0.0)
+ pipe_depth_(pipeline_depth), num_processes_(num_processes), process_rank_(process_rank),
+ plan_cache_dir_(plan_cache_dir), flops_(0.0)
 {
  static_assert(std::is_same<cutensornetHandle_t,void*>::value,"#FATAL(exatn::runtime::CuQuantumExecutor): cutensornetHandle_t != (void*)");
 
@@ -132,19 +240,18 @@ CuQuantumExecutor::CuQuantumExecutor(TensorImplFunc tensor_data_access_func,
  auto error_code = talshDeviceCount(DEV_NVIDIA_GPU,&num_gpus); assert(error_code == TALSH_SUCCESS);
  for(int i = 0; i < num_gpus; ++i){
   if(talshDeviceState(i,DEV_NVIDIA_GPU) >= DEV_ON){
+   auto & device_memory = getDeviceMemoryManager();
+   device_memory.registerBuffer(i,talsh::getDeviceBufferBasePtr(DEV_NVIDIA_GPU,i),
+                                talsh::getDeviceMaxBufferSize(DEV_NVIDIA_GPU,i)); //already registered by TAL-SH
    gpu_attr_.emplace_back(std::make_pair(i,DeviceAttr{}));
-   gpu_attr_.back().second.pipe_level = 0;
-   gpu_attr_.back().second.workspace_ptr = talsh::getDeviceBufferBasePtr(DEV_NVIDIA_GPU,i);
-   assert(reinterpret_cast<std::size_t>(gpu_attr_.back().second.workspace_ptr) % MEM_ALIGNMENT == 0);
-   gpu_attr_.back().second.buffer_size = talsh::getDeviceMaxBufferSize(DEV_NVIDIA_GPU,i);
-   std::size_t wrk_size = (std::size_t)(static_cast<float>(gpu_attr_.back().second.buffer_size) * WORKSPACE_FRACTION);
+   auto & dev_attr = gpu_attr_.back().second;
+   auto registered = device_memory.getBuffer(i,&(dev_attr.buffer_ptr),&(dev_attr.buffer_size)); assert(registered);
+   assert(reinterpret_cast<std::size_t>(dev_attr.buffer_ptr) % MEM_ALIGNMENT == 0);
+   dev_attr.buffer_size -= dev_attr.buffer_size % MEM_ALIGNMENT;
+   std::size_t wrk_size = (std::size_t)(static_cast<float>(dev_attr.buffer_size) * WORKSPACE_FRACTION) / pipe_depth_;
    wrk_size -= wrk_size % MEM_ALIGNMENT;
-   gpu_attr_.back().second.workspace_size = wrk_size;
-   gpu_attr_.back().second.buffer_size -= wrk_size;
-   gpu_attr_.back().second.buffer_size -= gpu_attr_.back().second.buffer_size % MEM_ALIGNMENT;
-   gpu_attr_.back().second.buffer_ptr = (void*)(((char*)(gpu_attr_.back().second.workspace_ptr)) + wrk_size);
-   mem_pool_.emplace_back(LinearMemoryPool(gpu_attr_.back().second.buffer_ptr,
-                                           gpu_attr_.back().second.buffer_size,MEM_ALIGNMENT));
+   dev_attr.workspace_size = wrk_size;
+   dev_attr.workspace_slots.assign(pipe_depth_,nullptr);
   }
  }
  std::cout << "#DEBUG(exatn::runtime::CuQuantumExecutor): Number of available GPUs = " << gpu_attr_.size() << std::endl;
@@ -152,16 +259,36 @@ CuQuantumExecutor::CuQuantumExecutor(TensorImplFunc tensor_data_access_func,
  for(const auto & gpu: gpu_attr_){
   HANDLE_CUDA_ERROR(cudaSetDevice(gpu.first));
   HANDLE_CTN_ERROR(cutensornetCreate((cutensornetHandle_t*)(&gpu.second.cutn_handle)));
+  HANDLE_CUDA_ERROR(cudaStreamCreateWithFlags((cudaStream_t*)(&gpu.second.copy_stream),cudaStreamNonBlocking));
  }
  std::cout << "#DEBUG(exatn::runtime::CuQuantumExecutor): Created cuTensorNet contexts for all available GPUs" << std::endl;
 
+ //Start the planner threads:
+ if(!gpu_attr_.empty()){
+  for(unsigned int i = 0; i < NUM_PLANNER_THREADS; ++i) planners_.emplace_back(&CuQuantumExecutor::runPlanner,this);
+ }
+
+ //Enable the peer access of the first GPU to all other GPUs (reduction of partial output tensors):
+ if(gpu_attr_.size() > 1){
+  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_attr_[0].first));
+  for(int gpu = 1; gpu < gpu_attr_.size(); ++gpu){
+   int can_access = 0;
+   HANDLE_CUDA_ERROR(cudaDeviceCanAccessPeer(&can_access,gpu_attr_[0].first,gpu_attr_[gpu].first));
+   if(can_access != 0){
+    const auto cuda_error = cudaDeviceEnablePeerAccess(gpu_attr_[gpu].first,0);
+    if(cuda_error != cudaErrorPeerAccessAlreadyEnabled) HANDLE_CUDA_ERROR(cuda_error);
+    cudaGetLastError(); //clear the sticky error of the already enabled peer access
+   }
+  }
+ }
+
  std::cout << "#DEBUG(exatn::runtime::CuQuantumExecutor): GPU configuration:\n";
  for(const auto & gpu: gpu_attr_){
   std::cout << " GPU #" << gpu.first
-            << ": wrk_ptr = " << gpu.second.workspace_ptr
-            << ", size = " << gpu.second.workspace_size
-            << "; buf_ptr = " << gpu.second.buffer_ptr
-            << ", size = " << gpu.second.buffer_size << std::endl;
+            << ": buf_ptr = " << gpu.second.buffer_ptr
+            << ", size = " << gpu.second.buffer_size
+            << "; wrk_slots = " << gpu.second.workspace_slots.size()
+            << ", size = " << gpu.second.workspace_size << std::endl;
  }
 }
 
@@ -169,10 +296,26 @@ CuQuantumExecutor::CuQuantumExecutor(TensorImplFunc tensor_data_access_func,
 CuQuantumExecutor::~CuQuantumExecutor()
 {
  sync();
+ {
+  std::lock_guard<std::mutex> lock(plan_mutex_);
+  stop_planners_ = true;
+ }
+ plan_cv_.notify_all();
+ for(auto & planner: planners_) planner.join();
+ planners_.clear();
+ plan_cache_.clear();
  for(const auto & gpu: gpu_attr_){
   HANDLE_CUDA_ERROR(cudaSetDevice(gpu.first));
+  HANDLE_CUDA_ERROR(cudaStreamDestroy((cudaStream_t)(gpu.second.copy_stream)));
   HANDLE_CTN_ERROR(cutensornetDestroy((cutensornetHandle_t)(gpu.second.cutn_handle)));
  }
+#ifdef MPI_ENABLED
+ for(auto & counters: slice_counters_){ //collective
+  auto errc = MPI_Win_unlock_all(counters.second.win); assert(errc == MPI_SUCCESS);
+  errc = MPI_Win_free(&(counters.second.win)); assert(errc == MPI_SUCCESS);
+ }
+ slice_counters_.clear();
+#endif
  std::cout << "#DEBUG(exatn::runtime::CuQuantumExecutor): Destroyed cuTensorNet contexts for all available GPUs" << std::endl;
  std::cout << "#MSG(exatn::cuQuantum): Statistics across all GPU devices:\n";
  std::cout << " Number of Flops processed: " << flops_ << std::endl;
@@ -183,17 +326,31 @@ CuQuantumExecutor::~CuQuantumExecutor()
 
 TensorNetworkQueue::ExecStat CuQuantumExecutor::execute(std::shared_ptr<numerics::TensorNetwork> network,
                                                         unsigned int num_processes, unsigned int process_rank,
+                                                        const MPICommProxy & communicator,
                                                         const TensorOpExecHandle exec_handle)
 {
  assert(network);
  TensorNetworkQueue::ExecStat exec_stat = TensorNetworkQueue::ExecStat::None;
+ leaseDeviceMemory();
  auto res = active_networks_.emplace(std::make_pair(exec_handle, new TensorNetworkReq{}));
  if(res.second){
   auto tn_req = res.first->second;
   tn_req->network = network;
   tn_req->exec_status = TensorNetworkQueue::ExecStat::Idle;
+  tn_req->exec_handle = exec_handle;
   tn_req->num_procs = num_processes;
   tn_req->proc_id = process_rank;
+#ifdef MPI_ENABLED
+  if(num_processes > 1){ //dynamic slicing across the processes
+   assert(!communicator.isEmpty());
+   tn_req->comm = communicator.getRef<MPI_Comm>();
+   auto & counters = getSliceCounters(tn_req->comm); //collective on the first use of the communicator
+   tn_req->counter_seq = counters.next_seq++;
+   tn_req->counter_slot = tn_req->counter_seq % counters.slot_base.size();
+   tn_req->dynamic_slicing = true;
+   reduction_order_.emplace_back(exec_handle);
+  }
+#endif
   parseTensorNetwork(tn_req); //still Idle
   loadTensors(tn_req); //Idle --> Loading
   if(tn_req->exec_status == TensorNetworkQueue::ExecStat::Loading){
@@ -235,9 +392,11 @@ TensorNetworkQueue::ExecStat CuQuantumExecutor::sync(const TensorOpExecHandle ex
    if(num_slices != nullptr) *num_slices = tn_req->num_slices;
    if(timings != nullptr){
     timings->prepare = (tn_req->prepare_finish - tn_req->prepare_start) * 1000.0;
-    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->data_in),tn_req->data_in_start,tn_req->data_in_finish));
-    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->data_out),tn_req->compute_finish,tn_req->data_out_finish));
-    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->compute),tn_req->compute_start,tn_req->compute_finish));
+    const auto & gpu0 = tn_req->gpus[0]; //timings of the first GPU
+    HANDLE_CUDA_ERROR(cudaSetDevice(gpu0.gpu_id));
+    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->data_in),gpu0.data_in_start,gpu0.data_in_finish));
+    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->data_out),gpu0.compute_finish,tn_req->data_out_finish));
+    HANDLE_CUDA_ERROR(cudaEventElapsedTime(&(timings->compute),gpu0.compute_start,gpu0.compute_finish));
    }
   }
   tn_req.reset();
@@ -256,6 +415,7 @@ void CuQuantumExecutor::sync()
    if(exec_stat == TensorNetworkQueue::ExecStat::Completed) break;
   }
  }
+ releaseDeviceMemory();
  return;
 }
 
@@ -290,15 +450,69 @@ cutensornetComputeType_t getCutensorComputeType(const TensorElementType elem_typ
 }
 
 
-void CuQuantumExecutor::acquireWorkspace(unsigned int dev,
-                                         void ** workspace_ptr,
-                                         uint64_t * workspace_size)
+void CuQuantumExecutor::leaseDeviceMemory()
+{
+ if(leased_) return;
+ auto & device_memory = getDeviceMemoryManager();
+ mem_pool_.clear();
+ for(const auto & gpu: gpu_attr_){
+  auto leased = device_memory.acquireLease(gpu.first,"cuquantum");
+  if(!leased){
+   std::cout << "#ERROR(exatn::runtime::CuQuantumExecutor): Unable to lease the device buffer of GPU "
+             << gpu.first << std::endl;
+   assert(false);
+  }
+  mem_pool_.emplace_back(FreeListMemoryPool(gpu.second.buffer_ptr,gpu.second.buffer_size,MEM_ALIGNMENT));
+  for(const auto & range: device_memory.getRetainedRanges(gpu.first)){ //tensor images retained by TAL-SH
+   auto reserved = mem_pool_.back().reserveMemory(range.first,range.second); assert(reserved);
+  }
+ }
+ leased_ = true;
+ return;
+}
+
+
+void CuQuantumExecutor::releaseDeviceMemory()
+{
+ if(!leased_) return;
+ assert(active_networks_.empty());
+ auto & device_memory = getDeviceMemoryManager();
+ for(const auto & gpu: gpu_attr_) device_memory.releaseLease(gpu.first,"cuquantum");
+ mem_pool_.clear();
+ leased_ = false;
+ return;
+}
+
+
+int CuQuantumExecutor::acquireWorkspace(unsigned int dev,
+                                        void ** workspace_ptr,
+                                        uint64_t * workspace_size)
 {
  assert(dev < gpu_attr_.size());
  auto & dev_attr = gpu_attr_[dev].second;
- *workspace_size = dev_attr.workspace_size / pipe_depth_;
- *workspace_ptr = (void*)((char*)(dev_attr.workspace_ptr) + ((*workspace_size) * dev_attr.pipe_level));
- dev_attr.pipe_level = (++(dev_attr.pipe_level)) % pipe_depth_;
+ for(int slot = 0; slot < dev_attr.workspace_slots.size(); ++slot){
+  if(dev_attr.workspace_slots[slot] == nullptr){
+   void * mem_ptr = mem_pool_[dev].acquireMemory(dev_attr.workspace_size);
+   if(mem_ptr == nullptr) return -1; //not enough memory currently
+   dev_attr.workspace_slots[slot] = mem_ptr;
+   *workspace_size = dev_attr.workspace_size;
+   *workspace_ptr = mem_ptr;
+   return slot;
+  }
+ }
+ return -1;
+}
+
+
+void CuQuantumExecutor::releaseWorkspace(unsigned int dev,
+                                         int slot)
+{
+ assert(dev < gpu_attr_.size());
+ auto & dev_attr = gpu_attr_[dev].second;
+ assert(slot >= 0 && slot < dev_attr.workspace_slots.size());
+ assert(dev_attr.workspace_slots[slot] != nullptr);
+ mem_pool_[dev].releaseMemory(dev_attr.workspace_slots[slot]);
+ dev_attr.workspace_slots[slot] = nullptr;
  return;
 }
 
@@ -312,7 +526,6 @@ void CuQuantumExecutor::parseTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_
  tn_req->strides_in = new int64_t*[num_input_tensors];
  tn_req->modes_in = new int32_t*[num_input_tensors];
  tn_req->alignments_in = new uint32_t[num_input_tensors];
- tn_req->data_in = new void*[num_input_tensors];
 
  for(unsigned int i = 0; i < num_input_tensors; ++i) tn_req->strides_in[i] = NULL;
  for(unsigned int i = 0; i < num_input_tensors; ++i) tn_req->alignments_in[i] = MEM_ALIGNMENT;
@@ -342,7 +555,13 @@ void CuQuantumExecutor::parseTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_
    for(unsigned int i = 0; i < tens_rank; ++i) descr.extents[i] = tens_dims[i];
    descr.data_type = getCudaDataType(tens_type);
    descr.volume = tens_vol;
-   descr.src_ptr = tensor_data_access_func_(*(tens.getTensor()),DEV_HOST,0,&(descr.size)); //`Assuming tensor body is on Host
+   if(tens_id != 0){ //input tensor: Use its image resident on a GPU in place (zero copy), if any
+    for(int gpu = 0; gpu < gpu_attr_.size(); ++gpu){
+     descr.src_ptr = tensor_data_access_func_(*(tens.getTensor()),DEV_NVIDIA_GPU,gpu_attr_[gpu].first,&(descr.size));
+     if(descr.src_ptr != nullptr){descr.src_gpu = gpu; break;}
+    }
+   }
+   if(descr.src_ptr == nullptr) descr.src_ptr = tensor_data_access_func_(*(tens.getTensor()),DEV_HOST,0,&(descr.size));
    assert(descr.src_ptr != nullptr);
   }
 
@@ -376,20 +595,49 @@ void CuQuantumExecutor::parseTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_
  tn_req->data_type = getCudaDataType(tens_elem_type);
  tn_req->compute_type = getCutensorComputeType(tens_elem_type);
 
- //Create a cuTensorNet network descriptor for one or all GPUs:
- for(int gpu = 0; gpu < 1; ++gpu){ //`Only one GPU for now
-  const auto gpu_id = gpu_attr_[gpu].first;
-  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_id));
-  HANDLE_CTN_ERROR(cutensornetCreateNetworkDescriptor(gpu_attr_[gpu].second.cutn_handle,num_input_tensors,
+ //Structural key of the tensor network (data/compute type, modes and extents of all tensors):
+ std::string plan_key = std::to_string(static_cast<int>(tn_req->data_type)) + ":"
+                      + std::to_string(static_cast<int>(tn_req->compute_type));
+ auto append_tensor = [&plan_key](int32_t num_modes, const int32_t * modes, const int64_t * extents){
+  plan_key += "|";
+  for(int32_t i = 0; i < num_modes; ++i) plan_key += std::to_string(modes[i]) + "=" + std::to_string(extents[i]) + ",";
+ };
+ append_tensor(tn_req->num_modes_out,tn_req->modes_out,tn_req->extents_out);
+ for(int32_t i = 0; i < num_input_tensors; ++i) append_tensor(tn_req->num_modes_in[i],tn_req->modes_in[i],tn_req->extents_in[i]);
+
+ //Look up the contraction plan cache, otherwise create a cuTensorNet network descriptor (shared by all GPUs):
+ assert(!gpu_attr_.empty());
+ HANDLE_CUDA_ERROR(cudaSetDevice(gpu_attr_[0].first));
+ auto cached = plan_cache_.find(plan_key);
+ if(cached != plan_cache_.end()){
+  tn_req->plan = cached->second;
+ }else{
+  if(plan_cache_.size() >= PLAN_CACHE_CAPACITY){ //drop a contraction plan not in use
+   for(auto iter = plan_cache_.begin(); iter != plan_cache_.end(); ++iter){
+    if(iter->second.use_count() == 1){plan_cache_.erase(iter); break;}
+   }
+  }
+  tn_req->plan = std::make_shared<ContractionPlan>();
+  HANDLE_CTN_ERROR(cutensornetCreateNetworkDescriptor(gpu_attr_[0].second.cutn_handle,num_input_tensors,
                    tn_req->num_modes_in,tn_req->extents_in,tn_req->strides_in,tn_req->modes_in,tn_req->alignments_in,
                    tn_req->num_modes_out,tn_req->extents_out,tn_req->strides_out,tn_req->modes_out,tn_req->alignment_out,
-                   tn_req->data_type,tn_req->compute_type,&(tn_req->net_descriptor)));
-  HANDLE_CUDA_ERROR(cudaStreamCreate(&(tn_req->stream)));
-  HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->data_in_start)));
-  HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->data_in_finish)));
-  HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->compute_start)));
-  HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->compute_finish)));
-  HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->data_out_finish)));
+                   tn_req->data_type,tn_req->compute_type,&(tn_req->plan->net_descriptor)));
+  plan_cache_.emplace(std::make_pair(plan_key,tn_req->plan));
+ }
+ tn_req->plan_key = std::move(plan_key);
+ HANDLE_CUDA_ERROR(cudaEventCreate(&(tn_req->data_out_finish)));
+ //Create the execution state on all GPUs:
+ tn_req->gpus.resize(gpu_attr_.size());
+ for(int gpu = 0; gpu < gpu_attr_.size(); ++gpu){
+  auto & gpu_req = tn_req->gpus[gpu];
+  gpu_req.gpu_id = gpu_attr_[gpu].first;
+  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+  gpu_req.data_in = new void*[num_input_tensors];
+  HANDLE_CUDA_ERROR(cudaStreamCreate(&(gpu_req.stream)));
+  HANDLE_CUDA_ERROR(cudaEventCreate(&(gpu_req.data_in_start)));
+  HANDLE_CUDA_ERROR(cudaEventCreate(&(gpu_req.data_in_finish)));
+  HANDLE_CUDA_ERROR(cudaEventCreate(&(gpu_req.compute_start)));
+  HANDLE_CUDA_ERROR(cudaEventCreate(&(gpu_req.compute_finish)));
  }
  return;
 }
@@ -397,50 +645,82 @@ void CuQuantumExecutor::parseTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_
 
 void CuQuantumExecutor::loadTensors(std::shared_ptr<TensorNetworkReq> tn_req)
 {
- //Load tensors to one or all GPUs:
- for(int gpu = 0; gpu < 1; ++gpu){ //`Only one GPU for now
-  const auto gpu_id = gpu_attr_[gpu].first;
-  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_id));
-  void * prev_front = mem_pool_[gpu].getFront();
-  bool success = true;
-  //Acquire device memory:
+ const auto output_hash = tn_req->network->getTensor(0)->getTensorHash();
+ const auto output_size = tn_req->tensor_descriptors[output_hash].size;
+ const int num_gpus = tn_req->gpus.size();
+ //Acquire a workspace slot and device memory on all GPUs (all or nothing):
+ tn_req->gpu_memory.assign(num_gpus,std::vector<void*>{});
+ bool success = true;
+ int gpu = 0;
+ for(gpu = 0; gpu < num_gpus; ++gpu){
+  auto & gpu_req = tn_req->gpus[gpu];
+  gpu_req.workspace_slot = acquireWorkspace(gpu,&(gpu_req.workspace),&(gpu_req.worksize));
+  success = (gpu_req.workspace_slot >= 0); if(!success) break;
   for(auto & descr: tn_req->tensor_descriptors){
-   void * dev_ptr = mem_pool_[gpu].acquireMemory(descr.second.size);
-   success = (dev_ptr != nullptr); if(!success) break;
-   descr.second.dst_ptr.emplace_back(dev_ptr);
-  }
-  if(success){
-   //Initiate data transfers:
-   HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->data_in_start,tn_req->stream));
-   for(auto & descr: tn_req->tensor_descriptors){
-    /*std::cout << "#DEBUG(exatn::CuQuantumExecutor): loadTensors: "
-              << descr.second.dst_ptr.back() << " " << descr.second.src_ptr << " "
-              << descr.second.size << std::endl << std::flush; //debug*/
-    HANDLE_CUDA_ERROR(cudaMemcpyAsync(descr.second.dst_ptr.back(),descr.second.src_ptr,
-                                      descr.second.size,cudaMemcpyDefault,tn_req->stream));
+   if(descr.second.src_gpu == gpu){ //tensor image resident on this GPU is used in place
+    descr.second.dst_ptr.emplace_back(descr.second.src_ptr);
+   }else{
+    void * dev_ptr = mem_pool_[gpu].acquireMemory(descr.second.size);
+    success = (dev_ptr != nullptr); if(!success) break;
+    descr.second.dst_ptr.emplace_back(dev_ptr);
+    tn_req->gpu_memory[gpu].emplace_back(dev_ptr);
    }
-   HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->data_in_finish,tn_req->stream));
-   tn_req->memory_window_ptr.emplace_back(mem_pool_[gpu].getFront());
-   auto & net = *(tn_req->network);
-   int32_t tens_num = 0;
-   for(auto iter = net.cbegin(); iter != net.cend(); ++iter){
-    const auto tens_id = iter->first;
-    const auto & tens = iter->second;
-    const auto tens_hash = tens.getTensor()->getTensorHash();
-    auto descr = tn_req->tensor_descriptors.find(tens_hash);
-    void * dev_ptr = descr->second.dst_ptr.back();
-    if(tens_id == 0){
-     tn_req->data_out = dev_ptr;
-    }else{
-     tn_req->data_in[tens_num++] = dev_ptr;
-    }
+  }
+  if(success && gpu == 0 && num_gpus > 1){
+   tn_req->reduction_buffer = mem_pool_[gpu].acquireMemory(output_size);
+   success = (tn_req->reduction_buffer != nullptr);
+   if(success) tn_req->gpu_memory[gpu].emplace_back(tn_req->reduction_buffer);
+  }
+  if(!success) break;
+ }
+ if(!success){ //no enough memory currently
+  //Release the acquired memory:
+  for(int i = 0; i < num_gpus; ++i){
+   for(auto * dev_ptr: tn_req->gpu_memory[i]) mem_pool_[i].releaseMemory(dev_ptr);
+   if(tn_req->gpus[i].workspace_slot >= 0){
+    releaseWorkspace(i,tn_req->gpus[i].workspace_slot);
+    tn_req->gpus[i].workspace_slot = -1;
+   }
+  }
+  tn_req->gpu_memory.clear();
+  for(auto & descr: tn_req->tensor_descriptors) descr.second.dst_ptr.clear();
+  tn_req->reduction_buffer = nullptr;
+  return;
+ }
+ //Initiate data transfers to all GPUs:
+ for(gpu = 0; gpu < num_gpus; ++gpu){
+  auto & gpu_req = tn_req->gpus[gpu];
+  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+  auto copy_stream = (cudaStream_t)(gpu_attr_[gpu].second.copy_stream);
+  HANDLE_CUDA_ERROR(cudaEventRecord(gpu_req.data_in_start,copy_stream));
+  for(auto & descr: tn_req->tensor_descriptors){
+   /*std::cout << "#DEBUG(exatn::CuQuantumExecutor): loadTensors: "
+             << descr.second.dst_ptr[gpu] << " " << descr.second.src_ptr << " "
+             << descr.second.size << std::endl << std::flush; //debug*/
+   if(descr.first == output_hash && (gpu > 0 || tn_req->proc_id > 0)){ //partial output tensors start from zero
+    HANDLE_CUDA_ERROR(cudaMemsetAsync(descr.second.dst_ptr[gpu],0,descr.second.size,copy_stream));
+   }else if(descr.second.dst_ptr[gpu] != descr.second.src_ptr){ //Host or peer GPU source image
+    HANDLE_CUDA_ERROR(cudaMemcpyAsync(descr.second.dst_ptr[gpu],descr.second.src_ptr,
+                                      descr.second.size,cudaMemcpyDefault,copy_stream));
+   }
+  }
+  HANDLE_CUDA_ERROR(cudaEventRecord(gpu_req.data_in_finish,copy_stream));
+  auto & net = *(tn_req->network);
+  int32_t tens_num = 0;
+  for(auto iter = net.cbegin(); iter != net.cend(); ++iter){
+   const auto tens_id = iter->first;
+   const auto & tens = iter->second;
+   const auto tens_hash = tens.getTensor()->getTensorHash();
+   auto descr = tn_req->tensor_descriptors.find(tens_hash);
+   void * dev_ptr = descr->second.dst_ptr[gpu];
+   if(tens_id == 0){
+    gpu_req.data_out = dev_ptr;
+   }else{
+    gpu_req.data_in[tens_num++] = dev_ptr;
    }
-  }else{ //no enough memory currently
-   //Restore previous memory front:
-   mem_pool_[gpu].restorePreviousFront(prev_front);
-   return;
   }
  }
+ tn_req->prepare_start = Timer::timeInSecHR();
  tn_req->exec_status = TensorNetworkQueue::ExecStat::Loading;
  return;
 }
@@ -448,85 +728,368 @@ void CuQuantumExecutor::loadTensors(std::shared_ptr<TensorNetworkReq> tn_req)
 
 void CuQuantumExecutor::planExecution(std::shared_ptr<TensorNetworkReq> tn_req)
 {
- //Configure tensor network contraction on one or all GPUs:
- tn_req->prepare_start = Timer::timeInSecHR();
- for(int gpu = 0; gpu < 1; ++gpu){ //`Only one GPU for now
-  const auto gpu_id = gpu_attr_[gpu].first;
-  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_id));
-  HANDLE_CTN_ERROR(cutensornetCreateContractionOptimizerConfig(gpu_attr_[gpu].second.cutn_handle,&(tn_req->opt_config)));
-  HANDLE_CTN_ERROR(cutensornetCreateContractionOptimizerInfo(gpu_attr_[gpu].second.cutn_handle,tn_req->net_descriptor,&(tn_req->opt_info)));
-  acquireWorkspace(gpu,&(tn_req->workspace),&(tn_req->worksize));
-  HANDLE_CTN_ERROR(cutensornetContractionOptimize(gpu_attr_[gpu].second.cutn_handle,
-                                                  tn_req->net_descriptor,tn_req->opt_config,
-                                                  tn_req->worksize,tn_req->opt_info));
-  HANDLE_CTN_ERROR(cutensornetCreateContractionPlan(gpu_attr_[gpu].second.cutn_handle,
-                                                    tn_req->net_descriptor,tn_req->opt_info,
-                                                    tn_req->worksize,&(tn_req->comp_plan)));
-  double flops = 0.0;
-  HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoGetAttribute(gpu_attr_[gpu].second.cutn_handle,
-                                                                   tn_req->opt_info,
-                                                                   CUTENSORNET_CONTRACTION_OPTIMIZER_INFO_FLOP_COUNT,
-                                                                   &flops,sizeof(flops)));
-  flops_ += flops;
+ //The workspace slots on all GPUs have been acquired together with the tensors (loadTensors):
+ const int num_gpus = tn_req->gpus.size();
+ assert(tn_req->gpus[0].workspace_slot >= 0);
+ //Determine the contraction path and slicing by a planner thread (unless cached):
+ auto plan = tn_req->plan;
+ if(!plan->planned){
+  if(!plan->optimized.load(std::memory_order_acquire)){
+   if(!plan->optimizing){
+    uint64_t worksize = tn_req->gpus[0].worksize; //workspace limit common to all GPUs
+    for(const auto & gpu_req: tn_req->gpus) worksize = std::min(worksize,gpu_req.worksize);
+    const auto plan_key = tn_req->plan_key;
+    plan->optimizing = true;
+    {
+     std::lock_guard<std::mutex> lock(plan_mutex_);
+     plan_jobs_.emplace_back([this,plan,plan_key,worksize](void * cutn_handle){
+      optimizeContraction(cutn_handle,plan_key,worksize,*plan);
+     });
+    }
+    plan_cv_.notify_one();
+   }
+   return; //still Loading (while the contraction path is being determined)
+  }
+  //Create the contraction plan on each GPU:
+  for(int gpu = 0; gpu < num_gpus; ++gpu){
+   auto & gpu_req = tn_req->gpus[gpu];
+   HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+   cutensornetContractionPlan_t comp_plan;
+   HANDLE_CTN_ERROR(cutensornetCreateContractionPlan(gpu_attr_[gpu].second.cutn_handle,
+                                                     plan->net_descriptor,plan->opt_info,
+                                                     gpu_req.worksize,&comp_plan));
+   plan->comp_plans.emplace_back(comp_plan);
+   plan->gpu_ids.emplace_back(gpu_req.gpu_id);
+  }
+  plan->planned = true;
  }
+ flops_ += plan->flops;
  tn_req->prepare_finish = Timer::timeInSecHR();
  tn_req->exec_status = TensorNetworkQueue::ExecStat::Planning;
  return;
 }
 
 
+void CuQuantumExecutor::optimizeContraction(void * cutn_handle,
+                                            const std::string & plan_key,
+                                            uint64_t worksize,
+                                            ContractionPlan & plan)
+{
+ HANDLE_CTN_ERROR(cutensornetCreateContractionOptimizerConfig(cutn_handle,&(plan.opt_config)));
+ plan.opt_config_created = true;
+ if(!loadOptimizerInfo(cutn_handle,plan_key,plan)){
+  HANDLE_CTN_ERROR(cutensornetCreateContractionOptimizerInfo(cutn_handle,plan.net_descriptor,&(plan.opt_info)));
+  plan.opt_info_created = true;
+  HANDLE_CTN_ERROR(cutensornetContractionOptimize(cutn_handle,
+                                                  plan.net_descriptor,plan.opt_config,
+                                                  worksize,plan.opt_info));
+  storeOptimizerInfo(cutn_handle,plan_key,plan);
+ }
+ HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoGetAttribute(cutn_handle,
+                                                                  plan.opt_info,
+                                                                  CUTENSORNET_CONTRACTION_OPTIMIZER_INFO_FLOP_COUNT,
+                                                                  &(plan.flops),sizeof(plan.flops)));
+ HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoGetAttribute(cutn_handle,
+                                                                  plan.opt_info,
+                                                                  CUTENSORNET_CONTRACTION_OPTIMIZER_INFO_NUM_SLICES,
+                                                                  &(plan.num_slices),sizeof(plan.num_slices)));
+ plan.optimized.store(true,std::memory_order_release);
+ return;
+}
+
+
+void CuQuantumExecutor::runPlanner()
+{
+ HANDLE_CUDA_ERROR(cudaSetDevice(gpu_attr_[0].first));
+ cutensornetHandle_t cutn_handle;
+ HANDLE_CTN_ERROR(cutensornetCreate(&cutn_handle));
+ while(true){
+  std::function<void(void*)> job;
+  {
+   std::unique_lock<std::mutex> lock(plan_mutex_);
+   plan_cv_.wait(lock,[this](){return stop_planners_ || !plan_jobs_.empty();});
+   if(plan_jobs_.empty()) break; //stopped
+   job = std::move(plan_jobs_.front());
+   plan_jobs_.pop_front();
+  }
+  job(cutn_handle);
+ }
+ HANDLE_CTN_ERROR(cutensornetDestroy(cutn_handle));
+ return;
+}
+
+
 void CuQuantumExecutor::contractTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_req)
 {
- //Execute the contraction plan on one or all GPUs:
- for(int gpu = 0; gpu < 1; ++gpu){ //`Only one GPU for now
-  const auto gpu_id = gpu_attr_[gpu].first;
-  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_id));
-  tn_req->num_slices = 0;
-  HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoGetAttribute(gpu_attr_[gpu].second.cutn_handle,
-                                                                   tn_req->opt_info,
-                                                                   CUTENSORNET_CONTRACTION_OPTIMIZER_INFO_NUM_SLICES,
-                                                                   &(tn_req->num_slices),sizeof(tn_req->num_slices)));
-  assert(tn_req->num_slices > 0);
-  HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->compute_start,tn_req->stream));
-  for(int64_t slice_id = tn_req->proc_id; slice_id < tn_req->num_slices; slice_id += tn_req->num_procs){
+ const int num_gpus = tn_req->gpus.size();
+#ifdef MPI_ENABLED
+ if(tn_req->dynamic_slicing){
+  const auto & counters = getSliceCounters(tn_req->comm);
+  if(counters.slot_turn[tn_req->counter_slot] != tn_req->counter_seq) return; //slice counter slot still in use: still Planning
+ }
+#endif
+ tn_req->num_slices = tn_req->plan->num_slices;
+ assert(tn_req->num_slices > 0);
+ for(int gpu = 0; gpu < num_gpus; ++gpu){
+  auto & gpu_req = tn_req->gpus[gpu];
+  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+  HANDLE_CUDA_ERROR(cudaStreamWaitEvent(gpu_req.stream,gpu_req.data_in_finish,0)); //input tensors loaded via the copy stream
+  HANDLE_CUDA_ERROR(cudaEventRecord(gpu_req.compute_start,gpu_req.stream));
+ }
+#ifdef MPI_ENABLED
+ if(tn_req->dynamic_slicing){
+  //Fetch the first batch of slices for each GPU from the shared slice counter:
+  const auto & counters = getSliceCounters(tn_req->comm);
+  tn_req->counter_base = counters.slot_base[tn_req->counter_slot];
+  tn_req->slice_batch = std::max(static_cast<int64_t>(1),
+   tn_req->num_slices / (static_cast<int64_t>(counters.total_gpus) * SLICE_BATCHES_PER_GPU));
+  for(int gpu = 0; gpu < num_gpus; ++gpu) contractSliceBatch(tn_req,gpu);
+  tn_req->exec_status = TensorNetworkQueue::ExecStat::Executing;
+  return;
+ }
+#endif
+ //Execute the contraction plan on all GPUs (each GPU processes its own subset of slices):
+ const int64_t slice_stride = static_cast<int64_t>(tn_req->num_procs) * num_gpus;
+ for(int gpu = 0; gpu < num_gpus; ++gpu){
+  auto & gpu_req = tn_req->gpus[gpu];
+  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+  for(int64_t slice_id = static_cast<int64_t>(tn_req->proc_id) * num_gpus + gpu;
+      slice_id < tn_req->num_slices; slice_id += slice_stride){
    HANDLE_CTN_ERROR(cutensornetContraction(gpu_attr_[gpu].second.cutn_handle,
-                                           tn_req->comp_plan,
-                                           tn_req->data_in,tn_req->data_out,
-                                           tn_req->workspace,tn_req->worksize,
-                                           slice_id,tn_req->stream));
-  }
-  HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->compute_finish,tn_req->stream));
-  const auto output_hash = tn_req->network->getTensor(0)->getTensorHash();
-  auto iter = tn_req->tensor_descriptors.find(output_hash);
-  assert(iter != tn_req->tensor_descriptors.cend());
-  const auto & descr = iter->second;
-  HANDLE_CUDA_ERROR(cudaMemcpyAsync(descr.src_ptr,descr.dst_ptr[gpu],
-                                    descr.size,cudaMemcpyDefault,tn_req->stream));
-  HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->data_out_finish,tn_req->stream));
+                                           tn_req->plan->comp_plans[gpu],
+                                           gpu_req.data_in,gpu_req.data_out,
+                                           gpu_req.workspace,gpu_req.worksize,
+                                           slice_id,gpu_req.stream));
+  }
+  HANDLE_CUDA_ERROR(cudaEventRecord(gpu_req.compute_finish,gpu_req.stream));
+  gpu_req.slices_exhausted = true;
  }
+ reducePartialOutputs(tn_req);
  tn_req->exec_status = TensorNetworkQueue::ExecStat::Executing;
  return;
 }
 
 
+#ifdef MPI_ENABLED
+CuQuantumExecutor::SliceCounters & CuQuantumExecutor::getSliceCounters(MPI_Comm comm)
+{
+ auto iter = slice_counters_.find(comm);
+ if(iter == slice_counters_.end()){
+  int rank = 0;
+  auto errc = MPI_Comm_rank(comm,&rank); assert(errc == MPI_SUCCESS);
+  SliceCounters counters;
+  counters.slot_base.assign(pipe_depth_ + 1,0);
+  counters.slot_turn.resize(counters.slot_base.size());
+  for(unsigned int i = 0; i < counters.slot_turn.size(); ++i) counters.slot_turn[i] = i;
+  unsigned int num_gpus = gpu_attr_.size();
+  errc = MPI_Allreduce(&num_gpus,&(counters.total_gpus),1,MPI_UNSIGNED,MPI_SUM,comm); assert(errc == MPI_SUCCESS);
+  const MPI_Aint win_size = (rank == 0) ? counters.slot_base.size() * sizeof(int64_t) : 0;
+  errc = MPI_Win_allocate(win_size,sizeof(int64_t),MPI_INFO_NULL,comm,&(counters.counters),&(counters.win));
+  assert(errc == MPI_SUCCESS);
+  if(rank == 0){
+   for(std::size_t i = 0; i < counters.slot_base.size(); ++i) counters.counters[i] = 0;
+  }
+  errc = MPI_Barrier(comm); assert(errc == MPI_SUCCESS);
+  errc = MPI_Win_lock_all(MPI_MODE_NOCHECK,counters.win); assert(errc == MPI_SUCCESS);
+  iter = slice_counters_.emplace(std::make_pair(comm,counters)).first;
+ }
+ return iter->second;
+}
+
+
+void CuQuantumExecutor::contractSliceBatch(std::shared_ptr<TensorNetworkReq> tn_req, int gpu)
+{
+ auto & gpu_req = tn_req->gpus[gpu];
+ auto & counters = getSliceCounters(tn_req->comm);
+ int64_t first_slice = 0;
+ auto errc = MPI_Fetch_and_op(&(tn_req->slice_batch),&first_slice,MPI_INT64_T,0,
+                              tn_req->counter_slot,MPI_SUM,counters.win); assert(errc == MPI_SUCCESS);
+ errc = MPI_Win_flush(0,counters.win); assert(errc == MPI_SUCCESS);
+ first_slice -= tn_req->counter_base;
+ HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+ if(first_slice < tn_req->num_slices){
+  const int64_t last_slice = std::min(first_slice + tn_req->slice_batch, tn_req->num_slices);
+  for(int64_t slice_id = first_slice; slice_id < last_slice; ++slice_id){
+   HANDLE_CTN_ERROR(cutensornetContraction(gpu_attr_[gpu].second.cutn_handle,
+                                           tn_req->plan->comp_plans[gpu],
+                                           gpu_req.data_in,gpu_req.data_out,
+                                           gpu_req.workspace,gpu_req.worksize,
+                                           slice_id,gpu_req.stream));
+  }
+ }else{
+  gpu_req.slices_exhausted = true;
+ }
+ HANDLE_CUDA_ERROR(cudaEventRecord(gpu_req.compute_finish,gpu_req.stream));
+ return;
+}
+#endif
+
+
+void CuQuantumExecutor::reducePartialOutputs(std::shared_ptr<TensorNetworkReq> tn_req)
+{
+ //Reduce the partial output tensors on the first GPU:
+ const int num_gpus = tn_req->gpus.size();
+ const auto output_hash = tn_req->network->getTensor(0)->getTensorHash();
+ auto iter = tn_req->tensor_descriptors.find(output_hash);
+ assert(iter != tn_req->tensor_descriptors.cend());
+ const auto & descr = iter->second;
+ auto & gpu0 = tn_req->gpus[0];
+ HANDLE_CUDA_ERROR(cudaSetDevice(gpu0.gpu_id));
+ for(int gpu = 1; gpu < num_gpus; ++gpu){
+  const auto & gpu_req = tn_req->gpus[gpu];
+  HANDLE_CUDA_ERROR(cudaStreamWaitEvent(gpu0.stream,gpu_req.compute_finish,0));
+  HANDLE_CUDA_ERROR(cudaMemcpyPeerAsync(tn_req->reduction_buffer,gpu0.gpu_id,
+                                        gpu_req.data_out,gpu_req.gpu_id,
+                                        descr.size,gpu0.stream));
+  const bool complex_type = (tn_req->data_type == CUDA_C_32F || tn_req->data_type == CUDA_C_64F);
+  const std::size_t count = descr.volume * (complex_type ? 2 : 1);
+  const unsigned int num_blocks = std::min((count + REDUCTION_BLOCK_SIZE - 1) / REDUCTION_BLOCK_SIZE,
+                                           static_cast<std::size_t>(REDUCTION_MAX_BLOCKS));
+  if(tn_req->data_type == CUDA_R_32F || tn_req->data_type == CUDA_C_32F){
+   accumulate_partial_output<<<num_blocks,REDUCTION_BLOCK_SIZE,0,gpu0.stream>>>(
+    static_cast<float*>(gpu0.data_out),static_cast<const float*>(tn_req->reduction_buffer),count);
+  }else{
+   accumulate_partial_output<<<num_blocks,REDUCTION_BLOCK_SIZE,0,gpu0.stream>>>(
+    static_cast<double*>(gpu0.data_out),static_cast<const double*>(tn_req->reduction_buffer),count);
+  }
+  HANDLE_CUDA_ERROR(cudaGetLastError());
+ }
+ HANDLE_CUDA_ERROR(cudaMemcpyAsync(descr.src_ptr,gpu0.data_out,
+                                   descr.size,cudaMemcpyDefault,gpu0.stream));
+ HANDLE_CUDA_ERROR(cudaEventRecord(tn_req->data_out_finish,gpu0.stream));
+ tn_req->contraction_done = true;
+ return;
+}
+
+
+std::string CuQuantumExecutor::planFileName(const std::string & plan_key) const
+{
+ std::ostringstream file_name;
+ file_name << plan_cache_dir_ << "/exatn_cutn_plan_" << std::hex << std::hash<std::string>{}(plan_key) << ".bin";
+ return file_name.str();
+}
+
+
+bool CuQuantumExecutor::loadOptimizerInfo(void * cutn_handle, const std::string & plan_key, ContractionPlan & plan)
+{
+ if(plan_cache_dir_.empty()) return false;
+#if defined(CUTENSORNET_VERSION) && (CUTENSORNET_VERSION >= 10000)
+ std::ifstream plan_file(planFileName(plan_key),std::ios::in | std::ios::binary);
+ if(!plan_file.is_open()) return false;
+ uint64_t key_length = 0, packed_size = 0;
+ plan_file.read(reinterpret_cast<char*>(&key_length),sizeof(key_length));
+ if(!plan_file || key_length != plan_key.length()) return false;
+ std::string key(key_length,' ');
+ plan_file.read(&(key[0]),key_length);
+ if(!plan_file || key != plan_key) return false; //hash collision
+ plan_file.read(reinterpret_cast<char*>(&packed_size),sizeof(packed_size));
+ if(!plan_file || packed_size == 0) return false;
+ std::vector<char> packed(packed_size);
+ plan_file.read(packed.data(),packed_size);
+ if(!plan_file) return false;
+ HANDLE_CTN_ERROR(cutensornetCreateContractionOptimizerInfoFromPackedData(cutn_handle,
+                  plan.net_descriptor,packed.data(),packed_size,&(plan.opt_info)));
+ plan.opt_info_created = true;
+ return true;
+#else
+ return false;
+#endif
+}
+
+
+void CuQuantumExecutor::storeOptimizerInfo(void * cutn_handle, const std::string & plan_key, const ContractionPlan & plan)
+{
+ if(plan_cache_dir_.empty()) return;
+#if defined(CUTENSORNET_VERSION) && (CUTENSORNET_VERSION >= 10000)
+ std::size_t packed_size = 0;
+ HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoGetPackedSize(cutn_handle,
+                  plan.opt_info,&packed_size));
+ std::vector<char> packed(packed_size);
+ HANDLE_CTN_ERROR(cutensornetContractionOptimizerInfoPackData(cutn_handle,
+                  plan.opt_info,packed.data(),packed_size));
+ const auto file_name = planFileName(plan_key);
+ const auto temp_name = file_name + "." + std::to_string(process_rank_); //atomic replacement via rename
+ std::ofstream plan_file(temp_name,std::ios::out | std::ios::binary | std::ios::trunc);
+ if(!plan_file.is_open()) return;
+ const uint64_t key_length = plan_key.length();
+ const uint64_t data_size = packed_size;
+ plan_file.write(reinterpret_cast<const char*>(&key_length),sizeof(key_length));
+ plan_file.write(plan_key.data(),key_length);
+ plan_file.write(reinterpret_cast<const char*>(&data_size),sizeof(data_size));
+ plan_file.write(packed.data(),packed_size);
+ plan_file.close();
+ if(plan_file) std::rename(temp_name.c_str(),file_name.c_str());
+ else std::remove(temp_name.c_str());
+#endif
+ return;
+}
+
+
 void CuQuantumExecutor::testCompletion(std::shared_ptr<TensorNetworkReq> tn_req)
 {
- //Test work completion on one or all GPUs:
- bool all_completed = true;
- for(int gpu = 0; gpu < 1; ++gpu){ //`Only one GPU for now
-  const auto gpu_id = gpu_attr_[gpu].first;
-  HANDLE_CUDA_ERROR(cudaSetDevice(gpu_id));
+#ifdef MPI_ENABLED
+ //Dynamic slicing: Fetch more slices for the GPUs which completed their batch:
+ if(!tn_req->contraction_done){
+  bool all_exhausted = true;
+  for(int gpu = 0; gpu < tn_req->gpus.size(); ++gpu){
+   auto & gpu_req = tn_req->gpus[gpu];
+   if(!gpu_req.slices_exhausted){
+    HANDLE_CUDA_ERROR(cudaSetDevice(gpu_req.gpu_id));
+    if(cudaEventQuery(gpu_req.compute_finish) == cudaSuccess) contractSliceBatch(tn_req,gpu);
+    all_exhausted = all_exhausted && gpu_req.slices_exhausted;
+   }
+  }
+  if(!all_exhausted) return;
+  //Advance the base of the shared slice counter slot past its final value
+  //(each GPU of each process performs exactly one fetch past the last slice):
+  auto & counters = getSliceCounters(tn_req->comm);
+  const int64_t num_batches = (tn_req->num_slices + tn_req->slice_batch - 1) / tn_req->slice_batch;
+  counters.slot_base[tn_req->counter_slot] += (num_batches + counters.total_gpus) * tn_req->slice_batch;
+  reducePartialOutputs(tn_req);
+ }
+#endif
+ //Test work completion (the output tensor is reduced on the first GPU after all GPUs complete):
+ if(!tn_req->memory_released){
+  HANDLE_CUDA_ERROR(cudaSetDevice(tn_req->gpus[0].gpu_id));
   cudaError_t cuda_error = cudaEventQuery(tn_req->data_out_finish);
-  if(cuda_error == cudaSuccess){
-   if(tn_req->memory_window_ptr[gpu] != nullptr){
-    mem_pool_[gpu].releaseMemory(tn_req->memory_window_ptr[gpu]);
-    tn_req->memory_window_ptr[gpu] = nullptr;
+  if(cuda_error != cudaSuccess) return;
+  for(int gpu = 0; gpu < tn_req->gpus.size(); ++gpu){
+   if(gpu < tn_req->gpu_memory.size()){
+    for(auto * dev_ptr: tn_req->gpu_memory[gpu]) mem_pool_[gpu].releaseMemory(dev_ptr);
    }
-  }else{
-   all_completed = false;
+   auto & gpu_req = tn_req->gpus[gpu];
+   if(gpu_req.workspace_slot >= 0){
+    releaseWorkspace(gpu,gpu_req.workspace_slot);
+    gpu_req.workspace_slot = -1;
+   }
+  }
+  tn_req->gpu_memory.clear();
+  tn_req->memory_released = true;
+ }
+#ifdef MPI_ENABLED
+ //Reduce the output tensor across all processes (reductions are started in the submission order):
+ if(tn_req->dynamic_slicing){
+  if(!tn_req->reduction_started){
+   assert(!reduction_order_.empty());
+   if(reduction_order_.front() != tn_req->exec_handle) return;
+   reduction_order_.pop_front();
+   const auto output_hash = tn_req->network->getTensor(0)->getTensorHash();
+   const auto & descr = tn_req->tensor_descriptors[output_hash];
+   const bool complex_type = (tn_req->data_type == CUDA_C_32F || tn_req->data_type == CUDA_C_64F);
+   const bool single_precision = (tn_req->data_type == CUDA_R_32F || tn_req->data_type == CUDA_C_32F);
+   const int count = static_cast<int>(descr.volume * (complex_type ? 2 : 1));
+   auto errc = MPI_Iallreduce(MPI_IN_PLACE,descr.src_ptr,count,(single_precision ? MPI_FLOAT : MPI_DOUBLE),
+                              MPI_SUM,tn_req->comm,&(tn_req->reduction_request)); assert(errc == MPI_SUCCESS);
+   tn_req->reduction_started = true;
   }
+  int completed = 0;
+  auto errc = MPI_Test(&(tn_req->reduction_request),&completed,MPI_STATUS_IGNORE); assert(errc == MPI_SUCCESS);
+  if(completed == 0) return;
+  auto & counters = getSliceCounters(tn_req->comm);
+  counters.slot_turn[tn_req->counter_slot] += counters.slot_turn.size(); //pass the slice counter slot to its next user
  }
- if(all_completed) tn_req->exec_status = TensorNetworkQueue::ExecStat::Completed;
+#endif
+ tn_req->exec_status = TensorNetworkQueue::ExecStat::Completed;
  return;
 }
 
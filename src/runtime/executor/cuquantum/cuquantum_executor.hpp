@@ -1,5 +1,5 @@
 /** ExaTN: Tensor Runtime: Tensor network executor: NVIDIA cuQuantum
-REVISION: 2022/01/10
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -8,6 +8,21 @@ Rationale:
  - ExaTN graph executor may accept whole tensor networks for execution
    via the optional cuQuantum backend in which case the graph executor
    will delegate execution of whole tensor networks to CuQuantumExecutor.
+ - CuQuantumExecutor distributes the tensor network slices across all GPUs
+   available to the current process, followed by an on-node reduction of
+   the partial output tensors on the first GPU.
+ - Contraction plans are cached and reused for the tensor networks of
+   the same structure (optionally persisted in the directory given by
+   the "cuquantum_plan_cache_directory" runtime parameter).
+ - Tensor loading (copy stream), contraction path finding (planner threads)
+   and contraction (compute streams) of different tensor networks overlap.
+ - With multiple MPI processes, the slices are assigned dynamically via
+   a shared atomic slice counter and the output tensor is reduced across
+   the processes via a non-blocking MPI_Iallreduce progressed by sync().
+ - CuQuantumExecutor leases the whole TAL-SH device buffer of each GPU
+   from the process-wide device memory manager while it executes tensor
+   networks, and reads the input tensors still resident on a GPU directly
+   from their TAL-SH images (zero copy).
 
 **/
 
@@ -18,9 +33,20 @@ Rationale:
 
 #include <unordered_map>
 #include <vector>
+#include <string>
+#include <memory>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
 
-#include "linear_memory.hpp"
+#ifdef MPI_ENABLED
+#include "mpi.h"
+#endif
+
+#include "free_list_memory.hpp"
 #include "tensor_network_queue.hpp"
 
 namespace talsh{
@@ -34,6 +60,7 @@ using TensorImplFunc = std::function<void*(const numerics::Tensor &, int, int, s
 using TensorImplTalshFunc = std::function<std::shared_ptr<talsh::Tensor>(const numerics::Tensor &, int, int)>;
 
 struct TensorNetworkReq;
+struct ContractionPlan;
 
 struct ExecutionTimings {
  float prepare = 0.0;
@@ -50,7 +77,8 @@ public:
  CuQuantumExecutor(TensorImplFunc tensor_data_access_func,
                    unsigned int pipeline_depth,
                    unsigned int num_processes,
-                   unsigned int process_rank);
+                   unsigned int process_rank,
+                   const std::string & plan_cache_dir = ""); //in: directory for persistent contraction plans (optional)
 
  CuQuantumExecutor(const CuQuantumExecutor &) = delete;
  CuQuantumExecutor & operator=(CuQuantumExecutor &) = delete;
@@ -64,6 +92,7 @@ public:
  TensorNetworkQueue::ExecStat execute(std::shared_ptr<numerics::TensorNetwork> network, //in: tensor network
                                       unsigned int num_processes, //in: total number of executing processes
                                       unsigned int process_rank,  //in: rank of the current executing process
+                                      const MPICommProxy & communicator, //in: MPI communicator of the executing processes
                                       const TensorOpExecHandle exec_handle); //in: tensor network execution handle
 
  /** Synchronizes on the progress of the tensor network execution.
@@ -82,34 +111,86 @@ public:
 
 protected:
 
- static constexpr float WORKSPACE_FRACTION = 0.6;
+ static constexpr float WORKSPACE_FRACTION = 0.6; //max fraction of the device buffer occupied by the workspace slots
  static constexpr std::size_t MEM_ALIGNMENT = 256;
+ static constexpr unsigned int REDUCTION_BLOCK_SIZE = 256; //CUDA thread block size of the partial output reduction
+ static constexpr unsigned int REDUCTION_MAX_BLOCKS = 1024; //max number of CUDA thread blocks of the partial output reduction
+ static constexpr std::size_t PLAN_CACHE_CAPACITY = 256; //max number of cached contraction plans
+ static constexpr unsigned int NUM_PLANNER_THREADS = 2; //number of Host threads determining contraction paths
+ static constexpr int64_t SLICE_BATCHES_PER_GPU = 8; //average number of slice batches per GPU (dynamic slicing)
+
+ /** Leases the device buffers of all GPUs from the device memory manager
+     (no-op if already leased), setting up their free-list memory pools. **/
+ void leaseDeviceMemory();
+
+ /** Returns the leased device buffers of all GPUs to the device memory manager. **/
+ void releaseDeviceMemory();
+
+ /** Acquires a free workspace slot on a given GPU, returning its index (-1 if none is free). **/
+ int acquireWorkspace(unsigned int dev,
+                      void ** workspace_ptr,
+                      uint64_t * workspace_size);
 
- void acquireWorkspace(unsigned int dev,
-                       void ** workspace_ptr,
-                       uint64_t * workspace_size);
+ /** Releases a workspace slot on a given GPU. **/
+ void releaseWorkspace(unsigned int dev,
+                       int slot);
 
  void parseTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_req);
  void loadTensors(std::shared_ptr<TensorNetworkReq> tn_req);
  void planExecution(std::shared_ptr<TensorNetworkReq> tn_req);
  void contractTensorNetwork(std::shared_ptr<TensorNetworkReq> tn_req);
  void testCompletion(std::shared_ptr<TensorNetworkReq> tn_req);
+ /** Reduces the partial output tensors on the first GPU and transfers the output tensor to Host. **/
+ void reducePartialOutputs(std::shared_ptr<TensorNetworkReq> tn_req);
+
+ /** Determines the contraction path and slicing (executed by a planner thread). **/
+ void optimizeContraction(void * cutn_handle, //in: cuTensorNet handle of the planner thread
+                          const std::string & plan_key,
+                          uint64_t worksize,
+                          ContractionPlan & plan);
+ /** Planner thread main loop. **/
+ void runPlanner();
+
+ /** Returns the name of the file storing the optimizer info for a given plan key. **/
+ std::string planFileName(const std::string & plan_key) const;
+ /** Loads the optimizer info from the plan cache directory (returns FALSE if unavailable). **/
+ bool loadOptimizerInfo(void * cutn_handle, const std::string & plan_key, ContractionPlan & plan);
+ /** Stores the optimizer info in the plan cache directory (if any). **/
+ void storeOptimizerInfo(void * cutn_handle, const std::string & plan_key, const ContractionPlan & plan);
 
  struct DeviceAttr{
-  void * buffer_ptr = nullptr;
-  std::size_t buffer_size = 0;
-  void * workspace_ptr = nullptr;
-  std::size_t workspace_size = 0;
-  unsigned int pipe_level = 0;
+  void * buffer_ptr = nullptr; //base of the device buffer (shared with TAL-SH)
+  std::size_t buffer_size = 0; //size of the device buffer
+  std::size_t workspace_size = 0; //size of a workspace slot
+  std::vector<void*> workspace_slots; //memory of each workspace slot (nullptr: free)
   void * cutn_handle; //cutensornetHandle_t = void*
+  void * copy_stream; //cudaStream_t for loading tensors
  };
 
+ #ifdef MPI_ENABLED
+ struct SliceCounters{
+  MPI_Win win; //MPI window with the shared slice counters (hosted by the first process)
+  int64_t * counters = nullptr; //shared slice counters (on the first process)
+  unsigned int total_gpus = 0; //total number of GPUs across all processes of the communicator
+  unsigned int next_seq = 0; //sequence number of the next tensor network using the slice counters
+  std::vector<int64_t> slot_base; //base value of each slice counter slot
+  std::vector<unsigned int> slot_turn; //sequence number of the tensor network allowed to use each slice counter slot
+ };
+
+ /** Returns the shared slice counters for a given MPI communicator (collective on the first call). **/
+ SliceCounters & getSliceCounters(MPI_Comm comm);
+ /** Fetches the next batch of slices from the shared slice counter and issues it on a given GPU. **/
+ void contractSliceBatch(std::shared_ptr<TensorNetworkReq> tn_req, int gpu);
+#endif
+
  /** Currently processed (progressing) tensor networks **/
  std::unordered_map<TensorOpExecHandle,std::shared_ptr<TensorNetworkReq>> active_networks_;
  /** Attributes of all GPUs available to the current process **/
  std::vector<std::pair<int,DeviceAttr>> gpu_attr_; //{gpu_id, gpu_attributes}
- /** Moving-window linear memory pools for all GPUs of the current process **/
- std::vector<LinearMemoryPool> mem_pool_;
+ /** Free-list memory pools for all GPUs of the current process (tensors and workspace) **/
+ std::vector<FreeListMemoryPool> mem_pool_;
+ /** Whether or not the device buffers are currently leased **/
+ bool leased_ = false;
  /** Tensor data access function **/
  TensorImplFunc tensor_data_access_func_; //numerics::Tensor --> {tensor_body_ptr, size_in_bytes}
  /** Pipeline depth **/
@@ -118,6 +199,22 @@ protected:
  const unsigned int num_processes_;
  /** Current process rank **/
  const unsigned int process_rank_;
+ /** Cached contraction plans: Structural key of the tensor network --> contraction plan **/
+ std::unordered_map<std::string,std::shared_ptr<ContractionPlan>> plan_cache_;
+ /** Directory for persistent contraction plans (empty: no persistence) **/
+ const std::string plan_cache_dir_;
+ /** Planner threads and their job queue **/
+ std::vector<std::thread> planners_;
+ std::deque<std::function<void(void*)>> plan_jobs_; //job(cutn_handle)
+ std::mutex plan_mutex_;
+ std::condition_variable plan_cv_;
+ bool stop_planners_ = false;
+#ifdef MPI_ENABLED
+ /** Shared slice counters for each MPI communicator **/
+ std::map<MPI_Comm,SliceCounters> slice_counters_;
+ /** Execution handles of the multi-process tensor networks in their submission order (pending reduction) **/
+ std::deque<TensorOpExecHandle> reduction_order_;
+#endif
  /** Executed flops **/
  double flops_;
 };
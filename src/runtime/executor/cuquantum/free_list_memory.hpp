@@ -0,0 +1,154 @@
+/** ExaTN: Tensor Runtime: Tensor network executor: Free-list memory allocator
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The free-list memory pool manages a contiguous memory buffer (e.g., GPU memory)
+     by the best-fit policy: A memory request is served from the smallest free block
+     that fits it, with the remainder of the block returned to the free list.
+ (b) Memory blocks can be released in any order; a released block is coalesced
+     with its adjacent free blocks, thus a long-lived allocation does not block
+     the reuse of the memory released after it (unlike the linear memory pool).
+ (c) All memory blocks are aligned to the alignment of the memory pool.
+ (d) A memory buffer shared with another user (e.g., the device buffer shared with TAL-SH)
+     can be managed by the memory pool once the ranges still occupied by the other user
+     have been reserved (they are never acquired and never released).
+
+**/
+
+#ifndef EXATN_RUNTIME_FREE_LIST_MEMORY_HPP_
+#define EXATN_RUNTIME_FREE_LIST_MEMORY_HPP_
+
+#include <map>
+#include <unordered_map>
+#include <iterator>
+#include <algorithm>
+
+#include "errors.hpp"
+
+class FreeListMemoryPool {
+
+public:
+
+ FreeListMemoryPool(void * base_ptr,
+                    std::size_t total_size,
+                    std::size_t alignment):
+  base_ptr_(base_ptr), total_size_(total_size), alignment_(alignment), occupied_size_(0)
+ {
+  assert(reinterpret_cast<std::size_t>(base_ptr_) % alignment_ == 0);
+  if(total_size_ > 0) insertFreeBlock(0,total_size_);
+ }
+
+ std::size_t occupiedSize() const {
+  return occupied_size_;
+ }
+
+ /** Acquires a memory block of a given size (nullptr if no free block fits). **/
+ void * acquireMemory(std::size_t mem_size) {
+  assert(mem_size > 0);
+  const auto unaligned = mem_size % alignment_;
+  if(unaligned > 0) mem_size += (alignment_ - unaligned);
+  auto best_fit = free_by_size_.lower_bound(mem_size);
+  if(best_fit == free_by_size_.end()) return nullptr;
+  const std::size_t offset = best_fit->second;
+  const std::size_t block_size = best_fit->first;
+  eraseFreeBlock(offset);
+  if(block_size > mem_size) insertFreeBlock(offset + mem_size,block_size - mem_size);
+  void * mem_ptr = (void*)((char*)base_ptr_ + offset);
+  allocated_.emplace(std::make_pair(mem_ptr,mem_size));
+  occupied_size_ += mem_size;
+  return mem_ptr;
+ }
+
+ /** Releases a previously acquired memory block (coalesced with adjacent free blocks). **/
+ void releaseMemory(void * mem_ptr) {
+  auto iter = allocated_.find(mem_ptr);
+  assert(iter != allocated_.end());
+  std::size_t offset = reinterpret_cast<std::size_t>(mem_ptr) - reinterpret_cast<std::size_t>(base_ptr_);
+  std::size_t block_size = iter->second;
+  occupied_size_ -= block_size;
+  allocated_.erase(iter);
+  auto next = free_by_offset_.lower_bound(offset);
+  if(next != free_by_offset_.end() && next->first == offset + block_size){ //merge with the next free block
+   block_size += next->second;
+   eraseFreeBlock(next->first);
+  }
+  next = free_by_offset_.lower_bound(offset);
+  if(next != free_by_offset_.begin()){
+   auto prev = std::prev(next);
+   if(prev->first + prev->second == offset){ //merge with the previous free block
+    offset = prev->first;
+    block_size += prev->second;
+    eraseFreeBlock(offset);
+   }
+  }
+  insertFreeBlock(offset,block_size);
+  return;
+ }
+
+ /** Reserves a memory range occupied by another user of the memory buffer (extended
+     to the alignment, clipped to the memory buffer), such that it is never acquired.
+     Returns FALSE if the memory range does not start within the memory buffer.
+     The reserved ranges may overlap. **/
+ bool reserveMemory(const void * mem_ptr, std::size_t mem_size) {
+  const std::size_t base = reinterpret_cast<std::size_t>(base_ptr_);
+  const std::size_t addr = reinterpret_cast<std::size_t>(mem_ptr);
+  if(mem_size == 0 || addr < base || addr >= base + total_size_) return false;
+  std::size_t begin = addr - base;
+  begin -= begin % alignment_;
+  std::size_t end = addr - base + mem_size;
+  const auto unaligned = end % alignment_;
+  if(unaligned > 0) end += (alignment_ - unaligned);
+  end = std::min(end,total_size_);
+  auto iter = free_by_offset_.upper_bound(begin);
+  if(iter != free_by_offset_.begin()) iter = std::prev(iter);
+  while(iter != free_by_offset_.end() && iter->first < end){
+   const std::size_t offset = iter->first;
+   const std::size_t block_size = iter->second;
+   ++iter;
+   if(offset + block_size <= begin) continue; //free block precedes the range
+   eraseFreeBlock(offset);
+   if(offset < begin) insertFreeBlock(offset,begin - offset);
+   if(offset + block_size > end) insertFreeBlock(end,offset + block_size - end);
+   occupied_size_ += (std::min(offset + block_size,end) - std::max(offset,begin));
+  }
+  return true;
+ }
+
+ /** Returns the size of the largest free memory block. **/
+ std::size_t largestFreeBlock() const {
+  if(free_by_size_.empty()) return 0;
+  return free_by_size_.crbegin()->first;
+ }
+
+protected:
+
+ void insertFreeBlock(std::size_t offset, std::size_t block_size) {
+  free_by_offset_.emplace(std::make_pair(offset,block_size));
+  free_by_size_.emplace(std::make_pair(block_size,offset));
+  return;
+ }
+
+ void eraseFreeBlock(std::size_t offset) {
+  auto iter = free_by_offset_.find(offset);
+  assert(iter != free_by_offset_.end());
+  auto range = free_by_size_.equal_range(iter->second);
+  for(auto pos = range.first; pos != range.second; ++pos){
+   if(pos->second == offset){free_by_size_.erase(pos); break;}
+  }
+  free_by_offset_.erase(iter);
+  return;
+ }
+
+ void * base_ptr_;
+ std::size_t total_size_;
+ std::size_t alignment_;
+ std::size_t occupied_size_;                          //total size of the acquired memory blocks
+ std::map<std::size_t,std::size_t> free_by_offset_;   //free blocks: offset --> size
+ std::multimap<std::size_t,std::size_t> free_by_size_; //free blocks: size --> offset
+ std::unordered_map<void*,std::size_t> allocated_;    //acquired blocks: pointer --> size
+};
+
+#endif //EXATN_RUNTIME_FREE_LIST_MEMORY_HPP_
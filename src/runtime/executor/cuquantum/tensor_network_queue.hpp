@@ -1,5 +1,5 @@
 /** ExaTN: Tensor Runtime: Tensor network executor: Execution queue
-REVISION: 2022/01/07
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -8,7 +8,21 @@ Rationale:
  - ExaTN graph executor may accept whole tensor networks for execution
    via the optional cuQuantum backend in which case the graph executor
    will delegate execution of whole tensor networks to CuQuantumExecutor.
-
+ - Client threads submit tensor networks into a bounded multi-producer
+   single-consumer (MPSC) lock-free submission ring (same protocol as
+   TensorOpRing) and get the submission ticket (+1) as the execution handle.
+   The execution thread (single consumer) moves newly submitted tensor networks
+   from the submission ring into its private queue whenever it restarts a pass
+   over the queue (reset) or checks its emptiness, thus traversing and removing
+   tensor networks from the queue never requires synchronization.
+ - The execution status of each submitted tensor network lives in a concurrent
+   status table directly indexed by the execution handle (modulo the capacity),
+   where each slot is tagged by the execution handle occupying it. Clients polling
+   the execution status (checkExecStatus) only perform atomic loads, validating
+   the slot tag after reading the status, thus polling never blocks execution.
+   Since execution handles are unique, a reused slot can never be mistaken.
+ - The number of submitted but not yet removed tensor networks is bounded by
+   the queue capacity: append() returns zero when the queue is full.
 **/
 
 #ifndef EXATN_RUNTIME_TENSOR_NETWORK_QUEUE_HPP_
@@ -18,10 +32,10 @@ Rationale:
 #include "tensor_operation.hpp"
 
 #include <unordered_map>
+#include <vector>
 #include <list>
 #include <memory>
 #include <atomic>
-#include <mutex>
 
 #include "errors.hpp"
 
@@ -32,6 +46,8 @@ class TensorNetworkQueue {
 
 public:
 
+ static constexpr std::size_t DEFAULT_CAPACITY = 1024; //must be a power of 2
+
  //Tensor network execution status:
  enum class ExecStat {
   None,      //no execution status
@@ -56,7 +72,13 @@ public:
  using ConstTensorNetworkQueueIterator =
   std::list<std::pair<std::shared_ptr<numerics::TensorNetwork>,TensorOpExecHandle>>::const_iterator;
 
- TensorNetworkQueue(): current_network_(networks_.end()) {
+ TensorNetworkQueue(std::size_t capacity = DEFAULT_CAPACITY):
+  submissions_(capacity), status_(capacity), mask_(capacity - 1),
+  enqueue_pos_(0), dequeue_pos_(0), num_removed_(0), current_network_(networks_.end())
+ {
+  make_sure((capacity >= 2) && ((capacity & (capacity - 1)) == 0),
+            "exatn::runtime::TensorNetworkQueue: Queue capacity must be a power of 2!");
+  for(std::size_t i = 0; i < capacity; ++i) submissions_[i].sequence.store(i,std::memory_order_relaxed);
  }
 
  TensorNetworkQueue(const TensorNetworkQueue &) = delete;
@@ -65,104 +87,117 @@ public:
  TensorNetworkQueue & operator=(TensorNetworkQueue &&) noexcept = delete;
  ~TensorNetworkQueue() = default;
 
+ /** Iterators over the tensor networks moved into the queue (execution thread only). **/
  TensorNetworkQueueIterator begin() {return networks_.begin();}
  TensorNetworkQueueIterator end() {return networks_.end();}
  ConstTensorNetworkQueueIterator cbegin() {return networks_.cbegin();}
  ConstTensorNetworkQueueIterator cend() {return networks_.cend();}
 
- /** Returns TRUE is the tensor network queue is empty, FALSE otherwise. **/
+ /** Returns TRUE is the tensor network queue is empty, FALSE otherwise
+     (execution thread only, moves newly submitted tensor networks into the queue). **/
  bool isEmpty() {
-  lock();
-  bool empt = networks_.empty();
-  unlock();
-  return empt;
+  acceptSubmissions();
+  return networks_.empty();
  }
 
- /** Returns the current size of the tensor network queue. **/
- std::size_t getSize() {
-  lock();
-  const std::size_t current_size = networks_.size();
-  unlock();
-  return current_size;
+ /** Returns the current size of the tensor network queue,
+     including the submitted tensor networks not yet moved into it (any thread). **/
+ std::size_t getSize() const {
+  return (enqueue_pos_.load(std::memory_order_acquire) - num_removed_.load(std::memory_order_acquire));
  }
 
- /** Appends a new tensor network to the queue (no repeats allowed).
-     Upon success, returns a positive execution handle, zero otherwise. **/
+ /** Appends a new tensor network to the queue (any thread, lock-free).
+     Upon success, returns a positive execution handle, zero if the queue is full. **/
  TensorOpExecHandle append(std::shared_ptr<numerics::TensorNetwork> network,
                            const MPICommProxy & communicator,
                            unsigned int num_processes,
                            unsigned int process_rank) {
-  lock();
-  TensorOpExecHandle tn_hash = getTensorNetworkHash(network);
-  auto res = tn_exec_stat_.emplace(std::make_pair(tn_hash,
-              NetEntry{ExecStat::Idle,num_processes,process_rank,communicator}));
-  if(res.second){
-   networks_.emplace_back(std::make_pair(network,tn_hash));
-  }else{
-   tn_hash = 0;
+  Submission * slot = nullptr;
+  std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while(true){
+   slot = &(submissions_[pos & mask_]);
+   const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+   const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+   if(diff == 0){
+    //The status slot is only released by the consumer, thus it stays free once seen free:
+    if(status_[pos & mask_].handle.load(std::memory_order_acquire) != 0) return 0; //queue is full
+    if(enqueue_pos_.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed)) break;
+   }else if(diff < 0){ //queue is full
+    return 0;
+   }else{
+    pos = enqueue_pos_.load(std::memory_order_relaxed);
+   }
   }
-  unlock();
-  return tn_hash;
+  const TensorOpExecHandle exec_handle = pos + 1;
+  auto & status = status_[pos & mask_];
+  status.exec_status.store(ExecStat::Idle,std::memory_order_relaxed);
+  status.handle.store(exec_handle,std::memory_order_release); //publish the execution status
+  slot->network = network;
+  slot->entry = NetEntry{ExecStat::Idle,num_processes,process_rank,communicator};
+  slot->sequence.store(pos+1,std::memory_order_release); //publish the submission
+  return exec_handle;
  }
 
- /** Removes the tensor network currently pointed to from the queue.
+ /** Removes the tensor network currently pointed to from the queue (execution thread only).
      The tensor network execution status must be marked Completed. **/
  void remove() {
-  lock();
   assert(current_network_ != networks_.end());
-  auto iter = tn_exec_stat_.find(current_network_->second);
-  if(iter != tn_exec_stat_.end()){
-   if(iter->second.exec_status == ExecStat::Completed){
-    tn_exec_stat_.erase(iter);
+  const auto exec_handle = current_network_->second;
+  auto & status = status_[(exec_handle - 1) & mask_];
+  if(status.handle.load(std::memory_order_relaxed) == exec_handle){
+   if(status.exec_status.load(std::memory_order_relaxed) == ExecStat::Completed){
+    status.exec_status.store(ExecStat::None,std::memory_order_relaxed);
+    status.handle.store(0,std::memory_order_release); //release the status slot
    }else{
     std::cout << "#ERROR(exatn::runtime::TensorNetworkQueue): Attempt to delete an unfinished tensor network!\n";
     assert(false);
    }
   }
+  tn_exec_conf_.erase(exec_handle);
   current_network_ = networks_.erase(current_network_);
-  unlock();
+  num_removed_.fetch_add(1,std::memory_order_release);
   return;
  }
 
  /** Returns the execution status associated with
-     the given tensor network execution handle. **/
- ExecStat checkExecStatus(const TensorOpExecHandle exec_handle) {
+     the given tensor network execution handle (any thread, never blocks). **/
+ ExecStat checkExecStatus(const TensorOpExecHandle exec_handle) const {
   auto exec_stat = ExecStat::None;
-  lock();
-  auto iter = tn_exec_stat_.find(exec_handle);
-  if(iter != tn_exec_stat_.cend()) exec_stat = iter->second.exec_status;
-  unlock();
+  if(exec_handle != 0){
+   const auto & status = status_[(exec_handle - 1) & mask_];
+   if(status.handle.load(std::memory_order_acquire) == exec_handle){
+    exec_stat = status.exec_status.load(std::memory_order_acquire);
+    if(status.handle.load(std::memory_order_acquire) != exec_handle) exec_stat = ExecStat::None; //removed meanwhile
+   }
+  }
   return exec_stat;
  }
 
  /** Updates the execution status associated with
-     the given tensor network execution handle.
+     the given tensor network execution handle (execution thread only).
      Returns the previous execution status. **/
  ExecStat updateExecStatus(const TensorOpExecHandle exec_handle,
                            ExecStat new_exec_stat) {
   auto exec_stat = ExecStat::None;
-  lock();
-  auto iter = tn_exec_stat_.find(exec_handle);
-  if(iter != tn_exec_stat_.end()){
-   exec_stat = iter->second.exec_status;
-   iter->second.exec_status = new_exec_stat;
+  if(exec_handle != 0){
+   auto & status = status_[(exec_handle - 1) & mask_];
+   if(status.handle.load(std::memory_order_acquire) == exec_handle){
+    exec_stat = status.exec_status.exchange(new_exec_stat,std::memory_order_acq_rel);
+   }
   }
-  unlock();
   return exec_stat;
  }
 
  /** Returns the parallel execution configuration associated
-     with the given tensor network execution handle. **/
+     with the given tensor network execution handle (execution thread only). **/
  std::pair<int,int> getExecConfiguration(const TensorOpExecHandle exec_handle,
                                          MPICommProxy * communicator = nullptr) {
   std::pair<int,int> exec_conf{0,-1};
-  lock();
-  auto iter = tn_exec_stat_.find(exec_handle);
-  if(iter != tn_exec_stat_.cend()){
+  auto iter = tn_exec_conf_.find(exec_handle);
+  if(iter != tn_exec_conf_.cend()){
    exec_conf = std::make_pair(iter->second.num_procs,iter->second.proc_id);
    if(communicator != nullptr) *communicator = iter->second.comm;
   }
-  unlock();
   return exec_conf;
  }
 
@@ -171,33 +206,27 @@ public:
   return current_network_;
  }
 
- /** Resets the current iterator to the beginning of the queue. **/
+ /** Resets the current iterator to the beginning of the queue
+     (execution thread only, moves newly submitted tensor networks into the queue). **/
  void reset() {
-  lock();
+  acceptSubmissions();
   current_network_ = networks_.begin();
-  unlock();
   return;
  }
 
  /** Returns TRUE if the current iterator is positioned
      after the end of the queue, FALSE otherwise. **/
  bool isOver() {
-  lock();
-  bool over = (current_network_ == networks_.end());
-  unlock();
-  return over;
+  return (current_network_ == networks_.end());
  }
 
  /** Moves the current iterator to the next element of the queue.
      If moved past the end, return FALSE, otherwise TRUE.
      The current iterator must be valid on entrance. **/
  bool next() {
-  lock();
   assert(current_network_ != networks_.end());
   ++current_network_;
-  bool not_over = (current_network_ != networks_.end());
-  unlock();
-  return not_over;
+  return (current_network_ != networks_.end());
  }
 
  /** Returns the distance from the current iterator
@@ -206,20 +235,56 @@ public:
   return std::distance(networks_.begin(),current_network_);
  }
 
- /** Locks. **/
- inline void lock(){queue_lock_.lock();}
- inline void unlock(){queue_lock_.unlock();}
-
 protected:
 
- /** Tensor network execution status **/
- std::unordered_map<TensorOpExecHandle,NetEntry> tn_exec_stat_;
- /** Queue of tensor networks to be executed **/
+ /** Moves all published submissions into the queue in the submission order (execution thread only).
+     Returns the number of moved tensor networks. **/
+ std::size_t acceptSubmissions() {
+  std::size_t num_accepted = 0;
+  while(true){
+   const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+   Submission & slot = submissions_[pos & mask_];
+   const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+   if(seq != (pos+1)) break; //no more published submissions
+   const TensorOpExecHandle exec_handle = pos + 1;
+   tn_exec_conf_.emplace(std::make_pair(exec_handle,slot.entry));
+   networks_.emplace_back(std::make_pair(std::move(slot.network),exec_handle));
+   slot.network.reset();
+   slot.sequence.store(pos+submissions_.size(),std::memory_order_release); //release the slot
+   dequeue_pos_.store(pos+1,std::memory_order_release);
+   ++num_accepted;
+  }
+  return num_accepted;
+ }
+
+ struct Submission {
+  std::atomic<std::size_t> sequence;               //slot sequence number
+  std::shared_ptr<numerics::TensorNetwork> network; //submitted tensor network
+  NetEntry entry;                                   //its parallel execution configuration
+  Submission(): sequence(0), network(nullptr) {}
+ };
+
+ struct StatusSlot {
+  std::atomic<TensorOpExecHandle> handle;          //execution handle occupying the slot (0: free)
+  std::atomic<ExecStat> exec_status;               //execution status
+  StatusSlot(): handle(0), exec_status(ExecStat::None) {}
+ };
+
+ /** Submission ring (MPSC) **/
+ std::vector<Submission> submissions_;
+ /** Tensor network execution status table (indexed by the execution handle) **/
+ std::vector<StatusSlot> status_;
+ const std::size_t mask_;                           //capacity - 1
+ alignas(64) std::atomic<std::size_t> enqueue_pos_; //next submission ticket (producers)
+ alignas(64) std::atomic<std::size_t> dequeue_pos_; //next submission ticket to be accepted (consumer)
+ alignas(64) std::atomic<std::size_t> num_removed_; //number of removed tensor networks (consumer)
+ /** Parallel execution configuration of the accepted tensor networks (execution thread only) **/
+ std::unordered_map<TensorOpExecHandle,NetEntry> tn_exec_conf_;
+ /** Queue of tensor networks to be executed (execution thread only) **/
  std::list<std::pair<std::shared_ptr<numerics::TensorNetwork>,
                      TensorOpExecHandle>> networks_;
  /** Tensor network iterator **/
  TensorNetworkQueueIterator current_network_;
- std::mutex queue_lock_;
 };
 
 } //namespace runtime
@@ -0,0 +1,399 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Asynchronous binary execution log
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The execution log replaces the synchronous formatted text logging of the execution thread
+     by fixed-size (POD) binary records {event kind, code, time stamp, up to three arguments}
+     appended to a lock-free bounded multi-producer ring preallocated at opening. Recording a record
+     neither allocates, formats numbers nor performs any stream I/O: A producer reserves a contiguous
+     range of ring slots by a CAS on the tail position, fills them, and publishes each slot
+     by storing its sequence number (position + 1) with release semantics.
+ (b) A background flusher thread periodically drains the published slots in order and appends
+     them to the binary log file "exatn_exec_thread.<global_rank>.bin" (raw records after a header),
+     thus the file I/O is moved off the execution thread. If the ring is full, the record is dropped
+     (the producer never blocks), the number of dropped records is reported in the log as a DROPPED record.
+ (c) Variable-length text (tensor operation details, lists of DAG nodes) spans several consecutive
+     TEXT (NODE_LIST) records reserved atomically, thus it is never interleaved with other records.
+ (d) The offline decoder (decode(), exatn_exec_log_decode executable) reproduces the human-readable
+     text format of the synchronous execution thread log from the binary log file.
+ (e) flush() blocks until all records recorded so far have been written to the file (used before
+     aborting on a fatal error). Opening/closing must not overlap with recording.
+**/
+
+#ifndef EXATN_RUNTIME_EXEC_LOG_HPP_
+#define EXATN_RUNTIME_EXEC_LOG_HPP_
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+#include <cstdint>
+
+namespace exatn {
+namespace runtime {
+
+class ExecLog {
+
+public:
+
+  static constexpr const std::size_t DEFAULT_CAPACITY = 65536;  //default number of records in the ring
+  static constexpr const unsigned int FLUSH_INTERVAL_US = 1000; //flusher thread polling interval (microseconds)
+  static constexpr const unsigned int FILE_VERSION = 1;         //binary log file format version
+
+  enum class EventKind: std::uint16_t {
+    TEXT,        //text chunk: (length) bytes of text stored in the arguments
+    NODE_READY,  //DAG node has all its dependencies resolved: (args[0]:node)
+    PREFETCH,    //prefetch initiated: (time, args[0]:node)
+    SUBMIT,      //tensor operation is being submitted: (time, args[0]:node, code:opcode)
+    STATUS,      //submission status: (code:error code)
+    SYNCING,     //syncing the submitted tensor operation
+    SUCCESS,     //immediate completion: (time)
+    MEMORY,      //memory usage: (time, args[0]:total flop count (bits), args[1]:used, args[2]:free)
+    FRONT,       //DAG front node progressed: (args[0]:front node, args[1]:number of DAG nodes)
+    FAILED,      //immediate completion failed: (time, code:error code)
+    DEFERRED,    //tensor operation is executing asynchronously
+    POSTPONED,   //tensor operation postponed (TRY_LATER)
+    SYNCED,      //deferred completion: (time, args[0]:node, code:opcode)
+    SYNC_FAILED, //deferred completion failed: (time, args[0]:node, code:opcode)
+    NODE_LIST,   //list of DAG nodes: (length:number of nodes in this record, args:nodes), the last record is never full
+    DROPPED,     //records dropped due to a full ring: (args[0]:number of dropped records)
+    NUM_KINDS
+  };
+
+  enum class NodeList: std::int32_t {
+    ENTRY,  //DAG entry list of dependency free nodes
+    CURRENT //DAG current list of dependency free nodes
+  };
+
+  struct Record {
+    std::uint16_t kind;     //event kind (EventKind)
+    std::uint16_t length;   //number of text bytes (TEXT), number of nodes (NODE_LIST), 0 otherwise
+    std::int32_t code;      //opcode, error code, node list kind
+    double time;            //time stamp (sec since the executor start)
+    std::uint64_t args[3];  //event arguments
+  };
+
+  static constexpr const std::size_t TEXT_PER_RECORD = sizeof(Record::args);                       //text bytes per TEXT record
+  static constexpr const std::size_t NODES_PER_RECORD = sizeof(Record::args) / sizeof(std::uint64_t); //nodes per NODE_LIST record
+
+  ExecLog(): capacity_(0), tail_(0), head_(0), dropped_(0), flushed_(0), flush_request_(0),
+             active_(false), stopping_(false) {}
+
+  ExecLog(const ExecLog &) = delete;
+  ExecLog & operator=(const ExecLog &) = delete;
+  ExecLog(ExecLog &&) = delete;
+  ExecLog & operator=(ExecLog &&) = delete;
+
+  ~ExecLog() {
+    close();
+  }
+
+  /** Opens the binary log file with a preallocated ring of a given capacity (records)
+      and starts the flusher thread. Returns FALSE if the file could not be opened. **/
+  bool open(const std::string & filename,
+            std::size_t capacity = DEFAULT_CAPACITY) {
+    close();
+    if(capacity == 0) return false;
+    logfile_.open(filename,std::ios::out|std::ios::trunc|std::ios::binary);
+    if(!logfile_.is_open()) return false;
+    const char magic[8] = {'E','X','A','T','N','L','O','G'};
+    const std::uint32_t header[2] = {FILE_VERSION,static_cast<std::uint32_t>(sizeof(Record))};
+    logfile_.write(magic,sizeof(magic));
+    logfile_.write(reinterpret_cast<const char*>(header),sizeof(header));
+    if(capacity != capacity_){
+      ring_.reset(new Slot[capacity]);
+      capacity_ = capacity;
+    }
+    for(std::size_t i = 0; i < capacity_; ++i) ring_[i].sequence.store(0,std::memory_order_relaxed);
+    tail_.store(0); head_.store(0); dropped_.store(0);
+    flushed_.store(0); flush_request_.store(0);
+    stopping_.store(false);
+    flusher_ = std::thread(&ExecLog::flusherLoop,this);
+    active_.store(true);
+    return true;
+  }
+
+  /** Stops the flusher thread after it has drained the ring and closes the binary log file.
+      The ring is retained (reused by the next opening of the same capacity). **/
+  void close() {
+    active_.store(false);
+    if(flusher_.joinable()){
+      stopping_.store(true);
+      flusher_.join();
+    }
+    if(logfile_.is_open()) logfile_.close();
+    return;
+  }
+
+  /** Returns TRUE if the execution log is open. **/
+  inline bool isActive() const {return active_.load(std::memory_order_relaxed);}
+
+  /** Records an event (lock-free, never blocks).
+      [THREAD: Can be called concurrently from multiple executor threads] **/
+  void record(EventKind kind,
+              double time = 0.0,
+              std::uint64_t arg0 = 0,
+              std::uint64_t arg1 = 0,
+              std::uint64_t arg2 = 0,
+              std::int32_t code = 0) {
+    std::uint64_t pos;
+    if(!reserve(1,&pos)) return;
+    Record & rec = slotRecord(pos);
+    rec.kind = static_cast<std::uint16_t>(kind);
+    rec.length = 0;
+    rec.code = code;
+    rec.time = time;
+    rec.args[0] = arg0; rec.args[1] = arg1; rec.args[2] = arg2;
+    publish(pos);
+    return;
+  }
+
+  /** Records the memory usage along with the total flop count. **/
+  void recordMemory(double time,
+                    double flops,
+                    std::size_t used_mem,
+                    std::size_t free_mem) {
+    std::uint64_t flop_bits = 0;
+    std::memcpy(&flop_bits,&flops,sizeof(flops));
+    record(EventKind::MEMORY,time,flop_bits,used_mem,free_mem);
+    return;
+  }
+
+  /** Records a (preformatted) text as consecutive TEXT records. **/
+  void recordText(const std::string & text) {
+    if(text.empty()) return;
+    const std::size_t per_record = TEXT_PER_RECORD;
+    const std::size_t num_records = (text.size() + per_record - 1) / per_record;
+    std::uint64_t pos;
+    if(!reserve(num_records,&pos)) return;
+    for(std::size_t i = 0; i < num_records; ++i){
+      Record & rec = slotRecord(pos+i);
+      const std::size_t offset = i * per_record;
+      const std::size_t length = std::min(per_record,text.size()-offset);
+      rec.kind = static_cast<std::uint16_t>(EventKind::TEXT);
+      rec.length = static_cast<std::uint16_t>(length);
+      rec.code = 0;
+      rec.time = 0.0;
+      std::memcpy(rec.args,text.data()+offset,length);
+      publish(pos+i);
+    }
+    return;
+  }
+
+  /** Records a list of DAG nodes as consecutive NODE_LIST records. **/
+  template <typename Container>
+  void recordNodes(NodeList list,
+                   const Container & nodes) {
+    const std::size_t per_record = NODES_PER_RECORD;
+    const std::size_t num_nodes = nodes.size();
+    const std::size_t num_records = num_nodes / per_record + 1; //the last record is never full
+    std::uint64_t pos;
+    if(!reserve(num_records,&pos)) return;
+    auto node = nodes.begin();
+    for(std::size_t i = 0; i < num_records; ++i){
+      Record & rec = slotRecord(pos+i);
+      const std::size_t length = std::min(per_record,num_nodes-i*per_record);
+      rec.kind = static_cast<std::uint16_t>(EventKind::NODE_LIST);
+      rec.length = static_cast<std::uint16_t>(length);
+      rec.code = (i == 0) ? static_cast<std::int32_t>(list) : -1; //-1: continuation
+      rec.time = 0.0;
+      for(std::size_t j = 0; j < length; ++j) rec.args[j] = static_cast<std::uint64_t>(*node++);
+      publish(pos+i);
+    }
+    return;
+  }
+
+  /** Blocks until all records recorded so far have been written to the file. **/
+  void flush() {
+    if(!isActive()) return;
+    const auto target = tail_.load();
+    std::uint64_t request = flush_request_.load();
+    while(request < target && !flush_request_.compare_exchange_weak(request,target));
+    while(flushed_.load() < target) std::this_thread::sleep_for(std::chrono::microseconds(FLUSH_INTERVAL_US / 10U));
+    return;
+  }
+
+  /** Decodes a binary log file into the human-readable text format of the execution thread log.
+      Returns FALSE if the input is not a valid binary log file. **/
+  static bool decode(std::istream & input,
+                     std::ostream & output) {
+    char magic[8];
+    std::uint32_t header[2];
+    input.read(magic,sizeof(magic));
+    input.read(reinterpret_cast<char*>(header),sizeof(header));
+    if(!input || std::strncmp(magic,"EXATNLOG",sizeof(magic)) != 0 ||
+       header[0] != FILE_VERSION || header[1] != sizeof(Record)) return false;
+    output << std::fixed << std::setprecision(6);
+    Record rec;
+    while(input.read(reinterpret_cast<char*>(&rec),sizeof(rec))) decodeRecord(rec,output);
+    output.flush();
+    return true;
+  }
+
+  /** Prints a single record in the human-readable text format. **/
+  static void decodeRecord(const Record & rec,
+                           std::ostream & output) {
+    static const char * const prefix = "](LazyGraphExecutor)[EXEC_THREAD]: ";
+    const std::size_t text_per_record = TEXT_PER_RECORD;
+    const std::size_t nodes_per_record = NODES_PER_RECORD;
+    switch(static_cast<EventKind>(rec.kind)){
+    case EventKind::TEXT:
+      output.write(reinterpret_cast<const char*>(rec.args),std::min(static_cast<std::size_t>(rec.length),text_per_record));
+      break;
+    case EventKind::NODE_READY:
+      output << "DAG node detected with all dependencies resolved: " << rec.args[0] << std::endl;
+      break;
+    case EventKind::PREFETCH:
+      output << "[" << rec.time << prefix << "Initiated prefetch for tensor operation " << rec.args[0] << std::endl;
+      break;
+    case EventKind::SUBMIT:
+      output << "[" << rec.time << prefix << "Submitting tensor operation " << rec.args[0] << ": Opcode = " << rec.code;
+      break;
+    case EventKind::STATUS:
+      output << ": Status = " << rec.code;
+      break;
+    case EventKind::SYNCING:
+      output << ": Syncing ... ";
+      break;
+    case EventKind::SUCCESS:
+      output << "Success [" << rec.time << "]" << std::endl;
+      break;
+    case EventKind::MEMORY:
+      {
+        double flops = 0.0;
+        std::memcpy(&flops,&(rec.args[0]),sizeof(flops));
+        output << "[" << rec.time << "]" << " Total Flop count = " << flops
+               << "; Memory usage = " << rec.args[1] << ", Free = " << rec.args[2] << std::endl;
+      }
+      break;
+    case EventKind::FRONT:
+      output << "DAG front node progressed to " << rec.args[0] << " out of total of " << rec.args[1] << std::endl;
+      break;
+    case EventKind::FAILED:
+      output << "Failed: Error " << rec.code << " [" << rec.time << "]" << std::endl;
+      break;
+    case EventKind::DEFERRED:
+      output << "Deferred" << std::endl;
+      break;
+    case EventKind::POSTPONED:
+      output << ": Postponed" << std::endl;
+      break;
+    case EventKind::SYNCED:
+      output << "[" << rec.time << prefix << "Synced tensor operation " << rec.args[0] << ": Opcode = " << rec.code << std::endl;
+      break;
+    case EventKind::SYNC_FAILED:
+      output << "[" << rec.time << prefix << "Failed to sync tensor operation " << rec.args[0] << ": Opcode = " << rec.code << std::endl;
+      break;
+    case EventKind::NODE_LIST:
+      if(rec.code == static_cast<std::int32_t>(NodeList::ENTRY)){
+        output << "DAG entry list of dependency free nodes:";
+      }else if(rec.code == static_cast<std::int32_t>(NodeList::CURRENT)){
+        output << "DAG current list of dependency free nodes:";
+      }
+      for(std::size_t i = 0; i < std::min(static_cast<std::size_t>(rec.length),nodes_per_record); ++i) output << " " << rec.args[i];
+      if(rec.length < nodes_per_record) output << std::endl; //last record of the list
+      break;
+    case EventKind::DROPPED:
+      output << std::endl << "#WARNING(ExecLog): " << rec.args[0] << " records dropped (full ring)" << std::endl;
+      break;
+    default:
+      output << std::endl << "#ERROR(ExecLog): Invalid record kind " << rec.kind << std::endl;
+      break;
+    }
+    return;
+  }
+
+protected:
+
+  struct Slot {
+    std::atomic<std::uint64_t> sequence; //position + 1 once the record has been published
+    Record record;                       //record
+  };
+
+  /** Reserves a contiguous range of ring slots, returns FALSE (drops) if the ring is full. **/
+  bool reserve(std::size_t num_records,
+               std::uint64_t * position) {
+    if(!isActive()) return false;
+    auto pos = tail_.load(std::memory_order_relaxed);
+    do{
+      if(num_records > capacity_ || pos + num_records - head_.load(std::memory_order_acquire) > capacity_){
+        dropped_.fetch_add(num_records,std::memory_order_relaxed);
+        return false;
+      }
+    }while(!tail_.compare_exchange_weak(pos,pos+num_records,std::memory_order_relaxed));
+    *position = pos;
+    return true;
+  }
+
+  inline Record & slotRecord(std::uint64_t position) {
+    return ring_[position % capacity_].record;
+  }
+
+  inline void publish(std::uint64_t position) {
+    ring_[position % capacity_].sequence.store(position + 1,std::memory_order_release);
+    return;
+  }
+
+  /** Drains all published records into the binary log file, returns the number of records. **/
+  std::size_t drain() {
+    std::size_t num_drained = 0;
+    const auto dropped = dropped_.exchange(0,std::memory_order_relaxed);
+    if(dropped > 0){
+      Record rec{static_cast<std::uint16_t>(EventKind::DROPPED),0,0,0.0,{dropped,0,0}};
+      logfile_.write(reinterpret_cast<const char*>(&rec),sizeof(rec));
+    }
+    auto pos = head_.load(std::memory_order_relaxed);
+    while(true){
+      const auto & slot = ring_[pos % capacity_];
+      if(slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+      logfile_.write(reinterpret_cast<const char*>(&(slot.record)),sizeof(Record));
+      head_.store(++pos,std::memory_order_release);
+      ++num_drained;
+    }
+    return num_drained;
+  }
+
+  /** Flusher thread. **/
+  void flusherLoop() {
+    while(true){
+      const bool stopping = stopping_.load();
+      const auto num_drained = drain();
+      const auto request = flush_request_.load();
+      if(request > flushed_.load()){
+        logfile_.flush();
+        flushed_.store(head_.load());
+      }
+      if(stopping && num_drained == 0) break;
+      if(num_drained == 0) std::this_thread::sleep_for(std::chrono::microseconds(FLUSH_INTERVAL_US * 1U));
+    }
+    logfile_.flush();
+    return;
+  }
+
+  std::unique_ptr<Slot[]> ring_;         //ring of records (preallocated)
+  std::size_t capacity_;                 //ring capacity (records)
+  std::atomic<std::uint64_t> tail_;      //next reserved position
+  std::atomic<std::uint64_t> head_;      //next position to be drained
+  std::atomic<std::uint64_t> dropped_;   //number of dropped records (not yet reported)
+  std::atomic<std::uint64_t> flushed_;   //position up to which the records have been flushed to the file
+  std::atomic<std::uint64_t> flush_request_; //position up to which a flush has been requested
+  std::atomic<bool> active_;             //activation status
+  std::atomic<bool> stopping_;           //signal to stop the flusher thread
+  std::ofstream logfile_;                //binary log file (written by the flusher thread only)
+  std::thread flusher_;                  //flusher thread
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_EXEC_LOG_HPP_
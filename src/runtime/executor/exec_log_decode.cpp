@@ -0,0 +1,47 @@
+/** ExaTN:: Tensor Runtime: Offline decoder of the binary execution log
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Usage:
+ exatn_exec_log_decode <exatn_exec_thread.<rank>.bin> [<output.log>]
+ Decodes the binary execution log into the human-readable execution thread log
+ (printed to the standard output unless the output file is specified).
+ Exit code: 0: Success; 2: Invalid input.
+**/
+
+#include "exec_log.hpp"
+
+#include <string>
+#include <iostream>
+#include <fstream>
+
+int main(int argc, char **argv) {
+
+  if(argc < 2 || argc > 3){
+    std::cout << "Usage: exatn_exec_log_decode <exatn_exec_thread.<rank>.bin> [<output.log>]" << std::endl;
+    return 2;
+  }
+  std::ifstream input(argv[1],std::ios::in|std::ios::binary);
+  if(!input.is_open()){
+    std::cout << "#ERROR(exatn_exec_log_decode): Unable to open the binary log " << argv[1] << std::endl;
+    return 2;
+  }
+  bool decoded = false;
+  if(argc == 3){
+    std::ofstream output(argv[2],std::ios::out|std::ios::trunc);
+    if(!output.is_open()){
+      std::cout << "#ERROR(exatn_exec_log_decode): Unable to open the output file " << argv[2] << std::endl;
+      return 2;
+    }
+    decoded = exatn::runtime::ExecLog::decode(input,output);
+  }else{
+    decoded = exatn::runtime::ExecLog::decode(input,std::cout);
+  }
+  if(!decoded){
+    std::cout << "#ERROR(exatn_exec_log_decode): Invalid binary log " << argv[1] << std::endl;
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,345 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Performance counters
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The performance counters of the tensor graph executor are always on:
+     All counters are relaxed atomics updated without locks by the execution
+     (worker) threads, thus their cost is a handful of atomic increments per
+     executed tensor operation. The counters are read via a snapshot (RuntimeMetrics),
+     which is only approximately consistent while the DAG is being executed.
+ (b) Counters:
+     - Per-opcode count of executed tensor operations, their total latency and
+       their latency histogram with power-of-two (microsecond) bins;
+     - Per-device count of executed tensor operations, their flop count and busy time
+       (accumulated latency), giving the achieved GFlop/s and utilization per device
+       (the busy time of concurrently executing tensor operations overlaps, thus the
+       achieved GFlop/s is a lower bound), together with the work currently queued
+       on the device and its free memory (provided by the node executor);
+     - Length of the ready queue (dependency-free DAG nodes) sampled over time;
+     - Number of TRY_LATER postponements of tensor operations;
+     - Prefetch hits (executed tensor operations whose operand prefetch had been initiated)
+       and misses (executed tensor operations whose operand prefetch had been attempted
+       but could not be initiated);
+     - Host-to-device and device-to-host data transfer volume (provided by the node executor);
+     - Inter-process communication volume: Total size of the tensor operands of the executed
+       FETCH, UPLOAD, BROADCAST and ALLREDUCE tensor operations (payload per process);
+     - Host memory buffer usage, total size of allocated tensors and the resulting
+       fragmentation factor (provided by the node executor at the time of the snapshot),
+       as well as the peak Host memory buffer usage (sampled after each executed CREATE)
+       and the high-water mark of the total size of allocated tensors (provided by the node executor);
+     - Time the execution thread spent idle (parked waiting for new work)
+       or spinning (polling the DAG without any progress).
+ (c) Besides the counters, the execution thread publishes the current state of the executed DAG
+     (number of DAG nodes and the DAG front node) after each DAG traversal, which is not reset
+     together with the counters (used by live monitoring).
+**/
+
+#ifndef EXATN_RUNTIME_EXEC_METRICS_HPP_
+#define EXATN_RUNTIME_EXEC_METRICS_HPP_
+
+#include "tensor_operation.hpp"
+
+#include "timers.hpp"
+
+#include <vector>
+#include <array>
+#include <atomic>
+
+namespace exatn {
+namespace runtime {
+
+/** Snapshot of the tensor runtime performance counters. **/
+struct RuntimeMetrics {
+
+  struct OpcodeStats {
+    std::size_t count = 0;      //number of executed tensor operations
+    double total_latency = 0.0; //total execution latency (sec)
+    std::vector<std::size_t> latency_histogram; //bin k: latency in [2^k,2^(k+1)) microseconds (bin 0 includes shorter ones)
+  };
+
+  struct DeviceStats {
+    int device = -1;                   //flat device id (-1: Host or unknown)
+    std::size_t count = 0;             //number of executed tensor operations
+    double flops = 0.0;                //executed flop count (estimate)
+    double busy_time = 0.0;            //accumulated execution latency (sec)
+    double gflops = 0.0;               //achieved GFlop/s
+    double utilization = 0.0;          //busy_time / elapsed_time (concurrent tensor operations may exceed 1.0)
+    double queued_flops = 0.0;         //work currently queued on the device (provided by the node executor)
+    std::size_t free_memory_bytes = 0; //free device memory (provided by the node executor)
+  };
+
+  std::vector<OpcodeStats> opcodes; //indexed by TensorOpCode
+  std::vector<DeviceStats> devices; //devices which have executed at least one tensor operation
+  std::vector<std::pair<double,std::size_t>> ready_queue; //ready queue length samples: {time since reset (sec), length}
+  std::size_t ready_queue_max = 0;      //max observed ready queue length
+  std::size_t num_postponed = 0;        //number of TRY_LATER postponements
+  std::size_t num_prefetch_hits = 0;    //number of prefetch hits
+  std::size_t num_prefetch_misses = 0;  //number of prefetch misses
+  std::size_t host_to_device_bytes = 0; //host-to-device transfer volume (bytes)
+  std::size_t device_to_host_bytes = 0; //device-to-host transfer volume (bytes)
+  std::size_t comm_bytes = 0;           //inter-process communication volume (bytes)
+  std::size_t memory_usage_bytes = 0;   //Host memory buffer usage, including fragmentation overhead (bytes)
+  std::size_t memory_free_bytes = 0;    //Host memory buffer free space (bytes)
+  std::size_t memory_peak_bytes = 0;    //peak Host memory buffer usage since the counters reset (bytes)
+  std::size_t tensor_memory_bytes = 0;  //total size of all allocated tensors (bytes)
+  std::size_t tensor_memory_peak_bytes = 0; //high-water mark of the total size of all allocated tensors since the counters reset (bytes)
+  double memory_fragmentation = 0.0;    //memory_usage_bytes / tensor_memory_bytes (0.0: unknown)
+  double exec_idle_time = 0.0;          //time the execution thread spent idle (sec)
+  double exec_spin_time = 0.0;          //time the execution thread spent spinning (sec)
+  double contr_seq_time = 0.0;          //time spent in the tensor contraction sequence search (sec, provided by the client)
+  std::size_t contr_seq_count = 0;      //number of tensor contraction sequence searches (provided by the client)
+  double contr_seq_graph_time = 0.0;    //tensor contraction sequence search: graph construction time (sec, provided by the client)
+  double contr_seq_partition_time = 0.0; //tensor contraction sequence search: graph partitioning time accumulated over walkers (sec, provided by the client)
+  std::size_t contr_seq_partition_calls = 0; //tensor contraction sequence search: number of graph partitioning calls (provided by the client)
+  double contr_seq_evaluation_time = 0.0; //tensor contraction sequence search: walker evaluation time accumulated over walkers (sec, provided by the client)
+  double contr_seq_merge_time = 0.0;    //tensor contraction sequence search: merging of walker results (sec, provided by the client)
+  std::size_t auto_default_networks = 0;   //"auto" backend: number of tensor networks assigned to the default backend (provided by the client)
+  std::size_t auto_cuquantum_networks = 0; //"auto" backend: number of tensor networks assigned to cuQuantum (provided by the client)
+  std::size_t auto_trials = 0;             //"auto" backend: number of trials of the other backend (provided by the client)
+  double elapsed_time = 0.0;            //time since the counters reset (sec)
+  std::size_t dag_nodes = 0;            //number of nodes in the currently executed DAG
+  std::size_t dag_front = 0;            //front node of the currently executed DAG (first unexecuted node)
+};
+
+
+class ExecMetrics {
+
+public:
+
+  static constexpr const unsigned int NUM_OPCODES = static_cast<unsigned int>(TensorOpCode::ALLREDUCE) + 1;
+  static constexpr const unsigned int NUM_LATENCY_BINS = 32;     //number of power-of-two latency bins (microseconds)
+  static constexpr const unsigned int MAX_DEVICES = 64;          //max number of tracked devices (including Host)
+  static constexpr const unsigned int NUM_QUEUE_SAMPLES = 256;   //number of retained ready queue length samples
+  static constexpr const double QUEUE_SAMPLE_PERIOD = 1e-3;      //ready queue sampling period (sec)
+
+  ExecMetrics(): dag_nodes_(0), dag_front_(0) {reset();}
+
+  ExecMetrics(const ExecMetrics &) = delete;
+  ExecMetrics & operator=(const ExecMetrics &) = delete;
+  ExecMetrics(ExecMetrics &&) = delete;
+  ExecMetrics & operator=(ExecMetrics &&) = delete;
+  ~ExecMetrics() = default;
+
+  /** Resets all counters. **/
+  void reset() {
+    for(auto & counters: opcodes_){
+      counters.count.store(0,std::memory_order_relaxed);
+      counters.latency_nsec.store(0,std::memory_order_relaxed);
+      for(auto & bin: counters.histogram) bin.store(0,std::memory_order_relaxed);
+    }
+    for(auto & counters: devices_){
+      counters.count.store(0,std::memory_order_relaxed);
+      counters.flops.store(0.0,std::memory_order_relaxed);
+      counters.busy_nsec.store(0,std::memory_order_relaxed);
+    }
+    for(auto & sample: queue_samples_){
+      sample.time.store(0.0,std::memory_order_relaxed);
+      sample.length.store(0,std::memory_order_relaxed);
+    }
+    num_queue_samples_.store(0,std::memory_order_relaxed);
+    ready_queue_max_.store(0,std::memory_order_relaxed);
+    num_postponed_.store(0,std::memory_order_relaxed);
+    num_prefetch_hits_.store(0,std::memory_order_relaxed);
+    num_prefetch_misses_.store(0,std::memory_order_relaxed);
+    comm_bytes_.store(0,std::memory_order_relaxed);
+    memory_peak_.store(0,std::memory_order_relaxed);
+    idle_nsec_.store(0,std::memory_order_relaxed);
+    spin_nsec_.store(0,std::memory_order_relaxed);
+    time_reset_.store(exatn::Timer::timeInSecHR(),std::memory_order_relaxed);
+    last_queue_sample_.store(0.0,std::memory_order_relaxed);
+    return;
+  }
+
+  /** Records an executed tensor operation (after its finish time stamp has been recorded). **/
+  inline void recordExecuted(const TensorOperation & op,
+                             int device = -1) {
+    const auto opcode = static_cast<unsigned int>(op.getOpcode());
+    const double latency = op.getFinishTime() - op.getStartTime();
+    const auto latency_nsec = (latency > 0.0) ? static_cast<uint64_t>(latency * 1e9) : uint64_t{0};
+    if(opcode < NUM_OPCODES){
+      auto & counters = opcodes_[opcode];
+      counters.count.fetch_add(1,std::memory_order_relaxed);
+      counters.latency_nsec.fetch_add(latency_nsec,std::memory_order_relaxed);
+      counters.histogram[latencyBin(latency_nsec / 1000)].fetch_add(1,std::memory_order_relaxed);
+    }
+    const unsigned int dev = (device >= 0 && device < static_cast<int>(MAX_DEVICES - 1)) ? (device + 1) : 0;
+    auto & counters = devices_[dev];
+    counters.count.fetch_add(1,std::memory_order_relaxed);
+    counters.busy_nsec.fetch_add(latency_nsec,std::memory_order_relaxed);
+    double flops = op.getFlopEstimate();
+    if(flops > 0.0){
+      const auto tensor = op.getTensorOperand(0);
+      if(tensor) flops *= tensorElementTypeOpFactor(tensor->getElementType());
+      auto total = counters.flops.load(std::memory_order_relaxed);
+      while(!counters.flops.compare_exchange_weak(total,total+flops,std::memory_order_relaxed));
+    }
+    if(opcode >= static_cast<unsigned int>(TensorOpCode::FETCH) && opcode < NUM_OPCODES){
+      const auto tensor = op.getTensorOperand(0);
+      if(tensor) comm_bytes_.fetch_add(tensor->getSize(),std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  /** Records the current Host memory buffer usage (bytes) in the peak memory usage. **/
+  inline void recordMemoryUsage(std::size_t used_mem) {
+    auto peak = memory_peak_.load(std::memory_order_relaxed);
+    while(used_mem > peak && !memory_peak_.compare_exchange_weak(peak,used_mem,std::memory_order_relaxed));
+    return;
+  }
+
+  /** Records a TRY_LATER postponement of a tensor operation. **/
+  inline void recordPostponed() {
+    num_postponed_.fetch_add(1,std::memory_order_relaxed);
+    return;
+  }
+
+  /** Records a prefetch hit (TRUE) or miss (FALSE) for an executed tensor operation. **/
+  inline void recordPrefetch(bool hit) {
+    if(hit){
+      num_prefetch_hits_.fetch_add(1,std::memory_order_relaxed);
+    }else{
+      num_prefetch_misses_.fetch_add(1,std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  /** Records the time the execution thread spent idle (sec). **/
+  inline void recordIdleTime(double time_interval) {
+    if(time_interval > 0.0) idle_nsec_.fetch_add(static_cast<uint64_t>(time_interval * 1e9),std::memory_order_relaxed);
+    return;
+  }
+
+  /** Records the time the execution thread spent spinning without progress (sec). **/
+  inline void recordSpinTime(double time_interval) {
+    if(time_interval > 0.0) spin_nsec_.fetch_add(static_cast<uint64_t>(time_interval * 1e9),std::memory_order_relaxed);
+    return;
+  }
+
+  /** Records the current state of the executed DAG (number of DAG nodes and its front node).
+      [THREAD: Must only be called by the execution thread] **/
+  inline void recordDagState(std::size_t num_nodes,
+                             std::size_t front_node) {
+    dag_nodes_.store(num_nodes,std::memory_order_relaxed);
+    dag_front_.store(front_node,std::memory_order_relaxed);
+    return;
+  }
+
+  /** Samples the current ready queue length (at most once per QUEUE_SAMPLE_PERIOD).
+      [THREAD: Must only be called by the execution thread] **/
+  inline void sampleReadyQueue(std::size_t length) {
+    if(length > ready_queue_max_.load(std::memory_order_relaxed)) ready_queue_max_.store(length,std::memory_order_relaxed);
+    const double time_stamp = exatn::Timer::timeInSecHR(time_reset_.load(std::memory_order_relaxed));
+    if(time_stamp - last_queue_sample_.load(std::memory_order_relaxed) >= QUEUE_SAMPLE_PERIOD){
+      last_queue_sample_.store(time_stamp,std::memory_order_relaxed);
+      const auto num_samples = num_queue_samples_.load(std::memory_order_relaxed);
+      auto & sample = queue_samples_[num_samples % NUM_QUEUE_SAMPLES];
+      sample.time.store(time_stamp,std::memory_order_relaxed);
+      sample.length.store(length,std::memory_order_relaxed);
+      num_queue_samples_.store(num_samples + 1,std::memory_order_release);
+    }
+    return;
+  }
+
+  /** Returns a snapshot of all counters (except the data transfer volume
+      which is provided by the node executor). **/
+  RuntimeMetrics getSnapshot() const {
+    RuntimeMetrics metrics;
+    metrics.opcodes.resize(NUM_OPCODES);
+    for(unsigned int i = 0; i < NUM_OPCODES; ++i){
+      const auto & counters = opcodes_[i];
+      auto & stats = metrics.opcodes[i];
+      stats.count = counters.count.load(std::memory_order_relaxed);
+      stats.total_latency = static_cast<double>(counters.latency_nsec.load(std::memory_order_relaxed)) * 1e-9;
+      stats.latency_histogram.resize(NUM_LATENCY_BINS);
+      for(unsigned int j = 0; j < NUM_LATENCY_BINS; ++j){
+        stats.latency_histogram[j] = counters.histogram[j].load(std::memory_order_relaxed);
+      }
+    }
+    for(unsigned int i = 0; i < MAX_DEVICES; ++i){
+      const auto & counters = devices_[i];
+      const auto count = counters.count.load(std::memory_order_relaxed);
+      if(count > 0){
+        RuntimeMetrics::DeviceStats stats;
+        stats.device = static_cast<int>(i) - 1;
+        stats.count = count;
+        stats.flops = counters.flops.load(std::memory_order_relaxed);
+        stats.busy_time = static_cast<double>(counters.busy_nsec.load(std::memory_order_relaxed)) * 1e-9;
+        if(stats.busy_time > 0.0) stats.gflops = stats.flops / stats.busy_time * 1e-9;
+        metrics.devices.emplace_back(stats);
+      }
+    }
+    const auto num_samples = num_queue_samples_.load(std::memory_order_acquire);
+    const auto first = (num_samples > NUM_QUEUE_SAMPLES) ? (num_samples - NUM_QUEUE_SAMPLES) : std::size_t{0};
+    for(auto i = first; i < num_samples; ++i){
+      const auto & sample = queue_samples_[i % NUM_QUEUE_SAMPLES];
+      metrics.ready_queue.emplace_back(std::make_pair(sample.time.load(std::memory_order_relaxed),
+                                                      sample.length.load(std::memory_order_relaxed)));
+    }
+    metrics.ready_queue_max = ready_queue_max_.load(std::memory_order_relaxed);
+    metrics.num_postponed = num_postponed_.load(std::memory_order_relaxed);
+    metrics.num_prefetch_hits = num_prefetch_hits_.load(std::memory_order_relaxed);
+    metrics.num_prefetch_misses = num_prefetch_misses_.load(std::memory_order_relaxed);
+    metrics.comm_bytes = comm_bytes_.load(std::memory_order_relaxed);
+    metrics.memory_peak_bytes = memory_peak_.load(std::memory_order_relaxed);
+    metrics.exec_idle_time = static_cast<double>(idle_nsec_.load(std::memory_order_relaxed)) * 1e-9;
+    metrics.exec_spin_time = static_cast<double>(spin_nsec_.load(std::memory_order_relaxed)) * 1e-9;
+    metrics.elapsed_time = exatn::Timer::timeInSecHR(time_reset_.load(std::memory_order_relaxed));
+    metrics.dag_nodes = dag_nodes_.load(std::memory_order_relaxed);
+    metrics.dag_front = dag_front_.load(std::memory_order_relaxed);
+    if(metrics.elapsed_time > 0.0){
+      for(auto & stats: metrics.devices) stats.utilization = stats.busy_time / metrics.elapsed_time;
+    }
+    return metrics;
+  }
+
+protected:
+
+  /** Returns the power-of-two latency bin for a given latency in microseconds. **/
+  static inline unsigned int latencyBin(uint64_t latency_usec) {
+    unsigned int bin = 0;
+    while(latency_usec > 1 && bin < (NUM_LATENCY_BINS - 1)){latency_usec >>= 1; ++bin;}
+    return bin;
+  }
+
+  struct OpcodeCounters {
+    std::atomic<std::size_t> count;        //number of executed tensor operations
+    std::atomic<uint64_t> latency_nsec;    //total latency (nanoseconds)
+    std::array<std::atomic<std::size_t>,NUM_LATENCY_BINS> histogram; //latency histogram
+  };
+
+  struct DeviceCounters {
+    std::atomic<std::size_t> count;        //number of executed tensor operations
+    std::atomic<double> flops;             //executed flop count
+    std::atomic<uint64_t> busy_nsec;       //accumulated latency (nanoseconds)
+  };
+
+  struct QueueSample {
+    std::atomic<double> time;              //time since reset (sec)
+    std::atomic<std::size_t> length;       //ready queue length
+  };
+
+  std::array<OpcodeCounters,NUM_OPCODES> opcodes_;           //per-opcode counters
+  std::array<DeviceCounters,MAX_DEVICES> devices_;           //per-device counters (entry 0: Host/unknown)
+  std::array<QueueSample,NUM_QUEUE_SAMPLES> queue_samples_;  //ring of ready queue length samples
+  std::atomic<std::size_t> num_queue_samples_;               //total number of ready queue length samples
+  std::atomic<std::size_t> ready_queue_max_;                 //max observed ready queue length
+  std::atomic<std::size_t> num_postponed_;                   //number of TRY_LATER postponements
+  std::atomic<std::size_t> num_prefetch_hits_;               //number of prefetch hits
+  std::atomic<std::size_t> num_prefetch_misses_;             //number of prefetch misses
+  std::atomic<std::size_t> comm_bytes_;                      //inter-process communication volume (bytes)
+  std::atomic<std::size_t> memory_peak_;                     //peak Host memory buffer usage (bytes)
+  std::atomic<uint64_t> idle_nsec_;                          //execution thread idle time (nanoseconds)
+  std::atomic<uint64_t> spin_nsec_;                          //execution thread spin time (nanoseconds)
+  std::atomic<double> time_reset_;                           //time stamp of the last reset (sec)
+  std::atomic<double> last_queue_sample_;                    //time of the last ready queue sample (sec since reset)
+  std::atomic<std::size_t> dag_nodes_;                       //number of nodes in the currently executed DAG
+  std::atomic<std::size_t> dag_front_;                       //front node of the currently executed DAG
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_EXEC_METRICS_HPP_
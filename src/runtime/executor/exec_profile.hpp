@@ -0,0 +1,245 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Roofline profile of executed tensor operations
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) Once activated, the execution profile aggregates the executed tensor operations by their
+     signature {opcode, compute element type, ranks of the tensor operands, execution device}:
+     Count, total/min/max execution time, flop count (flop estimate scaled by the element type
+     operation factor) and bytes (combined size of all tensor operands in the compute precision).
+     Recording takes a lock and only allocates when a new signature is encountered.
+ (b) The profile report is a roofline-style summary: For each signature it lists the achieved
+     arithmetic intensity (flop/byte), GFlop/s and GB/s, as well as the fraction of the attainable
+     performance min(peak_gflops, intensity * peak_gbps) given the peak GFlop/s and GB/s of
+     the execution device, together with the bound (compute or memory) the signature falls under.
+     The peaks are supplied by the user (the fraction of peak is not reported if they are unknown).
+     Signatures are sorted by their total execution time (largest first), thus the underperforming
+     tensor operation shapes which dominate the execution time come first.
+ (c) The execution time of an operation is its latency (from its start to its finish time stamp),
+     thus the achieved performance of concurrently executed tensor operations is a lower bound.
+ (d) The report must not overlap with recording (the tensor runtime writes it after
+     the execution thread has finished executing the DAG of the closed scope).
+**/
+
+#ifndef EXATN_RUNTIME_EXEC_PROFILE_HPP_
+#define EXATN_RUNTIME_EXEC_PROFILE_HPP_
+
+#include "tensor_operation.hpp"
+#include "exec_trace.hpp"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace exatn {
+namespace runtime {
+
+class ExecProfile {
+
+public:
+
+  static constexpr const unsigned int MAX_OPERANDS = 4; //max number of tensor operands in the signature
+
+  /** Peak performance of an execution device (0.0: unknown). **/
+  struct Peak {
+    double gflops = 0.0; //peak GFlop/s
+    double gbps = 0.0;   //peak memory bandwidth (GB/s)
+  };
+
+  ExecProfile(): active_(false) {}
+
+  ExecProfile(const ExecProfile &) = delete;
+  ExecProfile & operator=(const ExecProfile &) = delete;
+  ExecProfile(ExecProfile &&) = delete;
+  ExecProfile & operator=(ExecProfile &&) = delete;
+  ~ExecProfile() = default;
+
+  /** Activates/deactivates profiling with the given peak performance of the Host and accelerators.
+      All previously recorded statistics are discarded. Must not be called while recording. **/
+  void activate(bool active,                 //in: activation status
+                const Peak & host_peak,      //in: peak performance of the Host
+                const Peak & device_peak) {  //in: peak performance of an accelerator
+    std::lock_guard<std::mutex> lock(mtx_);
+    active_.store(false);
+    stats_.clear();
+    host_peak_ = host_peak;
+    device_peak_ = device_peak;
+    active_.store(active);
+    return;
+  }
+
+  /** Returns TRUE if profiling is active. **/
+  inline bool isActive() const {return active_.load(std::memory_order_relaxed);}
+
+  /** Records an executed tensor operation (before its tensor operands are dissociated).
+      [THREAD: Can be called concurrently from multiple executor threads] **/
+  void record(const TensorOperation & op,
+              int device = -1) {
+    if(!isActive()) return;
+    Signature signature;
+    signature.opcode = static_cast<int>(op.getOpcode());
+    signature.device = (device >= 0) ? device : -1;
+    signature.element_type = 0;
+    signature.num_operands = 0;
+    std::fill(signature.ranks,signature.ranks+MAX_OPERANDS,0U);
+    double bytes = 0.0;
+    const auto num_operands = op.getNumOperandsSet();
+    for(unsigned int i = 0; i < num_operands; ++i){
+      const auto tensor = op.getTensorOperand(i);
+      if(tensor){
+        const auto element_type = tensorComputeElementType(tensor->getElementType());
+        if(signature.element_type == 0) signature.element_type = static_cast<int>(element_type);
+        bytes += static_cast<double>(tensor->getVolume()) *
+                 static_cast<double>(numerics::tensor_element_type_size(element_type));
+        if(signature.num_operands < MAX_OPERANDS) signature.ranks[signature.num_operands++] = tensor->getRank();
+      }
+    }
+    double flops = op.getFlopEstimate();
+    if(flops > 0.0) flops *= tensorElementTypeOpFactor(static_cast<TensorElementType>(signature.element_type));
+    const double time = std::max(0.0,op.getFinishTime() - op.getStartTime());
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto & stats = stats_[signature];
+    ++(stats.count);
+    stats.time += time;
+    stats.min_time = std::min(stats.min_time,time);
+    stats.max_time = std::max(stats.max_time,time);
+    stats.flops += flops;
+    stats.bytes += bytes;
+    return;
+  }
+
+  /** Writes the roofline summary of all recorded tensor operations into a text file
+      and clears the statistics. Returns FALSE if the file could not be written. **/
+  bool dumpReport(const std::string & filename, //in: output file name
+                  int process_id) {             //in: process id (global MPI rank)
+    std::lock_guard<std::mutex> lock(mtx_);
+    if(stats_.empty()) return true;
+    std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+    if(!report_file.is_open()) return false;
+    std::vector<std::pair<Signature,Stats>> entries(stats_.cbegin(),stats_.cend());
+    std::sort(entries.begin(),entries.end(),
+              [](const std::pair<Signature,Stats> & entry0, const std::pair<Signature,Stats> & entry1){
+               return entry0.second.time > entry1.second.time;
+              });
+    std::size_t total_count = 0;
+    double total_time = 0.0, total_flops = 0.0;
+    for(const auto & entry: entries){
+      total_count += entry.second.count;
+      total_time += entry.second.time;
+      total_flops += entry.second.flops;
+    }
+    report_file << "#ExecProfile: Process " << process_id << ": Tensor operations = " << total_count
+                << "; Signatures = " << entries.size() << std::scientific << std::setprecision(3)
+                << "; Time = " << total_time << " sec; GFlop = " << (total_flops * 1e-9)
+                << "; Peak GFlop/s, GB/s: Host = " << host_peak_.gflops << ", " << host_peak_.gbps
+                << "; Accelerators = " << device_peak_.gflops << ", " << device_peak_.gbps << std::endl;
+    report_file << std::left << std::setw(18) << "Opcode" << std::setw(6) << "Type"
+                << std::setw(12) << "Ranks" << std::right << std::setw(7) << "Device"
+                << std::setw(10) << "Count" << std::setw(11) << "Time" << std::setw(11) << "MinTime"
+                << std::setw(11) << "MaxTime" << std::setw(11) << "GFlop" << std::setw(11) << "GByte"
+                << std::setw(11) << "Flop/Byte" << std::setw(11) << "GFlop/s" << std::setw(11) << "GB/s"
+                << std::setw(9) << "%Peak" << std::setw(9) << "Bound" << std::endl;
+    for(const auto & entry: entries){
+      const auto & signature = entry.first;
+      const auto & stats = entry.second;
+      std::string ranks;
+      for(unsigned int i = 0; i < signature.num_operands; ++i){
+        if(i > 0) ranks += ":";
+        ranks += std::to_string(signature.ranks[i]);
+      }
+      const double intensity = (stats.bytes > 0.0) ? (stats.flops / stats.bytes) : 0.0;
+      const double gflops = (stats.time > 0.0) ? (stats.flops / stats.time * 1e-9) : 0.0;
+      const double gbps = (stats.time > 0.0) ? (stats.bytes / stats.time * 1e-9) : 0.0;
+      report_file << std::left << std::setw(18) << ExecTrace::opcodeName(signature.opcode)
+                  << std::setw(6) << elementTypeName(signature.element_type)
+                  << std::setw(12) << ranks << std::right << std::setw(7) << signature.device
+                  << std::setw(10) << stats.count << std::scientific << std::setprecision(3)
+                  << std::setw(11) << stats.time << std::setw(11) << stats.min_time
+                  << std::setw(11) << stats.max_time << std::setw(11) << (stats.flops * 1e-9)
+                  << std::setw(11) << (stats.bytes * 1e-9) << std::setw(11) << intensity
+                  << std::setw(11) << gflops << std::setw(11) << gbps;
+      const auto & peak = (signature.device >= 0) ? device_peak_ : host_peak_;
+      const double attainable = std::min(peak.gflops,intensity * peak.gbps);
+      if(stats.flops > 0.0 && attainable > 0.0){
+        report_file << std::fixed << std::setprecision(1) << std::setw(9) << (gflops / attainable * 1e2)
+                    << std::setw(9) << ((intensity * peak.gbps < peak.gflops) ? "memory" : "compute");
+      }else{
+        report_file << std::setw(9) << "-" << std::setw(9) << "-";
+      }
+      report_file << std::endl;
+    }
+    report_file.close();
+    stats_.clear();
+    return true;
+  }
+
+protected:
+
+  struct Signature {
+    int opcode;                         //tensor operation code
+    int device;                         //execution device (-1: Host or unknown)
+    int element_type;                   //compute element type of the first tensor operand
+    unsigned int num_operands;          //number of tensor operands
+    unsigned int ranks[MAX_OPERANDS];   //tensor operand ranks
+
+    bool operator==(const Signature & another) const {
+      return opcode == another.opcode && device == another.device &&
+             element_type == another.element_type && num_operands == another.num_operands &&
+             std::equal(ranks,ranks+MAX_OPERANDS,another.ranks);
+    }
+  };
+
+  struct SignatureHash {
+    std::size_t operator()(const Signature & signature) const {
+      std::size_t seed = static_cast<std::size_t>(signature.opcode);
+      auto combine = [&seed](std::size_t value){seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);};
+      combine(static_cast<std::size_t>(signature.device + 1));
+      combine(static_cast<std::size_t>(signature.element_type));
+      for(unsigned int i = 0; i < signature.num_operands; ++i) combine(signature.ranks[i]);
+      return seed;
+    }
+  };
+
+  struct Stats {
+    std::size_t count = 0; //number of executed tensor operations
+    double time = 0.0;     //total execution time (sec)
+    double min_time = std::numeric_limits<double>::max(); //min execution time (sec)
+    double max_time = 0.0; //max execution time (sec)
+    double flops = 0.0;    //total flop count (estimate)
+    double bytes = 0.0;    //total size of the tensor operands (bytes)
+  };
+
+  /** Returns the printable name of a tensor element type. **/
+  static const char * elementTypeName(int element_type) {
+    static const char * const names[] = {"VOID","R16","R32","R64","C16","C32","C64"};
+    switch(static_cast<TensorElementType>(element_type)){
+    case TensorElementType::REAL16: return names[1];
+    case TensorElementType::REAL32: return names[2];
+    case TensorElementType::REAL64: return names[3];
+    case TensorElementType::COMPLEX16: return names[4];
+    case TensorElementType::COMPLEX32: return names[5];
+    case TensorElementType::COMPLEX64: return names[6];
+    default: break;
+    }
+    return names[0];
+  }
+
+  std::unordered_map<Signature,Stats,SignatureHash> stats_; //aggregated statistics per signature
+  Peak host_peak_;          //peak performance of the Host
+  Peak device_peak_;        //peak performance of an accelerator
+  std::mutex mtx_;          //protects the statistics
+  std::atomic<bool> active_; //profiling activation status
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_EXEC_PROFILE_HPP_
@@ -0,0 +1,216 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Structured execution trace
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The execution trace buffers fixed-size (POD) per-operation events in a ring
+     preallocated at activation. Recording an event neither allocates nor performs
+     any stream I/O, thus it is safe to record from the execution (worker) threads.
+     Once the ring is full, the oldest events are overwritten (and counted as dropped).
+ (b) Each event carries the opcode, the DAG node id, the names of (up to MAX_OPERANDS)
+     tensor operands, the execution device (-1 if unknown/Host), the bytes moved
+     (combined size of all tensor operands), the flop estimate and the event kind:
+     EXECUTED (complete event with start/finish time stamps), POSTPONED (TRY_LATER)
+     or PREFETCH (both are instant events).
+ (c) The recorded events are dumped as a Chrome trace JSON file (chrome://tracing, Perfetto UI)
+     with pid = global MPI rank and tid = executor thread. Time stamps are absolute
+     (since the clock epoch), thus trace files from different MPI processes can be
+     loaded together and aligned on a single timeline.
+ (d) Dumping must not overlap with recording (the tensor runtime dumps the trace
+     after the execution thread has finished executing the DAG of the closed scope).
+**/
+
+#ifndef EXATN_RUNTIME_EXEC_TRACE_HPP_
+#define EXATN_RUNTIME_EXEC_TRACE_HPP_
+
+#include "tensor_operation.hpp"
+#include "tensor_exec_state.hpp"
+
+#include "timers.hpp"
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+
+namespace exatn {
+namespace runtime {
+
+class ExecTrace {
+
+public:
+
+  static constexpr const std::size_t DEFAULT_CAPACITY = 65536; //default number of events in the ring
+  static constexpr const unsigned int MAX_OPERANDS = 3;        //max number of traced tensor operands per event
+  static constexpr const std::size_t OPERAND_NAME_LEN = 32;    //max traced tensor operand name length (including '\0')
+
+  enum class EventKind: int {
+    EXECUTED,  //tensor operation has been executed
+    POSTPONED, //tensor operation has been postponed (TRY_LATER)
+    PREFETCH   //tensor operand prefetch has been initiated for the tensor operation
+  };
+
+  struct Event {
+    double start;        //start time stamp (sec)
+    double finish;       //finish time stamp (sec)
+    double flops;        //flop estimate
+    double bytes;        //combined size of all tensor operands (bytes)
+    VertexIdType node;   //DAG node id
+    EventKind kind;      //event kind
+    int opcode;          //tensor operation code
+    int device;          //execution device (-1: unknown/Host)
+    unsigned int thread; //executor thread (0: execution thread)
+    unsigned int num_operands; //number of traced tensor operands
+    char operands[MAX_OPERANDS][OPERAND_NAME_LEN]; //tensor operand names (truncated)
+  };
+
+  ExecTrace(): num_recorded_(0), active_(false) {}
+
+  ExecTrace(const ExecTrace &) = delete;
+  ExecTrace & operator=(const ExecTrace &) = delete;
+  ExecTrace(ExecTrace &&) = delete;
+  ExecTrace & operator=(ExecTrace &&) = delete;
+  ~ExecTrace() = default;
+
+  /** Activates tracing with a preallocated ring of a given capacity (events),
+      or deactivates it (capacity = 0). All previously recorded events are discarded.
+      Must not be called while events are being recorded. **/
+  void activate(std::size_t capacity) {
+    active_.store(false);
+    ring_.clear();
+    ring_.shrink_to_fit();
+    ring_.resize(capacity);
+    num_recorded_.store(0);
+    active_.store(capacity > 0);
+    return;
+  }
+
+  /** Returns TRUE if tracing is active. **/
+  inline bool isActive() const {return active_.load(std::memory_order_relaxed);}
+
+  /** Records an event for a given tensor operation (before its tensor operands are dissociated).
+      [THREAD: Can be called concurrently from multiple executor threads] **/
+  void record(EventKind kind,
+              const TensorOperation & op,
+              VertexIdType node_id,
+              int device = -1,
+              unsigned int thread = 0) {
+    if(!isActive()) return;
+    const auto slot = num_recorded_.fetch_add(1,std::memory_order_relaxed) % ring_.size();
+    auto & event = ring_[slot];
+    event.kind = kind;
+    event.node = node_id;
+    event.opcode = static_cast<int>(op.getOpcode());
+    event.device = device;
+    event.thread = thread;
+    if(kind == EventKind::EXECUTED){
+      event.start = op.getStartTime();
+      event.finish = op.getFinishTime();
+    }else{
+      event.start = exatn::Timer::timeInSecHR();
+      event.finish = event.start;
+    }
+    event.flops = op.getFlopEstimate();
+    event.bytes = 0.0;
+    event.num_operands = 0;
+    const auto num_operands = op.getNumOperandsSet();
+    for(unsigned int i = 0; i < num_operands; ++i){
+      const auto tensor = op.getTensorOperand(i);
+      if(tensor){
+        event.bytes += static_cast<double>(tensor->getVolume()) *
+                       static_cast<double>(numerics::tensor_element_type_size(tensorComputeElementType(tensor->getElementType())));
+        if(event.num_operands < MAX_OPERANDS){
+          std::strncpy(event.operands[event.num_operands],tensor->getName().c_str(),OPERAND_NAME_LEN-1);
+          event.operands[event.num_operands][OPERAND_NAME_LEN-1] = '\0';
+          ++(event.num_operands);
+        }
+      }
+    }
+    return;
+  }
+
+  /** Returns the number of events currently held in the ring. **/
+  std::size_t getNumEvents() const {
+    return std::min(num_recorded_.load(),ring_.size());
+  }
+
+  /** Returns the number of events overwritten due to the ring overflow. **/
+  std::size_t getNumDropped() const {
+    const auto num_recorded = num_recorded_.load();
+    return (num_recorded > ring_.size()) ? (num_recorded - ring_.size()) : 0;
+  }
+
+  /** Dumps all recorded events into a Chrome trace JSON file and clears the ring.
+      Returns FALSE if the file could not be written. **/
+  bool dumpChromeTrace(const std::string & filename, //in: output file name
+                       int process_id) {             //in: process id (global MPI rank)
+    const auto num_recorded = num_recorded_.load();
+    if(num_recorded == 0) return true;
+    std::ofstream trace_file(filename,std::ios::out|std::ios::trunc);
+    if(!trace_file.is_open()) return false;
+    const auto num_events = getNumEvents();
+    const auto first = num_recorded - num_events; //oldest retained event
+    trace_file << "{\"traceEvents\":[" << std::endl;
+    trace_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << process_id
+               << ",\"args\":{\"name\":\"Rank " << process_id << "\"}}";
+    trace_file << std::fixed << std::setprecision(3);
+    for(std::size_t i = first; i < num_recorded; ++i){
+      const auto & event = ring_[i % ring_.size()];
+      trace_file << "," << std::endl << "{\"name\":\"" << opcodeName(event.opcode);
+      switch(event.kind){
+      case EventKind::EXECUTED:
+        trace_file << "\",\"cat\":\"exec\",\"ph\":\"X\",\"ts\":" << (event.start * 1e6)
+                   << ",\"dur\":" << ((event.finish - event.start) * 1e6);
+        break;
+      case EventKind::POSTPONED:
+        trace_file << "\",\"cat\":\"try_later\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << (event.start * 1e6);
+        break;
+      case EventKind::PREFETCH:
+        trace_file << "\",\"cat\":\"prefetch\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << (event.start * 1e6);
+        break;
+      }
+      trace_file << ",\"pid\":" << process_id << ",\"tid\":" << event.thread
+                 << ",\"args\":{\"node\":" << event.node << ",\"device\":" << event.device
+                 << ",\"flops\":" << event.flops << ",\"bytes\":" << event.bytes << ",\"operands\":[";
+      for(unsigned int j = 0; j < event.num_operands; ++j){
+        if(j > 0) trace_file << ",";
+        trace_file << "\"";
+        for(const char * c = event.operands[j]; *c != '\0'; ++c){
+          if(*c == '"' || *c == '\\') trace_file << '\\';
+          trace_file << *c;
+        }
+        trace_file << "\"";
+      }
+      trace_file << "]}}";
+    }
+    trace_file << std::endl << "],\"otherData\":{\"dropped_events\":" << getNumDropped() << "}}" << std::endl;
+    trace_file.close();
+    num_recorded_.store(0);
+    return true;
+  }
+
+  /** Returns the printable name of a tensor operation code. **/
+  static const char * opcodeName(int opcode) {
+    static const char * const names[] = {"NOOP","CREATE","DESTROY","TRANSFORM","SLICE","INSERT",
+     "ADD","CONTRACT","DECOMPOSE_SVD3","DECOMPOSE_SVD2","ORTHOGONALIZE_SVD","ORTHOGONALIZE_MGS",
+     "FETCH","UPLOAD","BROADCAST","ALLREDUCE"};
+    if(opcode >= 0 && opcode < static_cast<int>(sizeof(names)/sizeof(names[0]))) return names[opcode];
+    return "UNKNOWN";
+  }
+
+protected:
+
+  std::vector<Event> ring_;                //preallocated ring of events
+  std::atomic<std::size_t> num_recorded_;  //total number of recorded events (since the last dump)
+  std::atomic<bool> active_;               //tracing activation status
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_EXEC_TRACE_HPP_
@@ -1,5 +1,6 @@
 #include "graph_executor_eager.hpp"
 #include "graph_executor_lazy.hpp"
+#include "graph_executor_parallel.hpp"
 #include "node_executor_exatensor.hpp"
 #include "node_executor_talsh.hpp"
 
@@ -31,6 +32,9 @@ public:
     context.RegisterService<exatn::runtime::TensorGraphExecutor>(
       std::make_shared<exatn::runtime::LazyGraphExecutor>()
     );
+    context.RegisterService<exatn::runtime::TensorGraphExecutor>(
+      std::make_shared<exatn::runtime::ParallelGraphExecutor>()
+    );
 
     //Activate tensor graph (DAG) node executors:
     context.RegisterService<exatn::runtime::TensorNodeExecutor>(
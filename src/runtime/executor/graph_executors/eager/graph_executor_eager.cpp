@@ -1,14 +1,15 @@
 /** ExaTN:: Tensor Runtime: Tensor graph executor: Eager
-REVISION: 2021/12/22
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Tiffany Mintz, Dmitry Lyakh, Alex McCaskey
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Tiffany Mintz, Dmitry Lyakh, Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 **/
 
 #include "graph_executor_eager.hpp"
 
 #include "talshxx.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -17,13 +18,84 @@ Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
 namespace exatn {
 namespace runtime {
 
+void EagerGraphExecutor::resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> node_executor,
+                                           const ParamConf & parameters,
+                                           unsigned int num_processes,
+                                           unsigned int process_rank,
+                                           unsigned int global_process_rank)
+{
+  TensorGraphExecutor::resetNodeExecutor(node_executor,parameters,num_processes,process_rank,global_process_rank);
+  int64_t depth = 0;
+  if(parameters.getParameter("dag_executor_issue_window",&depth)){
+    if(depth > 0) issue_window_ = static_cast<unsigned int>(depth);
+  }
+  if(parameters.getParameter("dag_executor_prefetch_depth",&depth)){
+    if(depth >= 0) prefetch_depth_ = static_cast<unsigned int>(depth);
+  }
+  return;
+}
+
+
+bool EagerGraphExecutor::retireOldest(TensorGraph & dag,
+                                      std::deque<InFlightNode> & in_flight,
+                                      bool wait)
+{
+  assert(!in_flight.empty());
+  const auto entry = in_flight.front();
+  int error_code = 0;
+  auto synced = node_executor_->sync(entry.exec_handle,&error_code,wait);
+  if(!synced && !wait && error_code == 0) return false; //still executing
+  auto & dag_node = dag.getNodeProperties(entry.node);
+  auto op = dag_node.getOperation();
+  op->recordFinishTime();
+  if(synced && error_code == 0){
+    recordNodeExecuted(dag_node,entry.node,entry.device);
+    dag.setNodeExecuted(entry.node);
+    if(logging_.load() != 0){
+      logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+               << "](EagerGraphExecutor)[EXEC_THREAD]: Synced tensor operation "
+               << entry.node << ": Success" << std::endl; //debug
+      //logfile_.flush();
+    }
+    dag.progressFrontNode(entry.node);
+    in_flight.pop_front();
+    return true;
+  }
+  //Failed to synchronize the submitted tensor operation:
+  node_executor_->discard(entry.exec_handle);
+  if(error_code != 0) dag.setNodeExecuted(entry.node,error_code);
+  if(logging_.load() != 0){
+    logfile_ << "Failed to synchronize tensor operation " << entry.node << ": Error " << error_code << std::endl;
+    //logfile_.flush();
+  }
+  std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorEager): Failed to synchronize tensor operation: Error "
+            << error_code << std::endl << std::flush;
+  assert(false);
+  return false;
+}
+
+
 void EagerGraphExecutor::execute(TensorGraph & dag) {
+  const unsigned int window = serialize_.load() ? 1 : std::max(issue_window_,1U); //in-order issue window (b)
+  std::deque<InFlightNode> in_flight; //issued DAG nodes in flight (in issue order)
   auto num_nodes = dag.getNumNodes();
   auto current = dag.getFrontNode();
+  auto prefetched = current; //DAG nodes before this one have been considered for prefetching (c)
   while(current < num_nodes){
     TensorOpExecHandle exec_handle;
     auto & dag_node = dag.getNodeProperties(current);
     if(!(dag_node.isExecuted())){
+      //Retire the completed DAG nodes in flight, then wait on the oldest ones
+      //until the window has a free slot, the current DAG node is dependency-free
+      //and it holds the accumulation lock (commutative accumulations only):
+      while(!(in_flight.empty()) && retireOldest(dag,in_flight,false));
+      while(!(in_flight.empty()) && (in_flight.size() >= window || !(dag.nodeDependenciesResolved(current))
+                                     || !(dag.tryAcquireAccumulation(current)))){
+        retireOldest(dag,in_flight,true);
+      }
+      if(in_flight.empty()){ //no other accumulation can be in flight
+        auto acquired = dag.tryAcquireAccumulation(current); assert(acquired);
+      }
       dag.setNodeExecuting(current);
       auto op = dag_node.getOperation();
       if(logging_.load() != 0){
@@ -38,37 +110,29 @@ void EagerGraphExecutor::execute(TensorGraph & dag) {
       op->recordStartTime();
       auto error_code = op->accept(*node_executor_,&exec_handle);
       if(logging_.load() != 0){
-        logfile_ << ": Status = " << error_code << ": "; //debug
+        logfile_ << ": Status = " << error_code << std::endl; //debug
       }
       if(error_code == 0){
-        if(logging_.load() != 0){
-          logfile_ << "Syncing ... "; //debug
-        }
-        auto synced = node_executor_->sync(exec_handle,&error_code,true);
-        op->recordFinishTime();
-        if(synced && error_code == 0){
-          dag.setNodeExecuted(current);
-          if(logging_.load() != 0){
-            logfile_ << "Success [" << std::fixed << std::setprecision(6)
-                     << exatn::Timer::timeInSecHR(getTimeStampStart()) << "]" << std::endl; //debug
-            //logfile_.flush();
+        const int device = node_executor_->getExecutionDevice(exec_handle);
+        in_flight.emplace_back(InFlightNode{current,exec_handle,device});
+        if(in_flight.size() >= window){ //window is full (window = 1: synchronous execution)
+          retireOldest(dag,in_flight,true);
+        }else if(prefetch_depth_ > 0){ //prefetch the tensor operands of the following DAG nodes (c)
+          prefetched = std::max(prefetched,current + 1);
+          while(prefetched < num_nodes && prefetched <= current + prefetch_depth_){
+            auto & next_node = dag.getNodeProperties(prefetched);
+            if(next_node.isIdle()){
+              auto prefetching = node_executor_->prefetch(*(next_node.getOperation()));
+              recordNodePrefetch(next_node,prefetched,prefetching);
+            }
+            ++prefetched;
           }
-          dag.progressFrontNode(current);
-          ++current;
-        }else{ //failed to synchronize the submitted tensor operation
-          node_executor_->discard(exec_handle);
-          if(error_code != 0) dag.setNodeExecuted(current,error_code);
-          if(logging_.load() != 0){
-            logfile_ << "Failed to synchronize tensor operation: Error " << error_code << std::endl;
-            //logfile_.flush();
-          }
-          std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorEager): Failed to synchronize tensor operation: Error "
-                    << error_code << std::endl << std::flush;
-          assert(false);
         }
+        ++current;
       }else{ //failed to submit the tensor operation
         node_executor_->discard(exec_handle);
         dag.setNodeIdle(current);
+        recordNodePostponed(dag_node,current);
         if(error_code != TRY_LATER && error_code != DEVICE_UNABLE){
          std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorEager): Failed to submit tensor operation: Error "
                    << error_code << std::endl << std::flush;
@@ -78,11 +142,19 @@ void EagerGraphExecutor::execute(TensorGraph & dag) {
           logfile_ << "Will retry again" << std::endl; //debug
           //logfile_.flush();
         }
+        if(!(in_flight.empty())) retireOldest(dag,in_flight,true); //release the resources held by the oldest DAG node in flight
       }
     }else{
       ++current;
     }
+    dag.drainStagedOperations(); //append newly submitted tensor operations into the DAG
+    dag.applyCancellations(); //cancel the requested idle DAG nodes
     num_nodes = dag.getNumNodes();
+    if(current >= num_nodes){ //drain the issue window before returning
+      while(!(in_flight.empty())) retireOldest(dag,in_flight,true);
+      dag.drainStagedOperations();
+      num_nodes = dag.getNumNodes();
+    }
   }
   return;
 }
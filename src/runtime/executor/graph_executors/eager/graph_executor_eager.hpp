@@ -1,11 +1,24 @@
 /** ExaTN:: Tensor Runtime: Tensor graph executor: Eager
-REVISION: 2021/12/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Tiffany Mintz, Dmitry Lyakh, Alex McCaskey
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Tiffany Mintz, Dmitry Lyakh, Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
-
+ (a) The eager graph executor issues the DAG nodes strictly in their order in the DAG,
+     thus the order of execution is deterministic (debugging-sensitive runs).
+ (b) In-order issue window: Up to K issued DAG nodes may be in flight (executing asynchronously),
+     K being set via the "dag_executor_issue_window" runtime parameter (default 1: each issued
+     DAG node is synchronized before the next one is issued). Before a DAG node is issued,
+     the DAG nodes in flight are synchronized in their issue order (oldest first) until all
+     its dependencies are resolved and the window has a free slot; completed DAG nodes
+     are retired in their issue order as well, thus the DAG front node progresses in order.
+     Commutative accumulations into the same tensor carry no mutual dependencies, thus
+     a commutative accumulation is only issued once it holds the accumulation lock
+     on its output tensor (no other accumulation into it is in flight).
+ (c) With an issue window K > 1, the tensor operands of the DAG nodes following the current one
+     are prefetched up to the prefetch depth ("dag_executor_prefetch_depth" runtime parameter).
+     Serialized execution (resetSerialization) enforces K = 1.
 **/
 
 #ifndef EXATN_RUNTIME_EAGER_GRAPH_EXECUTOR_HPP_
@@ -13,6 +26,8 @@ Rationale:
 
 #include "tensor_graph_executor.hpp"
 
+#include <deque>
+
 namespace exatn {
 namespace runtime {
 
@@ -20,6 +35,11 @@ class EagerGraphExecutor : public TensorGraphExecutor {
 
 public:
 
+  static constexpr const unsigned int DEFAULT_ISSUE_WINDOW = 1;   //max number of issued DAG nodes in flight (b)
+  static constexpr const unsigned int DEFAULT_PREFETCH_DEPTH = 1; //number of DAG nodes ahead of the current one to prefetch (c)
+
+  EagerGraphExecutor(): issue_window_(DEFAULT_ISSUE_WINDOW), prefetch_depth_(DEFAULT_PREFETCH_DEPTH) {}
+
   //EagerGraphExecutor(const EagerGraphExecutor &) = delete;
   //EagerGraphExecutor & operator=(const EagerGraphExecutor &) = delete;
   //EagerGraphExecutor(EagerGraphExecutor &&) = delete;
@@ -27,6 +47,13 @@ public:
 
   virtual ~EagerGraphExecutor() = default;
 
+  /** Sets/resets the DAG node executor (tensor operation executor). **/
+  virtual void resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> node_executor,
+                                 const ParamConf & parameters,
+                                 unsigned int num_processes,
+                                 unsigned int process_rank,
+                                 unsigned int global_process_rank) override;
+
   /** Traverses the DAG and executes all its nodes. **/
   virtual void execute(TensorGraph & dag) override;
 
@@ -35,12 +62,41 @@ public:
 
   /** Regulates the tensor prefetch depth (0 turns prefetch off). **/
   virtual void setPrefetchDepth(unsigned int depth) override {
+    prefetch_depth_ = depth;
     return;
   }
 
+  /** Returns the current prefetch depth. **/
+  inline unsigned int getPrefetchDepth() const {
+    return prefetch_depth_;
+  }
+
+  /** Returns the in-order issue window (max number of issued DAG nodes in flight). **/
+  inline unsigned int getIssueWindow() const {
+    return issue_window_;
+  }
+
   const std::string name() const override {return "eager-dag-executor";}
   const std::string description() const override {return "Eager tensor graph executor";}
   std::shared_ptr<TensorGraphExecutor> clone() override {return std::make_shared<EagerGraphExecutor>();}
+
+protected:
+
+  /** Issued DAG node in flight **/
+  struct InFlightNode {
+    VertexIdType node;              //DAG node id
+    TensorOpExecHandle exec_handle; //execution handle of its tensor operation
+    int device;                     //execution device
+  };
+
+  /** Synchronizes (wait = TRUE) or tests for completion (wait = FALSE) the oldest DAG node
+      in flight and retires it if completed. Returns TRUE if it has been retired. **/
+  bool retireOldest(TensorGraph & dag,
+                    std::deque<InFlightNode> & in_flight,
+                    bool wait);
+
+  unsigned int issue_window_;   //max number of issued DAG nodes in flight (b)
+  unsigned int prefetch_depth_; //prefetch depth (c)
 };
 
 } //namespace runtime
@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Tensor graph executor: Lazy
-REVISION: 2022/01/17
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -13,8 +13,10 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 #include "cuquantum_executor.hpp"
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 #include "errors.hpp"
 
@@ -32,7 +34,50 @@ void LazyGraphExecutor::resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> no
                                           unsigned int global_process_rank)
 {
   TensorGraphExecutor::resetNodeExecutor(node_executor,parameters,num_processes,process_rank,global_process_rank);
+  std::string scheduling;
+  if(parameters.getParameter("dag_executor_scheduling",scheduling)){
+    if(scheduling == "critical_path"){
+      critical_path_ = true;
+    }else if(scheduling == "fifo"){
+      critical_path_ = false;
+    }else{
+      std::cout << "#ERROR(exatn::runtime::LazyGraphExecutor): Unknown DAG scheduling policy: "
+                << scheduling << std::endl << std::flush;
+      assert(false);
+    }
+  }
+  int64_t depth = 0;
+  if(parameters.getParameter("dag_executor_pipeline_depth",&depth)){
+    if(depth > 0){
+      pipeline_depth_ = static_cast<unsigned int>(depth);
+      pipeline_depth_fixed_ = true;
+    }
+  }
+  if(parameters.getParameter("dag_executor_prefetch_depth",&depth)){
+    if(depth >= 0){
+      prefetch_depth_ = static_cast<unsigned int>(depth);
+      prefetch_depth_fixed_ = true;
+    }
+  }
+  if(parameters.getParameter("dag_executor_remote_prefetch_depth",&depth)){
+    if(depth >= 0) remote_prefetch_depth_ = static_cast<unsigned int>(depth);
+  }
+  if(parameters.getParameter("dag_executor_lookahead_window",&depth)){
+    if(depth >= 0) lookahead_window_ = static_cast<unsigned int>(depth);
+  }
+  int64_t autotune = 0;
+  if(parameters.getParameter("dag_executor_autotune",&autotune)) autotune_ = (autotune != 0);
+  int64_t memory_admission = 0;
+  if(parameters.getParameter("dag_executor_memory_admission",&memory_admission)) memory_admission_ = (memory_admission != 0);
+  memory_reserved_ = 0;
+  reservations_.clear();
 #ifdef CUQUANTUM
+  std::string plan_cache_dir;
+  parameters.getParameter("cuquantum_plan_cache_directory",plan_cache_dir);
+  int64_t cuquantum_depth = 0;
+  if(parameters.getParameter("cuquantum_pipeline_depth",&cuquantum_depth)){
+    if(cuquantum_depth > 0) cuquantum_pipe_depth_ = static_cast<unsigned int>(cuquantum_depth);
+  }
   if(node_executor){
     cuquantum_executor_ = std::make_shared<CuQuantumExecutor>(
       [this](const numerics::Tensor & tensor, int device_kind, int device_id, std::size_t * size){
@@ -41,7 +86,8 @@ void LazyGraphExecutor::resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> no
       },
       cuquantum_pipe_depth_,
       num_processes,
-      process_rank
+      process_rank,
+      plan_cache_dir
     );
   }
 #endif
@@ -57,11 +103,15 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
     VertexIdType current;   //the current node in the DAG
   };
 
+  dag.activatePriorities(critical_path_);
+
   Progress progress{dag.getNumNodes(),dag.getFrontNode(),0};
   progress.current = progress.front;
 
   auto find_next_idle_node = [this,&dag,&progress] () {
     const auto prev_node = progress.current;
+    dag.drainStagedOperations(); //append newly submitted tensor operations into the DAG
+    dag.applyCancellations(); //cancel the requested idle DAG nodes
     progress.front = dag.getFrontNode();
     progress.num_nodes = dag.getNumNodes();
     if(progress.front < progress.num_nodes){
@@ -95,11 +145,23 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
         ready_for_execution = ready_for_execution && dag.nodeDependenciesResolved(progress.current);
         if(ready_for_execution){ //all node dependencies resolved (or none)
           auto registered = dag.registerDependencyFreeNode(progress.current);
-          if(registered && logging_.load() > 1) logfile_ << "DAG node detected with all dependencies resolved: " << progress.current << std::endl;
+          if(registered && logging_.load() > 1){
+            if(exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::NODE_READY,0.0,progress.current);
+            }else{
+              logfile_ << "DAG node detected with all dependencies resolved: " << progress.current << std::endl;
+            }
+          }
         }else{ //node still has unresolved dependencies, try prefetching
-          if(progress.current < (progress.front + this->getPrefetchDepth())){
+          auto prefetch_depth = this->getPrefetchDepth();
+          if(dag_node.getOperation()->getOpcode() == TensorOpCode::FETCH) //remote prefetch (h)
+            prefetch_depth = std::max(prefetch_depth,this->getRemotePrefetchDepth());
+          if(progress.current < (progress.front + prefetch_depth)){
             auto prefetching = this->node_executor_->prefetch(*(dag_node.getOperation()));
-            if(logging_.load() != 0 && prefetching){
+            recordNodePrefetch(dag_node,progress.current,prefetching);
+            if(logging_.load() != 0 && prefetching && exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::PREFETCH,exatn::Timer::timeInSecHR(getTimeStampStart()),progress.current);
+            }else if(logging_.load() != 0 && prefetching){
               logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                        << "](LazyGraphExecutor)[EXEC_THREAD]: Initiated prefetch for tensor operation "
                        << progress.current << std::endl;
@@ -114,19 +176,35 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
     return ready_for_execution;
   };
 
-  auto issue_ready_node = [this,&dag,&progress] () {
+  auto & stats = autotune_stats_;
+
+  auto issue_ready_node = [this,&dag,&progress,&stats] () {
     if(logging_.load() > 2){
-      logfile_ << "DAG current list of dependency free nodes:";
       auto free_nodes = dag.getDependencyFreeNodes();
-      for(const auto & node: free_nodes) logfile_ << " " << node;
-      logfile_ << std::endl;
+      if(exec_log_.isActive()){
+        exec_log_.recordNodes(ExecLog::NodeList::CURRENT,free_nodes);
+      }else{
+        logfile_ << "DAG current list of dependency free nodes:";
+        for(const auto & node: free_nodes) logfile_ << " " << node;
+        logfile_ << std::endl;
+      }
     }
     VertexIdType node;
-    bool issued = dag.extractDependencyFreeNode(&node);
+    std::size_t footprint = 0;
+    bool issued = extractAdmissibleNode(dag,&node,&footprint);
     if(issued){
       auto & dag_node = dag.getNodeProperties(node);
       auto op = dag_node.getOperation();
-      if(logging_.load() != 0){
+      if(logging_.load() != 0 && exec_log_.isActive()){
+        exec_log_.record(ExecLog::EventKind::SUBMIT,exatn::Timer::timeInSecHR(getTimeStampStart()),node,0,0,
+                         static_cast<int>(op->getOpcode()));
+        if(logging_.load() > 1){ //the details are formatted in memory (no stream I/O)
+          log_text_.str("");
+          log_text_ << ": Details:" << std::endl;
+          op->printItFile(log_text_);
+          exec_log_.recordText(log_text_.str());
+        }
+      }else if(logging_.load() != 0){
         logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                  << "](LazyGraphExecutor)[EXEC_THREAD]: Submitting tensor operation "
                  << node << ": Opcode = " << static_cast<int>(op->getOpcode());
@@ -142,15 +220,35 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
       op->recordStartTime();
       TensorOpExecHandle exec_handle;
       auto error_code = op->accept(*(this->node_executor_),&exec_handle);
-      if(logging_.load() != 0) logfile_ << ": Status = " << error_code;
+      if(logging_.load() != 0){
+        if(exec_log_.isActive()){
+          exec_log_.record(ExecLog::EventKind::STATUS,0.0,0,0,0,error_code);
+        }else{
+          logfile_ << ": Status = " << error_code;
+        }
+      }
       if(error_code == 0){ //tensor operation submitted for execution successfully
-        if(logging_.load() != 0) logfile_ << ": Syncing ... ";
+        ++(stats.issued);
+        if(logging_.load() != 0){
+          if(exec_log_.isActive()){
+            exec_log_.record(ExecLog::EventKind::SYNCING);
+          }else{
+            logfile_ << ": Syncing ... ";
+          }
+        }
+        const int device = this->node_executor_->getExecutionDevice(exec_handle);
         auto synced = this->node_executor_->sync(exec_handle,&error_code,serialize_.load());
         if(synced){ //tensor operation has completed immediately
           op->recordFinishTime();
+          if(error_code == 0) recordNodeExecuted(dag_node,node,device);
           dag.setNodeExecuted(node,error_code);
           if(error_code == 0){
-            if(logging_.load() != 0){
+            if(logging_.load() != 0 && exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::SUCCESS,exatn::Timer::timeInSecHR(getTimeStampStart()));
+              std::size_t free_mem = 0;
+              std::size_t used_mem = this->node_executor_->getMemoryUsage(&free_mem);
+              exec_log_.recordMemory(exatn::Timer::timeInSecHR(getTimeStampStart()),getTotalFlopCount(),used_mem,free_mem);
+            }else if(logging_.load() != 0){
               logfile_ << "Success [" << std::fixed << std::setprecision(6)
                        << exatn::Timer::timeInSecHR(getTimeStampStart()) << "]" << std::endl;
               std::size_t free_mem = 0;
@@ -173,10 +271,19 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
                 progress.front = dag.getFrontNode();
               }
             }
-            if(progressed && logging_.load() > 1) logfile_ << "DAG front node progressed to "
-              << progress.front << " out of total of " << progress.num_nodes << std::endl;
+            if(progressed && logging_.load() > 1){
+              if(exec_log_.isActive()){
+                exec_log_.record(ExecLog::EventKind::FRONT,0.0,progress.front,progress.num_nodes);
+              }else{
+                logfile_ << "DAG front node progressed to "
+                         << progress.front << " out of total of " << progress.num_nodes << std::endl;
+              }
+            }
           }else{
-            if(logging_.load() != 0){
+            if(logging_.load() != 0 && exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::FAILED,exatn::Timer::timeInSecHR(getTimeStampStart()),0,0,0,error_code);
+              exec_log_.flush();
+            }else if(logging_.load() != 0){
               logfile_ << "Failed: Error " << error_code << " [" << std::fixed << std::setprecision(6)
                        << exatn::Timer::timeInSecHR(getTimeStampStart()) << "]" << std::endl;
               logfile_.flush();
@@ -186,8 +293,15 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
             assert(false); //`Do I need to handle this case gracefully?
           }
         }else{ //tensor operation is still executing asynchronously
+          reserveMemory(*op,footprint);
           dag.registerExecutingNode(node,exec_handle);
-          if(logging_.load() != 0) logfile_ << "Deferred" << std::endl;
+          if(logging_.load() != 0){
+            if(exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::DEFERRED);
+            }else{
+              logfile_ << "Deferred" << std::endl;
+            }
+          }
         }
       }else{ //tensor operation not submitted due to either temporary resource shortage or fatal error
         auto discarded = this->node_executor_->discard(exec_handle);
@@ -195,9 +309,20 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
         auto registered = dag.registerDependencyFreeNode(node); assert(registered);
         issued = false;
         if(error_code == TRY_LATER){ //temporary shortage of resources
-          if(logging_.load() != 0) logfile_ << ": Postponed" << std::endl;
+          ++(stats.postponed);
+          recordNodePostponed(dag_node,node);
+          if(logging_.load() != 0){
+            if(exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::POSTPONED);
+            }else{
+              logfile_ << ": Postponed" << std::endl;
+            }
+          }
         }else{ //fatal error
-          if(logging_.load() != 0) logfile_.flush();
+          if(logging_.load() != 0){
+            exec_log_.flush();
+            logfile_.flush();
+          }
           std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorLazy): Failed to submit tensor operation "
            << node << " with execution handle " << exec_handle << ": Error " << error_code << std::endl << std::flush;
           assert(false); //`Do I need to handle this case gracefully?
@@ -208,10 +333,12 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
   };
 
   auto test_nodes_for_completion = [this,&dag,&progress] () {
+    std::size_t num_completed = 0;
     auto executing_nodes = dag.executingNodesBegin();
     while(executing_nodes != dag.executingNodesEnd()){
       int error_code;
       auto exec_handle = executing_nodes->second;
+      const int device = this->node_executor_->getExecutionDevice(exec_handle);
       auto synced = this->node_executor_->sync(exec_handle,&error_code,serialize_.load());
       if(synced){ //tensor operation has completed
         VertexIdType node;
@@ -219,9 +346,18 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
         auto & dag_node = dag.getNodeProperties(node);
         auto op = dag_node.getOperation();
         op->recordFinishTime();
+        releaseMemory(*op);
+        if(error_code == 0) recordNodeExecuted(dag_node,node,device);
         dag.setNodeExecuted(node,error_code);
+        ++num_completed;
         if(error_code == 0){
-          if(logging_.load() != 0){
+          if(logging_.load() != 0 && exec_log_.isActive()){
+            exec_log_.record(ExecLog::EventKind::SYNCED,exatn::Timer::timeInSecHR(getTimeStampStart()),node,0,0,
+                             static_cast<int>(op->getOpcode()));
+            std::size_t free_mem = 0;
+            std::size_t used_mem = this->node_executor_->getMemoryUsage(&free_mem);
+            exec_log_.recordMemory(exatn::Timer::timeInSecHR(getTimeStampStart()),getTotalFlopCount(),used_mem,free_mem);
+          }else if(logging_.load() != 0){
             logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                      << "](LazyGraphExecutor)[EXEC_THREAD]: Synced tensor operation "
                      << node << ": Opcode = " << static_cast<int>(op->getOpcode()) << std::endl;
@@ -245,10 +381,20 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
               progress.front = dag.getFrontNode();
             }
           }
-          if(progressed && logging_.load() > 1) logfile_ << "DAG front node progressed to "
-            << progress.front << " out of total of " << progress.num_nodes << std::endl;
+          if(progressed && logging_.load() > 1){
+            if(exec_log_.isActive()){
+              exec_log_.record(ExecLog::EventKind::FRONT,0.0,progress.front,progress.num_nodes);
+            }else{
+              logfile_ << "DAG front node progressed to "
+                       << progress.front << " out of total of " << progress.num_nodes << std::endl;
+            }
+          }
         }else{
-          if(logging_.load() != 0){
+          if(logging_.load() != 0 && exec_log_.isActive()){
+            exec_log_.record(ExecLog::EventKind::SYNC_FAILED,exatn::Timer::timeInSecHR(getTimeStampStart()),node,0,0,
+                             static_cast<int>(op->getOpcode()));
+            exec_log_.flush();
+          }else if(logging_.load() != 0){
             logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                      << "](LazyGraphExecutor)[EXEC_THREAD]: Failed to sync tensor operation "
                      << node << ": Opcode = " << static_cast<int>(op->getOpcode()) << std::endl;
@@ -262,25 +408,196 @@ void LazyGraphExecutor::execute(TensorGraph & dag) {
         ++executing_nodes;
       }
     }
-    return;
+    return num_completed;
   };
 
   if(logging_.load() != 0){
-    logfile_ << "DAG entry list of dependency free nodes:";
     auto free_nodes = dag.getDependencyFreeNodes();
-    for(const auto & node: free_nodes) logfile_ << " " << node;
-    logfile_ << std::endl << std::flush;
+    if(exec_log_.isActive()){
+      exec_log_.recordNodes(ExecLog::NodeList::ENTRY,free_nodes);
+    }else{
+      logfile_ << "DAG entry list of dependency free nodes:";
+      for(const auto & node: free_nodes) logfile_ << " " << node;
+      logfile_ << std::endl << std::flush;
+    }
   }
+  const auto quantum = getExecutionQuantum();
+  std::size_t num_iterations = 0;
+  VertexIdType lookahead_front = progress.num_nodes; //DAG front node of the last lookahead window
   bool not_done = (progress.front < progress.num_nodes);
   while(not_done){
+    const auto poll_start = exatn::Timer::timeInSecHR();
+    bool progressed = false;
+    //Refresh the cache eviction lookahead window once the DAG front node has progressed:
+    if(lookahead_window_ > 0 && progress.front != lookahead_front){
+      resetLookahead(dag,progress.front);
+      lookahead_front = progress.front;
+    }
     //Try to issue all idle DAG nodes that are ready for execution:
-    while(issue_ready_node());
+    while(issue_ready_node()) progressed = true;
     //Inspect whether the current node can be issued:
     auto node_ready = inspect_node_dependencies();
+    exec_metrics_.sampleReadyQueue(dag.getNumDependencyFreeNodes());
     //Test the currently executing DAG nodes for completion:
-    test_nodes_for_completion();
+    if(test_nodes_for_completion() > 0) progressed = true;
     //Find the next idle DAG node:
     not_done = find_next_idle_node() || (progress.front < progress.num_nodes);
+    if(!progressed) exec_metrics_.recordSpinTime(exatn::Timer::timeInSecHR(poll_start));
+    //Autotune the pipeline and prefetch depths:
+    if(autotune_){
+      ++(stats.polls);
+      if(not_done && dag.executingNodesBegin() == dag.executingNodesEnd()) ++(stats.idle_polls);
+      if((stats.issued + stats.postponed) >= AUTOTUNE_PERIOD){
+        autotuneDepths(stats);
+        stats = AutotuneStats();
+      }
+    }
+    //Return control once the execution quantum has been exhausted:
+    if(quantum > 0 && ++num_iterations >= quantum) break;
+  }
+  return;
+}
+
+
+void LazyGraphExecutor::resetLookahead(TensorGraph & dag,
+                                       VertexIdType front_node)
+{
+  std::vector<TensorHashType> upcoming;
+  const auto num_nodes = dag.getNumNodes();
+  const auto end_node = std::min(num_nodes,front_node + lookahead_window_);
+  for(auto node = front_node; node < end_node; ++node){
+    if(!(dag.nodeExecuted(node))){
+      const auto & op = dag.getNodeProperties(node).getOperation();
+      const auto num_operands = op->getNumOperandsSet();
+      for(unsigned int i = 0; i < num_operands; ++i) upcoming.emplace_back(op->getTensorOperandHash(i));
+    }
+  }
+  this->node_executor_->resetLookahead(upcoming);
+  return;
+}
+
+
+std::size_t LazyGraphExecutor::projectMemoryFootprint(const TensorOperation & op)
+{
+  auto tensor_size = [&op](unsigned int i){
+    const auto tensor = op.getTensorOperand(i);
+    if(!tensor) return std::size_t{0};
+    return static_cast<std::size_t>(tensor->getVolume()) *
+           numerics::tensor_element_type_size(tensorComputeElementType(tensor->getElementType()));
+  };
+  std::size_t footprint = 0;
+  const auto num_operands = op.getNumOperandsSet();
+  switch(op.getOpcode()){
+  case TensorOpCode::CREATE: //new tensor body
+    footprint = tensor_size(0);
+    break;
+  case TensorOpCode::ADD:
+  case TensorOpCode::SLICE:
+  case TensorOpCode::INSERT: //permuted copy of the input tensor
+    if(num_operands > 1) footprint = tensor_size(1);
+    break;
+  case TensorOpCode::CONTRACT:
+  case TensorOpCode::DECOMPOSE_SVD3:
+  case TensorOpCode::DECOMPOSE_SVD2:
+  case TensorOpCode::ORTHOGONALIZE_SVD:
+  case TensorOpCode::ORTHOGONALIZE_MGS: //permuted copies of all tensor operands
+    for(unsigned int i = 0; i < num_operands; ++i) footprint += tensor_size(i);
+    break;
+  default:
+    break;
+  }
+  return footprint;
+}
+
+
+bool LazyGraphExecutor::freesMemory(const TensorOperation & op)
+{
+  return (op.getOpcode() == TensorOpCode::DESTROY);
+}
+
+
+bool LazyGraphExecutor::extractAdmissibleNode(TensorGraph & dag,
+                                              VertexIdType * node_id,
+                                              std::size_t * footprint)
+{
+  *footprint = 0;
+  if(!memory_admission_) return dag.extractDependencyFreeNode(node_id);
+  std::size_t free_mem = 0;
+  node_executor_->getMemoryUsage(&free_mem);
+  const std::size_t available = (free_mem > memory_reserved_) ? (free_mem - memory_reserved_) : 0;
+  //Under memory pressure, prefer the DAG nodes freeing memory:
+  const std::size_t buffer_size = node_executor_->getMemoryBufferSize();
+  if(static_cast<double>(available) < MEMORY_PRESSURE_FREE_MEM * static_cast<double>(buffer_size)){
+    if(dag.extractDependencyFreeNodeIf(node_id,[&dag](VertexIdType node){
+        return freesMemory(*(dag.getNodeProperties(node).getOperation()));})) return true;
+  }
+  //Otherwise issue the next fitting dependency-free DAG node (the others keep their order):
+  auto fits = [this,&dag,available](VertexIdType node){
+    return (memory_reserved_ == 0 ||
+            projectMemoryFootprint(*(dag.getNodeProperties(node).getOperation())) <= available);
+  };
+  VertexIdType node;
+  bool extracted = dag.extractDependencyFreeNode(&node,fits);
+  if(extracted){
+    *node_id = node;
+    *footprint = projectMemoryFootprint(*(dag.getNodeProperties(node).getOperation()));
+  }
+  return extracted;
+}
+
+
+void LazyGraphExecutor::reserveMemory(const TensorOperation & op, std::size_t footprint)
+{
+  if(footprint > 0){
+    reservations_[op.getTensorOpHash()] = footprint;
+    memory_reserved_ += footprint;
+  }
+  return;
+}
+
+
+void LazyGraphExecutor::releaseMemory(const TensorOperation & op)
+{
+  auto iter = reservations_.find(op.getTensorOpHash());
+  if(iter != reservations_.end()){
+    memory_reserved_ -= iter->second;
+    reservations_.erase(iter);
+  }
+  return;
+}
+
+
+void LazyGraphExecutor::autotuneDepths(const AutotuneStats & stats)
+{
+  const auto attempts = stats.issued + stats.postponed;
+  if(attempts == 0 || stats.polls == 0) return;
+  const double postpone_rate = static_cast<double>(stats.postponed) / static_cast<double>(attempts);
+  const double idle_rate = static_cast<double>(stats.idle_polls) / static_cast<double>(stats.polls);
+  double free_mem_fraction = 1.0;
+  const std::size_t buffer_size = node_executor_ ? node_executor_->getMemoryBufferSize() : 0;
+  if(buffer_size > 0){
+    std::size_t free_mem = 0;
+    node_executor_->getMemoryUsage(&free_mem);
+    free_mem_fraction = static_cast<double>(free_mem) / static_cast<double>(buffer_size);
+  }
+  const auto pipeline_depth = pipeline_depth_;
+  const auto prefetch_depth = prefetch_depth_;
+  if(postpone_rate > AUTOTUNE_MAX_POSTPONE_RATE || free_mem_fraction < AUTOTUNE_MIN_FREE_MEM){ //resource pressure: back off
+    if(!pipeline_depth_fixed_) pipeline_depth_ = std::max(MIN_PIPELINE_DEPTH,pipeline_depth_/2);
+    if(!prefetch_depth_fixed_) prefetch_depth_ = std::min(prefetch_depth_/2,pipeline_depth_);
+  }else if(idle_rate > AUTOTUNE_MAX_IDLE_RATE && free_mem_fraction > AUTOTUNE_GROW_FREE_MEM){ //starving pipeline: grow
+    if(!pipeline_depth_fixed_) pipeline_depth_ = std::min(MAX_PIPELINE_DEPTH,pipeline_depth_+std::max(1U,pipeline_depth_/4));
+    if(!prefetch_depth_fixed_) prefetch_depth_ = std::min(prefetch_depth_+1,pipeline_depth_/2);
+  }
+  if(logging_.load() != 0 && (pipeline_depth_ != pipeline_depth || prefetch_depth_ != prefetch_depth)){
+    log_text_.str("");
+    std::ostream & log = exec_log_.isActive() ? static_cast<std::ostream&>(log_text_) : logfile_;
+    log << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+        << "](LazyGraphExecutor)[EXEC_THREAD]: Autotuning: TRY_LATER rate = " << postpone_rate
+        << "; Idle rate = " << idle_rate << "; Free memory = " << free_mem_fraction
+        << ": Pipeline depth " << pipeline_depth << " -> " << pipeline_depth_
+        << "; Prefetch depth " << prefetch_depth << " -> " << prefetch_depth_ << std::endl;
+    if(exec_log_.isActive()) exec_log_.recordText(log_text_.str());
   }
   return;
 }
@@ -306,11 +623,9 @@ void LazyGraphExecutor::execute(TensorNetworkQueue & tensor_network_queue) {
         int error_code = 0;
         int64_t num_slices = 0;
         ExecutionTimings timings;
-        auto exec_stat = tensor_network_queue.checkExecStatus(exec_handle);
-        if(exec_stat == TensorNetworkQueue::ExecStat::Idle || current_pos == 0){
-          exec_stat = cuquantum_executor_->sync(exec_handle,&error_code,&num_slices,&timings); //this call will progress tensor network execution
-          assert(error_code == 0);
-        }
+        //Progress all tensor networks within the pipeline (also fetches more slices for the executing ones):
+        auto exec_stat = cuquantum_executor_->sync(exec_handle,&error_code,&num_slices,&timings);
+        assert(error_code == 0);
         if(exec_stat == TensorNetworkQueue::ExecStat::None){
           if(logging_.load() != 0){
             logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
@@ -319,8 +634,9 @@ void LazyGraphExecutor::execute(TensorNetworkQueue & tensor_network_queue) {
             logfile_.flush();
 #endif
           }
-          const auto exec_conf = tensor_network_queue.getExecConfiguration(exec_handle);
-          exec_stat = cuquantum_executor_->execute(current->first,exec_conf.first,exec_conf.second,exec_handle);
+          MPICommProxy communicator;
+          const auto exec_conf = tensor_network_queue.getExecConfiguration(exec_handle,&communicator);
+          exec_stat = cuquantum_executor_->execute(current->first,exec_conf.first,exec_conf.second,communicator,exec_handle);
           if(logging_.load() != 0){
             logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
                      << "](LazyGraphExecutor)[EXEC_THREAD]: Submitted to cuQuantum tensor network " << exec_handle
@@ -346,8 +662,7 @@ void LazyGraphExecutor::execute(TensorNetworkQueue & tensor_network_queue) {
 #endif
           }
           auto prev_exec_stat = tensor_network_queue.updateExecStatus(exec_handle,exec_stat);
-          assert(current_pos == 0);
-          tensor_network_queue.remove();
+          tensor_network_queue.remove(); //tensor networks may complete out of order
           //std::cout << "#DEBUG(exatn::runtime::LazyGraphExecutor::execute): Completed tensor network execution via cuQuantum\n";
           not_over = !tensor_network_queue.isOver();
         }else{
@@ -369,10 +684,10 @@ void LazyGraphExecutor::execute(TensorNetworkQueue & tensor_network_queue) {
 
 double LazyGraphExecutor::getTotalFlopCount() const
 {
-  while(!node_executor_);
+  waitNodeExecutorInitialized();
   double flops = node_executor_->getTotalFlopCount();
 #ifdef CUQUANTUM
-  while(!cuquantum_executor_);
+  waiter_.wait([this](){return static_cast<bool>(cuquantum_executor_);});
   flops += cuquantum_executor_->getTotalFlopCount();
 #endif
   return flops;
@@ -1,11 +1,58 @@
 /** ExaTN:: Tensor Runtime: Tensor graph executor: Lazy
-REVISION: 2022/01/08
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
-
+ (a) The lazy graph executor inspects a window of DAG nodes starting from the DAG front node
+     and issues the dependency-free DAG nodes for execution, up to the pipeline depth.
+ (b) The order in which the dependency-free DAG nodes are issued is regulated by the
+     "dag_executor_scheduling" runtime parameter (ParamConf):
+     "fifo" (default): In the order of their detection;
+     "critical_path": In the order of decreasing critical-path priority (bottom level)
+                      computed from the flop/word estimates of tensor operations.
+ (c) The pipeline depth and prefetch depth are autotuned during execution by a feedback
+     controller: Every AUTOTUNE_PERIOD issue attempts, a high rate of TRY_LATER postponements
+     or a low fraction of free memory buffer halves both depths, whereas an idle pipeline
+     (no tensor operations in flight while unexecuted DAG nodes are available) with enough
+     free memory increases them. The autotuning is turned on via the "dag_executor_autotune"
+     runtime parameter (0:off (default), 1:on). A depth set explicitly, either via the
+     "dag_executor_pipeline_depth" and "dag_executor_prefetch_depth" runtime parameters
+     or via setPrefetchDepth(), is never changed by the autotuning (the prefetch depth
+     is still kept within the pipeline depth if only the latter is set explicitly).
+ (d) The lazy graph executor honors the execution quantum: Once the quantum is exhausted,
+     it returns with the unfinished DAG nodes left in flight (their execution state is kept
+     in the DAG), thus resuming the DAG traversal on the next call. The autotuning statistics
+     are accumulated across such calls.
+ (e) Memory-aware admission control: The lazy graph executor projects the memory buffer
+     footprint of each dependency-free DAG node from the volumes of its tensor operands
+     (tensor creation, workspace of tensor contractions, additions, etc.) and keeps a running
+     reservation for the issued DAG nodes still in flight. A DAG node is only issued if its
+     footprint fits into the free memory buffer minus the current reservation; otherwise
+     it stays dependency-free at its position (its priority is kept) and the executor
+     issues the next fitting DAG node in the scheduling order instead.
+     Under memory pressure, DAG nodes freeing memory (tensor destruction) are issued first.
+     A DAG node is always admitted when no reservation is in flight, thus guaranteeing progress.
+     The admission control is turned on via the "dag_executor_memory_admission"
+     runtime parameter (0:off (default), 1:on).
+ (f) Lookahead cache eviction: Whenever the DAG front node progresses, the lazy graph executor
+     passes the tensor operands of the unexecuted DAG nodes within the lookahead window
+     (starting from the DAG front node) to the node executor, which evicts the cached
+     accelerator tensor images needed the latest first (Belady-style). The lookahead window
+     (number of DAG nodes) is set via the "dag_executor_lookahead_window" runtime parameter
+     (0 turns the lookahead off, reverting to the node executor's own eviction order).
+ (g) If the asynchronous binary execution log is open, the per-operation events of the execution
+     thread (submission, status, completion, memory usage, DAG front progress) are recorded as
+     binary records instead of being formatted into the text log; the tensor operation details
+     (logging level > 1) are formatted into a reusable in-memory buffer.
+ (h) Remote prefetch: Tensor fetches (FETCH of remote subtensors of composite tensors) are passed
+     to the node executor for prefetching within a separate, deeper window starting from the DAG
+     front node (bounded by the pipeline depth), such that the node executor can post their receives
+     ahead of time while the preceding tensor operations (and the CREATE of the fetched subtensor)
+     are still being executed. The window is set via the "dag_executor_remote_prefetch_depth"
+     runtime parameter (0 turns it off) and it is not autotuned (the node executor bounds
+     the buffer space reserved by the early receives).
 **/
 
 #ifndef EXATN_RUNTIME_LAZY_GRAPH_EXECUTOR_HPP_
@@ -13,6 +60,9 @@ Rationale:
 
 #include "tensor_graph_executor.hpp"
 
+#include <unordered_map>
+#include <sstream>
+
 namespace exatn {
 namespace runtime {
 
@@ -26,12 +76,27 @@ public:
 
   static constexpr const unsigned int DEFAULT_PIPELINE_DEPTH = 16;
   static constexpr const unsigned int DEFAULT_PREFETCH_DEPTH = 4;
+  static constexpr const unsigned int DEFAULT_REMOTE_PREFETCH_DEPTH = 16; //number of DAG nodes in the remote prefetch window (h)
+  static constexpr const unsigned int MIN_PIPELINE_DEPTH = 2;
+  static constexpr const unsigned int MAX_PIPELINE_DEPTH = 1024;
+  static constexpr const unsigned int DEFAULT_LOOKAHEAD_WINDOW = 256; //number of DAG nodes in the cache eviction lookahead window
+  static constexpr const std::size_t AUTOTUNE_PERIOD = 64;        //number of issue attempts per autotuning epoch
+  static constexpr const double AUTOTUNE_MAX_POSTPONE_RATE = 0.1; //TRY_LATER rate above which the depths are reduced
+  static constexpr const double AUTOTUNE_MIN_FREE_MEM = 0.1;      //free memory fraction below which the depths are reduced
+  static constexpr const double AUTOTUNE_GROW_FREE_MEM = 0.25;    //free memory fraction required for increasing the depths
+  static constexpr const double AUTOTUNE_MAX_IDLE_RATE = 0.05;    //pipeline idle rate above which the depths are increased
+  static constexpr const double MEMORY_PRESSURE_FREE_MEM = 0.25;  //free memory fraction (minus reservation) below which memory-freeing DAG nodes are preferred
 #ifdef CUQUANTUM
-  static constexpr const unsigned int CUQUANTUM_PIPELINE_DEPTH = 2;
+  static constexpr const unsigned int CUQUANTUM_PIPELINE_DEPTH = 4; //default (overridden by the "cuquantum_pipeline_depth" runtime parameter)
 #endif
 
   LazyGraphExecutor(): pipeline_depth_(DEFAULT_PIPELINE_DEPTH),
-                       prefetch_depth_(DEFAULT_PREFETCH_DEPTH)
+                       prefetch_depth_(DEFAULT_PREFETCH_DEPTH),
+                       remote_prefetch_depth_(DEFAULT_REMOTE_PREFETCH_DEPTH),
+                       lookahead_window_(DEFAULT_LOOKAHEAD_WINDOW),
+                       critical_path_(false), autotune_(false),
+                       pipeline_depth_fixed_(false), prefetch_depth_fixed_(false),
+                       memory_admission_(false), memory_reserved_(0)
 #ifdef CUQUANTUM
                       ,cuquantum_pipe_depth_(CUQUANTUM_PIPELINE_DEPTH)
 #endif
@@ -58,9 +123,11 @@ public:
   /** Traverses the list of tensor networks and executes them as a whole. **/
   virtual void execute(TensorNetworkQueue & tensor_network_queue) override;
 
-  /** Regulates the tensor prefetch depth (0 turns prefetch off). **/
+  /** Regulates the tensor prefetch depth (0 turns prefetch off),
+      which is no longer subject to the autotuning. **/
   virtual void setPrefetchDepth(unsigned int depth) override {
     prefetch_depth_ = depth;
+    prefetch_depth_fixed_ = true;
     return;
   }
 
@@ -69,11 +136,26 @@ public:
     return prefetch_depth_;
   }
 
+  /** Returns the remote prefetch depth (h). **/
+  inline unsigned int getRemotePrefetchDepth() const {
+    return remote_prefetch_depth_;
+  }
+
   /** Returns the current pipeline depth. **/
   inline unsigned int getPipelineDepth() const {
     return pipeline_depth_;
   }
 
+  /** Returns TRUE if the pipeline/prefetch depth autotuning is active. **/
+  inline bool autotuningActive() const {
+    return autotune_;
+  }
+
+  /** Returns TRUE if the critical-path scheduling policy is active. **/
+  inline bool criticalPathScheduling() const {
+    return critical_path_;
+  }
+
   /** Returns the current value of the total Flop count executed by the node executor. **/
   virtual double getTotalFlopCount() const override;
 
@@ -83,8 +165,53 @@ public:
 
 protected:
 
+  /** Execution statistics collected during an autotuning epoch **/
+  struct AutotuneStats {
+    std::size_t issued = 0;     //number of successfully issued tensor operations
+    std::size_t postponed = 0;  //number of TRY_LATER postponements
+    std::size_t polls = 0;      //number of DAG traversal iterations
+    std::size_t idle_polls = 0; //number of DAG traversal iterations without tensor operations in flight
+  };
+
+  /** Adjusts the pipeline and prefetch depths based on the collected statistics. **/
+  void autotuneDepths(const AutotuneStats & stats);
+
+  /** Returns the projected memory buffer footprint (bytes) of a tensor operation
+      which needs to be reserved while it is in flight. **/
+  static std::size_t projectMemoryFootprint(const TensorOperation & op);
+
+  /** Returns TRUE if a tensor operation frees memory. **/
+  static bool freesMemory(const TensorOperation & op);
+
+  /** Extracts a dependency-free DAG node admissible for execution under
+      the memory admission control, returning its projected memory footprint.
+      Returns FALSE if no admissible dependency-free DAG node exists. **/
+  bool extractAdmissibleNode(TensorGraph & dag,
+                             VertexIdType * node_id,
+                             std::size_t * footprint);
+
+  /** Passes the tensor operands of the unexecuted DAG nodes within the lookahead window,
+      starting from a given DAG node, to the node executor. **/
+  void resetLookahead(TensorGraph & dag,
+                      VertexIdType front_node);
+
+  /** Reserves/releases the memory footprint of an issued tensor operation in flight. **/
+  void reserveMemory(const TensorOperation & op, std::size_t footprint);
+  void releaseMemory(const TensorOperation & op);
+
   unsigned int pipeline_depth_; //max number of active tensor operations in flight
   unsigned int prefetch_depth_; //max number of tensor operations with active prefetch in flight
+  unsigned int remote_prefetch_depth_; //number of DAG nodes in the remote prefetch window (h), 0:off
+  unsigned int lookahead_window_; //number of DAG nodes in the cache eviction lookahead window (0:off)
+  bool critical_path_;          //critical-path (list) scheduling policy for dependency-free DAG nodes
+  bool autotune_;               //autotuning of the pipeline and prefetch depths
+  bool pipeline_depth_fixed_;   //pipeline depth set explicitly (not autotuned)
+  bool prefetch_depth_fixed_;   //prefetch depth set explicitly (not autotuned)
+  AutotuneStats autotune_stats_;  //autotuning statistics of the current epoch
+  bool memory_admission_;         //memory-aware admission control of DAG nodes
+  std::size_t memory_reserved_;   //memory reserved by the issued tensor operations in flight (bytes)
+  std::unordered_map<TensorHashType,std::size_t> reservations_; //tensor operation hash --> reserved memory (bytes)
+  std::ostringstream log_text_;   //reusable text buffer of the binary execution log (tensor operation details)
 #ifdef CUQUANTUM
   unsigned int cuquantum_pipe_depth_; //max number of actively executed tensor networks via cuQuantum
   std::shared_ptr<CuQuantumExecutor> cuquantum_executor_; //cuQuantum executor
@@ -0,0 +1,301 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Parallel (work-stealing)
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+**/
+
+#include "graph_executor_parallel.hpp"
+
+#include "talshxx.hpp"
+#include "thread_topology.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+#include "errors.hpp"
+
+namespace exatn {
+namespace runtime {
+
+ParallelGraphExecutor::~ParallelGraphExecutor()
+{
+  joinWorkers();
+}
+
+
+void ParallelGraphExecutor::resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> node_executor,
+                                              const ParamConf & parameters,
+                                              unsigned int num_processes,
+                                              unsigned int process_rank,
+                                              unsigned int global_process_rank)
+{
+  joinWorkers();
+  TensorGraphExecutor::resetNodeExecutor(node_executor,parameters,num_processes,process_rank,global_process_rank);
+  if(node_executor){
+    num_workers_ = DEFAULT_NUM_WORKERS;
+    int64_t num_workers = 0;
+    if(parameters.getParameter("dag_executor_num_workers",&num_workers)){
+      if(num_workers > 0) num_workers_ = static_cast<unsigned int>(num_workers);
+    }
+    if(!(node_executor->isThreadSafe()) && num_workers_ > 1){ //see rationale (c)
+      if(process_rank == 0){
+        std::cout << "#WARNING(exatn::runtime::ParallelGraphExecutor): The node executor is not thread-safe:"
+                  << " Using a single worker thread instead of " << num_workers_ << std::endl << std::flush;
+      }
+      num_workers_ = 1;
+    }
+    launchWorkers();
+  }
+  return;
+}
+
+
+void ParallelGraphExecutor::launchWorkers()
+{
+  if(!(workers_alive_.load())){
+    queues_.clear();
+    for(unsigned int i = 0; i < num_workers_; ++i) queues_.emplace_back(std::make_unique<WorkerQueue>());
+    num_queued_.store(0);
+    workers_alive_.store(true);
+    for(unsigned int i = 0; i < num_workers_; ++i){
+      workers_.emplace_back(std::thread(&ParallelGraphExecutor::workerThreadWorkflow,this,i));
+    }
+  }
+  return;
+}
+
+
+void ParallelGraphExecutor::joinWorkers()
+{
+  if(workers_alive_.load()){
+    {
+      std::lock_guard<std::mutex> lock(work_mtx_);
+      workers_alive_.store(false);
+    }
+    work_cv_.notify_all();
+    for(auto & worker: workers_) worker.join();
+    workers_.clear();
+    queues_.clear();
+  }
+  return;
+}
+
+
+void ParallelGraphExecutor::pushNode(unsigned int worker_id, VertexIdType node_id)
+{
+  {
+    std::lock_guard<std::mutex> lock(queues_[worker_id]->mtx);
+    queues_[worker_id]->nodes.emplace_back(node_id);
+  }
+  {
+    std::lock_guard<std::mutex> lock(work_mtx_);
+    ++num_queued_;
+  }
+  work_cv_.notify_one();
+  return;
+}
+
+
+bool ParallelGraphExecutor::acquireNode(unsigned int worker_id, VertexIdType * node_id)
+{
+  //Try the worker's own deque first (front):
+  {
+    std::lock_guard<std::mutex> lock(queues_[worker_id]->mtx);
+    auto & nodes = queues_[worker_id]->nodes;
+    if(!nodes.empty()){
+      *node_id = nodes.front();
+      nodes.pop_front();
+      --num_queued_;
+      return true;
+    }
+  }
+  //Steal from other workers (back):
+  for(unsigned int i = 1; i < num_workers_; ++i){
+    const unsigned int victim = (worker_id + i) % num_workers_;
+    std::lock_guard<std::mutex> lock(queues_[victim]->mtx);
+    auto & nodes = queues_[victim]->nodes;
+    if(!nodes.empty()){
+      *node_id = nodes.back();
+      nodes.pop_back();
+      --num_queued_;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void ParallelGraphExecutor::workerThreadWorkflow(unsigned int worker_id)
+{
+  getThreadTopology().pinWorkerThread(worker_id,num_workers_); //if the thread topology is active
+  while(workers_alive_.load()){
+    VertexIdType node;
+    if(acquireNode(worker_id,&node)){
+      const bool executed = executeNode(node,worker_id);
+      if(executed){
+        {
+          std::lock_guard<std::mutex> lock(retire_mtx_);
+          retired_.emplace_back(node);
+        }
+        retire_cv_.notify_one();
+      }
+    }else{
+      std::unique_lock<std::mutex> lock(work_mtx_);
+      work_cv_.wait(lock,[this](){return (num_queued_.load() > 0 || !(workers_alive_.load()));});
+    }
+  }
+  return;
+}
+
+
+bool ParallelGraphExecutor::executeNode(VertexIdType node_id, unsigned int worker_id)
+{
+  const bool thread_safe = node_executor_->isThreadSafe();
+  auto & dag_node = dag_->getNodeProperties(node_id);
+  auto op = dag_node.getOperation();
+  if(logging_.load() != 0){
+    std::lock_guard<std::mutex> lock(log_mtx_);
+    logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+             << "](ParallelGraphExecutor)[WORKER_THREAD]: Submitting tensor operation "
+             << node_id << ": Opcode = " << static_cast<int>(op->getOpcode()) << std::endl;
+    if(logging_.load() > 1) op->printItFile(logfile_);
+  }
+  op->recordStartTime();
+  TensorOpExecHandle exec_handle;
+  int error_code = 0;
+  bool synced = false;
+  std::unique_lock<std::mutex> exec_lock(node_exec_mtx_,std::defer_lock);
+  if(!thread_safe) exec_lock.lock();
+  error_code = op->accept(*node_executor_,&exec_handle);
+  if(error_code == 0){
+    const int device = node_executor_->getExecutionDevice(exec_handle);
+    synced = node_executor_->sync(exec_handle,&error_code,serialize_.load());
+    while(!synced){
+      if(!thread_safe) exec_lock.unlock();
+      std::this_thread::yield();
+      if(!thread_safe) exec_lock.lock();
+      synced = node_executor_->sync(exec_handle,&error_code,false);
+    }
+    if(!thread_safe) exec_lock.unlock();
+    op->recordFinishTime();
+    if(error_code == 0) recordNodeExecuted(dag_node,node_id,device,worker_id+1);
+    dag_->setNodeExecuted(node_id,error_code);
+    if(error_code == 0){
+      if(logging_.load() != 0){
+        std::lock_guard<std::mutex> lock(log_mtx_);
+        logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                 << "](ParallelGraphExecutor)[WORKER_THREAD]: Synced tensor operation "
+                 << node_id << ": Opcode = " << static_cast<int>(op->getOpcode()) << std::endl;
+      }
+      op->dissociateTensorOperands();
+    }else{
+      if(logging_.load() != 0){
+        std::lock_guard<std::mutex> lock(log_mtx_);
+        logfile_.flush();
+      }
+      std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorParallel): Completion error for tensor operation "
+       << node_id << " with execution handle " << exec_handle << ": Error " << error_code << std::endl << std::flush;
+      assert(false); //`Do I need to handle this case gracefully?
+    }
+  }else{ //tensor operation not submitted due to either temporary resource shortage or fatal error
+    node_executor_->discard(exec_handle);
+    if(!thread_safe) exec_lock.unlock();
+    dag_->setNodeIdle(node_id);
+    if(error_code == TRY_LATER || error_code == DEVICE_UNABLE){ //temporary shortage of resources
+      recordNodePostponed(dag_node,node_id,worker_id+1);
+      if(logging_.load() != 0){
+        std::lock_guard<std::mutex> lock(log_mtx_);
+        logfile_ << "[" << std::fixed << std::setprecision(6) << exatn::Timer::timeInSecHR(getTimeStampStart())
+                 << "](ParallelGraphExecutor)[WORKER_THREAD]: Postponed tensor operation " << node_id << std::endl;
+      }
+    }else{ //fatal error
+      std::cout << "#ERROR(exatn::TensorRuntime::GraphExecutorParallel): Failed to submit tensor operation "
+       << node_id << " with execution handle " << exec_handle << ": Error " << error_code << std::endl << std::flush;
+      assert(false); //`Do I need to handle this case gracefully?
+    }
+    return false;
+  }
+  return true;
+}
+
+
+void ParallelGraphExecutor::execute(TensorGraph & dag) {
+  assert(workers_alive_.load());
+  dag_ = &dag;
+  unsigned int next_worker = 0; //round-robin worker selection
+  auto front = dag.getFrontNode();
+  auto num_nodes = dag.getNumNodes();
+  while(front < num_nodes){
+    //Dispatch idle DAG nodes with resolved dependencies within the window:
+    const auto window_end = std::min(num_nodes,static_cast<VertexIdType>(front + pipeline_depth_));
+    for(auto node = front; node < window_end; ++node){
+      if(dag.nodeIdle(node)){
+        if(dag.nodeDependenciesResolved(node)){
+          auto registered = dag.registerDependencyFreeNode(node);
+          if(registered && logging_.load() > 1){
+            std::lock_guard<std::mutex> lock(log_mtx_);
+            logfile_ << "DAG node detected with all dependencies resolved: " << node << std::endl;
+          }
+        }else if(node < (front + prefetch_depth_)){
+          std::unique_lock<std::mutex> exec_lock(node_exec_mtx_,std::defer_lock);
+          if(!(node_executor_->isThreadSafe())) exec_lock.lock();
+          auto & dag_node = dag.getNodeProperties(node);
+          auto prefetching = node_executor_->prefetch(*(dag_node.getOperation()));
+          recordNodePrefetch(dag_node,node,prefetching);
+        }
+      }
+    }
+    exec_metrics_.sampleReadyQueue(dag.getNumDependencyFreeNodes());
+    bool dispatched = false;
+    VertexIdType node;
+    while(dag.extractDependencyFreeNode(&node)){
+      dag.setNodeExecuting(node);
+      pushNode(next_worker,node);
+      next_worker = (next_worker + 1) % num_workers_;
+      dispatched = true;
+    }
+    //Retire the DAG nodes executed by the workers:
+    std::list<VertexIdType> retired;
+    {
+      std::unique_lock<std::mutex> lock(retire_mtx_);
+      if(retired_.empty() && !dispatched){ //nothing to do: wait for workers instead of spinning
+        retire_cv_.wait_for(lock,std::chrono::microseconds(100),[this](){return !(retired_.empty());});
+      }
+      retired.swap(retired_);
+    }
+    dag.drainStagedOperations(); //append newly submitted tensor operations into the DAG
+    dag.applyCancellations(); //cancel the requested idle DAG nodes
+    num_nodes = dag.getNumNodes();
+    for(const auto & node_executed: retired){
+      auto progressed = dag.progressFrontNode(node_executed);
+      if(progressed){
+        front = dag.getFrontNode();
+        while(front < num_nodes){
+          if(!(dag.nodeExecuted(front))) break;
+          dag.progressFrontNode(front);
+          front = dag.getFrontNode();
+        }
+        if(logging_.load() > 1){
+          std::lock_guard<std::mutex> lock(log_mtx_);
+          logfile_ << "DAG front node progressed to " << front << " out of total of " << num_nodes << std::endl;
+        }
+      }
+    }
+    //Nodes postponed by the workers return to the idle state and will be redispatched
+    front = dag.getFrontNode();
+    num_nodes = dag.getNumNodes();
+  }
+  dag_ = nullptr;
+  return;
+}
+
+
+void ParallelGraphExecutor::execute(TensorNetworkQueue & tensor_network_queue) {
+  assert(tensor_network_queue.isEmpty()); //see rationale (e)
+  return;
+}
+
+} //namespace runtime
+} //namespace exatn
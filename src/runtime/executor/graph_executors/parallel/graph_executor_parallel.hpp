@@ -0,0 +1,154 @@
+/** ExaTN:: Tensor Runtime: Tensor graph executor: Parallel (work-stealing)
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The parallel graph executor employs a pool of worker threads which
+     execute dependency-free DAG nodes concurrently. The execution thread
+     acts as a dispatcher: It inspects a window of DAG nodes starting at
+     the DAG front node, registers the nodes with all their dependencies
+     resolved in the list of dependency-free nodes (TensorExecState), and
+     distributes them among per-worker deques. Each worker pops nodes from
+     the front of its own deque and, once its own deque is empty, steals
+     nodes from the back of the deques of other workers.
+ (b) The execution thread retires the DAG nodes executed by the workers
+     and progresses the DAG front node.
+ (c) Concurrent execution of DAG nodes requires a thread-safe node executor
+     (TensorNodeExecutor::isThreadSafe). A node executor which is not thread-safe,
+     like the TAL-SH node executor, executes Host tensor operations synchronously
+     inside a single call, thus the parallel graph executor falls back to a single
+     worker thread with it (the lazy graph executor is then the better choice).
+     The execution thread still dispatches and retires the DAG nodes concurrently
+     with the worker thread, but all calls into the node executor are serialized
+     by an internal mutex.
+ (d) The number of worker threads is regulated by the "dag_executor_num_workers"
+     runtime parameter (ParamConf), subject to (c).
+ (e) Entire tensor networks (cuQuantum backend) are only executed by the lazy graph executor:
+     The numerical server rejects the cuQuantum backend in combination with this executor
+     at configuration time, thus the tensor network queue is always empty here.
+**/
+
+#ifndef EXATN_RUNTIME_PARALLEL_GRAPH_EXECUTOR_HPP_
+#define EXATN_RUNTIME_PARALLEL_GRAPH_EXECUTOR_HPP_
+
+#include "tensor_graph_executor.hpp"
+
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace exatn {
+namespace runtime {
+
+class ParallelGraphExecutor : public TensorGraphExecutor {
+
+public:
+
+  static constexpr const unsigned int DEFAULT_NUM_WORKERS = 4;
+  static constexpr const unsigned int DEFAULT_PIPELINE_DEPTH = 64;
+  static constexpr const unsigned int DEFAULT_PREFETCH_DEPTH = 4;
+
+  ParallelGraphExecutor(): num_workers_(DEFAULT_NUM_WORKERS),
+                           pipeline_depth_(DEFAULT_PIPELINE_DEPTH),
+                           prefetch_depth_(DEFAULT_PREFETCH_DEPTH),
+                           dag_(nullptr), num_queued_(0), workers_alive_(false)
+  {
+  }
+
+  ParallelGraphExecutor(const ParallelGraphExecutor &) = delete;
+  ParallelGraphExecutor & operator=(const ParallelGraphExecutor &) = delete;
+  ParallelGraphExecutor(ParallelGraphExecutor &&) = delete;
+  ParallelGraphExecutor & operator=(ParallelGraphExecutor &&) = delete;
+
+  virtual ~ParallelGraphExecutor();
+
+  /** Sets/resets the DAG node executor (tensor operation executor).
+      Launches/joins the worker threads (a single one if the node executor is not thread-safe). **/
+  virtual void resetNodeExecutor(std::shared_ptr<TensorNodeExecutor> node_executor,
+                                 const ParamConf & parameters,
+                                 unsigned int num_processes,
+                                 unsigned int process_rank,
+                                 unsigned int global_process_rank) override;
+
+  /** Traverses the DAG and executes all its nodes. **/
+  virtual void execute(TensorGraph & dag) override;
+
+  /** Traverses the list of tensor networks and executes them as a whole. **/
+  virtual void execute(TensorNetworkQueue & tensor_network_queue) override;
+
+  /** Regulates the tensor prefetch depth (0 turns prefetch off). **/
+  virtual void setPrefetchDepth(unsigned int depth) override {
+    prefetch_depth_ = depth;
+    return;
+  }
+
+  /** Returns the current prefetch depth. **/
+  inline unsigned int getPrefetchDepth() const {
+    return prefetch_depth_;
+  }
+
+  /** Returns the current pipeline depth. **/
+  inline unsigned int getPipelineDepth() const {
+    return pipeline_depth_;
+  }
+
+  /** Returns the number of worker threads (see rationale (c)). **/
+  inline unsigned int getNumWorkers() const {
+    return num_workers_;
+  }
+
+  const std::string name() const override {return "parallel-dag-executor";}
+  const std::string description() const override {return "Parallel work-stealing tensor graph executor";}
+  std::shared_ptr<TensorGraphExecutor> clone() override {return std::make_shared<ParallelGraphExecutor>();}
+
+protected:
+
+  /** Per-worker deque of dispatched DAG nodes **/
+  struct WorkerQueue {
+    std::mutex mtx;
+    std::deque<VertexIdType> nodes;
+  };
+
+  /** Launches the worker threads. **/
+  void launchWorkers();
+  /** Signals the worker threads to finish and joins them. **/
+  void joinWorkers();
+  /** The worker threads live here. **/
+  void workerThreadWorkflow(unsigned int worker_id);
+  /** Pushes a dispatched DAG node into the deque of a given worker. **/
+  void pushNode(unsigned int worker_id, VertexIdType node_id);
+  /** Pops a DAG node from the worker's own deque or steals one from other workers.
+      Returns FALSE if no DAG node is available. **/
+  bool acquireNode(unsigned int worker_id, VertexIdType * node_id);
+  /** Executes a DAG node to completion (by a worker thread).
+      Returns FALSE if the node has been postponed due to resource shortage. **/
+  bool executeNode(VertexIdType node_id, unsigned int worker_id);
+
+  unsigned int num_workers_;    //number of worker threads
+  unsigned int pipeline_depth_; //max number of DAG nodes in flight (dispatch window size)
+  unsigned int prefetch_depth_; //max number of tensor operations with active prefetch in flight
+  TensorGraph * dag_;           //non-owning pointer to the DAG currently being executed
+  std::vector<std::unique_ptr<WorkerQueue>> queues_; //per-worker deques of DAG nodes
+  std::vector<std::thread> workers_;                 //worker threads
+  std::list<VertexIdType> retired_;                  //DAG nodes executed by the workers, not yet retired
+  std::atomic<std::size_t> num_queued_;              //total number of queued DAG nodes
+  std::atomic<bool> workers_alive_;                  //TRUE while the worker threads are alive
+  std::mutex work_mtx_;                              //work availability mutex
+  std::condition_variable work_cv_;                  //work availability condition
+  std::mutex retire_mtx_;                            //retirement list mutex
+  std::condition_variable retire_cv_;                //retirement condition
+  std::mutex node_exec_mtx_;                         //serializes access to a non-thread-safe node executor
+  std::mutex log_mtx_;                               //logging mutex
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_PARALLEL_GRAPH_EXECUTOR_HPP_
@@ -0,0 +1,336 @@
+/** ExaTN:: Tensor Runtime: Tensor node executor: Memory timeline
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The live tensor memory (total size of the allocated tensor bodies) and its high-water mark
+     are always tracked by the node executor (one atomic update per tensor allocation/free).
+ (b) Once activated, the memory timeline also records the allocation and free events of tensor bodies
+     {time stamp, tensor hash, tensor name, size, device (-1: Host), DAG node id of the tensor
+     operation allocating/freeing the tensor body} in an event buffer preallocated at activation.
+     Recording an event neither allocates nor performs any I/O. Once the event buffer is full,
+     further events are dropped (counted), the recorded prefix of the timeline remaining exact.
+ (c) The memory timeline report lists the largest peaks of the live tensor memory (local maxima
+     of the timeline), largest first, together with the tensors live at each peak, largest first,
+     thus attributing the peak to specific tensors (intermediates) and their creating operations.
+     The tensors allocated before the recorded window are carried over from the previous report.
+ (d) Memory usage predictions (the max intermediate presence volume of a tensor network scaled by
+     its slicing) are registered together with the last tensor operation of their execution window.
+     The report compares each prediction with the actual tensor memory usage within its window:
+     The peak live tensor memory minus the live tensor memory at the window start (approximate
+     if other tensor operations are executed concurrently within the window). The ratio of
+     the actual to the predicted usage calibrates the memory model of the slicing heuristic.
+ (e) Events are recorded by the thread executing the tensor operations, predictions can be
+     registered by any thread. The report must not overlap with recording (the tensor runtime
+     writes it after the execution thread has finished executing the DAG of the closed scope).
+**/
+
+#ifndef EXATN_RUNTIME_MEMORY_TIMELINE_HPP_
+#define EXATN_RUNTIME_MEMORY_TIMELINE_HPP_
+
+#include "tensor_operation.hpp"
+#include "tensor.hpp"
+
+#include "timers.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+namespace exatn {
+namespace runtime {
+
+class MemoryTimeline {
+
+public:
+
+  static constexpr const std::size_t DEFAULT_CAPACITY = 65536;  //default number of recorded events
+  static constexpr const std::size_t NAME_LEN = 32;             //max recorded tensor name length (including '\0')
+  static constexpr const unsigned int MAX_REPORTED_PEAKS = 4;   //max number of reported memory peaks
+  static constexpr const unsigned int MAX_REPORTED_TENSORS = 16; //max number of reported live tensors per peak
+
+  enum class EventKind: int {
+    ALLOC, //tensor body has been allocated
+    FREE   //tensor body has been freed
+  };
+
+  struct Event {
+    double time;                    //time stamp (sec)
+    std::size_t bytes;              //size of the tensor body (bytes)
+    numerics::TensorHashType hash;  //tensor hash
+    std::size_t node;               //DAG node id of the tensor operation
+    int device;                     //device (-1: Host)
+    EventKind kind;                 //event kind
+    char name[NAME_LEN];            //tensor name (truncated)
+  };
+
+  MemoryTimeline(): num_events_(0), num_dropped_(0), live_bytes_(0), peak_bytes_(0), window_live_bytes_(0) {}
+
+  MemoryTimeline(const MemoryTimeline &) = delete;
+  MemoryTimeline & operator=(const MemoryTimeline &) = delete;
+  MemoryTimeline(MemoryTimeline &&) = delete;
+  MemoryTimeline & operator=(MemoryTimeline &&) = delete;
+  ~MemoryTimeline() = default;
+
+  /** Activates the recording of events with a given event buffer capacity (0 deactivates it). **/
+  void activate(std::size_t capacity) {
+    events_.clear();
+    events_.shrink_to_fit();
+    events_.resize(capacity);
+    num_events_ = 0;
+    num_dropped_ = 0;
+    window_live_bytes_ = live_bytes_.load();
+    carried_.clear();
+    return;
+  }
+
+  /** Returns TRUE if the recording of events is active. **/
+  inline bool isActive() const {return !events_.empty();}
+
+  /** Records the allocation of a tensor body. **/
+  inline void recordAlloc(const numerics::Tensor & tensor,
+                          std::size_t bytes,
+                          int device,
+                          std::size_t node) {
+    const auto live = live_bytes_.fetch_add(bytes,std::memory_order_relaxed) + bytes;
+    auto peak = peak_bytes_.load(std::memory_order_relaxed);
+    while(live > peak && !peak_bytes_.compare_exchange_weak(peak,live,std::memory_order_relaxed));
+    if(isActive()) record(EventKind::ALLOC,tensor,bytes,device,node);
+    return;
+  }
+
+  /** Records the free of a tensor body. **/
+  inline void recordFree(const numerics::Tensor & tensor,
+                         std::size_t bytes,
+                         int device,
+                         std::size_t node) {
+    live_bytes_.fetch_sub(bytes,std::memory_order_relaxed);
+    if(isActive()) record(EventKind::FREE,tensor,bytes,device,node);
+    return;
+  }
+
+  /** Returns the live tensor memory (bytes). **/
+  inline std::size_t getLiveBytes() const {return live_bytes_.load(std::memory_order_relaxed);}
+
+  /** Returns the high-water mark of the live tensor memory (bytes). **/
+  inline std::size_t getPeakBytes() const {return peak_bytes_.load(std::memory_order_relaxed);}
+
+  /** Resets the high-water mark of the live tensor memory to the current live tensor memory. **/
+  inline void resetPeak() {
+    peak_bytes_.store(live_bytes_.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    return;
+  }
+
+  /** Registers a memory usage prediction for the execution window which starts no earlier than
+      the given time stamp and the completion of the preceding tensor operation (if any) and ends
+      with the completion of the last tensor operation of the window. Ignored unless active.
+      [THREAD: Can be called by any thread] **/
+  void addPrediction(const std::string & label,                            //in: label (e.g., tensor network name)
+                     double predicted_bytes,                               //in: predicted tensor memory usage (bytes)
+                     double start_time,                                    //in: submission time stamp of the first tensor operation of the window (sec)
+                     std::shared_ptr<numerics::TensorOperation> prior_op, //in: tensor operation preceding the window (or nullptr)
+                     std::shared_ptr<numerics::TensorOperation> last_op)  //in: last tensor operation of the window
+  {
+    if(!isActive() || !last_op) return;
+    std::lock_guard<std::mutex> lock(predictions_mutex_);
+    predictions_.emplace_back(Prediction{label,predicted_bytes,start_time,prior_op,last_op});
+    return;
+  }
+
+  /** Writes the memory timeline report (peaks with their live tensors, prediction calibration)
+      and starts a new recorded window. **/
+  bool dumpReport(const std::string & filename, //in: output file name
+                  int process_id) {             //in: process id (global MPI rank)
+    std::lock_guard<std::mutex> lock(predictions_mutex_);
+    if(num_events_ == 0 && predictions_.empty()) return true;
+    std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+    if(!report_file.is_open()) return false;
+    writeReport(report_file,process_id);
+    report_file.close();
+    //Carry the live tensors over to the next window:
+    std::unordered_map<numerics::TensorHashType,Event> live;
+    replay(num_events_,live);
+    carried_.clear();
+    if(num_dropped_ == 0){
+      for(const auto & entry: live) carried_.emplace_back(entry.second);
+    }
+    window_live_bytes_ = live_bytes_.load();
+    num_events_ = 0;
+    num_dropped_ = 0;
+    predictions_.clear();
+    return true;
+  }
+
+protected:
+
+  struct Prediction {
+    std::string label;                                  //label
+    double predicted_bytes;                             //predicted tensor memory usage (bytes)
+    double start_time;                                  //submission time stamp of the window (sec)
+    std::shared_ptr<numerics::TensorOperation> prior_op; //tensor operation preceding the window (or nullptr)
+    std::shared_ptr<numerics::TensorOperation> last_op;  //last tensor operation of the window
+  };
+
+  /** Records an event. **/
+  inline void record(EventKind kind,
+                     const numerics::Tensor & tensor,
+                     std::size_t bytes,
+                     int device,
+                     std::size_t node) {
+    if(num_events_ >= events_.size()){++num_dropped_; return;}
+    auto & event = events_[num_events_++];
+    event.time = exatn::Timer::timeInSecHR();
+    event.bytes = bytes;
+    event.hash = tensor.getTensorHash();
+    event.node = node;
+    event.device = device;
+    event.kind = kind;
+    std::strncpy(event.name,tensor.getName().c_str(),NAME_LEN-1);
+    event.name[NAME_LEN-1] = '\0';
+    return;
+  }
+
+  /** Replays the first num_events recorded events, returning the live tensor memory
+      and the live tensors (including the carried-over ones) afterwards. **/
+  std::size_t replay(std::size_t num_events,
+                     std::unordered_map<numerics::TensorHashType,Event> & live) const {
+    live.clear();
+    for(const auto & event: carried_) live.emplace(event.hash,event);
+    std::size_t live_bytes = window_live_bytes_;
+    for(std::size_t i = 0; i < num_events; ++i){
+      const auto & event = events_[i];
+      if(event.kind == EventKind::ALLOC){
+        live_bytes += event.bytes;
+        live[event.hash] = event;
+      }else{
+        live_bytes -= std::min(live_bytes,event.bytes);
+        live.erase(event.hash);
+      }
+    }
+    return live_bytes;
+  }
+
+  /** Returns the live tensor memory after all events recorded no later than a given time stamp. **/
+  std::size_t liveBytesAt(double time, std::size_t * next_event) const {
+    std::size_t live_bytes = window_live_bytes_;
+    std::size_t i = 0;
+    for(; i < num_events_ && events_[i].time <= time; ++i){
+      const auto & event = events_[i];
+      live_bytes = (event.kind == EventKind::ALLOC) ? (live_bytes + event.bytes)
+                                                    : (live_bytes - std::min(live_bytes,event.bytes));
+    }
+    *next_event = i;
+    return live_bytes;
+  }
+
+  /** Writes the memory timeline report (the caller holds the lock on the predictions). **/
+  void writeReport(std::ostream & report, int process_id) const {
+    report << "#MemoryTimeline: Process " << process_id << ": Recorded events = " << num_events_
+           << "; Dropped events = " << num_dropped_ << "; Live tensor memory at window start = "
+           << window_live_bytes_ << "; High-water mark = " << getPeakBytes() << " bytes" << std::endl;
+    //Find the local maxima of the live tensor memory (an allocation followed by a free):
+    std::vector<std::pair<std::size_t,std::size_t>> peaks; //{live tensor memory, number of events}
+    std::size_t live_bytes = window_live_bytes_;
+    bool rising = false;
+    for(std::size_t i = 0; i < num_events_; ++i){
+      const auto & event = events_[i];
+      if(event.kind == EventKind::ALLOC){
+        live_bytes += event.bytes;
+        rising = true;
+      }else{
+        if(rising) peaks.emplace_back(std::make_pair(live_bytes,i));
+        live_bytes -= std::min(live_bytes,event.bytes);
+        rising = false;
+      }
+    }
+    if(rising) peaks.emplace_back(std::make_pair(live_bytes,num_events_));
+    std::stable_sort(peaks.begin(),peaks.end(),
+                     [](const std::pair<std::size_t,std::size_t> & a, const std::pair<std::size_t,std::size_t> & b){
+                       return a.first > b.first;
+                     });
+    if(peaks.size() > MAX_REPORTED_PEAKS) peaks.resize(MAX_REPORTED_PEAKS);
+    //Report the tensors live at each peak:
+    std::unordered_map<numerics::TensorHashType,Event> live;
+    for(unsigned int k = 0; k < peaks.size(); ++k){
+      const auto peak_bytes = replay(peaks[k].second,live);
+      std::vector<Event> tensors;
+      std::size_t attributed = 0;
+      for(const auto & entry: live){tensors.emplace_back(entry.second); attributed += entry.second.bytes;}
+      std::sort(tensors.begin(),tensors.end(),[](const Event & a, const Event & b){return a.bytes > b.bytes;});
+      const double peak_time = (peaks[k].second > 0) ? events_[peaks[k].second - 1].time : 0.0;
+      report << "Peak " << k << ": " << peak_bytes << " bytes at " << std::fixed << std::setprecision(6)
+             << peak_time << " sec: " << tensors.size() << " live tensors" << std::endl;
+      for(std::size_t i = 0; i < tensors.size() && i < MAX_REPORTED_TENSORS; ++i){
+        const auto & tensor = tensors[i];
+        report << " " << tensor.name << ": " << tensor.bytes << " bytes (device " << tensor.device
+               << ", created by DAG node " << tensor.node << ")" << std::endl;
+      }
+      if(tensors.size() > MAX_REPORTED_TENSORS) report << " ... " << (tensors.size() - MAX_REPORTED_TENSORS)
+                                                       << " more tensors" << std::endl;
+      if(peak_bytes > attributed) report << " (" << (peak_bytes - attributed)
+                                         << " bytes allocated before the recorded window)" << std::endl;
+    }
+    //Compare the memory usage predictions with the actual memory usage:
+    if(!predictions_.empty()){
+      double ratio_sum = 0.0, ratio_max = 0.0;
+      unsigned int num_ratios = 0;
+      report << "Memory usage predictions (predicted / actual bytes):" << std::endl;
+      for(const auto & prediction: predictions_){
+        const double finish = prediction.last_op->getFinishTime();
+        report << " " << prediction.label << ": " << std::scientific << prediction.predicted_bytes;
+        if(finish <= 0.0){
+          report << " / unknown (not executed)" << std::endl;
+          continue;
+        }
+        double start = prediction.start_time;
+        if(prediction.prior_op) start = std::max(start,prediction.prior_op->getFinishTime());
+        std::size_t i = 0;
+        const auto base_bytes = liveBytesAt(start,&i);
+        std::size_t window_peak = base_bytes, window_bytes = base_bytes;
+        for(; i < num_events_ && events_[i].time <= finish; ++i){
+          const auto & event = events_[i];
+          window_bytes = (event.kind == EventKind::ALLOC) ? (window_bytes + event.bytes)
+                                                          : (window_bytes - std::min(window_bytes,event.bytes));
+          window_peak = std::max(window_peak,window_bytes);
+        }
+        const double actual = static_cast<double>(window_peak - base_bytes);
+        report << " / " << actual;
+        if(prediction.predicted_bytes > 0.0){
+          const double ratio = actual / prediction.predicted_bytes;
+          report << " (ratio " << std::fixed << std::setprecision(3) << ratio << ")";
+          ratio_sum += ratio; ratio_max = std::max(ratio_max,ratio); ++num_ratios;
+        }
+        if(i >= num_events_ && num_dropped_ > 0) report << " (truncated)";
+        report << std::endl;
+      }
+      if(num_ratios > 0) report << "Actual/predicted memory usage ratio: Mean = " << std::fixed << std::setprecision(3)
+                                << (ratio_sum / static_cast<double>(num_ratios)) << "; Max = " << ratio_max << std::endl;
+    }
+    return;
+  }
+
+  std::vector<Event> events_;                //preallocated buffer of recorded events
+  std::size_t num_events_;                   //number of recorded events (since the last report)
+  std::size_t num_dropped_;                  //number of dropped events (since the last report)
+  std::atomic<std::size_t> live_bytes_;      //live tensor memory (bytes)
+  std::atomic<std::size_t> peak_bytes_;      //high-water mark of the live tensor memory (bytes)
+  std::size_t window_live_bytes_;            //live tensor memory at the start of the recorded window (bytes)
+  std::vector<Event> carried_;               //live tensors allocated before the recorded window
+  std::vector<Prediction> predictions_;      //registered memory usage predictions
+  mutable std::mutex predictions_mutex_;     //protects the registered memory usage predictions
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_MEMORY_TIMELINE_HPP_
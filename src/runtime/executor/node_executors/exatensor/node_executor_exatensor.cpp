@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Tensor graph node executor: Exatensor
-REVISION: 2022/01/17
+REVISION: 2022/03/22
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -14,21 +14,28 @@ namespace runtime {
 
 void ExatensorNodeExecutor::initialize(const ParamConf & parameters)
 {
+ if(!node_engine_){
+  node_engine_ = std::make_shared<TalshNodeExecutor>();
+  node_engine_->initialize(parameters);
+  exatensor_host_mem_buffer_size_.store(node_engine_->getMemoryBufferSize());
+ }else{ //hot reconfiguration
+  node_engine_->initialize(parameters);
+ }
  return;
 }
 
 
 void ExatensorNodeExecutor::activateDryRun(bool dry_run)
 {
- //`Finish
- return;
+ assert(node_engine_);
+ return node_engine_->activateDryRun(dry_run);
 }
 
 
 void ExatensorNodeExecutor::activateFastMath()
 {
- //`Finish
- return;
+ assert(node_engine_);
+ return node_engine_->activateFastMath();
 }
 
 
@@ -42,136 +49,157 @@ std::size_t ExatensorNodeExecutor::getMemoryBufferSize() const
 
 std::size_t ExatensorNodeExecutor::getMemoryUsage(std::size_t * free_mem) const
 {
- //`Implement
- *free_mem = 0;
- return 0;
+ if(!node_engine_){
+  *free_mem = 0;
+  return 0;
+ }
+ return node_engine_->getMemoryUsage(free_mem);
 }
 
 
 double ExatensorNodeExecutor::getTotalFlopCount() const
 {
- //`Implement
- return 0.0;
+ if(!node_engine_) return 0.0;
+ return node_engine_->getTotalFlopCount();
+}
+
+
+void ExatensorNodeExecutor::getTransferVolume(std::size_t * host_to_device,
+                                              std::size_t * device_to_host) const
+{
+ if(!node_engine_){
+  *host_to_device = 0;
+  *device_to_host = 0;
+  return;
+ }
+ return node_engine_->getTransferVolume(host_to_device,device_to_host);
+}
+
+
+std::size_t ExatensorNodeExecutor::getTensorMemoryUsage() const
+{
+ if(!node_engine_) return 0;
+ return node_engine_->getTensorMemoryUsage();
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpCreate & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpDestroy & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpTransform & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpSlice & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpInsert & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpAdd & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpContract & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpDecomposeSVD3 & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpDecomposeSVD2 & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpOrthogonalizeSVD & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpOrthogonalizeMGS & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpFetch & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpUpload & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpBroadcast & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
 int ExatensorNodeExecutor::execute(numerics::TensorOpAllreduce & op,
                                    TensorOpExecHandle * exec_handle)
 {
- //`Implement
- return 0;
+ assert(node_engine_);
+ return node_engine_->execute(op,exec_handle);
 }
 
 
@@ -179,44 +207,91 @@ bool ExatensorNodeExecutor::sync(TensorOpExecHandle op_handle,
                                  int * error_code,
                                  bool wait)
 {
- *error_code = 0;
- //`Implement
- return false;
+ assert(node_engine_);
+ return node_engine_->sync(op_handle,error_code,wait);
 }
 
 
 bool ExatensorNodeExecutor::sync()
 {
- //`Implement
- return false;
+ if(!node_engine_) return true;
+ return node_engine_->sync();
+}
+
+
+int ExatensorNodeExecutor::getExecutionDevice(TensorOpExecHandle op_handle) const
+{
+ if(!node_engine_) return -1;
+ return node_engine_->getExecutionDevice(op_handle);
+}
+
+
+bool ExatensorNodeExecutor::getDeviceLoad(int device,
+                                          double * queued_flops,
+                                          std::size_t * free_mem) const
+{
+ if(!node_engine_) return false;
+ return node_engine_->getDeviceLoad(device,queued_flops,free_mem);
 }
 
 
 bool ExatensorNodeExecutor::discard(TensorOpExecHandle op_handle)
 {
- //`Implement
- return false;
+ assert(node_engine_);
+ return node_engine_->discard(op_handle);
 }
 
 
 bool ExatensorNodeExecutor::prefetch(const numerics::TensorOperation & op)
 {
- //`Implement
- return false;
+ assert(node_engine_);
+ return node_engine_->prefetch(op);
 }
 
 
 void ExatensorNodeExecutor::clearCache()
 {
+ if(node_engine_) node_engine_->clearCache();
  return;
 }
 
 
+void ExatensorNodeExecutor::resetLookahead(const std::vector<numerics::TensorHashType> & upcoming)
+{
+ if(node_engine_) node_engine_->resetLookahead(upcoming);
+ return;
+}
+
+
+bool ExatensorNodeExecutor::isThreadSafe() const
+{
+ if(!node_engine_) return false;
+ return node_engine_->isThreadSafe();
+}
+
+
 std::shared_ptr<talsh::Tensor> ExatensorNodeExecutor::getLocalTensor(const numerics::Tensor & tensor,
                                       const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec)
 {
- //`Implement
- return std::make_shared<talsh::Tensor>(std::vector<int>{},0.0);
+ assert(node_engine_);
+ return node_engine_->getLocalTensor(tensor,slice_spec);
+}
+
+
+TensorView ExatensorNodeExecutor::getTensorView(const numerics::Tensor & tensor)
+{
+ assert(node_engine_);
+ return node_engine_->getTensorView(tensor);
+}
+
+
+void * ExatensorNodeExecutor::getTensorImage(const numerics::Tensor & tensor,
+                                             int device_kind,
+                                             int device_id,
+                                             std::size_t * size) const
+{
+ if(!node_engine_) return nullptr;
+ return node_engine_->getTensorImage(tensor,device_kind,device_id,size);
 }
 
 } //namespace runtime
@@ -1,11 +1,19 @@
 /** ExaTN:: Tensor Runtime: Tensor graph node executor: Exatensor
-REVISION: 2022/01/17
+REVISION: 2022/03/22
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
-
+ (a) ExaTENSOR executes tensor operations within a compute node by its TAL-SH layer, hence
+     the ExaTENSOR node executor drives a node-level TAL-SH engine (TalshNodeExecutor), thus
+     providing the same asynchronous execution path: Execution handles tested/waited on by sync(),
+     operand prefetching and accelerator caching, tensor images/views and memory accounting.
+     The distribution of tensors across the compute nodes is done by ExaTN (composite tensors).
+     The distributed ExaTENSOR engine (Fortran API) is not bound to C++, thus distributed
+     tensor operations are not yet forwarded to it.
+ (b) The ExaTENSOR node executor is selected by the "exatensor" computational backend
+     (NumServer::switchComputationalBackend), which reconfigures the tensor runtime.
 **/
 
 #ifndef EXATN_RUNTIME_EXATENSOR_NODE_EXECUTOR_HPP_
@@ -13,8 +21,11 @@ Rationale:
 
 #include "tensor_node_executor.hpp"
 
+#include "node_executor_talsh.hpp"
+
 #include "talshxx.hpp"
 
+#include <memory>
 #include <atomic>
 
 namespace exatn {
@@ -24,7 +35,7 @@ class ExatensorNodeExecutor : public TensorNodeExecutor {
 
 public:
 
-  ExatensorNodeExecutor() = default;
+  ExatensorNodeExecutor(): exatensor_host_mem_buffer_size_(0) {}
   ExatensorNodeExecutor(const ExatensorNodeExecutor &) = delete;
   ExatensorNodeExecutor & operator=(const ExatensorNodeExecutor &) = delete;
   ExatensorNodeExecutor(ExatensorNodeExecutor &&) noexcept = delete;
@@ -43,6 +54,11 @@ public:
 
   double getTotalFlopCount() const override;
 
+  void getTransferVolume(std::size_t * host_to_device,
+                         std::size_t * device_to_host) const override;
+
+  std::size_t getTensorMemoryUsage() const override;
+
   int execute(numerics::TensorOpCreate & op,
               TensorOpExecHandle * exec_handle) override;
   int execute(numerics::TensorOpDestroy & op,
@@ -80,19 +96,31 @@ public:
 
   bool sync() override;
 
+  int getExecutionDevice(TensorOpExecHandle op_handle) const override;
+
+  bool getDeviceLoad(int device,
+                     double * queued_flops,
+                     std::size_t * free_mem) const override;
+
   bool discard(TensorOpExecHandle op_handle) override;
 
   bool prefetch(const numerics::TensorOperation & op) override;
 
   void clearCache() override;
 
+  void resetLookahead(const std::vector<numerics::TensorHashType> & upcoming) override;
+
+  bool isThreadSafe() const override;
+
   std::shared_ptr<talsh::Tensor> getLocalTensor(const numerics::Tensor & tensor,
                  const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec) override;
 
+  TensorView getTensorView(const numerics::Tensor & tensor) override;
+
   void * getTensorImage(const numerics::Tensor & tensor,
                         int device_kind,
                         int device_id,
-                        std::size_t * size = nullptr) const override {return nullptr;}
+                        std::size_t * size = nullptr) const override;
 
   const std::string name() const override {return "exatensor-node-executor";}
   const std::string description() const override {return "ExaTENSOR tensor graph node executor";}
@@ -100,6 +128,8 @@ public:
 
 protected:
  //`ExaTENSOR executor state
+ /** Node-level TAL-SH engine of ExaTENSOR **/
+ std::shared_ptr<TalshNodeExecutor> node_engine_;
  /** Size of the distributed Host memory buffer provided by ExaTENSOR in bytes **/
  std::atomic<std::size_t> exatensor_host_mem_buffer_size_;
 };
@@ -0,0 +1,277 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: Transpose-free direct tensor contraction kernels
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) The generic Host path of a binary tensor contraction D+=L*R transposes the tensor operands
+     into the matrix layout, multiplies the matrices (GEMM) and transposes the result back (TTGT).
+     For bandwidth-bound shapes the transposes cost more than the GEMM, and they need temporary
+     buffers as large as the tensor operands themselves. The direct kernels (BLIS/TBLIS style)
+     instead pack bounded micro-panels of the tensor operands straight from their strided layouts,
+     thus each tensor element is read from its original location and no transposed copy exists.
+ (b) The uncontracted indices of the left (right) tensor form the M (N) dimension and the contracted
+     indices form the K dimension of the equivalent matrix multiplication D(M,N)+=L(M,K)*R(K,N).
+     Each dimension is described by a table of element offsets (scatter vectors): The offsets of the
+     M (N) multi-indices in the left (right) and destination tensors and the offsets of the K multi-indices
+     in the left and right tensors. The tables hold M+N+K entries in total, not M*N or M*K.
+ (c) The destination tensor is partitioned into tiles of at most MC x NC elements (OpenMP-parallel).
+     For each tile, the K dimension is traversed in blocks of KC: The MC x KC left panel and the KC x NC
+     right panel are gathered into contiguous (per-thread) buffers, complex conjugated on the fly
+     if needed, and multiplied into the tile accumulator, which is scattered into the destination
+     tensor at the end. The temporary memory is thus bounded by (MC*KC + KC*NC + MC*NC) elements
+     per thread regardless of the tensor volumes.
+ (d) Hyper indices and traces (indices appearing in one input tensor only) are not supported.
+**/
+
+#ifndef EXATN_RUNTIME_DIRECT_CONTRACTION_KERNELS_HPP_
+#define EXATN_RUNTIME_DIRECT_CONTRACTION_KERNELS_HPP_
+
+#include "tensor_symbol.hpp"
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+/** Index positions of a binary tensor contraction D+=L*R for the direct kernels (no hyper indices, no traces). **/
+struct DirectContractionPattern{
+  unsigned int rank[3];           //ranks of the destination, left and right tensors
+  std::vector<int> m_pos[2];      //uncontracted indices of the left tensor: positions in the destination/left tensor
+  std::vector<int> n_pos[2];      //uncontracted indices of the right tensor: positions in the destination/right tensor
+  std::vector<int> k_pos[2];      //contracted indices: positions in the left/right tensor (in the order of the left tensor)
+  bool conj[2];                   //complex conjugation of the left/right tensor
+};
+
+/** Offset tables (scatter vectors) of a binary tensor contraction for given tensor extents. **/
+struct DirectContractionPlan{
+  static constexpr const std::size_t MC = 128; //max number of M elements in a destination tile
+  static constexpr const std::size_t NC = 128; //max number of N elements in a destination tile
+  static constexpr const std::size_t KC = 256; //max number of K elements in a packed panel
+
+  std::vector<std::size_t> m_offset[2]; //offsets of the M multi-indices in the destination/left tensor
+  std::vector<std::size_t> n_offset[2]; //offsets of the N multi-indices in the destination/right tensor
+  std::vector<std::size_t> k_offset[2]; //offsets of the K multi-indices in the left/right tensor
+
+  /** Returns the temporary memory per thread (number of tensor elements). **/
+  static constexpr std::size_t getBufferVolume() {return (MC * KC + KC * NC + MC * NC);}
+};
+
+
+/** Parses a (reduced) symbolic tensor contraction pattern into index positions.
+    Returns FALSE if the tensor contraction is not supported by the direct kernels. **/
+inline bool parse_direct_contraction(const std::string & pattern,          //in: symbolic tensor contraction pattern
+                                     DirectContractionPattern & positions) //out: index positions
+{
+  std::vector<std::string> tensors;
+  std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
+  if(!parse_tensor_contraction(pattern,tensors,left_inds,right_inds,contr_inds,hyper_inds)) return false;
+  if(tensors.size() != 3 || !hyper_inds.empty()) return false;
+  for(unsigned int arg = 0; arg < 3; ++arg){
+    std::string tensor_name;
+    std::vector<IndexLabel> indices;
+    bool conj = false;
+    if(!parse_tensor(tensors[arg],tensor_name,indices,conj)) return false;
+    positions.rank[arg] = indices.size();
+    if(arg > 0) positions.conj[arg-1] = conj;
+  }
+  //Traces are not supported:
+  if(positions.rank[0] != left_inds.size() + right_inds.size()) return false;
+  if(positions.rank[1] != left_inds.size() + contr_inds.size()) return false;
+  if(positions.rank[2] != right_inds.size() + contr_inds.size()) return false;
+  std::sort(left_inds.begin(),left_inds.end(),
+            [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[0] < b.arg_pos[0];});
+  std::sort(right_inds.begin(),right_inds.end(),
+            [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[0] < b.arg_pos[0];});
+  std::sort(contr_inds.begin(),contr_inds.end(),
+            [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[1] < b.arg_pos[1];});
+  for(unsigned int i = 0; i < 2; ++i){
+    positions.m_pos[i].clear(); positions.n_pos[i].clear(); positions.k_pos[i].clear();
+  }
+  for(const auto & index: left_inds){
+    positions.m_pos[0].emplace_back(index.arg_pos[0]);
+    positions.m_pos[1].emplace_back(index.arg_pos[1]);
+  }
+  for(const auto & index: right_inds){
+    positions.n_pos[0].emplace_back(index.arg_pos[0]);
+    positions.n_pos[1].emplace_back(index.arg_pos[2]);
+  }
+  for(const auto & index: contr_inds){
+    positions.k_pos[0].emplace_back(index.arg_pos[1]);
+    positions.k_pos[1].emplace_back(index.arg_pos[2]);
+  }
+  return true;
+}
+
+
+/** Builds the offset table of a multi-index (first index is the fastest) in two tensors. **/
+inline void direct_offset_table(const std::vector<std::size_t> & extents,     //in: extents of the indices
+                                const std::vector<std::size_t> (& strides)[2], //in: strides of the indices in both tensors
+                                std::vector<std::size_t> (& offsets)[2])       //out: offsets of the multi-indices in both tensors
+{
+  std::size_t volume = 1;
+  for(const auto extent: extents) volume *= extent;
+  offsets[0].resize(volume); offsets[1].resize(volume);
+  std::vector<std::size_t> index(extents.size(),0);
+  std::size_t offset[2] = {0,0};
+  for(std::size_t n = 0; n < volume; ++n){
+    offsets[0][n] = offset[0]; offsets[1][n] = offset[1];
+    for(std::size_t i = 0; i < extents.size(); ++i){ //next multi-index
+      offset[0] += strides[0][i]; offset[1] += strides[1][i];
+      if(++(index[i]) < extents[i]) break;
+      offset[0] -= extents[i] * strides[0][i]; offset[1] -= extents[i] * strides[1][i];
+      index[i] = 0;
+    }
+  }
+  return;
+}
+
+
+/** Sets up the offset tables of a binary tensor contraction for given tensor extents.
+    Returns FALSE if the tensor ranks or extents do not match the index pattern. **/
+template <typename ExtentType>
+bool setup_direct_contraction(const DirectContractionPattern & positions, //in: index positions
+                              const unsigned int ranks[3],                //in: ranks of the destination, left and right tensors
+                              const ExtentType * const extents[3],        //in: extents of the destination, left and right tensors
+                              DirectContractionPlan & plan)               //out: offset tables
+{
+  for(unsigned int arg = 0; arg < 3; ++arg) if(ranks[arg] != positions.rank[arg]) return false;
+  std::vector<std::size_t> strides[3];
+  for(unsigned int arg = 0; arg < 3; ++arg){
+    std::size_t stride = 1;
+    for(unsigned int i = 0; i < ranks[arg]; ++i){
+      strides[arg].emplace_back(stride);
+      stride *= static_cast<std::size_t>(extents[arg][i]);
+    }
+  }
+  //Builds the offset table of an index group shared by two tensors (tensor arguments arg0 and arg1):
+  auto build_group = [&](const std::vector<int> (& pos)[2], unsigned int arg0, unsigned int arg1,
+                         std::vector<std::size_t> (& offsets)[2]){
+    std::vector<std::size_t> group_extents;
+    std::vector<std::size_t> group_strides[2];
+    for(std::size_t i = 0; i < pos[0].size(); ++i){
+      if(extents[arg0][pos[0][i]] != extents[arg1][pos[1][i]]) return false;
+      group_extents.emplace_back(static_cast<std::size_t>(extents[arg0][pos[0][i]]));
+      group_strides[0].emplace_back(strides[arg0][pos[0][i]]);
+      group_strides[1].emplace_back(strides[arg1][pos[1][i]]);
+    }
+    direct_offset_table(group_extents,group_strides,offsets);
+    return true;
+  };
+  if(!build_group(positions.m_pos,0,1,plan.m_offset)) return false;
+  if(!build_group(positions.n_pos,0,2,plan.n_offset)) return false;
+  if(!build_group(positions.k_pos,1,2,plan.k_offset)) return false;
+  return true;
+}
+
+
+template <typename NumericType>
+inline NumericType direct_conjugated(const NumericType & value){return value;}
+
+template <typename RealType>
+inline std::complex<RealType> direct_conjugated(const std::complex<RealType> & value){return std::conj(value);}
+
+
+/** Direct tensor contraction kernel: dest = alpha * left * right (+ dest, if accumulative),
+    where the left/right tensor may be complex conjugated (ignored for real types). **/
+template <typename NumericType>
+void direct_contraction(const DirectContractionPlan & plan,
+                        NumericType * __restrict__ dest,
+                        const NumericType * __restrict__ left,
+                        const NumericType * __restrict__ right,
+                        NumericType alpha,
+                        bool accumulative,
+                        bool conj_left = false,
+                        bool conj_right = false)
+{
+  constexpr std::size_t MC = DirectContractionPlan::MC;
+  constexpr std::size_t NC = DirectContractionPlan::NC;
+  constexpr std::size_t KC = DirectContractionPlan::KC;
+  const std::size_t m_volume = plan.m_offset[0].size();
+  const std::size_t n_volume = plan.n_offset[0].size();
+  const std::size_t k_volume = plan.k_offset[0].size();
+  const std::size_t m_tiles = (m_volume + MC - 1) / MC;
+  const std::size_t n_tiles = (n_volume + NC - 1) / NC;
+  const long long num_tiles = static_cast<long long>(m_tiles * n_tiles);
+#pragma omp parallel if(num_tiles > 1)
+  {
+    std::vector<NumericType> left_panel(MC * KC), right_panel(KC * NC), tile(MC * NC);
+#pragma omp for schedule(dynamic)
+    for(long long t = 0; t < num_tiles; ++t){
+      const std::size_t m_base = (static_cast<std::size_t>(t) % m_tiles) * MC;
+      const std::size_t n_base = (static_cast<std::size_t>(t) / m_tiles) * NC;
+      const std::size_t mc = std::min(MC,m_volume - m_base);
+      const std::size_t nc = std::min(NC,n_volume - n_base);
+      std::fill(tile.begin(),tile.begin() + mc * nc,NumericType(0));
+      for(std::size_t k_base = 0; k_base < k_volume; k_base += KC){
+        const std::size_t kc = std::min(KC,k_volume - k_base);
+        const std::size_t * k_left = &(plan.k_offset[0][k_base]);
+        const std::size_t * k_right = &(plan.k_offset[1][k_base]);
+        //Pack the left panel (row i: contiguous K):
+        for(std::size_t i = 0; i < mc; ++i){
+          const NumericType * src = &(left[plan.m_offset[1][m_base + i]]);
+          NumericType * dst = &(left_panel[i * kc]);
+          if(conj_left){
+            for(std::size_t p = 0; p < kc; ++p) dst[p] = direct_conjugated(src[k_left[p]]);
+          }else{
+            for(std::size_t p = 0; p < kc; ++p) dst[p] = src[k_left[p]];
+          }
+        }
+        //Pack the right panel (column j: contiguous K):
+        for(std::size_t j = 0; j < nc; ++j){
+          const NumericType * src = &(right[plan.n_offset[1][n_base + j]]);
+          NumericType * dst = &(right_panel[j * kc]);
+          if(conj_right){
+            for(std::size_t p = 0; p < kc; ++p) dst[p] = direct_conjugated(src[k_right[p]]);
+          }else{
+            for(std::size_t p = 0; p < kc; ++p) dst[p] = src[k_right[p]];
+          }
+        }
+        //Multiply the packed panels into the tile (four rows share each column of the right panel):
+        for(std::size_t j = 0; j < nc; ++j){
+          const NumericType * rcol = &(right_panel[j * kc]);
+          NumericType * tcol = &(tile[j * mc]);
+          std::size_t i = 0;
+          for(; i + 4 <= mc; i += 4){
+            const NumericType * l0 = &(left_panel[i * kc]);
+            const NumericType * l1 = l0 + kc;
+            const NumericType * l2 = l1 + kc;
+            const NumericType * l3 = l2 + kc;
+            NumericType s0(0), s1(0), s2(0), s3(0);
+            for(std::size_t p = 0; p < kc; ++p){
+              const NumericType r = rcol[p];
+              s0 += l0[p] * r; s1 += l1[p] * r; s2 += l2[p] * r; s3 += l3[p] * r;
+            }
+            tcol[i] += s0; tcol[i+1] += s1; tcol[i+2] += s2; tcol[i+3] += s3;
+          }
+          for(; i < mc; ++i){
+            const NumericType * l0 = &(left_panel[i * kc]);
+            NumericType s0(0);
+            for(std::size_t p = 0; p < kc; ++p) s0 += l0[p] * rcol[p];
+            tcol[i] += s0;
+          }
+        }
+      }
+      //Scatter the tile into the destination tensor:
+      for(std::size_t j = 0; j < nc; ++j){
+        const std::size_t n_dest = plan.n_offset[0][n_base + j];
+        const NumericType * tcol = &(tile[j * mc]);
+        for(std::size_t i = 0; i < mc; ++i){
+          NumericType & elem = dest[plan.m_offset[0][m_base + i] + n_dest];
+          elem = accumulative ? (elem + alpha * tcol[i]) : (alpha * tcol[i]);
+        }
+      }
+    }
+  }
+  return;
+}
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_DIRECT_CONTRACTION_KERNELS_HPP_
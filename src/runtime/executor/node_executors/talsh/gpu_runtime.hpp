@@ -0,0 +1,245 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: GPU runtime portability layer
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) Besides TAL-SH, the TAL-SH node executor makes a handful of direct GPU runtime calls:
+     Device selection, default stream synchronization, registration of the Host buffer
+     as pinned memory, and in-place BLAS scaling of device-resident tensor bodies.
+     They are routed through this thin layer, which maps them onto the CUDA runtime and cuBLAS
+     (default GPU build, NVIDIA GPUs) or onto the HIP runtime and hipBLAS (EXATN_HIP build,
+     AMD GPUs), thus the node executor itself is vendor-neutral. The GPUs of either vendor
+     are exposed by TAL-SH under the same device kind (DEV_NVIDIA_GPU).
+ (b) Without GPU support (NO_GPU), all calls fail (nothing to do).
+ (c) All calls clear the sticky error state of the GPU runtime upon failure,
+     thus a failed call does not poison subsequent GPU runtime calls.
+**/
+
+#ifndef EXATN_RUNTIME_GPU_RUNTIME_HPP_
+#define EXATN_RUNTIME_GPU_RUNTIME_HPP_
+
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+#include <hip/hip_runtime.h>
+#include <hipblas/hipblas.h>
+#else
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#endif
+#endif
+
+#include <complex>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+namespace gpu {
+
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+using BlasHandle = hipblasHandle_t;
+#else
+using BlasHandle = cublasHandle_t;
+#endif
+#else
+using BlasHandle = void*;
+#endif
+
+/** Returns the current GPU of the calling thread. **/
+inline bool getDevice(int * device)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  if(hipGetDevice(device) == hipSuccess) return true;
+  hipGetLastError();
+#else
+  if(cudaGetDevice(device) == cudaSuccess) return true;
+  cudaGetLastError();
+#endif
+#endif
+  return false;
+}
+
+/** Sets the current GPU of the calling thread. **/
+inline bool setDevice(int device)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  if(hipSetDevice(device) == hipSuccess) return true;
+  hipGetLastError();
+#else
+  if(cudaSetDevice(device) == cudaSuccess) return true;
+  cudaGetLastError();
+#endif
+#endif
+  return false;
+}
+
+/** Synchronizes the default stream of the current GPU.
+    Returns zero on success, otherwise the GPU runtime error code. **/
+inline int synchronizeDefaultStream()
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  const auto error = hipStreamSynchronize(0);
+  if(error == hipSuccess) return 0;
+  hipGetLastError();
+#else
+  const auto error = cudaStreamSynchronize(0);
+  if(error == cudaSuccess) return 0;
+  cudaGetLastError();
+#endif
+  return static_cast<int>(error);
+#else
+  return -1;
+#endif
+}
+
+/** Returns TRUE if a Host memory pointer belongs to pinned (page-locked) memory. **/
+inline bool isPinnedHostMemory(const void * ptr)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  hipPointerAttribute_t attributes;
+  if(hipPointerGetAttributes(&attributes,ptr) == hipSuccess){
+#if HIP_VERSION_MAJOR >= 6
+    return (attributes.type == hipMemoryTypeHost);
+#else
+    return (attributes.memoryType == hipMemoryTypeHost);
+#endif
+  }
+  hipGetLastError(); //clear the error of querying an unregistered pointer
+#else
+  cudaPointerAttributes attributes;
+  if(cudaPointerGetAttributes(&attributes,ptr) == cudaSuccess) return (attributes.type == cudaMemoryTypeHost);
+  cudaGetLastError(); //clear the error of querying an unregistered pointer
+#endif
+#endif
+  return false;
+}
+
+/** Registers a Host memory range as pinned memory accessible by all GPUs.
+    Returns zero on success, otherwise the GPU runtime error code. **/
+inline int registerHostMemory(void * ptr, std::size_t size)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  const auto error = hipHostRegister(ptr,size,hipHostRegisterPortable);
+  if(error == hipSuccess) return 0;
+  hipGetLastError();
+#else
+  const auto error = cudaHostRegister(ptr,size,cudaHostRegisterPortable);
+  if(error == cudaSuccess) return 0;
+  cudaGetLastError();
+#endif
+  return static_cast<int>(error);
+#else
+  return -1;
+#endif
+}
+
+/** Unregisters a Host memory range registered by registerHostMemory(). **/
+inline void unregisterHostMemory(void * ptr)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  if(hipHostUnregister(ptr) != hipSuccess) hipGetLastError();
+#else
+  if(cudaHostUnregister(ptr) != cudaSuccess) cudaGetLastError();
+#endif
+#endif
+  return;
+}
+
+/** Returns the description of a GPU runtime error code. **/
+inline const char * errorString(int error)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return hipGetErrorString(static_cast<hipError_t>(error));
+#else
+  return cudaGetErrorString(static_cast<cudaError_t>(error));
+#endif
+#else
+  return "No GPU support";
+#endif
+}
+
+/** Creates a BLAS handle on the current GPU (it uses the default stream). **/
+inline bool createBlasHandle(BlasHandle * handle)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return (hipblasCreate(handle) == HIPBLAS_STATUS_SUCCESS);
+#else
+  return (cublasCreate(handle) == CUBLAS_STATUS_SUCCESS);
+#endif
+#else
+  return false;
+#endif
+}
+
+/** Scales a device-resident vector in place by BLAS (asynchronously in the default stream). **/
+inline bool scale(BlasHandle handle, int n, float alpha, float * x)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return (hipblasSscal(handle,n,&alpha,x,1) == HIPBLAS_STATUS_SUCCESS);
+#else
+  return (cublasSscal(handle,n,&alpha,x,1) == CUBLAS_STATUS_SUCCESS);
+#endif
+#else
+  return false;
+#endif
+}
+
+inline bool scale(BlasHandle handle, int n, double alpha, double * x)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return (hipblasDscal(handle,n,&alpha,x,1) == HIPBLAS_STATUS_SUCCESS);
+#else
+  return (cublasDscal(handle,n,&alpha,x,1) == CUBLAS_STATUS_SUCCESS);
+#endif
+#else
+  return false;
+#endif
+}
+
+inline bool scale(BlasHandle handle, int n, std::complex<float> alpha, std::complex<float> * x)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return (hipblasCscal(handle,n,reinterpret_cast<const hipblasComplex*>(&alpha),
+                       reinterpret_cast<hipblasComplex*>(x),1) == HIPBLAS_STATUS_SUCCESS);
+#else
+  return (cublasCscal(handle,n,reinterpret_cast<const cuComplex*>(&alpha),
+                      reinterpret_cast<cuComplex*>(x),1) == CUBLAS_STATUS_SUCCESS);
+#endif
+#else
+  return false;
+#endif
+}
+
+inline bool scale(BlasHandle handle, int n, std::complex<double> alpha, std::complex<double> * x)
+{
+#ifndef NO_GPU
+#ifdef EXATN_HIP
+  return (hipblasZscal(handle,n,reinterpret_cast<const hipblasDoubleComplex*>(&alpha),
+                       reinterpret_cast<hipblasDoubleComplex*>(x),1) == HIPBLAS_STATUS_SUCCESS);
+#else
+  return (cublasZscal(handle,n,reinterpret_cast<const cuDoubleComplex*>(&alpha),
+                      reinterpret_cast<cuDoubleComplex*>(x),1) == CUBLAS_STATUS_SUCCESS);
+#endif
+#else
+  return false;
+#endif
+}
+
+} //namespace gpu
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_GPU_RUNTIME_HPP_
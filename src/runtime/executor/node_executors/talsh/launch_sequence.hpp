@@ -0,0 +1,121 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: Recurring accelerator launch sequences
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) Iterative algorithms (sweeps, slices) issue the same sequence of accelerator launches
+     (tensor contractions of the same index patterns and shapes, on different tensors)
+     between consecutive synchronization points of the node executor over and over.
+     The launch sequence records the signature (shape hash) of each launch together with
+     the launch decision made for it (execution device). At each synchronization point,
+     the recorded sequence is committed and compared with the previously committed one:
+     Once two consecutive sequences are identical, the sequence is recurring and the next
+     occurrence replays the committed launch decisions position by position, thus skipping
+     the per-launch decision making. The first launch whose signature deviates from
+     the committed sequence stops the replay until the sequence recurs again.
+ (b) The launch sequence is used by the thread executing the tensor operations only (not thread-safe).
+**/
+
+#ifndef EXATN_RUNTIME_LAUNCH_SEQUENCE_HPP_
+#define EXATN_RUNTIME_LAUNCH_SEQUENCE_HPP_
+
+#include <vector>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+class LaunchSequence {
+
+public:
+
+  static constexpr const std::size_t MAX_LENGTH = 65536; //max number of recorded launches between synchronization points
+
+  /** Launch decision **/
+  struct Launch {
+    std::size_t signature; //launch signature (shape hash)
+    int device;            //execution device (flat device id)
+  };
+
+  LaunchSequence(): active_(false), recurring_(false), replaying_(false), overflow_(false), num_replayed_(0) {}
+
+  LaunchSequence(const LaunchSequence &) = delete;
+  LaunchSequence & operator=(const LaunchSequence &) = delete;
+  LaunchSequence(LaunchSequence &&) noexcept = delete;
+  LaunchSequence & operator=(LaunchSequence &&) noexcept = delete;
+  ~LaunchSequence() = default;
+
+  /** Activates/deactivates the recording and replay of launch sequences. **/
+  void activate(bool active)
+  {
+    active_ = active;
+    committed_.clear();
+    current_.clear();
+    recurring_ = false; replaying_ = false; overflow_ = false;
+    return;
+  }
+
+  /** Returns TRUE if the recording and replay of launch sequences is active. **/
+  inline bool isActive() const {return active_;}
+
+  /** Returns the committed launch decision for the next launch with a given signature
+      if the launch sequence is being replayed, otherwise returns FALSE. **/
+  bool next(std::size_t signature, Launch * launch)
+  {
+    if(!replaying_) return false;
+    const auto position = current_.size();
+    if(position < committed_.size() && committed_[position].signature == signature){
+      *launch = committed_[position];
+      return true;
+    }
+    replaying_ = false; //the launch sequence deviates
+    return false;
+  }
+
+  /** Records a launch (after its launch decision was obtained via next()). **/
+  void record(std::size_t signature, int device)
+  {
+    if(current_.size() < MAX_LENGTH){
+      if(replaying_) ++num_replayed_;
+      current_.emplace_back(Launch{signature,device});
+    }else{
+      overflow_ = true;
+      replaying_ = false;
+    }
+    return;
+  }
+
+  /** Commits the launch sequence recorded since the previous synchronization point. **/
+  void commit()
+  {
+    if(current_.empty()) return; //no accelerator launches
+    bool identical = (!overflow_ && current_.size() == committed_.size());
+    for(std::size_t i = 0; identical && i < current_.size(); ++i) identical = (current_[i].signature == committed_[i].signature);
+    if(!identical || !recurring_) committed_.swap(current_); //the replayed launch decisions stay committed
+    recurring_ = identical;
+    replaying_ = recurring_;
+    overflow_ = false;
+    current_.clear();
+    return;
+  }
+
+  /** Returns the total number of replayed launches. **/
+  inline std::size_t getNumReplayed() const {return num_replayed_;}
+
+private:
+
+  bool active_;                    //recording and replay of launch sequences is active
+  bool recurring_;                 //the committed launch sequence has recurred
+  bool replaying_;                 //the committed launch sequence is being replayed
+  bool overflow_;                  //the current launch sequence exceeded the max length
+  std::size_t num_replayed_;       //total number of replayed launches
+  std::vector<Launch> committed_;  //committed launch sequence
+  std::vector<Launch> current_;    //launch sequence recorded since the previous synchronization point
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_LAUNCH_SEQUENCE_HPP_
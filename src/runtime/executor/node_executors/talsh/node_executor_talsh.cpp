@@ -1,21 +1,47 @@
 /** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh
-REVISION: 2022/01/17
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 **/
 
 #include "node_executor_talsh.hpp"
+#include "gpu_runtime.hpp"
 
 #ifdef MPI_ENABLED
 #include "mpi.h"
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
 #include <complex>
+#include <type_traits>
+#include <fstream>
+#include <chrono>
+#include <random>
 #include <limits>
 #include <mutex>
+#include <cmath>
 
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#include "functor_init_val.hpp"
+#include "functor_scale.hpp"
+#include "tensor_method_device.hpp"
+#include "half_float.hpp"
 
 #include "errors.hpp"
 
@@ -28,6 +54,18 @@ std::atomic<bool> TalshNodeExecutor::talsh_initialized_{false};
 std::atomic<int> TalshNodeExecutor::talsh_node_exec_count_{0};
 std::atomic<std::size_t> TalshNodeExecutor::talsh_host_mem_buffer_size_{0};
 std::atomic<double> TalshNodeExecutor::talsh_submitted_flops_{0.0};
+std::atomic<std::size_t> TalshNodeExecutor::talsh_h2d_bytes_{0};
+std::atomic<std::size_t> TalshNodeExecutor::talsh_d2h_bytes_{0};
+std::atomic<std::size_t> TalshNodeExecutor::talsh_tensor_bytes_{0};
+std::atomic<bool> TalshNodeExecutor::talsh_fast_math_default_{false};
+std::atomic<bool> TalshNodeExecutor::talsh_fast_math_active_{false};
+std::vector<int> TalshNodeExecutor::talsh_gpus_;
+int TalshNodeExecutor::talsh_node_process_rank_{-1};
+int TalshNodeExecutor::talsh_node_num_processes_{0};
+bool TalshNodeExecutor::talsh_numa_first_touch_{false};
+std::size_t TalshNodeExecutor::talsh_huge_page_size_{0};
+bool TalshNodeExecutor::talsh_pin_host_buffer_{false};
+bool TalshNodeExecutor::talsh_host_buffer_pinned_{false};
 
 std::mutex talsh_init_lock;
 
@@ -48,1546 +86,4797 @@ inline MPI_Datatype get_mpi_tensor_element_kind(int talsh_data_kind)
  }
  return mpi_data_kind;
 }
-#endif
 
+/** Half-precision MPI data kinds (binary16 real and complex) and their summation operations,
+    created on first use and kept until MPI is finalized. **/
+static void mpi_sum_half_real(void * in, void * inout, int * len, MPI_Datatype * data_kind)
+{
+ const auto * src = static_cast<const numerics::Float16*>(in);
+ auto * dst = static_cast<numerics::Float16*>(inout);
+ for(int i = 0; i < *len; ++i) dst[i] = static_cast<float>(dst[i]) + static_cast<float>(src[i]);
+ return;
+}
 
-void TalshNodeExecutor::initialize(const ParamConf & parameters)
+static void mpi_sum_half_complex(void * in, void * inout, int * len, MPI_Datatype * data_kind)
 {
-#ifdef DEBUG
-  const bool debugging = true;
-#else
-  const bool debugging = false;
-#endif
- talsh_init_lock.lock();
- if(!(talsh_initialized_.load())){
-  std::size_t host_mem_buffer_size = DEFAULT_MEM_BUFFER_SIZE;
-  int64_t provided_buf_size = 0;
-  if(parameters.getParameter("host_memory_buffer_size",&provided_buf_size))
-   host_mem_buffer_size = provided_buf_size;
-  auto error_code = talsh::initialize(&host_mem_buffer_size);
-  if(error_code == TALSH_SUCCESS){
-   talsh_host_mem_buffer_size_.store(host_mem_buffer_size);
-   if(debugging) std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): TAL-SH initialized with Host buffer size of " <<
-    talsh_host_mem_buffer_size_.load() << " bytes" << std::endl << std::flush; //debug
-   talsh_initialized_.store(true);
-  }else{
-   std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to initialize TAL-SH!" << std::endl << std::flush;
-   assert(false);
-  }
+ const auto * src = static_cast<const numerics::ComplexFloat16*>(in);
+ auto * dst = static_cast<numerics::ComplexFloat16*>(inout);
+ for(int i = 0; i < *len; ++i){
+  dst[i] = static_cast<std::complex<float>>(dst[i]) + static_cast<std::complex<float>>(src[i]);
  }
- ++talsh_node_exec_count_;
- talsh_init_lock.unlock();
  return;
 }
 
+struct MPIHalfKinds{
+ MPI_Datatype real_kind;
+ MPI_Datatype complex_kind;
+ MPI_Op real_sum;
+ MPI_Op complex_sum;
+};
 
-void TalshNodeExecutor::activateDryRun(bool dry_run)
+static const MPIHalfKinds & get_mpi_half_kinds()
 {
- dry_run_.store(dry_run);
- return;
+ static MPIHalfKinds kinds;
+ static std::once_flag created;
+ std::call_once(created,[](){
+  int errc = MPI_Type_contiguous(sizeof(numerics::Float16),MPI_BYTE,&kinds.real_kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Type_commit(&kinds.real_kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Type_contiguous(sizeof(numerics::ComplexFloat16),MPI_BYTE,&kinds.complex_kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Type_commit(&kinds.complex_kind); assert(errc == MPI_SUCCESS);
+  errc = MPI_Op_create(&mpi_sum_half_real,1,&kinds.real_sum); assert(errc == MPI_SUCCESS);
+  errc = MPI_Op_create(&mpi_sum_half_complex,1,&kinds.complex_sum); assert(errc == MPI_SUCCESS);
+ });
+ return kinds;
 }
 
+/** Executes a broadcast (root_rank >= 0) or an allreduce (root_rank < 0) of a tensor body
+    in reduced precision: The tensor body is converted chunk by chunk into a double buffer,
+    such that the conversion of the next chunk overlaps with the non-blocking collective
+    on the current chunk. All MPI processes (including the root) store back the rounded
+    values, thus keeping all replicas of the tensor identical. Returns the MPI error code. **/
+template <typename FullType, typename ReducedType>
+static int reduced_precision_collective(FullType * body,                //inout: tensor body
+                                        std::size_t volume,             //in: tensor volume
+                                        std::size_t chunk,              //in: chunk size (elements)
+                                        MPI_Datatype mpi_reduced_kind,  //in: MPI data kind of the reduced precision
+                                        MPI_Comm communicator,          //in: MPI communicator
+                                        int root_rank,                  //in: root rank (broadcast) or negative (allreduce)
+                                        MPI_Op mpi_sum = MPI_SUM)       //in: MPI summation operation for the reduced precision
+{
+ int error_code = MPI_SUCCESS;
+ if(volume == 0) return error_code;
+ int my_rank = 0;
+ if(root_rank >= 0){error_code = MPI_Comm_rank(communicator,&my_rank); if(error_code != MPI_SUCCESS) return error_code;}
+ const bool send_data = (root_rank < 0 || my_rank == root_rank);
+ chunk = std::min(chunk,volume);
+ std::vector<ReducedType> buffers[2] = {std::vector<ReducedType>(chunk),std::vector<ReducedType>(chunk)};
+ MPI_Request requests[2];
+ const std::size_t num_chunks = (volume + chunk - 1) / chunk;
+ auto post_chunk = [&](std::size_t i){
+  const std::size_t base = i * chunk;
+  const int count = static_cast<int>(std::min(chunk,volume-base));
+  auto & buf = buffers[i%2];
+  if(send_data){
+   for(int k = 0; k < count; ++k) buf[k] = static_cast<ReducedType>(body[base+k]);
+  }
+  if(root_rank >= 0){
+   return MPI_Ibcast((void*)(buf.data()),count,mpi_reduced_kind,root_rank,communicator,&(requests[i%2]));
+  }
+  return MPI_Iallreduce(MPI_IN_PLACE,(void*)(buf.data()),count,mpi_reduced_kind,mpi_sum,communicator,&(requests[i%2]));
+ };
+ error_code = post_chunk(0);
+ for(std::size_t i = 0; i < num_chunks && error_code == MPI_SUCCESS; ++i){
+  if(i + 1 < num_chunks) error_code = post_chunk(i+1); //overlaps with the collective on chunk i
+  int errc = MPI_Wait(&(requests[i%2]),MPI_STATUS_IGNORE);
+  if(error_code == MPI_SUCCESS) error_code = errc;
+  if(error_code != MPI_SUCCESS) break;
+  const std::size_t base = i * chunk;
+  const std::size_t count = std::min(chunk,volume-base);
+  const auto & buf = buffers[i%2];
+  for(std::size_t k = 0; k < count; ++k) body[base+k] = static_cast<FullType>(buf[k]);
+ }
+ return error_code;
+}
 
-void TalshNodeExecutor::activateFastMath()
+/** Returns the payload volume (bytes) of the MPI transfer of a tensor body,
+    halved by the single-precision transfer of a double-precision tensor. **/
+static std::size_t transfer_size(const numerics::Tensor & tensor, bool reduced_precision)
 {
- while(!(talsh_initialized_.load()));
- auto activated = talsh::enableFastMath(DEV_HOST);
- activated = talsh::enableFastMath(DEV_NVIDIA_GPU);
- return;
+ const auto elem_type = tensor.getElementType();
+ const bool reduced = reduced_precision &&
+  (elem_type == TensorElementType::REAL64 || elem_type == TensorElementType::COMPLEX64);
+ return reduced ? (tensor.getSize() / 2) : tensor.getSize();
 }
+#endif
 
 
-std::size_t TalshNodeExecutor::getMemoryBufferSize() const
+/** Returns the squared 2-norm of a tensor body. **/
+template <typename NumericType>
+static inline double norm2_squared(const NumericType * body, std::size_t volume)
 {
- while(!(talsh_initialized_.load()));
- std::size_t buf_size = talsh_host_mem_buffer_size_.load();
- while(buf_size == 0) buf_size = talsh_host_mem_buffer_size_.load();
- return buf_size;
+ double sum = 0.0;
+#pragma omp parallel for schedule(guided) shared(body,volume) reduction(+:sum)
+ for(std::size_t i = 0; i < volume; ++i) sum += static_cast<double>(std::norm(body[i]));
+ return sum;
 }
 
 
-std::size_t TalshNodeExecutor::getMemoryUsage(std::size_t * free_mem) const
+/** Computes the 2-norm of a TAL-SH tensor if its body image is on Host. **/
+static bool host_norm2(const talsh::Tensor & talsh_tens, double * norm)
 {
- while(!(talsh_initialized_.load()));
- std::size_t total_size = talsh_host_mem_buffer_size_.load();
- while(total_size == 0) total_size = talsh_host_mem_buffer_size_.load();
- assert(free_mem != nullptr);
- *free_mem = talshDeviceBufferFreeSize(0,DEV_HOST);
- std::size_t used_size = total_size - (*free_mem);
- return used_size;
+ const auto volume = talsh_tens.getVolume();
+ double sum = 0.0;
+ bool accessed = false;
+ {const float * body = nullptr;
+  if(talsh_tens.getDataAccessHostConst(&body)){sum = norm2_squared(body,volume); accessed = true;}}
+ if(!accessed){const double * body = nullptr;
+  if(talsh_tens.getDataAccessHostConst(&body)){sum = norm2_squared(body,volume); accessed = true;}}
+ if(!accessed){const std::complex<float> * body = nullptr;
+  if(talsh_tens.getDataAccessHostConst(&body)){sum = norm2_squared(body,volume); accessed = true;}}
+ if(!accessed){const std::complex<double> * body = nullptr;
+  if(talsh_tens.getDataAccessHostConst(&body)){sum = norm2_squared(body,volume); accessed = true;}}
+ if(accessed) *norm = std::sqrt(sum);
+ return accessed;
 }
 
 
-double TalshNodeExecutor::getTotalFlopCount() const
+/** Returns TRUE if a given tensor operation initializes its tensor to zero. **/
+static bool is_zero_initialization(const numerics::TensorOperation & op)
 {
- return talsh_submitted_flops_.load();
+ if(op.getOpcode() != TensorOpCode::TRANSFORM) return false;
+ const auto * transform = dynamic_cast<const numerics::TensorOpTransform*>(&op);
+ if(transform == nullptr) return false;
+ const auto init_val = std::dynamic_pointer_cast<numerics::FunctorInitVal>(transform->getFunctor());
+ if(!init_val) return false;
+ return (init_val->getValue() == std::complex<double>(0.0,0.0));
 }
 
 
-TalshNodeExecutor::~TalshNodeExecutor()
+/** Scales a tensor body resident on a GPU in place by cuBLAS/hipBLAS (as FunctorScale does:
+    real tensors are scaled by the real part of the scalar). Returns zero on success, or
+    numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED if the scaling cannot be done on the device. **/
+static int scale_on_device(void * body,                //inout: device-resident tensor body
+                           std::size_t volume,         //in: tensor volume
+                           int data_kind,              //in: TAL-SH data kind
+                           int device_kind,            //in: TAL-SH device kind
+                           int device_id,              //in: device id within its kind
+                           std::complex<double> value) //in: scaling value
 {
-#ifdef DEBUG
-  const bool debugging = true;
-#else
-  const bool debugging = false;
-#endif
- auto synced = sync(); assert(synced);
- talsh_init_lock.lock();
- --talsh_node_exec_count_;
- if(talsh_initialized_.load() && talsh_node_exec_count_.load() == 0){
-  tasks_.clear();
-  tensors_.clear();
-  talsh::printStatistics();
-  auto error_code = talsh::shutdown();
-  if(error_code == TALSH_SUCCESS){
-   if(debugging){
-    std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): TAL-SH shut down" << std::endl;
-    std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): Max encountered actual (reduced) tensor rank = "
-              << max_tensor_rank_ << std::endl << std::flush;
-   }
-   talsh_initialized_.store(false);
-  }else{
-   std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to shut down TAL-SH!" << std::endl;
-   assert(false);
+ int error_code = numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED;
+#ifndef NO_GPU
+ if(device_kind != DEV_NVIDIA_GPU || device_id < 0 || device_id >= MAX_GPUS_PER_NODE) return error_code;
+ if(volume > static_cast<std::size_t>(std::numeric_limits<int>::max())) return error_code;
+ static gpu::BlasHandle handles[MAX_GPUS_PER_NODE] = {nullptr};
+ static std::mutex handles_lock;
+ int current_device = -1;
+ if(!gpu::getDevice(&current_device)) return error_code;
+ if(!gpu::setDevice(device_id)) return error_code;
+ const std::lock_guard<std::mutex> lock(handles_lock);
+ if(handles[device_id] == nullptr){
+  if(!gpu::createBlasHandle(&(handles[device_id]))) handles[device_id] = nullptr;
+ }
+ if(handles[device_id] != nullptr){
+  const int n = static_cast<int>(volume);
+  bool scaled = false;
+  switch(data_kind){
+  case(talsh::REAL32):
+   scaled = gpu::scale(handles[device_id],n,static_cast<float>(value.real()),static_cast<float*>(body));
+   break;
+  case(talsh::REAL64):
+   scaled = gpu::scale(handles[device_id],n,value.real(),static_cast<double*>(body));
+   break;
+  case(talsh::COMPLEX32):
+   scaled = gpu::scale(handles[device_id],n,std::complex<float>(value),static_cast<std::complex<float>*>(body));
+   break;
+  case(talsh::COMPLEX64):
+   scaled = gpu::scale(handles[device_id],n,value,static_cast<std::complex<double>*>(body));
+   break;
   }
+  if(scaled) error_code = gpu::synchronizeDefaultStream(); //BLAS handles use the default stream
  }
- talsh_init_lock.unlock();
+ gpu::setDevice(current_device);
+#endif
+ return error_code;
 }
 
 
-TalshNodeExecutor::TensorImpl::TensorImpl(const std::vector<std::size_t> & full_offsets,
-                                          const std::vector<DimExtent> & full_extents,
-                                          const std::vector<std::size_t> & reduced_offsets,
-                                          const std::vector<int> & reduced_extents,
-                                          int data_kind):
- talsh_tensor(new talsh::Tensor(reduced_offsets,reduced_extents,data_kind,talsh_tens_no_init)),
- full_base_offsets(full_offsets), reduced_base_offsets(reduced_offsets),
- stored_shape(nullptr), full_shape_is_on(false)
+/** Returns the Host body of a TAL-SH tensor (nullptr if its body image is not on Host). **/
+static void * host_body(talsh::Tensor & talsh_tens)
 {
- auto errc = tensShape_create(&stored_shape); assert(errc == TALSH_SUCCESS);
- int full_rank = full_extents.size();
- int dims[full_rank];
- for(int i = 0; i < full_rank; ++i){
-  if(full_extents[i] > static_cast<DimExtent>(std::numeric_limits<int>::max())){
-   std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): CREATE: Tensor dimension extent exceeds max int: "
-             << full_extents[i] << std::endl << std::flush;
-   assert(false);
-  }
-  dims[i] = full_extents[i];
+ {float * body = nullptr; if(talsh_tens.getDataAccessHost(&body)) return static_cast<void*>(body);}
+ {double * body = nullptr; if(talsh_tens.getDataAccessHost(&body)) return static_cast<void*>(body);}
+ {std::complex<float> * body = nullptr; if(talsh_tens.getDataAccessHost(&body)) return static_cast<void*>(body);}
+ {std::complex<double> * body = nullptr; if(talsh_tens.getDataAccessHost(&body)) return static_cast<void*>(body);}
+ return nullptr;
+}
+
+
+/** Transposes the Host body of a TAL-SH tensor into the Host body of another TAL-SH tensor
+    of the same data kind: dest = alpha * permuted(src) (+ dest, if accumulative). **/
+static bool transpose_host_body(const TensorTransposePlan & plan,
+                                int data_kind,
+                                void * dest_body,
+                                const void * src_body,
+                                const std::complex<double> alpha,
+                                bool accumulative,
+                                bool conj)
+{
+ switch(data_kind){
+ case talsh::REAL32:
+  tensor_transpose(plan,static_cast<float*>(dest_body),static_cast<const float*>(src_body),
+                   static_cast<float>(alpha.real()),accumulative);
+  break;
+ case talsh::REAL64:
+  tensor_transpose(plan,static_cast<double*>(dest_body),static_cast<const double*>(src_body),
+                   alpha.real(),accumulative);
+  break;
+ case talsh::COMPLEX32:
+  tensor_transpose(plan,static_cast<std::complex<float>*>(dest_body),static_cast<const std::complex<float>*>(src_body),
+                   std::complex<float>(alpha),accumulative,conj);
+  break;
+ case talsh::COMPLEX64:
+  tensor_transpose(plan,static_cast<std::complex<double>*>(dest_body),static_cast<const std::complex<double>*>(src_body),
+                   alpha,accumulative,conj);
+  break;
+ default:
+  return false;
  }
- errc = tensShape_construct(stored_shape,NOPE,full_rank,dims); assert(errc == TALSH_SUCCESS);
+ return true;
 }
 
 
-TalshNodeExecutor::TensorImpl::TensorImpl(TalshNodeExecutor::TensorImpl && other) noexcept:
- talsh_tensor(std::move(other.talsh_tensor)),
- full_base_offsets(std::move(other.full_base_offsets)),
- reduced_base_offsets(std::move(other.reduced_base_offsets)),
- stored_shape(other.stored_shape), full_shape_is_on(other.full_shape_is_on)
+/** Splits a complex Host tensor body into its real part, its imaginary part (negated if complex conjugated)
+    and their sum (3M algorithm). **/
+template <typename RealType>
+static void gauss_split(const std::complex<RealType> * body,
+                        std::size_t volume,
+                        bool conj,
+                        RealType * real_part,
+                        RealType * imag_part,
+                        RealType * sum_part)
 {
- other.stored_shape = nullptr;
+ const RealType sign = conj ? RealType(-1) : RealType(1);
+#pragma omp parallel for schedule(static)
+ for(std::size_t i = 0; i < volume; ++i){
+  real_part[i] = body[i].real();
+  imag_part[i] = sign * body[i].imag();
+  sum_part[i] = real_part[i] + imag_part[i];
+ }
+ return;
 }
 
 
-TalshNodeExecutor::TensorImpl & TalshNodeExecutor::TensorImpl::operator=(TalshNodeExecutor::TensorImpl && other) noexcept
+/** Combines the three real products of the 3M algorithm into a complex Host tensor body:
+    body = alpha * ((t1 - t2) + i(t3 - t1 - t2)) (+ body, if accumulative). **/
+template <typename RealType>
+static void gauss_combine(std::complex<RealType> * body,
+                          std::size_t volume,
+                          const RealType * t1,
+                          const RealType * t2,
+                          const RealType * t3,
+                          std::complex<RealType> alpha,
+                          bool accumulative)
 {
- if(this != &other){
-  if(stored_shape != nullptr){
-   resetTensorShapeToReduced();
-   auto errc = tensShape_destroy(stored_shape); assert(errc == TALSH_SUCCESS);
+#pragma omp parallel for schedule(static)
+ for(std::size_t i = 0; i < volume; ++i){
+  const std::complex<RealType> value = alpha * std::complex<RealType>(t1[i] - t2[i],t3[i] - t1[i] - t2[i]);
+  body[i] = accumulative ? (body[i] + value) : value;
+ }
+ return;
+}
+
+
+/** Constructs a TAL-SH tensor either owning its body or aliasing an external body (non-owning). **/
+static std::unique_ptr<talsh::Tensor> make_talsh_tensor(const std::vector<std::size_t> & offsets,
+                                                        const std::vector<int> & extents,
+                                                        int data_kind,
+                                                        void * ext_body)
+{
+ std::unique_ptr<talsh::Tensor> talsh_tensor;
+ if(ext_body == nullptr){
+  talsh_tensor.reset(new talsh::Tensor(offsets,extents,data_kind,talsh_tens_no_init));
+ }else{ //TAL-SH tensor aliasing an external body which it does not own
+  switch(data_kind){
+   case talsh::REAL32:
+    talsh_tensor.reset(new talsh::Tensor(offsets,extents,static_cast<float*>(ext_body)));
+    break;
+   case talsh::REAL64:
+    talsh_tensor.reset(new talsh::Tensor(offsets,extents,static_cast<double*>(ext_body)));
+    break;
+   case talsh::COMPLEX32:
+    talsh_tensor.reset(new talsh::Tensor(offsets,extents,static_cast<std::complex<float>*>(ext_body)));
+    break;
+   case talsh::COMPLEX64:
+    talsh_tensor.reset(new talsh::Tensor(offsets,extents,static_cast<std::complex<double>*>(ext_body)));
+    break;
+   default:
+    std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): Invalid tensor element type for an external body!"
+              << std::endl << std::flush;
+    assert(false);
   }
-  stored_shape = other.stored_shape;
-  other.stored_shape = nullptr;
-  full_base_offsets = std::move(other.full_base_offsets);
-  reduced_base_offsets = std::move(other.reduced_base_offsets);
-  talsh_tensor = std::move(other.talsh_tensor);
-  full_shape_is_on = other.full_shape_is_on;
  }
- return *this;
+ return talsh_tensor;
 }
 
 
-TalshNodeExecutor::TensorImpl::~TensorImpl()
+/** Scales the Host body of a TAL-SH tensor by a scalar (returns FALSE if its body image is not on Host
+    or the scalar is complex while the tensor is real). **/
+static bool scale_host_body(talsh::Tensor & talsh_tens, const std::complex<double> factor)
 {
- if(stored_shape != nullptr){
-  resetTensorShapeToReduced();
-  auto errc = tensShape_destroy(stored_shape); assert(errc == TALSH_SUCCESS);
-  stored_shape = nullptr;
+ const auto volume = talsh_tens.getVolume();
+ const bool real_factor = (factor.imag() == 0.0);
+ {float * body = nullptr; if(talsh_tens.getDataAccessHost(&body)){
+   if(!real_factor) return false;
+   const float val = static_cast<float>(factor.real());
+#pragma omp parallel for schedule(static)
+   for(std::size_t i = 0; i < volume; ++i) body[i] *= val;
+   return true;
+ }}
+ {double * body = nullptr; if(talsh_tens.getDataAccessHost(&body)){
+   if(!real_factor) return false;
+   const double val = factor.real();
+#pragma omp parallel for schedule(static)
+   for(std::size_t i = 0; i < volume; ++i) body[i] *= val;
+   return true;
+ }}
+ {std::complex<float> * body = nullptr; if(talsh_tens.getDataAccessHost(&body)){
+   const std::complex<float> val(factor);
+#pragma omp parallel for schedule(static)
+   for(std::size_t i = 0; i < volume; ++i) body[i] *= val;
+   return true;
+ }}
+ {std::complex<double> * body = nullptr; if(talsh_tens.getDataAccessHost(&body)){
+#pragma omp parallel for schedule(static)
+   for(std::size_t i = 0; i < volume; ++i) body[i] *= factor;
+   return true;
+ }}
+ return false;
+}
+
+
+/** Fills a tensor body with (complex) normally distributed random numbers. **/
+template <typename RealType>
+static void fill_gaussian(RealType * body, std::size_t volume, std::mt19937_64 & generator)
+{
+ std::normal_distribution<RealType> distribution(0.0,1.0);
+ for(std::size_t i = 0; i < volume; ++i) body[i] = distribution(generator);
+}
+
+template <typename RealType>
+static void fill_gaussian(std::complex<RealType> * body, std::size_t volume, std::mt19937_64 & generator)
+{
+ std::normal_distribution<RealType> distribution(0.0,1.0);
+ for(std::size_t i = 0; i < volume; ++i){
+  const RealType re = distribution(generator);
+  const RealType im = distribution(generator);
+  body[i] = std::complex<RealType>(re,im);
  }
 }
 
 
-void TalshNodeExecutor::TensorImpl::resetTensorShapeToFull()
+/** Scales the slices of a tensor body by the factors associated with the multi-index
+    of its bond dimensions (the first bond dimension is the fastest one). **/
+template <typename NumericType>
+static void scale_bonds(NumericType * body,                      //inout: tensor body
+                        const std::vector<int> & extents,        //in: tensor dimension extents
+                        const std::vector<unsigned int> & bonds, //in: positions of the bond dimensions
+                        const std::vector<double> & factors)     //in: factor for each bond multi-index
 {
- if(!full_shape_is_on){
-  talsh_tensor->resetDimOffsets(full_base_offsets);
-  auto * talsh_tens = talsh_tensor->getTalshTensorPtr();
-  talsh_tens_shape_t * current_shape = talsh_tens->shape_p;
-  assert(current_shape != nullptr && stored_shape != nullptr);
-  talsh_tens->shape_p = stored_shape;
-  stored_shape = current_shape;
-  full_shape_is_on = true;
+ using RealType = decltype(std::real(NumericType()));
+ const auto rank = extents.size();
+ std::size_t volume = 1;
+ for(const auto & extent: extents) volume *= extent;
+ std::vector<std::size_t> strides(rank,0);
+ std::size_t stride = 1;
+ for(const auto & bond: bonds){strides[bond] = stride; stride *= extents[bond];}
+ std::vector<int> mlndx(rank,0);
+ std::size_t bond_offset = 0;
+ for(std::size_t i = 0; i < volume; ++i){
+  body[i] *= static_cast<RealType>(factors[bond_offset]);
+  for(unsigned int j = 0; j < rank; ++j){ //next multi-index
+   if(++(mlndx[j]) < extents[j]){bond_offset += strides[j]; break;}
+   bond_offset -= strides[j] * (extents[j] - 1);
+   mlndx[j] = 0;
+  }
  }
  return;
 }
 
+/** Reads the singular values (real parts) and zeroes those not exceeding the tolerance. **/
+template <typename NumericType>
+static void truncate_singular_values(NumericType * body,              //inout: singular values
+                                     std::size_t volume,             //in: number of singular values
+                                     double tolerance,               //in: truncation tolerance
+                                     std::vector<double> & values)   //out: truncated singular values
+{
+ values.resize(volume);
+ for(std::size_t i = 0; i < volume; ++i){
+  values[i] = std::real(body[i]);
+  if(values[i] <= tolerance){values[i] = 0.0; body[i] = NumericType(0.0);}
+ }
+ return;
+}
 
-void TalshNodeExecutor::TensorImpl::resetTensorShapeToReduced()
+/** Copies (accumulates) a contiguous run of tensor elements. **/
+template <typename NumericType>
+static inline void copy_run(NumericType * dst, const NumericType * src, std::size_t length, bool accumulative)
 {
- if(full_shape_is_on){
-  talsh_tensor->resetDimOffsets(reduced_base_offsets);
-  auto * talsh_tens = talsh_tensor->getTalshTensorPtr();
-  talsh_tens_shape_t * current_shape = talsh_tens->shape_p;
-  assert(current_shape != nullptr && stored_shape != nullptr);
-  talsh_tens->shape_p = stored_shape;
-  stored_shape = current_shape;
-  full_shape_is_on = false;
+ if(accumulative){
+#pragma omp simd
+  for(std::size_t i = 0; i < length; ++i) dst[i] += src[i];
+ }else{
+#pragma omp simd
+  for(std::size_t i = 0; i < length; ++i) dst[i] = src[i];
  }
  return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpCreate & op,
-                               TensorOpExecHandle * exec_handle)
+/** Extracts (insert == false) or inserts (insert == true) a slice of a tensor body (column-major):
+    The leading dimensions covered by the slice in full together with the first partially covered
+    dimension form the innermost contiguous run, the runs being distributed across OpenMP threads
+    in blocks of (at least) block_volume elements. **/
+template <typename NumericType>
+static void copy_slice(NumericType * tensor_body,                     //inout: tensor body
+                       NumericType * slice_body,                      //inout: slice body
+                       const std::vector<int> & tensor_extents,       //in: tensor dimension extents
+                       const std::vector<int> & slice_extents,        //in: slice dimension extents
+                       const std::vector<int> & offsets,              //in: slice offsets in the tensor
+                       bool insert,                                   //in: direction of the copy
+                       bool accumulative,                             //in: whether or not to accumulate
+                       std::size_t block_volume,                      //in: min volume of a block of runs
+                       std::size_t parallel_volume)                   //in: min slice volume copied in parallel
 {
- assert(op.isSet());
-
- const auto & tensor = *(op.getTensorOperand(0));
- const auto & tensor_signature = tensor.getSignature();
- const auto full_tensor_rank = tensor.getRank();
- const auto tensor_hash = tensor.getTensorHash();
- //Get tensor dimension extents:
- const auto & dim_extents = tensor.getDimExtents();
- //Get tensor dimension base offsets:
- std::vector<std::size_t> offsets(full_tensor_rank);
- for(int i = 0; i < full_tensor_rank; ++i){
-  auto space_id = tensor_signature.getDimSpaceId(i);
-  auto subspace_id = tensor_signature.getDimSubspaceId(i);
-  if(space_id == SOME_SPACE){
-   offsets[i] = static_cast<std::size_t>(subspace_id);
-  }else{
-   const auto * subspace = getSpaceRegister()->getSubspace(space_id,subspace_id);
-   offsets[i] = static_cast<std::size_t>(subspace->getLowerBound());
-  }
+ const unsigned int rank = tensor_extents.size();
+ std::vector<std::size_t> strides(rank);
+ std::size_t stride = 1, base = 0;
+ for(unsigned int i = 0; i < rank; ++i){
+  strides[i] = stride;
+  base += static_cast<std::size_t>(offsets[i]) * stride;
+  stride *= tensor_extents[i];
  }
- //Remove tensor dimensions of extent 1:
- unsigned int tensor_rank = 0;
- for(int i = 0; i < full_tensor_rank; ++i){
-  if(dim_extents[i] > 1){
-   if(dim_extents[i] <= static_cast<DimExtent>(std::numeric_limits<int>::max())){
-    ++tensor_rank;
+ //Innermost contiguous run:
+ std::size_t run = 1;
+ unsigned int first = 0; //first dimension outside the run
+ while(first < rank){
+  const bool full = (slice_extents[first] == tensor_extents[first]);
+  run *= slice_extents[first++];
+  if(!full) break;
+ }
+ std::size_t num_runs = 1;
+ for(unsigned int i = first; i < rank; ++i) num_runs *= slice_extents[i];
+ if(run == 0 || num_runs == 0) return;
+ const std::size_t block = std::max(static_cast<std::size_t>(1),block_volume / run); //runs per block
+ const std::size_t num_blocks = (num_runs + block - 1) / block;
+#pragma omp parallel for schedule(static) if(run * num_runs >= parallel_volume)
+ for(std::size_t b = 0; b < num_blocks; ++b){
+  const std::size_t begin = b * block;
+  const std::size_t end = std::min(begin + block,num_runs);
+  //Multi-index of the first run of the block:
+  std::vector<int> mlndx(rank,0);
+  std::size_t tens_offset = base;
+  std::size_t r = begin;
+  for(unsigned int j = first; j < rank; ++j){
+   mlndx[j] = static_cast<int>(r % slice_extents[j]);
+   r /= slice_extents[j];
+   tens_offset += static_cast<std::size_t>(mlndx[j]) * strides[j];
+  }
+  for(std::size_t i = begin; i < end; ++i){
+   if(insert){
+    copy_run(tensor_body + tens_offset,slice_body + i * run,run,accumulative);
    }else{
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CREATE: Tensor dimension extent exceeds max int: "
-              << dim_extents[i] << std::endl << std::flush;
-    assert(false);
+    copy_run(slice_body + i * run,tensor_body + tens_offset,run,accumulative);
+   }
+   for(unsigned int j = first; j < rank; ++j){ //next run
+    if(++(mlndx[j]) < slice_extents[j]){tens_offset += strides[j]; break;}
+    tens_offset -= strides[j] * (slice_extents[j] - 1);
+    mlndx[j] = 0;
    }
   }
  }
- if(static_cast<int>(tensor_rank) > max_tensor_rank_) max_tensor_rank_ = static_cast<int>(tensor_rank);
- std::vector<int> extents(tensor_rank);
- std::vector<std::size_t> bases(tensor_rank);
- tensor_rank = 0;
- for(int i = 0; i < full_tensor_rank; ++i){
-  if(dim_extents[i] > 1){
-   extents[tensor_rank] = static_cast<int>(dim_extents[i]);
-   bases[tensor_rank++] = offsets[i];
-  }
+ return;
+}
+
+
+
+void TalshNodeExecutor::initializeTalsh()
+{
+#ifdef DEBUG
+  const bool debugging = true;
+#else
+  const bool debugging = false;
+#endif
+ std::size_t host_mem_buffer_size = talsh_host_mem_buffer_size_.load();
+ int num_gpus = 0;
+ auto error_code = talshDeviceCount(DEV_NVIDIA_GPU,&num_gpus);
+ if(error_code != TALSH_SUCCESS || num_gpus < 0) num_gpus = 0;
+ talsh_gpus_.resize(num_gpus);
+ for(int gpu = 0; gpu < num_gpus; ++gpu) talsh_gpus_[gpu] = gpu;
+ if(talsh_node_process_rank_ >= 0){ //node-local GPU binding
+  talsh_gpus_ = bindNodeLocalGPUs(num_gpus,talsh_node_process_rank_,talsh_node_num_processes_);
+  int host_arg_max = 0;
+  error_code = talshInit(&host_mem_buffer_size,&host_arg_max,talsh_gpus_.size(),talsh_gpus_.data(),0,nullptr,0,nullptr);
+ }else{
+  error_code = talsh::initialize(&host_mem_buffer_size);
  }
- //Get tensor data kind:
- auto data_kind = get_talsh_tensor_element_kind(op.getTensorElementType());
- //Construct the TAL-SH tensor implementation:
- auto res = tensors_.emplace(std::make_pair(tensor_hash,TensorImpl(offsets,dim_extents,bases,extents,data_kind)));
- if(res.second){
-  if(res.first->second.talsh_tensor->isEmpty()){ //tensor has not been allocated memory due to its temporary shortage
-   tensors_.erase(res.first);
-   return TRY_LATER;
+ if(error_code == TALSH_SUCCESS){
+  talsh_host_mem_buffer_size_.store(host_mem_buffer_size);
+  if(debugging) std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): TAL-SH initialized with Host buffer size of " <<
+   talsh_host_mem_buffer_size_.load() << " bytes and " << talsh_gpus_.size() << " GPUs" << std::endl << std::flush; //debug
+  if(talsh_huge_page_size_ > 0) adviseHugePages(host_mem_buffer_size,talsh_huge_page_size_);
+  if(talsh_pin_host_buffer_) talsh_host_buffer_pinned_ = pinHostBuffer(host_mem_buffer_size);
+  if(talsh_numa_first_touch_) firstTouchHostBuffer(host_mem_buffer_size);
+  for(const auto gpu: talsh_gpus_){ //device buffers shared with other executors
+   if(talshDeviceState(gpu,DEV_NVIDIA_GPU) >= DEV_ON){
+    getDeviceMemoryManager().registerBuffer(gpu,talsh::getDeviceBufferBasePtr(DEV_NVIDIA_GPU,gpu),
+                                            talsh::getDeviceMaxBufferSize(DEV_NVIDIA_GPU,gpu));
+   }
   }
-  //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): New tensor " << tensor.getName()
-  //          << " emplaced with hash " << tensor_hash << std::endl;
+  if(talsh_fast_math_default_.load()){ //fast math activated before TAL-SH initialization
+   auto activated = talsh::enableFastMath(DEV_HOST);
+   activated = talsh::enableFastMath(DEV_NVIDIA_GPU);
+  }
+  talsh_initialized_.store(true);
  }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CREATE: Attempt to create the same tensor twice: " << std::endl;
-  tensor.printIt();
+  std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to initialize TAL-SH!" << std::endl << std::flush;
   assert(false);
  }
- *exec_handle = op.getId();
- return 0;
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpDestroy & op,
-                               TensorOpExecHandle * exec_handle)
+void TalshNodeExecutor::commitTalsh()
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ if(!(talsh_initialized_.load())){
+  std::lock_guard<std::mutex> lock(talsh_init_lock);
+  if(!(talsh_initialized_.load())) initializeTalsh();
+ }
+ return;
+}
 
- const auto & tensor = *(op.getTensorOperand(0));
- const auto tensor_hash = tensor.getTensorHash();
- auto iter = tensors_.find(tensor_hash);
- if(iter != tensors_.end()){
-  //Complete an active tensor image eviction, if any:
-  auto eviction = evictions_.find(iter->second.talsh_tensor.get());
-  if(eviction != evictions_.end()){
-   auto snc = eviction->second->wait();
-   evictions_.erase(eviction);
-  }
-  //Tensor destruction procedure:
-  bool in_use = tensorIsCurrentlyInUse(iter->second.talsh_tensor.get());
-  if(!in_use){
-   //Evict the tensor from device caches:
-   for(int dev = 0; dev < DEV_MAX; ++dev){
-    auto cached = accel_cache_[dev].find(iter->second.talsh_tensor.get());
-    if(cached != accel_cache_[dev].end()) accel_cache_[dev].erase(cached);
+
+void TalshNodeExecutor::initialize(const ParamConf & parameters)
+{
+ talsh_init_lock.lock();
+ if(exec_initialized_){ //hot reconfiguration: Tensor bodies and caches are kept (see rationale (kk))
+  int64_t provided_buf_size = 0;
+  if(parameters.getParameter("host_memory_buffer_size",&provided_buf_size)){
+   const auto host_mem_buffer_size = static_cast<std::size_t>(provided_buf_size);
+   if(!(talsh_initialized_.load())){
+    talsh_host_mem_buffer_size_.store(host_mem_buffer_size); //requested size until TAL-SH is initialized
+   }else if(host_mem_buffer_size != talsh_host_mem_buffer_size_.load()){
+    std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): Unable to resize the committed TAL-SH Host buffer to "
+              << host_mem_buffer_size << " bytes: Retained " << talsh_host_mem_buffer_size_.load() << " bytes"
+              << std::endl << std::flush;
    }
-   //Move tensor image to Host:
-   auto synced = iter->second.talsh_tensor->sync(DEV_HOST,0,nullptr,true); assert(synced);
-   //Destroy the tensor:
-   iter->second.resetTensorShapeToReduced();
-   tensors_.erase(iter);
-   //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): Tensor " << tensor.getName()
-   //          << " erased with hash " << tensor_hash << std::endl;
+  }
+ }else if(!(talsh_initialized_.load())){
+  std::size_t host_mem_buffer_size = DEFAULT_MEM_BUFFER_SIZE;
+  int64_t provided_buf_size = 0;
+  if(parameters.getParameter("host_memory_buffer_size",&provided_buf_size))
+   host_mem_buffer_size = provided_buf_size;
+  talsh_host_mem_buffer_size_.store(host_mem_buffer_size); //requested size until TAL-SH is initialized
+  std::string gpu_binding("all");
+  parameters.getParameter("gpu_binding",gpu_binding);
+  if(gpu_binding == "node_local"){
+   int64_t node_process_rank = 0, node_num_processes = 1;
+   parameters.getParameter("node_process_rank",&node_process_rank);
+   parameters.getParameter("node_num_processes",&node_num_processes);
+   talsh_node_process_rank_ = static_cast<int>(node_process_rank);
+   talsh_node_num_processes_ = static_cast<int>(node_num_processes);
+  }else if(gpu_binding == "all"){
+   talsh_node_process_rank_ = -1;
+   talsh_node_num_processes_ = 0;
   }else{
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DESTROY: Attempt to destroy an active tensor:" << std::endl;
-   tensor.printIt();
+   std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unknown GPU binding policy: " << gpu_binding << std::endl << std::flush;
    assert(false);
   }
- }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DESTROY: Attempt to destroy non-existing tensor:" << std::endl;
-  tensor.printIt();
-  assert(false);
+  int64_t numa_first_touch = 0;
+  talsh_numa_first_touch_ = false;
+  if(parameters.getParameter("host_memory_numa_first_touch",&numa_first_touch)) talsh_numa_first_touch_ = (numa_first_touch != 0);
+  std::string huge_pages("none");
+  parameters.getParameter("host_memory_huge_pages",huge_pages);
+  if(huge_pages == "none"){
+   talsh_huge_page_size_ = 0;
+  }else if(huge_pages == "2M"){
+   talsh_huge_page_size_ = HUGE_PAGE_SIZE_2M;
+  }else if(huge_pages == "1G"){
+   talsh_huge_page_size_ = HUGE_PAGE_SIZE_1G;
+  }else{
+   std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unknown huge page size: " << huge_pages << std::endl << std::flush;
+   assert(false);
+  }
+  int64_t pinned = 0;
+  talsh_pin_host_buffer_ = false;
+  if(parameters.getParameter("host_memory_pinned",&pinned)) talsh_pin_host_buffer_ = (pinned != 0);
+  int64_t eager_init = 0;
+  if(parameters.getParameter("talsh_eager_init",&eager_init)){
+   if(eager_init != 0) initializeTalsh();
+  }
  }
- *exec_handle = op.getId();
- return 0;
+ if(!exec_initialized_) ++talsh_node_exec_count_;
+ exec_initialized_ = true;
+ talsh_init_lock.unlock();
+ tensors_.reserve(TABLE_RESERVE_SIZE);
+ tasks_.reserve(TABLE_RESERVE_SIZE);
+ task_pool_.reserve(TASK_POOL_CAPACITY);
+ int64_t small_flops = 0;
+ if(parameters.getParameter("talsh_small_contraction_flops",&small_flops)){
+  if(small_flops >= 0) small_contraction_flops_ = static_cast<double>(small_flops);
+ }
+ int64_t small_kernel_flops = 0;
+ if(parameters.getParameter("talsh_small_kernel_flops",&small_kernel_flops)){
+  if(small_kernel_flops >= 0) small_kernel_flops_ = static_cast<double>(small_kernel_flops);
+ }
+ int64_t host_transpose = 1;
+ if(parameters.getParameter("talsh_host_transpose",&host_transpose)) host_transpose_ = (host_transpose != 0);
+ int64_t gauss_flops = 0;
+ if(parameters.getParameter("talsh_gauss_contraction_flops",&gauss_flops)){
+  if(gauss_flops >= 0) gauss_contraction_flops_ = static_cast<double>(gauss_flops);
+ }
+ int64_t launch_replay = 0;
+ if(parameters.getParameter("talsh_launch_replay",&launch_replay)){
+  if((launch_replay != 0) != launch_sequence_.isActive()) launch_sequence_.activate(launch_replay != 0); //keeps recorded sequences
+ }
+ int64_t direct_contraction = 0;
+ if(parameters.getParameter("talsh_direct_contraction",&direct_contraction)){
+  if(direct_contraction >= DIRECT_CONTRACTION_OFF && direct_contraction <= DIRECT_CONTRACTION_ALL)
+   direct_contraction_ = static_cast<int>(direct_contraction);
+ }
+ int64_t memory_timeline = 0, memory_timeline_capacity = MemoryTimeline::DEFAULT_CAPACITY;
+ parameters.getParameter("talsh_memory_timeline",&memory_timeline);
+ parameters.getParameter("talsh_memory_timeline_capacity",&memory_timeline_capacity);
+ memory_timeline_.activate((memory_timeline != 0 && memory_timeline_capacity > 0) ?
+                           static_cast<std::size_t>(memory_timeline_capacity) : 0);
+ int64_t persistent_requests = 0;
+ if(parameters.getParameter("mpi_persistent_requests",&persistent_requests)) persistent_requests_ = (persistent_requests != 0);
+ int64_t gpu_direct = 0;
+ if(parameters.getParameter("mpi_gpu_direct",&gpu_direct)) gpu_direct_ = (gpu_direct != 0);
+ layout_cache_limit_ = static_cast<std::size_t>(static_cast<double>(talsh_host_mem_buffer_size_.load()) * DEFAULT_LAYOUT_CACHE_FRACTION);
+ parameters.getParameter("host_memory_spill_directory",spill_directory_);
+ int64_t compression = 0;
+ if(parameters.getParameter("host_memory_compression",&compression)){
+  if(compression >= COMPRESSION_OFF && compression <= COMPRESSION_LOSSY) compression_mode_ = static_cast<int>(compression);
+ }
+ double compression_tolerance = 0.0;
+ if(parameters.getParameter("host_memory_compression_tolerance",&compression_tolerance)){
+  if(compression_tolerance > 0.0) compression_tolerance_ = compression_tolerance;
+ }
+ int64_t power_iterations = 0;
+ if(parameters.getParameter("talsh_rsvd_power_iterations",&power_iterations)){
+  if(power_iterations >= 0) rsvd_power_iterations_ = static_cast<int>(power_iterations);
+ }
+ int64_t layout_cache_size = 0;
+ if(parameters.getParameter("talsh_layout_cache_size",&layout_cache_size)){
+  if(layout_cache_size >= 0) layout_cache_limit_ = static_cast<std::size_t>(layout_cache_size);
+ }
+ remote_prefetch_limit_ = static_cast<std::size_t>(static_cast<double>(talsh_host_mem_buffer_size_.load()) * DEFAULT_REMOTE_PREFETCH_FRACTION);
+ int64_t remote_prefetch_size = 0;
+ if(parameters.getParameter("talsh_remote_prefetch_size",&remote_prefetch_size)){
+  if(remote_prefetch_size >= 0) remote_prefetch_limit_ = static_cast<std::size_t>(remote_prefetch_size);
+ }
+ std::string autotune_database;
+ if(!(autotuner_.isActive()) && parameters.getParameter("talsh_autotune_database",autotune_database)){ //keeps tuned keys
+  int64_t autotune_threshold = ContractAutotuner::DEFAULT_THRESHOLD;
+  parameters.getParameter("talsh_autotune_threshold",&autotune_threshold);
+  autotuner_.activate(autotune_database,{"host_direct","host_ttgt","host_layout","accelerator","host_packed"},
+                      static_cast<unsigned int>(std::max(autotune_threshold,int64_t{1})));
+ }
+ std::string placement;
+ if(parameters.getParameter("talsh_device_placement",placement)){
+  if(placement == "cost_model"){
+   placement_cost_model_ = true;
+  }else if(placement == "talsh"){
+   placement_cost_model_ = false;
+  }else{
+   std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor): Unknown device placement policy: "
+             << placement << std::endl << std::flush;
+   assert(false);
+  }
+ }
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpTransform & op,
-                               TensorOpExecHandle * exec_handle)
+bool TalshNodeExecutor::startPersistentTransfer(numerics::TensorHashType tensor_hash,
+                                                void * body,
+                                                std::size_t volume,
+                                                int talsh_data_kind,
+                                                int remote_rank,
+                                                int mesg_tag,
+                                                const MPICommProxy & communicator,
+                                                bool send,
+                                                std::list<void*> & requests,
+                                                int * error_code)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
-
- const auto & tensor = *(op.getTensorOperand(0));
- const auto tensor_hash = tensor.getTensorHash();
- auto tens_pos = tensors_.find(tensor_hash);
- if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): TRANSFORM: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+ *error_code = 0;
+#ifdef MPI_ENABLED
+ const auto key = std::make_tuple(tensor_hash,remote_rank,mesg_tag,send);
+ auto iter = persistent_transfers_.find(key);
+ if(iter != persistent_transfers_.end()){
+  for(auto * req: iter->second.requests){
+   if(persistent_active_.find(req) != persistent_active_.end()) return false; //still in flight
+  }
+  if(iter->second.body != body || iter->second.volume != volume || iter->second.communicator != communicator){
+   for(auto * req: iter->second.requests){
+    auto errc = MPI_Request_free((MPI_Request*)req);
+    delete (MPI_Request*)req;
+   }
+   persistent_transfers_.erase(iter);
+   iter = persistent_transfers_.end();
+  }
  }
- tens_pos->second.resetTensorShapeToFull();
- auto & tens = *(tens_pos->second.talsh_tensor);
- auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
- int error_code = op.apply(tens); //synchronous user-defined Host operation
- *exec_handle = op.getId();
- return error_code;
+ if(iter == persistent_transfers_.end()){ //create persistent MPI requests
+  int data_kind_size = 0;
+  auto valid = talshValidDataKind(talsh_data_kind,&data_kind_size); assert(valid == YEP);
+  auto mpi_data_kind = get_mpi_tensor_element_kind(talsh_data_kind);
+  auto comm = *(communicator.get<MPI_Comm>());
+  PersistentTransfer transfer{body,volume,communicator,{}};
+  int chunk = std::numeric_limits<int>::max();
+  for(std::size_t base = 0; base < volume; base += chunk){
+   int count = std::min(chunk,static_cast<int>(volume-base));
+   void * chunk_body = (void*)(static_cast<char*>(body) + base * data_kind_size);
+   MPI_Request * mpi_req = new MPI_Request;
+   if(send){
+    *error_code = MPI_Send_init(chunk_body,count,mpi_data_kind,remote_rank,mesg_tag,comm,mpi_req);
+   }else{
+    *error_code = MPI_Recv_init(chunk_body,count,mpi_data_kind,remote_rank,mesg_tag,comm,mpi_req);
+   }
+   if(*error_code != MPI_SUCCESS){
+    delete mpi_req;
+    for(auto * req: transfer.requests){
+     auto errc = MPI_Request_free((MPI_Request*)req);
+     delete (MPI_Request*)req;
+    }
+    return true;
+   }
+   transfer.requests.emplace_back((void*)mpi_req);
+  }
+  iter = persistent_transfers_.emplace(std::make_pair(key,transfer)).first;
+ }
+ for(auto * req: iter->second.requests){ //restart persistent MPI requests
+  *error_code = MPI_Start((MPI_Request*)req);
+  if(*error_code != MPI_SUCCESS) break;
+  persistent_active_.emplace(req);
+  requests.emplace_back(req);
+ }
+#endif
+ return true;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpSlice & op,
-                               TensorOpExecHandle * exec_handle)
+void TalshNodeExecutor::freePersistentTransfers(const numerics::TensorHashType * tensor_hash)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+#ifdef MPI_ENABLED
+ auto iter = persistent_transfers_.begin();
+ while(iter != persistent_transfers_.end()){
+  if(tensor_hash == nullptr || std::get<0>(iter->first) == *tensor_hash){
+   for(auto * req: iter->second.requests){
+    if(persistent_active_.erase(req) != 0){
+     auto errc = MPI_Wait((MPI_Request*)req,MPI_STATUS_IGNORE);
+    }
+    auto errc = MPI_Request_free((MPI_Request*)req);
+    delete (MPI_Request*)req;
+   }
+   iter = persistent_transfers_.erase(iter);
+  }else{
+   ++iter;
+  }
+ }
+#endif
+ return;
+}
 
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+
+bool TalshNodeExecutor::postEarlyReceive(const numerics::TensorOperation & op)
+{
+ if(early_receives_.find(op.getId()) != early_receives_.end()) return true; //already in flight
+#ifdef MPI_ENABLED
+ if(remote_prefetch_limit_ == 0 || dry_run_.load()) return false;
+ const auto & tensor = *(op.getTensorOperand(0));
+ const std::size_t volume = tensor.getVolume();
+ if(volume == 0 || volume > static_cast<std::size_t>(std::numeric_limits<int>::max())) return false; //single message only
+ const int data_kind = get_talsh_tensor_element_kind(tensor.getElementType());
+ int elem_size = 0;
+ if(talshValidDataKind(data_kind,&elem_size) != YEP) return false;
+ const std::size_t size = volume * static_cast<std::size_t>(elem_size);
+ if(remote_prefetch_bytes_ + size > remote_prefetch_limit_) return false; //reserved buffer space exhausted
+ if(talshDeviceBufferFreeSize(0,DEV_HOST) < 2 * size) return false; //spare Host buffer space only
+ const auto & communicator = op.getMPICommunicator();
+ const int remote_rank = op.getRemoteProcessRank();
+ const int mesg_tag = op.getMessageTag();
+ for(const auto & early: early_receives_){ //one early receive per message signature
+  if(early.second.remote_rank == remote_rank && early.second.mesg_tag == mesg_tag &&
+     early.second.communicator == communicator) return false;
  }
- tens0_pos->second.resetTensorShapeToFull();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
+ auto staging = make_talsh_tensor(std::vector<std::size_t>{0},std::vector<int>{static_cast<int>(volume)},data_kind,nullptr);
+ void * staging_body = host_body(*staging);
+ if(staging_body == nullptr) return false;
+ MPI_Request * mpi_req = new MPI_Request;
+ auto error_code = MPI_Irecv(staging_body,static_cast<int>(volume),get_mpi_tensor_element_kind(data_kind),
+                             remote_rank,mesg_tag,*(communicator.get<MPI_Comm>()),mpi_req);
+ if(error_code != MPI_SUCCESS){
+  delete mpi_req;
+  return false;
+ }
+ early_receives_.emplace(std::make_pair(op.getId(),
+  EarlyReceive{communicator,remote_rank,mesg_tag,data_kind,volume,size,std::move(staging),(void*)mpi_req}));
+ remote_prefetch_bytes_ += size;
+ return true;
+#else
+ return false;
+#endif
+}
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Tensor operand 1 not found: " << std::endl;
+
+bool TalshNodeExecutor::completeEarlyReceive(const numerics::TensorOperation & op,
+                                             talsh::Tensor & tens,
+                                             bool * received)
+{
+ *received = false;
+#ifdef MPI_ENABLED
+ if(early_receives_.empty()) return true;
+ auto iter = early_receives_.find(op.getId());
+ bool completed = false;
+ if(iter == early_receives_.end()){ //an early receive of another tensor fetch with the same message signature would match first
+  const auto & communicator = op.getMPICommunicator();
+  for(auto early = early_receives_.begin(); early != early_receives_.end(); ++early){
+   if(early->second.remote_rank == op.getRemoteProcessRank() && early->second.mesg_tag == op.getMessageTag() &&
+      early->second.communicator == communicator){
+    MPI_Request * mpi_req = (MPI_Request*)(early->second.request);
+    MPI_Status status;
+    int cancelled = 0;
+    auto errc = MPI_Cancel(mpi_req);
+    errc = MPI_Wait(mpi_req,&status);
+    errc = MPI_Test_cancelled(&status,&cancelled);
+    if(cancelled == 0){ //the message of this tensor fetch has already been received: Adopt it
+     auto adopted = std::move(early->second);
+     early_receives_.erase(early);
+     iter = early_receives_.emplace(std::make_pair(op.getId(),std::move(adopted))).first;
+     completed = true;
+    }else{ //the other tensor fetch will post its receive anew
+     remote_prefetch_bytes_ -= early->second.size;
+     delete mpi_req;
+     early_receives_.erase(early);
+    }
+    break;
+   }
+  }
+  if(iter == early_receives_.end()) return true;
+ }
+ auto & early = iter->second;
+ MPI_Request * mpi_req = (MPI_Request*)(early.request);
+ if(!completed){
+  int done = 0;
+  auto errc = MPI_Test(mpi_req,&done,MPI_STATUS_IGNORE);
+  if(errc != MPI_SUCCESS){
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Early receive failed: Error " << errc << std::endl;
+   op.printIt();
+   assert(false);
+  }
+  if(done == 0) return false;
+ }
+ if(early.volume != tens.getVolume() || early.data_kind != tens.getElementType()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Early receive does not match the fetched tensor: " << std::endl;
   op.printIt();
   assert(false);
  }
- tens1_pos->second.resetTensorShapeToFull();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
+ auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ void * dest_body = host_body(tens); assert(dest_body != nullptr);
+ std::memcpy(dest_body,host_body(*(early.staging)),early.size);
+ remote_prefetch_bytes_ -= early.size;
+ delete mpi_req;
+ early_receives_.erase(iter);
+ *received = true;
+#endif
+ return true;
+}
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+
+void TalshNodeExecutor::cancelEarlyReceives()
+{
+#ifdef MPI_ENABLED
+ for(auto & early: early_receives_){
+  MPI_Request * mpi_req = (MPI_Request*)(early.second.request);
+  auto errc = MPI_Cancel(mpi_req);
+  errc = MPI_Wait(mpi_req,MPI_STATUS_IGNORE);
+  delete mpi_req;
  }
+#endif
+ early_receives_.clear();
+ remote_prefetch_bytes_ = 0;
+ return;
+}
 
- const auto & tensor_signature = tensor1.getSignature();
- const auto & slice_signature = tensor0.getSignature();
- const auto slice_rank = slice_signature.getRank();
- std::vector<int> offsets(slice_rank);
- for(unsigned int i = 0; i < slice_rank; ++i){
-  const auto tensor_space_id = tensor_signature.getDimSpaceId(i);
-  const auto tensor_subspace_id = tensor_signature.getDimSubspaceId(i);
-  const auto slice_space_id = slice_signature.getDimSpaceId(i);
-  const auto slice_subspace_id = slice_signature.getDimSubspaceId(i);
-  if(slice_space_id == SOME_SPACE && tensor_space_id == SOME_SPACE){
-   if(slice_subspace_id < tensor_subspace_id){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Slice offset below lower bound: "
-              << slice_subspace_id << " < " << tensor_subspace_id << std::endl;
-    assert(false);
-   }
-   if((slice_subspace_id - tensor_subspace_id) > std::numeric_limits<int>::max()){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Integer (int) overflow in offsets" << std::endl;
-    assert(false);
-   }
-   offsets[i] = static_cast<int>(slice_subspace_id - tensor_subspace_id);
-  }else if(slice_space_id != SOME_SPACE && tensor_space_id == slice_space_id){
-   const auto * tensor_subspace = getSpaceRegister()->getSubspace(tensor_space_id,tensor_subspace_id);
-   const auto tensor_lower_bound = tensor_subspace->getLowerBound();
-   const auto * slice_subspace = getSpaceRegister()->getSubspace(slice_space_id,slice_subspace_id);
-   const auto slice_lower_bound = slice_subspace->getLowerBound();
-   if(slice_lower_bound < tensor_lower_bound){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Slice offset below lower bound: "
-              << slice_lower_bound << " < " << tensor_lower_bound << std::endl;
-    assert(false);
-   }
-   if((slice_lower_bound - tensor_lower_bound) > std::numeric_limits<int>::max()){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Integer (int) overflow in offsets" << std::endl;
-    assert(false);
+
+void * TalshNodeExecutor::getDeviceResidentBody(talsh::Tensor & tens, int * device)
+{
+ if(!gpu_direct_) return nullptr;
+ return getDeviceOnlyBody(tens,device);
+}
+
+
+void * TalshNodeExecutor::getDeviceOnlyBody(talsh::Tensor & tens, int * device)
+{
+ if(external_.find(&tens) != external_.end()) return nullptr;
+ auto * talsh_tens = tens.getTalshTensorPtr();
+ int ncopies = 0, copies[DEV_MAX], data_kinds[DEV_MAX];
+ auto errc = talshTensorPresence(talsh_tens,&ncopies,copies,data_kinds);
+ if(errc != TALSH_SUCCESS || ncopies != 1) return nullptr; //no image or multiple images
+ int dev_kind = DEV_NULL;
+ talshKindDevId(copies[0],&dev_kind);
+ if(dev_kind == DEV_HOST) return nullptr; //the only image is on Host
+ void * body = nullptr;
+ errc = talshTensorGetBodyAccess(talsh_tens,&body,data_kinds[0],copies[0]);
+ if(errc != TALSH_SUCCESS) return nullptr;
+ *device = copies[0];
+ return body;
+}
+
+
+void TalshNodeExecutor::retainResidentImages()
+{
+ std::map<int,std::vector<DeviceMemoryManager::MemoryRange>> retained; //GPU id --> occupied ranges
+ for(const auto gpu: talsh_gpus_) retained[gpu].clear();
+ auto retain_images = [&retained](talsh::Tensor & tens){
+  auto * talsh_tens = tens.getTalshTensorPtr();
+  int ncopies = 0, copies[DEV_MAX], data_kinds[DEV_MAX];
+  auto errc = talshTensorPresence(talsh_tens,&ncopies,copies,data_kinds);
+  if(errc != TALSH_SUCCESS) return;
+  for(int i = 0; i < ncopies; ++i){
+   int dev_kind = DEV_NULL;
+   const int gpu = talshKindDevId(copies[i],&dev_kind);
+   if(dev_kind == DEV_NVIDIA_GPU){
+    void * body = nullptr;
+    int data_kind_size = 0;
+    errc = talshTensorGetBodyAccess(talsh_tens,&body,data_kinds[i],copies[i]);
+    auto valid = talshValidDataKind(data_kinds[i],&data_kind_size);
+    if(errc == TALSH_SUCCESS && valid == YEP)
+     retained[gpu].emplace_back(std::make_pair(body,tens.getVolume() * data_kind_size));
    }
-   offsets[i] = static_cast<int>(slice_lower_bound - tensor_lower_bound);
-  }else{
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Space mismatch: "
-             << slice_space_id << " VS "<< tensor_space_id << std::endl;
+  }
+ };
+ for(auto & tens: tensors_){
+  if(tens.second.talsh_tensor) retain_images(*(tens.second.talsh_tensor));
+ }
+ for(auto & layout: layout_cache_){
+  if(layout.second.tensor) retain_images(*(layout.second.tensor));
+ }
+ auto & device_memory = getDeviceMemoryManager();
+ for(const auto & ranges: retained){
+  auto recorded = device_memory.retainRanges(ranges.first,ranges.second);
+  if(!recorded){
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): Device buffer of GPU " << ranges.first
+             << " is leased while TAL-SH still manages it!" << std::endl;
    assert(false);
   }
  }
+ return;
+}
 
- auto error_code = tens1.extractSlice((task_res.first)->second.get(),
-                                      tens0,
-                                      offsets,
-                                      DEV_HOST,0,
-                                      op.isAccumulative());
 
- return error_code;
+void TalshNodeExecutor::beginCommRecord(TensorOpExecHandle op_handle,
+                                        CommProfile::CommKind kind,
+                                        const MPICommProxy & communicator,
+                                        int peer,
+                                        std::size_t bytes)
+{
+ if(getCommProfile().isActive()){
+  comm_pending_[op_handle] = PendingComm{kind,communicator,peer,bytes,exatn::Timer::timeInSecHR()};
+ }
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpInsert & op,
-                               TensorOpExecHandle * exec_handle)
+void TalshNodeExecutor::endCommRecord(TensorOpExecHandle op_handle)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
-
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+ auto iter = comm_pending_.find(op_handle);
+ if(iter != comm_pending_.end()){
+  const auto & comm = iter->second;
+  getCommProfile().record(comm.kind,comm.communicator,comm.peer,comm.bytes,exatn::Timer::timeInSecHR(comm.start));
+  comm_pending_.erase(iter);
  }
- tens0_pos->second.resetTensorShapeToFull();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
+ return;
+}
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Tensor operand 1 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens1_pos->second.resetTensorShapeToFull();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+int TalshNodeExecutor::postDeviceTransfer(TensorOpCode opcode,
+                                          void * body,
+                                          std::size_t volume,
+                                          int talsh_data_kind,
+                                          int rank,
+                                          int mesg_tag,
+                                          const MPICommProxy & communicator,
+                                          std::list<void*> & requests)
+{
+ int error_code = 0;
+#ifdef MPI_ENABLED
+ int data_kind_size = 0;
+ auto valid = talshValidDataKind(talsh_data_kind,&data_kind_size); assert(valid == YEP);
+ auto mpi_data_kind = get_mpi_tensor_element_kind(talsh_data_kind);
+ auto comm = *(communicator.get<MPI_Comm>());
+ int my_rank = 0;
+ if(opcode == TensorOpCode::ALLREDUCE && rank >= 0){
+  error_code = MPI_Comm_rank(comm,&my_rank); assert(error_code == MPI_SUCCESS);
+ }
+ const int chunk = (opcode == TensorOpCode::FETCH || opcode == TensorOpCode::UPLOAD) ?
+                   std::numeric_limits<int>::max() : ALLREDUCE_CHUNK_SIZE;
+ for(std::size_t base = 0; base < volume; base += chunk){
+  int count = std::min(chunk,static_cast<int>(volume-base));
+  void * chunk_body = (void*)(static_cast<char*>(body) + base * data_kind_size);
+  MPI_Request * mpi_req = new MPI_Request;
+  requests.emplace_back((void*)mpi_req);
+  switch(opcode){
+   case(TensorOpCode::FETCH):
+    error_code = MPI_Irecv(chunk_body,count,mpi_data_kind,rank,mesg_tag,comm,mpi_req);
+    break;
+   case(TensorOpCode::UPLOAD):
+    error_code = MPI_Isend((const void*)chunk_body,count,mpi_data_kind,rank,mesg_tag,comm,mpi_req);
+    break;
+   case(TensorOpCode::BROADCAST):
+    error_code = MPI_Ibcast(chunk_body,count,mpi_data_kind,rank,comm,mpi_req);
+    break;
+   case(TensorOpCode::ALLREDUCE):
+    if(rank >= 0){ //reduce to root
+     error_code = MPI_Ireduce((my_rank == rank) ? MPI_IN_PLACE : chunk_body,chunk_body,count,mpi_data_kind,
+                              MPI_SUM,rank,comm,mpi_req);
+    }else{
+     error_code = MPI_Iallreduce(MPI_IN_PLACE,chunk_body,count,mpi_data_kind,MPI_SUM,comm,mpi_req);
+    }
+    break;
+   default:
+    assert(false);
+  }
+  if(error_code != MPI_SUCCESS) break;
  }
+#endif
+ return error_code;
+}
 
- const auto & tensor_signature = tensor0.getSignature();
- const auto & slice_signature = tensor1.getSignature();
- const auto slice_rank = slice_signature.getRank();
- std::vector<int> offsets(slice_rank);
- for(unsigned int i = 0; i < slice_rank; ++i){
-  const auto tensor_space_id = tensor_signature.getDimSpaceId(i);
-  const auto tensor_subspace_id = tensor_signature.getDimSubspaceId(i);
-  const auto slice_space_id = slice_signature.getDimSpaceId(i);
-  const auto slice_subspace_id = slice_signature.getDimSubspaceId(i);
-  if(slice_space_id == SOME_SPACE && tensor_space_id == SOME_SPACE){
-   if(slice_subspace_id < tensor_subspace_id){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Slice offset below lower bound: "
-              << slice_subspace_id << " < " << tensor_subspace_id << std::endl;
-    assert(false);
-   }
-   if((slice_subspace_id - tensor_subspace_id) > std::numeric_limits<int>::max()){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Integer (int) overflow in offsets" << std::endl;
-    assert(false);
-   }
-   offsets[i] = static_cast<int>(slice_subspace_id - tensor_subspace_id);
-  }else if(slice_space_id != SOME_SPACE && tensor_space_id == slice_space_id){
-   const auto * tensor_subspace = getSpaceRegister()->getSubspace(tensor_space_id,tensor_subspace_id);
-   const auto tensor_lower_bound = tensor_subspace->getLowerBound();
-   const auto * slice_subspace = getSpaceRegister()->getSubspace(slice_space_id,slice_subspace_id);
-   const auto slice_lower_bound = slice_subspace->getLowerBound();
-   if(slice_lower_bound < tensor_lower_bound){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Slice offset below lower bound: "
-              << slice_lower_bound << " < " << tensor_lower_bound << std::endl;
-    assert(false);
-   }
-   if((slice_lower_bound - tensor_lower_bound) > std::numeric_limits<int>::max()){
-    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Integer (int) overflow in offsets" << std::endl;
-    assert(false);
-   }
-   offsets[i] = static_cast<int>(slice_lower_bound - tensor_lower_bound);
-  }else{
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Space mismatch: "
-             << slice_space_id << " VS "<< tensor_space_id << std::endl;
-   assert(false);
-  }
- }
-
- auto error_code = tens0.insertSlice((task_res.first)->second.get(),
-                                     tens1,
-                                     offsets,
-                                     DEV_HOST,0,
-                                     op.isAccumulative());
 
- return error_code;
+void TalshNodeExecutor::adviseHugePages(std::size_t buffer_size, std::size_t page_size)
+{
+ auto * buffer = static_cast<char*>(talsh::getDeviceBufferBasePtr(DEV_HOST,0));
+ if(buffer == nullptr || buffer_size == 0) return;
+ //Huge-page aligned interior of the Host buffer:
+ const auto base = reinterpret_cast<std::uintptr_t>(buffer);
+ const auto begin = ((base + page_size - 1) / page_size) * page_size;
+ const auto end = ((base + buffer_size) / page_size) * page_size;
+ if(end <= begin){
+  std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): Host buffer is too small for huge pages of "
+            << page_size << " bytes" << std::endl << std::flush;
+  return;
+ }
+ void * interior = reinterpret_cast<void*>(begin);
+ const std::size_t length = end - begin;
+#ifdef MAP_HUGETLB
+ //Replace the (still unused) anonymous pages by explicit huge pages:
+ const int page_flag = (page_size == HUGE_PAGE_SIZE_1G) ? (30 << MAP_HUGE_SHIFT) : (21 << MAP_HUGE_SHIFT);
+ void * mapped = mmap(interior,length,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED|MAP_HUGETLB|page_flag,-1,0);
+ if(mapped == interior) return;
+ //No huge pages reserved (/proc/sys/vm/nr_hugepages): Restore the regular anonymous pages:
+ mapped = mmap(interior,length,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED,-1,0);
+ assert(mapped == interior);
+#endif
+#ifdef MADV_HUGEPAGE
+ //Fall back to the transparent (2 MB) huge pages:
+ auto error_code = madvise(interior,length,MADV_HUGEPAGE);
+ if(error_code == 0){
+  std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): Explicit huge pages of " << page_size
+            << " bytes are not available, using transparent huge pages instead" << std::endl << std::flush;
+  return;
+ }
+#endif
+ std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): Unable to back the Host buffer with huge pages"
+           << std::endl << std::flush;
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpAdd & op,
-                               TensorOpExecHandle * exec_handle)
+bool TalshNodeExecutor::pinHostBuffer(std::size_t buffer_size)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ void * buffer = talsh::getDeviceBufferBasePtr(DEV_HOST,0);
+ if(buffer == nullptr || buffer_size == 0) return false;
+#ifndef NO_GPU
+ if(talsh_gpus_.empty()) return false;
+ if(gpu::isPinnedHostMemory(buffer)) return false; //already pinned by TAL-SH
+ const auto gpu_error = gpu::registerHostMemory(buffer,buffer_size);
+ if(gpu_error == 0) return true;
+ std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): Unable to pin the Host buffer: "
+           << gpu::errorString(gpu_error) << std::endl << std::flush;
+#endif
+ return false;
+}
 
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Tensor operand 1 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+void TalshNodeExecutor::unpinHostBuffer()
+{
+#ifndef NO_GPU
+ if(talsh_host_buffer_pinned_){
+  void * buffer = talsh::getDeviceBufferBasePtr(DEV_HOST,0);
+  if(buffer != nullptr) gpu::unregisterHostMemory(buffer);
  }
- tens1_pos->second.resetTensorShapeToReduced();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
+#endif
+ talsh_host_buffer_pinned_ = false;
+ return;
+}
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
- }
 
- auto error_code = tens0.accumulate((task_res.first)->second.get(),
-                                    op.getIndexPatternReduced(),
-                                    tens1,
-                                    DEV_DEFAULT,DEV_DEFAULT,
-                                    op.getScalar(0));
- if(error_code == DEVICE_UNABLE || error_code == TALSH_NOT_AVAILABLE || error_code == TALSH_NOT_IMPLEMENTED){
-  (task_res.first)->second->clean();
-  error_code = tens0.accumulate((task_res.first)->second.get(),
-                                op.getIndexPatternReduced(),
-                                tens1,
-                                DEV_HOST,0,
-                                op.getScalar(0));
- }else if(error_code == TRY_LATER){
-  std::size_t total_tensor_size = tensor0.getSize() + tensor1.getSize();
-  auto evicting = evictMovedTensors(talsh::determineOptimalDevice(tens0,tens1),total_tensor_size);
- }else if(error_code == TALSH_SUCCESS){
-  prefetch_enabled_ = true;
- }
- if(error_code == TALSH_SUCCESS){
-  double flop_count = talsh_submitted_flops_.load() + op.getFlopEstimate() * tensorElementTypeOpFactor(tensor1.getElementType());
-  talsh_submitted_flops_.store(flop_count);
+void TalshNodeExecutor::firstTouchHostBuffer(std::size_t buffer_size)
+{
+ auto * buffer = static_cast<volatile char*>(talsh::getDeviceBufferBasePtr(DEV_HOST,0));
+ if(buffer == nullptr || buffer_size == 0) return;
+#ifdef _OPENMP
+ if(omp_get_proc_bind() == omp_proc_bind_false && !getThreadTopology().isActive()){
+  std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor): NUMA first touch of the Host buffer requires "
+            << "OpenMP thread binding (OMP_PROC_BIND/OMP_PLACES or the thread topology)" << std::endl << std::flush;
  }
- return error_code;
+ const std::size_t num_pages = (buffer_size + NUMA_PAGE_SIZE - 1) / NUMA_PAGE_SIZE;
+#pragma omp parallel for schedule(static) shared(buffer,num_pages)
+ for(std::size_t page = 0; page < num_pages; ++page) buffer[page * NUMA_PAGE_SIZE] = 0;
+#endif
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpContract & op,
-                               TensorOpExecHandle * exec_handle)
+void TalshNodeExecutor::activateDryRun(bool dry_run)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ dry_run_.store(dry_run);
+ return;
+}
 
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 1 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+void TalshNodeExecutor::activateFastMath()
+{
+ std::lock_guard<std::mutex> lock(talsh_init_lock);
+ if(talsh_initialized_.load()){ //otherwise activated upon TAL-SH initialization
+  auto activated = talsh::enableFastMath(DEV_HOST);
+  activated = talsh::enableFastMath(DEV_NVIDIA_GPU);
  }
- tens1_pos->second.resetTensorShapeToReduced();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
+ talsh_fast_math_default_.store(true);
+ talsh_fast_math_active_.store(true);
+ return;
+}
 
- const auto & tensor2 = *(op.getTensorOperand(2));
- const auto tensor2_hash = tensor2.getTensorHash();
- auto tens2_pos = tensors_.find(tensor2_hash);
- if(tens2_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 2 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens2_pos->second.resetTensorShapeToReduced();
- auto & tens2 = *(tens2_pos->second.talsh_tensor);
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+bool TalshNodeExecutor::reducedPrecision(const numerics::TensorOperation & op,
+                                         const talsh::Tensor & dest,
+                                         const talsh::Tensor & left,
+                                         const talsh::Tensor & right) const
+{
+ switch(op.getPrecision()){
+ case TensorOpPrecision::FULL:
+  return false;
+ case TensorOpPrecision::REDUCED:
+  return true;
+ case TensorOpPrecision::AUTO:
+ {
+  //Error bound of the reduced-precision contraction: K * u * ||L|| * ||R||, K = contracted volume:
+  double left_norm = 0.0, right_norm = 0.0;
+  if(!(host_norm2(left,&left_norm) && host_norm2(right,&right_norm))) return false; //norms are not available
+  const double dest_vol = static_cast<double>(dest.getVolume());
+  const double contr_vol = std::sqrt(static_cast<double>(left.getVolume()) * static_cast<double>(right.getVolume())
+                                     / ((dest_vol > 1.0) ? dest_vol : 1.0));
+  const double error_bound = contr_vol * REDUCED_PRECISION_UNIT_ROUNDOFF * left_norm * right_norm;
+  return (error_bound <= op.getPrecisionTolerance());
  }
+ default: //half-precision operands are always computed in reduced precision
+  if(tensorElementTypeIsHalf(op.getTensorOperand(0)->getElementType()) &&
+     tensorElementTypeIsHalf(op.getTensorOperand(1)->getElementType()) &&
+     tensorElementTypeIsHalf(op.getTensorOperand(2)->getElementType())) return true;
+  return talsh_fast_math_default_.load();
+ }
+}
 
- //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): Tensor contraction " << op.getIndexPattern() << std::endl; //debug
- //const auto host_buf_free_mem = talshDeviceBufferFreeSize(0,DEV_HOST); //debug
- auto error_code = tens0.contractAccumulate((task_res.first)->second.get(),
-                                            op.getIndexPatternReduced(),
-                                            tens1,tens2,
-                                            DEV_DEFAULT,DEV_DEFAULT,
-                                            op.getScalar(0),
-                                            op.isAccumulative());
- if(error_code == DEVICE_UNABLE){ //use out-of-core version if tensor contraction does not fit in GPU
-  //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CONTRACT: Redirected to XL\n" << std::flush; //debug
-  (task_res.first)->second->clean();
-  bool synced = sync(); //completes all active tasks, prefetches and evictions
-  bool evicting = evictMovedTensors(DEV_DEFAULT,0); //evict all cached tensors from all accelerators
-  if(evicting) synced = synced && sync(); //completes all evictions
-  task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                            std::make_shared<talsh::TensorTask>()));
-  if(synced){
-   error_code = tens0.contractAccumulateXL((task_res.first)->second.get(),
-                                           op.getIndexPatternReduced(),
-                                           tens1,tens2,
-                                           DEV_DEFAULT,DEV_DEFAULT,
-                                           op.getScalar(0),
-                                           op.isAccumulative());
+
+void TalshNodeExecutor::switchFastMath(bool fast_math)
+{
+ if(fast_math != talsh_fast_math_active_.load()){
+  bool switched = false;
+  if(fast_math){
+   switched = talsh::enableFastMath(DEV_NVIDIA_GPU);
   }else{
-   error_code = tens0.contractAccumulate((task_res.first)->second.get(),
-                                         op.getIndexPatternReduced(),
-                                         tens1,tens2,
-                                         DEV_HOST,0,
-                                         op.getScalar(0),
-                                         op.isAccumulative());
+   switched = talsh::disableFastMath(DEV_NVIDIA_GPU);
+  }
+  if(switched){
+   talsh_fast_math_active_.store(fast_math);
+  }else{ //the cached state keeps following the actual TAL-SH state
+   static std::atomic<bool> failure_reported{false};
+   if(!failure_reported.exchange(true)){
+    std::cout << "#WARNING(exatn::runtime::node_executor_talsh): Unable to " << (fast_math ? "enable" : "disable")
+              << " the fast math on GPU: The current TAL-SH math mode is retained" << std::endl << std::flush;
+   }
   }
- }else if(error_code == TALSH_NOT_AVAILABLE || error_code == TALSH_NOT_IMPLEMENTED){
-  (task_res.first)->second->clean();
-  error_code = tens0.contractAccumulate((task_res.first)->second.get(),
-                                         op.getIndexPatternReduced(),
-                                         tens1,tens2,
-                                         DEV_HOST,0,
-                                         op.getScalar(0),
-                                         op.isAccumulative());
- }else if(error_code == TRY_LATER){
-  std::size_t total_tensor_size = tensor0.getSize() + tensor1.getSize() + tensor2.getSize();
-  bool evicting = evictMovedTensors(talsh::determineOptimalDevice(tens0,tens1,tens2),total_tensor_size);
- }else if(error_code == TALSH_SUCCESS){
-  prefetch_enabled_ = true;
- }
- if(error_code == TALSH_SUCCESS){
-  double flop_count = talsh_submitted_flops_.load() + op.getFlopEstimate() * tensorElementTypeOpFactor(tensor1.getElementType());
-  talsh_submitted_flops_.store(flop_count);
  }
- /*if(talshDeviceBufferFreeSize(0,DEV_HOST) < host_buf_free_mem){ //debug
-  std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): Host buffer leak detected for tensor contraction:\n";
-  op.printIt();
-  std::abort();
- }*/
- return error_code;
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpDecomposeSVD3 & op,
-                               TensorOpExecHandle * exec_handle)
+std::size_t TalshNodeExecutor::getMemoryBufferSize() const
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
-
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
+ std::size_t buf_size = talsh_host_mem_buffer_size_.load();
+ while(buf_size == 0) buf_size = talsh_host_mem_buffer_size_.load();
+ return buf_size;
+}
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 1 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens1_pos->second.resetTensorShapeToReduced();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
 
- const auto & tensor2 = *(op.getTensorOperand(2));
- const auto tensor2_hash = tensor2.getTensorHash();
- auto tens2_pos = tensors_.find(tensor2_hash);
- if(tens2_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 2 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+std::size_t TalshNodeExecutor::getMemoryUsage(std::size_t * free_mem) const
+{
+ std::size_t total_size = talsh_host_mem_buffer_size_.load();
+ while(total_size == 0) total_size = talsh_host_mem_buffer_size_.load();
+ assert(free_mem != nullptr);
+ if(!(talsh_initialized_.load())){ //TAL-SH buffers are not committed yet
+  *free_mem = total_size;
+  return 0;
  }
- tens2_pos->second.resetTensorShapeToReduced();
- auto & tens2 = *(tens2_pos->second.talsh_tensor);
+ *free_mem = talshDeviceBufferFreeSize(0,DEV_HOST);
+ std::size_t used_size = total_size - (*free_mem);
+ return used_size;
+}
 
- const auto & tensor3 = *(op.getTensorOperand(3));
- const auto tensor3_hash = tensor3.getTensorHash();
- auto tens3_pos = tensors_.find(tensor3_hash);
- if(tens3_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 3 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens3_pos->second.resetTensorShapeToReduced();
- auto & tens3 = *(tens3_pos->second.talsh_tensor);
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
- }
+double TalshNodeExecutor::getTotalFlopCount() const
+{
+ return talsh_submitted_flops_.load();
+}
 
- auto error_code = tens3.decomposeSVD((task_res.first)->second.get(),
-                                      op.getIndexPatternReduced(),
-                                      tens0,tens1,tens2,
-                                      DEV_HOST,0);
- return error_code;
+
+void TalshNodeExecutor::getTransferVolume(std::size_t * host_to_device,
+                                          std::size_t * device_to_host) const
+{
+ *host_to_device = talsh_h2d_bytes_.load(std::memory_order_relaxed);
+ *device_to_host = talsh_d2h_bytes_.load(std::memory_order_relaxed);
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpDecomposeSVD2 & op,
-                               TensorOpExecHandle * exec_handle)
+std::size_t TalshNodeExecutor::getTensorMemoryUsage() const
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ return talsh_tensor_bytes_.load(std::memory_order_relaxed);
+}
 
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
 
- const auto & tensor1 = *(op.getTensorOperand(1));
- const auto tensor1_hash = tensor1.getTensorHash();
- auto tens1_pos = tensors_.find(tensor1_hash);
- if(tens1_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 1 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens1_pos->second.resetTensorShapeToReduced();
- auto & tens1 = *(tens1_pos->second.talsh_tensor);
+double TalshNodeExecutor::getContractionMemoryFactor() const
+{
+ //All tensor contractions are executed on Host by the direct kernels (no transposed copies):
+ if(direct_contraction_ == DIRECT_CONTRACTION_ALL && talsh_gpus_.empty()) return 1.0;
+ return TensorNodeExecutor::getContractionMemoryFactor();
+}
 
- const auto & tensor2 = *(op.getTensorOperand(2));
- const auto tensor2_hash = tensor2.getTensorHash();
- auto tens2_pos = tensors_.find(tensor2_hash);
- if(tens2_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 2 not found: " << std::endl;
-  op.printIt();
-  assert(false);
- }
- tens2_pos->second.resetTensorShapeToReduced();
- auto & tens2 = *(tens2_pos->second.talsh_tensor);
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+TalshNodeExecutor::~TalshNodeExecutor()
+{
+#ifdef DEBUG
+  const bool debugging = true;
+#else
+  const bool debugging = false;
+#endif
+ cancelEarlyReceives();
+ auto synced = sync(); assert(synced);
+ freePersistentTransfers();
+ invalidateLayouts();
+ for(auto & spilled: spilled_){
+  if(spilled.second.io.valid()) spilled.second.io.wait();
+  if(!(spilled.second.path.empty())) std::remove(spilled.second.path.c_str());
  }
-
- auto error_code = tens2.decomposeSVDLR((task_res.first)->second.get(),
-                                        op.getIndexPatternReduced(),
-                                        tens0,tens1,
-                                        DEV_HOST,0);
- return error_code;
+ spilled_.clear();
+ task_pool_.clear();
+ talsh_init_lock.lock();
+ --talsh_node_exec_count_;
+ if(talsh_initialized_.load() && talsh_node_exec_count_.load() == 0){
+  tasks_.clear();
+  tensors_.clear();
+  talsh_tensor_bytes_.store(0);
+  talsh_fast_math_default_.store(false);
+  talsh_fast_math_active_.store(false);
+  talsh::printStatistics();
+  unpinHostBuffer();
+  auto error_code = talsh::shutdown();
+  if(error_code == TALSH_SUCCESS){
+   if(debugging){
+    std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): TAL-SH shut down" << std::endl;
+    std::cout << "#DEBUG(exatn::runtime::TalshNodeExecutor): Max encountered actual (reduced) tensor rank = "
+              << max_tensor_rank_ << std::endl << std::flush;
+   }
+   talsh_initialized_.store(false);
+  }else{
+   std::cerr << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to shut down TAL-SH!" << std::endl;
+   assert(false);
+  }
+ }
+ talsh_init_lock.unlock();
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpOrthogonalizeSVD & op,
-                               TensorOpExecHandle * exec_handle)
+TalshNodeExecutor::TensorImpl::TensorImpl(const std::vector<std::size_t> & full_offsets,
+                                          const std::vector<DimExtent> & full_extents,
+                                          const std::vector<std::size_t> & reduced_offsets,
+                                          const std::vector<int> & reduced_extents,
+                                          int data_kind,
+                                          void * ext_body):
+ full_base_offsets(full_offsets), reduced_base_offsets(reduced_offsets),
+ stored_shape(nullptr), full_shape_is_on(false)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
-
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_SVD: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+ talsh_tensor = make_talsh_tensor(reduced_offsets,reduced_extents,data_kind,ext_body);
+ auto errc = tensShape_create(&stored_shape); assert(errc == TALSH_SUCCESS);
+ int full_rank = full_extents.size();
+ int dims[full_rank];
+ for(int i = 0; i < full_rank; ++i){
+  if(full_extents[i] > static_cast<DimExtent>(std::numeric_limits<int>::max())){
+   std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): CREATE: Tensor dimension extent exceeds max int: "
+             << full_extents[i] << std::endl << std::flush;
+   assert(false);
+  }
+  dims[i] = full_extents[i];
  }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
+ errc = tensShape_construct(stored_shape,NOPE,full_rank,dims); assert(errc == TALSH_SUCCESS);
+}
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_SVD: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
- }
 
- auto error_code = tens0.orthogonalizeSVD((task_res.first)->second.get(),
-                                          op.getIndexPatternReduced(),
-                                          DEV_HOST,0);
- return error_code;
+TalshNodeExecutor::TensorImpl::TensorImpl(TalshNodeExecutor::TensorImpl && other) noexcept:
+ talsh_tensor(std::move(other.talsh_tensor)),
+ full_base_offsets(std::move(other.full_base_offsets)),
+ reduced_base_offsets(std::move(other.reduced_base_offsets)),
+ stored_shape(other.stored_shape), full_shape_is_on(other.full_shape_is_on)
+{
+ other.stored_shape = nullptr;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpOrthogonalizeMGS & op,
-                               TensorOpExecHandle * exec_handle)
+TalshNodeExecutor::TensorImpl & TalshNodeExecutor::TensorImpl::operator=(TalshNodeExecutor::TensorImpl && other) noexcept
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ if(this != &other){
+  if(stored_shape != nullptr){
+   resetTensorShapeToReduced();
+   auto errc = tensShape_destroy(stored_shape); assert(errc == TALSH_SUCCESS);
+  }
+  stored_shape = other.stored_shape;
+  other.stored_shape = nullptr;
+  full_base_offsets = std::move(other.full_base_offsets);
+  reduced_base_offsets = std::move(other.reduced_base_offsets);
+  talsh_tensor = std::move(other.talsh_tensor);
+  full_shape_is_on = other.full_shape_is_on;
+ }
+ return *this;
+}
 
- const auto & tensor0 = *(op.getTensorOperand(0));
- const auto tensor0_hash = tensor0.getTensorHash();
- auto tens0_pos = tensors_.find(tensor0_hash);
- if(tens0_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_MGS: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+
+TalshNodeExecutor::TensorImpl::~TensorImpl()
+{
+ if(stored_shape != nullptr){
+  resetTensorShapeToReduced();
+  auto errc = tensShape_destroy(stored_shape); assert(errc == TALSH_SUCCESS);
+  stored_shape = nullptr;
  }
- tens0_pos->second.resetTensorShapeToReduced();
- auto & tens0 = *(tens0_pos->second.talsh_tensor);
+}
 
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_MGS: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+
+void TalshNodeExecutor::TensorImpl::resetTensorShapeToFull()
+{
+ if(!full_shape_is_on){
+  talsh_tensor->resetDimOffsets(full_base_offsets);
+  auto * talsh_tens = talsh_tensor->getTalshTensorPtr();
+  talsh_tens_shape_t * current_shape = talsh_tens->shape_p;
+  assert(current_shape != nullptr && stored_shape != nullptr);
+  talsh_tens->shape_p = stored_shape;
+  stored_shape = current_shape;
+  full_shape_is_on = true;
  }
+ return;
+}
 
- auto error_code = 0;
- /*
- auto error_code = tens0.orthogonalizeMGS((task_res.first)->second.get(),
-                                          op.getIndexPatternReduced(),
-                                          DEV_HOST,0);
- */
- return error_code;
+
+void TalshNodeExecutor::TensorImpl::resetTensorShapeToReduced()
+{
+ if(full_shape_is_on){
+  talsh_tensor->resetDimOffsets(reduced_base_offsets);
+  auto * talsh_tens = talsh_tensor->getTalshTensorPtr();
+  talsh_tens_shape_t * current_shape = talsh_tens->shape_p;
+  assert(current_shape != nullptr && stored_shape != nullptr);
+  talsh_tens->shape_p = stored_shape;
+  stored_shape = current_shape;
+  full_shape_is_on = false;
+ }
+ return;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpFetch & op,
+int TalshNodeExecutor::execute(numerics::TensorOpCreate & op,
                                TensorOpExecHandle * exec_handle)
 {
  assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ commitTalsh(); //TAL-SH is initialized upon the first tensor creation
 
  const auto & tensor = *(op.getTensorOperand(0));
+ const auto & tensor_signature = tensor.getSignature();
+ const auto full_tensor_rank = tensor.getRank();
  const auto tensor_hash = tensor.getTensorHash();
- auto tens_pos = tensors_.find(tensor_hash);
- if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+ //Get tensor dimension extents:
+ const auto & dim_extents = tensor.getDimExtents();
+ //Get tensor dimension base offsets:
+ std::vector<std::size_t> offsets(full_tensor_rank);
+ for(int i = 0; i < full_tensor_rank; ++i){
+  auto space_id = tensor_signature.getDimSpaceId(i);
+  auto subspace_id = tensor_signature.getDimSubspaceId(i);
+  if(space_id == SOME_SPACE){
+   offsets[i] = static_cast<std::size_t>(subspace_id);
+  }else{
+   const auto * subspace = getSpaceRegister()->getSubspace(space_id,subspace_id);
+   offsets[i] = static_cast<std::size_t>(subspace->getLowerBound());
+  }
  }
- tens_pos->second.resetTensorShapeToReduced();
- auto & tens = *(tens_pos->second.talsh_tensor);
-
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+ //Remove tensor dimensions of extent 1:
+ unsigned int tensor_rank = 0;
+ for(int i = 0; i < full_tensor_rank; ++i){
+  if(dim_extents[i] > 1){
+   if(dim_extents[i] <= static_cast<DimExtent>(std::numeric_limits<int>::max())){
+    ++tensor_rank;
+   }else{
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CREATE: Tensor dimension extent exceeds max int: "
+              << dim_extents[i] << std::endl << std::flush;
+    assert(false);
+   }
+  }
  }
-
- int error_code = 0;
-#ifdef MPI_ENABLED
- auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
- float * tens_body_r4 = nullptr;
- double * tens_body_r8 = nullptr;
- std::complex<float> * tens_body_c4 = nullptr;
- std::complex<double> * tens_body_c8 = nullptr;
- bool access_granted = false;
- int tens_elem_type = tens.getElementType();
- switch(tens_elem_type){
-  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
-  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
-  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
-  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
-  default:
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Unknown TAL-SH data kind: "
-             << tens_elem_type << std::endl;
-   op.printIt();
-   assert(false);
+ if(static_cast<int>(tensor_rank) > max_tensor_rank_) max_tensor_rank_ = static_cast<int>(tensor_rank);
+ std::vector<int> extents(tensor_rank);
+ std::vector<std::size_t> bases(tensor_rank);
+ tensor_rank = 0;
+ for(int i = 0; i < full_tensor_rank; ++i){
+  if(dim_extents[i] > 1){
+   extents[tensor_rank] = static_cast<int>(dim_extents[i]);
+   bases[tensor_rank++] = offsets[i];
+  }
  }
- if(access_granted){
-  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
-  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
-  int remote_rank = op.getRemoteProcessRank();
-  int mesg_tag = op.getMessageTag();
-  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
-                                       std::list<void*>{})); assert(req_res.second);
-  std::size_t tens_volume = tens.getVolume();
-  int chunk = std::numeric_limits<int>::max();
-  for(std::size_t base = 0; base < tens_volume; base += chunk){
-   int count = std::min(chunk,static_cast<int>(tens_volume-base));
-   MPI_Request * mpi_req = new MPI_Request;
-   req_res.first->second.emplace_back((void*)mpi_req);
-   switch(tens_elem_type){
-    case(talsh::REAL32):
-     assert(tens_body_r4 != nullptr);
-     error_code = MPI_Irecv((void*)(&tens_body_r4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::REAL64):
-     assert(tens_body_r8 != nullptr);
-     error_code = MPI_Irecv((void*)(&tens_body_r8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::COMPLEX32):
-     assert(tens_body_c4 != nullptr);
-     error_code = MPI_Irecv((void*)(&tens_body_c4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::COMPLEX64):
-     assert(tens_body_c8 != nullptr);
-     error_code = MPI_Irecv((void*)(&tens_body_c8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
+ //Get tensor data kind:
+ auto data_kind = get_talsh_tensor_element_kind(op.getTensorElementType());
+ //Construct the TAL-SH tensor implementation:
+ auto * ext_body = op.getExternalBody();
+ auto res = tensors_.emplace(std::make_pair(tensor_hash,TensorImpl(offsets,dim_extents.toVector(),bases,extents,data_kind,ext_body)));
+ if(res.second){
+  if(res.first->second.talsh_tensor->isEmpty()){ //tensor has not been allocated memory due to its temporary shortage
+   tensors_.erase(res.first);
+   spillColdTensors(tensor.getSize());
+   return TRY_LATER;
+  }
+  if(ext_body != nullptr){
+   external_.emplace(res.first->second.talsh_tensor.get()); //external bodies are not accounted in the executor memory usage
+  }else{
+   talsh_tensor_bytes_.fetch_add(tensor.getSize(),std::memory_order_relaxed);
+   memory_timeline_.recordAlloc(tensor,tensor.getSize(),-1,op.getId());
+  }
+  //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): New tensor " << tensor.getName()
+  //          << " emplaced with hash " << tensor_hash << std::endl;
+ }else{
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CREATE: Attempt to create the same tensor twice: " << std::endl;
+  tensor.printIt();
+  assert(false);
+ }
+ *exec_handle = op.getId();
+ return 0;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpDestroy & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor = *(op.getTensorOperand(0));
+ const auto tensor_hash = tensor.getTensorHash();
+ auto iter = tensors_.find(tensor_hash);
+ if(iter != tensors_.end()){
+  //Discard the spilled tensor body, if any:
+  if(discardSpilledTensor(tensor_hash)){ //the tensor body is not resident
+   tensors_.erase(iter);
+   talsh_tensor_bytes_.fetch_sub(tensor.getSize(),std::memory_order_relaxed);
+   memory_timeline_.recordFree(tensor,tensor.getSize(),-1,op.getId());
+   *exec_handle = op.getId();
+   return 0;
+  }
+  //Complete an active tensor image eviction, if any:
+  auto eviction = evictions_.find(iter->second.talsh_tensor.get());
+  if(eviction != evictions_.end()){
+   auto snc = eviction->second->wait();
+   evictions_.erase(eviction);
+  }
+  //Tensor destruction procedure:
+  bool in_use = tensorIsCurrentlyInUse(iter->second.talsh_tensor.get());
+  if(!in_use){
+   //Evict the tensor from device caches:
+   for(int dev = 0; dev < DEV_MAX; ++dev){
+    auto cached = accel_cache_[dev].find(iter->second.talsh_tensor.get());
+    if(cached != accel_cache_[dev].end()) accel_cache_[dev].erase(cached);
    }
-   if(error_code != MPI_SUCCESS) break;
+   next_use_.erase(iter->second.talsh_tensor.get());
+   freePersistentTransfers(&tensor_hash);
+   invalidateLayouts(&tensor_hash);
+   //Move tensor image to Host:
+   auto synced = iter->second.talsh_tensor->sync(DEV_HOST,0,nullptr,true); assert(synced);
+   //Destroy the tensor:
+   iter->second.resetTensorShapeToReduced();
+   const bool external = (external_.erase(iter->second.talsh_tensor.get()) != 0);
+   tensors_.erase(iter);
+   if(!external){
+    talsh_tensor_bytes_.fetch_sub(tensor.getSize(),std::memory_order_relaxed);
+    memory_timeline_.recordFree(tensor,tensor.getSize(),-1,op.getId());
+   }
+   //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): Tensor " << tensor.getName()
+   //          << " erased with hash " << tensor_hash << std::endl;
+  }else{
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DESTROY: Attempt to destroy an active tensor:" << std::endl;
+   tensor.printIt();
+   assert(false);
   }
  }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Unable to get access to the tensor body!" << std::endl;
-  op.printIt();
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DESTROY: Attempt to destroy non-existing tensor:" << std::endl;
+  tensor.printIt();
   assert(false);
  }
-#endif
- return error_code;
+ *exec_handle = op.getId();
+ return 0;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpUpload & op,
+int TalshNodeExecutor::execute(numerics::TensorOpTransform & op,
                                TensorOpExecHandle * exec_handle)
 {
  assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
 
  const auto & tensor = *(op.getTensorOperand(0));
  const auto tensor_hash = tensor.getTensorHash();
  auto tens_pos = tensors_.find(tensor_hash);
  if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Tensor operand 0 not found: " << std::endl;
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): TRANSFORM: Tensor operand 0 not found: " << std::endl;
   op.printIt();
   assert(false);
  }
- tens_pos->second.resetTensorShapeToReduced();
+ if(is_zero_initialization(op)){ //the tensor body will be written once it is needed
+  known_zero_.insert(tensor_hash);
+  *exec_handle = op.getId();
+  return 0;
+ }
+ tens_pos->second.resetTensorShapeToFull();
  auto & tens = *(tens_pos->second.talsh_tensor);
-
- *exec_handle = op.getId();
- auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
-                                std::make_shared<talsh::TensorTask>()));
- if(!task_res.second){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Attempt to execute the same operation twice: " << std::endl;
-  op.printIt();
-  assert(false);
+ int device = -1;
+ void * device_body = getDeviceOnlyBody(tens,&device);
+ if(device_body != nullptr){ //try the device implementation first
+  int error_code = applyOnDevice(op,tens,device_body,device);
+  if(error_code != numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED){
+   *exec_handle = op.getId();
+   return error_code;
+  }
  }
-
- int error_code = 0;
-#ifdef MPI_ENABLED
  auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
- float * tens_body_r4 = nullptr;
- double * tens_body_r8 = nullptr;
- std::complex<float> * tens_body_c4 = nullptr;
- std::complex<double> * tens_body_c8 = nullptr;
- bool access_granted = false;
- int tens_elem_type = tens.getElementType();
- switch(tens_elem_type){
-  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
-  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
-  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
-  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
-  default:
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Unknown TAL-SH data kind: "
-             << tens_elem_type << std::endl;
-   op.printIt();
-   assert(false);
- }
- if(access_granted){
-  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
-  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
-  int remote_rank = op.getRemoteProcessRank();
-  int mesg_tag = op.getMessageTag();
-  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
-                                       std::list<void*>{})); assert(req_res.second);
-  std::size_t tens_volume = tens.getVolume();
-  int chunk = std::numeric_limits<int>::max();
-  for(std::size_t base = 0; base < tens_volume; base += chunk){
-   int count = std::min(chunk,static_cast<int>(tens_volume-base));
-   MPI_Request * mpi_req = new MPI_Request;
-   req_res.first->second.emplace_back((void*)mpi_req);
-   switch(tens_elem_type){
-    case(talsh::REAL32):
-     assert(tens_body_r4 != nullptr);
-     error_code = MPI_Isend((const void*)(&tens_body_r4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::REAL64):
-     assert(tens_body_r8 != nullptr);
-     error_code = MPI_Isend((const void*)(&tens_body_r8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::COMPLEX32):
-     assert(tens_body_c4 != nullptr);
-     error_code = MPI_Isend((const void*)(&tens_body_c4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-    case(talsh::COMPLEX64):
-     assert(tens_body_c8 != nullptr);
-     error_code = MPI_Isend((const void*)(&tens_body_c8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
-     break;
-   }
-   if(error_code != MPI_SUCCESS) break;
-  }
+ int error_code = op.apply(tens); //synchronous user-defined Host operation
+ *exec_handle = op.getId();
+ return error_code;
+}
+
+
+int TalshNodeExecutor::applyOnDevice(numerics::TensorOpTransform & op,
+                                     talsh::Tensor & tens,
+                                     void * device_body,
+                                     int device)
+{
+ int error_code = numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED;
+ auto functor = op.getFunctor();
+ if(!functor) return 0; //no functor: nothing to apply
+ int device_kind = DEV_NULL;
+ const int device_id = talshKindDevId(device,&device_kind);
+ const int data_kind = tens.getElementType();
+ auto device_method = std::dynamic_pointer_cast<numerics::DeviceTensorMethod>(functor);
+ if(device_method){ //user-defined device kernel
+  error_code = device_method->applyOnDevice(tens,device_body,data_kind,device_kind,device_id);
  }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Unable to get access to the tensor body!" << std::endl;
-  op.printIt();
-  assert(false);
+  auto scale = std::dynamic_pointer_cast<numerics::FunctorScale>(functor);
+  if(scale) error_code = scale_on_device(device_body,tens.getVolume(),data_kind,device_kind,device_id,scale->getValue());
  }
-#endif
  return error_code;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpBroadcast & op,
+int TalshNodeExecutor::execute(numerics::TensorOpSlice & op,
                                TensorOpExecHandle * exec_handle)
 {
  assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
 
- const auto & tensor = *(op.getTensorOperand(0));
- const auto tensor_hash = tensor.getTensorHash();
- auto tens_pos = tensors_.find(tensor_hash);
- if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Tensor operand 0 not found: " << std::endl;
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Tensor operand 0 not found: " << std::endl;
   op.printIt();
   assert(false);
  }
- tens_pos->second.resetTensorShapeToReduced();
- auto & tens = *(tens_pos->second.talsh_tensor);
-
- *exec_handle = op.getId();
+ tens0_pos->second.resetTensorShapeToFull();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
 
- int error_code = 0;
-#ifdef MPI_ENABLED
- auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
- float * tens_body_r4 = nullptr;
- double * tens_body_r8 = nullptr;
- std::complex<float> * tens_body_c4 = nullptr;
- std::complex<double> * tens_body_c8 = nullptr;
- bool access_granted = false;
- int tens_elem_type = tens.getElementType();
- switch(tens_elem_type){
-  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
-  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
-  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
-  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
-  default:
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Unknown TAL-SH data kind: "
-             << tens_elem_type << std::endl;
-   op.printIt();
-   assert(false);
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
  }
- if(access_granted){
-  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
-  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
-  int root_rank = op.getRootRank();
-  std::size_t tens_volume = tens.getVolume();
-  int chunk = std::numeric_limits<int>::max();
-  for(std::size_t base = 0; base < tens_volume; base += chunk){
-   int count = std::min(chunk,static_cast<int>(tens_volume-base));
-   switch(tens_elem_type){
-    case(talsh::REAL32):
-     assert(tens_body_r4 != nullptr);
-     error_code = MPI_Bcast((void*)(&tens_body_r4[base]),count,mpi_data_kind,root_rank,communicator);
-     break;
-    case(talsh::REAL64):
-     assert(tens_body_r8 != nullptr);
-     error_code = MPI_Bcast((void*)(&tens_body_r8[base]),count,mpi_data_kind,root_rank,communicator);
-     break;
-    case(talsh::COMPLEX32):
-     assert(tens_body_c4 != nullptr);
-     error_code = MPI_Bcast((void*)(&tens_body_c4[base]),count,mpi_data_kind,root_rank,communicator);
-     break;
-    case(talsh::COMPLEX64):
+ tens1_pos->second.resetTensorShapeToFull();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ const auto & tensor_signature = tensor1.getSignature();
+ const auto & slice_signature = tensor0.getSignature();
+ const auto slice_rank = slice_signature.getRank();
+ std::vector<int> offsets(slice_rank);
+ for(unsigned int i = 0; i < slice_rank; ++i){
+  const auto tensor_space_id = tensor_signature.getDimSpaceId(i);
+  const auto tensor_subspace_id = tensor_signature.getDimSubspaceId(i);
+  const auto slice_space_id = slice_signature.getDimSpaceId(i);
+  const auto slice_subspace_id = slice_signature.getDimSubspaceId(i);
+  if(slice_space_id == SOME_SPACE && tensor_space_id == SOME_SPACE){
+   if(slice_subspace_id < tensor_subspace_id){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Slice offset below lower bound: "
+              << slice_subspace_id << " < " << tensor_subspace_id << std::endl;
+    assert(false);
+   }
+   if((slice_subspace_id - tensor_subspace_id) > std::numeric_limits<int>::max()){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Integer (int) overflow in offsets" << std::endl;
+    assert(false);
+   }
+   offsets[i] = static_cast<int>(slice_subspace_id - tensor_subspace_id);
+  }else if(slice_space_id != SOME_SPACE && tensor_space_id == slice_space_id){
+   const auto * tensor_subspace = getSpaceRegister()->getSubspace(tensor_space_id,tensor_subspace_id);
+   const auto tensor_lower_bound = tensor_subspace->getLowerBound();
+   const auto * slice_subspace = getSpaceRegister()->getSubspace(slice_space_id,slice_subspace_id);
+   const auto slice_lower_bound = slice_subspace->getLowerBound();
+   if(slice_lower_bound < tensor_lower_bound){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Slice offset below lower bound: "
+              << slice_lower_bound << " < " << tensor_lower_bound << std::endl;
+    assert(false);
+   }
+   if((slice_lower_bound - tensor_lower_bound) > std::numeric_limits<int>::max()){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Integer (int) overflow in offsets" << std::endl;
+    assert(false);
+   }
+   offsets[i] = static_cast<int>(slice_lower_bound - tensor_lower_bound);
+  }else{
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Space mismatch: "
+             << slice_space_id << " VS "<< tensor_space_id << std::endl;
+   assert(false);
+  }
+ }
+
+ *exec_handle = op.getId();
+ if(createSliceView(op,offsets)) return 0; //the read-only slice aliases the body of the parental tensor
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): SLICE: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ auto error_code = copySliceOnHost(tens1,tens0,offsets,false,op.isAccumulative());
+ if(error_code == TALSH_NOT_AVAILABLE){ //TAL-SH slicing (on the device the tensor operands reside on)
+  error_code = tens1.extractSlice((task_res.first)->second.get(),
+                                  tens0,
+                                  offsets,
+                                  DEV_DEFAULT,DEV_DEFAULT,
+                                  op.isAccumulative());
+  if(error_code != TALSH_SUCCESS){ //fall back to Host
+   (task_res.first)->second->clean();
+   error_code = tens1.extractSlice((task_res.first)->second.get(),
+                                   tens0,
+                                   offsets,
+                                   DEV_HOST,0,
+                                   op.isAccumulative());
+  }
+ }
+
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpInsert & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToFull();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens1_pos->second.resetTensorShapeToFull();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ const auto & tensor_signature = tensor0.getSignature();
+ const auto & slice_signature = tensor1.getSignature();
+ const auto slice_rank = slice_signature.getRank();
+ std::vector<int> offsets(slice_rank);
+ for(unsigned int i = 0; i < slice_rank; ++i){
+  const auto tensor_space_id = tensor_signature.getDimSpaceId(i);
+  const auto tensor_subspace_id = tensor_signature.getDimSubspaceId(i);
+  const auto slice_space_id = slice_signature.getDimSpaceId(i);
+  const auto slice_subspace_id = slice_signature.getDimSubspaceId(i);
+  if(slice_space_id == SOME_SPACE && tensor_space_id == SOME_SPACE){
+   if(slice_subspace_id < tensor_subspace_id){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Slice offset below lower bound: "
+              << slice_subspace_id << " < " << tensor_subspace_id << std::endl;
+    assert(false);
+   }
+   if((slice_subspace_id - tensor_subspace_id) > std::numeric_limits<int>::max()){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Integer (int) overflow in offsets" << std::endl;
+    assert(false);
+   }
+   offsets[i] = static_cast<int>(slice_subspace_id - tensor_subspace_id);
+  }else if(slice_space_id != SOME_SPACE && tensor_space_id == slice_space_id){
+   const auto * tensor_subspace = getSpaceRegister()->getSubspace(tensor_space_id,tensor_subspace_id);
+   const auto tensor_lower_bound = tensor_subspace->getLowerBound();
+   const auto * slice_subspace = getSpaceRegister()->getSubspace(slice_space_id,slice_subspace_id);
+   const auto slice_lower_bound = slice_subspace->getLowerBound();
+   if(slice_lower_bound < tensor_lower_bound){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Slice offset below lower bound: "
+              << slice_lower_bound << " < " << tensor_lower_bound << std::endl;
+    assert(false);
+   }
+   if((slice_lower_bound - tensor_lower_bound) > std::numeric_limits<int>::max()){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Integer (int) overflow in offsets" << std::endl;
+    assert(false);
+   }
+   offsets[i] = static_cast<int>(slice_lower_bound - tensor_lower_bound);
+  }else{
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): INSERT: Space mismatch: "
+             << slice_space_id << " VS "<< tensor_space_id << std::endl;
+   assert(false);
+  }
+ }
+
+ auto error_code = copySliceOnHost(tens0,tens1,offsets,true,op.isAccumulative());
+ if(error_code == TALSH_NOT_AVAILABLE){ //TAL-SH insertion (on the device the tensor operands reside on)
+  error_code = tens0.insertSlice((task_res.first)->second.get(),
+                                 tens1,
+                                 offsets,
+                                 DEV_DEFAULT,DEV_DEFAULT,
+                                 op.isAccumulative());
+  if(error_code != TALSH_SUCCESS){ //fall back to Host
+   (task_res.first)->second->clean();
+   error_code = tens0.insertSlice((task_res.first)->second.get(),
+                                  tens1,
+                                  offsets,
+                                  DEV_HOST,0,
+                                  op.isAccumulative());
+  }
+ }
+
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpAdd & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens1_pos->second.resetTensorShapeToReduced();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ if(aliasDonatedTensor(op)) return 0; //the destination tensor took over the body of the donated tensor
+ if(deferPlainCopy(op)) return 0; //the destination tensor will be copied from the source tensor once needed
+ if(executeHostTranspose(op,tens0,tens1)) return 0; //synchronous transpose kernels on Host
+
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ADD: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ if(known_zero_.find(tensor0_hash) != known_zero_.end()){ //known-zero destination tensor
+  if(op.getScalar(0) != std::complex<double>(1.0,0.0)) materializeZeros(tensor0_hash);
+ }
+ if(known_zero_.find(tensor0_hash) != known_zero_.end()){ //known-zero destination tensor: Overwrite
+  auto pattern = op.getIndexPatternReduced();
+  const auto pos = pattern.find("+=");
+  if(pos != std::string::npos) pattern.replace(pos,2,"=");
+  auto error_code = tens0.copyBody((task_res.first)->second.get(),pattern,tens1,DEV_DEFAULT,DEV_DEFAULT);
+  if(error_code != TALSH_SUCCESS){
+   (task_res.first)->second->clean();
+   error_code = tens0.copyBody((task_res.first)->second.get(),pattern,tens1,DEV_HOST,0);
+  }
+  if(error_code == TALSH_SUCCESS) known_zero_.erase(tensor0_hash);
+  return error_code;
+ }
+
+ auto error_code = tens0.accumulate((task_res.first)->second.get(),
+                                    op.getIndexPatternReduced(),
+                                    tens1,
+                                    DEV_DEFAULT,DEV_DEFAULT,
+                                    op.getScalar(0));
+ if(error_code == DEVICE_UNABLE || error_code == TALSH_NOT_AVAILABLE || error_code == TALSH_NOT_IMPLEMENTED){
+  (task_res.first)->second->clean();
+  error_code = tens0.accumulate((task_res.first)->second.get(),
+                                op.getIndexPatternReduced(),
+                                tens1,
+                                DEV_HOST,0,
+                                op.getScalar(0));
+ }else if(error_code == TRY_LATER){
+  std::size_t total_tensor_size = tensor0.getSize() + tensor1.getSize();
+  auto evicting = evictMovedTensors(talsh::determineOptimalDevice(tens0,tens1),total_tensor_size);
+ }else if(error_code == TALSH_SUCCESS){
+  prefetch_enabled_ = true;
+ }
+ if(error_code == TALSH_SUCCESS){
+  double flop_count = talsh_submitted_flops_.load() + op.getFlopEstimate() * tensorElementTypeOpFactor(tensor1.getElementType());
+  talsh_submitted_flops_.store(flop_count);
+ }
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpContract & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ const auto error_code = executeContraction(op,exec_handle);
+ if(error_code != TRY_LATER) scaled_contractions_.erase(&op); //the scaled destination tensor has been consumed (ll)
+ return error_code;
+}
+
+
+int TalshNodeExecutor::executeContraction(numerics::TensorOpContract & op,
+                                          TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens1_pos->second.resetTensorShapeToReduced();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ const auto & tensor2 = *(op.getTensorOperand(2));
+ const auto tensor2_hash = tensor2.getTensorHash();
+ auto tens2_pos = tensors_.find(tensor2_hash);
+ if(tens2_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Tensor operand 2 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens2_pos->second.resetTensorShapeToReduced();
+ auto & tens2 = *(tens2_pos->second.talsh_tensor);
+
+ //Scaled accumulation (beta other than 0 and 1): TAL-SH only accumulates, thus the destination is scaled first:
+ const auto beta = op.getBeta();
+ if(op.isAccumulative() && beta != std::complex<double>(1.0,0.0) &&
+    known_zero_.find(tensor0_hash) == known_zero_.end()){
+  if(scaled_contractions_.find(&op) == scaled_contractions_.end()){ //not scaled yet by a postponed attempt (ll)
+   auto synced = tens0.sync(DEV_HOST,0,nullptr,true); assert(synced);
+   auto scaled = scale_host_body(tens0,beta);
+   if(!scaled){
+    std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Beta prefactor " << beta
+              << " cannot scale the destination tensor: " << std::endl;
+    op.printIt();
+    assert(false);
+   }
+   scaled_contractions_.emplace(&op);
+  }
+ }
+
+ const double flops = op.getFlopEstimate() * tensorElementTypeOpFactor(tensor1.getElementType());
+ const auto device_class = op.getExecutionDevice();
+ bool small = (device_class == TensorOpDevice::HOST) ||
+              (device_class == TensorOpDevice::ANY && isSmallContraction({&tens0,&tens1,&tens2},flops));
+ //Autotuned execution strategy (aa):
+ std::string tuning_key;
+ int strategy = ContractAutotuner::DEFAULT_STRATEGY;
+ bool tuning_trial = false;
+ if(autotuner_.isActive() && device_class == TensorOpDevice::ANY && !dry_run_.load()){
+  tuning_key = contractionTuningKey(op,tens0,tens1,tens2);
+  strategy = autotuner_.select(tuning_key,contractionStrategies(flops),&tuning_trial);
+  if(strategy != ContractAutotuner::DEFAULT_STRATEGY) small = (strategy != CONTRACT_ACCELERATOR);
+ }
+ const double tuning_start = exatn::Timer::timeInSecHR();
+ if(small && (strategy == ContractAutotuner::DEFAULT_STRATEGY || strategy == CONTRACT_HOST_DIRECT)){
+  if(executeSmallContraction(op,tens0,tens1,tens2,flops)){ //synchronous small kernel on Host
+   if(tuning_trial) autotuner_.record(tuning_key,strategy,exatn::Timer::timeInSecHR(tuning_start));
+   *exec_handle = op.getId();
+   return 0;
+  }
+  if(tuning_trial){ //small kernels are not applicable
+   autotuner_.reject(tuning_key,strategy);
+   tuning_trial = false;
+  }
+ }
+ //Transpose-free direct kernels on Host (bb):
+ const bool host_bound = small || (talsh_gpus_.empty() && device_class != TensorOpDevice::ACCELERATOR);
+ if((host_bound && strategy == ContractAutotuner::DEFAULT_STRATEGY) || strategy == CONTRACT_HOST_PACKED){
+  if(executeDirectContraction(op,tens0,tens1,tens2,flops,strategy == CONTRACT_HOST_PACKED)){
+   if(tuning_trial) autotuner_.record(tuning_key,strategy,exatn::Timer::timeInSecHR(tuning_start));
+   *exec_handle = op.getId();
+   return 0;
+  }
+  if(tuning_trial){ //direct kernels are not applicable
+   autotuner_.reject(tuning_key,strategy);
+   tuning_trial = false;
+  }
+ }
+ //3M (Gauss) complex tensor contractions (dd):
+ if(strategy == ContractAutotuner::DEFAULT_STRATEGY && gaussContraction(op,tens0,tens1,tens2,flops)){
+  if(executeGaussContraction(op,tens0,tens1,tens2,flops,small)){
+   *exec_handle = op.getId();
+   return 0;
+  }
+ }
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): CONTRACT: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ //Replay of the recurring launch sequence (ee):
+ std::size_t launch_signature = 0;
+ LaunchSequence::Launch launch;
+ const bool launch_recorded = (!small && launch_sequence_.isActive());
+ if(launch_recorded) launch_signature = contractionSignature(op,tens0,tens1,tens2);
+ const bool replayed = (launch_recorded && launch_sequence_.next(launch_signature,&launch));
+ int exec_device = small ? DEV_DEFAULT : (replayed ? launch.device : selectExecutionDevice({&tens0,&tens1,&tens2},flops));
+ if((device_class == TensorOpDevice::ACCELERATOR || strategy == CONTRACT_ACCELERATOR) &&
+    exec_device == DEV_DEFAULT && !talsh_gpus_.empty())
+  exec_device = talshFlatDevId(DEV_NVIDIA_GPU,talsh_gpus_.front()); //single GPU: do not leave the choice to TAL-SH
+ int exec_dev_kind = DEV_DEFAULT, exec_dev_id = DEV_DEFAULT;
+ switchFastMath(reducedPrecision(op,tens0,tens1,tens2));
+ talsh::Tensor * left = &tens1; talsh::Tensor * right = &tens2;
+ std::vector<std::shared_ptr<talsh::Tensor>> layouts;
+ const auto pattern = (strategy == CONTRACT_HOST_TTGT) ? op.getIndexPatternReduced()
+                                                       : applyLayoutCache(op,&left,&right,layouts);
+ const bool zero_output = (known_zero_.find(op.getTensorOperandHash(0)) != known_zero_.end());
+ const bool accumulative = op.isAccumulative() && !zero_output; //known-zero destination tensor is overwritten
+ if(small){ //small (or Host-bound) tensor contractions are executed on Host to avoid the accelerator launch latency
+  exec_dev_kind = DEV_HOST; exec_dev_id = 0;
+ }else if(exec_device != DEV_DEFAULT){
+  exec_dev_id = talshKindDevId(exec_device,&exec_dev_kind);
+ }
+
+ //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): Tensor contraction " << op.getIndexPattern() << std::endl; //debug
+ //const auto host_buf_free_mem = talshDeviceBufferFreeSize(0,DEV_HOST); //debug
+ auto error_code = tens0.contractAccumulate((task_res.first)->second.get(),
+                                            pattern,
+                                            *left,*right,
+                                            exec_dev_kind,exec_dev_id,
+                                            op.getScalar(0),
+                                            accumulative);
+ if(tuning_trial && error_code != TALSH_SUCCESS){
+  if(error_code == TRY_LATER){
+   autotuner_.cancel(tuning_key,strategy); //will be retried
+  }else{
+   autotuner_.reject(tuning_key,strategy); //the fallback execution does not follow the strategy
+  }
+  tuning_trial = false;
+ }
+ if(error_code == DEVICE_UNABLE){ //use out-of-core version if tensor contraction does not fit in GPU
+  //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CONTRACT: Redirected to XL\n" << std::flush; //debug
+  (task_res.first)->second->clean();
+  bool synced = sync(); //completes all active tasks, prefetches and evictions
+  bool evicting = evictMovedTensors(DEV_DEFAULT,0); //evict all cached tensors from all accelerators
+  if(evicting) synced = synced && sync(); //completes all evictions
+  task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                            acquireTask()));
+  if(synced){
+   error_code = tens0.contractAccumulateXL((task_res.first)->second.get(),
+                                           pattern,
+                                           *left,*right,
+                                           DEV_DEFAULT,DEV_DEFAULT,
+                                           op.getScalar(0),
+                                           accumulative);
+  }else{
+   error_code = tens0.contractAccumulate((task_res.first)->second.get(),
+                                         pattern,
+                                         *left,*right,
+                                         DEV_HOST,0,
+                                         op.getScalar(0),
+                                         accumulative);
+  }
+ }else if(error_code == TALSH_NOT_AVAILABLE || error_code == TALSH_NOT_IMPLEMENTED){
+  (task_res.first)->second->clean();
+  error_code = tens0.contractAccumulate((task_res.first)->second.get(),
+                                         pattern,
+                                         *left,*right,
+                                         DEV_HOST,0,
+                                         op.getScalar(0),
+                                         accumulative);
+ }else if(error_code == TRY_LATER){
+  std::size_t total_tensor_size = tensor0.getSize() + tensor1.getSize() + tensor2.getSize();
+  bool evicting = evictMovedTensors((exec_device != DEV_DEFAULT) ? exec_device
+                                    : talsh::determineOptimalDevice(tens0,*left,*right),total_tensor_size);
+ }else if(error_code == TALSH_SUCCESS){
+  prefetch_enabled_ = true;
+  if(exec_device != DEV_DEFAULT) registerPlacement(*exec_handle,exec_device,flops);
+ }
+ if(error_code == TALSH_SUCCESS && launch_recorded) launch_sequence_.record(launch_signature,exec_device);
+ if(error_code == TALSH_SUCCESS){
+  if(zero_output) known_zero_.erase(op.getTensorOperandHash(0));
+  if(!layouts.empty()) layouts_in_use_[*exec_handle] = std::move(layouts);
+  if(tuning_trial) tuning_trials_[*exec_handle] = TuningTrial{tuning_key,strategy,tuning_start};
+  double flop_count = talsh_submitted_flops_.load() + flops;
+  talsh_submitted_flops_.store(flop_count);
+ }
+ if(error_code != TALSH_SUCCESS){ //permuted copies of a postponed tensor contraction
+  for(auto & copy: layouts) releaseLayoutTensor(copy);
+ }
+ /*if(talshDeviceBufferFreeSize(0,DEV_HOST) < host_buf_free_mem){ //debug
+  std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): Host buffer leak detected for tensor contraction:\n";
+  op.printIt();
+  std::abort();
+ }*/
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpDecomposeSVD3 & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens1_pos->second.resetTensorShapeToReduced();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ const auto & tensor2 = *(op.getTensorOperand(2));
+ const auto tensor2_hash = tensor2.getTensorHash();
+ auto tens2_pos = tensors_.find(tensor2_hash);
+ if(tens2_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 2 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens2_pos->second.resetTensorShapeToReduced();
+ auto & tens2 = *(tens2_pos->second.talsh_tensor);
+
+ const auto & tensor3 = *(op.getTensorOperand(3));
+ const auto tensor3_hash = tensor3.getTensorHash();
+ auto tens3_pos = tensors_.find(tensor3_hash);
+ if(tens3_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Tensor operand 3 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens3_pos->second.resetTensorShapeToReduced();
+ auto & tens3 = *(tens3_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD3: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = TALSH_SUCCESS;
+ if(op.randomizedTruncation() || op.getTruncationTolerance() > 0.0){ //truncated SVD
+  error_code = decomposeSVDTruncated(op.getIndexPatternReduced(),tens3,tens0,tens1,&tens2,
+                                     op.randomizedTruncation(),op.getTruncationTolerance());
+ }else{
+  error_code = tens3.decomposeSVD((task_res.first)->second.get(),
+                                  op.getIndexPatternReduced(),
+                                  tens0,tens1,tens2,
+                                  DEV_HOST,0);
+ }
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpDecomposeSVD2 & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ const auto & tensor1 = *(op.getTensorOperand(1));
+ const auto tensor1_hash = tensor1.getTensorHash();
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens1_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 1 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens1_pos->second.resetTensorShapeToReduced();
+ auto & tens1 = *(tens1_pos->second.talsh_tensor);
+
+ const auto & tensor2 = *(op.getTensorOperand(2));
+ const auto tensor2_hash = tensor2.getTensorHash();
+ auto tens2_pos = tensors_.find(tensor2_hash);
+ if(tens2_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Tensor operand 2 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens2_pos->second.resetTensorShapeToReduced();
+ auto & tens2 = *(tens2_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD2: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = TALSH_SUCCESS;
+ if(op.randomizedTruncation() || op.getTruncationTolerance() > 0.0){ //truncated SVD
+  error_code = decomposeSVDTruncated(op.getIndexPatternReduced(),tens2,tens0,tens1,nullptr,
+                                     op.randomizedTruncation(),op.getTruncationTolerance());
+ }else{
+  error_code = tens2.decomposeSVDLR((task_res.first)->second.get(),
+                                    op.getIndexPatternReduced(),
+                                    tens0,tens1,
+                                    DEV_HOST,0);
+ }
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpOrthogonalizeSVD & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_SVD: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_SVD: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ auto error_code = tens0.orthogonalizeSVD((task_res.first)->second.get(),
+                                          op.getIndexPatternReduced(),
+                                          DEV_HOST,0);
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpOrthogonalizeMGS & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor0 = *(op.getTensorOperand(0));
+ const auto tensor0_hash = tensor0.getTensorHash();
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ if(tens0_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_MGS: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens0_pos->second.resetTensorShapeToReduced();
+ auto & tens0 = *(tens0_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ORTHOGONALIZE_MGS: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ auto error_code = 0;
+ /*
+ auto error_code = tens0.orthogonalizeMGS((task_res.first)->second.get(),
+                                          op.getIndexPatternReduced(),
+                                          DEV_HOST,0);
+ */
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpFetch & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor = *(op.getTensorOperand(0));
+ const auto tensor_hash = tensor.getTensorHash();
+ auto tens_pos = tensors_.find(tensor_hash);
+ if(tens_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens_pos->second.resetTensorShapeToReduced();
+ auto & tens = *(tens_pos->second.talsh_tensor);
+ bool received = false;
+ if(!completeEarlyReceive(op,tens,&received)) return TRY_LATER; //early receive still in flight (hh)
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = 0;
+#ifdef MPI_ENABLED
+ beginCommRecord(*exec_handle,CommProfile::CommKind::FETCH,op.getMPICommunicator(),
+                 op.getRemoteProcessRank(),op.getTensorOperand(0)->getSize());
+ if(received) return error_code; //tensor body has already been received by the early receive (hh)
+ //GPU-direct transfer of the device-resident tensor body (CUDA-aware MPI):
+ int body_device = DEV_NULL;
+ void * device_body = getDeviceResidentBody(tens,&body_device);
+ if(device_body != nullptr){
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  gpu_direct_transfers_.emplace(std::make_pair(*exec_handle,&tens));
+  error_code = postDeviceTransfer(op.getOpcode(),device_body,tens.getVolume(),tens.getElementType(),
+                                  op.getRemoteProcessRank(),op.getMessageTag(),op.getMPICommunicator(),req_res.first->second);
+  return error_code;
+ }
+ auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ float * tens_body_r4 = nullptr;
+ double * tens_body_r8 = nullptr;
+ std::complex<float> * tens_body_c4 = nullptr;
+ std::complex<double> * tens_body_c8 = nullptr;
+ bool access_granted = false;
+ int tens_elem_type = tens.getElementType();
+ switch(tens_elem_type){
+  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
+  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
+  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
+  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Unknown TAL-SH data kind: "
+             << tens_elem_type << std::endl;
+   op.printIt();
+   assert(false);
+ }
+ if(access_granted){
+  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
+  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
+  int remote_rank = op.getRemoteProcessRank();
+  int mesg_tag = op.getMessageTag();
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  std::size_t tens_volume = tens.getVolume();
+  bool started = false;
+  if(persistent_requests_){
+   void * tens_body = nullptr;
+   switch(tens_elem_type){
+    case(talsh::REAL32): tens_body = (void*)tens_body_r4; break;
+    case(talsh::REAL64): tens_body = (void*)tens_body_r8; break;
+    case(talsh::COMPLEX32): tens_body = (void*)tens_body_c4; break;
+    case(talsh::COMPLEX64): tens_body = (void*)tens_body_c8; break;
+   }
+   started = startPersistentTransfer(tensor_hash,tens_body,tens_volume,tens_elem_type,remote_rank,mesg_tag,
+                                     op.getMPICommunicator(),false,req_res.first->second,&error_code);
+  }
+  if(!started){
+   int chunk = std::numeric_limits<int>::max();
+   for(std::size_t base = 0; base < tens_volume; base += chunk){
+    int count = std::min(chunk,static_cast<int>(tens_volume-base));
+    MPI_Request * mpi_req = new MPI_Request;
+    req_res.first->second.emplace_back((void*)mpi_req);
+    switch(tens_elem_type){
+     case(talsh::REAL32):
+      assert(tens_body_r4 != nullptr);
+      error_code = MPI_Irecv((void*)(&tens_body_r4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::REAL64):
+      assert(tens_body_r8 != nullptr);
+      error_code = MPI_Irecv((void*)(&tens_body_r8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::COMPLEX32):
+      assert(tens_body_c4 != nullptr);
+      error_code = MPI_Irecv((void*)(&tens_body_c4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::COMPLEX64):
+      assert(tens_body_c8 != nullptr);
+      error_code = MPI_Irecv((void*)(&tens_body_c8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+    }
+    if(error_code != MPI_SUCCESS) break;
+   }
+  }
+ }else{
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): FETCH: Unable to get access to the tensor body!" << std::endl;
+  op.printIt();
+  assert(false);
+ }
+#endif
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpUpload & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor = *(op.getTensorOperand(0));
+ const auto tensor_hash = tensor.getTensorHash();
+ auto tens_pos = tensors_.find(tensor_hash);
+ if(tens_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens_pos->second.resetTensorShapeToReduced();
+ auto & tens = *(tens_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = 0;
+#ifdef MPI_ENABLED
+ beginCommRecord(*exec_handle,CommProfile::CommKind::UPLOAD,op.getMPICommunicator(),
+                 op.getRemoteProcessRank(),op.getTensorOperand(0)->getSize());
+ //GPU-direct transfer of the device-resident tensor body (CUDA-aware MPI):
+ int body_device = DEV_NULL;
+ void * device_body = getDeviceResidentBody(tens,&body_device);
+ if(device_body != nullptr){
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  gpu_direct_transfers_.emplace(std::make_pair(*exec_handle,&tens));
+  error_code = postDeviceTransfer(op.getOpcode(),device_body,tens.getVolume(),tens.getElementType(),
+                                  op.getRemoteProcessRank(),op.getMessageTag(),op.getMPICommunicator(),req_res.first->second);
+  return error_code;
+ }
+ auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ float * tens_body_r4 = nullptr;
+ double * tens_body_r8 = nullptr;
+ std::complex<float> * tens_body_c4 = nullptr;
+ std::complex<double> * tens_body_c8 = nullptr;
+ bool access_granted = false;
+ int tens_elem_type = tens.getElementType();
+ switch(tens_elem_type){
+  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
+  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
+  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
+  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Unknown TAL-SH data kind: "
+             << tens_elem_type << std::endl;
+   op.printIt();
+   assert(false);
+ }
+ if(access_granted){
+  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
+  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
+  int remote_rank = op.getRemoteProcessRank();
+  int mesg_tag = op.getMessageTag();
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  std::size_t tens_volume = tens.getVolume();
+  bool started = false;
+  if(persistent_requests_){
+   void * tens_body = nullptr;
+   switch(tens_elem_type){
+    case(talsh::REAL32): tens_body = (void*)tens_body_r4; break;
+    case(talsh::REAL64): tens_body = (void*)tens_body_r8; break;
+    case(talsh::COMPLEX32): tens_body = (void*)tens_body_c4; break;
+    case(talsh::COMPLEX64): tens_body = (void*)tens_body_c8; break;
+   }
+   started = startPersistentTransfer(tensor_hash,tens_body,tens_volume,tens_elem_type,remote_rank,mesg_tag,
+                                     op.getMPICommunicator(),true,req_res.first->second,&error_code);
+  }
+  if(!started){
+   int chunk = std::numeric_limits<int>::max();
+   for(std::size_t base = 0; base < tens_volume; base += chunk){
+    int count = std::min(chunk,static_cast<int>(tens_volume-base));
+    MPI_Request * mpi_req = new MPI_Request;
+    req_res.first->second.emplace_back((void*)mpi_req);
+    switch(tens_elem_type){
+     case(talsh::REAL32):
+      assert(tens_body_r4 != nullptr);
+      error_code = MPI_Isend((const void*)(&tens_body_r4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::REAL64):
+      assert(tens_body_r8 != nullptr);
+      error_code = MPI_Isend((const void*)(&tens_body_r8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::COMPLEX32):
+      assert(tens_body_c4 != nullptr);
+      error_code = MPI_Isend((const void*)(&tens_body_c4[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+     case(talsh::COMPLEX64):
+      assert(tens_body_c8 != nullptr);
+      error_code = MPI_Isend((const void*)(&tens_body_c8[base]),count,mpi_data_kind,remote_rank,mesg_tag,communicator,mpi_req);
+      break;
+    }
+    if(error_code != MPI_SUCCESS) break;
+   }
+  }
+ }else{
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): UPLOAD: Unable to get access to the tensor body!" << std::endl;
+  op.printIt();
+  assert(false);
+ }
+#endif
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpBroadcast & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor = *(op.getTensorOperand(0));
+ const auto tensor_hash = tensor.getTensorHash();
+ auto tens_pos = tensors_.find(tensor_hash);
+ if(tens_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens_pos->second.resetTensorShapeToReduced();
+ auto & tens = *(tens_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = 0;
+#ifdef MPI_ENABLED
+ beginCommRecord(*exec_handle,CommProfile::CommKind::BROADCAST,op.getMPICommunicator(),op.getRootRank(),
+                 transfer_size(*(op.getTensorOperand(0)),op.reducedPrecisionTransfer()));
+ //GPU-direct transfer of the device-resident tensor body (CUDA-aware MPI):
+ int body_device = DEV_NULL;
+ const bool half_transfer = tensorElementTypeIsHalf(op.getTensorOperand(0)->getElementType());
+ void * device_body = (op.reducedPrecisionTransfer() || half_transfer) ? nullptr : getDeviceResidentBody(tens,&body_device);
+ if(device_body != nullptr){
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  gpu_direct_transfers_.emplace(std::make_pair(*exec_handle,&tens));
+  error_code = postDeviceTransfer(op.getOpcode(),device_body,tens.getVolume(),tens.getElementType(),
+                                  op.getRootRank(),0,op.getMPICommunicator(),req_res.first->second);
+  return error_code;
+ }
+ auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ float * tens_body_r4 = nullptr;
+ double * tens_body_r8 = nullptr;
+ std::complex<float> * tens_body_c4 = nullptr;
+ std::complex<double> * tens_body_c8 = nullptr;
+ bool access_granted = false;
+ int tens_elem_type = tens.getElementType();
+ switch(tens_elem_type){
+  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
+  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
+  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
+  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Unknown TAL-SH data kind: "
+             << tens_elem_type << std::endl;
+   op.printIt();
+   assert(false);
+ }
+ if(access_granted){
+  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
+  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
+  int root_rank = op.getRootRank();
+  if(half_transfer){ //half-precision transfer of a half-precision tensor
+   const auto & half_kinds = get_mpi_half_kinds();
+   if(tens_elem_type == talsh::REAL32){
+    error_code = reduced_precision_collective<float,numerics::Float16>(tens_body_r4,tens.getVolume(),ALLREDUCE_CHUNK_SIZE,
+                                                            half_kinds.real_kind,communicator,root_rank);
+   }else{
+    error_code = reduced_precision_collective<std::complex<float>,numerics::ComplexFloat16>(tens_body_c4,tens.getVolume(),
+                                                            ALLREDUCE_CHUNK_SIZE,half_kinds.complex_kind,communicator,root_rank);
+   }
+   return error_code;
+  }
+  if(op.reducedPrecisionTransfer() &&
+     (tens_elem_type == talsh::REAL64 || tens_elem_type == talsh::COMPLEX64)){ //single-precision transfer
+   if(tens_elem_type == talsh::REAL64){
+    error_code = reduced_precision_collective<double,float>(tens_body_r8,tens.getVolume(),ALLREDUCE_CHUNK_SIZE,
+                                                            MPI_REAL,communicator,root_rank);
+   }else{
+    error_code = reduced_precision_collective<std::complex<double>,std::complex<float>>(tens_body_c8,tens.getVolume(),
+                                                            ALLREDUCE_CHUNK_SIZE,MPI_COMPLEX,communicator,root_rank);
+   }
+   return error_code;
+  }
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  std::size_t tens_volume = tens.getVolume();
+  int chunk = ALLREDUCE_CHUNK_SIZE; //pipelined chunks
+  for(std::size_t base = 0; base < tens_volume; base += chunk){
+   int count = std::min(chunk,static_cast<int>(tens_volume-base));
+   MPI_Request * mpi_req = new MPI_Request;
+   req_res.first->second.emplace_back((void*)mpi_req);
+   switch(tens_elem_type){
+    case(talsh::REAL32):
+     assert(tens_body_r4 != nullptr);
+     error_code = MPI_Ibcast((void*)(&tens_body_r4[base]),count,mpi_data_kind,root_rank,communicator,mpi_req);
+     break;
+    case(talsh::REAL64):
+     assert(tens_body_r8 != nullptr);
+     error_code = MPI_Ibcast((void*)(&tens_body_r8[base]),count,mpi_data_kind,root_rank,communicator,mpi_req);
+     break;
+    case(talsh::COMPLEX32):
+     assert(tens_body_c4 != nullptr);
+     error_code = MPI_Ibcast((void*)(&tens_body_c4[base]),count,mpi_data_kind,root_rank,communicator,mpi_req);
+     break;
+    case(talsh::COMPLEX64):
+     assert(tens_body_c8 != nullptr);
+     error_code = MPI_Ibcast((void*)(&tens_body_c8[base]),count,mpi_data_kind,root_rank,communicator,mpi_req);
+     break;
+   }
+   if(error_code != MPI_SUCCESS) break;
+  }
+ }else{
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Unable to get access to the tensor body!" << std::endl;
+  op.printIt();
+  assert(false);
+ }
+#endif
+ return error_code;
+}
+
+
+int TalshNodeExecutor::execute(numerics::TensorOpAllreduce & op,
+                               TensorOpExecHandle * exec_handle)
+{
+ assert(op.isSet());
+ if(tensorOperandsPinned(op) || !finishPrefetching(op)) return TRY_LATER;
+ invalidateLayouts(op);
+ if(!materializeCopies(op)) return TRY_LATER;
+ materializeZeros(op);
+
+ const auto & tensor = *(op.getTensorOperand(0));
+ const auto tensor_hash = tensor.getTensorHash();
+ auto tens_pos = tensors_.find(tensor_hash);
+ if(tens_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Tensor operand 0 not found: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+ tens_pos->second.resetTensorShapeToReduced();
+ auto & tens = *(tens_pos->second.talsh_tensor);
+
+ *exec_handle = op.getId();
+ auto task_res = tasks_.emplace(std::make_pair(*exec_handle,
+                                acquireTask()));
+ if(!task_res.second){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Attempt to execute the same operation twice: " << std::endl;
+  op.printIt();
+  assert(false);
+ }
+
+ int error_code = 0;
+#ifdef MPI_ENABLED
+ beginCommRecord(*exec_handle,(op.getRootRank() >= 0) ? CommProfile::CommKind::REDUCE : CommProfile::CommKind::ALLREDUCE,
+                 op.getMPICommunicator(),op.getRootRank(),
+                 transfer_size(*(op.getTensorOperand(0)),op.reducedPrecisionTransfer() && op.getRootRank() < 0));
+ //GPU-direct transfer of the device-resident tensor body (CUDA-aware MPI):
+ int body_device = DEV_NULL;
+ const bool half_transfer = tensorElementTypeIsHalf(op.getTensorOperand(0)->getElementType());
+ void * device_body = (op.reducedPrecisionTransfer() || half_transfer) ? nullptr : getDeviceResidentBody(tens,&body_device);
+ if(device_body != nullptr){
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  gpu_direct_transfers_.emplace(std::make_pair(*exec_handle,&tens));
+  error_code = postDeviceTransfer(op.getOpcode(),device_body,tens.getVolume(),tens.getElementType(),
+                                  op.getRootRank(),0,op.getMPICommunicator(),req_res.first->second);
+  return error_code;
+ }
+ auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ float * tens_body_r4 = nullptr;
+ double * tens_body_r8 = nullptr;
+ std::complex<float> * tens_body_c4 = nullptr;
+ std::complex<double> * tens_body_c8 = nullptr;
+ bool access_granted = false;
+ int tens_elem_type = tens.getElementType();
+ switch(tens_elem_type){
+  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
+  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
+  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
+  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Unknown TAL-SH data kind: "
+             << tens_elem_type << std::endl;
+   op.printIt();
+   assert(false);
+ }
+ if(access_granted){
+  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
+  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
+  const int root_rank = op.getRootRank(); //reduce to root (non-negative) or allreduce (negative)
+  int my_rank = 0;
+  if(root_rank >= 0){error_code = MPI_Comm_rank(communicator,&my_rank); assert(error_code == MPI_SUCCESS);}
+  if(half_transfer && root_rank < 0){ //half-precision transfer of a half-precision tensor
+   const auto & half_kinds = get_mpi_half_kinds();
+   if(tens_elem_type == talsh::REAL32){
+    error_code = reduced_precision_collective<float,numerics::Float16>(tens_body_r4,tens.getVolume(),ALLREDUCE_CHUNK_SIZE,
+                                                            half_kinds.real_kind,communicator,-1,half_kinds.real_sum);
+   }else{
+    error_code = reduced_precision_collective<std::complex<float>,numerics::ComplexFloat16>(tens_body_c4,tens.getVolume(),
+                                                            ALLREDUCE_CHUNK_SIZE,half_kinds.complex_kind,communicator,-1,
+                                                            half_kinds.complex_sum);
+   }
+   return error_code;
+  }
+  if(op.reducedPrecisionTransfer() && root_rank < 0 &&
+     (tens_elem_type == talsh::REAL64 || tens_elem_type == talsh::COMPLEX64)){ //single-precision transfer
+   if(tens_elem_type == talsh::REAL64){
+    error_code = reduced_precision_collective<double,float>(tens_body_r8,tens.getVolume(),ALLREDUCE_CHUNK_SIZE,
+                                                            MPI_REAL,communicator,-1);
+   }else{
+    error_code = reduced_precision_collective<std::complex<double>,std::complex<float>>(tens_body_c8,tens.getVolume(),
+                                                            ALLREDUCE_CHUNK_SIZE,MPI_COMPLEX,communicator,-1);
+   }
+   return error_code;
+  }
+  auto req_res = mpi_requests_.emplace(std::make_pair(*exec_handle,
+                                       std::list<void*>{})); assert(req_res.second);
+  std::size_t tens_volume = tens.getVolume();
+  int chunk = ALLREDUCE_CHUNK_SIZE; //pipelined chunks
+  for(std::size_t base = 0; base < tens_volume; base += chunk){
+   int count = std::min(chunk,static_cast<int>(tens_volume-base));
+   MPI_Request * mpi_req = new MPI_Request;
+   req_res.first->second.emplace_back((void*)mpi_req);
+   if(root_rank >= 0){ //reduce to root: The tensor on other processes is left unchanged
+    void * body = nullptr;
+    std::size_t elem_size = 0;
+    switch(tens_elem_type){
+     case(talsh::REAL32): body = (void*)tens_body_r4; elem_size = sizeof(float); break;
+     case(talsh::REAL64): body = (void*)tens_body_r8; elem_size = sizeof(double); break;
+     case(talsh::COMPLEX32): body = (void*)tens_body_c4; elem_size = sizeof(std::complex<float>); break;
+     case(talsh::COMPLEX64): body = (void*)tens_body_c8; elem_size = sizeof(std::complex<double>); break;
+    }
+    assert(body != nullptr);
+    void * chunk_body = (void*)(((char*)body) + base * elem_size);
+    error_code = MPI_Ireduce((my_rank == root_rank) ? MPI_IN_PLACE : chunk_body,chunk_body,count,mpi_data_kind,
+                             MPI_SUM,root_rank,communicator,mpi_req);
+    if(error_code != MPI_SUCCESS) break;
+    continue;
+   }
+   switch(tens_elem_type){
+    case(talsh::REAL32):
+     assert(tens_body_r4 != nullptr);
+     error_code = MPI_Iallreduce(MPI_IN_PLACE,(void*)(&tens_body_r4[base]),count,mpi_data_kind,MPI_SUM,communicator,mpi_req);
+     break;
+    case(talsh::REAL64):
+     assert(tens_body_r8 != nullptr);
+     error_code = MPI_Iallreduce(MPI_IN_PLACE,(void*)(&tens_body_r8[base]),count,mpi_data_kind,MPI_SUM,communicator,mpi_req);
+     break;
+    case(talsh::COMPLEX32):
+     assert(tens_body_c4 != nullptr);
+     error_code = MPI_Iallreduce(MPI_IN_PLACE,(void*)(&tens_body_c4[base]),count,mpi_data_kind,MPI_SUM,communicator,mpi_req);
+     break;
+    case(talsh::COMPLEX64):
      assert(tens_body_c8 != nullptr);
-     error_code = MPI_Bcast((void*)(&tens_body_c8[base]),count,mpi_data_kind,root_rank,communicator);
+     error_code = MPI_Iallreduce(MPI_IN_PLACE,(void*)(&tens_body_c8[base]),count,mpi_data_kind,MPI_SUM,communicator,mpi_req);
      break;
    }
-   if(error_code != MPI_SUCCESS) break;
+   if(error_code != MPI_SUCCESS) break;
+  }
+ }else{
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Unable to get access to the tensor body!" << std::endl;
+  op.printIt();
+  assert(false);
+ }
+#endif
+ return error_code;
+}
+
+
+bool TalshNodeExecutor::sync(TensorOpExecHandle op_handle,
+                             int * error_code,
+                             bool wait)
+{
+ *error_code = 0;
+ bool synced = true;
+ auto iter = tasks_.find(op_handle);
+ if(iter != tasks_.end()){
+  auto & task = *(iter->second);
+  if(!task.isEmpty()){
+   if(wait){
+    synced = task.wait();
+   }else{
+    int sts;
+    synced = task.test(&sts);
+    if(synced && sts == TALSH_TASK_ERROR) *error_code = TALSH_TASK_ERROR;
+   }
+   if(synced && *error_code == 0) cacheMovedTensors(task);
+#ifdef MPI_ENABLED
+  }else{
+   auto req_iter = mpi_requests_.find(op_handle);
+   if(req_iter != mpi_requests_.end()){
+    while(!req_iter->second.empty()){
+     MPI_Request * req = (MPI_Request*)(req_iter->second.front());
+     assert(req != nullptr);
+     int completed = 0;
+     if(wait){
+      int errc = MPI_Wait(req,MPI_STATUS_IGNORE);
+      if(errc == MPI_SUCCESS){
+       completed = 1;
+      }else{
+       *error_code = TALSH_TASK_ERROR;
+      }
+      synced = synced && (completed != 0);
+     }else{
+      int errc = MPI_Test(req,&completed,MPI_STATUS_IGNORE);
+      if(errc != MPI_SUCCESS) *error_code = TALSH_TASK_ERROR;
+      synced = synced && (completed != 0);
+     }
+     if(completed){
+      if(persistent_active_.erase((void*)req) == 0) delete req;
+      req_iter->second.pop_front();
+     }else{
+      break;
+     }
+    }
+    if(synced){
+     mpi_requests_.erase(req_iter);
+     gpu_direct_transfers_.erase(op_handle);
+    }
+   }
+#endif
+  }
+  if(synced){
+   endCommRecord(op_handle);
+   recycleTask(iter->second);
+   tasks_.erase(iter);
+   releasePlacement(op_handle);
+   finishTuningTrial(op_handle,(*error_code == 0));
+   auto layouts = layouts_in_use_.find(op_handle);
+   if(layouts != layouts_in_use_.end()){
+    for(auto & copy: layouts->second) releaseLayoutTensor(copy);
+    layouts_in_use_.erase(layouts);
+   }
+  }
+ }
+ return synced;
+}
+
+
+int TalshNodeExecutor::getExecutionDevice(TensorOpExecHandle op_handle) const
+{
+ auto iter = tasks_.find(op_handle);
+ if(iter != tasks_.end()){
+  auto & task = *(iter->second); //TAL-SH task (shared ownership)
+  if(!task.isEmpty()){
+   int dev_kind;
+   int dev_id = task.getExecutionDevice(&dev_kind);
+   if(dev_id >= 0) return talshFlatDevId(dev_kind,dev_id);
+  }
+ }
+ return -1;
+}
+
+
+bool TalshNodeExecutor::getDeviceLoad(int device,
+                                      double * queued_flops,
+                                      std::size_t * free_mem) const
+{
+ assert(queued_flops != nullptr && free_mem != nullptr);
+ if(device < 0 || device >= DEV_MAX) return false;
+ int dev_kind;
+ int dev_id = talshKindDevId(device,&dev_kind);
+ if(dev_id < 0) return false;
+ *queued_flops = device_queued_flops_[device].load(std::memory_order_relaxed);
+ *free_mem = talshDeviceBufferFreeSize(dev_id,dev_kind);
+ return true;
+}
+
+
+bool TalshNodeExecutor::sync()
+{
+ bool synced = true;
+
+ for(auto & task: evictions_){
+  bool snc = task.second->wait();
+  synced = synced && snc;
+ }
+ evictions_.clear();
+
+#ifdef MPI_ENABLED
+ for(auto & task: mpi_requests_){
+  while(!task.second.empty()){
+   MPI_Request * req = (MPI_Request*)(task.second.front());
+   assert(req != nullptr);
+   int error_code = MPI_Wait(req,MPI_STATUS_IGNORE);
+   synced = synced && (error_code == MPI_SUCCESS);
+   if(persistent_active_.erase((void*)req) == 0) delete req;
+   task.second.pop_front();
+  }
+ }
+ mpi_requests_.clear();
+ while(!comm_pending_.empty()) endCommRecord(comm_pending_.begin()->first);
+#endif
+
+ for(auto & task: tasks_){
+  bool snc = task.second->wait();
+  if(snc){
+   cacheMovedTensors(*(task.second));
+   recycleTask(task.second);
+  }
+  finishTuningTrial(task.first,snc);
+  synced = synced && snc;
+ }
+ tasks_.clear();
+ tuning_trials_.clear();
+ placements_.clear();
+ for(auto & queued_flops: device_queued_flops_) queued_flops.store(0.0,std::memory_order_relaxed);
+ for(auto & layouts: layouts_in_use_){
+  for(auto & copy: layouts.second) releaseLayoutTensor(copy);
+ }
+ layouts_in_use_.clear();
+
+ for(auto & task: prefetches_){
+  bool snc = task.second->wait();
+  if(snc){
+   cacheMovedTensors(*(task.second));
+   recycleTask(task.second);
+  }
+  synced = synced && snc;
+ }
+ prefetches_.clear();
+
+ completeSpills(true);
+ launch_sequence_.commit(); //synchronization point delimits launch sequences (ee)
+ return synced;
+}
+
+
+bool TalshNodeExecutor::discard(TensorOpExecHandle op_handle)
+{
+#ifdef MPI_ENABLED
+ //`Cancel associated MPI message (if any)
+#endif
+ auto iter = tasks_.find(op_handle);
+ if(iter != tasks_.end()){
+  tasks_.erase(iter);
+  releasePlacement(op_handle);
+  finishTuningTrial(op_handle,false);
+  return true;
+ }
+ return false;
+}
+
+
+bool TalshNodeExecutor::prefetch(const numerics::TensorOperation & op)
+{
+ bool prefetching = false;
+ if(op.getOpcode() == TensorOpCode::FETCH) return postEarlyReceive(op); //early receive (hh)
+ //Bring spilled tensor operands back to Host ahead of use:
+ if(!spilled_.empty() && op.getOpcode() != TensorOpCode::DESTROY){
+  const auto num_operands = op.getNumOperandsSet();
+  for(unsigned int i = 0; i < num_operands; ++i){
+   if(!restoreSpilledTensor(op.getTensorOperandHash(i),false)) prefetching = true;
+  }
+  if(prefetching) return prefetching;
+ }
+ if(prefetch_enabled_){
+  const auto opcode = op.getOpcode();
+  if(opcode == TensorOpCode::CONTRACT){
+   const auto num_operands = op.getNumOperands(); assert(num_operands == 3);
+   talsh::Tensor * talsh_tens[3];
+   for(unsigned int i = 0; i < num_operands; ++i){
+    auto iter = tensors_.find(op.getTensorOperand(i)->getTensorHash());
+    if(iter != tensors_.end() && iter->second.talsh_tensor){
+     iter->second.resetTensorShapeToReduced();
+     talsh_tens[i] = iter->second.talsh_tensor.get(); assert(talsh_tens[i] != nullptr);
+    }else{
+     return prefetching;
+    }
+   }
+   int dev_kind;
+   int opt_exec_device = selectExecutionDevice({talsh_tens[0],talsh_tens[1],talsh_tens[2]},
+    op.getFlopEstimate() * tensorElementTypeOpFactor(op.getTensorOperand(1)->getElementType()));
+   if(opt_exec_device == DEV_DEFAULT)
+    opt_exec_device = talsh::determineOptimalDevice(*(talsh_tens[0]),*(talsh_tens[1]),*(talsh_tens[2]));
+   int dev_id = talshKindDevId(opt_exec_device,&dev_kind);
+   //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): PREFETCH: TAL-SH tensors: "
+   //          << talsh_tens[0] << " " << talsh_tens[1] << " " << talsh_tens[2] << std::endl << std::flush; //debug
+   if(dev_kind != DEV_HOST){
+    for(unsigned int i = 0; i < num_operands; ++i){
+     bool in_use = tensorIsCurrentlyInUse(talsh_tens[i]) || tensorIsPinned(op.getTensorOperand(i)->getTensorHash());
+     if(!in_use){
+      auto task_res = prefetches_.emplace(std::make_pair(op.getTensorOperand(i)->getTensorHash(),
+                                          acquireTask()));
+      if(task_res.second){
+       bool prefetch_started = talsh_tens[i]->sync(task_res.first->second.get(),dev_kind,dev_id);
+       if(!prefetch_started){
+        task_res.first->second->clean();
+        prefetches_.erase(task_res.first);
+       }
+       prefetching = prefetching || prefetch_started;
+      }else{
+       std::cout << "#ERROR(exatn::runtime::node_executor_talsh): PREFETCH: Repeated prefetch corruption for tensor operand "
+                 << i << " in tensor operation:" << std::endl; //broken association between exatn::TensorHash and talsh::Tensor
+       op.printIt();
+       assert(false);
+      }
+     }
+    }
+   }
+  }
+ }
+ return prefetching;
+}
+
+
+void TalshNodeExecutor::clearCache()
+{
+ bool evicted = evictMovedTensors();
+ for(auto & task: evictions_){
+  bool snc = task.second->wait(); assert(snc);
+  recycleTask(task.second);
+ }
+ evictions_.clear();
+ retainResidentImages();
+ return;
+}
+
+
+void TalshNodeExecutor::resetLookahead(const std::vector<numerics::TensorHashType> & upcoming)
+{
+ //Bring spilled tensors entering the lookahead window back to Host:
+ if(!spilled_.empty()){
+  for(const auto & tensor_hash: upcoming) restoreSpilledTensor(tensor_hash,false,false);
+ }
+ next_use_.clear();
+ const auto num_upcoming = upcoming.size();
+ for(std::size_t pos = 0; pos < num_upcoming; ++pos){
+  auto iter = tensors_.find(upcoming[pos]);
+  if(iter != tensors_.end() && iter->second.talsh_tensor)
+   next_use_.emplace(std::make_pair(iter->second.talsh_tensor.get(),pos)); //keeps the first use
+ }
+ return;
+}
+
+
+std::shared_ptr<talsh::Tensor> TalshNodeExecutor::getLocalTensor(const numerics::Tensor & tensor,
+                                  const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec)
+{
+ const auto tensor_rank = slice_spec.size();
+ std::vector<std::size_t> signature(tensor_rank);
+ std::vector<int> offsets(tensor_rank);
+ std::vector<int> dims(tensor_rank);
+ for(unsigned int i = 0; i < tensor_rank; ++i){
+  signature[i] = static_cast<std::size_t>(slice_spec[i].first);
+  offsets[i] = static_cast<int>(slice_spec[i].first);
+  dims[i] = static_cast<int>(slice_spec[i].second);
+ }
+ std::shared_ptr<talsh::Tensor> slice(nullptr);
+ switch(tensorComputeElementType(tensor.getElementType())){
+  case TensorElementType::REAL32:
+   slice = std::make_shared<talsh::Tensor>(signature,dims,static_cast<float>(0.0));
+   break;
+  case TensorElementType::REAL64:
+   slice = std::make_shared<talsh::Tensor>(signature,dims,static_cast<double>(0.0));
+   break;
+  case TensorElementType::COMPLEX32:
+   slice = std::make_shared<talsh::Tensor>(signature,dims,std::complex<float>(0.0));
+   break;
+  case TensorElementType::COMPLEX64:
+   slice = std::make_shared<talsh::Tensor>(signature,dims,std::complex<double>(0.0));
+   break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor::getLocalTensor): Invalid tensor element type!"
+             << std::endl << std::flush;
+   std::abort();
+ }
+ if(!(slice->isEmpty()) && !restoreSpilledTensor(tensor.getTensorHash(),true)) slice.reset();
+ if(slice && !(slice->isEmpty())) materializeCopies(tensor.getTensorHash(),false);
+ if(slice && !(slice->isEmpty())) materializeZeros(tensor.getTensorHash());
+ if(slice && !(slice->isEmpty())){
+  auto tens_pos = tensors_.find(tensor.getTensorHash());
+  if(tens_pos == tensors_.end()){
+   std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor::getLocalTensor): Tensor not found: " << std::endl;
+   tensor.printIt();
+   std::abort();
+  }
+  tens_pos->second.resetTensorShapeToFull();
+  auto & talsh_tensor = *(tens_pos->second.talsh_tensor);
+  auto error_code = talsh_tensor.extractSlice(nullptr,*slice,offsets);
+  assert(error_code == TALSH_SUCCESS);
+ }else{
+  slice.reset();
+  std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor::getLocalTensor): "
+            << "Unable to allocate a local slice for tensor " << tensor.getName()
+            << ":" << std::endl;
+  tensor.printIt();
+  std::cout << std::endl;
+ }
+ return slice;
+}
+
+
+TensorView TalshNodeExecutor::getTensorView(const numerics::Tensor & tensor)
+{
+ const auto tensor_hash = tensor.getTensorHash();
+ if(tensors_.find(tensor_hash) == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor::getTensorView): Tensor not found: " << std::endl;
+  tensor.printIt();
+  std::abort();
+ }
+ //Bring the spilled tensor back to Host:
+ if(!restoreSpilledTensor(tensor_hash,true)) return TensorView();
+ materializeCopies(tensor_hash,false);
+ materializeCopies(tensor_hash,true); //the tensor view is writable
+ detachSliceViews(tensor_hash);
+ materializeZeros(tensor_hash);
+ //Complete an active prefetch of the tensor (the tensor will be synced to Host):
+ auto prefetch = prefetches_.find(tensor_hash);
+ if(prefetch != prefetches_.end()){
+  bool snc = prefetch->second->wait();
+  if(snc){
+   cacheMovedTensors(*(prefetch->second));
+   recycleTask(prefetch->second);
+   prefetches_.erase(prefetch);
+  }
+ }
+ std::size_t size = 0;
+ const void * data = getTensorImage(tensor,DEV_HOST,0,&size); //syncs the tensor body image to Host
+ if(data == nullptr) return TensorView();
+ //External bodies may have been updated by another process: Drop the cached permuted copies:
+ if(external_.find(tensors_.find(tensor_hash)->second.talsh_tensor.get()) != external_.end()) invalidateLayouts(&tensor_hash);
+ //Pin the tensor:
+ auto pinned = pinned_;
+ {
+  std::lock_guard<std::mutex> lock(pinned->mtx);
+  auto res = pinned->pins.emplace(std::make_pair(tensor_hash,0U));
+  if(res.second) ++(pinned->num_pinned);
+  ++(res.first->second);
+ }
+ std::shared_ptr<void> pin(nullptr,[pinned,tensor_hash](void *){ //unpins the tensor once the last view copy is gone
+  std::lock_guard<std::mutex> lock(pinned->mtx);
+  auto iter = pinned->pins.find(tensor_hash);
+  if(iter != pinned->pins.end()){
+   if(--(iter->second) == 0){
+    pinned->pins.erase(iter);
+    --(pinned->num_pinned);
+   }
+  }
+ });
+ const auto tensor_rank = tensor.getRank();
+ std::vector<DimExtent> extents(tensor_rank);
+ for(unsigned int i = 0; i < tensor_rank; ++i) extents[i] = tensor.getDimExtent(i);
+ return TensorView(data,size,tensor.getElementType(),extents,pin);
+}
+
+
+bool TalshNodeExecutor::tensorIsPinned(numerics::TensorHashType tensor_hash) const
+{
+ if(pinned_->num_pinned.load() == 0) return false;
+ std::lock_guard<std::mutex> lock(pinned_->mtx);
+ return (pinned_->pins.find(tensor_hash) != pinned_->pins.end());
+}
+
+
+bool TalshNodeExecutor::tensorOperandsPinned(const numerics::TensorOperation & op) const
+{
+ if(pinned_->num_pinned.load() == 0) return false; //fast path: no pinned tensors
+ const auto num_operands = op.getNumOperandsSet();
+ for(unsigned int i = 0; i < num_operands; ++i){
+  if(tensorIsPinned(op.getTensorOperandHash(i))) return true;
+ }
+ return false;
+}
+
+
+void * TalshNodeExecutor::getTensorImage(const numerics::Tensor & tensor,
+                                         int device_kind, int device_id,
+                                         std::size_t * size) const
+{
+ const auto tensor_hash = tensor.getTensorHash();
+ auto tens_pos = tensors_.find(tensor_hash);
+ if(tens_pos == tensors_.end()){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): getTensorImage: Tensor not found:\n";
+  tensor.printIt();
+  assert(false);
+ }
+ //tens_pos->second.resetTensorShapeToReduced();
+ auto & tens = *(tens_pos->second.talsh_tensor);
+
+ if(device_kind != DEV_HOST){ //only an already resident accelerator image (no transfer)
+  if(external_.find(&tens) != external_.end()) return nullptr;
+  auto * talsh_tens = tens.getTalshTensorPtr();
+  const int device = talshFlatDevId(device_kind,device_id);
+  int ncopies = 0, copies[DEV_MAX], data_kinds[DEV_MAX];
+  auto errc = talshTensorPresence(talsh_tens,&ncopies,copies,data_kinds);
+  if(errc != TALSH_SUCCESS) return nullptr;
+  for(int i = 0; i < ncopies; ++i){
+   if(copies[i] == device && data_kinds[i] == tens.getElementType()){
+    void * body = nullptr;
+    errc = talshTensorGetBodyAccess(talsh_tens,&body,data_kinds[i],copies[i]);
+    if(errc != TALSH_SUCCESS) return nullptr;
+    if(size != nullptr) *size = tens.getSize();
+    return body;
+   }
+  }
+  return nullptr;
+ }
+ assert(device_id == 0);
+ auto synced = tens.sync(device_kind,device_id,nullptr,true); assert(synced);
+ void * tens_body = nullptr;
+ float * tens_body_r4 = nullptr;
+ double * tens_body_r8 = nullptr;
+ std::complex<float> * tens_body_c4 = nullptr;
+ std::complex<double> * tens_body_c8 = nullptr;
+ bool access_granted = false;
+ const int tens_elem_type = tens.getElementType();
+ switch(tens_elem_type){
+  case(talsh::REAL32):
+   access_granted = tens.getDataAccessHost(&tens_body_r4);
+   if(access_granted) tens_body = static_cast<void*>(tens_body_r4);
+   break;
+  case(talsh::REAL64):
+   access_granted = tens.getDataAccessHost(&tens_body_r8);
+   if(access_granted) tens_body = static_cast<void*>(tens_body_r8);
+   break;
+  case(talsh::COMPLEX32):
+   access_granted = tens.getDataAccessHost(&tens_body_c4);
+   if(access_granted) tens_body = static_cast<void*>(tens_body_c4);
+   break;
+  case(talsh::COMPLEX64):
+   access_granted = tens.getDataAccessHost(&tens_body_c8);
+   if(access_granted) tens_body = static_cast<void*>(tens_body_c8);
+   break;
+  default:
+   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): getTensorImage: Unknown TAL-SH data kind: "
+             << tens_elem_type << std::endl;
+   tens.print();
+   assert(false);
+ }
+ if(size != nullptr){
+  *size = tens.getSize();
+  assert(*size > 0);
+ }
+ return tens_body;
+}
+
+
+bool TalshNodeExecutor::finishPrefetching(const numerics::TensorOperation & op)
+{
+ bool synced = true;
+ //Bring spilled tensor operands back to Host:
+ if(!spilled_.empty()){
+  completeSpills(false);
+  if(op.getOpcode() != TensorOpCode::DESTROY){
+   const auto num_operands = op.getNumOperandsSet();
+   for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
+    if(!restoreSpilledTensor(op.getTensorOperandHash(oprnd),true)) return false;
+   }
+  }
+ }
+ //Test completion of active evictions:
+ auto eviction = evictions_.begin();
+ while(eviction != evictions_.end()){
+  int sts;
+  bool snc = eviction->second->test(&sts);
+  if(snc){
+   recycleTask(eviction->second);
+   eviction = evictions_.erase(eviction);
+  }else{
+   ++eviction;
+  }
+ }
+ //Test completion of active prefetches:
+ auto prefetch = prefetches_.begin();
+ while(prefetch != prefetches_.end()){
+  int sts;
+  bool snc = prefetch->second->test(&sts);
+  if(snc){
+   cacheMovedTensors(*(prefetch->second));
+   recycleTask(prefetch->second);
+   prefetch = prefetches_.erase(prefetch);
+  }else{
+   ++prefetch;
+  }
+ }
+ //Finish tensor operand prefetching for the given tensor operation:
+ const auto num_operands = op.getNumOperands();
+ for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
+  const auto tens_hash = op.getTensorOperand(oprnd)->getTensorHash();
+  auto iter = prefetches_.find(tens_hash);
+  if(iter != prefetches_.end()){
+   bool snc = iter->second->wait();
+   if(snc){
+    cacheMovedTensors(*(iter->second));
+    recycleTask(iter->second);
+    prefetches_.erase(iter);
+   }
+   synced = synced && snc;
+  }
+ }
+ return synced;
+}
+
+
+void TalshNodeExecutor::cacheMovedTensors(talsh::TensorTask & talsh_task)
+{
+ if(!(talsh_task.isEmpty())){
+  int dev_kind;
+  int dev_id = talsh_task.getExecutionDevice(&dev_kind);
+  if(dev_kind != DEV_HOST){
+   const int device = talshFlatDevId(dev_kind,dev_id);
+   const auto num_operands = talsh_task.getNumTensorArguments();
+   const auto coherence = talsh_task.getTensorArgumentCoherence();
+   if(coherence >= 0){
+    for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
+     unsigned int arg_coherence = argument_coherence_get_value(coherence,num_operands,oprnd);
+     if(arg_coherence == COPY_M || arg_coherence == COPY_K){ //move or copy of tensor body image
+      auto * talsh_tens = const_cast<talsh::Tensor*>(talsh_task.getTensorArgument(oprnd));
+      if(external_.find(talsh_tens) != external_.end()){ //external bodies stay authoritative on Host
+       auto synced = talsh_tens->sync(DEV_HOST,0,nullptr,true); assert(synced);
+       continue;
+      }
+      auto res = accel_cache_[device].emplace(std::make_pair(talsh_tens,CachedAttr{exatn::Timer::timeInSecHR()}));
+      if(res.second){ //tensor body image has been transferred to the device
+       int data_kind_size;
+       if(talshValidDataKind(talsh_tens->getElementType(),&data_kind_size) == YEP)
+        talsh_h2d_bytes_.fetch_add(talsh_tens->getVolume() * data_kind_size,std::memory_order_relaxed);
+      }
+      //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CACHE: Device " << device
+      //          << " cached " << res.first->first << std::endl << std::flush; //debug
+     }
+    }
+   }
+  }
+ }
+ return;
+}
+
+
+bool TalshNodeExecutor::evictMovedTensors(int device_id, std::size_t required_space)
+{
+ //Disable further prefetching:
+ prefetch_enabled_ = false;
+ //Initiate new tensor evictions:
+ bool evicting = false, single_device = false;
+ int dev_begin = 0, dev_end = (DEV_MAX - 1);
+ if(device_id != DEV_DEFAULT){
+  assert(device_id >= 0 && device_id < DEV_MAX);
+  dev_begin = device_id; dev_end = device_id;
+  single_device = true;
+ }
+ std::size_t freed_bytes = 0;
+ bool still_freeing = true;
+ while(still_freeing){
+  bool cache_empty = true;
+  for(int dev = dev_begin; dev <= dev_end; ++dev){
+   //Choose the idle cached tensor image needed the latest (least recently used among equals):
+   auto victim = accel_cache_[dev].end();
+   std::size_t victim_next_use = 0;
+   for(auto iter = accel_cache_[dev].begin(); iter != accel_cache_[dev].end(); ++iter){
+    if(!tensorIsCurrentlyInUse(iter->first)){
+     auto next_use = next_use_.find(iter->first);
+     const std::size_t tens_next_use = (next_use != next_use_.end()) ? next_use->second
+                                       : std::numeric_limits<std::size_t>::max();
+     if(victim == accel_cache_[dev].end() || tens_next_use > victim_next_use ||
+        (tens_next_use == victim_next_use && iter->second.last_used < victim->second.last_used)){
+      victim = iter;
+      victim_next_use = tens_next_use;
+     }
+    }
+   }
+   if(victim != accel_cache_[dev].end()){
+    cache_empty = false;
+    int data_kind_size;
+    auto valid = talshValidDataKind(victim->first->getElementType(),&data_kind_size);
+    assert(valid == YEP);
+    std::size_t talsh_tens_size = victim->first->getVolume() * data_kind_size;
+    auto task_res = evictions_.emplace(std::make_pair(victim->first,
+                                                      acquireTask()));
+    if(task_res.second){
+     //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CACHE: Device " << dev
+     //          << " evicting " << victim->first << std::endl << std::flush; //debug
+     bool synced = victim->first->sync(task_res.first->second.get(),DEV_HOST,0,nullptr,!single_device); //initiate a move of the tensor body image back to Host
+     freed_bytes += talsh_tens_size;
+     talsh_d2h_bytes_.fetch_add(talsh_tens_size,std::memory_order_relaxed);
+     evicting = true;
+    }
+    accel_cache_[dev].erase(victim);
+   }
+   still_freeing = ((!cache_empty) || (dev < dev_end)) && ((required_space == 0) || (freed_bytes < required_space));
+   if(!still_freeing) break;
+  }
+ }
+ //Check the completion of previously initiated tensor evictions:
+ auto eviction = evictions_.begin();
+ while(eviction != evictions_.end()){
+  int sts;
+  bool snc = eviction->second->test(&sts);
+  if(snc){
+   recycleTask(eviction->second);
+   eviction = evictions_.erase(eviction);
+  }else{
+   ++eviction;
+  }
+ }
+ return evicting;
+}
+
+
+std::vector<int> TalshNodeExecutor::bindNodeLocalGPUs(int num_gpus,
+                                                      int node_process_rank,
+                                                      int node_num_processes)
+{
+ std::vector<int> gpus;
+ if(num_gpus > 0 && node_num_processes > 0){
+  assert(node_process_rank >= 0 && node_process_rank < node_num_processes);
+  const long long first = static_cast<long long>(node_process_rank) * num_gpus / node_num_processes;
+  const long long last = std::max(first + 1,static_cast<long long>(node_process_rank + 1) * num_gpus / node_num_processes);
+  for(long long gpu = first; gpu < last; ++gpu) gpus.emplace_back(static_cast<int>(gpu));
+ }
+ return gpus;
+}
+
+
+int TalshNodeExecutor::selectExecutionDevice(const std::vector<const talsh::Tensor*> & operands,
+                                             double flops) const
+{
+ int best_device = DEV_DEFAULT;
+ if(placement_cost_model_){
+  if(talsh_gpus_.size() > 1){
+   double best_cost = 0.0;
+   bool best_fits = false;
+   for(const auto gpu: talsh_gpus_){
+    const int device = talshFlatDevId(DEV_NVIDIA_GPU,gpu);
+    if(device < 0 || device >= DEV_MAX) continue;
+    //Bytes to transfer given the current device cache residency:
+    std::size_t transfer_bytes = 0;
+    for(const auto * talsh_tens: operands){
+     if(accel_cache_[device].find(const_cast<talsh::Tensor*>(talsh_tens)) == accel_cache_[device].end()){
+      int data_kind_size;
+      if(talshValidDataKind(talsh_tens->getElementType(),&data_kind_size) == YEP)
+       transfer_bytes += talsh_tens->getVolume() * data_kind_size;
+     }
+    }
+    //Estimated completion time, including the work already queued on the device:
+    const bool fits = (talshDeviceBufferFreeSize(gpu,DEV_NVIDIA_GPU) >= transfer_bytes);
+    const double cost = static_cast<double>(transfer_bytes) / PLACEMENT_TRANSFER_BANDWIDTH
+                      + (device_queued_flops_[device].load(std::memory_order_relaxed) + flops) / PLACEMENT_DEVICE_FLOPS;
+    if(best_device == DEV_DEFAULT || (fits && !best_fits) || (fits == best_fits && cost < best_cost)){
+     best_device = device;
+     best_cost = cost;
+     best_fits = fits;
+    }
+   }
+  }
+ }
+ return best_device;
+}
+
+
+bool TalshNodeExecutor::isSmallContraction(const std::vector<const talsh::Tensor*> & operands,
+                                           double flops) const
+{
+ if(small_contraction_flops_ <= 0.0 || flops > small_contraction_flops_) return false;
+ for(const auto * talsh_tens: operands){
+  for(int dev = 0; dev < DEV_MAX; ++dev){ //tensor operands resident on an accelerator stay there
+   if(accel_cache_[dev].find(const_cast<talsh::Tensor*>(talsh_tens)) != accel_cache_[dev].end()) return false;
+  }
+ }
+ return true;
+}
+
+
+std::string TalshNodeExecutor::contractionTuningKey(const numerics::TensorOpContract & op,
+                                                    const talsh::Tensor & dest,
+                                                    const talsh::Tensor & left,
+                                                    const talsh::Tensor & right) const
+{
+ std::string key = op.getIndexPatternReduced();
+ const talsh::Tensor * operands[] = {&dest,&left,&right};
+ for(const auto * talsh_tens: operands){
+  unsigned int rank = 0;
+  const int * extents = talsh_tens->getDimExtents(rank);
+  key += "|";
+  for(unsigned int i = 0; i < rank; ++i){
+   if(i > 0) key += ",";
+   key += std::to_string(extents[i]);
+  }
+ }
+ key += "|" + std::to_string(dest.getElementType()) + "|" + std::to_string(talsh_gpus_.size());
+ return key;
+}
+
+
+std::size_t TalshNodeExecutor::contractionSignature(const numerics::TensorOpContract & op,
+                                                   const talsh::Tensor & dest,
+                                                   const talsh::Tensor & left,
+                                                   const talsh::Tensor & right) const
+{
+ std::size_t signature = std::hash<std::string>{}(op.getIndexPatternReduced());
+ auto combine = [&signature](std::size_t value){
+  signature ^= value + 0x9e3779b97f4a7c15ULL + (signature << 6) + (signature >> 2);
+ };
+ const talsh::Tensor * operands[] = {&dest,&left,&right};
+ for(const auto * talsh_tens: operands){
+  unsigned int rank = 0;
+  const int * extents = talsh_tens->getDimExtents(rank);
+  combine(rank);
+  for(unsigned int i = 0; i < rank; ++i) combine(static_cast<std::size_t>(extents[i]));
+ }
+ combine(static_cast<std::size_t>(dest.getElementType()));
+ combine(static_cast<std::size_t>(op.getExecutionDevice()));
+ return signature;
+}
+
+
+std::vector<int> TalshNodeExecutor::contractionStrategies(double flops) const
+{
+ std::vector<int> strategies;
+ if(small_kernel_flops_ > 0.0 && flops <= small_kernel_flops_) strategies.emplace_back(CONTRACT_HOST_DIRECT);
+ strategies.emplace_back(CONTRACT_HOST_TTGT);
+ if(layout_cache_limit_ > 0) strategies.emplace_back(CONTRACT_HOST_LAYOUT);
+ if(!talsh_gpus_.empty()) strategies.emplace_back(CONTRACT_ACCELERATOR);
+ if(direct_contraction_ != DIRECT_CONTRACTION_OFF) strategies.emplace_back(CONTRACT_HOST_PACKED);
+ return strategies;
+}
+
+
+void TalshNodeExecutor::finishTuningTrial(TensorOpExecHandle op_handle, bool success)
+{
+ auto iter = tuning_trials_.find(op_handle);
+ if(iter != tuning_trials_.end()){
+  if(success){
+   autotuner_.record(iter->second.key,iter->second.strategy,exatn::Timer::timeInSecHR(iter->second.start));
+  }else{
+   autotuner_.cancel(iter->second.key,iter->second.strategy);
+  }
+  tuning_trials_.erase(iter);
+ }
+ return;
+}
+
+
+void TalshNodeExecutor::registerPlacement(TensorOpExecHandle op_handle, int device, double flops)
+{
+ auto res = placements_.emplace(std::make_pair(op_handle,std::make_pair(device,flops)));
+ if(res.second){
+  auto & queued_flops = device_queued_flops_[device];
+  queued_flops.store(queued_flops.load(std::memory_order_relaxed) + flops,std::memory_order_relaxed);
+ }
+ return;
+}
+
+
+void TalshNodeExecutor::releasePlacement(TensorOpExecHandle op_handle)
+{
+ auto iter = placements_.find(op_handle);
+ if(iter != placements_.end()){
+  auto & queued_flops = device_queued_flops_[iter->second.first];
+  const double remaining = queued_flops.load(std::memory_order_relaxed) - iter->second.second;
+  queued_flops.store((remaining > 0.0) ? remaining : 0.0,std::memory_order_relaxed);
+  placements_.erase(iter);
+ }
+ return;
+}
+
+
+bool TalshNodeExecutor::executeSmallContraction(const numerics::TensorOpContract & op,
+                                                talsh::Tensor & dest,
+                                                talsh::Tensor & left,
+                                                talsh::Tensor & right,
+                                                double flops)
+{
+ if(small_kernel_flops_ <= 0.0 || flops > small_kernel_flops_ || dry_run_.load()) return false;
+ const auto dest_hash = op.getTensorOperandHash(0);
+ if(op.getTensorOperandHash(1) == dest_hash || op.getTensorOperandHash(2) == dest_hash) return false; //in-place tensor contraction
+ const auto pattern = op.getIndexPatternReduced();
+ auto iter = small_patterns_.find(pattern);
+ if(iter == small_patterns_.end()){
+  SmallContractionPattern positions{};
+  const bool supported = parse_small_contraction(pattern,positions);
+  iter = small_patterns_.emplace(std::make_pair(pattern,std::make_pair(supported,positions))).first;
+ }
+ if(!(iter->second.first)) return false;
+ const int data_kind = dest.getElementType();
+ if(left.getElementType() != data_kind || right.getElementType() != data_kind) return false;
+ const void * left_body = host_body(left);
+ const void * right_body = host_body(right);
+ if(left_body == nullptr || right_body == nullptr) return false; //input tensors are not on Host
+ const auto * loops = getSmallContractionPlan(pattern,iter->second.second,dest,left,right);
+ if(loops == nullptr) return false;
+ auto synced = dest.sync(DEV_HOST,0,nullptr,true); //the destination tensor body is only kept on Host
+ if(!synced) return false;
+ void * dest_body = host_body(dest); assert(dest_body != nullptr);
+ const bool zero_output = (known_zero_.find(dest_hash) != known_zero_.end());
+ const bool accumulative = op.isAccumulative() && !zero_output; //known-zero destination tensor is overwritten
+ const auto alpha = op.getScalar(0);
+ const bool conj_left = iter->second.second.conj[0];
+ const bool conj_right = iter->second.second.conj[1];
+ bool done = false;
+ switch(data_kind){
+ case talsh::REAL32:
+  done = small_contraction(*loops,static_cast<float*>(dest_body),static_cast<const float*>(left_body),
+                           static_cast<const float*>(right_body),static_cast<float>(alpha.real()),accumulative);
+  break;
+ case talsh::REAL64:
+  done = small_contraction(*loops,static_cast<double*>(dest_body),static_cast<const double*>(left_body),
+                           static_cast<const double*>(right_body),alpha.real(),accumulative);
+  break;
+ case talsh::COMPLEX32:
+  done = small_contraction(*loops,static_cast<std::complex<float>*>(dest_body),
+                           static_cast<const std::complex<float>*>(left_body),
+                           static_cast<const std::complex<float>*>(right_body),
+                           std::complex<float>(alpha),accumulative,conj_left,conj_right);
+  break;
+ case talsh::COMPLEX64:
+  done = small_contraction(*loops,static_cast<std::complex<double>*>(dest_body),
+                           static_cast<const std::complex<double>*>(left_body),
+                           static_cast<const std::complex<double>*>(right_body),
+                           alpha,accumulative,conj_left,conj_right);
+  break;
+ default:
+  return false;
+ }
+ if(done){
+  if(zero_output) known_zero_.erase(dest_hash);
+  double flop_count = talsh_submitted_flops_.load() + flops;
+  talsh_submitted_flops_.store(flop_count);
+ }
+ return done;
+}
+
+
+bool TalshNodeExecutor::executeDirectContraction(const numerics::TensorOpContract & op,
+                                                 talsh::Tensor & dest,
+                                                 talsh::Tensor & left,
+                                                 talsh::Tensor & right,
+                                                 double flops,
+                                                 bool forced)
+{
+ if(dry_run_.load()) return false;
+ if(!forced && direct_contraction_ == DIRECT_CONTRACTION_OFF) return false;
+ if(!forced && direct_contraction_ == DIRECT_CONTRACTION_BANDWIDTH_BOUND){
+  const double volume = static_cast<double>(dest.getVolume() + left.getVolume() + right.getVolume());
+  if(flops > DIRECT_CONTRACTION_INTENSITY * volume) return false; //compute-bound: TTGT
+ }
+ const auto dest_hash = op.getTensorOperandHash(0);
+ if(op.getTensorOperandHash(1) == dest_hash || op.getTensorOperandHash(2) == dest_hash) return false; //in-place tensor contraction
+ const auto pattern = op.getIndexPatternReduced();
+ auto iter = direct_patterns_.find(pattern);
+ if(iter == direct_patterns_.end()){
+  DirectContractionPattern positions{};
+  const bool supported = parse_direct_contraction(pattern,positions);
+  iter = direct_patterns_.emplace(std::make_pair(pattern,std::make_pair(supported,positions))).first;
+ }
+ if(!(iter->second.first)) return false;
+ const int data_kind = dest.getElementType();
+ if(left.getElementType() != data_kind || right.getElementType() != data_kind) return false;
+ const void * left_body = host_body(left);
+ const void * right_body = host_body(right);
+ if(left_body == nullptr || right_body == nullptr) return false; //input tensors are not on Host
+ const auto * plan = getDirectContractionPlan(pattern,iter->second.second,dest,left,right);
+ if(plan == nullptr) return false;
+ auto synced = dest.sync(DEV_HOST,0,nullptr,true); //the destination tensor body is only kept on Host
+ if(!synced) return false;
+ void * dest_body = host_body(dest); assert(dest_body != nullptr);
+ const bool zero_output = (known_zero_.find(dest_hash) != known_zero_.end());
+ const bool accumulative = op.isAccumulative() && !zero_output; //known-zero destination tensor is overwritten
+ const auto alpha = op.getScalar(0);
+ const bool conj_left = iter->second.second.conj[0];
+ const bool conj_right = iter->second.second.conj[1];
+ switch(data_kind){
+ case talsh::REAL32:
+  direct_contraction(*plan,static_cast<float*>(dest_body),static_cast<const float*>(left_body),
+                     static_cast<const float*>(right_body),static_cast<float>(alpha.real()),accumulative);
+  break;
+ case talsh::REAL64:
+  direct_contraction(*plan,static_cast<double*>(dest_body),static_cast<const double*>(left_body),
+                     static_cast<const double*>(right_body),alpha.real(),accumulative);
+  break;
+ case talsh::COMPLEX32:
+  direct_contraction(*plan,static_cast<std::complex<float>*>(dest_body),
+                     static_cast<const std::complex<float>*>(left_body),
+                     static_cast<const std::complex<float>*>(right_body),
+                     std::complex<float>(alpha),accumulative,conj_left,conj_right);
+  break;
+ case talsh::COMPLEX64:
+  direct_contraction(*plan,static_cast<std::complex<double>*>(dest_body),
+                     static_cast<const std::complex<double>*>(left_body),
+                     static_cast<const std::complex<double>*>(right_body),
+                     alpha,accumulative,conj_left,conj_right);
+  break;
+ default:
+  return false;
+ }
+ if(zero_output) known_zero_.erase(dest_hash);
+ double flop_count = talsh_submitted_flops_.load() + flops;
+ talsh_submitted_flops_.store(flop_count);
+ return true;
+}
+
+
+/** Returns the key of a tensor contraction pattern applied to given tensor shapes. **/
+static std::string contractionShapeKey(const std::string & pattern,
+                                       const talsh::Tensor & dest,
+                                       const talsh::Tensor & left,
+                                       const talsh::Tensor & right)
+{
+ std::string key = pattern;
+ for(const auto * tensor: {&dest,&left,&right}){
+  unsigned int rank = 0;
+  const int * extents = tensor->getDimExtents(rank);
+  key += "|";
+  for(unsigned int i = 0; i < rank; ++i) key += std::to_string(extents[i]) + ",";
+ }
+ return key;
+}
+
+
+const SmallContractionLoops * TalshNodeExecutor::getSmallContractionPlan(const std::string & pattern,
+                                                                         const SmallContractionPattern & positions,
+                                                                         const talsh::Tensor & dest,
+                                                                         const talsh::Tensor & left,
+                                                                         const talsh::Tensor & right)
+{
+ auto key = contractionShapeKey(pattern,dest,left,right);
+ auto iter = small_plans_.find(key);
+ if(iter == small_plans_.end()){
+  unsigned int ranks[3];
+  const int * extents[3] = {dest.getDimExtents(ranks[0]),left.getDimExtents(ranks[1]),right.getDimExtents(ranks[2])};
+  SmallContractionLoops loops;
+  const bool applicable = setup_small_contraction(positions,ranks,extents,loops);
+  if(small_plans_.size() >= CONTRACTION_PLAN_CACHE_SIZE) small_plans_.clear();
+  iter = small_plans_.emplace(std::make_pair(std::move(key),std::make_pair(applicable,loops))).first;
+ }
+ return (iter->second.first ? &(iter->second.second) : nullptr);
+}
+
+
+const DirectContractionPlan * TalshNodeExecutor::getDirectContractionPlan(const std::string & pattern,
+                                                                          const DirectContractionPattern & positions,
+                                                                          const talsh::Tensor & dest,
+                                                                          const talsh::Tensor & left,
+                                                                          const talsh::Tensor & right)
+{
+ auto key = contractionShapeKey(pattern,dest,left,right);
+ auto iter = direct_plans_.find(key);
+ if(iter == direct_plans_.end()){
+  unsigned int ranks[3];
+  const int * extents[3] = {dest.getDimExtents(ranks[0]),left.getDimExtents(ranks[1]),right.getDimExtents(ranks[2])};
+  DirectContractionPlan plan;
+  const bool applicable = setup_direct_contraction(positions,ranks,extents,plan);
+  if(direct_plans_.size() >= CONTRACTION_PLAN_CACHE_SIZE) direct_plans_.clear();
+  iter = direct_plans_.emplace(std::make_pair(std::move(key),std::make_pair(applicable,std::move(plan)))).first;
+ }
+ return (iter->second.first ? &(iter->second.second) : nullptr);
+}
+
+
+const TensorTransposePlan * TalshNodeExecutor::getTransposePlan(const std::string & pattern,
+                                                                const talsh::Tensor & src,
+                                                                bool * conj)
+{
+ auto iter = transpose_patterns_.find(pattern);
+ if(iter == transpose_patterns_.end()){
+  TensorTransposePattern transpose{};
+  const bool supported = parse_tensor_transpose(pattern,transpose);
+  iter = transpose_patterns_.emplace(std::make_pair(pattern,std::make_pair(supported,transpose))).first;
+ }
+ if(!(iter->second.first)) return nullptr;
+ *conj = iter->second.second.conj;
+ unsigned int rank = 0;
+ const int * extents = src.getDimExtents(rank);
+ std::string key = pattern + "|";
+ for(unsigned int i = 0; i < rank; ++i) key += std::to_string(extents[i]) + ",";
+ auto plan_iter = transpose_plans_.find(key);
+ if(plan_iter == transpose_plans_.end()){
+  TensorTransposePlan plan;
+  if(!setup_tensor_transpose(iter->second.second,rank,extents,plan)) return nullptr;
+  if(transpose_plans_.size() >= TRANSPOSE_PLAN_CACHE_SIZE) transpose_plans_.clear();
+  plan_iter = transpose_plans_.emplace(std::make_pair(key,std::move(plan))).first;
+ }
+ return &(plan_iter->second);
+}
+
+
+bool TalshNodeExecutor::executeHostTranspose(const numerics::TensorOpAdd & op,
+                                             talsh::Tensor & dest,
+                                             talsh::Tensor & src)
+{
+ if(!host_transpose_ || dry_run_.load()) return false;
+ const auto dest_hash = op.getTensorOperandHash(0);
+ if(op.getTensorOperandHash(1) == dest_hash) return false; //in-place tensor addition
+ const int data_kind = dest.getElementType();
+ if(src.getElementType() != data_kind) return false;
+ const void * src_body = host_body(src);
+ if(src_body == nullptr || host_body(dest) == nullptr) return false; //tensor bodies are not on Host
+ if(dest.getVolume() != src.getVolume()) return false;
+ bool conj = false;
+ const auto * plan = getTransposePlan(op.getIndexPatternReduced(),src,&conj);
+ if(plan == nullptr) return false;
+ auto synced = dest.sync(DEV_HOST,0,nullptr,true); //the destination tensor body is only kept on Host
+ if(!synced) return false;
+ void * dest_body = host_body(dest); assert(dest_body != nullptr);
+ const bool zero_output = (known_zero_.find(dest_hash) != known_zero_.end()); //known-zero destination tensor is overwritten
+ if(!transpose_host_body(*plan,data_kind,dest_body,src_body,op.getScalar(0),!zero_output,conj)) return false;
+ if(zero_output) known_zero_.erase(dest_hash);
+ double flop_count = talsh_submitted_flops_.load() + op.getFlopEstimate() * tensorElementTypeOpFactor(op.getTensorOperand(1)->getElementType());
+ talsh_submitted_flops_.store(flop_count);
+ return true;
+}
+
+
+bool TalshNodeExecutor::gaussContraction(const numerics::TensorOpContract & op,
+                                         const talsh::Tensor & dest,
+                                         const talsh::Tensor & left,
+                                         const talsh::Tensor & right,
+                                         double flops) const
+{
+ if(gauss_contraction_flops_ <= 0.0 || flops < gauss_contraction_flops_ || dry_run_.load()) return false;
+ const int data_kind = dest.getElementType();
+ if(data_kind != talsh::COMPLEX32 && data_kind != talsh::COMPLEX64) return false;
+ switch(op.getPrecision()){
+ case TensorOpPrecision::FULL:
+  return false;
+ case TensorOpPrecision::AUTO:
+ {
+  //Error bound of the 3M complex tensor contraction: GAUSS_ERROR_FACTOR * K * u * ||L|| * ||R||, K = contracted volume:
+  double left_norm = 0.0, right_norm = 0.0;
+  if(!(host_norm2(left,&left_norm) && host_norm2(right,&right_norm))) return false; //norms are not available
+  const double dest_vol = static_cast<double>(dest.getVolume());
+  const double contr_vol = std::sqrt(static_cast<double>(left.getVolume()) * static_cast<double>(right.getVolume())
+                                     / ((dest_vol > 1.0) ? dest_vol : 1.0));
+  const double unit_roundoff = (data_kind == talsh::COMPLEX32) ? 0.5 * std::numeric_limits<float>::epsilon()
+                                                               : 0.5 * std::numeric_limits<double>::epsilon();
+  const double error_bound = GAUSS_ERROR_FACTOR * contr_vol * unit_roundoff * left_norm * right_norm;
+  return (error_bound <= op.getPrecisionTolerance());
+ }
+ default:
+  return true;
+ }
+}
+
+
+bool TalshNodeExecutor::executeGaussContraction(const numerics::TensorOpContract & op,
+                                                talsh::Tensor & dest,
+                                                talsh::Tensor & left,
+                                                talsh::Tensor & right,
+                                                double flops,
+                                                bool host)
+{
+ const int data_kind = dest.getElementType();
+ if(left.getElementType() != data_kind || right.getElementType() != data_kind) return false;
+ const auto dest_hash = op.getTensorOperandHash(0);
+ if(op.getTensorOperandHash(1) == dest_hash || op.getTensorOperandHash(2) == dest_hash) return false; //in-place tensor contraction
+ const void * left_body = host_body(left);
+ const void * right_body = host_body(right);
+ if(left_body == nullptr || right_body == nullptr) return false; //input tensors are not on Host
+ //Real tensor contraction pattern (complex conjugation is applied when splitting):
+ std::vector<std::string> tensors;
+ if(!parse_tensor_network(op.getIndexPatternReduced(),tensors) || tensors.size() != 3) return false;
+ bool conj[3] = {false,false,false};
+ for(unsigned int arg = 0; arg < 3; ++arg){
+  std::string tensor_name;
+  std::vector<IndexLabel> indices;
+  if(!parse_tensor(tensors[arg],tensor_name,indices,conj[arg])) return false;
+  tensors[arg] = assemble_symbolic_tensor(tensor_name,indices);
+ }
+ if(conj[0]) return false;
+ const auto pattern = assemble_symbolic_tensor_network(tensors);
+ //Temporary real tensors {real part, imaginary part, sum} for each tensor operand:
+ const int real_kind = (data_kind == talsh::COMPLEX32) ? talsh::REAL32 : talsh::REAL64;
+ const std::size_t real_size = (data_kind == talsh::COMPLEX32) ? sizeof(float) : sizeof(double);
+ const std::size_t temp_size = 3 * (dest.getVolume() + left.getVolume() + right.getVolume()) * real_size;
+ if(talshDeviceBufferFreeSize(0,DEV_HOST) < 2 * temp_size) return false; //spare Host buffer space only
+ talsh::Tensor * operands[3] = {&dest,&left,&right};
+ std::unique_ptr<talsh::Tensor> parts[3][3]; //[operand][real,imag,sum]
+ for(unsigned int arg = 0; arg < 3; ++arg){
+  unsigned int rank = 0;
+  const int * extents = operands[arg]->getDimExtents(rank);
+  for(unsigned int part = 0; part < 3; ++part){
+   parts[arg][part] = make_talsh_tensor(std::vector<std::size_t>(rank,0),std::vector<int>(extents,extents+rank),
+                                        real_kind,nullptr);
   }
- }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): BROADCAST: Unable to get access to the tensor body!" << std::endl;
-  op.printIt();
-  assert(false);
  }
-#endif
- return error_code;
+ auto split = [&](auto * real_type_ptr){ //splits the left and right tensors
+  using RealType = typename std::remove_pointer<decltype(real_type_ptr)>::type;
+  for(unsigned int arg = 1; arg < 3; ++arg){
+   const std::complex<RealType> * body = nullptr;
+   RealType * part_bodies[3] = {nullptr,nullptr,nullptr};
+   bool accessed = operands[arg]->getDataAccessHostConst(&body);
+   for(unsigned int part = 0; part < 3; ++part) accessed = accessed && parts[arg][part]->getDataAccessHost(&(part_bodies[part]));
+   if(!accessed) return false;
+   gauss_split(body,operands[arg]->getVolume(),conj[arg],part_bodies[0],part_bodies[1],part_bodies[2]);
+  }
+  return true;
+ };
+ const bool split_done = (real_kind == talsh::REAL32) ? split(static_cast<float*>(nullptr)) : split(static_cast<double*>(nullptr));
+ if(!split_done) return false;
+ //Three real tensor contractions: T1=A*C, T2=B*D, T3=(A+B)*(C+D):
+ switchFastMath(reducedPrecision(op,dest,left,right));
+ for(unsigned int part = 0; part < 3; ++part){
+  talsh::TensorTask task;
+  int error_code = parts[0][part]->contractAccumulate(&task,pattern,*(parts[1][part]),*(parts[2][part]),
+                                                      host ? DEV_HOST : DEV_DEFAULT,host ? 0 : DEV_DEFAULT,
+                                                      std::complex<double>(1.0,0.0),false);
+  if(error_code != TALSH_SUCCESS && !host){ //fall back to Host
+   task.clean();
+   error_code = parts[0][part]->contractAccumulate(&task,pattern,*(parts[1][part]),*(parts[2][part]),
+                                                   DEV_HOST,0,std::complex<double>(1.0,0.0),false);
+  }
+  if(error_code != TALSH_SUCCESS) return false;
+  if(!task.wait()) return false;
+  if(!parts[0][part]->sync(DEV_HOST,0,nullptr,true)) return false;
+ }
+ //Combine the real products into the destination tensor:
+ auto synced = dest.sync(DEV_HOST,0,nullptr,true); //the destination tensor body is only kept on Host
+ if(!synced) return false;
+ const bool zero_output = (known_zero_.find(dest_hash) != known_zero_.end());
+ const bool accumulative = op.isAccumulative() && !zero_output; //known-zero destination tensor is overwritten
+ const auto alpha = op.getScalar(0);
+ auto combine = [&](auto * real_type_ptr){
+  using RealType = typename std::remove_pointer<decltype(real_type_ptr)>::type;
+  std::complex<RealType> * body = nullptr;
+  RealType * products[3] = {nullptr,nullptr,nullptr};
+  bool accessed = dest.getDataAccessHost(&body);
+  for(unsigned int part = 0; part < 3; ++part) accessed = accessed && parts[0][part]->getDataAccessHost(&(products[part]));
+  if(!accessed) return false;
+  gauss_combine(body,dest.getVolume(),products[0],products[1],products[2],std::complex<RealType>(alpha),accumulative);
+  return true;
+ };
+ const bool combined = (real_kind == talsh::REAL32) ? combine(static_cast<float*>(nullptr)) : combine(static_cast<double*>(nullptr));
+ assert(combined);
+ if(zero_output) known_zero_.erase(dest_hash);
+ double flop_count = talsh_submitted_flops_.load() + flops;
+ talsh_submitted_flops_.store(flop_count);
+ return true;
 }
 
 
-int TalshNodeExecutor::execute(numerics::TensorOpAllreduce & op,
-                               TensorOpExecHandle * exec_handle)
+std::string TalshNodeExecutor::applyLayoutCache(const numerics::TensorOperation & op,
+                                                talsh::Tensor ** left,
+                                                talsh::Tensor ** right,
+                                                std::vector<std::shared_ptr<talsh::Tensor>> & used)
 {
- assert(op.isSet());
- if(!finishPrefetching(op)) return TRY_LATER;
+ auto pattern = op.getIndexPatternReduced();
+ if(layout_cache_limit_ == 0 || dry_run_.load()) return pattern;
+ std::vector<std::string> tensors;
+ std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
+ bool parsed = parse_tensor_contraction(pattern,tensors,left_inds,right_inds,contr_inds,hyper_inds);
+ if(!parsed || tensors.size() != 3 || !hyper_inds.empty()) return pattern;
+ //Target layout: Contracted dimensions (in the order of the left tensor), uncontracted dimensions (in the order of the destination tensor):
+ std::sort(contr_inds.begin(),contr_inds.end(),
+           [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[1] < b.arg_pos[1];});
+ std::sort(left_inds.begin(),left_inds.end(),
+           [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[0] < b.arg_pos[0];});
+ std::sort(right_inds.begin(),right_inds.end(),
+           [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[0] < b.arg_pos[0];});
+ bool rewritten = false;
+ talsh::Tensor ** operands[2] = {left,right};
+ for(unsigned int arg = 1; arg <= 2; ++arg){
+  const auto tensor_hash = op.getTensorOperandHash(arg);
+  if(tensor_hash == op.getTensorOperandHash(0)) continue; //in-place tensor contraction
+  if(op.operandIsDonated(arg)) continue; //last use: the permuted copy would never be reused
+  std::string tensor_name;
+  std::vector<IndexLabel> indices;
+  bool conj;
+  if(!parse_tensor(tensors[arg],tensor_name,indices,conj)) continue;
+  const auto & free_inds = (arg == 1) ? left_inds : right_inds;
+  if(indices.size() != contr_inds.size() + free_inds.size()) continue; //traces are not supported
+  std::vector<IndexLabel> target;
+  std::vector<int> permutation;
+  bool trivial = true;
+  const std::vector<PosIndexLabel> * index_groups[] = {&contr_inds,&free_inds};
+  for(const auto * inds: index_groups){
+   for(const auto & index: *inds){
+    if(index.arg_pos[arg] != static_cast<int>(permutation.size())) trivial = false;
+    permutation.emplace_back(index.arg_pos[arg]);
+    target.emplace_back(index.index_label);
+   }
+  }
+  if(trivial) continue; //the tensor already has the target layout
+  auto copy_pattern = assemble_symbolic_tensor("D",target) + "=" + assemble_symbolic_tensor("L",indices);
+  auto copy = getLayoutCopy(tensor_hash,**(operands[arg-1]),permutation,copy_pattern);
+  if(copy){
+   *(operands[arg-1]) = copy.get();
+   used.emplace_back(copy);
+   tensors[arg] = assemble_symbolic_tensor(tensor_name,target,conj);
+   rewritten = true;
+  }
+ }
+ if(rewritten) pattern = assemble_symbolic_tensor_network(tensors);
+ return pattern;
+}
 
- const auto & tensor = *(op.getTensorOperand(0));
- const auto tensor_hash = tensor.getTensorHash();
+
+std::shared_ptr<talsh::Tensor> TalshNodeExecutor::getLayoutCopy(numerics::TensorHashType tensor_hash,
+                                                                talsh::Tensor & tens,
+                                                                const std::vector<int> & permutation,
+                                                                const std::string & pattern)
+{
+ auto iter = layout_cache_.find(std::make_pair(tensor_hash,permutation));
+ if(iter == layout_cache_.end()){
+  iter = layout_cache_.emplace(std::make_pair(std::make_pair(tensor_hash,permutation),
+                                              LayoutCopy{nullptr,0,0,0.0})).first;
+ }
+ auto & entry = iter->second;
+ entry.last_used = exatn::Timer::timeInSecHR();
+ if(entry.tensor) return entry.tensor;
+ if(++(entry.uses) < 2) return nullptr; //only repeatedly used permutations are cached
+ const auto size = tens.getSize();
+ if(talshDeviceBufferFreeSize(0,DEV_HOST) < 2 * size) return nullptr; //spare Host buffer space only
+ if(!reserveLayoutCache(size)) return nullptr;
  auto tens_pos = tensors_.find(tensor_hash);
- if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Tensor operand 0 not found: " << std::endl;
-  op.printIt();
-  assert(false);
+ if(tens_pos == tensors_.end()) return nullptr;
+ unsigned int rank = 0;
+ const int * extents = tens.getDimExtents(rank);
+ if(extents == nullptr || rank != permutation.size()) return nullptr;
+ const auto & base_offsets = tens_pos->second.reduced_base_offsets;
+ std::vector<std::size_t> signature(rank);
+ std::vector<int> dims(rank);
+ for(unsigned int i = 0; i < rank; ++i){
+  signature[i] = base_offsets[permutation[i]];
+  dims[i] = extents[permutation[i]];
  }
- tens_pos->second.resetTensorShapeToReduced();
- auto & tens = *(tens_pos->second.talsh_tensor);
+ auto copy = std::make_shared<talsh::Tensor>(signature,dims,tens.getElementType(),talsh_tens_no_init);
+ bool conj = false;
+ const void * src_body = host_body(tens);
+ const auto * plan = (host_transpose_ && src_body != nullptr) ? getTransposePlan(pattern,tens,&conj) : nullptr;
+ if(plan != nullptr){ //Host transpose kernels (cc)
+  void * dest_body = host_body(*copy); assert(dest_body != nullptr);
+  if(!transpose_host_body(*plan,tens.getElementType(),dest_body,src_body,std::complex<double>(1.0,0.0),false,conj))
+   return nullptr;
+ }else{
+  talsh::TensorTask task;
+  auto error_code = copy->copyBody(&task,pattern,tens,DEV_HOST,0);
+  if(error_code == TALSH_SUCCESS){
+   bool synced = task.wait();
+   if(!synced) return nullptr;
+  }else{
+   return nullptr;
+  }
+ }
+ entry.tensor = copy;
+ entry.size = size;
+ layout_cache_bytes_ += size;
+ return entry.tensor;
+}
 
- *exec_handle = op.getId();
 
- int error_code = 0;
-#ifdef MPI_ENABLED
- auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
- float * tens_body_r4 = nullptr;
- double * tens_body_r8 = nullptr;
- std::complex<float> * tens_body_c4 = nullptr;
- std::complex<double> * tens_body_c8 = nullptr;
- bool access_granted = false;
- int tens_elem_type = tens.getElementType();
- switch(tens_elem_type){
-  case(talsh::REAL32): access_granted = tens.getDataAccessHost(&tens_body_r4); break;
-  case(talsh::REAL64): access_granted = tens.getDataAccessHost(&tens_body_r8); break;
-  case(talsh::COMPLEX32): access_granted = tens.getDataAccessHost(&tens_body_c4); break;
-  case(talsh::COMPLEX64): access_granted = tens.getDataAccessHost(&tens_body_c8); break;
-  default:
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Unknown TAL-SH data kind: "
-             << tens_elem_type << std::endl;
-   op.printIt();
-   assert(false);
- }
- if(access_granted){
-  auto mpi_data_kind = get_mpi_tensor_element_kind(tens_elem_type);
-  auto communicator = *(op.getMPICommunicator().get<MPI_Comm>());
-  std::size_t tens_volume = tens.getVolume();
-  //int chunk = std::numeric_limits<int>::max();
-  int chunk = ALLREDUCE_CHUNK_SIZE;
-  for(std::size_t base = 0; base < tens_volume; base += chunk){
-   int count = std::min(chunk,static_cast<int>(tens_volume-base));
-   switch(tens_elem_type){
-    case(talsh::REAL32):
-     assert(tens_body_r4 != nullptr);
-     error_code = MPI_Allreduce(MPI_IN_PLACE,(void*)(&tens_body_r4[base]),count,mpi_data_kind,MPI_SUM,communicator);
-     break;
-    case(talsh::REAL64):
-     assert(tens_body_r8 != nullptr);
-     error_code = MPI_Allreduce(MPI_IN_PLACE,(void*)(&tens_body_r8[base]),count,mpi_data_kind,MPI_SUM,communicator);
-     break;
-    case(talsh::COMPLEX32):
-     assert(tens_body_c4 != nullptr);
-     error_code = MPI_Allreduce(MPI_IN_PLACE,(void*)(&tens_body_c4[base]),count,mpi_data_kind,MPI_SUM,communicator);
-     break;
-    case(talsh::COMPLEX64):
-     assert(tens_body_c8 != nullptr);
-     error_code = MPI_Allreduce(MPI_IN_PLACE,(void*)(&tens_body_c8[base]),count,mpi_data_kind,MPI_SUM,communicator);
-     break;
+bool TalshNodeExecutor::reserveLayoutCache(std::size_t size)
+{
+ if(size > layout_cache_limit_) return false;
+ while(layout_cache_bytes_ + size > layout_cache_limit_){
+  auto victim = layout_cache_.end();
+  for(auto iter = layout_cache_.begin(); iter != layout_cache_.end(); ++iter){
+   if(iter->second.tensor && iter->second.tensor.use_count() == 1){ //idle permuted copy
+    if(victim == layout_cache_.end() || iter->second.last_used < victim->second.last_used) victim = iter;
    }
-   if(error_code != MPI_SUCCESS) break;
   }
- }else{
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): ALLREDUCE: Unable to get access to the tensor body!" << std::endl;
-  op.printIt();
-  assert(false);
+  if(victim == layout_cache_.end()) return false;
+  layout_cache_bytes_ -= victim->second.size;
+  releaseLayoutTensor(victim->second.tensor);
+  layout_cache_.erase(victim);
  }
-#endif
- return error_code;
+ return true;
 }
 
 
-bool TalshNodeExecutor::sync(TensorOpExecHandle op_handle,
-                             int * error_code,
-                             bool wait)
+void TalshNodeExecutor::invalidateLayouts(const numerics::TensorOperation & op)
 {
- *error_code = 0;
- bool synced = true;
- auto iter = tasks_.find(op_handle);
- if(iter != tasks_.end()){
-  auto & task = *(iter->second);
-  if(!task.isEmpty()){
-   if(wait){
-    synced = task.wait();
-   }else{
-    int sts;
-    synced = task.test(&sts);
-    if(synced && sts == TALSH_TASK_ERROR) *error_code = TALSH_TASK_ERROR;
-   }
-   if(synced && *error_code == 0) cacheMovedTensors(task);
-#ifdef MPI_ENABLED
-  }else{
-   auto req_iter = mpi_requests_.find(op_handle);
-   if(req_iter != mpi_requests_.end()){
-    while(!req_iter->second.empty()){
-     MPI_Request * req = (MPI_Request*)(req_iter->second.front());
-     assert(req != nullptr);
-     int completed = 0;
-     if(wait){
-      int errc = MPI_Wait(req,MPI_STATUS_IGNORE);
-      if(errc == MPI_SUCCESS){
-       completed = 1;
-      }else{
-       *error_code = TALSH_TASK_ERROR;
-      }
-      synced = synced && (completed != 0);
-     }else{
-      int errc = MPI_Test(req,&completed,MPI_STATUS_IGNORE);
-      if(errc != MPI_SUCCESS) *error_code = TALSH_TASK_ERROR;
-      synced = synced && (completed != 0);
-     }
-     if(completed){
-      delete req;
-      req_iter->second.pop_front();
-     }else{
-      break;
-     }
-    }
-    if(synced) mpi_requests_.erase(req_iter);
-   }
-#endif
+ if(layout_cache_.empty()) return;
+ const auto num_operands = op.getNumOperandsSet();
+ for(unsigned int i = 0; i < num_operands; ++i){
+  if(op.operandIsMutable(i)){
+   const auto tensor_hash = op.getTensorOperandHash(i);
+   invalidateLayouts(&tensor_hash);
   }
-  if(synced) tasks_.erase(iter);
  }
- return synced;
+ return;
 }
 
 
-bool TalshNodeExecutor::sync()
+void TalshNodeExecutor::invalidateLayouts(const numerics::TensorHashType * tensor_hash)
 {
- bool synced = true;
+ auto iter = (tensor_hash == nullptr) ? layout_cache_.begin()
+             : layout_cache_.lower_bound(std::make_pair(*tensor_hash,std::vector<int>{}));
+ while(iter != layout_cache_.end()){
+  if(tensor_hash != nullptr && iter->first.first != *tensor_hash) break;
+  if(iter->second.tensor){
+   layout_cache_bytes_ -= iter->second.size;
+   releaseLayoutTensor(iter->second.tensor);
+  }
+  iter = layout_cache_.erase(iter);
+ }
+ return;
+}
 
- for(auto & task: evictions_){
-  bool snc = task.second->wait();
-  synced = synced && snc;
+
+void TalshNodeExecutor::releaseLayoutTensor(std::shared_ptr<talsh::Tensor> & copy)
+{
+ if(copy && copy.use_count() == 1){ //last reference: Unregister the permuted copy from the accelerator caches
+  auto eviction = evictions_.find(copy.get());
+  if(eviction != evictions_.end()){
+   auto snc = eviction->second->wait();
+   evictions_.erase(eviction);
+  }
+  for(int dev = 0; dev < DEV_MAX; ++dev) accel_cache_[dev].erase(copy.get());
+  next_use_.erase(copy.get());
  }
- evictions_.clear();
+ copy.reset();
+ return;
+}
 
-#ifdef MPI_ENABLED
- for(auto & task: mpi_requests_){
-  while(!task.second.empty()){
-   MPI_Request * req = (MPI_Request*)(task.second.front());
-   assert(req != nullptr);
-   int error_code = MPI_Wait(req,MPI_STATUS_IGNORE);
-   synced = synced && (error_code == MPI_SUCCESS);
-   delete req;
-   task.second.pop_front();
+
+bool TalshNodeExecutor::spillColdTensors(std::size_t required_space)
+{
+ if(spill_directory_.empty() && compression_mode_ == COMPRESSION_OFF) return false;
+ completeSpills(false);
+ std::vector<std::pair<std::size_t,numerics::TensorHashType>> candidates; //{size, tensor hash}
+ for(auto & tens: tensors_){
+  auto * talsh_tens = tens.second.talsh_tensor.get();
+  if(talsh_tens == nullptr || spilled_.find(tens.first) != spilled_.end()) continue;
+  if(external_.find(talsh_tens) != external_.end()) continue; //external bodies are not owned
+  if(tensorIsViewed(tens.first)) continue; //tensor slice views alias the body
+  const auto size = talsh_tens->getSize();
+  if(size < SPILL_MIN_TENSOR_SIZE) continue;
+  if(next_use_.find(talsh_tens) != next_use_.end()) continue; //needed within the lookahead window
+  bool on_accelerator = false;
+  for(int dev = 0; dev < DEV_MAX; ++dev) on_accelerator = on_accelerator || (accel_cache_[dev].find(talsh_tens) != accel_cache_[dev].end());
+  if(on_accelerator || prefetches_.find(tens.first) != prefetches_.end()) continue;
+  if(tensorIsCurrentlyInUse(talsh_tens) || tensorIsPinned(tens.first)) continue;
+  candidates.emplace_back(std::make_pair(size,tens.first));
+ }
+ std::sort(candidates.begin(),candidates.end(),
+           [](const std::pair<std::size_t,numerics::TensorHashType> & a,
+              const std::pair<std::size_t,numerics::TensorHashType> & b){return a.first > b.first;}); //largest first
+ std::size_t spilled_size = 0;
+ for(const auto & candidate: candidates){
+  if(required_space > 0 && spilled_size >= required_space) break;
+  auto & tens_impl = tensors_.find(candidate.second)->second;
+  tens_impl.resetTensorShapeToReduced();
+  auto & tens = *(tens_impl.talsh_tensor);
+  void * body = host_body(tens);
+  if(body == nullptr) continue;
+  unsigned int rank = 0;
+  const int * extents = tens.getDimExtents(rank);
+  SpilledTensor spilled;
+  if(!spill_directory_.empty())
+   spilled.path = spill_directory_ + "/exatn_spill_" + std::to_string(getpid()) + "_" + std::to_string(candidate.second) + ".bin";
+  if(extents != nullptr) spilled.extents.assign(extents,extents+rank);
+  spilled.data_kind = tens.getElementType();
+  spilled.size = candidate.first;
+  spilled.status = SpillStatus::WRITING;
+  const auto path = spilled.path;
+  const auto size = spilled.size;
+  std::shared_ptr<std::vector<unsigned char>> packed;
+  double tolerance = 0.0;
+  if(compression_mode_ != COMPRESSION_OFF){
+   packed = std::make_shared<std::vector<unsigned char>>();
+   if(compression_mode_ == COMPRESSION_LOSSY) tolerance = compression_tolerance_;
   }
+  spilled.packed = packed;
+  const std::size_t word_size = (spilled.data_kind == talsh::REAL32 || spilled.data_kind == talsh::COMPLEX32) ? sizeof(float) : sizeof(double);
+  const std::size_t stride = (spilled.data_kind == talsh::COMPLEX32 || spilled.data_kind == talsh::COMPLEX64) ? 2 : 1;
+  spilled.io = std::async(std::launch::async,[path,body,size,packed,word_size,stride,tolerance](){
+   if(packed){ //compression tier
+    compress_tensor_body(body,size,word_size,stride,tolerance,*packed);
+    if(static_cast<double>(packed->size()) <= static_cast<double>(size) * COMPRESSION_MAX_RATIO){
+     packed->shrink_to_fit();
+     return true;
+    }
+    packed->clear();
+    packed->shrink_to_fit();
+    if(path.empty()) return false; //does not compress well: Stays resident
+   }
+   std::ofstream file(path,std::ios::out|std::ios::binary|std::ios::trunc);
+   if(!file.is_open()) return false;
+   file.write(static_cast<const char*>(body),static_cast<std::streamsize>(size));
+   return file.good();
+  });
+  spilled_.emplace(std::make_pair(candidate.second,std::move(spilled)));
+  spilled_size += size;
  }
- mpi_requests_.clear();
-#endif
+ return (spilled_size > 0);
+}
 
- for(auto & task: tasks_){
-  bool snc = task.second->wait();
-  if(snc) cacheMovedTensors(*(task.second));
-  synced = synced && snc;
+
+void TalshNodeExecutor::completeSpills(bool wait)
+{
+ auto iter = spilled_.begin();
+ while(iter != spilled_.end()){
+  auto & spilled = iter->second;
+  if(spilled.status == SpillStatus::WRITING &&
+     (wait || spilled.io.wait_for(std::chrono::seconds(0)) == std::future_status::ready)){
+   bool written = spilled.io.get();
+   auto tens_pos = tensors_.find(iter->first);
+   if(written && tens_pos != tensors_.end()){
+    auto * talsh_tens = tens_pos->second.talsh_tensor.get();
+    if(!tensorIsCurrentlyInUse(talsh_tens) && !tensorIsPinned(iter->first)){ //release the tensor body from the Host buffer
+     next_use_.erase(talsh_tens);
+     tens_pos->second.talsh_tensor.reset();
+     spilled.status = SpillStatus::STORED;
+     ++iter;
+     continue;
+    }
+   }
+   if(!(spilled.path.empty())) std::remove(spilled.path.c_str()); //spill failed or cancelled
+   iter = spilled_.erase(iter);
+  }else{
+   ++iter;
+  }
  }
- tasks_.clear();
+ return;
+}
 
- for(auto & task: prefetches_){
-  bool snc = task.second->wait();
-  if(snc) cacheMovedTensors(*(task.second));
-  synced = synced && snc;
+
+bool TalshNodeExecutor::restoreSpilledTensor(numerics::TensorHashType tensor_hash, bool wait, bool make_room)
+{
+ auto iter = spilled_.find(tensor_hash);
+ if(iter == spilled_.end()) return true;
+ auto & spilled = iter->second;
+ if(spilled.status == SpillStatus::WRITING){ //cancel the spill: The tensor body is still resident
+  spilled.io.wait();
+  if(!(spilled.path.empty())) std::remove(spilled.path.c_str());
+  spilled_.erase(iter);
+  return true;
  }
- prefetches_.clear();
+ auto tens_pos = tensors_.find(tensor_hash); assert(tens_pos != tensors_.end());
+ if(spilled.status == SpillStatus::STORED){ //start reading the tensor body back
+  std::unique_ptr<talsh::Tensor> restored(new talsh::Tensor(tens_pos->second.reduced_base_offsets,spilled.extents,
+                                                            spilled.data_kind,talsh_tens_no_init));
+  if(restored->isEmpty()){ //no free space in the Host buffer at the moment
+   const auto size = spilled.size;
+   if(make_room) spillColdTensors(size);
+   return false;
+  }
+  void * body = host_body(*restored); assert(body != nullptr);
+  tens_pos->second.talsh_tensor = std::move(restored);
+  const auto path = spilled.path;
+  const auto size = spilled.size;
+  auto packed = spilled.packed;
+  spilled.io = std::async(std::launch::async,[path,body,size,packed](){
+   if(packed && !(packed->empty())) return decompress_tensor_body(*packed,body,size); //compression tier
+   std::ifstream file(path,std::ios::in|std::ios::binary);
+   if(!file.is_open()) return false;
+   file.read(static_cast<char*>(body),static_cast<std::streamsize>(size));
+   return file.good();
+  });
+  spilled.status = SpillStatus::READING;
+ }
+ if(!wait && spilled.io.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+ bool restored = spilled.io.get();
+ if(!restored){
+  std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to restore a spilled tensor from "
+            << ((spilled.packed && !(spilled.packed->empty())) ? std::string("memory") : spilled.path) << std::endl << std::flush;
+  assert(false);
+ }
+ if(!(spilled.path.empty())) std::remove(spilled.path.c_str());
+ spilled_.erase(iter);
+ return true;
+}
 
- return synced;
+
+bool TalshNodeExecutor::discardSpilledTensor(numerics::TensorHashType tensor_hash)
+{
+ auto iter = spilled_.find(tensor_hash);
+ if(iter == spilled_.end()) return false;
+ if(iter->second.io.valid()) iter->second.io.wait();
+ const bool stored = (iter->second.status == SpillStatus::STORED);
+ if(!(iter->second.path.empty())) std::remove(iter->second.path.c_str());
+ spilled_.erase(iter);
+ return stored;
 }
 
 
-bool TalshNodeExecutor::discard(TensorOpExecHandle op_handle)
+int TalshNodeExecutor::contractSync(talsh::Tensor & dest, const std::string & pattern,
+                                    talsh::Tensor & left, talsh::Tensor & right)
 {
-#ifdef MPI_ENABLED
- //`Cancel associated MPI message (if any)
-#endif
- auto iter = tasks_.find(op_handle);
- if(iter != tasks_.end()){
-  tasks_.erase(iter);
-  return true;
+ talsh::TensorTask task;
+ int error_code = dest.contractAccumulate(&task,pattern,left,right,DEV_DEFAULT,DEV_DEFAULT,
+                                          std::complex<double>(1.0,0.0),false);
+ if(error_code != TALSH_SUCCESS){ //fall back to Host
+  task.clean();
+  error_code = dest.contractAccumulate(&task,pattern,left,right,DEV_HOST,0,
+                                       std::complex<double>(1.0,0.0),false);
  }
- return false;
+ if(error_code == TALSH_SUCCESS){
+  if(!task.wait()) return TALSH_FAILURE;
+  cacheMovedTensors(task);
+ }
+ return error_code;
 }
 
 
-bool TalshNodeExecutor::prefetch(const numerics::TensorOperation & op)
+int TalshNodeExecutor::decomposeSVDTruncated(const std::string & pattern,
+                                             talsh::Tensor & dest,
+                                             talsh::Tensor & left,
+                                             talsh::Tensor & right,
+                                             talsh::Tensor * middle,
+                                             bool randomized,
+                                             double tolerance)
 {
- bool prefetching = false;
- if(prefetch_enabled_){
-  const auto opcode = op.getOpcode();
-  if(opcode == TensorOpCode::CONTRACT){
-   const auto num_operands = op.getNumOperands(); assert(num_operands == 3);
-   talsh::Tensor * talsh_tens[3];
-   for(unsigned int i = 0; i < num_operands; ++i){
-    auto iter = tensors_.find(op.getTensorOperand(i)->getTensorHash());
-    if(iter != tensors_.end()){
-     iter->second.resetTensorShapeToReduced();
-     talsh_tens[i] = iter->second.talsh_tensor.get(); assert(talsh_tens[i] != nullptr);
-    }else{
-     return prefetching;
-    }
-   }
-   int dev_kind;
-   int opt_exec_device = talsh::determineOptimalDevice(*(talsh_tens[0]),*(talsh_tens[1]),*(talsh_tens[2]));
-   int dev_id = talshKindDevId(opt_exec_device,&dev_kind);
-   //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): PREFETCH: TAL-SH tensors: "
-   //          << talsh_tens[0] << " " << talsh_tens[1] << " " << talsh_tens[2] << std::endl << std::flush; //debug
-   if(dev_kind != DEV_HOST){
-    for(unsigned int i = 0; i < num_operands; ++i){
-     bool in_use = tensorIsCurrentlyInUse(talsh_tens[i]);
-     if(!in_use){
-      auto task_res = prefetches_.emplace(std::make_pair(op.getTensorOperand(i)->getTensorHash(),
-                                          std::make_shared<talsh::TensorTask>()));
-      if(task_res.second){
-       bool prefetch_started = talsh_tens[i]->sync(task_res.first->second.get(),dev_kind,dev_id);
-       if(!prefetch_started){
-        task_res.first->second->clean();
-        prefetches_.erase(task_res.first);
-       }
-       prefetching = prefetching || prefetch_started;
-      }else{
-       std::cout << "#ERROR(exatn::runtime::node_executor_talsh): PREFETCH: Repeated prefetch corruption for tensor operand "
-                 << i << " in tensor operation:" << std::endl; //broken association between exatn::TensorHash and talsh::Tensor
-       op.printIt();
-       assert(false);
-      }
-     }
-    }
+ //Parse the decomposition pattern D(..)=L(..)*R(..):
+ std::vector<std::string> tensors;
+ std::string tensor_name;
+ std::vector<IndexLabel> dinds, linds, rinds;
+ bool conj;
+ bool parsed = parse_tensor_network(pattern,tensors);
+ if(parsed) parsed = (tensors.size() == 3);
+ if(parsed) parsed = parse_tensor(tensors[0],tensor_name,dinds,conj) &&
+                     parse_tensor(tensors[1],tensor_name,linds,conj) &&
+                     parse_tensor(tensors[2],tensor_name,rinds,conj);
+ if(!parsed){
+  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): DECOMPOSE_SVD: Invalid index pattern: "
+            << pattern << std::endl;
+  assert(false);
+ }
+ //Classify the indices into left free, bond (shared by L and R), and right free:
+ auto find_label = [](const std::vector<IndexLabel> & inds, const std::string & label){
+  for(unsigned int i = 0; i < inds.size(); ++i) if(inds[i].label == label) return static_cast<int>(i);
+  return -1;
+ };
+ unsigned int lrank = 0, rrank = 0;
+ const int * lext = left.getDimExtents(lrank);
+ const int * rext = right.getDimExtents(rrank);
+ std::vector<int> left_extents(lext,lext+lrank), right_extents(rext,rext+rrank);
+ std::vector<IndexLabel> bonds, lfree, rfree;
+ std::vector<int> bond_dims, lfree_dims, rfree_dims;
+ std::vector<unsigned int> lbond_pos, rbond_pos;
+ for(unsigned int i = 0; i < linds.size(); ++i){
+  const int j = find_label(rinds,linds[i].label);
+  if(j >= 0){
+   bonds.emplace_back(linds[i]); bond_dims.emplace_back(left_extents[i]);
+   lbond_pos.emplace_back(i); rbond_pos.emplace_back(j);
+  }else{
+   lfree.emplace_back(linds[i]); lfree_dims.emplace_back(left_extents[i]);
+  }
+ }
+ for(unsigned int j = 0; j < rinds.size(); ++j){
+  if(find_label(linds,rinds[j].label) < 0){
+   rfree.emplace_back(rinds[j]); rfree_dims.emplace_back(right_extents[j]);
+  }
+ }
+ std::size_t m = 1, n = 1, k = 1;
+ for(const auto & dim: lfree_dims) m *= dim;
+ for(const auto & dim: rfree_dims) n *= dim;
+ for(const auto & dim: bond_dims) k *= dim;
+ const std::size_t oversampling = RSVD_OVERSAMPLING;
+ const std::size_t sketch = k + oversampling;
+ if(lfree.empty() || rfree.empty() || bonds.empty() || sketch >= std::min(m,n)) randomized = false;
+
+ //Temporary tensors:
+ const int data_kind = dest.getElementType();
+ std::vector<std::unique_ptr<talsh::Tensor>> temps;
+ auto new_tensor = [&temps,data_kind](const std::vector<int> & dims){
+  temps.emplace_back(std::unique_ptr<talsh::Tensor>(
+   new talsh::Tensor(std::vector<std::size_t>(dims.size(),0),dims,data_kind,talsh_tens_no_init)));
+  return temps.back().get();
+ };
+ auto purge_temps = [this,&temps](){
+  for(const auto & temp: temps){
+   for(int dev = 0; dev < DEV_MAX; ++dev) accel_cache_[dev].erase(temp.get());
+   next_use_.erase(temp.get());
+  }
+  temps.clear();
+ };
+ talsh::Tensor * svals = middle;
+ if(svals == nullptr) svals = new_tensor(bond_dims);
+
+ int error_code = TALSH_SUCCESS;
+ talsh::Tensor * svd_dest = &dest;
+ talsh::Tensor * svd_left = &left;
+ std::string svd_pattern = pattern;
+ talsh::Tensor * basis = nullptr;
+ talsh::Tensor * ufactor = nullptr;
+ std::string lift_pattern;
+ if(randomized){ //randomized range finder: D ~ Q * (Q+ * D)
+  const IndexLabel s_label{"rsvd_s",LegDirection::UNDIRECT};
+  const IndexLabel t_label{"rsvd_t",LegDirection::UNDIRECT};
+  auto rfree_s = rfree; rfree_s.emplace_back(s_label);
+  auto lfree_s = lfree; lfree_s.emplace_back(s_label);
+  auto lfree_t = lfree; lfree_t.emplace_back(t_label);
+  std::vector<IndexLabel> s_rfree(1,s_label); s_rfree.insert(s_rfree.end(),rfree.cbegin(),rfree.cend());
+  std::vector<IndexLabel> s_bonds(1,s_label); s_bonds.insert(s_bonds.end(),bonds.cbegin(),bonds.cend());
+  auto rfree_dims_s = rfree_dims; rfree_dims_s.emplace_back(sketch);
+  auto lfree_dims_s = lfree_dims; lfree_dims_s.emplace_back(sketch);
+  std::vector<int> s_rfree_dims(1,sketch); s_rfree_dims.insert(s_rfree_dims.end(),rfree_dims.cbegin(),rfree_dims.cend());
+  std::vector<int> s_bond_dims(1,sketch); s_bond_dims.insert(s_bond_dims.end(),bond_dims.cbegin(),bond_dims.cend());
+  const auto range_pattern = assemble_symbolic_tensor("D",lfree_s) + "+=" +
+                             assemble_symbolic_tensor("L",dinds) + "*" + assemble_symbolic_tensor("R",rfree_s);
+  const auto power_pattern = assemble_symbolic_tensor("D",rfree_s) + "+=" +
+                             assemble_symbolic_tensor("L",dinds,true) + "*" + assemble_symbolic_tensor("R",lfree_s);
+  const auto orth_pattern = assemble_symbolic_tensor("D",lfree_s) + "=" +
+                            assemble_symbolic_tensor("L",lfree_t) + "*" +
+                            assemble_symbolic_tensor("R",std::vector<IndexLabel>{t_label,s_label});
+  const auto proj_pattern = assemble_symbolic_tensor("D",s_rfree) + "+=" +
+                            assemble_symbolic_tensor("L",lfree_s,true) + "*" + assemble_symbolic_tensor("R",dinds);
+  svd_pattern = assemble_symbolic_tensor("D",s_rfree) + "=" +
+                assemble_symbolic_tensor("L",s_bonds) + "*" + assemble_symbolic_tensor("R",rinds);
+  lift_pattern = assemble_symbolic_tensor("D",linds) + "+=" +
+                 assemble_symbolic_tensor("L",lfree_s) + "*" + assemble_symbolic_tensor("R",s_bonds);
+  auto * omega = new_tensor(rfree_dims_s);                    //random test matrix (reused for D+ * Q)
+  auto * range = new_tensor(lfree_dims_s);                    //sampled range Y = D * Omega
+  basis = new_tensor(lfree_dims_s);                           //orthonormal range basis Q
+  auto * yright = new_tensor(std::vector<int>{static_cast<int>(sketch),static_cast<int>(sketch)});
+  auto * yvals = new_tensor(std::vector<int>{static_cast<int>(sketch)});
+  auto * projected = new_tensor(s_rfree_dims);                //projected matrix B = Q+ * D
+  ufactor = new_tensor(s_bond_dims);                          //left singular vectors of B
+  for(const auto & temp: temps){
+   if(temp->isEmpty()){purge_temps(); return TRY_LATER;}
+  }
+  void * body = host_body(*omega); assert(body != nullptr);
+  std::mt19937_64 generator;
+  switch(data_kind){
+   case(talsh::REAL32): fill_gaussian(static_cast<float*>(body),omega->getVolume(),generator); break;
+   case(talsh::REAL64): fill_gaussian(static_cast<double*>(body),omega->getVolume(),generator); break;
+   case(talsh::COMPLEX32): fill_gaussian(static_cast<std::complex<float>*>(body),omega->getVolume(),generator); break;
+   case(talsh::COMPLEX64): fill_gaussian(static_cast<std::complex<double>*>(body),omega->getVolume(),generator); break;
+   default: assert(false);
+  }
+  auto orthonormalize = [&](){
+   talsh::TensorTask task;
+   int errc = range->decomposeSVD(&task,orth_pattern,*basis,*yright,*yvals,DEV_HOST,0);
+   if(errc == TALSH_SUCCESS && !task.wait()) errc = TALSH_FAILURE;
+   return errc;
+  };
+  error_code = contractSync(*range,range_pattern,dest,*omega);
+  if(error_code == TALSH_SUCCESS) error_code = orthonormalize();
+  for(int iter = 0; iter < rsvd_power_iterations_ && error_code == TALSH_SUCCESS; ++iter){
+   error_code = contractSync(*omega,power_pattern,dest,*basis);
+   if(error_code == TALSH_SUCCESS) error_code = contractSync(*range,range_pattern,dest,*omega);
+   if(error_code == TALSH_SUCCESS) error_code = orthonormalize();
+  }
+  if(error_code == TALSH_SUCCESS) error_code = contractSync(*projected,proj_pattern,*basis,dest);
+  svd_dest = projected;
+  svd_left = ufactor;
+ }else{
+  for(const auto & temp: temps){
+   if(temp->isEmpty()){purge_temps(); return TRY_LATER;}
+  }
+ }
+ //Small SVD on Host:
+ if(error_code == TALSH_SUCCESS){
+  talsh::TensorTask task;
+  error_code = svd_dest->decomposeSVD(&task,svd_pattern,*svd_left,right,*svals,DEV_HOST,0);
+  if(error_code == TALSH_SUCCESS && !task.wait()) error_code = TALSH_FAILURE;
+ }
+ if(error_code == TALSH_SUCCESS && randomized) error_code = contractSync(left,lift_pattern,*basis,*ufactor);
+ //Truncation and absorption of the singular values:
+ if(error_code == TALSH_SUCCESS && (tolerance > 0.0 || middle == nullptr)){
+  auto synced = svals->sync(DEV_HOST,0,nullptr,true); assert(synced);
+  void * body = host_body(*svals); assert(body != nullptr);
+  std::vector<double> factors;
+  switch(data_kind){
+   case(talsh::REAL32): truncate_singular_values(static_cast<float*>(body),svals->getVolume(),tolerance,factors); break;
+   case(talsh::REAL64): truncate_singular_values(static_cast<double*>(body),svals->getVolume(),tolerance,factors); break;
+   case(talsh::COMPLEX32): truncate_singular_values(static_cast<std::complex<float>*>(body),svals->getVolume(),tolerance,factors); break;
+   case(talsh::COMPLEX64): truncate_singular_values(static_cast<std::complex<double>*>(body),svals->getVolume(),tolerance,factors); break;
+   default: assert(false);
+  }
+  if(middle == nullptr){ //absorb sqrt(S) into both factors
+   for(auto & factor: factors) factor = std::sqrt(factor);
+   synced = left.sync(DEV_HOST,0,nullptr,true); assert(synced);
+   synced = right.sync(DEV_HOST,0,nullptr,true); assert(synced);
+   void * lbody = host_body(left); assert(lbody != nullptr);
+   void * rbody = host_body(right); assert(rbody != nullptr);
+   switch(data_kind){
+    case(talsh::REAL32):
+     scale_bonds(static_cast<float*>(lbody),left_extents,lbond_pos,factors);
+     scale_bonds(static_cast<float*>(rbody),right_extents,rbond_pos,factors);
+     break;
+    case(talsh::REAL64):
+     scale_bonds(static_cast<double*>(lbody),left_extents,lbond_pos,factors);
+     scale_bonds(static_cast<double*>(rbody),right_extents,rbond_pos,factors);
+     break;
+    case(talsh::COMPLEX32):
+     scale_bonds(static_cast<std::complex<float>*>(lbody),left_extents,lbond_pos,factors);
+     scale_bonds(static_cast<std::complex<float>*>(rbody),right_extents,rbond_pos,factors);
+     break;
+    case(talsh::COMPLEX64):
+     scale_bonds(static_cast<std::complex<double>*>(lbody),left_extents,lbond_pos,factors);
+     scale_bonds(static_cast<std::complex<double>*>(rbody),right_extents,rbond_pos,factors);
+     break;
+    default: assert(false);
    }
   }
  }
- return prefetching;
+ purge_temps();
+ return error_code;
 }
 
-
-void TalshNodeExecutor::clearCache()
+bool TalshNodeExecutor::tensorOnAccelerator(const talsh::Tensor * talsh_tens) const
 {
- bool evicted = evictMovedTensors();
- return;
+ for(int dev = 0; dev < DEV_MAX; ++dev){
+  if(accel_cache_[dev].find(const_cast<talsh::Tensor*>(talsh_tens)) != accel_cache_[dev].end()) return true;
+ }
+ return false;
 }
 
 
-std::shared_ptr<talsh::Tensor> TalshNodeExecutor::getLocalTensor(const numerics::Tensor & tensor,
-                                  const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec)
+int TalshNodeExecutor::copySliceOnHost(talsh::Tensor & tens,
+                                       talsh::Tensor & slice,
+                                       const std::vector<int> & offsets,
+                                       bool insert,
+                                       bool accumulative)
 {
- const auto tensor_rank = slice_spec.size();
- std::vector<std::size_t> signature(tensor_rank);
- std::vector<int> offsets(tensor_rank);
- std::vector<int> dims(tensor_rank);
- for(unsigned int i = 0; i < tensor_rank; ++i){
-  signature[i] = static_cast<std::size_t>(slice_spec[i].first);
-  offsets[i] = static_cast<int>(slice_spec[i].first);
-  dims[i] = static_cast<int>(slice_spec[i].second);
+ if(dry_run_.load()) return TALSH_NOT_AVAILABLE;
+ if(tensorOnAccelerator(&tens) || tensorOnAccelerator(&slice)) return TALSH_NOT_AVAILABLE;
+ const int data_kind = tens.getElementType();
+ if(slice.getElementType() != data_kind) return TALSH_NOT_AVAILABLE;
+ void * tens_body = host_body(tens);
+ void * slice_body = host_body(slice);
+ if(tens_body == nullptr || slice_body == nullptr) return TALSH_NOT_AVAILABLE;
+ unsigned int rank = 0, slice_rank = 0;
+ const int * tens_ext = tens.getDimExtents(rank);
+ const int * slice_ext = slice.getDimExtents(slice_rank);
+ if(slice_rank != rank || offsets.size() != rank) return TALSH_NOT_AVAILABLE;
+ std::vector<int> tens_extents(tens_ext,tens_ext+rank), slice_extents(slice_ext,slice_ext+rank);
+ for(unsigned int i = 0; i < rank; ++i){
+  if(offsets[i] < 0 || offsets[i] + slice_extents[i] > tens_extents[i]) return TALSH_NOT_AVAILABLE;
  }
- std::shared_ptr<talsh::Tensor> slice(nullptr);
- switch(tensor.getElementType()){
-  case TensorElementType::REAL32:
-   slice = std::make_shared<talsh::Tensor>(signature,dims,static_cast<float>(0.0));
+ switch(data_kind){
+  case(talsh::REAL32):
+   copy_slice(static_cast<float*>(tens_body),static_cast<float*>(slice_body),
+              tens_extents,slice_extents,offsets,insert,accumulative,SLICE_BLOCK_VOLUME,SLICE_PARALLEL_VOLUME);
    break;
-  case TensorElementType::REAL64:
-   slice = std::make_shared<talsh::Tensor>(signature,dims,static_cast<double>(0.0));
+  case(talsh::REAL64):
+   copy_slice(static_cast<double*>(tens_body),static_cast<double*>(slice_body),
+              tens_extents,slice_extents,offsets,insert,accumulative,SLICE_BLOCK_VOLUME,SLICE_PARALLEL_VOLUME);
    break;
-  case TensorElementType::COMPLEX32:
-   slice = std::make_shared<talsh::Tensor>(signature,dims,std::complex<float>(0.0));
+  case(talsh::COMPLEX32):
+   copy_slice(static_cast<std::complex<float>*>(tens_body),static_cast<std::complex<float>*>(slice_body),
+              tens_extents,slice_extents,offsets,insert,accumulative,SLICE_BLOCK_VOLUME,SLICE_PARALLEL_VOLUME);
    break;
-  case TensorElementType::COMPLEX64:
-   slice = std::make_shared<talsh::Tensor>(signature,dims,std::complex<double>(0.0));
+  case(talsh::COMPLEX64):
+   copy_slice(static_cast<std::complex<double>*>(tens_body),static_cast<std::complex<double>*>(slice_body),
+              tens_extents,slice_extents,offsets,insert,accumulative,SLICE_BLOCK_VOLUME,SLICE_PARALLEL_VOLUME);
    break;
   default:
-   std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor::getLocalTensor): Invalid tensor element type!"
-             << std::endl << std::flush;
-   std::abort();
+   return TALSH_NOT_AVAILABLE;
  }
- if(!(slice->isEmpty())){
-  auto tens_pos = tensors_.find(tensor.getTensorHash());
-  if(tens_pos == tensors_.end()){
-   std::cout << "#ERROR(exatn::runtime::TalshNodeExecutor::getLocalTensor): Tensor not found: " << std::endl;
-   tensor.printIt();
-   std::abort();
-  }
-  tens_pos->second.resetTensorShapeToFull();
-  auto & talsh_tensor = *(tens_pos->second.talsh_tensor);
-  auto error_code = talsh_tensor.extractSlice(nullptr,*slice,offsets);
-  assert(error_code == TALSH_SUCCESS);
- }else{
-  slice.reset();
-  std::cout << "#WARNING(exatn::runtime::TalshNodeExecutor::getLocalTensor): "
-            << "Unable to allocate a local slice for tensor " << tensor.getName()
-            << ":" << std::endl;
-  tensor.printIt();
-  std::cout << std::endl;
+ return TALSH_SUCCESS;
+}
+
+
+
+void TalshNodeExecutor::materializeZeros(const numerics::TensorOperation & op)
+{
+ if(known_zero_.empty()) return;
+ const auto opcode = op.getOpcode();
+ const auto num_operands = op.getNumOperands();
+ if(opcode == TensorOpCode::DESTROY){
+  known_zero_.erase(op.getTensorOperandHash(0));
+  return;
  }
- return slice;
+ //Destination tensors handling the known-zero state by themselves:
+ bool overwrite = (opcode == TensorOpCode::CONTRACT || opcode == TensorOpCode::ADD || is_zero_initialization(op));
+ for(unsigned int i = 1; i < num_operands; ++i){
+  if(op.getTensorOperandHash(i) == op.getTensorOperandHash(0)) overwrite = false; //in-place tensor operation
+ }
+ for(unsigned int i = (overwrite ? 1 : 0); i < num_operands; ++i) materializeZeros(op.getTensorOperandHash(i));
+ return;
 }
 
 
-void * TalshNodeExecutor::getTensorImage(const numerics::Tensor & tensor,
-                                         int device_kind, int device_id,
-                                         std::size_t * size) const
+void TalshNodeExecutor::materializeZeros(numerics::TensorHashType tensor_hash)
 {
- const auto tensor_hash = tensor.getTensorHash();
+ auto iter = known_zero_.find(tensor_hash);
+ if(iter == known_zero_.end()) return;
  auto tens_pos = tensors_.find(tensor_hash);
- if(tens_pos == tensors_.end()){
-  std::cout << "#ERROR(exatn::runtime::node_executor_talsh): getTensorImage: Tensor not found:\n";
-  tensor.printIt();
-  assert(false);
+ if(tens_pos != tensors_.end()){
+  auto & tens = *(tens_pos->second.talsh_tensor);
+  auto synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+  void * body = host_body(tens); assert(body != nullptr);
+  std::memset(body,0,tens.getSize());
  }
- //tens_pos->second.resetTensorShapeToReduced();
- auto & tens = *(tens_pos->second.talsh_tensor);
+ known_zero_.erase(iter);
+ return;
+}
 
- assert(device_kind == DEV_HOST && device_id == 0); //`temporary
- auto synced = tens.sync(device_kind,device_id,nullptr,true); assert(synced);
- void * tens_body = nullptr;
- float * tens_body_r4 = nullptr;
- double * tens_body_r8 = nullptr;
- std::complex<float> * tens_body_c4 = nullptr;
- std::complex<double> * tens_body_c8 = nullptr;
- bool access_granted = false;
- const int tens_elem_type = tens.getElementType();
- switch(tens_elem_type){
-  case(talsh::REAL32):
-   access_granted = tens.getDataAccessHost(&tens_body_r4);
-   if(access_granted) tens_body = static_cast<void*>(tens_body_r4);
-   break;
-  case(talsh::REAL64):
-   access_granted = tens.getDataAccessHost(&tens_body_r8);
-   if(access_granted) tens_body = static_cast<void*>(tens_body_r8);
-   break;
-  case(talsh::COMPLEX32):
-   access_granted = tens.getDataAccessHost(&tens_body_c4);
-   if(access_granted) tens_body = static_cast<void*>(tens_body_c4);
-   break;
-  case(talsh::COMPLEX64):
-   access_granted = tens.getDataAccessHost(&tens_body_c8);
-   if(access_granted) tens_body = static_cast<void*>(tens_body_c8);
-   break;
-  default:
-   std::cout << "#ERROR(exatn::runtime::node_executor_talsh): getTensorImage: Unknown TAL-SH data kind: "
-             << tens_elem_type << std::endl;
-   tens.print();
-   assert(false);
+
+bool TalshNodeExecutor::aliasDonatedTensor(const numerics::TensorOpAdd & op)
+{
+ if(!op.operandIsDonated(1) || !isPlainCopy(op)) return false;
+ const auto tensor0_hash = op.getTensorOperandHash(0);
+ const auto tensor1_hash = op.getTensorOperandHash(1);
+ if(known_zero_.find(tensor0_hash) == known_zero_.end()) return false;
+ if(!swapTensorBodies(tensor0_hash,tensor1_hash)) return false;
+ known_zero_.erase(tensor0_hash);
+ return true;
+}
+
+
+bool TalshNodeExecutor::isPlainCopy(const numerics::TensorOpAdd & op) const
+{
+ if(op.operandIsConjugated(1) || op.getScalar(0) != std::complex<double>(1.0,0.0)) return false;
+ const auto tensor0_hash = op.getTensorOperandHash(0);
+ const auto tensor1_hash = op.getTensorOperandHash(1);
+ if(tensor0_hash == tensor1_hash) return false;
+ //No index permutation:
+ std::vector<std::string> tensors;
+ if(!parse_tensor_network(op.getIndexPattern(),tensors) || tensors.size() != 2) return false;
+ std::string names[2];
+ std::vector<IndexLabel> indices[2];
+ bool conj[2];
+ for(unsigned int i = 0; i < 2; ++i){
+  if(!parse_tensor(tensors[i],names[i],indices[i],conj[i]) || conj[i]) return false;
  }
- if(size != nullptr){
-  *size = tens.getSize();
-  assert(*size > 0);
+ if(indices[0].size() != indices[1].size()) return false;
+ for(unsigned int i = 0; i < indices[0].size(); ++i){
+  if(indices[0][i].label != indices[1][i].label) return false;
  }
- return tens_body;
+ //Same shape:
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens0_pos == tensors_.cend() || tens1_pos == tensors_.cend()) return false;
+ if(tens0_pos->second.full_base_offsets != tens1_pos->second.full_base_offsets) return false;
+ auto * talsh_tens0 = tens0_pos->second.talsh_tensor.get();
+ auto * talsh_tens1 = tens1_pos->second.talsh_tensor.get();
+ return (talsh_tens0->getElementType() == talsh_tens1->getElementType() &&
+         talsh_tens0->getVolume() == talsh_tens1->getVolume());
 }
 
 
-bool TalshNodeExecutor::finishPrefetching(const numerics::TensorOperation & op)
+bool TalshNodeExecutor::swapTensorBodies(numerics::TensorHashType tensor0_hash,
+                                         numerics::TensorHashType tensor1_hash)
 {
- bool synced = true;
- //Test completion of active evictions:
- auto eviction = evictions_.begin();
- while(eviction != evictions_.end()){
-  int sts;
-  bool snc = eviction->second->test(&sts);
-  if(snc) eviction = evictions_.erase(eviction);
- }
- //Test completion of active prefetches:
- auto prefetch = prefetches_.begin();
- while(prefetch != prefetches_.end()){
-  int sts;
-  bool snc = prefetch->second->test(&sts);
-  if(snc){
-   cacheMovedTensors(*(prefetch->second));
-   prefetch = prefetches_.erase(prefetch);
+ if(spilled_.find(tensor0_hash) != spilled_.end() || spilled_.find(tensor1_hash) != spilled_.end()) return false;
+ if(tensorIsViewed(tensor0_hash) || tensorIsViewed(tensor1_hash)) return false;
+ //Both tensor bodies must be idle Host-only images owned by the executor:
+ auto tens0_pos = tensors_.find(tensor0_hash);
+ auto tens1_pos = tensors_.find(tensor1_hash);
+ if(tens0_pos == tensors_.end() || tens1_pos == tensors_.end()) return false;
+ talsh::Tensor * talsh_tens[2] = {tens0_pos->second.talsh_tensor.get(),tens1_pos->second.talsh_tensor.get()};
+ for(auto * tens: talsh_tens){
+  if(external_.find(tens) != external_.end() || evictions_.find(tens) != evictions_.end()) return false;
+  for(int dev = 0; dev < DEV_MAX; ++dev){
+   if(accel_cache_[dev].find(tens) != accel_cache_[dev].end()) return false;
   }
+  if(tensorIsCurrentlyInUse(tens) || host_body(*tens) == nullptr) return false;
  }
- //Finish tensor operand prefetching for the given tensor operation:
+ //Swap the TAL-SH tensors:
+ freePersistentTransfers(&tensor0_hash);
+ freePersistentTransfers(&tensor1_hash);
+ invalidateLayouts(&tensor0_hash);
+ invalidateLayouts(&tensor1_hash);
+ next_use_.erase(talsh_tens[0]);
+ next_use_.erase(talsh_tens[1]);
+ std::swap(tens0_pos->second.talsh_tensor,tens1_pos->second.talsh_tensor);
+ return true;
+}
+
+
+bool TalshNodeExecutor::deferPlainCopy(const numerics::TensorOpAdd & op)
+{
+ const auto tensor0_hash = op.getTensorOperandHash(0);
+ const auto tensor1_hash = op.getTensorOperandHash(1);
+ if(known_zero_.find(tensor0_hash) == known_zero_.end() || !isPlainCopy(op)) return false;
+ //Externally provided bodies are visible outside of the executor:
+ for(const auto tensor_hash: {tensor0_hash,tensor1_hash}){
+  auto tens_pos = tensors_.find(tensor_hash);
+  if(tens_pos == tensors_.end()) return false;
+  if(external_.find(tens_pos->second.talsh_tensor.get()) != external_.end()) return false;
+ }
+ lazy_copies_[tensor0_hash] = tensor1_hash;
+ known_zero_.erase(tensor0_hash);
+ return true;
+}
+
+
+bool TalshNodeExecutor::materializeCopies(const numerics::TensorOperation & op)
+{
+ if(lazy_copies_.empty() && slice_views_.empty()) return true;
+ const auto opcode = op.getOpcode();
  const auto num_operands = op.getNumOperands();
- for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
-  const auto tens_hash = op.getTensorOperand(oprnd)->getTensorHash();
-  auto iter = prefetches_.find(tens_hash);
-  if(iter != prefetches_.end()){
-   bool snc = iter->second->wait();
-   if(snc){
-    cacheMovedTensors(*(iter->second));
-    prefetches_.erase(iter);
-   }
-   synced = synced && snc;
+ const bool destroy = (opcode == TensorOpCode::DESTROY);
+ const bool overwrite = (destroy || is_zero_initialization(op));
+ //Slice views detached below must not be in use:
+ for(unsigned int i = 0; i < num_operands; ++i){
+  if((i == 0 && overwrite) || op.operandIsMutable(i)){
+   if(!sliceViewsIdle(op.getTensorOperandHash(i),!(i == 0 && destroy))) return false;
   }
  }
- return synced;
+ for(unsigned int i = 0; i < num_operands; ++i){
+  const auto tensor_hash = op.getTensorOperandHash(i);
+  const bool discard = (i == 0 && overwrite);
+  if(discard){
+   lazy_copies_.erase(tensor_hash); //the lazy copy is no longer needed
+   if(destroy) slice_views_.erase(tensor_hash); //the destroyed slice view does not own its body
+  }else{
+   materializeCopies(tensor_hash,false);
+  }
+  if(discard || op.operandIsMutable(i)){
+   detachSliceViews(tensor_hash);
+   materializeCopies(tensor_hash,true,discard);
+  }
+ }
+ return true;
 }
 
 
-void TalshNodeExecutor::cacheMovedTensors(talsh::TensorTask & talsh_task)
+void TalshNodeExecutor::materializeCopies(numerics::TensorHashType tensor_hash,
+                                          bool written,
+                                          bool discarded)
 {
- if(!(talsh_task.isEmpty())){
-  int dev_kind;
-  int dev_id = talsh_task.getExecutionDevice(&dev_kind);
-  if(dev_kind != DEV_HOST){
-   const int device = talshFlatDevId(dev_kind,dev_id);
-   const auto num_operands = talsh_task.getNumTensorArguments();
-   const auto coherence = talsh_task.getTensorArgumentCoherence();
-   if(coherence >= 0){
-    for(unsigned int oprnd = 0; oprnd < num_operands; ++oprnd){
-     unsigned int arg_coherence = argument_coherence_get_value(coherence,num_operands,oprnd);
-     if(arg_coherence == COPY_M || arg_coherence == COPY_K){ //move or copy of tensor body image
-      auto res = accel_cache_[device].emplace(std::make_pair(const_cast<talsh::Tensor*>(talsh_task.getTensorArgument(oprnd)),
-                                                             CachedAttr{exatn::Timer::timeInSecHR()}));
-      //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CACHE: Device " << device
-      //          << " cached " << res.first->first << std::endl << std::flush; //debug
-     }
+ if(lazy_copies_.empty()) return;
+ if(!written){ //the tensor is accessed: Materialize its own lazy copy
+  auto iter = lazy_copies_.find(tensor_hash);
+  if(iter != lazy_copies_.end()){
+   copyTensorBody(tensor_hash,iter->second);
+   lazy_copies_.erase(iter);
+  }
+ }else{ //the tensor is about to be written: Materialize all lazy copies of it
+  numerics::TensorHashType holder = tensor_hash;
+  for(auto iter = lazy_copies_.begin(); iter != lazy_copies_.end();){
+   if(iter->second == tensor_hash){
+    //The discarded body can be handed over to the first lazy copy:
+    if(!(discarded && holder == tensor_hash && swapTensorBodies(iter->first,tensor_hash))){
+     copyTensorBody(iter->first,holder);
     }
+    holder = iter->first;
+    iter = lazy_copies_.erase(iter);
+   }else{
+    ++iter;
    }
   }
  }
@@ -1595,63 +4884,170 @@ void TalshNodeExecutor::cacheMovedTensors(talsh::TensorTask & talsh_task)
 }
 
 
-bool TalshNodeExecutor::evictMovedTensors(int device_id, std::size_t required_space)
+void TalshNodeExecutor::copyTensorBody(numerics::TensorHashType tensor_hash,
+                                       numerics::TensorHashType source_hash)
 {
- //Disable further prefetching:
- prefetch_enabled_ = false;
- //Initiate new tensor evictions:
- bool evicting = false, single_device = false;
- int dev_begin = 0, dev_end = (DEV_MAX - 1);
- if(device_id != DEV_DEFAULT){
-  assert(device_id >= 0 && device_id < DEV_MAX);
-  dev_begin = device_id; dev_end = device_id;
-  single_device = true;
+ auto restored = restoreSpilledTensor(source_hash,true); assert(restored);
+ restored = restoreSpilledTensor(tensor_hash,true); assert(restored);
+ auto tens_pos = tensors_.find(tensor_hash);
+ auto source_pos = tensors_.find(source_hash);
+ assert(tens_pos != tensors_.end() && source_pos != tensors_.end());
+ auto & tens = *(tens_pos->second.talsh_tensor);
+ auto & source = *(source_pos->second.talsh_tensor);
+ auto synced = source.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ synced = tens.sync(DEV_HOST,0,nullptr,true); assert(synced);
+ void * body = host_body(tens); assert(body != nullptr);
+ const void * source_body = host_body(source); assert(source_body != nullptr);
+ assert(tens.getSize() == source.getSize());
+ std::memcpy(body,source_body,tens.getSize());
+ return;
+}
+
+
+bool TalshNodeExecutor::createSliceView(const numerics::TensorOpSlice & op,
+                                        const std::vector<int> & offsets)
+{
+ //TAL-SH may move the body images of tensor operands to accelerators (the view would dangle):
+ if(!op.isReadOnly() || op.isAccumulative() || !talsh_gpus_.empty()) return false;
+ const auto & slice = *(op.getTensorOperand(0));
+ const auto & tensor = *(op.getTensorOperand(1));
+ const auto slice_hash = slice.getTensorHash();
+ const auto tensor_hash = tensor.getTensorHash();
+ if(slice_hash == tensor_hash || known_zero_.find(slice_hash) != known_zero_.end()) return false;
+ if(spilled_.find(slice_hash) != spilled_.end() || spilled_.find(tensor_hash) != spilled_.end()) return false;
+ if(slice_views_.find(tensor_hash) != slice_views_.end() || tensorIsViewed(slice_hash)) return false;
+ //The slice must be a contiguous block of the parental tensor (column-major storage):
+ const auto rank = slice.getRank();
+ if(tensor.getRank() != rank || offsets.size() != rank) return false;
+ unsigned int dim = 0;
+ while(dim < rank && slice.getDimExtent(dim) == tensor.getDimExtent(dim)) ++dim; //full dimensions
+ for(++dim; dim < rank; ++dim) if(slice.getDimExtent(dim) != 1) return false; //dimensions after the partial one
+ std::size_t offset = 0, stride = 1;
+ for(unsigned int i = 0; i < rank; ++i){
+  offset += static_cast<std::size_t>(offsets[i]) * stride;
+  stride *= tensor.getDimExtent(i);
  }
- std::size_t freed_bytes = 0;
- bool still_freeing = true;
- while(still_freeing){
-  bool cache_empty = true;
-  for(int dev = dev_begin; dev <= dev_end; ++dev){
-   auto iter = accel_cache_[dev].begin();
-   while(iter != accel_cache_[dev].end()){
-    if(!tensorIsCurrentlyInUse(iter->first)){
-     cache_empty = false;
-     int data_kind_size;
-     auto valid = talshValidDataKind(iter->first->getElementType(),&data_kind_size);
-     assert(valid == YEP);
-     std::size_t talsh_tens_size = iter->first->getVolume() * data_kind_size;
-     auto task_res = evictions_.emplace(std::make_pair(iter->first,
-                                                       std::make_shared<talsh::TensorTask>()));
-     if(task_res.second){
-      //std::cout << "#DEBUG(exatn::runtime::node_executor_talsh): CACHE: Device " << dev
-      //          << " evicting " << iter->first << std::endl << std::flush; //debug
-      bool synced = iter->first->sync(task_res.first->second.get(),DEV_HOST,0,nullptr,!single_device); //initiate a move of the tensor body image back to Host
-      iter = accel_cache_[dev].erase(iter);
-      freed_bytes += talsh_tens_size;
-      iter = accel_cache_[dev].end();
-      evicting = true;
-     }
-    }else{
-     ++iter;
-    }
+ //The parental tensor body must be on Host, the slice body must be idle and owned by the executor:
+ auto slice_pos = tensors_.find(slice_hash);
+ auto tensor_pos = tensors_.find(tensor_hash);
+ if(slice_pos == tensors_.end() || tensor_pos == tensors_.end()) return false;
+ auto * slice_tens = slice_pos->second.talsh_tensor.get();
+ auto * tensor_tens = tensor_pos->second.talsh_tensor.get();
+ if(slice_tens->getElementType() != tensor_tens->getElementType()) return false;
+ if(external_.find(slice_tens) != external_.end() || tensorIsCurrentlyInUse(slice_tens)) return false;
+ int elem_size = 0;
+ if(talshValidDataKind(tensor_tens->getElementType(),&elem_size) != YEP) return false;
+ auto * body = static_cast<char*>(host_body(*tensor_tens));
+ if(body == nullptr) return false;
+ //Replace the slice body with the view of the parental tensor body:
+ slice_pos->second.resetTensorShapeToReduced();
+ unsigned int slice_rank = 0;
+ const int * extents = slice_tens->getDimExtents(slice_rank);
+ auto view = make_talsh_tensor(slice_pos->second.reduced_base_offsets,
+                               std::vector<int>(extents,extents+slice_rank),
+                               slice_tens->getElementType(),
+                               static_cast<void*>(body + offset * elem_size));
+ next_use_.erase(slice_tens);
+ freePersistentTransfers(&slice_hash);
+ invalidateLayouts(&slice_hash);
+ slice_pos->second.talsh_tensor = std::move(view);
+ external_.emplace(slice_pos->second.talsh_tensor.get());
+ talsh_tensor_bytes_.fetch_sub(slice.getSize(),std::memory_order_relaxed);
+ memory_timeline_.recordFree(slice,slice.getSize(),-1,op.getId());
+ slice_views_.emplace(std::make_pair(slice_hash,SliceView{tensor_hash,op.getTensorOperand(0)}));
+ return true;
+}
+
+
+bool TalshNodeExecutor::tensorIsViewed(numerics::TensorHashType tensor_hash) const
+{
+ for(const auto & view: slice_views_){
+  if(view.second.parent == tensor_hash) return true;
+ }
+ return false;
+}
+
+
+bool TalshNodeExecutor::sliceViewsIdle(numerics::TensorHashType tensor_hash,
+                                       bool including_itself) const
+{
+ for(const auto & view: slice_views_){
+  if(view.second.parent == tensor_hash || (including_itself && view.first == tensor_hash)){
+   auto tens_pos = tensors_.find(view.first);
+   if(tens_pos != tensors_.cend() && tensorIsCurrentlyInUse(tens_pos->second.talsh_tensor.get())) return false;
+  }
+ }
+ return true;
+}
+
+
+void TalshNodeExecutor::detachSliceViews(numerics::TensorHashType tensor_hash)
+{
+ for(auto view = slice_views_.begin(); view != slice_views_.end();){
+  if(view->first == tensor_hash || view->second.parent == tensor_hash){
+   const auto view_hash = view->first;
+   auto tens_pos = tensors_.find(view_hash);
+   assert(tens_pos != tensors_.end());
+   auto & tens_impl = tens_pos->second;
+   tens_impl.resetTensorShapeToReduced();
+   auto * view_tens = tens_impl.talsh_tensor.get();
+   auto synced = view_tens->sync(DEV_HOST,0,nullptr,true); assert(synced);
+   const auto & slice = *(view->second.slice);
+   unsigned int rank = 0;
+   const int * extents = view_tens->getDimExtents(rank);
+   const std::vector<int> dims(extents,extents+rank);
+   auto body = make_talsh_tensor(tens_impl.reduced_base_offsets,dims,view_tens->getElementType(),nullptr);
+   if(body->isEmpty()){ //temporary memory shortage
+    spillColdTensors(slice.getSize());
+    body = make_talsh_tensor(tens_impl.reduced_base_offsets,dims,view_tens->getElementType(),nullptr);
    }
-   still_freeing = ((!cache_empty) || (dev < dev_end)) && ((required_space == 0) || (freed_bytes < required_space));
-   if(!still_freeing) break;
+   if(body->isEmpty()){
+    std::cout << "#FATAL(exatn::runtime::TalshNodeExecutor): Unable to allocate the body of a detached tensor slice view!"
+              << std::endl << std::flush;
+    assert(false);
+   }
+   std::memcpy(host_body(*body),host_body(*view_tens),view_tens->getSize());
+   external_.erase(view_tens);
+   next_use_.erase(view_tens);
+   freePersistentTransfers(&view_hash);
+   invalidateLayouts(&view_hash);
+   tens_impl.talsh_tensor = std::move(body);
+   talsh_tensor_bytes_.fetch_add(slice.getSize(),std::memory_order_relaxed);
+   memory_timeline_.recordAlloc(slice,slice.getSize(),-1,0);
+   view = slice_views_.erase(view);
+  }else{
+   ++view;
   }
  }
- //Check the completion of previously initiated tensor evictions:
- auto eviction = evictions_.begin();
- while(eviction != evictions_.end()){
-  int sts;
-  bool snc = eviction->second->test(&sts);
-  if(snc) eviction = evictions_.erase(eviction);
+ return;
+}
+
+
+std::shared_ptr<talsh::TensorTask> TalshNodeExecutor::acquireTask()
+{
+ if(task_pool_.empty()) return std::make_shared<talsh::TensorTask>();
+ auto task = std::move(task_pool_.back());
+ task_pool_.pop_back();
+ return task;
+}
+
+
+void TalshNodeExecutor::recycleTask(std::shared_ptr<talsh::TensorTask> & task)
+{
+ if(task && task.use_count() == 1 && task_pool_.size() < TASK_POOL_CAPACITY){
+  task->clean();
+  task_pool_.emplace_back(std::move(task));
  }
- return evicting;
+ task.reset();
+ return;
 }
 
 
 bool TalshNodeExecutor::tensorIsCurrentlyInUse(const talsh::Tensor * talsh_tens) const
 {
+ for(const auto & transfer: gpu_direct_transfers_){
+  if(transfer.second == talsh_tens) return true;
+ }
  for(const auto & task: evictions_){
   const auto num_task_args = task.second->getNumTensorArguments();
   for(unsigned int i = 0; i < num_task_args; ++i){
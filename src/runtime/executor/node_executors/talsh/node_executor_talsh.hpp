@@ -1,11 +1,268 @@
 /** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh
-REVISION: 2022/01/17
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
-
+ (a) Multi-GPU placement of tensor contractions: Unless disabled via the "talsh_device_placement"
+     runtime parameter ("cost_model" (default) or "talsh"), each tensor contraction (and its
+     operand prefetch) is placed on the NVIDIA GPU with the lowest estimated completion time,
+     which is the sum of the time to transfer its tensor operands not yet resident in the device
+     cache, the time to complete the work already queued on the device and the time to execute
+     the tensor contraction itself. GPUs without enough free memory for the non-resident
+     tensor operands are only chosen if no GPU has enough. With a single GPU, the placement
+     is left to TAL-SH (talsh::determineOptimalDevice).
+ (b) NUMA first touch of the Host buffer: If the "host_memory_numa_first_touch" runtime
+     parameter is set (non-zero), the pages of the TAL-SH Host buffer are touched right after
+     its allocation by all OpenMP threads with the static schedule, distributing the pages
+     across the NUMA domains of the bound OpenMP threads (OMP_PROC_BIND/OMP_PLACES), such that
+     the statically scheduled Host kernels touch mostly socket-local memory. This has no effect
+     on the pages already touched (or pinned) by TAL-SH during the buffer allocation.
+ (c) Small tensor contractions (Flop count not exceeding the "talsh_small_contraction_flops"
+     runtime parameter, DEFAULT_SMALL_CONTRACTION_FLOPS by default, 0 turns it off) whose tensor
+     operands are not resident on any accelerator are executed on Host, where they complete
+     upon submission, thus avoiding the accelerator launch, transfer and polling latency.
+ (d) Precision policy of tensor contractions (TensorOpPrecision): The mixed-precision fast math
+     of the accelerators is switched on/off before each tensor contraction as requested by its
+     precision policy. The DEFAULT policy follows activateFastMath(). The AUTO policy selects
+     the fast math if the error bound K * u * ||L|| * ||R|| does not exceed the tolerance carried
+     by the tensor contraction, where K is the contracted volume, u is the unit roundoff of
+     the reduced precision, and ||L||, ||R|| are the 2-norms of the input tensor operands,
+     which must reside on Host (otherwise the full precision is used).
+ (e) Tensor broadcast and allreduce are executed as pipelines of non-blocking MPI collectives
+     over ALLREDUCE_CHUNK_SIZE chunks of the tensor body (like tensor fetch/upload), which are
+     tracked by the execution handle, thus the DAG execution proceeds while they progress.
+     As with the blocking collectives, all MPI processes must issue them in the same order.
+ (f) Persistent MPI requests: If the "mpi_persistent_requests" runtime parameter is set (non-zero),
+     the MPI requests of tensor fetch/upload are created once (MPI_Recv_init/MPI_Send_init) for each
+     {tensor, remote rank, message tag, direction} and restarted (MPI_Start) by repeated transfers,
+     as long as the tensor body, its volume and the MPI communicator stay the same. The persistent
+     MPI requests are freed once the tensor is destroyed.
+ (g) Reduced-precision transfers: Broadcast/allreduce of a double-precision (real or complex)
+     tensor marked as tolerant to reduced-precision transfers (TensorOpBroadcast/TensorOpAllreduce
+     reducedPrecisionTransfer()) communicates its body in single precision, thus halving the
+     communication volume. The conversion of each ALLREDUCE_CHUNK_SIZE chunk overlaps with the
+     non-blocking collective on the previous chunk. Such a collective completes upon execution.
+ (h) Layout cache: TAL-SH contracts tensors via transpose-GEMM-transpose, such that an input tensor
+     repeatedly contracted over the same indices is repeatedly permuted. When the same input tensor
+     is contracted a second time with the same permutation, its permuted copy (contracted dimensions
+     leading, in the order of the left tensor, followed by the uncontracted dimensions in the order
+     of the destination tensor) is created in the spare Host buffer space and cached, keyed by
+     {tensor hash, permutation}, and the tensor contraction is redirected to the copy, whose layout
+     no longer requires the transpose. Cached copies are invalidated once their tensor is written
+     (executed as a mutable tensor operand) or destroyed. The cache size is limited by the
+     "talsh_layout_cache_size" runtime parameter (bytes, 0 turns it off), which defaults to
+     DEFAULT_LAYOUT_CACHE_FRACTION of the TAL-SH Host buffer, the least recently used idle copies
+     being dropped when the limit is reached.
+ (i) Spill tier: If the "host_memory_spill_directory" runtime parameter is set (e.g., a node-local
+     NVMe scratch directory), idle tensors (not less than SPILL_MIN_TENSOR_SIZE) which are not needed
+     within the current lookahead window of the DAG are spilled to files in that directory
+     once the Host buffer is exhausted, largest first. The tensor body is written asynchronously
+     and released from the Host buffer once the write has completed. A spilled tensor is brought
+     back asynchronously by prefetch() (or by resetLookahead() once it enters the lookahead window),
+     and synchronously by finishPrefetching() before its tensor operation is executed.
+     An access to a tensor being spilled cancels its spill.
+ (j) Randomized truncated SVD: A tensor decomposition (DECOMPOSE_SVD3/SVD2) in the randomized truncated
+     mode computes the k leading singular triplets, where k is the total extent of the bond indices,
+     by the randomized range finder: Y = D * G (G is a Gaussian sketch with RSVD_OVERSAMPLING extra
+     columns), followed by "talsh_rsvd_power_iterations" power iterations Y = D * (D+ * Q),
+     Q = orth(Y), B = Q+ * D, B = U * S * R, L = Q * U. The tensor contractions are executed
+     by TAL-SH on the optimal device (GPU if available), whereas only the small SVDs of Y and B
+     are executed on Host. The full SVD is used if the sketch is not smaller than the tensor.
+ (k) Tensor slicing/insertion (SLICE/INSERT) with both tensor operands resident on Host is executed
+     by the multi-threaded Host kernel: The leading dimensions covered by the slice in full together with
+     the first partially covered dimension form the innermost contiguous run (detected up front), which is
+     copied by a SIMD loop, whereas the runs are distributed across OpenMP threads in blocks of at least
+     SLICE_BLOCK_VOLUME elements (slices smaller than SLICE_PARALLEL_VOLUME are copied by a single thread).
+     Otherwise, the slicing/insertion is executed by TAL-SH on the device the tensor operands reside on.
+ (l) TAL-SH tasks of completed tensor operations, prefetches and evictions are cleaned and recycled
+     via a pool (up to TASK_POOL_CAPACITY tasks), and the hash tables of tensors and active tasks are
+     pre-sized (TABLE_RESERVE_SIZE), such that the steady-state execution does not allocate tasks
+     or rehash the tables.
+ (m) Known-zero tensors: The zero initialization of a tensor (TRANSFORM with FunctorInitVal(0))
+     does not write the tensor body but marks the tensor as known-zero. A tensor contraction
+     (or addition with the unit scalar) into a known-zero destination tensor overwrites it
+     (beta = 0) instead of accumulating into it. Any other access to a known-zero tensor
+     (tensor operation, tensor view, local tensor slice) writes the zeros into its Host body first.
+ (n) GPU binding: The "gpu_binding" runtime parameter selects the NVIDIA GPUs initialized by TAL-SH.
+     With "all" (default), each MPI process uses all visible GPUs of its compute node. With "node_local",
+     the GPUs of the compute node are partitioned among the node-local MPI processes ("node_process_rank"
+     and "node_num_processes" runtime parameters, supplied by the numerical server) in contiguous ranges
+     of GPU ids, such that GPUs adjacent in the node topology (NVLink/PCIe switch neighbors typically
+     have adjacent ids) serve the same process, and multiple processes share a GPU only if the node
+     has fewer GPUs than processes (consecutive node-local ranks share the same GPU).
+ (o) Execution device class of tensor contractions (TensorOpDevice): HOST contractions are executed
+     on Host regardless of their size, ACCELERATOR contractions bypass the small contraction shortcut (c)
+     and are placed on a GPU even if there is only one (multi-GPU placement as in (a)), whereas ANY
+     contractions follow (a) and (c). Without GPUs, all tensor contractions are executed on Host.
+ (p) GPU-direct transfers: If the "mpi_gpu_direct" runtime parameter is set (non-zero; requires
+     a CUDA-aware MPI library), tensor fetch/upload, broadcast and allreduce of a tensor whose
+     only body image resides on a GPU pass the device pointer to MPI directly, instead of moving
+     the tensor body back to Host (and later re-uploading it). The tensor image stays on the GPU
+     (it is not evicted) until the transfer completes. Reduced-precision transfers (g), external
+     tensor bodies and tensors with a Host image use the Host path.
+ (q) Lazy TAL-SH initialization: TAL-SH, together with its Host buffer ("host_memory_buffer_size")
+     and the GPU buffers, is only initialized upon the first tensor creation, such that short-lived
+     jobs do not pay for committing (pinning, first touch) the full buffers up front. Until then,
+     the requested Host buffer size is reported and the memory usage is zero. Setting the
+     "talsh_eager_init" runtime parameter (non-zero) initializes TAL-SH in initialize() instead.
+ (r) Backing of the Host buffer: The "host_memory_huge_pages" runtime parameter ("none" (default),
+     "2M" or "1G") replaces the pages of the (still unused) Host buffer allocated by TAL-SH with
+     explicit huge pages of the given size (huge-page aligned interior of the buffer, requires huge
+     pages reserved via /proc/sys/vm/nr_hugepages), falling back to the transparent huge pages,
+     thus reducing the TLB misses of the Host kernels (tensor transposes). The "host_memory_pinned"
+     runtime parameter (non-zero) registers the Host buffer as GPU pinned memory once upon TAL-SH
+     initialization (unless TAL-SH already pinned it), such that all Host-device transfers of tensor
+     bodies are direct DMA transfers. Both precede the NUMA first touch (b).
+ (s) Half-precision tensors (REAL16, COMPLEX16): TAL-SH has no half-precision data kind, thus such
+     tensors are held and computed in single precision (TAL-SH REAL32/COMPLEX32). Their contractions
+     default to the reduced-precision (tensor core) mode with single-precision accumulation (d), and
+     their broadcast/allreduce always communicate binary16 numbers (summed in single precision),
+     thus halving the communication volume as in (g).
+ (t) Device-side TRANSFORM: A TRANSFORM of a tensor whose only body image resides on a GPU is applied
+     in place on that GPU, without moving the tensor body to Host and back, if its tensor functor
+     implements numerics::DeviceTensorMethod (user device kernels) or is numerics::FunctorScale
+     (executed by cuBLAS). Otherwise, or if the device kernel declines, the Host apply() is used.
+ (u) Small tensor contraction kernels: Tensor contractions executed on Host (c,o) whose tensor operands
+     are of rank 4 at most and already reside on Host, without hyper indices and traces, and whose Flop
+     count does not exceed the "talsh_small_kernel_flops" runtime parameter (DEFAULT_SMALL_KERNEL_FLOPS
+     by default, 0 turns it off), are executed synchronously by the compile-time specialized Host
+     kernels (small_contraction_kernels.hpp) instead of TAL-SH, thus avoiding the operand transposes
+     and the task overhead of the generic path. The parsed index patterns are cached.
+ (v) Memory timeline: The tensor bodies allocated in the Host buffer by CREATE and freed by DESTROY
+     are tracked by the memory timeline (memory_timeline.hpp) with the DAG node id of the CREATE/DESTROY
+     operation, which always tracks the high-water mark of the tensor memory. Recording of the
+     allocation/free events is activated by the "talsh_memory_timeline" runtime parameter (0:off, 1:on),
+     with the event buffer capacity set by the "talsh_memory_timeline_capacity" runtime parameter.
+     Tensors with external bodies are not tracked, as in the executor memory usage. Tensor body images
+     cached on accelerators are not attributed (they are evicted on demand).
+ (w) Communication profile: The tensor communication operations (FETCH, UPLOAD, BROADCAST, ALLREDUCE)
+     are recorded in the process-wide communication profile (comm_profile.hpp), if active, upon
+     their completion, with their payload volume and their duration from issue to completion.
+ (x) Donated tensor operands (last use, see TensorOperation): A donated input tensor of a tensor
+     contraction never enters the layout cache (h), since it is destroyed right after. An addition
+     with the unit scalar of a donated Host-resident input tensor into a known-zero destination
+     tensor (m) of the same shape without index permutation (plain copy) aliases the destination
+     to the body of the donated tensor (the two TAL-SH tensors are swapped), such that no copy
+     is made and the subsequent DESTROY of the donated tensor frees the unused destination body.
+ (y) Lazy copies (copy-on-write): Any other plain copy (x) into a known-zero destination tensor,
+     for example issued by NumServer::copyTensor or NumServer::duplicateSync, is deferred:
+     The destination tensor is recorded as a lazy copy of the source tensor and no data
+     is moved until either of the two tensors is accessed by a subsequent tensor operation
+     (or a tensor view). The source tensor body is copied into the lazy copy right before
+     the lazy copy is accessed or the source tensor is written. A lazy copy destroyed
+     or reinitialized before being accessed is never copied, whereas a source tensor
+     destroyed or reinitialized first hands its body over to one of its lazy copies.
+     The destination tensor body is still allocated upon its creation.
+ (z) Tensor slice views: A read-only tensor slice (an input tensor slice extracted by
+     the sliced tensor network evaluation) which is a contiguous block of its parental
+     tensor (column-major storage: full leading dimensions, at most one partial dimension,
+     trailing dimensions of extent 1 in the slice) does not copy the data: Its body
+     is replaced with a non-owning view of the parental tensor body, which the
+     subsequent tensor contractions read directly. The tensor slice view is detached
+     (gets its own copy of the data) before either the tensor slice or its parental
+     tensor is written or the parental tensor is destroyed. The parental tensor body
+     is neither spilled nor swapped while being viewed. TAL-SH tensor slices cannot
+     be strided, and TAL-SH may move the tensor body images to accelerators,
+     thus tensor slice views are only used without GPU.
+ (aa) Autotuning of tensor contractions: If the "talsh_autotune_database" runtime parameter
+     (file path) is set, the execution strategy of frequently executed tensor contractions
+     (seen "talsh_autotune_threshold" times) is tuned per key {reduced index pattern, operand
+     shapes, element type, number of GPUs} by the contraction autotuner (contract_autotuner.hpp):
+     Small kernels on Host (direct), TAL-SH on Host (TTGT) with or without the layout cache
+     (pre-permuted operands), TAL-SH on GPU. The tuned strategies are stored in the database
+     and loaded upon initialization. Only tensor contractions without a device restriction are
+     tuned. The internal tiling of the TAL-SH kernels is not exposed, thus it is not tuned.
+ (bb) Direct tensor contractions: The "talsh_direct_contraction" runtime parameter (0: off (default),
+     1: bandwidth-bound, 2: all) executes the tensor contractions bound to Host, whose tensor operands
+     reside on Host, by the transpose-free direct kernels (direct_contraction_kernels.hpp) instead of
+     TAL-SH (TTGT): Either only the bandwidth-bound ones (Flop count per tensor element not exceeding
+     DIRECT_CONTRACTION_INTENSITY), or all of them. The direct kernels pack bounded micro-panels
+     straight from the strided tensor operands, thus no transposed operand copies are allocated.
+     In the latter mode without GPU, the tensor contraction memory factor reported to the slicing
+     heuristic is 1.0 instead of 2.0 (no room for the transposed copies is needed). The direct
+     kernels are also a candidate strategy of the contraction autotuner (aa). The parsed index
+     patterns are cached.
+ (cc) Host tensor transposes: The tensor permutations executed on Host, namely ADD (copy/accumulation
+     of a permuted tensor) with both tensor bodies on Host and the permuted operand copies of the
+     layout cache (p), are executed synchronously by the cache-blocked, OpenMP-parallel transpose
+     kernels (tensor_transpose_kernels.hpp) instead of TAL-SH. The transpose plans are cached per
+     {tensor shape, permutation} (up to TRANSPOSE_PLAN_CACHE_SIZE plans, then the cache is reset).
+     The "talsh_host_transpose" runtime parameter (0) switches them off. The operand transposes
+     inside the TAL-SH tensor contractions (TTGT) are internal to TAL-SH (see (bb) instead).
+ (dd) 3M (Gauss) complex tensor contractions: If the "talsh_gauss_contraction_flops" runtime parameter
+     is positive, complex tensor contractions (COMPLEX32/COMPLEX64) with at least that Flop count,
+     whose tensor operands reside on Host, are executed as three real tensor contractions by TAL-SH:
+     With L=A+iB and R=C+iD, T1=A*C, T2=B*D, T3=(A+B)*(C+D), the result is D+=alpha*(T1-T2+i(T3-T1-T2)),
+     thus 3 instead of 4 real multiplications per complex FMA (25% fewer Flops). The real/imaginary
+     parts are split into (and the result combined from) temporary real tensors on Host, which must
+     fit into the spare Host buffer, otherwise the regular complex tensor contraction is executed.
+     The 3M algorithm is less accurate (in the imaginary part), thus the precision policy of the
+     tensor contraction decides: FULL disables it, AUTO only allows it if its estimated absolute
+     error bound, GAUSS_ERROR_FACTOR * K * u * ||L|| * ||R||, stays within the tolerance (K:
+     contracted volume, u: unit roundoff of the element type), DEFAULT and REDUCED allow it.
+     The real tensor contractions are executed synchronously (on any device chosen by TAL-SH).
+ (ee) Launch sequence replay: If the "talsh_launch_replay" runtime parameter is set (non-zero),
+     the sequence of tensor contractions launched by TAL-SH off the small contraction shortcut (c)
+     between two synchronization points of the node executor (sync()) is recorded with the shape
+     signature and the execution device of each tensor contraction (launch_sequence.hpp). Once
+     the sequence recurs (identical signatures), its next occurrences replay the recorded execution
+     devices instead of evaluating the placement cost model (a) for each tensor contraction, which also
+     keeps the tensor operands of the recurring sequence on the same accelerators (device cache reuse).
+     The replay stops at the first deviating tensor contraction. TAL-SH launches its kernels on its
+     own CUDA streams, thus the launches themselves cannot be captured into a CUDA graph here.
+ (ff) Shared device memory: The TAL-SH device buffer of each GPU is registered with the process-wide
+     device memory manager (device_memory.hpp), from which the cuQuantum executor leases it while
+     it executes whole tensor networks, instead of statically partitioning the device memory.
+     clearCache(), which precedes the lease, completes the eviction of the cached tensor images
+     and records the device memory ranges still occupied by the tensor images left on the GPUs
+     (e.g., tensors computed on a GPU), such that they are preserved. getTensorImage() returns
+     such a GPU-resident tensor image without any transfer, thus it can be used in place (zero copy).
+ (gg) AMD GPUs: The direct GPU runtime calls of the node executor (device selection, Host buffer pinning,
+     in-place scaling on the device) go through a portability layer (gpu_runtime.hpp), which maps them
+     onto CUDA/cuBLAS or, in the HIP build (ENABLE_HIP, EXATN_HIP), onto HIP/hipBLAS. The HIP build links
+     against a HIP build of TAL-SH, which exposes the AMD GPUs as DEV_NVIDIA_GPU devices with their own
+     device buffers and streams, thus the placement (a), prefetch and eviction logic applies unchanged.
+ (hh) Early receives of tensor fetches: A FETCH (remote subtensor of a composite tensor) passed for prefetching
+     by the graph executor, whose destination tensor typically does not exist yet, posts its receive ahead
+     of time into a staging Host tensor, as long as the staging tensors fit into the reserved buffer space
+     (DEFAULT_REMOTE_PREFETCH_FRACTION of the Host buffer, or the "talsh_remote_prefetch_size" runtime
+     parameter in bytes, 0 turns it off) and into the spare Host buffer. Once the FETCH is executed,
+     the received body is copied from the staging tensor into the destination tensor (TRY_LATER until
+     the early receive completes). At most one early receive per message signature {communicator,
+     remote rank, message tag} is in flight. Messages of the same signature are matched in their issue
+     order, thus a FETCH executed while an early receive of another FETCH with its signature is in flight
+     cancels that early receive, or adopts it if it has already received the message.
+ (ii) Compression tier: If the "host_memory_compression" runtime parameter is set to COMPRESSION_LOSSLESS
+     or COMPRESSION_LOSSY, the cold tensors chosen by the spill tier (i) are compressed in memory (outside
+     of the Host buffer) by the tensor body codec (tensor_body_codec.hpp) instead of being written
+     to the scratch directory, and they are decompressed transparently upon restoration (i).
+     The lossy mode is error-bounded: Each real word is reproduced within the absolute tolerance
+     given by the "host_memory_compression_tolerance" runtime parameter (the lossless mode is used
+     if it is not positive). A tensor body which does not compress below COMPRESSION_MAX_RATIO
+     of its size is written to the scratch directory instead, if set, otherwise it stays resident.
+ (jj) Contraction descriptors: The Host kernels of tensor contractions (small (u) and direct (bb))
+     are driven by precompiled contraction descriptors (loop extents/strides, offset tables
+     of the grouped dimensions), which are cached per {reduced index pattern, tensor operand shapes}
+     (up to CONTRACTION_PLAN_CACHE_SIZE descriptors per kernel kind, then the cache is reset),
+     thus a recurring tensor contraction is neither re-parsed nor re-planned. The reduced index
+     patterns themselves are memoized by the tensor operation. TAL-SH tensor contractions
+     are still specified by the (interned) index pattern strings as required by the TAL-SH API.
+ (kk) Hot reconfiguration: A node executor handed over to a new runtime configuration
+     (TensorRuntime::reconfigure) is initialized again with the new runtime parameters:
+     It keeps its tensor bodies and caches (layouts, prefetches, contraction descriptors,
+     autotuning records) and only re-reads its tunable parameters. A changed Host buffer size
+     ("host_memory_buffer_size") takes effect in place as long as TAL-SH has not been initialized
+     yet (see rationale (q)), otherwise the committed TAL-SH buffers cannot be relocated
+     and the current Host buffer size is retained.
+ (ll) Scaled accumulation: TAL-SH tensor contractions only accumulate into or overwrite
+     the destination tensor, thus a tensor contraction with a beta prefactor other than 0 and 1
+     scales its destination tensor on Host first. The tensor operation itself is never altered
+     (it may be shared and resubmitted): A tensor contraction postponed (TRY_LATER) after
+     its destination tensor has been scaled is remembered by the executor, such that its retry
+     does not scale the destination tensor again. A complex beta prefactor cannot scale
+     a real destination tensor and is rejected.
 **/
 
 #ifndef EXATN_RUNTIME_TALSH_NODE_EXECUTOR_HPP_
@@ -15,11 +272,29 @@ Rationale:
 
 #include "talshxx.hpp"
 
+#include "small_contraction_kernels.hpp"
+#include "direct_contraction_kernels.hpp"
+#include "tensor_transpose_kernels.hpp"
+#include "tensor_body_codec.hpp"
+
+#include "mpi_proxy.hpp"
+#include "comm_profile.hpp"
+#include "device_memory.hpp"
+#include "thread_topology.hpp"
+#include "contract_autotuner.hpp"
+#include "launch_sequence.hpp"
+
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <tuple>
+#include <future>
+#include <string>
 #include <vector>
 #include <list>
 #include <memory>
 #include <atomic>
+#include <mutex>
 
 namespace exatn {
 namespace runtime {
@@ -29,9 +304,54 @@ class TalshNodeExecutor : public TensorNodeExecutor {
 public:
 
   static constexpr const std::size_t DEFAULT_MEM_BUFFER_SIZE = 2UL * 1024UL * 1024UL * 1024UL; //bytes
-  static constexpr const int ALLREDUCE_CHUNK_SIZE = 64 * 1024 * 1024; //elements
+  static constexpr const int ALLREDUCE_CHUNK_SIZE = 64 * 1024 * 1024; //elements per pipelined chunk of non-blocking collectives
+  static constexpr const double PLACEMENT_TRANSFER_BANDWIDTH = 12e9; //Host-to-device bandwidth assumed by the placement cost model (bytes/sec)
+  static constexpr const double PLACEMENT_DEVICE_FLOPS = 7e12;       //device throughput assumed by the placement cost model (flop/sec)
+  static constexpr const std::size_t NUMA_PAGE_SIZE = 4096;          //memory page size assumed by the NUMA first touch (bytes)
+  static constexpr const std::size_t HUGE_PAGE_SIZE_2M = 2UL * 1024UL * 1024UL;          //2 MB huge page size (bytes)
+  static constexpr const std::size_t HUGE_PAGE_SIZE_1G = 1024UL * 1024UL * 1024UL;        //1 GB huge page size (bytes)
+  static constexpr const double DEFAULT_SMALL_CONTRACTION_FLOPS = 16777216.0; //max Flop count of a small tensor contraction executed on Host
+  static constexpr const double DEFAULT_SMALL_KERNEL_FLOPS = 1048576.0; //max Flop count of a tensor contraction executed by the small kernels
+  static constexpr const double REDUCED_PRECISION_UNIT_ROUNDOFF = 4.8828125e-4;  //unit roundoff of the fast math (TF32/FP16: 2^-11)
+  static constexpr const double DEFAULT_LAYOUT_CACHE_FRACTION = 0.125; //default fraction of the Host buffer used by the layout cache
+  static constexpr const double DEFAULT_REMOTE_PREFETCH_FRACTION = 0.0625; //default fraction of the Host buffer reserved for early receives (hh)
+  static constexpr const std::size_t SPILL_MIN_TENSOR_SIZE = 1024UL * 1024UL; //min size of a tensor spilled to the scratch directory (bytes)
+  static constexpr const int COMPRESSION_OFF = 0;      //compression tier (ii): Off
+  static constexpr const int COMPRESSION_LOSSLESS = 1; //compression tier (ii): Lossless
+  static constexpr const int COMPRESSION_LOSSY = 2;    //compression tier (ii): Error-bounded lossy
+  static constexpr const double COMPRESSION_MAX_RATIO = 0.75; //max compressed/original size ratio of a tensor body kept compressed
+  static constexpr const std::size_t RSVD_OVERSAMPLING = 8;     //oversampling of the randomized range finder (extra sketch columns)
+  static constexpr const int DEFAULT_RSVD_POWER_ITERATIONS = 1; //default number of power iterations of the randomized range finder
+  static constexpr const std::size_t SLICE_BLOCK_VOLUME = 4096;      //min number of elements in a block of contiguous runs copied by a thread
+  static constexpr const std::size_t SLICE_PARALLEL_VOLUME = 65536;  //min slice volume copied by multiple threads
+  static constexpr const std::size_t TASK_POOL_CAPACITY = 1024;      //max number of recycled TAL-SH tasks kept in the pool
+  static constexpr const std::size_t TABLE_RESERVE_SIZE = 4096;      //initial capacity of the tensor and task hash tables
+  static constexpr const int CONTRACT_HOST_DIRECT = 0;      //tensor contraction strategy: Small kernels on Host
+  static constexpr const int CONTRACT_HOST_TTGT = 1;        //tensor contraction strategy: TAL-SH on Host
+  static constexpr const int CONTRACT_HOST_LAYOUT = 2;      //tensor contraction strategy: TAL-SH on Host with the layout cache
+  static constexpr const int CONTRACT_ACCELERATOR = 3;      //tensor contraction strategy: TAL-SH on GPU
+  static constexpr const int CONTRACT_HOST_PACKED = 4;      //tensor contraction strategy: Direct kernels on Host
+  static constexpr const int DIRECT_CONTRACTION_OFF = 0;            //direct tensor contractions: Off
+  static constexpr const int DIRECT_CONTRACTION_BANDWIDTH_BOUND = 1; //direct tensor contractions: Bandwidth-bound only
+  static constexpr const int DIRECT_CONTRACTION_ALL = 2;            //direct tensor contractions: All tensor contractions on Host
+  static constexpr const double DIRECT_CONTRACTION_INTENSITY = 16.0; //max Flop count per tensor element of a bandwidth-bound tensor contraction
+  static constexpr const std::size_t TRANSPOSE_PLAN_CACHE_SIZE = 1024; //max number of cached Host tensor transpose plans
+  static constexpr const std::size_t CONTRACTION_PLAN_CACHE_SIZE = 1024; //max number of cached contraction descriptors per kernel kind
+  static constexpr const double GAUSS_ERROR_FACTOR = 4.0;   //error amplification of the 3M complex multiplication (vs. conventional)
 
-  TalshNodeExecutor(): max_tensor_rank_(-1), prefetch_enabled_(true), dry_run_(false) {}
+  TalshNodeExecutor(): pinned_(std::make_shared<PinRegistry>()),
+                       layout_cache_limit_(0), layout_cache_bytes_(0),
+                       remote_prefetch_limit_(0), remote_prefetch_bytes_(0),
+                       compression_mode_(COMPRESSION_OFF), compression_tolerance_(0.0),
+                       rsvd_power_iterations_(DEFAULT_RSVD_POWER_ITERATIONS),
+                       max_tensor_rank_(-1), prefetch_enabled_(true), dry_run_(false),
+                       placement_cost_model_(true), small_contraction_flops_(DEFAULT_SMALL_CONTRACTION_FLOPS),
+                       small_kernel_flops_(DEFAULT_SMALL_KERNEL_FLOPS), direct_contraction_(DIRECT_CONTRACTION_OFF),
+                       host_transpose_(true), gauss_contraction_flops_(0.0),
+                       persistent_requests_(false), gpu_direct_(false), exec_initialized_(false)
+  {
+    for(auto & queued_flops: device_queued_flops_) queued_flops.store(0.0);
+  }
 
   TalshNodeExecutor(const TalshNodeExecutor &) = delete;
   TalshNodeExecutor & operator=(const TalshNodeExecutor &) = delete;
@@ -52,6 +372,15 @@ public:
 
   double getTotalFlopCount() const override;
 
+  void getTransferVolume(std::size_t * host_to_device,
+                         std::size_t * device_to_host) const override;
+
+  std::size_t getTensorMemoryUsage() const override;
+
+  MemoryTimeline * getMemoryTimeline() override {return &memory_timeline_;}
+
+  double getContractionMemoryFactor() const override;
+
   int execute(numerics::TensorOpCreate & op,
               TensorOpExecHandle * exec_handle) override;
   int execute(numerics::TensorOpDestroy & op,
@@ -89,18 +418,35 @@ public:
 
   bool sync() override;
 
+  int getExecutionDevice(TensorOpExecHandle op_handle) const override;
+
+  bool getDeviceLoad(int device,
+                     double * queued_flops,
+                     std::size_t * free_mem) const override;
+
   bool discard(TensorOpExecHandle op_handle) override;
 
   bool prefetch(const numerics::TensorOperation & op) override;
 
+  /** Evicts all idle cached tensor images from accelerators (completing the evictions) and records
+      the device memory still occupied by the remaining tensor images with the device memory manager. **/
   void clearCache() override;
 
+  /** Resets the lookahead window of tensor operands of the upcoming tensor operations,
+      which is used for choosing the cached tensor images to evict from accelerators. **/
+  void resetLookahead(const std::vector<numerics::TensorHashType> & upcoming) override;
+
   /** Returns a locally stored slice copy of a tensor, or nullptr if no RAM. **/
   std::shared_ptr<talsh::Tensor> getLocalTensor(const numerics::Tensor & tensor,
                  const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec) override;
 
+  /** Returns a read-only zero-copy view of the local tensor body in the Host buffer,
+      pinning the tensor until the view is released. **/
+  TensorView getTensorView(const numerics::Tensor & tensor) override;
+
   /** Returns a non-owning pointer to a local tensor data image on a given device.
-      If unsuccessful, returns nullptr. **/
+      A Host image is synchronized (created, if needed), whereas an accelerator image
+      is only returned if it already resides there. If unsuccessful, returns nullptr. **/
   void * getTensorImage(const numerics::Tensor & tensor,        //in: tensor
                         int device_kind,                        //in: device kind (implementation specific)
                         int device_id,                          //in: device id: [0,1,2,..]
@@ -113,7 +459,9 @@ public:
   void cacheMovedTensors(talsh::TensorTask & talsh_task); //in: TAL-SH task associated with the tensor operation
 
   /** Evicts some or all idle cached TAL-SH tensor body images
-      from accelerator(s), moving them back to Host. On return,
+      from accelerator(s), moving them back to Host. The tensor images
+      which are needed the latest within the lookahead window (or not needed
+      at all) are evicted first, the least recently used first among those. On return,
       returns whether at least one such tensor image has been found. **/
   bool evictMovedTensors(int device_id = DEV_DEFAULT,     //in: flat device id (TAL-SH numeration), DEV_DEFAULT covers all accelerators, DEV_HOST has no effect
                          std::size_t required_space = 0); //in: required space to free in bytes, 0 will evict all idle tensor images on the chosen device(s)
@@ -124,10 +472,384 @@ public:
 
 protected:
 
+  /** Starts a tensor transfer (fetch/upload) via cached persistent MPI requests, creating them
+      if needed, and appends the started MPI requests to the given list. Returns FALSE if
+      the persistent MPI requests are still in flight (the transfer is then not started). **/
+  bool startPersistentTransfer(numerics::TensorHashType tensor_hash,  //in: tensor hash
+                               void * body,                           //in: tensor body
+                               std::size_t volume,                    //in: tensor volume
+                               int talsh_data_kind,                   //in: TAL-SH data kind
+                               int remote_rank,                       //in: remote MPI process rank
+                               int mesg_tag,                          //in: MPI message tag
+                               const MPICommProxy & communicator,     //in: MPI communicator
+                               bool send,                             //in: TRUE for upload, FALSE for fetch
+                               std::list<void*> & requests,           //inout: MPI requests of the tensor operation
+                               int * error_code);                     //out: MPI error code
+
+  /** Frees the cached persistent MPI requests of a given tensor (all, if nullptr). **/
+  void freePersistentTransfers(const numerics::TensorHashType * tensor_hash = nullptr);
+
+  /** Posts the early receive of a tensor fetch into a staging tensor (hh).
+      Returns TRUE if the early receive of the tensor fetch is in flight. **/
+  bool postEarlyReceive(const numerics::TensorOperation & op); //in: FETCH tensor operation
+
+  /** Completes the early receive of a tensor fetch (hh), if any, by copying the received body
+      into the destination tensor. Returns FALSE if the early receive is still in flight. **/
+  bool completeEarlyReceive(const numerics::TensorOperation & op, //in: FETCH tensor operation
+                            talsh::Tensor & tens,                 //inout: destination TAL-SH tensor
+                            bool * received);                     //out: TRUE if the tensor body has been received
+
+  /** Cancels all early receives of tensor fetches (hh), releasing their staging tensors. **/
+  void cancelEarlyReceives();
+
+  /** Returns the device body of a tensor whose only image resides on an accelerator
+      (nullptr if GPU-direct transfers are off or the tensor has a Host image). **/
+  void * getDeviceResidentBody(talsh::Tensor & tens, //in: TAL-SH tensor
+                               int * device);        //out: flat device id of the tensor image
+
+  /** Returns the device body of a tensor whose only image resides on an accelerator
+      (nullptr if the tensor has a Host image or an external body). **/
+  void * getDeviceOnlyBody(talsh::Tensor & tens, //in: TAL-SH tensor
+                           int * device);        //out: flat device id of the tensor image
+
+  /** Records the device memory ranges occupied by the tensor images residing on the GPUs
+      with the device memory manager (they are preserved while the device buffers are leased). **/
+  void retainResidentImages();
+
+  /** Applies the tensor functor of a TRANSFORM in place to the device-resident tensor body.
+      Returns numerics::DeviceTensorMethod::DEVICE_UNSUPPORTED if the functor has no device implementation. **/
+  int applyOnDevice(numerics::TensorOpTransform & op, //in: TRANSFORM tensor operation
+                    talsh::Tensor & tens,             //in: TAL-SH tensor
+                    void * device_body,               //inout: device-resident tensor body
+                    int device);                      //in: flat device id of the tensor image
+
+  /** Starts recording a tensor communication operation in the communication profile (if active). **/
+  void beginCommRecord(TensorOpExecHandle op_handle,        //in: tensor operation handle
+                       CommProfile::CommKind kind,          //in: communication kind
+                       const MPICommProxy & communicator,   //in: MPI communicator
+                       int peer,                            //in: remote rank (FETCH/UPLOAD) or root rank (negative: allreduce)
+                       std::size_t bytes);                  //in: payload volume (bytes)
+
+  /** Records a completed tensor communication operation in the communication profile (if started). **/
+  void endCommRecord(TensorOpExecHandle op_handle);          //in: tensor operation handle
+
+  /** Posts the non-blocking MPI transfer (FETCH, UPLOAD, BROADCAST, ALLREDUCE)
+      of a device-resident tensor body, appending the MPI requests to the given list. **/
+  int postDeviceTransfer(TensorOpCode opcode,      //in: tensor operation code
+                         void * body,                        //in: device-resident tensor body
+                         std::size_t volume,                 //in: tensor volume
+                         int talsh_data_kind,                //in: TAL-SH data kind
+                         int rank,                           //in: remote rank (FETCH/UPLOAD) or root rank (negative: allreduce)
+                         int mesg_tag,                       //in: MPI message tag (FETCH/UPLOAD)
+                         const MPICommProxy & communicator,  //in: MPI communicator
+                         std::list<void*> & requests);       //inout: MPI requests of the tensor operation
+
+  /** Initializes TAL-SH with the configured Host buffer size and GPU binding
+      (the TAL-SH initialization lock must be held). **/
+  static void initializeTalsh();
+
+  /** Initializes TAL-SH unless already initialized (see rationale (q)). **/
+  static void commitTalsh();
+
+  /** Backs the TAL-SH Host buffer with huge pages of the given size (see rationale (r)). **/
+  static void adviseHugePages(std::size_t buffer_size,  //in: Host buffer size (bytes)
+                              std::size_t page_size);   //in: huge page size (bytes)
+
+  /** Registers the TAL-SH Host buffer as GPU pinned memory, returns TRUE
+      if registered here (FALSE if already pinned or pinning is impossible). **/
+  static bool pinHostBuffer(std::size_t buffer_size); //in: Host buffer size (bytes)
+
+  /** Unregisters the TAL-SH Host buffer registered by pinHostBuffer(). **/
+  static void unpinHostBuffer();
+
+  /** Touches all pages of the TAL-SH Host buffer by all OpenMP threads (NUMA first touch). **/
+  static void firstTouchHostBuffer(std::size_t buffer_size); //in: Host buffer size (bytes)
+
+  /** Returns the ids of the NVIDIA GPUs bound to a given node-local process
+      (contiguous range of GPU ids, see rationale (n)). **/
+  static std::vector<int> bindNodeLocalGPUs(int num_gpus,             //in: number of GPUs on the compute node
+                                            int node_process_rank,    //in: node-local process rank
+                                            int node_num_processes);  //in: number of processes on the compute node
+
+  /** Selects the accelerator for executing a tensor operation with given TAL-SH tensor operands
+      and Flop count using the placement cost model. Returns the flat device id (TAL-SH numeration),
+      or DEV_DEFAULT if the placement is left to TAL-SH. **/
+  int selectExecutionDevice(const std::vector<const talsh::Tensor*> & operands, //in: TAL-SH tensor operands
+                            double flops) const;                                //in: Flop count
+
+  /** Returns TRUE if a tensor contraction with given TAL-SH tensor operands
+      is to be executed with reduced precision according to its precision policy. **/
+  bool reducedPrecision(const numerics::TensorOperation & op, //in: tensor contraction
+                        const talsh::Tensor & dest,           //in: destination TAL-SH tensor
+                        const talsh::Tensor & left,           //in: left TAL-SH tensor
+                        const talsh::Tensor & right) const;   //in: right TAL-SH tensor
+
+  /** Switches the mixed-precision fast math of the accelerators on/off
+      (the active state is only updated if TAL-SH has switched it). **/
+  static void switchFastMath(bool fast_math);
+
+  /** Returns TRUE if a tensor contraction with given TAL-SH tensor operands
+      and Flop count is small enough to be executed on Host. **/
+  bool isSmallContraction(const std::vector<const talsh::Tensor*> & operands, //in: TAL-SH tensor operands
+                          double flops) const;                                //in: Flop count
+
+  /** Executes a tensor contraction after its destination tensor has been scaled by beta (ll). **/
+  int executeContraction(numerics::TensorOpContract & op,
+                         TensorOpExecHandle * exec_handle);
+
+  /** Executes a small tensor contraction on Host by the specialized small kernels (u).
+      Returns FALSE if the small kernels are not applicable. **/
+  bool executeSmallContraction(const numerics::TensorOpContract & op, //in: tensor contraction
+                               talsh::Tensor & dest,                  //inout: destination TAL-SH tensor
+                               talsh::Tensor & left,                  //in: left TAL-SH tensor
+                               talsh::Tensor & right,                 //in: right TAL-SH tensor
+                               double flops);                         //in: Flop count
+
+  /** Executes a tensor contraction on Host by the transpose-free direct kernels (bb), unless it is not
+      bandwidth-bound in the bandwidth-bound mode (forced: regardless of the mode). Returns FALSE
+      if the direct kernels are not applicable. **/
+  bool executeDirectContraction(const numerics::TensorOpContract & op, //in: tensor contraction
+                                talsh::Tensor & dest,                  //inout: destination TAL-SH tensor
+                                talsh::Tensor & left,                  //in: left TAL-SH tensor
+                                talsh::Tensor & right,                 //in: right TAL-SH tensor
+                                double flops,                          //in: Flop count
+                                bool forced = false);                  //in: whether to ignore the direct contraction mode
+
+  /** Returns the cached contraction descriptor (jj) of the small kernels for a tensor contraction
+      pattern applied to given TAL-SH tensors, or nullptr if the small kernels are not applicable. **/
+  const SmallContractionLoops * getSmallContractionPlan(const std::string & pattern,        //in: reduced tensor contraction pattern
+                                                        const SmallContractionPattern & positions, //in: parsed index positions
+                                                        const talsh::Tensor & dest,          //in: destination TAL-SH tensor
+                                                        const talsh::Tensor & left,          //in: left TAL-SH tensor
+                                                        const talsh::Tensor & right);        //in: right TAL-SH tensor
+
+  /** Returns the cached contraction descriptor (jj) of the direct kernels for a tensor contraction
+      pattern applied to given TAL-SH tensors, or nullptr if the direct kernels are not applicable. **/
+  const DirectContractionPlan * getDirectContractionPlan(const std::string & pattern,         //in: reduced tensor contraction pattern
+                                                         const DirectContractionPattern & positions, //in: parsed index positions
+                                                         const talsh::Tensor & dest,           //in: destination TAL-SH tensor
+                                                         const talsh::Tensor & left,           //in: left TAL-SH tensor
+                                                         const talsh::Tensor & right);         //in: right TAL-SH tensor
+
+  /** Returns the cached Host transpose plan (cc) of a tensor permutation pattern D(...)=S(...)
+      applied to a given TAL-SH tensor, or nullptr if it is not a pure dimension permutation. **/
+  const TensorTransposePlan * getTransposePlan(const std::string & pattern, //in: tensor permutation pattern
+                                               const talsh::Tensor & src,   //in: source TAL-SH tensor
+                                               bool * conj);                //out: complex conjugation of the source tensor
+
+  /** Executes a tensor addition (copy/accumulation of a permuted tensor) on Host
+      by the tensor transpose kernels (cc). Returns FALSE if they are not applicable. **/
+  bool executeHostTranspose(const numerics::TensorOpAdd & op, //in: tensor addition
+                            talsh::Tensor & dest,             //inout: destination TAL-SH tensor
+                            talsh::Tensor & src);             //in: source TAL-SH tensor
+
+  /** Returns TRUE if a complex tensor contraction with given TAL-SH tensor operands and Flop count
+      is to be executed by the 3M (Gauss) algorithm according to its precision policy (dd). **/
+  bool gaussContraction(const numerics::TensorOpContract & op, //in: tensor contraction
+                        const talsh::Tensor & dest,            //in: destination TAL-SH tensor
+                        const talsh::Tensor & left,            //in: left TAL-SH tensor
+                        const talsh::Tensor & right,           //in: right TAL-SH tensor
+                        double flops) const;                   //in: Flop count
+
+  /** Executes a complex tensor contraction as three real tensor contractions (3M algorithm) (dd).
+      Returns FALSE if it is not applicable or failed (the destination tensor is then intact). **/
+  bool executeGaussContraction(const numerics::TensorOpContract & op, //in: tensor contraction
+                               talsh::Tensor & dest,                  //inout: destination TAL-SH tensor
+                               talsh::Tensor & left,                  //in: left TAL-SH tensor
+                               talsh::Tensor & right,                 //in: right TAL-SH tensor
+                               double flops,                          //in: Flop count
+                               bool host);                            //in: whether to execute on Host
+
+  /** Returns the autotuning key of a tensor contraction (aa). **/
+  std::string contractionTuningKey(const numerics::TensorOpContract & op, //in: tensor contraction
+                                   const talsh::Tensor & dest,            //in: destination TAL-SH tensor
+                                   const talsh::Tensor & left,            //in: left TAL-SH tensor
+                                   const talsh::Tensor & right) const;    //in: right TAL-SH tensor
+
+  /** Returns the candidate execution strategies of a tensor contraction with a given Flop count (aa). **/
+  std::vector<int> contractionStrategies(double flops) const;
+
+  /** Completes the autotuning trial of a finished tensor contraction (if any). **/
+  void finishTuningTrial(TensorOpExecHandle op_handle, //in: tensor operation handle
+                         bool success);                //in: whether the tensor contraction succeeded
+
+  /** Returns the launch signature (shape hash) of a tensor contraction (ee). **/
+  std::size_t contractionSignature(const numerics::TensorOpContract & op,
+                                   const talsh::Tensor & dest,
+                                   const talsh::Tensor & left,
+                                   const talsh::Tensor & right) const;
+
+  /** Registers/releases the work of a tensor operation placed on an accelerator. **/
+  void registerPlacement(TensorOpExecHandle op_handle, int device, double flops);
+  void releasePlacement(TensorOpExecHandle op_handle);
+
+  /** Redirects the input tensor operands of a tensor contraction to their cached permuted copies
+      (layout cache), creating the copies upon repeated use. Returns the (rewritten) reduced index
+      pattern of the tensor contraction and appends the used permuted copies to the given list. **/
+  std::string applyLayoutCache(const numerics::TensorOperation & op,                //in: tensor contraction
+                               talsh::Tensor ** left,                               //inout: left TAL-SH tensor
+                               talsh::Tensor ** right,                              //inout: right TAL-SH tensor
+                               std::vector<std::shared_ptr<talsh::Tensor>> & used); //out: used permuted copies
+
+  /** Returns the cached permuted copy of a TAL-SH tensor, creating it upon repeated use,
+      or nullptr if it is not (yet) cached. **/
+  std::shared_ptr<talsh::Tensor> getLayoutCopy(numerics::TensorHashType tensor_hash, //in: tensor hash
+                                               talsh::Tensor & tens,                 //in: TAL-SH tensor
+                                               const std::vector<int> & permutation, //in: permutation: copy dimension --> tensor dimension
+                                               const std::string & pattern);         //in: permutation pattern
+
+  /** Frees the layout cache space of a given size by dropping least recently used idle copies.
+      Returns FALSE if the space cannot be freed. **/
+  bool reserveLayoutCache(std::size_t size);
+
+  /** Invalidates the cached permuted copies of the mutable tensor operands of a tensor operation. **/
+  void invalidateLayouts(const numerics::TensorOperation & op);
+
+  /** Invalidates the cached permuted copies of a given tensor (all, if nullptr). **/
+  void invalidateLayouts(const numerics::TensorHashType * tensor_hash = nullptr);
+
+  /** Releases a reference to a permuted copy, unregistering the copy from the accelerator
+      caches once it is no longer referenced anywhere else. **/
+  void releaseLayoutTensor(std::shared_ptr<talsh::Tensor> & copy);
+
+  /** Starts spilling idle tensors not needed within the current lookahead window to the scratch
+      directory or compressing them in memory (ii) in order to free the given amount of the Host buffer
+      (0: all such tensors).
+      Returns TRUE if at least one tensor is being spilled. **/
+  bool spillColdTensors(std::size_t required_space);
+
+  /** Completes the finished writes of spilled tensors, releasing their bodies from the Host buffer. **/
+  void completeSpills(bool wait); //in: whether or not to wait for all active writes
+
+  /** Brings a spilled tensor back to the Host buffer. Returns TRUE if the tensor body
+      is resident on return, FALSE if its restoration is still in progress or
+      there is no free space in the Host buffer at the moment. **/
+  bool restoreSpilledTensor(numerics::TensorHashType tensor_hash, //in: tensor hash
+                            bool wait,                            //in: whether or not to wait for the completion
+                            bool make_room = true);               //in: whether or not to spill other tensors if needed
+
+  /** Discards the spill of a given tensor (if any). Returns TRUE if the tensor body is not resident. **/
+  bool discardSpilledTensor(numerics::TensorHashType tensor_hash);
+
+  /** Decomposes a tensor via the truncated SVD (synchronously): D = L * S * R (middle != nullptr)
+      or D = L * R with the square root of singular values absorbed into both L and R (middle == nullptr).
+      The randomized range finder is used if requested and the sketch is smaller than the tensor,
+      otherwise the full SVD is used. Singular values not exceeding the tolerance are discarded. **/
+  int decomposeSVDTruncated(const std::string & pattern, //in: reduced index pattern D(..)=L(..)*R(..)
+                            talsh::Tensor & dest,        //in: decomposed TAL-SH tensor
+                            talsh::Tensor & left,        //out: left TAL-SH tensor factor
+                            talsh::Tensor & right,       //out: right TAL-SH tensor factor
+                            talsh::Tensor * middle,      //out: middle TAL-SH tensor factor (singular values), if any
+                            bool randomized,             //in: whether or not to use the randomized range finder
+                            double tolerance);           //in: singular values not exceeding the tolerance are discarded
+
+  /** Returns TRUE if a given TAL-SH tensor has an image cached on an accelerator. **/
+  bool tensorOnAccelerator(const talsh::Tensor * talsh_tens) const;
+
+  /** Extracts (insert == false) or inserts (insert == true) a tensor slice by the multi-threaded Host kernel.
+      Returns TALSH_NOT_AVAILABLE if the Host kernel is not applicable (e.g., a tensor operand resides on an accelerator). **/
+  int copySliceOnHost(talsh::Tensor & tens,              //inout: TAL-SH tensor
+                      talsh::Tensor & slice,             //inout: TAL-SH tensor slice
+                      const std::vector<int> & offsets,  //in: slice offsets in the tensor
+                      bool insert,                       //in: whether to insert (or extract) the slice
+                      bool accumulative);                //in: whether or not to accumulate into the destination
+
+  /** Executes a tensor contraction in TAL-SH synchronously (on Host if the optimal device is unable). **/
+  int contractSync(talsh::Tensor & dest,              //inout: destination TAL-SH tensor (overwritten)
+                   const std::string & pattern,       //in: tensor contraction pattern
+                   talsh::Tensor & left,              //in: left TAL-SH tensor
+                   talsh::Tensor & right);            //in: right TAL-SH tensor
+
+  /** Writes zeros into the known-zero tensor operands of a tensor operation, except the
+      destination tensor of an operation overwriting it (contraction, addition, zero initialization).
+      Destroyed tensors are no longer tracked. **/
+  void materializeZeros(const numerics::TensorOperation & op);
+
+  /** Writes zeros into the Host body of a given tensor if it is known to be zero. **/
+  void materializeZeros(numerics::TensorHashType tensor_hash);
+
+  /** Aliases the known-zero destination tensor of a plain copy (addition) to the body of
+      the donated input tensor by swapping their TAL-SH tensors. Returns FALSE if the
+      tensor addition does not qualify, in which case nothing is done. **/
+  bool aliasDonatedTensor(const numerics::TensorOpAdd & op);
+
+  /** Returns TRUE if a tensor addition is a plain copy: Unit scalar, no index permutation,
+      no complex conjugation, distinct tensors of the same shape and element type. **/
+  bool isPlainCopy(const numerics::TensorOpAdd & op) const;
+
+  /** Swaps the TAL-SH tensors (bodies) of two tensors if both are idle Host-only images
+      owned by the executor. Returns FALSE if the swap is not possible. **/
+  bool swapTensorBodies(numerics::TensorHashType tensor0_hash,
+                        numerics::TensorHashType tensor1_hash);
+
+  /** Defers a plain copy (addition) into a known-zero destination tensor by recording
+      the destination tensor as a lazy copy of the source tensor. Returns FALSE if the
+      tensor addition does not qualify, in which case nothing is done. **/
+  bool deferPlainCopy(const numerics::TensorOpAdd & op);
+
+  /** Materializes the lazy copies affected by a tensor operation: Lazy copies accessed
+      by the tensor operation and lazy copies of the tensors written by it. A lazy copy
+      overwritten (zero initialization) or destroyed by the tensor operation is dropped.
+      Tensor slice views of (or being) the tensors written by the tensor operation are
+      detached from the parental body. Returns FALSE if the tensor slice views to be
+      detached are still in use (nothing is done, the tensor operation has to wait). **/
+  bool materializeCopies(const numerics::TensorOperation & op);
+
+  /** Materializes the lazy copy of a given tensor (written = FALSE) or all lazy copies
+      of a given tensor (written = TRUE). In the latter case, if the tensor body is about
+      to be discarded, it is handed over to one of its lazy copies, if possible. **/
+  void materializeCopies(numerics::TensorHashType tensor_hash,
+                         bool written,
+                         bool discarded = false);
+
+  /** Replaces the body of a read-only tensor slice extracted by a SLICE operation with the view
+      of the parental tensor body (no data is moved), if the slice is a contiguous block of
+      the parental tensor and both are idle Host images. Returns FALSE if the tensor slice
+      does not qualify, in which case nothing is done. **/
+  bool createSliceView(const numerics::TensorOpSlice & op,
+                       const std::vector<int> & offsets);
+
+  /** Returns TRUE if a given tensor is the parental tensor of some tensor slice view. **/
+  bool tensorIsViewed(numerics::TensorHashType tensor_hash) const;
+
+  /** Returns TRUE if none of the tensor slice views of a given tensor (and, optionally,
+      the given tensor itself if it is a tensor slice view) is currently in use. **/
+  bool sliceViewsIdle(numerics::TensorHashType tensor_hash,
+                      bool including_itself) const;
+
+  /** Detaches the tensor slice views of a given tensor (and the given tensor itself if it
+      is a tensor slice view) from the parental body by giving them own (copied) bodies. **/
+  void detachSliceViews(numerics::TensorHashType tensor_hash);
+
+  /** Copies the body of the source tensor into the body of a given tensor (on Host). **/
+  void copyTensorBody(numerics::TensorHashType tensor_hash,
+                      numerics::TensorHashType source_hash);
+
+  /** Returns a clean TAL-SH task (recycled from the pool, if any). **/
+  std::shared_ptr<talsh::TensorTask> acquireTask();
+
+  /** Returns a completed TAL-SH task to the pool (unless referenced elsewhere or the pool is full).
+      The given reference is reset on return. **/
+  void recycleTask(std::shared_ptr<talsh::TensorTask> & task);
+
   /** Determines whether a given TAL-SH tensor is currently participating
       in an active tensor operation, tensor prefetch or tensor eviction. **/
   bool tensorIsCurrentlyInUse(const talsh::Tensor * talsh_tens) const;
 
+  /** Returns TRUE if a given tensor is currently pinned by a tensor view. **/
+  bool tensorIsPinned(numerics::TensorHashType tensor_hash) const;
+
+  /** Returns TRUE if any tensor operand of a given tensor operation is currently
+      pinned by a tensor view (the tensor operation must then be postponed). **/
+  bool tensorOperandsPinned(const numerics::TensorOperation & op) const;
+
+  /** Registry of tensors pinned by tensor views (shared with the views) **/
+  struct PinRegistry {
+    mutable std::mutex mtx;
+    std::unordered_map<numerics::TensorHashType,unsigned int> pins; //tensor hash --> number of pinning views
+    std::atomic<std::size_t> num_pinned{0};                          //number of pinned tensors
+  };
+
   struct TensorImpl{
     //TAL-SH tensor with reduced shape (all extent-1 tensor dimensions removed):
     std::unique_ptr<talsh::Tensor> talsh_tensor;
@@ -144,7 +866,8 @@ protected:
                const std::vector<DimExtent> & full_extents,      //full tensor shape
                const std::vector<std::size_t> & reduced_offsets, //reduced tensor signature
                const std::vector<int> & reduced_extents,         //reduced tensor shape
-               int data_kind);                                   //TAL-SH tensor data kind
+               int data_kind,                                    //TAL-SH tensor data kind
+               void * ext_body = nullptr);                       //external tensor body (non-owning), if any
     TensorImpl(const TensorImpl &) = delete;
     TensorImpl & operator=(const TensorImpl &) = delete;
     TensorImpl(TensorImpl &&) noexcept;
@@ -155,10 +878,17 @@ protected:
     void resetTensorShapeToReduced();
   };
 
+  struct SliceView{
+    numerics::TensorHashType parent;        //hash of the parental tensor whose body is aliased
+    std::shared_ptr<numerics::Tensor> slice; //tensor slice aliasing the parental tensor body
+  };
+
   struct CachedAttr{
     double last_used; //time stamp of last usage of the cached tensor image
   };
 
+  /** Tensors pinned by tensor views **/
+  std::shared_ptr<PinRegistry> pinned_;
   /** Maps generic exatn::numerics::Tensor to its TAL-SH implementation **/
   std::unordered_map<numerics::TensorHashType,TensorImpl> tensors_;
   /** Active execution handles associated with tensor operations currently executed by TAL-SH **/
@@ -167,24 +897,183 @@ protected:
   std::unordered_map<numerics::TensorHashType,std::shared_ptr<talsh::TensorTask>> prefetches_;
   /** Active tensor image eviction from accelerators tasks **/
   std::unordered_map<talsh::Tensor*,std::shared_ptr<talsh::TensorTask>> evictions_;
+  /** TAL-SH tensors with externally provided bodies (e.g. node-shared replicas): Never spilled or cached on accelerators **/
+  std::unordered_set<const talsh::Tensor*> external_;
+  /** Tensors known to be zero whose bodies have not been written yet **/
+  std::unordered_set<numerics::TensorHashType> known_zero_;
+  /** Postponed tensor contractions whose destination tensor has already been scaled by beta (ll) **/
+  std::unordered_set<const numerics::TensorOpContract*> scaled_contractions_;
+  /** Lazy copies (copy-on-write) whose bodies have not been written yet: Lazy copy --> its source tensor **/
+  std::unordered_map<numerics::TensorHashType,numerics::TensorHashType> lazy_copies_;
+  /** Read-only tensor slices aliasing the body of their parental tensor: Tensor slice --> its view attributes **/
+  std::unordered_map<numerics::TensorHashType,SliceView> slice_views_;
+  /** Pool of recycled (clean) TAL-SH tasks **/
+  std::vector<std::shared_ptr<talsh::TensorTask>> task_pool_;
   /** Register (cache) of tensors with body images moved/copied to accelerators **/
   std::unordered_map<talsh::Tensor*,CachedAttr> accel_cache_[DEV_MAX]; //cache for each device
+  /** Accelerator placements of tensor operations currently executed by TAL-SH: Handle --> {Flat device id, Flop count} **/
+  std::unordered_map<TensorOpExecHandle,std::pair<int,double>> placements_;
+  /** Work (Flop count) queued on each accelerator by placed tensor operations **/
+  std::atomic<double> device_queued_flops_[DEV_MAX];
+  /** Position of the next use of a TAL-SH tensor within the lookahead window **/
+  std::unordered_map<const talsh::Tensor*,std::size_t> next_use_;
   /** Active MPI requests for non-blocking two-sided messages **/
-  std::unordered_map<TensorOpExecHandle,std::list<void*>> mpi_requests_; //owning pointers
+  std::unordered_map<TensorOpExecHandle,std::list<void*>> mpi_requests_; //owning pointers (except persistent MPI requests)
+  /** Persistent MPI requests of a repeated tensor transfer **/
+  struct PersistentTransfer{
+    const void * body;           //tensor body the MPI requests have been created for
+    std::size_t volume;          //tensor volume
+    MPICommProxy communicator;   //MPI communicator
+    std::vector<void*> requests; //persistent MPI requests (one per chunk, owning pointers)
+  };
+  /** Cached persistent MPI requests: {Tensor hash, Remote rank, Message tag, Send} --> Persistent transfer **/
+  std::map<std::tuple<numerics::TensorHashType,int,int,bool>,PersistentTransfer> persistent_transfers_;
+  /** Persistent MPI requests currently in flight (owned by persistent_transfers_) **/
+  std::unordered_set<void*> persistent_active_;
+  /** Tensors whose device-resident body is accessed by GPU-direct MPI transfers in flight **/
+  std::unordered_map<TensorOpExecHandle,const talsh::Tensor*> gpu_direct_transfers_;
+  /** Tensor communication operation in flight recorded by the communication profile **/
+  struct PendingComm{
+    CommProfile::CommKind kind;  //communication kind
+    MPICommProxy communicator;   //MPI communicator
+    int peer;                    //remote rank or root rank (negative: allreduce)
+    std::size_t bytes;           //payload volume (bytes)
+    double start;                //issue time stamp (sec)
+  };
+  std::unordered_map<TensorOpExecHandle,PendingComm> comm_pending_;
+  /** Permuted copy of an input tensor in the layout cache **/
+  struct LayoutCopy{
+    std::shared_ptr<talsh::Tensor> tensor; //permuted copy (nullptr until repeated use)
+    std::size_t size;                      //size of the permuted copy (bytes)
+    unsigned int uses;                     //number of uses of the permutation before caching
+    double last_used;                      //time stamp of last usage
+  };
+  /** Layout cache: {Tensor hash, Permutation} --> Permuted copy **/
+  std::map<std::pair<numerics::TensorHashType,std::vector<int>>,LayoutCopy> layout_cache_;
+  /** Permuted copies used by tensor operations currently executed by TAL-SH **/
+  std::unordered_map<TensorOpExecHandle,std::vector<std::shared_ptr<talsh::Tensor>>> layouts_in_use_;
+  /** Max size of the layout cache (bytes), 0 turns it off **/
+  std::size_t layout_cache_limit_;
+  /** Current size of the layout cache (bytes) **/
+  std::size_t layout_cache_bytes_;
+  /** Early receive of a tensor fetch (hh) **/
+  struct EarlyReceive{
+    MPICommProxy communicator;               //MPI communicator
+    int remote_rank;                         //remote MPI process rank
+    int mesg_tag;                            //MPI message tag
+    int data_kind;                           //TAL-SH data kind
+    std::size_t volume;                      //tensor volume
+    std::size_t size;                        //size of the staging tensor body (bytes)
+    std::unique_ptr<talsh::Tensor> staging;  //staging Host tensor receiving the message
+    void * request;                          //MPI request (owning pointer)
+  };
+  /** Early receives of tensor fetches in flight: Tensor operation id --> Early receive **/
+  std::unordered_map<TensorOpExecHandle,EarlyReceive> early_receives_;
+  /** Max size of the staging tensors of the early receives (bytes), 0 turns them off **/
+  std::size_t remote_prefetch_limit_;
+  /** Current size of the staging tensors of the early receives (bytes) **/
+  std::size_t remote_prefetch_bytes_;
+  /** Spilled tensor **/
+  enum class SpillStatus{WRITING, STORED, READING};
+  struct SpilledTensor{
+    std::string path;         //file storing the tensor body (empty: no scratch directory)
+    std::shared_ptr<std::vector<unsigned char>> packed; //compressed tensor body kept in memory (ii), empty: file
+    std::vector<int> extents; //reduced tensor shape
+    int data_kind;            //TAL-SH data kind
+    std::size_t size;         //size of the tensor body (bytes)
+    SpillStatus status;       //spill status
+    std::future<bool> io;     //active asynchronous write/read of the tensor body
+  };
+  /** Spilled tensors: Tensor hash --> Spilled tensor **/
+  std::unordered_map<numerics::TensorHashType,SpilledTensor> spilled_;
+  /** Scratch directory for spilled tensors (empty: no spilling) **/
+  std::string spill_directory_;
+  /** Compression tier mode (ii) **/
+  int compression_mode_;
+  /** Absolute error bound of the lossy compression (ii) **/
+  double compression_tolerance_;
+  /** Number of power iterations of the randomized range finder **/
+  int rsvd_power_iterations_;
   /** Max encountered actual tensor rank **/
   int max_tensor_rank_;
   /** Prefetching enabled flag **/
   bool prefetch_enabled_;
   /** Dry run (no actual computations) **/
   std::atomic<bool> dry_run_;
+  /** Cost-model-based accelerator placement of tensor contractions **/
+  bool placement_cost_model_;
+  /** Max Flop count of a small tensor contraction executed on Host **/
+  double small_contraction_flops_;
+  /** Max Flop count of a tensor contraction executed by the small kernels (0: off) **/
+  double small_kernel_flops_;
+  /** Direct tensor contraction mode (bb) **/
+  int direct_contraction_;
+  /** Host tensor transpose kernels enabled flag (cc) **/
+  bool host_transpose_;
+  /** Min Flop count of a complex tensor contraction executed by the 3M algorithm (0: off) (dd) **/
+  double gauss_contraction_flops_;
+  /** Autotuner of the tensor contraction execution strategies (aa) **/
+  ContractAutotuner autotuner_;
+  /** Recurring launch sequence of tensor contractions (ee) **/
+  LaunchSequence launch_sequence_;
+  /** Autotuning trial in flight **/
+  struct TuningTrial{
+    std::string key; //tensor contraction key
+    int strategy;    //tried execution strategy
+    double start;    //submission time stamp (sec)
+  };
+  /** Autotuning trials in flight: Tensor operation handle --> Trial **/
+  std::unordered_map<TensorOpExecHandle,TuningTrial> tuning_trials_;
+  /** Parsed index patterns of the small kernels: pattern --> {supported, index positions} **/
+  std::unordered_map<std::string,std::pair<bool,SmallContractionPattern>> small_patterns_;
+  /** Parsed index patterns of the direct kernels (bb) **/
+  std::unordered_map<std::string,std::pair<bool,DirectContractionPattern>> direct_patterns_;
+  /** Parsed tensor permutation patterns of the Host transpose kernels (cc) **/
+  std::unordered_map<std::string,std::pair<bool,TensorTransposePattern>> transpose_patterns_;
+  /** Cached Host transpose plans (cc): {Tensor permutation pattern, tensor shape} --> Transpose plan **/
+  std::unordered_map<std::string,TensorTransposePlan> transpose_plans_;
+  /** Cached contraction descriptors of the small kernels (jj): {Pattern, tensor shapes} --> {applicable, Descriptor} **/
+  std::unordered_map<std::string,std::pair<bool,SmallContractionLoops>> small_plans_;
+  /** Cached contraction descriptors of the direct kernels (jj): {Pattern, tensor shapes} --> {applicable, Descriptor} **/
+  std::unordered_map<std::string,std::pair<bool,DirectContractionPlan>> direct_plans_;
+  /** Memory timeline of the tensor bodies allocated in the Host buffer **/
+  MemoryTimeline memory_timeline_;
+  /** Persistent MPI requests for tensor fetch/upload **/
+  bool persistent_requests_;
+  /** GPU-direct MPI transfers of device-resident tensor bodies (CUDA-aware MPI) **/
+  bool gpu_direct_;
   /** TAL-SH Host memory buffer size (bytes) **/
   static std::atomic<std::size_t> talsh_host_mem_buffer_size_;
   /** TAL-SH submitted Flop count **/
   static std::atomic<double> talsh_submitted_flops_;
+  /** TAL-SH Host-to-device data transfer volume (bytes) **/
+  static std::atomic<std::size_t> talsh_h2d_bytes_;
+  /** TAL-SH device-to-Host data transfer volume (bytes) **/
+  static std::atomic<std::size_t> talsh_d2h_bytes_;
+  /** Total size of the bodies of all live tensors (bytes) **/
+  static std::atomic<std::size_t> talsh_tensor_bytes_;
+  /** Fast math activation status for the DEFAULT precision policy **/
+  static std::atomic<bool> talsh_fast_math_default_;
+  /** Current fast math status of the accelerators **/
+  static std::atomic<bool> talsh_fast_math_active_;
+  /** Ids of the NVIDIA GPUs initialized by TAL-SH **/
+  static std::vector<int> talsh_gpus_;
+  /** Node-local process rank and number of processes for the node-local GPU binding (-1: all GPUs) **/
+  static int talsh_node_process_rank_;
+  static int talsh_node_num_processes_;
+  /** NUMA first touch of the TAL-SH Host buffer upon initialization **/
+  static bool talsh_numa_first_touch_;
+  /** Huge page size backing the TAL-SH Host buffer (0: regular pages) **/
+  static std::size_t talsh_huge_page_size_;
+  /** Registration of the TAL-SH Host buffer as GPU pinned memory: requested, done **/
+  static bool talsh_pin_host_buffer_;
+  static bool talsh_host_buffer_pinned_;
   /** TAL-SH initialization status **/
   static std::atomic<bool> talsh_initialized_;
   /** Number of instances of TAL-SH node executors **/
   static std::atomic<int> talsh_node_exec_count_;
+  /** Initialization status of this node executor (see rationale (kk)) **/
+  bool exec_initialized_;
 };
 
 
@@ -197,6 +1086,9 @@ inline int get_talsh_tensor_element_kind(TensorElementType element_type)
     case TensorElementType::REAL64: talsh_data_kind = talsh::REAL64; break;
     case TensorElementType::COMPLEX32: talsh_data_kind = talsh::COMPLEX32; break;
     case TensorElementType::COMPLEX64: talsh_data_kind = talsh::COMPLEX64; break;
+    //Half-precision tensors are held and computed in single precision:
+    case TensorElementType::REAL16: talsh_data_kind = talsh::REAL32; break;
+    case TensorElementType::COMPLEX16: talsh_data_kind = talsh::COMPLEX32; break;
   }
   return talsh_data_kind;
 }
@@ -0,0 +1,284 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: Small tensor contraction kernels
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) Small tensor contractions (e.g., operator application in MPS algorithms) are dominated by
+     the fixed cost of the generic Host path (index pattern processing, operand transposes into
+     the matrix layout, GEMM call). These kernels contract the tensor operands in place by a direct
+     loop nest over their original layouts, without any transposes or temporary buffers.
+ (b) The kernels are specialized at compile time on the number of uncontracted (destination)
+     indices and the number of contracted indices (up to MAX_RANK each, such that every tensor
+     operand is of rank MAX_RANK at most), thus all loop nests are fully unrolled. The index pattern
+     itself (positions of the indices in each tensor operand) is applied via runtime strides.
+     Complex conjugation of the input tensors is a compile-time parameter of the kernels as well.
+ (c) The destination tensor is traversed in its storage order (column-major, the first dimension
+     is the fastest), the contracted indices are traversed in the order of the left tensor.
+     Hyper indices and traces (indices appearing in one input tensor only) are not supported.
+**/
+
+#ifndef EXATN_RUNTIME_SMALL_CONTRACTION_KERNELS_HPP_
+#define EXATN_RUNTIME_SMALL_CONTRACTION_KERNELS_HPP_
+
+#include "tensor_symbol.hpp"
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+/** Index positions of a small binary tensor contraction D+=L*R (no hyper indices, no traces). **/
+struct SmallContractionPattern{
+  static constexpr const unsigned int MAX_RANK = 4; //max rank of a tensor operand
+
+  unsigned int rank[3];         //ranks of the destination, left and right tensors
+  unsigned int num_contr;       //number of contracted indices
+  int free_pos[2][MAX_RANK];    //position of each destination index in the left/right tensor (-1: absent)
+  int contr_pos[2][MAX_RANK];   //positions of the contracted indices in the left/right tensor
+  bool conj[2];                 //complex conjugation of the left/right tensor
+};
+
+/** Loop nest of a small binary tensor contraction for given tensor extents. **/
+struct SmallContractionLoops{
+  static constexpr const unsigned int MAX_RANK = SmallContractionPattern::MAX_RANK;
+
+  unsigned int num_free;                 //number of uncontracted indices (destination tensor rank)
+  unsigned int num_contr;                //number of contracted indices
+  std::size_t free_extent[MAX_RANK];     //extents of the uncontracted indices (in the order of the destination tensor)
+  std::size_t free_stride[2][MAX_RANK];  //strides of the uncontracted indices in the left/right tensor (0: absent)
+  std::size_t contr_extent[MAX_RANK];    //extents of the contracted indices (in the order of the left tensor)
+  std::size_t contr_stride[2][MAX_RANK]; //strides of the contracted indices in the left/right tensor
+};
+
+
+/** Parses a (reduced) symbolic tensor contraction pattern into index positions.
+    Returns FALSE if the tensor contraction is not supported by the small kernels. **/
+inline bool parse_small_contraction(const std::string & pattern,         //in: symbolic tensor contraction pattern
+                                    SmallContractionPattern & positions) //out: index positions
+{
+  constexpr unsigned int MAX_RANK = SmallContractionPattern::MAX_RANK;
+  std::vector<std::string> tensors;
+  std::vector<PosIndexLabel> left_inds, right_inds, contr_inds, hyper_inds;
+  if(!parse_tensor_contraction(pattern,tensors,left_inds,right_inds,contr_inds,hyper_inds)) return false;
+  if(tensors.size() != 3 || !hyper_inds.empty()) return false;
+  for(unsigned int arg = 0; arg < 3; ++arg){
+    std::string tensor_name;
+    std::vector<IndexLabel> indices;
+    bool conj = false;
+    if(!parse_tensor(tensors[arg],tensor_name,indices,conj)) return false;
+    if(indices.size() > MAX_RANK) return false;
+    positions.rank[arg] = indices.size();
+    if(arg > 0) positions.conj[arg-1] = conj;
+  }
+  //Traces are not supported:
+  if(positions.rank[0] != left_inds.size() + right_inds.size()) return false;
+  if(positions.rank[1] != left_inds.size() + contr_inds.size()) return false;
+  if(positions.rank[2] != right_inds.size() + contr_inds.size()) return false;
+  for(unsigned int i = 0; i < MAX_RANK; ++i){
+    positions.free_pos[0][i] = -1; positions.free_pos[1][i] = -1;
+    positions.contr_pos[0][i] = -1; positions.contr_pos[1][i] = -1;
+  }
+  for(const auto & index: left_inds) positions.free_pos[0][index.arg_pos[0]] = index.arg_pos[1];
+  for(const auto & index: right_inds) positions.free_pos[1][index.arg_pos[0]] = index.arg_pos[2];
+  std::sort(contr_inds.begin(),contr_inds.end(),
+            [](const PosIndexLabel & a, const PosIndexLabel & b){return a.arg_pos[1] < b.arg_pos[1];});
+  positions.num_contr = contr_inds.size();
+  for(unsigned int i = 0; i < positions.num_contr; ++i){
+    positions.contr_pos[0][i] = contr_inds[i].arg_pos[1];
+    positions.contr_pos[1][i] = contr_inds[i].arg_pos[2];
+  }
+  return true;
+}
+
+
+/** Sets up the loop nest of a small tensor contraction for given tensor extents.
+    Returns FALSE if the tensor ranks do not match the index pattern. **/
+template <typename ExtentType>
+bool setup_small_contraction(const SmallContractionPattern & positions, //in: index positions
+                             const unsigned int ranks[3],               //in: ranks of the destination, left and right tensors
+                             const ExtentType * const extents[3],       //in: extents of the destination, left and right tensors
+                             SmallContractionLoops & loops)             //out: loop nest
+{
+  for(unsigned int arg = 0; arg < 3; ++arg) if(ranks[arg] != positions.rank[arg]) return false;
+  std::size_t strides[2][SmallContractionPattern::MAX_RANK];
+  for(unsigned int arg = 1; arg <= 2; ++arg){
+    std::size_t stride = 1;
+    for(unsigned int i = 0; i < ranks[arg]; ++i){
+      strides[arg-1][i] = stride;
+      stride *= static_cast<std::size_t>(extents[arg][i]);
+    }
+  }
+  loops.num_free = ranks[0];
+  for(unsigned int i = 0; i < loops.num_free; ++i){
+    loops.free_extent[i] = static_cast<std::size_t>(extents[0][i]);
+    for(unsigned int side = 0; side < 2; ++side){
+      const int pos = positions.free_pos[side][i];
+      if(pos >= 0){
+        if(static_cast<std::size_t>(extents[side+1][pos]) != loops.free_extent[i]) return false;
+        loops.free_stride[side][i] = strides[side][pos];
+      }else{
+        loops.free_stride[side][i] = 0;
+      }
+    }
+  }
+  loops.num_contr = positions.num_contr;
+  for(unsigned int i = 0; i < loops.num_contr; ++i){
+    const int lpos = positions.contr_pos[0][i];
+    const int rpos = positions.contr_pos[1][i];
+    if(extents[1][lpos] != extents[2][rpos]) return false;
+    loops.contr_extent[i] = static_cast<std::size_t>(extents[1][lpos]);
+    loops.contr_stride[0][i] = strides[0][lpos];
+    loops.contr_stride[1][i] = strides[1][rpos];
+  }
+  return true;
+}
+
+
+template <typename NumericType>
+struct SmallIsComplex{static constexpr const bool value = false;};
+
+template <typename RealType>
+struct SmallIsComplex<std::complex<RealType>>{static constexpr const bool value = true;};
+
+template <typename NumericType>
+inline NumericType small_conjugated(const NumericType & value){return value;}
+
+template <typename RealType>
+inline std::complex<RealType> small_conjugated(const std::complex<RealType> & value){return std::conj(value);}
+
+/** Element product with compile-time complex conjugation of the factors. **/
+template <bool ConjLeft, bool ConjRight>
+struct SmallContractionProduct{
+  template <typename NumericType>
+  NumericType operator()(const NumericType & left, const NumericType & right) const
+  {
+    return (ConjLeft ? small_conjugated(left) : left) * (ConjRight ? small_conjugated(right) : right);
+  }
+};
+
+
+/** Small tensor contraction kernel with NumFree uncontracted indices and NumContr contracted indices:
+    dest = alpha * left * right (+ dest, if accumulative). **/
+template <unsigned int NumFree, unsigned int NumContr, typename NumericType, typename Product>
+void small_contraction_kernel(const SmallContractionLoops & loops,
+                              NumericType * __restrict__ dest,
+                              const NumericType * __restrict__ left,
+                              const NumericType * __restrict__ right,
+                              NumericType alpha,
+                              bool accumulative)
+{
+  const Product product;
+  std::size_t dest_volume = 1;
+  for(unsigned int i = 0; i < NumFree; ++i) dest_volume *= loops.free_extent[i];
+  std::size_t free_index[NumFree + 1] = {0}; //+1: no zero-size arrays
+  std::size_t contr_index[NumContr + 1] = {0};
+  std::size_t left_base = 0, right_base = 0; //offsets of the current destination element in the left/right tensor
+  for(std::size_t dest_offset = 0; dest_offset < dest_volume; ++dest_offset){
+    NumericType sum(0);
+    if(NumContr == 0){
+      sum = product(left[left_base],right[right_base]);
+    }else{
+      const std::size_t inner_extent = loops.contr_extent[0];
+      const std::size_t inner_left_stride = loops.contr_stride[0][0];
+      const std::size_t inner_right_stride = loops.contr_stride[1][0];
+      std::size_t left_offset = left_base, right_offset = right_base;
+      while(true){
+        for(std::size_t k = 0; k < inner_extent; ++k){
+          sum += product(left[left_offset + k * inner_left_stride],right[right_offset + k * inner_right_stride]);
+        }
+        unsigned int i = 1;
+        for(; i < NumContr; ++i){ //next outer contracted multi-index
+          left_offset += loops.contr_stride[0][i];
+          right_offset += loops.contr_stride[1][i];
+          if(++(contr_index[i]) < loops.contr_extent[i]) break;
+          left_offset -= loops.contr_extent[i] * loops.contr_stride[0][i];
+          right_offset -= loops.contr_extent[i] * loops.contr_stride[1][i];
+          contr_index[i] = 0;
+        }
+        if(i >= NumContr) break;
+      }
+    }
+    dest[dest_offset] = accumulative ? (dest[dest_offset] + alpha * sum) : (alpha * sum);
+    for(unsigned int i = 0; i < NumFree; ++i){ //next destination multi-index
+      left_base += loops.free_stride[0][i];
+      right_base += loops.free_stride[1][i];
+      if(++(free_index[i]) < loops.free_extent[i]) break;
+      left_base -= loops.free_extent[i] * loops.free_stride[0][i];
+      right_base -= loops.free_extent[i] * loops.free_stride[1][i];
+      free_index[i] = 0;
+    }
+  }
+  return;
+}
+
+
+/** Dispatches a small tensor contraction to the kernel specialized for its loop nest. **/
+template <typename NumericType, typename Product>
+void small_contraction_dispatch(const SmallContractionLoops & loops,
+                                NumericType * dest,
+                                const NumericType * left,
+                                const NumericType * right,
+                                NumericType alpha,
+                                bool accumulative)
+{
+  using Kernel = void (*)(const SmallContractionLoops &, NumericType *, const NumericType *,
+                          const NumericType *, NumericType, bool);
+  static const Kernel kernels[5][5] = {
+    {&small_contraction_kernel<0,0,NumericType,Product>,&small_contraction_kernel<0,1,NumericType,Product>,
+     &small_contraction_kernel<0,2,NumericType,Product>,&small_contraction_kernel<0,3,NumericType,Product>,
+     &small_contraction_kernel<0,4,NumericType,Product>},
+    {&small_contraction_kernel<1,0,NumericType,Product>,&small_contraction_kernel<1,1,NumericType,Product>,
+     &small_contraction_kernel<1,2,NumericType,Product>,&small_contraction_kernel<1,3,NumericType,Product>,
+     &small_contraction_kernel<1,4,NumericType,Product>},
+    {&small_contraction_kernel<2,0,NumericType,Product>,&small_contraction_kernel<2,1,NumericType,Product>,
+     &small_contraction_kernel<2,2,NumericType,Product>,&small_contraction_kernel<2,3,NumericType,Product>,
+     &small_contraction_kernel<2,4,NumericType,Product>},
+    {&small_contraction_kernel<3,0,NumericType,Product>,&small_contraction_kernel<3,1,NumericType,Product>,
+     &small_contraction_kernel<3,2,NumericType,Product>,&small_contraction_kernel<3,3,NumericType,Product>,
+     &small_contraction_kernel<3,4,NumericType,Product>},
+    {&small_contraction_kernel<4,0,NumericType,Product>,&small_contraction_kernel<4,1,NumericType,Product>,
+     &small_contraction_kernel<4,2,NumericType,Product>,&small_contraction_kernel<4,3,NumericType,Product>,
+     &small_contraction_kernel<4,4,NumericType,Product>}
+  };
+  kernels[loops.num_free][loops.num_contr](loops,dest,left,right,alpha,accumulative);
+  return;
+}
+
+
+/** Executes a small tensor contraction: dest = alpha * left * right (+ dest, if accumulative),
+    where the left/right tensor may be complex conjugated. Returns FALSE if the loop nest
+    exceeds the kernel specializations. **/
+template <typename NumericType>
+bool small_contraction(const SmallContractionLoops & loops,
+                       NumericType * dest,
+                       const NumericType * left,
+                       const NumericType * right,
+                       NumericType alpha,
+                       bool accumulative,
+                       bool conj_left = false,
+                       bool conj_right = false)
+{
+  if(loops.num_free > SmallContractionLoops::MAX_RANK || loops.num_contr > SmallContractionLoops::MAX_RANK) return false;
+  const bool conj_any = SmallIsComplex<NumericType>::value && (conj_left || conj_right);
+  if(!conj_any){
+    small_contraction_dispatch<NumericType,SmallContractionProduct<false,false>>(loops,dest,left,right,alpha,accumulative);
+  }else if(conj_left && conj_right){
+    small_contraction_dispatch<NumericType,SmallContractionProduct<true,true>>(loops,dest,left,right,alpha,accumulative);
+  }else if(conj_left){
+    small_contraction_dispatch<NumericType,SmallContractionProduct<true,false>>(loops,dest,left,right,alpha,accumulative);
+  }else{
+    small_contraction_dispatch<NumericType,SmallContractionProduct<false,true>>(loops,dest,left,right,alpha,accumulative);
+  }
+  return true;
+}
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_SMALL_CONTRACTION_KERNELS_HPP_
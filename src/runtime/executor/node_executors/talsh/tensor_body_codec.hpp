@@ -0,0 +1,268 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: Tensor body codec
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) The tensor body codec compresses idle tensor bodies kept in memory (compressed-at-rest tier).
+     It has to be much faster than the memory it saves is worth, thus it is a single-pass byte codec
+     without entropy coding. A tensor body is a sequence of real words (float or double; complex
+     elements are pairs of real words).
+ (b) Lossless mode: The bytes of the words are shuffled into byte planes (byte k of all words, then
+     byte k+1, etc.), which turns the slowly varying sign/exponent bytes of the floating point numbers
+     (and zero elements) into long runs of equal bytes, followed by the run-length encoding
+     of the byte stream: A token byte T < 128 is followed by T+1 literal bytes, a token byte T >= 128
+     is followed by a single byte repeated T-125 times (runs of 3..130 bytes).
+ (c) Error-bounded lossy mode (tolerance > 0): Each real word x is quantized to the integer
+     q = round(x / (2 * tolerance)), thus |x - 2 * tolerance * q| <= tolerance. The differences
+     of the integers of consecutive tensor elements (the same real/imaginary part) are zigzag-encoded into variable-length integers (7 bits per byte),
+     followed by the run-length encoding (b). A body with words which are not finite or too large
+     to be quantized is encoded losslessly instead.
+ (d) The packed body starts with a header {magic, mode, word size, words per element, tolerance, body size}, thus it is
+     decoded without any extra information.
+**/
+
+#ifndef EXATN_RUNTIME_TENSOR_BODY_CODEC_HPP_
+#define EXATN_RUNTIME_TENSOR_BODY_CODEC_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+/** Packed tensor body header. **/
+struct TensorBodyCodecHeader{
+  static constexpr const std::uint32_t MAGIC = 0x45584342; //"EXCB"
+  static constexpr const std::uint32_t LOSSLESS = 0;       //byte shuffle + run-length encoding
+  static constexpr const std::uint32_t QUANTIZED = 1;      //quantization + variable-length integers + run-length encoding
+
+  std::uint32_t magic;     //magic number
+  std::uint32_t mode;      //encoding mode
+  std::uint64_t word_size; //size of a real word (4 or 8 bytes)
+  std::uint64_t stride;    //number of real words per tensor element (1: real, 2: complex)
+  double tolerance;        //absolute error bound of the quantization
+  std::uint64_t size;      //size of the tensor body (bytes)
+};
+
+
+/** Appends the run-length encoding of a byte stream to the packed body. **/
+inline void tensor_body_rle_encode(const unsigned char * data,
+                                   std::size_t size,
+                                   std::vector<unsigned char> & packed)
+{
+  static constexpr const std::size_t MIN_RUN = 3, MAX_RUN = 130, MAX_LITERALS = 128;
+  std::size_t i = 0, literal_begin = 0;
+  auto flush_literals = [&](std::size_t end){
+    while(literal_begin < end){
+      const std::size_t count = std::min(end - literal_begin,MAX_LITERALS);
+      packed.emplace_back(static_cast<unsigned char>(count - 1));
+      packed.insert(packed.end(),data + literal_begin,data + literal_begin + count);
+      literal_begin += count;
+    }
+  };
+  while(i < size){
+    std::size_t run = 1;
+    while(i + run < size && run < MAX_RUN && data[i + run] == data[i]) ++run;
+    if(run >= MIN_RUN){
+      flush_literals(i);
+      packed.emplace_back(static_cast<unsigned char>(run - MIN_RUN + 128));
+      packed.emplace_back(data[i]);
+      i += run;
+      literal_begin = i;
+    }else{
+      i += run;
+    }
+  }
+  flush_literals(size);
+  return;
+}
+
+
+/** Decodes a run-length encoded byte stream of a given decoded size.
+    Returns the position past the encoded stream (nullptr on malformed input). **/
+inline const unsigned char * tensor_body_rle_decode(const unsigned char * packed,
+                                                    const unsigned char * packed_end,
+                                                    unsigned char * data,
+                                                    std::size_t size)
+{
+  std::size_t i = 0;
+  while(i < size){
+    if(packed >= packed_end) return nullptr;
+    const unsigned int token = *packed++;
+    if(token < 128){
+      const std::size_t count = token + 1;
+      if(i + count > size || packed + count > packed_end) return nullptr;
+      std::memcpy(data + i,packed,count);
+      packed += count;
+      i += count;
+    }else{
+      const std::size_t count = token - 125;
+      if(i + count > size || packed >= packed_end) return nullptr;
+      std::memset(data + i,*packed++,count);
+      i += count;
+    }
+  }
+  return packed;
+}
+
+
+/** Quantizes the real words of a tensor body into zigzag-encoded variable-length integer differences.
+    Returns FALSE if some word cannot be quantized. **/
+template<typename T>
+inline bool tensor_body_quantize(const T * words,
+                                 std::size_t num_words,
+                                 std::size_t stride,
+                                 double tolerance,
+                                 std::vector<unsigned char> & stream)
+{
+  const double scale = 1.0 / (2.0 * tolerance);
+  const double limit = 4.0e18; //max magnitude of a quantized word (int64_t)
+  std::vector<std::int64_t> previous(stride,0);
+  stream.reserve(num_words * 2);
+  for(std::size_t i = 0; i < num_words; ++i){
+    const double scaled = static_cast<double>(words[i]) * scale;
+    if(!std::isfinite(scaled) || std::abs(scaled) > limit) return false;
+    const std::int64_t quantized = static_cast<std::int64_t>(std::llround(scaled));
+    const std::int64_t delta = quantized - previous[i % stride];
+    previous[i % stride] = quantized;
+    std::uint64_t zigzag = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+    while(zigzag >= 0x80){
+      stream.emplace_back(static_cast<unsigned char>(zigzag | 0x80));
+      zigzag >>= 7;
+    }
+    stream.emplace_back(static_cast<unsigned char>(zigzag));
+  }
+  return true;
+}
+
+
+/** Dequantizes the zigzag-encoded variable-length integer differences into real words.
+    Returns FALSE on malformed input. **/
+template<typename T>
+inline bool tensor_body_dequantize(const unsigned char * stream,
+                                   std::size_t stream_size,
+                                   std::size_t stride,
+                                   double tolerance,
+                                   T * words,
+                                   std::size_t num_words)
+{
+  const double step = 2.0 * tolerance;
+  std::vector<std::int64_t> previous(stride,0);
+  std::size_t pos = 0;
+  for(std::size_t i = 0; i < num_words; ++i){
+    std::uint64_t zigzag = 0;
+    unsigned int shift = 0;
+    while(true){
+      if(pos >= stream_size || shift > 63) return false;
+      const unsigned char byte = stream[pos++];
+      zigzag |= (static_cast<std::uint64_t>(byte & 0x7F) << shift);
+      if((byte & 0x80) == 0) break;
+      shift += 7;
+    }
+    const std::int64_t delta = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+    previous[i % stride] += delta;
+    words[i] = static_cast<T>(static_cast<double>(previous[i % stride]) * step);
+  }
+  return (pos == stream_size);
+}
+
+
+/** Compresses a tensor body of real words (4 or 8 bytes, stride words per tensor element),
+    losslessly (tolerance = 0) or with the absolute error bound tolerance > 0. **/
+inline void compress_tensor_body(const void * body,
+                                 std::size_t size,
+                                 std::size_t word_size,
+                                 std::size_t stride,
+                                 double tolerance,
+                                 std::vector<unsigned char> & packed)
+{
+  const auto * bytes = static_cast<const unsigned char*>(body);
+  const std::size_t num_words = (word_size > 0) ? size / word_size : 0;
+  if(stride == 0) stride = 1;
+  TensorBodyCodecHeader header{TensorBodyCodecHeader::MAGIC,TensorBodyCodecHeader::LOSSLESS,
+                               static_cast<std::uint64_t>(word_size),static_cast<std::uint64_t>(stride),
+                               0.0,static_cast<std::uint64_t>(size)};
+  packed.clear();
+  packed.resize(sizeof(header));
+  if(tolerance > 0.0 && num_words * word_size == size && (word_size == sizeof(float) || word_size == sizeof(double))){
+    std::vector<unsigned char> stream;
+    const bool quantized = (word_size == sizeof(float)) ?
+      tensor_body_quantize(static_cast<const float*>(body),num_words,stride,tolerance,stream) :
+      tensor_body_quantize(static_cast<const double*>(body),num_words,stride,tolerance,stream);
+    if(quantized){
+      header.mode = TensorBodyCodecHeader::QUANTIZED;
+      header.tolerance = tolerance;
+      const std::uint64_t stream_size = stream.size();
+      packed.insert(packed.end(),reinterpret_cast<const unsigned char*>(&stream_size),
+                    reinterpret_cast<const unsigned char*>(&stream_size) + sizeof(stream_size));
+      tensor_body_rle_encode(stream.data(),stream.size(),packed);
+    }
+  }
+  if(header.mode == TensorBodyCodecHeader::LOSSLESS){
+    if(num_words * word_size == size && word_size > 1){ //byte planes
+      std::vector<unsigned char> planes(size);
+      for(std::size_t k = 0; k < word_size; ++k){
+        unsigned char * plane = planes.data() + k * num_words;
+        for(std::size_t i = 0; i < num_words; ++i) plane[i] = bytes[i * word_size + k];
+      }
+      tensor_body_rle_encode(planes.data(),size,packed);
+    }else{
+      header.word_size = 1;
+      tensor_body_rle_encode(bytes,size,packed);
+    }
+  }
+  std::memcpy(packed.data(),&header,sizeof(header));
+  return;
+}
+
+
+/** Decompresses a packed tensor body into a buffer of a given size.
+    Returns FALSE on a size mismatch or malformed input. **/
+inline bool decompress_tensor_body(const std::vector<unsigned char> & packed,
+                                   void * body,
+                                   std::size_t size)
+{
+  TensorBodyCodecHeader header;
+  if(packed.size() < sizeof(header)) return false;
+  std::memcpy(&header,packed.data(),sizeof(header));
+  if(header.magic != TensorBodyCodecHeader::MAGIC || header.size != size ||
+     header.word_size == 0 || header.stride == 0) return false;
+  const unsigned char * pos = packed.data() + sizeof(header);
+  const unsigned char * end = packed.data() + packed.size();
+  const std::size_t word_size = header.word_size;
+  const std::size_t num_words = size / word_size;
+  if(header.mode == TensorBodyCodecHeader::QUANTIZED){
+    std::uint64_t stream_size = 0;
+    if(static_cast<std::size_t>(end - pos) < sizeof(stream_size)) return false;
+    std::memcpy(&stream_size,pos,sizeof(stream_size));
+    pos += sizeof(stream_size);
+    std::vector<unsigned char> stream(stream_size);
+    if(tensor_body_rle_decode(pos,end,stream.data(),stream.size()) != end) return false;
+    if(word_size == sizeof(float))
+      return tensor_body_dequantize(stream.data(),stream.size(),header.stride,header.tolerance,static_cast<float*>(body),num_words);
+    if(word_size == sizeof(double))
+      return tensor_body_dequantize(stream.data(),stream.size(),header.stride,header.tolerance,static_cast<double*>(body),num_words);
+    return false;
+  }
+  if(header.mode != TensorBodyCodecHeader::LOSSLESS || num_words * word_size != size) return false;
+  auto * bytes = static_cast<unsigned char*>(body);
+  if(word_size == 1) return (tensor_body_rle_decode(pos,end,bytes,size) == end);
+  std::vector<unsigned char> planes(size);
+  if(tensor_body_rle_decode(pos,end,planes.data(),size) != end) return false;
+  for(std::size_t k = 0; k < word_size; ++k){
+    const unsigned char * plane = planes.data() + k * num_words;
+    for(std::size_t i = 0; i < num_words; ++i) bytes[i * word_size + k] = plane[i];
+  }
+  return true;
+}
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_TENSOR_BODY_CODEC_HPP_
@@ -0,0 +1,225 @@
+/** ExaTN:: Tensor Runtime: Tensor graph node executor: Talsh: Host tensor transpose kernels
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+/** Rationale:
+ (a) A tensor transpose D(perm(i))=S(i) is bandwidth-bound, but a naive loop over either tensor
+     reads or writes the other one with large strides, thus wasting most of each cache line.
+     The transpose kernels are cache-blocked instead: The fastest source dimensions form
+     the A group and the fastest remaining destination dimensions form the B group, each
+     of at least BLOCK elements (unless the tensor is smaller). A tile of BLOCK x BLOCK
+     elements of the (A,B) plane is read and written with short strides only, with the
+     A loop innermost (contiguous source reads, SIMD-vectorizable), for each multi-index
+     of the remaining (outer) dimensions. The (outer, B-tile) pairs are distributed among
+     OpenMP threads when the tensor is large enough.
+ (b) The element offsets of the A, B and outer groups in both tensors are tabulated once
+     per transpose plan (scatter vectors), thus the loops are independent of the tensor rank.
+     This also serves high-rank tensors of small extents (e.g., quantum circuit tensors with
+     extents of 2), whose dimensions are fused into the A and B groups. A transpose plan
+     only depends on the tensor shape and the permutation, thus it can be cached and reused.
+ (c) The kernels compute D = alpha * S (+ D, if accumulative) with an optional complex
+     conjugation of S, thus they also cover the accumulation of a permuted tensor.
+**/
+
+#ifndef EXATN_RUNTIME_TENSOR_TRANSPOSE_KERNELS_HPP_
+#define EXATN_RUNTIME_TENSOR_TRANSPOSE_KERNELS_HPP_
+
+#include "tensor_symbol.hpp"
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cstddef>
+
+namespace exatn {
+namespace runtime {
+
+/** Dimension permutation of a tensor transpose D(perm(i))=S(i). **/
+struct TensorTransposePattern{
+  std::vector<int> permutation; //position of each destination dimension in the source tensor
+  bool conj;                    //complex conjugation of the source tensor
+};
+
+/** Transpose plan (offset tables of the A, B and outer dimension groups) for a given tensor shape. **/
+struct TensorTransposePlan{
+  static constexpr const std::size_t BLOCK = 32;                   //tile edge (number of elements)
+  static constexpr const std::size_t PARALLEL_VOLUME = 65536;      //min tensor volume transposed by multiple threads
+
+  std::size_t volume = 0;                  //tensor volume
+  std::vector<std::size_t> a_offset[2];    //offsets of the A multi-indices in the destination/source tensor
+  std::vector<std::size_t> b_offset[2];    //offsets of the B multi-indices in the destination/source tensor
+  std::vector<std::size_t> outer_offset[2]; //offsets of the outer multi-indices in the destination/source tensor
+};
+
+
+/** Parses a (reduced) symbolic tensor addition/copy pattern D(...)+=S(...) into a dimension permutation.
+    Returns FALSE if it is not a pure dimension permutation (e.g., traces or diagonals). **/
+inline bool parse_tensor_transpose(const std::string & pattern,      //in: symbolic tensor addition/copy pattern
+                                   TensorTransposePattern & transpose) //out: dimension permutation
+{
+  std::vector<std::string> tensors;
+  if(!parse_tensor_network(pattern,tensors)) return false;
+  if(tensors.size() != 2) return false;
+  std::string tensor_name;
+  std::vector<IndexLabel> dest_indices, src_indices;
+  bool dest_conj = false;
+  if(!parse_tensor(tensors[0],tensor_name,dest_indices,dest_conj)) return false;
+  if(!parse_tensor(tensors[1],tensor_name,src_indices,transpose.conj)) return false;
+  if(dest_conj || dest_indices.size() != src_indices.size()) return false;
+  const auto rank = dest_indices.size();
+  transpose.permutation.assign(rank,-1);
+  std::vector<bool> used(rank,false);
+  for(std::size_t i = 0; i < rank; ++i){
+    for(std::size_t j = 0; j < rank; ++j){
+      if(!used[j] && src_indices[j].label == dest_indices[i].label){
+        transpose.permutation[i] = static_cast<int>(j);
+        used[j] = true;
+        break;
+      }
+    }
+    if(transpose.permutation[i] < 0) return false;
+  }
+  return true;
+}
+
+
+/** Builds the offset table of a group of dimensions (first one is the fastest) in two tensors. **/
+inline void transpose_offset_table(const std::vector<std::size_t> & extents,     //in: extents of the dimensions
+                                   const std::vector<std::size_t> (& strides)[2], //in: strides of the dimensions in both tensors
+                                   std::vector<std::size_t> (& offsets)[2])       //out: offsets of the multi-indices in both tensors
+{
+  std::size_t volume = 1;
+  for(const auto extent: extents) volume *= extent;
+  offsets[0].resize(volume); offsets[1].resize(volume);
+  std::vector<std::size_t> index(extents.size(),0);
+  std::size_t offset[2] = {0,0};
+  for(std::size_t n = 0; n < volume; ++n){
+    offsets[0][n] = offset[0]; offsets[1][n] = offset[1];
+    for(std::size_t i = 0; i < extents.size(); ++i){ //next multi-index
+      offset[0] += strides[0][i]; offset[1] += strides[1][i];
+      if(++(index[i]) < extents[i]) break;
+      offset[0] -= extents[i] * strides[0][i]; offset[1] -= extents[i] * strides[1][i];
+      index[i] = 0;
+    }
+  }
+  return;
+}
+
+
+/** Sets up the transpose plan for given source tensor extents.
+    Returns FALSE if the permutation does not match the tensor rank. **/
+template <typename ExtentType>
+bool setup_tensor_transpose(const TensorTransposePattern & transpose, //in: dimension permutation
+                            unsigned int rank,                        //in: tensor rank
+                            const ExtentType * src_extents,           //in: extents of the source tensor
+                            TensorTransposePlan & plan)               //out: transpose plan
+{
+  if(transpose.permutation.size() != rank) return false;
+  std::vector<std::size_t> extents(rank), strides[2]; //destination/source strides of the source dimensions
+  strides[0].resize(rank); strides[1].resize(rank);
+  std::size_t stride = 1;
+  for(unsigned int i = 0; i < rank; ++i){
+    extents[i] = static_cast<std::size_t>(src_extents[i]);
+    strides[1][i] = stride;
+    stride *= extents[i];
+  }
+  plan.volume = stride;
+  stride = 1;
+  for(unsigned int i = 0; i < rank; ++i){
+    strides[0][transpose.permutation[i]] = stride;
+    stride *= extents[transpose.permutation[i]];
+  }
+  //Assign the source dimensions to the groups {0:A, 1:B, 2:outer}:
+  std::vector<int> group(rank,2);
+  std::size_t a_volume = 1, b_volume = 1;
+  for(unsigned int i = 0; i < rank && a_volume < TensorTransposePlan::BLOCK; ++i){ //fastest source dimensions
+    group[i] = 0; a_volume *= extents[i];
+  }
+  for(unsigned int i = 0; i < rank && b_volume < TensorTransposePlan::BLOCK; ++i){ //fastest remaining destination dimensions
+    const int dim = transpose.permutation[i];
+    if(group[dim] == 2){
+      group[dim] = 1; b_volume *= extents[dim];
+    }
+  }
+  std::vector<std::size_t> group_extents[3], group_strides[3][2];
+  for(unsigned int i = 0; i < rank; ++i){ //source order within the A and outer groups
+    if(group[i] != 1){
+      group_extents[group[i]].emplace_back(extents[i]);
+      group_strides[group[i]][0].emplace_back(strides[0][i]);
+      group_strides[group[i]][1].emplace_back(strides[1][i]);
+    }
+  }
+  for(unsigned int i = 0; i < rank; ++i){ //destination order within the B group
+    const int dim = transpose.permutation[i];
+    if(group[dim] == 1){
+      group_extents[1].emplace_back(extents[dim]);
+      group_strides[1][0].emplace_back(strides[0][dim]);
+      group_strides[1][1].emplace_back(strides[1][dim]);
+    }
+  }
+  transpose_offset_table(group_extents[0],group_strides[0],plan.a_offset);
+  transpose_offset_table(group_extents[1],group_strides[1],plan.b_offset);
+  transpose_offset_table(group_extents[2],group_strides[2],plan.outer_offset);
+  return true;
+}
+
+
+template <typename NumericType>
+inline NumericType transpose_conjugated(const NumericType & value){return value;}
+
+template <typename RealType>
+inline std::complex<RealType> transpose_conjugated(const std::complex<RealType> & value){return std::conj(value);}
+
+
+/** Tensor transpose kernel: dest = alpha * permuted(src) (+ dest, if accumulative),
+    where the source tensor may be complex conjugated (ignored for real types). **/
+template <typename NumericType>
+void tensor_transpose(const TensorTransposePlan & plan,
+                      NumericType * __restrict__ dest,
+                      const NumericType * __restrict__ src,
+                      NumericType alpha,
+                      bool accumulative,
+                      bool conj = false)
+{
+  constexpr std::size_t BLOCK = TensorTransposePlan::BLOCK;
+  const std::size_t a_volume = plan.a_offset[0].size();
+  const std::size_t b_volume = plan.b_offset[0].size();
+  const std::size_t b_tiles = (b_volume + BLOCK - 1) / BLOCK;
+  const long long num_tasks = static_cast<long long>(plan.outer_offset[0].size() * b_tiles);
+  const bool plain = (alpha == NumericType(1) && !accumulative && !conj);
+  const std::size_t * a_dest = plan.a_offset[0].data();
+  const std::size_t * a_src = plan.a_offset[1].data();
+#pragma omp parallel for schedule(static) if(plan.volume >= TensorTransposePlan::PARALLEL_VOLUME)
+  for(long long t = 0; t < num_tasks; ++t){
+    const std::size_t outer = static_cast<std::size_t>(t) / b_tiles;
+    const std::size_t b_base = (static_cast<std::size_t>(t) % b_tiles) * BLOCK;
+    const std::size_t b_end = std::min(b_base + BLOCK,b_volume);
+    const std::size_t outer_dest = plan.outer_offset[0][outer];
+    const std::size_t outer_src = plan.outer_offset[1][outer];
+    for(std::size_t a_base = 0; a_base < a_volume; a_base += BLOCK){
+      const std::size_t a_end = std::min(a_base + BLOCK,a_volume);
+      for(std::size_t j = b_base; j < b_end; ++j){
+        NumericType * d = &(dest[outer_dest + plan.b_offset[0][j]]);
+        const NumericType * s = &(src[outer_src + plan.b_offset[1][j]]);
+        if(plain){
+#pragma omp simd
+          for(std::size_t i = a_base; i < a_end; ++i) d[a_dest[i]] = s[a_src[i]];
+        }else{
+          for(std::size_t i = a_base; i < a_end; ++i){
+            const NumericType value = alpha * (conj ? transpose_conjugated(s[a_src[i]]) : s[a_src[i]]);
+            d[a_dest[i]] = accumulative ? (d[a_dest[i]] + value) : value;
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_TENSOR_TRANSPOSE_KERNELS_HPP_
@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Tensor graph executor
-REVISION: 2022/03/07
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -11,6 +11,40 @@ Rationale:
      (tensor operation stored in the DAG node accepts a polymorphic
      tensor node executor which then executes that tensor operation).
      The execution of each DAG node is generally asynchronous.
+ (b) All waits on the execution state of the tensor graph executor
+     are performed via a spin-then-park Waiter whose spin budget
+     is regulated by the "runtime_spin_budget" runtime parameter.
+ (c) The structured execution trace (ExecTrace) is activated by the
+     "runtime_exec_trace" runtime parameter (0:off, 1:on), with the ring
+     capacity (number of events) set by the "runtime_exec_trace_capacity"
+     runtime parameter. The trace is dumped as a Chrome trace JSON file
+     "exatn_exec_trace.<global_rank>.<scope>.json" upon scope closure.
+ (d) The performance counters (ExecMetrics) are always on and can be
+     read at any time via getMetrics().
+ (e) The execution quantum limits the number of DAG traversal iterations
+     performed by a single call to execute(dag) before it returns control
+     to the caller with the unfinished tensor operations left in flight,
+     thus allowing the tensor runtime to time-slice the execution among
+     multiple concurrently executed DAGs. A graph executor which cannot
+     leave tensor operations in flight across calls ignores the quantum.
+ (f) The memory timeline (MemoryTimeline) of the node executor, if activated,
+     is reported into a text file "exatn_memory_timeline.<global_rank>.<scope>.txt"
+     upon scope closure. Its high-water mark of the tensor memory is reported
+     in the performance counters.
+ (g) The roofline profile (ExecProfile) of the executed tensor operations is activated by
+     the "runtime_exec_profile" runtime parameter (0:off, 1:on), with the peak performance
+     of the Host and accelerators set by the "runtime_exec_profile_host_gflops",
+     "runtime_exec_profile_host_gbps", "runtime_exec_profile_device_gflops" and
+     "runtime_exec_profile_device_gbps" runtime parameters (real). The profile is reported
+     into a text file "exatn_exec_profile.<global_rank>.<scope>.txt" upon scope closure.
+ (h) The process-wide communication profile (CommProfile) is activated by the "runtime_comm_profile"
+     runtime parameter (0:off, 1:on) and is reported into a text file
+     "exatn_comm_profile.<global_rank>.<scope>.txt" upon scope closure.
+ (i) The asynchronous binary execution log (ExecLog) is selected by the "runtime_exec_log_binary"
+     runtime parameter (0:off, 1:on), with the ring capacity (number of records) set by
+     the "runtime_exec_log_capacity" runtime parameter. Once logging is enabled, a graph executor
+     supporting it logs its per-operation events into "exatn_exec_thread.<global_rank>.bin"
+     instead of formatting them into the text log (decoded offline by exatn_exec_log_decode).
 **/
 
 #ifndef EXATN_RUNTIME_TENSOR_GRAPH_EXECUTOR_HPP_
@@ -22,13 +56,20 @@ Rationale:
 #include "tensor_network_queue.hpp"
 #include "tensor_node_executor.hpp"
 #include "tensor_operation.hpp"
+#include "exec_trace.hpp"
+#include "exec_profile.hpp"
+#include "exec_log.hpp"
+#include "exec_metrics.hpp"
 
 #include "param_conf.hpp"
+#include "comm_profile.hpp"
 
 #include "timers.hpp"
+#include "waiter.hpp"
 
 #include <memory>
 #include <atomic>
+#include <algorithm>
 
 #include <iostream>
 #include <fstream>
@@ -46,8 +87,9 @@ public:
   TensorGraphExecutor():
    node_executor_(nullptr), num_ops_issued_(0),
    num_processes_(0), process_rank_(-1), global_process_rank_(-1),
-   logging_(0), initialized_(false), stopping_(false), active_(false),
-   serialize_(false), validation_tracing_(false),
+   logging_(0), exec_log_binary_(false), exec_log_capacity_(ExecLog::DEFAULT_CAPACITY),
+   initialized_(false), stopping_(false), active_(false),
+   serialize_(false), validation_tracing_(false), exec_quantum_(0),
    time_start_(exatn::Timer::timeInSecHR())
   {
   }
@@ -68,10 +110,33 @@ public:
                                  unsigned int num_processes,
                                  unsigned int process_rank,
                                  unsigned int global_process_rank) {
+    int64_t spin_budget = Waiter::DEFAULT_SPIN_BUDGET;
+    if(parameters.getParameter("runtime_spin_budget",&spin_budget)) waiter_.resetSpinBudget(spin_budget);
+    int64_t exec_trace = 0, exec_trace_capacity = ExecTrace::DEFAULT_CAPACITY;
+    parameters.getParameter("runtime_exec_trace",&exec_trace);
+    parameters.getParameter("runtime_exec_trace_capacity",&exec_trace_capacity);
+    exec_trace_.activate((exec_trace != 0 && exec_trace_capacity > 0) ? static_cast<std::size_t>(exec_trace_capacity) : 0);
+    int64_t exec_profile = 0;
+    ExecProfile::Peak host_peak, device_peak;
+    parameters.getParameter("runtime_exec_profile",&exec_profile);
+    parameters.getParameter("runtime_exec_profile_host_gflops",&(host_peak.gflops));
+    parameters.getParameter("runtime_exec_profile_host_gbps",&(host_peak.gbps));
+    parameters.getParameter("runtime_exec_profile_device_gflops",&(device_peak.gflops));
+    parameters.getParameter("runtime_exec_profile_device_gbps",&(device_peak.gbps));
+    exec_profile_.activate(exec_profile != 0,host_peak,device_peak);
+    int64_t comm_profile = 0;
+    parameters.getParameter("runtime_comm_profile",&comm_profile);
+    getCommProfile().activate(comm_profile != 0);
+    int64_t exec_log_binary = 0, exec_log_capacity = ExecLog::DEFAULT_CAPACITY;
+    parameters.getParameter("runtime_exec_log_binary",&exec_log_binary);
+    parameters.getParameter("runtime_exec_log_capacity",&exec_log_capacity);
+    exec_log_binary_.store(exec_log_binary != 0 && exec_log_capacity > 0);
+    if(exec_log_capacity > 0) exec_log_capacity_.store(static_cast<std::size_t>(exec_log_capacity));
     initialized_.store(false);
     num_processes_.store(num_processes);
     process_rank_.store(process_rank);
     global_process_rank_.store(global_process_rank);
+    waiter_.notify();
     bool executor_on = false;
     if(node_executor){
       if(logging_.load() != 0){
@@ -88,20 +153,38 @@ public:
     }
     node_executor_ = node_executor;
     initialized_.store(executor_on);
+    waiter_.notify();
     return;
   }
 
+  /** Returns the current DAG node executor (for handing it over to another DAG executor). **/
+  std::shared_ptr<TensorNodeExecutor> getNodeExecutor() const {
+    return node_executor_;
+  }
+
   bool nodeExecutorInitialized() const {
     return initialized_.load();
   }
 
+  /** Blocks until the node executor has been initialized. **/
+  void waitNodeExecutorInitialized() const {
+    waiter_.wait([this](){return nodeExecutorInitialized();});
+    return;
+  }
+
   /** Resets the logging level (0:none). **/
   void resetLoggingLevel(int level = 0) {
     if(logging_.load() == 0){
-      while(level != 0 && global_process_rank_.load() < 0);
+      if(level != 0) waiter_.wait([this](){return (global_process_rank_.load() >= 0);});
       if(level != 0) logfile_.open("exatn_exec_thread."+std::to_string(global_process_rank_.load())+".log", std::ios::out | std::ios::trunc);
+      if(level != 0 && exec_log_binary_.load()){
+        exec_log_.open("exatn_exec_thread."+std::to_string(global_process_rank_.load())+".bin",exec_log_capacity_.load());
+      }
     }else{
-      if(level == 0) logfile_.close();
+      if(level == 0){
+        exec_log_.close();
+        logfile_.close();
+      }
     }
     logging_.store(level);
     return;
@@ -115,21 +198,27 @@ public:
     return;
   }
 
+  /** Returns the serialization status of the DAG execution and, optionally, of validation tracing. **/
+  bool isSerialized(bool * validation_trace = nullptr) const {
+    if(validation_trace != nullptr) *validation_trace = validation_tracing_.load();
+    return serialize_.load();
+  }
+
   /** Activates/deactivates dry run (no actual computations). **/
   void activateDryRun(bool dry_run) {
-   while(!nodeExecutorInitialized());
+   waitNodeExecutorInitialized();
    return node_executor_->activateDryRun(dry_run);
   }
 
   /** Activates mixed-precision fast math on all devices (if available). **/
   void activateFastMath() {
-    while(!nodeExecutorInitialized());
+    waitNodeExecutorInitialized();
     return node_executor_->activateFastMath();
   }
 
   /** Returns the Host memory buffer size in bytes provided by the node executor. **/
   std::size_t getMemoryBufferSize() const {
-    while(!nodeExecutorInitialized());
+    waitNodeExecutorInitialized();
     return node_executor_->getMemoryBufferSize();
   }
 
@@ -137,13 +226,34 @@ public:
       Note that the returned value includes buffer fragmentation overhead. **/
   std::size_t getMemoryUsage(std::size_t * free_mem) const {
     assert(free_mem != nullptr);
-    while(!nodeExecutorInitialized());
+    waitNodeExecutorInitialized();
     return node_executor_->getMemoryUsage(free_mem);
   }
 
+  /** Returns the current memory fragmentation factor: The ratio of the memory usage
+      (including buffer fragmentation overhead) to the total size of all allocated tensors
+      (1.0: no overhead). Returns 0.0 if unknown (no allocated tensors or not tracked).
+      The total size of all allocated tensors is returned in tensor_mem, if provided. **/
+  double getMemoryFragmentation(std::size_t * tensor_mem = nullptr) const {
+    waitNodeExecutorInitialized();
+    const auto tensor_volume = node_executor_->getTensorMemoryUsage();
+    if(tensor_mem != nullptr) *tensor_mem = tensor_volume;
+    if(tensor_volume == 0) return 0.0;
+    std::size_t free_mem = 0;
+    const auto used_mem = node_executor_->getMemoryUsage(&free_mem);
+    return std::max(1.0,static_cast<double>(used_mem) / static_cast<double>(tensor_volume));
+  }
+
+  /** Returns the peak memory of a binary tensor contraction relative to the volume
+      of its tensor operands, as determined by the node executor. **/
+  double getContractionMemoryFactor() const {
+    waitNodeExecutorInitialized();
+    return node_executor_->getContractionMemoryFactor();
+  }
+
   /** Returns the current value of the total Flop count executed by the node executor. **/
   virtual double getTotalFlopCount() const {
-    while(!nodeExecutorInitialized());
+    waitNodeExecutorInitialized();
     return node_executor_->getTotalFlopCount();
   }
 
@@ -168,12 +278,133 @@ public:
     return node_executor_->getLocalTensor(tensor,slice_spec);
   }
 
+  /** Returns a read-only zero-copy view of a given tensor (pins the tensor). **/
+  TensorView getTensorView(const numerics::Tensor & tensor) {
+    assert(node_executor_);
+    return node_executor_->getTensorView(tensor);
+  }
+
+  /** Sets the execution quantum: The max number of DAG traversal iterations
+      performed by a single call to execute(dag), 0 means unlimited. **/
+  void resetExecutionQuantum(std::size_t num_iterations) {
+    exec_quantum_.store(num_iterations);
+    return;
+  }
+
+  /** Returns the current execution quantum (0: unlimited). **/
+  std::size_t getExecutionQuantum() const {
+    return exec_quantum_.load();
+  }
+
   /** Signals to stop execution of the DAG until later resume
       and waits until the execution has actually stopped.
       [THREAD: This function is executed by the main thread] **/
   void stopExecution() {
-    stopping_.store(true);   //this signal will be picked by the execution thread
-    while(active_.load()){}; //once the DAG execution is stopped the execution thread will set active_ to FALSE
+    stopping_.store(true); //this signal will be picked by the execution thread
+    waiter_.wait([this](){return !(active_.load());}); //once the DAG execution is stopped the execution thread will set active_ to FALSE
+    return;
+  }
+
+  /** Dumps the structured execution trace recorded so far (if active) into
+      a Chrome trace JSON file "exatn_exec_trace.<global_rank>.<scope>.json".
+      Must not be called while the execution thread is executing the DAG.
+      [THREAD: This function is executed by the main thread] **/
+  bool dumpExecTrace(const std::string & scope_name) {
+    if(!(exec_trace_.isActive())) return true;
+    const auto rank = global_process_rank_.load();
+    const std::string filename = "exatn_exec_trace." + std::to_string(rank) + "." + scope_name + ".json";
+    const bool dumped = exec_trace_.dumpChromeTrace(filename,rank);
+    if(!dumped) std::cout << "#ERROR(exatn::runtime::TensorGraphExecutor): Unable to write the execution trace file "
+                          << filename << std::endl << std::flush;
+    return dumped;
+  }
+
+  /** Writes the roofline profile of the executed tensor operations recorded so far (if active)
+      into a text file "exatn_exec_profile.<global_rank>.<scope>.txt".
+      Must not be called while the execution thread is executing the DAG.
+      [THREAD: This function is executed by the main thread] **/
+  bool dumpExecProfile(const std::string & scope_name) {
+    if(!(exec_profile_.isActive())) return true;
+    const auto rank = global_process_rank_.load();
+    const std::string filename = "exatn_exec_profile." + std::to_string(rank) + "." + scope_name + ".txt";
+    const bool dumped = exec_profile_.dumpReport(filename,rank);
+    if(!dumped) std::cout << "#ERROR(exatn::runtime::TensorGraphExecutor): Unable to write the execution profile file "
+                          << filename << std::endl << std::flush;
+    return dumped;
+  }
+
+  /** Writes the communication profile recorded so far (if active) into
+      a text file "exatn_comm_profile.<global_rank>.<scope>.txt".
+      [THREAD: This function is executed by the main thread] **/
+  bool dumpCommProfile(const std::string & scope_name) {
+    auto & comm_profile = getCommProfile();
+    if(!(comm_profile.isActive())) return true;
+    const auto rank = global_process_rank_.load();
+    const std::string filename = "exatn_comm_profile." + std::to_string(rank) + "." + scope_name + ".txt";
+    const bool dumped = comm_profile.dumpReport(filename,rank);
+    if(!dumped) std::cout << "#ERROR(exatn::runtime::TensorGraphExecutor): Unable to write the communication profile file "
+                          << filename << std::endl << std::flush;
+    return dumped;
+  }
+
+  /** Writes the memory timeline report of the node executor (if active) into
+      a text file "exatn_memory_timeline.<global_rank>.<scope>.txt".
+      Must not be called while the execution thread is executing the DAG.
+      [THREAD: This function is executed by the main thread] **/
+  bool dumpMemoryTimeline(const std::string & scope_name) {
+    auto * timeline = getMemoryTimeline();
+    if(timeline == nullptr || !(timeline->isActive())) return true;
+    const auto rank = global_process_rank_.load();
+    const std::string filename = "exatn_memory_timeline." + std::to_string(rank) + "." + scope_name + ".txt";
+    const bool dumped = timeline->dumpReport(filename,rank);
+    if(!dumped) std::cout << "#ERROR(exatn::runtime::TensorGraphExecutor): Unable to write the memory timeline file "
+                          << filename << std::endl << std::flush;
+    return dumped;
+  }
+
+  /** Returns the memory timeline of the node executor (nullptr if not tracked).
+      [THREAD: This function can be executed by any thread] **/
+  MemoryTimeline * getMemoryTimeline() const {
+    if(!nodeExecutorInitialized()) return nullptr;
+    return node_executor_->getMemoryTimeline();
+  }
+
+  /** Returns a snapshot of the performance counters.
+      [THREAD: This function can be executed by any thread] **/
+  RuntimeMetrics getMetrics() const {
+    auto metrics = exec_metrics_.getSnapshot();
+    if(nodeExecutorInitialized()){
+      node_executor_->getTransferVolume(&(metrics.host_to_device_bytes),&(metrics.device_to_host_bytes));
+      metrics.tensor_memory_bytes = node_executor_->getTensorMemoryUsage();
+      metrics.memory_usage_bytes = node_executor_->getMemoryUsage(&(metrics.memory_free_bytes));
+      metrics.memory_peak_bytes = std::max(metrics.memory_peak_bytes,metrics.memory_usage_bytes);
+      const auto * timeline = node_executor_->getMemoryTimeline();
+      if(timeline != nullptr) metrics.tensor_memory_peak_bytes = timeline->getPeakBytes();
+      metrics.memory_fragmentation = getMemoryFragmentation();
+      for(auto & stats: metrics.devices){
+        if(stats.device >= 0) node_executor_->getDeviceLoad(stats.device,&(stats.queued_flops),&(stats.free_memory_bytes));
+      }
+    }
+    return metrics;
+  }
+
+  /** Resets the performance counters (except the data transfer volume). **/
+  void resetMetrics() {
+    exec_metrics_.reset();
+    auto * timeline = getMemoryTimeline();
+    if(timeline != nullptr) timeline->resetPeak();
+    return;
+  }
+
+  /** Records the time the execution thread spent idle waiting for new work (sec). **/
+  inline void recordIdleTime(double time_interval) {
+    exec_metrics_.recordIdleTime(time_interval);
+    return;
+  }
+
+  /** Records the current state of the executed DAG (for live monitoring). **/
+  inline void recordDagState(TensorGraph & dag) {
+    exec_metrics_.recordDagState(dag.getNumNodes(),dag.getFrontNode());
     return;
   }
 
@@ -185,19 +416,64 @@ public:
 
 protected:
 
+  /** Records an executed DAG node in the performance counters, the execution trace and profile
+      (must be called before the tensor operands of its tensor operation are dissociated). **/
+  inline void recordNodeExecuted(TensorOpNode & dag_node,
+                                 VertexIdType node_id,
+                                 int device = -1,
+                                 unsigned int thread = 0) {
+    const auto & op = *(dag_node.getOperation());
+    exec_metrics_.recordExecuted(op,device);
+    if(op.getOpcode() == TensorOpCode::CREATE && nodeExecutorInitialized()){
+      std::size_t free_mem = 0;
+      exec_metrics_.recordMemoryUsage(node_executor_->getMemoryUsage(&free_mem));
+    }
+    const auto prefetch = dag_node.getPrefetchStatus();
+    if(prefetch != TensorOpNode::PREFETCH_NONE) exec_metrics_.recordPrefetch(prefetch == TensorOpNode::PREFETCH_INITIATED);
+    exec_trace_.record(ExecTrace::EventKind::EXECUTED,op,node_id,device,thread);
+    exec_profile_.record(op,device);
+    return;
+  }
+
+  /** Records a postponed (TRY_LATER) DAG node in the performance counters and the execution trace. **/
+  inline void recordNodePostponed(TensorOpNode & dag_node,
+                                  VertexIdType node_id,
+                                  unsigned int thread = 0) {
+    exec_metrics_.recordPostponed();
+    exec_trace_.record(ExecTrace::EventKind::POSTPONED,*(dag_node.getOperation()),node_id,-1,thread);
+    return;
+  }
+
+  /** Records an attempted prefetch of the tensor operands of a DAG node. **/
+  inline void recordNodePrefetch(TensorOpNode & dag_node,
+                                 VertexIdType node_id,
+                                 bool initiated) {
+    dag_node.setPrefetchStatus(initiated);
+    if(initiated) exec_trace_.record(ExecTrace::EventKind::PREFETCH,*(dag_node.getOperation()),node_id);
+    return;
+  }
+
   std::shared_ptr<TensorNodeExecutor> node_executor_; //intr-node tensor operation executor
   std::atomic<std::size_t> num_ops_issued_; //total number of issued tensor operations
   std::atomic<int> num_processes_; //number of parallel processes
   std::atomic<int> process_rank_; //current process rank
   std::atomic<int> global_process_rank_; //current global process rank (in MPI_COMM_WORLD)
   std::atomic<int> logging_;      //logging level (0:none)
+  std::atomic<bool> exec_log_binary_; //whether or not the asynchronous binary execution log is selected
+  std::atomic<std::size_t> exec_log_capacity_; //ring capacity of the binary execution log (records)
   std::atomic<bool> initialized_; //initialization status of the node executor
   std::atomic<bool> stopping_;    //signal to pause the execution thread
   std::atomic<bool> active_;      //TRUE while the execution thread is executing DAG operations
   std::atomic<bool> serialize_;   //serialization of the DAG execution
   std::atomic<bool> validation_tracing_; //validation tracing flag
+  std::atomic<std::size_t> exec_quantum_; //max number of DAG traversal iterations per execute(dag) call (0:unlimited)
   const double time_start_;       //start time stamp
   std::ofstream logfile_;         //logging file stream (output)
+  ExecLog exec_log_;              //asynchronous binary execution log
+  ExecTrace exec_trace_;          //structured execution trace
+  ExecProfile exec_profile_;      //roofline profile of the executed tensor operations
+  ExecMetrics exec_metrics_;      //performance counters
+  mutable Waiter waiter_;         //spin-then-park waiter for the execution state changes
 };
 
 } //namespace runtime
@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Tensor graph node executor
-REVISION: 2022/03/07
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -22,6 +22,8 @@ Rationale:
 
 #include "tensor_op_factory.hpp"
 #include "tensor.hpp"
+#include "tensor_view.hpp"
+#include "memory_timeline.hpp"
 #include "space_register.hpp"
 
 #include "param_conf.hpp"
@@ -51,7 +53,9 @@ public:
 
   virtual ~TensorNodeExecutor() = default;
 
-  /** Explicitly initializes the underlying numerical service, if needed. **/
+  /** Explicitly initializes the underlying numerical service, if needed.
+      Initializing an already initialized node executor (handed over to a new runtime
+      configuration) only applies the new parameters, keeping the existing tensors. **/
   virtual void initialize(const ParamConf & parameters) = 0;
 
   /** Activates dry run (no actual computations). **/
@@ -67,9 +71,35 @@ public:
       Note that the returned value includes buffer fragmentation overhead. **/
   virtual std::size_t getMemoryUsage(std::size_t * free_mem) const = 0;
 
+  /** Returns the total size of the bodies of all currently allocated tensors in bytes,
+      excluding any buffer fragmentation overhead (zero if not tracked). **/
+  virtual std::size_t getTensorMemoryUsage() const {return 0;}
+
+  /** Returns the memory timeline (tensor allocation/free events and the high-water mark
+      of the tensor memory) tracked by the node executor (nullptr if not tracked). **/
+  virtual MemoryTimeline * getMemoryTimeline() {return nullptr;}
+
+  /** Returns the peak memory of a binary tensor contraction relative to the volume of its tensor
+      operands (2.0: the tensor operands are transposed into temporary copies). **/
+  virtual double getContractionMemoryFactor() const {return 2.0;}
+
   /** Returns the current value of the total Flop count executed by the node executor. **/
   virtual double getTotalFlopCount() const = 0;
 
+  /** Returns the total volume of Host-to-device and device-to-Host data transfers (bytes). **/
+  virtual void getTransferVolume(std::size_t * host_to_device,
+                                 std::size_t * device_to_host) const {
+    *host_to_device = 0; *device_to_host = 0;
+    return;
+  }
+
+  /** Returns a read-only zero-copy view of the local tensor body in the Host buffer,
+      pinning the tensor until the view is released. Returns an empty view if
+      zero-copy views are not supported by the node executor. **/
+  virtual TensorView getTensorView(const numerics::Tensor & tensor) {
+    return TensorView();
+  }
+
   /** Executes the tensor operation found in a DAG node asynchronously,
       returning the execution handle in exec_handle that can later be
       used for testing for completion of the operation execution.
@@ -113,6 +143,17 @@ public:
   /** Synchronizes the execution of all currently progressing tensor operations. **/
   virtual bool sync() = 0;
 
+  /** Returns the flat id of the device executing a previously submitted (not yet synced)
+      tensor operation, or -1 if unknown (Host or no device assignment). **/
+  virtual int getExecutionDevice(TensorOpExecHandle op_handle) const {return -1;}
+
+  /** Returns the work (Flop count) currently queued on a given device (flat id)
+      and its free memory (bytes). Returns FALSE if the device load is not tracked.
+      [THREAD: This function can be executed by any thread] **/
+  virtual bool getDeviceLoad(int device,
+                             double * queued_flops,
+                             std::size_t * free_mem) const {return false;}
+
   /** Discards a previously submitted tensor operation. **/
   virtual bool discard(TensorOpExecHandle op_handle) = 0;
 
@@ -122,6 +163,14 @@ public:
   /** Clears all internal node executor caches **/
   virtual void clearCache() = 0;
 
+  /** Resets the lookahead window of tensor operands of the upcoming tensor operations
+      (in the order of their expected execution, repeats allowed), which the node executor
+      may use for its cache eviction decisions (tensors needed the latest are evicted first). **/
+  virtual void resetLookahead(const std::vector<numerics::TensorHashType> & upcoming) {return;}
+
+  /** Returns TRUE if the node executor accepts concurrent calls from multiple threads. **/
+  virtual bool isThreadSafe() const {return false;}
+
   /** Returns a local copy of a given tensor slice. **/
   virtual std::shared_ptr<talsh::Tensor> getLocalTensor(const numerics::Tensor & tensor,
                          const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec) = 0;
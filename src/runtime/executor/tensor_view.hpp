@@ -0,0 +1,104 @@
+/** ExaTN:: Tensor Runtime: Read-only zero-copy view of a local tensor
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) A tensor view provides read-only access to the local tensor body
+     directly in the Host buffer of the node executor, without copying.
+     The tensor body is stored in the column-major (Fortran) order with
+     the dimension extents of the full tensor shape.
+ (b) A tensor view is a reference-counted handle: All copies of a tensor view
+     share the same pin on the tensor, which is released once the last copy
+     has been destroyed (or released explicitly). While pinned, the tensor
+     cannot be destroyed, updated or migrated away from the Host by the node
+     executor: All tensor operations on a pinned tensor are postponed until
+     it is unpinned. Thus, a tensor view must be released before the tensor
+     is synchronized with any further tensor operations on it.
+ (c) A node executor which does not support zero-copy views returns an empty view,
+     in which case the tensor runtime falls back to a view over a private copy
+     of the tensor body (the copy is then owned by the view).
+**/
+
+#ifndef EXATN_RUNTIME_TENSOR_VIEW_HPP_
+#define EXATN_RUNTIME_TENSOR_VIEW_HPP_
+
+#include "tensor_basic.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace exatn {
+namespace runtime {
+
+class TensorView {
+
+public:
+
+  /** Empty view. **/
+  TensorView(): data_(nullptr), size_(0), element_type_(TensorElementType::VOID) {}
+
+  /** View over a non-owned tensor body pinned by a given pin (its deleter unpins). **/
+  TensorView(const void * data,                       //in: non-owning pointer to the tensor body
+             std::size_t size,                        //in: size of the tensor body in bytes
+             TensorElementType element_type,          //in: tensor element type
+             const std::vector<DimExtent> & extents,  //in: tensor dimension extents
+             std::shared_ptr<void> pin):              //in: pin on the tensor body (shared)
+   pin_(pin), data_(data), size_(size), element_type_(element_type), extents_(extents)
+  {
+  }
+
+  TensorView(const TensorView &) = default;
+  TensorView & operator=(const TensorView &) = default;
+  TensorView(TensorView &&) noexcept = default;
+  TensorView & operator=(TensorView &&) noexcept = default;
+  ~TensorView() = default;
+
+  /** Returns TRUE if the view is empty. **/
+  inline bool isEmpty() const {return (data_ == nullptr);}
+
+  /** Returns a non-owning pointer to the tensor body (column-major). **/
+  template <typename NumericType>
+  inline const NumericType * getData() const {return static_cast<const NumericType*>(data_);}
+
+  /** Returns a non-owning untyped pointer to the tensor body (column-major). **/
+  inline const void * getDataRaw() const {return data_;}
+
+  /** Returns the size of the tensor body in bytes. **/
+  inline std::size_t getSize() const {return size_;}
+
+  /** Returns the tensor element type. **/
+  inline TensorElementType getElementType() const {return element_type_;}
+
+  /** Returns the tensor dimension extents. **/
+  inline const std::vector<DimExtent> & getDimExtents() const {return extents_;}
+
+  /** Returns the tensor volume (number of elements). **/
+  inline std::size_t getVolume() const {
+    std::size_t vol = 1;
+    for(const auto & extent: extents_) vol *= static_cast<std::size_t>(extent);
+    return vol;
+  }
+
+  /** Releases this copy of the view (the tensor is unpinned once all copies are released). **/
+  inline void release() {
+    pin_.reset();
+    data_ = nullptr;
+    size_ = 0;
+    return;
+  }
+
+private:
+
+  std::shared_ptr<void> pin_;        //pin on the tensor body (shared by all copies of the view)
+  const void * data_;                //non-owning pointer to the tensor body
+  std::size_t size_;                 //size of the tensor body in bytes
+  TensorElementType element_type_;   //tensor element type
+  std::vector<DimExtent> extents_;   //tensor dimension extents
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_TENSOR_VIEW_HPP_
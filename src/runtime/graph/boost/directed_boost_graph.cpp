@@ -1,8 +1,8 @@
 /** ExaTN:: Tensor Runtime: Directed acyclic graph of tensor operations
-REVISION: 2021/09/21
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry Lyakh, Alex McCaskey, Tiffany Mintz
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Dmitry Lyakh, Alex McCaskey, Tiffany Mintz
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 **/
 
 #include "directed_boost_graph.hpp"
@@ -25,25 +25,8 @@ VertexIdType DirectedBoostGraph::addOperation(std::shared_ptr<TensorOperation> o
   auto vid = add_vertex(*dag_);
   (*dag_)[vid].properties = std::move(std::make_shared<TensorOpNode>(op));
   (*dag_)[vid].properties->setId(vid); //DAG node id is stored in the node properties
-  auto output_tensor = op->getTensorOperand(0); //output tensor operand
-  bool dependent = false; int epoch;
-  const auto * nodes = exec_state_.getTensorEpochNodes(*output_tensor,&epoch);
-  if(nodes != nullptr){
-    for(const auto & node_id: *nodes) addDependency(vid,node_id); //Write-after-Read & Write-after-Write
-    dependent = true;
-  }
-  exec_state_.registerTensorWrite(*output_tensor,vid);
-  unsigned int num_operands = op->getNumOperands();
-  for(unsigned int i = 1; i < num_operands; ++i){ //input tensor operands
-    auto tensor = op->getTensorOperand(i);
-    nodes = exec_state_.getTensorEpochNodes(*tensor,&epoch);
-    if(epoch < 0){ //write epoch: Read-after-Write
-      for(const auto & node_id: *nodes) addDependency(vid,node_id);
-      dependent = true;
-    }
-    exec_state_.registerTensorRead(*tensor,vid);
-  }
-  //if(!dependent) exec_state_.registerDependencyFreeNode(vid);
+  registerOperationDependencies(vid,*op);
+  if(prioritiesActive()) updatePriorities(vid);
   unlock();
   return vid; //new node id in the DAG
 }
@@ -171,8 +154,10 @@ void DirectedBoostGraph::printIt()
 void DirectedBoostGraph::clear()
 {
   lock();
+  resetStaging();
   dag_->clear();
   exec_state_.clear();
+  boosted_nodes_.clear();
   unlock();
   return;
 }
@@ -0,0 +1,222 @@
+/** ExaTN:: Tensor Runtime: Directed acyclic graph of tensor operations: Compressed sparse row storage
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+**/
+
+#include "csr_graph.hpp"
+
+#include <limits>
+#include <iostream>
+
+#include "errors.hpp"
+
+namespace exatn {
+namespace runtime {
+
+CSRGraph::CSRGraph():
+ base_node_(0), base_edge_(0), edge_offsets_(1,0)
+{
+  edge_offsets_.reserve(DEFAULT_NODE_CAPACITY+1);
+  edges_.reserve(DEFAULT_EDGE_CAPACITY);
+  retired_node_.setExecuting();
+  retired_node_.setExecuted(0);
+}
+
+
+VertexIdType CSRGraph::addOperation(std::shared_ptr<TensorOperation> op) {
+  lock();
+  const VertexIdType vid = base_node_.load() + nodes_.size();
+  nodes_.emplace_back(op);
+  nodes_.back().setId(vid); //DAG node id is stored in the node properties
+  edge_offsets_.emplace_back(edge_offsets_.back());
+  registerOperationDependencies(vid,*op);
+  if(prioritiesActive()) updatePriorities(vid);
+  unlock();
+  return vid; //new node id in the DAG
+}
+
+
+void CSRGraph::addDependency(VertexIdType dependent, VertexIdType dependee) {
+  lock();
+  const auto base = base_node_.load();
+  make_sure((dependent + 1) == (base + nodes_.size()) && dependee < dependent,
+            "exatn::runtime::CSRGraph::addDependency: Only the last appended DAG node can depend on previous ones!");
+  if(dependee >= base){ //dependencies on retired (executed) DAG nodes are always resolved
+    bool exists = false;
+    for(auto i = edge_offsets_[dependent-base] - base_edge_; i < edges_.size(); ++i){
+      if(edges_[i] == dependee){exists = true; break;}
+    }
+    if(!exists){
+      edges_.emplace_back(dependee);
+      ++(edge_offsets_.back());
+    }
+  }
+  unlock();
+  return;
+}
+
+
+bool CSRGraph::dependencyExists(VertexIdType vertex_id1, VertexIdType vertex_id2) {
+  bool exists = false;
+  lock();
+  if(!(isRetired(vertex_id1) || isRetired(vertex_id2))){
+    const auto base = base_node_.load();
+    const auto end = edge_offsets_[vertex_id1-base+1] - base_edge_;
+    for(auto i = edge_offsets_[vertex_id1-base] - base_edge_; i < end; ++i){
+      if(edges_[i] == vertex_id2){exists = true; break;}
+    }
+  }
+  unlock();
+  return exists;
+}
+
+
+TensorOpNode & CSRGraph::getNodeProperties(VertexIdType vertex_id) {
+  lock();
+  TensorOpNode & node_properties = isRetired(vertex_id) ? retired_node_ : nodes_[vertex_id-base_node_.load()];
+  unlock();
+  return node_properties;
+}
+
+
+std::size_t CSRGraph::getNodeDegree(VertexIdType vertex_id) {
+  std::size_t ns = 0;
+  lock();
+  if(!isRetired(vertex_id)){
+    const auto base = base_node_.load();
+    ns = edge_offsets_[vertex_id-base+1] - edge_offsets_[vertex_id-base];
+  }
+  unlock();
+  return ns;
+}
+
+
+std::size_t CSRGraph::getNumNodes() {
+  lock();
+  std::size_t n = base_node_.load() + nodes_.size();
+  unlock();
+  return n;
+}
+
+
+std::size_t CSRGraph::getNumResidentNodes() {
+  lock();
+  std::size_t n = nodes_.size();
+  unlock();
+  return n;
+}
+
+
+std::size_t CSRGraph::getNumDependencies() {
+  lock();
+  std::size_t m = edge_offsets_.back();
+  unlock();
+  return m;
+}
+
+
+std::vector<VertexIdType> CSRGraph::getNeighborList(VertexIdType vertex_id) {
+  std::vector<VertexIdType> l;
+  lock();
+  visitNeighbors(vertex_id,[&l](VertexIdType dep){l.emplace_back(dep);});
+  unlock();
+  return l;
+}
+
+
+void CSRGraph::visitNeighbors(VertexIdType vertex_id,
+                              const std::function<void (VertexIdType)> & visitor) {
+  lock();
+  if(!isRetired(vertex_id)){
+    const auto base = base_node_.load();
+    const auto end = edge_offsets_[vertex_id-base+1] - base_edge_;
+    for(auto i = edge_offsets_[vertex_id-base] - base_edge_; i < end; ++i){
+      if(edges_[i] >= base) visitor(edges_[i]); //retired dependees are skipped
+    }
+  }
+  unlock();
+  return;
+}
+
+
+void CSRGraph::computeShortestPath(VertexIdType startIndex,
+                                   std::vector<double> & distances,
+                                   std::vector<VertexIdType> & paths) {
+  lock();
+  const auto base = base_node_.load();
+  const auto num_nodes = base + nodes_.size();
+  assert(startIndex < num_nodes);
+  std::vector<double> d(num_nodes,std::numeric_limits<double>::max());
+  std::vector<VertexIdType> p(num_nodes);
+  for(VertexIdType i = 0; i < num_nodes; ++i) p[i] = i;
+  d[startIndex] = 0.0;
+  //Edges only point to previously appended nodes, thus a single backward sweep suffices:
+  for(VertexIdType i = startIndex + 1; i-- > base;){
+    if(d[i] < std::numeric_limits<double>::max()){
+      visitNeighbors(i,[&d,&p,i](VertexIdType dep){
+        if(d[i] + 1.0 < d[dep]){d[dep] = d[i] + 1.0; p[dep] = i;}
+      });
+    }
+  }
+  for(const auto & di: d) distances.push_back(di);
+  for(const auto & pi: p) paths.push_back(pi);
+  unlock();
+  return;
+}
+
+
+void CSRGraph::printIt()
+{
+  lock();
+  std::cout << "#MSG: Printing DAG:" << std::endl;
+  const auto base = base_node_.load();
+  if(base > 0) std::cout << "Nodes 0.." << (base - 1) << ": Retired" << std::endl;
+  const auto num_nodes = base + nodes_.size();
+  for(VertexIdType i = base; i < num_nodes; ++i){
+    std::cout << "Node " << i << ": Depends on { ";
+    visitNeighbors(i,[](VertexIdType dep){std::cout << dep << " ";});
+    std::cout << "}" << std::endl;
+  }
+  std::cout << "#END MSG" << std::endl;
+  unlock();
+  return;
+}
+
+
+void CSRGraph::reclaimExecutedNodes()
+{
+  //Keep at least RECLAIM_CHUNK executed DAG nodes right behind the front node resident:
+  if(getFrontNode() >= (base_node_.load() + 2 * RECLAIM_CHUNK)){
+    lock();
+    const auto num_retired = RECLAIM_CHUNK;
+    const auto new_base_edge = edge_offsets_[num_retired];
+    edges_.erase(edges_.begin(),edges_.begin() + (new_base_edge - base_edge_));
+    edge_offsets_.erase(edge_offsets_.begin(),edge_offsets_.begin() + num_retired);
+    for(std::size_t i = 0; i < num_retired; ++i) nodes_.pop_front();
+    base_edge_ = new_base_edge;
+    base_node_.store(base_node_.load() + num_retired);
+    unlock();
+  }
+  return;
+}
+
+
+void CSRGraph::clear()
+{
+  lock();
+  resetStaging();
+  nodes_.clear();
+  edges_.clear();
+  edge_offsets_.assign(1,0);
+  base_edge_ = 0;
+  base_node_.store(0);
+  exec_state_.clear();
+  boosted_nodes_.clear();
+  unlock();
+  return;
+}
+
+} // namespace runtime
+} // namespace exatn
@@ -0,0 +1,152 @@
+/** ExaTN:: Tensor Runtime: Directed acyclic graph of tensor operations: Compressed sparse row storage
+REVISION: 2022/03/20
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The CSR tensor graph is an append-only implementation of the tensor graph (DAG):
+     Since all dependencies of a newly appended DAG node are established right away
+     and can only point to previously appended DAG nodes, the DAG structure is stored
+     in the compressed sparse row (CSR) format: A contiguous array of dependee node ids
+     (directed edges) and a contiguous array of edge offsets for each DAG node.
+     Therefore, only the most recently appended DAG node can acquire new dependencies.
+ (b) DAG node properties (TensorOpNode) are stored in a chunked contiguous container
+     by value, thus avoiding per-node heap allocations while keeping references to
+     DAG node properties stable during the DAG growth. The execution state of DAG nodes
+     is not split off into a separate flat array of atomics: The TensorGraph API
+     (getNodeProperties) and all graph executors access the DAG node state through
+     the TensorOpNode reference, thus the state atomics stay inside TensorOpNode,
+     which is co-located with the rest of the DAG node properties anyway.
+ (c) The neighbor (dependee) list of a DAG node can be visited without allocation
+     via visitNeighbors().
+ (d) The CSR tensor graph is registered as "csr-digraph" and can be selected
+     via the "runtime_dag_kind" runtime parameter (ParamConf).
+ (e) The CSR tensor graph is a sliding window over the DAG: Once enough DAG nodes
+     behind the DAG front node have been executed, the oldest of them are retired
+     in chunks of RECLAIM_CHUNK nodes and their storage is recycled. DAG node ids
+     stay stable (offset by the id of the first resident DAG node). A retired DAG node
+     is reported as successfully executed via a read-only dummy sentinel TensorOpNode
+     (TensorOpNode::isDummy) shared by all retired DAG nodes, which carries no tensor
+     operation and ignores all attempts to modify it (its execution state changes are
+     fatal errors). A retired DAG node is also skipped during neighbor traversal,
+     since a dependency on an executed DAG node is always resolved. Thus, an unbounded
+     number of tensor operations can be streamed through the DAG in bounded memory.
+**/
+
+#ifndef EXATN_RUNTIME_CSR_GRAPH_HPP_
+#define EXATN_RUNTIME_CSR_GRAPH_HPP_
+
+#include "tensor_graph.hpp"
+#include "tensor_operation.hpp"
+#include "tensor.hpp"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <atomic>
+
+namespace exatn {
+namespace runtime {
+
+class CSRGraph : public TensorGraph {
+
+public:
+
+  static constexpr std::size_t DEFAULT_NODE_CAPACITY = 8192;  //initial capacity for DAG nodes
+  static constexpr std::size_t DEFAULT_EDGE_CAPACITY = 32768; //initial capacity for DAG edges
+  static constexpr std::size_t RECLAIM_CHUNK = 1024;          //number of executed DAG nodes retired at once
+
+  CSRGraph();
+  CSRGraph(const CSRGraph &) = delete;
+  CSRGraph & operator=(const CSRGraph &) = delete;
+  CSRGraph(CSRGraph &&) noexcept = delete;
+  CSRGraph & operator=(CSRGraph &&) noexcept = delete;
+  virtual ~CSRGraph() = default;
+
+  /** Appends a new DAG node and returns its vertex id. **/
+  VertexIdType addOperation(std::shared_ptr<TensorOperation> op) override;
+
+  /** Marks dependency of Vertex dependent on Vertex dependee by establishing
+      a directed DAG edge from Vertex dependent. Only the most recently
+      appended DAG node can be the dependent one. **/
+  void addDependency(VertexIdType dependent,
+                     VertexIdType dependee) override;
+
+  /** Returns TRUE if vertex_id1 depends on vertex_id2, FALSE otherwise. **/
+  bool dependencyExists(VertexIdType vertex_id1,
+                        VertexIdType vertex_id2) override;
+
+  /** Returns the properties of a given DAG node (the read-only dummy sentinel for retired DAG nodes). **/
+  TensorOpNode & getNodeProperties(VertexIdType vertex_id) override;
+
+  /** Returns the number of dependencies for a given DAG node. **/
+  std::size_t getNodeDegree(VertexIdType vertex_id) override;
+
+  /** Returns the total number of nodes in the DAG (including retired ones). **/
+  std::size_t getNumNodes() override;
+
+  /** Returns the total number of dependencies in the DAG,
+      that is, the total number of directed edges in the DAG
+      (including the edges of retired DAG nodes). **/
+  std::size_t getNumDependencies() override;
+
+  /** Returns the list of dependencies of a given DAG node, that is,
+      the list of vertices the given one depends on. **/
+  std::vector<VertexIdType> getNeighborList(VertexIdType vertex_id) override;
+
+  /** Visits all dependencies of a given DAG node without allocation. **/
+  void visitNeighbors(VertexIdType vertex_id,
+                      const std::function<void (VertexIdType)> & visitor) override;
+
+  /** Computes the shortest path (in the number of edges) from the start DAG node
+      to all other DAG nodes. Unreachable DAG nodes get the maximal distance
+      and themselves as their predecessors. **/
+  void computeShortestPath(VertexIdType startIndex,
+                           std::vector<double> & distances,
+                           std::vector<VertexIdType> & paths) override;
+
+  /** Prints the DAG. **/
+  void printIt() override;
+
+  const std::string name() const override {
+    return "csr-digraph";
+  }
+
+  const std::string description() const override {
+    return "Directed acyclic graph of tensor operations (CSR storage)";
+  }
+
+  std::shared_ptr<TensorGraph> clone() override {
+    return std::make_shared<CSRGraph>();
+  }
+
+  /** The CSR tensor graph retires executed DAG nodes. **/
+  bool reclaimsExecutedNodes() const override {return true;}
+
+  /** Retires the oldest executed DAG nodes behind the DAG front node. **/
+  void reclaimExecutedNodes() override;
+
+  /** Returns the number of resident (not retired) DAG nodes. **/
+  std::size_t getNumResidentNodes();
+
+  virtual void clear() override;
+
+protected:
+
+  /** Returns TRUE if the DAG node has been retired. **/
+  inline bool isRetired(VertexIdType vertex_id) const {return (vertex_id < base_node_.load());}
+
+  std::atomic<VertexIdType> base_node_;    //id of the first resident DAG node
+  std::size_t base_edge_;                  //global position of the first resident DAG edge
+  std::deque<TensorOpNode> nodes_;         //resident DAG node properties (stable references)
+  std::vector<std::size_t> edge_offsets_;  //global edge offsets: Edges of resident node i are [edge_offsets_[i]:edge_offsets_[i+1])
+  std::vector<VertexIdType> edges_;        //dependee node ids (directed edges) of resident DAG nodes
+  TensorOpNode retired_node_;              //properties reported for all retired DAG nodes (executed dummy sentinel)
+};
+
+} // namespace runtime
+} // namespace exatn
+
+#endif //EXATN_RUNTIME_CSR_GRAPH_HPP_
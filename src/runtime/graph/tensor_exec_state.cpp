@@ -1,32 +1,85 @@
 /** ExaTN:: Tensor Runtime: Tensor graph execution state
-REVISION: 2021/09/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 **/
 
 #include "tensor_exec_state.hpp"
+#include "tensor_op_transform.hpp"
+
+#include "space_register.hpp"
 
 #include <iostream>
+#include <iterator>
+#include <mutex>
 
 #include "errors.hpp"
 
 namespace exatn {
 namespace runtime {
 
-const std::vector<VertexIdType> * TensorExecState::getTensorEpochNodes(const Tensor & tensor, int * epoch)
+namespace {
+
+/** Process-wide registry of tensor versions (d) **/
+struct TensorVersions {
+  std::mutex lock;                                           //protects the registry
+  std::uint64_t counter = 0;                                 //sequence number of the last write
+  std::unordered_map<TensorHashType,std::uint64_t> versions; //tensor hash --> version
+};
+
+TensorVersions & getTensorVersions()
 {
-  *epoch = 0;
-  auto tens_hash = tensor.getTensorHash();
-  auto iter = tensor_info_.find(tens_hash);
-  if(iter == tensor_info_.end()) return nullptr;
-  auto & tens_info = *(iter->second);
-  *epoch = tens_info.rw_epoch.load();
-  return &(tens_info.rw_epoch_nodes);
+  static TensorVersions * tensor_versions = new TensorVersions(); //never destroyed (used during static destruction)
+  return *tensor_versions;
+}
+
+} //namespace
+
+void TensorExecState::registerTensorWrites(const TensorOperation & op)
+{
+  const auto num_out_operands = op.getNumOperandsOut();
+  if(num_out_operands == 0) return;
+  if(op.getOpcode() == TensorOpCode::TRANSFORM){ //read-only tensor transformations do not write
+    const auto * transform = dynamic_cast<const numerics::TensorOpTransform*>(&op);
+    if(transform != nullptr && transform->isReadOnly()) return;
+  }
+  auto & registry = getTensorVersions();
+  std::lock_guard<std::mutex> lock(registry.lock);
+  if(op.getOpcode() == TensorOpCode::DESTROY){
+    registry.versions.erase(op.getTensorOperand(0)->getTensorHash());
+  }else{
+    for(unsigned int i = 0; i < num_out_operands; ++i){
+      auto tensor = op.getTensorOperand(i);
+      if(tensor) registry.versions[tensor->getTensorHash()] = ++(registry.counter);
+    }
+  }
+  return;
 }
 
-int TensorExecState::registerTensorRead(const Tensor & tensor, VertexIdType node_id)
+std::uint64_t TensorExecState::registerTensorWrite(const Tensor & tensor)
 {
+  auto & registry = getTensorVersions();
+  std::lock_guard<std::mutex> lock(registry.lock);
+  const auto version = ++(registry.counter);
+  registry.versions[tensor.getTensorHash()] = version;
+  return version;
+}
+
+std::uint64_t TensorExecState::getTensorVersion(const Tensor & tensor)
+{
+  auto & registry = getTensorVersions();
+  std::lock_guard<std::mutex> lock(registry.lock);
+  auto iter = registry.versions.find(tensor.getTensorHash());
+  if(iter == registry.versions.cend()) return 0;
+  return iter->second;
+}
+
+void TensorExecState::registerTensorAccess(const Tensor & tensor, VertexIdType node_id, bool write,
+                                           const TensorRegion & region, std::vector<VertexIdType> & dependencies,
+                                           bool accumulate)
+{
+  if(accumulate) write = true;
   auto tens_hash = tensor.getTensorHash();
   auto iter = tensor_info_.find(tens_hash);
   if(iter == tensor_info_.end()){
@@ -34,30 +87,120 @@ int TensorExecState::registerTensorRead(const Tensor & tensor, VertexIdType node
     iter = pos.first;
   }
   auto & tens_info = *(iter->second);
-  if(tens_info.rw_epoch.load() < 0){ //write epoch
-    tens_info.rw_epoch_nodes.clear();
-    tens_info.rw_epoch.store(0);
+  auto & accesses = tens_info.accesses;
+  auto access = accesses.begin();
+  while(access != accesses.end()){
+    bool superseded = false;
+    if((write || access->write) && !(accumulate && access->accumulate) &&
+       regionsOverlap(access->region,region)){
+      if(access->node != node_id) dependencies.emplace_back(access->node);
+      superseded = (write && !accumulate && regionCovers(region,access->region));
+    }
+    if(superseded){
+      access = accesses.erase(access);
+    }else{
+      ++access;
+    }
   }
-  tens_info.rw_epoch_nodes.emplace_back(node_id);
-  return ++(tens_info.rw_epoch);
+  accesses.emplace_back(TensorAccess{node_id,write,accumulate,region});
+  if(write) ++(tens_info.update_count);
+  return;
 }
 
-int TensorExecState::registerTensorWrite(const Tensor & tensor, VertexIdType node_id)
+std::vector<VertexIdType> TensorExecState::getTensorWriteNodes(const Tensor & tensor) const
 {
-  auto tens_hash = tensor.getTensorHash();
-  auto iter = tensor_info_.find(tens_hash);
-  if(iter == tensor_info_.end()){
-    auto pos = tensor_info_.emplace(std::make_pair(tens_hash,std::make_shared<TensorExecInfo>()));
-    iter = pos.first;
+  std::vector<VertexIdType> nodes;
+  auto iter = tensor_info_.find(tensor.getTensorHash());
+  if(iter != tensor_info_.end()){
+    for(const auto & access: iter->second->accesses){
+      if(access.write) nodes.emplace_back(access.node);
+    }
   }
+  return nodes;
+}
+
+bool TensorExecState::acquireAccumulation(const Tensor & tensor, VertexIdType node_id)
+{
+  auto iter = tensor_info_.find(tensor.getTensorHash());
+  if(iter == tensor_info_.end()) return true;
   auto & tens_info = *(iter->second);
-  if(tens_info.rw_epoch.load() != 0){ //either read or write epoch
-    tens_info.rw_epoch_nodes.clear();
-    tens_info.rw_epoch.store(0);
+  if(tens_info.accumulating) return (tens_info.accumulating_node == node_id);
+  tens_info.accumulating = true;
+  tens_info.accumulating_node = node_id;
+  return true;
+}
+
+void TensorExecState::releaseAccumulation(const Tensor & tensor, VertexIdType node_id)
+{
+  auto iter = tensor_info_.find(tensor.getTensorHash());
+  if(iter != tensor_info_.end()){
+    auto & tens_info = *(iter->second);
+    if(tens_info.accumulating && tens_info.accumulating_node == node_id) tens_info.accumulating = false;
   }
-  tens_info.rw_epoch_nodes.emplace_back(node_id);
-  ++(tens_info.update_count);
-  return --(tens_info.rw_epoch); //-1
+  return;
+}
+
+bool TensorExecState::accumulationBlocked(const Tensor & tensor, VertexIdType node_id) const
+{
+  auto iter = tensor_info_.find(tensor.getTensorHash());
+  if(iter == tensor_info_.end()) return false;
+  const auto & tens_info = *(iter->second);
+  return (tens_info.accumulating && tens_info.accumulating_node != node_id);
+}
+
+TensorRegion TensorExecState::getSliceRegion(const Tensor & tensor, const Tensor & slice)
+{
+  TensorRegion region;
+  const auto tensor_rank = tensor.getRank();
+  if(slice.getRank() != tensor_rank) return region;
+  const auto & tensor_signature = tensor.getSignature();
+  const auto & slice_signature = slice.getSignature();
+  region.resize(tensor_rank);
+  for(unsigned int i = 0; i < tensor_rank; ++i){
+    const auto tensor_space_id = tensor_signature.getDimSpaceId(i);
+    const auto tensor_subspace_id = tensor_signature.getDimSubspaceId(i);
+    const auto slice_space_id = slice_signature.getDimSpaceId(i);
+    const auto slice_subspace_id = slice_signature.getDimSubspaceId(i);
+    DimOffset tensor_lower_bound = 0, slice_lower_bound = 0;
+    if(slice_space_id == SOME_SPACE && tensor_space_id == SOME_SPACE){
+      tensor_lower_bound = tensor_subspace_id;
+      slice_lower_bound = slice_subspace_id;
+    }else if(slice_space_id != SOME_SPACE && tensor_space_id == slice_space_id){
+      tensor_lower_bound = getSpaceRegister()->getSubspace(tensor_space_id,tensor_subspace_id)->getLowerBound();
+      slice_lower_bound = getSpaceRegister()->getSubspace(slice_space_id,slice_subspace_id)->getLowerBound();
+    }else{ //space mismatch: whole tensor
+      return TensorRegion();
+    }
+    if(slice_lower_bound < tensor_lower_bound) return TensorRegion();
+    region[i] = std::make_pair(slice_lower_bound - tensor_lower_bound,slice.getDimExtent(i));
+  }
+  return region;
+}
+
+bool TensorExecState::regionsOverlap(const TensorRegion & region1, const TensorRegion & region2)
+{
+  if(region1.empty() || region2.empty()) return true; //whole tensor
+  if(region1.size() != region2.size()) return true;
+  for(std::size_t i = 0; i < region1.size(); ++i){
+    const auto & range1 = region1[i];
+    const auto & range2 = region2[i];
+    if(range1.first >= range2.first + range2.second ||
+       range2.first >= range1.first + range1.second) return false;
+  }
+  return true;
+}
+
+bool TensorExecState::regionCovers(const TensorRegion & region1, const TensorRegion & region2)
+{
+  if(region1.empty()) return true; //whole tensor
+  if(region2.empty() || region1.size() != region2.size()) return false;
+  for(std::size_t i = 0; i < region1.size(); ++i){
+    const auto & range1 = region1[i];
+    const auto & range2 = region2[i];
+    if(range2.first < range1.first ||
+       range2.first + range2.second > range1.first + range1.second) return false;
+  }
+  return true;
 }
 
 std::size_t TensorExecState::registerWriteCompletion(const Tensor & tensor)
@@ -86,6 +229,14 @@ bool TensorExecState::registerDependencyFreeNode(VertexIdType node_id)
   return inserted;
 }
 
+bool TensorExecState::unregisterDependencyFreeNode(VertexIdType node_id)
+{
+  for(auto iter = nodes_ready_.begin(); iter != nodes_ready_.end(); ++iter){
+    if(*iter == node_id){nodes_ready_.erase(iter); return true;}
+  }
+  return false;
+}
+
 bool TensorExecState::extractDependencyFreeNode(VertexIdType * node_id)
 {
   bool empty = nodes_ready_.empty();
@@ -96,6 +247,57 @@ bool TensorExecState::extractDependencyFreeNode(VertexIdType * node_id)
   return !empty;
 }
 
+bool TensorExecState::extractDependencyFreeNode(VertexIdType * node_id,
+                                                const std::function<double (VertexIdType)> & priority,
+                                                const std::function<bool (VertexIdType)> & admissible)
+{
+  auto best = nodes_ready_.end();
+  double best_priority = 0.0;
+  for(auto iter = nodes_ready_.begin(); iter != nodes_ready_.end(); ++iter){
+    if(admissible && !admissible(*iter)) continue;
+    const double node_priority = priority(*iter);
+    if(best == nodes_ready_.end() || node_priority > best_priority){best = iter; best_priority = node_priority;}
+  }
+  bool found = (best != nodes_ready_.end());
+  if(found){
+    *node_id = *best;
+    nodes_ready_.erase(best);
+  }
+  return found;
+}
+
+bool TensorExecState::extractDependencyFreeNode(VertexIdType * node_id,
+                                                const std::function<std::pair<int,double> (VertexIdType)> & priority,
+                                                const std::function<bool (VertexIdType)> & admissible)
+{
+  auto best = nodes_ready_.end();
+  std::pair<int,double> best_priority{0,0.0};
+  for(auto iter = nodes_ready_.begin(); iter != nodes_ready_.end(); ++iter){
+    if(admissible && !admissible(*iter)) continue;
+    const auto node_priority = priority(*iter);
+    if(best == nodes_ready_.end() || node_priority > best_priority){best = iter; best_priority = node_priority;}
+  }
+  bool found = (best != nodes_ready_.end());
+  if(found){
+    *node_id = *best;
+    nodes_ready_.erase(best);
+  }
+  return found;
+}
+
+bool TensorExecState::extractDependencyFreeNodeIf(VertexIdType * node_id,
+                                                  const std::function<bool (VertexIdType)> & predicate)
+{
+  for(auto iter = nodes_ready_.begin(); iter != nodes_ready_.end(); ++iter){
+    if(predicate(*iter)){
+      *node_id = *iter;
+      nodes_ready_.erase(iter);
+      return true;
+    }
+  }
+  return false;
+}
+
 std::list<VertexIdType> TensorExecState::getDependencyFreeNodes() const
 {
   return nodes_ready_;
@@ -1,8 +1,8 @@
 /** ExaTN:: Tensor Runtime: Tensor graph execution state
-REVISION: 2021/09/21
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
  (a) Tensor graph is a directed acyclic graph in which vertices
@@ -14,26 +14,36 @@ Rationale:
  (b) The tensor graph contains:
      1. The DAG implementation (DirectedBoostGraph subclass);
      2. The DAG execution state (TensorExecState data member).
- (c) The execution state of each Tensor in the DAG is either of the following:
-     1. None (no outstanding reads or writes on the Tensor);
-     2. Read (one or more most recently submitted tensor operations
-        involving the Tensor perform reads on it). This is the READ
-        epoch characterized by a positive integer equal to the number
-        of outstanding reads on the Tensor in the current (read) epoch.
-     3. Write (most recent tensor operation on the Tensor is a write).
-        This is the WRITE epoch characterized by a negative integer -1
-        denoting the single outstanding write on the Tensor in the
-        current (write) epoch.
-     The execution state of a Tensor is progressing through alternating
-     read and write epochs, introducing read-after-write, write-after-write,
-     and write-after-read dependencies between tensor nodes with stored
-     tensor operations operating on the same data (Tensor). Importantly,
-     the execution state of a Tensor is defined with respect to the DAG
+ (c) The execution state of each Tensor in the DAG is the list of its outstanding
+     (not yet superseded) accesses, each one being either a read or a write
+     performed by a DAG node on a region of the Tensor. A region is a box
+     of dimension ranges {base offset, extent} (an empty region denotes
+     the whole Tensor). A newly registered access depends on all previous
+     accesses on overlapping regions of the same Tensor, provided that
+     at least one of the two is a write, thus introducing read-after-write,
+     write-after-write, and write-after-read dependencies between tensor nodes
+     only when they actually touch the same data. A write supersedes (removes)
+     all previous accesses on the regions it covers. Consequently, slice
+     insertions into (and slice extractions from) disjoint regions of the same
+     Tensor do not depend on each other and can proceed concurrently.
+     Similarly, commutative accumulations into the same Tensor do not depend
+     on each other (but on all other conflicting accesses), thus they are executed
+     in any order, yet one at a time, as they become ready (the DAG node currently
+     accumulating into a Tensor holds its accumulation lock).
+     Importantly, the execution state of a tensor is defined with respect to the DAG
      builder, that is, every time a new tensor operation is added into
      the DAG the execution state of each participating tensor is inspected
-     and possibly altered (switched to another epoch). Thus, the execution
-     state of a tensor is only used for establishing data dependencies for
-     newly added DAG nodes, it has nothing to do with actual DAG execution.
+     and possibly altered. Thus, the execution state of a tensor is only used
+     for establishing data dependencies for newly added DAG nodes,
+     it has nothing to do with actual DAG execution.
+ (d) Tensor versions: Unlike the per-DAG execution state, each Tensor also has a process-wide
+     version, which is the sequence number of the last write submitted on it (any output
+     tensor operand of a tensor operation, except read-only tensor transformations), taken from
+     a single process-wide counter. The version is bumped when the write is submitted, not when
+     it is appended into the DAG (which is deferred to the execution thread), thus a tensor
+     operation submitted later always observes it. Since the counter is process-wide,
+     a Tensor recreated at the same address (same hash) never repeats a previous version.
+     The version of a destroyed Tensor is dropped (version 0: never written).
 **/
 
 #ifndef EXATN_RUNTIME_TENSOR_EXEC_STATE_HPP_
@@ -45,7 +55,10 @@ Rationale:
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <functional>
+#include <vector>
 #include <atomic>
+#include <cstdint>
 
 namespace exatn {
 namespace runtime {
@@ -58,6 +71,9 @@ using numerics::TensorHashType; //each numerics::Tensor has its unique integer h
 using numerics::Tensor;
 using numerics::TensorOperation;
 
+// Tensor access region: {base offset, extent} for each tensor dimension (empty: whole tensor):
+using TensorRegion = std::vector<std::pair<DimOffset,DimExtent>>;
+
 using ExecutingNodesIterator = typename std::list<std::pair<VertexIdType,TensorOpExecHandle>>::const_iterator;
 
 
@@ -65,12 +81,20 @@ class TensorExecState {
 
 protected:
 
+  struct TensorAccess {
+    VertexIdType node;   //DAG node accessing the Tensor
+    bool write;          //write (TRUE) or read (FALSE) access
+    bool accumulate;     //commutative accumulation (a write commuting with other such writes)
+    TensorRegion region; //accessed region of the Tensor (empty: whole tensor)
+  };
+
   struct TensorExecInfo {
-    std::atomic<std::size_t> update_count;    //total number of outstanding updates on a given Tensor in the current DAG
-    std::atomic<int> rw_epoch;                //>0: number of current epoch reads; -1: current epoch write (single)
-    std::vector<VertexIdType> rw_epoch_nodes; //nodes participating in the current R/W epoch (either read or write)
+    std::atomic<std::size_t> update_count;  //total number of outstanding updates on a given Tensor in the current DAG
+    std::vector<TensorAccess> accesses;     //outstanding (not superseded) accesses on the Tensor
+    bool accumulating;                      //whether or not a DAG node is currently accumulating into the Tensor
+    VertexIdType accumulating_node;         //DAG node currently accumulating into the Tensor (holds the accumulation lock)
 
-    TensorExecInfo(): update_count(0), rw_epoch(0) {}
+    TensorExecInfo(): update_count(0), accumulating(false), accumulating_node(0) {}
     TensorExecInfo(const TensorExecInfo &) = delete;
     TensorExecInfo & operator=(const TensorExecInfo &) = delete;
     TensorExecInfo(TensorExecInfo &&) noexcept = delete;
@@ -88,17 +112,40 @@ public:
   TensorExecState & operator=(TensorExecState &&) noexcept = default;
   ~TensorExecState() = default;
 
-  /** Returns the list of nodes participating in the current R/W epoch:
-      epoch > 0: This is the number of reads in the current Read epoch;
-      epoch = -1: This is the single write in the current Write epoch. **/
-  const std::vector<VertexIdType> * getTensorEpochNodes(const Tensor & tensor,
-                                                        int * epoch);
-  /** Registers a new read on a Tensor. Returns the current epoch R/W counter. **/
-  int registerTensorRead(const Tensor & tensor,
-                         VertexIdType node_id);
-  /** Registers a new write on a Tensor. Returns the current epoch R/W counter. **/
-  int registerTensorWrite(const Tensor & tensor,
-                          VertexIdType node_id);
+  /** Registers a new access (read, write or commutative accumulation) by a DAG node
+      on a region of a Tensor and appends the DAG nodes it depends on (previous
+      conflicting accesses on overlapping regions) to the given list. **/
+  void registerTensorAccess(const Tensor & tensor,
+                            VertexIdType node_id,
+                            bool write,
+                            const TensorRegion & region,
+                            std::vector<VertexIdType> & dependencies,
+                            bool accumulate = false);
+  /** Returns the DAG nodes with outstanding (not superseded) writes on a Tensor. **/
+  std::vector<VertexIdType> getTensorWriteNodes(const Tensor & tensor) const;
+
+  /** Acquires the accumulation lock on a Tensor for a DAG node performing
+      a commutative accumulation into it. Returns FALSE if the lock is held
+      by another DAG node (TRUE if it is already held by the same DAG node). **/
+  bool acquireAccumulation(const Tensor & tensor,
+                           VertexIdType node_id);
+  /** Releases the accumulation lock on a Tensor if it is held by a given DAG node. **/
+  void releaseAccumulation(const Tensor & tensor,
+                           VertexIdType node_id);
+  /** Returns TRUE if the accumulation lock on a Tensor is held by another DAG node. **/
+  bool accumulationBlocked(const Tensor & tensor,
+                           VertexIdType node_id) const;
+
+  /** Returns the region of a tensor occupied by its slice (an empty region denotes
+      the whole tensor, which is also returned when the region cannot be determined). **/
+  static TensorRegion getSliceRegion(const Tensor & tensor,
+                                     const Tensor & slice);
+  /** Returns TRUE if two regions of the same tensor overlap. **/
+  static bool regionsOverlap(const TensorRegion & region1,
+                             const TensorRegion & region2);
+  /** Returns TRUE if the first region of a tensor covers the second one. **/
+  static bool regionCovers(const TensorRegion & region1,
+                           const TensorRegion & region2);
 
   /** Registers completion of an outstanding write on a Tensor.
       Returns the updated outstanding update count on the Tensor. **/
@@ -108,11 +155,34 @@ public:
 
   /** Registers a DAG node without dependencies. **/
   bool registerDependencyFreeNode(VertexIdType node_id);
+  /** Unregisters a DAG node from the list of dependency-free nodes.
+      Returns FALSE if the node was not registered. **/
+  bool unregisterDependencyFreeNode(VertexIdType node_id);
   /** Extracts a dependency-free node from the list.
       Returns FALSE if no such node exists. **/
   bool extractDependencyFreeNode(VertexIdType * node_id);
+  /** Extracts the dependency-free node with the highest priority from the list
+      (the earliest registered one among equals), only considering the nodes
+      admissible by an optional predicate. The other nodes keep their positions.
+      Returns FALSE if no such node exists. **/
+  bool extractDependencyFreeNode(VertexIdType * node_id,
+                                 const std::function<double (VertexIdType)> & priority,
+                                 const std::function<bool (VertexIdType)> & admissible = nullptr);
+  /** Extracts the dependency-free node with the highest (latency class, priority) pair
+      from the list, compared lexicographically (the earliest registered one among equals),
+      only considering the nodes admissible by an optional predicate. The other nodes keep
+      their positions. Returns FALSE if no such node exists. **/
+  bool extractDependencyFreeNode(VertexIdType * node_id,
+                                 const std::function<std::pair<int,double> (VertexIdType)> & priority,
+                                 const std::function<bool (VertexIdType)> & admissible = nullptr);
+  /** Extracts the earliest registered dependency-free node satisfying a given predicate.
+      Returns FALSE if no such node exists. **/
+  bool extractDependencyFreeNodeIf(VertexIdType * node_id,
+                                   const std::function<bool (VertexIdType)> & predicate);
   /** Returns the current list of dependency free nodes. **/
   std::list<VertexIdType> getDependencyFreeNodes() const;
+  /** Returns the current number of dependency free nodes. **/
+  inline std::size_t getNumDependencyFreeNodes() const {return nodes_ready_.size();}
 
   /** Registers a DAG node as being executed (together with its execution handle). **/
   void registerExecutingNode(VertexIdType node_id,
@@ -135,6 +205,15 @@ public:
   /** Clears the object. **/
   void clear();
 
+  /** Registers the writes of a submitted tensor operation into its output tensor operands,
+      bumping their versions (d). A DESTROY drops the version of its tensor operand. **/
+  static void registerTensorWrites(const TensorOperation & op);
+  /** Registers a write into a Tensor outside of tensor operations, bumping its version (d).
+      Returns the new version. **/
+  static std::uint64_t registerTensorWrite(const Tensor & tensor);
+  /** Returns the current version of a Tensor (0: never written) (d). **/
+  static std::uint64_t getTensorVersion(const Tensor & tensor);
+
 private:
   /** Table for tracking the execution status of a given tensor:
       Tensor Hash --> TensorExecInfo **/
@@ -1,8 +1,8 @@
 /** ExaTN:: Tensor Runtime: Directed acyclic graph (DAG) of tensor operations
-REVISION: 2021/09/21
+REVISION: 2022/03/21
 
-Copyright (C) 2018-2021 Dmitry Lyakh, Alex McCaskey, Tiffany Mintz
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2018-2022 Dmitry Lyakh, Alex McCaskey, Tiffany Mintz
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 Rationale:
  (a) The execution space consists of one or more DAGs in which nodes
@@ -24,6 +24,52 @@ Rationale:
      individual DAG nodes, which is only related to TensorOpNode.getOperation() method since it returns a
      reference to the stored tensor operation (shared pointer reference), thus may require external locking
      for securing an exclusive access to this data member of TensorOpNode.
+ (d) Client threads can stage new tensor operations into the lock-free
+     staging ring (TensorOpRing) via stageOperation() without acquiring
+     the DAG lock. The staged tensor operations are appended into the DAG
+     in batches by drainStagedOperations(), normally called by the execution
+     thread. A staged tensor operation gets its DAG node id upon staging.
+     Staging must not be mixed with concurrent direct calls to addOperation().
+ (e) Optionally, the tensor graph maintains a critical-path priority (bottom level)
+     for each DAG node, that is, the largest total cost of a dependency chain
+     starting at that node and ending at any of its (transitively) dependent nodes.
+     The cost of a DAG node is estimated from the flop and word estimates of its
+     tensor operation. Once priorities are activated (the DAG nodes appended
+     before the activation obtain their priorities right away), dependency-free DAG nodes
+     are extracted in the order of decreasing priority (list scheduling).
+ (f) A tensor graph implementation may reclaim the storage of executed DAG nodes
+     behind the DAG front node (reclaimsExecutedNodes() returns TRUE). DAG node ids
+     stay stable: A reclaimed DAG node is reported as successfully executed.
+ (g) Optionally, a batch of staged tensor operations can be rewritten by a tensor
+     operation rewriter (normally a TensorGraphOptimizer) right before it is appended
+     into the DAG. The rewriter never modifies a submitted tensor operation: It may replace
+     it by a rewritten clone (the client keeps its own tensor operation intact) and it may
+     elide some tensor operations. An elided tensor operation still occupies its DAG node, such that DAG
+     node ids stay stable, but it establishes no data dependencies and its DAG node
+     is marked as successfully executed upon appending, thus never being executed.
+ (h) Each DAG node has a latency class: That of its tensor operation (TensorOpPriority),
+     possibly boosted by boostNode(). Once a DAG node with a non-default latency class
+     has appeared, dependency-free DAG nodes are extracted in the order of decreasing
+     latency class first (and decreasing critical-path priority second, if active).
+     Boosting a DAG node raises the latency class of all its unexecuted (transitive)
+     dependencies. The boosted DAG nodes are then registered as dependency-free as soon as
+     they are ready for execution (upon extraction of dependency-free DAG nodes, that is,
+     by the execution thread), such that the graph executor can issue them right away
+     regardless of its traversal window.
+ (i) Commutative accumulations into the same tensor carry no mutual dependencies,
+     thus they are executed in the order they become ready. However, they are executed
+     one at a time: A dependency-free commutative accumulation is skipped upon extraction
+     while another one into the same tensor is being executed (it holds the accumulation lock),
+     keeping its position in the list of dependency-free nodes.
+ (j) Cancellation of DAG nodes (speculative execution): Any thread may request cancellation
+     of a DAG node (or of a staged tensor operation via its future DAG node id), but the
+     cancellation requests are only applied by the execution thread via applyCancellations(),
+     which it calls right after appending the staged tensor operations. A cancelled DAG node
+     is marked executed without ever reaching the node executor, thus its dependent DAG nodes
+     proceed as if it had been executed. Cancellation is best effort: A DAG node which is
+     already executing (or executed) is not affected, and neither is a tensor operation which
+     has been replaced by its rewritten clone (see TensorGraphOptimizer). It is up to the client
+     to cancel all DAG nodes that consume the output of a cancelled one.
 **/
 
 #ifndef EXATN_RUNTIME_TENSOR_GRAPH_HPP_
@@ -32,29 +78,48 @@ Rationale:
 #include "Identifiable.hpp"
 
 #include "tensor_exec_state.hpp"
+#include "tensor_op_ring.hpp"
 #include "tensor_operation.hpp"
 #include "tensor.hpp"
 
 #include <vector>
+#include <list>
+#include <algorithm>
 #include <memory>
+#include <functional>
+#include <utility>
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include "errors.hpp"
 
 namespace exatn {
 namespace runtime {
 
+/** Rewrites a batch of staged tensor operations (in their staging order) before they are
+    appended into the DAG: elided[i] is set to TRUE for each tensor operation to be elided,
+    a rewritten tensor operation replaces the submitted one by its clone (see TensorGraphOptimizer).
+    Returns the number of elided tensor operations. **/
+using TensorOpRewriter = std::function<std::size_t (std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                                    std::vector<bool> & elided)>;
+
 // Tensor Graph node
 class TensorOpNode {
 
 public:
+
+  static constexpr const int PREFETCH_NONE = 0;      //no prefetch of tensor operands has been attempted
+  static constexpr const int PREFETCH_ATTEMPTED = 1; //prefetch of tensor operands has been attempted but not initiated
+  static constexpr const int PREFETCH_INITIATED = 2; //prefetch of tensor operands has been initiated
   TensorOpNode():
-   op_(nullptr), is_noop_(true), executing_(false), executed_(false), error_(0)
+   op_(nullptr), is_noop_(true), executing_(false), executed_(false), error_(0),
+   prefetch_(PREFETCH_NONE), boost_(static_cast<int>(TensorOpPriority::NORMAL)), cost_(0.0), priority_(0.0)
   {}
 
   TensorOpNode(std::shared_ptr<TensorOperation> tens_op):
-   op_(tens_op), is_noop_(false), executing_(false), executed_(false), error_(0)
+   op_(tens_op), is_noop_(false), executing_(false), executed_(false), error_(0),
+   prefetch_(PREFETCH_NONE), boost_(static_cast<int>(TensorOpPriority::NORMAL)), cost_(0.0), priority_(0.0)
   {}
 
   TensorOpNode(const TensorOpNode &) = delete;
@@ -63,7 +128,10 @@ public:
   TensorOpNode & operator=(TensorOpNode &&) noexcept = delete;
   ~TensorOpNode() = default;
 
-  /** Returns whether or not the TensorOpNode is dummy. **/
+  /** Returns whether or not the TensorOpNode is dummy. A dummy TensorOpNode
+      carries no tensor operation and serves as a read-only sentinel once
+      it has been marked executed: Its execution state can no longer change
+      and its cost, priority, latency class and prefetch status stay put. **/
   inline bool isDummy() const {return is_noop_;}
 
   /** Returns a reference to the stored tensor operation. Note that
@@ -90,12 +158,60 @@ public:
     return !(ans || executed_.load());
   }
 
+  /** Returns the estimated execution cost of the tensor graph node. **/
+  inline double getCost() const {return cost_;}
+
+  /** Returns the critical-path priority (bottom level) of the tensor graph node. **/
+  inline double getPriority() const {return priority_;}
+
+  /** Returns the latency class of the tensor graph node: That of its tensor operation,
+      unless boosted higher. **/
+  inline int getLatencyClass() const {
+    const int boost = boost_.load(std::memory_order_relaxed);
+    if(!op_) return boost;
+    return std::max(static_cast<int>(op_->getPriority()),boost);
+  }
+
+  /** Boosts the latency class of the tensor graph node.
+      Returns TRUE if the latency class has been raised. **/
+  inline bool boostLatencyClass(int latency_class) {
+    if(is_noop_ || latency_class <= getLatencyClass()) return false;
+    boost_.store(latency_class,std::memory_order_relaxed);
+    return true;
+  }
+
   /** Sets the (unique) id of the tensor graph node. **/
   inline void setId(VertexIdType id) {
     id_ = id;
     return;
   }
 
+  /** Sets the estimated execution cost of the tensor graph node. **/
+  inline void setCost(double cost) {
+    if(!is_noop_) cost_ = cost;
+    return;
+  }
+
+  /** Sets the critical-path priority (bottom level) of the tensor graph node. **/
+  inline void setPriority(double priority) {
+    if(!is_noop_) priority_ = priority;
+    return;
+  }
+
+  /** Returns the prefetch status of the tensor operands of the tensor graph node. **/
+  inline int getPrefetchStatus() const {return prefetch_.load(std::memory_order_relaxed);}
+
+  /** Records an attempt to prefetch the tensor operands of the tensor graph node. **/
+  inline void setPrefetchStatus(bool initiated) {
+    if(is_noop_) return;
+    if(initiated){
+      prefetch_.store(PREFETCH_INITIATED,std::memory_order_relaxed);
+    }else if(prefetch_.load(std::memory_order_relaxed) == PREFETCH_NONE){
+      prefetch_.store(PREFETCH_ATTEMPTED,std::memory_order_relaxed);
+    }
+    return;
+  }
+
   /** Marks the tensor graph node as being currently executed. **/
   inline void setExecuting() {
     auto executing = executing_.load();
@@ -152,7 +268,11 @@ protected:
   std::atomic<bool> executing_; //TRUE if the stored tensor operation is currently being executed
   std::atomic<bool> executed_;  //TRUE if the stored tensor operation has been executed to completion
   std::atomic<int> error_;      //execution error code (0:success)
+  std::atomic<int> prefetch_;   //prefetch status of the tensor operands (PREFETCH_XXX)
+  std::atomic<int> boost_;      //boosted latency class (TensorOpPriority)
   VertexIdType id_;             //graph vertex id
+  double cost_;                 //estimated execution cost (flop-equivalent)
+  double priority_;             //critical-path priority: Bottom level (flop-equivalent)
 
 private:
   std::recursive_mutex mtx_; //object access mutex
@@ -163,7 +283,12 @@ private:
 class TensorGraph : public Identifiable, public Cloneable<TensorGraph> {
 
 public:
-  TensorGraph() = default;
+
+  static constexpr std::size_t DEFAULT_DRAIN_BATCH = 1024; //max number of staged tensor operations appended into the DAG at once
+  static constexpr double WORD_COST = 1.0; //cost of a single word of tensor operands in flop-equivalents
+
+  TensorGraph(): ticket_base_(0), draining_(false), priorities_(false), latency_classes_(false), elide_append_(false),
+                 cancellations_(false) {}
   TensorGraph(const TensorGraph &) = delete;
   TensorGraph & operator=(const TensorGraph &) = delete;
   TensorGraph(TensorGraph &&) noexcept = default;
@@ -200,6 +325,24 @@ public:
   /** Returns the list of nodes connected to the given DAG node. **/
   virtual std::vector<VertexIdType> getNeighborList(VertexIdType vertex_id) = 0;
 
+  /** Returns TRUE if the DAG reclaims the storage of executed nodes
+      behind the DAG front node, thus being able to grow unboundedly. **/
+  virtual bool reclaimsExecutedNodes() const {return false;}
+
+  /** Reclaims the storage of executed DAG nodes behind the DAG front node, if supported.
+      [THREAD: This function is executed by the execution thread] **/
+  virtual void reclaimExecutedNodes() {return;}
+
+  /** Visits all nodes the given DAG node is connected to.
+      Subclasses with contiguous adjacency storage should override
+      this method to avoid allocating the neighbor list. **/
+  virtual void visitNeighbors(VertexIdType vertex_id,
+                              const std::function<void (VertexIdType)> & visitor) {
+    const auto neighbors = getNeighborList(vertex_id);
+    for(const auto & neighbor: neighbors) visitor(neighbor);
+    return;
+  }
+
   /** Computes the shortest path from the start index. **/
   virtual void computeShortestPath(VertexIdType startIndex,
                                    std::vector<double> & distances,
@@ -225,12 +368,14 @@ public:
     auto & output_tensor = *(op->getTensorOperand(0)); //`Assumes a single output tensor
     lock();
     auto update_cnt = exec_state_.registerWriteCompletion(output_tensor);
+    if(op->isCommutativeAccumulation()) exec_state_.releaseAccumulation(output_tensor,vertex_id);
     unlock();
     return;
   }
 
   /** Marks the DAG node as idle. **/
   void setNodeIdle(VertexIdType vertex_id) {
+    releaseAccumulation(vertex_id);
     return getNodeProperties(vertex_id).setIdle();
   }
 
@@ -255,12 +400,13 @@ public:
   bool nodeDependenciesResolved(VertexIdType vertex_id) {
     bool resolved = true;
     lock();
-    auto dependencies = getNeighborList(vertex_id);
-    for(const auto & dep: dependencies){
-      int error_code;
-      auto executed = nodeExecuted(dep,&error_code);
-      if((!executed) || (error_code != 0)){resolved = false; break;}
-    }
+    visitNeighbors(vertex_id,[this,&resolved](VertexIdType dep){
+      if(resolved){
+        int error_code;
+        auto executed = nodeExecuted(dep,&error_code);
+        if((!executed) || (error_code != 0)) resolved = false;
+      }
+    });
     unlock();
     return resolved;
   }
@@ -276,20 +422,124 @@ public:
   /** Registers a DAG node without dependencies. **/
   inline bool registerDependencyFreeNode(VertexIdType node_id) {
     lock();
+    releaseAccumulation(node_id); //a returned commutative accumulation releases its accumulation lock
     auto registered = exec_state_.registerDependencyFreeNode(node_id);
     unlock();
     return registered;
   }
 
-  /** Extracts a dependency-free node from the list.
-      Returns FALSE if no such node exists. **/
-  inline bool extractDependencyFreeNode(VertexIdType * node_id) {
+  /** Extracts a dependency-free node from the list (the one with
+      the highest priority if priorities are active), skipping commutative
+      accumulations into tensors currently being accumulated into by other DAG nodes
+      as well as the DAG nodes not admissible by an optional predicate. The skipped
+      dependency-free nodes keep their positions. Returns FALSE if no such node exists. **/
+  inline bool extractDependencyFreeNode(VertexIdType * node_id,
+                                        const std::function<bool (VertexIdType)> & admissible = nullptr) {
     lock();
-    auto avail = exec_state_.extractDependencyFreeNode(node_id);
+    if(!boosted_nodes_.empty()) registerBoostedNodes();
+    bool avail = selectDependencyFreeNode(node_id,
+                  [this,&admissible](VertexIdType node){
+                    return !(this->accumulationBlocked(node)) && (!admissible || admissible(node));
+                  });
+    if(avail){
+      auto acquired = acquireAccumulation(*node_id); assert(acquired);
+    }
     unlock();
     return avail;
   }
 
+  /** Acquires the accumulation lock on the output tensor for a DAG node with a commutative
+      accumulation (in-order executors, see rationale i). Returns FALSE if the DAG node
+      is blocked by another commutative accumulation into the same tensor. **/
+  inline bool tryAcquireAccumulation(VertexIdType node_id) {
+    lock();
+    bool acquired = acquireAccumulation(node_id);
+    unlock();
+    return acquired;
+  }
+
+  /** Extracts the earliest registered dependency-free node satisfying a given predicate
+      (skipping blocked commutative accumulations). Returns FALSE if no such node exists. **/
+  inline bool extractDependencyFreeNodeIf(VertexIdType * node_id,
+                                          const std::function<bool (VertexIdType)> & predicate) {
+    lock();
+    bool avail = exec_state_.extractDependencyFreeNodeIf(node_id,
+                  [this,&predicate](VertexIdType node){
+                    return predicate(node) && this->acquireAccumulation(node);
+                  });
+    unlock();
+    return avail;
+  }
+
+  /** Boosts the latency class of a given DAG node and all its unexecuted (transitive)
+      dependencies, which will be registered as dependency-free once ready for execution.
+      Returns the number of boosted DAG nodes. [THREAD: Can be called by any thread] **/
+  std::size_t boostNode(VertexIdType node_id,
+                        TensorOpPriority latency_class = TensorOpPriority::URGENT) {
+    std::size_t num_boosted = 0;
+    const int boost = static_cast<int>(latency_class);
+    lock();
+    if(node_id < getNumNodes()){
+      latency_classes_.store(true);
+      std::vector<VertexIdType> boosted{node_id};
+      while(!boosted.empty()){
+        const auto node = boosted.back(); boosted.pop_back();
+        auto & node_properties = getNodeProperties(node);
+        if(node_properties.isExecuted()) continue;
+        if(node_properties.boostLatencyClass(boost) || node == node_id){
+          ++num_boosted;
+          boosted_nodes_.emplace_back(node);
+          visitNeighbors(node,[&boosted](VertexIdType dep){boosted.emplace_back(dep);});
+        }
+      }
+    }
+    unlock();
+    return num_boosted;
+  }
+
+  /** Boosts the latency class of all unexecuted DAG nodes a given tensor
+      is waiting on for the completion of its outstanding updates.
+      Returns the number of boosted DAG nodes. [THREAD: Can be called by any thread] **/
+  std::size_t boostTensor(const Tensor & tensor,
+                          TensorOpPriority latency_class = TensorOpPriority::URGENT) {
+    std::size_t num_boosted = 0;
+    lock();
+    const auto nodes = exec_state_.getTensorWriteNodes(tensor); //outstanding writes (preceding reads depend on them)
+    for(const auto & node: nodes) num_boosted += boostNode(node,latency_class);
+    unlock();
+    return num_boosted;
+  }
+
+  /** Activates/deactivates critical-path priorities of DAG nodes. Upon activation,
+      the unexecuted DAG nodes appended before it obtain their priorities as well,
+      such that the very first extraction already follows the priorities. **/
+  void activatePriorities(bool active) {
+    lock();
+    if(active && !(priorities_.exchange(active))){
+      const auto num_nodes = getNumNodes();
+      for(auto node = exec_state_.getFrontNode(); node < num_nodes; ++node){ //in the order of appending
+        if(!(getNodeProperties(node).isExecuted())) updatePriorities(node);
+      }
+    }else{
+      priorities_.store(active);
+    }
+    unlock();
+    return;
+  }
+
+  /** Returns TRUE if critical-path priorities of DAG nodes are active. **/
+  inline bool prioritiesActive() const {
+    return priorities_.load();
+  }
+
+  /** Returns the current number of dependency free nodes (ready queue length). **/
+  inline std::size_t getNumDependencyFreeNodes() {
+    lock();
+    auto num_nodes = exec_state_.getNumDependencyFreeNodes();
+    unlock();
+    return num_nodes;
+  }
+
   /** Returns the current list of dependency free nodes. **/
   inline std::list<VertexIdType> getDependencyFreeNodes() {
     lock();
@@ -330,7 +580,12 @@ public:
   /** Given just executed DAG node, moves forward the DAG front node
       if appropriate. **/
   inline bool progressFrontNode(VertexIdType node_executed) {
-    return exec_state_.progressFrontNode(node_executed);
+    lock();
+    auto progressed = exec_state_.progressFrontNode(node_executed);
+    if(skipExecutedFrontNodes()) progressed = true; //elided DAG nodes are never reported as executed
+    unlock();
+    if(progressed) reclaimExecutedNodes();
+    return progressed;
   }
 
   /** Returns the current front node id. **/
@@ -338,14 +593,150 @@ public:
     return exec_state_.getFrontNode();
   }
 
-  /** Affirms that the DAG has unexecuted nodes. **/
+  /** Affirms that the DAG has unexecuted nodes (including staged ones). **/
   inline bool hasUnexecutedNodes() {
-    return (exec_state_.getFrontNode() < this->getNumNodes());
+    return (hasStagedOperations() || draining_.load() || exec_state_.getFrontNode() < this->getNumNodes());
+  }
+
+  /** Stages a new tensor operation for a deferred appending into the DAG without
+      acquiring the DAG lock and returns its (future) DAG node id, which is also
+      set in the tensor operation. If the staging ring is full, the calling thread
+      will help drain it into the DAG. **/
+  VertexIdType stageOperation(std::shared_ptr<TensorOperation> op) {
+    std::size_t ticket = 0;
+    auto set_id = [this,&op](std::size_t pos){op->setId(pos - ticket_base_.load()); return;};
+    while(!staging_ring_.push(op,&ticket,set_id)){
+      if(drainStagedOperations() == 0) std::this_thread::yield();
+    }
+    return static_cast<VertexIdType>(ticket - ticket_base_.load());
+  }
+
+  /** Stages a batch of new tensor operations for a deferred appending into the DAG
+      under contiguous (future) DAG node ids, which are also set in the tensor operations.
+      Returns the DAG node id of the first tensor operation in the batch. Batches larger
+      than half the staging ring capacity are staged in chunks (still in order, but
+      possibly interleaved with tensor operations staged concurrently by other threads). **/
+  VertexIdType stageOperations(const std::vector<std::shared_ptr<TensorOperation>> & ops) {
+    VertexIdType first_node_id = 0;
+    const std::size_t max_chunk = staging_ring_.getCapacity() / 2;
+    std::vector<std::shared_ptr<TensorOperation>> chunk;
+    std::size_t pos = 0;
+    while(pos < ops.size()){
+      const std::size_t chunk_size = std::min(max_chunk,ops.size() - pos);
+      chunk.assign(ops.cbegin() + pos,ops.cbegin() + pos + chunk_size);
+      std::size_t first_ticket = 0;
+      const auto ticket_base = ticket_base_.load();
+      std::size_t i = 0;
+      while(!staging_ring_.pushBatch(chunk,&first_ticket,
+                                     [&chunk,&i,ticket_base](std::size_t tkt){
+                                       chunk[i++]->setId(tkt - ticket_base); return;})){
+        if(drainStagedOperations() == 0) std::this_thread::yield();
+      }
+      if(pos == 0) first_node_id = static_cast<VertexIdType>(first_ticket - ticket_base);
+      pos += chunk_size;
+    }
+    return first_node_id;
+  }
+
+  /** Appends up to max_batch staged tensor operations into the DAG in the staging order.
+      The batch is rewritten by the tensor operation rewriter first, if any.
+      Only one thread drains the staging ring at a time, other threads return immediately.
+      Returns the number of appended tensor operations. **/
+  std::size_t drainStagedOperations(std::size_t max_batch = DEFAULT_DRAIN_BATCH) {
+    std::size_t num_drained = 0;
+    if(!hasStagedOperations()) return num_drained;
+    std::unique_lock<std::mutex> drain_lock(drain_mtx_,std::try_to_lock);
+    if(drain_lock.owns_lock()){
+      draining_.store(true); //popped tensor operations are still unexecuted
+      const auto first_ticket = staging_ring_.getNumExtracted();
+      std::shared_ptr<TensorOperation> op;
+      while(drain_batch_.size() < max_batch){
+        if(!staging_ring_.pop(&op)) break;
+        drain_batch_.emplace_back(std::move(op));
+      }
+      num_drained = drain_batch_.size();
+      if(num_drained > 0){
+        std::size_t num_elided = 0;
+        drain_elided_.assign(num_drained,false);
+        if(rewriter_) num_elided = rewriter_(drain_batch_,drain_elided_);
+        lock();
+        for(std::size_t i = 0; i < num_drained; ++i){
+          const auto node_id = appendOperation(drain_batch_[i],drain_elided_[i]);
+          make_sure(node_id == (first_ticket + i - ticket_base_.load()),
+                    "exatn::runtime::TensorGraph::drainStagedOperations: Staged DAG node id mismatch!");
+        }
+        if(num_elided > 0) skipExecutedFrontNodes();
+        unlock();
+        drain_batch_.clear();
+      }
+      draining_.store(false);
+    }
+    return num_drained;
+  }
+
+  /** Resets the tensor operation rewriter applied to staged tensor operations
+      (an empty rewriter disables rewriting). **/
+  void resetOperationRewriter(TensorOpRewriter rewriter) {
+    std::lock_guard<std::mutex> drain_lock(drain_mtx_);
+    rewriter_ = std::move(rewriter);
+    return;
+  }
+
+  /** Returns TRUE if there are staged tensor operations not yet appended into the DAG. **/
+  inline bool hasStagedOperations() const {
+    return !(staging_ring_.isEmpty());
+  }
+
+  /** Requests cancellation of a DAG node (see rationale j), which can also be
+      a staged tensor operation not yet appended into the DAG. If the tensor operation
+      is provided, the request is ignored unless the DAG node stores it. Thread-safe. **/
+  void cancelNode(VertexIdType vertex_id,
+                  std::shared_ptr<TensorOperation> op = nullptr) {
+    std::lock_guard<std::mutex> cancel_lock(cancel_mtx_);
+    cancelled_nodes_.emplace_back(std::make_pair(vertex_id,std::move(op)));
+    cancellations_.store(true);
+    return;
+  }
+
+  /** Applies the pending cancellation requests to the idle DAG nodes (rationale j).
+      Must only be called by the execution thread. Cancellation requests for
+      DAG nodes not yet appended stay pending. Returns the number of cancelled DAG nodes. **/
+  std::size_t applyCancellations() {
+    std::size_t num_cancelled = 0;
+    if(!cancellations_.load()) return num_cancelled;
+    lock(); //lock order: DAG lock, then cancellation lock
+    std::unique_lock<std::mutex> cancel_lock(cancel_mtx_);
+    const auto num_nodes = getNumNodes();
+    auto node = cancelled_nodes_.begin();
+    while(node != cancelled_nodes_.end()){
+      const auto node_id = node->first;
+      if(node_id < num_nodes){
+        auto & node_properties = getNodeProperties(node_id);
+        const bool matches = (!(node->second) || node->second == node_properties.getOperation());
+        if(matches && node_properties.isIdle()){
+          exec_state_.unregisterDependencyFreeNode(node_id);
+          setNodeExecuting(node_id);
+          setNodeExecuted(node_id,0);
+          node_properties.getOperation()->dissociateTensorOperands();
+          ++num_cancelled;
+        }
+        node = cancelled_nodes_.erase(node);
+      }else{
+        ++node;
+      }
+    }
+    cancellations_.store(!(cancelled_nodes_.empty()));
+    cancel_lock.unlock();
+    if(num_cancelled > 0) skipExecutedFrontNodes();
+    unlock();
+    return num_cancelled;
   }
 
   virtual void clear() {
     lock();
+    resetStaging();
     exec_state_.clear();
+    boosted_nodes_.clear();
     unlock();
     return;
   }
@@ -354,10 +745,203 @@ public:
   inline void unlock() {mtx_.unlock();}
 
 protected:
+
+  /** Establishes data dependencies of a newly appended DAG node with stored tensor operation
+      (Read-after-Write, Write-after-Read, Write-after-Write) via addDependency()
+      and registers its tensor operands in the execution state. **/
+  void registerOperationDependencies(VertexIdType vid,
+                                     const TensorOperation & op) {
+    if(elide_append_) return; //elided DAG nodes establish no data dependencies
+    lock();
+    const auto opcode = op.getOpcode();
+    std::vector<VertexIdType> dependencies;
+    auto output_tensor = op.getTensorOperand(0); //output tensor operand
+    TensorRegion region; //INSERT only writes into the region of the inserted slice
+    if(opcode == TensorOpCode::INSERT) region = exec_state_.getSliceRegion(*output_tensor,*(op.getTensorOperand(1)));
+    exec_state_.registerTensorAccess(*output_tensor,vid,true,region,dependencies, //Write-after-Read & Write-after-Write
+                                     op.isCommutativeAccumulation());
+    unsigned int num_operands = op.getNumOperands();
+    for(unsigned int i = 1; i < num_operands; ++i){ //input tensor operands
+      auto tensor = op.getTensorOperand(i);
+      region.clear(); //SLICE only reads from the region of the extracted slice
+      if(opcode == TensorOpCode::SLICE) region = exec_state_.getSliceRegion(*tensor,*output_tensor);
+      exec_state_.registerTensorAccess(*tensor,vid,false,region,dependencies); //Read-after-Write
+    }
+    std::sort(dependencies.begin(),dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(),dependencies.end()),dependencies.end());
+    for(const auto & node_id: dependencies) addDependency(vid,node_id);
+    unlock();
+    return;
+  }
+
+  /** Selects (extracts) a dependency-free node admissible by a given predicate
+      from the list (the one with the highest priority if priorities are active). **/
+  bool selectDependencyFreeNode(VertexIdType * node_id,
+                                const std::function<bool (VertexIdType)> & admissible) {
+    bool avail = false;
+    if(latency_classes_.load()){
+      const bool priorities = prioritiesActive();
+      avail = exec_state_.extractDependencyFreeNode(node_id,
+               [this,priorities](VertexIdType node){
+                 const auto & node_properties = this->getNodeProperties(node);
+                 return std::pair<int,double>{node_properties.getLatencyClass(),
+                                              priorities ? node_properties.getPriority() : 0.0};
+               },admissible);
+    }else if(prioritiesActive()){
+      avail = exec_state_.extractDependencyFreeNode(node_id,
+               [this](VertexIdType node){return this->getNodeProperties(node).getPriority();},
+               admissible);
+    }else{
+      avail = exec_state_.extractDependencyFreeNodeIf(node_id,admissible);
+    }
+    return avail;
+  }
+
+  /** Returns TRUE if a DAG node with a commutative accumulation is blocked
+      by another commutative accumulation into the same tensor. **/
+  bool accumulationBlocked(VertexIdType node_id) {
+    const auto & op = getNodeProperties(node_id).getOperation();
+    if(!op || !(op->isCommutativeAccumulation())) return false;
+    return exec_state_.accumulationBlocked(*(op->getTensorOperand(0)),node_id);
+  }
+
+  /** Acquires the accumulation lock on the output tensor for a DAG node
+      with a commutative accumulation. Returns FALSE if the DAG node is blocked
+      by another commutative accumulation into the same tensor. **/
+  bool acquireAccumulation(VertexIdType node_id) {
+    const auto & op = getNodeProperties(node_id).getOperation();
+    if(!op || !(op->isCommutativeAccumulation())) return true;
+    return exec_state_.acquireAccumulation(*(op->getTensorOperand(0)),node_id);
+  }
+
+  /** Releases the accumulation lock on the output tensor if held by a given DAG node. **/
+  void releaseAccumulation(VertexIdType node_id) {
+    lock();
+    const auto & op = getNodeProperties(node_id).getOperation();
+    if(op && op->isCommutativeAccumulation()){
+      auto output_tensor = op->getTensorOperand(0);
+      if(output_tensor) exec_state_.releaseAccumulation(*output_tensor,node_id);
+    }
+    unlock();
+    return;
+  }
+
+  /** Registers the boosted DAG nodes which are ready for execution as dependency-free,
+      forgetting the executed and registered ones. **/
+  void registerBoostedNodes() {
+    lock();
+    auto node = boosted_nodes_.begin();
+    while(node != boosted_nodes_.end()){
+      bool done = nodeExecuted(*node) || nodeExecuting(*node);
+      if(!done && nodeDependenciesResolved(*node)){
+        exec_state_.registerDependencyFreeNode(*node);
+        done = true;
+      }
+      if(done){
+        node = boosted_nodes_.erase(node);
+      }else{
+        ++node;
+      }
+    }
+    unlock();
+    return;
+  }
+
+  /** Estimates the cost of a newly appended DAG node and propagates
+      its critical-path priority (bottom level) to all unexecuted
+      DAG nodes it (transitively) depends on. **/
+  void updatePriorities(VertexIdType node_id) {
+    lock();
+    auto & node_properties = getNodeProperties(node_id);
+    const auto & op = node_properties.getOperation();
+    const double cost = op->getFlopEstimate() + WORD_COST * op->getWordEstimate();
+    node_properties.setCost(cost);
+    node_properties.setPriority(cost);
+    std::vector<VertexIdType> updated{node_id};
+    while(!updated.empty()){
+      const auto node = updated.back(); updated.pop_back();
+      const double priority = getNodeProperties(node).getPriority();
+      visitNeighbors(node,[this,priority,&updated](VertexIdType dep){
+        auto & dep_properties = getNodeProperties(dep);
+        if(!(dep_properties.isExecuted())){
+          const double dep_priority = dep_properties.getCost() + priority;
+          if(dep_priority > dep_properties.getPriority()){
+            dep_properties.setPriority(dep_priority);
+            updated.emplace_back(dep);
+          }
+        }
+      });
+    }
+    unlock();
+    return;
+  }
+
+  /** Appends a tensor operation into the DAG via addOperation(). An elided tensor operation
+      establishes no data dependencies and its DAG node is marked as executed right away. **/
+  VertexIdType appendOperation(std::shared_ptr<TensorOperation> op,
+                               bool elided) {
+    lock();
+    if(op->getPriority() != TensorOpPriority::NORMAL) latency_classes_.store(true);
+    elide_append_ = elided;
+    const auto node_id = addOperation(op);
+    elide_append_ = false;
+    if(elided){
+      auto & node_properties = getNodeProperties(node_id);
+      node_properties.setExecuting();
+      node_properties.setExecuted(0);
+      op->dissociateTensorOperands();
+    }
+    unlock();
+    return node_id;
+  }
+
+  /** Moves the DAG front node forward past all executed DAG nodes.
+      Returns TRUE if the DAG front node has progressed. **/
+  bool skipExecutedFrontNodes() {
+    bool progressed = false;
+    lock();
+    const auto num_nodes = getNumNodes();
+    auto front = exec_state_.getFrontNode();
+    while(front < num_nodes){
+      if(!nodeExecuted(front)) break;
+      exec_state_.progressFrontNode(front);
+      front = exec_state_.getFrontNode();
+      progressed = true;
+    }
+    unlock();
+    return progressed;
+  }
+
+  /** Restarts the DAG node numbering of staged tensor operations from zero
+      (the DAG must be empty and there must be no staged tensor operations). **/
+  void resetStaging() {
+    make_sure(staging_ring_.isEmpty(),
+              "exatn::runtime::TensorGraph::resetStaging: Clearing the DAG with staged tensor operations!");
+    ticket_base_.store(staging_ring_.getNumIssued());
+    std::lock_guard<std::mutex> cancel_lock(cancel_mtx_);
+    cancelled_nodes_.clear(); //pending cancellation requests refer to the old DAG node numbering
+    cancellations_.store(false);
+    return;
+  }
+
   TensorExecState exec_state_; //tensor graph execution state
+  std::list<VertexIdType> boosted_nodes_; //boosted DAG nodes not yet registered as dependency-free
 
 private:
-  std::recursive_mutex mtx_; //object access mutex
+  TensorOpRing staging_ring_;             //staging ring for newly submitted tensor operations
+  std::atomic<std::size_t> ticket_base_;  //staging ticket corresponding to DAG node 0
+  std::mutex drain_mtx_;                  //serializes the consumers of the staging ring
+  std::atomic<bool> draining_;            //TRUE while a drained batch is being appended into the DAG
+  std::vector<std::shared_ptr<TensorOperation>> drain_batch_; //batch of drained tensor operations
+  std::vector<bool> drain_elided_;        //elision flags for the drained batch
+  TensorOpRewriter rewriter_;             //optional rewriter of drained batches
+  std::atomic<bool> priorities_;          //activation of critical-path priorities of DAG nodes
+  std::atomic<bool> latency_classes_;     //TRUE once a DAG node with a non-default latency class has appeared
+  bool elide_append_;                     //TRUE while appending an elided tensor operation
+  std::mutex cancel_mtx_;                 //protects the pending cancellation requests
+  std::list<std::pair<VertexIdType,std::shared_ptr<TensorOperation>>> cancelled_nodes_; //pending cancellation requests
+  std::atomic<bool> cancellations_;       //TRUE if there are pending cancellation requests
+  std::recursive_mutex mtx_;              //object access mutex
 };
 
 } // namespace runtime
@@ -0,0 +1,172 @@
+/** ExaTN:: Tensor Runtime: Lock-free staging ring for newly submitted tensor operations
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The tensor operation staging ring is a bounded multi-producer single-consumer (MPSC)
+     lock-free queue of tensor operations which have been submitted by Client threads
+     but not yet appended into the DAG. Each tensor operation occupies a slot with
+     its own sequence number, such that producers only contend on a single atomic
+     position counter and never block each other nor the consumer.
+ (b) Each successfully staged tensor operation gets a unique ticket, that is,
+     its monotonically increasing position in the ring. The consumer extracts
+     tensor operations strictly in the ticket order. An extraction stops at the
+     first slot which has been reserved by a producer but not yet published.
+ (c) A batch of tensor operations can be staged at once, in which case the producer
+     reserves a contiguous range of tickets (slots) with a single atomic update.
+     Since the consumer releases the slots strictly in the ticket order, the whole
+     range is free once its last slot is free.
+ (d) The ring has a single consumer at a time: Concurrent consumers must be
+     serialized externally (see TensorGraph::drainStagedOperations).
+**/
+
+#ifndef EXATN_RUNTIME_TENSOR_OP_RING_HPP_
+#define EXATN_RUNTIME_TENSOR_OP_RING_HPP_
+
+#include "tensor_operation.hpp"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "errors.hpp"
+
+namespace exatn {
+namespace runtime {
+
+class TensorOpRing {
+
+public:
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 8192; //must be a power of 2
+
+  TensorOpRing(std::size_t capacity = DEFAULT_CAPACITY):
+   slots_(capacity), mask_(capacity - 1), enqueue_pos_(0), dequeue_pos_(0)
+  {
+    make_sure((capacity >= 2) && ((capacity & (capacity - 1)) == 0),
+              "exatn::runtime::TensorOpRing: Ring capacity must be a power of 2!");
+    for(std::size_t i = 0; i < capacity; ++i) slots_[i].sequence.store(i,std::memory_order_relaxed);
+  }
+
+  TensorOpRing(const TensorOpRing &) = delete;
+  TensorOpRing & operator=(const TensorOpRing &) = delete;
+  TensorOpRing(TensorOpRing &&) noexcept = delete;
+  TensorOpRing & operator=(TensorOpRing &&) noexcept = delete;
+  ~TensorOpRing() = default;
+
+  /** Stages a tensor operation (any thread). Upon success, returns TRUE and the ticket
+      assigned to the staged tensor operation. The <on_reserve> functor, if provided, is
+      invoked with the ticket before the tensor operation becomes visible to the consumer.
+      Returns FALSE if the ring is full. **/
+  template <typename Functor>
+  bool push(std::shared_ptr<TensorOperation> op,
+            std::size_t * ticket,
+            Functor && on_reserve) {
+    Slot * slot = nullptr;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while(true){
+      slot = &(slots_[pos & mask_]);
+      const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if(diff == 0){
+        if(enqueue_pos_.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed)) break;
+      }else if(diff < 0){ //ring is full
+        return false;
+      }else{
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    on_reserve(pos);
+    slot->op = std::move(op);
+    slot->sequence.store(pos+1,std::memory_order_release); //publish
+    *ticket = pos;
+    return true;
+  }
+
+  bool push(std::shared_ptr<TensorOperation> op,
+            std::size_t * ticket) {
+    return push(op,ticket,[](std::size_t){return;});
+  }
+
+  /** Stages a batch of tensor operations (any thread) into a contiguous range of tickets.
+      Upon success, returns TRUE and the ticket assigned to the first staged tensor operation.
+      The <on_reserve> functor, if provided, is invoked with each ticket before the respective
+      tensor operation becomes visible to the consumer. Returns FALSE if the ring does not have
+      enough free slots (the batch must not exceed the ring capacity). **/
+  template <typename Functor>
+  bool pushBatch(const std::vector<std::shared_ptr<TensorOperation>> & ops,
+                 std::size_t * first_ticket,
+                 Functor && on_reserve) {
+    const std::size_t num_ops = ops.size();
+    if(num_ops == 0 || num_ops > slots_.size()) return false;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while(true){
+      const Slot & last_slot = slots_[(pos + num_ops - 1) & mask_];
+      const std::size_t seq = last_slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + num_ops - 1);
+      if(diff == 0){
+        if(enqueue_pos_.compare_exchange_weak(pos,pos+num_ops,std::memory_order_relaxed)) break;
+      }else if(diff < 0){ //not enough free slots
+        return false;
+      }else{
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    for(std::size_t i = 0; i < num_ops; ++i){
+      Slot & slot = slots_[(pos + i) & mask_];
+      on_reserve(pos + i);
+      slot.op = ops[i];
+      slot.sequence.store(pos+i+1,std::memory_order_release); //publish
+    }
+    *first_ticket = pos;
+    return true;
+  }
+
+  /** Extracts the next staged tensor operation in the ticket order (single consumer).
+      Returns FALSE if the ring is empty or the next tensor operation is not yet published. **/
+  bool pop(std::shared_ptr<TensorOperation> * op) {
+    const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Slot & slot = slots_[pos & mask_];
+    const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if(seq != (pos+1)) return false;
+    *op = std::move(slot.op);
+    slot.op.reset();
+    slot.sequence.store(pos+slots_.size(),std::memory_order_release); //release the slot
+    dequeue_pos_.store(pos+1,std::memory_order_release);
+    return true;
+  }
+
+  /** Returns TRUE if all staged tensor operations have been extracted by the consumer. **/
+  inline bool isEmpty() const {
+    return (dequeue_pos_.load(std::memory_order_acquire) == enqueue_pos_.load(std::memory_order_acquire));
+  }
+
+  /** Returns the total number of tickets issued so far. **/
+  inline std::size_t getNumIssued() const {return enqueue_pos_.load(std::memory_order_acquire);}
+
+  /** Returns the total number of tensor operations extracted by the consumer so far. **/
+  inline std::size_t getNumExtracted() const {return dequeue_pos_.load(std::memory_order_acquire);}
+
+  /** Returns the ring capacity. **/
+  inline std::size_t getCapacity() const {return slots_.size();}
+
+private:
+
+  struct Slot {
+    std::atomic<std::size_t> sequence;   //slot sequence number
+    std::shared_ptr<TensorOperation> op; //staged tensor operation
+    Slot(): sequence(0), op(nullptr) {}
+  };
+
+  std::vector<Slot> slots_;                          //ring slots
+  const std::size_t mask_;                           //capacity - 1
+  alignas(64) std::atomic<std::size_t> enqueue_pos_; //next ticket to be issued (producers)
+  alignas(64) std::atomic<std::size_t> dequeue_pos_; //next ticket to be extracted (consumer)
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_TENSOR_OP_RING_HPP_
@@ -1,3 +1,5 @@
+#include "tensor_op_fusion.hpp"
+
 #include "cppmicroservices/BundleActivator.h"
 #include "cppmicroservices/BundleContext.h"
 
@@ -19,6 +21,10 @@ public:
    */
   void Start(BundleContext context) {
 
+    //Activate tensor graph (DAG) optimizers:
+    context.RegisterService<exatn::runtime::TensorGraphOptimizer>(
+      std::make_shared<exatn::runtime::TensorOpFusion>()
+    );
   }
 
   /**
@@ -1,19 +1,64 @@
+/** ExaTN:: Tensor Runtime: Tensor graph (DAG) optimizer
+REVISION: 2022/03/21
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) A tensor graph optimizer rewrites batches of staged tensor operations
+     right before they are appended into the DAG (see TensorGraph::drainStagedOperations).
+     It may rewrite tensor operations and elide some of them. An elided tensor operation
+     still occupies its DAG node but it is never executed. The submitted tensor operations
+     are shared with the client (and its caches, for example, the cached tensor operations
+     of a tensor network), which may resubmit them, thus they must never be modified in place:
+     A rewritten tensor operation is a clone (with the same id) replacing the submitted one
+     in the batch, such that only the DAG node sees the rewritten tensor operation.
+ (b) Since the rewritten tensor operations have not been appended into the DAG yet,
+     the optimizer does not need to synchronize with the DAG execution. However, it
+     can only see the tensor operations from the same batch.
+ (c) Tensor graph optimizers are registered as services by their names. The tensor runtime
+     selects the optimizer via the "runtime_dag_optimizer" runtime parameter (ParamConf).
+**/
+
 #ifndef EXATN_RUNTIME_DAGOPT_HPP_
 #define EXATN_RUNTIME_DAGOPT_HPP_
 
+#include "Identifiable.hpp"
+
 #include "tensor_graph.hpp"
+#include "tensor_operation.hpp"
 
+#include <vector>
 #include <memory>
 
 namespace exatn {
 namespace runtime {
 
-class TensorGraphOptimizer {
+class TensorGraphOptimizer : public Identifiable, public Cloneable<TensorGraphOptimizer> {
 
 public:
 
-  virtual void optimize(TensorGraph & dag) = 0;
+  virtual ~TensorGraphOptimizer() = default;
+
+  /** Rewrites a batch of tensor operations (in their submission order) which are about
+      to be appended into the DAG. Sets elided[i] to TRUE for each tensor operation to be
+      elided (already elided tensor operations must stay elided) and replaces each rewritten
+      tensor operation by its rewritten clone (see rationale a). Returns the number of
+      elided tensor operations in the batch. **/
+  virtual std::size_t optimize(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                               std::vector<bool> & elided) = 0;
+
+  /** Returns a tensor operation rewriter for the DAG based on this optimizer. **/
+  TensorOpRewriter getRewriter() {
+    auto optimizer = this->clone();
+    return [optimizer](std::vector<std::shared_ptr<TensorOperation>> & operations,
+                       std::vector<bool> & elided){
+      return optimizer->optimize(operations,elided);
+    };
+  }
 
+  /** Clones an empty subclass instance (needed for plugin registry). **/
+  virtual std::shared_ptr<TensorGraphOptimizer> clone() = 0;
 };
 
 } // namespace runtime
@@ -0,0 +1,246 @@
+/** ExaTN:: Tensor Runtime: Tensor graph optimizer: Tensor operation fusion
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+**/
+
+#include "tensor_op_fusion.hpp"
+
+#include "tensor_op_contract.hpp"
+#include "tensor_op_transform.hpp"
+#include "functor_init_val.hpp"
+#include "functor_scale.hpp"
+
+#include <algorithm>
+
+#include "errors.hpp"
+
+namespace exatn {
+namespace runtime {
+
+/** Replaces a tensor operation in the batch by its clone, which can then be rewritten
+    without affecting the submitted tensor operation. Returns the clone. **/
+static inline std::shared_ptr<TensorOperation> & privatize(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                                           std::size_t pos)
+{
+  operations[pos] = std::shared_ptr<TensorOperation>(operations[pos]->clone());
+  return operations[pos];
+}
+
+/** Returns TRUE if the tensor operation has the given tensor among its operands. **/
+static inline bool touchesTensor(const TensorOperation & op, TensorHashType tensor_hash)
+{
+  const auto num_operands = op.getNumOperands();
+  for(unsigned int i = 0; i < num_operands; ++i){
+    if(op.getTensorOperandHash(i) == tensor_hash) return true;
+  }
+  return false;
+}
+
+/** Returns TRUE if the tensor operation has the given tensor among its output operands. **/
+static inline bool writesTensor(const TensorOperation & op, TensorHashType tensor_hash)
+{
+  const auto num_operands_out = op.getNumOperandsOut();
+  for(unsigned int i = 0; i < num_operands_out; ++i){
+    if(op.getTensorOperandHash(i) == tensor_hash) return true;
+  }
+  return false;
+}
+
+/** Returns TRUE if the tensor operation is a zero initialization of a tensor. **/
+static inline bool isZeroInit(const TensorOperation & op)
+{
+  if(op.getOpcode() == TensorOpCode::TRANSFORM && op.getNumOperands() == 1){
+    const auto * transform = dynamic_cast<const numerics::TensorOpTransform *>(&op);
+    if(transform != nullptr){
+      auto functor = std::dynamic_pointer_cast<numerics::FunctorInitVal>(transform->getFunctor());
+      if(functor) return (functor->getValue() == std::complex<double>{0.0,0.0});
+    }
+  }
+  return false;
+}
+
+/** Returns TRUE if the tensor operation is a scaling of a tensor (returns the scaling value). **/
+static inline bool isScaling(const TensorOperation & op, std::complex<double> * value)
+{
+  if(op.getOpcode() == TensorOpCode::TRANSFORM && op.getNumOperands() == 1){
+    const auto * transform = dynamic_cast<const numerics::TensorOpTransform *>(&op);
+    if(transform != nullptr){
+      auto functor = std::dynamic_pointer_cast<numerics::FunctorScale>(transform->getFunctor());
+      if(functor){
+        *value = functor->getValue();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/** Returns TRUE if the tensor operation only writes into the given tensor
+    (its single output operand) without reading it. **/
+static inline bool onlyWritesTensor(const TensorOperation & op, TensorHashType tensor_hash)
+{
+  const auto opcode = op.getOpcode();
+  if(opcode == TensorOpCode::CONTRACT || opcode == TensorOpCode::ADD ||
+     opcode == TensorOpCode::INSERT || isZeroInit(op)){
+    if(op.getNumOperandsOut() == 1 && op.getTensorOperandHash(0) == tensor_hash){
+      const auto num_operands = op.getNumOperands();
+      for(unsigned int i = 1; i < num_operands; ++i){
+        if(op.getTensorOperandHash(i) == tensor_hash) return false;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+
+std::size_t TensorOpFusion::optimize(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                     std::vector<bool> & elided)
+{
+  make_sure(elided.size() == operations.size(),
+            "exatn::runtime::TensorOpFusion::optimize: Elision flags do not match the tensor operations!");
+  const auto num_ops = operations.size();
+  for(std::size_t i = 0; i < num_ops; ++i){
+    if(!elided[i]){
+      const auto & op = *(operations[i]);
+      switch(op.getOpcode()){
+      case TensorOpCode::CREATE:
+        elideUnreadTensor(operations,elided,i);
+        break;
+      case TensorOpCode::TRANSFORM:
+        if(isZeroInit(op)){
+          fuseZeroInit(operations,elided,i);
+        }else{
+          std::complex<double> value;
+          if(isScaling(op,&value)) fuseScaling(operations,elided,i,value);
+        }
+        break;
+      case TensorOpCode::ADD:
+        mergeAdditions(operations,elided,i);
+        break;
+      default:
+        break;
+      }
+    }
+  }
+  return static_cast<std::size_t>(std::count(elided.cbegin(),elided.cend(),true));
+}
+
+
+std::size_t TensorOpFusion::elideUnreadTensor(const std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                              std::vector<bool> & elided,
+                                              std::size_t create_pos)
+{
+  const auto tensor_hash = operations[create_pos]->getTensorOperandHash(0);
+  const auto end_pos = std::min(operations.size(),create_pos + 1 + FUSION_WINDOW);
+  std::vector<std::size_t> writers;
+  for(auto pos = create_pos + 1; pos < end_pos; ++pos){
+    if(elided[pos]) continue;
+    const auto & op = *(operations[pos]);
+    if(!touchesTensor(op,tensor_hash)) continue;
+    if(op.getOpcode() == TensorOpCode::DESTROY){ //the tensor has never been read
+      elided[create_pos] = true;
+      for(const auto & writer: writers) elided[writer] = true;
+      elided[pos] = true;
+      return (writers.size() + 2);
+    }
+    if(!onlyWritesTensor(op,tensor_hash)) break; //the tensor is read
+    writers.emplace_back(pos);
+  }
+  return 0;
+}
+
+
+std::size_t TensorOpFusion::fuseZeroInit(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                         std::vector<bool> & elided,
+                                         std::size_t transform_pos)
+{
+  const auto tensor_hash = operations[transform_pos]->getTensorOperandHash(0);
+  const auto end_pos = std::min(operations.size(),transform_pos + 1 + FUSION_WINDOW);
+  for(auto pos = transform_pos + 1; pos < end_pos; ++pos){
+    if(elided[pos]) continue;
+    const auto & op = *(operations[pos]);
+    if(!touchesTensor(op,tensor_hash)) continue;
+    if(op.getOpcode() == TensorOpCode::CONTRACT && onlyWritesTensor(op,tensor_hash)){
+      auto contraction = std::dynamic_pointer_cast<numerics::TensorOpContract>(operations[pos]);
+      if(contraction && contraction->isAccumulative()){
+        contraction = std::dynamic_pointer_cast<numerics::TensorOpContract>(privatize(operations,pos));
+        contraction->resetAccumulative(false); //beta = 0: overwrites the output tensor
+        contraction->setCommutativeAccumulation(false); //must precede other accumulations into the tensor
+        elided[transform_pos] = true;
+        return 1;
+      }
+    }
+    break; //the next tensor operation touching the tensor cannot absorb its zero initialization
+  }
+  return 0;
+}
+
+
+std::size_t TensorOpFusion::fuseScaling(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                        std::vector<bool> & elided,
+                                        std::size_t transform_pos,
+                                        std::complex<double> value)
+{
+  const auto tensor_hash = operations[transform_pos]->getTensorOperandHash(0);
+  const auto elem_type = operations[transform_pos]->getTensorOperand(0)->getElementType();
+  if(value.imag() != 0.0 && (elem_type == TensorElementType::REAL32 || elem_type == TensorElementType::REAL64))
+    return 0; //a complex beta prefactor cannot scale a real tensor
+  const auto end_pos = std::min(operations.size(),transform_pos + 1 + FUSION_WINDOW);
+  for(auto pos = transform_pos + 1; pos < end_pos; ++pos){
+    if(elided[pos]) continue;
+    const auto & op = *(operations[pos]);
+    if(!touchesTensor(op,tensor_hash)) continue;
+    if(op.getOpcode() == TensorOpCode::CONTRACT && onlyWritesTensor(op,tensor_hash)){
+      auto contraction = std::dynamic_pointer_cast<numerics::TensorOpContract>(operations[pos]);
+      if(contraction && contraction->isAccumulative()){
+        contraction = std::dynamic_pointer_cast<numerics::TensorOpContract>(privatize(operations,pos));
+        contraction->resetBeta(contraction->getBeta() * value); //beta * value: scales the output tensor
+        contraction->setCommutativeAccumulation(false); //must precede other accumulations into the tensor
+        elided[transform_pos] = true;
+        return 1;
+      }
+    }
+    break; //the next tensor operation touching the tensor cannot absorb its scaling
+  }
+  return 0;
+}
+
+
+std::size_t TensorOpFusion::mergeAdditions(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                           std::vector<bool> & elided,
+                                           std::size_t add_pos)
+{
+  std::size_t num_merged = 0;
+  const auto & addition = *(operations[add_pos]);
+  const auto accumulator_hash = addition.getTensorOperandHash(0);
+  const auto tensor_hash = addition.getTensorOperandHash(1);
+  if(tensor_hash == accumulator_hash) return num_merged;
+  const bool conjugated = addition.operandIsConjugated(1);
+  const auto & pattern = addition.getIndexPattern();
+  auto prefactor = addition.getScalar(0);
+  const auto end_pos = std::min(operations.size(),add_pos + 1 + FUSION_WINDOW);
+  for(auto pos = add_pos + 1; pos < end_pos; ++pos){
+    if(elided[pos]) continue;
+    const auto & op = *(operations[pos]);
+    if(op.getOpcode() == TensorOpCode::ADD && op.getTensorOperandHash(0) == accumulator_hash){
+      if(op.getTensorOperandHash(1) == accumulator_hash) break;
+      if(op.getTensorOperandHash(1) == tensor_hash &&
+         op.operandIsConjugated(1) == conjugated &&
+         op.getIndexPattern() == pattern){
+        prefactor += op.getScalar(0);
+        elided[pos] = true;
+        ++num_merged;
+      }
+      continue; //additions into the same accumulator commute
+    }
+    if(touchesTensor(op,accumulator_hash) || writesTensor(op,tensor_hash)) break;
+  }
+  if(num_merged > 0) privatize(operations,add_pos)->setScalar(0,prefactor);
+  return num_merged;
+}
+
+} //namespace runtime
+} //namespace exatn
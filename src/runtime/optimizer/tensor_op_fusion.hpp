@@ -0,0 +1,86 @@
+/** ExaTN:: Tensor Runtime: Tensor graph optimizer: Tensor operation fusion
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry Lyakh
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The tensor operation fusion pass rewrites a batch of staged tensor operations
+     (within a lookahead window of FUSION_WINDOW tensor operations):
+     1. CREATE/DESTROY pairs of never-read tensors are elided together with
+        all tensor operations (only) writing into those tensors in between;
+     2. A zero initialization (TRANSFORM with FunctorInitVal(0)) of a tensor
+        which is next touched by an accumulating CONTRACT writing into it is fused
+        into that CONTRACT, which becomes non-accumulative (beta = 0 semantics);
+     3. A chain of ADDs into the same accumulator is merged: Each ADD of the same
+        tensor with the same index pattern and conjugation is folded into the first
+        one by summing the scalar prefactors, as long as the accumulator is not touched
+        by any other tensor operation in between and the added tensor is not updated;
+     4. A scaling of a tensor (TRANSFORM with FunctorScale) which is next touched by
+        an accumulating CONTRACT writing into it is fused into that CONTRACT as its beta
+        prefactor (Operand 0 = beta * Operand 0 + alpha * Operand 1 * Operand 2).
+     Each fusion removes a whole pass over the participating (output) tensor. A CONTRACT
+     absorbing a zero initialization or a scaling is no longer a commutative accumulation.
+     The absorbing CONTRACT (ADD) is a clone of the submitted one (see TensorGraphOptimizer).
+ (b) The tensor operation fusion pass is registered as "tensor-op-fusion". It is not active
+     by default (runtime parameter "runtime_dag_optimizer").
+**/
+
+#ifndef EXATN_RUNTIME_TENSOR_OP_FUSION_HPP_
+#define EXATN_RUNTIME_TENSOR_OP_FUSION_HPP_
+
+#include "tensor_graph_optimizer.hpp"
+
+#include <vector>
+#include <memory>
+#include <complex>
+
+namespace exatn {
+namespace runtime {
+
+class TensorOpFusion : public TensorGraphOptimizer {
+
+public:
+
+  static constexpr const std::size_t FUSION_WINDOW = 256; //max number of tensor operations inspected ahead
+
+  TensorOpFusion() = default;
+  virtual ~TensorOpFusion() = default;
+
+  /** Fuses tensor operations within the batch. **/
+  virtual std::size_t optimize(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                               std::vector<bool> & elided) override;
+
+  const std::string name() const override {return "tensor-op-fusion";}
+  const std::string description() const override {return "Tensor operation fusion pass";}
+  std::shared_ptr<TensorGraphOptimizer> clone() override {return std::make_shared<TensorOpFusion>();}
+
+protected:
+
+  /** Elides a CREATE/DESTROY pair of a never-read tensor together
+      with all tensor operations writing into it in between. **/
+  std::size_t elideUnreadTensor(const std::vector<std::shared_ptr<TensorOperation>> & operations,
+                                std::vector<bool> & elided,
+                                std::size_t create_pos);
+
+  /** Fuses a zero initialization of a tensor into the next CONTRACT writing into it. **/
+  std::size_t fuseZeroInit(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                           std::vector<bool> & elided,
+                           std::size_t transform_pos);
+
+  /** Fuses a scaling of a tensor into the next CONTRACT writing into it (beta prefactor). **/
+  std::size_t fuseScaling(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                          std::vector<bool> & elided,
+                          std::size_t transform_pos,
+                          std::complex<double> value);
+
+  /** Merges subsequent ADDs of the same tensor into the same accumulator. **/
+  std::size_t mergeAdditions(std::vector<std::shared_ptr<TensorOperation>> & operations,
+                             std::vector<bool> & elided,
+                             std::size_t add_pos);
+};
+
+} //namespace runtime
+} //namespace exatn
+
+#endif //EXATN_RUNTIME_TENSOR_OP_FUSION_HPP_
@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Task-based execution layer for tensor operations
-REVISION: 2022/01/17
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -7,6 +7,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 
 #include "tensor_runtime.hpp"
 #include "exatn_service.hpp"
+#include "thread_topology.hpp"
 
 #include "talshxx.hpp"
 
@@ -15,6 +16,7 @@ Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
 #endif
 
 #include <vector>
+#include <complex>
 #include <iostream>
 
 #include "errors.hpp"
@@ -32,8 +34,9 @@ TensorRuntime::TensorRuntime(const MPICommProxy & communicator,
                              const std::string & graph_executor_name,
                              const std::string & node_executor_name):
  parameters_(parameters),
- graph_executor_name_(graph_executor_name), node_executor_name_(node_executor_name),
- current_dag_(nullptr), logging_(0), executing_(false), scope_set_(false), alive_(false)
+ graph_executor_name_(graph_executor_name), node_executor_name_(node_executor_name), dag_kind_("boost-digraph"), dag_optimizer_name_("none"),
+ current_dag_(nullptr), concurrent_scopes_(false), scope_quantum_(DEFAULT_SCOPE_QUANTUM),
+ logging_(0), executing_(false), scope_set_(false), alive_(false), retain_node_executor_(false)
 {
 #ifdef DEBUG
   const bool debugging = true;
@@ -44,6 +47,18 @@ TensorRuntime::TensorRuntime(const MPICommProxy & communicator,
   int mpi_error = MPI_Comm_size(global_mpi_comm,&num_processes_); assert(mpi_error == MPI_SUCCESS);
   mpi_error = MPI_Comm_rank(global_mpi_comm,&process_rank_); assert(mpi_error == MPI_SUCCESS);
   mpi_error = MPI_Comm_rank(MPI_COMM_WORLD,&global_process_rank_); assert(mpi_error == MPI_SUCCESS);
+  int64_t spin_budget = Waiter::DEFAULT_SPIN_BUDGET;
+  if(parameters_.getParameter("runtime_spin_budget",&spin_budget)){
+    exec_waiter_.resetSpinBudget(spin_budget);
+    sync_waiter_.resetSpinBudget(spin_budget);
+  }
+  parameters_.getParameter("runtime_dag_kind",dag_kind_);
+  parameters_.getParameter("runtime_dag_optimizer",dag_optimizer_name_);
+  int64_t concurrent_scopes = 0;
+  if(parameters_.getParameter("runtime_concurrent_scopes",&concurrent_scopes)) concurrent_scopes_ = (concurrent_scopes != 0);
+  int64_t scope_quantum = 0;
+  if(parameters_.getParameter("runtime_scope_quantum",&scope_quantum) && scope_quantum > 0) scope_quantum_ = scope_quantum;
+  if(dag_optimizer_name_ != "none") dag_optimizer_ = exatn::getService<TensorGraphOptimizer>(dag_optimizer_name_);
   graph_executor_ = exatn::getService<TensorGraphExecutor>(graph_executor_name_);
   if(debugging) std::cout << "#DEBUG(exatn::runtime::TensorRuntime)[MAIN_THREAD:Process " << process_rank_
                           << "]: DAG executor set to " << graph_executor_name_ << " + "
@@ -55,8 +70,9 @@ TensorRuntime::TensorRuntime(const ParamConf & parameters,
                              const std::string & graph_executor_name,
                              const std::string & node_executor_name):
  parameters_(parameters),
- graph_executor_name_(graph_executor_name), node_executor_name_(node_executor_name),
- current_dag_(nullptr), logging_(0), executing_(false), scope_set_(false), alive_(false)
+ graph_executor_name_(graph_executor_name), node_executor_name_(node_executor_name), dag_kind_("boost-digraph"), dag_optimizer_name_("none"),
+ current_dag_(nullptr), concurrent_scopes_(false), scope_quantum_(DEFAULT_SCOPE_QUANTUM),
+ logging_(0), executing_(false), scope_set_(false), alive_(false), retain_node_executor_(false)
 {
 #ifdef DEBUG
   const bool debugging = true;
@@ -64,6 +80,18 @@ TensorRuntime::TensorRuntime(const ParamConf & parameters,
   const bool debugging = false;
 #endif
   num_processes_ = 1; process_rank_ = 0; global_process_rank_ = 0;
+  int64_t spin_budget = Waiter::DEFAULT_SPIN_BUDGET;
+  if(parameters_.getParameter("runtime_spin_budget",&spin_budget)){
+    exec_waiter_.resetSpinBudget(spin_budget);
+    sync_waiter_.resetSpinBudget(spin_budget);
+  }
+  parameters_.getParameter("runtime_dag_kind",dag_kind_);
+  parameters_.getParameter("runtime_dag_optimizer",dag_optimizer_name_);
+  int64_t concurrent_scopes = 0;
+  if(parameters_.getParameter("runtime_concurrent_scopes",&concurrent_scopes)) concurrent_scopes_ = (concurrent_scopes != 0);
+  int64_t scope_quantum = 0;
+  if(parameters_.getParameter("runtime_scope_quantum",&scope_quantum) && scope_quantum > 0) scope_quantum_ = scope_quantum;
+  if(dag_optimizer_name_ != "none") dag_optimizer_ = exatn::getService<TensorGraphOptimizer>(dag_optimizer_name_);
   graph_executor_ = exatn::getService<TensorGraphExecutor>(graph_executor_name_);
   if(debugging) std::cout << "#DEBUG(exatn::runtime::TensorRuntime)[MAIN_THREAD]: DAG executor set to "
                           << graph_executor_name_ << " + " << node_executor_name_ << std::endl << std::flush;
@@ -76,6 +104,7 @@ TensorRuntime::~TensorRuntime()
 {
   if(alive_.load()){
     alive_.store(false); //signal for the execution thread to finish
+    exec_waiter_.notify();
     //std::cout << "#DEBUG(exatn::runtime::TensorRuntime)[MAIN_THREAD]: Waiting Execution Thread ... " << std::flush;
     exec_thread_.join(); //wait until the execution thread has finished
     //std::cout << "Joined" << std::endl << std::flush;
@@ -83,6 +112,82 @@ TensorRuntime::~TensorRuntime()
 }
 
 
+bool TensorRuntime::reconfigure(const ParamConf & parameters,
+                                const std::string & graph_executor_name,
+                                const std::string & node_executor_name)
+{
+  if(node_executor_name != node_executor_name_) return false; //tensor bodies are owned by the node executor
+  while(!graph_executor_);
+  //Drain all executed DAGs (the current DAG and all concurrently executed DAGs, paused DAGs are idle):
+  if(currentScopeIsSet()){
+    bool synced = sync(true); assert(synced);
+  }
+  if(concurrent_scopes_){ //sync() only waits on the current DAG
+    auto scopes_drained = [this](){
+      std::lock_guard<std::mutex> lock(scope_mtx_);
+      for(const auto & scope: running_scopes_){
+        if(scope.dag->hasUnexecutedNodes()) return false;
+      }
+      return true;
+    };
+    sync_waiter_.wait([this,&scopes_drained](){
+      if(scopes_drained()) return true;
+      activateExecution();
+      return false;
+    });
+  }
+  sync_waiter_.wait([this](){return !(executing_.load());});
+  //Stop the execution thread, retaining the node executor:
+  bool validation_trace = false;
+  const bool serialize = graph_executor_->isSerialized(&validation_trace);
+  if(alive_.load()){
+    retain_node_executor_.store(true);
+    alive_.store(false); //signal for the execution thread to finish
+    exec_waiter_.notify();
+    exec_thread_.join();
+    retain_node_executor_.store(false);
+  }
+  //The runtime metrics of the outgoing DAG executor do not survive:
+  if(currentScopeIsSet()) dumpExecDiagnostics(current_scope_);
+  //Apply the new configuration:
+  parameters_ = parameters;
+  graph_executor_name_ = graph_executor_name;
+  int64_t spin_budget = Waiter::DEFAULT_SPIN_BUDGET;
+  parameters_.getParameter("runtime_spin_budget",&spin_budget);
+  exec_waiter_.resetSpinBudget(spin_budget);
+  sync_waiter_.resetSpinBudget(spin_budget);
+  dag_kind_ = "boost-digraph";
+  parameters_.getParameter("runtime_dag_kind",dag_kind_); //scopes opened afterwards
+  dag_optimizer_name_ = "none";
+  parameters_.getParameter("runtime_dag_optimizer",dag_optimizer_name_);
+  dag_optimizer_.reset();
+  if(dag_optimizer_name_ != "none") dag_optimizer_ = exatn::getService<TensorGraphOptimizer>(dag_optimizer_name_);
+  for(auto & dag: dags_){ //the open scopes are drained, thus their rewriters can be replaced
+    dag.second->resetOperationRewriter(dag_optimizer_ ? dag_optimizer_->getRewriter() : TensorOpRewriter());
+  }
+  int64_t scope_quantum = 0;
+  if(parameters_.getParameter("runtime_scope_quantum",&scope_quantum) && scope_quantum > 0) scope_quantum_ = scope_quantum;
+  auto graph_executor = exatn::getService<TensorGraphExecutor>(graph_executor_name_);
+  graph_executor->resetSerialization(serialize,validation_trace);
+  graph_executor_ = graph_executor;
+  //Relaunch the execution thread with the retained node executor:
+  launchExecutionThread();
+  graph_executor_->waitNodeExecutorInitialized();
+  if(logging_ != 0) graph_executor_->resetLoggingLevel(logging_);
+  return true;
+}
+
+
+void TensorRuntime::dumpExecDiagnostics(const std::string & scope_name)
+{
+  graph_executor_->dumpExecTrace(scope_name); //no-op unless the execution trace is active
+  graph_executor_->dumpMemoryTimeline(scope_name); //no-op unless the memory timeline is active
+  graph_executor_->dumpExecProfile(scope_name); //no-op unless the execution profile is active
+  graph_executor_->dumpCommProfile(scope_name); //no-op unless the communication profile is active
+  return;
+}
+
+
 void TensorRuntime::launchExecutionThread()
 {
   if(!(alive_.load())){
@@ -97,23 +202,50 @@ void TensorRuntime::launchExecutionThread()
 
 void TensorRuntime::executionThreadWorkflow()
 {
-  graph_executor_->resetNodeExecutor(exatn::getService<TensorNodeExecutor>(node_executor_name_),
-                                     parameters_,num_processes_,process_rank_,global_process_rank_);
+  getThreadTopology().pinRuntimeThread(true); //if the thread topology is active
+  auto node_executor = std::move(handed_node_executor_); //hot reconfiguration: node executor of the previous configuration
+  if(!node_executor) node_executor = exatn::getService<TensorNodeExecutor>(node_executor_name_);
+  graph_executor_->resetNodeExecutor(node_executor,parameters_,num_processes_,process_rank_,global_process_rank_);
+  node_executor.reset();
+  if(concurrent_scopes_) graph_executor_->resetExecutionQuantum(scope_quantum_);
   //std::cout << "#DEBUG(exatn::runtime::TensorRuntime)[EXEC_THREAD]: DAG node executor set to "
             //<< node_executor_name_ << std::endl << std::flush;
   while(alive_.load()){ //alive_ is set by the main thread
-    while(executing_.load()){ //executing_ is set to TRUE by the main thread when new operations and syncs are submitted
+    while(executing_.load() && concurrent_scopes_){ //all open scopes are executed concurrently
+      bool unfinished = executeConcurrentScopes();
+      processTensorDataRequests(); //process all outstanding client requests for tensor data (synchronous)
+      if(!unfinished){
+        graph_executor_->execute(tensor_network_queue_);
+        executing_.store(false); //executing_ is set to FALSE by the execution thread
+        if(executeConcurrentScopes()) executing_.store(true); //new operations have been submitted meanwhile
+        sync_waiter_.notify();
+      }
+    }
+    while(executing_.load() && !concurrent_scopes_){ //executing_ is set to TRUE by the main thread when new operations and syncs are submitted
+      current_dag_->drainStagedOperations(); //append a batch of newly submitted tensor operations into the DAG
+      current_dag_->applyCancellations(); //cancel the requested idle DAG nodes (speculative execution)
       graph_executor_->execute(*current_dag_);
+      graph_executor_->recordDagState(*current_dag_);
       processTensorDataRequests(); //process all outstanding client requests for tensor data (synchronous)
       if(current_dag_->hasUnexecutedNodes()){
         executing_.store(true); //reaffirm that DAG is still executing
       }else{
         graph_executor_->execute(tensor_network_queue_);
-        if(!(current_dag_->hasUnexecutedNodes())) executing_.store(false); //executing_ is set to FALSE by the execution thread
+        if(!(current_dag_->hasUnexecutedNodes())){
+          executing_.store(false); //executing_ is set to FALSE by the execution thread
+          sync_waiter_.notify();
+        }
       }
     }
     processTensorDataRequests(); //process all outstanding client requests for tensor data (synchronous)
+    const auto idle_start = exatn::Timer::timeInSecHR();
+    exec_waiter_.wait([this](){ //idle wait for new work
+      return (executing_.load() || !(alive_.load()) || hasTensorDataRequests());
+    });
+    graph_executor_->recordIdleTime(exatn::Timer::timeInSecHR(idle_start));
   }
+  processTensorDataRequests(); //client requests for tensor data submitted right before the end of life
+  if(retain_node_executor_.load()) handed_node_executor_ = graph_executor_->getNodeExecutor(); //hot reconfiguration
   graph_executor_->resetNodeExecutor(std::shared_ptr<TensorNodeExecutor>(nullptr),
                                      parameters_,num_processes_,process_rank_,global_process_rank_);
   //std::cout << "#DEBUG(exatn::runtime::TensorRuntime)[EXEC_THREAD]: DAG node executor reset. End of life."
@@ -122,6 +254,44 @@ void TensorRuntime::executionThreadWorkflow()
 }
 
 
+bool TensorRuntime::executeConcurrentScopes()
+{
+  std::vector<ScopeSlot> scopes;
+  scope_mtx_.lock();
+  scopes = running_scopes_; //snapshot: the main thread may open/close scopes meanwhile
+  scope_mtx_.unlock();
+  bool unfinished = false;
+  for(auto & scope: scopes){
+    for(unsigned int quantum = 0; quantum < scope.weight; ++quantum){
+      scope.dag->drainStagedOperations(); //append a batch of newly submitted tensor operations into the DAG
+      scope.dag->applyCancellations(); //cancel the requested idle DAG nodes (speculative execution)
+      if(!(scope.dag->hasUnexecutedNodes())) break;
+      graph_executor_->execute(*(scope.dag)); //returns once the execution quantum is exhausted
+      graph_executor_->recordDagState(*(scope.dag));
+    }
+    unfinished = unfinished || scope.dag->hasUnexecutedNodes();
+  }
+  return unfinished;
+}
+
+
+bool TensorRuntime::hasTensorDataRequests()
+{
+  lockDataReqQ();
+  bool pending = !(data_req_queue_.empty() && view_req_queue_.empty());
+  unlockDataReqQ();
+  return pending;
+}
+
+
+void TensorRuntime::activateExecution()
+{
+  executing_.store(true);
+  exec_waiter_.notify();
+  return;
+}
+
+
 void TensorRuntime::processTensorDataRequests()
 {
   lockDataReqQ();
@@ -129,6 +299,10 @@ void TensorRuntime::processTensorDataRequests()
     req.slice_promise_.set_value(graph_executor_->getLocalTensor(*(req.tensor_),req.slice_specs_));
   }
   data_req_queue_.clear();
+  for(auto & req: view_req_queue_){
+    req.view_promise_.set_value(createTensorView(*(req.tensor_)));
+  }
+  view_req_queue_.clear();
   unlockDataReqQ();
   return;
 }
@@ -178,6 +352,20 @@ std::size_t TensorRuntime::getMemoryUsage(std::size_t * free_mem) const
 }
 
 
+double TensorRuntime::getMemoryFragmentation(std::size_t * tensor_mem) const
+{
+  while(!graph_executor_);
+  return graph_executor_->getMemoryFragmentation(tensor_mem);
+}
+
+
+double TensorRuntime::getContractionMemoryFactor() const
+{
+  while(!graph_executor_);
+  return graph_executor_->getContractionMemoryFactor();
+}
+
+
 double TensorRuntime::getTotalFlopCount() const
 {
   while(!graph_executor_);
@@ -185,28 +373,56 @@ double TensorRuntime::getTotalFlopCount() const
 }
 
 
+RuntimeMetrics TensorRuntime::getMetrics() const
+{
+  while(!graph_executor_);
+  return graph_executor_->getMetrics();
+}
+
+
+void TensorRuntime::resetMetrics()
+{
+  while(!graph_executor_);
+  return graph_executor_->resetMetrics();
+}
+
+
+MemoryTimeline * TensorRuntime::getMemoryTimeline() const
+{
+  while(!graph_executor_);
+  return graph_executor_->getMemoryTimeline();
+}
+
+
 void TensorRuntime::openScope(const std::string & scope_name) {
   assert(!scope_name.empty());
-  // Complete the current scope first:
-  if(currentScopeIsSet()){
+  // Complete the current scope first (unless all open scopes execute concurrently):
+  if(currentScopeIsSet() && !concurrent_scopes_){
     assert(scope_name != current_scope_);
     closeScope();
   }
   // Create new DAG with name given by scope name and store it in the dags map:
   auto new_dag = dags_.emplace(std::make_pair(
                                 scope_name,
-                                exatn::getService<TensorGraph>("boost-digraph")
+                                exatn::getService<TensorGraph>(dag_kind_)
                                )
                               );
   assert(new_dag.second); // make sure there was no other scope with the same name
   current_dag_ = (new_dag.first)->second; //storing a shared pointer to the DAG
+  if(dag_optimizer_) current_dag_->resetOperationRewriter(dag_optimizer_->getRewriter());
   current_scope_ = scope_name; // change the name of the current scope
+  if(concurrent_scopes_){ // schedule the new DAG for concurrent execution
+    scope_mtx_.lock();
+    running_scopes_.emplace_back(ScopeSlot{scope_name,current_dag_,1});
+    scope_mtx_.unlock();
+  }
   scope_set_.store(true);
   return;
 }
 
 
 void TensorRuntime::pauseScope() {
+  if(concurrent_scopes_) return; //all open scopes keep progressing
   graph_executor_->stopExecution(); //execution thread will pause and reset executing_ to FALSE
   return;
 }
@@ -214,13 +430,33 @@ void TensorRuntime::pauseScope() {
 
 void TensorRuntime::resumeScope(const std::string & scope_name) {
   assert(!scope_name.empty());
+  if(concurrent_scopes_){ // only switch the current scope
+    auto dag = dags_.find(scope_name);
+    assert(dag != dags_.end());
+    current_dag_ = dag->second;
+    current_scope_ = scope_name;
+    scope_set_.store(true);
+    activateExecution();
+    return;
+  }
   // Pause the current scope first:
   if(currentScopeIsSet()) pauseScope();
-  while(executing_.load()){}; //wait until the execution thread stops executing previous DAG
+  sync_waiter_.wait([this](){return !(executing_.load());}); //wait until the execution thread stops executing previous DAG
   current_dag_ = dags_[scope_name]; //storing a shared pointer to the DAG
   current_scope_ = scope_name; // change the name of the current scope
   scope_set_.store(true);
-  executing_.store(true); //will trigger DAG execution by the execution thread
+  activateExecution(); //will trigger DAG execution by the execution thread
+  return;
+}
+
+
+void TensorRuntime::setScopeWeight(const std::string & scope_name, unsigned int weight) {
+  assert(weight > 0);
+  scope_mtx_.lock();
+  for(auto & scope: running_scopes_){
+    if(scope.name == scope_name) scope.weight = weight;
+  }
+  scope_mtx_.unlock();
   return;
 }
 
@@ -228,8 +464,25 @@ void TensorRuntime::resumeScope(const std::string & scope_name) {
 void TensorRuntime::closeScope() {
   if(currentScopeIsSet()){
     sync();
-    while(executing_.load()){}; //wait until the execution thread has completed execution of the current DAG
     const std::string scope_name = current_scope_;
+    if(concurrent_scopes_){ //other open scopes may still be executing
+      scope_mtx_.lock();
+      for(auto scope = running_scopes_.begin(); scope != running_scopes_.end(); ++scope){
+        if(scope->name == scope_name){
+          running_scopes_.erase(scope);
+          break;
+        }
+      }
+      const bool last_scope = running_scopes_.empty();
+      scope_mtx_.unlock();
+      if(last_scope){
+        sync_waiter_.wait([this](){return !(executing_.load());});
+        dumpExecDiagnostics(scope_name);
+      }
+    }else{
+      sync_waiter_.wait([this](){return !(executing_.load());}); //wait until the execution thread has completed execution of the current DAG
+      dumpExecDiagnostics(scope_name);
+    }
     scope_set_.store(false);
     current_scope_ = "";
     current_dag_.reset();
@@ -242,22 +495,44 @@ void TensorRuntime::closeScope() {
 
 VertexIdType TensorRuntime::submit(std::shared_ptr<TensorOperation> op) {
   assert(currentScopeIsSet());
-  auto node_id = current_dag_->addOperation(op);
-  op->setId(node_id);
+  TensorExecState::registerTensorWrites(*op); //bumps the versions of the output tensor operands
+  auto node_id = current_dag_->stageOperation(op); //lock-free: the execution thread will append it into the DAG
   //current_dag_->printIt(); //debug
-  executing_.store(true); //signal to the execution thread to execute the DAG
+  activateExecution(); //signal to the execution thread to execute the DAG
+  return node_id;
+}
+
+
+VertexIdType TensorRuntime::submit(const std::vector<std::shared_ptr<TensorOperation>> & ops) {
+  assert(currentScopeIsSet());
+  if(ops.empty()) return 0; //empty batch
+  for(const auto & op: ops) TensorExecState::registerTensorWrites(*op); //bumps the versions of the output tensor operands
+  auto node_id = current_dag_->stageOperations(ops); //lock-free: the execution thread will append them into the DAG
+  activateExecution(); //signal to the execution thread to execute the DAG
   return node_id;
 }
 
 
 bool TensorRuntime::sync(TensorOperation & op, bool wait) {
   assert(currentScopeIsSet());
-  executing_.store(true); //reactivate the execution thread to execute the DAG in case it was not active
+  activateExecution(); //reactivate the execution thread to execute the DAG in case it was not active
   auto opid = op.getId();
-  bool completed = current_dag_->nodeExecuted(opid);
-  while(wait && (!completed)){
-    executing_.store(true); //reactivate the execution thread to execute the DAG in case it was not active
-    completed = current_dag_->nodeExecuted(opid);
+  auto op_completed = [this,opid](){ //staged operation may not be in the DAG yet
+    return (opid < current_dag_->getNumNodes()) && current_dag_->nodeExecuted(opid);
+  };
+  bool completed = op_completed();
+  if(wait && (!completed)){
+    //A latency-sensitive tensor operation boosts its dependencies once it is in the DAG:
+    bool boosted = !(op.getPriority() > TensorOpPriority::NORMAL);
+    sync_waiter_.wait([this,&op,opid,&boosted,&op_completed](){
+      if(!boosted && opid < current_dag_->getNumNodes()){
+        current_dag_->boostNode(opid,op.getPriority());
+        boosted = true;
+      }
+      activateExecution(); //reactivate the execution thread to execute the DAG in case it was not active
+      return op_completed();
+    });
+    completed = true;
   }
   return completed;
 }
@@ -266,11 +541,18 @@ bool TensorRuntime::sync(TensorOperation & op, bool wait) {
 bool TensorRuntime::sync(const Tensor & tensor, bool wait) {
   //if(wait) std::cout << "#DEBUG(TensorRuntime::sync)[MAIN_THREAD]: Syncing on tensor " << tensor.getName() << " ... "; //debug
   assert(currentScopeIsSet());
-  executing_.store(true); //reactivate the execution thread to execute the DAG in case it was not active
-  bool completed = (current_dag_->getTensorUpdateCount(tensor) == 0);
-  while(wait && (!completed)){
-    executing_.store(true); //reactivate the execution thread to execute the DAG in case it was not active
-    completed = (current_dag_->getTensorUpdateCount(tensor) == 0);
+  activateExecution(); //reactivate the execution thread to execute the DAG in case it was not active
+  auto tensor_completed = [this,&tensor](){ //staged operations are not yet accounted in the tensor update count
+    current_dag_->drainStagedOperations();
+    return (!(current_dag_->hasStagedOperations()) && current_dag_->getTensorUpdateCount(tensor) == 0);
+  };
+  bool completed = tensor_completed();
+  if(wait && (!completed)){
+    sync_waiter_.wait([this,&tensor_completed](){
+      activateExecution(); //reactivate the execution thread to execute the DAG in case it was not active
+      return tensor_completed();
+    });
+    completed = true;
   }
   //if(wait) std::cout << "Synced" << std::endl; //debug
   return completed;
@@ -280,13 +562,20 @@ bool TensorRuntime::sync(const Tensor & tensor, bool wait) {
 bool TensorRuntime::sync(bool wait) {
   //if(wait) std::cout << "#DEBUG(TensorRuntime::sync)[MAIN_THREAD]: Syncing ... "; //debug
   assert(currentScopeIsSet());
-  if(current_dag_->hasUnexecutedNodes()) executing_.store(true);
-  bool still_working = executing_.load();
-  while(wait && still_working){
-    if(current_dag_->hasUnexecutedNodes()) executing_.store(true);
-    still_working = executing_.load();
+  if(current_dag_->hasUnexecutedNodes()) activateExecution();
+  auto dag_completed = [this](){ //concurrent scopes: only the current DAG is waited on
+    if(concurrent_scopes_) return !(current_dag_->hasUnexecutedNodes());
+    return !(executing_.load());
+  };
+  bool still_working = !dag_completed();
+  if(wait && still_working){
+    sync_waiter_.wait([this,&dag_completed](){
+      if(current_dag_->hasUnexecutedNodes()) activateExecution();
+      return dag_completed();
+    });
+    still_working = false;
   }
-  if(wait && (!still_working)){
+  if(wait && (!still_working) && !concurrent_scopes_ && !(current_dag_->reclaimsExecutedNodes())){ //concurrently executed DAGs are not cleared
     if(current_dag_->getNumNodes() > MAX_RUNTIME_DAG_SIZE){
       //std::cout << "Clearing DAG ... "; //debug
       current_dag_->clear();
@@ -298,13 +587,61 @@ bool TensorRuntime::sync(bool wait) {
 }
 
 
+bool TensorRuntime::isCancellable(const TensorOperation & op) {
+  switch(op.getOpcode()){
+    case TensorOpCode::NOOP: case TensorOpCode::CREATE: case TensorOpCode::DESTROY:
+    case TensorOpCode::FETCH: case TensorOpCode::UPLOAD:
+    case TensorOpCode::BROADCAST: case TensorOpCode::ALLREDUCE:
+      return false;
+    default:
+      return true;
+  }
+}
+
+
+std::size_t TensorRuntime::cancel(const std::vector<std::shared_ptr<TensorOperation>> & ops) {
+  assert(currentScopeIsSet());
+  std::size_t num_cancelled = 0;
+  for(const auto & op: ops){
+    if(op && isCancellable(*op)){
+      current_dag_->cancelNode(op->getId(),op); //staged operation may not be in the DAG yet
+      ++num_cancelled;
+    }
+  }
+  if(num_cancelled > 0) activateExecution(); //the execution thread applies the cancellations
+  return num_cancelled;
+}
+
+
+bool TensorRuntime::throttle(std::size_t max_unexecuted) {
+  assert(currentScopeIsSet());
+  if(!(current_dag_->reclaimsExecutedNodes())) return sync(true);
+  auto below_limit = [this,max_unexecuted](){
+    return ((current_dag_->getNumNodes() - current_dag_->getFrontNode()) < max_unexecuted);
+  };
+  if(!below_limit()){
+    sync_waiter_.wait([this,&below_limit](){
+      activateExecution(); //reactivate the execution thread to execute the DAG in case it was not active
+      return below_limit();
+    });
+  }
+  return true;
+}
+
+
 #ifdef CUQUANTUM
 TensorOpExecHandle TensorRuntime::submit(std::shared_ptr<numerics::TensorNetwork> network,
                                          const MPICommProxy & communicator,
                                          unsigned int num_processes, unsigned int process_rank)
 {
-  const auto exec_handle = tensor_network_queue_.append(network,communicator,num_processes,process_rank);
-  executing_.store(true); //signal to the execution thread to execute the queue
+  TensorExecState::registerTensorWrite(*(network->getTensor(0))); //bumps the version of the output tensor
+  auto exec_handle = tensor_network_queue_.append(network,communicator,num_processes,process_rank);
+  while(exec_handle == 0){ //tensor network queue is full: Let the execution thread drain it
+    activateExecution();
+    std::this_thread::yield();
+    exec_handle = tensor_network_queue_.append(network,communicator,num_processes,process_rank);
+  }
+  activateExecution(); //signal to the execution thread to execute the queue
   return exec_handle;
 }
 
@@ -312,14 +649,17 @@ TensorOpExecHandle TensorRuntime::submit(std::shared_ptr<numerics::TensorNetwork
 bool TensorRuntime::syncNetwork(const TensorOpExecHandle exec_handle, bool wait)
 {
   assert(exec_handle != 0);
-  executing_.store(true); //reactivate the execution thread in case it was not active
-  bool synced = false;
-  while(!synced){
+  activateExecution(); //reactivate the execution thread in case it was not active
+  auto network_synced = [this,exec_handle](){
     const auto exec_stat = tensor_network_queue_.checkExecStatus(exec_handle);
-    synced = (exec_stat == TensorNetworkQueue::ExecStat::None ||
-              exec_stat == TensorNetworkQueue::ExecStat::Completed);
-    if(!wait) break;
+    return (exec_stat == TensorNetworkQueue::ExecStat::None ||
+            exec_stat == TensorNetworkQueue::ExecStat::Completed);
   };
+  bool synced = network_synced();
+  if(wait && (!synced)){
+    sync_waiter_.wait(network_synced);
+    synced = true;
+  }
   return synced;
 }
 #endif
@@ -328,7 +668,9 @@ bool TensorRuntime::syncNetwork(const TensorOpExecHandle exec_handle, bool wait)
 std::future<std::shared_ptr<talsh::Tensor>> TensorRuntime::getLocalTensor(std::shared_ptr<Tensor> tensor,
                                           const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec)
 {
-  // Complete all submitted update operations on the tensor:
+  // Complete all submitted update operations on the tensor (interactive read):
+  current_dag_->drainStagedOperations();
+  current_dag_->boostTensor(*tensor,TensorOpPriority::INTERACTIVE);
   auto synced = sync(*tensor,true); assert(synced);
   // Create promise-future pair:
   std::promise<std::shared_ptr<talsh::Tensor>> promised_slice;
@@ -337,8 +679,73 @@ std::future<std::shared_ptr<talsh::Tensor>> TensorRuntime::getLocalTensor(std::s
   lockDataReqQ();
   data_req_queue_.emplace_back(std::move(promised_slice),slice_spec,tensor);
   unlockDataReqQ();
+  exec_waiter_.notify();
   return future_slice;
 }
 
+
+std::future<TensorView> TensorRuntime::getTensorView(std::shared_ptr<Tensor> tensor)
+{
+  // Complete all submitted update operations on the tensor (interactive read):
+  current_dag_->drainStagedOperations();
+  current_dag_->boostTensor(*tensor,TensorOpPriority::INTERACTIVE);
+  auto synced = sync(*tensor,true); assert(synced);
+  // Create promise-future pair:
+  std::promise<TensorView> promised_view;
+  auto future_view = promised_view.get_future();
+  // Schedule view request:
+  lockDataReqQ();
+  view_req_queue_.emplace_back(std::move(promised_view),tensor);
+  unlockDataReqQ();
+  exec_waiter_.notify();
+  return future_view;
+}
+
+
+TensorView TensorRuntime::createTensorView(const Tensor & tensor)
+{
+  auto view = graph_executor_->getTensorView(tensor);
+  if(view.isEmpty()){ //fall back to a view over a copy of the full tensor
+    const auto tensor_rank = tensor.getRank();
+    std::vector<std::pair<DimOffset,DimExtent>> slice_spec(tensor_rank);
+    std::vector<DimExtent> extents(tensor_rank);
+    for(unsigned int i = 0; i < tensor_rank; ++i){
+      extents[i] = tensor.getDimExtent(i);
+      slice_spec[i] = std::pair<DimOffset,DimExtent>{0,extents[i]};
+    }
+    auto local_tensor = graph_executor_->getLocalTensor(tensor,slice_spec);
+    if(local_tensor){
+      const void * body = nullptr;
+      bool access_granted = false;
+      switch(tensor.getElementType()){
+      case TensorElementType::REAL32:
+        {const float * body_r4 = nullptr;
+         access_granted = local_tensor->getDataAccessHostConst(&body_r4); body = body_r4;}
+        break;
+      case TensorElementType::REAL64:
+        {const double * body_r8 = nullptr;
+         access_granted = local_tensor->getDataAccessHostConst(&body_r8); body = body_r8;}
+        break;
+      case TensorElementType::COMPLEX32:
+        {const std::complex<float> * body_c4 = nullptr;
+         access_granted = local_tensor->getDataAccessHostConst(&body_c4); body = body_c4;}
+        break;
+      case TensorElementType::COMPLEX64:
+        {const std::complex<double> * body_c8 = nullptr;
+         access_granted = local_tensor->getDataAccessHostConst(&body_c8); body = body_c8;}
+        break;
+      default:
+        break;
+      }
+      if(access_granted){
+        const auto elem_type = tensorComputeElementType(tensor.getElementType()); //in-memory element type
+        const std::size_t size = local_tensor->getVolume() * numerics::tensor_element_type_size(elem_type);
+        view = TensorView(body,size,elem_type,extents,local_tensor); //the view owns the copy
+      }
+    }
+  }
+  return view;
+}
+
 } // namespace runtime
 } // namespace exatn
@@ -1,5 +1,5 @@
 /** ExaTN:: Tensor Runtime: Task-based execution layer for tensor operations
-REVISION: 2022/01/17
+REVISION: 2022/03/27
 
 Copyright (C) 2018-2022 Dmitry Lyakh, Tiffany Mintz, Alex McCaskey
 Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
@@ -39,6 +39,56 @@ Rationale:
      of the DAG structure (by Client thread) and its execution state (by Execution thread).
      Additionally each node of the TensorGraph (TensorOpNode object) provides more fine grain
      locking mechanism (lock/unlock methods) for providing exclusive access to individual DAG nodes.
+     The .submit method does not acquire the DAG lock: It stages the tensor operation into the
+     lock-free staging ring of the DAG which is drained into the DAG by the Execution thread.
+     A batch of tensor operations is staged at once (single ticket reservation), such that
+     it is appended into the DAG within a single critical section (up to the drain batch size).
+ (f) DEVELOPERS ONLY: The idle Execution thread and the Client thread waiting for completion
+     block on spin-then-park waiters (see waiter.hpp) whose spin budget is regulated by the
+     "runtime_spin_budget" runtime parameter.
+ (g) DEVELOPERS ONLY: The DAG implementation is selected by the "runtime_dag_kind"
+     runtime parameter: "boost-digraph" (default) or "csr-digraph". The latter reclaims
+     the storage of executed DAG nodes, thus lifting the MAX_RUNTIME_DAG_SIZE limit.
+ (h) DEVELOPERS ONLY: Batches of submitted tensor operations are rewritten by the DAG optimizer
+     right before they are appended into the DAG. The DAG optimizer is selected by the
+     "runtime_dag_optimizer" runtime parameter: "none" (default) or "tensor-op-fusion".
+ (i) The runtime performance counters (see exec_metrics.hpp) are always on and can be
+     queried by any thread via getMetrics(). The Execution thread accounts the time
+     it spends idle waiting for new work.
+ (j) Tensor views (see tensor_view.hpp) provide read-only zero-copy access to the local
+     tensor body in the Host buffer of the node executor. They are created by the execution
+     thread (via the same client data request mechanism as getLocalTensor) and pin the tensor
+     until released. Client threads must release a view before waiting on further tensor
+     operations on the viewed tensor, otherwise those operations will be postponed forever.
+ (k) Concurrent scopes: If the "runtime_concurrent_scopes" runtime parameter is set to 1,
+     all open scopes (DAGs) progress concurrently on the same node executor: openScope()
+     no longer closes the current scope, resumeScope() no longer pauses it (only switches
+     the current scope for the subsequent submissions and syncs) and pauseScope() is a no-op.
+     The Execution thread time-slices among the open DAGs in a weighted round-robin fashion:
+     In each round, a DAG receives as many execution quanta as its weight (setScopeWeight,
+     default 1), with an execution quantum of "runtime_scope_quantum" DAG traversal iterations.
+     Synchronization only waits on the current DAG. Closing a scope completes its DAG only.
+     The eager and parallel graph executors ignore the execution quantum, thus the DAGs are
+     then interleaved at the granularity of the batches of submitted tensor operations.
+ (l) Hot reconfiguration: reconfigure() drains the current DAG and, with concurrent scopes (k),
+     all other open DAGs (without concurrent scopes, the DAGs of the paused scopes are not being
+     executed and keep their unexecuted DAG nodes, which resume with the new DAG executor once
+     their scope is resumed). Then it stops the Execution thread and relaunches it with a new
+     DAG executor and new runtime parameters, handing the existing node executor over to it
+     (re-initialized with the new parameters), thus all tensor bodies and the caches of the node
+     executor survive. The open scopes (DAGs) are kept and switched to the new DAG optimizer,
+     whereas the new DAG kind only applies to the scopes opened afterwards, and the concurrent
+     scope execution mode cannot be changed. The runtime metrics (kept by the DAG executor) restart,
+     thus the execution trace, memory timeline and profiles recorded by the outgoing DAG executor
+     are dumped first (as upon scope closure). Switching to another node executor kind is not
+     possible this way since the tensor bodies are owned by the node executor.
+ (m) Cancellation (speculative execution): cancel() requests cancellation of previously submitted
+     tensor operations in the current scope, which the Execution thread then drops from the DAG
+     unless they are already executing or executed (best effort, see TensorGraph rationale (j)).
+     Only local computational tensor operations can be cancelled: Tensor creation/destruction
+     and communication (FETCH, UPLOAD, BROADCAST, ALLREDUCE) are always executed, such that
+     the tensor bodies and the communication pattern stay consistent. The output tensors of
+     cancelled tensor operations are left in an undefined state (they should only be destroyed).
 **/
 
 #ifndef EXATN_RUNTIME_TENSOR_RUNTIME_HPP_
@@ -47,11 +97,13 @@ Rationale:
 #include "tensor_graph.hpp"
 #include "tensor_network_queue.hpp"
 #include "tensor_graph_executor.hpp"
+#include "tensor_graph_optimizer.hpp"
 #include "tensor_operation.hpp"
 #include "tensor_method.hpp"
 
 #include "param_conf.hpp"
 #include "mpi_proxy.hpp"
+#include "waiter.hpp"
 
 #include <map>
 #include <list>
@@ -71,6 +123,7 @@ class TensorRuntime final {
 public:
 
   static constexpr std::size_t MAX_RUNTIME_DAG_SIZE = 8192; //max allowed DAG size during runtime
+  static constexpr std::size_t DEFAULT_SCOPE_QUANTUM = 16;   //default execution quantum (DAG traversal iterations) for concurrent scopes
 
 #ifdef MPI_ENABLED
   TensorRuntime(const MPICommProxy & communicator,                               //MPI communicator proxy
@@ -88,6 +141,13 @@ public:
   TensorRuntime & operator=(TensorRuntime &&) noexcept = delete;
   ~TensorRuntime();
 
+  /** Reconfigures the tensor runtime in place with new runtime parameters and a new DAG executor,
+      keeping all tensors, open scopes and the node executor (see rationale (l)).
+      Returns FALSE if the requested node executor kind differs (nothing done then). **/
+  bool reconfigure(const ParamConf & parameters,                                  //in: runtime configuration parameters
+                   const std::string & graph_executor_name = "eager-dag-executor", //in: DAG executor kind
+                   const std::string & node_executor_name = "talsh-node-executor"); //in: DAG node executor kind
+
   /** Resets the logging level (0:none) [MAIN THREAD]. **/
   void resetLoggingLevel(int level = 0);
 
@@ -108,9 +168,27 @@ public:
       Note that the returned value includes buffer fragmentation overhead. **/
   std::size_t getMemoryUsage(std::size_t * free_mem) const;
 
+  /** Returns the current memory fragmentation factor (memory usage over the total size
+      of all allocated tensors, 0.0 if unknown) and, optionally, the latter (bytes). **/
+  double getMemoryFragmentation(std::size_t * tensor_mem = nullptr) const;
+
+  /** Returns the peak memory of a binary tensor contraction relative to the volume of its tensor operands. **/
+  double getContractionMemoryFactor() const;
+
   /** Returns the current value of the total Flop count executed by the executor. **/
   double getTotalFlopCount() const;
 
+  /** Returns a snapshot of the runtime performance counters (always on). **/
+  RuntimeMetrics getMetrics() const;
+
+  /** Resets the runtime performance counters. **/
+  void resetMetrics();
+
+  /** Returns the memory timeline of the node executor (nullptr if not tracked),
+      which records the tensor allocation/free events once activated by the
+      "talsh_memory_timeline" runtime parameter and is reported upon scope closure. **/
+  MemoryTimeline * getMemoryTimeline() const;
+
   /** Opens a new scope represented by a new execution graph (DAG). **/
   void openScope(const std::string & scope_name);
 
@@ -126,14 +204,27 @@ public:
       in the current execution graph. **/
   void closeScope();
 
+  /** Sets the weight of an open scope in the concurrent scope execution:
+      The number of execution quanta its DAG receives per scheduling round. **/
+  void setScopeWeight(const std::string & scope_name, //in: open scope name
+                      unsigned int weight);           //in: weight (>0)
+
   /** Returns TRUE if there is the current scope is set. **/
   inline bool currentScopeIsSet() const {return scope_set_.load();}
 
+  /** Returns TRUE if all open scopes execute concurrently. **/
+  inline bool concurrentScopes() const {return concurrent_scopes_;}
+
   /** Submits a tensor operation into the current execution graph and returns its integer id. **/
   VertexIdType submit(std::shared_ptr<TensorOperation> op); //in: tensor operation
 
+  /** Submits a batch of tensor operations into the current execution graph under contiguous
+      integer ids (staged together) and returns the id of the first tensor operation. **/
+  VertexIdType submit(const std::vector<std::shared_ptr<TensorOperation>> & ops); //in: tensor operations
+
   /** Tests for completion of a given tensor operation.
-      If wait = TRUE, it will block until completion. **/
+      If wait = TRUE, it will block until completion. A blocking wait on a tensor operation
+      with an above-normal latency class boosts all its unexecuted dependencies to that class. **/
   bool sync(TensorOperation & op,
             bool wait = true);
 
@@ -146,6 +237,25 @@ public:
       If wait = TRUE, it will block until completion. **/
   bool sync(bool wait = true);
 
+  /** Requests cancellation of previously submitted tensor operations in the current scope
+      (see rationale (m)). Returns the number of tensor operations requested to be cancelled
+      (non-cancellable tensor operations are skipped). **/
+  std::size_t cancel(const std::vector<std::shared_ptr<TensorOperation>> & ops); //in: submitted tensor operations
+
+  /** Returns TRUE if a given tensor operation can be cancelled. **/
+  static bool isCancellable(const TensorOperation & op);
+
+  /** Limits the number of unexecuted tensor operations in the current execution graph
+      by blocking until it drops below max_unexecuted, if the execution graph reclaims
+      executed nodes. Otherwise, it is equivalent to sync(true). **/
+  bool throttle(std::size_t max_unexecuted = MAX_RUNTIME_DAG_SIZE);
+
+  /** Returns TRUE if the current execution graph reclaims executed nodes,
+      thus not requiring periodic synchronization to bound its size. **/
+  inline bool reclaimsExecutedNodes() const {
+    return (currentScopeIsSet() && current_dag_->reclaimsExecutedNodes());
+  }
+
 #ifdef CUQUANTUM
   /** Submits an entire tensor network for processing as a whole.
       The returned execution handle can be used for checking the status
@@ -168,6 +278,12 @@ public:
   std::future<std::shared_ptr<talsh::Tensor>> getLocalTensor(std::shared_ptr<Tensor> tensor, //in: exatn::numerics::Tensor to get slice of (by copy)
                             const std::vector<std::pair<DimOffset,DimExtent>> & slice_spec); //in: tensor slice specification
 
+  /** Returns a read-only zero-copy view of the local tensor body (TensorView),
+      which pins the tensor in the node executor until the view is released.
+      If zero-copy views are not supported, the view will own a copy of the tensor body.
+      The returned future becomes ready once the execution thread has created the view. **/
+  std::future<TensorView> getTensorView(std::shared_ptr<Tensor> tensor); //in: exatn::numerics::Tensor to view
+
 private:
   /** Tensor data request **/
   class TensorDataReq{
@@ -188,12 +304,51 @@ private:
    ~TensorDataReq() = default;
   };
 
+  /** Tensor view request **/
+  class TensorViewReq{
+  public:
+   std::promise<TensorView> view_promise_;
+   std::shared_ptr<Tensor> tensor_;
+
+   TensorViewReq(std::promise<TensorView> && view_promise,
+                 std::shared_ptr<Tensor> tensor):
+    view_promise_(std::move(view_promise)), tensor_(tensor){}
+
+   TensorViewReq(const TensorViewReq & req) = delete;
+   TensorViewReq & operator=(const TensorViewReq & req) = delete;
+   TensorViewReq(TensorViewReq && req) noexcept = default;
+   TensorViewReq & operator=(TensorViewReq && req) noexcept = default;
+   ~TensorViewReq() = default;
+  };
+
+  /** Open scope scheduled for concurrent execution **/
+  struct ScopeSlot{
+   std::string name;                //scope name
+   std::shared_ptr<TensorGraph> dag; //scope DAG
+   unsigned int weight;             //number of execution quanta per scheduling round
+  };
+
+  /** Executes all open scopes with the weighted round-robin time slicing (by execution thread).
+      Returns TRUE if some open scope still has unexecuted tensor operations. **/
+  bool executeConcurrentScopes();
+
+  /** Creates a tensor view (by execution thread). **/
+  TensorView createTensorView(const Tensor & tensor);
+
+  /** Dumps the execution trace, memory timeline and profiles recorded by the DAG executor
+      (each one only if active). Must not overlap with the DAG execution. **/
+  void dumpExecDiagnostics(const std::string & scope_name);
+
   /** Launches the execution thread which will be executing DAGs on the fly. **/
   void launchExecutionThread();
   /** The execution thread lives here. **/
   void executionThreadWorkflow();
   /** Processes all outstanding tensor data requests (by execution thread). **/
   void processTensorDataRequests();
+  /** Returns TRUE if there are outstanding tensor data requests. **/
+  bool hasTensorDataRequests();
+  /** Signals the execution thread to execute the current DAG (wakes it up if idle). **/
+  void activateExecution();
 
   inline void lockDataReqQ(){data_req_mtx_.lock();}
   inline void unlockDataReqQ(){data_req_mtx_.unlock();}
@@ -204,6 +359,10 @@ private:
   std::string graph_executor_name_;
   /** Tensor graph (DAG) node executor name **/
   std::string node_executor_name_;
+  /** Tensor graph (DAG) implementation name **/
+  std::string dag_kind_;
+  /** Tensor graph (DAG) optimizer name **/
+  std::string dag_optimizer_name_;
   /** Total number of parallel processes in the dedicated MPI communicator **/
   int num_processes_;
   /** Rank of the current parallel process in the dedicated MPI communicator **/
@@ -212,6 +371,8 @@ private:
   int global_process_rank_;
   /** Current tensor graph (DAG) executor **/
   std::shared_ptr<TensorGraphExecutor> graph_executor_;
+  /** Tensor graph (DAG) optimizer (optional) **/
+  std::shared_ptr<TensorGraphOptimizer> dag_optimizer_;
   /** Active execution graphs (DAGs) **/
   std::map<std::string, std::shared_ptr<TensorGraph>> dags_;
   /** Name of the current scope (current DAG name) **/
@@ -220,6 +381,14 @@ private:
   std::shared_ptr<TensorGraph> current_dag_; //pointer to the current DAG
   /** Tensor data request queue **/
   std::list<TensorDataReq> data_req_queue_;
+  /** Tensor view request queue **/
+  std::list<TensorViewReq> view_req_queue_;
+  /** Open scopes scheduled for concurrent execution **/
+  std::vector<ScopeSlot> running_scopes_;
+  /** Concurrent execution of all open scopes **/
+  bool concurrent_scopes_;
+  /** Execution quantum (DAG traversal iterations) for concurrent scopes **/
+  std::size_t scope_quantum_;
   /** List of tensor networks submitted for processing as a whole **/
   TensorNetworkQueue tensor_network_queue_;
   /** Logging level (0:none) **/
@@ -232,8 +401,18 @@ private:
   std::atomic<bool> alive_; //TRUE while the main thread is accepting new operations from Client
   /** Execution thread **/
   std::thread exec_thread_;
+  /** Node executor handed over from the previous Execution thread (hot reconfiguration) **/
+  std::shared_ptr<TensorNodeExecutor> handed_node_executor_;
+  /** Retention of the node executor at the end of life of the Execution thread (hot reconfiguration) **/
+  std::atomic<bool> retain_node_executor_;
   /** Data request mutex **/
   std::mutex data_req_mtx_;
+  /** Running scopes mutex **/
+  std::mutex scope_mtx_;
+  /** Idle waiter of the execution thread **/
+  Waiter exec_waiter_;
+  /** Completion waiter of the main thread **/
+  Waiter sync_waiter_;
 };
 
 } // namespace runtime
@@ -12,6 +12,24 @@
  *******************************************************************************/
 #include <gtest/gtest.h>
 #include "exatn.hpp"
+#include "talshxx.hpp"
+#include "small_contraction_kernels.hpp"
+#include "direct_contraction_kernels.hpp"
+#include "tensor_transpose_kernels.hpp"
+#include "contract_autotuner.hpp"
+#include "launch_sequence.hpp"
+#include "backend_selector.hpp"
+#include "tensor_body_codec.hpp"
+#include "graph_executor_lazy.hpp"
+#include "exec_trace.hpp"
+#include "tensor_op_ring.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
 
 TEST(TensorRuntimeTester, checkSimple) {
 
@@ -69,6 +87,1062 @@ TEST(TensorRuntimeTester, checkSimple) {
 }
 
 
+TEST(TensorRuntimeTester, benchSmallContractionKernels) {
+
+  using exatn::runtime::SmallContractionPattern;
+  using exatn::runtime::SmallContractionLoops;
+  using Complex = std::complex<double>;
+
+  const int bond_dim = 16, phys_dim = 2; //MPS bond and physical dimensions
+  const int num_repeats = 1000;
+
+  //Create an ExaTN tensor to initialize the TAL-SH backend:
+  bool success = exatn::createTensorSync("Z0",exatn::TensorElementType::COMPLEX64,exatn::numerics::TensorShape{2}); assert(success);
+
+  //Typical small tensor contractions of MPS algorithms:
+  const std::vector<std::pair<std::string,std::vector<std::vector<int>>>> contractions{
+   {"D(a,i,b)+=L(a,j,b)*R(i,j)",{{bond_dim,phys_dim,bond_dim},{bond_dim,phys_dim,bond_dim},{phys_dim,phys_dim}}},
+   {"D(a,i,j,b)+=L(a,i,c)*R(c,j,b)",{{bond_dim,phys_dim,phys_dim,bond_dim},{bond_dim,phys_dim,bond_dim},{bond_dim,phys_dim,bond_dim}}},
+   {"D(a,b)+=L+(c,i,a)*R(c,i,b)",{{bond_dim,bond_dim},{bond_dim,phys_dim,bond_dim},{bond_dim,phys_dim,bond_dim}}},
+   {"D(a,i,b,c)+=L(a,d,e)*R(d,i,b,c,e)",{{bond_dim,phys_dim,bond_dim,phys_dim},{bond_dim,bond_dim,phys_dim},{bond_dim,phys_dim,bond_dim,phys_dim,phys_dim}}}
+  };
+  for(const auto & contraction: contractions){
+    const auto & pattern = contraction.first;
+    std::shared_ptr<talsh::Tensor> tensors[2][3]; //generic path, small kernel
+    for(unsigned int path = 0; path < 2; ++path){
+      for(unsigned int arg = 0; arg < 3; ++arg){
+        const auto & dims = contraction.second[arg];
+        std::vector<std::size_t> signature(dims.size(),0);
+        tensors[path][arg] = std::make_shared<talsh::Tensor>(signature,dims,Complex(0.0));
+        Complex * body = nullptr;
+        success = tensors[path][arg]->getDataAccessHost(&body); assert(success);
+        for(std::size_t i = 0; i < tensors[path][arg]->getVolume(); ++i) body[i] = Complex(1.0/(i+1.0),1.0/(i+2.0));
+      }
+    }
+    //Generic TAL-SH path on Host:
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int repeat = 0; repeat < num_repeats; ++repeat){
+      talsh::TensorTask task;
+      int error_code = tensors[0][0]->contractAccumulate(&task,pattern,*(tensors[0][1]),*(tensors[0][2]),
+                                                         DEV_HOST,0,Complex(0.5,0.0),true);
+      assert(error_code == TALSH_SUCCESS);
+      success = task.wait(); assert(success);
+    }
+    const double generic_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //Small kernels (the index pattern is parsed once, as cached by the TAL-SH node executor):
+    SmallContractionPattern positions;
+    const bool supported = exatn::runtime::parse_small_contraction(pattern,positions);
+    double kernel_time = 0.0;
+    if(supported){
+      Complex * bodies[3];
+      unsigned int ranks[3];
+      const int * extents[3];
+      for(unsigned int arg = 0; arg < 3; ++arg){
+        success = tensors[1][arg]->getDataAccessHost(&(bodies[arg])); assert(success);
+        extents[arg] = tensors[1][arg]->getDimExtents(ranks[arg]);
+      }
+      start = std::chrono::high_resolution_clock::now();
+      for(int repeat = 0; repeat < num_repeats; ++repeat){
+        SmallContractionLoops loops;
+        success = exatn::runtime::setup_small_contraction(positions,ranks,extents,loops); assert(success);
+        success = exatn::runtime::small_contraction(loops,bodies[0],bodies[1],bodies[2],Complex(0.5,0.0),true,
+                                                    positions.conj[0],positions.conj[1]); assert(success);
+      }
+      kernel_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+      //Compare the results:
+      Complex * generic_body = nullptr;
+      success = tensors[0][0]->getDataAccessHost(&generic_body); assert(success);
+      double max_diff = 0.0, max_abs = 0.0;
+      for(std::size_t i = 0; i < tensors[1][0]->getVolume(); ++i){
+        max_diff = std::max(max_diff,std::abs(generic_body[i] - bodies[0][i]));
+        max_abs = std::max(max_abs,std::abs(generic_body[i]));
+      }
+      EXPECT_LE(max_diff,1e-12 * std::max(max_abs,1.0));
+    }
+    std::cout << "Small tensor contraction " << pattern << ": Generic path " << generic_time / num_repeats
+              << " s, small kernel ";
+    if(supported){
+      std::cout << kernel_time / num_repeats << " s (speedup " << generic_time / kernel_time << ")" << std::endl;
+    }else{
+      std::cout << "not applicable" << std::endl;
+    }
+  }
+
+  success = exatn::destroyTensorSync("Z0"); assert(success);
+}
+
+
+TEST(TensorRuntimeTester, benchDirectContractionKernels) {
+
+  using exatn::runtime::DirectContractionPattern;
+  using exatn::runtime::DirectContractionPlan;
+  using Complex = std::complex<double>;
+
+  const int num_repeats = 10;
+
+  //Create an ExaTN tensor to initialize the TAL-SH backend:
+  bool success = exatn::createTensorSync("Z0",exatn::TensorElementType::COMPLEX64,exatn::numerics::TensorShape{2}); assert(success);
+
+  //Bandwidth-bound tensor contractions (small contracted or uncontracted dimensions):
+  const std::vector<std::pair<std::string,std::vector<std::vector<int>>>> contractions{
+   {"D(a,i,b)+=L(a,j,b)*R(i,j)",{{128,2,128},{128,2,128},{2,2}}},
+   {"D(a,b,c,d)+=L(d,k,a)*R(k,c,b)",{{32,32,16,16},{16,4,32},{4,16,32}}},
+   {"D(a,b)+=L+(c,a,d)*R(b,d,c)",{{64,64},{32,64,32},{64,32,32}}},
+   {"D(a,b,c)+=L(c,a)*R(b)",{{64,16,64},{64,64},{16}}}
+  };
+  for(const auto & contraction: contractions){
+    const auto & pattern = contraction.first;
+    std::shared_ptr<talsh::Tensor> tensors[2][3]; //generic path, direct kernel
+    for(unsigned int path = 0; path < 2; ++path){
+      for(unsigned int arg = 0; arg < 3; ++arg){
+        const auto & dims = contraction.second[arg];
+        std::vector<std::size_t> signature(dims.size(),0);
+        tensors[path][arg] = std::make_shared<talsh::Tensor>(signature,dims,Complex(0.0));
+        Complex * body = nullptr;
+        success = tensors[path][arg]->getDataAccessHost(&body); assert(success);
+        for(std::size_t i = 0; i < tensors[path][arg]->getVolume(); ++i) body[i] = Complex(1.0/(i+1.0),1.0/(i+2.0));
+      }
+    }
+    //Generic TAL-SH path on Host (TTGT):
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int repeat = 0; repeat < num_repeats; ++repeat){
+      talsh::TensorTask task;
+      int error_code = tensors[0][0]->contractAccumulate(&task,pattern,*(tensors[0][1]),*(tensors[0][2]),
+                                                         DEV_HOST,0,Complex(0.5,0.0),true);
+      assert(error_code == TALSH_SUCCESS);
+      success = task.wait(); assert(success);
+    }
+    const double generic_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //Direct kernels (the index pattern is parsed once, as cached by the TAL-SH node executor):
+    DirectContractionPattern positions;
+    success = exatn::runtime::parse_direct_contraction(pattern,positions); assert(success);
+    Complex * bodies[3];
+    unsigned int ranks[3];
+    const int * extents[3];
+    for(unsigned int arg = 0; arg < 3; ++arg){
+      success = tensors[1][arg]->getDataAccessHost(&(bodies[arg])); assert(success);
+      extents[arg] = tensors[1][arg]->getDimExtents(ranks[arg]);
+    }
+    start = std::chrono::high_resolution_clock::now();
+    for(int repeat = 0; repeat < num_repeats; ++repeat){
+      DirectContractionPlan plan;
+      success = exatn::runtime::setup_direct_contraction(positions,ranks,extents,plan); assert(success);
+      exatn::runtime::direct_contraction(plan,bodies[0],bodies[1],bodies[2],Complex(0.5,0.0),true,
+                                         positions.conj[0],positions.conj[1]);
+    }
+    const double kernel_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //Compare the results:
+    Complex * generic_body = nullptr;
+    success = tensors[0][0]->getDataAccessHost(&generic_body); assert(success);
+    double max_diff = 0.0, max_abs = 0.0;
+    for(std::size_t i = 0; i < tensors[1][0]->getVolume(); ++i){
+      max_diff = std::max(max_diff,std::abs(generic_body[i] - bodies[0][i]));
+      max_abs = std::max(max_abs,std::abs(generic_body[i]));
+    }
+    EXPECT_LE(max_diff,1e-12 * std::max(max_abs,1.0));
+    std::cout << "Direct tensor contraction " << pattern << ": Generic path " << generic_time / num_repeats
+              << " s, direct kernel " << kernel_time / num_repeats << " s (speedup "
+              << generic_time / kernel_time << ")" << std::endl;
+  }
+
+  success = exatn::destroyTensorSync("Z0"); assert(success);
+}
+
+
+TEST(TensorRuntimeTester, benchTensorTransposeKernels) {
+
+  using exatn::runtime::TensorTransposePattern;
+  using exatn::runtime::TensorTransposePlan;
+  using Complex = std::complex<double>;
+
+  const int num_repeats = 10;
+
+  //Create an ExaTN tensor to initialize the TAL-SH backend:
+  bool success = exatn::createTensorSync("Z0",exatn::TensorElementType::COMPLEX64,exatn::numerics::TensorShape{2}); assert(success);
+
+  //Tensor permutations (the extents are given for the source tensor):
+  const std::vector<std::pair<std::string,std::vector<int>>> transposes{
+   {"D(a,b)=S(b,a)",{512,512}},
+   {"D(a,b,c,d)=S(d,b,a,c)",{64,8,64,8}},
+   {"D(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s,t)=S(t,s,r,q,a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p)",std::vector<int>(20,2)}
+  };
+  for(const auto & transpose: transposes){
+    const auto & pattern = transpose.first;
+    TensorTransposePattern positions;
+    success = exatn::runtime::parse_tensor_transpose(pattern,positions); assert(success);
+    const auto & src_dims = transpose.second;
+    std::vector<int> dest_dims(src_dims.size());
+    for(std::size_t i = 0; i < dest_dims.size(); ++i) dest_dims[i] = src_dims[positions.permutation[i]];
+    std::vector<std::size_t> signature(src_dims.size(),0);
+    talsh::Tensor src(signature,src_dims,Complex(0.0));
+    talsh::Tensor dest0(signature,dest_dims,Complex(0.0)), dest1(signature,dest_dims,Complex(0.0));
+    Complex * src_body = nullptr;
+    success = src.getDataAccessHost(&src_body); assert(success);
+    for(std::size_t i = 0; i < src.getVolume(); ++i) src_body[i] = Complex(1.0/(i+1.0),1.0/(i+2.0));
+    //Generic TAL-SH path on Host:
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int repeat = 0; repeat < num_repeats; ++repeat){
+      talsh::TensorTask task;
+      int error_code = dest0.copyBody(&task,pattern,src,DEV_HOST,0);
+      assert(error_code == TALSH_SUCCESS);
+      success = task.wait(); assert(success);
+    }
+    const double generic_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //Transpose kernels with a cached plan (as cached by the TAL-SH node executor):
+    unsigned int rank = 0;
+    const int * extents = src.getDimExtents(rank);
+    TensorTransposePlan plan;
+    success = exatn::runtime::setup_tensor_transpose(positions,rank,extents,plan); assert(success);
+    Complex * dest_body = nullptr;
+    success = dest1.getDataAccessHost(&dest_body); assert(success);
+    start = std::chrono::high_resolution_clock::now();
+    for(int repeat = 0; repeat < num_repeats; ++repeat){
+      exatn::runtime::tensor_transpose(plan,dest_body,static_cast<const Complex*>(src_body),Complex(1.0,0.0),false);
+    }
+    const double kernel_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //Compare the results:
+    Complex * generic_body = nullptr;
+    success = dest0.getDataAccessHost(&generic_body); assert(success);
+    double max_diff = 0.0;
+    for(std::size_t i = 0; i < dest1.getVolume(); ++i) max_diff = std::max(max_diff,std::abs(generic_body[i] - dest_body[i]));
+    EXPECT_EQ(max_diff,0.0);
+    std::cout << "Tensor transpose " << pattern << ": Generic path " << generic_time / num_repeats
+              << " s, transpose kernel " << kernel_time / num_repeats << " s (speedup "
+              << generic_time / kernel_time << ")" << std::endl;
+  }
+
+  success = exatn::destroyTensorSync("Z0"); assert(success);
+}
+
+
+TEST(TensorRuntimeTester, checkContractAutotuner) {
+  using exatn::runtime::ContractAutotuner;
+  const std::string database("exatn_autotune_test.txt");
+  std::remove(database.c_str());
+  const std::vector<std::string> strategies{"direct","ttgt","layout"};
+  const std::string key("D(a,b)+=L(a,c)*R(c,b)|8,8|8,8|8,8|R8|0");
+  {
+    ContractAutotuner autotuner;
+    autotuner.activate(database,strategies,2);
+    bool trial = true;
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),ContractAutotuner::DEFAULT_STRATEGY); //seen once
+    EXPECT_FALSE(trial);
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),0);
+    EXPECT_TRUE(trial);
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),ContractAutotuner::DEFAULT_STRATEGY); //trial in flight
+    autotuner.reject(key,0);
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),1);
+    autotuner.record(key,1,2.0);
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),2);
+    autotuner.record(key,2,1.0);
+    EXPECT_EQ(autotuner.getSelected(key),2);
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),2);
+    EXPECT_FALSE(trial);
+  }
+  {
+    ContractAutotuner autotuner; //tuned strategies are loaded from the database
+    autotuner.activate(database,strategies,2);
+    EXPECT_EQ(autotuner.getNumTuned(),1);
+    bool trial = true;
+    EXPECT_EQ(autotuner.select(key,{0,1,2},&trial),2);
+    EXPECT_FALSE(trial);
+    EXPECT_EQ(autotuner.select(key,{0,1},&trial),ContractAutotuner::DEFAULT_STRATEGY); //not available
+  }
+  std::remove(database.c_str());
+}
+
+
+TEST(TensorRuntimeTester, checkLaunchSequence) {
+  using exatn::runtime::LaunchSequence;
+  LaunchSequence sequence;
+  sequence.activate(true);
+  LaunchSequence::Launch launch;
+  for(int occurrence = 0; occurrence < 3; ++occurrence){ //the third occurrence replays the second one
+    for(std::size_t signature = 1; signature <= 3; ++signature){
+      const bool replayed = sequence.next(signature,&launch);
+      EXPECT_EQ(replayed,(occurrence == 2));
+      if(replayed){
+        EXPECT_EQ(launch.device,static_cast<int>(signature) + 10);
+      }
+      sequence.record(signature,static_cast<int>(signature) + 10 * occurrence);
+    }
+    sequence.commit();
+  }
+  EXPECT_EQ(sequence.getNumReplayed(),3);
+  EXPECT_TRUE(sequence.next(1,&launch)); //still recurring
+  sequence.record(1,launch.device);
+  EXPECT_FALSE(sequence.next(7,&launch)); //deviation stops the replay
+  sequence.record(7,0);
+  EXPECT_FALSE(sequence.next(3,&launch));
+  sequence.record(3,0);
+  sequence.commit();
+  EXPECT_FALSE(sequence.next(1,&launch)); //no longer recurring
+}
+
+
+TEST(TensorRuntimeTester, checkBackendSelector) {
+  using exatn::runtime::BackendSelector;
+  BackendSelector selector;
+  const BackendSelector::Resources resources{1e9,4e9,1};
+  const BackendSelector::NetworkCost small{1e6,1e3,1e3};
+  const BackendSelector::NetworkCost large{1e13,1e8,1e6};
+  const BackendSelector::NetworkCost huge_io{1e13,1e8,1e10};
+  bool trial = false;
+  //Selection by the estimates:
+  EXPECT_EQ(selector.select("large",large,resources,&trial),BackendSelector::CUQUANTUM_BACKEND);
+  EXPECT_FALSE(trial);
+  EXPECT_EQ(selector.select("huge_io",huge_io,resources,&trial),BackendSelector::DEFAULT_BACKEND); //does not fit into the GPU
+  EXPECT_EQ(selector.estimate(BackendSelector::CUQUANTUM_BACKEND,huge_io,resources),std::numeric_limits<double>::infinity());
+  EXPECT_EQ(selector.select("large",large,BackendSelector::Resources{1e9,4e9,0},&trial),BackendSelector::DEFAULT_BACKEND); //no GPU
+  //Trial of the other backend once the key recurs:
+  EXPECT_EQ(selector.select("small",small,resources,&trial),BackendSelector::DEFAULT_BACKEND);
+  selector.record("small",BackendSelector::DEFAULT_BACKEND,small,resources,1e-2);
+  EXPECT_EQ(selector.select("small",small,resources,&trial),BackendSelector::CUQUANTUM_BACKEND);
+  EXPECT_TRUE(trial);
+  selector.record("small",BackendSelector::CUQUANTUM_BACKEND,small,resources,5e-3);
+  //Selection by the measured times:
+  EXPECT_EQ(selector.select("small",small,resources,&trial),BackendSelector::CUQUANTUM_BACKEND);
+  EXPECT_FALSE(trial);
+  selector.record("small",BackendSelector::DEFAULT_BACKEND,small,resources,1e-3);
+  EXPECT_EQ(selector.select("small",small,resources,&trial),BackendSelector::DEFAULT_BACKEND);
+  EXPECT_EQ(selector.getNumTrials(),1);
+  EXPECT_EQ(selector.getNumSelected(BackendSelector::CUQUANTUM_BACKEND),3);
+  EXPECT_EQ(selector.getNumSelected(BackendSelector::DEFAULT_BACKEND),4);
+}
+
+
+TEST(TensorRuntimeTester, checkTensorBodyCodec) {
+  using exatn::runtime::compress_tensor_body;
+  using exatn::runtime::decompress_tensor_body;
+  std::vector<unsigned char> packed;
+  //Lossless: Sparse double-precision tensor body:
+  std::vector<double> sparse(65536,0.0);
+  for(std::size_t i = 0; i < sparse.size(); i += 7) sparse[i] = 1.0 / static_cast<double>(i + 1);
+  compress_tensor_body(sparse.data(),sparse.size()*sizeof(double),sizeof(double),1,0.0,packed);
+  EXPECT_LT(packed.size(),sparse.size()*sizeof(double));
+  std::vector<double> restored(sparse.size());
+  EXPECT_TRUE(decompress_tensor_body(packed,restored.data(),restored.size()*sizeof(double)));
+  EXPECT_EQ(restored,sparse);
+  EXPECT_FALSE(decompress_tensor_body(packed,restored.data(),(restored.size()-1)*sizeof(double))); //size mismatch
+  //Error-bounded lossy: Smooth single-precision complex tensor body:
+  const double tolerance = 1e-4;
+  std::vector<std::complex<float>> smooth(32768);
+  for(std::size_t i = 0; i < smooth.size(); ++i)
+    smooth[i] = std::complex<float>(std::sin(1e-3f*i),std::cos(1e-3f*i));
+  compress_tensor_body(smooth.data(),smooth.size()*sizeof(std::complex<float>),sizeof(float),2,tolerance,packed);
+  EXPECT_LT(packed.size(),smooth.size()*sizeof(std::complex<float>)/3);
+  std::vector<std::complex<float>> approx(smooth.size());
+  EXPECT_TRUE(decompress_tensor_body(packed,approx.data(),approx.size()*sizeof(std::complex<float>)));
+  double max_error = 0.0;
+  for(std::size_t i = 0; i < smooth.size(); ++i){
+    max_error = std::max(max_error,static_cast<double>(std::abs(smooth[i].real() - approx[i].real())));
+    max_error = std::max(max_error,static_cast<double>(std::abs(smooth[i].imag() - approx[i].imag())));
+  }
+  EXPECT_LE(max_error,tolerance * 1.01);
+  //Non-finite words fall back to the lossless mode:
+  std::vector<float> special{1.0f,std::numeric_limits<float>::infinity(),-2.5f,0.0f};
+  compress_tensor_body(special.data(),special.size()*sizeof(float),sizeof(float),1,tolerance,packed);
+  std::vector<float> exact(special.size());
+  EXPECT_TRUE(decompress_tensor_body(packed,exact.data(),exact.size()*sizeof(float)));
+  EXPECT_EQ(exact,special);
+}
+
+
+TEST(TensorRuntimeTester, checkTensorOpFusion) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  auto optimizer = exatn::getService<exatn::runtime::TensorGraphOptimizer>("tensor-op-fusion");
+  auto rewriter = optimizer->getRewriter();
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{4,4});
+  auto tens_c = std::make_shared<Tensor>("C",TensorShape{4,4});
+  auto tens_d = std::make_shared<Tensor>("D",TensorShape{4,4});
+  //D = 0; D += A * A; C += A; C += A:
+  std::shared_ptr<TensorOperation> zero_init = factory->createTensorOp(TensorOpCode::TRANSFORM);
+  zero_init->setTensorOperand(tens_d);
+  std::dynamic_pointer_cast<exatn::numerics::TensorOpTransform>(zero_init)->resetFunctor(
+    std::shared_ptr<exatn::TensorMethod>(new exatn::numerics::FunctorInitVal(0.0)));
+  std::shared_ptr<TensorOperation> contraction = factory->createTensorOp(TensorOpCode::CONTRACT);
+  contraction->setTensorOperand(tens_d);
+  contraction->setTensorOperand(tens_a);
+  contraction->setTensorOperand(tens_a);
+  contraction->setIndexPattern("D(a,b)+=A(a,c)*A(c,b)");
+  std::vector<std::shared_ptr<TensorOperation>> submitted{zero_init,contraction};
+  for(int i = 0; i < 2; ++i){
+    std::shared_ptr<TensorOperation> addition = factory->createTensorOp(TensorOpCode::ADD);
+    addition->setTensorOperand(tens_c);
+    addition->setTensorOperand(tens_a);
+    addition->setScalar(0,std::complex<double>{1.0,0.0});
+    addition->setIndexPattern("C(a,b)+=A(a,b)");
+    submitted.emplace_back(addition);
+  }
+  for(std::size_t i = 0; i < submitted.size(); ++i) submitted[i]->setId(i);
+  //Rewriting the same submitted tensor operations twice (resubmission) gives the same result:
+  for(int pass = 0; pass < 2; ++pass){
+    auto batch = submitted;
+    std::vector<bool> elided(batch.size(),false);
+    EXPECT_EQ(rewriter(batch,elided),2);
+    EXPECT_TRUE(elided[0]); EXPECT_FALSE(elided[1]); EXPECT_FALSE(elided[2]); EXPECT_TRUE(elided[3]);
+    //The rewritten tensor operations are clones:
+    EXPECT_NE(batch[1],submitted[1]);
+    EXPECT_EQ(batch[1]->getId(),submitted[1]->getId());
+    EXPECT_FALSE(std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(batch[1])->isAccumulative());
+    EXPECT_NE(batch[2],submitted[2]);
+    EXPECT_EQ(batch[2]->getScalar(0),(std::complex<double>{2.0,0.0}));
+    //The submitted tensor operations are intact:
+    auto submitted_contraction = std::dynamic_pointer_cast<exatn::numerics::TensorOpContract>(submitted[1]);
+    EXPECT_TRUE(submitted_contraction->isAccumulative());
+    EXPECT_EQ(submitted_contraction->getBeta(),(std::complex<double>{1.0,0.0}));
+    EXPECT_EQ(submitted[2]->getScalar(0),(std::complex<double>{1.0,0.0}));
+  }
+}
+
+
+TEST(TensorRuntimeTester, checkDependencyFreeNodeOrder) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::VertexIdType;
+  auto dag = exatn::getService<exatn::runtime::TensorGraph>("boost-digraph");
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{4,4});
+  auto tens_c = std::make_shared<Tensor>("C",TensorShape{4,4});
+  auto tens_d = std::make_shared<Tensor>("D",TensorShape{4,4});
+  auto tens_e = std::make_shared<Tensor>("E",TensorShape{4,4});
+  //Nodes 0 and 1: Commutative accumulations into D; nodes 2 and 3: Additions into C and E:
+  for(int i = 0; i < 2; ++i){
+    std::shared_ptr<TensorOperation> op = factory->createTensorOp(TensorOpCode::CONTRACT);
+    op->setTensorOperand(tens_d);
+    op->setTensorOperand(tens_a);
+    op->setTensorOperand(tens_a);
+    op->setIndexPattern("D(a,b)+=A(a,c)*A(c,b)");
+    op->setCommutativeAccumulation(true);
+    EXPECT_EQ(dag->addOperation(op),i);
+  }
+  for(auto tens: {tens_c,tens_e}){
+    std::shared_ptr<TensorOperation> op = factory->createTensorOp(TensorOpCode::ADD);
+    op->setTensorOperand(tens);
+    op->setTensorOperand(tens_a);
+    op->setIndexPattern(tens->getName() + "(a,b)+=A(a,b)");
+    dag->addOperation(op);
+  }
+  for(VertexIdType node = 0; node < 4; ++node) EXPECT_TRUE(dag->registerDependencyFreeNode(node));
+  VertexIdType node = 0;
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(node,0);
+  //Node 1 is blocked by the accumulation lock of node 0, node 2 is not admissible:
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node,[](VertexIdType node){return node != 2;}));
+  EXPECT_EQ(node,3);
+  //Node 0 returns (releasing its accumulation lock), the skipped nodes 1 and 2 kept their positions:
+  EXPECT_TRUE(dag->registerDependencyFreeNode(0));
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(node,1);
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(node,2);
+  //Node 0 is now blocked by the accumulation lock of node 1:
+  EXPECT_FALSE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(dag->getNumDependencyFreeNodes(),1);
+}
+
+
+TEST(TensorRuntimeTester, checkPriorityActivation) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::VertexIdType;
+  auto dag = exatn::getService<exatn::runtime::TensorGraph>("boost-digraph");
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{16,16});
+  auto tens_c = std::make_shared<Tensor>("C",TensorShape{16,16});
+  auto tens_d = std::make_shared<Tensor>("D",TensorShape{16,16});
+  auto tens_e = std::make_shared<Tensor>("E",TensorShape{16,16});
+  //Node 0: Cheap addition into C; nodes 1 -> 2: Chain of contractions D += A * A, E += D * D:
+  std::shared_ptr<TensorOperation> addition = factory->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(tens_c);
+  addition->setTensorOperand(tens_a);
+  addition->setIndexPattern("C(a,b)+=A(a,b)");
+  EXPECT_EQ(dag->addOperation(addition),0);
+  std::shared_ptr<TensorOperation> contraction = factory->createTensorOp(TensorOpCode::CONTRACT);
+  contraction->setTensorOperand(tens_d);
+  contraction->setTensorOperand(tens_a);
+  contraction->setTensorOperand(tens_a);
+  contraction->setIndexPattern("D(a,b)+=A(a,c)*A(c,b)");
+  EXPECT_EQ(dag->addOperation(contraction),1);
+  contraction = factory->createTensorOp(TensorOpCode::CONTRACT);
+  contraction->setTensorOperand(tens_e);
+  contraction->setTensorOperand(tens_d);
+  contraction->setTensorOperand(tens_d);
+  contraction->setIndexPattern("E(a,b)+=D(a,c)*D(c,b)");
+  EXPECT_EQ(dag->addOperation(contraction),2);
+  EXPECT_TRUE(dag->registerDependencyFreeNode(0));
+  EXPECT_TRUE(dag->registerDependencyFreeNode(1));
+  //The DAG nodes appended before the activation obtain their priorities:
+  dag->activatePriorities(true);
+  EXPECT_GT(dag->getNodeProperties(2).getPriority(),0.0);
+  EXPECT_GT(dag->getNodeProperties(1).getPriority(),dag->getNodeProperties(2).getPriority());
+  EXPECT_GT(dag->getNodeProperties(1).getPriority(),dag->getNodeProperties(0).getPriority());
+  //The head of the critical path is extracted first:
+  VertexIdType node = 0;
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(node,1);
+  EXPECT_TRUE(dag->extractDependencyFreeNode(&node));
+  EXPECT_EQ(node,0);
+}
+
+
+TEST(TensorRuntimeTester, checkCSRGraph) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::VertexIdType;
+  auto dag = exatn::getService<exatn::runtime::TensorGraph>("csr-digraph");
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{16,16});
+  auto tens_c = std::make_shared<Tensor>("C",TensorShape{16,16});
+  auto tens_d = std::make_shared<Tensor>("D",TensorShape{16,16});
+  //Node 0: C += A; Node 1: D += C (Read-after-Write); Node 2: C += A (Write-after-Read and Write-after-Write):
+  std::shared_ptr<TensorOperation> addition = factory->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(tens_c);
+  addition->setTensorOperand(tens_a);
+  addition->setIndexPattern("C(a,b)+=A(a,b)");
+  EXPECT_EQ(dag->addOperation(addition),0);
+  addition = factory->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(tens_d);
+  addition->setTensorOperand(tens_c);
+  addition->setIndexPattern("D(a,b)+=C(a,b)");
+  EXPECT_EQ(dag->addOperation(addition),1);
+  addition = factory->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(tens_c);
+  addition->setTensorOperand(tens_a);
+  addition->setIndexPattern("C(a,b)+=A(a,b)");
+  EXPECT_EQ(dag->addOperation(addition),2);
+  EXPECT_EQ(dag->getNumNodes(),3);
+  EXPECT_EQ(dag->getNumDependencies(),3);
+  EXPECT_TRUE(dag->dependencyExists(1,0));
+  EXPECT_FALSE(dag->dependencyExists(0,1));
+  EXPECT_TRUE(dag->dependencyExists(2,0));
+  EXPECT_TRUE(dag->dependencyExists(2,1));
+  EXPECT_EQ(dag->getNodeDegree(0),0);
+  EXPECT_EQ(dag->getNodeDegree(2),2);
+  //The allocation-free neighbor traversal visits the same dependencies:
+  std::vector<VertexIdType> neighbors;
+  dag->visitNeighbors(2,[&neighbors](VertexIdType dep){neighbors.emplace_back(dep);});
+  EXPECT_EQ(neighbors,dag->getNeighborList(2));
+  EXPECT_EQ(neighbors.size(),2);
+  //Dependencies get resolved upon execution:
+  EXPECT_TRUE(dag->nodeDependenciesResolved(0));
+  EXPECT_FALSE(dag->nodeDependenciesResolved(1));
+  dag->setNodeExecuting(0);
+  dag->setNodeExecuted(0);
+  EXPECT_TRUE(dag->nodeExecuted(0));
+  EXPECT_TRUE(dag->nodeDependenciesResolved(1));
+  EXPECT_FALSE(dag->nodeDependenciesResolved(2));
+  dag->setNodeExecuting(1);
+  dag->setNodeExecuted(1);
+  EXPECT_TRUE(dag->nodeDependenciesResolved(2));
+  EXPECT_FALSE(dag->getNodeProperties(2).isDummy());
+}
+
+
+TEST(TensorRuntimeTester, checkCSRGraphRetirement) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOpPriority;
+  using exatn::TensorOperation;
+  using exatn::runtime::VertexIdType;
+  const VertexIdType NUM_NODES = 4096; //well beyond the retirement threshold (2 * CSRGraph::RECLAIM_CHUNK)
+  auto dag = exatn::getService<exatn::runtime::TensorGraph>("csr-digraph");
+  EXPECT_TRUE(dag->reclaimsExecutedNodes());
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{16,16});
+  auto tens_t = std::make_shared<Tensor>("T",TensorShape{16,16});
+  auto append = [&](){
+    std::shared_ptr<TensorOperation> addition = factory->createTensorOp(TensorOpCode::ADD);
+    addition->setTensorOperand(tens_t);
+    addition->setTensorOperand(tens_a);
+    addition->setIndexPattern("T(a,b)+=A(a,b)");
+    return dag->addOperation(addition);
+  };
+  //A chain of DAG nodes: Each one depends on the previous one (Write-after-Write):
+  for(VertexIdType i = 0; i < NUM_NODES; ++i) EXPECT_EQ(append(),i);
+  EXPECT_EQ(dag->getNumDependencies(),NUM_NODES-1);
+  //Execute the chain in order, progressing the DAG front node (retires executed DAG nodes):
+  for(VertexIdType node = 0; node < NUM_NODES; ++node){
+    EXPECT_TRUE(dag->nodeDependenciesResolved(node));
+    dag->setNodeExecuting(node);
+    dag->setNodeExecuted(node);
+    EXPECT_TRUE(dag->progressFrontNode(node));
+  }
+  EXPECT_EQ(dag->getFrontNode(),NUM_NODES);
+  //DAG node ids stay stable, retired DAG nodes are reported as executed:
+  EXPECT_EQ(dag->getNumNodes(),NUM_NODES);
+  EXPECT_EQ(dag->getNumDependencies(),NUM_NODES-1);
+  EXPECT_TRUE(dag->getNodeProperties(0).isDummy());
+  EXPECT_TRUE(dag->nodeExecuted(0));
+  EXPECT_FALSE(dag->nodeIdle(0));
+  EXPECT_FALSE(dag->dependencyExists(1,0));
+  EXPECT_EQ(dag->getNodeDegree(1),0);
+  EXPECT_FALSE(dag->getNodeProperties(NUM_NODES-1).isDummy());
+  EXPECT_TRUE(dag->dependencyExists(NUM_NODES-1,NUM_NODES-2));
+  //The sentinel shared by the retired DAG nodes is read-only:
+  auto & retired = dag->getNodeProperties(1);
+  EXPECT_FALSE(retired.boostLatencyClass(static_cast<int>(TensorOpPriority::URGENT)));
+  retired.setPriority(1.0);
+  EXPECT_EQ(dag->getNodeProperties(0).getPriority(),0.0);
+  EXPECT_EQ(dag->boostNode(0),0);
+  //Compaction: The dependencies of the first resident DAG node on retired ones are dropped:
+  VertexIdType first_resident = 0;
+  while(dag->getNodeProperties(first_resident).isDummy()) ++first_resident;
+  EXPECT_GT(first_resident,0);
+  EXPECT_LT(first_resident,NUM_NODES);
+  EXPECT_TRUE(dag->getNeighborList(first_resident).empty());
+  EXPECT_EQ(dag->getNeighborList(first_resident+1),std::vector<VertexIdType>{first_resident});
+  //Appending continues with stable ids and dependencies on resident DAG nodes:
+  EXPECT_EQ(append(),NUM_NODES);
+  EXPECT_TRUE(dag->dependencyExists(NUM_NODES,NUM_NODES-1));
+  EXPECT_TRUE(dag->nodeIdle(NUM_NODES));
+  EXPECT_TRUE(dag->nodeDependenciesResolved(NUM_NODES));
+}
+
+
+TEST(TensorRuntimeTester, checkTensorOpRingFull) {
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::TensorOpRing;
+  auto factory = exatn::TensorOpFactory::get();
+  TensorOpRing ring(4);
+  std::vector<std::shared_ptr<TensorOperation>> ops;
+  for(int i = 0; i < 6; ++i) ops.emplace_back(factory->createTensorOp(TensorOpCode::ADD));
+  std::size_t ticket = 0;
+  for(std::size_t i = 0; i < 4; ++i){
+    EXPECT_TRUE(ring.push(ops[i],&ticket));
+    EXPECT_EQ(ticket,i);
+  }
+  //The full ring rejects both single and batched staging without issuing tickets:
+  EXPECT_FALSE(ring.push(ops[4],&ticket));
+  EXPECT_FALSE(ring.pushBatch({ops[4]},&ticket,[](std::size_t){return;}));
+  EXPECT_EQ(ring.getNumIssued(),4);
+  //A single extraction frees a single slot, whereas a batch needs all its slots free:
+  std::shared_ptr<TensorOperation> op;
+  EXPECT_TRUE(ring.pop(&op));
+  EXPECT_EQ(op,ops[0]);
+  EXPECT_FALSE(ring.pushBatch({ops[4],ops[5]},&ticket,[](std::size_t){return;}));
+  EXPECT_TRUE(ring.pop(&op));
+  EXPECT_EQ(op,ops[1]);
+  EXPECT_TRUE(ring.pushBatch({ops[4],ops[5]},&ticket,[](std::size_t){return;}));
+  EXPECT_EQ(ticket,4);
+  EXPECT_FALSE(ring.push(ops[0],&ticket));
+  //A batch exceeding the ring capacity is never accepted:
+  for(std::size_t i = 2; i < 6; ++i){
+    EXPECT_TRUE(ring.pop(&op));
+    EXPECT_EQ(op,ops[i]);
+  }
+  EXPECT_TRUE(ring.isEmpty());
+  EXPECT_FALSE(ring.pop(&op));
+  EXPECT_FALSE(ring.pushBatch({ops[0],ops[1],ops[2],ops[3],ops[4]},&ticket,[](std::size_t){return;}));
+  EXPECT_EQ(ring.getNumIssued(),6);
+  EXPECT_EQ(ring.getNumExtracted(),6);
+}
+
+
+TEST(TensorRuntimeTester, checkTensorOpRingWrapAround) {
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::TensorOpRing;
+  auto factory = exatn::TensorOpFactory::get();
+  TensorOpRing ring(8);
+  std::size_t next_ticket = 0, next_extracted = 0;
+  std::shared_ptr<TensorOperation> op;
+  //Staged tensor operations wrap around the ring many times (singles and batches straddling the ring end):
+  for(int round = 0; round < 100; ++round){
+    const std::size_t num_ops = 1 + (round % 7);
+    std::vector<std::shared_ptr<TensorOperation>> ops;
+    for(std::size_t i = 0; i < num_ops; ++i) ops.emplace_back(factory->createTensorOp(TensorOpCode::ADD));
+    std::size_t ticket = 0;
+    if(round % 2 == 0){
+      for(const auto & staged: ops){
+        EXPECT_TRUE(ring.push(staged,&ticket,[&staged](std::size_t pos){staged->setId(pos);}));
+        EXPECT_EQ(ticket,next_ticket++);
+      }
+    }else{
+      const std::size_t first_ticket = next_ticket;
+      EXPECT_TRUE(ring.pushBatch(ops,&ticket,[&ops,first_ticket](std::size_t pos){ops[pos-first_ticket]->setId(pos);}));
+      EXPECT_EQ(ticket,first_ticket);
+      next_ticket += num_ops;
+    }
+    for(const auto & staged: ops){
+      EXPECT_TRUE(ring.pop(&op));
+      EXPECT_EQ(op,staged);
+      EXPECT_EQ(op->getId(),next_extracted++);
+    }
+    EXPECT_TRUE(ring.isEmpty());
+  }
+  EXPECT_EQ(ring.getNumIssued(),next_ticket);
+  EXPECT_GT(next_ticket,10 * ring.getCapacity());
+}
+
+
+TEST(TensorRuntimeTester, checkTensorOpRingMultiProducer) {
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::TensorOpRing;
+  const int NUM_PRODUCERS = 4;
+  const std::size_t NUM_OPS = 20000; //per producer
+  const std::size_t BATCH_SIZE = 3;
+  auto factory = exatn::TensorOpFactory::get();
+  TensorOpRing ring(64); //small ring: Producers keep hitting the full ring
+  std::vector<std::vector<std::shared_ptr<TensorOperation>>> ops(NUM_PRODUCERS);
+  std::unordered_map<const TensorOperation*,std::pair<int,std::size_t>> origin; //op --> {producer,position}
+  for(int p = 0; p < NUM_PRODUCERS; ++p){
+    for(std::size_t i = 0; i < NUM_OPS; ++i){
+      ops[p].emplace_back(factory->createTensorOp(TensorOpCode::ADD));
+      origin[ops[p].back().get()] = std::make_pair(p,i);
+    }
+  }
+  //Odd producers stage batches, even producers stage single tensor operations:
+  auto producer = [&ring,&ops,BATCH_SIZE,NUM_OPS](int p){
+    std::size_t ticket = 0;
+    for(std::size_t i = 0; i < NUM_OPS;){
+      if(p % 2 != 0 && i + BATCH_SIZE <= NUM_OPS){
+        std::vector<std::shared_ptr<TensorOperation>> batch(ops[p].begin()+i,ops[p].begin()+i+BATCH_SIZE);
+        std::size_t k = 0;
+        if(ring.pushBatch(batch,&ticket,[&batch,&k](std::size_t pos){batch[k++]->setId(pos);})){
+          i += BATCH_SIZE;
+        }else{
+          std::this_thread::yield();
+        }
+      }else{
+        const auto & staged = ops[p][i];
+        if(ring.push(staged,&ticket,[&staged](std::size_t pos){staged->setId(pos);})){
+          ++i;
+        }else{
+          std::this_thread::yield();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> producers;
+  for(int p = 0; p < NUM_PRODUCERS; ++p) producers.emplace_back(producer,p);
+  //The single consumer extracts every tensor operation exactly once, in the ticket order
+  //as well as in the per-producer staging order:
+  std::vector<std::size_t> next(NUM_PRODUCERS,0);
+  std::size_t num_extracted = 0;
+  std::shared_ptr<TensorOperation> op;
+  while(num_extracted < NUM_PRODUCERS * NUM_OPS){
+    if(ring.pop(&op)){
+      EXPECT_EQ(op->getId(),num_extracted);
+      const auto & src = origin.at(op.get());
+      EXPECT_EQ(src.second,next[src.first]);
+      next[src.first] = src.second + 1;
+      ++num_extracted;
+    }else{
+      std::this_thread::yield();
+    }
+  }
+  for(auto & thread: producers) thread.join();
+  for(int p = 0; p < NUM_PRODUCERS; ++p) EXPECT_EQ(next[p],NUM_OPS);
+  EXPECT_TRUE(ring.isEmpty());
+  EXPECT_EQ(ring.getNumIssued(),NUM_PRODUCERS * NUM_OPS);
+}
+
+
+TEST(TensorRuntimeTester, checkTensorNetworkQueue) {
+  using exatn::TensorNetwork;
+  using exatn::MPICommProxy;
+  using exatn::runtime::TensorOpExecHandle;
+  using exatn::runtime::TensorNetworkQueue;
+  using ExecStat = TensorNetworkQueue::ExecStat;
+  TensorNetworkQueue queue(4);
+  MPICommProxy communicator;
+  auto network = std::make_shared<TensorNetwork>("net");
+  //Execution handles are submission tickets (+1): The same tensor network may be submitted repeatedly:
+  std::vector<TensorOpExecHandle> handles;
+  for(unsigned int i = 0; i < 4; ++i){
+    handles.emplace_back(queue.append(network,communicator,4,i));
+    EXPECT_EQ(handles.back(),i+1);
+    EXPECT_EQ(queue.checkExecStatus(handles.back()),ExecStat::Idle);
+  }
+  EXPECT_EQ(queue.getSize(),4);
+  //The queue is bounded: A full queue rejects new submissions:
+  EXPECT_EQ(queue.append(network,communicator,1,0),0);
+  EXPECT_EQ(queue.getSize(),4);
+  EXPECT_EQ(queue.checkExecStatus(0),ExecStat::None);
+  EXPECT_EQ(queue.checkExecStatus(5),ExecStat::None);
+  //The execution thread accepts the submissions in order:
+  EXPECT_FALSE(queue.isEmpty());
+  queue.reset();
+  for(unsigned int i = 0; i < 4; ++i){
+    EXPECT_EQ(queue.getCurrent()->second,handles[i]);
+    EXPECT_EQ(queue.getExecConfiguration(handles[i]),std::make_pair(4,static_cast<int>(i)));
+    if(i < 3){
+      EXPECT_TRUE(queue.next());
+    }else{
+      EXPECT_FALSE(queue.next());
+    }
+  }
+  EXPECT_TRUE(queue.isOver());
+  //Complete and remove the first tensor network, releasing its status slot:
+  queue.reset();
+  EXPECT_EQ(queue.updateExecStatus(handles[0],ExecStat::Executing),ExecStat::Idle);
+  EXPECT_EQ(queue.checkExecStatus(handles[0]),ExecStat::Executing);
+  EXPECT_EQ(queue.updateExecStatus(handles[0],ExecStat::Completed),ExecStat::Executing);
+  queue.remove();
+  EXPECT_EQ(queue.getSize(),3);
+  EXPECT_EQ(queue.checkExecStatus(handles[0]),ExecStat::None);
+  //A new submission reuses the status slot of the removed one under a new execution handle:
+  const auto reused = queue.append(network,communicator,1,0);
+  EXPECT_EQ(reused,5);
+  EXPECT_EQ((reused - 1) % 4,(handles[0] - 1) % 4);
+  EXPECT_EQ(queue.checkExecStatus(reused),ExecStat::Idle);
+  EXPECT_EQ(queue.checkExecStatus(handles[0]),ExecStat::None);
+  EXPECT_EQ(queue.updateExecStatus(handles[0],ExecStat::Completed),ExecStat::None);
+  EXPECT_EQ(queue.checkExecStatus(reused),ExecStat::Idle);
+  EXPECT_EQ(queue.getExecConfiguration(handles[0]),std::make_pair(0,-1));
+  EXPECT_EQ(queue.append(network,communicator,1,0),0);
+  //Drain the queue (tensor networks may complete out of order):
+  std::size_t num_removed = 0;
+  while(!queue.isEmpty()){
+    queue.reset();
+    while(!queue.isOver()){
+      EXPECT_EQ(queue.checkExecStatus(queue.getCurrent()->second),ExecStat::Idle);
+      queue.updateExecStatus(queue.getCurrent()->second,ExecStat::Completed);
+      queue.remove();
+      ++num_removed;
+    }
+  }
+  EXPECT_EQ(num_removed,4);
+  EXPECT_EQ(queue.getSize(),0);
+  EXPECT_EQ(queue.checkExecStatus(reused),ExecStat::None);
+}
+
+
+TEST(TensorRuntimeTester, checkTensorNetworkQueueMultiProducer) {
+  using exatn::TensorNetwork;
+  using exatn::MPICommProxy;
+  using exatn::runtime::TensorOpExecHandle;
+  using exatn::runtime::TensorNetworkQueue;
+  using ExecStat = TensorNetworkQueue::ExecStat;
+  const int NUM_PRODUCERS = 4;
+  const std::size_t NUM_NETWORKS = 2000; //per producer
+  TensorNetworkQueue queue(16); //small queue: Producers keep hitting the full queue
+  auto network = std::make_shared<TensorNetwork>("net");
+  //Each producer retries when the queue is full (as TensorRuntime::submit does):
+  std::vector<std::vector<TensorOpExecHandle>> handles(NUM_PRODUCERS);
+  auto producer = [&queue,&network,&handles,NUM_NETWORKS](int p){
+    MPICommProxy communicator;
+    for(std::size_t i = 0; i < NUM_NETWORKS; ++i){
+      auto exec_handle = queue.append(network,communicator,NUM_PRODUCERS,p);
+      while(exec_handle == 0){
+        std::this_thread::yield();
+        exec_handle = queue.append(network,communicator,NUM_PRODUCERS,p);
+      }
+      handles[p].emplace_back(exec_handle);
+    }
+  };
+  std::vector<std::thread> producers;
+  for(int p = 0; p < NUM_PRODUCERS; ++p) producers.emplace_back(producer,p);
+  //The execution thread accepts the submissions in the ticket order and retires them:
+  std::size_t num_removed = 0;
+  TensorOpExecHandle last_handle = 0;
+  while(num_removed < NUM_PRODUCERS * NUM_NETWORKS){
+    if(!queue.isEmpty()){
+      queue.reset();
+      while(!queue.isOver()){
+        const auto exec_handle = queue.getCurrent()->second;
+        EXPECT_EQ(exec_handle,last_handle+1);
+        last_handle = exec_handle;
+        const auto exec_conf = queue.getExecConfiguration(exec_handle);
+        EXPECT_EQ(exec_conf.first,NUM_PRODUCERS);
+        EXPECT_EQ(queue.updateExecStatus(exec_handle,ExecStat::Completed),ExecStat::Idle);
+        queue.remove();
+        EXPECT_EQ(queue.checkExecStatus(exec_handle),ExecStat::None);
+        ++num_removed;
+      }
+    }else{
+      std::this_thread::yield();
+    }
+  }
+  for(auto & thread: producers) thread.join();
+  //Every submission got a unique execution handle:
+  std::vector<TensorOpExecHandle> all_handles;
+  for(const auto & producer_handles: handles){
+    EXPECT_TRUE(std::is_sorted(producer_handles.cbegin(),producer_handles.cend()));
+    all_handles.insert(all_handles.end(),producer_handles.cbegin(),producer_handles.cend());
+  }
+  std::sort(all_handles.begin(),all_handles.end());
+  EXPECT_EQ(std::adjacent_find(all_handles.cbegin(),all_handles.cend()),all_handles.cend());
+  EXPECT_EQ(all_handles.size(),NUM_PRODUCERS * NUM_NETWORKS);
+  EXPECT_TRUE(queue.isEmpty());
+  EXPECT_EQ(queue.getSize(),0);
+}
+
+
+TEST(TensorRuntimeTester, checkRegionDependencies) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorSignature;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::SOME_SPACE;
+  auto dag = exatn::getService<exatn::runtime::TensorGraph>("boost-digraph");
+  auto factory = exatn::TensorOpFactory::get();
+  auto tens_t = std::make_shared<Tensor>("T",TensorShape{8,8});
+  auto tens_x = std::make_shared<Tensor>("X",TensorShape{8,8});
+  auto make_slice = [](const std::string & name, exatn::DimOffset offset0, exatn::DimOffset offset1){
+    return std::make_shared<Tensor>(name,TensorShape{4,4},TensorSignature{{SOME_SPACE,offset0},{SOME_SPACE,offset1}});
+  };
+  auto slice_00 = make_slice("S00",0,0); //region [0:4)x[0:4)
+  auto slice_11 = make_slice("S11",4,4); //region [4:8)x[4:8)
+  auto slice_01 = make_slice("S01",0,4); //region [0:4)x[4:8)
+  auto slice_22 = make_slice("S22",2,2); //region [2:6)x[2:6)
+  auto insert = [&](std::shared_ptr<Tensor> slice){
+    std::shared_ptr<TensorOperation> op = factory->createTensorOp(TensorOpCode::INSERT);
+    op->setTensorOperand(tens_t);
+    op->setTensorOperand(slice);
+    return dag->addOperation(op);
+  };
+  //Node 0, 1: Insertions of disjoint slices into T carry no mutual dependency:
+  EXPECT_EQ(insert(slice_00),0);
+  EXPECT_EQ(insert(slice_11),1);
+  EXPECT_FALSE(dag->dependencyExists(1,0));
+  //Node 2: Extraction of a slice disjoint from both inserted ones:
+  std::shared_ptr<TensorOperation> extraction = factory->createTensorOp(TensorOpCode::SLICE);
+  extraction->setTensorOperand(slice_01);
+  extraction->setTensorOperand(tens_t);
+  EXPECT_EQ(dag->addOperation(extraction),2);
+  EXPECT_FALSE(dag->dependencyExists(2,0));
+  EXPECT_FALSE(dag->dependencyExists(2,1));
+  EXPECT_EQ(dag->getNodeDegree(2),0);
+  //Node 3: Insertion of a slice overlapping all previous regions (Write-after-Write, Write-after-Read):
+  EXPECT_EQ(insert(slice_22),3);
+  EXPECT_TRUE(dag->dependencyExists(3,0));
+  EXPECT_TRUE(dag->dependencyExists(3,1));
+  EXPECT_TRUE(dag->dependencyExists(3,2));
+  //Node 4: A whole-tensor read of T depends on all writes into T (Read-after-Write), but not on the read:
+  std::shared_ptr<TensorOperation> addition = factory->createTensorOp(TensorOpCode::ADD);
+  addition->setTensorOperand(tens_x);
+  addition->setTensorOperand(tens_t);
+  addition->setIndexPattern("X(a,b)+=T(a,b)");
+  EXPECT_EQ(dag->addOperation(addition),4);
+  EXPECT_TRUE(dag->dependencyExists(4,0));
+  EXPECT_TRUE(dag->dependencyExists(4,1));
+  EXPECT_FALSE(dag->dependencyExists(4,2));
+  EXPECT_TRUE(dag->dependencyExists(4,3));
+}
+
+
+class TestLazyGraphExecutor: public exatn::runtime::LazyGraphExecutor {
+public:
+  //Runs an autotuning epoch with either a congested (TRY_LATER) or a starving pipeline:
+  void runAutotuningEpoch(bool congested) {
+    AutotuneStats stats;
+    stats.issued = congested ? 0 : AUTOTUNE_PERIOD;
+    stats.postponed = congested ? AUTOTUNE_PERIOD : 0;
+    stats.polls = AUTOTUNE_PERIOD;
+    stats.idle_polls = congested ? 0 : AUTOTUNE_PERIOD;
+    autotuneDepths(stats);
+  }
+};
+
+TEST(TensorRuntimeTester, checkLazyExecutorAutotuning) {
+  using exatn::runtime::LazyGraphExecutor;
+  const auto pipeline_depth = LazyGraphExecutor::DEFAULT_PIPELINE_DEPTH;
+  const auto prefetch_depth = LazyGraphExecutor::DEFAULT_PREFETCH_DEPTH;
+  //The autotuning is off by default:
+  {
+    TestLazyGraphExecutor executor;
+    executor.resetNodeExecutor(nullptr,exatn::ParamConf(),1,0,0);
+    EXPECT_FALSE(executor.autotuningActive());
+    EXPECT_EQ(executor.getPipelineDepth(),pipeline_depth);
+    EXPECT_EQ(executor.getPrefetchDepth(),prefetch_depth);
+  }
+  exatn::ParamConf parameters;
+  parameters.setParameter("dag_executor_autotune",static_cast<int64_t>(1));
+  //Autotuned depths:
+  {
+    TestLazyGraphExecutor executor;
+    executor.resetNodeExecutor(nullptr,parameters,1,0,0);
+    EXPECT_TRUE(executor.autotuningActive());
+    executor.runAutotuningEpoch(false);
+    EXPECT_GT(executor.getPipelineDepth(),pipeline_depth);
+    EXPECT_GT(executor.getPrefetchDepth(),prefetch_depth);
+    executor.runAutotuningEpoch(true);
+    executor.runAutotuningEpoch(true);
+    EXPECT_LT(executor.getPipelineDepth(),pipeline_depth);
+    EXPECT_LT(executor.getPrefetchDepth(),prefetch_depth);
+  }
+  //An explicitly set prefetch depth is not autotuned:
+  {
+    TestLazyGraphExecutor executor;
+    executor.resetNodeExecutor(nullptr,parameters,1,0,0);
+    executor.setPrefetchDepth(prefetch_depth + 2);
+    executor.runAutotuningEpoch(true);
+    EXPECT_LT(executor.getPipelineDepth(),pipeline_depth);
+    EXPECT_EQ(executor.getPrefetchDepth(),prefetch_depth + 2);
+  }
+  //An explicitly set pipeline depth is not autotuned:
+  parameters.setParameter("dag_executor_pipeline_depth",static_cast<int64_t>(8));
+  {
+    TestLazyGraphExecutor executor;
+    executor.resetNodeExecutor(nullptr,parameters,1,0,0);
+    executor.runAutotuningEpoch(false);
+    EXPECT_EQ(executor.getPipelineDepth(),8);
+    EXPECT_LE(executor.getPrefetchDepth(),4);
+    executor.runAutotuningEpoch(true);
+    EXPECT_EQ(executor.getPipelineDepth(),8);
+    EXPECT_EQ(executor.getPrefetchDepth(),2);
+  }
+}
+
+
+TEST(TensorRuntimeTester, checkExecTrace) {
+  using exatn::Tensor;
+  using exatn::TensorShape;
+  using exatn::TensorOpCode;
+  using exatn::TensorOperation;
+  using exatn::runtime::ExecTrace;
+  auto tens_a = std::make_shared<Tensor>("A",TensorShape{4,4});
+  auto tens_d = std::make_shared<Tensor>("D",TensorShape{4,4});
+  std::shared_ptr<TensorOperation> contraction = exatn::TensorOpFactory::get()->createTensorOp(TensorOpCode::CONTRACT);
+  contraction->setTensorOperand(tens_d);
+  contraction->setTensorOperand(tens_a);
+  contraction->setTensorOperand(tens_a);
+  contraction->setIndexPattern("D(a,b)+=A(a,c)*A(c,b)");
+  ExecTrace trace;
+  EXPECT_FALSE(trace.isActive());
+  trace.record(ExecTrace::EventKind::POSTPONED,*contraction,0); //inactive: not recorded
+  //Ring of 4 events overflowed by 2 events:
+  trace.activate(4);
+  EXPECT_TRUE(trace.isActive());
+  for(exatn::runtime::VertexIdType node = 0; node < 6; ++node){
+    trace.record(ExecTrace::EventKind::POSTPONED,*contraction,node);
+  }
+  EXPECT_EQ(trace.getNumEvents(),4U);
+  EXPECT_EQ(trace.getNumDropped(),2U);
+  const std::string file_name = "exatn_exec_trace.test.json";
+  EXPECT_TRUE(trace.dumpChromeTrace(file_name,0));
+  EXPECT_EQ(trace.getNumEvents(),0U);
+  std::ifstream trace_file(file_name);
+  ASSERT_TRUE(trace_file.is_open());
+  const std::string contents((std::istreambuf_iterator<char>(trace_file)),std::istreambuf_iterator<char>());
+  trace_file.close();
+  std::remove(file_name.c_str());
+  //Only the 4 newest events (DAG nodes 2..5) are retained:
+  EXPECT_EQ(contents.find("\"node\":1,"),std::string::npos);
+  for(int node = 2; node < 6; ++node){
+    EXPECT_NE(contents.find("\"node\":" + std::to_string(node) + ","),std::string::npos);
+  }
+  EXPECT_NE(contents.find("\"operands\":[\"D\",\"A\",\"A\"]"),std::string::npos);
+  EXPECT_NE(contents.find("\"dropped_events\":2"),std::string::npos);
+}
+
+
 int main(int argc, char **argv) {
   exatn::initialize();
 
@@ -0,0 +1,177 @@
+/** ExaTN: Communication profile
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "comm_profile.hpp"
+
+#ifdef MPI_ENABLED
+#include "mpi.h"
+#endif
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace exatn {
+
+CommProfile & getCommProfile()
+{
+ static CommProfile * comm_profile = new CommProfile(); //never destroyed (used during static destruction)
+ return *comm_profile;
+}
+
+
+const char * CommProfile::kindName(CommKind kind)
+{
+ static const char * const names[] = {"FETCH","UPLOAD","BROADCAST","ALLREDUCE","REDUCE",
+                                      "SEQ_GATHER","SEQ_BCAST","SEQ_ALLREDUCE","SEQ_BOUND","BACKEND_BCAST",
+                                      "COMM_SPLIT"};
+ const auto k = static_cast<int>(kind);
+ if(k >= 0 && k < static_cast<int>(CommKind::NUM_KINDS)) return names[k];
+ return "UNKNOWN";
+}
+
+
+void CommProfile::activate(bool active)
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ active_.store(false);
+ stats_.clear();
+ peers_.clear();
+ active_.store(active);
+ return;
+}
+
+
+const CommProfile::Group & CommProfile::resolve(const MPICommProxy & communicator)
+{
+#ifdef MPI_ENABLED
+ if(!(communicator.isEmpty())){
+  const auto comm = *(communicator.get<MPI_Comm>());
+  for(const auto & group: groups_){
+   if(!(group.freed) && !(group.communicator.isEmpty()) && *(group.communicator.get<MPI_Comm>()) == comm) return group;
+  }
+  int comm_size = 0;
+  auto errc = MPI_Comm_size(comm,&comm_size); assert(errc == MPI_SUCCESS);
+  MPI_Group comm_group, world_group;
+  errc = MPI_Comm_group(comm,&comm_group); assert(errc == MPI_SUCCESS);
+  errc = MPI_Comm_group(MPI_COMM_WORLD,&world_group); assert(errc == MPI_SUCCESS);
+  std::vector<int> local_ranks(comm_size), global_ranks(comm_size);
+  for(int i = 0; i < comm_size; ++i) local_ranks[i] = i;
+  errc = MPI_Group_translate_ranks(comm_group,comm_size,local_ranks.data(),world_group,global_ranks.data());
+  assert(errc == MPI_SUCCESS);
+  errc = MPI_Group_free(&comm_group); assert(errc == MPI_SUCCESS);
+  errc = MPI_Group_free(&world_group); assert(errc == MPI_SUCCESS);
+  groups_.emplace_back(Group{MPICommProxy(comm),next_group_id_++,
+                             std::vector<unsigned int>(global_ranks.cbegin(),global_ranks.cend()),false});
+  return groups_.back();
+ }
+#endif
+ for(const auto & group: groups_){
+  if(group.communicator.isEmpty()) return group;
+ }
+ groups_.emplace_back(Group{MPICommProxy(),next_group_id_++,std::vector<unsigned int>{0},false});
+ return groups_.back();
+}
+
+
+void CommProfile::record(CommKind kind,
+                         const MPICommProxy & communicator,
+                         int peer,
+                         std::size_t bytes,
+                         double time)
+{
+ if(!isActive()) return;
+ std::lock_guard<std::mutex> lock(mtx_);
+ const auto & group = resolve(communicator);
+ auto & stats = stats_[std::make_pair(static_cast<int>(kind),group.id)];
+ ++(stats.messages);
+ stats.bytes += bytes;
+ stats.time += time;
+ stats.max_time = std::max(stats.max_time,time);
+ if((kind == CommKind::FETCH || kind == CommKind::UPLOAD) &&
+    peer >= 0 && peer < static_cast<int>(group.ranks.size())){
+  auto & peer_stats = peers_[group.ranks[peer]];
+  if(kind == CommKind::UPLOAD){
+   ++(peer_stats.sent_messages);
+   peer_stats.sent_bytes += bytes;
+  }else{
+   ++(peer_stats.received_messages);
+   peer_stats.received_bytes += bytes;
+  }
+ }
+ return;
+}
+
+
+void CommProfile::forget(const MPICommProxy & communicator)
+{
+#ifdef MPI_ENABLED
+ if(communicator.isEmpty()) return;
+ std::lock_guard<std::mutex> lock(mtx_);
+ const auto comm = *(communicator.get<MPI_Comm>());
+ for(auto & group: groups_){
+  if(!(group.freed) && !(group.communicator.isEmpty()) && *(group.communicator.get<MPI_Comm>()) == comm) group.freed = true;
+ }
+#endif
+ return;
+}
+
+
+bool CommProfile::dumpReport(const std::string & filename,
+                             int process_id)
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(stats_.empty()) return true;
+ std::ofstream report_file(filename,std::ios::out|std::ios::trunc);
+ if(!report_file.is_open()) return false;
+ std::size_t total_messages = 0, total_bytes = 0;
+ double total_time = 0.0;
+ for(const auto & entry: stats_){
+  total_messages += entry.second.messages;
+  total_bytes += entry.second.bytes;
+  total_time += entry.second.time;
+ }
+ report_file << "#CommProfile: Process " << process_id << ": Messages = " << total_messages
+             << "; Bytes = " << total_bytes << std::scientific << std::setprecision(3)
+             << "; Time = " << total_time << " sec" << std::endl;
+ //Statistics per communication kind and process group:
+ report_file << std::left << std::setw(15) << "Kind" << std::right << std::setw(7) << "Group"
+             << std::setw(7) << "Size" << std::setw(11) << "Messages" << std::setw(16) << "Bytes"
+             << std::setw(11) << "Time" << std::setw(11) << "MaxTime" << std::setw(11) << "GB/s" << std::endl;
+ for(const auto & entry: stats_){
+  const auto kind = static_cast<CommKind>(entry.first.first);
+  const auto group_id = entry.first.second;
+  const auto & group = groups_[group_id];
+  const auto & stats = entry.second;
+  report_file << std::left << std::setw(15) << kindName(kind) << std::right << std::setw(7) << group_id
+              << std::setw(7) << group.ranks.size() << std::setw(11) << stats.messages << std::setw(16) << stats.bytes
+              << std::setw(11) << stats.time << std::setw(11) << stats.max_time
+              << std::setw(11) << ((stats.time > 0.0) ? (static_cast<double>(stats.bytes) / stats.time * 1e-9) : 0.0)
+              << std::endl;
+ }
+ //Process groups (global MPI ranks):
+ for(const auto & group: groups_){
+  report_file << "Group " << group.id << ":";
+  for(const auto rank: group.ranks) report_file << " " << rank;
+  if(group.freed) report_file << " (freed)";
+  report_file << std::endl;
+ }
+ //Point-to-point communication matrix row of the current process:
+ if(!peers_.empty()){
+  report_file << "Row " << process_id << " (peer: sent messages/bytes, received messages/bytes):";
+  for(const auto & peer: peers_){
+   report_file << " " << peer.first << ": " << peer.second.sent_messages << "/" << peer.second.sent_bytes
+               << ", " << peer.second.received_messages << "/" << peer.second.received_bytes << ";";
+  }
+  report_file << std::endl;
+ }
+ report_file.close();
+ stats_.clear();
+ peers_.clear();
+ return true;
+}
+
+} //namespace exatn
@@ -0,0 +1,132 @@
+/** ExaTN: Communication profile
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The communication profile is a process-wide registry of the MPI communication
+     performed by ExaTN: The tensor communication operations executed by the node executor
+     (FETCH, UPLOAD, BROADCAST, ALLREDUCE/REDUCE), the collectives of the numerical server
+     (e.g., the contraction sequence agreement) and the communicator splits of process groups.
+     Once activated, it aggregates the number of messages, the payload volume (bytes sent or
+     received by the current process), and the total/max time per communication kind and
+     process group (MPI communicator). The time of a non-blocking communication is measured
+     from its issue to its observed completion, thus it includes any overlap with computation.
+ (b) Point-to-point communications (FETCH, UPLOAD) are additionally aggregated per peer
+     (global MPI rank), giving the row of the current process in the global communication
+     matrix. The reports of all MPI processes together form the full matrix, thus exposing
+     communication imbalance between the MPI processes.
+ (c) Process groups are identified by their MPI communicator, resolved to the global MPI ranks
+     of their members upon the first recorded communication. A freed MPI communicator is
+     marked as such (retained in the report), such that a reused MPI communicator handle
+     is resolved anew.
+ (d) Recording takes a lock, thus it can be done from any thread. The registry
+     is never destroyed, thus it can be used during static destruction.
+**/
+
+#ifndef EXATN_COMM_PROFILE_HPP_
+#define EXATN_COMM_PROFILE_HPP_
+
+#include "mpi_proxy.hpp"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+#include <mutex>
+
+namespace exatn {
+
+class CommProfile {
+public:
+
+ /** Communication kinds. **/
+ enum class CommKind: int {
+  FETCH,         //point-to-point receive of a tensor (TensorOpFetch)
+  UPLOAD,        //point-to-point send of a tensor (TensorOpUpload)
+  BROADCAST,     //broadcast of a tensor (TensorOpBroadcast)
+  ALLREDUCE,     //allreduce of a tensor (TensorOpAllreduce)
+  REDUCE,        //reduction of a tensor to the root (TensorOpAllreduce with a root)
+  SEQ_GATHER,    //gather of the contraction sequence costs (sequence agreement)
+  SEQ_BCAST,     //broadcast of the agreed contraction sequence (sequence agreement)
+  SEQ_ALLREDUCE, //allreduce of the contraction sequences of multiple tensor networks (sequence agreement)
+  SEQ_BOUND,     //one-sided exchange of the best contraction sequence cost (distributed sequence search)
+  BACKEND_BCAST, //broadcast of the automatically selected computational backend of a tensor network
+  COMM_SPLIT,    //split of a process group into subgroups
+  NUM_KINDS
+ };
+
+ CommProfile(): active_(false), next_group_id_(0) {}
+
+ CommProfile(const CommProfile &) = delete;
+ CommProfile & operator=(const CommProfile &) = delete;
+ CommProfile(CommProfile &&) = delete;
+ CommProfile & operator=(CommProfile &&) = delete;
+ ~CommProfile() = default;
+
+ /** Activates/deactivates the communication profile,
+     discarding all previously recorded statistics. **/
+ void activate(bool active);
+
+ /** Returns TRUE if the communication profile is active. **/
+ inline bool isActive() const {return active_.load(std::memory_order_relaxed);}
+
+ /** Records a communication over an MPI communicator. **/
+ void record(CommKind kind,                    //in: communication kind
+             const MPICommProxy & communicator, //in: MPI communicator
+             int peer,                         //in: peer rank within the MPI communicator (root of a collective), or negative (all members)
+             std::size_t bytes,                //in: payload volume sent or received by the current process (bytes)
+             double time);                     //in: duration from issue to completion (sec)
+
+ /** Forgets a (freed) MPI communicator. **/
+ void forget(const MPICommProxy & communicator);
+
+ /** Writes the communication profile into a text file and clears the statistics
+     (the resolved process groups are retained). Returns FALSE on failure. **/
+ bool dumpReport(const std::string & filename, //in: output file name
+                 int process_id);              //in: process id (global MPI rank)
+
+ /** Returns the printable name of a communication kind. **/
+ static const char * kindName(CommKind kind);
+
+protected:
+
+ struct Group {
+  MPICommProxy communicator;         //non-owning proxy of the MPI communicator
+  unsigned int id;                   //process group id (in the order of appearance)
+  std::vector<unsigned int> ranks;   //global MPI ranks of the members
+  bool freed;                        //whether or not the MPI communicator has been freed
+ };
+
+ struct Stats {
+  std::size_t messages = 0; //number of communications
+  std::size_t bytes = 0;    //payload volume (bytes)
+  double time = 0.0;        //total duration (sec)
+  double max_time = 0.0;    //max duration (sec)
+ };
+
+ struct PeerStats {
+  std::size_t sent_messages = 0;     //number of sent messages
+  std::size_t sent_bytes = 0;        //sent volume (bytes)
+  std::size_t received_messages = 0; //number of received messages
+  std::size_t received_bytes = 0;    //received volume (bytes)
+ };
+
+ /** Resolves an MPI communicator to its process group (the lock must be held). **/
+ const Group & resolve(const MPICommProxy & communicator);
+
+ std::vector<Group> groups_;                                  //resolved process groups
+ std::map<std::pair<int,unsigned int>,Stats> stats_;         //statistics per {communication kind, process group id}
+ std::map<unsigned int,PeerStats> peers_;                    //point-to-point statistics per peer (global MPI rank)
+ std::atomic<bool> active_;                                  //activation status
+ unsigned int next_group_id_;                                //next process group id
+ std::mutex mtx_;                                            //protects the statistics
+};
+
+/** Returns the process-wide communication profile. **/
+CommProfile & getCommProfile();
+
+} //namespace exatn
+
+#endif //EXATN_COMM_PROFILE_HPP_
@@ -0,0 +1,161 @@
+/** ExaTN: Sharded concurrent registry
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) A concurrent registry is a key-value map split into a fixed number of shards,
+     each protected by its own reader-writer lock, thus lookups proceed concurrently
+     and insertions/removals by different threads mostly hit different shards.
+ (b) Registered entries are immutable key-value nodes owned by shared pointers (RCU-style):
+     A lookup returns a shared reference to the found node rather than an iterator into
+     the shard, thus it stays valid after the shard lock is released, even if the entry
+     is concurrently removed or replaced. A lookup neither allocates nor copies the value.
+     A found entry only compares equal to another one if both are void (not found),
+     which keeps the familiar (find(key) != end()) idiom working.
+ (c) Iteration is only possible over a snapshot of all entries (entries()).
+ (d) lookup() returns a pointer to the stored value, which stays valid until
+     the entry is removed (node stability of std::unordered_map). It is meant
+     for values that are never removed while in use by the caller.
+**/
+
+#ifndef EXATN_CONCURRENT_REGISTRY_HPP_
+#define EXATN_CONCURRENT_REGISTRY_HPP_
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <memory>
+
+#include <cstddef>
+
+namespace exatn {
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentRegistry {
+
+public:
+
+ static constexpr const std::size_t NUM_SHARDS = 16; //number of shards (power of 2)
+
+ using Node = std::pair<const Key,Value>; //immutable registry entry
+
+ /** Shared reference to a registry entry (void if not found). **/
+ class Entry {
+ public:
+  Entry() = default;
+  Entry(std::shared_ptr<const Node> node): node_(std::move(node)) {}
+  const Node * operator->() const {return node_.get();}
+  const Node & operator*() const {return *node_;}
+  bool operator==(const Entry & another) const {return (!node_ && !(another.node_));}
+  bool operator!=(const Entry & another) const {return !(*this == another);}
+ private:
+  std::shared_ptr<const Node> node_;
+ };
+
+ ConcurrentRegistry() = default;
+
+ ConcurrentRegistry(const ConcurrentRegistry &) = delete;
+ ConcurrentRegistry & operator=(const ConcurrentRegistry &) = delete;
+ ConcurrentRegistry(ConcurrentRegistry &&) = delete;
+ ConcurrentRegistry & operator=(ConcurrentRegistry &&) = delete;
+ ~ConcurrentRegistry() = default;
+
+ /** Returns the void entry (not found). **/
+ Entry end() const {return Entry();}
+ Entry cend() const {return Entry();}
+
+ /** Returns a shared reference to the entry with the given key, or the void entry. **/
+ Entry find(const Key & key) const {
+  const auto & shard = getShard(key);
+  std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+  auto iter = shard.entries.find(key);
+  if(iter == shard.entries.cend()) return Entry();
+  return Entry(iter->second);
+ }
+
+ /** Returns a pointer to the stored value with the given key, or nullptr (see rationale d). **/
+ const Value * lookup(const Key & key) const {
+  const auto & shard = getShard(key);
+  std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+  auto iter = shard.entries.find(key);
+  if(iter == shard.entries.cend()) return nullptr;
+  return &(iter->second->second);
+ }
+
+ /** Inserts a new entry unless the key is already registered. Returns a shared reference
+     of the registered entry and whether or not the insertion took place. **/
+ std::pair<Entry,bool> emplace(const std::pair<Key,Value> & entry) {
+  auto & shard = getShard(entry.first);
+  std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+  auto iter = shard.entries.find(entry.first);
+  if(iter != shard.entries.end()) return std::make_pair(Entry(iter->second),false);
+  auto res = shard.entries.emplace(entry.first,std::make_shared<const Node>(entry.first,entry.second));
+  return std::make_pair(Entry(res.first->second),true);
+ }
+
+ /** Removes the entry with the given key. Returns the number of removed entries. **/
+ std::size_t erase(const Key & key) {
+  auto & shard = getShard(key);
+  std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+  return shard.entries.erase(key);
+ }
+
+ /** Returns the number of entries (not synchronized with concurrent updates). **/
+ std::size_t size() const {
+  std::size_t num_entries = 0;
+  for(const auto & shard: shards_){
+   std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+   num_entries += shard.entries.size();
+  }
+  return num_entries;
+ }
+
+ bool empty() const {return (size() == 0);}
+
+ /** Returns a snapshot of all entries (in the order of shards). **/
+ std::vector<std::pair<Key,Value>> entries() const {
+  std::vector<std::pair<Key,Value>> all_entries;
+  for(const auto & shard: shards_){
+   std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+   for(const auto & entry: shard.entries) all_entries.emplace_back(entry.first,entry.second->second);
+  }
+  return all_entries;
+ }
+
+ /** Removes all entries. **/
+ void clear() {
+  for(auto & shard: shards_){
+   std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+   shard.entries.clear();
+  }
+  return;
+ }
+
+private:
+
+ struct Shard{
+  mutable std::shared_timed_mutex lock; //reader-writer lock
+  std::unordered_map<Key,std::shared_ptr<const Node>,Hash> entries; //registered entries
+ };
+
+ const Shard & getShard(const Key & key) const {
+  const std::size_t hash = Hash()(key);
+  return shards_[(hash ^ (hash >> 7)) & (NUM_SHARDS - 1)];
+ }
+
+ Shard & getShard(const Key & key) {
+  const std::size_t hash = Hash()(key);
+  return shards_[(hash ^ (hash >> 7)) & (NUM_SHARDS - 1)];
+ }
+
+ Shard shards_[NUM_SHARDS]; //registry shards
+};
+
+} //namespace exatn
+
+#endif //EXATN_CONCURRENT_REGISTRY_HPP_
@@ -0,0 +1,113 @@
+/** ExaTN: Device memory manager
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include "device_memory.hpp"
+
+#include <iostream>
+#include <cassert>
+
+namespace exatn {
+
+DeviceMemoryManager & getDeviceMemoryManager()
+{
+ static DeviceMemoryManager * device_memory = new DeviceMemoryManager(); //never destroyed (used during static destruction)
+ return *device_memory;
+}
+
+
+void DeviceMemoryManager::registerBuffer(int device, void * base_ptr, std::size_t size)
+{
+ assert(device >= 0 && base_ptr != nullptr && size > 0);
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto res = buffers_.emplace(std::make_pair(device,DeviceBuffer{}));
+ auto & buffer = res.first->second;
+ if(res.second){
+  buffer.base_ptr = base_ptr;
+  buffer.size = size;
+ }else if(buffer.base_ptr != base_ptr || buffer.size != size){
+  std::cout << "#ERROR(exatn::DeviceMemoryManager): registerBuffer: Conflicting registration of the device buffer of GPU "
+            << device << std::endl;
+  assert(false);
+ }
+ return;
+}
+
+
+std::vector<int> DeviceMemoryManager::getDevices() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ std::vector<int> devices;
+ for(const auto & buffer: buffers_) devices.emplace_back(buffer.first);
+ return devices;
+}
+
+
+bool DeviceMemoryManager::getBuffer(int device, void ** base_ptr, std::size_t * size) const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter == buffers_.cend()) return false;
+ *base_ptr = iter->second.base_ptr;
+ *size = iter->second.size;
+ return true;
+}
+
+
+bool DeviceMemoryManager::retainRanges(int device, const std::vector<MemoryRange> & ranges)
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter == buffers_.end()) return ranges.empty();
+ if(!(iter->second.tenant.empty())) return false;
+ iter->second.retained = ranges;
+ return true;
+}
+
+
+std::vector<DeviceMemoryManager::MemoryRange> DeviceMemoryManager::getRetainedRanges(int device) const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter == buffers_.cend()) return std::vector<MemoryRange>{};
+ return iter->second.retained;
+}
+
+
+bool DeviceMemoryManager::acquireLease(int device, const std::string & tenant)
+{
+ assert(!tenant.empty());
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter == buffers_.end()) return false;
+ if(!(iter->second.tenant.empty())) return (iter->second.tenant == tenant);
+ iter->second.tenant = tenant;
+ return true;
+}
+
+
+void DeviceMemoryManager::releaseLease(int device, const std::string & tenant)
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter != buffers_.end()){
+  if(iter->second.tenant == tenant){
+   iter->second.tenant.clear();
+   iter->second.retained.clear(); //the default tenant resumes the management of the device buffer
+  }
+ }
+ return;
+}
+
+
+bool DeviceMemoryManager::isLeased(int device) const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ auto iter = buffers_.find(device);
+ if(iter == buffers_.cend()) return false;
+ return !(iter->second.tenant.empty());
+}
+
+} //namespace exatn
@@ -0,0 +1,101 @@
+/** ExaTN: Device memory manager
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The device memory manager is a process-wide registry of the device memory buffers
+     (one per GPU) shared by the executors of ExaTN: The TAL-SH node executor, which owns
+     the device buffers allocated by TAL-SH (the default tenant), and the cuQuantum tensor
+     network executor, which executes from the same device buffers (leasing tenant).
+     Thus, whichever executor is active, it can use the whole device memory, instead of
+     statically partitioning the device memory between the executors.
+ (b) A leasing tenant takes over the device buffer of a GPU for the time of its execution
+     (exclusive lease). Before the lease, the default tenant records the ranges of the device
+     buffer still retained by its resident data (e.g., tensor images left on the GPU), which
+     the leasing tenant must not overwrite, but which it may read directly (zero copy).
+     The retained ranges are discarded once the lease is released, when the default tenant
+     resumes the management of the device buffer.
+ (c) All methods take a lock, thus they can be called from any thread. The manager
+     is never destroyed, thus it can be used during static destruction.
+**/
+
+#ifndef EXATN_DEVICE_MEMORY_HPP_
+#define EXATN_DEVICE_MEMORY_HPP_
+
+#include <vector>
+#include <map>
+#include <string>
+#include <mutex>
+#include <cstddef>
+
+namespace exatn {
+
+class DeviceMemoryManager {
+public:
+
+ /** Device memory range: {Pointer, Size in bytes} **/
+ using MemoryRange = std::pair<void*,std::size_t>;
+
+ DeviceMemoryManager() = default;
+
+ DeviceMemoryManager(const DeviceMemoryManager &) = delete;
+ DeviceMemoryManager & operator=(const DeviceMemoryManager &) = delete;
+ DeviceMemoryManager(DeviceMemoryManager &&) = delete;
+ DeviceMemoryManager & operator=(DeviceMemoryManager &&) = delete;
+ ~DeviceMemoryManager() = default;
+
+ /** Registers the device buffer of a given GPU. Repeated registrations must agree. **/
+ void registerBuffer(int device,        //in: GPU id
+                     void * base_ptr,   //in: base pointer of the device buffer
+                     std::size_t size); //in: size of the device buffer (bytes)
+
+ /** Returns the GPU ids of all registered device buffers. **/
+ std::vector<int> getDevices() const;
+
+ /** Retrieves the device buffer of a given GPU. Returns FALSE if it is not registered. **/
+ bool getBuffer(int device,              //in: GPU id
+                void ** base_ptr,        //out: base pointer of the device buffer
+                std::size_t * size) const; //out: size of the device buffer (bytes)
+
+ /** Records the ranges of the device buffer of a given GPU retained by the default tenant,
+     replacing the previously recorded ones. Returns FALSE if the device buffer is leased. **/
+ bool retainRanges(int device,                               //in: GPU id
+                   const std::vector<MemoryRange> & ranges); //in: retained ranges of the device buffer
+
+ /** Returns the ranges of the device buffer of a given GPU retained by the default tenant. **/
+ std::vector<MemoryRange> getRetainedRanges(int device) const;
+
+ /** Leases the device buffer of a given GPU to a tenant (except for the retained ranges).
+     Returns FALSE if the device buffer is not registered or leased by another tenant. **/
+ bool acquireLease(int device,                  //in: GPU id
+                   const std::string & tenant); //in: tenant name
+
+ /** Releases the lease of the device buffer of a given GPU held by a tenant,
+     returning the device buffer to the default tenant. **/
+ void releaseLease(int device,                  //in: GPU id
+                   const std::string & tenant); //in: tenant name
+
+ /** Returns TRUE if the device buffer of a given GPU is currently leased. **/
+ bool isLeased(int device) const;
+
+protected:
+
+ struct DeviceBuffer {
+  void * base_ptr = nullptr;           //base pointer of the device buffer
+  std::size_t size = 0;                //size of the device buffer (bytes)
+  std::string tenant;                  //current leasing tenant (empty: default tenant)
+  std::vector<MemoryRange> retained;   //ranges retained by the default tenant
+ };
+
+ std::map<int,DeviceBuffer> buffers_;  //GPU id --> device buffer
+ mutable std::mutex mtx_;              //protects the registry
+};
+
+/** Returns the process-wide device memory manager. **/
+DeviceMemoryManager & getDeviceMemoryManager();
+
+} //namespace exatn
+
+#endif //EXATN_DEVICE_MEMORY_HPP_
@@ -1,10 +1,12 @@
 /** ExaTN: MPI Communicator Proxy & Process group
-REVISION: 2021/09/26
+REVISION: 2022/03/27
 
-Copyright (C) 2018-2021 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2018-2021 Oak Ridge National Laboratory (UT-Battelle) **/
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
 
 #include "mpi_proxy.hpp"
+#include "comm_profile.hpp"
+#include "timers.hpp"
 
 #ifdef MPI_ENABLED
 #include "mpi.h"
@@ -35,6 +37,7 @@ MPICommProxy::~MPICommProxy()
     if(res != MPI_IDENT){
      errc = MPI_Comm_compare(*mpicomm,MPI_COMM_SELF,&res); assert(errc == MPI_SUCCESS);
      if(res != MPI_IDENT){
+      getCommProfile().forget(*this);
       errc = MPI_Comm_free(mpicomm); assert(errc == MPI_SUCCESS);
      }
     }
@@ -111,23 +114,10 @@ std::shared_ptr<ProcessGroup> ProcessGroup::split(int my_subgroup) const
    int my_orig_rank;
    auto errc = MPI_Comm_rank(mpicomm,&my_orig_rank); assert(errc == MPI_SUCCESS);
    MPI_Comm subgroup_mpicomm;
+   const double time_start = Timer::timeInSecHR();
    errc = MPI_Comm_split(mpicomm,color,my_orig_rank,&subgroup_mpicomm); assert(errc == MPI_SUCCESS);
-   if(color != MPI_UNDEFINED){
-    int subgroup_size;
-    errc = MPI_Comm_size(subgroup_mpicomm,&subgroup_size); assert(errc == MPI_SUCCESS);
-    MPI_Group orig_group,new_group;
-    errc = MPI_Comm_group(mpicomm,&orig_group); assert(errc == MPI_SUCCESS);
-    errc = MPI_Comm_group(subgroup_mpicomm,&new_group); assert(errc == MPI_SUCCESS);
-    int sub_ranks[subgroup_size],orig_ranks[subgroup_size];
-    for(int i = 0; i < subgroup_size; ++i) sub_ranks[i] = i;
-    errc = MPI_Group_translate_ranks(new_group,subgroup_size,sub_ranks,orig_group,orig_ranks);
-    std::vector<unsigned int> subgroup_ranks(subgroup_size); //vector of global MPI ranks
-    const auto & ranks = this->getProcessRanks();
-    for(int i = 0; i < subgroup_size; ++i) subgroup_ranks[i] = ranks[orig_ranks[i]];
-    subgroup = std::make_shared<ProcessGroup>(MPICommProxy(subgroup_mpicomm,true),
-                                              subgroup_ranks,
-                                              this->getMemoryLimitPerProcess());
-   }
+   getCommProfile().record(CommProfile::CommKind::COMM_SPLIT,intra_comm_,-1,0,Timer::timeInSecHR(time_start));
+   if(color != MPI_UNDEFINED) subgroup = makeSubgroup(&subgroup_mpicomm);
   }else{
    std::cout << "#ERROR(exatn::ProcessGroup::split): Empty MPI communicator!\n" << std::flush;
    assert(false);
@@ -137,4 +127,58 @@ std::shared_ptr<ProcessGroup> ProcessGroup::split(int my_subgroup) const
  return subgroup;
 }
 
+
+std::shared_ptr<ProcessGroup> ProcessGroup::splitByNode() const
+{
+ std::shared_ptr<ProcessGroup> subgroup(nullptr);
+ if(this->getSize() == 1){
+  subgroup = std::make_shared<ProcessGroup>(*this);
+ }else{
+#ifdef MPI_ENABLED
+  if(!(intra_comm_.isEmpty())){
+   auto & mpicomm = intra_comm_.getRef<MPI_Comm>();
+   int my_orig_rank;
+   auto errc = MPI_Comm_rank(mpicomm,&my_orig_rank); assert(errc == MPI_SUCCESS);
+   MPI_Comm subgroup_mpicomm;
+   const double time_start = Timer::timeInSecHR();
+   errc = MPI_Comm_split_type(mpicomm,MPI_COMM_TYPE_SHARED,my_orig_rank,MPI_INFO_NULL,&subgroup_mpicomm);
+   assert(errc == MPI_SUCCESS);
+   getCommProfile().record(CommProfile::CommKind::COMM_SPLIT,intra_comm_,-1,0,Timer::timeInSecHR(time_start));
+   subgroup = makeSubgroup(&subgroup_mpicomm);
+  }else{
+   std::cout << "#ERROR(exatn::ProcessGroup::splitByNode): Empty MPI communicator!\n" << std::flush;
+   assert(false);
+  }
+#else
+  subgroup = std::make_shared<ProcessGroup>(*this);
+#endif
+ }
+ return subgroup;
+}
+
+
+std::shared_ptr<ProcessGroup> ProcessGroup::makeSubgroup(void * subgroup_comm) const
+{
+ std::shared_ptr<ProcessGroup> subgroup(nullptr);
+#ifdef MPI_ENABLED
+ auto & mpicomm = intra_comm_.getRef<MPI_Comm>();
+ MPI_Comm subgroup_mpicomm = *(static_cast<MPI_Comm*>(subgroup_comm));
+ int subgroup_size;
+ auto errc = MPI_Comm_size(subgroup_mpicomm,&subgroup_size); assert(errc == MPI_SUCCESS);
+ MPI_Group orig_group,new_group;
+ errc = MPI_Comm_group(mpicomm,&orig_group); assert(errc == MPI_SUCCESS);
+ errc = MPI_Comm_group(subgroup_mpicomm,&new_group); assert(errc == MPI_SUCCESS);
+ std::vector<int> sub_ranks(subgroup_size),orig_ranks(subgroup_size);
+ for(int i = 0; i < subgroup_size; ++i) sub_ranks[i] = i;
+ errc = MPI_Group_translate_ranks(new_group,subgroup_size,sub_ranks.data(),orig_group,orig_ranks.data());
+ std::vector<unsigned int> subgroup_ranks(subgroup_size); //vector of global MPI ranks
+ const auto & ranks = this->getProcessRanks();
+ for(int i = 0; i < subgroup_size; ++i) subgroup_ranks[i] = ranks[orig_ranks[i]];
+ subgroup = std::make_shared<ProcessGroup>(MPICommProxy(subgroup_mpicomm,true),
+                                           subgroup_ranks,
+                                           this->getMemoryLimitPerProcess());
+#endif
+ return subgroup;
+}
+
 } //namespace exatn
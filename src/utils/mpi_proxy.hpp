@@ -144,8 +144,17 @@ public:
      different MPI processes, thus putting them into disjoint subgroups. **/
  std::shared_ptr<ProcessGroup> split(int my_subgroup) const;
 
+ /** Splits the existing process group into subgroups of MPI processes
+     sharing the same compute node (shared memory) and returns the
+     process subgroup the current MPI process belongs to. **/
+ std::shared_ptr<ProcessGroup> splitByNode() const;
+
 protected:
 
+ /** Wraps a newly created MPI communicator (MPI_Comm*) of a subset of the
+     MPI processes of the process group into a new process subgroup. **/
+ std::shared_ptr<ProcessGroup> makeSubgroup(void * subgroup_comm) const;
+
  std::vector<unsigned int> process_ranks_; //global ranks of the MPI processes forming the process group
  MPICommProxy intra_comm_;                 //associated MPI intra-communicator
  std::size_t mem_per_process_;             //dynamic memory limit per process (bytes)
@@ -0,0 +1,248 @@
+/** ExaTN: Thread topology manager
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle) **/
+
+#include <cassert>
+
+#include "thread_topology.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+#include <map>
+
+namespace exatn {
+
+ThreadTopology & getThreadTopology()
+{
+ static ThreadTopology * thread_topology = new ThreadTopology(); //never destroyed (used during static destruction)
+ return *thread_topology;
+}
+
+
+/** Reads an integer topology attribute of a logical CPU from sysfs (-1 if not available). **/
+static int readCpuAttribute(int cpu, const std::string & attribute)
+{
+ std::ifstream attr_file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + attribute);
+ int value = -1;
+ if(attr_file) attr_file >> value;
+ return (attr_file ? value : -1);
+}
+
+
+/** Confines the calling thread to given logical CPUs. **/
+static bool pinToCores(const std::vector<int> & cores)
+{
+#ifdef __linux__
+ if(cores.empty()) return false;
+ cpu_set_t cpu_set;
+ CPU_ZERO(&cpu_set);
+ for(const auto cpu: cores) CPU_SET(cpu,&cpu_set);
+ return (pthread_setaffinity_np(pthread_self(),sizeof(cpu_set),&cpu_set) == 0);
+#else
+ return false;
+#endif
+}
+
+
+/** Prints a list of logical CPUs as ranges. **/
+static void printCores(std::ostream & os, const std::vector<int> & cores)
+{
+ if(cores.empty()){
+  os << "none";
+  return;
+ }
+ std::size_t i = 0;
+ while(i < cores.size()){
+  std::size_t j = i;
+  while(j + 1 < cores.size() && cores[j+1] == cores[j] + 1) ++j;
+  if(i > 0) os << ",";
+  os << cores[i];
+  if(j > i) os << "-" << cores[j];
+  i = j + 1;
+ }
+ return;
+}
+
+
+bool ThreadTopology::configure(const ParamConf & parameters, int node_process_rank, int node_num_processes)
+{
+ assert(node_process_rank >= 0 && node_process_rank < node_num_processes);
+ std::lock_guard<std::mutex> lock(mtx_);
+ active_ = false;
+ share_.clear(); runtime_.clear(); mpi_.clear(); compute_.clear();
+ node_process_rank_ = node_process_rank;
+ node_num_processes_ = node_num_processes;
+ int64_t requested = 0;
+ if(!parameters.getParameter("thread_topology",&requested) || requested == 0) return false;
+#ifdef __linux__
+ int64_t runtime_cores = DEFAULT_RUNTIME_CORES, mpi_cores = DEFAULT_MPI_CORES, smt = 0;
+ parameters.getParameter("thread_topology_runtime_cores",&runtime_cores);
+ parameters.getParameter("thread_topology_mpi_cores",&mpi_cores);
+ parameters.getParameter("thread_topology_smt",&smt);
+ //Logical CPUs of the process affinity mask ordered by {socket, physical core, logical CPU}:
+ cpu_set_t cpu_set;
+ CPU_ZERO(&cpu_set);
+ if(sched_getaffinity(0,sizeof(cpu_set),&cpu_set) != 0){
+  std::cout << "#ERROR(exatn::ThreadTopology): configure: Unable to query the process affinity mask" << std::endl;
+  return false;
+ }
+ std::vector<std::tuple<int,int,int>> cpus; //{socket, physical core, logical CPU}
+ for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu){
+  if(CPU_ISSET(cpu,&cpu_set)) cpus.emplace_back(std::make_tuple(readCpuAttribute(cpu,"physical_package_id"),
+                                                                readCpuAttribute(cpu,"core_id"),cpu));
+ }
+ std::sort(cpus.begin(),cpus.end());
+ std::vector<int> cores;
+ std::map<std::pair<int,int>,int> hw_threads; //{socket, physical core} --> number of used hardware threads
+ for(const auto & cpu: cpus){
+  auto & used = hw_threads[std::make_pair(std::get<0>(cpu),std::get<1>(cpu))];
+  if(smt <= 0 || std::get<1>(cpu) < 0 || used < smt){
+   cores.emplace_back(std::get<2>(cpu));
+   ++used;
+  }
+ }
+ if(cores.empty()) return false;
+ //Process share (unless the launcher has already confined the process):
+ const int num_online = static_cast<int>(std::thread::hardware_concurrency());
+ if(node_num_processes > 1 && static_cast<int>(cpus.size()) >= num_online){
+  const std::size_t num_cores = cores.size();
+  const std::size_t num_procs = node_num_processes;
+  const std::size_t rank = node_process_rank;
+  if(num_cores >= num_procs){
+   share_.assign(cores.cbegin() + (rank * num_cores / num_procs),cores.cbegin() + ((rank + 1) * num_cores / num_procs));
+  }else{
+   share_.emplace_back(cores[rank % num_cores]);
+  }
+ }else{
+  share_ = cores;
+ }
+ //Runtime cores, MPI progress cores, compute cores:
+ const int num_share = static_cast<int>(share_.size());
+ const int num_runtime = std::max(0,std::min(static_cast<int>(runtime_cores),num_share - 1));
+ const int num_mpi = std::max(0,std::min(static_cast<int>(mpi_cores),num_share - num_runtime - 1));
+ compute_.assign(share_.cbegin() + num_runtime + num_mpi,share_.cend());
+ mpi_.assign(share_.cbegin() + num_runtime,share_.cbegin() + num_runtime + num_mpi);
+ if(num_runtime > 0){
+  runtime_.assign(share_.cbegin(),share_.cbegin() + num_runtime);
+ }else{
+  runtime_ = compute_; //the runtime threads share the compute cores
+ }
+ std::sort(share_.begin(),share_.end());
+ active_ = true;
+#else
+ std::cout << "#WARNING(exatn::ThreadTopology): configure: Thread pinning is only supported on Linux" << std::endl;
+#endif
+ return active_;
+}
+
+
+bool ThreadTopology::isActive() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ return active_;
+}
+
+
+unsigned int ThreadTopology::getNumComputeCores() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ return (active_ ? compute_.size() : 0);
+}
+
+
+bool ThreadTopology::pinClientThread() const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(!active_) return false;
+#ifdef _OPENMP
+ omp_set_num_threads(static_cast<int>(compute_.size()));
+#endif
+ return pinToCores(share_);
+}
+
+
+bool ThreadTopology::pinRuntimeThread(bool compute_team) const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(!active_) return false;
+ bool pinned = pinToCores(runtime_);
+ if(pinned && compute_team){
+  if(runtime_ == compute_){ //no dedicated runtime cores: The calling thread is team thread 0
+   pinned = pinTeam(compute_,0);
+  }else{
+   pinned = pinTeam(compute_,1);
+  }
+ }
+ return pinned;
+}
+
+
+bool ThreadTopology::pinWorkerThread(unsigned int worker_id, unsigned int num_workers) const
+{
+ assert(worker_id < num_workers);
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(!active_) return false;
+ std::vector<int> slice;
+ const std::size_t num_cores = compute_.size();
+ if(num_cores >= num_workers){
+  slice.assign(compute_.cbegin() + (worker_id * num_cores / num_workers),
+               compute_.cbegin() + ((worker_id + 1) * num_cores / num_workers));
+ }else{
+  slice.emplace_back(compute_[worker_id % num_cores]);
+ }
+ bool pinned = pinToCores(slice);
+ if(pinned) pinned = pinTeam(slice,0);
+ return pinned;
+}
+
+
+bool ThreadTopology::pinTeam(const std::vector<int> & cores, unsigned int offset)
+{
+ bool pinned = true;
+#ifdef _OPENMP
+ const int num_threads = static_cast<int>(cores.size() + offset);
+ omp_set_num_threads(num_threads);
+ int failed = 0;
+#pragma omp parallel num_threads(num_threads) reduction(+:failed)
+ {
+  const unsigned int thread = omp_get_thread_num();
+  if(thread >= offset){
+   if(!pinToCores(std::vector<int>{cores[(thread - offset) % cores.size()]})) ++failed;
+  }
+ }
+ pinned = (failed == 0);
+#endif
+ return pinned;
+}
+
+
+void ThreadTopology::printLayout(std::ostream & os) const
+{
+ std::lock_guard<std::mutex> lock(mtx_);
+ if(!active_){
+  os << "Thread topology: inactive" << std::endl;
+  return;
+ }
+ os << "Thread topology (node-local process " << node_process_rank_ << " of " << node_num_processes_ << "):" << std::endl;
+ os << " process share: "; printCores(os,share_); os << std::endl;
+ os << " runtime threads: "; printCores(os,runtime_); os << std::endl;
+ os << " MPI progress threads: "; printCores(os,mpi_); os << std::endl;
+ os << " compute threads (" << compute_.size() << "): "; printCores(os,compute_); os << std::endl;
+ return;
+}
+
+} //namespace exatn
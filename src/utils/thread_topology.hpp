@@ -0,0 +1,111 @@
+/** ExaTN: Thread topology manager
+REVISION: 2022/03/27
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) The thread topology is a process-wide placement of all threads of an ExaTN process,
+     configured from the runtime parameters upon the construction of the numerical server
+     (exatn::initialize()): The client (main) thread, the execution thread with the auxiliary
+     threads (runtime monitor), the compute threads (OpenMP team used by the TAL-SH Host kernels
+     and OpenMP-threaded BLAS, worker threads of the parallel DAG executor), and the cores
+     reserved for the MPI progress threads.
+ (b) The logical CPUs of the process affinity mask (ordered by socket, physical core and
+     hardware thread, optionally with a limited number of hardware threads per physical core)
+     are partitioned among the node-local MPI processes in contiguous ranges (process share).
+     If the launcher has already confined the process to a part of the compute node,
+     its whole affinity mask is the process share. The process share is split into
+     the runtime cores (first), the MPI progress cores (next, kept free of ExaTN threads),
+     and the compute cores (rest).
+ (c) Threads are pinned deterministically: The client thread is confined to the process share;
+     the execution thread and the auxiliary threads are pinned to the runtime cores, with the
+     OpenMP team of the execution thread pinned to the compute cores (thread t >= 1 to compute
+     core t-1); worker thread w out of W is confined to the w-th contiguous slice of the compute
+     cores, with its OpenMP team pinned within the slice. All OpenMP teams are limited
+     to the compute cores (no oversubscription).
+ (d) The thread topology is inactive unless requested by the runtime parameter "thread_topology" (0/1).
+     Other runtime parameters: "thread_topology_runtime_cores" (default 1),
+     "thread_topology_mpi_cores" (default 0), "thread_topology_smt" (max number of hardware
+     threads used per physical core, default 0: all). Thread pinning requires Linux.
+ (e) All methods take a lock, thus they can be called from any thread. The manager
+     is never destroyed, thus it can be used during static destruction.
+**/
+
+#ifndef EXATN_THREAD_TOPOLOGY_HPP_
+#define EXATN_THREAD_TOPOLOGY_HPP_
+
+#include "param_conf.hpp"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <mutex>
+
+namespace exatn {
+
+class ThreadTopology {
+public:
+
+ static constexpr const int DEFAULT_RUNTIME_CORES = 1; //default number of runtime cores per process
+ static constexpr const int DEFAULT_MPI_CORES = 0;     //default number of cores reserved for the MPI progress threads per process
+
+ ThreadTopology() = default;
+
+ ThreadTopology(const ThreadTopology &) = delete;
+ ThreadTopology & operator=(const ThreadTopology &) = delete;
+ ThreadTopology(ThreadTopology &&) = delete;
+ ThreadTopology & operator=(ThreadTopology &&) = delete;
+ ~ThreadTopology() = default;
+
+ /** Configures the thread topology of the process from the runtime parameters (see rationale d).
+     Returns TRUE if the thread topology is active. **/
+ bool configure(const ParamConf & parameters,  //in: runtime parameters
+                int node_process_rank,         //in: node-local process rank
+                int node_num_processes);       //in: number of processes on the compute node
+
+ /** Returns TRUE if the thread topology is active. **/
+ bool isActive() const;
+
+ /** Returns the number of compute cores of the process (0 if inactive). **/
+ unsigned int getNumComputeCores() const;
+
+ /** Confines the calling (client) thread to the process share and limits its OpenMP team
+     to the number of compute cores. Returns FALSE if inactive or failed. **/
+ bool pinClientThread() const;
+
+ /** Pins the calling thread to the runtime cores. If <compute_team> is TRUE, the OpenMP team
+     of the calling thread is pinned to the compute cores. Returns FALSE if inactive or failed. **/
+ bool pinRuntimeThread(bool compute_team) const;
+
+ /** Confines the calling worker thread to its slice of the compute cores, with its OpenMP team
+     pinned within the slice. Returns FALSE if inactive or failed. **/
+ bool pinWorkerThread(unsigned int worker_id,           //in: worker id
+                      unsigned int num_workers) const;  //in: number of workers
+
+ /** Prints the thread topology of the process. **/
+ void printLayout(std::ostream & os) const;
+
+protected:
+
+ /** Pins the OpenMP team of the calling thread to given cores: Team thread t
+     to core (t - offset), the threads t < offset stay where they are. **/
+ static bool pinTeam(const std::vector<int> & cores,
+                     unsigned int offset);
+
+ bool active_ = false;          //whether or not the thread topology is active
+ int node_process_rank_ = 0;    //node-local process rank
+ int node_num_processes_ = 1;   //number of processes on the compute node
+ std::vector<int> share_;       //process share (logical CPUs)
+ std::vector<int> runtime_;     //runtime cores
+ std::vector<int> mpi_;         //cores reserved for the MPI progress threads
+ std::vector<int> compute_;     //compute cores
+ mutable std::mutex mtx_;       //protects the thread topology
+};
+
+/** Returns the process-wide thread topology. **/
+ThreadTopology & getThreadTopology();
+
+} //namespace exatn
+
+#endif //EXATN_THREAD_TOPOLOGY_HPP_
@@ -0,0 +1,108 @@
+/** ExaTN: Spin-then-park waiter
+REVISION: 2022/03/17
+
+Copyright (C) 2018-2022 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2018-2022 Oak Ridge National Laboratory (UT-Battelle)
+
+Rationale:
+ (a) A waiter blocks the calling thread until a given predicate becomes TRUE.
+     It first spins by re-evaluating the predicate up to the spin budget times
+     (yielding the CPU periodically), then parks the thread on a condition variable.
+     A parked thread is woken up either by notify() or by its own timeout,
+     which grows exponentially (adaptive backoff) up to MAX_PARK_USEC, such that
+     the predicate does not have to be coupled with an explicit notification.
+ (b) The notifying side only acquires the waiter mutex when some thread
+     is actually parked, thus keeping notify() cheap on hot paths.
+ (c) The spin budget is normally set from the "runtime_spin_budget"
+     runtime parameter (ParamConf). A zero spin budget parks immediately.
+**/
+
+#ifndef EXATN_WAITER_HPP_
+#define EXATN_WAITER_HPP_
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include <cstdint>
+
+namespace exatn {
+
+class Waiter {
+
+public:
+
+ static constexpr const int64_t DEFAULT_SPIN_BUDGET = 1024; //default number of predicate checks before parking
+ static constexpr const int64_t SPIN_YIELD_PERIOD = 64;     //the spinning thread yields the CPU every that many checks
+ static constexpr const int64_t MIN_PARK_USEC = 8;          //initial parking timeout (microseconds)
+ static constexpr const int64_t MAX_PARK_USEC = 1024;       //maximal parking timeout (microseconds)
+
+ Waiter(int64_t spin_budget = DEFAULT_SPIN_BUDGET):
+  spin_budget_(spin_budget), num_parked_(0)
+ {
+ }
+
+ Waiter(const Waiter &) = delete;
+ Waiter & operator=(const Waiter &) = delete;
+ Waiter(Waiter &&) noexcept = delete;
+ Waiter & operator=(Waiter &&) noexcept = delete;
+ ~Waiter() = default;
+
+ /** Resets the spin budget (number of predicate checks before parking). **/
+ void resetSpinBudget(int64_t spin_budget)
+ {
+  if(spin_budget >= 0) spin_budget_.store(spin_budget);
+  return;
+ }
+
+ /** Returns the current spin budget. **/
+ int64_t getSpinBudget() const
+ {
+  return spin_budget_.load();
+ }
+
+ /** Blocks until the predicate returns TRUE. **/
+ template <typename Predicate>
+ void wait(Predicate && predicate)
+ {
+  const int64_t spin_budget = spin_budget_.load();
+  for(int64_t i = 0; i < spin_budget; ++i){
+   if(predicate()) return;
+   if((i+1) % SPIN_YIELD_PERIOD == 0) std::this_thread::yield();
+  }
+  int64_t park_usec = MIN_PARK_USEC;
+  std::unique_lock<std::mutex> lock(mtx_);
+  ++num_parked_;
+  while(!predicate()){
+   cv_.wait_for(lock,std::chrono::microseconds(park_usec));
+   if(park_usec < MAX_PARK_USEC) park_usec *= 2;
+  }
+  --num_parked_;
+  return;
+ }
+
+ /** Wakes up all parked threads (the predicate state must be updated before this call). **/
+ void notify()
+ {
+  if(num_parked_.load() > 0){
+   {
+    std::lock_guard<std::mutex> lock(mtx_);
+   }
+   cv_.notify_all();
+  }
+  return;
+ }
+
+private:
+
+ std::atomic<int64_t> spin_budget_; //number of predicate checks before parking
+ std::atomic<int> num_parked_;      //number of currently parked threads
+ std::mutex mtx_;                   //parking mutex
+ std::condition_variable cv_;       //parking condition
+};
+
+} //namespace exatn
+
+#endif //EXATN_WAITER_HPP_